@@ -14,6 +14,12 @@ set(mlas_common_srcs
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/logistic.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/tanh.cpp
   ${ONNXRUNTIME_ROOT}/core/mlas/lib/erf.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/compute.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/quantize.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/transpose.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/normalize.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/cast.cpp
+  ${ONNXRUNTIME_ROOT}/core/mlas/lib/murmurhash.cpp
 )
 
 if(MSVC)
@@ -66,7 +72,12 @@ if(MSVC)
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/LogisticKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/TanhKernelFma3.asm
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/ErfKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SoftmaxKernelFma3.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/amd64/SoftmaxKernelAvx512F.asm
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/MurmurHash3KernelAvx2.cpp
     )
+    set_source_files_properties(${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/MurmurHash3KernelAvx2.cpp
+                                PROPERTIES COMPILE_FLAGS "/arch:AVX2")
   else()
     enable_language(ASM_MASM)
 
@@ -168,6 +179,8 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/LogisticKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/TanhKernelFma3.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/ErfKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SoftmaxKernelFma3.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/MurmurHash3KernelAvx2.cpp
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
@@ -175,6 +188,7 @@ else()
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SconvKernelAvx512F.S
       ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SpoolKernelAvx512F.S
+      ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SoftmaxKernelAvx512F.S
     )
     set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -193,9 +207,29 @@ else()
       ${mlas_platform_srcs_avx512f}
       ${mlas_platform_srcs_avx512bw}
     )
+
+    # The bfloat16 SGEMM kernel is written with intrinsics, so it is only built
+    # if the compiler supports AVX512-BF16 code generation.
+    check_cxx_compiler_flag("-mavx512bf16" HAS_AVX512BF16)
+
+    if(HAS_AVX512BF16)
+      set(mlas_platform_srcs_avx512bf16
+        ${ONNXRUNTIME_ROOT}/core/mlas/lib/x86_64/SgemmKernelAvx512Bf16.cpp
+      )
+      set_source_files_properties(${mlas_platform_srcs_avx512bf16} PROPERTIES COMPILE_FLAGS "-mavx512f -mavx512bw -mavx512bf16")
+
+      set(mlas_platform_srcs
+        ${mlas_platform_srcs}
+        ${mlas_platform_srcs_avx512bf16}
+      )
+      set(mlas_platform_definitions MLAS_AVX512BF16_SUPPORTED)
+    endif()
   endif()
 endif()
 
 add_library(onnxruntime_mlas STATIC ${mlas_common_srcs} ${mlas_platform_srcs})
 target_include_directories(onnxruntime_mlas PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc ${ONNXRUNTIME_ROOT}/core/mlas/lib ${eigen_INCLUDE_DIRS})
+if(mlas_platform_definitions)
+  target_compile_definitions(onnxruntime_mlas PRIVATE ${mlas_platform_definitions})
+endif()
 set_target_properties(onnxruntime_mlas PROPERTIES FOLDER "ONNXRuntime")
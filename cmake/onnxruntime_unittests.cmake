@@ -540,7 +540,8 @@ install(TARGETS onnx_test_runner
         RUNTIME  DESTINATION ${CMAKE_INSTALL_BINDIR})
 
 if(onnxruntime_BUILD_BENCHMARKS)
-  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc)
+  add_executable(onnxruntime_benchmark ${TEST_SRC_DIR}/onnx/microbenchmark/main.cc ${TEST_SRC_DIR}/onnx/microbenchmark/modeltest.cc
+                 ${TEST_SRC_DIR}/onnx/microbenchmark/kernels.cc)
   target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} benchmark)
   onnxruntime_add_include_to_target(onnxruntime_benchmark gsl)
   if(WIN32)
@@ -620,6 +621,20 @@ if (onnxruntime_USE_TVM)
   endif()
 endif()
 
+# the model zoo benchmark suite, which is run on demand as it needs the models and takes a while
+set(onnxruntime_BENCHMARK_MODELS_DIR "" CACHE PATH "Directory of the models of the benchmark suite")
+set(onnxruntime_BENCHMARK_BASELINE "" CACHE FILEPATH "Results of the benchmark suite to compare against")
+set(onnxruntime_benchmark_suite_args --perf_test $<TARGET_FILE:onnxruntime_perf_test>
+  --models_dir ${onnxruntime_BENCHMARK_MODELS_DIR} --output ${CMAKE_CURRENT_BINARY_DIR}/benchmark_results.json)
+if (onnxruntime_BENCHMARK_BASELINE)
+  list(APPEND onnxruntime_benchmark_suite_args --baseline ${onnxruntime_BENCHMARK_BASELINE})
+endif()
+add_custom_target(onnxruntime_benchmark_suite
+  COMMAND ${PYTHON_EXECUTABLE} ${REPO_ROOT}/tools/python/run_benchmark_suite.py ${onnxruntime_benchmark_suite_args}
+  DEPENDS onnxruntime_perf_test
+  USES_TERMINAL)
+set_target_properties(onnxruntime_benchmark_suite PROPERTIES FOLDER "ONNXRuntimeTest")
+
 # Opaque API test can not be a part of the shared lib tests since it is using
 # C++ internals apis to register custom type, kernel and schema. It also can not
 # a part of providers unit tests since it requires its own environment.
@@ -762,3 +777,10 @@ endif()
 list(APPEND onnxruntime_mlas_test_libs Threads::Threads)
 target_link_libraries(onnxruntime_mlas_test PRIVATE ${onnxruntime_mlas_test_libs})
 set_target_properties(onnxruntime_mlas_test PROPERTIES FOLDER "ONNXRuntimeTest")
+
+if(onnxruntime_BUILD_BENCHMARKS)
+  add_executable(onnxruntime_mlas_benchmark ${TEST_SRC_DIR}/mlas/benchmark.cpp)
+  target_include_directories(onnxruntime_mlas_benchmark PRIVATE ${ONNXRUNTIME_ROOT}/core/mlas/inc)
+  target_link_libraries(onnxruntime_mlas_benchmark PRIVATE benchmark ${onnxruntime_mlas_test_libs})
+  set_target_properties(onnxruntime_mlas_benchmark PROPERTIES FOLDER "ONNXRuntimeTest")
+endif()
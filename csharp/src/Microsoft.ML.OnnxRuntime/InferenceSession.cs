@@ -6,6 +6,7 @@ using System.Runtime.InteropServices;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Threading.Tasks;
 
 
 namespace Microsoft.ML.OnnxRuntime
@@ -188,6 +189,137 @@ namespace Microsoft.ML.OnnxRuntime
 
         }
 
+        /// <summary>
+        /// Runs the loaded model for the given inputs, and writes the outputs into the given OrtValues, whose
+        /// shapes must match the outputs. The OrtValues can be created once over long-lived buffers and reused for
+        /// every run, which then allocates no managed memory.
+        /// </summary>
+        /// <param name="inputNames">Names of the inputs</param>
+        /// <param name="inputValues">Input values, in the order of <paramref name="inputNames"/></param>
+        /// <param name="outputNames">Names of the outputs</param>
+        /// <param name="outputValues">Output values to write, in the order of <paramref name="outputNames"/></param>
+        public void Run(string[] inputNames, ReadOnlySpan<OrtValue> inputValues, string[] outputNames, ReadOnlySpan<OrtValue> outputValues)
+        {
+            Run(inputNames, inputValues, outputNames, outputValues, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs, and writes the outputs into the given OrtValues, whose
+        /// shapes must match the outputs. Uses the given RunOptions for this run.
+        /// </summary>
+        /// <param name="inputNames">Names of the inputs</param>
+        /// <param name="inputValues">Input values, in the order of <paramref name="inputNames"/></param>
+        /// <param name="outputNames">Names of the outputs</param>
+        /// <param name="outputValues">Output values to write, in the order of <paramref name="outputNames"/></param>
+        /// <param name="options"></param>
+        public void Run(string[] inputNames, ReadOnlySpan<OrtValue> inputValues, string[] outputNames, ReadOnlySpan<OrtValue> outputValues, RunOptions options)
+        {
+            if (inputNames.Length != inputValues.Length)
+            {
+                throw new ArgumentException("The number of input names and values differ", nameof(inputValues));
+            }
+            if (outputNames.Length != outputValues.Length)
+            {
+                throw new ArgumentException("The number of output names and values differ", nameof(outputValues));
+            }
+
+            unsafe
+            {
+                IntPtr* inputHandles = stackalloc IntPtr[inputValues.Length];
+                for (int i = 0; i < inputValues.Length; i++)
+                {
+                    inputHandles[i] = inputValues[i].Handle;
+                }
+
+                // the outputs are preallocated, so the native Run writes into them instead of creating new values
+                IntPtr* outputHandles = stackalloc IntPtr[outputValues.Length];
+                for (int i = 0; i < outputValues.Length; i++)
+                {
+                    outputHandles[i] = outputValues[i].Handle;
+                }
+
+                NativeApiStatus.VerifySuccess(NativeMethods.OrtRunWithValues(
+                                                    this._nativeHandle,
+                                                    options.Handle,
+                                                    inputNames,
+                                                    inputHandles,
+                                                    (UIntPtr)inputValues.Length,
+                                                    outputNames,
+                                                    (UIntPtr)outputValues.Length,
+                                                    outputHandles));
+            }
+        }
+
+        /// <summary>
+        /// Queues a run of the loaded model for the given inputs on the threads of the session, fetching all the outputs.
+        /// </summary>
+        /// <param name="inputs">Inputs, whose buffers must not change until the task completes</param>
+        /// <returns>A task of the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs)
+        {
+            string[] outputNames = new string[_outputMetadata.Count];
+            _outputMetadata.Keys.CopyTo(outputNames, 0);
+            return RunAsync(inputs, outputNames, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Queues a run of the loaded model for the given inputs on the threads of the session, fetching the outputs
+        /// specified in <paramref name="outputNames"/>. Uses the given RunOptions, which must not be disposed until
+        /// the task completes.
+        /// </summary>
+        /// <param name="inputs">Inputs, whose buffers must not change until the task completes</param>
+        /// <param name="outputNames"></param>
+        /// <param name="options"></param>
+        /// <returns>A task of the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames, RunOptions options)
+        {
+            var inputNames = new string[inputs.Count];
+            var inputTensors = new IntPtr[inputs.Count];
+            var state = new AsyncRunState
+            {
+                Completion = new TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>(),
+                OutputNames = outputNames.ToArray(),
+                PinnedBufferHandles = new System.Buffers.MemoryHandle[inputs.Count],
+                Options = options
+            };
+
+            int inputIndex = 0;
+            foreach (var input in inputs)
+            {
+                inputNames[inputIndex] = input.Name;
+                input.ToNativeOnnxValue(out inputTensors[inputIndex], out state.PinnedBufferHandles[inputIndex]);
+                inputIndex++;
+            }
+
+            var stateHandle = GCHandle.Alloc(state);
+            IntPtr status = NativeMethods.OrtRunAsync(
+                                                this._nativeHandle,
+                                                options.Handle,
+                                                inputNames,
+                                                inputTensors,
+                                                (UIntPtr)inputTensors.Length,
+                                                state.OutputNames,
+                                                (UIntPtr)state.OutputNames.Length,
+                                                new IntPtr[state.OutputNames.Length],
+                                                s_runAsyncCompleted,
+                                                GCHandle.ToIntPtr(stateHandle));
+
+            // the native run holds its own references to the input values, but their buffers stay pinned until it completes
+            for (int i = 0; i < inputTensors.Length; i++)
+            {
+                NativeMethods.OrtReleaseValue(inputTensors[i]);
+            }
+
+            if (status != IntPtr.Zero)
+            {
+                stateHandle.Free();
+                state.UnpinInputs();
+                NativeApiStatus.VerifySuccess(status);
+            }
+
+            return state.Completion.Task;
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -201,6 +333,64 @@ namespace Microsoft.ML.OnnxRuntime
 
         #region private methods
 
+        private class AsyncRunState
+        {
+            public TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> Completion;
+            public string[] OutputNames;
+            public System.Buffers.MemoryHandle[] PinnedBufferHandles;
+            public RunOptions Options;  // keeps the options from being finalized while the run is pending
+
+            public void UnpinInputs()
+            {
+                for (int i = 0; i < PinnedBufferHandles.Length; i++)
+                {
+                    PinnedBufferHandles[i].Dispose();
+                }
+            }
+        }
+
+        // a single delegate, so that it is never collected while native runs are pending
+        private static readonly NativeMethods.DOrtRunAsyncCallback s_runAsyncCompleted = RunAsyncCompleted;
+
+        private static void RunAsyncCompleted(IntPtr userData, IntPtr outputValues, UIntPtr outputCount, IntPtr status)
+        {
+            var stateHandle = GCHandle.FromIntPtr(userData);
+            var state = (AsyncRunState)stateHandle.Target;
+            stateHandle.Free();
+            state.UnpinInputs();
+
+            // the task is completed on the thread pool, so that its continuations don't run on, and block, a thread of the session
+            if (status != IntPtr.Zero)
+            {
+                // the status is released by the native side after this returns
+                var exception = NativeApiStatus.ToException(status);
+                Task.Run(() => state.Completion.SetException(exception));
+                return;
+            }
+
+            var result = new DisposableList<DisposableNamedOnnxValue>();
+            int outputIndex = 0;
+            try
+            {
+                for (; outputIndex < (int)outputCount; outputIndex++)
+                {
+                    IntPtr outputValue = Marshal.ReadIntPtr(outputValues, outputIndex * IntPtr.Size);
+                    result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(state.OutputNames[outputIndex], outputValue));
+                }
+                Task.Run(() => state.Completion.SetResult(result));
+            }
+            catch (Exception e)
+            {
+                result.Dispose();
+                // the values not wrapped yet are still owned here
+                for (; outputIndex < (int)outputCount; outputIndex++)
+                {
+                    NativeMethods.OrtReleaseValue(Marshal.ReadIntPtr(outputValues, outputIndex * IntPtr.Size));
+                }
+                Task.Run(() => state.Completion.SetException(e));
+            }
+        }
+
         private void Init(string modelPath, SessionOptions options)
         {
             var envHandle = OnnxRuntime.Handle;
@@ -426,6 +426,35 @@ namespace Microsoft.ML.OnnxRuntime
 
     internal static class TensorElementTypeConverter
     {
+        public static TensorElementType GetElementType(Type type)
+        {
+            if (type == typeof(float))
+                return TensorElementType.Float;
+            if (type == typeof(double))
+                return TensorElementType.Double;
+            if (type == typeof(short))
+                return TensorElementType.Int16;
+            if (type == typeof(ushort))
+                return TensorElementType.UInt16;
+            if (type == typeof(int))
+                return TensorElementType.Int32;
+            if (type == typeof(uint))
+                return TensorElementType.UInt32;
+            if (type == typeof(long))
+                return TensorElementType.Int64;
+            if (type == typeof(ulong))
+                return TensorElementType.UInt64;
+            if (type == typeof(byte))
+                return TensorElementType.UInt8;
+            if (type == typeof(sbyte))
+                return TensorElementType.Int8;
+            if (type == typeof(string))
+                return TensorElementType.String;
+            if (type == typeof(bool))
+                return TensorElementType.Bool;
+            return TensorElementType.DataTypeMax;
+        }
+
         public static void GetTypeAndWidth(TensorElementType elemType, out Type type, out int width)
         {
             switch (elemType)
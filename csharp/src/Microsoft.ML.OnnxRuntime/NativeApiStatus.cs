@@ -31,5 +31,13 @@ namespace Microsoft.ML.OnnxRuntime
                 throw new OnnxRuntimeException(statusCode, errorMessage);
             }
         }
+
+        /// <summary>
+        /// Constructs the exception for a native Status that is not OK, without releasing it.
+        /// </summary>
+        internal static OnnxRuntimeException ToException(IntPtr nativeStatus)
+        {
+            return new OnnxRuntimeException(NativeMethods.OrtGetErrorCode(nativeStatus), GetErrorMessage(nativeStatus));
+        }
     }
 }
@@ -117,6 +117,37 @@ namespace Microsoft.ML.OnnxRuntime
         public IntPtr ReleaseTensorTypeAndShapeInfo;
         public IntPtr ReleaseSessionOptions;
         public IntPtr ReleaseCustomOpDomain;
+
+        public IntPtr CreatePreparedRun;
+        public IntPtr RunPrepared;
+        public IntPtr ReleasePreparedRun;
+        public IntPtr AddInitializer;
+        public IntPtr CreateIoBinding;
+        public IntPtr BindInput;
+        public IntPtr BindOutput;
+        public IntPtr BindOutputToDevice;
+        public IntPtr RunWithBinding;
+        public IntPtr GetBoundOutputCount;
+        public IntPtr GetBoundOutputValues;
+        public IntPtr ClearBoundInputs;
+        public IntPtr ClearBoundOutputs;
+        public IntPtr ReleaseIoBinding;
+        public IntPtr RunOptionsSetIntraOpNumThreads;
+        public IntPtr RunOptionsGetIntraOpNumThreads;
+        public IntPtr CreateEnvWithGlobalThreadPools;
+        public IntPtr CreateThreadingOptions;
+        public IntPtr SetGlobalIntraOpNumThreads;
+        public IntPtr SetGlobalInterOpNumThreads;
+        public IntPtr SetGlobalSpinControl;
+        public IntPtr SetGlobalIntraOpThreadAffinity;
+        public IntPtr ReleaseThreadingOptions;
+        public IntPtr DisablePerSessionThreads;
+        public IntPtr SetIntraOpThreadAffinity;
+        public IntPtr SetSessionNumaNode;
+        public IntPtr SetOptimizationReportFilePath;
+        public IntPtr SessionGetArenaUsage;
+        public IntPtr SetSessionWarmup;
+        public IntPtr RunAsync;
     }
 
     internal static class NativeMethods
@@ -139,6 +170,8 @@ namespace Microsoft.ML.OnnxRuntime
             OrtCreateSession = (DOrtCreateSession)Marshal.GetDelegateForFunctionPointer(api_.CreateSession, typeof(DOrtCreateSession));
             OrtCreateSessionFromArray = (DOrtCreateSessionFromArray)Marshal.GetDelegateForFunctionPointer(api_.CreateSessionFromArray, typeof(DOrtCreateSessionFromArray));
             OrtRun = (DOrtRun)Marshal.GetDelegateForFunctionPointer(api_.Run, typeof(DOrtRun));
+            OrtRunWithValues = (DOrtRunWithValues)Marshal.GetDelegateForFunctionPointer(api_.Run, typeof(DOrtRunWithValues));
+            OrtRunAsync = (DOrtRunAsync)Marshal.GetDelegateForFunctionPointer(api_.RunAsync, typeof(DOrtRunAsync));
             OrtSessionGetInputCount = (DOrtSessionGetInputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetInputCount, typeof(DOrtSessionGetInputCount));
             OrtSessionGetOutputCount = (DOrtSessionGetOutputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOutputCount, typeof(DOrtSessionGetOutputCount));
             OrtSessionGetInputName = (DOrtSessionGetInputName)Marshal.GetDelegateForFunctionPointer(api_.SessionGetInputName, typeof(DOrtSessionGetInputName));
@@ -263,6 +296,40 @@ namespace Microsoft.ML.OnnxRuntime
                                                 );
         public static DOrtRun OrtRun;
 
+        // same native function as OrtRun, with the value arrays passed as pointers so that they can be stack allocated
+        public unsafe delegate IntPtr /*(ONNStatus*)*/ DOrtRunWithValues(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr* /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                IntPtr* outputValues /* Non-null entries are used as the preallocated outputs */
+                                                );
+        public static DOrtRunWithValues OrtRunWithValues;
+
+        // called on a thread of the session when an OrtRunAsync completes. The status is released after it returns.
+        public delegate void DOrtRunAsyncCallback(
+                                                IntPtr userData,
+                                                IntPtr /*(OrtValue**)*/ outputValues,
+                                                UIntPtr outputCount,  // 0 when the run failed
+                                                IntPtr /*(const OrtStatus*)*/ status);
+
+        public delegate IntPtr /*(ONNStatus*)*/ DOrtRunAsync(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                IntPtr[] outputValues, /* Non-null entries are used as the preallocated outputs */
+                                                DOrtRunAsyncCallback callback,
+                                                IntPtr userData
+                                                );
+        public static DOrtRunAsync OrtRunAsync;
+
         public delegate IntPtr /*(OrtStatus*)*/ DOrtSessionGetInputCount(
                                                 IntPtr /*(OrtSession*)*/ session,
                                                 out UIntPtr count);
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// A native OnnxValue over a tensor buffer owned by the caller. The buffer stays pinned, and the native value
+    /// alive, until the OrtValue is disposed, so the same OrtValue can be passed to any number of
+    /// InferenceSession.Run calls as an input, or as an output that the run writes into, without any managed
+    /// allocation per call.
+    /// </summary>
+    public class OrtValue : IDisposable
+    {
+        private IntPtr _nativeHandle;
+        private MemoryHandle _pinnedBufferHandle;
+
+        private OrtValue(IntPtr nativeHandle, MemoryHandle pinnedBufferHandle)
+        {
+            _nativeHandle = nativeHandle;
+            _pinnedBufferHandle = pinnedBufferHandle;
+        }
+
+        internal IntPtr Handle
+        {
+            get
+            {
+                return _nativeHandle;
+            }
+        }
+
+        /// <summary>
+        /// Creates a tensor OrtValue over the buffer, which must hold exactly the number of elements of the shape.
+        /// The buffer is pinned until the OrtValue is disposed.
+        /// </summary>
+        /// <typeparam name="T">Element type, one of the numeric types or bool. Strings are not supported.</typeparam>
+        /// <param name="buffer">Tensor data, in row-major order</param>
+        /// <param name="shape">Tensor shape</param>
+        /// <returns>The OrtValue. User must dispose it.</returns>
+        public static OrtValue CreateTensor<T>(Memory<T> buffer, long[] shape)
+        {
+            var elementType = TensorElementTypeConverter.GetElementType(typeof(T));
+            if (elementType == TensorElementType.DataTypeMax || elementType == TensorElementType.String)
+            {
+                throw new NotSupportedException("Tensors of " + typeof(T) + " are not supported");
+            }
+            Type dotnetType;
+            int width;
+            TensorElementTypeConverter.GetTypeAndWidth(elementType, out dotnetType, out width);
+
+            long elementCount = 1;
+            foreach (var dim in shape)
+            {
+                elementCount *= dim;
+            }
+            if (elementCount != buffer.Length)
+            {
+                throw new ArgumentException("The buffer has " + buffer.Length + " elements, but the shape has " +
+                                            elementCount, nameof(buffer));
+            }
+
+            var pinnedBufferHandle = buffer.Pin();
+            IntPtr nativeValue = IntPtr.Zero;
+            IntPtr status;
+            unsafe
+            {
+                status = NativeMethods.OrtCreateTensorWithDataAsOrtValue(
+                        NativeMemoryInfo.DefaultInstance.Handle,
+                        (IntPtr)pinnedBufferHandle.Pointer,
+                        (UIntPtr)(buffer.Length * width),
+                        shape,
+                        (UIntPtr)shape.Length,
+                        elementType,
+                        out nativeValue);
+            }
+            try
+            {
+                NativeApiStatus.VerifySuccess(status);
+            }
+            catch (OnnxRuntimeException e)
+            {
+                pinnedBufferHandle.Dispose();
+                throw e;
+            }
+
+            return new OrtValue(nativeValue, pinnedBufferHandle);
+        }
+
+        #region destructors disposers
+
+        ~OrtValue()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            // the native value points into the buffer, so it is released before the buffer is unpinned
+            if (_nativeHandle != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseValue(_nativeHandle);
+                _nativeHandle = IntPtr.Zero;
+            }
+            _pinnedBufferHandle.Dispose();
+        }
+
+        #endregion
+    }
+}
@@ -228,6 +228,73 @@ namespace Microsoft.ML.OnnxRuntime.Tests
         }
 
 
+        [Fact]
+        private void CanRunInferenceWithPreallocatedOrtValues()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+            using (var session = new InferenceSession(modelPath))
+            {
+                float[] inputData = LoadTensorFromFile(@"bench.in");
+                float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
+                float[] outputData = new float[expectedOutput.Length];
+                long[] inputShape = Array.ConvertAll(session.InputMetadata["data_0"].Dimensions, d => (long)d);
+
+                using (var input = OrtValue.CreateTensor(new Memory<float>(inputData), inputShape))
+                using (var output = OrtValue.CreateTensor(new Memory<float>(outputData), new long[] { 1, 1000, 1, 1 }))
+                {
+                    var inputNames = new string[] { "data_0" };
+                    var outputNames = new string[] { "softmaxout_1" };
+                    var inputs = new OrtValue[] { input };
+                    var outputs = new OrtValue[] { output };
+
+                    // the same values are reused by every run, and the output is written into outputData
+                    for (int run = 0; run < 2; run++)
+                    {
+                        Array.Clear(outputData, 0, outputData.Length);
+                        session.Run(inputNames, inputs, outputNames, outputs);
+                        Assert.Equal(expectedOutput, outputData, new floatComparer());
+                    }
+                }
+            }
+        }
+
+        [Fact]
+        private async Task CanRunInferenceAsync()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+            using (var session = new InferenceSession(modelPath))
+            {
+                float[] inputData = LoadTensorFromFile(@"bench.in");
+                var tensor = new DenseTensor<float>(inputData, session.InputMetadata["data_0"].Dimensions);
+                var container = new List<NamedOnnxValue> { NamedOnnxValue.CreateFromTensor<float>("data_0", tensor) };
+
+                var runs = new Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>[3];
+                for (int i = 0; i < runs.Length; i++)
+                {
+                    runs[i] = session.RunAsync(container);
+                }
+                foreach (var run in runs)
+                {
+                    using (var results = await run)
+                    {
+                        validateRunResults(results);
+                    }
+                }
+
+                var wrongShape = new List<NamedOnnxValue>
+                {
+                    NamedOnnxValue.CreateFromTensor<float>("data_0", new DenseTensor<float>(new float[6], new int[] { 1, 6 }))
+                };
+                await Assert.ThrowsAsync<OnnxRuntimeException>(() => session.RunAsync(wrongShape));
+            }
+        }
+
+        [Fact]
+        private void ThrowWrongOrtValueShape()
+        {
+            Assert.Throws<ArgumentException>(() => OrtValue.CreateTensor(new Memory<float>(new float[5]), new long[] { 2, 3 }));
+        }
+
         [Fact]
         private void ThrowWrongInputName()
         {
@@ -5,9 +5,11 @@
 
 #include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <cstring>
 #include <type_traits>
+#include <unordered_map>
 
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
@@ -252,6 +254,8 @@ class IDeviceAllocator : public IAllocator {
   void Free(void* p) override = 0;
   const OrtMemoryInfo& Info() const override = 0;
   virtual bool AllowsArena() const { return true; }
+  // bytes of the memory allocated and not yet freed that is backed by huge pages
+  virtual size_t HugePageBytes() const { return 0; }
 };
 
 class CPUAllocator : public IDeviceAllocator {
@@ -273,6 +277,55 @@ class CPUAllocator : public IDeviceAllocator {
   std::unique_ptr<OrtMemoryInfo> memory_info_;
 };
 
+// CPU allocator placing its memory on a NUMA node, so that an arena used by threads pinned to the node only
+// touches local memory. Falls back to the default allocation if the platform can't place memory on a node.
+class NumaCPUAllocator : public IDeviceAllocator {
+ public:
+  NumaCPUAllocator(std::unique_ptr<OrtMemoryInfo> memory_info, int numa_node)
+      : memory_info_(std::move(memory_info)), numa_node_(numa_node) {
+    ORT_ENFORCE(nullptr != memory_info_);
+  }
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  const OrtMemoryInfo& Info() const override;
+
+  int NumaNode() const { return numa_node_; }
+
+ private:
+  std::unique_ptr<OrtMemoryInfo> memory_info_;
+  const int numa_node_;
+
+  // the sizes of the blocks allocated on the node, to free them. blocks not in it are from the fallback.
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> numa_blocks_;
+};
+
+// CPU allocator backing the allocations of at least a huge page with huge pages, so that the large regions of an
+// arena, such as the ones holding the initializers, take fewer TLB entries. The smaller allocations, and the ones
+// the platform can't back with huge pages, are made by the fallback allocator.
+class HugePageCPUAllocator : public IDeviceAllocator {
+ public:
+  HugePageCPUAllocator(std::unique_ptr<IDeviceAllocator> fallback, int numa_node)
+      : fallback_(std::move(fallback)), numa_node_(numa_node) {
+    ORT_ENFORCE(nullptr != fallback_);
+  }
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+  const OrtMemoryInfo& Info() const override;
+  size_t HugePageBytes() const override;
+
+ private:
+  std::unique_ptr<IDeviceAllocator> fallback_;
+  const int numa_node_;
+
+  // the sizes of the blocks backed by huge pages, to free them. blocks not in it are from the fallback.
+  mutable std::mutex mutex_;
+  std::unordered_map<void*, size_t> huge_page_blocks_;
+  size_t huge_page_bytes_ = 0;
+};
+
 using AllocatorPtr = std::shared_ptr<IAllocator>;
 
 }  // namespace onnxruntime
@@ -14,6 +14,9 @@
 namespace onnxruntime {
 class GraphViewer;
 class Node;
+namespace profiling {
+class EpProfiler;
+}
 }  // namespace onnxruntime
 namespace onnxruntime {
 
@@ -38,6 +41,20 @@ struct NodeComputeInfo {
   DestroyFunctionStateFunc release_state_func;
 };
 
+/**
+   Device work of a Run recorded by IExecutionProvider::EndGraphCapture. Replaying it repeats the work on the
+   same buffers, so it is only valid for Runs with the same inputs and outputs as the captured one.
+*/
+class CapturedGraph {
+ public:
+  virtual ~CapturedGraph() = default;
+
+  /**
+     Submits the recorded work. As with a Run, it may not be finished on the device when this returns.
+  */
+  virtual common::Status Replay() = 0;
+};
+
 class IExecutionProvider {
  protected:
   IExecutionProvider(const std::string& type) : type_{type} {}
@@ -135,6 +152,25 @@ class IExecutionProvider {
   */
   virtual common::Status OnRunEnd();
 
+  /**
+     Starts recording, instead of executing, the device work submitted by the calling thread, until
+     EndGraphCapture is called on the same thread. The buffers allocated meanwhile are kept for the lifetime
+     of the captured graph. Returns NOT_IMPLEMENTED when the provider can't capture.
+  */
+  virtual common::Status BeginGraphCapture();
+
+  /**
+     Ends the capture started by BeginGraphCapture, and on success sets graph to the recorded work.
+     None of the work has been executed yet, so the graph has to be replayed to complete the captured Run.
+  */
+  virtual common::Status EndGraphCapture(std::unique_ptr<CapturedGraph>& graph);
+
+  /**
+     Returns a profiler measuring the device time of the kernels of the provider, which the session uses
+     when profiling is enabled. nullptr, the default, means the host time of the kernels is the device time.
+  */
+  virtual std::unique_ptr<profiling::EpProfiler> GetProfiler();
+
   void InsertAllocator(AllocatorPtr allocator);
 
   /**
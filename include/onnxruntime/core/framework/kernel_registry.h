@@ -3,7 +3,12 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 /**
@@ -14,6 +19,8 @@ class KernelRegistry {
  public:
   KernelRegistry() = default;
 
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelRegistry);
+
   // Register a kernel with kernel definition and function to create the kernel.
   Status Register(KernelDefBuilder& kernel_def_builder,
                   const KernelCreateFn& kernel_creator);
@@ -33,10 +40,16 @@ class KernelRegistry {
                          std::unique_ptr<OpKernel>& op_kernel) const;
 
   // Check if an execution provider can create kernel for a node and return
-  // the kernel if so
+  // the kernel if so.
+  // The candidates are looked up by (domain, op type, provider) in an index built at registration,
+  // and the result is memoized per (domain, op type, provider, since version, types of the arguments),
+  // so the nodes of the same signature only pay for VerifyKernelDef once per registry.
   const KernelCreateInfo* TryFindKernel(const onnxruntime::Node& node,
                                         onnxruntime::ProviderType exec_provider) const;
 
+  // number of signatures memoized by TryFindKernel
+  size_t NumCachedLookups() const;
+
   bool IsEmpty() const { return kernel_creator_fn_map_.empty(); }
 
 #ifdef onnxruntime_PYBIND_EXPORT_OPSCHEMA
@@ -67,7 +80,28 @@ class KernelRegistry {
                               std::string& error_str,
                               onnxruntime::ProviderType exec_provider = "");
 
+  // Adds the entry to kernel_creator_fn_map_ and kernels_by_op_.
+  void AddEntry(KernelCreateInfo&& create_info);
+
+  // Key of kernels_by_op_ for the domain, op type and provider
+  static std::string MakeOpKey(const std::string& domain, const std::string& op_type,
+                               const std::string& provider);
+
+  // Key of lookup_cache_ for the node: its op key, the since version of its schema, the number of
+  // actual arguments of each formal input, and the types of its actual inputs and outputs.
+  // The interned ONNX type strings identify the types, so these determine the result of VerifyKernelDef.
+  static std::string MakeLookupKey(const onnxruntime::Node& node, const std::string& op_key);
+
   // Kernel create function map from op name to kernel creation info.
   KernelCreateMap kernel_creator_fn_map_;
+
+  // The entries of kernel_creator_fn_map_ by op key, in registration order.
+  // The entries of the multimap are stable, so pointers to them stay valid.
+  std::unordered_map<std::string, std::vector<const KernelCreateInfo*>> kernels_by_op_;
+
+  // TryFindKernel results by lookup key, nullptr for the signatures without a kernel.
+  // Cleared by Register.
+  mutable std::unordered_map<std::string, const KernelCreateInfo*> lookup_cache_;
+  mutable OrtMutex lookup_mutex_;
 };
 }  // namespace onnxruntime
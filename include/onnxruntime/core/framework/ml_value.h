@@ -10,6 +10,10 @@
 #include "core/framework/data_types.h"
 #include "core/framework/tensor.h"
 
+namespace onnxruntime {
+class SparseTensor;
+}  // namespace onnxruntime
+
 /**
    Represents both tensors and non-tensors.
 */
@@ -47,6 +51,15 @@ struct OrtValue {
     return onnxruntime::DataTypeImpl::GetType<onnxruntime::Tensor>() == type_;
   }
 
+  bool IsSparseTensor() const noexcept {
+    return onnxruntime::DataTypeImpl::GetType<onnxruntime::SparseTensor>() == type_;
+  }
+
+  // true if no other OrtValue shares the data, so it can be overwritten without affecting another value
+  bool IsUnique() const noexcept {
+    return data_.use_count() == 1;
+  }
+
   onnxruntime::MLDataType Type() const {
     return type_;
   }
@@ -46,6 +46,19 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  // Called by the session once for every input of the kernel that is a constant initializer, after the kernel is
+  // created and before the first Compute. A kernel that transforms the tensor into the layout it computes with,
+  // such as packed GEMM weights, does so here and sets is_packed. The result may be handed back in packed_buffer,
+  // which the session keeps alive for the lifetime of the kernel. When every node that uses the initializer has
+  // packed it, the session releases the original tensor, so Compute must not fetch an input it packed.
+  virtual Status PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer, bool& is_packed) {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+    ORT_UNUSED_PARAMETER(packed_buffer);
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
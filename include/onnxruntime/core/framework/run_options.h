@@ -5,6 +5,7 @@
 
 #include <string>
 #include <atomic>
+#include <chrono>
 #include "core/session/onnxruntime_c_api.h"
 
 /**
@@ -22,6 +23,21 @@ struct OrtRunOptions {
   // be forced to terminate with an error status.
   bool terminate = false;
 
+  /// Max number of threads, including the calling one, the kernels may use for the intra-op parallelism
+  /// of the Run. Caps the session's intra-op thread pool so a Run can't take all of its threads.
+  /// Default = 0 (use all the threads of the session's intra-op thread pool).
+  int intra_op_num_threads = 0;
+
+  /// Time by which the Run must have completed. A Run still executing then stops between two nodes, or between the
+  /// blocks of the parallel loop of its current kernel, and returns a failed status; a Run started, or queued by
+  /// BatchingInferenceSession, past its deadline returns the status without running.
+  /// Default = time_point::max() (no deadline).
+  std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+  /// Order of the Runs queued by BatchingInferenceSession, the ones of higher priority are run first.
+  /// Default = 0.
+  int priority = 0;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 
@@ -67,6 +67,15 @@ class Tensor final {
   Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, const OrtMemoryInfo& alloc,
          int64_t offset = 0);
 
+  /**
+   * Create tensor that takes ownership of a preallocated buffer.
+   * \param p_data A preallocated buffer, for a non-string type.
+   * \param deleter The buffer is released with deleter->Free(p_data) when the tensor is released,
+   *                and the tensor's location is deleter->Info()
+   */
+  Tensor(MLDataType p_type, const TensorShape& shape, void* p_data, std::shared_ptr<IAllocator> deleter,
+         int64_t offset = 0);
+
   /**
    * Deprecated. The orginal design is this Tensor class won't do any allocation / release.
    * However, this function will allocate the buffer for the shape, and do placement new if p_type is string tensor.
@@ -97,6 +106,11 @@ class Tensor final {
   */
   const OrtMemoryInfo& Location() const { return alloc_info_; }
 
+  /**
+     Returns true if the tensor releases its buffer when it is released
+  */
+  bool OwnsBuffer() const noexcept { return buffer_deleter_ != nullptr; }
+
   /**
      May return nullptr if tensor size is zero
   */
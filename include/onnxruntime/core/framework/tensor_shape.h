@@ -17,7 +17,9 @@ namespace onnxruntime {
 #endif
 #endif
 class TensorShape : private std::vector<int64_t> {
-  // TODO - Use a custom STL allocator to avoid heap allocations in the common case.
+  // The dimensions stay in a std::vector because GetDims() and ReinterpretBaseType() hand out the vector itself.
+  // Code on hot paths avoids temporary shapes instead: SizeToDimension/SizeFromDimension rather than
+  // Slice(...).Size(), ReinterpretBaseType to view an existing vector as a shape, and moving the dims vector in.
   // We use negative numbers for unknown symbolic dimension. Each negative
   // number represents a unique symbolic dimension.
   // Private inheritance is used to prevent ambiguity of element versus dimension size
@@ -129,6 +131,9 @@ class TensorShape : private std::vector<int64_t> {
     return len == 0 || (len == 1 && operator[](0) == 1);
   }
 
+  /**
+     View an existing vector of dimensions as a TensorShape without copying it.
+  */
   static const TensorShape& ReinterpretBaseType(const std::vector<int64_t>& dimensions) {
     static_assert(sizeof(TensorShape) == sizeof(std::vector<int64_t>), "Size of TensorShape prevents safe casting from vector");
     return *static_cast<const TensorShape*>(&dimensions);
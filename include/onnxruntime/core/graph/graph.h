@@ -796,6 +796,10 @@ class Graph {
   // Graph::LoadGraph All other access should be via the public API.
   friend class Model;
 
+  // This friendship relationship should only be used to call Graph::SetNodeInferencingNeeded
+  // when an attribute of the Node changes.
+  friend class Node;
+
   Graph() = delete;
 
   // Constructor: Given a <GraphProto> loaded from model file, construct
@@ -828,6 +832,22 @@ class Graph {
     return *this;
   }
 
+  // Forces the type and shape inferencing of the node in the next Resolve, for changes that
+  // the versions of its input and output NodeArgs don't show.
+  void SetNodeInferencingNeeded(NodeIndex node_index) {
+    nodes_to_infer_.insert(node_index);
+  }
+
+  // Checks whether the node needs type and shape inferencing because it is new, it was changed, or the NodeArgs
+  // it reads or writes changed since it was last inferred.
+  bool NodeInferencingNeeded(const Node& node) const;
+
+  // Records the versions of the NodeArgs that the node was inferred with.
+  void SetNodeInferred(const Node& node);
+
+  // Changes the version of the NodeArg with the name, if any, so that the nodes reading it are inferred again.
+  void SetNodeArgChanged(const std::string& name);
+
   Graph& GraphProtoSyncNeeded(bool needed) noexcept {
     graph_proto_sync_needed_ = needed;
     return *this;
@@ -1017,6 +1037,14 @@ class Graph {
 
   // number of times Resolve has run.
   int num_resolves_ = 0;
+
+  // The input and output NodeArgs, and their versions, that each node was last inferred with, indexed by NodeIndex.
+  // Resolve only infers the nodes that are new or whose NodeArgs changed since, so a graph transformer that
+  // changes a few nodes doesn't pay for the inferencing of the whole graph.
+  std::vector<std::vector<std::pair<const NodeArg*, uint64_t>>> inferred_node_args_;
+
+  // Nodes whose attributes changed since they were inferred.
+  std::unordered_set<NodeIndex> nodes_to_infer_;
 };
 
 }  // namespace onnxruntime
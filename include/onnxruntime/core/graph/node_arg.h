@@ -91,5 +91,9 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Changes whenever the type or shape changes. Versions are unique across all NodeArgs, so that Graph::Resolve
+  // can tell whether the inputs and outputs of a node changed since it was last inferred.
+  uint64_t version_;
 };
 }  // namespace onnxruntime
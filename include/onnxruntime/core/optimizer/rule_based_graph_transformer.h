@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <map>
+
 #include "core/common/common.h"
 #include "core/graph/graph_viewer.h"
 #include "core/optimizer/graph_transformer.h"
@@ -53,6 +55,12 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   /** Returns the total number of rules that are registered in this transformer. */
   size_t RulesCount() const;
 
+  /** Gets the number of nodes each rewrite rule modified the graph on, over all the applications of this
+      transformer. */
+  const std::map<std::string, size_t>& RuleApplicationCounts() const {
+    return rule_application_counts_;
+  }
+
  protected:
   /** Applies the given set of rewrite rules on the Node of this Graph.
       @param[in] graph The Graph.
@@ -74,6 +82,8 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   std::unordered_map<std::string, std::vector<std::reference_wrapper<const RewriteRule>>> op_type_to_rules_;
   // Rules that will be evaluated regardless of the op type of the node.
   std::vector<std::reference_wrapper<const RewriteRule>> any_op_type_rules_;
+  // Number of nodes each rule modified the graph on. Updated by the const ApplyImpl.
+  mutable std::map<std::string, size_t> rule_application_counts_;
 
   // Performs a single top-down traversal of the graph and applies all registered rules.
   common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
@@ -2,10 +2,13 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <chrono>
 #include <string>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <cstddef>
+#include <thread>
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -25,10 +28,61 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+struct ThreadOptions {
+  // let idle threads spin for a while before blocking, which lowers the latency of work scheduled shortly
+  // after but keeps the cores busy. turn it off when the pool shares the cores with other pools.
+  bool allow_spinning = true;
+
+  // time, in microseconds, the workers of a ParallelSection spin waiting for the next loop before they return
+  // their threads to the pool. spinning keeps them hot across the loops of consecutive operators; lower it on
+  // hosts shared with other processes. ignored, as if 0, when allow_spinning is false.
+  int section_spin_duration_us = 100;
+
+  // logical processors to pin the threads of the pool to, the i-th thread to affinity[i % affinity.size()].
+  // empty means the threads aren't pinned.
+  std::vector<int> affinity;
+};
+
+/*
+Eigen thread environment creating the threads of a ThreadPool, pinned according to ThreadOptions::affinity.
+*/
+class ThreadEnvironment {
+ public:
+  struct Task {
+    std::function<void()> f;
+  };
+
+  class EnvThread {
+   public:
+    explicit EnvThread(std::function<void()> f) : thread_(std::move(f)) {}
+    ~EnvThread() { thread_.join(); }
+    // thread cancellation isn't supported, the pool stops its threads when destroyed
+    void OnCancel() {}
+
+   private:
+    std::thread thread_;
+  };
+
+  explicit ThreadEnvironment(std::vector<int> affinity = {}) : affinity_(std::move(affinity)) {}
+
+  EnvThread* CreateThread(std::function<void()> f);
+  Task CreateTask(std::function<void()> f) { return Task{std::move(f)}; }
+  void ExecuteTask(const Task& t) { t.f(); }
+
+ private:
+  std::vector<int> affinity_;
+  // the pool creates its threads one at a time in its constructor
+  size_t num_created_threads_ = 0;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
  */
+// the blocks of a ParallelFor, and the workers of a ThreadPool::ParallelSection. see threadpool.cc
+struct ParallelForState;
+struct ParallelSectionState;
+
 class ThreadPool {
  public:
   /*
@@ -36,6 +90,8 @@ class ThreadPool {
   */
   ThreadPool(const std::string& name, int num_threads);
 
+  ThreadPool(const std::string& name, int num_threads, const ThreadOptions& thread_options);
+
   /*
   Enqueue a unit of work.
   */
@@ -43,25 +99,114 @@ class ThreadPool {
 
   /*
   Schedule work in the interval [0, total).
+  The interval is split into at most NumThreads() + 1 contiguous blocks and the
+  calling thread runs one of them, so the dispatch cost does not grow with total.
   */
   void ParallelFor(int32_t total, std::function<void(int32_t)> fn);
 
   /*
-  Schedule work in the interval [first, last].
+  Schedule work in the interval [0, total), handing fn one contiguous block
+  [first, last) at a time. cost_per_unit is the approximate cost, in cycles, of a
+  single iteration; small ranges of cheap iterations run inline on the calling
+  thread. Pass 0 when the cost is unknown to use one block per thread.
+  */
+  void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
+  /*
+  Schedule work in the interval [first, last), handing fn one contiguous block at a time.
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Returns the number of blocks ParallelFor would split total iterations of the
+  given cost into.
+  */
+  std::ptrdiff_t ComputeBlockCount(std::ptrdiff_t total, double cost_per_unit) const;
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
+  /*
+  Returns the number of worker threads the work scheduled from the calling thread may use.
+  This is less than the size of the pool while a ScopedParallelismLimit is active on the calling thread.
+  */
   int NumThreads() const;
 
+  /*
+  Limits the number of threads, including the calling one, used by the work the calling thread schedules
+  through NumThreads-aware helpers such as ParallelFor and MLAS, for the lifetime of the object.
+  max_threads <= 0 means no limit. The previous limit is restored on destruction.
+  */
+  class ScopedParallelismLimit {
+   public:
+    explicit ScopedParallelismLimit(int max_threads);
+    ~ScopedParallelismLimit();
+
+   private:
+    ScopedParallelismLimit(const ScopedParallelismLimit&) = delete;
+    ScopedParallelismLimit& operator=(const ScopedParallelismLimit&) = delete;
+
+    int previous_max_threads_;
+  };
+
+  // Returns the limit of the active ScopedParallelismLimit of the calling thread, or 0 if there is none.
+  static int CurrentParallelismLimit();
+
+  /*
+  Sets the time after which the loops the calling thread schedules with ParallelFor stop running their blocks, for
+  the lifetime of the object, so a Run past its deadline doesn't complete the loops of the kernel it is in. The
+  blocks not started by then are skipped, which leaves the loop incomplete: the caller checks DeadlineExceeded
+  after it and discards its results. The previous deadline is restored on destruction.
+  */
+  class ScopedDeadline {
+   public:
+    explicit ScopedDeadline(std::chrono::steady_clock::time_point deadline);
+    ~ScopedDeadline();
+
+   private:
+    ScopedDeadline(const ScopedDeadline&) = delete;
+    ScopedDeadline& operator=(const ScopedDeadline&) = delete;
+
+    std::chrono::steady_clock::time_point previous_deadline_;
+  };
+
+  // Returns the deadline of the active ScopedDeadline of the calling thread, or time_point::max() if there is none.
+  static std::chrono::steady_clock::time_point CurrentDeadline();
+
+  // Returns whether the deadline of the active ScopedDeadline of the calling thread has passed.
+  static bool DeadlineExceeded();
+
+  /*
+  Keeps up to NumThreads() workers of the pool waiting for the loops the calling thread schedules with ParallelFor
+  for the lifetime of the object, such as all the operators of a Run, so consecutive loops don't pay for waking
+  up the threads of the pool. Between loops the workers spin for ThreadOptions::section_spin_duration_us, then
+  end their tasks so the threads can run the work of other callers, such as the loops of concurrent Runs; the
+  next loop schedules them again. It does nothing for a null pool, for a pool that already has a section open on
+  the calling thread, or when the calling thread is one of the threads of the pool.
+  */
+  class ParallelSection {
+   public:
+    explicit ParallelSection(ThreadPool* tp);
+    ~ParallelSection();
+
+   private:
+    ParallelSection(const ParallelSection&) = delete;
+    ParallelSection& operator=(const ParallelSection&) = delete;
+
+    std::shared_ptr<ParallelSectionState> state_;
+  };
+
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler() { return impl_; }
 
  private:
-  Eigen::ThreadPool impl_;
+  // runs the loop on the workers of the section open on the calling thread, if there is one for this pool
+  bool TryParallelForInSection(const std::shared_ptr<ParallelForState>& loop);
+
+  Eigen::NonBlockingThreadPoolTempl<ThreadEnvironment> impl_;
+  int section_spin_duration_us_;
 };
 
 }  // namespace concurrency
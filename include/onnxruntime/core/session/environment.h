@@ -7,8 +7,21 @@
 #include <memory>
 #include "core/common/common.h"
 #include "core/common/status.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
+/**
+   Options of the thread pools created once on the Environment and shared by the sessions that don't use
+   per session threads. See SessionOptions::use_per_session_threads.
+*/
+struct ThreadingOptions {
+  // sizes of the pools, with the same meaning as SessionOptions::intra_op_num_threads and inter_op_num_threads.
+  int intra_op_num_threads = 0;
+  int inter_op_num_threads = 0;
+  concurrency::ThreadOptions intra_op_thread_options;
+  concurrency::ThreadOptions inter_op_thread_options;
+};
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -20,6 +33,11 @@ class Environment {
   */
   static Status Create(std::unique_ptr<Environment>& environment);
 
+  /**
+     Create and initialize the runtime environment with thread pools the sessions can share.
+  */
+  static Status Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& threading_options);
+
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
   */
@@ -30,6 +48,18 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns whether the environment was created with thread pools the sessions can share.
+  */
+  bool HasGlobalThreadPools() const { return create_global_thread_pools_; }
+
+  /**
+     The shared thread pools. nullptr if there are none, or if the pool size is 1 as the calling thread
+     runs the work then.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_.get(); }
+  concurrency::ThreadPool* GetInterOpThreadPool() const { return inter_op_thread_pool_.get(); }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
@@ -37,5 +67,9 @@ class Environment {
   Status Initialize();
 
   static std::atomic<bool> is_initialized_;
+
+  bool create_global_thread_pools_ = false;
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
 };
 }  // namespace onnxruntime
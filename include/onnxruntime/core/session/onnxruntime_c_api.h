@@ -156,6 +156,9 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(PreparedRun);
+ORT_RUNTIME_CLASS(IoBinding);
+ORT_RUNTIME_CLASS(ThreadingOptions);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -170,6 +173,16 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Called when a RunAsync completes, on a thread of the session.
+// outputs are the output values in the order of the output names: the preallocated output given for it, or a new
+// value the callee must free with OrtReleaseValue. status is nullptr on success, and is freed after the callback
+// returns, as is the outputs array.
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(
+    void* user_data, OrtValue** outputs, size_t num_outputs, const OrtStatus* status);
+
+// Runs the iterations [begin, end) of a KernelContext_ParallelFor.
+typedef void(ORT_API_CALL* OrtParallelForFn)(void* user_data, size_t begin, size_t end);
+
 // Set Graph optimization level.
 // TODO (askhade) Add documentation about which optimizations are enabled for each value.
 typedef enum GraphOptimizationLevel {
@@ -267,7 +280,7 @@ struct OrtApi {
   // The idea is if the input shapes are the same, we could trace the internal memory allocation
   // and generate a memory pattern for future request. So next time we could just do one allocation
   // with a big chunk for all the internal memory allocation.
-  // Note: memory pattern optimization is only available when SequentialExecution enabled.
+  // This works with both sequential and parallel execution.
   OrtStatus*(ORT_API_CALL* EnableMemPattern)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
   OrtStatus*(ORT_API_CALL* DisableMemPattern)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
 
@@ -611,6 +624,244 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  /**
+   * Create a prepared run for the inputs and outputs of the given names of a session. They are resolved and
+   * the copies of their values across devices are planned once, instead of by each Run.
+   * \param input_memory_infos The memory each input will be on, NULL for CPU memory. May be NULL if all are on CPU.
+   * \param output_memory_infos The memory each output will be returned in, NULL for CPU memory.
+   *        May be NULL if all are on CPU.
+   * \param out Should be freed by OrtReleasePreparedRun after use, before the session is released
+   */
+  OrtStatus*(ORT_API_CALL* CreatePreparedRun)(_Inout_ OrtSession* sess,
+                                              _In_ const char* const* input_names,
+                                              _In_opt_ const OrtMemoryInfo* const* input_memory_infos, size_t input_len,
+                                              _In_ const char* const* output_names,
+                                              _In_opt_ const OrtMemoryInfo* const* output_memory_infos,
+                                              size_t output_names_len, _Outptr_ OrtPreparedRun** out)NO_EXCEPTION;
+
+  /**
+   * Same as Run, for the inputs and outputs of a prepared run of the session, in the order of its names.
+   * It may be called by multiple threads at the same time with the same prepared run.
+   */
+  OrtStatus*(ORT_API_CALL* RunPrepared)(_Inout_ OrtSession* sess,
+                                        _In_opt_ const OrtRunOptions* run_options,
+                                        _In_ const OrtPreparedRun* prepared_run,
+                                        _In_ const OrtValue* const* input, size_t input_len,
+                                        _Outptr_ OrtValue** output, size_t output_len)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /**
+   * Use a tensor for the initializer of the given name of the main graph instead of loading it from the model,
+   * so that the sessions created with the options share its memory.
+   * The tensor must have the type and shape of the initializer, and be on the device its consumers are placed on.
+   * Its memory must stay valid and unchanged until all the sessions using it are released.
+   */
+  OrtStatus*(ORT_API_CALL* AddInitializer)(_Inout_ OrtSessionOptions* options, _In_ const char* name,
+                                           _In_ const OrtValue* val)NO_EXCEPTION;
+
+  /**
+   * Create a binding of inputs and outputs to values for the Runs of a session, so that the outputs are written to
+   * preallocated memory and the values may stay on a device between Runs.
+   * \param out Should be freed by OrtReleaseIoBinding after use, before the session is released
+   */
+  OrtStatus*(ORT_API_CALL* CreateIoBinding)(_Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out)NO_EXCEPTION;
+
+  /**
+   * Bind a value to an input, replacing a value bound before to the same name.
+   * A tensor that isn't on the device its consumers are placed on is copied there once, when it's bound.
+   */
+  OrtStatus*(ORT_API_CALL* BindInput)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                      _In_ const OrtValue* val_ptr)NO_EXCEPTION;
+
+  /**
+   * Bind a preallocated value to an output, into which the Runs write it.
+   */
+  OrtStatus*(ORT_API_CALL* BindOutput)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                       _In_ const OrtValue* val_ptr)NO_EXCEPTION;
+
+  /**
+   * Bind an output to the memory of the given info, where the Runs allocate it, e.g. to keep it on the GPU.
+   */
+  OrtStatus*(ORT_API_CALL* BindOutputToDevice)(_Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                                               _In_ const OrtMemoryInfo* val_ptr)NO_EXCEPTION;
+
+  /**
+   * Same as Run, for the inputs and outputs bound to the binding.
+   */
+  OrtStatus*(ORT_API_CALL* RunWithBinding)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                           _Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION;
+
+  /**
+   * Get the count of the outputs bound to the binding.
+   */
+  OrtStatus*(ORT_API_CALL* GetBoundOutputCount)(_In_ const OrtIoBinding* binding_ptr, _Out_ size_t* out)NO_EXCEPTION;
+
+  /**
+   * Get the values of the bound outputs after a Run, in the order they were bound.
+   * \param output An array of output_len entries, each of which must be freed by OrtReleaseValue
+   */
+  OrtStatus*(ORT_API_CALL* GetBoundOutputValues)(_In_ const OrtIoBinding* binding_ptr,
+                                                 _Outptr_ OrtValue** output, size_t output_len)NO_EXCEPTION;
+
+  /**
+   * Remove all the inputs or outputs bound to the binding.
+   */
+  void(ORT_API_CALL* ClearBoundInputs)(_Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
+  void(ORT_API_CALL* ClearBoundOutputs)(_Inout_ OrtIoBinding* binding_ptr)NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
+
+  ORT_CLASS_RELEASE(IoBinding);
+
+  /**
+   * Limit the number of threads, including the calling one, the kernels of a Run using these options may use
+   * from the session's intra-op thread pool. 0, the default, means all of them.
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetIntraOpNumThreads)(_Inout_ OrtRunOptions* options, int value)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* RunOptionsGetIntraOpNumThreads)(_In_ const OrtRunOptions* options, _Out_ int* out)NO_EXCEPTION;
+
+  /**
+   * Create an environment with intra-op and inter-op thread pools shared by the sessions created with it whose
+   * options call DisablePerSessionThreads, so the number of threads doesn't grow with the number of sessions.
+   * The environment must outlive those sessions.
+   */
+  OrtStatus*(ORT_API_CALL* CreateEnvWithGlobalThreadPools)(OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                                                           _In_ const OrtThreadingOptions* threading_options,
+                                                           _Outptr_ OrtEnv** out)NO_EXCEPTION;
+
+  /**
+   * Options of the global thread pools. The pool sizes default to 0, which has the same meaning as for
+   * SetIntraOpNumThreads and SetInterOpNumThreads.
+   */
+  OrtStatus*(ORT_API_CALL* CreateThreadingOptions)(_Outptr_ OrtThreadingOptions** out)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* SetGlobalIntraOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* SetGlobalInterOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads)NO_EXCEPTION;
+
+  /**
+   * allow_spinning = 1, the default, lets idle threads spin for a while before blocking. Pass 0 to block right
+   * away, e.g. when the pools share the cores with other work.
+   */
+  OrtStatus*(ORT_API_CALL* SetGlobalSpinControl)(_Inout_ OrtThreadingOptions* tp_options, int allow_spinning)NO_EXCEPTION;
+
+  /**
+   * Pin the i-th thread of the global intra-op pool to logical_processors[i % count].
+   */
+  OrtStatus*(ORT_API_CALL* SetGlobalIntraOpThreadAffinity)(_Inout_ OrtThreadingOptions* tp_options,
+                                                           _In_ const int* logical_processors, size_t count)NO_EXCEPTION;
+  ORT_CLASS_RELEASE(ThreadingOptions);
+
+  /**
+   * Use the thread pools of the environment instead of creating ones for the session.
+   * The environment must have been created with CreateEnvWithGlobalThreadPools.
+   */
+  OrtStatus*(ORT_API_CALL* DisablePerSessionThreads)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Pin the i-th thread of the session's intra-op thread pool to logical_processors[i % count].
+   */
+  OrtStatus*(ORT_API_CALL* SetIntraOpThreadAffinity)(_Inout_ OrtSessionOptions* options,
+                                                     _In_ const int* logical_processors, size_t count)NO_EXCEPTION;
+
+  /**
+   * Run the session on a NUMA node, -1 for none: the threads of the session's intra-op thread pool are pinned to
+   * the processors of the node unless SetIntraOpThreadAffinity is used, the pool has as many threads as the node
+   * has processors unless SetIntraOpNumThreads is used, and the memory of the default CPU execution provider is
+   * allocated on the node.
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionNumaNode)(_Inout_ OrtSessionOptions* options, int numa_node)NO_EXCEPTION;
+
+  /**
+   * Write what each graph transformer did to the graph, and the op types and execution providers of the nodes of
+   * the final graph, to optimization_report_filepath as JSON when the session is initialized.
+   */
+  OrtStatus*(ORT_API_CALL* SetOptimizationReportFilePath)(_Inout_ OrtSessionOptions* options,
+                                                          _In_ const ORTCHAR_T* optimization_report_filepath)NO_EXCEPTION;
+
+  /**
+   * The bytes in use and the high-water mark of the bytes in use, summed over the memory arenas of the session.
+   * Can be called while Runs are in progress.
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetArenaUsage)(_In_ const OrtSession* sess, _Out_ size_t* bytes_in_use,
+                                                 _Out_ size_t* max_bytes_in_use)NO_EXCEPTION;
+
+  /**
+   * Run the session 'warmup_runs' times at the end of its initialization, so the work of the first Runs, such as
+   * the growth of the arenas or the algorithm search of the kernels, happens when the session is created.
+   * \param warmup_inputs_path directory with the inputs as TensorProto files input_0.pb, input_1.pb, ..., or null
+   * to generate zero-filled inputs, with 1 for their free dimensions.
+   */
+  OrtStatus*(ORT_API_CALL* SetSessionWarmup)(_Inout_ OrtSessionOptions* options, unsigned warmup_runs,
+                                             _In_opt_ const ORTCHAR_T* warmup_inputs_path)NO_EXCEPTION;
+
+  /**
+   * Same as Run, but queues the Run and returns immediately. The Run executes on a thread pool of the session, of
+   * the session's inter-op number of threads, which then calls callback with user_data.
+   * The run options are copied by this call. The inputs and the preallocated outputs must stay valid until
+   * callback is called.
+   * Pending Runs complete before the session is released.
+   * \param output An array of output_names_len entries, each of which is a preallocated output or NULL.
+   *        It is only read by this call, the values are passed to callback.
+   */
+  OrtStatus*(ORT_API_CALL* RunAsync)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                     _In_ const char* const* input_names, _In_ const OrtValue* const* input,
+                                     size_t input_len, _In_ const char* const* output_names, size_t output_names_len,
+                                     _Inout_ OrtValue** output, _In_ RunAsyncCallbackFn callback,
+                                     _In_opt_ void* user_data)NO_EXCEPTION;
+
+  /**
+   * Runs fn over the iterations [0, total), in contiguous blocks, on the intra-op thread pool of the session running
+   * the kernel, as the built-in kernels do. Runs fn(user_data, 0, total) on the calling thread if the session has no
+   * pool. Returns when every block has run.
+   * \param cost_per_unit The approximate cost of an iteration in cycles, or 0 if unknown. Ranges of cheap iterations
+   *        run on the calling thread.
+   */
+  OrtStatus*(ORT_API_CALL* KernelContext_ParallelFor)(_Inout_ OrtKernelContext* context, _In_ OrtParallelForFn fn,
+                                                      _In_opt_ void* user_data, size_t total,
+                                                      double cost_per_unit)NO_EXCEPTION;
+
+  /**
+   * Place the nodes an execution provider other than CPU claims on it only where it is estimated to be faster than
+   * leaving them to the CPU execution provider, including the copies between the two.
+   * \param cost_filepath file the placement decisions are loaded from, if it exists, and saved to, so later sessions
+   *        of the same model reuse them, or null for none.
+   */
+  OrtStatus*(ORT_API_CALL* EnableCostBasedPartitioning)(_Inout_ OrtSessionOptions* options,
+                                                        _In_opt_ const ORTCHAR_T* cost_filepath)NO_EXCEPTION;
+
+  /**
+   * Back the large allocations of the default CPU execution provider, including the ones holding the initializers,
+   * with huge pages where the platform has them available, and with the usual pages otherwise.
+   */
+  OrtStatus*(ORT_API_CALL* EnableHugePages)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * The bytes of the memory held by the arenas of the session that is backed by huge pages, see EnableHugePages.
+   */
+  OrtStatus*(ORT_API_CALL* SessionGetHugePageBytes)(_In_ const OrtSession* sess, _Out_ size_t* bytes)NO_EXCEPTION;
+
+  /**
+   * Set the deadline of the Runs using these options to timeout_us microseconds from now. A Run still executing
+   * at the deadline stops and returns an error status, and a Run started past it returns the error without
+   * running. 0 removes the deadline.
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetTimeout)(_Inout_ OrtRunOptions* options, int64_t timeout_us)NO_EXCEPTION;
+
+  /**
+   * The order of the queued Runs using these options, the ones of higher priority are run first. 0 by default.
+   */
+  OrtStatus*(ORT_API_CALL* RunOptionsSetPriority)(_Inout_ OrtRunOptions* options, int value)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* RunOptionsGetPriority)(_In_ const OrtRunOptions* options, _Out_ int* out)NO_EXCEPTION;
+
+  /**
+   * Create a session running the models of a pipeline, such as a preprocessing model, a backbone and a
+   * postprocessing model, composed into a single graph. Each input of a model is fed by the output of the same name
+   * of the latest earlier model producing one, and is an input of the session otherwise. The outputs of the session
+   * are the outputs of the models that don't feed a later one.
+   */
+  OrtStatus*(ORT_API_CALL* CreateSessionFromModels)(_In_ const OrtEnv* env,
+                                                    _In_ const ORTCHAR_T* const* model_paths,
+                                                    size_t num_models, _In_ const OrtSessionOptions* options,
+                                                    _Outptr_ OrtSession** out)NO_EXCEPTION;
 };
 
 typedef struct OrtApi OrtApi;
@@ -629,8 +880,11 @@ ORT_API(const char*, OrtGetVersionString);
  * The OrtCustomOp structure defines a custom op's schema and its kernel callbacks. The callbacks are filled in by
  * the implementor of the custom op.
 */
+// Version of OrtCustomOp with the in-place, alias and output memory callbacks. Ops of version 1 end at KernelDestroy.
+#define ORT_CUSTOM_OP_VERSION 2
+
 struct OrtCustomOp {
-  uint32_t version;  // Initialize to ORT_API_VERSION
+  uint32_t version;  // Initialize to ORT_CUSTOM_OP_VERSION, or to ORT_API_VERSION for an op without the fields of version 2
 
   // This callback creates the kernel, which is a user defined parameter that is passed to the Kernel* callbacks below.
   void*(ORT_API_CALL* CreateKernel)(_In_ struct OrtCustomOp* op, _In_ const OrtApi* api, _In_ const OrtKernelInfo* info);
@@ -650,6 +904,20 @@ struct OrtCustomOp {
   // Op kernel callbacks
   void(ORT_API_CALL* KernelCompute)(_In_ void* op_kernel, _In_ OrtKernelContext* context);
   void(ORT_API_CALL* KernelDestroy)(_In_ void* op_kernel);
+
+  // Version 2. Each of these may be NULL.
+
+  // Returns the index of an input whose buffer the output may be written into, or -1.
+  // The output then reuses the buffer when nothing else reads the input, as with MayInplace of a built-in kernel.
+  int(ORT_API_CALL* GetMayInplaceInput)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
+
+  // Returns the index of an input the output is an alias of, sharing its buffer and content, or -1.
+  // As with Alias of a built-in kernel like Reshape, the kernel gets the buffer of the input from KernelContext_GetOutput.
+  int(ORT_API_CALL* GetAliasInput)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
+
+  // Returns where the output is allocated, e.g. OrtMemTypeCPUOutput for an output of a GPU kernel that it writes
+  // from the CPU. NULL allocates every output in the default memory of the execution provider.
+  OrtMemType(ORT_API_CALL* GetOutputMemoryType)(_In_ struct OrtCustomOp* op, _In_ size_t output_index);
 };
 
 /*
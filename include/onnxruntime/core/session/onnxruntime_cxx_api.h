@@ -16,6 +16,8 @@
 #include "onnxruntime_c_api.h"
 #include <cstddef>
 #include <array>
+#include <functional>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -48,10 +50,13 @@ struct Exception : std::exception {
 ORT_DEFINE_RELEASE(MemoryInfo);
 ORT_DEFINE_RELEASE(CustomOpDomain);
 ORT_DEFINE_RELEASE(Env);
+ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(PreparedRun);
 ORT_DEFINE_RELEASE(RunOptions);
 ORT_DEFINE_RELEASE(Session);
 ORT_DEFINE_RELEASE(SessionOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
+ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
 
@@ -98,12 +103,25 @@ struct Unowned : T {
 struct AllocatorWithDefaultOptions;
 struct MemoryInfo;
 struct Env;
+struct IoBinding;
 struct TypeInfo;
 struct Value;
 
+struct ThreadingOptions : Base<OrtThreadingOptions> {
+  explicit ThreadingOptions(nullptr_t) {}
+  ThreadingOptions();
+
+  ThreadingOptions& SetGlobalIntraOpNumThreads(int intra_op_num_threads);
+  ThreadingOptions& SetGlobalInterOpNumThreads(int inter_op_num_threads);
+  ThreadingOptions& SetGlobalSpinControl(bool allow_spinning);
+  ThreadingOptions& SetGlobalIntraOpThreadAffinity(const std::vector<int>& logical_processors);
+};
+
 struct Env : Base<OrtEnv> {
   Env(nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level, _In_ const char* logid);
+  // the thread pools of the environment are shared by the sessions whose options call DisablePerSessionThreads
+  Env(const ThreadingOptions& threading_options, OrtLoggingLevel default_logging_level, _In_ const char* logid);
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
 
@@ -134,6 +152,15 @@ struct RunOptions : Base<OrtRunOptions> {
   RunOptions& SetTerminate();
   // unset the terminate flag so this RunOptions instance can be used in a new Session::Run call
   RunOptions& UnsetTerminate();
+
+  // limit the intra-op threads, including the calling one, of the Session::Run calls using this instance
+  RunOptions& SetIntraOpNumThreads(int intra_op_num_threads);
+  int GetIntraOpNumThreads() const;
+
+  // see OrtApi::RunOptionsSetTimeout and OrtApi::RunOptionsSetPriority
+  RunOptions& SetTimeout(int64_t timeout_us);
+  RunOptions& SetPriority(int priority);
+  int GetPriority() const;
 };
 
 struct SessionOptions : Base<OrtSessionOptions> {
@@ -145,12 +172,20 @@ struct SessionOptions : Base<OrtSessionOptions> {
 
   SessionOptions& SetIntraOpNumThreads(int intra_op_num_threads);
   SessionOptions& SetInterOpNumThreads(int inter_op_num_threads);
+  // use the thread pools of the Env the session is created with, see OrtApi::DisablePerSessionThreads
+  SessionOptions& DisablePerSessionThreads();
+  SessionOptions& SetIntraOpThreadAffinity(const std::vector<int>& logical_processors);
+  SessionOptions& SetNumaNode(int numa_node);
   SessionOptions& SetGraphOptimizationLevel(GraphOptimizationLevel graph_optimization_level);
 
   SessionOptions& EnableCpuMemArena();
   SessionOptions& DisableCpuMemArena();
 
   SessionOptions& SetOptimizedModelFilePath(const ORTCHAR_T* optimized_model_file);
+  SessionOptions& SetOptimizationReportFilePath(const ORTCHAR_T* optimization_report_file);
+  SessionOptions& SetWarmup(unsigned warmup_runs, const ORTCHAR_T* warmup_inputs_path = nullptr);
+  SessionOptions& EnableCostBasedPartitioning(const ORTCHAR_T* cost_filepath = nullptr);
+  SessionOptions& EnableHugePages();
 
   SessionOptions& EnableProfiling(const ORTCHAR_T* profile_file_prefix);
   SessionOptions& DisableProfiling();
@@ -164,12 +199,23 @@ struct SessionOptions : Base<OrtSessionOptions> {
   SessionOptions& SetLogId(const char* logid);
 
   SessionOptions& Add(OrtCustomOpDomain* custom_op_domain);
+
+  // the value is shared by the sessions created with the options, see OrtApi::AddInitializer
+  SessionOptions& AddInitializer(const char* name, const Value& value);
+};
+
+// The input and output names of Runs of a Session resolved once, see Session::CreatePreparedRun
+struct PreparedRun : Base<OrtPreparedRun> {
+  explicit PreparedRun(nullptr_t) {}
+  explicit PreparedRun(OrtPreparedRun* p) : Base<OrtPreparedRun>{p} {}
 };
 
 struct Session : Base<OrtSession> {
   explicit Session(nullptr_t) {}
   Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options);
   Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options);
+  // the models of a pipeline composed into one session, see OrtApi::CreateSessionFromModels
+  Session(Env& env, const std::vector<const ORTCHAR_T*>& model_paths, const SessionOptions& options);
 
   // Run that will allocate the output values
   std::vector<Value> Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
@@ -178,6 +224,24 @@ struct Session : Base<OrtSession> {
   void Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
 
+  // The memory infos are where the inputs will be and the outputs will be returned, nullptr for all on CPU
+  PreparedRun CreatePreparedRun(const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count,
+                                const OrtMemoryInfo* const* input_memory_infos = nullptr,
+                                const OrtMemoryInfo* const* output_memory_infos = nullptr);
+  // Runs with the inputs and outputs in the order of the names of the prepared run
+  std::vector<Value> Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                         Value* input_values, size_t input_count, size_t output_count);
+  void Run(const RunOptions& run_options, const PreparedRun& prepared_run, Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+  // Runs with the inputs and outputs bound to the binding
+  void Run(const RunOptions& run_options, IoBinding& io_binding);
+  // Queues a Run on the threads of the session, see OrtApi::RunAsync. The future throws Ort::Exception if it fails.
+  // The run options are copied, the inputs must stay valid until the future is ready.
+  std::future<std::vector<Value>> RunAsync(const RunOptions& run_options, const char* const* input_names,
+                                           Value* input_values, size_t input_count,
+                                           const char* const* output_names, size_t output_count);
+
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
   size_t GetOverridableInitializerCount() const;
@@ -189,6 +253,28 @@ struct Session : Base<OrtSession> {
   TypeInfo GetInputTypeInfo(size_t index) const;
   TypeInfo GetOutputTypeInfo(size_t index) const;
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;
+
+  // summed over the memory arenas of the session, see OrtApi::SessionGetArenaUsage
+  void GetArenaUsage(size_t& bytes_in_use, size_t& max_bytes_in_use) const;
+  // see OrtApi::SessionGetHugePageBytes
+  size_t GetHugePageBytes() const;
+};
+
+// The inputs and outputs of Runs of a Session bound to values, see OrtApi::CreateIoBinding
+struct IoBinding : Base<OrtIoBinding> {
+  explicit IoBinding(nullptr_t) {}
+  explicit IoBinding(Session& session);
+
+  void BindInput(const char* name, const Value& value);
+  void BindOutput(const char* name, const Value& value);
+  // the output is allocated by the Runs in the memory of the info, e.g. on the GPU
+  void BindOutput(const char* name, const OrtMemoryInfo* memory_info);
+
+  // the values of the bound outputs after a Run, in the order they were bound
+  std::vector<Value> GetOutputValues() const;
+
+  void ClearBoundInputs();
+  void ClearBoundOutputs();
 };
 
 struct TensorTypeAndShapeInfo : Base<OrtTensorTypeAndShapeInfo> {
@@ -300,6 +386,9 @@ struct CustomOpApi {
   const OrtValue* KernelContext_GetInput(const OrtKernelContext* context, _In_ size_t index);
   size_t KernelContext_GetOutputCount(const OrtKernelContext* context);
   OrtValue* KernelContext_GetOutput(OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count);
+  // Runs fn(begin, end) over blocks of [0, total) on the intra-op thread pool of the session. fn must not throw.
+  void KernelContext_ParallelFor(OrtKernelContext* context, size_t total, double cost_per_unit,
+                                 const std::function<void(size_t begin, size_t end)>& fn);
 
   void ThrowOnError(OrtStatus* result);
 
@@ -310,7 +399,7 @@ struct CustomOpApi {
 template <typename TOp, typename TKernel>
 struct CustomOpBase : OrtCustomOp {
   CustomOpBase() {
-    OrtCustomOp::version = ORT_API_VERSION;
+    OrtCustomOp::version = ORT_CUSTOM_OP_VERSION;
     OrtCustomOp::CreateKernel = [](OrtCustomOp* this_, const OrtApi* api, const OrtKernelInfo* info) { return static_cast<TOp*>(this_)->CreateKernel(*api, info); };
     OrtCustomOp::GetName = [](OrtCustomOp* this_) { return static_cast<TOp*>(this_)->GetName(); };
 
@@ -324,10 +413,19 @@ struct CustomOpBase : OrtCustomOp {
 
     OrtCustomOp::KernelCompute = [](void* op_kernel, OrtKernelContext* context) { static_cast<TKernel*>(op_kernel)->Compute(context); };
     OrtCustomOp::KernelDestroy = [](void* op_kernel) { delete static_cast<TKernel*>(op_kernel); };
+
+    OrtCustomOp::GetMayInplaceInput = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetMayInplaceInput(index); };
+    OrtCustomOp::GetAliasInput = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetAliasInput(index); };
+    OrtCustomOp::GetOutputMemoryType = [](OrtCustomOp* this_, size_t index) { return static_cast<TOp*>(this_)->GetOutputMemoryType(index); };
   }
 
   // Default implementation of GetExecutionProviderType that returns nullptr to default to the CPU provider
   const char* GetExecutionProviderType() const { return nullptr; }
+
+  // Default implementations of the in-place, alias and output memory declarations, which declare none
+  int GetMayInplaceInput(size_t /*index*/) const { return -1; }
+  int GetAliasInput(size_t /*index*/) const { return -1; }
+  OrtMemType GetOutputMemoryType(size_t /*index*/) const { return OrtMemTypeDefault; }
 };
 
 }  // namespace Ort
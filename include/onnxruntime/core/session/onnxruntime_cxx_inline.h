@@ -89,6 +89,35 @@ inline Env::Env(OrtLoggingLevel default_warning_level, _In_ const char* logid) {
   ThrowOnError(g_api->CreateEnv(default_warning_level, logid, &p_));
 }
 
+inline Env::Env(const ThreadingOptions& threading_options, OrtLoggingLevel default_warning_level,
+                _In_ const char* logid) {
+  ThrowOnError(g_api->CreateEnvWithGlobalThreadPools(default_warning_level, logid, threading_options, &p_));
+}
+
+inline ThreadingOptions::ThreadingOptions() {
+  ThrowOnError(g_api->CreateThreadingOptions(&p_));
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpNumThreads(int intra_op_num_threads) {
+  ThrowOnError(g_api->SetGlobalIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpNumThreads(int inter_op_num_threads) {
+  ThrowOnError(g_api->SetGlobalInterOpNumThreads(p_, inter_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalSpinControl(bool allow_spinning) {
+  ThrowOnError(g_api->SetGlobalSpinControl(p_, allow_spinning ? 1 : 0));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpThreadAffinity(const std::vector<int>& logical_processors) {
+  ThrowOnError(g_api->SetGlobalIntraOpThreadAffinity(p_, logical_processors.data(), logical_processors.size()));
+  return *this;
+}
+
 inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param) {
   ThrowOnError(g_api->CreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
@@ -142,6 +171,33 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetIntraOpNumThreads(int intra_op_num_threads) {
+  ThrowOnError(g_api->RunOptionsSetIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline int RunOptions::GetIntraOpNumThreads() const {
+  int out;
+  ThrowOnError(g_api->RunOptionsGetIntraOpNumThreads(p_, &out));
+  return out;
+}
+
+inline RunOptions& RunOptions::SetTimeout(int64_t timeout_us) {
+  ThrowOnError(g_api->RunOptionsSetTimeout(p_, timeout_us));
+  return *this;
+}
+
+inline RunOptions& RunOptions::SetPriority(int priority) {
+  ThrowOnError(g_api->RunOptionsSetPriority(p_, priority));
+  return *this;
+}
+
+inline int RunOptions::GetPriority() const {
+  int out;
+  ThrowOnError(g_api->RunOptionsGetPriority(p_, &out));
+  return out;
+}
+
 inline SessionOptions::SessionOptions() {
   ThrowOnError(g_api->CreateSessionOptions(&p_));
 }
@@ -172,6 +228,26 @@ inline SessionOptions& SessionOptions::SetOptimizedModelFilePath(const ORTCHAR_T
   return *this;
 }
 
+inline SessionOptions& SessionOptions::SetOptimizationReportFilePath(const ORTCHAR_T* optimization_report_filepath) {
+  ThrowOnError(g_api->SetOptimizationReportFilePath(p_, optimization_report_filepath));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetWarmup(unsigned warmup_runs, const ORTCHAR_T* warmup_inputs_path) {
+  ThrowOnError(g_api->SetSessionWarmup(p_, warmup_runs, warmup_inputs_path));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableCostBasedPartitioning(const ORTCHAR_T* cost_filepath) {
+  ThrowOnError(g_api->EnableCostBasedPartitioning(p_, cost_filepath));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableHugePages() {
+  ThrowOnError(g_api->EnableHugePages(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::EnableProfiling(const ORTCHAR_T* profile_file_prefix) {
   ThrowOnError(g_api->EnableProfiling(p_, profile_file_prefix));
   return *this;
@@ -187,6 +263,21 @@ inline SessionOptions& SessionOptions::EnableMemPattern() {
   return *this;
 }
 
+inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
+  ThrowOnError(g_api->DisablePerSessionThreads(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetIntraOpThreadAffinity(const std::vector<int>& logical_processors) {
+  ThrowOnError(g_api->SetIntraOpThreadAffinity(p_, logical_processors.data(), logical_processors.size()));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetNumaNode(int numa_node) {
+  ThrowOnError(g_api->SetSessionNumaNode(p_, numa_node));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::DisableMemPattern() {
   ThrowOnError(g_api->DisableMemPattern(p_));
   return *this;
@@ -221,10 +312,19 @@ inline SessionOptions& SessionOptions::Add(OrtCustomOpDomain* custom_op_domain)
   return *this;
 }
 
+inline SessionOptions& SessionOptions::AddInitializer(const char* name, const Value& value) {
+  ThrowOnError(g_api->AddInitializer(p_, name, value));
+  return *this;
+}
+
 inline Session::Session(Env& env, const ORTCHAR_T* model_path, const SessionOptions& options) {
   ThrowOnError(g_api->CreateSession(env, model_path, options, &p_));
 }
 
+inline Session::Session(Env& env, const std::vector<const ORTCHAR_T*>& model_paths, const SessionOptions& options) {
+  ThrowOnError(g_api->CreateSessionFromModels(env, model_paths.data(), model_paths.size(), options, &p_));
+}
+
 inline Session::Session(Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options) {
   ThrowOnError(g_api->CreateSessionFromArray(env, model_data, model_data_length, options, &p_));
 }
@@ -246,6 +346,71 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(g_api->Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline PreparedRun Session::CreatePreparedRun(const char* const* input_names, size_t input_count,
+                                              const char* const* output_names, size_t output_count,
+                                              const OrtMemoryInfo* const* input_memory_infos,
+                                              const OrtMemoryInfo* const* output_memory_infos) {
+  OrtPreparedRun* out;
+  ThrowOnError(g_api->CreatePreparedRun(p_, input_names, input_memory_infos, input_count,
+                                        output_names, output_memory_infos, output_count, &out));
+  return PreparedRun{out};
+}
+
+inline std::vector<Value> Session::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                       Value* input_values, size_t input_count, size_t output_count) {
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  Run(run_options, prepared_run, input_values, input_count, output_values.data(), output_count);
+  return output_values;
+}
+
+inline void Session::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                         Value* input_values, size_t input_count, Value* output_values, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(g_api->RunPrepared(p_, run_options, prepared_run, ort_input_values, input_count,
+                                  ort_output_values, output_count));
+}
+
+inline void Session::Run(const RunOptions& run_options, IoBinding& io_binding) {
+  ThrowOnError(g_api->RunWithBinding(p_, run_options, io_binding));
+}
+
+namespace detail {
+inline void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                          const OrtStatus* status) {
+  std::unique_ptr<std::promise<std::vector<Value>>> promise{static_cast<std::promise<std::vector<Value>>*>(user_data)};
+  if (status != nullptr) {
+    promise->set_exception(std::make_exception_ptr(
+        Ort::Exception(g_api->GetErrorMessage(status), g_api->GetErrorCode(status))));
+    return;
+  }
+
+  std::vector<Value> output_values;
+  for (size_t i = 0; i < num_outputs; i++)
+    output_values.emplace_back(outputs[i]);
+  promise->set_value(std::move(output_values));
+}
+}  // namespace detail
+
+inline std::future<std::vector<Value>> Session::RunAsync(const RunOptions& run_options, const char* const* input_names,
+                                                         Value* input_values, size_t input_count,
+                                                         const char* const* output_names, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  std::vector<OrtValue*> ort_output_values(output_count, nullptr);
+
+  // the callback owns the promise once the Run is queued
+  std::unique_ptr<std::promise<std::vector<Value>>> promise{new std::promise<std::vector<Value>>()};
+  auto future = promise->get_future();
+  ThrowOnError(g_api->RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names,
+                               output_count, ort_output_values.data(), &detail::RunAsyncCallback, promise.get()));
+  promise.release();
+  return future;
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(g_api->SessionGetInputCount(p_, &out));
@@ -300,6 +465,51 @@ inline TypeInfo Session::GetOverridableInitializerTypeInfo(size_t index) const {
   return TypeInfo{out};
 }
 
+inline void Session::GetArenaUsage(size_t& bytes_in_use, size_t& max_bytes_in_use) const {
+  ThrowOnError(g_api->SessionGetArenaUsage(p_, &bytes_in_use, &max_bytes_in_use));
+}
+
+inline size_t Session::GetHugePageBytes() const {
+  size_t bytes;
+  ThrowOnError(g_api->SessionGetHugePageBytes(p_, &bytes));
+  return bytes;
+}
+
+inline IoBinding::IoBinding(Session& session) {
+  ThrowOnError(g_api->CreateIoBinding(session, &p_));
+}
+
+inline void IoBinding::BindInput(const char* name, const Value& value) {
+  ThrowOnError(g_api->BindInput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const Value& value) {
+  ThrowOnError(g_api->BindOutput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const OrtMemoryInfo* memory_info) {
+  ThrowOnError(g_api->BindOutputToDevice(p_, name, memory_info));
+}
+
+inline std::vector<Value> IoBinding::GetOutputValues() const {
+  size_t output_count;
+  ThrowOnError(g_api->GetBoundOutputCount(p_, &output_count));
+  std::vector<OrtValue*> ort_output_values(output_count);
+  ThrowOnError(g_api->GetBoundOutputValues(p_, ort_output_values.data(), output_count));
+  std::vector<Value> output_values;
+  for (auto* ort_value : ort_output_values)
+    output_values.emplace_back(ort_value);
+  return output_values;
+}
+
+inline void IoBinding::ClearBoundInputs() {
+  g_api->ClearBoundInputs(p_);
+}
+
+inline void IoBinding::ClearBoundOutputs() {
+  g_api->ClearBoundOutputs(p_);
+}
+
 inline ONNXTensorElementDataType TensorTypeAndShapeInfo::GetElementType() const {
   ONNXTensorElementDataType out;
   ThrowOnError(g_api->GetTensorElementType(p_, &out));
@@ -553,4 +763,12 @@ inline OrtValue* CustomOpApi::KernelContext_GetOutput(OrtKernelContext* context,
   return out;
 }
 
+inline void CustomOpApi::KernelContext_ParallelFor(OrtKernelContext* context, size_t total, double cost_per_unit,
+                                                   const std::function<void(size_t begin, size_t end)>& fn) {
+  using Fn = std::function<void(size_t begin, size_t end)>;
+  ThrowOnError(api_.KernelContext_ParallelFor(
+      context, [](void* user_data, size_t begin, size_t end) { (*static_cast<const Fn*>(user_data))(begin, end); },
+      const_cast<Fn*>(&fn), total, cost_per_unit));
+}
+
 }  // namespace Ort
@@ -4,6 +4,8 @@
 #include "core/common/common.h"
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 #include "core/automl/featurizers/src/FeaturizerPrep/Featurizers/DateTimeFeaturizer.h"
 
@@ -38,5 +40,89 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>())
         .TypeConstraint("T2", DataTypeImpl::GetType<Microsoft::Featurizer::DateTimeFeaturizer::TimePoint>()),
     DateTimeTransformer);
+
+constexpr int64_t kTimePointFieldCount = 10;
+
+// Splits seconds since the epoch into the fields of dtf::TimePoint, like gmtime, with the conversion of days to
+// civil dates of http://howardhinnant.github.io/date_algorithms.html, which avoids the calls into the C runtime.
+static void ToTimePointFields(int64_t seconds, int32_t* fields) {
+  const int64_t days = seconds / 86400;
+  const int64_t seconds_of_day = seconds % 86400;
+
+  // the era of 400 years starting on March 1st, 0000 that contains the date
+  const int64_t z = days + 719468;
+  const int64_t era = z / 146097;
+  const int64_t day_of_era = z - era * 146097;
+  const int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  const int64_t day_of_march_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  const int64_t march_month = (5 * day_of_march_year + 2) / 153;
+  const int32_t day = static_cast<int32_t>(day_of_march_year - (153 * march_month + 2) / 5 + 1);
+  const int32_t month = static_cast<int32_t>(march_month < 10 ? march_month + 3 : march_month - 9);
+  const int32_t year = static_cast<int32_t>(year_of_era + era * 400 + (month <= 2 ? 1 : 0));
+
+  // March 1st is the 59th day of the year, or the 60th in leap years
+  const bool is_leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  const int32_t day_of_year = static_cast<int32_t>(
+      day_of_march_year >= 306 ? day_of_march_year - 306 : day_of_march_year + 59 + (is_leap ? 1 : 0));
+
+  fields[0] = year;
+  fields[1] = month;
+  fields[2] = day;
+  fields[3] = static_cast<int32_t>(seconds_of_day / 3600);
+  fields[4] = static_cast<int32_t>(seconds_of_day / 60 % 60);
+  fields[5] = static_cast<int32_t>(seconds_of_day % 60);
+  // January 1st, 1970 was a Thursday
+  fields[6] = static_cast<int32_t>((days + 4) % 7);
+  fields[7] = day_of_year;
+  fields[8] = (month + 2) / 3;
+  fields[9] = (day - 1) / 7;
+}
+
+class DateTimeBatchTransformer final : public OpKernel {
+ public:
+  explicit DateTimeBatchTransformer(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+Status DateTimeBatchTransformer::Compute(OpKernelContext* ctx) const {
+  const auto* input_tensor = ctx->Input<Tensor>(0);
+  const auto& input_shape = input_tensor->Shape();
+  std::vector<int64_t> output_dims = input_shape.GetDims();
+  output_dims.push_back(kTimePointFieldCount);
+  auto* output_tensor = ctx->Output(0, TensorShape(output_dims));
+
+  const int64_t* input = input_tensor->Data<int64_t>();
+  int32_t* output = output_tensor->MutableData<int32_t>();
+  const auto count = static_cast<std::ptrdiff_t>(input_shape.Size());
+  for (std::ptrdiff_t i = 0; i < count; ++i) {
+    if (input[i] < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Dates prior to 1970 are not supported.");
+    }
+  }
+
+  auto convert = [input, output](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      ToTimePointFields(input[i], output + i * kTimePointFieldCount);
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr) {
+    tp->ParallelFor(count, 50.0, convert);
+  } else {
+    convert(0, count);
+  }
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    DateTimeBatchTransformer,
+    kMSAutoMLDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int32_t>()),
+    DateTimeBatchTransformer);
 }  // namespace automl
 }  // namespace onnxruntime
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    Attention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Attention<float>);
+
+Status AttentionBase::CheckInputs(const Tensor* input, const Tensor* weights, const Tensor* bias,
+                                  const Tensor* mask) const {
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 3 dimensions, got ",
+                           dims.size());
+  }
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+  const int64_t hidden_size = dims[2];
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "hidden_size ", hidden_size,
+                           " is not a multiple of num_heads ", num_heads_);
+  }
+
+  const auto& weights_dims = weights->Shape().GetDims();
+  if (weights_dims.size() != 2 || weights_dims[0] != hidden_size || weights_dims[1] != 3 * hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weight' is expected to have shape (",
+                           hidden_size, ", ", 3 * hidden_size, "), got ", weights->Shape());
+  }
+
+  const auto& bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1 || bias_dims[0] != 3 * hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' is expected to have shape (",
+                           3 * hidden_size, "), got ", bias->Shape());
+  }
+
+  if (mask != nullptr) {
+    const auto& mask_dims = mask->Shape().GetDims();
+    const bool valid_2d = mask_dims.size() == 2 && mask_dims[0] == batch_size && mask_dims[1] == sequence_length;
+    const bool valid_4d = mask_dims.size() == 4 && mask_dims[0] == batch_size && mask_dims[1] == 1 &&
+                          mask_dims[2] == 1 && mask_dims[3] == sequence_length;
+    if (!valid_2d && !valid_4d) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'mask' is expected to have shape (",
+                             batch_size, ", ", sequence_length, ") or (", batch_size, ", 1, 1, ", sequence_length,
+                             "), got ", mask->Shape());
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status Attention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask));
+
+  const auto& dims = input->Shape().GetDims();
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  const int head_size = hidden_size / num_heads_;
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  // Compute Q, K and V of every head with one GEMM: qkv(B * S, 3 * H) = input x weights + bias.
+  // Row r of qkv holds Q, K and V of token r, each as num_heads consecutive blocks of head_size.
+  const size_t m = static_cast<size_t>(batch_size) * sequence_length;
+  const size_t qkv_stride = 3 * static_cast<size_t>(hidden_size);
+  auto qkv_data = alloc->Alloc(sizeof(T) * m * qkv_stride);
+  BufferUniquePtr qkv_buffer(qkv_data, BufferDeleter(alloc));
+  T* qkv = static_cast<T*>(qkv_buffer.get());
+
+  const T* bias_data = bias->template Data<T>();
+  for (size_t r = 0; r < m; ++r) {
+    memcpy(qkv + r * qkv_stride, bias_data, sizeof(T) * qkv_stride);
+  }
+
+  MlasSgemm(CblasNoTrans, CblasNoTrans, m, qkv_stride, static_cast<size_t>(hidden_size),
+            1.0f, input->template Data<T>(), static_cast<size_t>(hidden_size),
+            weights->template Data<T>(), qkv_stride,
+            1.0f, qkv, qkv_stride, tp);
+
+  // Each (batch, head) pair is independent. The scores of each pair get their own (S, S) scratch block.
+  const size_t scores_size = static_cast<size_t>(sequence_length) * sequence_length;
+  auto scores_data = alloc->Alloc(sizeof(T) * batch_size * num_heads_ * scores_size);
+  BufferUniquePtr scores_buffer(scores_data, BufferDeleter(alloc));
+  T* scores = static_cast<T*>(scores_buffer.get());
+
+  const T* mask_data = mask != nullptr ? mask->template Data<T>() : nullptr;
+  T* output_data = output->template MutableData<T>();
+  const float alpha = 1.0f / std::sqrt(static_cast<float>(head_size));
+  const int num_heads = num_heads_;
+
+  auto compute_heads = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      const int batch = static_cast<int>(i / num_heads);
+      const int head = static_cast<int>(i % num_heads);
+      const T* q = qkv + static_cast<size_t>(batch) * sequence_length * qkv_stride + head * head_size;
+      const T* k = q + hidden_size;
+      const T* v = k + hidden_size;
+      T* head_scores = scores + i * scores_size;
+
+      // scores(S, S) = Q x K' / sqrt(head_size) + mask, with the mask broadcast over the rows.
+      float beta = 0.0f;
+      if (mask_data != nullptr) {
+        for (int row = 0; row < sequence_length; ++row) {
+          memcpy(head_scores + row * sequence_length, mask_data + batch * sequence_length,
+                 sizeof(T) * sequence_length);
+        }
+        beta = 1.0f;
+      }
+      MlasSgemm(CblasNoTrans, CblasTrans, sequence_length, sequence_length, head_size,
+                alpha, q, qkv_stride, k, qkv_stride,
+                beta, head_scores, sequence_length, nullptr);
+
+      MlasComputeSoftmax(head_scores, head_scores, sequence_length, sequence_length, false, nullptr);
+
+      // The head's (S, head_size) result is written straight to its columns of the (B, S, H) output.
+      MlasSgemm(CblasNoTrans, CblasNoTrans, sequence_length, head_size, sequence_length,
+                1.0f, head_scores, sequence_length, v, qkv_stride,
+                0.0f, output_data + static_cast<size_t>(batch) * sequence_length * hidden_size + head * head_size,
+                hidden_size, nullptr);
+    }
+  };
+
+  const std::ptrdiff_t task_count = static_cast<std::ptrdiff_t>(batch_size) * num_heads;
+  if (tp == nullptr) {
+    compute_heads(0, task_count);
+  } else {
+    // two (S, S, head_size) GEMMs and the softmax per head
+    const double cost = static_cast<double>(scores_size) * (2 * head_size + 16);
+    tp->ParallelFor(task_count, cost, compute_heads);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attribute handling and input validation shared by the CPU and CUDA Attention kernels.
+class AttentionBase {
+ protected:
+  AttentionBase(const OpKernelInfo& info) {
+    int64_t num_heads = 0;
+    ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+    num_heads_ = static_cast<int>(num_heads);
+  }
+
+  Status CheckInputs(const Tensor* input, const Tensor* weights, const Tensor* bias, const Tensor* mask) const;
+
+  int num_heads_;  // number of attention heads
+};
+
+template <typename T>
+class Attention final : public OpKernel, public AttentionBase {
+ public:
+  Attention(const OpKernelInfo& info) : OpKernel(info), AttentionBase(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
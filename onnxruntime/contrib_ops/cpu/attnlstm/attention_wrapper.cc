@@ -8,6 +8,7 @@
 #include <memory>
 
 using onnxruntime::rnn::detail::Allocate;
+using onnxruntime::rnn::detail::ComputeGemm;
 
 namespace onnxruntime {
 namespace contrib {
@@ -38,11 +39,18 @@ template <typename T>
 void AttentionWrapper<T>::ProcessOutput(const gsl::span<const T>& rnn_cell_output) {
   if (has_attn_layer_) {
     // rnn_cell_output * cell_weights, (part of the attention layer above the attention mechanism).
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    batch_size_, attn_layer_depth_, inner_cell_hidden_size_, T{1.0},
-                    rnn_cell_output.data(), inner_cell_hidden_size_,
-                    attn_layer_cell_weights_.data(), attn_layer_depth_, T{0.0},
-                    attn_states_.data(), attn_layer_depth_, ttp_);
+    if (packed_attn_layer_cell_weights_ != nullptr) {
+      ComputeGemm(batch_size_, attn_layer_depth_, inner_cell_hidden_size_, T{1.0},
+                  rnn_cell_output.cbegin(), rnn_cell_output.cend(), inner_cell_hidden_size_,
+                  *packed_attn_layer_cell_weights_, T{0.0},
+                  attn_states_.begin(), attn_states_.end(), attn_layer_depth_, ttp_);
+    } else {
+      math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
+                      batch_size_, attn_layer_depth_, inner_cell_hidden_size_, T{1.0},
+                      rnn_cell_output.data(), inner_cell_hidden_size_,
+                      attn_layer_cell_weights_.data(), attn_layer_depth_, T{0.0},
+                      attn_states_.data(), attn_layer_depth_, ttp_);
+    }
   }
 
   // Get the context which is calculated within attention mechanism.
@@ -55,11 +63,18 @@ void AttentionWrapper<T>::ProcessOutput(const gsl::span<const T>& rnn_cell_outpu
     //concat([p_cell_output, context]) * stack([attn_layer_cell_weights_, attn_layer_attn_weights_]) =
     //     p_cell_output * attn_layer_cell_weights_ + context * attn_layer_attn_weights_
     // The first part is calulated above. Here just add the later.
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    batch_size_, attn_layer_depth_, attn_context_depth_, T{1.0},
-                    attn_context_.data(), attn_context_depth_,
-                    attn_layer_attn_weights_.data(), attn_layer_depth_, T{1.0},
-                    attn_states_.data(), attn_layer_depth_, ttp_);
+    if (packed_attn_layer_attn_weights_ != nullptr) {
+      ComputeGemm(batch_size_, attn_layer_depth_, attn_context_depth_, T{1.0},
+                  attn_context_.cbegin(), attn_context_.cend(), attn_context_depth_,
+                  *packed_attn_layer_attn_weights_, T{1.0},
+                  attn_states_.begin(), attn_states_.end(), attn_layer_depth_, ttp_);
+    } else {
+      math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
+                      batch_size_, attn_layer_depth_, attn_context_depth_, T{1.0},
+                      attn_context_.data(), attn_context_depth_,
+                      attn_layer_attn_weights_.data(), attn_layer_depth_, T{1.0},
+                      attn_states_.data(), attn_layer_depth_, ttp_);
+    }
   }
 }
 
@@ -69,8 +84,12 @@ gsl::span<const T> AttentionWrapper<T>::GetAttnStates() const {
 }
 
 template <typename T>
-void AttentionWrapper<T>::SetWeights(const gsl::span<const T>& wrapper_weights) {
+void AttentionWrapper<T>::SetWeights(const gsl::span<const T>& wrapper_weights,
+                                     const rnn::detail::PackedWeights* packed_cell_weights,
+                                     const rnn::detail::PackedWeights* packed_attn_weights) {
   has_attn_layer_ = !wrapper_weights.empty();
+  packed_attn_layer_cell_weights_ = packed_cell_weights;
+  packed_attn_layer_attn_weights_ = packed_attn_weights;
 
   if (has_attn_layer_) {
     //cell weight size and attn weight size in the attn layer
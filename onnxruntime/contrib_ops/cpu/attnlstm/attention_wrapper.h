@@ -9,6 +9,7 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
 #include "core/platform/threadpool.h"
+#include "core/providers/cpu/rnn/rnn_helpers.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -32,7 +33,11 @@ class AttentionWrapper {
 
   gsl::span<const T> GetAttnStates() const;
 
-  void SetWeights(const gsl::span<const T>& wrapper_weights);
+  // packed_cell_weights and packed_attn_weights are the two parts of wrapper_weights packed by PackWeights, or
+  // nullptr if they aren't packed.
+  void SetWeights(const gsl::span<const T>& wrapper_weights,
+                  const rnn::detail::PackedWeights* packed_cell_weights = nullptr,
+                  const rnn::detail::PackedWeights* packed_attn_weights = nullptr);
 
   // the size after attention layer or direct from attention context.
   int GetAttentionSize() const {
@@ -49,6 +54,8 @@ class AttentionWrapper {
 
   gsl::span<const T> attn_layer_cell_weights_;
   gsl::span<const T> attn_layer_attn_weights_;
+  const rnn::detail::PackedWeights* packed_attn_layer_cell_weights_ = nullptr;
+  const rnn::detail::PackedWeights* packed_attn_layer_attn_weights_ = nullptr;
 
   IAllocatorUniquePtr<T> attn_context_ptr_;
   gsl::span<T> attn_context_;
@@ -29,10 +29,12 @@ template <typename T>
 void BahdanauAttention<T>::SetWeights(
     const gsl::span<const T>& attn_weights,
     const gsl::span<const T>& query_layer_weights,
-    const gsl::span<const T>& memory_layer_weights) {
+    const gsl::span<const T>& memory_layer_weights,
+    const rnn::detail::PackedWeights* packed_query_layer_weights) {
   attention_v_ = attn_weights;                   //[attn_depth_]
   query_layer_weights_ = query_layer_weights;    //[query_depth_, attn_depth_]
   memory_layer_weights_ = memory_layer_weights;  //[memory_depth_, attn_depth_]
+  packed_query_layer_weights_ = packed_query_layer_weights;
 }
 
 template <typename T>
@@ -115,43 +117,64 @@ void BahdanauAttention<T>::Compute(
     const gsl::span<T>& output,
     const gsl::span<T>& aligns) const {
   //process query in dense query layer without bias
-  math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                  batch_size_, attn_depth_, query_depth_, T{1.0},
-                  queries.data(), query_depth_,
-                  query_layer_weights_.data(), attn_depth_, T{0.0},
-                  processed_query_.data(), attn_depth_, ttp_);
+  if (packed_query_layer_weights_ != nullptr) {
+    rnn::detail::ComputeGemm(batch_size_, attn_depth_, query_depth_, T{1.0},
+                             queries.cbegin(), queries.cend(), query_depth_,
+                             *packed_query_layer_weights_, T{0.0},
+                             processed_query_.begin(), processed_query_.end(), attn_depth_, ttp_);
+  } else {
+    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
+                    batch_size_, attn_depth_, query_depth_, T{1.0},
+                    queries.data(), query_depth_,
+                    query_layer_weights_.data(), attn_depth_, T{0.0},
+                    processed_query_.data(), attn_depth_, ttp_);
+  }
 
   std::fill(aligns.begin(), aligns.end(), T{});
 
   // return math_ops.reduce_sum(v * math_ops.tanh(keys + processed_query), [2])
-  for (int b = 0; b < batch_size_; b++) {
-    T* alignments = aligns.data() + b * max_memory_steps_;
-    const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
-    const T* query = processed_query_.data() + b * attn_depth_;
+  // The batches are independent, so each computes its scores, softmax and context on its own thread.
+  auto compute_batches = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t b = first; b < last; b++) {
+      ComputeContext(static_cast<int>(b), output, aligns);
+    }
+  };
+  if (ttp_ == nullptr) {
+    compute_batches(0, batch_size_);
+  } else {
+    const double cost = static_cast<double>(max_memory_steps_) * (attn_depth_ * 8 + memory_depth_ * 2);
+    ttp_->ParallelFor(batch_size_, cost, compute_batches);
+  }
+}
 
-    int mem_steps = mem_seq_lengths_[b];
-    for (int step = 0; step < mem_steps; step++) {
-      const T* keys_on_step = keys + step * attn_depth_;
-      T* dest = alignments + step;
-
-      // reduce_sum(v * tanh(keys[step] + query)) on last dimension
-      *dest = T(0.0);
-      for (int i = 0; i < attn_depth_; i++) {
-        *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
-      }
+template <typename T>
+void BahdanauAttention<T>::ComputeContext(int b, const gsl::span<T>& output, const gsl::span<T>& aligns) const {
+  T* alignments = aligns.data() + b * max_memory_steps_;
+  const T* keys = keys_.data() + b * max_memory_steps_ * attn_depth_;
+  const T* query = processed_query_.data() + b * attn_depth_;
+
+  int mem_steps = mem_seq_lengths_[b];
+  for (int step = 0; step < mem_steps; step++) {
+    const T* keys_on_step = keys + step * attn_depth_;
+    T* dest = alignments + step;
+
+    // reduce_sum(v * tanh(keys[step] + query)) on last dimension
+    *dest = T(0.0);
+    for (int i = 0; i < attn_depth_; i++) {
+      *dest += (attention_v_[i] * tanh(keys_on_step[i] + query[i]));
     }
+  }
 
-    SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
+  SoftmaxInplace(gsl::span<T>{alignments, mem_steps});
 
-    // Calculate the context
-    auto outspan = output.subspan(b * memory_depth_);
-    auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
-    math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
-                    1, memory_depth_, max_memory_steps_, T{1.0},
-                    alignments, max_memory_steps_,
-                    values.data(), memory_depth_, T{0.0},
-                    outspan.data(), memory_depth_, ttp_);
-  }
+  // Calculate the context
+  auto outspan = output.subspan(b * memory_depth_);
+  auto values = values_.subspan(b * max_memory_steps_ * memory_depth_);
+  math::GemmEx<T>(CblasNoTrans, CblasNoTrans,
+                  1, memory_depth_, max_memory_steps_, T{1.0},
+                  alignments, max_memory_steps_,
+                  values.data(), memory_depth_, T{0.0},
+                  outspan.data(), memory_depth_, nullptr);
 }
 
 template class BahdanauAttention<float>;
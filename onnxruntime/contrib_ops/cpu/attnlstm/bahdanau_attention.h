@@ -25,10 +25,12 @@ class BahdanauAttention : public IAttentionMechanism<T> {
       int attn_depth,
       bool normalize, concurrency::ThreadPool* threadpool);
 
+  // packed_query_layer_weights is query_layer_weights packed by PackWeights, or nullptr if it isn't packed.
   void SetWeights(
       const gsl::span<const T>& attn_weights,
       const gsl::span<const T>& query_layer_weights,
-      const gsl::span<const T>& memory_layer_weights);
+      const gsl::span<const T>& memory_layer_weights,
+      const rnn::detail::PackedWeights* packed_query_layer_weights = nullptr);
 
   ~BahdanauAttention() override = default;
 
@@ -51,6 +53,9 @@ class BahdanauAttention : public IAttentionMechanism<T> {
   bool NeedPrevAlignment() const override;
 
  private:
+  // Computes the alignments and the context of batch b of a Compute call.
+  void ComputeContext(int b, const gsl::span<T>& output, const gsl::span<T>& aligns) const;
+
   AllocatorPtr allocator_;
   const logging::Logger& logger_;
 
@@ -63,6 +68,7 @@ class BahdanauAttention : public IAttentionMechanism<T> {
   gsl::span<const T> attention_v_;
   gsl::span<const T> query_layer_weights_;
   gsl::span<const T> memory_layer_weights_;
+  const rnn::detail::PackedWeights* packed_query_layer_weights_ = nullptr;
 
   IAllocatorUniquePtr<T> keys_ptr_;
   gsl::span<T> keys_;
@@ -17,6 +17,7 @@ namespace contrib {
 
 using ::onnxruntime::contrib::rnn::detail::UniDirectionalAttnLstm;
 using ::onnxruntime::rnn::detail::Allocate;
+using ::onnxruntime::rnn::detail::PackWeights;
 
 extern template class BahdanauAttention<float>;
 
@@ -51,6 +52,86 @@ DeepCpuAttnLstmOp::Compute(OpKernelContext* context) const {
   return status;
 }
 
+// Returns the constant float input of the given index if it has the expected number of dimensions and num_directions
+// for its first dimension, or nullptr.
+static const Tensor* GetConstantWeights(const OpKernelInfo& info, int index, size_t num_dimensions,
+                                        int num_directions) {
+  const Tensor* tensor;
+  if (!info.TryGetConstantInput(index, &tensor) || tensor->DataType() != DataTypeImpl::GetType<float>() ||
+      tensor->Shape().NumDimensions() != num_dimensions || tensor->Shape()[0] != num_directions) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+void DeepCpuAttnLstmOp::PackConstantWeights(const OpKernelInfo& info) {
+  auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  packed_weights_.resize(num_directions_);
+
+  // R of [num_directions, 4*hidden_size, hidden_size]
+  const Tensor* R = GetConstantWeights(info, 2, 3, num_directions_);
+  if (R != nullptr && R->Shape()[1] == 4 * hidden_size_ && R->Shape()[2] == hidden_size_) {
+    const size_t N = 4 * hidden_size;
+    for (int i = 0; i < num_directions_; ++i) {
+      PackWeights(alloc, R->Data<float>() + i * N * hidden_size, N, hidden_size, packed_weights_[i].recurrent);
+    }
+  }
+
+  // am_query_layer_weights of [num_directions, query_depth(hidden_size of lstm), am_attn_size]
+  const Tensor* query_layer = GetConstantWeights(info, 8, 3, num_directions_);
+  if (query_layer != nullptr && query_layer->Shape()[1] == hidden_size_) {
+    const size_t N = static_cast<size_t>(query_layer->Shape()[2]);
+    for (int i = 0; i < num_directions_; ++i) {
+      PackWeights(alloc, CblasNoTrans, query_layer->Data<float>() + i * hidden_size * N, N, hidden_size, N,
+                  packed_weights_[i].query_layer);
+    }
+  }
+
+  // The size of the attention state is the depth of the optional attention layer, else the depth of the memory.
+  int64_t attention_size = -1;
+  const auto& input_defs = info.node().InputDefs();
+  const bool has_attention_layer = input_defs.size() > 13 && input_defs[13]->Exists();
+  if (has_attention_layer) {
+    // attn_layer_weights of [num_directions, memory_depth+cell_hidden_size, aw_attn_size]
+    const Tensor* attn_layer = GetConstantWeights(info, 13, 3, num_directions_);
+    if (attn_layer != nullptr && attn_layer->Shape()[1] > hidden_size_) {
+      const size_t N = static_cast<size_t>(attn_layer->Shape()[2]);
+      const size_t memory_depth = static_cast<size_t>(attn_layer->Shape()[1]) - hidden_size;
+      for (int i = 0; i < num_directions_; ++i) {
+        const float* cell_weights = attn_layer->Data<float>() + i * (hidden_size + memory_depth) * N;
+        PackWeights(alloc, CblasNoTrans, cell_weights, N, hidden_size, N, packed_weights_[i].attn_layer_cell);
+        PackWeights(alloc, CblasNoTrans, cell_weights + hidden_size * N, N, memory_depth, N,
+                    packed_weights_[i].attn_layer_attn);
+      }
+      attention_size = attn_layer->Shape()[2];
+    }
+  } else {
+    // am_memory_layer_weights of [num_directions, memory_depth, am_attn_size]
+    const Tensor* memory_layer = GetConstantWeights(info, 9, 3, num_directions_);
+    if (memory_layer != nullptr) {
+      attention_size = memory_layer->Shape()[1];
+    }
+  }
+
+  // W of [num_directions, 4*hidden_size, input_size + attention_size]; only the attention columns are applied in
+  // each step, the input columns are applied to all the steps at once.
+  const Tensor* W = GetConstantWeights(info, 1, 3, num_directions_);
+  if (W != nullptr && attention_size > 0 && W->Shape()[1] == 4 * hidden_size_ && W->Shape()[2] > attention_size) {
+    const size_t N = 4 * hidden_size;
+    const size_t ldb = static_cast<size_t>(W->Shape()[2]);
+    const size_t input_size = ldb - static_cast<size_t>(attention_size);
+    for (int i = 0; i < num_directions_; ++i) {
+      PackWeights(alloc, CblasTrans, W->Data<float>() + i * N * ldb + input_size, N,
+                  static_cast<size_t>(attention_size), ldb, packed_weights_[i].attention);
+    }
+  }
+}
+
+static const PackedWeights* PackedOrNull(const PackedWeights& weights) {
+  return weights.buffer != nullptr ? &weights : nullptr;
+}
+
 // #define DUMP_MATRIXES to provide lots of diagnostic output
 #if defined(DUMP_MATRIXES)
 #define DumpMatrix(...) ::onnxruntime::rnn::detail::DumpMatrixImpl(__VA_ARGS__)
@@ -246,7 +327,8 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     fam.SetWeights(
         FirstHalfSpan(am_v_weights.DataAsSpan<T>()),
         FirstHalfSpan(am_query_layer_weights.DataAsSpan<T>()),
-        FirstHalfSpan(am_memory_layer_weights.DataAsSpan<T>()));
+        FirstHalfSpan(am_memory_layer_weights.DataAsSpan<T>()),
+        PackedOrNull(packed_weights_[0].query_layer));
     fam.PrepareMemory(attn_memory.DataAsSpan<T>(), memory_seq_lens_span);
 
     AttentionWrapper<T> faw(
@@ -258,7 +340,9 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
         hidden_size_,
         has_attention_layer,
         fam, thread_pool);
-    faw.SetWeights(FirstHalfSpan(attn_layer_weights_span));
+    faw.SetWeights(FirstHalfSpan(attn_layer_weights_span),
+                   PackedOrNull(packed_weights_[0].attn_layer_cell),
+                   PackedOrNull(packed_weights_[0].attn_layer_attn));
 
     UniDirectionalAttnLstm<T> fw(
         alloc, logger,
@@ -282,7 +366,8 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     bam.SetWeights(
         SecondHalfSpan(am_v_weights.DataAsSpan<T>()),
         SecondHalfSpan(am_query_layer_weights.DataAsSpan<T>()),
-        SecondHalfSpan(am_memory_layer_weights.DataAsSpan<T>()));
+        SecondHalfSpan(am_memory_layer_weights.DataAsSpan<T>()),
+        PackedOrNull(packed_weights_[1].query_layer));
     bam.PrepareMemory(attn_memory.DataAsSpan<T>(), memory_seq_lens_span);
 
     AttentionWrapper<T> baw(
@@ -294,7 +379,9 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
         hidden_size_,
         has_attention_layer,
         bam, thread_pool);
-    baw.SetWeights(SecondHalfSpan(attn_layer_weights_span));
+    baw.SetWeights(SecondHalfSpan(attn_layer_weights_span),
+                   PackedOrNull(packed_weights_[1].attn_layer_cell),
+                   PackedOrNull(packed_weights_[1].attn_layer_attn));
 
     UniDirectionalAttnLstm<T> bw(
         alloc, logger,
@@ -306,8 +393,12 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
         activation_funcs_.Entries()[5],
         clip_, thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2, output_2, hidden_output_2, last_cell_2);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+               PackedOrNull(packed_weights_[0].attention), PackedOrNull(packed_weights_[0].recurrent),
+               output_1, hidden_output_1, last_cell_1);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+               PackedOrNull(packed_weights_[1].attention), PackedOrNull(packed_weights_[1].recurrent),
+               output_2, hidden_output_2, last_cell_2);
 
   } else {
     BahdanauAttention<T> fam(
@@ -323,7 +414,8 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
     fam.SetWeights(
         am_v_weights.DataAsSpan<T>(),
         am_query_layer_weights.DataAsSpan<T>(),
-        am_memory_layer_weights.DataAsSpan<T>());
+        am_memory_layer_weights.DataAsSpan<T>(),
+        PackedOrNull(packed_weights_[0].query_layer));
     fam.PrepareMemory(attn_memory.DataAsSpan<T>(), memory_seq_lens_span);
 
     AttentionWrapper<T> faw(
@@ -336,7 +428,9 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
         has_attention_layer,
         fam, thread_pool);
 
-    faw.SetWeights(attn_layer_weights_span);
+    faw.SetWeights(attn_layer_weights_span,
+                   PackedOrNull(packed_weights_[0].attn_layer_cell),
+                   PackedOrNull(packed_weights_[0].attn_layer_attn));
 
     UniDirectionalAttnLstm<T> fw(
         alloc, logger,
@@ -348,7 +442,9 @@ Status DeepCpuAttnLstmOp::ComputeImpl(OpKernelContext& context) const {
         activation_funcs_.Entries()[2],
         clip_, thread_pool);
 
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
+               PackedOrNull(packed_weights_[0].attention), PackedOrNull(packed_weights_[0].recurrent),
+               output_1, hidden_output_1, last_cell_1);
   }
 
   if (!output.empty()) {
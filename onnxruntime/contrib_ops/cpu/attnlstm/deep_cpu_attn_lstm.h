@@ -16,6 +16,7 @@ namespace contrib {
 using onnxruntime::rnn::detail::ActivationFuncs;
 using onnxruntime::rnn::detail::Direction;
 using onnxruntime::rnn::detail::MakeDirection;
+using onnxruntime::rnn::detail::PackedWeights;
 
 // The class represents DeepCPU implementation of a long short term memory (LSTM) plus a Bahdanau Attention wraper.
 // The equivilent python usage could be checked int the corresponding op test directory, attention_lstm_data_gen.py.
@@ -57,6 +58,8 @@ class DeepCpuAttnLstmOp final : public OpKernel {
     activation_funcs_ = ActivationFuncs(activation_func_names,
                                         activation_func_alphas,
                                         activation_func_betas);
+
+    PackConstantWeights(info);
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -64,6 +67,18 @@ class DeepCpuAttnLstmOp final : public OpKernel {
   ~DeepCpuAttnLstmOp() override = default;
 
  private:
+  // The weights of one direction that are applied in each step, packed by MlasSgemmPackB when they are constant
+  // initializers. Weights that aren't packed have an empty buffer.
+  struct PackedDirectionWeights {
+    PackedWeights recurrent;        // R[iofc]
+    PackedWeights attention;        // WA[iofc], the columns of W applied to the attention state
+    PackedWeights query_layer;      // the query layer of the attention mechanism
+    PackedWeights attn_layer_cell;  // the attention layer weights applied to the cell output
+    PackedWeights attn_layer_attn;  // the attention layer weights applied to the attention context
+  };
+
+  void PackConstantWeights(const OpKernelInfo& info);
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 
@@ -92,6 +107,8 @@ class DeepCpuAttnLstmOp final : public OpKernel {
 
   ActivationFuncs activation_funcs_;
 
+  std::vector<PackedDirectionWeights> packed_weights_;
+
 // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
 // across them. mutable due to this.
 // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
@@ -197,6 +197,8 @@ void UniDirectionalAttnLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                         const int num_directions,
                                         const gsl::span<const T>& input_weights,
                                         const gsl::span<const T>& recurrent_weights,
+                                        const PackedWeights* packed_attention_weights,
+                                        const PackedWeights* packed_recurrent_weights,
                                         gsl::span<T>& outputs,
                                         gsl::span<T>& final_hidden_state,
                                         gsl::span<T>& final_cell_state) {
@@ -290,22 +292,40 @@ void UniDirectionalAttnLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       const gsl::span<const T> attention = attention_wrapper_.GetAttnStates();
 
       // Xt*(W[iofc]^T) = INPUTt * W[iofc]^T + At-1 * WA[iofc]
-      ComputeGemm(batch_size_, hidden_size_x4, attention_size_, T{1.0},
-                  attention.cbegin(), attention.cend(),  // At-1
-                  attention_size_,
-                  input_weights.cbegin() + input_size_, input_weights.cend(),  // WA[iofc]
-                  input_size_ + attention_size_, T{1.0},
-                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, ttp_);
+      if (packed_attention_weights != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_x4, attention_size_, T{1.0},
+                    attention.cbegin(), attention.cend(),  // At-1
+                    attention_size_,
+                    *packed_attention_weights, T{1.0},  // WA[iofc]
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_x4, attention_size_, T{1.0},
+                    attention.cbegin(), attention.cend(),  // At-1
+                    attention_size_,
+                    input_weights.cbegin() + input_size_, input_weights.cend(),  // WA[iofc]
+                    input_size_ + attention_size_, T{1.0},
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, ttp_);
+      }
 
       // calculate Xt*(W[iofc]^T) + Ht-1*R[iofc]
-      ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, T{1.0},
-                  previous_state, previous_state_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, T{1.0},
-                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, ttp_);
+      if (packed_recurrent_weights != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, T{1.0},
+                    previous_state, previous_state_end,  // Ht-1
+                    hidden_size_,
+                    *packed_recurrent_weights, T{1.0},  // R[iofc]
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, T{1.0},
+                    previous_state, previous_state_end,  // Ht-1
+                    hidden_size_,
+                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
+                    hidden_size_, T{1.0},
+                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4, ttp_);
+      }
 
       span_T_iter batched_output, batched_output_end;
       if (output_sequence) {
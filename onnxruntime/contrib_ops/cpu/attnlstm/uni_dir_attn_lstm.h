@@ -24,6 +24,7 @@ using ::onnxruntime::IAllocatorUniquePtr;
 using ::onnxruntime::contrib::detail::ActivationInfo;
 using ::onnxruntime::rnn::detail::ActivationFuncs;
 using ::onnxruntime::rnn::detail::Direction;
+using ::onnxruntime::rnn::detail::PackedWeights;
 
 namespace rnn {
 namespace detail {
@@ -53,11 +54,15 @@ class UniDirectionalAttnLstm {
                          const float clip,
                          onnxruntime::concurrency::ThreadPool* ttp);
 
+  // packed_attention_weights and packed_recurrent_weights are the attention columns of input_weights and
+  // recurrent_weights packed by PackWeights, or nullptr if they aren't packed.
   void Compute(const gsl::span<const T>& inputs,
                const gsl::span<const int>& sequence_lengths,
                const int num_directions,
                const gsl::span<const T>& input_weights,
                const gsl::span<const T>& recurrent_weights,
+               const PackedWeights* packed_attention_weights,
+               const PackedWeights* packed_recurrent_weights,
                gsl::span<T>& outputs,
                gsl::span<T>& final_hidden_state,
                gsl::span<T>& final_cell_state);
@@ -0,0 +1,446 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/beam_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+#include "core/providers/cpu/math/top_k.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    BeamSearch,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("V", DataTypeImpl::AllTensorTypes()),
+    BeamSearch);
+
+namespace {
+
+// the score of the beams other than the first before the first step, so the identical beams aren't all expanded
+constexpr float kInactiveBeamScore = -1e9f;
+
+OrtValue AllocateTensorValue(MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator) {
+  auto p_tensor = std::make_unique<Tensor>(data_type, shape, allocator);
+  return OrtValue{p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// Copy the rows (entries of dimension 0) of 'source' selected by 'rows' to 'target'.
+// 'free_value' is written to instead of a new buffer if it has the shape and type needed, and nothing else uses it.
+Status GatherRows(const OrtValue& source, const std::vector<int64_t>& rows, AllocatorPtr& allocator,
+                  OrtValue& free_value, OrtValue& target) {
+  const auto& tensor = source.Get<Tensor>();
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() == 0 || tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "BeamSearch states must be numeric tensors with the batch in dimension 0. Got shape ",
+                           shape);
+  }
+
+  std::vector<int64_t> dims = shape.GetDims();
+  const int64_t num_source_rows = dims[0];
+  dims[0] = static_cast<int64_t>(rows.size());
+  TensorShape target_shape(dims);
+
+  if (free_value.IsAllocated() && free_value.IsUnique() && free_value.Get<Tensor>().Shape() == target_shape &&
+      free_value.Get<Tensor>().DataType() == tensor.DataType()) {
+    target = std::move(free_value);
+  } else {
+    target = AllocateTensorValue(tensor.DataType(), target_shape, allocator);
+  }
+  free_value = OrtValue();
+
+  const size_t row_bytes = num_source_rows == 0 ? 0 : tensor.SizeInBytes() / static_cast<size_t>(num_source_rows);
+  const auto* source_data = static_cast<const uint8_t*>(tensor.DataRaw());
+  auto* target_data = static_cast<uint8_t*>(target.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (rows[i] < 0 || rows[i] >= num_source_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BeamSearch state has ", num_source_rows,
+                             " entries in dimension 0 but entry ", rows[i], " is needed.");
+    }
+    memcpy(target_data + i * row_bytes, source_data + rows[i] * row_bytes, row_bytes);
+  }
+
+  return Status::OK();
+}
+
+// The finished sequences of a batch entry. Only the num_beams best are kept.
+class Hypotheses {
+ public:
+  explicit Hypotheses(size_t num_beams) : num_beams_{num_beams} {}
+
+  void Add(float score, std::vector<int64_t> tokens) {
+    if (entries_.size() < num_beams_) {
+      entries_.emplace_back(score, std::move(tokens));
+      return;
+    }
+
+    auto worst = Worst();
+    if (score > worst->first) {
+      *worst = std::make_pair(score, std::move(tokens));
+    }
+  }
+
+  // nothing better can be found once there are num_beams sequences, if a running beam with the best sum of
+  // log probabilities can't beat the worst of them
+  bool IsDone(float best_running_score, bool early_stopping) const {
+    if (entries_.size() < num_beams_) {
+      return false;
+    }
+
+    return early_stopping || best_running_score <= Worst()->first;
+  }
+
+  const std::pair<float, std::vector<int64_t>>& Best() const {
+    return *std::max_element(entries_.cbegin(), entries_.cend(),
+                             [](const std::pair<float, std::vector<int64_t>>& lhs,
+                                const std::pair<float, std::vector<int64_t>>& rhs) { return lhs.first < rhs.first; });
+  }
+
+  bool done = false;
+
+ private:
+  std::vector<std::pair<float, std::vector<int64_t>>>::const_iterator Worst() const {
+    return std::min_element(entries_.cbegin(), entries_.cend(),
+                            [](const std::pair<float, std::vector<int64_t>>& lhs,
+                               const std::pair<float, std::vector<int64_t>>& rhs) { return lhs.first < rhs.first; });
+  }
+
+  std::vector<std::pair<float, std::vector<int64_t>>>::iterator Worst() {
+    return std::min_element(entries_.begin(), entries_.end(),
+                            [](const std::pair<float, std::vector<int64_t>>& lhs,
+                               const std::pair<float, std::vector<int64_t>>& rhs) { return lhs.first < rhs.first; });
+  }
+
+  const size_t num_beams_;
+  std::vector<std::pair<float, std::vector<int64_t>>> entries_;
+};
+
+}  // namespace
+
+BeamSearch::BeamSearch(const OpKernelInfo& info) : OpKernel(info) {
+  // make sure the attribute was present even though we don't need it here.
+  // The GraphProto is loaded as a Graph instance by main Graph::Resolve,
+  // and a SessionState instance for executing the subgraph is created by InferenceSession.
+  ONNX_NAMESPACE::GraphProto proto;
+  ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+  ORT_IGNORE_RETURN_VALUE(proto);
+
+  ORT_ENFORCE(info.GetAttr<int64_t>("eos_token_id", &eos_token_id_).IsOK(), "BeamSearch requires eos_token_id.");
+  pad_token_id_ = info.GetAttrOrDefault<int64_t>("pad_token_id", eos_token_id_);
+  num_beams_ = info.GetAttrOrDefault<int64_t>("num_beams", 1);
+  ORT_ENFORCE(num_beams_ >= 1, "num_beams must be positive. Got ", num_beams_);
+  length_penalty_ = info.GetAttrOrDefault<float>("length_penalty", 1.f);
+  early_stopping_ = info.GetAttrOrDefault<int64_t>("early_stopping", 0) != 0;
+}
+
+common::Status BeamSearch::SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                                      const std::string& attribute_name,
+                                                      const SessionState& subgraph_session_state) {
+  ORT_ENFORCE(feeds_fetches_manager_ == nullptr,
+              "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+  ORT_UNUSED_PARAMETER(attribute_name);
+
+  const auto& node = Node();
+  const auto& subgraph_inputs = subgraph_session_state.GetGraphViewer()->GetInputs();
+  const auto& subgraph_outputs = subgraph_session_state.GetGraphViewer()->GetOutputs();
+
+  if (subgraph_inputs.empty() || subgraph_inputs.size() != subgraph_outputs.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "The BeamSearch decoder should have the input ids and the past states as inputs, and the "
+                           "logits and the present states as outputs. Got ",
+                           subgraph_inputs.size(), " inputs and ", subgraph_outputs.size(), " outputs.");
+  }
+
+  num_states_ = static_cast<int>(subgraph_inputs.size()) - 1;
+  if (node.InputDefs().size() != static_cast<size_t>(2 + num_states_)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The BeamSearch decoder has ", num_states_,
+                           " past states, so the node needs as many initial states. Got ",
+                           node.InputDefs().size() - 2);
+  }
+
+  // the input ids and states are created by BeamSearch on CPU. the implicit inputs come from the graph.
+  std::vector<std::string> feed_names;
+  feed_names.reserve(subgraph_inputs.size() + node.ImplicitInputDefs().size());
+  for (const auto* input : subgraph_inputs) {
+    feed_names.push_back(input->Name());
+  }
+
+  for (const auto* entry : node.ImplicitInputDefs()) {
+    feed_names.push_back(entry->Name());
+  }
+
+  std::vector<OrtDevice> feed_locations;
+  ORT_RETURN_IF_ERROR(controlflow::detail::FindDevicesForValues(session_state, feed_names, feed_locations,
+                                                                subgraph_inputs.size()));
+
+  std::vector<std::string> output_names;
+  output_names.reserve(subgraph_outputs.size());
+  for (const auto* output : subgraph_outputs) {
+    output_names.push_back(output->Name());
+  }
+
+  std::unique_ptr<FeedsFetchesManager> ffm;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names,
+                                                  subgraph_session_state.GetOrtValueNameIdxMap(), ffm));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(subgraph_session_state, *ffm));
+
+  // the logits are searched and the states reordered on CPU, so all the decoder outputs are needed there
+  const auto& cpu_location = utils::FindMemoryInfoForValue(session_state, node.OutputDefs()[0]->Name());
+  std::vector<const OrtMemoryInfo*> fetch_locations(output_names.size(), &cpu_location);
+  utils::FinalizeFeedFetchCopyInfo(subgraph_session_state, *ffm, feed_locations, fetch_locations);
+
+  feeds_fetches_manager_ = std::move(ffm);
+
+  return Status::OK();
+}
+
+Status BeamSearch::Compute(OpKernelContext* ctx) const {
+  auto* ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  auto* session_state = ctx_internal->SubgraphSessionState("decoder");
+  ORT_ENFORCE(session_state, "Subgraph SessionState was not found for 'decoder' attribute.");
+  ORT_ENFORCE(feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
+
+  const auto* input_ids = ctx->Input<Tensor>(0);
+  const auto& input_ids_shape = input_ids->Shape();
+  if (input_ids_shape.NumDimensions() != 2 || input_ids_shape[1] < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "BeamSearch input_ids should have the shape (batch_size, sequence_length) with a "
+                           "sequence_length of at least 1. Got ",
+                           input_ids_shape);
+  }
+
+  const auto* max_length_tensor = ctx->Input<Tensor>(1);
+  if (max_length_tensor->Shape().Size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BeamSearch max_length should be a scalar. Got shape ",
+                           max_length_tensor->Shape());
+  }
+
+  const int64_t batch_size = input_ids_shape[0];
+  const int64_t prompt_len = input_ids_shape[1];
+  const int64_t max_length = std::max(*max_length_tensor->Data<int64_t>(), prompt_len);
+  const int64_t num_beams = num_beams_;
+  const int64_t num_rows = batch_size * num_beams;
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx_internal->GetTempSpaceAllocator(&allocator));
+
+  // the tokens of each beam, each row max_length long. beams are the rows of their batch entry.
+  std::vector<int64_t> sequences(num_rows * max_length);
+  std::vector<int64_t> next_sequences(num_rows * max_length);
+  std::vector<float> beam_scores(num_rows, 0.f);
+  std::vector<float> next_beam_scores(num_rows);
+  std::vector<int64_t> beam_rows(num_rows);  // the row each beam continues, the batch entry at first
+  std::vector<int64_t> next_tokens(num_rows);
+
+  const auto* prompt = input_ids->Data<int64_t>();
+  for (int64_t row = 0; row < num_rows; ++row) {
+    const int64_t b = row / num_beams;
+    std::copy(prompt + b * prompt_len, prompt + (b + 1) * prompt_len, sequences.begin() + row * max_length);
+    if (row % num_beams != 0) {
+      beam_scores[row] = kInactiveBeamScore;
+    }
+    beam_rows[row] = b;
+  }
+
+  // feeds: input ids, past states, implicit inputs
+  const auto& implicit_inputs = ctx_internal->GetImplicitInputs();
+  std::vector<OrtValue> feeds(1 + num_states_ + implicit_inputs.size());
+  std::vector<OrtValue> free_states(num_states_);
+  std::vector<OrtValue> fetches;
+
+  auto set_input_ids = [&](int64_t len, int64_t first) {
+    feeds[0] = AllocateTensorValue(DataTypeImpl::GetType<int64_t>(), TensorShape({num_rows, len}), allocator);
+    auto* data = feeds[0].GetMutable<Tensor>()->MutableData<int64_t>();
+    for (int64_t row = 0; row < num_rows; ++row) {
+      std::copy_n(sequences.begin() + row * max_length + first, len, data + row * len);
+    }
+  };
+
+  set_input_ids(prompt_len, 0);
+  for (int i = 0; i < num_states_; ++i) {
+    const auto& initial_state = *ctx_internal->GetInputMLValue(2 + i);
+    if (!initial_state.IsTensor() || initial_state.Get<Tensor>().Shape().NumDimensions() == 0 ||
+        initial_state.Get<Tensor>().Shape()[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "BeamSearch initial state ", i,
+                             " should be a tensor with batch_size entries in dimension 0.");
+    }
+
+    if (num_beams == 1) {
+      feeds[1 + i] = initial_state;
+    } else {
+      // repeat each batch entry for its beams
+      ORT_RETURN_IF_ERROR(GatherRows(initial_state, beam_rows, allocator, free_states[i], feeds[1 + i]));
+    }
+  }
+
+  for (size_t i = 0; i < implicit_inputs.size(); ++i) {
+    feeds[1 + num_states_ + i] = *implicit_inputs[i];
+  }
+
+  std::vector<Hypotheses> hypotheses(static_cast<size_t>(batch_size), Hypotheses(static_cast<size_t>(num_beams)));
+  std::vector<float> scores;
+  const auto num_candidates = static_cast<unsigned>(2 * num_beams);
+  std::vector<float> top_scores(num_candidates);
+  std::vector<int64_t> top_indices(num_candidates);
+  std::vector<int64_t> selection_scratch;
+
+  auto normalize = [this](float sum_log_probs, int64_t length) {
+    return sum_log_probs / std::pow(static_cast<float>(length), length_penalty_);
+  };
+
+  int64_t cur_len = prompt_len;
+  while (cur_len < max_length) {
+    fetches.clear();
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*session_state, *feeds_fetches_manager_, feeds, fetches, {},
+                                               /*sequential_execution*/ true, ctx_internal->GetTerminateFlag(),
+                                               ctx_internal->Logger()));
+
+    const auto& logits = fetches[0].Get<Tensor>();
+    const auto& logits_shape = logits.Shape();
+    const auto logits_rank = logits_shape.NumDimensions();
+    if (logits.DataType() != DataTypeImpl::GetType<float>() || (logits_rank != 2 && logits_rank != 3) || logits_shape[0] != num_rows ||
+        logits_shape[logits_rank - 1] < 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                             "The BeamSearch decoder logits should be float with the shape (batch_size * num_beams, "
+                             "vocab_size) or (batch_size * num_beams, sequence_length, vocab_size). Got ",
+                             logits_shape);
+    }
+
+    // log softmax of the logits of the last position, added to the score of the beam
+    const int64_t vocab_size = logits_shape[logits_rank - 1];
+    const int64_t num_positions = logits_rank == 3 ? logits_shape[1] : 1;
+    const auto* logits_data = logits.Data<float>();
+    scores.resize(num_rows * vocab_size);
+    for (int64_t row = 0; row < num_rows; ++row) {
+      const float* row_logits = logits_data + ((row + 1) * num_positions - 1) * vocab_size;
+      const float max_logit = *std::max_element(row_logits, row_logits + vocab_size);
+      float sum = 0.f;
+      for (int64_t v = 0; v < vocab_size; ++v) {
+        sum += std::exp(row_logits[v] - max_logit);
+      }
+
+      const float offset = beam_scores[row] - max_logit - std::log(sum);
+      float* row_scores = scores.data() + row * vocab_size;
+      for (int64_t v = 0; v < vocab_size; ++v) {
+        row_scores[v] = row_logits[v] + offset;
+      }
+    }
+
+    // keep the num_beams best continuations of the beams of each batch entry. 2 * num_beams candidates cover the
+    // sequences ending with eos, which can't be the best of the candidates of more than num_beams beams.
+    bool all_done = true;
+    for (int64_t b = 0; b < batch_size; ++b) {
+      auto& batch_hypotheses = hypotheses[b];
+      if (batch_hypotheses.done) {
+        for (int64_t row = b * num_beams; row < (b + 1) * num_beams; ++row) {
+          beam_rows[row] = row;
+          next_tokens[row] = pad_token_id_;
+          next_beam_scores[row] = 0.f;
+        }
+        continue;
+      }
+
+      SelectTopK(scores.data() + b * num_beams * vocab_size, num_beams * vocab_size, num_candidates,
+                 selection_scratch, top_scores.data(), top_indices.data());
+
+      int64_t beam = 0;
+      for (unsigned j = 0; j < num_candidates && beam < num_beams; ++j) {
+        const int64_t source_row = b * num_beams + top_indices[j] / vocab_size;
+        const int64_t token = top_indices[j] % vocab_size;
+        if (token == eos_token_id_) {
+          // a sequence ending with eos is only kept if it's among the best num_beams
+          if (static_cast<int64_t>(j) < num_beams) {
+            auto begin = sequences.cbegin() + source_row * max_length;
+            std::vector<int64_t> tokens(begin, begin + cur_len);
+            tokens.push_back(token);
+            batch_hypotheses.Add(normalize(top_scores[j], cur_len + 1), std::move(tokens));
+          }
+          continue;
+        }
+
+        const int64_t row = b * num_beams + beam++;
+        beam_rows[row] = source_row;
+        next_tokens[row] = token;
+        next_beam_scores[row] = top_scores[j];
+      }
+
+      batch_hypotheses.done = batch_hypotheses.IsDone(normalize(next_beam_scores[b * num_beams], cur_len + 1),
+                                                      early_stopping_);
+      all_done = all_done && batch_hypotheses.done;
+    }
+
+    bool reordered = false;
+    for (int64_t row = 0; row < num_rows; ++row) {
+      auto source = sequences.cbegin() + beam_rows[row] * max_length;
+      std::copy(source, source + cur_len, next_sequences.begin() + row * max_length);
+      next_sequences[row * max_length + cur_len] = next_tokens[row];
+      reordered = reordered || beam_rows[row] != row;
+    }
+
+    sequences.swap(next_sequences);
+    beam_scores.swap(next_beam_scores);
+    ++cur_len;
+
+    if (all_done || cur_len == max_length) {
+      break;
+    }
+
+    // with past states only the new tokens are fed. without, the decoder needs the whole sequences.
+    if (num_states_ > 0) {
+      set_input_ids(1, cur_len - 1);
+    } else {
+      set_input_ids(cur_len, 0);
+    }
+
+    for (int i = 0; i < num_states_; ++i) {
+      // the buffer of the last past state is reused for the next one if the reordered states fit in it
+      free_states[i] = std::move(feeds[1 + i]);
+      if (!reordered) {
+        // the present states are fed as they are, which is always the case for greedy search
+        feeds[1 + i] = fetches[1 + i];
+      } else {
+        ORT_RETURN_IF_ERROR(GatherRows(fetches[1 + i], beam_rows, allocator, free_states[i], feeds[1 + i]));
+      }
+    }
+  }
+
+  // the running beams of the batch entries that didn't finish compete with the sequences ending with eos
+  int64_t output_len = 0;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    auto& batch_hypotheses = hypotheses[b];
+    if (!batch_hypotheses.done) {
+      for (int64_t row = b * num_beams; row < (b + 1) * num_beams; ++row) {
+        auto begin = sequences.cbegin() + row * max_length;
+        batch_hypotheses.Add(normalize(beam_scores[row], cur_len), std::vector<int64_t>(begin, begin + cur_len));
+      }
+    }
+
+    output_len = std::max(output_len, static_cast<int64_t>(batch_hypotheses.Best().second.size()));
+  }
+
+  auto* output_sequences = ctx->Output(0, TensorShape({batch_size, output_len}));
+  auto* output_scores = ctx->Output(1, TensorShape({batch_size}));
+  auto* output_data = output_sequences->MutableData<int64_t>();
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const auto& best = hypotheses[b].Best();
+    auto* out = output_data + b * output_len;
+    std::fill(std::copy(best.second.cbegin(), best.second.cend(), out), out + output_len, pad_token_id_);
+    if (output_scores) {
+      output_scores->MutableData<float>()[b] = best.first;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/controlflow/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Autoregressive generation running the 'decoder' subgraph once per token, with beam search,
+// or greedy search when num_beams is 1.
+// The decoder takes the input ids followed by the past states, and returns the logits followed by the present
+// states, which are fed back as the past states of the next step after being reordered to follow the beams.
+class BeamSearch final : public OpKernel, public controlflow::IControlFlowKernel {
+ public:
+  BeamSearch(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* ctx) const override;
+
+  common::Status SetupSubgraphExecutionInfo(const SessionState& session_state,
+                                            const std::string& attribute_name,
+                                            const SessionState& subgraph_session_state) override;
+
+ private:
+  int64_t eos_token_id_;
+  int64_t pad_token_id_;
+  int64_t num_beams_;
+  float length_penalty_;
+  bool early_stopping_;
+
+  // number of past state inputs of the decoder, each matched by a present state output
+  int num_states_ = 0;
+
+  // FeedsFetchesManager re-used for each decoder execution
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
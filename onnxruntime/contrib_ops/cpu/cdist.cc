@@ -12,5 +12,14 @@ namespace contrib {
 DEFINE_KERNEL(float);
 DEFINE_KERNEL(double);
 
+#define DEFINE_TOPK_KERNEL(data_type)                                                              \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(CDistTopK, kMSDomain, 1, data_type, kCpuExecutionProvider,         \
+                                KernelDefBuilder()                                                 \
+                                    .TypeConstraint("T", DataTypeImpl::GetTensorType<data_type>()) \
+                                    .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),  \
+                                CDistTopK<data_type>);
+DEFINE_TOPK_KERNEL(float);
+DEFINE_TOPK_KERNEL(double);
+
 }  // namespace contrib
 }  // namespace onnxruntime
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
 #include "core/common/common.h"
 #include "core/util/distance.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "assert.h"
 #ifndef USE_OPENMP
 #include "core/util/eigen_common_wrapper.h"
@@ -89,23 +92,97 @@ void cdist(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, conc
 #endif
 }
 
+// Computes dest = -2 * a * b^T for the row major matrices a [ma, n] and b [mb, n], with ldd elements per row of dest.
+inline void MinusTwoABt(const float* a, const float* b, float* dest, size_t ma, size_t mb, size_t n, size_t ldd,
+                        concurrency::ThreadPool* tp) {
+  MlasSgemm(CblasNoTrans, CblasTrans, ma, mb, n, -2.f, a, n, b, n, 0.f, dest, ldd, tp);
+}
+
+inline void MinusTwoABt(const double* a, const double* b, double* dest, size_t ma, size_t mb, size_t n, size_t ldd,
+                        concurrency::ThreadPool*) {
+  Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>, 0, Eigen::OuterStride<>>(
+      dest, ma, mb, Eigen::OuterStride<>(ldd))
+      .noalias() = -2.0 * ConstEigenMatrixMapRowMajor<double>(a, ma, n) *
+                   ConstEigenMatrixMapRowMajor<double>(b, mb, n).transpose();
+}
+
+// Computes the squared norm of each row of the row major matrix a [m, n].
+template <typename T>
+std::vector<T> squared_row_norms(const T* a, size_t m, size_t n) {
+  std::vector<T> norms(m);
+  ConstEigenMatrixMapRowMajor<T> a_matrix(a, m, n);
+  EigenVectorMap<T>(norms.data(), m) = a_matrix.rowwise().squaredNorm();
+  return norms;
+}
+
+// Finishes the squared distance d = ||a||^2 + ||b||^2 - 2ab from -2ab. The cancellation loses the relative precision
+// of distances much smaller than the norms, which are rare and are recomputed directly instead.
+template <typename T>
+inline T FinishSquaredDistance(T minus_two_ab, T a_norm, T b_norm, const T* a, const T* b, size_t n) {
+  const T d = minus_two_ab + a_norm + b_norm;
+  return d > (a_norm + b_norm) * static_cast<T>(1e-3) ? d : Sqeuclidean<T>()(a, b, n);
+}
+
+// Computes the (squared) Euclidean distances as ||a||^2 + ||b||^2 - 2ab, so the bulk of the work is one GEMM.
+template <typename T>
+void cdist_gemm(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n, bool take_sqrt,
+                concurrency::ThreadPool* tp) {
+  const std::vector<T> a_norms = squared_row_norms(a, ma, n);
+  const std::vector<T> b_norms = squared_row_norms(b, mb, n);
+  MinusTwoABt(a, b, dest, ma, mb, n, mb, tp);
+
+  auto add_norms = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      T* row = dest + i * mb;
+      const T* a1 = a + i * n;
+      for (size_t j = 0; j < mb; ++j) {
+        T d = FinishSquaredDistance(row[j], a_norms[i], b_norms[j], a1, b + j * n, n);
+        row[j] = take_sqrt ? std::sqrt(d) : d;
+      }
+    }
+  };
+  if (tp == nullptr) {
+    add_norms(0, static_cast<std::ptrdiff_t>(ma));
+  } else {
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(ma), static_cast<double>(mb * (take_sqrt ? 16 : 4)), add_norms);
+  }
+}
+
+// Parses the metric attribute shared by CDist and CDistTopK. Returns whether the metric is "euclidean", the only
+// other supported metric is "sqeuclidean".
+inline bool IsEuclideanCDistMetric(const OpKernelInfo& info) {
+  std::string metric;
+  ORT_ENFORCE(info.GetAttr<std::string>("metric", &metric).IsOK());
+  if (metric.compare("euclidean") == 0) {
+    return true;
+  }
+  if (metric.compare("sqeuclidean") != 0) {
+    ORT_NOT_IMPLEMENTED("CDist metric ", metric, " is not supported.");
+  }
+  return false;
+}
+
+inline Status ValidateCDistInputs(const TensorShape& shape_a, const TensorShape& shape_b) {
+  if (shape_a.NumDimensions() != 2 || shape_a[1] <= 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The first input of CDist kernel has wrong shape: ", shape_a);
+  }
+  if (shape_b.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The second input of CDist kernel has wrong shape: ", shape_b);
+  }
+  if (shape_a[1] != shape_b[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input shape dimensions mismatch:", shape_a, " and ", shape_b);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 class CDist final : public OpKernel {
  private:
-  typedef void (*DistFunc)(const T* a, const T* b, T* dest, size_t ma, size_t mb, size_t n,
-                           concurrency::ThreadPool* tp);
   enum { EUCLIDEAN, SQEUCLIDEAN } mode_;
 
  public:
   CDist(const OpKernelInfo& info) : OpKernel(info) {
-    std::string metric;
-    ORT_ENFORCE(info.GetAttr<std::string>("metric", &metric).IsOK());
-    if (metric.compare("sqeuclidean") == 0)
-      mode_ = SQEUCLIDEAN;
-    else if (metric.compare("euclidean") == 0) {
-      mode_ = EUCLIDEAN;
-    } else
-      ORT_NOT_IMPLEMENTED();
+    mode_ = IsEuclideanCDistMetric(info) ? EUCLIDEAN : SQEUCLIDEAN;
   }
 
   common::Status Compute(OpKernelContext* context) const override {
@@ -117,33 +194,30 @@ class CDist final : public OpKernel {
     const Tensor* B = context->Input<Tensor>(1);
     const TensorShape& shape_a = A->Shape();
     const TensorShape& shape_b = B->Shape();
-    if (shape_a.NumDimensions() != 2 || shape_a[1] <= 0) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The first input of CDist kernel has wrong shape: ", shape_a);
-    }
-
-    if (shape_b.NumDimensions() != 2) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The second input of CDist kernel has wrong shape: ", shape_b);
-    }
-    if (shape_a[1] != shape_b[1]) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input shape dimensions mismatch:", shape_a, " and ", shape_b);
-    }
+    ORT_RETURN_IF_ERROR(ValidateCDistInputs(shape_a, shape_b));
 
     TensorShape output_shape = {shape_a[0], shape_b[0]};
     Tensor* C = context->Output(0, output_shape);
     T* output = C->MutableData<T>();
+    const size_t ma = static_cast<size_t>(shape_a[0]);
+    const size_t mb = static_cast<size_t>(shape_b[0]);
+    const size_t n = static_cast<size_t>(shape_a[1]);
+    if (ma == 0 || mb == 0) {
+      return Status::OK();
+    }
+
+    // for smaller vector size, a raw loop is better than the GEMM
+    if (n >= 8) {
+      cdist_gemm(A->Data<T>(), B->Data<T>(), output, ma, mb, n, mode_ == EUCLIDEAN, tp);
+      return Status::OK();
+    }
+
     switch (mode_) {
       case EUCLIDEAN:
-        if (shape_a[1] >= 8)
-          cdist<T, EuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
-        else  // for smaller vector size, a raw loop is better
-          cdist<T, Euclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+        cdist<T, Euclidean<T> >(A->Data<T>(), B->Data<T>(), output, ma, mb, n, tp);
         break;
       case SQEUCLIDEAN:
-        if (shape_a[1] >= 8)
-          cdist<T, SqeuclideanWithEigen<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1],
-                                             tp);
-        else  // for smaller vector size, a raw loop is better
-          cdist<T, Sqeuclidean<T> >(A->Data<T>(), B->Data<T>(), output, shape_a[0], shape_b[0], shape_a[1], tp);
+        cdist<T, Sqeuclidean<T> >(A->Data<T>(), B->Data<T>(), output, ma, mb, n, tp);
         break;
       default:
         return Status(ONNXRUNTIME, NOT_IMPLEMENTED);
@@ -151,5 +225,115 @@ class CDist final : public OpKernel {
     return Status::OK();
   }
 };
+
+// the rows of A and B CDistTopK computes the distances of at a time
+constexpr size_t kCDistTopKRowBlockSize = 32;
+constexpr size_t kCDistTopKColumnBlockSize = 1024;
+
+// CDist followed by a TopK of the smallest distances of each row. The distances are computed by blocks of rows and
+// columns, so the [ma, mb] distance matrix is never materialized.
+template <typename T>
+class CDistTopK final : public OpKernel {
+ public:
+  CDistTopK(const OpKernelInfo& info) : OpKernel(info) {
+    euclidean_ = IsEuclideanCDistMetric(info);
+    ORT_ENFORCE(info.GetAttr<int64_t>("k", &k_).IsOK() && k_ > 0, "CDistTopK requires a positive k attribute.");
+  }
+
+  common::Status Compute(OpKernelContext* context) const override {
+    auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+    concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+    const Tensor* A = context->Input<Tensor>(0);
+    const Tensor* B = context->Input<Tensor>(1);
+    const TensorShape& shape_a = A->Shape();
+    const TensorShape& shape_b = B->Shape();
+    ORT_RETURN_IF_ERROR(ValidateCDistInputs(shape_a, shape_b));
+    if (k_ > shape_b[0]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "k argument [", k_,
+                             "] should not be greater than the number of rows of B [", shape_b[0], "]");
+    }
+
+    Tensor* values = context->Output(0, {shape_a[0], k_});
+    Tensor* indices = context->Output(1, {shape_a[0], k_});
+
+    const T* a = A->Data<T>();
+    const T* b = B->Data<T>();
+    T* values_data = values->MutableData<T>();
+    int64_t* indices_data = indices->MutableData<int64_t>();
+    const size_t ma = static_cast<size_t>(shape_a[0]);
+    const size_t mb = static_cast<size_t>(shape_b[0]);
+    const size_t n = static_cast<size_t>(shape_a[1]);
+    const size_t k = static_cast<size_t>(k_);
+
+    const std::vector<T> b_norms = squared_row_norms(b, mb, n);
+    const size_t block_count = (ma + kCDistTopKRowBlockSize - 1) / kCDistTopKRowBlockSize;
+
+    auto compute_blocks = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      std::vector<T> distances(kCDistTopKRowBlockSize * kCDistTopKColumnBlockSize);
+      std::vector<std::vector<std::pair<T, int64_t>>> heaps(kCDistTopKRowBlockSize);
+
+      for (std::ptrdiff_t block = first; block < last; ++block) {
+        const size_t row_begin = static_cast<size_t>(block) * kCDistTopKRowBlockSize;
+        const size_t rows = std::min(kCDistTopKRowBlockSize, ma - row_begin);
+        const T* a_block = a + row_begin * n;
+        const std::vector<T> a_norms = squared_row_norms(a_block, rows, n);
+        for (auto& heap : heaps) {
+          heap.clear();
+        }
+
+        for (size_t column_begin = 0; column_begin < mb; column_begin += kCDistTopKColumnBlockSize) {
+          const size_t columns = std::min(kCDistTopKColumnBlockSize, mb - column_begin);
+          MinusTwoABt(a_block, b + column_begin * n, distances.data(), rows, columns, n, kCDistTopKColumnBlockSize,
+                      nullptr);
+
+          for (size_t i = 0; i < rows; ++i) {
+            // a max-heap of the k smallest (distance, index) pairs seen so far, ties go to the lower index
+            auto& heap = heaps[i];
+            const T* row = distances.data() + i * kCDistTopKColumnBlockSize;
+            const T* a1 = a_block + i * n;
+            for (size_t j = 0; j < columns; ++j) {
+              const size_t column = column_begin + j;
+              std::pair<T, int64_t> candidate(
+                  FinishSquaredDistance(row[j], a_norms[i], b_norms[column], a1, b + column * n, n),
+                  static_cast<int64_t>(column));
+              if (heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end());
+              } else if (candidate < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end());
+              }
+            }
+          }
+        }
+
+        for (size_t i = 0; i < rows; ++i) {
+          auto& heap = heaps[i];
+          std::sort_heap(heap.begin(), heap.end());
+          T* row_values = values_data + (row_begin + i) * k;
+          int64_t* row_indices = indices_data + (row_begin + i) * k;
+          for (size_t j = 0; j < k; ++j) {
+            row_values[j] = euclidean_ ? std::sqrt(heap[j].first) : heap[j].first;
+            row_indices[j] = heap[j].second;
+          }
+        }
+      }
+    };
+
+    if (tp == nullptr) {
+      compute_blocks(0, static_cast<std::ptrdiff_t>(block_count));
+    } else {
+      const double block_cost = static_cast<double>(kCDistTopKRowBlockSize * mb * n * 2);
+      tp->ParallelFor(static_cast<std::ptrdiff_t>(block_count), block_cost, compute_blocks);
+    }
+    return Status::OK();
+  }
+
+ private:
+  bool euclidean_;
+  int64_t k_;
+};
 }  // namespace contrib
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -16,7 +16,9 @@ limitations under the License.
 
 #include "contrib_ops/cpu/crop_and_resize.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include "core/util/math_cpuonly.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
@@ -43,6 +45,61 @@ namespace contrib {
 
 ADD_TYPED_CROPANDRESIZE_OP(float);
 
+// Approximate cost, in cycles, of one bilinear sample of one channel.
+constexpr double kCostPerSample = 8.0;
+
+// The source coordinate of an output row or column of a crop, along an axis of the given size.
+template <typename T>
+T CropSourceCoordinate(int64_t p, int32_t pooled_size, T roi_start, T roi_end, int64_t size, T scale) {
+  if (pooled_size <= 1) {
+    return static_cast<T>(0.5 * (roi_start + roi_end) * (size - 1));
+  }
+  if (p == 0) {
+    return static_cast<T>(roi_start * (size - 1));
+  }
+  if (p == pooled_size - 1) {
+    return static_cast<T>(roi_end * (size - 1));
+  }
+  return static_cast<T>(roi_start * (size - 1) + p * scale);
+}
+
+// The interpolation table of one axis of a crop: for each output row or column, the two source indices to blend
+// and the weight of the second, or the nearest source index in low. Positions outside of the image are marked so
+// the extrapolation value is selected instead, and sample index 0 so that the sampling loop doesn't branch.
+template <typename T>
+struct CropAxisTable {
+  std::vector<int64_t> low;
+  std::vector<int64_t> high;
+  std::vector<float> lerp;
+  std::vector<uint8_t> valid;
+
+  void Compute(int32_t pooled_size, T roi_start, T roi_end, int64_t size, bool bilinear) {
+    low.resize(pooled_size);
+    high.resize(pooled_size);
+    lerp.resize(pooled_size);
+    valid.resize(pooled_size);
+
+    const T scale = (pooled_size > 1) ? (roi_end - roi_start) * (size - 1) / (pooled_size - 1) : 0;
+    for (int32_t p = 0; p < pooled_size; p++) {
+      const T in = CropSourceCoordinate(p, pooled_size, roi_start, roi_end, size, scale);
+      if (!(in >= 0 && in <= size - 1)) {
+        low[p] = high[p] = 0;
+        lerp[p] = 0.0f;
+        valid[p] = 0;
+      } else if (bilinear) {
+        low[p] = static_cast<int64_t>(floorf(static_cast<float>(in)));
+        high[p] = static_cast<int64_t>(ceilf(static_cast<float>(in)));
+        lerp[p] = static_cast<float>(in - low[p]);
+        valid[p] = 1;
+      } else {
+        low[p] = high[p] = static_cast<int64_t>(roundf(static_cast<float>(in)));
+        lerp[p] = 0.0f;
+        valid[p] = 1;
+      }
+    }
+  }
+};
+
 template <typename T>
 void CropAndResizeForward(
     int64_t nthreads,
@@ -58,126 +115,87 @@ void CropAndResizeForward(
     T* top_data,
     const std::string& mode,
     const int32_t* batch_indices_ptr,
-    const ThreadPool* ttp) {
-  int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
-
-  std::function<void(int32_t)> work_object = [&](int32_t n) {
-    int64_t index_n = n * channels * pooled_width * pooled_height;
-
-    const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
-    const auto roi_batch_ind = batch_indices_ptr[n];
-
-    T roi_start_w = offset_bottom_rois[1];
-    T roi_start_h = offset_bottom_rois[0];
-    T roi_end_w = offset_bottom_rois[3];
-    T roi_end_h = offset_bottom_rois[2];
-
-    T height_scale =
-        (pooled_height > 1)
-        ? (roi_end_h - roi_start_h) * (height - 1) / (pooled_height - 1)
-        : 0;
-    T width_scale =
-        (pooled_width > 1) ? (roi_end_w - roi_start_w) * (width - 1) / (pooled_width - 1)
-        : 0;
-
-    for (auto ph = 0; ph < pooled_height; ph++) {
-      T in_y = static_cast<T>((pooled_height > 1)
-        ? roi_start_h * (height - 1) + ph * height_scale
-        : 0.5 * (roi_start_h + roi_end_h) * (height - 1));
-      if (ph == pooled_height - 1) {
-        in_y = static_cast<T>((pooled_height > 1)
-        ? roi_end_h * (height - 1)
-        : 0.5 * (roi_start_h + roi_end_h) * (height - 1));
-      }
-      if (ph == 0) {
-        in_y = static_cast<T>((pooled_height > 1)
-        ? roi_start_h * (height - 1)
-        : 0.5 * (roi_start_h + roi_end_h) * (height - 1));
-      }
-      if (in_y < 0 || in_y > height - 1) {
-        for (int64_t pw = 0; pw < pooled_width; pw++) {
-        for (int64_t c = 0; c < channels; c++)
-        {
-          int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-          int64_t index = index_n_c + ph * pooled_width + pw;
-          top_data[index] = extrapolation_value;
-        }
-        }
-        continue;
+    ThreadPool* ttp) {
+  if (nthreads == 0) {
+    return;
+  }
+
+  const int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
+  const bool bilinear = mode == "bilinear";
+  const T extrapolation = static_cast<T>(extrapolation_value);
+
+  // The (roi, channel) pairs are split over the thread pool. A block of pairs computes the interpolation tables of
+  // each of its ROIs once and reuses them for all the channels of that ROI in the block. The tables are separable,
+  // so a row of the crop blends two source rows with the same column indices and weights.
+  auto work_object = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    CropAxisTable<T> y_table;
+    CropAxisTable<T> x_table;
+    int64_t current_n = -1;
+    int64_t roi_batch_ind = 0;
+
+    for (std::ptrdiff_t n_c = first; n_c < last; ++n_c) {
+      const int64_t n = n_c / channels;
+      const int64_t c = n_c % channels;
+
+      if (n != current_n) {
+        current_n = n;
+
+        const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
+        roi_batch_ind = batch_indices_ptr[n];
+
+        T roi_start_w = offset_bottom_rois[1];
+        T roi_start_h = offset_bottom_rois[0];
+        T roi_end_w = offset_bottom_rois[3];
+        T roi_end_h = offset_bottom_rois[2];
+
+        y_table.Compute(pooled_height, roi_start_h, roi_end_h, height, bilinear);
+        x_table.Compute(pooled_width, roi_start_w, roi_end_w, width, bilinear);
       }
 
-      const int top_y_index = static_cast<int>(floorf(static_cast<float>(in_y)));
-      const int bottom_y_index = static_cast<int>(ceilf(static_cast<float>(in_y)));
-      const float y_lerp = static_cast<float>(in_y - top_y_index);
-
-      for (auto pw = 0; pw < pooled_width; pw++) {
-        T in_x = static_cast<T>((pooled_width > 1)
-        ? roi_start_w * (width - 1) + pw * width_scale
-        : 0.5 * (roi_start_w + roi_end_w) * (width - 1));
-        if (pw == pooled_width - 1) {
-        in_x = static_cast<T>((pooled_width > 1)
-          ? roi_end_w * (width - 1)
-          : 0.5 * (roi_start_w + roi_end_w) * (width - 1));
-        }
-        if (pw == 0) {
-        in_x = static_cast<T>((pooled_width > 1)
-          ? roi_start_w * (width - 1)
-          : 0.5 * (roi_start_w + roi_end_w) * (width - 1));
-        }
-        if (in_x < 0 || in_x > width - 1) {
-        for (int64_t c = 0; c < channels; c++)
-        {
-          int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-          int64_t index = index_n_c + ph * pooled_width + pw;
-          top_data[index] = extrapolation_value;
-        }
-        continue;
+      const T* offset_bottom_data = bottom_data + (roi_batch_ind * channels + c) * height * width;
+      T* offset_top_data = top_data + n_c * pooled_width * pooled_height;
+
+      const int64_t* x_low = x_table.low.data();
+      const int64_t* x_high = x_table.high.data();
+      const float* x_lerp = x_table.lerp.data();
+      const uint8_t* x_valid = x_table.valid.data();
+
+      for (int32_t ph = 0; ph < pooled_height; ph++) {
+        T* row = offset_top_data + ph * pooled_width;
+        if (!y_table.valid[ph]) {
+          std::fill(row, row + pooled_width, extrapolation);
+          continue;
         }
 
-        T output_val = extrapolation_value;
-        if (mode == "bilinear") {
-          const int left_x_index = static_cast<int>(floorf(static_cast<float>(in_x)));
-          const int right_x_index = static_cast<int>(ceilf(static_cast<float>(in_x)));
-          const float x_lerp = static_cast<float>(in_x - left_x_index);
-          auto top_left_index = top_y_index * width + left_x_index;
-          auto top_right_index = top_y_index * width + right_x_index;
-          auto bottom_left_index = bottom_y_index * width + left_x_index;
-          auto bottom_right_index = bottom_y_index * width + right_x_index;
-
-          for (auto c = 0; c < channels; c++)
-          {
-            int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-            int64_t index = index_n_c + ph * pooled_width + pw;
-            const T* offset_bottom_data =
-            bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-            const float top_left(static_cast<float>(offset_bottom_data[top_left_index]));
-            const float top_right(static_cast<float>(offset_bottom_data[top_right_index]));
-            const float bottom_left(static_cast<float>(offset_bottom_data[bottom_left_index]));
-            const float bottom_right(static_cast<float>(offset_bottom_data[bottom_right_index]));
-            const float top = top_left + (top_right - top_left) * x_lerp;
-            const float bottom = bottom_left + (bottom_right - bottom_left) * x_lerp;
-            output_val = top + (bottom - top) * y_lerp;
-            top_data[index] = output_val;
+        const T* top = offset_bottom_data + y_table.low[ph] * width;
+        if (bilinear) {
+          const T* bottom = offset_bottom_data + y_table.high[ph] * width;
+          const float y_lerp = y_table.lerp[ph];
+          for (int32_t pw = 0; pw < pooled_width; pw++) {
+            const float top_left(static_cast<float>(top[x_low[pw]]));
+            const float top_right(static_cast<float>(top[x_high[pw]]));
+            const float bottom_left(static_cast<float>(bottom[x_low[pw]]));
+            const float bottom_right(static_cast<float>(bottom[x_high[pw]]));
+            const float top_val = top_left + (top_right - top_left) * x_lerp[pw];
+            const float bottom_val = bottom_left + (bottom_right - bottom_left) * x_lerp[pw];
+            const T output_val = static_cast<T>(top_val + (bottom_val - top_val) * y_lerp);
+            row[pw] = x_valid[pw] ? output_val : extrapolation;
           }
-        }
-        else {  // mode == "nearest"
-          const int closest_x_index = static_cast<int>(roundf(static_cast<float>(in_x)));
-          const int closest_y_index = static_cast<int>(roundf(static_cast<float>(in_y)));
-          auto closest_index = closest_y_index * width + closest_x_index;
-
-          for (auto c = 0; c < channels; c++)
-          {
-            int64_t index_n_c = index_n + c * pooled_width * pooled_height;
-            int64_t index = index_n_c + ph * pooled_width + pw;
-            const T* offset_bottom_data =
-              bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
-            top_data[index] = static_cast<float>(offset_bottom_data[closest_index]);
+        } else {  // mode == "nearest"
+          for (int32_t pw = 0; pw < pooled_width; pw++) {
+            row[pw] = x_valid[pw] ? top[x_low[pw]] : extrapolation;
           }
         }
-      }  // for pw
-    }    // for ph
-  };     // for n
-  const_cast<ThreadPool*>(ttp)->ParallelFor(static_cast<int32_t>(n_rois), work_object);
+      }  // for ph
+    }    // for n_c
+  };
+
+  const std::ptrdiff_t total = static_cast<std::ptrdiff_t>(n_rois * channels);
+  if (ttp == nullptr) {
+    work_object(0, total);
+  } else {
+    ttp->ParallelFor(total, kCostPerSample * static_cast<double>(pooled_height) * pooled_width, work_object);
+  }
 }
 
 template <typename T>
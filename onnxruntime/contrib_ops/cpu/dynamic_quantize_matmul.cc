@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/dynamic_quantize_matmul.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/util/qmath.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    DynamicQuantizeMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeMatMul);
+
+Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
+  auto a = ctx->Input<Tensor>(0);
+  auto b = ctx->Input<Tensor>(1);
+  ORT_ENFORCE(a != nullptr && b != nullptr);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  auto b_scale = ctx->Input<Tensor>(2);
+  ORT_ENFORCE(IsScalarOr1ElementVector(b_scale),
+              "DynamicQuantizeMatMul : weight scale must be a scalar or 1D tensor of size 1");
+  uint8_t b_offset = 0;
+  auto b_zero_point = ctx->Input<Tensor>(3);
+  if (b_zero_point != nullptr) {
+    ORT_ENFORCE(IsScalarOr1ElementVector(b_zero_point),
+                "DynamicQuantizeMatMul : weight zero point must be a scalar or 1D tensor of size 1");
+    b_offset = *b_zero_point->template Data<uint8_t>();
+  }
+  auto bias = ctx->Input<Tensor>(4);
+  if (bias != nullptr) {
+    ORT_ENFORCE(bias->Shape().NumDimensions() == 1 && bias->Shape()[0] == static_cast<int64_t>(helper.N()),
+                "DynamicQuantizeMatMul : bias must be a 1D tensor of N elements");
+  }
+
+  // The scale and zero point of A, computed as DynamicQuantizeLinear does: the range of A extended to contain 0,
+  // which is then exactly representable.
+  const auto* a_data = a->template Data<float>();
+  float a_min = 0.f;
+  float a_max = 0.f;
+  if (a->Shape().Size() > 0) {
+    MlasFindMinMaxElement(a_data, &a_min, &a_max, static_cast<size_t>(a->Shape().Size()));
+  }
+  a_min = std::min(a_min, 0.f);
+  a_max = std::max(a_max, 0.f);
+  // a scale of 0 would divide by 0 for an A of zeros, which quantizes to 0 with any scale
+  const float a_scale = (a_max > a_min) ? (a_max - a_min) / 255.f : 1.f;
+  const auto a_offset = static_cast<uint8_t>(std::nearbyint(std::max(0.f, std::min(255.f, -a_min / a_scale))));
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+
+  // The 32-bit accumulators for one matrix, dequantized to the output by the GEMM.
+  const size_t gemm_output_size = static_cast<size_t>(helper.M() * helper.N());
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * gemm_output_size);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    QGemmf32u8_f32(static_cast<int>(helper.M()),
+                   static_cast<int>(helper.N()),
+                   static_cast<int>(helper.K()),
+                   a_data + helper.LeftOffsets()[i],
+                   static_cast<int>(helper.K()),
+                   a_scale,
+                   a_offset,
+                   b->template Data<uint8_t>() + helper.RightOffsets()[i],
+                   static_cast<int>(helper.N()),
+                   b_offset,
+                   bias != nullptr ? bias->template Data<float>() : nullptr,
+                   gemm_output,
+                   y->template MutableData<float>() + helper.OutputOffsets()[i],
+                   static_cast<int>(helper.N()),
+                   a_scale * *b_scale->template Data<float>(),
+                   thread_pool);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Elements per task. All the ops of the chain run over a block that stays in the L1 cache before moving on to
+// the next block, so the input and output are each streamed through memory once.
+static constexpr int64_t kFusedElementwiseBlockSize = 4096;
+
+namespace {
+
+// The second input of a binary op. size is the element count of the whole input, 1, or the size of the last
+// dimension it is broadcast along.
+struct Operand {
+  const float* data;
+  int64_t size;
+};
+
+// dst[i] = op(src[i], operand[start + i]) for count elements, broadcasting the operand as needed.
+template <typename TOp>
+void ApplyBinary(TOp op, const float* src, float* dst, const Operand& operand, int64_t elem_count, int64_t start,
+                 size_t count) {
+  if (operand.size == elem_count) {
+    const float* b = operand.data + start;
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = op(src[i], b[i]);
+    }
+  } else if (operand.size == 1) {
+    const float b = *operand.data;
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = op(src[i], b);
+    }
+  } else {
+    // broadcast along the last dimension one row segment at a time, so the inner loop stays contiguous
+    int64_t offset = start % operand.size;
+    size_t i = 0;
+    while (i < count) {
+      const size_t segment = static_cast<size_t>(std::min(static_cast<int64_t>(count - i), operand.size - offset));
+      const float* b = operand.data + offset;
+      for (size_t j = 0; j < segment; ++j) {
+        dst[i + j] = op(src[i + j], b[j]);
+      }
+      i += segment;
+      offset = 0;
+    }
+  }
+}
+
+template <typename TOp>
+void ApplyBinary(TOp op, bool operand_first, const float* src, float* dst, const Operand& operand,
+                 int64_t elem_count, int64_t start, size_t count) {
+  if (operand_first) {
+    ApplyBinary([op](float a, float b) { return op(b, a); }, src, dst, operand, elem_count, start, count);
+  } else {
+    ApplyBinary(op, src, dst, operand, elem_count, start, count);
+  }
+}
+
+template <typename TOp>
+void ApplyUnary(TOp op, const float* src, float* dst, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = op(src[i]);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  static const std::unordered_map<std::string, ElementwiseOp> op_names = {
+      {"Abs", ElementwiseOp::Abs}, {"Exp", ElementwiseOp::Exp}, {"Neg", ElementwiseOp::Neg},
+      {"Relu", ElementwiseOp::Relu}, {"Sigmoid", ElementwiseOp::Sigmoid}, {"Tanh", ElementwiseOp::Tanh},
+      {"Add", ElementwiseOp::Add}, {"Sub", ElementwiseOp::Sub}, {"Mul", ElementwiseOp::Mul},
+      {"Div", ElementwiseOp::Div}};
+
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK() && !ops.empty(), "ops must be a non-empty list");
+  const auto operand_first = info.GetAttrsOrDefault<int64_t>("operand_first");
+
+  for (const auto& op : ops) {
+    auto it = op_names.find(op);
+    ORT_ENFORCE(it != op_names.end(), "Unsupported elementwise op ", op);
+    ops_.push_back(it->second);
+
+    bool is_operand_first = false;
+    if (it->second >= ElementwiseOp::Add) {
+      is_operand_first = binary_op_count_ < operand_first.size() && operand_first[binary_op_count_] != 0;
+      ++binary_op_count_;
+    }
+    operand_first_.push_back(is_operand_first);
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  const int64_t elem_count = shape.Size();
+  const int64_t last_dim = shape.NumDimensions() > 0 ? shape[shape.NumDimensions() - 1] : 1;
+
+  if (static_cast<size_t>(context->InputCount()) != binary_op_count_ + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", binary_op_count_ + 1,
+                           " inputs for the binary ops of the chain, got ", context->InputCount());
+  }
+
+  std::vector<Operand> operands;
+  operands.reserve(binary_op_count_);
+  for (size_t i = 1; i <= binary_op_count_; ++i) {
+    const Tensor* B = context->Input<Tensor>(static_cast<int>(i));
+    const TensorShape& b_shape = B->Shape();
+    const int64_t size = b_shape.Size();
+    if (size != elem_count && size != 1 &&
+        !(size == last_dim && b_shape.NumDimensions() > 0 && b_shape[b_shape.NumDimensions() - 1] == last_dim)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", i, " with shape ", b_shape,
+                             " can't be broadcast to the shape of the first input ", shape);
+    }
+    operands.push_back({B->template Data<float>(), size});
+  }
+
+  Tensor* Y = context->Output(0, shape);
+  const float* input = X->template Data<float>();
+  float* output = Y->template MutableData<float>();
+
+  const std::ptrdiff_t task_count =
+      static_cast<std::ptrdiff_t>((elem_count + kFusedElementwiseBlockSize - 1) / kFusedElementwiseBlockSize);
+  auto compute_tasks = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t start = task * kFusedElementwiseBlockSize;
+      const size_t count = static_cast<size_t>(std::min(kFusedElementwiseBlockSize, elem_count - start));
+
+      // the first op reads the input, the following ones update the output block in place
+      const float* src = input + start;
+      float* dst = output + start;
+      size_t operand_index = 0;
+      for (size_t k = 0; k < ops_.size(); ++k) {
+        const bool operand_first = operand_first_[k];
+        switch (ops_[k]) {
+          case ElementwiseOp::Abs:
+            ApplyUnary([](float x) { return std::abs(x); }, src, dst, count);
+            break;
+          case ElementwiseOp::Exp:
+            MlasComputeExp(src, dst, count);
+            break;
+          case ElementwiseOp::Neg:
+            ApplyUnary([](float x) { return -x; }, src, dst, count);
+            break;
+          case ElementwiseOp::Relu:
+            ApplyUnary([](float x) { return std::max(x, 0.0f); }, src, dst, count);
+            break;
+          case ElementwiseOp::Sigmoid:
+            MlasComputeLogistic(src, dst, count);
+            break;
+          case ElementwiseOp::Tanh:
+            MlasComputeTanh(src, dst, count);
+            break;
+          case ElementwiseOp::Add:
+            ApplyBinary([](float a, float b) { return a + b; }, operand_first, src, dst, operands[operand_index++],
+                        elem_count, start, count);
+            break;
+          case ElementwiseOp::Sub:
+            ApplyBinary([](float a, float b) { return a - b; }, operand_first, src, dst, operands[operand_index++],
+                        elem_count, start, count);
+            break;
+          case ElementwiseOp::Mul:
+            ApplyBinary([](float a, float b) { return a * b; }, operand_first, src, dst, operands[operand_index++],
+                        elem_count, start, count);
+            break;
+          case ElementwiseOp::Div:
+            ApplyBinary([](float a, float b) { return a / b; }, operand_first, src, dst, operands[operand_index++],
+                        elem_count, start, count);
+            break;
+        }
+        src = dst;
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp == nullptr || task_count <= 1) {
+    compute_tasks(0, task_count);
+  } else {
+    tp->ParallelFor(task_count, static_cast<double>(kFusedElementwiseBlockSize * ops_.size() * 4), compute_tasks);
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise<float>);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class FusedElementwise final : public OpKernel {
+ public:
+  enum class ElementwiseOp {
+    Abs,
+    Exp,
+    Neg,
+    Relu,
+    Sigmoid,
+    Tanh,
+    Add,
+    Sub,
+    Mul,
+    Div,
+  };
+
+  FusedElementwise(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<ElementwiseOp> ops_;
+  // for each of ops_, whether the operand of a binary op comes first
+  std::vector<bool> operand_first_;
+  size_t binary_op_count_{0};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -10,8 +10,20 @@ template <typename T>
 class FusedGemm final : public Gemm<T> {
  public:
   FusedGemm(const OpKernelInfo& info) : Gemm<T>(info) {
-    Gemm<T>::activation_ = info.GetAttrOrDefault<std::string>("activation", "");
-    Gemm<T>::leaky_relu_alpha_ = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+    const auto activation = info.GetAttrOrDefault<std::string>("activation", "");
+    MLAS_ACTIVATION& mlas_activation = Gemm<T>::activation_;
+    if (activation == "Relu") {
+      mlas_activation.ActivationKind = MlasReluActivation;
+    } else if (activation == "Sigmoid") {
+      mlas_activation.ActivationKind = MlasLogisticActivation;
+    } else if (activation == "Tanh") {
+      mlas_activation.ActivationKind = MlasTanhActivation;
+    } else if (activation == "LeakyRelu") {
+      mlas_activation.ActivationKind = MlasLeakyReluActivation;
+      mlas_activation.Parameters.LeakyRelu.alpha = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+    } else if (!activation.empty()) {
+      ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation);
+    }
   }
 };
 
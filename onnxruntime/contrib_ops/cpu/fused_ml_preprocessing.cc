@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_ml_preprocessing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Features per task, rounded to whole rows. All the ops of the chain run over the rows of a task while they stay
+// in the L1 cache, so the input and output are each streamed through memory once.
+static constexpr int64_t kFusedMLPreprocessingBlockSize = 4096;
+
+namespace {
+
+// The ops as their ai.onnx.ml kernels compute them, over a row of count features. src and dst may be the same.
+
+void Impute(const float* src, float* dst, size_t count, const float* imputed_values, float replaced_value) {
+  const bool replace_nan = std::isnan(replaced_value);
+  for (size_t i = 0; i < count; ++i) {
+    const float x = src[i];
+    dst[i] = (x == replaced_value || (replace_nan && std::isnan(x))) ? imputed_values[i] : x;
+  }
+}
+
+void Scale(const float* src, float* dst, size_t count, const float* offset, const float* scale) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = (src[i] - offset[i]) * scale[i];
+  }
+}
+
+void Normalize(const float* src, float* dst, size_t count, ml::NORMALIZE norm) {
+  float divisor = 0.f;
+  switch (norm) {
+    case ml::NORMALIZE::NMAX:
+      divisor = std::numeric_limits<float>::lowest();
+      for (size_t i = 0; i < count; ++i) {
+        divisor = std::max(divisor, src[i]);
+      }
+      break;
+    case ml::NORMALIZE::L1:
+      for (size_t i = 0; i < count; ++i) {
+        divisor += std::abs(src[i]);
+      }
+      break;
+    case ml::NORMALIZE::L2:
+      for (size_t i = 0; i < count; ++i) {
+        divisor += src[i] * src[i];
+      }
+      break;
+  }
+
+  // rows with a zero norm are left as they are
+  if (divisor == 0.f) {
+    if (dst != src) {
+      std::copy(src, src + count, dst);
+    }
+  } else if (norm == ml::NORMALIZE::L2) {
+    for (size_t i = 0; i < count; ++i) {
+      const float x = src[i];
+      const float y = std::sqrt(x * x / divisor);
+      dst[i] = x < 0 ? -y : y;
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = src[i] / divisor;
+    }
+  }
+}
+
+// Returns the index of the first NaN of the row, which the Binarizer kernel fails on, or count.
+size_t Binarize(const float* src, float* dst, size_t count, float threshold) {
+  for (size_t i = 0; i < count; ++i) {
+    const float x = src[i];
+    if (std::isnan(x)) {
+      return i;
+    }
+    dst[i] = x > threshold ? 1.0f : 0.0f;
+  }
+  return count;
+}
+
+}  // namespace
+
+FusedMLPreprocessing::FusedMLPreprocessing(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK() && !ops.empty(), "ops must be a non-empty list");
+  feature_values_ = info.GetAttrsOrDefault<float>("feature_values");
+  const auto scalar_values = info.GetAttrsOrDefault<float>("scalar_values");
+  const auto norms = info.GetAttrsOrDefault<std::string>("norms");
+
+  // the per feature values are counted in rows of feature_count_ values until the row size is known
+  size_t feature_rows = 0;
+  size_t scalar_index = 0;
+  size_t norm_index = 0;
+  for (const auto& op : ops) {
+    Step step{PreprocessingOp::Imputer, feature_rows, 0.f, ml::NORMALIZE::NMAX};
+    if (op == "Imputer" || op == "Binarizer") {
+      ORT_ENFORCE(scalar_index < scalar_values.size(), "Missing scalar_values for ", op);
+      step.scalar = scalar_values[scalar_index++];
+    }
+
+    if (op == "Imputer") {
+      feature_rows += 1;
+    } else if (op == "Scaler") {
+      step.op = PreprocessingOp::Scaler;
+      feature_rows += 2;
+    } else if (op == "Normalizer") {
+      ORT_ENFORCE(norm_index < norms.size(), "Missing norms for Normalizer");
+      step.op = PreprocessingOp::Normalizer;
+      step.norm = ml::MakeNormalize(norms[norm_index++]);
+    } else if (op == "Binarizer") {
+      step.op = PreprocessingOp::Binarizer;
+    } else {
+      ORT_THROW("Unsupported preprocessing op ", op);
+    }
+    steps_.push_back(step);
+  }
+
+  ORT_ENFORCE(scalar_index == scalar_values.size() && norm_index == norms.size(),
+              "scalar_values and norms must have one value per op that uses them");
+  if (feature_rows > 0) {
+    ORT_ENFORCE(!feature_values_.empty() && feature_values_.size() % feature_rows == 0,
+                "feature_values must have the same number of values for each Imputer, Scaler offset and scale");
+    feature_count_ = static_cast<int64_t>(feature_values_.size() / feature_rows);
+    for (auto& step : steps_) {
+      step.feature_values *= static_cast<size_t>(feature_count_);
+    }
+  } else {
+    ORT_ENFORCE(feature_values_.empty(), "feature_values given without an Imputer or Scaler");
+  }
+}
+
+Status FusedMLPreprocessing::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  if (shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input must be a [N, C] feature matrix, got ", shape);
+  }
+  const int64_t rows = shape[0];
+  const int64_t cols = shape[1];
+  if (feature_count_ != 0 && cols != feature_count_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input has ", cols, " features, the parameters are for ",
+                           feature_count_);
+  }
+
+  Tensor* Y = context->Output(0, shape);
+  const float* input = X->template Data<float>();
+  float* output = Y->template MutableData<float>();
+  if (rows == 0 || cols == 0) {
+    return Status::OK();
+  }
+
+  // the lowest element index that a Binarizer found a NaN at
+  std::atomic<int64_t> nan_index{std::numeric_limits<int64_t>::max()};
+
+  const int64_t rows_per_task = std::max<int64_t>(1, kFusedMLPreprocessingBlockSize / cols);
+  const std::ptrdiff_t task_count = static_cast<std::ptrdiff_t>((rows + rows_per_task - 1) / rows_per_task);
+  const size_t count = static_cast<size_t>(cols);
+  auto compute_tasks = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t row_end = std::min(rows, (task + 1) * rows_per_task);
+      for (int64_t row = task * rows_per_task; row < row_end; ++row) {
+        // the first op reads the input, the following ones update the output row in place
+        const float* src = input + row * cols;
+        float* dst = output + row * cols;
+        for (const auto& step : steps_) {
+          const float* values = feature_values_.data() + step.feature_values;
+          switch (step.op) {
+            case PreprocessingOp::Imputer:
+              Impute(src, dst, count, values, step.scalar);
+              break;
+            case PreprocessingOp::Scaler:
+              Scale(src, dst, count, values, values + count);
+              break;
+            case PreprocessingOp::Normalizer:
+              Normalize(src, dst, count, step.norm);
+              break;
+            case PreprocessingOp::Binarizer: {
+              const size_t nan_offset = Binarize(src, dst, count, step.scalar);
+              if (nan_offset != count) {
+                const int64_t index = row * cols + static_cast<int64_t>(nan_offset);
+                int64_t current = nan_index.load();
+                while (index < current && !nan_index.compare_exchange_weak(current, index)) {
+                }
+                return;
+              }
+            } break;
+          }
+          src = dst;
+        }
+      }
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp == nullptr || task_count <= 1) {
+    compute_tasks(0, task_count);
+  } else {
+    tp->ParallelFor(task_count, static_cast<double>(rows_per_task * cols * steps_.size() * 4), compute_tasks);
+  }
+
+  if (nan_index.load() != std::numeric_limits<int64_t>::max()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input data with index: ", nan_index.load(), " is NaN");
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedMLPreprocessing,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedMLPreprocessing);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/ml/ml_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class FusedMLPreprocessing final : public OpKernel {
+ public:
+  enum class PreprocessingOp {
+    Imputer,
+    Scaler,
+    Normalizer,
+    Binarizer,
+  };
+
+  // An op of the chain with the parameters it uses. feature_values is the offset of the per feature values of
+  // an Imputer or Scaler in feature_values_, scalar the replaced value of an Imputer or threshold of a Binarizer.
+  struct Step {
+    PreprocessingOp op;
+    size_t feature_values;
+    float scalar;
+    ml::NORMALIZE norm;
+  };
+
+  FusedMLPreprocessing(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<Step> steps_;
+  std::vector<float> feature_values_;
+  // the number of features the per feature values are for, or 0 if there are none
+  int64_t feature_count_{0};
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #include "contrib_ops/cpu/gather_nd.h"
 
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/gather.h"
+
 namespace onnxruntime {
 namespace contrib     {
 
@@ -93,30 +96,31 @@ Status GatherND::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(context->Input<Tensor>(1)->DataType() == DataTypeImpl::GetType<int32_t>() ? 
                               PrepareForCompute<int32_t>(context, p) : PrepareForCompute<int64_t>(context, p));
 
-  return nullptr == p.input_str_base ? GatherNumber(p) : GatherString(p);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
-Status GatherND::GatherNumber(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    memcpy(p.output_base + i * p.bytes_to_copy,
-           p.input_base + p.element_offsets[i] * p.element_bytes,
-           p.bytes_to_copy);
-  }
+Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
+  GatherRows(p.output_base, static_cast<int64_t>(p.element_offsets.size()), static_cast<size_t>(p.bytes_to_copy), tp,
+             [&p](std::ptrdiff_t i) { return p.input_base + p.element_offsets[i] * p.element_bytes; });
 
   return Status::OK();
 }
 
-Status GatherND::GatherString(const Prepare& p) const {
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t i = 0; i < static_cast<int64_t>(p.element_offsets.size()); ++i) {
-    for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
-      p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) const {
+  auto copy_strings = [&p](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      for (int64_t j = 0; j < static_cast<int64_t>(p.element_to_copy); ++j) {
+        p.output_str_base[i * p.element_to_copy + j] = p.input_str_base[p.element_offsets[i] + j];
+      }
     }
+  };
+
+  const auto offset_count = static_cast<std::ptrdiff_t>(p.element_offsets.size());
+  if (tp == nullptr) {
+    copy_strings(0, offset_count);
+  } else {
+    tp->ParallelFor(offset_count, 64.0 * static_cast<double>(p.element_to_copy), copy_strings);
   }
 
   return Status::OK();
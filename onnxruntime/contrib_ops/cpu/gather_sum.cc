@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/gather_sum.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GatherSum,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    GatherSum<float>);
+
+template <typename T, typename Tind>
+static Status SumBags(const T* data, int64_t row_count, int64_t row_size, const Tind* indices, int64_t bag_count,
+                      int64_t bag_size, T* output, concurrency::ThreadPool* tp) {
+  // Check the indices first so that the threaded loop below can't fail.
+  for (int64_t i = 0; i < bag_count * bag_size; ++i) {
+    if (indices[i] < 0 || indices[i] >= row_count) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=", indices[i],
+                             " data_dim=", row_count);
+    }
+  }
+
+  auto sum_bags = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t bag = first; bag < last; ++bag) {
+      T* y = output + bag * row_size;
+      const Tind* bag_indices = indices + bag * bag_size;
+      if (bag_size == 0) {
+        std::fill_n(y, row_size, T{0});
+        continue;
+      }
+
+      // the first row initializes the sum, so the output is written once per row of the bag
+      memcpy(y, data + bag_indices[0] * row_size, row_size * sizeof(T));
+      for (int64_t j = 1; j < bag_size; ++j) {
+        if (j + gather_detail::kPrefetchDistance < bag_size) {
+          ORT_GATHER_PREFETCH(data + bag_indices[j + gather_detail::kPrefetchDistance] * row_size);
+        }
+        const T* x = data + bag_indices[j] * row_size;
+        for (int64_t k = 0; k < row_size; ++k) {
+          y[k] += x[k];
+        }
+      }
+    }
+  };
+
+  if (tp == nullptr) {
+    sum_bags(0, static_cast<std::ptrdiff_t>(bag_count));
+  } else {
+    // as for Gather, each row costs a cache miss plus the work over its elements
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(bag_count),
+                    static_cast<double>(bag_size) * (64.0 + static_cast<double>(row_size)), sum_bags);
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+Status GatherSum<T>::Compute(OpKernelContext* context) const {
+  const auto* data_tensor = context->Input<Tensor>(0);
+  const auto* indices_tensor = context->Input<Tensor>(1);
+  const TensorShape& data_shape = data_tensor->Shape();
+  const TensorShape& indices_shape = indices_tensor->Shape();
+
+  if (data_shape.NumDimensions() < 1 || indices_shape.NumDimensions() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data and indices must have a rank of at least 1");
+  }
+
+  // the last axis of the indices is summed over and replaced by the dimensions of a row of data
+  const auto& indices_dims = indices_shape.GetDims();
+  const auto& data_dims = data_shape.GetDims();
+  std::vector<int64_t> output_dims(indices_dims.begin(), indices_dims.end() - 1);
+  output_dims.insert(output_dims.end(), data_dims.begin() + 1, data_dims.end());
+  Tensor* output_tensor = context->Output(0, TensorShape(output_dims));
+
+  const int64_t row_count = data_shape[0];
+  const int64_t row_size = data_shape.SizeFromDimension(1);
+  const int64_t bag_size = indices_dims.back();
+  const int64_t bag_count = indices_shape.SizeToDimension(indices_shape.NumDimensions() - 1);
+
+  const T* data = data_tensor->template Data<T>();
+  T* output = output_tensor->template MutableData<T>();
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  if (indices_tensor->DataType() == DataTypeImpl::GetType<int32_t>()) {
+    return SumBags(data, row_count, row_size, indices_tensor->template Data<int32_t>(), bag_count, bag_size,
+                   output, tp);
+  }
+  if (indices_tensor->DataType() == DataTypeImpl::GetType<int64_t>()) {
+    return SumBags(data, row_count, row_size, indices_tensor->template Data<int64_t>(), bag_count, bag_size,
+                   output, tp);
+  }
+
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in GatherSum.");
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Sums the rows of data selected by each bag of indices along their last axis: an embedding bag lookup,
+// which is Gather(axis=0) followed by ReduceSum over the last axis of the indices.
+template <typename T>
+class GatherSum final : public OpKernel {
+ public:
+  explicit GatherSum(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
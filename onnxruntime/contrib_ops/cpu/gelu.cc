@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gelu.h"
+
+#include <algorithm>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Elements per task. Each task runs its three steps over a block that stays in the L1 cache, so the input
+// and output are each streamed through memory once.
+static constexpr int64_t kGeluBlockSize = 4096;
+
+// Splits the elements into blocks and runs fn(input, output, count) on each block, in parallel when there
+// is an operator thread pool.
+template <typename TFunc>
+static void ComputeBlocks(OpKernelContext* context, const float* input, float* output, int64_t elem_count,
+                          TFunc fn) {
+  const std::ptrdiff_t task_count = static_cast<std::ptrdiff_t>((elem_count + kGeluBlockSize - 1) / kGeluBlockSize);
+  auto compute_tasks = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t start = task * kGeluBlockSize;
+      const size_t count = static_cast<size_t>(std::min(kGeluBlockSize, elem_count - start));
+      fn(input + start, output + start, count);
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp == nullptr || task_count <= 1) {
+    compute_tasks(0, task_count);
+  } else {
+    tp->ParallelFor(task_count, static_cast<double>(kGeluBlockSize * 16), compute_tasks);
+  }
+}
+
+template <>
+Status Gelu<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  Tensor* Y = context->Output(0, X->Shape());
+
+  ComputeBlocks(context, X->Data<float>(), Y->MutableData<float>(), X->Shape().Size(),
+                [](const float* input, float* output, size_t count) {
+                  // 1 / sqrt(2)
+                  constexpr float kAlpha = 0.7071067811865476f;
+                  // the output block holds erf(x / sqrt(2)) until the final step
+                  for (size_t i = 0; i < count; ++i) {
+                    output[i] = kAlpha * input[i];
+                  }
+                  MlasComputeErf(output, output, count);
+                  for (size_t i = 0; i < count; ++i) {
+                    output[i] = 0.5f * input[i] * (output[i] + 1.0f);
+                  }
+                });
+
+  return Status::OK();
+}
+
+template <>
+Status FastGelu<float>::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  Tensor* Y = context->Output(0, X->Shape());
+
+  ComputeBlocks(context, X->Data<float>(), Y->MutableData<float>(), X->Shape().Size(),
+                [](const float* input, float* output, size_t count) {
+                  // sqrt(2 / pi)
+                  constexpr float kAlpha = 0.7978845608028654f;
+                  constexpr float kBeta = 0.044715f;
+                  for (size_t i = 0; i < count; ++i) {
+                    const float x = input[i];
+                    output[i] = kAlpha * x * (1.0f + kBeta * x * x);
+                  }
+                  MlasComputeTanh(output, output, count);
+                  for (size_t i = 0; i < count; ++i) {
+                    output[i] = 0.5f * input[i] * (output[i] + 1.0f);
+                  }
+                });
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    Gelu,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    Gelu<float>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    FastGelu,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FastGelu<float>);
+
+}  // namespace contrib
+}  // namespace onnxruntime
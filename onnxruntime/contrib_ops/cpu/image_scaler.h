@@ -5,6 +5,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -42,8 +44,19 @@ class ImageScaler final : public OpKernel {
     ConstEigenArrayMap<T> X_arr(X->template Data<T>(), H * W, N * C);
     EigenArrayMap<T> Y_arr(Y->template MutableData<T>(), H * W, N * C);
 
-    for (int64_t nc = 0; nc < N * C; ++nc) {
-      Y_arr.col(nc) = scale_ * X_arr.col(nc) + bias_[nc % C];
+    // the image planes are scaled in parallel, each in one vectorized pass
+    auto scale_planes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t nc = first; nc < last; ++nc) {
+        Y_arr.col(nc) = scale_ * X_arr.col(nc) + bias_[nc % C];
+      }
+    };
+
+    const auto plane_count = static_cast<std::ptrdiff_t>(N * C);
+    concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+    if (tp == nullptr) {
+      scale_planes(0, plane_count);
+    } else {
+      tp->ParallelFor(plane_count, static_cast<double>(H * W), scale_planes);
     }
     return Status::OK();
   }
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "layer_norm.h"
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      LayerNormalization,                                         \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCpuExecutionProvider,                                      \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      LayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+
+template <typename T>
+LayerNorm<T>::LayerNorm(const OpKernelInfo& op_kernel_info)
+    : OpKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("axis", &axis_).IsOK());
+  ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+}
+
+template <typename T>
+Status LayerNorm<T>::Compute(OpKernelContext* p_op_kernel_context) const {
+  const Tensor* X = p_op_kernel_context->Input<Tensor>(0);
+  const Tensor* scale = p_op_kernel_context->Input<Tensor>(1);
+  const Tensor* bias = p_op_kernel_context->Input<Tensor>(2);
+  const TensorShape& x_shape = X->Shape();
+
+  const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+  const int64_t norm_count = x_shape.SizeToDimension(axis);
+  const int64_t norm_size = x_shape.SizeFromDimension(axis);
+
+  if (scale->Shape().Size() != norm_size || bias->Shape().Size() != norm_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Size of scale and B must match the normalized dimensions of X. X shape: ", x_shape,
+                           " axis: ", axis_, " scale shape: ", scale->Shape(), " B shape: ", bias->Shape());
+  }
+
+  Tensor* Y = p_op_kernel_context->Output(0, x_shape);
+
+  const T* x_data = X->template Data<T>();
+  const T* scale_data = scale->template Data<T>();
+  const T* bias_data = bias->template Data<T>();
+  T* y_data = Y->template MutableData<T>();
+  const T epsilon = static_cast<T>(epsilon_);
+
+  auto normalize_rows = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    ConstEigenVectorArrayMap<T> scale_arr(scale_data, norm_size);
+    ConstEigenVectorArrayMap<T> bias_arr(bias_data, norm_size);
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      ConstEigenVectorArrayMap<T> x_arr(x_data + i * norm_size, norm_size);
+      EigenVectorArrayMap<T> y_arr(y_data + i * norm_size, norm_size);
+
+      // Y is used as scratch for X - mean, so each row is read from X only twice.
+      const T mean = x_arr.mean();
+      y_arr = x_arr - mean;
+      const T inv_std_dev = 1 / std::sqrt(y_arr.square().mean() + epsilon);
+      y_arr = y_arr * (inv_std_dev * scale_arr) + bias_arr;
+    }
+  };
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    normalize_rows(0, norm_count);
+  } else {
+    tp->ParallelFor(norm_count, static_cast<double>(norm_size * 4), normalize_rows);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
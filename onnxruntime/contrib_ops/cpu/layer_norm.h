@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = (X - mean) / sqrt(variance + epsilon) * scale + B, with the mean and variance computed
+// over the dimensions starting at axis. Rows are normalized independently across the thread pool.
+template <typename T>
+class LayerNorm final : public OpKernel {
+ public:
+  LayerNorm(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* p_op_kernel_context) const override;
+
+ private:
+  int64_t axis_;
+  float epsilon_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
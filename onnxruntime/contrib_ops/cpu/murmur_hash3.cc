@@ -9,6 +9,14 @@
 
 #include "contrib_ops/cpu/murmur_hash3.h"
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
 // Platform-specific functions and macros
 
 // Microsoft Visual Studio
@@ -95,6 +103,13 @@ FORCE_INLINE uint64_t fmix(uint64_t k) {
 namespace onnxruntime {
 namespace contrib {
 
+// Approximate cost, in cycles, of hashing a 32-bit key with the MLAS kernel, and a string of typical length.
+static constexpr double kIntegerKeyCost = 2.0;
+static constexpr double kStringKeyCost = 32.0;
+
+// Keys hashed at a time into a local buffer by HashedEmbedding.
+static constexpr std::ptrdiff_t kHashedEmbeddingBlockSize = 256;
+
 ONNX_OPERATOR_KERNEL_EX(
     MurmurHash3,
     kMSDomain,
@@ -108,7 +123,19 @@ ONNX_OPERATOR_KERNEL_EX(
                                                       DataTypeImpl::GetTensorType<uint32_t>()}),
     MurmurHash3);
 
-void MurmurHash3::MurmurHash3_x86_32(const void* key, int len, uint32_t seed, void* out) const {
+ONNX_OPERATOR_KERNEL_EX(
+    HashedEmbedding,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                      DataTypeImpl::GetTensorType<uint32_t>(),
+                                                      DataTypeImpl::GetTensorType<std::string>()})
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    HashedEmbedding);
+
+static uint32_t MurmurHash3_x86_32(const void* key, int len, uint32_t seed) {
   const uint8_t* data = reinterpret_cast<const uint8_t*>(key);
   const int nblocks = len / 4;
   uint32_t h1 = seed;
@@ -156,10 +183,41 @@ void MurmurHash3::MurmurHash3_x86_32(const void* key, int len, uint32_t seed, vo
 
   h1 = fmix(h1);
 
-  if (is_positive_) {
-    *(uint32_t*)out = h1;
+  return h1;
+}
+
+// Checks that the keys are strings or 32-bit integers, which are hashed as their 4 bytes.
+static Status CheckKeyType(const Tensor& keys, bool& is_string) {
+  const MLDataType keys_type = keys.DataType();
+  is_string = DataTypeImpl::GetType<std::string>() == keys_type;
+  if (!is_string && DataTypeImpl::GetType<int32_t>() != keys_type && DataTypeImpl::GetType<uint32_t>() != keys_type) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type not supported.");
+  }
+  return Status::OK();
+}
+
+// Computes the hashes of the count keys starting at first. The hashes of integer keys are computed by the MLAS
+// kernel, which hashes several keys at a time in the lanes of vector registers.
+static void HashKeys(const Tensor& keys, bool is_string, uint32_t seed, std::ptrdiff_t first, std::ptrdiff_t count,
+                     uint32_t* hashes) {
+  if (is_string) {
+    const std::string* input = keys.Data<std::string>() + first;
+    for (std::ptrdiff_t i = 0; i < count; ++i) {
+      hashes[i] = MurmurHash3_x86_32(input[i].c_str(), static_cast<int>(input[i].length()), seed);
+    }
+  } else {
+    MlasMurmurHash3U32(static_cast<const uint32_t*>(keys.DataRaw()) + first, hashes, static_cast<size_t>(count),
+                       seed);
+  }
+}
+
+static void ParallelForKeys(OpKernelContext* ctx, std::ptrdiff_t count, double cost_per_key,
+                            const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    fn(0, count);
   } else {
-    *(int32_t*)out = h1;
+    tp->ParallelFor(count, cost_per_key, fn);
   }
 }
 
@@ -167,37 +225,63 @@ Status MurmurHash3::Compute(OpKernelContext* ctx) const {
   const Tensor* keys = ctx->Input<Tensor>(0);
   ORT_ENFORCE(keys);
 
+  bool is_string = false;
+  ORT_RETURN_IF_ERROR(CheckKeyType(*keys, is_string));
+
   const TensorShape& input_shape = keys->Shape();
   Tensor* output_tensor = ctx->Output(0, input_shape);
 
-  const MLDataType keys_type = keys->DataType();
-  const int input_element_bytes = static_cast<int>(keys->DataType()->Size());
-  const int output_element_bytes = static_cast<int>(output_tensor->DataType()->Size());
-  const int64_t input_count = input_shape.Size();
-  for (int i = 0; i < input_count; ++i) {
-    if (DataTypeImpl::GetType<std::string>() == keys_type) {
-      auto input = keys->DataRaw();
-      auto output = output_tensor->MutableDataRaw();
-      auto input_string = reinterpret_cast<const std::string*>(input)[i];
-      MurmurHash3_x86_32(input_string.c_str(),
-                         static_cast<int>(input_string.length()),
-                         seed_,
-                         reinterpret_cast<uint8_t*>(output) + static_cast<int64_t>(i) * output_element_bytes);
-    } else {
-      auto output_type = output_tensor->DataType();
-      if ((DataTypeImpl::GetType<int32_t>() == keys_type || DataTypeImpl::GetType<uint32_t>() == keys_type) &&
-          (DataTypeImpl::GetType<int32_t>() == output_type || DataTypeImpl::GetType<uint32_t>() == output_type)) {
-        auto input = keys->DataRaw();
-        auto output = output_tensor->MutableDataRaw();
-        MurmurHash3_x86_32(reinterpret_cast<const uint8_t*>(input) + static_cast<int64_t>(i) * input_element_bytes,
-                           input_element_bytes,
-                           seed_,
-                           reinterpret_cast<uint8_t*>(output) + static_cast<int64_t>(i) * output_element_bytes);
-      } else {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type not supported.");
+  // the int32 output of a non positive hash has the bits of the uint32 hash
+  uint32_t* output = static_cast<uint32_t*>(output_tensor->MutableDataRaw());
+  const auto input_count = static_cast<std::ptrdiff_t>(input_shape.Size());
+  ParallelForKeys(ctx, input_count, is_string ? kStringKeyCost : kIntegerKeyCost,
+                  [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                    HashKeys(*keys, is_string, seed_, first, last - first, output + first);
+                  });
+
+  return Status::OK();
+}
+
+Status HashedEmbedding::Compute(OpKernelContext* ctx) const {
+  const Tensor* keys = ctx->Input<Tensor>(0);
+  const Tensor* table = ctx->Input<Tensor>(1);
+  ORT_ENFORCE(keys && table);
+
+  bool is_string = false;
+  ORT_RETURN_IF_ERROR(CheckKeyType(*keys, is_string));
+
+  const TensorShape& table_shape = table->Shape();
+  if (table_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The embedding table must be 2D, got ", table_shape);
+  }
+  const int64_t row_count = table_shape[0];
+  const int64_t embedding_size = table_shape[1];
+
+  const TensorShape& input_shape = keys->Shape();
+  const auto input_count = static_cast<std::ptrdiff_t>(input_shape.Size());
+  if (row_count == 0 && input_count != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The embedding table has no rows to hash the keys to");
+  }
+
+  std::vector<int64_t> output_dims(input_shape.GetDims());
+  output_dims.push_back(embedding_size);
+  Tensor* output_tensor = ctx->Output(0, TensorShape(std::move(output_dims)));
+
+  const float* table_data = table->Data<float>();
+  float* output = output_tensor->MutableData<float>();
+  const auto rows = static_cast<uint32_t>(row_count);
+  const size_t row_bytes = static_cast<size_t>(embedding_size) * sizeof(float);
+  const double cost_per_key = (is_string ? kStringKeyCost : kIntegerKeyCost) + static_cast<double>(embedding_size);
+  ParallelForKeys(ctx, input_count, cost_per_key, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    uint32_t hashes[kHashedEmbeddingBlockSize];
+    for (std::ptrdiff_t block = first; block < last; block += kHashedEmbeddingBlockSize) {
+      const std::ptrdiff_t count = std::min(kHashedEmbeddingBlockSize, last - block);
+      HashKeys(*keys, is_string, seed_, block, count, hashes);
+      for (std::ptrdiff_t i = 0; i < count; ++i) {
+        memcpy(output + (block + i) * embedding_size, table_data + (hashes[i] % rows) * embedding_size, row_bytes);
       }
     }
-  }
+  });
 
   return Status::OK();
 }
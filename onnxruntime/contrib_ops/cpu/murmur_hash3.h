@@ -13,17 +13,27 @@ class MurmurHash3 final : public OpKernel {
  public:
   MurmurHash3(const OpKernelInfo& info) : OpKernel(info) {
     seed_ = static_cast<uint32_t>(info.GetAttrOrDefault<int64_t>("seed", 0));
-    is_positive_ = static_cast<int64_t>(info.GetAttrOrDefault<int64_t>("positive", 1));
   }
 
   Status Compute(OpKernelContext* context) const override;
 
-private:
-  void MurmurHash3_x86_32(const void* key, int len, uint32_t seed, void* out) const;
+ private:
+  uint32_t seed_;
+};
 
-private :
+// Feature hashing fused with the embedding lookup: each key is hashed with MurmurHash3, and the hash modulo the
+// number of rows of the embedding table selects the row that is copied to the output.
+class HashedEmbedding final : public OpKernel {
+ public:
+  HashedEmbedding(const OpKernelInfo& info) : OpKernel(info) {
+    seed_ = static_cast<uint32_t>(info.GetAttrOrDefault<int64_t>("seed", 0));
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
   uint32_t seed_;
-  int64_t is_positive_{1};
 };
+
 }  // namespace contrib
 }  // namespace onnxruntime
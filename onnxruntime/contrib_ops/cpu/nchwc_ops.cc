@@ -68,6 +68,23 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Upsample,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcUpsample);
+
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Mul,
+    1,
+    float,
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcMul);
+
 template <typename T>
 Status ReorderInput<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -199,5 +216,48 @@ Status NchwcAveragePool::Compute(OpKernelContext* context) const {
                                                                            MlasAveragePoolingExcludePad);
 }
 
+Status NchwcUpsample::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+
+  const auto& X_shape = X->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+
+  std::vector<int64_t> Y_dims(X_shape.GetDims());
+  for (size_t i = 0; i < Y_dims.size(); i++) {
+    Y_dims[i] *= scales_[i];
+  }
+  auto* Y = context->Output(0, Y_dims);
+
+  MlasNchwcUpsample(X_shape.GetDims().data(),
+                    scales_.data() + 2,
+                    X->template Data<float>(),
+                    Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
+Status NchwcMul::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* S = context->Input<Tensor>(1);
+
+  const auto& X_shape = X->Shape();
+  const auto& S_shape = S->Shape();
+  ORT_ENFORCE(X_shape.NumDimensions() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+  ORT_RETURN_IF_NOT(S_shape.NumDimensions() == 4 && S_shape[0] == X_shape[0] && S_shape[1] == X_shape[1] &&
+                        S_shape[2] == 1 && S_shape[3] == 1,
+                    "scale shape ", S_shape, " doesn't match input shape ", X_shape);
+
+  auto* Y = context->Output(0, X_shape);
+
+  MlasNchwcScaleChannels(X_shape.GetDims().data(),
+                         X->template Data<float>(),
+                         S->template Data<float>(),
+                         Y->template MutableData<float>());
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
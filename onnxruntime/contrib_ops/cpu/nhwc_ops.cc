@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "nhwc_ops.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(name, ver, type, builder, ...) \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(name, kMSNhwcDomain, ver, type, kCpuExecutionProvider, builder, __VA_ARGS__)
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    Conv,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcConv);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    MaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    GlobalMaxPool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcMaxPool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    AveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+ONNX_CPU_OPERATOR_TYPED_NHWC_KERNEL(
+    GlobalAveragePool,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcAveragePool);
+
+// Reorders the [M, C, kernel_h, kernel_w] filter to the [kernel_h, kernel_w, C, M] right operand of the GEMM, which
+// matches the (kernel_h, kernel_w, C) order of the columns the NHWC Im2col produces.
+static void ReorderFilter(const float* W, int64_t M, int64_t C, int64_t kernel_size, float* reordered_W) {
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t c = 0; c < C; ++c) {
+      for (int64_t k = 0; k < kernel_size; ++k) {
+        reordered_W[(k * C + c) * M + m] = *W++;
+      }
+    }
+  }
+}
+
+NhwcConv::NhwcConv(const OpKernelInfo& info) : OpKernel(info), ConvBase(info) {
+  ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+
+  // A constant filter is reordered and packed once here rather than on each Compute.
+  const Tensor* W;
+  if (info.TryGetConstantInput(1, &W) && W->Shape().NumDimensions() == 4 && W->Shape().Size() > 0) {
+    const auto& W_shape = W->Shape();
+    const int64_t M = W_shape[0];
+    const int64_t kernel_dim = W_shape.SizeFromDimension(1);
+
+    std::vector<float> reordered_W(static_cast<size_t>(W_shape.Size()));
+    ReorderFilter(W->Data<float>(), M, W_shape[1], W_shape.SizeFromDimension(2), reordered_W.data());
+
+    auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+    const size_t packed_w_size = MlasSgemmPackBSize(static_cast<size_t>(M), static_cast<size_t>(kernel_dim));
+    packed_w_ = BufferUniquePtr(alloc->Alloc(packed_w_size), BufferDeleter(alloc));
+    MlasSgemmPackB(CblasNoTrans, static_cast<size_t>(M), static_cast<size_t>(kernel_dim), reordered_W.data(),
+                   static_cast<size_t>(M), packed_w_.get());
+  }
+}
+
+Status NhwcConv::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  const auto* X = context->Input<Tensor>(0);
+  const auto* W = context->Input<Tensor>(1);
+  const auto* B = context->Input<Tensor>(2);
+
+  const auto& X_shape = X->Shape();
+  const auto& W_shape = W->Shape();
+  if (X_shape.NumDimensions() != 4 || W_shape.NumDimensions() != 4) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Unsupported convolution size.");
+  }
+  if (ConvBase::group_ != 1) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Unsupported convolution group count.");
+  }
+
+  const int64_t N = X_shape[0];
+  const int64_t input_height = X_shape[1];
+  const int64_t input_width = X_shape[2];
+  const int64_t C = X_shape[3];
+  const int64_t M = W_shape[0];
+  if (C != W_shape[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Input channels C is not equal to kernel channels.",
+                           " C: ", C, " kernel channels: ", W_shape[1]);
+  }
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ConvBase::ComputeKernelShape(W_shape, kernel_shape));
+
+  std::vector<int64_t> pads(ConvBase::pads_);
+  if (pads.empty()) {
+    pads.resize(kernel_shape.size() * 2, 0);
+  }
+  std::vector<int64_t> dilations(ConvBase::dilations_);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  std::vector<int64_t> strides(ConvBase::strides_);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  std::vector<int64_t> Y_dims{N};
+  TensorShape input_shape{input_height, input_width};
+  ORT_RETURN_IF_ERROR(ConvBase::InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Y_dims.push_back(M);
+  auto* Y = context->Output(0, Y_dims);
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  const int64_t output_image_size = Y_dims[1] * Y_dims[2];
+  const int64_t kernel_dim = C * kernel_shape[0] * kernel_shape[1];
+  const auto* Xdata = X->Data<float>();
+  const auto* Bdata = B != nullptr ? B->Data<float>() : nullptr;
+  auto* Ydata = Y->MutableData<float>();
+
+  BufferUniquePtr reordered_W_buffer;
+  if (!packed_w_) {
+    reordered_W_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * W_shape.Size()), BufferDeleter(alloc));
+    ReorderFilter(W->Data<float>(), M, C, kernel_shape[0] * kernel_shape[1],
+                  static_cast<float*>(reordered_W_buffer.get()));
+  }
+
+  // Each row of the output is a pixel with its M channels, so the bias is added to every row and the
+  // activation applied as the GEMM writes it.
+  auto gemm = [&](const float* col_data, int64_t rows, float* y_data) {
+    if (packed_w_) {
+      MlasSgemmPacked(CblasNoTrans, static_cast<size_t>(rows), static_cast<size_t>(M), static_cast<size_t>(kernel_dim),
+                      1.0f, col_data, static_cast<size_t>(kernel_dim), packed_w_.get(), 0.0f, y_data,
+                      static_cast<size_t>(M), Bdata, &activation_, tp);
+    } else {
+      MlasSgemm(CblasNoTrans, CblasNoTrans, static_cast<size_t>(rows), static_cast<size_t>(M),
+                static_cast<size_t>(kernel_dim), 1.0f, col_data, static_cast<size_t>(kernel_dim),
+                static_cast<const float*>(reordered_W_buffer.get()), static_cast<size_t>(M), 0.0f, y_data,
+                static_cast<size_t>(M), Bdata, &activation_, tp);
+    }
+  };
+
+  if (ConvBase::IsPointwiseConv(kernel_shape, strides, pads)) {
+    // The input pixels already are the rows of C channels the GEMM needs, so the whole batch is a single GEMM.
+    gemm(Xdata, N * output_image_size, Ydata);
+    return Status::OK();
+  }
+
+  auto col_data = alloc->Alloc(sizeof(float) * output_image_size * kernel_dim);
+  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
+  auto* col_buffer_data = static_cast<float*>(col_buffer.get());
+
+  const int64_t X_offset = input_height * input_width * C;
+  const int64_t Y_offset = output_image_size * M;
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    math::Im2col<float, CPUMathUtil, StorageOrder::NHWC>(
+        Xdata + image_id * X_offset,
+        C,
+        input_height,
+        input_width,
+        kernel_shape[0],
+        kernel_shape[1],
+        dilations[0],
+        dilations[1],
+        pads[0],
+        pads[1],
+        pads[2],
+        pads[3],
+        strides[0],
+        strides[1],
+        col_buffer_data,
+        &CPUMathUtil::Instance());
+    gemm(col_buffer_data, output_image_size, Ydata + image_id * Y_offset);
+  }
+
+  return Status::OK();
+}
+
+Status NhwcPoolBase::NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  const auto* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "Input dimension must be 4, got ", X_shape.NumDimensions());
+
+  const int64_t N = X_shape[0];
+  const int64_t input_height = X_shape[1];
+  const int64_t input_width = X_shape[2];
+  const int64_t C = X_shape[3];
+
+  // The attributes compute the output size of the equivalent NCHW input.
+  std::vector<int64_t> pads = pool_attrs_.pads;
+  const TensorShape nchw_shape{N, C, input_height, input_width};
+  std::vector<int64_t> output_dims = pool_attrs_.SetOutputSize(nchw_shape, C, &pads);
+  const int64_t output_height = output_dims[2];
+  const int64_t output_width = output_dims[3];
+  auto* Y = context->Output(0, {N, output_height, output_width, C});
+
+  int64_t kernel_h = input_height;
+  int64_t kernel_w = input_width;
+  int64_t dilation_h = 1;
+  int64_t dilation_w = 1;
+  if (!pool_attrs_.global_pooling) {
+    kernel_h = pool_attrs_.kernel_shape[0];
+    kernel_w = pool_attrs_.kernel_shape[1];
+    dilation_h = pool_attrs_.dilations[0];
+    dilation_w = pool_attrs_.dilations[1];
+  } else {
+    pads.assign(4, 0);
+  }
+
+  const auto* X_data = X->Data<float>();
+  auto* Y_data = Y->MutableData<float>();
+
+  // Each output row, i.e. every pixel of an output image row, pools all the channels at once from the contiguous
+  // channels of each input pixel.
+  auto pool_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t image_id = row / output_height;
+      const int64_t ph = row % output_height;
+      const float* x_image = X_data + image_id * input_height * input_width * C;
+      float* y_row = Y_data + row * output_width * C;
+
+      const int64_t hstart = ph * stride_h() - pads[0];
+      for (int64_t pw = 0; pw < output_width; ++pw) {
+        const int64_t wstart = pw * stride_w() - pads[1];
+        auto y = EigenVectorArrayMap<float>(y_row + pw * C, C);
+        y.setConstant(kind == MlasMaximumPooling ? std::numeric_limits<float>::lowest() : 0.0f);
+
+        int64_t pool_size = 0;
+        for (int64_t kh = 0; kh < kernel_h; ++kh) {
+          const int64_t h = hstart + kh * dilation_h;
+          if (h < 0 || h >= input_height) {
+            continue;
+          }
+          for (int64_t kw = 0; kw < kernel_w; ++kw) {
+            const int64_t w = wstart + kw * dilation_w;
+            if (w < 0 || w >= input_width) {
+              continue;
+            }
+            auto x = ConstEigenVectorArrayMap<float>(x_image + (h * input_width + w) * C, C);
+            if (kind == MlasMaximumPooling) {
+              y = y.max(x);
+            } else {
+              y += x;
+            }
+            ++pool_size;
+          }
+        }
+
+        if (kind == MlasAveragePoolingIncludePad) {
+          y /= static_cast<float>(kernel_h * kernel_w);
+        } else if (kind == MlasAveragePoolingExcludePad && pool_size > 0) {
+          y /= static_cast<float>(pool_size);
+        }
+      }
+    }
+  };
+
+  const std::ptrdiff_t total_rows = static_cast<std::ptrdiff_t>(N * output_height);
+  if (tp == nullptr) {
+    pool_rows(0, total_rows);
+  } else {
+    const double cost = static_cast<double>(output_width * kernel_h * kernel_w * C);
+    tp->ParallelFor(total_rows, cost, pool_rows);
+  }
+
+  return Status::OK();
+}
+
+Status NhwcMaxPool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, MlasMaximumPooling);
+}
+
+Status NhwcAveragePool::Compute(OpKernelContext* context) const {
+  return NhwcPoolBase::NhwcPool(context, pool_attrs_.count_include_pad ? MlasAveragePoolingIncludePad :
+                                                                         MlasAveragePoolingExcludePad);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cpu/nn/pool.h"
+#include "contrib_ops/cpu/fused_activation.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Convolution of a [N, H, W, C] image producing a [N, H, W, M] output. The filter keeps the ONNX
+// [M, C, kernel_h, kernel_w] layout.
+class NhwcConv : public OpKernel, public ConvBase {
+ public:
+  NhwcConv(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MLAS_ACTIVATION activation_;
+
+  // the filter reordered to [kernel_h, kernel_w, C, M] and packed by MlasSgemmPackB, when it is a constant initializer
+  BufferUniquePtr packed_w_;
+};
+
+class NhwcPoolBase : public PoolBase {
+ public:
+  NhwcPoolBase(const OpKernelInfo& info) : PoolBase(info) {
+    if (!pool_attrs_.global_pooling)
+      ORT_ENFORCE(pool_attrs_.kernel_shape.size() == 2, "kernel_shape num_dims is not compatible with X num_dims.");
+  }
+
+  Status NhwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const;
+};
+
+class NhwcMaxPool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcMaxPool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+class NhwcAveragePool : public OpKernel, public NhwcPoolBase {
+ public:
+  NhwcAveragePool(const OpKernelInfo& info) : OpKernel(info), NhwcPoolBase(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
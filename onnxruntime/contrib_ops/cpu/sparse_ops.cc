@@ -0,0 +1,224 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/sparse_ops.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/sparse_tensor.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/gather.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    SparseToDenseMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetSparseTensorType<float>())
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    SparseToDenseMatMul);
+
+ONNX_OPERATOR_KERNEL_EX(
+    SparseGatherSum,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", DataTypeImpl::GetSparseTensorType<int64_t>()),
+    SparseGatherSum);
+
+namespace {
+
+// The non-zero values of a 2D sparse tensor grouped by row, as the CSR format does: the values of row r are
+// order[row_start[r]] to order[row_start[r + 1] - 1], which are positions in the values of the sparse tensor.
+struct SparseRows {
+  int64_t rows;
+  int64_t cols;
+  std::vector<int64_t> row_start;
+  std::vector<int64_t> order;
+  // the column of each value, in the order of the sparse tensor
+  std::vector<int64_t> col;
+};
+
+// Groups the values of the COO sparse tensor by row, or by column when transpose is set, with a counting sort
+// that keeps their order within a row.
+Status GroupByRow(const SparseTensor& sparse, bool transpose, SparseRows& rows) {
+  const auto& shape = sparse.Shape();
+  if (shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sparse input must be 2D, got shape ", shape);
+  }
+
+  const auto& indices_shape = sparse.Indices().Shape();
+  const auto nnz = static_cast<int64_t>(sparse.NumValues());
+  if (indices_shape.NumDimensions() != 2 || indices_shape[0] != nnz || indices_shape[1] != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sparse input indices must have shape [NNZ, 2], got ",
+                           indices_shape);
+  }
+
+  rows.rows = transpose ? shape[1] : shape[0];
+  rows.cols = transpose ? shape[0] : shape[1];
+  rows.row_start.assign(static_cast<size_t>(rows.rows + 1), 0);
+  rows.order.resize(static_cast<size_t>(nnz));
+  rows.col.resize(static_cast<size_t>(nnz));
+
+  const int64_t* indices = sparse.Indices().Data<int64_t>();
+  for (int64_t i = 0; i < nnz; ++i) {
+    const int64_t row = indices[2 * i + (transpose ? 1 : 0)];
+    const int64_t col = indices[2 * i + (transpose ? 0 : 1)];
+    if (row < 0 || row >= rows.rows || col < 0 || col >= rows.cols) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Sparse input index (", indices[2 * i], ", ",
+                             indices[2 * i + 1], ") out of the bounds of shape ", shape);
+    }
+    ++rows.row_start[row + 1];
+    rows.col[i] = col;
+  }
+
+  for (int64_t r = 0; r < rows.rows; ++r) {
+    rows.row_start[r + 1] += rows.row_start[r];
+  }
+
+  std::vector<int64_t> next(rows.row_start.begin(), rows.row_start.end() - 1);
+  for (int64_t i = 0; i < nnz; ++i) {
+    const int64_t row = indices[2 * i + (transpose ? 1 : 0)];
+    rows.order[next[row]++] = i;
+  }
+
+  return Status::OK();
+}
+
+void ForEachRow(concurrency::ThreadPool* tp, const SparseRows& rows, int64_t row_size,
+                const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  if (tp == nullptr) {
+    fn(0, static_cast<std::ptrdiff_t>(rows.rows));
+  } else {
+    // each row costs its share of the values, each of which reads and accumulates row_size elements
+    const double values_per_row = static_cast<double>(rows.order.size()) / std::max<int64_t>(rows.rows, 1);
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(rows.rows), (values_per_row + 1.0) * static_cast<double>(row_size),
+                    fn);
+  }
+}
+
+}  // namespace
+
+Status SparseToDenseMatMul::Compute(OpKernelContext* ctx) const {
+  const auto* a = ctx->Input<SparseTensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  SparseRows rows;
+  ORT_RETURN_IF_ERROR(GroupByRow(*a, trans_a_, rows));
+
+  const auto& b_shape = b->Shape();
+  if (b_shape.NumDimensions() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "B must be 2D, got shape ", b_shape);
+  }
+  const int64_t K = rows.cols;
+  const int64_t N = trans_b_ ? b_shape[0] : b_shape[1];
+  if ((trans_b_ ? b_shape[1] : b_shape[0]) != K) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "SparseToDenseMatMul dimension mismatch, A: ",
+                           a->Shape(), " B: ", b_shape);
+  }
+
+  Tensor* y = ctx->Output(0, TensorShape({rows.rows, N}));
+  const float* values = a->Values().Data<float>();
+  const float* b_data = b->Data<float>();
+  float* y_data = y->MutableData<float>();
+  const float alpha = alpha_;
+  const bool trans_b = trans_b_;
+
+  auto multiply_rows = [&rows, values, b_data, y_data, alpha, trans_b, K, N](std::ptrdiff_t first,
+                                                                            std::ptrdiff_t last) {
+    for (std::ptrdiff_t r = first; r < last; ++r) {
+      float* y_row = y_data + r * N;
+      std::fill_n(y_row, N, 0.f);
+      for (int64_t j = rows.row_start[r]; j < rows.row_start[r + 1]; ++j) {
+        const int64_t i = rows.order[j];
+        const float value = alpha * values[i];
+        if (trans_b) {
+          const float* b_col = b_data + rows.col[i];
+          for (int64_t n = 0; n < N; ++n) {
+            y_row[n] += value * b_col[n * K];
+          }
+        } else {
+          const float* b_row = b_data + rows.col[i] * N;
+          for (int64_t n = 0; n < N; ++n) {
+            y_row[n] += value * b_row[n];
+          }
+        }
+      }
+    }
+  };
+
+  ForEachRow(static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool(), rows, N, multiply_rows);
+  return Status::OK();
+}
+
+Status SparseGatherSum::Compute(OpKernelContext* ctx) const {
+  const auto* data_tensor = ctx->Input<Tensor>(0);
+  const auto* indices = ctx->Input<SparseTensor>(1);
+
+  const auto& data_shape = data_tensor->Shape();
+  if (data_shape.NumDimensions() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data must have a rank of at least 1");
+  }
+
+  SparseRows bags;
+  ORT_RETURN_IF_ERROR(GroupByRow(*indices, false, bags));
+
+  // check the ids first so that the threaded loop below can't fail
+  const int64_t row_count = data_shape[0];
+  const int64_t* ids = indices->Values().Data<int64_t>();
+  for (size_t i = 0; i < indices->NumValues(); ++i) {
+    if (ids[i] < 0 || ids[i] >= row_count) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=", ids[i],
+                             " data_dim=", row_count);
+    }
+  }
+
+  std::vector<int64_t> output_dims{bags.rows};
+  const auto& data_dims = data_shape.GetDims();
+  output_dims.insert(output_dims.end(), data_dims.begin() + 1, data_dims.end());
+  Tensor* output_tensor = ctx->Output(0, TensorShape(output_dims));
+
+  const int64_t row_size = data_shape.SizeFromDimension(1);
+  const float* data = data_tensor->Data<float>();
+  float* output = output_tensor->MutableData<float>();
+
+  auto sum_bags = [&bags, ids, data, output, row_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t bag = first; bag < last; ++bag) {
+      float* y = output + bag * row_size;
+      const int64_t begin = bags.row_start[bag];
+      const int64_t end = bags.row_start[bag + 1];
+      if (begin == end) {
+        std::fill_n(y, row_size, 0.f);
+        continue;
+      }
+
+      // the first row initializes the sum, so the output is written once per row of the bag
+      memcpy(y, data + ids[bags.order[begin]] * row_size, row_size * sizeof(float));
+      for (int64_t j = begin + 1; j < end; ++j) {
+        if (j + gather_detail::kPrefetchDistance < end) {
+          ORT_GATHER_PREFETCH(data + ids[bags.order[j + gather_detail::kPrefetchDistance]] * row_size);
+        }
+        const float* x = data + ids[bags.order[j]] * row_size;
+        for (int64_t k = 0; k < row_size; ++k) {
+          y[k] += x[k];
+        }
+      }
+    }
+  };
+
+  ForEachRow(static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool(), bags, row_size, sum_bags);
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Y = alpha * A' * B' of a sparse A and a dense B, with A' = transpose(A) if transA else A, and the same for B.
+// A is regrouped by rows, as CSR, and each row accumulates the rows of B selected by its non-zero values.
+class SparseToDenseMatMul final : public OpKernel {
+ public:
+  SparseToDenseMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    alpha_ = info.GetAttrOrDefault<float>("alpha", 1.0f);
+    trans_a_ = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float alpha_;
+  bool trans_a_;
+  bool trans_b_;
+};
+
+// GatherSum with sparse indices of shape [bags, bag_size]: the non-zero values of each row of the indices are the
+// ids of the rows of data summed into the bag, so bags of different sizes need no padding.
+class SparseGatherSum final : public OpKernel {
+ public:
+  SparseGatherSum(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
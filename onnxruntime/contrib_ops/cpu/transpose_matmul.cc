@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transpose_matmul.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <>
+Status TransposeMatMul<float>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* A = ctx->Input<Tensor>(0);
+  const auto* B = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(A->Shape(), B->Shape(), trans_a_, trans_b_));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const auto M = static_cast<size_t>(helper.M());
+  const auto N = static_cast<size_t>(helper.N());
+  const auto K = static_cast<size_t>(helper.K());
+
+  // The transposes are handled by the GEMM reading the matrices in column order, so only the leading
+  // dimensions differ from MatMul.
+  const size_t lda = trans_a_ ? M : K;
+  const size_t ldb = trans_b_ ? K : N;
+
+  const float* a_data = A->Data<float>();
+  const float* b_data = B->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  const size_t max_len = helper.OutputOffsets().size();
+
+  std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].C = y_data + helper.OutputOffsets()[i];
+  }
+
+  MlasSgemmBatch(trans_a_ ? CblasTrans : CblasNoTrans,
+                 trans_b_ ? CblasTrans : CblasNoTrans,
+                 M, N, K,
+                 alpha_,
+                 lda, ldb,
+                 0.0f,
+                 N,
+                 data.data(), max_len,
+                 thread_pool);
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    TransposeMatMul,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    TransposeMatMul<float>);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class TransposeMatMul final : public OpKernel {
+ public:
+  TransposeMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    trans_a_ = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+    alpha_ = info.GetAttrOrDefault<float>("alpha", 1.0f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool trans_a_;
+  bool trans_b_;
+  float alpha_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
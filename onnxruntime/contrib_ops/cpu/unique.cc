@@ -8,20 +8,327 @@
 #pragma warning(disable : 4996)
 #endif
 #include "unique.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/util/parallel_scan.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+// Approximate cost, in cycles, of looking up one element in a hash table.
+constexpr double kCostPerElement = 64.0;
+
+// Inputs up to this size are sorted rather than hashed, which needs no table to be allocated and cleared.
+constexpr size_t kSortMaxElements = 64;
+
+// Inputs from this size are split by hash over the threads of the pool when there is more than one.
+constexpr size_t kPartitionMinElements = 65536;
+
+// The finalizer of MurmurHash3, which spreads the bits of the key over the whole hash, so both the low bits used
+// for the slots of a table and the high bits used for the partitions of the input are well distributed.
+inline uint64_t MixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Hashing and ordering of the element types, consistent with the equality of the elements.
+template <typename T>
+struct UniqueKey {
+  static uint64_t Hash(T x) { return MixHash(static_cast<uint64_t>(x)); }
+  static bool Equal(T a, T b) { return a == b; }
+  static bool Less(T a, T b) { return a < b; }
+};
+
+// -0.0f equals 0.0f and so hashes the same, and a NaN equals nothing so each one is a unique element of its own.
+// NaNs are ordered after all the numbers, which keeps the ordering a strict weak ordering.
+template <>
+struct UniqueKey<float> {
+  static uint64_t Hash(float x) {
+    uint32_t bits = 0;
+    if (x != 0.0f) {
+      std::memcpy(&bits, &x, sizeof(bits));
+    }
+    return MixHash(bits);
+  }
+  static bool Equal(float a, float b) { return a == b; }
+  static bool Less(float a, float b) { return !std::isnan(a) && (std::isnan(b) || a < b); }
+};
+
+template <>
+struct UniqueKey<std::string> {
+  static uint64_t Hash(const std::string& x) { return MixHash(std::hash<std::string>()(x)); }
+  static bool Equal(const std::string& a, const std::string& b) { return a == b; }
+  static bool Less(const std::string& a, const std::string& b) { return a < b; }
+};
+
+// Open addressing hash table with linear probing over the unique elements in the order they are inserted. The
+// slots hold the hash next to the index of the element, so a probe only reads the element when the hashes match.
+template <typename T>
+class UniqueTable {
+ public:
+  // Returns the index of x in Elements(), adding it if it is new, and counts the occurrence.
+  int64_t Insert(const T& x, uint64_t hash) {
+    if ((elements_.size() + 1) * 2 > slots_.size()) {
+      Grow();
+    }
+
+    for (size_t slot = static_cast<size_t>(hash) & mask_;; slot = (slot + 1) & mask_) {
+      Slot& s = slots_[slot];
+      if (s.index < 0) {
+        s.hash = hash;
+        s.index = static_cast<int64_t>(elements_.size());
+        elements_.push_back(x);
+        counts_.push_back(1);
+        return s.index;
+      }
+      if (s.hash == hash && UniqueKey<T>::Equal(elements_[static_cast<size_t>(s.index)], x)) {
+        ++counts_[static_cast<size_t>(s.index)];
+        return s.index;
+      }
+    }
+  }
+
+  std::vector<T>& Elements() { return elements_; }
+  std::vector<int64_t>& Counts() { return counts_; }
+
+ private:
+  struct Slot {
+    uint64_t hash;
+    int64_t index;
+  };
+
+  // doubles the slots so that at most half of them are used
+  void Grow() {
+    std::vector<Slot> slots(std::max<size_t>(16, slots_.size() * 2), Slot{0, -1});
+    mask_ = slots.size() - 1;
+    for (const Slot& s : slots_) {
+      if (s.index >= 0) {
+        size_t slot = static_cast<size_t>(s.hash) & mask_;
+        while (slots[slot].index >= 0) {
+          slot = (slot + 1) & mask_;
+        }
+        slots[slot] = s;
+      }
+    }
+    slots_ = std::move(slots);
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_{0};
+  std::vector<T> elements_;
+  std::vector<int64_t> counts_;
+};
+
+// Finds the unique elements of a small input by stable sorting the indices of the elements, so that the first
+// index of each run of equal elements is its first occurrence, and then ordering the runs by first occurrence.
+template <typename T>
+void UniqueBySort(const T* input, size_t num_elements, int64_t* output_idx,
+                  std::vector<T>& unique_elements, std::vector<int64_t>& element_counts) {
+  std::vector<size_t> order(num_elements);
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [input](size_t a, size_t b) { return UniqueKey<T>::Less(input[a], input[b]); });
+
+  // the runs of equal elements as their positions in order
+  std::vector<size_t> run_begins;
+  for (size_t k = 0; k < num_elements; ++k) {
+    if (k == 0 || !UniqueKey<T>::Equal(input[order[k - 1]], input[order[k]])) {
+      run_begins.push_back(k);
+    }
+  }
+  const size_t run_count = run_begins.size();
+  run_begins.push_back(num_elements);
+
+  std::vector<size_t> runs(run_count);
+  std::iota(runs.begin(), runs.end(), size_t{0});
+  std::sort(runs.begin(), runs.end(),
+            [&order, &run_begins](size_t a, size_t b) { return order[run_begins[a]] < order[run_begins[b]]; });
+
+  unique_elements.reserve(run_count);
+  element_counts.reserve(run_count);
+  for (size_t run : runs) {
+    const int64_t index = static_cast<int64_t>(unique_elements.size());
+    unique_elements.push_back(input[order[run_begins[run]]]);
+    element_counts.push_back(static_cast<int64_t>(run_begins[run + 1] - run_begins[run]));
+    for (size_t k = run_begins[run]; k < run_begins[run + 1]; ++k) {
+      output_idx[order[k]] = index;
+    }
+  }
+}
+
+template <typename T>
+void UniqueByHash(const T* input, size_t num_elements, int64_t* output_idx,
+                  std::vector<T>& unique_elements, std::vector<int64_t>& element_counts) {
+  UniqueTable<T> table;
+  for (size_t i = 0; i < num_elements; ++i) {
+    output_idx[i] = table.Insert(input[i], UniqueKey<T>::Hash(input[i]));
+  }
+  unique_elements = std::move(table.Elements());
+  element_counts = std::move(table.Counts());
+}
+
+template <typename T>
+void WriteUniques(OpKernelContext* ctx, const std::vector<T>& unique_elements,
+                  const std::vector<int64_t>& element_counts) {
+  TensorShape output_shape({static_cast<int64_t>(unique_elements.size())});
+  Tensor* output_uniques = ctx->Output(0, output_shape);
+  Tensor* output_counts = ctx->Output(2, output_shape);
+  std::copy(unique_elements.cbegin(), unique_elements.cend(), output_uniques->template MutableData<T>());
+  std::copy(element_counts.cbegin(), element_counts.cend(), output_counts->template MutableData<int64_t>());
+}
+
+// Finds the unique elements of a large input in parallel. The elements are split by the high bits of their hash
+// into one partition per block of the input, so equal elements always land in the same partition, and each
+// partition finds its unique elements in its own table, visiting its elements in input order. A first occurrence
+// in a partition is then a first occurrence in the whole input, and a prefix sum over the input in order of first
+// occurrence gives the global index of every unique element.
+template <typename T>
+void UniqueByPartitionedHash(OpKernelContext* ctx, concurrency::ThreadPool* tp, const BlockPartition& partition,
+                             const T* input, size_t num_elements, int64_t* output_idx) {
+  struct PartitionUniques {
+    UniqueTable<T> table;
+    std::vector<size_t> first_indices;
+    std::vector<int64_t> global_indices;
+  };
+
+  const std::ptrdiff_t block_count = partition.BlockCount();
+  const size_t partition_count = static_cast<size_t>(block_count);
+  std::vector<PartitionUniques> partitions(partition_count);
+
+  // the partition of each element, and the number of elements of each block in each partition
+  std::vector<uint16_t> element_partitions(num_elements);
+  std::vector<size_t> block_offsets(partition_count * partition_count);
+  partition.ForEachBlock([&](std::ptrdiff_t block, std::ptrdiff_t first, std::ptrdiff_t last) {
+    size_t* counts = block_offsets.data() + block * partition_count;
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      const uint64_t hash = UniqueKey<T>::Hash(input[i]);
+      const auto p = static_cast<uint16_t>(((hash >> 32) * partition_count) >> 32);
+      element_partitions[i] = p;
+      ++counts[p];
+    }
+  });
+
+  // lay out the element indices of each partition contiguously, block after block so that they stay in order
+  std::vector<size_t> partition_begins(partition_count + 1);
+  size_t offset = 0;
+  for (size_t p = 0; p < partition_count; ++p) {
+    partition_begins[p] = offset;
+    for (size_t block = 0; block < partition_count; ++block) {
+      const size_t count = block_offsets[block * partition_count + p];
+      block_offsets[block * partition_count + p] = offset;
+      offset += count;
+    }
+  }
+  partition_begins[partition_count] = offset;
+
+  std::vector<size_t> partition_elements(num_elements);
+  partition.ForEachBlock([&](std::ptrdiff_t block, std::ptrdiff_t first, std::ptrdiff_t last) {
+    size_t* offsets = block_offsets.data() + block * partition_count;
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      partition_elements[offsets[element_partitions[i]]++] = static_cast<size_t>(i);
+    }
+  });
+
+  // until the global indices are known 'idx' holds the index in the unique elements of the partition
+  const double partition_cost = kCostPerElement * static_cast<double>(num_elements) / block_count;
+  tp->ParallelFor(block_count, partition_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t p = first; p < last; ++p) {
+      PartitionUniques& uniques = partitions[p];
+      for (size_t k = partition_begins[p]; k < partition_begins[p + 1]; ++k) {
+        const size_t i = partition_elements[k];
+        const int64_t index = uniques.table.Insert(input[i], UniqueKey<T>::Hash(input[i]));
+        if (static_cast<size_t>(index) == uniques.first_indices.size()) {
+          uniques.first_indices.push_back(i);
+        }
+        output_idx[i] = index;
+      }
+      uniques.global_indices.resize(uniques.first_indices.size());
+    }
+  });
+
+  auto is_first_occurrence = [&](std::ptrdiff_t i) {
+    const auto& first_indices = partitions[element_partitions[i]].first_indices;
+    return first_indices[static_cast<size_t>(output_idx[i])] == static_cast<size_t>(i);
+  };
+
+  ParallelPrefixScan<int64_t> scan(tp, static_cast<std::ptrdiff_t>(num_elements), kCostPerElement);
+  const int64_t unique_count = scan.Reduce([&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    int64_t count = 0;
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      count += is_first_occurrence(i) ? 1 : 0;
+    }
+    return count;
+  });
+
+  TensorShape output_shape({unique_count});
+  T* output_uniques_data = ctx->Output(0, output_shape)->template MutableData<T>();
+  int64_t* output_counts_data = ctx->Output(2, output_shape)->template MutableData<int64_t>();
+
+  scan.Scan([&](std::ptrdiff_t first, std::ptrdiff_t last, int64_t global_index) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      if (is_first_occurrence(i)) {
+        PartitionUniques& uniques = partitions[element_partitions[i]];
+        const auto index = static_cast<size_t>(output_idx[i]);
+        uniques.global_indices[index] = global_index;
+        output_uniques_data[global_index] = uniques.table.Elements()[index];
+        output_counts_data[global_index] = uniques.table.Counts()[index];
+        ++global_index;
+      }
+    }
+  });
+
+  partition.ForEachBlock([&](std::ptrdiff_t, std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      output_idx[i] = partitions[element_partitions[i]].global_indices[static_cast<size_t>(output_idx[i])];
+    }
+  });
+}
+
+}  // namespace
+
 ONNX_OPERATOR_KERNEL_EX(Unique,
                         kMSDomain,
                         1,
                         kCpuExecutionProvider,
-                        KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
-                        Unique<float>);
+                        KernelDefBuilder().TypeConstraint("T", std::vector<MLDataType>{
+                                                                   DataTypeImpl::GetTensorType<float>(),
+                                                                   DataTypeImpl::GetTensorType<int32_t>(),
+                                                                   DataTypeImpl::GetTensorType<int64_t>(),
+                                                                   DataTypeImpl::GetTensorType<std::string>()}),
+                        Unique);
 
-template <>
-Status Unique<float>::Compute(OpKernelContext* ctx) const {
+Status Unique::Compute(OpKernelContext* ctx) const {
+  const Tensor* input = ctx->Input<Tensor>(0);
+  const auto data_type = input->DataType();
+  if (data_type == DataTypeImpl::GetType<float>()) {
+    return ComputeImpl<float>(ctx);
+  }
+  if (data_type == DataTypeImpl::GetType<int32_t>()) {
+    return ComputeImpl<int32_t>(ctx);
+  }
+  if (data_type == DataTypeImpl::GetType<int64_t>()) {
+    return ComputeImpl<int64_t>(ctx);
+  }
+  if (data_type == DataTypeImpl::GetType<std::string>()) {
+    return ComputeImpl<std::string>(ctx);
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported input type for Unique: ", data_type);
+}
+
+template <typename T>
+Status Unique::ComputeImpl(OpKernelContext* ctx) const {
   const Tensor* input = ctx->Input<Tensor>(0);
 
   // validate input
@@ -29,59 +336,31 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input tensor to Unique op should be 1D");
 
   // obtain raw input data
-  const float* input_data = input->Data<float>();
+  const T* input_data = input->template Data<T>();
   size_t num_elements = static_cast<size_t>(input->Shape().Size());
 
   // 'idx' output has same output shape as input
   Tensor* output_idx = ctx->Output(1, input->Shape());
   int64_t* output_idx_data = output_idx->template MutableData<int64_t>();
 
-  // container to hold the unique elements (in the order it was first seen)
-  std::vector<float> unique_elements;
-  // number of unique elements is atmost number of elements in the raw data
-  unique_elements.reserve(num_elements);
-
-  // containers to store other metadata needed for other output tensors
-  std::unordered_map<float, size_t> mapped_indices;
-  std::unordered_map<float, size_t> element_counts;
-
-  // processing
-  for (size_t i = 0; i < num_elements; ++i) {
-    float temp = input_data[i];
-
-    const auto iter = mapped_indices.find(temp);
-    if (iter == mapped_indices.end()) {
-      // element is being seen for the first time
-      element_counts[temp] = 1;
-      output_idx_data[i] = mapped_indices[temp] = unique_elements.size();
-      unique_elements.push_back(temp);
-    } else {
-      // element has been seen before
-      output_idx_data[i] = iter->second;
-      ++element_counts[temp];
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp != nullptr && num_elements >= kPartitionMinElements) {
+    BlockPartition partition(tp, static_cast<std::ptrdiff_t>(num_elements), kCostPerElement);
+    if (partition.BlockCount() > 1) {
+      UniqueByPartitionedHash(ctx, tp, partition, input_data, num_elements, output_idx_data);
+      return Status::OK();
     }
   }
 
-  // 'uniques' output
-  TensorShape output_shape({static_cast<int64_t>(unique_elements.size())});
-  Tensor* output_uniques = ctx->Output(0, output_shape);
-  float* output_uniques_data = output_uniques->template MutableData<float>();
-
-  // 'counts' output
-  Tensor* output_counts = ctx->Output(2, output_shape);
-  int64_t* output_counts_data = output_counts->template MutableData<int64_t>();
-
-  size_t iter = 0;
-  for (const float& e : unique_elements) {
-    // 'uniques' data
-    output_uniques_data[iter] = e;
-
-    // 'counts' data
-    const auto iter_map = element_counts.find(e);
-    output_counts_data[iter] = static_cast<int64_t>(iter_map->second);
-
-    ++iter;
+  // container to hold the unique elements (in the order it was first seen) and their counts
+  std::vector<T> unique_elements;
+  std::vector<int64_t> element_counts;
+  if (num_elements <= kSortMaxElements) {
+    UniqueBySort(input_data, num_elements, output_idx_data, unique_elements, element_counts);
+  } else {
+    UniqueByHash(input_data, num_elements, output_idx_data, unique_elements, element_counts);
   }
+  WriteUniques(ctx, unique_elements, element_counts);
 
   return Status::OK();
 }
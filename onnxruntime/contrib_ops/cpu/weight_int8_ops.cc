@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/weight_int8_ops.h"
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tensor/gather.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulWeightInt8,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>()),
+    MatMulWeightInt8);
+
+ONNX_OPERATOR_KERNEL_EX(
+    GatherWeightInt8,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(), DataTypeImpl::GetTensorType<int64_t>()}),
+    GatherWeightInt8);
+
+Status MatMulWeightInt8::Compute(OpKernelContext* ctx) const {
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+  const auto* b_scale = ctx->Input<Tensor>(2);
+  const auto* bias = ctx->Input<Tensor>(3);
+
+  ORT_RETURN_IF_NOT(b->Shape().NumDimensions() == 2, "MatMulWeightInt8 : B must be a 2D tensor");
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  const auto n = static_cast<int64_t>(helper.N());
+  ORT_RETURN_IF_NOT(b_scale->Shape().NumDimensions() == 1 && b_scale->Shape()[0] == n,
+                    "MatMulWeightInt8 : b_scale must be a 1D tensor of N elements");
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().NumDimensions() == 1 && bias->Shape()[0] == n,
+                      "MatMulWeightInt8 : bias must be a 1D tensor of N elements");
+  }
+
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  const auto* a_data = a->template Data<float>();
+  const auto* b_data = b->template Data<int8_t>();
+  auto* y_data = y->template MutableData<float>();
+
+  // B is 2D, so every matrix of A is multiplied by the same B
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    MlasSgemmQuantizedB(CblasNoTrans,
+                        static_cast<size_t>(helper.M()),
+                        static_cast<size_t>(helper.N()),
+                        static_cast<size_t>(helper.K()),
+                        1.0f,
+                        a_data + helper.LeftOffsets()[i],
+                        static_cast<size_t>(helper.K()),
+                        b_data,
+                        static_cast<size_t>(helper.N()),
+                        b_scale->template Data<float>(),
+                        0.0f,
+                        y_data + helper.OutputOffsets()[i],
+                        static_cast<size_t>(helper.N()),
+                        bias != nullptr ? bias->template Data<float>() : nullptr,
+                        thread_pool);
+  }
+
+  return Status::OK();
+}
+
+template <typename Tind>
+static Status GatherRows(const int8_t* data, const float* scale, int64_t row_count, int64_t row_size,
+                         const Tind* indices, int64_t index_count, float* output, concurrency::ThreadPool* tp) {
+  // Check the indices first so that the threaded loop below can't fail.
+  for (int64_t i = 0; i < index_count; ++i) {
+    if (indices[i] < 0 || indices[i] >= row_count) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "indices element out of data bounds, idx=", indices[i],
+                             " data_dim=", row_count);
+    }
+  }
+
+  auto gather_rows = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      if (i + gather_detail::kPrefetchDistance < last) {
+        ORT_GATHER_PREFETCH(data + indices[i + gather_detail::kPrefetchDistance] * row_size);
+      }
+      const int8_t* x = data + indices[i] * row_size;
+      const float row_scale = scale[indices[i]];
+      float* y = output + i * row_size;
+      for (int64_t k = 0; k < row_size; ++k) {
+        y[k] = static_cast<float>(x[k]) * row_scale;
+      }
+    }
+  };
+
+  if (tp == nullptr) {
+    gather_rows(0, static_cast<std::ptrdiff_t>(index_count));
+  } else {
+    // as for Gather, each row costs a cache miss plus the work over its elements
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(index_count), 64.0 + static_cast<double>(row_size), gather_rows);
+  }
+
+  return Status::OK();
+}
+
+Status GatherWeightInt8::Compute(OpKernelContext* context) const {
+  const auto* data_tensor = context->Input<Tensor>(0);
+  const auto* scale_tensor = context->Input<Tensor>(1);
+  const auto* indices_tensor = context->Input<Tensor>(2);
+  const TensorShape& data_shape = data_tensor->Shape();
+  const TensorShape& indices_shape = indices_tensor->Shape();
+
+  if (data_shape.NumDimensions() < 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "data must have a rank of at least 1");
+  }
+  const int64_t row_count = data_shape[0];
+  if (scale_tensor->Shape().NumDimensions() != 1 || scale_tensor->Shape()[0] != row_count) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "scale must be a 1D tensor with an element per row of data");
+  }
+
+  // the indices are replaced by the dimensions of a row of data, as Gather along axis 0 does
+  const auto& data_dims = data_shape.GetDims();
+  std::vector<int64_t> output_dims(indices_shape.GetDims());
+  output_dims.insert(output_dims.end(), data_dims.begin() + 1, data_dims.end());
+  Tensor* output_tensor = context->Output(0, TensorShape(output_dims));
+
+  const int64_t row_size = data_shape.SizeFromDimension(1);
+  const int64_t index_count = indices_shape.Size();
+  const int8_t* data = data_tensor->template Data<int8_t>();
+  const float* scale = scale_tensor->template Data<float>();
+  float* output = output_tensor->template MutableData<float>();
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
+  if (indices_tensor->DataType() == DataTypeImpl::GetType<int32_t>()) {
+    return GatherRows(data, scale, row_count, row_size, indices_tensor->template Data<int32_t>(), index_count,
+                      output, tp);
+  }
+  if (indices_tensor->DataType() == DataTypeImpl::GetType<int64_t>()) {
+    return GatherRows(data, scale, row_count, row_size, indices_tensor->template Data<int64_t>(), index_count,
+                      output, tp);
+  }
+
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in GatherWeightInt8.");
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
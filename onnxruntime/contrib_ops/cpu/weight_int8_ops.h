@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// MatMul of a float A and a 2D B of int8 weights with a scale per column, optionally followed by the Add of a bias.
+// The panels of B are dequantized as the SGEMM packs them, so the float B is never materialized.
+class MatMulWeightInt8 final : public OpKernel {
+ public:
+  MatMulWeightInt8(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+// Gather along axis 0 of an embedding table of int8 rows with a scale per row. Only the gathered rows are
+// dequantized.
+class GatherWeightInt8 final : public OpKernel {
+ public:
+  GatherWeightInt8(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
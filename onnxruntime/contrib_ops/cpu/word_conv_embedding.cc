@@ -3,118 +3,108 @@
 
 #include "word_conv_embedding.h"
 
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include <algorithm>
 #include "core/mlas/inc/mlas.h"
 #include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace contrib {
 
-void WordConvEmbedding::CharEmbeddingLookup(
+// Each window of filter_width chars of a word is a row of the conv GEMM. A word shorter than the filter has a single
+// window, which includes the chars that follow it, and an empty word has none.
+static int64_t NumberOfWindows(int word_length, int64_t filter_width) {
+  return word_length > 0 ? std::max<int64_t>(word_length, filter_width) - filter_width + 1 : 0;
+}
+
+// Looks up the char embeddings of the windows of the words [first_word, last_word), so that each window is a row of
+// filter_width * char_embedding_size values starting at its offset in dst.
+void WordConvEmbedding::UnfoldCharEmbeddings(
     const int* seq_ptr,
     const float* char_embedding_weight_p,
-    size_t seq_len,
-    size_t word_len,
-    size_t char_embedding_size,
-    size_t filter_width,
-    const int* words_len_ptr,
+    const int64_t* window_offsets,
+    int64_t first_word,
+    int64_t last_word,
+    int64_t word_len,
+    int64_t char_embedding_size,
+    int64_t filter_width,
     float* dst) const {
-  for (size_t word_inx = 0; word_inx < seq_len; word_inx++) {
-    if (words_len_ptr[word_inx] > 0) {
-      const int* cur_seq_ptr = seq_ptr + word_inx * word_len;
-      float* cur_dst_ptr = dst + word_inx * word_len * char_embedding_size;
-      size_t char_length_to_lookup = std::max<size_t>(words_len_ptr[word_inx], filter_width);
-      for (size_t char_inx = 0; char_inx < char_length_to_lookup; char_inx++) {
-        memcpy(cur_dst_ptr, char_embedding_weight_p + (*cur_seq_ptr) * char_embedding_size, sizeof(float) * char_embedding_size);
+  const size_t memcpy_size = char_embedding_size * sizeof(float);
+  float* cur_dst_ptr = dst + window_offsets[first_word] * filter_width * char_embedding_size;
+  for (int64_t word_inx = first_word; word_inx < last_word; word_inx++) {
+    const int* cur_seq_ptr = seq_ptr + word_inx * word_len;
+    for (int64_t window_inx = 0; window_inx < window_offsets[word_inx + 1] - window_offsets[word_inx]; window_inx++) {
+      for (int64_t char_inx = 0; char_inx < filter_width; char_inx++) {
+        memcpy(cur_dst_ptr, char_embedding_weight_p + cur_seq_ptr[window_inx + char_inx] * char_embedding_size,
+               memcpy_size);
         cur_dst_ptr += char_embedding_size;
-        cur_seq_ptr++;
       }
     }
   }
 }
 
-//input : [sequence_length, word_length, char_embedding_size]
+// Convolves the windows of the words [first_word, last_word) with one GEMM, whose epilogue adds the bias and applies
+// tanh, then max pools the windows of each word. weights is packed by MlasSgemmPackB when packed_w_conv_ is set.
 void WordConvEmbedding::ComputeConvMaxPoolWithActivation(
-    AllocatorPtr allocator,
     const float* input,
     const float* weights,
     const float* bias,
-    const int* words_len_ptr,
-    int64_t seq_len,
-    int64_t word_len,
+    const int64_t* window_offsets,
+    int64_t first_word,
+    int64_t last_word,
     int64_t char_embedding_size,
     int64_t filter_width,
     int64_t num_filters,
+    float* conv_buffer,
     float* output, concurrency::ThreadPool* tp) const {
-  int64_t input_word_size = word_len * char_embedding_size;
-  int64_t unfolded_width = word_len - filter_width + 1;
-  int64_t unfolded_kernal_size = filter_width * char_embedding_size;
-  int64_t unfolded_segment_size = unfolded_width * unfolded_kernal_size;
-  int64_t conv_res_segment_size = unfolded_width * num_filters;
-  int64_t memcpy_size = unfolded_kernal_size * sizeof(float);
-
-  auto unfolded_buffer_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * unfolded_segment_size);
-  auto conv_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-  auto conv_activation_result_p = IAllocator::MakeUniquePtr<float>(allocator, seq_len * conv_res_segment_size);
-
-  int64_t word_inx = 0;
-  while (word_inx < seq_len) {
-    if (words_len_ptr[word_inx] <= 0) {
-      word_inx++;
-      continue;
+  const int64_t unfolded_kernal_size = filter_width * char_embedding_size;
+  const int64_t first_window = window_offsets[first_word];
+  const int64_t num_windows = window_offsets[last_word] - first_window;
+  float* conv_buf_p = conv_buffer + first_window * num_filters;
+
+  if (num_windows > 0) {
+    MLAS_ACTIVATION activation;
+    activation.ActivationKind = MlasTanhActivation;
+    const float* unfolded_p = input + first_window * unfolded_kernal_size;
+    if (packed_w_conv_ != nullptr) {
+      MlasSgemmPacked(CblasNoTrans,
+                      static_cast<size_t>(num_windows), static_cast<size_t>(num_filters),
+                      static_cast<size_t>(unfolded_kernal_size), 1.0f,
+                      unfolded_p, static_cast<size_t>(unfolded_kernal_size),
+                      packed_w_conv_, 0.0f,
+                      conv_buf_p, static_cast<size_t>(num_filters),
+                      bias, &activation, tp);
+    } else {
+      MlasSgemm(CblasNoTrans, CblasTrans,
+                static_cast<size_t>(num_windows), static_cast<size_t>(num_filters),
+                static_cast<size_t>(unfolded_kernal_size), 1.0f,
+                unfolded_p, static_cast<size_t>(unfolded_kernal_size),
+                weights, static_cast<size_t>(unfolded_kernal_size), 0.0f,
+                conv_buf_p, static_cast<size_t>(num_filters),
+                bias, &activation, tp);
     }
+  }
 
-    float* words_unfolded_buffer_p = unfolded_buffer_p.get();
-    int64_t words_unfolded_width = 0;
-    int64_t tmp_word_inx = word_inx;
-    float* conv_buf_p = conv_result_p.get();
-    float* pactivationbuf = conv_activation_result_p.get();
-
-    // unfolding buffer
-    while (tmp_word_inx < seq_len && words_len_ptr[tmp_word_inx] > 0) {
-      const float* current_word_input = input + tmp_word_inx * input_word_size;
-      int64_t word_unfolded_width = std::max<int64_t>(words_len_ptr[tmp_word_inx], filter_width) - filter_width + 1;
-      words_unfolded_width += word_unfolded_width;
-      for (int64_t unfolded_inx = 0; unfolded_inx < word_unfolded_width; unfolded_inx++) {
-        memcpy(words_unfolded_buffer_p, current_word_input, memcpy_size);
-        current_word_input += char_embedding_size;
-        words_unfolded_buffer_p += unfolded_kernal_size;
-      }
-      tmp_word_inx++;
+  // an empty word has no windows and its output is zeros
+  const float* activationbuf_cur_ptr = conv_buf_p;
+  for (int64_t word_inx = first_word; word_inx < last_word; word_inx++) {
+    float* result_ptr = output + word_inx * num_filters;
+    const int64_t word_unfolded_width = window_offsets[word_inx + 1] - window_offsets[word_inx];
+    if (word_unfolded_width == 0) {
+      std::fill_n(result_ptr, num_filters, 0.0f);
+      continue;
     }
 
-    math::GemmEx<float>(
-        CblasNoTrans, CblasTrans,
-        static_cast<int>(words_unfolded_width), static_cast<int>(num_filters), static_cast<int>(unfolded_kernal_size), 1.0f,
-        unfolded_buffer_p.get(), static_cast<int>(unfolded_kernal_size),
-        weights, static_cast<int>(unfolded_kernal_size), 0.0f,
-        conv_buf_p, static_cast<int>(num_filters), tp);
-
-    for (int64_t unfolded_inx = 0; unfolded_inx < words_unfolded_width; unfolded_inx++)
-      for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        conv_buf_p[unfolded_inx * num_filters + filter_inx] += bias[filter_inx];
-      }
-    MlasComputeTanh(conv_buf_p, pactivationbuf, words_unfolded_width * num_filters);
-
-    float* activationbuf_cur_ptr = pactivationbuf;
-    for (int64_t pool_word_inx = word_inx; pool_word_inx < tmp_word_inx; pool_word_inx++) {
-      float* result_ptr = output + pool_word_inx * num_filters;
+    std::copy_n(activationbuf_cur_ptr, num_filters, result_ptr);
+    activationbuf_cur_ptr += num_filters;
+    for (int64_t unfolded_inx = 1; unfolded_inx < word_unfolded_width; unfolded_inx++) {
       for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-        result_ptr[filter_inx] = -1.0f * 1e12f;
-      }
-
-      int64_t word_unfolded_width = std::max<int64_t>(words_len_ptr[pool_word_inx], filter_width) - filter_width + 1;
-      for (int64_t unfolded_inx = 0; unfolded_inx < word_unfolded_width; unfolded_inx++) {
-        for (int64_t filter_inx = 0; filter_inx < num_filters; filter_inx++) {
-          result_ptr[filter_inx] = std::max(activationbuf_cur_ptr[filter_inx], result_ptr[filter_inx]);
-        }
-        activationbuf_cur_ptr += num_filters;
+        result_ptr[filter_inx] = std::max(activationbuf_cur_ptr[filter_inx], result_ptr[filter_inx]);
       }
+      activationbuf_cur_ptr += num_filters;
     }
-    word_inx = tmp_word_inx;
   }
 }
+
 void WordConvEmbedding::CalculateLengthOfEachWordInSequence(
     const int* seq_ptr,
     int* words_len_ptr,
@@ -160,18 +150,39 @@ Status WordConvEmbedding::ValidateInputShape(const TensorShape& w_conv_shape, co
   return Status::OK();
 }
 
+Status WordConvEmbedding::PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer,
+                                  bool& is_packed) {
+  is_packed = false;
+
+  // A constant conv weight [M, 1, kH, kW] is the transposed B of the GEMM of each Compute, so it is packed once here.
+  if (input_idx == 1 && tensor.Shape().NumDimensions() == 4 && tensor.Shape().Size() > 0) {
+    w_conv_shape_ = tensor.Shape();
+    const auto N = static_cast<size_t>(w_conv_shape_[0]);
+    const auto K = static_cast<size_t>(w_conv_shape_[2] * w_conv_shape_[3]);
+
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    packed_buffer = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+    MlasSgemmPackB(CblasTrans, N, K, tensor.Data<float>(), K, packed_buffer.get());
+    packed_w_conv_ = packed_buffer.get();
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
 Status WordConvEmbedding::Compute(OpKernelContext* ctx) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
   concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
   // original lstm processing
-  const Tensor& sequence = *(ctx->Input<Tensor>(0));          // sequence: [sequence_length, word_length]
-  const Tensor& w_conv = *(ctx->Input<Tensor>(1));            // conv weight: [M, C/group, kH, kW]
+  const Tensor& sequence = *(ctx->Input<Tensor>(0));  // sequence: [sequence_length, word_length]
+  // conv weight: [M, C/group, kH, kW]. the session may have released a packed weight
+  const Tensor* w_conv = packed_w_conv_ != nullptr ? nullptr : ctx->Input<Tensor>(1);
   const Tensor& b_conv = *(ctx->Input<Tensor>(2));            // conv bias: [M]
   const Tensor& w_char_embedding = *(ctx->Input<Tensor>(3));  // conv weights. [index, char_embedding_size]
 
   const TensorShape& sequence_shape = sequence.Shape();
-  const TensorShape& w_conv_shape = w_conv.Shape();
+  const TensorShape& w_conv_shape = w_conv != nullptr ? w_conv->Shape() : w_conv_shape_;
   const TensorShape& w_char_embedding_shape = w_char_embedding.Shape();
 
   ORT_RETURN_IF_ERROR(ValidateInputShape(w_conv_shape, w_char_embedding_shape));
@@ -184,43 +195,54 @@ Status WordConvEmbedding::Compute(OpKernelContext* ctx) const {
 
   TensorShape Y_dims{seq_len, filter_size};
   Tensor* Y = ctx->Output(/*index*/ 0, Y_dims);
+  if (seq_len == 0 || filter_size == 0) {
+    return Status::OK();
+  }
+  if (filter_width > word_len) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Conv kernal size 1 is larger than the word length.",
+                           " Conv kernal size 1: ", filter_width, " word length: ", word_len);
+  }
 
   const int* seq_ptr = sequence.Data<int>();
 
+  // The windows of all the words are the rows of one GEMM, at the offsets of the words.
+  std::vector<int> words_length(seq_len);
+  CalculateLengthOfEachWordInSequence(seq_ptr, words_length.data(), seq_len, word_len);
+  std::vector<int64_t> window_offsets(seq_len + 1, 0);
+  for (int64_t word_inx = 0; word_inx < seq_len; word_inx++) {
+    window_offsets[word_inx + 1] = window_offsets[word_inx] + NumberOfWindows(words_length[word_inx], filter_width);
+  }
+  const int64_t num_windows = window_offsets[seq_len];
+
+  // The scratch buffers come from the temp space allocator, which reuses them across calls, rather than from the
+  // kernel, so that concurrent Runs don't share them.
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-
-  // allocate memory for char look up
-  // seq_len * word_len * char_embedding_size
-  size_t chars_embeddings_size = seq_len * word_len * char_embedding_size;
-  auto chars_embeddings_ptr = IAllocator::MakeUniquePtr<float>(alloc, chars_embeddings_size);
-  auto words_length_ptr = IAllocator::MakeUniquePtr<int>(alloc, seq_len);
-  std::memset(chars_embeddings_ptr.get(), 0, chars_embeddings_size * sizeof(float));
-  std::memset(words_length_ptr.get(), 0, seq_len * sizeof(int));
-
-  CalculateLengthOfEachWordInSequence(seq_ptr, words_length_ptr.get(), seq_len, word_len);
-
-  CharEmbeddingLookup(seq_ptr,
-                      w_char_embedding.Data<float>(),
-                      seq_len,
-                      word_len,
-                      char_embedding_size,
-                      filter_width,
-                      words_length_ptr.get(),
-                      chars_embeddings_ptr.get());
-
-  ComputeConvMaxPoolWithActivation(
-      alloc,
-      chars_embeddings_ptr.get(),
-      w_conv.Data<float>(),
-      b_conv.Data<float>(),
-      words_length_ptr.get(),
-      seq_len,
-      word_len,
-      char_embedding_size,
-      filter_width,
-      filter_size,
-      Y->MutableData<float>(), tp);
+  const int64_t unfolded_kernal_size = filter_width * char_embedding_size;
+  auto unfolded_buffer_p = IAllocator::MakeUniquePtr<float>(alloc, std::max<int64_t>(num_windows, 1) * unfolded_kernal_size);
+  auto conv_result_p = IAllocator::MakeUniquePtr<float>(alloc, std::max<int64_t>(num_windows, 1) * filter_size);
+
+  const float* w_conv_p = w_conv != nullptr ? w_conv->Data<float>() : nullptr;
+  float* Y_p = Y->MutableData<float>();
+  auto compute_words = [&](std::ptrdiff_t first_word, std::ptrdiff_t last_word, concurrency::ThreadPool* gemm_tp) {
+    UnfoldCharEmbeddings(seq_ptr, w_char_embedding.Data<float>(), window_offsets.data(), first_word, last_word,
+                         word_len, char_embedding_size, filter_width, unfolded_buffer_p.get());
+    ComputeConvMaxPoolWithActivation(unfolded_buffer_p.get(), w_conv_p, b_conv.Data<float>(), window_offsets.data(),
+                                     first_word, last_word, char_embedding_size, filter_width, filter_size,
+                                     conv_result_p.get(), Y_p, gemm_tp);
+  };
+
+  // Blocks of words run on the threads of the pool, each with a GEMM on a single thread. When the sequence is too
+  // short to split, its GEMM is spread across the pool instead.
+  const double cost_per_word = static_cast<double>(num_windows) / seq_len * unfolded_kernal_size * filter_size;
+  const std::ptrdiff_t block_count = tp == nullptr ? 1 : tp->ComputeBlockCount(seq_len, cost_per_word);
+  if (block_count <= 1) {
+    compute_words(0, seq_len, tp);
+  } else {
+    tp->ParallelFor(seq_len, cost_per_word, [&](std::ptrdiff_t first_word, std::ptrdiff_t last_word) {
+      compute_words(first_word, last_word, nullptr);
+    });
+  }
 
   return Status::OK();
 }
@@ -18,29 +18,32 @@ class WordConvEmbedding final : public OpKernel {
   explicit WordConvEmbedding(const OpKernelInfo& info) : OpKernel(info) {
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer, bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  void CharEmbeddingLookup(
+  void UnfoldCharEmbeddings(
       const int* seq_ptr,
       const float* char_embedding_weight_p,
-      size_t seq_len,
-      size_t word_len,
-      size_t char_embedding_size,
-      size_t filter_width,
-      const int* words_len_ptr,
+      const int64_t* window_offsets,
+      int64_t first_word,
+      int64_t last_word,
+      int64_t word_len,
+      int64_t char_embedding_size,
+      int64_t filter_width,
       float* dst) const;
   void ComputeConvMaxPoolWithActivation(
-      AllocatorPtr allocator,
       const float* input,
       const float* weights,
       const float* bias,
-      const int* words_len_ptr,
-      int64_t seq_len,
-      int64_t word_len,
+      const int64_t* window_offsets,
+      int64_t first_word,
+      int64_t last_word,
       int64_t char_embedding_size,
       int64_t filter_width,
       int64_t num_filters,
+      float* conv_buffer,
       float* output, onnxruntime::concurrency::ThreadPool* tp) const;
   void CalculateLengthOfEachWordInSequence(
       const int* seq_ptr,
@@ -56,6 +59,10 @@ class WordConvEmbedding final : public OpKernel {
   int64_t embedding_size_{Info().GetAttrOrDefault<int64_t>("embedding_size", -1)};
   int64_t conv_window_size_{Info().GetAttrOrDefault<int64_t>("conv_window_size", -1)};
   int64_t char_embedding_size_{Info().GetAttrOrDefault<int64_t>("char_embedding_size", -1)};
+
+  // the conv weight packed by MlasSgemmPackB when it is a constant initializer, and its shape
+  const void* packed_w_conv_ = nullptr;
+  TensorShape w_conv_shape_;
 };
 
 }  // namespace contrib
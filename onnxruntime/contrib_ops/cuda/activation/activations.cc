@@ -10,10 +10,13 @@ namespace onnxruntime {
 namespace contrib {
 namespace cuda {
 
-#define REGISTER_ACTIVATION_KERNEL(x, ver, T)                    \
+#define REGISTER_ACTIVATION_KERNEL(x, ver, T) \
+  REGISTER_ACTIVATION_KERNEL_EX(x, kOnnxDomain, ver, T)
+
+#define REGISTER_ACTIVATION_KERNEL_EX(x, domain, ver, T)         \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                 \
       x,                                                         \
-      kOnnxDomain,                                               \
+      domain,                                                    \
       ver,                                                       \
       T,                                                         \
       kCudaExecutionProvider,                                    \
@@ -37,18 +40,23 @@ namespace cuda {
     return Status::OK();                                                                                   \
   }
 
-#define UNARY_ACTIVATION_OP_TYPED(name, ver, T) \
-  REGISTER_ACTIVATION_KERNEL(name, ver, T)      \
+#define UNARY_ACTIVATION_OP_TYPED(name, domain, ver, T) \
+  REGISTER_ACTIVATION_KERNEL_EX(name, domain, ver, T)   \
   UNARY_ACTIVATION_COMPUTE(name, T)
 
-#define UNARY_ACTIVATION_OP_HFD(name, ver)        \
-  UNARY_ACTIVATION_OP_TYPED(name, ver, MLFloat16) \
-  UNARY_ACTIVATION_OP_TYPED(name, ver, float)     \
-  UNARY_ACTIVATION_OP_TYPED(name, ver, double)
+#define UNARY_ACTIVATION_OP_HFD_EX(name, domain, ver)       \
+  UNARY_ACTIVATION_OP_TYPED(name, domain, ver, MLFloat16) \
+  UNARY_ACTIVATION_OP_TYPED(name, domain, ver, float)     \
+  UNARY_ACTIVATION_OP_TYPED(name, domain, ver, double)
+
+#define UNARY_ACTIVATION_OP_HFD(name, ver) \
+  UNARY_ACTIVATION_OP_HFD_EX(name, kOnnxDomain, ver)
 
 UNARY_ACTIVATION_OP_HFD(Affine, 1);
 UNARY_ACTIVATION_OP_HFD(ParametricSoftplus, 1);
 UNARY_ACTIVATION_OP_HFD(ScaledTanh, 1);
+UNARY_ACTIVATION_OP_HFD_EX(Gelu, kMSDomain, 1);
+UNARY_ACTIVATION_OP_HFD_EX(FastGelu, kMSDomain, 1);
 
 
 REGISTER_ACTIVATION_KERNEL(ThresholdedRelu, 1, MLFloat16)
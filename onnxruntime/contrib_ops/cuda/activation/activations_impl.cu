@@ -36,6 +36,22 @@ struct OP_ScaledTanh : public CtxScaledTanh {
   }
 };
 
+template <typename T>
+struct OP_Gelu : public CtxGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    // 1 / sqrt(2)
+    return (T)0.5f * a * ((T)1 + _Erf(a * (T)0.7071067811865476f));
+  }
+};
+
+template <typename T>
+struct OP_FastGelu : public CtxFastGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    // sqrt(2 / pi)
+    return (T)0.5f * a * ((T)1 + _Tanh((T)0.7978845608028654f * a * ((T)1 + (T)0.044715f * a * a)));
+  }
+};
+
 #define UNARY_ACTIVATION_IMPL(name)                                        \
   UNARY_ACTIVATION_IMPL_DECLARATION(name) {                                \
     UnaryElementWiseImpl(input_data,                                       \
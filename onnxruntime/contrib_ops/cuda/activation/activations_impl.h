@@ -11,11 +11,15 @@ namespace cuda {
 typedef onnxruntime::cuda::CtxAlphaBeta CtxAffine;
 typedef onnxruntime::cuda::CtxAlphaBeta CtxParametricSoftplus;
 typedef onnxruntime::cuda::CtxAlphaBeta CtxScaledTanh;
+typedef onnxruntime::cuda::CtxNull CtxGelu;
+typedef onnxruntime::cuda::CtxNull CtxFastGelu;
 
-#define UNARY_CONTRIB_ACTIVATION_OPS() \
-  UNARY_ACTIVATION_OP_NAME(ScaledTanh) \
-  UNARY_ACTIVATION_OP_NAME(Affine)     \
-  UNARY_ACTIVATION_OP_NAME(ParametricSoftplus)
+#define UNARY_CONTRIB_ACTIVATION_OPS()         \
+  UNARY_ACTIVATION_OP_NAME(ScaledTanh)         \
+  UNARY_ACTIVATION_OP_NAME(Affine)             \
+  UNARY_ACTIVATION_OP_NAME(ParametricSoftplus) \
+  UNARY_ACTIVATION_OP_NAME(Gelu)               \
+  UNARY_ACTIVATION_OP_NAME(FastGelu)
 
 #define UNARY_ACTIVATION_IMPL_DECLARATION(name) \
   template <typename T>                         \
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention.h"
+#include "attention_impl.h"
+
+#include "core/providers/cuda/shared_inc/fpgeneric.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Attention,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Attention<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+Status Attention<T>::ComputeInternal(OpKernelContext* context) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask = context->Input<Tensor>(3);
+  ORT_RETURN_IF_ERROR(CheckInputs(input, weights, bias, mask));
+
+  const auto& dims = input->Shape().GetDims();
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  const int head_size = hidden_size / num_heads_;
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  cublasHandle_t cublas = CublasHandle();
+  const CudaT one = ToCudaType<T>::FromFloat(1.0f);
+  const CudaT zero = ToCudaType<T>::FromFloat(0.0f);
+
+  // Compute Q, K and V of every head with one GEMM. cuBLAS is column major, so this is
+  // qkv(3 * H, B * S) = bias(3 * H, 1) x ones(1, B * S) followed by qkv += weights(3 * H, H) x input(H, B * S).
+  const int m = batch_size * sequence_length;
+  const int n = 3 * hidden_size;
+  auto qkv_buffer = GetScratchBuffer<CudaT>(static_cast<size_t>(m) * n);
+  CudaT* qkv = qkv_buffer.get();
+
+  CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+      cublas, CUBLAS_OP_N, CUBLAS_OP_N, n, m, 1, &one,
+      reinterpret_cast<const CudaT*>(bias->template Data<T>()), n,
+      GetConstOnes<CudaT>(m), 1,
+      &zero, qkv, n));
+  CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+      cublas, CUBLAS_OP_N, CUBLAS_OP_N, n, m, hidden_size, &one,
+      reinterpret_cast<const CudaT*>(weights->template Data<T>()), n,
+      reinterpret_cast<const CudaT*>(input->template Data<T>()), hidden_size,
+      &one, qkv, n));
+
+  // The heads of one batch are head_size apart within each row of qkv, so each batch is one strided batched
+  // GEMM over its heads. In column major terms, scores'(S, S) = K(head_size, S)' x Q(head_size, S).
+  const int64_t scores_stride = static_cast<int64_t>(sequence_length) * sequence_length;
+  auto scores_buffer = GetScratchBuffer<CudaT>(static_cast<size_t>(batch_size) * num_heads_ * scores_stride);
+  CudaT* scores = scores_buffer.get();
+  const CudaT alpha = ToCudaType<T>::FromFloat(1.0f / sqrtf(static_cast<float>(head_size)));
+
+  for (int b = 0; b < batch_size; ++b) {
+    const CudaT* q = qkv + static_cast<int64_t>(b) * sequence_length * n;
+    const CudaT* k = q + hidden_size;
+    CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+        cublas, CUBLAS_OP_T, CUBLAS_OP_N, sequence_length, sequence_length, head_size, &alpha,
+        k, n, head_size,
+        q, n, head_size,
+        &zero, scores + b * num_heads_ * scores_stride, sequence_length, scores_stride, num_heads_));
+  }
+
+  MaskedSoftmaxImpl<CudaT>(scores,
+                           mask == nullptr ? nullptr : reinterpret_cast<const CudaT*>(mask->template Data<T>()),
+                           batch_size, num_heads_, sequence_length);
+
+  // output(head_size, S) = V(head_size, S) x probs'(S, S) for each head, written straight to the head's
+  // columns of the (B, S, H) output.
+  CudaT* output_data = reinterpret_cast<CudaT*>(output->template MutableData<T>());
+  for (int b = 0; b < batch_size; ++b) {
+    const CudaT* v = qkv + static_cast<int64_t>(b) * sequence_length * n + 2 * hidden_size;
+    CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+        cublas, CUBLAS_OP_N, CUBLAS_OP_N, head_size, sequence_length, sequence_length, &one,
+        v, n, head_size,
+        scores + b * num_heads_ * scores_stride, sequence_length, scores_stride,
+        &zero, output_data + static_cast<int64_t>(b) * sequence_length * hidden_size, hidden_size, head_size,
+        num_heads_));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <math_constants.h>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cuda/math/softmax_impl.h"
+#include "attention_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The rows of scores that fit in the registers of a warp are computed by SoftmaxWarpForwardImpl. Otherwise one
+// block handles one row of scores. The reductions are done in float for half inputs.
+constexpr int kSoftmaxThreadsPerBlock = 256;
+
+template <bool is_max>
+__device__ float _BlockReduce(float value, float* buffer) {
+  buffer[threadIdx.x] = value;
+  __syncthreads();
+  for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+    if (threadIdx.x < stride) {
+      const float other = buffer[threadIdx.x + stride];
+      buffer[threadIdx.x] = is_max ? fmaxf(buffer[threadIdx.x], other) : buffer[threadIdx.x] + other;
+    }
+    __syncthreads();
+  }
+  float result = buffer[0];
+  // the buffer is reused by the next reduction
+  __syncthreads();
+  return result;
+}
+
+template <typename T>
+__global__ void _MaskedSoftmaxKernel(T* scores, const T* mask, const int num_heads, const int sequence_length) {
+  __shared__ float buffer[kSoftmaxThreadsPerBlock];
+
+  T* row = scores + static_cast<int64_t>(blockIdx.x) * sequence_length;
+  const T* row_mask = mask == nullptr ? nullptr : mask + (blockIdx.x / (num_heads * sequence_length)) * sequence_length;
+
+  float max_value = -CUDART_INF_F;
+  for (int i = threadIdx.x; i < sequence_length; i += blockDim.x) {
+    float value = static_cast<float>(row[i]);
+    if (row_mask != nullptr) {
+      value += static_cast<float>(row_mask[i]);
+    }
+    max_value = fmaxf(max_value, value);
+  }
+  max_value = _BlockReduce<true>(max_value, buffer);
+
+  float sum = 0.0f;
+  for (int i = threadIdx.x; i < sequence_length; i += blockDim.x) {
+    float value = static_cast<float>(row[i]);
+    if (row_mask != nullptr) {
+      value += static_cast<float>(row_mask[i]);
+    }
+    sum += expf(value - max_value);
+  }
+  const float inv_sum = 1.0f / _BlockReduce<false>(sum, buffer);
+
+  for (int i = threadIdx.x; i < sequence_length; i += blockDim.x) {
+    float value = static_cast<float>(row[i]);
+    if (row_mask != nullptr) {
+      value += static_cast<float>(row_mask[i]);
+    }
+    row[i] = static_cast<T>(expf(value - max_value) * inv_sum);
+  }
+}
+
+template <typename T>
+void MaskedSoftmaxImpl(
+    T* scores,
+    const T* mask,
+    const int batch_size,
+    const int num_heads,
+    const int sequence_length) {
+  if (sequence_length <= kMaxWarpSoftmaxElements) {
+    SoftmaxWarpForwardImpl<T>(scores, scores, mask, batch_size * num_heads * sequence_length, sequence_length,
+                              num_heads * sequence_length);
+    return;
+  }
+
+  const unsigned int rows = static_cast<unsigned int>(batch_size * num_heads * sequence_length);
+  _MaskedSoftmaxKernel<T><<<rows, kSoftmaxThreadsPerBlock, 0>>>(scores, mask, num_heads, sequence_length);
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void MaskedSoftmaxImpl<T>(T* scores, const T* mask, const int batch_size, const int num_heads, const int sequence_length);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
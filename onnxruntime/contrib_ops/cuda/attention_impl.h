@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Adds the optional (batch_size, sequence_length) mask to the (batch_size, num_heads, sequence_length,
+// sequence_length) attention scores and applies softmax to each row in place.
+template <typename T>
+void MaskedSoftmaxImpl(
+    T* scores,
+    const T* mask,
+    const int batch_size,
+    const int num_heads,
+    const int sequence_length);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
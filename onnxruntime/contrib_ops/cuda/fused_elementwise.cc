@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "fused_elementwise.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    float,
+    kCudaExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise<float>);
+
+template <typename T>
+FusedElementwise<T>::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+  static const std::unordered_map<std::string, FusedElementwiseOp> op_names = {
+      {"Abs", FusedElementwiseOp::Abs}, {"Exp", FusedElementwiseOp::Exp}, {"Neg", FusedElementwiseOp::Neg},
+      {"Relu", FusedElementwiseOp::Relu}, {"Sigmoid", FusedElementwiseOp::Sigmoid}, {"Tanh", FusedElementwiseOp::Tanh},
+      {"Add", FusedElementwiseOp::Add}, {"Sub", FusedElementwiseOp::Sub}, {"Mul", FusedElementwiseOp::Mul},
+      {"Div", FusedElementwiseOp::Div}};
+
+  std::vector<std::string> ops;
+  ORT_ENFORCE(info.GetAttrs<std::string>("ops", ops).IsOK() && !ops.empty(), "ops must be a non-empty list");
+  const auto operand_first = info.GetAttrsOrDefault<int64_t>("operand_first");
+
+  for (const auto& op : ops) {
+    auto it = op_names.find(op);
+    ORT_ENFORCE(it != op_names.end(), "Unsupported elementwise op ", op);
+    ops_.push_back(it->second);
+
+    bool is_operand_first = false;
+    if (it->second >= FusedElementwiseOp::Add) {
+      is_operand_first = binary_op_count_ < operand_first.size() && operand_first[binary_op_count_] != 0;
+      ++binary_op_count_;
+    }
+    operand_first_.push_back(is_operand_first);
+  }
+}
+
+template <typename T>
+Status FusedElementwise<T>::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const TensorShape& shape = X->Shape();
+  const int64_t elem_count = shape.Size();
+  const int64_t last_dim = shape.NumDimensions() > 0 ? shape[shape.NumDimensions() - 1] : 1;
+
+  if (static_cast<size_t>(context->InputCount()) != binary_op_count_ + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", binary_op_count_ + 1,
+                           " inputs for the binary ops of the chain, got ", context->InputCount());
+  }
+
+  Tensor* Y = context->Output(0, shape);
+  const float* input = X->template Data<float>();
+  float* output = Y->template MutableData<float>();
+
+  int input_index = 1;
+  for (size_t first = 0; first < ops_.size(); first += kMaxFusedElementwiseOps) {
+    FusedElementwiseProgram program{};
+    program.op_count = static_cast<int>(std::min(ops_.size() - first, static_cast<size_t>(kMaxFusedElementwiseOps)));
+    for (int k = 0; k < program.op_count; ++k) {
+      program.ops[k] = ops_[first + k];
+      program.operand_first[k] = operand_first_[first + k];
+      if (program.ops[k] >= FusedElementwiseOp::Add) {
+        const Tensor* B = context->Input<Tensor>(input_index);
+        const TensorShape& b_shape = B->Shape();
+        const int64_t size = b_shape.Size();
+        if (size != elem_count && size != 1 &&
+            !(size == last_dim && b_shape.NumDimensions() > 0 && b_shape[b_shape.NumDimensions() - 1] == last_dim)) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", input_index, " with shape ", b_shape,
+                                 " can't be broadcast to the shape of the first input ", shape);
+        }
+        program.operands[k] = B->template Data<float>();
+        program.operand_sizes[k] = gsl::narrow<int>(size);
+        ++input_index;
+      }
+    }
+
+    // the first launch reads the input, the following ones update the output in place
+    FusedElementwiseImpl(first == 0 ? input : output, output, program, static_cast<size_t>(elem_count));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
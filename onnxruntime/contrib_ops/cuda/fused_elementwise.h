@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "fused_elementwise_impl.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+using namespace onnxruntime::cuda;
+
+// Evaluates the chain of ElementwiseFusion in one pass over the input, or in one pass per
+// kMaxFusedElementwiseOps ops for longer chains.
+template <typename T>
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  std::vector<FusedElementwiseOp> ops_;
+  // for each of ops_, whether the operand of a binary op comes first
+  std::vector<bool> operand_first_;
+  size_t binary_op_count_{0};
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
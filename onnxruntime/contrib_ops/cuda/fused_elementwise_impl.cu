@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+__global__ void _FusedElementwise(
+    const float* input_data,
+    float* output_data,
+    const FusedElementwiseProgram program,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  float value = input_data[id];
+  for (int k = 0; k < program.op_count; ++k) {
+    const FusedElementwiseOp op = program.ops[k];
+    if (op >= FusedElementwiseOp::Add) {
+      const int size = program.operand_sizes[k];
+      const float operand = program.operands[k][size == N ? id : (size == 1 ? 0 : id % size)];
+      const float a = program.operand_first[k] ? operand : value;
+      const float b = program.operand_first[k] ? value : operand;
+      switch (op) {
+        case FusedElementwiseOp::Add:
+          value = a + b;
+          break;
+        case FusedElementwiseOp::Sub:
+          value = a - b;
+          break;
+        case FusedElementwiseOp::Mul:
+          value = a * b;
+          break;
+        default:
+          value = a / b;
+          break;
+      }
+    } else {
+      switch (op) {
+        case FusedElementwiseOp::Abs:
+          value = fabsf(value);
+          break;
+        case FusedElementwiseOp::Exp:
+          value = expf(value);
+          break;
+        case FusedElementwiseOp::Neg:
+          value = -value;
+          break;
+        case FusedElementwiseOp::Relu:
+          value = fmaxf(value, 0.0f);
+          break;
+        case FusedElementwiseOp::Sigmoid:
+          value = value > 0.0f ? 1.0f / (1.0f + expf(-value)) : 1.0f - 1.0f / (1.0f + expf(value));
+          break;
+        default:
+          value = tanhf(value);
+          break;
+      }
+    }
+  }
+  output_data[id] = value;
+}
+
+void FusedElementwiseImpl(
+    const float* input_data,
+    float* output_data,
+    const FusedElementwiseProgram& program,
+    size_t count) {
+  if (count == 0) {
+    return;
+  }
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  _FusedElementwise<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(input_data, output_data, program, N);
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The ops of FusedElementwise, in the order of the CPU kernel.
+enum class FusedElementwiseOp : int {
+  Abs,
+  Exp,
+  Neg,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Add,
+  Sub,
+  Mul,
+  Div,
+};
+
+// Number of ops evaluated by one launch. Longer chains take several launches, each updating the output in place.
+constexpr int kMaxFusedElementwiseOps = 16;
+
+// Part of a chain, passed to the kernel by value so that every thread reads the same op at the same time.
+struct FusedElementwiseProgram {
+  int op_count;
+  FusedElementwiseOp ops[kMaxFusedElementwiseOps];
+  // for the binary ops, whether the operand comes first
+  bool operand_first[kMaxFusedElementwiseOps];
+  // for the binary ops, the operand and its element count: the count of the input, 1, or the size of the last
+  // dimension it is broadcast along
+  const float* operands[kMaxFusedElementwiseOps];
+  int operand_sizes[kMaxFusedElementwiseOps];
+};
+
+// Evaluates the ops of program over count elements of input, keeping each element in a register between ops.
+void FusedElementwiseImpl(
+    const float* input_data,
+    float* output_data,
+    const FusedElementwiseProgram& program,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/gemm.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+template <typename T>
+class FusedGemm final : public onnxruntime::cuda::Gemm<T> {
+ public:
+  FusedGemm(const OpKernelInfo& info) : onnxruntime::cuda::Gemm<T>(info) {
+    using onnxruntime::cuda::FusedActivationKind;
+    const auto activation = info.GetAttrOrDefault<std::string>("activation", "");
+    auto& fused_activation = this->activation_;
+    if (activation == "Relu") {
+      fused_activation.kind = FusedActivationKind::Relu;
+    } else if (activation == "Sigmoid") {
+      fused_activation.kind = FusedActivationKind::Sigmoid;
+    } else if (activation == "Tanh") {
+      fused_activation.kind = FusedActivationKind::Tanh;
+    } else if (activation == "LeakyRelu") {
+      fused_activation.kind = FusedActivationKind::LeakyRelu;
+      fused_activation.alpha = info.GetAttrOrDefault("leaky_relu_alpha", 0.01f);
+    } else if (activation == "FastGelu") {
+      // fused on CUDA only, see GemmActivationFusion
+      fused_activation.kind = FusedActivationKind::FastGelu;
+    } else if (!activation.empty()) {
+      ORT_NOT_IMPLEMENTED("Not implemented fused activation: ", activation);
+    }
+  }
+};
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      FusedGemm,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      FusedGemm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
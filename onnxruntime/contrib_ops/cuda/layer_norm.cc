@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "layer_norm.h"
+#include "layer_norm_impl.h"
+
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      LayerNormalization,                                         \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCudaExecutionProvider,                                     \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      LayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+template <typename T>
+LayerNorm<T>::LayerNorm(const OpKernelInfo& op_kernel_info) : CudaKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("axis", &axis_).IsOK());
+  ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+}
+
+template <typename T>
+Status LayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+
+  const Tensor* X = ctx->Input<Tensor>(0);
+  const Tensor* scale = ctx->Input<Tensor>(1);
+  const Tensor* bias = ctx->Input<Tensor>(2);
+  const TensorShape& x_shape = X->Shape();
+
+  const int64_t axis = HandleNegativeAxis(axis_, x_shape.NumDimensions());
+  const int64_t n1 = x_shape.SizeToDimension(axis);
+  const int64_t n2 = x_shape.SizeFromDimension(axis);
+
+  if (scale->Shape().Size() != n2 || bias->Shape().Size() != n2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Size of scale and B must match the normalized dimensions of X. X shape: ", x_shape,
+                           " axis: ", axis_, " scale shape: ", scale->Shape(), " B shape: ", bias->Shape());
+  }
+
+  Tensor* Y = ctx->Output(0, x_shape);
+  if (n1 == 0 || n2 == 0) {
+    return Status::OK();
+  }
+
+  LayerNormImpl<CudaT>(
+      reinterpret_cast<const CudaT*>(X->template Data<T>()),
+      reinterpret_cast<const CudaT*>(scale->template Data<T>()),
+      reinterpret_cast<const CudaT*>(bias->template Data<T>()),
+      reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+      n1,
+      n2,
+      epsilon_);
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "layer_norm_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// One block normalizes one row. The statistics are accumulated in float for half inputs.
+constexpr int kLayerNormThreadsPerBlock = 256;
+
+template <typename T>
+struct LayerNormAccumulation {
+  typedef float type;
+};
+
+template <>
+struct LayerNormAccumulation<double> {
+  typedef double type;
+};
+
+template <typename U>
+__device__ U _BlockSum(U value, U* buffer) {
+  buffer[threadIdx.x] = value;
+  __syncthreads();
+  for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+    if (threadIdx.x < stride) {
+      buffer[threadIdx.x] += buffer[threadIdx.x + stride];
+    }
+    __syncthreads();
+  }
+  U sum = buffer[0];
+  // the buffer is reused by the next reduction
+  __syncthreads();
+  return sum;
+}
+
+template <typename T, typename U>
+__global__ void _LayerNormKernel(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t n2,
+    const U epsilon) {
+  __shared__ U buffer[kLayerNormThreadsPerBlock];
+
+  const T* x = input_data + blockIdx.x * n2;
+  T* y = output_data + blockIdx.x * n2;
+
+  U sum = 0;
+  for (int64_t i = threadIdx.x; i < n2; i += blockDim.x) {
+    sum += static_cast<U>(x[i]);
+  }
+  const U mean = _BlockSum(sum, buffer) / static_cast<U>(n2);
+
+  U sum_squares = 0;
+  for (int64_t i = threadIdx.x; i < n2; i += blockDim.x) {
+    const U diff = static_cast<U>(x[i]) - mean;
+    sum_squares += diff * diff;
+  }
+  const U inv_std_dev = static_cast<U>(1) / sqrt(_BlockSum(sum_squares, buffer) / static_cast<U>(n2) + epsilon);
+
+  for (int64_t i = threadIdx.x; i < n2; i += blockDim.x) {
+    const U normalized = (static_cast<U>(x[i]) - mean) * inv_std_dev;
+    y[i] = static_cast<T>(normalized * static_cast<U>(scale_data[i]) + static_cast<U>(bias_data[i]));
+  }
+}
+
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t n1,
+    const int64_t n2,
+    const float epsilon) {
+  typedef typename LayerNormAccumulation<T>::type U;
+  _LayerNormKernel<T, U><<<static_cast<unsigned int>(n1), kLayerNormThreadsPerBlock, 0>>>(
+      input_data, scale_data, bias_data, output_data, n2, static_cast<U>(epsilon));
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void LayerNormImpl<T>(const T* input_data, const T* scale_data, const T* bias_data, T* output_data, const int64_t n1, const int64_t n2, const float epsilon);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(double)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Normalizes each of the n1 rows of n2 contiguous elements of input into output.
+template <typename T>
+void LayerNormImpl(
+    const T* input_data,
+    const T* scale_data,
+    const T* bias_data,
+    T* output_data,
+    const int64_t n1,
+    const int64_t n2,
+    const float epsilon);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -33,13 +33,46 @@ enum class ScheduleType : int {
   ScheduleClosure = 4,
 };
 
+// Factors of the schedules, which a tuner may search per subgraph
+struct ScheduleParams {
+  int64_t vector_width = 16;  // split factor of vectorized axes
+  int block_size = 16;        // tile size of blocked loops
+  bool parallel = true;       // whether outer loops are parallelized
+};
+
+// Which factors of ScheduleParams the schedulers read
+struct ScheduleParamsUsage {
+  bool vector_width = false;
+  bool block_size = false;
+  bool parallel = false;
+};
+
 // Data struct to bundle tvm::Schedule and scheduled tensor
 struct ScheduleContext {
-  ScheduleContext(const tvm::Array<tvm::Operation>& ops) {
+  ScheduleContext(const tvm::Array<tvm::Operation>& ops,
+                  const ScheduleParams& schedule_params = ScheduleParams())
+      : params(schedule_params) {
     schedule = tvm::create_schedule(ops);
   }
   tvm::Schedule schedule;
   std::map<const tvm::Node*, ScheduleType> scheduled_tensors;
+
+  // Schedulers read the factors through these, so that a tuner only searches the ones in use
+  int64_t VectorWidth() {
+    params_used.vector_width = true;
+    return params.vector_width;
+  }
+  int BlockSize() {
+    params_used.block_size = true;
+    return params.block_size;
+  }
+  bool Parallel() {
+    params_used.parallel = true;
+    return params.parallel;
+  }
+
+  ScheduleParams params;
+  ScheduleParamsUsage params_used;
 };
 
 // Scheduler inserts a tvm::Schedule content to a tvm::Tensor
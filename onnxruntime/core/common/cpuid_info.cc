@@ -29,6 +29,14 @@ static inline void GetCPUID(int function_id, int data[4]) {  // NOLINT
 #endif
 }
 
+static inline void GetCPUID(int function_id, int sub_leaf, int data[4]) {  // NOLINT
+#if defined(_MSC_VER)
+  __cpuidex(reinterpret_cast<int*>(data), function_id, sub_leaf);
+#elif defined(__GNUC__)
+  __cpuid_count(function_id, sub_leaf, data[0], data[1], data[2], data[3]);
+#endif
+}
+
 static inline int XGETBV() {
 #if defined(_MSC_VER)
   return static_cast<int>(_xgetbv(0));
@@ -59,9 +67,17 @@ CPUIDInfo::CPUIDInfo() noexcept {
       has_f16c_ = has_avx && (data[2] & (1 << 29)) && (data[3] & (1 << 26));
 
       if (num_IDs >= 7) {
-        GetCPUID(7, data);
+        // Leaf 7 reports the extended features by sub-leaf, so the sub-leaf must be specified.
+        GetCPUID(7, 0, data);
+        int max_sub_leaf = data[0];
         has_avx2_ = has_avx && (data[1] & (1 << 5));
         has_avx512f_ = has_avx512 && (data[1] & (1 << 16));
+        has_avx512_vnni_ = has_avx512f_ && (data[2] & (1 << 11));
+
+        if (max_sub_leaf >= 1) {
+          GetCPUID(7, 1, data);
+          has_avx512_bf16_ = has_avx512f_ && (data[0] & (1 << 5));
+        }
       }
     }
   }
@@ -14,12 +14,16 @@ public:
 
   bool HasAVX2() const { return has_avx2_; }
   bool HasAVX512f() const { return has_avx512f_; }
+  bool HasAVX512_VNNI() const { return has_avx512_vnni_; }
+  bool HasAVX512_BF16() const { return has_avx512_bf16_; }
   bool HasF16C() const { return has_f16c_; }
 
 private:
   CPUIDInfo() noexcept;
   bool has_avx2_{false};
   bool has_avx512f_{false};
+  bool has_avx512_vnni_{false};
+  bool has_avx512_bf16_{false};
   bool has_f16c_{false};
 };
 
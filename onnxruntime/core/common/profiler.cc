@@ -82,10 +82,57 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
   }
 }
 
+void Profiler::AddEpProfiler(const std::string& provider_type, std::unique_ptr<EpProfiler> ep_profiler) {
+  ORT_ENFORCE(ep_profiler != nullptr);
+  ep_profilers_[provider_type] = std::move(ep_profiler);
+}
+
+void Profiler::CollectEpEvents() {
+  if (!enabled_ || ep_profilers_.empty()) {
+    return;
+  }
+
+  std::vector<EventRecord> ep_events;
+  for (auto& entry : ep_profilers_) {
+    entry.second->Collect(false, profiling_start_time_, ep_events);
+  }
+
+  if (profile_with_logger_) {
+    for (const auto& event : ep_events) {
+      custom_logger_->SendProfileEvent(event);
+    }
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto& event : ep_events) {
+    if (events_.size() >= max_num_events_) break;
+    events_.emplace_back(std::move(event));
+  }
+}
+
 std::string Profiler::EndProfiling() {
   if (!enabled_) {
     return std::string();
   }
+
+  // wait for the kernels still running on the devices
+  std::vector<EventRecord> ep_events;
+  for (auto& entry : ep_profilers_) {
+    entry.second->Collect(true, profiling_start_time_, ep_events);
+  }
+  if (profile_with_logger_) {
+    for (const auto& event : ep_events) {
+      custom_logger_->SendProfileEvent(event);
+    }
+  } else {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    for (auto& event : ep_events) {
+      if (events_.size() >= max_num_events_) break;
+      events_.emplace_back(std::move(event));
+    }
+  }
+
   if (profile_with_logger_) {
     profile_with_logger_ = false;
     return std::string();
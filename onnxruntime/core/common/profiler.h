@@ -6,6 +6,8 @@
 #include <fstream>
 #include <tuple>
 #include <initializer_list>
+#include <memory>
+#include <unordered_map>
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
 
@@ -17,6 +19,27 @@ namespace profiling {
 // note that static profiler instance only works with single session
 //#define ENABLE_STATIC_PROFILER_INSTANCE
 
+/**
+ * Device side timing of the kernels of an execution provider. A kernel of a device provider returns once its
+ * work is queued, so the time measured on the host is the launch time. An EpProfiler measures the time the
+ * work took on the device without synchronizing it, and resolves the events once the device has completed.
+ * Start and Stop may be called concurrently by the threads of the parallel executor.
+ */
+class EpProfiler {
+ public:
+  virtual ~EpProfiler() = default;
+
+  // Called before the kernel of a node is launched. Returns the id to pass to Stop.
+  virtual size_t Start() = 0;
+
+  // Called once the kernel is launched.
+  virtual void Stop(size_t id, const std::string& event_name, std::unordered_map<std::string, std::string>&& event_args) = 0;
+
+  // Append the events of the kernels the device has completed, with time stamps relative to profiling_start_time.
+  // If wait is true, waits for the device to complete all the kernels stopped so far.
+  virtual void Collect(bool wait, TimePoint profiling_start_time, std::vector<EventRecord>& events) = 0;
+};
+
 /**
  * Main class for profiling. It continues to accumulate events and produce
  * a corresponding "complete event (X)" in "chrome tracing" format.
@@ -73,6 +96,26 @@ class Profiler {
   */
   std::string EndProfiling();
 
+  /*
+  Add the device profiler of an execution provider.
+  */
+  void AddEpProfiler(const std::string& provider_type, std::unique_ptr<EpProfiler> ep_profiler);
+
+  /*
+  Get the device profiler of an execution provider, nullptr if it has none.
+  */
+  EpProfiler* GetEpProfiler(const std::string& provider_type) const {
+    if (ep_profilers_.empty()) return nullptr;
+    auto entry = ep_profilers_.find(provider_type);
+    return entry != ep_profilers_.end() ? entry->second.get() : nullptr;
+  }
+
+  /*
+  Record the events of the device profilers that are completed, e.g. at the end of a Run.
+  Doesn't wait for the devices.
+  */
+  void CollectEpEvents();
+
   static Profiler& Instance() {
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
     ORT_ENFORCE(instance_ != nullptr);
@@ -94,6 +137,7 @@ class Profiler {
   const logging::Logger* custom_logger_{nullptr};
   TimePoint profiling_start_time_;
   std::vector<EventRecord> events_;
+  std::unordered_map<std::string, std::unique_ptr<EpProfiler>> ep_profilers_;
   bool max_events_reached{false};
   static constexpr size_t max_num_events_ = 1000000;
   bool profile_with_logger_{false};
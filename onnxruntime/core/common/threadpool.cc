@@ -3,24 +3,16 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-
-#if defined(__GNUC__)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-parameter"
-#else
-#pragma warning(push)
-#pragma warning(disable : 4267)
-#endif
-#include <unsupported/Eigen/CXX11/src/ThreadPool/Barrier.h>
-#if defined(__GNUC__)
-#pragma GCC diagnostic pop
-#else
-#pragma warning(pop)
-#endif
-
-using Eigen::Barrier;
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
 
 namespace onnxruntime {
 
@@ -28,32 +20,294 @@ namespace concurrency {
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadEnvironment::EnvThread* ThreadEnvironment::CreateThread(std::function<void()> f) {
+  if (affinity_.empty()) {
+    return new EnvThread(std::move(f));
+  }
+
+  const int logical_processor = affinity_[num_created_threads_++ % affinity_.size()];
+  return new EnvThread([logical_processor, f]() {
+    // the thread still runs if it can't be pinned, e.g. if the processor isn't available to the process
+    Env::Default().SetCurrentThreadAffinity(logical_processor);
+    f();
+  });
+}
+
+ThreadPool::ThreadPool(const std::string& name, int num_threads) : ThreadPool(name, num_threads, ThreadOptions()) {}
+
+ThreadPool::ThreadPool(const std::string&, int num_threads, const ThreadOptions& thread_options)
+    : impl_(num_threads, thread_options.allow_spinning, ThreadEnvironment(thread_options.affinity)),
+      section_spin_duration_us_(thread_options.allow_spinning ? std::max(thread_options.section_spin_duration_us, 0)
+                                                              : 0) {}
 
 void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
 
-void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
+namespace {
+// Approximate amount of work, in cycles, below which handing a block to another
+// thread costs more than running it on the calling thread.
+constexpr double kMinCostPerBlock = 10000.0;
+
+// max number of threads, including the calling one, set by the ScopedParallelismLimit of the thread. 0 if none.
+thread_local int parallelism_limit = 0;
+
+// the innermost ParallelSection open on the thread. null if none.
+thread_local ParallelSectionState* current_section = nullptr;
+
+// the deadline set by the ScopedDeadline of the thread. time_point::max() if none.
+thread_local std::chrono::steady_clock::time_point run_deadline = std::chrono::steady_clock::time_point::max();
+}  // namespace
+
+// The blocks of one ParallelFor. The calling thread and the threads helping it claim the blocks one at a time,
+// so the calling thread runs them all itself if no thread of the pool is free. A helper that starts after all the
+// blocks are claimed returns without calling fn, so the calling thread only waits for the blocks to finish.
+struct ParallelForState {
+  ParallelForState(const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& f, std::ptrdiff_t t,
+                   std::ptrdiff_t size, std::ptrdiff_t count)
+      : fn(f), total(t), block_size(size), num_blocks(count), remaining_blocks(count), deadline(run_deadline) {}
+
+  // runs blocks until none is left to claim
+  void RunBlocks() {
+    for (;;) {
+      const std::ptrdiff_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+      if (block >= num_blocks) return;
+
+      // the blocks of a loop past the deadline of its Run are claimed without running them
+      if (deadline == std::chrono::steady_clock::time_point::max() || std::chrono::steady_clock::now() < deadline) {
+        const std::ptrdiff_t first = block * block_size;
+        fn(first, std::min(total, first + block_size));
+      }
+      if (remaining_blocks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<OrtMutex> lock(mutex);
+        done = true;
+        cv.notify_all();
+      }
+    }
+  }
+
+  // waits for the blocks claimed by other threads
+  void Wait() {
+    if (remaining_blocks.load(std::memory_order_acquire) == 0) return;
+    std::unique_lock<OrtMutex> lock(mutex);
+    cv.wait(lock, [this]() { return done; });
+  }
+
+  const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn;
+  const std::ptrdiff_t total;
+  const std::ptrdiff_t block_size;
+  const std::ptrdiff_t num_blocks;
+  std::atomic<std::ptrdiff_t> next_block{0};
+  std::atomic<std::ptrdiff_t> remaining_blocks;
+  // the deadline of the thread scheduling the loop, the helping threads don't have it
+  const std::chrono::steady_clock::time_point deadline;
+
+  OrtMutex mutex;
+  OrtCondVar cv;
+  bool done = false;
+};
+
+// The workers of a ParallelSection. Each one is a task of the pool that runs the blocks of the loops published by
+// the thread that opened the section, spinning between loops. A worker that spins without seeing a new loop ends
+// its task, so the thread goes back to the pool and can run the tasks of other callers, and the next Publish
+// schedules a replacement for it.
+struct ParallelSectionState : std::enable_shared_from_this<ParallelSectionState> {
+  ParallelSectionState(ThreadPool* tp, int workers, int spin_duration_us)
+      : pool(tp), max_workers(workers), spin_duration(spin_duration_us) {}
+
+  void RunWorker() {
+    // the pool runs a task on the thread scheduling it when its queue is full, and that thread can't be a worker
+    if (pool->CurrentThreadId() == -1) {
+      num_workers.fetch_sub(1);
+      return;
+    }
+
+    for (;;) {
+      const uint64_t seen = generation.load(std::memory_order_acquire);
+      std::shared_ptr<ParallelForState> current = std::atomic_load(&loop);
+      if (current) current->RunBlocks();
+      if (WaitForLoop(seen)) continue;
+
+      num_workers.fetch_sub(1);
+      // a loop published after the spin ended may not have scheduled a replacement for this worker
+      if (shutdown.load(std::memory_order_acquire) || generation.load(std::memory_order_acquire) == seen ||
+          !TryAddWorker()) {
+        return;
+      }
+    }
+  }
+
+  // spins until a loop newer than seen is published. returns false when the section ends or the spin times out.
+  bool WaitForLoop(uint64_t seen) {
+    auto is_signaled = [this, seen]() {
+      return generation.load(std::memory_order_acquire) != seen || shutdown.load(std::memory_order_acquire);
+    };
+
+    if (spin_duration.count() > 0) {
+      const auto spin_end = std::chrono::steady_clock::now() + spin_duration;
+      for (unsigned i = 1; !is_signaled(); ++i) {
+        // checking the clock costs more than checking for a loop, so do it every so often
+        if (i % 64 == 0) {
+          if (std::chrono::steady_clock::now() >= spin_end) break;
+          std::this_thread::yield();
+        }
+      }
+    }
+
+    return is_signaled() && !shutdown.load(std::memory_order_acquire);
+  }
+
+  // counts one more worker, unless the section already has max_workers of them
+  bool TryAddWorker() {
+    int workers = num_workers.load();
+    while (workers < max_workers) {
+      if (num_workers.compare_exchange_weak(workers, workers + 1)) return true;
+    }
+    return false;
+  }
+
+  void Publish(const std::shared_ptr<ParallelForState>& next_loop) {
+    std::atomic_store(&loop, next_loop);
+    generation.fetch_add(1);
+
+    // the workers that timed out since the last loop are scheduled again, behind the tasks already queued
+    std::shared_ptr<ParallelSectionState> state = shared_from_this();
+    while (TryAddWorker()) {
+      pool->Schedule([state]() { state->RunWorker(); });
+    }
+  }
+
+  void Close() {
+    std::atomic_store(&loop, std::shared_ptr<ParallelForState>());
+    shutdown.store(true, std::memory_order_release);
+  }
+
+  ThreadPool* const pool;
+  const int max_workers;
+  const std::chrono::microseconds spin_duration;
+  // the section open on the thread before this one
+  ParallelSectionState* previous = nullptr;
+
+  // the last loop published, accessed through std::atomic_load and std::atomic_store
+  std::shared_ptr<ParallelForState> loop;
+  std::atomic<uint64_t> generation{0};
+  std::atomic<bool> shutdown{false};
+
+  // the number of workers scheduled or running
+  std::atomic<int> num_workers{0};
+};
+
+ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
+  // the threads of the pool can't wait for a loop of their own pool
+  if (tp == nullptr || tp->CurrentThreadId() != -1) return;
+  for (auto* section = current_section; section != nullptr; section = section->previous) {
+    if (section->pool == tp) return;
+  }
+
+  const int max_workers = tp->NumThreads();
+  if (max_workers <= 0) return;
+
+  // the workers are scheduled by the first loop, a section whose Run has no parallel loop holds no thread.
+  // a worker that starts after the section ended returns right away, it keeps the state alive until then.
+  state_ = std::make_shared<ParallelSectionState>(tp, max_workers, tp->section_spin_duration_us_);
+  state_->previous = current_section;
+  current_section = state_.get();
+}
+
+ThreadPool::ParallelSection::~ParallelSection() {
+  if (!state_) return;
+
+  current_section = state_->previous;
+  state_->Close();
+}
+
+bool ThreadPool::TryParallelForInSection(const std::shared_ptr<ParallelForState>& loop) {
+  if (current_section == nullptr || current_section->pool != this) return false;
+
+  current_section->Publish(loop);
+  loop->RunBlocks();
+  loop->Wait();
+  return true;
+}
+
+ThreadPool::ScopedParallelismLimit::ScopedParallelismLimit(int max_threads)
+    : previous_max_threads_(parallelism_limit) {
+  parallelism_limit = std::max(max_threads, 0);
+}
+
+ThreadPool::ScopedParallelismLimit::~ScopedParallelismLimit() { parallelism_limit = previous_max_threads_; }
+
+int ThreadPool::CurrentParallelismLimit() { return parallelism_limit; }
+
+ThreadPool::ScopedDeadline::ScopedDeadline(std::chrono::steady_clock::time_point deadline)
+    : previous_deadline_(run_deadline) {
+  run_deadline = deadline;
+}
+
+ThreadPool::ScopedDeadline::~ScopedDeadline() { run_deadline = previous_deadline_; }
+
+std::chrono::steady_clock::time_point ThreadPool::CurrentDeadline() { return run_deadline; }
+
+bool ThreadPool::DeadlineExceeded() {
+  return run_deadline != std::chrono::steady_clock::time_point::max() &&
+         std::chrono::steady_clock::now() >= run_deadline;
+}
+
+std::ptrdiff_t ThreadPool::ComputeBlockCount(std::ptrdiff_t total, double cost_per_unit) const {
+  if (total <= 0) return 0;
+
+  // The calling thread runs one of the blocks, so use one more block than the
+  // number of worker threads.
+  std::ptrdiff_t max_blocks = std::min<std::ptrdiff_t>(total, static_cast<std::ptrdiff_t>(NumThreads()) + 1);
+
+  if (cost_per_unit > 0) {
+    const double total_cost = static_cast<double>(total) * cost_per_unit;
+    const double blocks_by_cost = std::ceil(total_cost / kMinCostPerBlock);
+    if (blocks_by_cost < static_cast<double>(max_blocks)) {
+      max_blocks = std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(blocks_by_cost));
+    }
+  }
+
+  return max_blocks;
+}
+
+void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
   if (total <= 0) return;
 
-  if (total == 1) {
-    fn(0);
+  std::ptrdiff_t num_blocks = ComputeBlockCount(total, cost_per_unit);
+  if (num_blocks <= 1) {
+    fn(0, total);
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(total - 1));
-  std::function<void(int32_t)> handle_iteration = [&barrier, &fn](int iteration) {
-    fn(iteration);
-    barrier.Notify();
-  };
+  // Round the block size up and recompute the block count so that no block is empty.
+  const std::ptrdiff_t block_size = (total + num_blocks - 1) / num_blocks;
+  num_blocks = (total + block_size - 1) / block_size;
+
+  auto loop = std::make_shared<ParallelForState>(fn, total, block_size, num_blocks);
+  if (TryParallelForInSection(loop)) return;
+
+  for (std::ptrdiff_t block = 1; block < num_blocks; ++block) {
+    Schedule([loop]() { loop->RunBlocks(); });
+  }
+
+  // The calling thread runs blocks too instead of idling until they are done.
+  loop->RunBlocks();
+  loop->Wait();
+}
+
+void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
+  if (total <= 0) return;
 
-  for (int32_t id = 1; id < total; ++id) {
-    Schedule([=, &handle_iteration]() { handle_iteration(id); });
+  if (total == 1) {
+    fn(0);
+    return;
   }
 
-  fn(0);
-  barrier.Wait();
+  ParallelFor(static_cast<std::ptrdiff_t>(total), 0.0, [&fn](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      fn(static_cast<int32_t>(i));
+    }
+  });
 }
 
 void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn) {
@@ -63,27 +317,20 @@ void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<voi
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(last - first));
-  std::function<void(int64_t, int64_t)> handle_range = [&barrier, &fn](int64_t first, int64_t last) {
-    fn(first, last);
-    barrier.Notify();
-  };
-
-  for (int64_t id = first + 1; id <= last; ++id) {
-    Schedule([=, &handle_range]() { handle_range(id, id + 1); });
-  }
-
-  fn(first, first + 1);
-  barrier.Wait();
+  ParallelFor(static_cast<std::ptrdiff_t>(last - first), 0.0,
+              [first, &fn](std::ptrdiff_t block_first, std::ptrdiff_t block_last) {
+                fn(first + block_first, first + block_last);
+              });
 }
 
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
 //   impl_->SetStealPartitions(partitions);
 // }
 
-int ThreadPool::NumThreads() const { return impl_.NumThreads(); }
+int ThreadPool::NumThreads() const {
+  // the calling thread is one of the threads allowed by the limit
+  return parallelism_limit > 0 ? std::min(impl_.NumThreads(), parallelism_limit - 1) : impl_.NumThreads();
+}
 
 int ThreadPool::CurrentThreadId() const { return impl_.CurrentThreadId(); }
 }  // namespace concurrency
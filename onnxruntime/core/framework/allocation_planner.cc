@@ -134,6 +134,7 @@ class PlannerImpl {
     const onnxruntime::NodeArg* p_def_site;  // the (unique) NodeArg corresponding to the MLValue
     int usecount = 0;                        // static reference-count
     OrtValueIndex reused_buffer_index;       // index of original buffer to reuse
+    std::vector<NodeIndex> users;            // nodes that produce or consume the value, or any value reusing it
   };
 
   // ort_value_info_ is indexed by an OrtValueIndex
@@ -153,6 +154,11 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // For parallel execution: bit j of row i of ancestors_ is set if node j must complete before node i can start,
+  // i.e. there is a path of edges from node j to node i. Each row has ancestor_words_ words.
+  std::vector<uint64_t> ancestors_;
+  size_t ancestor_words_ = 0;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -185,6 +191,27 @@ class PlannerImpl {
     info.usecount = 0;
     info.reused_buffer_index = id;  // initially, no reuse; the ml-value uses its own buffer
     info.p_def_site = p_def_site;
+    info.users.clear();
+  }
+
+  void AddUser(OrtValueIndex n, NodeIndex node_index) {
+    ORT_ENFORCE(n >= 0 && static_cast<size_t>(n) < ort_value_info_.size());
+    ort_value_info_[n].users.push_back(node_index);
+  }
+
+  bool IsAncestor(NodeIndex ancestor, NodeIndex node) const {
+    return (ancestors_[node * ancestor_words_ + ancestor / 64] >> (ancestor % 64)) & 1;
+  }
+
+  // Returns true if, under parallel execution, every node other than node_index that uses the buffer has
+  // completed before node_index starts, so node_index may overwrite the buffer. Always true for sequential
+  // execution, where the use counts already guarantee this.
+  bool BufferUsersPrecede(OrtValueIndex buffer, NodeIndex node_index) {
+    if (!context_.IsParallelExecutionEnabled()) return true;
+    for (NodeIndex user : ort_value_info_.at(buffer).users) {
+      if (user != node_index && !IsAncestor(user, node_index)) return false;
+    }
+    return true;
   }
 
   // Reuse/Alias/Share between two OrtValue indexes
@@ -196,6 +223,10 @@ class PlannerImpl {
     Buffer(reused_for) = original;
     // adjust original buffer's usecount
     UseCount(original) += UseCount(reused_for);
+    // the nodes using reused_for now use the original buffer too
+    auto& original_users = ort_value_info_[original].users;
+    const auto& reused_for_users = ort_value_info_[reused_for].users;
+    original_users.insert(original_users.end(), reused_for_users.cbegin(), reused_for_users.cend());
 
     // update allocation plan (for use at execution-time)
     auto& symplan = AllocPlan(reused_for);
@@ -235,7 +266,7 @@ class PlannerImpl {
           if (p_input_arg->Exists()) {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
-            if (1 == UseCount(original)) {
+            if (1 == UseCount(original) && BufferUsersPrecede(original, node.Index())) {
               if (SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
@@ -270,33 +301,45 @@ class PlannerImpl {
     return true;
   }
 
-  /*! \brief Given a tensor-type, return the size of an element of the tensor.
+  /*! \brief Given a tensor-type, return the type of an element of the tensor.
   */
-  static size_t GetElementSize(const DataType& tensor_type) {
+  static MLDataType GetElementType(const DataType& tensor_type) {
     const TypeProto& type_proto = ONNX_NAMESPACE::Utils::DataTypeUtils::ToTypeProto(tensor_type);
     MLDataType ml_data_type = DataTypeImpl::TypeFromProto(type_proto);
     const TensorTypeBase* tensor_type_base = ml_data_type->AsTensorType();
     ORT_ENFORCE(nullptr != tensor_type_base);
-    MLDataType elt_type = tensor_type_base->GetElementType();
-    return elt_type->Size();
+    return tensor_type_base->GetElementType();
+  }
+
+  /*! \brief Returns true and the number of bytes of a tensor if all its dimensions are known.
+  */
+  static bool KnownSizeInBytes(const TensorShapeProto& shape, MLDataType element_type, size_t* size_in_bytes) {
+    size_t num_elements = 1;
+    for (int i = 0, rank = shape.dim_size(); i < rank; i++) {
+      const auto& dim = shape.dim(i);
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return false;
+      num_elements *= static_cast<size_t>(dim.dim_value());
+    }
+    return IAllocator::CalcMemSizeForArray(num_elements, element_type->Size(), size_in_bytes);
   }
 
   static bool SameSize(const TensorShapeProto& shape1, const DataType& ptype1, const TensorShapeProto& shape2,
                        const DataType& ptype2) {
-    return (GetElementSize(ptype1) == GetElementSize(ptype2)) && SameShape(shape1, shape2);
-
-    /* TODO: we can improve this if the concrete shapes are known for both as below.
-       Unclear whether this is worthwhile though.
-    if (KnownSize(p_shape1) && KnownSize(p_shape2)) {
-      // Comparison of statically-known size
-      auto size1 = NumElements(p_shape1) * EltSize(ptype1);
-      auto size2 = NumElements(p_shape2) * EltSize(ptype2);
-      return size1 == size2;
-    } else {
-      // Comparison of statically-unknown size buffers
-      return SameElementSize(ptype1, ptype2) && SameShape(shape1, shape2);
-    }
-    */
+    MLDataType element_type1 = GetElementType(ptype1);
+    MLDataType element_type2 = GetElementType(ptype2);
+
+    // a buffer of strings holds std::string objects, so it's only reused for strings
+    const auto* string_type = DataTypeImpl::GetType<std::string>();
+    if ((element_type1 == string_type) != (element_type2 == string_type)) return false;
+
+    // Comparison of statically-unknown size buffers
+    if (element_type1->Size() == element_type2->Size() && SameShape(shape1, shape2)) return true;
+
+    // Comparison of statically-known size, which lets a dead buffer be reused across element types and shapes
+    // with the same number of bytes, e.g. an int64 buffer of shape {N} for a float output of shape {2N}.
+    size_t size1, size2;
+    return KnownSizeInBytes(shape1, element_type1, &size1) && KnownSizeInBytes(shape2, element_type2, &size2) &&
+           size1 == size2;
   }
 
   bool SameSize(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
@@ -305,11 +348,14 @@ class PlannerImpl {
     auto p_shape2 = context_.GetShape(arg2);
     // If the shapes are unknown, we conservatively assume they may be of different size.
     if ((nullptr == p_shape1) || (nullptr == p_shape2)) return false;
+    // an in-place kernel reads and writes each element at the same index, so the elements must have the same size
+    if (GetElementType(arg1.Type())->Size() != GetElementType(arg2.Type())->Size()) return false;
     return SameSize(*p_shape1, arg1.Type(), *p_shape2, arg2.Type());
   }
 
-  // Find if freelist contains a buffer of the same size as output_arg
-  bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, OrtValueIndex* reusable_tensor) {
+  // Find if freelist contains a buffer of the same size as output_arg that the node may overwrite
+  bool FindReusableTensor(const onnxruntime::Node& node, const onnxruntime::NodeArg& output_arg,
+                          OrtValueIndex* reusable_tensor) {
     auto p_required_buffer_shape = context_.GetShape(output_arg);
     if (nullptr == p_required_buffer_shape) return false;
     auto required_buffer_type = output_arg.Type();
@@ -320,6 +366,7 @@ class PlannerImpl {
       const onnxruntime::NodeArg* p_node_arg = ort_value_info_.at(reusable).p_def_site;
       auto& available_memory_info = AllocPlan(p_node_arg->Name()).location;
       if (!(available_memory_info == required_memory_info)) continue;
+      if (!BufferUsersPrecede(it->ml_value, node.Index())) continue;
       auto p_available_buffer_shape = context_.GetShape(*p_node_arg);
       if (nullptr != p_available_buffer_shape) {
         auto available_buffer_type = p_node_arg->Type();
@@ -344,6 +391,9 @@ class PlannerImpl {
     // Initialize node_has_fence.
     plan_.node_has_fence.resize(graph_viewer_.MaxNodeIndex());
 
+    // Initialize node_priority.
+    plan_.node_priority.resize(graph_viewer_.MaxNodeIndex());
+
     // Initialize allocation plan:
     plan_.allocation_plan.resize(num_ml_values);
   }
@@ -400,9 +450,11 @@ class PlannerImpl {
       }
 
       // increment UseCount and add location information if applicable for the provided input def
-      auto process_input = [&graph_inputs, &exec_provider, &p_kernelDef, this](const NodeArg& input, size_t arg_idx) {
+      auto process_input = [&graph_inputs, &exec_provider, &p_kernelDef, pnode, this](const NodeArg& input,
+                                                                                        size_t arg_idx) {
         const auto& name = input.Name();
         UseCount(name)++;
+        AddUser(Index(name), pnode->Index());
 
         // If it's a graph input or outer scope node arg, set its plan.
         // NOTE: Copy nodes should have already been added if a graph input is fed as input
@@ -431,6 +483,7 @@ class PlannerImpl {
         OrtValueIndex index = Index(node_output->Name());
         ProcessDef(index, node_output);
         ++UseCount(index);
+        AddUser(index, pnode->Index());
         plan_.SetLocation(static_cast<size_t>(index), exec_provider->GetAllocator(0, p_kernelDef->OutputMemoryType(i))->Info());
       }
       // if sync is needed, mark allocation plan as create_fence_if_async=true
@@ -560,8 +613,9 @@ class PlannerImpl {
         } else if (FindReusableInput(*pnode, output_arg_num, &reused)) {
           // Reuse one of this node's input buffers as the output buffer (for in-place update)
           Reuse(reused, current, AllocKind::kReuse);
-        } else if (!context_.IsParallelExecutionEnabled() && FindReusableTensor(*node_output, &reused)) {
-          // Reuse an available (dead) buffer for this output, this is only for sequential execution.
+        } else if (FindReusableTensor(*pnode, *node_output, &reused)) {
+          // Reuse an available (dead) buffer for this output. For parallel execution the buffer must not be used
+          // by any node that could run concurrently with this one.
           Reuse(reused, current, AllocKind::kReuse);
         } else {
           // otherwise: allocate a new buffer for this output
@@ -644,6 +698,49 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Compute the ancestors of every node in the execution order, which is topological, so the ancestors of the
+  // producers of a node are complete before the node itself.
+  Status ComputeAncestors() {
+    const size_t num_nodes = graph_viewer_.MaxNodeIndex();
+    ancestor_words_ = (num_nodes + 63) / 64;
+    ancestors_.assign(num_nodes * ancestor_words_, 0);
+
+    for (const auto& step : plan_.execution_plan) {
+      auto pnode = graph_viewer_.GetNode(step.node_index);
+      if (pnode == nullptr) return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Can not find the node ", step.node_index);
+
+      uint64_t* row = &ancestors_[step.node_index * ancestor_words_];
+      for (auto edge = pnode->InputEdgesBegin(), edge_end = pnode->InputEdgesEnd(); edge != edge_end; ++edge) {
+        const NodeIndex producer = edge->GetNode().Index();
+        const uint64_t* producer_row = &ancestors_[producer * ancestor_words_];
+        for (size_t w = 0; w < ancestor_words_; ++w) {
+          row[w] |= producer_row[w];
+        }
+        row[producer / 64] |= uint64_t{1} << (producer % 64);
+      }
+    }
+
+    return Status::OK();
+  }
+
+  // Compute the critical-path priority of every node by walking the execution order backwards, so that
+  // all consumers of a node have been visited before the node itself.
+  Status ComputeNodePriorities() {
+    for (auto it = plan_.execution_plan.rbegin(), end = plan_.execution_plan.rend(); it != end; ++it) {
+      auto pnode = graph_viewer_.GetNode(it->node_index);
+      if (pnode == nullptr) return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Can not find the node ", it->node_index);
+
+      size_t longest_downstream_path = 0;
+      for (auto edge = pnode->OutputEdgesBegin(), edge_end = pnode->OutputEdgesEnd(); edge != edge_end; ++edge) {
+        longest_downstream_path = std::max(longest_downstream_path, plan_.node_priority[edge->GetNode().Index()]);
+      }
+
+      plan_.node_priority[it->node_index] = longest_downstream_path + 1;
+    }
+
+    return Status::OK();
+  }
+
   // Convert information in a freelist (about which ml-value becomes free when) into
   // a deallocation plan in the format required in an ExecutionPlan
   void GenerateDeallocationPlan() {
@@ -698,12 +795,20 @@ Status PlannerImpl::CreatePlan() {
   // compute use counts for all ml-values
   ORT_RETURN_IF_ERROR(ComputeUseCounts());
 
+  // the DAG dependencies decide which buffers can be reused safely when nodes run concurrently
+  if (context_.IsParallelExecutionEnabled()) {
+    ORT_RETURN_IF_ERROR(ComputeAncestors());
+  }
+
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
   // Determine nodes that need fence check. This needs to be done after ComputeUseCounts and ComputeReusePlan.
   ORT_RETURN_IF_ERROR(ComputeFenceCheck());
 
+  // Determine the critical-path priority of each node for the parallel executor.
+  ORT_RETURN_IF_ERROR(ComputeNodePriorities());
+
   // convert information in the freelist_ into a deallocation plan in required format
   GenerateDeallocationPlan();
 
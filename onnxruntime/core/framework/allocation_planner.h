@@ -22,8 +22,8 @@ class OrtValueNameIdxMap;
 class ISequentialPlannerContext {
  public:
   virtual const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const = 0;
-  // If it returns true, planner won't reuse output tensors
-  // see PlannerImpl::ComputeReusePlan
+  // If it returns true, nodes may run concurrently, so the planner only reuses a buffer when all of its other
+  // users are ancestors of the node in the graph. see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
 };
 
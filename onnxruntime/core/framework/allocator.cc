@@ -4,6 +4,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/utils.h"
+#include "core/platform/env.h"
 #include "core/session/ort_apis.h"
 #include <cstdlib>
 #include <sstream>
@@ -19,6 +20,75 @@ void CPUAllocator::Free(void* p) {
 }
 
 const OrtMemoryInfo& CPUAllocator::Info() const { return *memory_info_; }
+
+void* NumaCPUAllocator::Alloc(size_t size) {
+  void* p = Env::Default().AllocOnNumaNode(size, numa_node_);
+  if (p == nullptr) return utils::DefaultAlloc(size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  numa_blocks_[p] = size;
+  return p;
+}
+
+void NumaCPUAllocator::Free(void* p) {
+  if (p == nullptr) return;
+
+  size_t size = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto block = numa_blocks_.find(p);
+    if (block == numa_blocks_.end()) {
+      utils::DefaultFree(p);
+      return;
+    }
+    size = block->second;
+    numa_blocks_.erase(block);
+  }
+
+  Env::Default().FreeOnNumaNode(p, size);
+}
+
+const OrtMemoryInfo& NumaCPUAllocator::Info() const { return *memory_info_; }
+
+void* HugePageCPUAllocator::Alloc(size_t size) {
+  const size_t huge_page_size = Env::Default().GetHugePageSize();
+  if (huge_page_size == 0 || size < huge_page_size) return fallback_->Alloc(size);
+
+  void* p = Env::Default().AllocHugePages(size, numa_node_);
+  if (p == nullptr) return fallback_->Alloc(size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  huge_page_blocks_[p] = size;
+  huge_page_bytes_ += (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+  return p;
+}
+
+void HugePageCPUAllocator::Free(void* p) {
+  if (p == nullptr) return;
+
+  size_t size = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto block = huge_page_blocks_.find(p);
+    if (block == huge_page_blocks_.end()) {
+      fallback_->Free(p);
+      return;
+    }
+    size = block->second;
+    huge_page_blocks_.erase(block);
+    const size_t huge_page_size = Env::Default().GetHugePageSize();
+    huge_page_bytes_ -= (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+  }
+
+  Env::Default().FreeHugePages(p, size);
+}
+
+const OrtMemoryInfo& HugePageCPUAllocator::Info() const { return fallback_->Info(); }
+
+size_t HugePageCPUAllocator::HugePageBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return huge_page_bytes_;
+}
 }  // namespace onnxruntime
 
 std::ostream& operator<<(std::ostream& out, const OrtMemoryInfo& info) { return (out << info.ToString()); }
@@ -14,6 +14,8 @@ struct DeviceAllocatorRegistrationInfo {
   OrtMemType mem_type;
   DeviceAllocatorFactory factory;
   size_t max_mem;
+  // Per-thread cache budget of the arena created for this allocator. 0 disables the cache.
+  size_t max_thread_cache_bytes{0};
 };
 
 AllocatorPtr CreateAllocator(DeviceAllocatorRegistrationInfo info, int device_id = 0);
@@ -26,6 +26,12 @@ class IArenaAllocator : public IAllocator {
   void Free(void* p) override = 0;
   virtual size_t Used() const = 0;
   virtual size_t Max() const = 0;
+  // Return the memory the arena holds without any allocation in it to the device allocator,
+  // so that it can be used by others. Returns the number of bytes released.
+  // Shrink call need to be thread safe.
+  virtual size_t Shrink() { return 0; }
+  // bytes of the memory the arena holds that is backed by huge pages
+  virtual size_t HugePageBytes() const { return 0; }
   const OrtMemoryInfo& Info() const override = 0;
   // allocate host pinned memory?
 };
@@ -64,6 +70,10 @@ class DummyArena : public IArenaAllocator {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  size_t HugePageBytes() const override {
+    return allocator_->HugePageBytes();
+  }
+
   const OrtMemoryInfo& Info() const override {
     return info_;
   }
@@ -5,11 +5,13 @@
 
 namespace onnxruntime {
 BFCArena::BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator,
-                   size_t total_memory)
+                   size_t total_memory,
+                   size_t max_thread_cache_bytes)
     : device_allocator_(std::move(resource_allocator)),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1),
-      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type) {
+      info_(device_allocator_->Info().name, OrtAllocatorType::OrtArenaAllocator, device_allocator_->Info().device, device_allocator_->Info().id, device_allocator_->Info().mem_type),
+      max_thread_cache_bytes_(max_thread_cache_bytes) {
   curr_region_allocation_bytes_ = RoundedBytes(std::min(total_memory, size_t{1048576}));
 
   // Allocate the requested amount of memory.
@@ -172,7 +174,138 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
-  return AllocateRawInternal(size, false);
+  if (max_thread_cache_bytes_ > 0 && size > 0 && size <= kMaxCachedChunkSize) {
+    void* ptr = AllocateFromThreadCache(size);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
+  void* ptr = AllocateRawInternal(size, false);
+  if (ptr == nullptr && max_thread_cache_bytes_ > 0 && bytes_in_cache_ > 0) {
+    // Chunks parked in the thread cache may be what stops the bins from satisfying the request.
+    DrainThreadCache();
+    ptr = AllocateRawInternal(size, false);
+  }
+
+  return ptr;
+}
+
+// static
+size_t BFCArena::CurrentThreadCacheShard() {
+  // Hand out shards round-robin so that busy threads are spread evenly.
+  static std::atomic<size_t> next_shard{0};
+  thread_local size_t shard = next_shard++ % kNumCacheShards;
+  return shard;
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+
+  // Cached chunks are a whole size class so that any request in the class can reuse them.
+  BinNum bin_num = BinNumForSize(rounded_bytes);
+  if (BinNumToSize(bin_num) < rounded_bytes) {
+    ++bin_num;
+  }
+
+  const size_t chunk_bytes = BinNumToSize(bin_num);
+
+  {
+    CacheShard& shard = cache_shards_[CurrentThreadCacheShard()];
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    auto& free_list = shard.free_lists[bin_num];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      shard.cached_bytes -= chunk_bytes;
+      bytes_in_cache_ -= static_cast<int64_t>(chunk_bytes);
+      ++num_cache_hits_;
+      return ptr;
+    }
+  }
+
+  ++num_cache_misses_;
+
+  void* ptr = AllocateRawInternal(chunk_bytes, false);
+  if (ptr != nullptr) {
+    CachedChunkShard& chunk_shard = CachedChunkShardFor(ptr);
+    std::lock_guard<OrtMutex> lock(chunk_shard.mutex);
+    chunk_shard.bins[ptr] = bin_num;
+  }
+
+  return ptr;
+}
+
+bool BFCArena::ReturnToThreadCache(void* ptr) {
+  BinNum bin_num = kInvalidBinNum;
+  {
+    CachedChunkShard& chunk_shard = CachedChunkShardFor(ptr);
+    std::lock_guard<OrtMutex> lock(chunk_shard.mutex);
+    auto entry = chunk_shard.bins.find(ptr);
+    if (entry == chunk_shard.bins.end()) {
+      return false;
+    }
+
+    bin_num = entry->second;
+  }
+
+  const size_t chunk_bytes = BinNumToSize(bin_num);
+  std::vector<void*> to_drain;
+  {
+    CacheShard& shard = cache_shards_[CurrentThreadCacheShard()];
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    shard.free_lists[bin_num].push_back(ptr);
+    shard.cached_bytes += chunk_bytes;
+    bytes_in_cache_ += static_cast<int64_t>(chunk_bytes);
+
+    if (shard.cached_bytes > max_thread_cache_bytes_) {
+      // Drain the whole shard rather than trickling chunks back one at a time.
+      for (auto& free_list : shard.free_lists) {
+        to_drain.insert(to_drain.end(), free_list.cbegin(), free_list.cend());
+        free_list.clear();
+      }
+
+      bytes_in_cache_ -= static_cast<int64_t>(shard.cached_bytes);
+      shard.cached_bytes = 0;
+    }
+  }
+
+  if (!to_drain.empty()) {
+    DrainCachedChunks(to_drain);
+  }
+
+  return true;
+}
+
+void BFCArena::DrainThreadCache() {
+  std::vector<void*> to_drain;
+  for (auto& shard : cache_shards_) {
+    std::lock_guard<OrtMutex> lock(shard.mutex);
+    for (auto& free_list : shard.free_lists) {
+      to_drain.insert(to_drain.end(), free_list.cbegin(), free_list.cend());
+      free_list.clear();
+    }
+
+    bytes_in_cache_ -= static_cast<int64_t>(shard.cached_bytes);
+    shard.cached_bytes = 0;
+  }
+
+  DrainCachedChunks(to_drain);
+}
+
+void BFCArena::DrainCachedChunks(const std::vector<void*>& ptrs) {
+  // Forget the chunks before handing them back, as the bins may give them out again straight away
+  // through the uncached path.
+  for (void* ptr : ptrs) {
+    CachedChunkShard& chunk_shard = CachedChunkShardFor(ptr);
+    std::lock_guard<OrtMutex> lock(chunk_shard.mutex);
+    chunk_shard.bins.erase(ptr);
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* ptr : ptrs) {
+    DeallocateRawInternal(ptr);
+  }
 }
 
 void* BFCArena::Reserve(size_t size) {
@@ -250,6 +383,53 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  stats->num_cache_hits = num_cache_hits_;
+  stats->num_cache_misses = num_cache_misses_;
+  stats->bytes_in_cache = bytes_in_cache_;
+  stats->num_regions = static_cast<int64_t>(region_manager_.regions().size());
+
+  // the free chunks of a bin are ordered by size, so the largest one is the last of the highest non empty bin
+  stats->largest_free_chunk = 0;
+  for (BinNum b = kNumBins; b-- > 0;) {
+    const Bin* bin = BinFromIndex(b);
+    if (!bin->free_chunks.empty()) {
+      stats->largest_free_chunk = static_cast<int64_t>(ChunkFromHandle(*bin->free_chunks.rbegin())->size);
+      break;
+    }
+  }
+}
+
+size_t BFCArena::Shrink() {
+  if (max_thread_cache_bytes_ > 0) {
+    DrainThreadCache();
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  std::vector<void*> unused_regions;
+  for (const auto& region : region_manager_.regions()) {
+    // a region without allocations has been coalesced back into the single chunk it started as
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    Chunk* c = ChunkFromHandle(h);
+    if (!c->in_use() && c->size == region.memory_size()) {
+      RemoveFreeChunkFromBin(h);
+      DeallocateChunk(h);
+      unused_regions.push_back(region.ptr());
+    }
+  }
+
+  size_t released_bytes = 0;
+  for (void* ptr : unused_regions) {
+    size_t bytes = region_manager_.RemoveAllocationRegion(ptr);
+    device_allocator_->Free(ptr);
+    stats_.total_allocated_bytes -= bytes;
+    released_bytes += bytes;
+  }
+
+  if (released_bytes > 0) {
+    LOGS_DEFAULT(INFO) << "Released " << released_bytes << " bytes in " << unused_regions.size()
+                       << " regions. Total allocated bytes: " << stats_.total_allocated_bytes;
+  }
+  return released_bytes;
 }
 
 void* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
@@ -340,6 +520,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (max_thread_cache_bytes_ > 0 && ReturnToThreadCache(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
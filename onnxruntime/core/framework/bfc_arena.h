@@ -16,6 +16,7 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -49,6 +50,12 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_cache_hits;    // Number of allocations served by the small-chunk thread cache.
+  int64_t num_cache_misses;  // Number of cacheable allocations that had to go to the bins.
+  int64_t bytes_in_cache;    // Number of bytes parked in the thread cache. These are included in bytes_in_use.
+  int64_t num_regions;         // Number of memory regions obtained from the device allocator.
+  int64_t largest_free_chunk;  // Size of the largest free chunk. The smaller it is compared to the free bytes,
+                               // total_allocated_bytes - bytes_in_use, the more fragmented the free memory is.
 
   AllocatorStats() { Clear(); }
 
@@ -59,6 +66,11 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_cache_hits = 0;
+    this->num_cache_misses = 0;
+    this->bytes_in_cache = 0;
+    this->num_regions = 0;
+    this->largest_free_chunk = 0;
   }
 
   std::string DebugString() const {
@@ -68,7 +80,12 @@ struct AllocatorStats {
        << "TotalAllocated: " << this->total_allocated_bytes << "\n"
        << "MaxInUse:       " << this->max_bytes_in_use << "\n"
        << "NumAllocs:      " << this->num_allocs << "\n"
-       << "MaxAllocSize:   " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:   " << this->max_alloc_size << "\n"
+       << "CacheHits:      " << this->num_cache_hits << "\n"
+       << "CacheMisses:    " << this->num_cache_misses << "\n"
+       << "InCache:        " << this->bytes_in_cache << "\n"
+       << "NumRegions:     " << this->num_regions << "\n"
+       << "LargestFree:    " << this->largest_free_chunk << "\n";
     return ss.str();
   }
 };
@@ -81,9 +98,18 @@ struct AllocatorStats {
 // coalescing.  One assumption we make is that the process using this
 // allocator owns pretty much all of the memory, and that nearly
 // all requests to allocate memory go through this interface.
+//
+// If max_thread_cache_bytes is non-zero, small chunks (up to kMaxCachedChunkSize
+// bytes) are rounded up to a power of two and, when freed, parked in a cache shard
+// owned by the freeing thread instead of being returned to the bins. The next
+// allocation of the same size class from that thread reuses the chunk without
+// taking the arena lock. A shard holding more than max_thread_cache_bytes is
+// drained back to the bins, and all shards are drained before the arena gives up
+// on an allocation.
 class BFCArena : public IArenaAllocator {
  public:
-  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory);
+  BFCArena(std::unique_ptr<IDeviceAllocator> resource_allocator, size_t total_memory,
+           size_t max_thread_cache_bytes = 0);
 
   ~BFCArena() override;
 
@@ -101,10 +127,19 @@ class BFCArena : public IArenaAllocator {
     return stats_.bytes_in_use;
   }
 
+  // the high-water mark of Used
+  size_t MaxUsed() const {
+    return stats_.max_bytes_in_use;
+  }
+
   size_t Max() const override {
     return memory_limit_;
   }
 
+  size_t HugePageBytes() const override {
+    return device_allocator_->HugePageBytes();
+  }
+
   const OrtMemoryInfo& Info() const override {
     return info_;
   }
@@ -120,10 +155,22 @@ class BFCArena : public IArenaAllocator {
 
   size_t AllocatedSize(const void* ptr);
 
+  // Return all chunks held by the thread cache to the bins.
+  void DrainThreadCache();
+
+  // Free the regions that are a single free chunk with the device allocator. The memory is allocated
+  // again from the device allocator when needed.
+  size_t Shrink() override;
+
  private:
   void* AllocateRawInternal(size_t num_bytes, bool dump_log_on_failure);
   void DeallocateRawInternal(void* ptr);
 
+  // Thread cache helpers. Both return nullptr/false if the request can't be served by the cache.
+  void* AllocateFromThreadCache(size_t num_bytes);
+  bool ReturnToThreadCache(void* ptr);
+  void DrainCachedChunks(const std::vector<void*>& ptrs);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -315,6 +362,16 @@ class BFCArena : public IArenaAllocator {
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
 
+    // Removes the region starting at ptr, and returns its size.
+    size_t RemoveAllocationRegion(void* ptr) {
+      auto entry =
+          std::upper_bound(regions_.begin(), regions_.end(), ptr, &Comparator);
+      ORT_ENFORCE(entry != regions_.end() && entry->ptr() == ptr, "Could not find Region for ", ptr);
+      size_t memory_size = entry->memory_size();
+      regions_.erase(entry);
+      return memory_size;
+    }
+
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
    private:
@@ -476,6 +533,37 @@ class BFCArena : public IArenaAllocator {
 
   std::unordered_map<void*, size_t> reserved_chunks_;
 
+  // Thread cache state. Cached chunks stay marked as in use in the bins' bookkeeping.
+  static const size_t kMaxCachedChunkSize = 64 * 1024;
+  static const BinNum kNumCachedBins = 9;  // size classes 256 bytes .. kMaxCachedChunkSize
+  static const size_t kNumCacheShards = 16;
+
+  // Freed chunks available for reuse, one free list per size class.
+  struct CacheShard {
+    OrtMutex mutex;
+    std::array<std::vector<void*>, kNumCachedBins> free_lists;
+    size_t cached_bytes = 0;
+  };
+
+  // Size class of every chunk that was handed out through the cache, sharded by address so that
+  // a chunk can be freed from any thread.
+  struct CachedChunkShard {
+    OrtMutex mutex;
+    std::unordered_map<const void*, BinNum> bins;
+  };
+
+  static size_t CurrentThreadCacheShard();
+  CachedChunkShard& CachedChunkShardFor(const void* ptr) {
+    return cached_chunk_shards_[(reinterpret_cast<std::uintptr_t>(ptr) >> kMinAllocationBits) % kNumCacheShards];
+  }
+
+  const size_t max_thread_cache_bytes_;
+  std::array<CacheShard, kNumCacheShards> cache_shards_;
+  std::array<CachedChunkShard, kNumCacheShards> cached_chunk_shards_;
+  std::atomic<int64_t> num_cache_hits_{0};
+  std::atomic<int64_t> num_cache_misses_{0};
+  std::atomic<int64_t> bytes_in_cache_{0};
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef __GNUC__
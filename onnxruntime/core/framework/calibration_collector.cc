@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/calibration_collector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+void CalibrationCollector::Rebin(Statistics& statistics, float abs_max) const {
+  std::vector<uint64_t> histogram(num_bins_, 0);
+  if (statistics.abs_max > 0.f) {
+    const float old_width = statistics.abs_max / num_bins_;
+    const float new_width = abs_max / num_bins_;
+    for (size_t i = 0; i < num_bins_; ++i) {
+      const auto bin = static_cast<size_t>((i + 0.5f) * old_width / new_width);
+      histogram[std::min(bin, num_bins_ - 1)] += statistics.histogram[i];
+    }
+  } else if (!statistics.histogram.empty()) {
+    // the values so far were all 0
+    histogram[0] = statistics.histogram[0];
+  }
+
+  statistics.histogram.swap(histogram);
+  statistics.abs_max = abs_max;
+}
+
+void CalibrationCollector::Collect(const std::string& name, const Tensor& tensor) {
+  if (tensor.DataType() != DataTypeImpl::GetType<float>() || tensor.Location().device.Type() != OrtDevice::CPU) {
+    return;
+  }
+
+  const auto size = tensor.Shape().Size();
+  if (size <= 0) {
+    return;
+  }
+
+  const float* data = tensor.Data<float>();
+  const auto min_max = std::minmax_element(data, data + size);
+  const float min = *min_max.first;
+  const float max = *min_max.second;
+  const float abs_max = std::max(std::abs(min), std::abs(max));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& statistics = statistics_[name];
+  if (statistics.count == 0) {
+    statistics.min = min;
+    statistics.max = max;
+    statistics.histogram.assign(num_bins_, 0);
+  } else {
+    statistics.min = std::min(statistics.min, min);
+    statistics.max = std::max(statistics.max, max);
+  }
+
+  // widen at least twice, so that the counts are moved between bins only a few times
+  if (abs_max > statistics.abs_max) {
+    Rebin(statistics, std::max(abs_max, 2 * statistics.abs_max));
+  }
+
+  if (statistics.abs_max > 0.f) {
+    const float scale = num_bins_ / statistics.abs_max;
+    for (int64_t i = 0; i < size; ++i) {
+      const auto bin = static_cast<size_t>(std::abs(data[i]) * scale);
+      ++statistics.histogram[std::min(bin, num_bins_ - 1)];
+    }
+  } else {
+    statistics.histogram[0] += size;
+  }
+  statistics.count += size;
+}
+
+std::unordered_map<std::string, TensorRange> CalibrationCollector::GetRanges(float percentile) const {
+  std::unordered_map<std::string, TensorRange> ranges;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& entry : statistics_) {
+    const auto& statistics = entry.second;
+    TensorRange range{statistics.min, statistics.max};
+
+    if (percentile < 100.f && statistics.abs_max > 0.f) {
+      const auto threshold = static_cast<uint64_t>(std::ceil(statistics.count * percentile / 100.f));
+      uint64_t cumulative = 0;
+      size_t bin = 0;
+      for (; bin < num_bins_; ++bin) {
+        cumulative += statistics.histogram[bin];
+        if (cumulative >= threshold) {
+          break;
+        }
+      }
+
+      const float magnitude = (bin + 1) * statistics.abs_max / num_bins_;
+      range.min = std::max(range.min, -magnitude);
+      range.max = std::min(range.max, magnitude);
+    }
+
+    ranges.emplace(entry.first, range);
+  }
+
+  return ranges;
+}
+
+void CalibrationCollector::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.clear();
+}
+
+}  // namespace onnxruntime
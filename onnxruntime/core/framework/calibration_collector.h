@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+class Tensor;
+
+// The range of the values of a float tensor, from which its quantization parameters are computed.
+struct TensorRange {
+  float min{0.f};
+  float max{0.f};
+};
+
+// CalibrationCollector accumulates the min, max and a histogram of the magnitudes of every float tensor it's given,
+// over all the Runs of a calibration dataset. The histogram lets the ranges clip the rare outliers which would
+// otherwise waste most of the 8 bit range.
+// Collect is safe to call concurrently; it takes a lock, as calibration runs offline.
+class CalibrationCollector {
+ public:
+  explicit CalibrationCollector(size_t num_bins = 2048) : num_bins_{num_bins} {}
+
+  // Adds the values of a tensor. Only the float tensors in CPU memory are collected, the others are ignored.
+  void Collect(const std::string& name, const Tensor& tensor);
+
+  // Returns the range of every tensor collected. With percentile < 100 the ranges are clipped to the magnitude
+  // which covers that percentage of the values, otherwise they are the min and max of the values.
+  std::unordered_map<std::string, TensorRange> GetRanges(float percentile = 100.f) const;
+
+  void Reset();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CalibrationCollector);
+
+  struct Statistics {
+    float min{0.f};
+    float max{0.f};
+    // counts of |x| in num_bins_ bins of [0, abs_max]
+    std::vector<uint64_t> histogram;
+    float abs_max{0.f};
+    uint64_t count{0};
+  };
+
+  // Widens the histogram to cover [0, abs_max], moving the counts of the old bins to the new ones.
+  void Rebin(Statistics& statistics, float abs_max) const;
+
+  const size_t num_bins_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Statistics> statistics_;
+};
+}  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
 #include "core/common/status.h"
 #include "core/framework/tensor.h"
 
@@ -17,6 +19,15 @@ class IDataTransfer {
 
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   virtual common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const = 0;
+
+  struct SrcDstPair {
+    std::reference_wrapper<const Tensor> src;
+    std::reference_wrapper<Tensor> dst;
+  };
+
+  // Copies several tensors that all go between the same devices, which a data transfer may do as one transfer
+  // rather than one per tensor. Copies them one by one by default.
+  virtual common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs, int exec_queue_id) const;
 };
 
 class CPUDataTransfer : public IDataTransfer {
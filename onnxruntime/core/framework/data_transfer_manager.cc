@@ -3,6 +3,8 @@
 
 #include "core/framework/data_transfer_manager.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 using namespace common;
 
@@ -51,4 +53,54 @@ Status DataTransferManager::CopyTensor(const Tensor& src, Tensor& dst, int exec_
                          dst.Location().device.ToString());
 }
 
+Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs) const {
+  return CopyTensors(src_dst_pairs, 0);
+}
+
+Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs,
+                                        int exec_queue_id) const {
+  // group the pairs by the data transfer that copies them, keeping their order within a group
+  std::vector<std::pair<const IDataTransfer*, std::vector<IDataTransfer::SrcDstPair>>> groups;
+  for (const auto& pair : src_dst_pairs) {
+    const Tensor& src = pair.src;
+    const Tensor& dst = pair.dst;
+    if (src.Shape().Size() != dst.Shape().Size()) {
+      return Status(ONNXRUNTIME, FAIL, "Tensor size mismatch");
+    }
+
+    const auto* data_transfer = GetDataTransfer(src.Location().device, dst.Location().device);
+    if (data_transfer == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME,
+                             FAIL,
+                             "There's no data transfer registered for copying tensors from ",
+                             src.Location().device.ToString(),
+                             " to ",
+                             dst.Location().device.ToString());
+    }
+
+    auto group = std::find_if(groups.begin(), groups.end(),
+                              [data_transfer, &src, &dst](const decltype(groups)::value_type& g) {
+                                const auto& first = g.second.front();
+                                return g.first == data_transfer &&
+                                       first.src.get().Location().device == src.Location().device &&
+                                       first.dst.get().Location().device == dst.Location().device;
+                              });
+    if (group == groups.end()) {
+      groups.emplace_back(data_transfer, std::vector<IDataTransfer::SrcDstPair>{pair});
+    } else {
+      group->second.push_back(pair);
+    }
+  }
+
+  for (const auto& group : groups) {
+    if (group.second.size() == 1) {
+      const auto& pair = group.second.front();
+      ORT_RETURN_IF_ERROR(group.first->CopyTensor(pair.src, pair.dst, exec_queue_id));
+    } else {
+      ORT_RETURN_IF_ERROR(group.first->CopyTensors(group.second, exec_queue_id));
+    }
+  }
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
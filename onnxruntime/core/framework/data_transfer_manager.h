@@ -23,6 +23,10 @@ class DataTransferManager {
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const;
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const;
 
+  // Copies the tensors of each pair of devices together, see IDataTransfer::CopyTensors.
+  common::Status CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs) const;
+  common::Status CopyTensors(const std::vector<IDataTransfer::SrcDstPair>& src_dst_pairs, int exec_queue_id) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DataTransferManager);
 
@@ -3,8 +3,10 @@
 
 #include "core/framework/execution_frame.h"
 
+#include <algorithm>
 #include <sstream>
 
+#include "core/framework/bfc_arena.h"
 #include "core/framework/mem_pattern_planner.h"
 #include "core/framework/execution_plan_base.h"
 #include "core/framework/sequential_execution_plan.h"
@@ -35,6 +37,20 @@ IExecutionFrame::IExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, cons
 
 IExecutionFrame::~IExecutionFrame() = default;
 
+void IExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                            const std::unordered_map<int, OrtValue>& initializers,
+                            const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(feeds.size() == feed_mlvalue_idxs.size());
+  ORT_ENFORCE(fetches.empty() || fetches.size() == fetch_mlvalue_idxs.size());
+
+  fetch_mlvalue_idxs_.assign(fetch_mlvalue_idxs.cbegin(), fetch_mlvalue_idxs.cend());
+  Init(feed_mlvalue_idxs, feeds, initializers, fetches);
+}
+
+void IExecutionFrame::ReleaseAllValues() {
+  std::fill(all_values_.begin(), all_values_.end(), OrtValue());
+}
+
 // Return nullptr if index map to an value that is an unused optional input/output
 const OrtValue* IExecutionFrame::GetNodeInputOrOutputMLValue(int index) const {
   int ort_value_idx = GetNodeIdxToMLValueIdx(index);
@@ -174,6 +190,27 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       session_state_{session_state},
       mem_patterns_{nullptr},
       planner_{nullptr} {
+  SetCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+  SetMemoryPatterns(feeds, FindMemoryPatterns(session_state, feeds));
+}
+
+ExecutionFrame::~ExecutionFrame() = default;
+
+void ExecutionFrame::Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                           const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                           std::shared_ptr<const MemoryPatternGroup> mem_patterns) {
+  IExecutionFrame::Reset(feed_mlvalue_idxs, feeds, session_state_.GetInitializedTensors(), fetch_mlvalue_idxs,
+                         fetches);
+  SetCustomAllocators(fetch_mlvalue_idxs, fetch_allocators);
+  SetMemoryPatterns(feeds, std::move(mem_patterns));
+}
+
+void ExecutionFrame::SetCustomAllocators(
+    const std::vector<int>& fetch_mlvalue_idxs,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  custom_allocators_.clear();
+
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
     for (size_t idx = 0, end = fetch_mlvalue_idxs.size(); idx < end; ++idx) {
@@ -185,47 +222,69 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
       }
     }
   }
+}
 
-  // If the session enable memory pattern optimization
-  // and we have execution plan generated, try to setup
-  // memory pattern optimization.
-  if (session_state.GetEnableMemoryPattern() && session_state.GetExecutionPlan()) {
-    std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
-    bool all_tensors = true;
-    // Reserve mem to avoid re-allocation.
-    input_shapes.reserve(feeds.size());
-    for (const auto& feed : feeds) {
-      if (!(feed.IsTensor())) {
-        all_tensors = false;
-        break;
-      }
-      auto& tensor = feed.Get<Tensor>();
-      input_shapes.push_back(std::cref(tensor.Shape()));
-    }
+static bool AllTensors(const std::vector<OrtValue>& feeds) {
+  return std::all_of(feeds.cbegin(), feeds.cend(), [](const OrtValue& feed) { return feed.IsTensor(); });
+}
 
-    //if there are some traditional ml value type in inputs disable the memory pattern optimization.
-    if (all_tensors) {
-      mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
-      // if no existing patterns, generate one in this executionframe
-      if (!mem_patterns_) {
-        planner_ = std::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
-        // all the internal kernel's input/output tensors will be allocated on these buffer.
-        for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
-          ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
-          AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
-          void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
-                             ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
-                             : nullptr;
-          buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
-        }
+std::shared_ptr<const MemoryPatternGroup> ExecutionFrame::FindMemoryPatterns(const SessionState& session_state,
+                                                                             const std::vector<OrtValue>& feeds) {
+  if (!session_state.GetEnableMemoryPattern() || !session_state.GetExecutionPlan()) {
+    return nullptr;
+  }
+
+  // the patterns computed from the shapes in the graph when they are all known are used for every Run.
+  auto mem_patterns = session_state.GetStaticMemoryPatternGroup();
+  if (mem_patterns) {
+    return mem_patterns;
+  }
+
+  //if there are some traditional ml value type in inputs disable the memory pattern optimization.
+  if (!AllTensors(feeds)) {
+    return nullptr;
+  }
+
+  std::vector<std::reference_wrapper<const TensorShape>> input_shapes;
+  // Reserve mem to avoid re-allocation.
+  input_shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    input_shapes.push_back(std::cref(feed.Get<Tensor>().Shape()));
+  }
+
+  return session_state.GetMemoryPatternGroup(input_shapes);
+}
+
+void ExecutionFrame::SetMemoryPatterns(const std::vector<OrtValue>& feeds,
+                                       std::shared_ptr<const MemoryPatternGroup> mem_patterns) {
+  planner_.reset();
+
+  // the buffers of a frame from a previous Run are kept as long as it uses the same patterns
+  if (mem_patterns != mem_patterns_) {
+    buffers_.clear();
+    mem_patterns_ = std::move(mem_patterns);
+
+    if (mem_patterns_) {
+      // pre-allocate the big chunk requested in memory pattern.
+      // all the internal kernel's input/output tensors will be allocated on these buffer.
+      for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
+        ORT_ENFORCE(buffers_.find(mem_patterns_->locations[i]) == buffers_.end());
+        AllocatorPtr alloc = GetAllocator(mem_patterns_->locations[i]);
+        void* buffer = mem_patterns_->patterns[i].PeakSize() > 0
+                           ? alloc->Alloc(mem_patterns_->patterns[i].PeakSize())
+                           : nullptr;
+        buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffer, alloc);
       }
     }
   }
-}
 
-ExecutionFrame::~ExecutionFrame() = default;
+  // If the session enable memory pattern optimization and there are no existing patterns for the feeds,
+  // generate one in this executionframe
+  if (!mem_patterns_ && session_state_.GetEnableMemoryPattern() && session_state_.GetExecutionPlan() &&
+      AllTensors(feeds)) {
+    planner_ = std::make_unique<OrtValuePatternPlanner>(*session_state_.GetExecutionPlan());
+  }
+}
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
@@ -272,19 +331,19 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // a block larger than needed is fine as the pattern may have been traced with larger input shapes
+        // from the same dim bucket.
+        if (it != buffers_.end() && block->size_ >= size) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (block->size_ < size) {
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
-          // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
           LOGS_DEFAULT(VERBOSE) << "For ort_value with index: " << ort_value_index
                                 << ", block in memory pattern size is: " << block->size_
                                 << " but the actually size is: " << size
@@ -317,11 +376,16 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
   OrtValue& ort_value_reuse = GetMutableMLValue(ort_value_index_reuse);
 
   auto* reuse_tensor = ort_value_reuse.GetMutable<Tensor>();
-  auto buffer_num_elements = reuse_tensor->Shape().Size();
-  auto required_num_elements = shape.Size();
+  size_t buffer_size_in_bytes = reuse_tensor->SizeInBytes();
+  size_t required_size_in_bytes;
+  if (shape.Size() < 0 ||
+      !IAllocator::CalcMemSizeForArray(static_cast<size_t>(shape.Size()), element_type->Size(), &required_size_in_bytes)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Invalid shape to re-use buffer: ", shape);
+  }
 
-  // check number of elements matches. shape may not be an exact match (e.g. Reshape op)
-  if (buffer_num_elements != required_num_elements) {
+  // check number of bytes matches. shape and element type may not be an exact match (e.g. Reshape op,
+  // or the planner reusing a dead buffer of another element type)
+  if (buffer_size_in_bytes != required_size_in_bytes) {
     // could be an allocation planner bug (less likely) or the model incorrectly uses something like 'None'
     // as a dim_param, or -1 in dim_value in multiple places making the planner think those shapes are equal.
     auto message = onnxruntime::MakeString(
@@ -331,7 +395,7 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
         "dim_param (all values with the same string should equate to the same size) in shapes in the model.");
 
     // be generous and use the buffer if it's large enough. log a warning though as it indicates a bad model
-    if (buffer_num_elements >= required_num_elements) {
+    if (buffer_size_in_bytes >= required_size_in_bytes) {
       LOGS_DEFAULT(WARNING) << message;
     } else {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, message);
@@ -453,6 +517,45 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
   }
 }
 
+void ExecutionFrame::RecordMemoryEvent(const char* event, int ort_value_idx, const OrtValue& ort_value) {
+  if (!ort_value.IsAllocated() || !ort_value.IsTensor()) return;
+
+  const auto& tensor = ort_value.Get<Tensor>();
+  const auto& per_alloc_plan = GetAllocationPlan(ort_value_idx);
+  const auto& value_info = session_state_.GetOrtValueNamesAndProducers()[ort_value_idx];
+
+  std::ostringstream alloc_kind;
+  alloc_kind << per_alloc_plan.alloc_kind;
+
+  std::string reused;
+  if (per_alloc_plan.alloc_kind == AllocKind::kReuse || per_alloc_plan.alloc_kind == AllocKind::kShare) {
+    reused = session_state_.GetOrtValueNamesAndProducers()[per_alloc_plan.reused_buffer].first;
+  }
+
+  // the size of its block in the memory patterns is what the plan expects the tensor to take
+  std::string planned_bytes;
+  if (mem_patterns_) {
+    const auto* pattern = mem_patterns_->GetPatterns(tensor.Location());
+    const auto* block = pattern != nullptr ? pattern->GetBlock(ort_value_idx) : nullptr;
+    if (block != nullptr) planned_bytes = std::to_string(block->size_);
+  }
+
+  std::string arena_bytes_in_use;
+  const auto* arena = dynamic_cast<const BFCArena*>(GetAllocator(tensor.Location()).get());
+  if (arena != nullptr) arena_bytes_in_use = std::to_string(arena->Used());
+
+  TimePoint now = session_state_.Profiler().StartTime();
+  session_state_.Profiler().EndTimeAndRecordEvent(profiling::MEMORY_EVENT, value_info.first + "_" + event, now,
+                                                  {{"ort_value_index", std::to_string(ort_value_idx)},
+                                                   {"node", value_info.second},
+                                                   {"location", tensor.Location().name},
+                                                   {"alloc_kind", alloc_kind.str()},
+                                                   {"reused_value", reused},
+                                                   {"bytes", std::to_string(tensor.SizeInBytes())},
+                                                   {"planned_bytes", planned_bytes},
+                                                   {"arena_bytes_in_use", arena_bytes_in_use}});
+}
+
 AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtMemoryInfo& info) const {
   return utils::GetAllocator(session_state_, info);
 }
@@ -460,10 +563,18 @@ AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtMemoryInfo& info) const {
 // This method is not thread safe!
 // Return S_OK and nullptr if index map to an value that is an unused optional input/output
 Status ExecutionFrame::CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) {
-  return AllocateAsPerAllocationPlan(ort_value, ort_value_idx, shape, nnz);
+  ORT_RETURN_IF_ERROR(AllocateAsPerAllocationPlan(ort_value, ort_value_idx, shape, nnz));
+  if (session_state_.Profiler().IsEnabled()) {
+    RecordMemoryEvent("alloc", ort_value_idx, ort_value);
+  }
+  return Status::OK();
 }
 
 Status ExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
+  if (session_state_.Profiler().IsEnabled() && ort_value_idx >= 0 &&
+      static_cast<size_t>(ort_value_idx) < NumValues()) {
+    RecordMemoryEvent("free", ort_value_idx, GetMutableMLValue(ort_value_idx));
+  }
   ORT_RETURN_IF_ERROR(IExecutionFrame::ReleaseMLValueImpl(ort_value_idx));
   TraceFree(ort_value_idx);
   return Status::OK();
@@ -58,17 +58,27 @@ class IExecutionFrame {
 
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Release all the values so the frame doesn't hold on to the feeds and fetches of a finished Run.
+  void ReleaseAllValues();
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
 
   OrtValue& GetMutableMLValue(int ort_value_index) { return const_cast<OrtValue&>(GetMLValue(ort_value_index)); }
 
+  size_t NumValues() const { return all_values_size_; }
+
   virtual Status ReleaseMLValueImpl(int ort_value_idx);
 
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
+  // Re-initialize the frame for another Run. The values of the previous Run must have been released.
+  void Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::unordered_map<int, OrtValue>& initializers, const std::vector<int>& fetch_mlvalue_idxs,
+             const std::vector<OrtValue>& fetches);
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
 
@@ -94,7 +104,7 @@ class IExecutionFrame {
   // perf optimization to avoid calling all_values_.size() repeatedly as the size is fixed once constructed
   const size_t all_values_size_;
 
-  const std::vector<int> fetch_mlvalue_idxs_;
+  std::vector<int> fetch_mlvalue_idxs_;
 };
 
 class ExecutionFrame final : public IExecutionFrame {
@@ -107,6 +117,21 @@ class ExecutionFrame final : public IExecutionFrame {
 
   ~ExecutionFrame() override;
 
+  // Re-initialize a frame released by a previous Run, keeping the buffers of the memory patterns if
+  // mem_patterns are the ones the frame already uses.
+  void Reset(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+             const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+             std::shared_ptr<const MemoryPatternGroup> mem_patterns);
+
+  // Get the memory patterns a Run with the feeds would use. nullptr if there are none yet.
+  static std::shared_ptr<const MemoryPatternGroup> FindMemoryPatterns(const SessionState& session_state,
+                                                                      const std::vector<OrtValue>& feeds);
+
+  const MemoryPatternGroup* GetMemoryPatterns() const {
+    return mem_patterns_.get();
+  }
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -128,6 +153,11 @@ class ExecutionFrame final : public IExecutionFrame {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFrame);
 
+  void SetCustomAllocators(const std::vector<int>& fetch_mlvalue_idxs,
+                           const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+
+  void SetMemoryPatterns(const std::vector<OrtValue>& feeds, std::shared_ptr<const MemoryPatternGroup> mem_patterns);
+
   AllocatorPtr GetAllocatorImpl(const OrtMemoryInfo& info) const override;
   Status ReleaseMLValueImpl(int ort_value_idx) override;
   Status CreateNodeOutputMLValueImpl(OrtValue& ort_value, int ort_value_idx, const TensorShape* shape, size_t nnz) override;
@@ -145,6 +175,9 @@ class ExecutionFrame final : public IExecutionFrame {
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
+  // record the allocation or free of a tensor in the profile, with its place in the allocation plan
+  void RecordMemoryEvent(const char* event, int ort_value_idx, const OrtValue& ort_value);
+
   const AllocPlanPerValue& GetAllocationPlan(int ort_value_idx);
 
   const SessionState& session_state_;
@@ -155,7 +188,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "core/framework/execution_provider.h"
 
+#include "core/common/profiler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry_manager.h"
@@ -49,6 +50,16 @@ common::Status IExecutionProvider::OnRunStart() { return Status::OK(); }
 
 common::Status IExecutionProvider::OnRunEnd() { return Status::OK(); }
 
+std::unique_ptr<profiling::EpProfiler> IExecutionProvider::GetProfiler() { return nullptr; }
+
+common::Status IExecutionProvider::BeginGraphCapture() {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
+common::Status IExecutionProvider::EndGraphCapture(std::unique_ptr<CapturedGraph>& /*graph*/) {
+  return common::Status(common::ONNXRUNTIME, common::NOT_IMPLEMENTED);
+}
+
 void IExecutionProvider::InsertAllocator(AllocatorPtr allocator) {
   const OrtMemoryInfo& info = allocator->Info();
   const int key = MakeKey(info.id, info.mem_type);
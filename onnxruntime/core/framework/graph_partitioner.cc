@@ -2,6 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/graph_partitioner.h"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_set>
+
 #include "core/framework/kernel_registry_manager.h"
 #include "core/graph/function.h"
 #include "core/graph/graph_viewer.h"
@@ -10,6 +16,7 @@
 #include "core/framework/execution_providers.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/func_kernel.h"
+#include "core/framework/partition_cost_model.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
 //#define COUNT_NON_CUDA_OPS
@@ -105,6 +112,69 @@ static Node* PlaceNode(Graph& graph, std::unique_ptr<IndexedSubGraph> capability
   return nullptr;
 }
 
+void GraphPartitioner::RemoveUnprofitableCapabilities(
+    const Graph& graph, const GraphViewer& graph_viewer, const std::string& provider_type,
+    std::vector<std::unique_ptr<ComputeCapability>>& capabilities) const {
+  // the capabilities whose unassigned nodes are connected form an island, which is placed on the provider as a whole.
+  // an island with a node the CPU provider can't run is left to the provider, as without the cost model.
+  const size_t num_capabilities = capabilities.size();
+  std::vector<size_t> parent(num_capabilities);
+  std::iota(parent.begin(), parent.end(), size_t{0});
+  auto find_root = [&parent](size_t i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+
+  std::unordered_map<NodeIndex, size_t> node_to_capability;
+  for (size_t i = 0; i < num_capabilities; ++i) {
+    if (capabilities[i] == nullptr || capabilities[i]->sub_graph == nullptr) {
+      continue;
+    }
+    for (auto node_index : capabilities[i]->sub_graph->nodes) {
+      const Node* node = graph.GetNode(node_index);
+      if (node != nullptr && node->GetExecutionProviderType().empty()) {
+        node_to_capability.emplace(node_index, i);
+      }
+    }
+  }
+
+  for (const auto& entry : node_to_capability) {
+    const Node& node = *graph.GetNode(entry.first);
+    for (auto edge = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); edge != end; ++edge) {
+      auto consumer = node_to_capability.find(edge->GetNode().Index());
+      if (consumer != node_to_capability.cend()) {
+        parent[find_root(entry.second)] = find_root(consumer->second);
+      }
+    }
+  }
+
+  std::map<size_t, std::vector<NodeIndex>> islands;
+  std::unordered_set<size_t> keep;
+  for (const auto& entry : node_to_capability) {
+    const size_t root = find_root(entry.second);
+    islands[root].push_back(entry.first);
+    if (!kernel_registry_mgr_.HasImplementationOf(*graph.GetNode(entry.first), kCpuExecutionProvider)) {
+      keep.insert(root);
+    }
+  }
+
+  for (auto& island : islands) {
+    std::sort(island.second.begin(), island.second.end());
+    if (keep.count(island.first) == 0 && !cost_model_->ShouldPlace(graph_viewer, island.second, provider_type)) {
+      for (size_t i = 0; i < num_capabilities; ++i) {
+        if (capabilities[i] != nullptr && find_root(i) == island.first) {
+          capabilities[i].reset();
+        }
+      }
+    }
+  }
+
+  capabilities.erase(std::remove(capabilities.begin(), capabilities.end(), nullptr), capabilities.end());
+}
+
 Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const {
   // It is a greedy partitioning algorithm per provider preferences user provided when calling ONNX RUNTIME right now.
   // 1. Execution providers' capabilities are checked one by one.
@@ -143,11 +213,17 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
   // TODO: when the graph contain a function node, and user pass in the dll which could
   // run the function by SessionOption, we should create a function kernel for it and
   // delegate the compute to the functions inside the dlls.
+  const bool record_events = profiler_ != nullptr && profiler_->IsEnabled();
   for (auto& provider : providers_) {
+    auto tp = record_events ? profiler_->StartTime() : TimePoint{};
     int count = 0;
     std::vector<Node*> nodes_need_compile;
     std::vector<std::unique_ptr<ComputeCapability>> capabilities =
         provider->GetCapability(graph_viewer, kernel_registry_mgr_.GetKernelRegistriesByProviderType(provider->Type()));
+    const size_t num_capabilities = capabilities.size();
+    if (cost_model_ != nullptr && provider->Type() != kCpuExecutionProvider) {
+      RemoveUnprofitableCapabilities(graph, graph_viewer, provider->Type(), capabilities);
+    }
     for (auto& capability : capabilities) {
       Node* n = PlaceNode(graph, std::move(capability->sub_graph), kernel_registry_mgr_, provider->Type(), count);
       if (n != nullptr) {
@@ -179,6 +255,14 @@ Status GraphPartitioner::Partition(Graph& graph, bool export_dll, FuncManager& f
             builder, static_cast<KernelCreatePtrFn>([](const OpKernelInfo& info) -> OpKernel* { return new FunctionKernel(info); })));
       }
     }
+
+    if (record_events) {
+      profiler_->EndTimeAndRecordEvent(profiling::SESSION_EVENT, "partitioning_" + provider->Type(), tp,
+                                       {{"graph", graph.Name()},
+                                        {"capabilities", std::to_string(num_capabilities)},
+                                        {"placed_capabilities", std::to_string(capabilities.size())},
+                                        {"compiled_nodes", std::to_string(nodes_need_compile.size())}});
+    }
   }
 
   ORT_RETURN_IF_ERROR(graph.Resolve());
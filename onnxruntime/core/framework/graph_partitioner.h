@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/common/profiler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/fuse_nodes_funcs.h"
@@ -12,20 +13,35 @@ namespace onnxruntime {
 
 class ExecutionProviders;
 class KernelRegistryManager;
+class PartitionCostModel;
+struct ComputeCapability;
 
 class GraphPartitioner {
  public:
   //The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  //If profiler is enabled, the partitioning by each provider is recorded as an event.
+  //If cost_model is set, the nodes a provider other than CPU claims are only placed on it where the cost model
+  //estimates that it is faster than leaving them to the CPU provider, copies included.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   profiling::Profiler* profiler = nullptr, PartitionCostModel* cost_model = nullptr)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {}
+        providers_(providers),
+        profiler_(profiler),
+        cost_model_(cost_model) {}
 
   Status Partition(Graph& graph, bool export_dll, FuncManager& func_mgr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphPartitioner);
 
+  // drops the capabilities of the islands of nodes the cost model doesn't place on the provider.
+  void RemoveUnprofitableCapabilities(const Graph& graph, const GraphViewer& graph_viewer,
+                                      const std::string& provider_type,
+                                      std::vector<std::unique_ptr<ComputeCapability>>& capabilities) const;
+
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  profiling::Profiler* profiler_;
+  PartitionCostModel* cost_model_;
 };
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 #include "core/framework/kernel_registry.h"
@@ -111,8 +112,46 @@ class TypeBindingResolver {
   const Node& node_;
   std::unique_ptr<TypeBindingMap> type_binding_map_;
 };
+
+template <typename T>
+void AppendBytes(std::string& key, const T& value) {
+  char bytes[sizeof(T)];
+  memcpy(bytes, &value, sizeof(T));
+  key.append(bytes, sizeof(T));
+}
 };  // namespace
 
+std::string KernelRegistry::MakeOpKey(const std::string& domain, const std::string& op_type,
+                                      const std::string& provider) {
+  std::string key;
+  key.reserve(domain.size() + op_type.size() + provider.size() + 2);
+  key.append(domain).push_back('\0');
+  key.append(op_type).push_back('\0');
+  key.append(provider);
+  return key;
+}
+
+std::string KernelRegistry::MakeLookupKey(const onnxruntime::Node& node, const std::string& op_key) {
+  std::string key = op_key;
+  AppendBytes(key, node.Op()->since_version());
+  const auto& arg_counts = node.InputArgCount();
+  AppendBytes(key, arg_counts.size());
+  for (int count : arg_counts) {
+    AppendBytes(key, count);
+  }
+
+  // a missing optional argument has no type
+  auto append_types = [&key](const ConstPointerContainer<std::vector<NodeArg*>>& args) {
+    AppendBytes(key, args.size());
+    for (const NodeArg* arg : args) {
+      AppendBytes(key, arg->Exists() ? arg->Type() : nullptr);
+    }
+  };
+  append_types(node.InputDefs());
+  append_types(node.OutputDefs());
+  return key;
+}
+
 bool KernelRegistry::VerifyKernelDef(const onnxruntime::Node& node,
                                      const KernelDef& kernel_def,
                                      std::string& error_str,
@@ -214,6 +253,16 @@ Status KernelRegistry::Register(KernelDefBuilder& kernel_builder,
   return Register(KernelCreateInfo(kernel_builder.Build(), kernel_creator));
 }
 
+void KernelRegistry::AddEntry(KernelCreateInfo&& create_info) {
+  const KernelDef& kernel_def = *create_info.kernel_def;
+  auto entry = kernel_creator_fn_map_.emplace(kernel_def.OpName(), std::move(create_info));
+  kernels_by_op_[MakeOpKey(kernel_def.Domain(), kernel_def.OpName(), kernel_def.Provider())].push_back(&entry->second);
+
+  // a memoized lookup may not have seen the new kernel
+  std::lock_guard<OrtMutex> lock(lookup_mutex_);
+  lookup_cache_.clear();
+}
+
 Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
   auto& op_name = create_info.kernel_def->OpName();
 
@@ -229,14 +278,14 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
                      ": Conflicting with a registered kernel with op versions.");
       // For invalid entries, we keep them in the map now. Must check for status
       // when using the entries from the map.
-      kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+      AddEntry(std::move(create_info));
       return st;
     }
   }
 
   // Register the kernel.
   // Ownership of the KernelDef is transferred to the map.
-  kernel_creator_fn_map_.emplace(op_name, std::move(create_info));
+  AddEntry(std::move(create_info));
   return Status::OK();
 }
 
@@ -278,25 +327,54 @@ static std::string ToString(const std::vector<std::string>& error_strs) {
 // otherwise, kernel_def.provider must equal to node.provider. exec_provider is ignored.
 const KernelCreateInfo* KernelRegistry::TryFindKernel(const onnxruntime::Node& node,
                                                       onnxruntime::ProviderType exec_provider) const {
-  auto range = kernel_creator_fn_map_.equal_range(node.OpType());
+  const std::string& expected_provider =
+      (node.GetExecutionProviderType().empty() ? exec_provider : node.GetExecutionProviderType());
+  const std::string op_key = MakeOpKey(node.Domain(), node.OpType(), expected_provider);
+  auto candidates = kernels_by_op_.find(op_key);
+  if (candidates == kernels_by_op_.cend()) {
+    LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
+                       << " No kernel is registered for the domain '" << node.Domain() << "'";
+    return nullptr;
+  }
+
+  const std::string lookup_key = MakeLookupKey(node, op_key);
+  {
+    std::lock_guard<OrtMutex> lock(lookup_mutex_);
+    auto cached = lookup_cache_.find(lookup_key);
+    if (cached != lookup_cache_.cend()) {
+      return cached->second;
+    }
+  }
+
+  const KernelCreateInfo* result = nullptr;
   std::vector<std::string> error_strs;
-  for (auto i = range.first; i != range.second; ++i) {
-    if (!i->second.status.IsOK()) {
+  for (const KernelCreateInfo* create_info : candidates->second) {
+    if (!create_info->status.IsOK()) {
       LOGS_DEFAULT(ERROR) << "Failed to create kernel for op: " << node.OpType()
                           << " since it was ill-formed during registration";
       continue;
     }
     std::string error_str;
-    if (VerifyKernelDef(node, *i->second.kernel_def, error_str, exec_provider)) {
-      return &i->second;
+    if (VerifyKernelDef(node, *create_info->kernel_def, error_str, exec_provider)) {
+      result = create_info;
+      break;
     }
     error_strs.push_back(error_str);
   }
-  std::string expected_provider =
-      (node.GetExecutionProviderType().empty() ? exec_provider : node.GetExecutionProviderType());
-  LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
-                     << " Encountered following errors: " << ToString(error_strs);
-  return nullptr;
+
+  if (result == nullptr) {
+    LOGS_DEFAULT(INFO) << node.OpType() << " kernel is not supported in " << expected_provider
+                       << " Encountered following errors: " << ToString(error_strs);
+  }
+
+  std::lock_guard<OrtMutex> lock(lookup_mutex_);
+  lookup_cache_.emplace(lookup_key, result);
+  return result;
+}
+
+size_t KernelRegistry::NumCachedLookups() const {
+  std::lock_guard<OrtMutex> lock(lookup_mutex_);
+  return lookup_cache_.size();
 }
 
 }  // namespace onnxruntime
@@ -12,10 +12,23 @@ Memcpy::Memcpy(const OpKernelInfo& info)
 }
 
 Status Memcpy::Compute(OpKernelContext* ctx) const {
-  const auto* X = ctx->Input<Tensor>(0);
-  Tensor* Y = ctx->Output(0, X->Shape());
-  Status retval = Info().GetDataTransferManager().CopyTensor(*X, *Y, Info().GetKernelDef().ExecQueueId());
-  return retval;
+  const int num_inputs = ctx->InputCount();
+  if (num_inputs == 1) {
+    const auto* X = ctx->Input<Tensor>(0);
+    Tensor* Y = ctx->Output(0, X->Shape());
+    return Info().GetDataTransferManager().CopyTensor(*X, *Y, Info().GetKernelDef().ExecQueueId());
+  }
+
+  // the tensors that cross devices at the same point are copied together
+  std::vector<IDataTransfer::SrcDstPair> copy_pairs;
+  copy_pairs.reserve(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    const auto* X = ctx->Input<Tensor>(i);
+    ORT_ENFORCE(X != nullptr, "Memcpy input ", i, " is missing.");
+    Tensor* Y = ctx->Output(i, X->Shape());
+    copy_pairs.push_back({*X, *Y});
+  }
+  return Info().GetDataTransferManager().CopyTensors(copy_pairs, Info().GetKernelDef().ExecQueueId());
 }
 
 }  // namespace onnxruntime
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_stats_recorder.h"
+
+namespace onnxruntime {
+
+NodeStatsRecorder::NodeStatsRecorder(size_t num_nodes)
+    : num_nodes_(num_nodes), counters_(new Counters[num_nodes]) {
+}
+
+void NodeStatsRecorder::Record(NodeIndex node_index, uint64_t duration_ns, uint64_t output_bytes) {
+  if (node_index >= num_nodes_) return;
+
+  auto& counters = counters_[node_index];
+  counters.count.fetch_add(1, std::memory_order_relaxed);
+  counters.total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+  counters.output_bytes.fetch_add(output_bytes, std::memory_order_relaxed);
+
+  uint64_t min_ns = counters.min_ns.load(std::memory_order_relaxed);
+  while (duration_ns < min_ns &&
+         !counters.min_ns.compare_exchange_weak(min_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+
+  uint64_t max_ns = counters.max_ns.load(std::memory_order_relaxed);
+  while (duration_ns > max_ns &&
+         !counters.max_ns.compare_exchange_weak(max_ns, duration_ns, std::memory_order_relaxed)) {
+  }
+}
+
+std::vector<NodeStats> NodeStatsRecorder::GetStats() const {
+  std::vector<NodeStats> stats(num_nodes_);
+  for (size_t i = 0; i < num_nodes_; ++i) {
+    const auto& counters = counters_[i];
+    auto& node_stats = stats[i];
+    node_stats.node_index = i;
+    node_stats.count = counters.count.load(std::memory_order_relaxed);
+    node_stats.total_ns = counters.total_ns.load(std::memory_order_relaxed);
+    node_stats.max_ns = counters.max_ns.load(std::memory_order_relaxed);
+    node_stats.output_bytes = counters.output_bytes.load(std::memory_order_relaxed);
+    const uint64_t min_ns = counters.min_ns.load(std::memory_order_relaxed);
+    node_stats.min_ns = min_ns == UINT64_MAX ? 0 : min_ns;
+  }
+  return stats;
+}
+
+void NodeStatsRecorder::Reset() {
+  for (size_t i = 0; i < num_nodes_; ++i) {
+    auto& counters = counters_[i];
+    counters.count.store(0, std::memory_order_relaxed);
+    counters.total_ns.store(0, std::memory_order_relaxed);
+    counters.min_ns.store(UINT64_MAX, std::memory_order_relaxed);
+    counters.max_ns.store(0, std::memory_order_relaxed);
+    counters.output_bytes.store(0, std::memory_order_relaxed);
+  }
+}
+}  // namespace onnxruntime
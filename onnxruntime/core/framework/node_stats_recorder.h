@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+// Statistics of the executions of a node.
+struct NodeStats {
+  NodeIndex node_index{0};
+  // filled in by InferenceSession::GetNodeStats
+  std::string node_name;
+  std::string op_type;
+
+  uint64_t count{0};
+  // kernel time in nanoseconds. min is 0 if the node hasn't run.
+  uint64_t total_ns{0};
+  uint64_t min_ns{0};
+  uint64_t max_ns{0};
+  // bytes of the tensors the node output, which the execution frame allocates unless it reuses a buffer
+  uint64_t output_bytes{0};
+};
+
+// NodeStatsRecorder aggregates the kernel time of every node of a graph in counters preallocated per NodeIndex.
+// Unlike the Profiler it records no event and takes no lock, so it's cheap enough to be left on in production.
+// Record is safe to call concurrently, and the statistics can be read at any time while Runs update them.
+class NodeStatsRecorder {
+ public:
+  explicit NodeStatsRecorder(size_t num_nodes);
+
+  void Record(NodeIndex node_index, uint64_t duration_ns, uint64_t output_bytes);
+
+  // Returns the statistics indexed by NodeIndex. The counters of a node are read one by one, so they may be off
+  // by a Run being recorded at the same time.
+  std::vector<NodeStats> GetStats() const;
+
+  void Reset();
+
+  size_t NumNodes() const { return num_nodes_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NodeStatsRecorder);
+
+  struct Counters {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> min_ns{UINT64_MAX};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> output_bytes{0};
+  };
+
+  const size_t num_nodes_;
+  std::unique_ptr<Counters[]> counters_;
+};
+}  // namespace onnxruntime
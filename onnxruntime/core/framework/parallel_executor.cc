@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -12,6 +13,7 @@
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
+#include "core/framework/node_stats_recorder.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
 #include "core/platform/threadpool.h"
@@ -19,9 +21,12 @@
 namespace onnxruntime {
 
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_{terminate_flag}, executor_pool_(session_state.GetInterOpThreadPool()) {
+    : node_refs_(session_state.GetGraphViewer()->MaxNodeIndex()),
+      out_standings_(0),
+      has_errors_(false),
+      terminate_flag_{terminate_flag},
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
   for (auto& node : graph_viewer->Nodes()) {
     node_refs_[node.Index()] = node.GetInputEdgesCount();
   }
@@ -41,15 +46,18 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   root_frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
                                                  fetch_allocators, session_state);
   //std::cout << "start nodes:" << std::endl;
+  std::vector<size_t> root_nodes;
   for (auto node_index : session_state.GetGraphViewer()->GetRootNodes()) {
     auto p_op_kernel = session_state.GetKernel(node_index);
     if (!p_op_kernel)
       continue;
 
     //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
-    EnqueueNode(node_index, session_state, logger);
+    root_nodes.push_back(node_index);
   }
 
+  EnqueueNodes(root_nodes, session_state, logger);
+
   // Wait for finish.
   {
     std::unique_lock<OrtMutex> lock(complete_mutex_);
@@ -119,8 +127,14 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
   auto graph_viewer = session_state.GetGraphViewer();
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
+  TimePoint node_stats_begin_time;
   const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  NodeStatsRecorder* const node_stats_recorder = session_state.GetNodeStatsRecorder();
+  CalibrationCollector* const calibration_collector = session_state.GetCalibrationCollector();
+  profiling::EpProfiler* ep_profiler = nullptr;
+  size_t ep_kernel_id = 0;
   const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  std::vector<size_t> ready_nodes;
 
   // Avoid context switching if possible.
   while (keep_running) {
@@ -130,6 +144,10 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
       ORT_THROW("Exiting due to terminate flag being set to true.");
     }
+    if (concurrency::ThreadPool::DeadlineExceeded()) {
+      LOGS(logger, WARNING) << "Exiting due to the deadline of the Run being exceeded.";
+      return utils::DeadlineExceededStatus();
+    }
 
     const auto* p_op_kernel = session_state.GetKernel(node_index);
     const auto& node = *graph_viewer->GetNode(node_index);
@@ -184,11 +202,20 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
                                                      {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
       kernel_begin_time = session_state.Profiler().StartTime();
+
+      ep_profiler = session_state.Profiler().GetEpProfiler(node.GetExecutionProviderType());
+      if (ep_profiler != nullptr) {
+        ep_kernel_id = ep_profiler->Start();
+      }
     }
 
     // call compute on the kernel
     VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
+    if (node_stats_recorder != nullptr) {
+      node_stats_begin_time = std::chrono::high_resolution_clock::now();
+    }
+
     // Execute the kernel.
     try {
       status = p_op_kernel->Compute(&op_kernel_context);
@@ -196,6 +223,12 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
     }
 
+    // the parallel loops of the kernel skip their remaining blocks once the deadline has passed, so its
+    // outputs can't be used
+    if (status.IsOK() && concurrency::ThreadPool::DeadlineExceeded()) {
+      status = utils::DeadlineExceededStatus();
+    }
+
     if (!status.IsOK()) {
       std::ostringstream ss;
       ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
@@ -206,11 +239,32 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
       break;
     }
 
+    if (node_stats_recorder != nullptr) {
+      const auto duration = std::chrono::high_resolution_clock::now() - node_stats_begin_time;
+      node_stats_recorder->Record(node_index,
+                                  std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                  utils::GetOutputTensorBytes(op_kernel_context));
+    }
+
+    if (calibration_collector != nullptr) {
+      utils::CollectOutputRanges(*calibration_collector, op_kernel_context, p_op_kernel->Node());
+    }
+
     if (f_profiler_enabled) {
+      const std::string input_shapes = utils::GetInputShapes(op_kernel_context);
+      if (ep_profiler != nullptr) {
+        ep_profiler->Stop(ep_kernel_id, node.Name() + "_device_kernel_time",
+                          {{"op_name", p_op_kernel->KernelDef().OpName()},
+                           {"provider", p_op_kernel->KernelDef().Provider()},
+                           {"input_shapes", input_shapes}});
+      }
+
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      node.Name() + "_kernel_time",
                                                      kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+                                                     {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                      {"provider", p_op_kernel->KernelDef().Provider()},
+                                                      {"input_shapes", input_shapes}});
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -250,43 +304,63 @@ Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
     keep_running = false;
 
     // Checking which output nodes ready for running.
-    {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
-
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
-        }
-
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+    ready_nodes.clear();
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      auto idx = (*it).GetNode().Index();
+      if (--node_refs_[idx] == 0) {
+        ready_nodes.push_back(idx);
       }
     }
+
+    if (!ready_nodes.empty()) {
+      // Continue on this thread with the ready node that is furthest from the graph outputs, and hand the
+      // rest to the thread pool where idle workers can steal them.
+      auto next = std::max_element(ready_nodes.cbegin(), ready_nodes.cend(), [&exec_plan](size_t a, size_t b) {
+        return exec_plan.NodePriority(a) < exec_plan.NodePriority(b);
+      });
+      node_index = *next;
+      keep_running = true;
+      ready_nodes.erase(next);
+      EnqueueNodes(ready_nodes, session_state, logger);
+    }
   }
 
   return status;
 }
 
-void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
-  {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
+void ParallelExecutor::EnqueueNodes(std::vector<size_t>& ready_nodes, const SessionState& session_state,
+                                    const logging::Logger& logger) {
+  if (ready_nodes.empty())
+    return;
+
+  // When called from a worker thread the tasks go onto that worker's own queue, which it pops most recently
+  // scheduled first while idle workers steal from the opposite end. Schedule in increasing priority order so the
+  // node on the longest remaining path is picked up first.
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+  std::sort(ready_nodes.begin(), ready_nodes.end(), [&exec_plan](size_t a, size_t b) {
+    return exec_plan.NodePriority(a) < exec_plan.NodePriority(b);
+  });
 
-    out_standings_++;
+  for (auto node_index : ready_nodes) {
+    EnqueueNode(node_index, session_state, logger);
   }
+}
+
+void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
+  // if there are errors there's no point queuing more work
+  if (has_errors_)
+    return;
+
+  out_standings_++;
+
+  // the intra-op parallelism limit and the deadline of the Run apply to the nodes run on the inter-op threads too
+  const int parallelism_limit = concurrency::ThreadPool::CurrentParallelismLimit();
+  const auto deadline = concurrency::ThreadPool::CurrentDeadline();
+
+  executor_pool_->Schedule([this, p_node_index, parallelism_limit, deadline, &session_state, &logger]() {
+    concurrency::ThreadPool::ScopedParallelismLimit scoped_parallelism_limit(parallelism_limit);
+    concurrency::ThreadPool::ScopedDeadline scoped_deadline(deadline);
 
-  executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
     auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
       const auto* node = session_state.GetGraphViewer()->GetNode(p_node_index);
 
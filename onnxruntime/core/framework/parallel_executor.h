@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <condition_variable>
 #include "core/common/common.h"
@@ -36,29 +37,33 @@ class ParallelExecutor : public IExecutor {
 
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
+  void EnqueueNodes(std::vector<size_t>& ready_nodes, const SessionState& session_state,
+                    const logging::Logger& logger);
+
   void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
+    if (!status.IsOK()) {
       std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
+      errors_.push_back(status);
+      has_errors_ = true;
     }
 
-    if (finished) {
+    if (--out_standings_ == 0) {
+      // Take the lock so the notification can't slip in between the waiter testing out_standings_ and
+      // going to sleep.
+      std::lock_guard<OrtMutex> lock(complete_mutex_);
       //std::cout << "all out standing nodes are completed." << std::endl;
       complete_cv_.notify_all();
     }
   }
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+  // Number of inputs still to be produced for each node. A node is ready once its count drops to zero.
+  std::vector<std::atomic<size_t>> node_refs_;
+  std::atomic<int> out_standings_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::atomic<bool> has_errors_;
+  std::vector<Status> errors_;  //protected by complete_mutex_
 
   const bool& terminate_flag_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/partition_cost_model.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+static const char* const kCostModelFileHeader = "ort_partition_cost_model 1";
+
+// number of elements of the value, or a negative value if its shape isn't known.
+static double ElementCount(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return -1.0;
+  }
+  double count = 1.0;
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() < 0) {
+      return -1.0;
+    }
+    count *= static_cast<double>(dim.dim_value());
+  }
+  return count;
+}
+
+static int64_t DimValue(const NodeArg& arg, int index) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return -1;
+  }
+  // a negative index counts from the last dimension
+  const int dim_index = index < 0 ? shape->dim_size() + index : index;
+  if (dim_index < 0 || dim_index >= shape->dim_size()) {
+    return -1;
+  }
+  const auto& dim = shape->dim(dim_index);
+  return dim.has_dim_value() ? dim.dim_value() : -1;
+}
+
+// size in bytes of an element of the value, or 0 if it isn't a tensor of a fixed size type.
+static size_t ElementSize(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return 0;
+  }
+  switch (type->tensor_type().elem_type()) {
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+      return 1;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      return 4;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+double PartitionCostModel::EstimateFlops(const Node& node) {
+  const auto& inputs = node.InputDefs();
+  const auto& outputs = node.OutputDefs();
+  if (outputs.empty() || inputs.empty() || !inputs[0]->Exists()) {
+    return -1.0;
+  }
+
+  const double output_count = ElementCount(*outputs[0]);
+  if (output_count < 0) {
+    return -1.0;
+  }
+
+  const std::string& op_type = node.OpType();
+  if ((op_type == "MatMul" || op_type == "Gemm" || op_type == "FusedGemm") && inputs.size() >= 2) {
+    // each output element is a dot product over the reduced dimension of A
+    int64_t k;
+    if (op_type == "MatMul") {
+      k = DimValue(*inputs[0], -1);
+    } else {
+      const double a_count = ElementCount(*inputs[0]);
+      const int64_t m = DimValue(*outputs[0], 0);
+      k = a_count < 0 || m <= 0 ? -1 : static_cast<int64_t>(a_count) / m;
+    }
+    return k < 0 ? -1.0 : 2.0 * output_count * static_cast<double>(k);
+  }
+
+  if ((op_type == "Conv" || op_type == "FusedConv" || op_type == "ConvTranspose") && inputs.size() >= 2) {
+    // each element of the output of Conv, or of the input of ConvTranspose, is a dot product over one filter
+    const double weight_count = ElementCount(*inputs[1]);
+    const int64_t filters = DimValue(*inputs[1], 0);
+    const double count = op_type == "ConvTranspose" ? ElementCount(*inputs[0]) : output_count;
+    if (weight_count < 0 || filters <= 0 || count < 0) {
+      return -1.0;
+    }
+    return 2.0 * count * weight_count / static_cast<double>(filters);
+  }
+
+  // an operation per element of the larger of the first input and the first output, which covers the element-wise
+  // ops as well as the reductions
+  const double input_count = ElementCount(*inputs[0]);
+  if (input_count < 0) {
+    return -1.0;
+  }
+  return std::max(input_count, output_count);
+}
+
+bool PartitionCostModel::EstimateTimes(const GraphViewer& graph, const std::vector<NodeIndex>& island,
+                                       double& provider_time, double& cpu_time) const {
+  const std::unordered_set<NodeIndex> island_nodes(island.cbegin(), island.cend());
+  std::unordered_set<std::string> produced;
+  for (NodeIndex index : island) {
+    for (const auto* output : graph.GetNode(index)->OutputDefs()) {
+      produced.insert(output->Name());
+    }
+  }
+
+  std::unordered_set<std::string> graph_outputs;
+  for (const auto* output : graph.GetOutputs()) {
+    graph_outputs.insert(output->Name());
+  }
+
+  const auto& initializers = graph.GetAllInitializedTensors();
+  std::unordered_set<const NodeArg*> copied;
+  provider_time = 0.0;
+  cpu_time = 0.0;
+
+  for (NodeIndex index : island) {
+    const Node& node = *graph.GetNode(index);
+    const double flops = EstimateFlops(node);
+    if (flops < 0) {
+      return false;
+    }
+    cpu_time += flops / costs_.cpu_flops_per_us;
+    provider_time += flops / (costs_.cpu_flops_per_us * costs_.device_speedup) + costs_.kernel_launch_us;
+
+    // the initializers are copied to the device once, when the session is initialized
+    for (const auto* input : node.InputDefs()) {
+      if (input->Exists() && produced.count(input->Name()) == 0 && initializers.count(input->Name()) == 0) {
+        copied.insert(input);
+      }
+    }
+
+    for (auto edge = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); edge != end; ++edge) {
+      if (island_nodes.count(edge->GetNode().Index()) == 0) {
+        copied.insert(node.OutputDefs()[edge->GetSrcArgIndex()]);
+      }
+    }
+    for (const auto* output : node.OutputDefs()) {
+      if (graph_outputs.count(output->Name()) != 0) {
+        copied.insert(output);
+      }
+    }
+  }
+
+  for (const auto* arg : copied) {
+    const double count = ElementCount(*arg);
+    const size_t element_size = ElementSize(*arg);
+    if (count < 0 || element_size == 0) {
+      return false;
+    }
+    provider_time += costs_.copy_latency_us + count * element_size / costs_.copy_bytes_per_us;
+  }
+
+  return true;
+}
+
+bool PartitionCostModel::ShouldPlace(const GraphViewer& graph, const std::vector<NodeIndex>& island,
+                                     const std::string& provider_type) {
+  auto key = [&graph](NodeIndex index) { return graph.Name() + "/" + std::to_string(index); };
+
+  // reuse a loaded decision if it covers the whole island with the same op types and provider
+  bool cached = !island.empty();
+  bool place = true;
+  for (NodeIndex index : island) {
+    auto entry = decisions_.find(key(index));
+    if (entry == decisions_.cend() || entry->second.op_type != graph.GetNode(index)->OpType() ||
+        entry->second.provider_type != provider_type) {
+      cached = false;
+      break;
+    }
+    place = place && entry->second.place;
+  }
+
+  if (!cached) {
+    double provider_time = 0.0;
+    double cpu_time = 0.0;
+    place = !EstimateTimes(graph, island, provider_time, cpu_time) || provider_time < cpu_time;
+  }
+
+  for (NodeIndex index : island) {
+    decisions_[key(index)] = Decision{graph.GetNode(index)->OpType(), provider_type, place};
+  }
+  return place;
+}
+
+Status PartitionCostModel::Load(const std::basic_string<ORTCHAR_T>& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string line;
+  if (!std::getline(file, line) || line != kCostModelFileHeader) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The partitioning cost file ", ToMBString(path),
+                           " is not a file written by the cost based partitioning.");
+  }
+
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string key;
+    Decision decision;
+    std::string place;
+    if (!std::getline(fields, key, '\t') || !std::getline(fields, decision.op_type, '\t') ||
+        !std::getline(fields, decision.provider_type, '\t') || !std::getline(fields, place) ||
+        (place != "0" && place != "1")) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid line in the partitioning cost file ",
+                             ToMBString(path), ": ", line);
+    }
+    decision.place = place == "1";
+    decisions_[key] = decision;
+  }
+  return Status::OK();
+}
+
+Status PartitionCostModel::Save(const std::basic_string<ORTCHAR_T>& path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the partitioning cost file ", ToMBString(path));
+  }
+
+  file << kCostModelFileHeader << "\n";
+  for (const auto& entry : decisions_) {
+    file << entry.first << "\t" << entry.second.op_type << "\t" << entry.second.provider_type << "\t"
+         << (entry.second.place ? "1" : "0") << "\n";
+  }
+  return file.good() ? Status::OK()
+                     : ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write the partitioning cost file ",
+                                       ToMBString(path));
+}
+
+}  // namespace onnxruntime
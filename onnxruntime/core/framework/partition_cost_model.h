@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/basic_types.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+class Node;
+
+/**
+@class PartitionCostModel
+
+Decides, for the cost based mode of GraphPartitioner, whether an island of nodes claimed by an execution provider
+other than CPU is worth placing on it, or should be left to the CPU execution provider. An island is a connected
+group of the nodes the provider claims. It is placed when the estimated time of its nodes on the provider, plus the
+copies of the values that cross its boundary, is lower than the estimated time of its nodes on CPU.
+
+The estimates need the shapes of the values of the island. An island with a value of unknown shape, such as one
+depending on a free dimension that SessionOptions::free_dimension_overrides doesn't set, is always placed, as the
+partitioning without the cost model would.
+
+The decisions can be saved to a file and loaded for later sessions of the same model, which then reuse them instead
+of estimating the costs again.
+*/
+class PartitionCostModel {
+ public:
+  struct Costs {
+    // throughput of the CPU execution provider, in floating point operations per microsecond
+    double cpu_flops_per_us = 10000.0;
+    // how many times faster than CPU the other execution providers run the same operations
+    double device_speedup = 10.0;
+    // fixed cost of running a node on the other execution providers, in microseconds
+    double kernel_launch_us = 10.0;
+    // fixed cost of a copy between CPU and another execution provider, in microseconds, and its throughput
+    double copy_latency_us = 20.0;
+    double copy_bytes_per_us = 5000.0;
+  };
+
+  PartitionCostModel() = default;
+  explicit PartitionCostModel(const Costs& costs) : costs_(costs) {}
+
+  /** Returns whether the island of graph claimed by provider_type should be placed on it. */
+  bool ShouldPlace(const GraphViewer& graph, const std::vector<NodeIndex>& island, const std::string& provider_type);
+
+  /**
+  Estimated floating point operations of node, from the shapes of its inputs and outputs, or a negative value if
+  a shape isn't known.
+  */
+  static double EstimateFlops(const Node& node);
+
+  /** Loads the decisions saved by Save. A missing file is not an error, there is nothing to reuse yet. */
+  Status Load(const std::basic_string<ORTCHAR_T>& path);
+
+  /** Saves the decisions of this model and the ones it loaded. */
+  Status Save(const std::basic_string<ORTCHAR_T>& path) const;
+
+  size_t NumDecisions() const { return decisions_.size(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PartitionCostModel);
+
+  struct Decision {
+    std::string op_type;
+    std::string provider_type;
+    bool place;
+  };
+
+  // estimated time of the island on provider_type and on CPU, in microseconds. false if a shape isn't known.
+  bool EstimateTimes(const GraphViewer& graph, const std::vector<NodeIndex>& island,
+                     double& provider_time, double& cpu_time) const;
+
+  Costs costs_;
+  // keyed by the name of the graph and the index of the node, ordered so the saved files are stable
+  std::map<std::string, Decision> decisions_;
+};
+
+}  // namespace onnxruntime
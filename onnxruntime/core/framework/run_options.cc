@@ -53,3 +53,35 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   options->terminate = false;
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetIntraOpNumThreads, _Inout_ OrtRunOptions* options, int value) {
+  if (value < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "intra_op_num_threads must be >= 0");
+  }
+  options->intra_op_num_threads = value;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsGetIntraOpNumThreads, _In_ const OrtRunOptions* options, int* out) {
+  *out = options->intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetTimeout, _Inout_ OrtRunOptions* options, int64_t timeout_us) {
+  if (timeout_us < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "timeout_us must be >= 0");
+  }
+  options->deadline = timeout_us == 0 ? std::chrono::steady_clock::time_point::max()
+                                      : std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetPriority, _Inout_ OrtRunOptions* options, int value) {
+  options->priority = value;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsGetPriority, _In_ const OrtRunOptions* options, int* out) {
+  *out = options->priority;
+  return nullptr;
+}
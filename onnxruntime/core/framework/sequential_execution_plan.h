@@ -69,6 +69,11 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   // Records whether a given node has fence on its input or output, key is node index.
   std::vector<bool> node_has_fence;
 
+  // Records the critical-path priority of a given node, key is node index. This is the number of nodes on
+  // the longest path from the node to any graph output, including the node itself. The parallel executor
+  // uses it to decide which ready node to run next.
+  std::vector<size_t> node_priority;
+
   // to_be_freed: vector elements represent indices of ml-values to be freed (as described above)
   std::vector<OrtValueIndex> to_be_freed;
 
@@ -92,6 +97,11 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
   bool NodeHasFence(onnxruntime::NodeIndex node_index) const {
     return node_has_fence[node_index];
   }
+
+  // Critical-path priority of a given node. Nodes with a higher priority should be run first.
+  size_t NodePriority(onnxruntime::NodeIndex node_index) const {
+    return node_priority[node_index];
+  }
 };
 
 // Output details of an execution plan:
@@ -12,7 +12,9 @@
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/session_state.h"
+#include "core/framework/node_stats_recorder.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/shape_subgraph_cache.h"
 #include "core/framework/utils.h"
 
 // Define this symbol to create Concurrency Visualizer markers.
@@ -32,6 +34,16 @@ static Status ReleaseNodeMLValues(ExecutionFrame& frame,
                                   const SequentialExecutionPlan::NodeExecutionPlan& node_exec_plan,
                                   const logging::Logger& logger);
 
+namespace {
+// returns the frame to the session state for the next Run on every exit path of Execute
+struct ExecutionFrameReleaser {
+  const SessionState* session_state;
+  void operator()(ExecutionFrame* frame) const {
+    session_state->ReleaseExecutionFrame(std::unique_ptr<ExecutionFrame>(frame));
+  }
+};
+}  // namespace
+
 Status SequentialExecutor::Execute(const SessionState& session_state, const std::vector<int>& feed_mlvalue_idxs,
                                    const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs,
                                    std::vector<OrtValue>& fetches,
@@ -41,12 +53,27 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   TimePoint tp;
   TimePoint sync_time_begin;
   TimePoint kernel_begin_time;
+  TimePoint node_stats_begin_time;
+  NodeStatsRecorder* const node_stats_recorder = session_state.GetNodeStatsRecorder();
+  CalibrationCollector* const calibration_collector = session_state.GetCalibrationCollector();
+  ShapeSubgraphCache* const shape_subgraph_cache = session_state.GetShapeSubgraphCache();
+  ShapeSubgraphCache::RunState shape_run_state(shape_subgraph_cache);
+  profiling::EpProfiler* ep_profiler = nullptr;
+  size_t ep_kernel_id = 0;
 
   if (is_profiler_enabled) {
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  std::unique_ptr<ExecutionFrame, ExecutionFrameReleaser> p_frame{
+      session_state.AcquireExecutionFrame(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators)
+          .release(),
+      ExecutionFrameReleaser{&session_state}};
+  ExecutionFrame& frame = *p_frame;
+
+  // keep the intra-op threads waiting for the loops of the kernels between the nodes, instead of letting them
+  // go back to sleep after each node. nested subgraphs run in the section of the outermost Run.
+  concurrency::ThreadPool::ParallelSection parallel_section(session_state.GetThreadPool());
 
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
@@ -73,6 +100,10 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
     }
+    if (concurrency::ThreadPool::DeadlineExceeded()) {
+      LOGS(logger, WARNING) << "Exiting due to the deadline of the Run being exceeded.";
+      return utils::DeadlineExceededStatus();
+    }
 
     auto node_index = node_exec_plan.node_index;
     const auto& node = *graph_viewer->GetNode(node_exec_plan.node_index);
@@ -143,6 +174,15 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       VLOGS(logger, 1) << "Computing kernel: " << p_op_kernel->Node().Name();
 
       kernel_begin_time = session_state.Profiler().StartTime();
+
+      ep_profiler = session_state.Profiler().GetEpProfiler(p_op_kernel->Node().GetExecutionProviderType());
+      if (ep_profiler != nullptr) {
+        ep_kernel_id = ep_profiler->Start();
+      }
+    }
+
+    if (node_stats_recorder != nullptr) {
+      node_stats_begin_time = std::chrono::high_resolution_clock::now();
     }
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -150,11 +190,32 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
       diagnostic::span span(series, "%s.%d", node.OpType().c_str(), node.Index());
 #endif
       Status compute_status;
+      const bool is_cached_node = shape_subgraph_cache != nullptr && shape_subgraph_cache->IsCached(node_index);
+      bool restored = false;
+      if (is_cached_node) {
+        compute_status = shape_subgraph_cache->TryRestore(node_index, op_kernel_context, shape_run_state, restored);
+      }
+
+      if (!restored && compute_status.IsOK()) {
+        try {
+          compute_status = p_op_kernel->Compute(&op_kernel_context);
+        } catch (const std::exception& ex) {
+          compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        }
 
-      try {
-        compute_status = p_op_kernel->Compute(&op_kernel_context);
-      } catch (const std::exception& ex) {
-        compute_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        // the parallel loops of the kernel skip their remaining blocks once the deadline has passed, so its
+        // outputs can't be used
+        if (compute_status.IsOK() && concurrency::ThreadPool::DeadlineExceeded()) {
+          compute_status = utils::DeadlineExceededStatus();
+        }
+
+        if (is_cached_node && compute_status.IsOK()) {
+          shape_subgraph_cache->Store(node_index, op_kernel_context, shape_run_state);
+        }
+      }
+
+      if (shape_subgraph_cache != nullptr && compute_status.IsOK() && shape_subgraph_cache->IsRoot(node_index)) {
+        shape_subgraph_cache->RecordRoot(node_index, op_kernel_context, shape_run_state);
       }
 
       if (!compute_status.IsOK()) {
@@ -170,11 +231,32 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     }
 #endif
 
+    if (node_stats_recorder != nullptr) {
+      const auto duration = std::chrono::high_resolution_clock::now() - node_stats_begin_time;
+      node_stats_recorder->Record(node_index,
+                                  std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+                                  utils::GetOutputTensorBytes(op_kernel_context));
+    }
+
+    if (calibration_collector != nullptr) {
+      utils::CollectOutputRanges(*calibration_collector, op_kernel_context, p_op_kernel->Node());
+    }
+
     if (is_profiler_enabled) {
+      const std::string input_shapes = utils::GetInputShapes(op_kernel_context);
+      if (ep_profiler != nullptr) {
+        ep_profiler->Stop(ep_kernel_id, p_op_kernel->Node().Name() + "_device_kernel_time",
+                          {{"op_name", p_op_kernel->KernelDef().OpName()},
+                           {"provider", p_op_kernel->KernelDef().Provider()},
+                           {"input_shapes", input_shapes}});
+      }
+
       session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                                      p_op_kernel->Node().Name() + "_kernel_time",
                                                      kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+                                                     {{"op_name", p_op_kernel->KernelDef().OpName()},
+                                                      {"provider", p_op_kernel->KernelDef().Provider()},
+                                                      {"input_shapes", input_shapes}});
 
       sync_time_begin = session_state.Profiler().StartTime();
     }
@@ -3,9 +3,11 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
@@ -14,6 +16,18 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+SessionState::~SessionState() {
+  // the pooled frames free their buffers to the allocators of the execution providers
+  execution_frames_.clear();
+
+  for (auto* p : session_kernels_) {
+    delete p;
+  }
+  for (auto& kvp : deleter_for_initialized_tensors_) {
+    kvp.second.f(kvp.second.param);
+  }
+}
+
 const GraphViewer* SessionState::GetGraphViewer() const { return graph_viewer_.get(); }
 Status SessionState::SetGraph(const Graph& graph) {
   graph_viewer_ = std::make_unique<onnxruntime::GraphViewer>(graph);
@@ -110,7 +124,7 @@ void SessionState::SetExecutionPlan(std::unique_ptr<SequentialExecutionPlan> p_s
 const SequentialExecutionPlan* SessionState::GetExecutionPlan() const { return p_seq_exec_plan_.get(); }
 
 Status SessionState::AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d,
-                                          bool constant) {
+                                          bool constant, int weights_buffer) {
   auto p = initialized_tensors_.insert({ort_value_index, ort_value});
   if (!p.second)
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "duplicated ort_value index:", ort_value_index,
@@ -124,6 +138,91 @@ Status SessionState::AddInitializedTensor(int ort_value_index, const OrtValue& o
     constant_initialized_tensors_.insert({ort_value_index, ort_value});
   }
 
+  if (weights_buffer >= 0) {
+    weights_buffer_for_initialized_tensors_[ort_value_index] = static_cast<size_t>(weights_buffer);
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::PrePackInitializedTensors() {
+  // the number of uses of each constant initializer by the nodes, and how many of those the kernels packed
+  struct InitializerUses {
+    size_t uses = 0;
+    size_t packed = 0;
+  };
+  std::unordered_map<int, InitializerUses> initializer_uses;
+
+  for (const auto& node : graph_viewer_->Nodes()) {
+    OpKernel* kernel = GetMutableKernel(node.Index());
+    ORT_ENFORCE(kernel != nullptr, "CreateKernels must be called prior to PrePackInitializedTensors.");
+
+    ORT_RETURN_IF_ERROR(Node::ForEachWithIndex(
+        node.InputDefs(), [&](const NodeArg& arg, size_t input_idx) -> Status {
+          int ort_value_index;
+          ORT_RETURN_IF_ERROR(ort_value_name_idx_map_.GetIdx(arg.Name(), ort_value_index));
+          auto it = constant_initialized_tensors_.find(ort_value_index);
+          if (it == constant_initialized_tensors_.end() || !it->second.IsTensor()) {
+            return Status::OK();
+          }
+
+          auto& uses = initializer_uses[ort_value_index];
+          ++uses.uses;
+
+          BufferUniquePtr packed_buffer;
+          bool is_packed = false;
+          ORT_RETURN_IF_ERROR(kernel->PrePack(it->second.Get<Tensor>(), static_cast<int>(input_idx), packed_buffer,
+                                              is_packed));
+          if (packed_buffer) {
+            weights_buffers_.push_back(std::move(packed_buffer));
+          }
+          if (is_packed) {
+            ++uses.packed;
+          }
+          return Status::OK();
+        }));
+
+    // a subgraph reads the implicit inputs as they are
+    for (const auto* arg : node.ImplicitInputDefs()) {
+      int ort_value_index;
+      if (arg->Exists() && ort_value_name_idx_map_.GetIdx(arg->Name(), ort_value_index).IsOK() &&
+          constant_initialized_tensors_.count(ort_value_index) != 0) {
+        ++initializer_uses[ort_value_index].uses;
+      }
+    }
+  }
+
+  // an initializer that is also a graph output has to be kept
+  for (const auto* output : graph_viewer_->GetOutputs()) {
+    int ort_value_index;
+    if (ort_value_name_idx_map_.GetIdx(output->Name(), ort_value_index).IsOK()) {
+      initializer_uses.erase(ort_value_index);
+    }
+  }
+
+  for (const auto& entry : initializer_uses) {
+    if (entry.second.packed == 0 || entry.second.packed != entry.second.uses) continue;
+
+    const int ort_value_index = entry.first;
+    VLOGS(Logger(), 1) << "Releasing the initialized tensor with index " << ort_value_index
+                       << " as all of its uses are pre-packed.";
+    initialized_tensors_.erase(ort_value_index);
+    constant_initialized_tensors_.erase(ort_value_index);
+
+    auto deleter = deleter_for_initialized_tensors_.find(ort_value_index);
+    if (deleter != deleter_for_initialized_tensors_.end()) {
+      deleter->second.f(deleter->second.param);
+      deleter_for_initialized_tensors_.erase(deleter);
+    }
+
+    // a buffer shared with other initializers, as planned by the memory pattern, stays allocated
+    auto buffer = weights_buffer_for_initialized_tensors_.find(ort_value_index);
+    if (buffer != weights_buffer_for_initialized_tensors_.end()) {
+      weights_buffers_[buffer->second].reset();
+      weights_buffer_for_initialized_tensors_.erase(buffer);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -146,43 +245,197 @@ const logging::Logger& SessionState::Logger() const {
 
 void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &profiler; }
 
+const std::vector<std::pair<std::string, std::string>>& SessionState::GetOrtValueNamesAndProducers() const {
+  std::call_once(ort_value_names_and_producers_once_, [this]() {
+    ort_value_names_and_producers_.resize(ort_value_name_idx_map_.MaxIdx());
+    for (const auto& entry : ort_value_name_idx_map_) {
+      ort_value_names_and_producers_[entry.second].first = entry.first;
+    }
+
+    for (const auto& node : graph_viewer_->Nodes()) {
+      for (const auto* output_def : node.OutputDefs()) {
+        int idx;
+        if (output_def->Exists() && ort_value_name_idx_map_.GetIdx(output_def->Name(), idx).IsOK()) {
+          ort_value_names_and_producers_[idx].second = node.Name();
+        }
+      }
+    }
+  });
+  return ort_value_names_and_producers_;
+}
+
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
+void SessionState::SetMaxExecutionFrames(size_t max_frames) {
+  std::lock_guard<OrtMutex> lock(execution_frames_lock_);
+  max_execution_frames_ = max_frames;
+  if (execution_frames_.size() > max_frames) {
+    execution_frames_.erase(execution_frames_.begin(),
+                            execution_frames_.begin() + (execution_frames_.size() - max_frames));
+  }
+}
+
+void SessionState::SetMemoryPatternCacheOptions(size_t max_entries, const std::vector<int64_t>& dim_buckets) {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  max_mem_patterns_ = max_entries;
+  mem_pattern_dim_buckets_ = dim_buckets;
+  std::sort(mem_pattern_dim_buckets_.begin(), mem_pattern_dim_buckets_.end());
+  mem_patterns_.clear();
+  mem_pattern_index_.clear();
+}
+
+// Flatten the input shapes into a single vector, with each shape's rank preceding its dims.
+static void FlattenInputShapes(const std::vector<std::reference_wrapper<const TensorShape>>& shapes,
+                               const std::vector<int64_t>& dim_buckets,
+                               std::vector<int64_t>& traced_dims, std::vector<int64_t>& bucketed_dims) {
   for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
+    const auto& dims = shape.get().GetDims();
+    traced_dims.push_back(static_cast<int64_t>(dims.size()));
+    bucketed_dims.push_back(static_cast<int64_t>(dims.size()));
+    for (auto dim : dims) {
+      traced_dims.push_back(dim);
+      auto bucket = std::lower_bound(dim_buckets.cbegin(), dim_buckets.cend(), dim);
+      bucketed_dims.push_back(bucket != dim_buckets.cend() ? *bucket : dim);
+    }
   }
-  return key;
 }
 
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// A pattern traced with the 'larger' shapes can be used for the 'smaller' ones if both have the same ranks
+// and every dim in 'larger' is at least as big as the matching dim in 'smaller'.
+static bool DimsDominate(const std::vector<int64_t>& larger, const std::vector<int64_t>& smaller) {
+  if (larger.size() != smaller.size()) return false;
+
+  for (size_t i = 0; i < larger.size();) {
+    // rank must match exactly
+    const int64_t rank = larger[i];
+    if (smaller[i] != rank) return false;
+    ++i;
+
+    for (int64_t end = static_cast<int64_t>(i) + rank; static_cast<int64_t>(i) < end; ++i) {
+      if (larger[i] < smaller[i]) return false;
+    }
+  }
+
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  std::vector<int64_t> traced_dims;
+  std::vector<int64_t> bucketed_dims;
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
+  FlattenInputShapes(input_shapes, mem_pattern_dim_buckets_, traced_dims, bucketed_dims);
+
+  auto found = mem_patterns_.end();
+  auto index_entry = mem_pattern_index_.find(bucketed_dims);
+  if (index_entry != mem_pattern_index_.end() && DimsDominate(index_entry->second->traced_dims, traced_dims)) {
+    found = index_entry->second;
+  } else if (!mem_pattern_dim_buckets_.empty()) {
+    // fall back to a pattern traced for a larger bucket
+    found = std::find_if(mem_patterns_.begin(), mem_patterns_.end(), [&traced_dims](const MemoryPatternCacheEntry& e) {
+      return DimsDominate(e.traced_dims, traced_dims);
+    });
+  }
+
+  if (found == mem_patterns_.end()) return nullptr;
 
-  return it->second.get();
+  // move to the front of the LRU list
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, found);
+  return found->patterns;
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  std::vector<int64_t> traced_dims;
+  std::vector<int64_t> bucketed_dims;
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  FlattenInputShapes(input_shapes, mem_pattern_dim_buckets_, traced_dims, bucketed_dims);
+
+  auto index_entry = mem_pattern_index_.find(bucketed_dims);
+  if (index_entry != mem_pattern_index_.end()) {
+    // keep the pattern for the largest shapes seen in the bucket so it covers the others
+    auto& entry = *index_entry->second;
+    if (traced_dims != entry.traced_dims && DimsDominate(traced_dims, entry.traced_dims)) {
+      entry.traced_dims = std::move(traced_dims);
+      entry.patterns = std::move(mem_patterns);
+    }
+
+    mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, index_entry->second);
+    return Status::OK();
+  }
+
+  mem_patterns_.push_front(MemoryPatternCacheEntry{bucketed_dims, std::move(traced_dims), std::move(mem_patterns)});
+  mem_pattern_index_.emplace(std::move(bucketed_dims), mem_patterns_.begin());
+
+  if (max_mem_patterns_ > 0 && mem_patterns_.size() > max_mem_patterns_) {
+    mem_pattern_index_.erase(mem_patterns_.back().bucketed_dims);
+    mem_patterns_.pop_back();
   }
 
   return Status::OK();
 }
 
+void SessionState::SetStaticMemoryPatternGroup(std::unique_ptr<MemoryPatternGroup> mem_patterns) {
+  static_mem_patterns_ = std::move(mem_patterns);
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
+std::unique_ptr<ExecutionFrame> SessionState::AcquireExecutionFrame(
+    const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+    const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+    const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const {
+  auto mem_patterns = ExecutionFrame::FindMemoryPatterns(*this, feeds);
+
+  std::unique_ptr<ExecutionFrame> frame;
+  {
+    std::lock_guard<OrtMutex> lock(execution_frames_lock_);
+    if (!execution_frames_.empty()) {
+      auto entry = std::find_if(execution_frames_.begin(), execution_frames_.end(),
+                                [&mem_patterns](const std::unique_ptr<ExecutionFrame>& f) {
+                                  return f->GetMemoryPatterns() == mem_patterns.get();
+                                });
+      // otherwise take the most recently released one
+      if (entry == execution_frames_.end()) {
+        entry = std::prev(execution_frames_.end());
+      }
+
+      frame = std::move(*entry);
+      execution_frames_.erase(entry);
+    }
+  }
+
+  if (frame) {
+    frame->Reset(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, std::move(mem_patterns));
+  } else {
+    frame = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators,
+                                             *this);
+  }
+
+  return frame;
+}
+
+void SessionState::ReleaseExecutionFrame(std::unique_ptr<ExecutionFrame> frame) const {
+  if (max_execution_frames_ == 0) {
+    return;
+  }
+
+  frame->ReleaseAllValues();
+
+  // the frame evicted to make room for this one is freed once the lock is released
+  std::unique_ptr<ExecutionFrame> evicted;
+  std::lock_guard<OrtMutex> lock(execution_frames_lock_);
+  if (execution_frames_.size() >= max_execution_frames_) {
+    // the oldest one, the others are more likely to use the patterns of the next Runs
+    evicted = std::move(execution_frames_.front());
+    execution_frames_.erase(execution_frames_.begin());
+  }
+  execution_frames_.push_back(std::move(frame));
+}
+
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
   // Graph partitioning should ensure an input is only consumed from one device. Copy nodes should have been inserted
   // to handle a scenario where an input is required on different devices by different nodes. Validate that.
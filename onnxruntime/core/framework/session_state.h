@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "gsl/gsl_util"
@@ -17,6 +19,7 @@
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
 #include "core/framework/ml_value.h"
@@ -29,10 +32,14 @@
 
 namespace onnxruntime {
 
+class ExecutionFrame;
 class ExecutionProviders;
 class KernelDef;
 class OpKernel;
 class NodeIndexInfo;
+class NodeStatsRecorder;
+class CalibrationCollector;
+class ShapeSubgraphCache;
 struct SequentialExecutionPlan;
 struct MemoryPatternGroup;
 
@@ -59,14 +66,7 @@ class SessionState {
         inter_op_thread_pool_(inter_op_thread_pool) {
   }
 
-  ~SessionState() {
-    for (auto* p : session_kernels_) {
-      delete p;
-    }
-    for (auto& kvp : deleter_for_initialized_tensors_) {
-      kvp.second.f(kvp.second.param);
-    }
-  }
+  ~SessionState();
 
   // Graph viewer.
   const GraphViewer* GetGraphViewer() const;
@@ -86,14 +86,23 @@ class SessionState {
 
   const OrtValueNameIdxMap& GetOrtValueNameIdxMap() const noexcept { return ort_value_name_idx_map_; }
 
+  /**
+  The name of every OrtValue and the name of the node producing it, empty for the graph inputs and initializers,
+  indexed by OrtValue index. Built on first use, for the memory events of the profiler.
+  */
+  const std::vector<std::pair<std::string, std::string>>& GetOrtValueNamesAndProducers() const;
+
   // initialized tensors
   /**
    * Adds an initialized tensor (weight) so that it can be used by the
    * execution frame to setup the appropriate OrtValue vectors.
    * This function will take a shallow copy of d if d is not NULL.
    * If 'constant' is true the tensor value cannot be overridden by an input at runtime.
+   * If 'weights_buffer' is not negative it is the index in the weights buffers of a buffer that holds this tensor
+   * alone, so it can be freed along with the tensor.
    */
-  Status AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d, bool constant);
+  Status AddInitializedTensor(int ort_value_index, const OrtValue& ort_value, const OrtCallback* d, bool constant,
+                              int weights_buffer = -1);
 
   Status SetGraph(const Graph& graph);
   Status CreateKernels(const KernelRegistryManager& custom_registry_manager);
@@ -101,6 +110,12 @@ class SessionState {
     ORT_RETURN_IF_ERROR(SetGraph(graph));
     return CreateKernels(custom_registry_manager);
   }
+
+  /**
+   * Calls OpKernel::PrePack for every constant initializer input of the kernels, which must have been created,
+   * and releases the initializers that every node using them has packed.
+   */
+  Status PrePackInitializedTensors();
   /**
    * Gets the map of ort_value_index to initialized tensors (weights) so that it can be used by the
    * execution frame to setup the appropriate OrtValue vectors.
@@ -141,10 +156,45 @@ class SessionState {
   */
   profiling::Profiler& Profiler() const;
 
+  /**
+  Whether a profiler was set and it's enabled.
+  */
+  bool IsProfilingEnabled() const { return profiler_ != nullptr && profiler_->IsEnabled(); }
+
+  /**
+  Set the recorder of the per node statistics, nullptr if they aren't collected. Not owned.
+  */
+  void SetNodeStatsRecorder(NodeStatsRecorder* node_stats_recorder) { node_stats_recorder_ = node_stats_recorder; }
+  NodeStatsRecorder* GetNodeStatsRecorder() const { return node_stats_recorder_; }
+
+  /**
+  Set the collector of the ranges of the graph inputs and node outputs, nullptr if they aren't collected. Not owned.
+  */
+  void SetCalibrationCollector(CalibrationCollector* calibration_collector) {
+    calibration_collector_ = calibration_collector;
+  }
+  CalibrationCollector* GetCalibrationCollector() const { return calibration_collector_; }
+
+  /**
+  Set the cache of the nodes that only depend on the shapes of values, nullptr to run them on every Run. Not owned.
+  */
+  void SetShapeSubgraphCache(ShapeSubgraphCache* shape_subgraph_cache) { shape_subgraph_cache_ = shape_subgraph_cache; }
+  ShapeSubgraphCache* GetShapeSubgraphCache() const { return shape_subgraph_cache_; }
+
+  /**
+  Configure the memory pattern cache.
+  @param max_entries Maximum number of cached patterns. The least recently used pattern is evicted
+                     when the limit is exceeded. 0 means unbounded.
+  @param dim_buckets Ascending bucket boundaries. When not empty, each input dimension is rounded up to the
+                     smallest boundary that is not less than it, so all shapes in a bucket share one pattern, and
+                     a pattern traced with larger shapes can be reused for smaller ones.
+  */
+  void SetMemoryPatternCacheOptions(size_t max_entries, const std::vector<int64_t>& dim_buckets);
+
   /**
   Get cached memory pattern based on input shapes
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
@@ -154,11 +204,41 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Set the memory patterns computed from the shapes in the graph when they're all known.
+  They're used by every Run instead of the patterns traced for the input shapes.
+  */
+  void SetStaticMemoryPatternGroup(std::unique_ptr<MemoryPatternGroup> mem_patterns);
+
+  std::shared_ptr<const MemoryPatternGroup> GetStaticMemoryPatternGroup() const { return static_mem_patterns_; }
+
   /**
   Get enable memory pattern flag
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Get an execution frame for a Run, reusing one released by a previous Run if possible.
+  A frame using the memory patterns for the feeds is preferred so its pre-allocated buffers are kept.
+  Const as it's an internal cache update only.
+  */
+  std::unique_ptr<ExecutionFrame> AcquireExecutionFrame(
+      const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+      const std::vector<int>& fetch_mlvalue_idxs, const std::vector<OrtValue>& fetches,
+      const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) const;
+
+  /**
+  Return an execution frame to the pool once the Run has finished with it.
+  The oldest frame of the pool is freed if it already holds the maximum number of frames.
+  */
+  void ReleaseExecutionFrame(std::unique_ptr<ExecutionFrame> frame) const;
+
+  /**
+  Set the maximum number of execution frames kept for reuse by later Runs. 0 disables the reuse.
+  */
+  void SetMaxExecutionFrames(size_t max_frames);
+  size_t GetMaxExecutionFrames() const { return max_execution_frames_; }
+
   struct NodeInfo {
     /**
      *
@@ -214,6 +294,9 @@ class SessionState {
   const DataTransferManager& GetDataTransferMgr() const { return *data_transfer_mgr_; }
   void SetDataTransferMgr(const DataTransferManager* data_transfer_mgr) { data_transfer_mgr_ = data_transfer_mgr; }
 
+  size_t GetMaxMemoryPatterns() const { return max_mem_patterns_; }
+  const std::vector<int64_t>& GetMemoryPatternDimBuckets() const { return mem_pattern_dim_buckets_; }
+
   std::vector<BufferUniquePtr>& GetMutableWeightsBuffers() { return weights_buffers_; }
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
@@ -237,17 +320,48 @@ class SessionState {
   // munmap memory region and close file descriptor
   std::unordered_map<int, OrtCallback> deleter_for_initialized_tensors_;
   std::vector<BufferUniquePtr> weights_buffers_;
+  // index in weights_buffers_ of the buffer that holds an initialized tensor alone. key is ort_value_index
+  std::unordered_map<int, size_t> weights_buffer_for_initialized_tensors_;
   std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan_ = nullptr;
 
   const logging::Logger* logger_ = nullptr;
-  profiling::Profiler* profiler_;
+  profiling::Profiler* profiler_ = nullptr;
+  NodeStatsRecorder* node_stats_recorder_ = nullptr;
+  CalibrationCollector* calibration_collector_ = nullptr;
+  ShapeSubgraphCache* shape_subgraph_cache_ = nullptr;
+
+  mutable std::once_flag ort_value_names_and_producers_once_;
+  mutable std::vector<std::pair<std::string, std::string>> ort_value_names_and_producers_;
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+
+  struct MemoryPatternCacheEntry {
+    // input ranks and dims after rounding to dim buckets. this is the cache key.
+    std::vector<int64_t> bucketed_dims;
+    // input ranks and dims the patterns were traced with.
+    std::vector<int64_t> traced_dims;
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+  };
+
+  using MemoryPatternCache = std::list<MemoryPatternCacheEntry>;
+
+  // cache for the generated mem_patterns, most recently used first. shared ownership keeps an evicted
+  // pattern alive for any execution frame still using it.
+  mutable MemoryPatternCache mem_patterns_;
+  mutable std::map<std::vector<int64_t>, MemoryPatternCache::iterator> mem_pattern_index_;
+  size_t max_mem_patterns_ = 0;
+  std::vector<int64_t> mem_pattern_dim_buckets_;
+  // patterns from the static shapes, set once at initialization
+  std::shared_ptr<const MemoryPatternGroup> static_mem_patterns_;
+
+  // execution frames released by previous Runs, oldest first. there is one per concurrent Run at most, and no
+  // more than max_execution_frames_.
+  mutable OrtMutex execution_frames_lock_;
+  mutable std::vector<std::unique_ptr<ExecutionFrame>> execution_frames_;
+  size_t max_execution_frames_ = 4;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -20,21 +20,29 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/static_mem_pattern_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
-// T should have signature of '(int idx, const OrtValue& value, const OrtCallback& d) -> Status'
+// T should have signature of
+// '(int idx, const OrtValue& value, const OrtCallback& d, bool constant, int weights_buffer) -> Status'
 template <typename T>
 static common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                              const onnxruntime::Graph& graph, const ExecutionProviders& exec_providers,
                                              const OrtValueNameIdxMap& ort_value_name_idx_map,
-                                             ITensorAllocator* planner, const T& save_tensor_func,
+                                             const ExecutionPlanBase& exec_plan,
+                                             ITensorAllocator* planner,
+                                             const std::vector<BufferUniquePtr>& weights_buffers,
+                                             const T& save_tensor_func,
                                              const logging::Logger& logger,
-                                             const DataTransferManager& data_transfer_mgr);
+                                             const DataTransferManager& data_transfer_mgr,
+                                             const std::unordered_map<std::string, OrtValue>* initializers_to_share,
+                                             concurrency::ThreadPool* thread_pool);
 
 static common::Status SaveInputOutputNamesToNodeMapping(
     const onnxruntime::Graph& graph,
@@ -46,14 +54,16 @@ SessionStateInitializer::SessionStateInitializer(bool enable_mem_pattern,
                                                  const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                                  onnxruntime::Graph& graph, SessionState& session_state,
                                                  const ExecutionProviders& providers,
-                                                 KernelRegistryManager& kernel_registry_manager)
+                                                 KernelRegistryManager& kernel_registry_manager,
+                                                 const std::unordered_map<std::string, OrtValue>* initializers_to_share)
     : graph_loc_(graph_loc),
       graph_{graph},
       session_state_{session_state},
       execution_providers_{providers},
       kernel_registry_manager_{kernel_registry_manager},
       logger_{session_state.Logger()},
-      enable_mem_pattern_(enable_mem_pattern) {}
+      enable_mem_pattern_(enable_mem_pattern),
+      initializers_to_share_(initializers_to_share) {}
 
 common::Status SessionStateInitializer::CreatePlan(
     const Node* parent_node,
@@ -77,6 +87,9 @@ common::Status SessionStateInitializer::CreatePlan(
                   });
   }
 
+  const bool profiling_enabled = session_state_.IsProfilingEnabled();
+  TimePoint tp = std::chrono::high_resolution_clock::now();
+
   std::unique_ptr<SequentialExecutionPlan> exec_plan;
   SequentialPlannerContext context(!enable_sequential_execution);
   ORT_RETURN_IF_ERROR(SequentialPlanner::CreatePlan(parent_node, *graph_viewer, valid_outer_scope_node_args,
@@ -87,35 +100,73 @@ common::Status SessionStateInitializer::CreatePlan(
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
+  // lay out the intermediate tensors up front if their shapes are all known, so no Run needs to trace them
+  if (session_state_.GetEnableMemoryPattern()) {
+    auto static_mem_patterns = StaticMemPatternPlanner::CreatePatterns(*exec_plan_ptr, *graph_viewer,
+                                                                       ort_value_name_idx_map);
+    if (static_mem_patterns) {
+      session_state_.SetStaticMemoryPatternGroup(std::move(static_mem_patterns));
+    }
+  }
+
+  if (profiling_enabled) {
+    session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "memory_plan_creation", tp,
+                                                    {{"graph", graph_.Name()}});
+    tp = std::chrono::high_resolution_clock::now();
+  }
+
   std::unique_ptr<ITensorAllocator> tensor_allocator_(ITensorAllocator::Create(
       enable_mem_pattern_, *exec_plan_ptr, execution_providers_, session_state_.GetMutableWeightsBuffers()));
 
   // lambda to save initialized tensors into SessionState directly
   const Env& env = Env::Default();
   ORT_RETURN_IF_ERROR(SaveInitializedTensors(
-      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, tensor_allocator_.get(),
-      [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant) -> Status {
-        return session_state_.AddInitializedTensor(idx, value, &d, constant);
+      env, graph_loc_, graph_, execution_providers_, ort_value_name_idx_map, *exec_plan_ptr, tensor_allocator_.get(),
+      session_state_.GetMutableWeightsBuffers(),
+      [this](int idx, const OrtValue& value, const OrtCallback& d, bool constant, int weights_buffer) -> Status {
+        return session_state_.AddInitializedTensor(idx, value, &d, constant, weights_buffer);
       },
-      logger_, session_state_.GetDataTransferMgr()));
+      logger_, session_state_.GetDataTransferMgr(), initializers_to_share_, session_state_.GetThreadPool()));
   // remove weights from the graph now to save memory but in many cases it won't save memory, if the tensor was
   // preallocated with the some other tensors in a single 'allocate' call, which is very common.
   // TODO: make it better
   graph_.CleanAllInitializedTensors();
 
+  if (profiling_enabled) {
+    session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_unpacking", tp,
+                                                    {{"graph", graph_.Name()}});
+    tp = std::chrono::high_resolution_clock::now();
+  }
+
   ORT_RETURN_IF_ERROR(session_state_.CreateKernels(kernel_registry_manager_));
+  if (profiling_enabled) {
+    session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernel_creation", tp,
+                                                    {{"graph", graph_.Name()}});
+    tp = std::chrono::high_resolution_clock::now();
+  }
+
+  // let the kernels transform their constant inputs once, releasing the originals nothing else needs
+  ORT_RETURN_IF_ERROR(session_state_.PrePackInitializedTensors());
+  if (profiling_enabled) {
+    session_state_.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_prepacking", tp,
+                                                    {{"graph", graph_.Name()}});
+  }
   ORT_RETURN_IF_ERROR(
       SaveInputOutputNamesToNodeMapping(graph_, kernel_registry_manager_, session_state_, outer_scope_node_args));
   return Status::OK();
 }
 
+static bool IsCpuLocation(const OrtMemoryInfo& alloc_info) {
+  return strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput;
+}
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m,
                                              const ExecutionProviders& exec_providers, OrtValue& ort_value,
                                              OrtCallback& deleter,
                                              const DataTransferManager& data_transfer_mgr) {
   const OrtMemoryInfo& alloc_info = m.GetAllocInfo();
-  if (strcmp(alloc_info.name, CPU) == 0 || alloc_info.mem_type == OrtMemTypeCPUOutput) {
+  if (IsCpuLocation(alloc_info)) {
     // deserialize directly to CPU tensor
     return utils::TensorProtoToMLValue(env, proto_path.c_str(), tensor_proto, m, ort_value, deleter);
   }
@@ -168,12 +219,44 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   return common::Status::OK();
 }
 
+static common::Status ValidateSharedInitializer(const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                const OrtValue& value, const OrtMemoryInfo& location) {
+  if (!value.IsTensor()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shared initializer ", tensor_proto.name(),
+                           " is not a tensor.");
+  }
+
+  const Tensor& tensor = value.Get<Tensor>();
+  if (utils::GetTensorProtoType(tensor) != tensor_proto.data_type()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shared initializer ", tensor_proto.name(),
+                           " doesn't have the type of the initializer in the model.");
+  }
+
+  TensorShape expected_shape(std::vector<int64_t>(tensor_proto.dims().cbegin(), tensor_proto.dims().cend()));
+  if (tensor.Shape() != expected_shape) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shared initializer ", tensor_proto.name(),
+                           " has shape ", tensor.Shape(), " but the initializer in the model has shape ",
+                           expected_shape, ".");
+  }
+
+  if (tensor.Location().device != location.device) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shared initializer ", tensor_proto.name(),
+                           " is on ", tensor.Location().ToString(), " but its consumers need it on ",
+                           location.ToString(), ".");
+  }
+  return Status::OK();
+}
+
 template <typename T>
 common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                                       const Graph& graph, const ExecutionProviders& exec_providers,
-                                      const OrtValueNameIdxMap& ort_value_name_idx_map, ITensorAllocator* planner,
+                                      const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                      const ExecutionPlanBase& exec_plan, ITensorAllocator* planner,
+                                      const std::vector<BufferUniquePtr>& weights_buffers,
                                       const T& save_tensor_func, const logging::Logger& logger,
-                                      const DataTransferManager& data_transfer_mgr) {
+                                      const DataTransferManager& data_transfer_mgr,
+                                      const std::unordered_map<std::string, OrtValue>* initializers_to_share,
+                                      concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > 0, "OrtValue indexes should have been populated.");
 
@@ -185,38 +268,142 @@ common::Status SaveInitializedTensors(const Env& env, const std::basic_string<PA
     ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(entry.first, ort_value_index));
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
+
+  // external data destined for CPU is memory-mapped and used in place, so it doesn't need a buffer
+  auto uses_data_in_place = [&exec_plan](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return IsCpuLocation(exec_plan.GetLocation(ort_value_index)) && utils::CanUseExternalDataInPlace(tensor_proto);
+  };
+
+  // a shared initializer uses the memory of its value, so it doesn't need a buffer either
+  auto get_shared_value = [initializers_to_share](const ONNX_NAMESPACE::TensorProto& tensor_proto) -> const OrtValue* {
+    if (initializers_to_share == nullptr) return nullptr;
+    auto it = initializers_to_share->find(tensor_proto.name());
+    return it == initializers_to_share->cend() ? nullptr : &it->second;
+  };
+
   for (const auto& entry : id_to_initialized_tensor) {
+    if (uses_data_in_place(entry.first, *entry.second) || get_shared_value(*entry.second) != nullptr) continue;
     ORT_RETURN_IF_ERROR(planner->Trace(entry.first, entry.second));
   }
 
   //2. allocate weight buffer on different locations
   ORT_RETURN_IF_ERROR(planner->FinalizePlan());
-  OrtCallback deleter;
   //3. create weight tensors based on weights buffer
+  // The buffers are fetched from the planner in order, then the tensors destined for CPU, which only read the
+  // TensorProto and write their own buffer, are deserialized in parallel. Those copied to a device and all the
+  // SessionState updates stay sequential.
+  struct InitializerToSave {
+    int ort_value_index;
+    const ONNX_NAMESPACE::TensorProto* tensor_proto;
+    bool constant;
+    const OrtValue* shared_value;
+    int weights_buffer;
+    std::unique_ptr<MemBuffer> m;
+    OrtValue ort_value;
+    OrtCallback deleter{nullptr, nullptr};
+    Status status;
+  };
+
+  std::vector<InitializerToSave> initializers;
+  initializers.reserve(id_to_initialized_tensor.size());
+  std::vector<size_t> cpu_initializers;
+  size_t cpu_bytes = 0;
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const char* name = (entry.second->name().empty()) ? "" : entry.second->name().c_str();
     const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
 
-    std::unique_ptr<MemBuffer> m;
-    // TODO: if the tensor need be copied, does it have enough room?
-    ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, m));
+    initializers.push_back(InitializerToSave{});
+    auto& initializer = initializers.back();
+    initializer.ort_value_index = ort_value_index;
+    initializer.tensor_proto = &tensor_proto;
+    initializer.constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
+    initializer.shared_value = get_shared_value(tensor_proto);
+    initializer.weights_buffer = -1;
+    if (initializer.shared_value != nullptr) {
+      ORT_RETURN_IF_ERROR(ValidateSharedInitializer(tensor_proto, *initializer.shared_value,
+                                                    exec_plan.GetLocation(ort_value_index)));
+      continue;
+    }
+
+    if (uses_data_in_place(ort_value_index, tensor_proto)) {
+      initializer.m = std::make_unique<MemBuffer>(nullptr, 0, exec_plan.GetLocation(ort_value_index));
+    } else {
+      // TODO: if the tensor need be copied, does it have enough room?
+      const size_t num_weights_buffers = weights_buffers.size();
+      ORT_RETURN_IF_ERROR(planner->GetPreallocatedBuffer(ort_value_index, name, initializer.m));
+      // a buffer allocated for this initializer alone can be freed with it
+      if (weights_buffers.size() == num_weights_buffers + 1) {
+        initializer.weights_buffer = static_cast<int>(num_weights_buffers);
+      }
+    }
 #ifndef NDEBUG
-    ORT_ENFORCE(m != nullptr);
-    ORT_ENFORCE(m->GetBuffer() != nullptr || m->GetLen() == 0);
+    ORT_ENFORCE(initializer.m != nullptr);
+    ORT_ENFORCE(initializer.m->GetBuffer() != nullptr || initializer.m->GetLen() == 0);
 #endif
-    OrtValue ort_value;
-    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, *m, exec_providers, ort_value, deleter, data_transfer_mgr);
+    if (IsCpuLocation(initializer.m->GetAllocInfo())) {
+      cpu_initializers.push_back(initializers.size() - 1);
+      cpu_bytes += initializer.m->GetLen();
+    }
+  }
+
+  auto deserialize = [&](InitializerToSave& initializer) {
+    initializer.status = DeserializeTensorProto(env, graph_loc, *initializer.tensor_proto, *initializer.m,
+                                                exec_providers, initializer.ort_value, initializer.deleter,
+                                                data_transfer_mgr);
+  };
+
+  auto deserialize_cpu_initializers = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      deserialize(initializers[cpu_initializers[i]]);
+    }
+  };
+  if (thread_pool == nullptr || cpu_initializers.size() < 2) {
+    deserialize_cpu_initializers(0, static_cast<std::ptrdiff_t>(cpu_initializers.size()));
+  } else {
+    // the cost of an initializer is about that of copying its bytes
+    thread_pool->ParallelFor(static_cast<std::ptrdiff_t>(cpu_initializers.size()),
+                             static_cast<double>(cpu_bytes) / cpu_initializers.size(), deserialize_cpu_initializers);
+  }
+
+  // releases the memory mapped data of the deserialized tensors the session state didn't take when one fails
+  auto release_unsaved = [&initializers](size_t first) {
+    for (size_t i = first; i < initializers.size(); ++i) {
+      if (initializers[i].deleter.f) initializers[i].deleter.f(initializers[i].deleter.param);
+    }
+  };
+
+  for (size_t i = 0; i < initializers.size(); ++i) {
+    auto& initializer = initializers[i];
+    const char* name = initializer.tensor_proto->name().c_str();
+    if (initializer.shared_value != nullptr) {
+      // the memory belongs to the caller, so there is nothing to release with the session state
+      ORT_RETURN_IF_ERROR(save_tensor_func(initializer.ort_value_index, *initializer.shared_value,
+                                           OrtCallback{nullptr, nullptr}, initializer.constant, -1));
+      VLOGS(logger, 1) << "Added shared weight with name : " << name << " with index: "
+                       << initializer.ort_value_index;
+      continue;
+    }
+
+    if (!IsCpuLocation(initializer.m->GetAllocInfo())) {
+      deserialize(initializer);
+    }
+    const Status& st = initializer.status;
     if (!st.IsOK()) {
+      release_unsaved(i);
       std::ostringstream oss;
       oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
       return Status(st.Category(), st.Code(), oss.str());
     }
 
-    bool constant = graph_utils::IsConstantInitializer(graph, name, /* check_outer_scope */ false);
-    ORT_RETURN_IF_ERROR(save_tensor_func(ort_value_index, ort_value, deleter, constant));
+    Status save_status = save_tensor_func(initializer.ort_value_index, initializer.ort_value, initializer.deleter,
+                                          initializer.constant, initializer.weights_buffer);
+    if (!save_status.IsOK()) {
+      release_unsaved(i);
+      return save_status;
+    }
 
-    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << ort_value_index;
+    VLOGS(logger, 1) << "Added weight with name : " << name << " with index: " << initializer.ort_value_index;
   }
 
   LOGS(logger, INFO) << "Done saving initialized tensors";
@@ -3,9 +3,12 @@
 
 #pragma once
 #include <map>
+#include <string>
+#include <unordered_map>
 
 #include "core/common/const_pointer_container.h"
 #include "core/framework/allocator.h"
+#include "core/framework/ml_value.h"
 #include "core/framework/tensor.h"
 #include "core/framework/path_lib.h"
 #include "core/framework/tensor_allocator.h"
@@ -30,10 +33,13 @@ class SessionStateInitializer {
   /**
    *
    * \param graph_loc The file path of where the graph was loaded. e.g. /tmp/test_squeezenet/model.onnx
+   * \param initializers_to_share Optional values, by name, used as is for the initializers of the graph instead
+   *                              of deserializing them. They must outlive the session state.
    */
   SessionStateInitializer(bool enable_mem_pattern, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
                           onnxruntime::Graph& graph, SessionState& session_state, const ExecutionProviders& providers,
-                          KernelRegistryManager& kernel_registry_manager);
+                          KernelRegistryManager& kernel_registry_manager,
+                          const std::unordered_map<std::string, OrtValue>* initializers_to_share = nullptr);
 
   // First perform any transformations and create the execution plan
   // Then initialize tensors, and save. save kernels and input/output node mappings
@@ -50,5 +56,6 @@ class SessionStateInitializer {
   KernelRegistryManager& kernel_registry_manager_;
   const logging::Logger& logger_;
   const bool enable_mem_pattern_;
+  const std::unordered_map<std::string, OrtValue>* initializers_to_share_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/shape_subgraph_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/session_state.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+static bool IsRandomOp(const std::string& op_type) {
+  return op_type == "RandomNormal" || op_type == "RandomNormalLike" || op_type == "RandomUniform" ||
+         op_type == "RandomUniformLike" || op_type == "Multinomial";
+}
+
+ShapeSubgraphCache::ShapeSubgraphCache(const SessionState& session_state, size_t max_signatures,
+                                       size_t max_output_bytes)
+    : max_signatures_(max_signatures), max_output_bytes_(max_output_bytes) {
+  const GraphViewer& graph = *session_state.GetGraphViewer();
+  const auto& name_to_idx = session_state.GetOrtValueNameIdxMap();
+  const auto& constant_initializers = session_state.GetConstantInitializedTensors();
+  auto is_constant_initializer = [&](const std::string& name) {
+    int idx;
+    return name_to_idx.GetIdx(name, idx).IsOK() && constant_initializers.count(idx) != 0;
+  };
+
+  nodes_.resize(graph.MaxNodeIndex());
+
+  // the roots each value depends on, for the outputs of the roots and of the cached nodes
+  std::unordered_map<std::string, std::vector<int>> value_roots;
+
+  for (NodeIndex node_index : graph.GetNodesInTopologicalOrder()) {
+    const Node& node = *graph.GetNode(node_index);
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider ||
+        (!node.Domain().empty() && node.Domain() != kOnnxDomain)) {
+      continue;
+    }
+
+    const auto& outputs = node.OutputDefs();
+    NodeInfo& info = nodes_[node_index];
+    if (node.OpType() == "Shape" || node.OpType() == "Size") {
+      if (!outputs.empty() && outputs[0]->Exists()) {
+        info.root_slot = static_cast<int>(num_roots_++);
+        value_roots[outputs[0]->Name()] = {info.root_slot};
+      }
+      continue;
+    }
+
+    if (node.ContainsSubgraph() || !node.ImplicitInputDefs().empty() || IsRandomOp(node.OpType())) {
+      continue;
+    }
+
+    std::vector<int> roots;
+    bool shape_only = true;
+    for (const auto* input : node.InputDefs()) {
+      if (!input->Exists()) {
+        continue;
+      }
+      auto entry = value_roots.find(input->Name());
+      if (entry != value_roots.cend()) {
+        roots.insert(roots.end(), entry->second.cbegin(), entry->second.cend());
+      } else if (!is_constant_initializer(input->Name())) {
+        shape_only = false;
+        break;
+      }
+    }
+
+    // a node of constant initializers only is left to constant folding
+    if (!shape_only || roots.empty()) {
+      continue;
+    }
+
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    for (const auto* output : outputs) {
+      if (output->Exists()) {
+        value_roots[output->Name()] = roots;
+      }
+    }
+    info.cached = true;
+    info.roots = std::move(roots);
+    ++num_cached_nodes_;
+  }
+}
+
+void ShapeSubgraphCache::RecordRoot(NodeIndex node_index, OpKernelContextInternal& context,
+                                    RunState& run_state) const {
+  const OrtValue* value = context.GetOutputMLValue(0);
+  if (value == nullptr || !value->IsAllocated() || !value->IsTensor()) {
+    return;
+  }
+
+  const auto& tensor = value->Get<Tensor>();
+  if (tensor.DataType() != DataTypeImpl::GetType<int64_t>()) {
+    return;
+  }
+
+  const int slot = nodes_[node_index].root_slot;
+  const int64_t* data = tensor.Data<int64_t>();
+  run_state.root_values_[slot].assign(data, data + tensor.Shape().Size());
+  run_state.recorded_[slot] = true;
+}
+
+bool ShapeSubgraphCache::MakeKey(const NodeInfo& node, const RunState& run_state, std::vector<int64_t>& key) const {
+  key.clear();
+  for (int slot : node.roots) {
+    if (!run_state.recorded_[slot]) {
+      return false;
+    }
+    const auto& values = run_state.root_values_[slot];
+    // the size separates the roots, as a Shape output can be of any length
+    key.push_back(static_cast<int64_t>(values.size()));
+    key.insert(key.end(), values.cbegin(), values.cend());
+  }
+  return true;
+}
+
+Status ShapeSubgraphCache::TryRestore(NodeIndex node_index, OpKernelContextInternal& context,
+                                      const RunState& run_state, bool& restored) const {
+  restored = false;
+  const NodeInfo& node = nodes_[node_index];
+  std::vector<int64_t> key;
+  if (!MakeKey(node, run_state, key)) {
+    return Status::OK();
+  }
+
+  std::shared_ptr<const CachedOutputs> outputs;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto entry = node.entries.find(key);
+    if (entry == node.entries.cend()) {
+      return Status::OK();
+    }
+    outputs = entry->second;
+  }
+
+  for (int i = 0, end = static_cast<int>(outputs->size()); i < end; ++i) {
+    const CachedTensor& cached = (*outputs)[i];
+    if (!cached.present) {
+      continue;
+    }
+    Tensor* output = context.Output(i, cached.shape);
+    ORT_RETURN_IF_NOT(output != nullptr && output->DataType() == cached.type,
+                      "The cached output ", i, " doesn't match the output of the node.");
+    if (!cached.data.empty()) {
+      memcpy(output->MutableDataRaw(), cached.data.data(), cached.data.size());
+    }
+  }
+
+  restored = true;
+  return Status::OK();
+}
+
+void ShapeSubgraphCache::Store(NodeIndex node_index, OpKernelContextInternal& context, const RunState& run_state) {
+  NodeInfo& node = nodes_[node_index];
+  std::vector<int64_t> key;
+  if (!MakeKey(node, run_state, key)) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (node.entries.size() >= max_signatures_ || node.entries.count(key) != 0) {
+      return;
+    }
+  }
+
+  auto outputs = std::make_shared<CachedOutputs>(static_cast<size_t>(context.OutputCount()));
+  size_t total_bytes = 0;
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const OrtValue* value = context.GetOutputMLValue(i);
+    if (value == nullptr) {
+      continue;
+    }
+    if (!value->IsAllocated() || !value->IsTensor()) {
+      return;
+    }
+
+    const auto& tensor = value->Get<Tensor>();
+    total_bytes += tensor.SizeInBytes();
+    if (tensor.DataType() == DataTypeImpl::GetType<std::string>() ||
+        tensor.Location().device.Type() != OrtDevice::CPU || total_bytes > max_output_bytes_) {
+      return;
+    }
+
+    CachedTensor& cached = (*outputs)[i];
+    cached.present = true;
+    cached.type = tensor.DataType();
+    cached.shape = tensor.Shape();
+    const auto* data = static_cast<const uint8_t*>(tensor.DataRaw());
+    cached.data.assign(data, data + tensor.SizeInBytes());
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (node.entries.size() < max_signatures_) {
+    node.entries.emplace(std::move(key), std::move(outputs));
+  }
+}
+
+size_t ShapeSubgraphCache::NumEntries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  size_t num_entries = 0;
+  for (const auto& node : nodes_) {
+    num_entries += node.entries.size();
+  }
+  return num_entries;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/tensor.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class OpKernelContextInternal;
+class SessionState;
+
+// ShapeSubgraphCache memoizes the nodes of a graph that only depend on the shapes of values, not on their contents,
+// such as the Gather, Unsqueeze and Concat nodes that exported models use to compute the targets of their Reshape
+// nodes at runtime from the outputs of Shape nodes.
+//
+// The shapes are read from the outputs of the Shape and Size nodes on CPU, the roots. A cached node is an ONNX node
+// on CPU, deterministic and without subgraphs, whose inputs are all constant initializers or outputs of roots or of
+// other cached nodes. Its outputs are a function of the outputs of the roots it depends on, which key its entries:
+// when a Run has produced the same root outputs as an earlier one, the outputs of the earlier Run are copied instead
+// of running the kernel.
+//
+// The roots are recorded in a RunState per Run. The entries are shared by the concurrent Runs of a session.
+class ShapeSubgraphCache {
+ public:
+  // the root outputs of a Run
+  class RunState {
+   public:
+    explicit RunState(const ShapeSubgraphCache* cache)
+        : root_values_(cache == nullptr ? 0 : cache->num_roots_),
+          recorded_(cache == nullptr ? 0 : cache->num_roots_, false) {}
+
+   private:
+    friend class ShapeSubgraphCache;
+    std::vector<std::vector<int64_t>> root_values_;
+    std::vector<bool> recorded_;
+  };
+
+  // max_signatures is the number of different root outputs cached per node. The outputs of a node that already
+  // has as many entries, or of more than max_output_bytes, aren't cached.
+  explicit ShapeSubgraphCache(const SessionState& session_state, size_t max_signatures = 16,
+                              size_t max_output_bytes = 16 * 1024);
+
+  size_t NumRoots() const { return num_roots_; }
+  size_t NumCachedNodes() const { return num_cached_nodes_; }
+
+  bool IsRoot(NodeIndex node_index) const {
+    return node_index < nodes_.size() && nodes_[node_index].root_slot >= 0;
+  }
+
+  bool IsCached(NodeIndex node_index) const {
+    return node_index < nodes_.size() && nodes_[node_index].cached;
+  }
+
+  // Records the output of the root node after its kernel ran.
+  void RecordRoot(NodeIndex node_index, OpKernelContextInternal& context, RunState& run_state) const;
+
+  // Copies the outputs a Run with the same root outputs produced into the outputs of the cached node.
+  // restored is false if there are none, the kernel has to run then.
+  Status TryRestore(NodeIndex node_index, OpKernelContextInternal& context, const RunState& run_state,
+                    bool& restored) const;
+
+  // Saves the outputs of the cached node after its kernel ran.
+  void Store(NodeIndex node_index, OpKernelContextInternal& context, const RunState& run_state);
+
+  // number of entries over all the cached nodes
+  size_t NumEntries() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ShapeSubgraphCache);
+
+  struct CachedTensor {
+    // false for an output the node doesn't produce
+    bool present = false;
+    MLDataType type = nullptr;
+    TensorShape shape;
+    std::vector<uint8_t> data;
+  };
+
+  using CachedOutputs = std::vector<CachedTensor>;
+
+  struct NodeInfo {
+    int root_slot = -1;
+    bool cached = false;
+    // slots of the roots the outputs of a cached node depend on
+    std::vector<int> roots;
+    std::map<std::vector<int64_t>, std::shared_ptr<const CachedOutputs>> entries;
+  };
+
+  // concatenates the outputs of the roots of the node recorded by the Run. false if one wasn't recorded.
+  bool MakeKey(const NodeInfo& node, const RunState& run_state, std::vector<int64_t>& key) const;
+
+  const size_t max_signatures_;
+  const size_t max_output_bytes_;
+  size_t num_roots_ = 0;
+  size_t num_cached_nodes_ = 0;
+  // indexed by NodeIndex
+  std::vector<NodeInfo> nodes_;
+  mutable OrtMutex mutex_;
+};
+
+}  // namespace onnxruntime
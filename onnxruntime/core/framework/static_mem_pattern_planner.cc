@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_mem_pattern_planner.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "core/framework/data_types.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+namespace {
+struct BufferLifetime {
+  int ort_value_idx;
+  size_t size;
+  // the steps of the execution plan that allocate and free the buffer
+  size_t first_step;
+  size_t last_step;
+  size_t offset;
+};
+
+// Place the buffers at the lowest offset that doesn't overlap a buffer alive at the same time, largest first.
+// Returns the peak size.
+size_t PlaceBuffers(std::vector<BufferLifetime>& buffers) {
+  std::sort(buffers.begin(), buffers.end(), [](const BufferLifetime& a, const BufferLifetime& b) {
+    return a.size != b.size ? a.size > b.size : a.first_step < b.first_step;
+  });
+
+  size_t peak_size = 0;
+  std::vector<const BufferLifetime*> overlapping;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    auto& buffer = buffers[i];
+
+    overlapping.clear();
+    for (size_t j = 0; j < i; ++j) {
+      const auto& placed = buffers[j];
+      if (placed.first_step <= buffer.last_step && buffer.first_step <= placed.last_step) {
+        overlapping.push_back(&placed);
+      }
+    }
+    std::sort(overlapping.begin(), overlapping.end(),
+              [](const BufferLifetime* a, const BufferLifetime* b) { return a->offset < b->offset; });
+
+    size_t offset = 0;
+    for (const auto* placed : overlapping) {
+      if (offset + buffer.size <= placed->offset) break;
+      offset = std::max(offset, placed->offset + placed->size);
+    }
+
+    buffer.offset = offset;
+    peak_size = std::max(peak_size, offset + buffer.size);
+  }
+
+  return peak_size;
+}
+}  // namespace
+
+std::unique_ptr<MemoryPatternGroup> StaticMemPatternPlanner::CreatePatterns(
+    const SequentialExecutionPlan& plan, const GraphViewer& graph_viewer,
+    const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  const auto& execution_plan = plan.execution_plan;
+  const size_t num_steps = execution_plan.size();
+
+  // the step after which each buffer is freed. a buffer reused by other values is freed after the last of them.
+  std::unordered_map<int, size_t> free_steps;
+  for (size_t step = 0; step < num_steps; ++step) {
+    for (int i = execution_plan[step].free_from_index; i <= execution_plan[step].free_to_index; ++i) {
+      free_steps[plan.to_be_freed[i]] = step;
+    }
+  }
+
+  std::map<OrtMemoryInfo, std::vector<BufferLifetime>> buffers;
+  for (size_t step = 0; step < num_steps; ++step) {
+    const auto* node = graph_viewer.GetNode(execution_plan[step].node_index);
+    if (node == nullptr) return nullptr;
+
+    for (const auto* output : node->OutputDefs()) {
+      if (!output->Exists()) continue;
+
+      int ort_value_idx;
+      if (!ort_value_name_idx_map.GetIdx(output->Name(), ort_value_idx).IsOK()) return nullptr;
+
+      const auto& alloc_plan = plan.allocation_plan[ort_value_idx];
+      if (alloc_plan.alloc_kind != AllocKind::kAllocate ||
+          alloc_plan.value_type == nullptr || !alloc_plan.value_type->IsTensorType()) {
+        continue;
+      }
+
+      // string tensors need placement new, so they're never allocated from a pattern
+      const auto* element_type = static_cast<const TensorTypeBase*>(alloc_plan.value_type)->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) continue;
+
+      const auto* shape = output->Shape();
+      if (shape == nullptr) return nullptr;
+
+      size_t num_elements = 1;
+      for (const auto& dim : shape->dim()) {
+        if (!utils::HasDimValue(dim) || dim.dim_value() < 0) return nullptr;
+        num_elements *= static_cast<size_t>(dim.dim_value());
+      }
+
+      // same size as ExecutionFrame allocates
+      size_t size;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(num_elements, element_type->Size(), &size)) {
+        return nullptr;
+      }
+      if (size == 0) continue;
+
+      auto free_step = free_steps.find(ort_value_idx);
+      buffers[alloc_plan.location].push_back(
+          BufferLifetime{ort_value_idx, size, step, free_step != free_steps.end() ? free_step->second : num_steps - 1, 0});
+    }
+  }
+
+  auto group = std::make_unique<MemoryPatternGroup>();
+  for (auto& entry : buffers) {
+    MemoryPattern pattern;
+    pattern.peak_size_ = PlaceBuffers(entry.second);
+    for (const auto& buffer : entry.second) {
+      pattern.patterns_[buffer.ort_value_idx] = MemoryBlock(buffer.offset, buffer.size);
+    }
+
+    group->locations.push_back(entry.first);
+    group->patterns.push_back(std::move(pattern));
+  }
+
+  return group;
+}
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+// StaticMemPatternPlanner computes the memory patterns of a sequential execution plan from the shapes
+// of the values in the graph, instead of tracing the allocations of a first Run like MemPatternPlanner.
+// The lifetime of every buffer the plan allocates is known from the plan, so the blocks are packed
+// greedily by decreasing size, each at the lowest offset free for the whole of its lifetime.
+class StaticMemPatternPlanner {
+ public:
+  // Returns nullptr if the shape of a tensor the plan allocates isn't fully known.
+  static std::unique_ptr<MemoryPatternGroup> CreatePatterns(const SequentialExecutionPlan& plan,
+                                                            const GraphViewer& graph_viewer,
+                                                            const OrtValueNameIdxMap& ort_value_name_idx_map);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StaticMemPatternPlanner);
+};
+}  // namespace onnxruntime
@@ -361,6 +361,22 @@ static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   from.param = nullptr;
 }
 
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (!IsLittleEndianOrder() || tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL ||
+      !HasDataType(tensor_proto) || tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    return false;
+  }
+
+  // the mapping starts on a page boundary, so the data is aligned if its offset in the file is
+  const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
+  return external_data_info->GetOffset() % static_cast<int64_t>(type->Size()) == 0;
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, OrtValue& value,
                             OrtCallback& deleter) {
@@ -401,7 +417,9 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       raw_data = tensor_proto.raw_data().data();
       raw_data_len = tensor_proto.raw_data().size();
     }
-    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr) {
+    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr &&
+        reinterpret_cast<std::uintptr_t>(raw_data) % type->Size() == 0) {
+      // use the memory-mapped (or already read) file data in place.
       tensor_data = const_cast<void*>(raw_data);
       MoveOrtCallback(deleter_for_file_data.d, deleter);
     } else {
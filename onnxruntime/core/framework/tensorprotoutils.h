@@ -34,6 +34,14 @@ TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShape
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
+
+/**
+ * Returns true if TensorProtoToMLValue will wrap the external data of 'input' in place. On little-endian hosts the
+ * external data file is memory-mapped, so if the data is suitably aligned for its element type no buffer needs to be
+ * preallocated for it and the data is never copied.
+ */
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& input);
+
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
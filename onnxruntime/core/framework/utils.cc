@@ -6,6 +6,7 @@
 #include <iomanip>
 
 #include "core/graph/graph_viewer.h"
+#include "core/framework/calibration_collector.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/execution_providers.h"
@@ -140,10 +141,12 @@ const std::string& GetNodeInputProviderType(const SessionState::NodeInfo& info)
   return required_provider_type;
 }
 
+// If copy_pairs is not null, the copy of the tensor is added to it instead of being done.
 static Status CopyMLValue(const DataTransferManager& data_transfer_mgr,
                           const MLValueCopyInfo& copy_info,
                           const OrtValue& source_mlvalue,
-                          OrtValue& target_mlvalue) {
+                          OrtValue& target_mlvalue,
+                          std::vector<IDataTransfer::SrcDstPair>* copy_pairs = nullptr) {
   if (copy_info.source_device == copy_info.target_device) {
     target_mlvalue = source_mlvalue;
     return Status::OK();
@@ -166,6 +169,11 @@ static Status CopyMLValue(const DataTransferManager& data_transfer_mgr,
 
   Tensor* p_output_tensor = target_mlvalue.GetMutable<Tensor>();
 
+  if (copy_pairs != nullptr) {
+    copy_pairs->push_back({source_tensor, *p_output_tensor});
+    return Status::OK();
+  }
+
   ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(source_tensor, *p_output_tensor));
 
   return Status::OK();
@@ -388,11 +396,13 @@ static common::Status CopyInputsAcrossDevices(const std::vector<OrtValue>& orig_
 
   new_feeds.resize(num_feeds);
 
+  // the feeds are copied together, which lets a data transfer coalesce the copies between the same devices
+  std::vector<IDataTransfer::SrcDstPair> copy_pairs;
   for (size_t idx = 0; idx < num_feeds; ++idx) {
-    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], orig_feeds[idx], new_feeds[idx]));
+    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], orig_feeds[idx], new_feeds[idx], &copy_pairs));
   }
 
-  return Status::OK();
+  return data_transfer_mgr.CopyTensors(copy_pairs);
 }
 
 // public method to do a single copy. used by external partners
@@ -422,11 +432,13 @@ static common::Status CopyOutputsAcrossDevices(const SessionState& session_state
 
   const auto& data_transfer_mgr = session_state.GetDataTransferMgr();
 
+  // like the feeds, the fetches are copied together
+  std::vector<IDataTransfer::SrcDstPair> copy_pairs;
   for (size_t idx = 0; idx < num_outputs; ++idx) {
-    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], fetches[idx], user_fetches[idx]));
+    ORT_RETURN_IF_ERROR(CopyMLValue(data_transfer_mgr, copy_info[idx], fetches[idx], user_fetches[idx], &copy_pairs));
   }
 
-  return Status::OK();
+  return data_transfer_mgr.CopyTensors(copy_pairs);
 }
 
 static common::Status ExecuteGraphImpl(const SessionState& session_state,
@@ -435,11 +447,13 @@ static common::Status ExecuteGraphImpl(const SessionState& session_state,
                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                        bool sequential_execution, const bool& terminate_flag,
                                        const logging::Logger& logger) {
-  std::unique_ptr<IExecutor> p_exec;
-  if (sequential_execution) {
-    p_exec = std::unique_ptr<IExecutor>(new SequentialExecutor(terminate_flag));
-  } else {
-    p_exec = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+  // the sequential executor is kept on the stack as this runs for every iteration of a control flow subgraph
+  SequentialExecutor sequential_executor(terminate_flag);
+  std::unique_ptr<IExecutor> parallel_executor;
+  IExecutor* p_exec = &sequential_executor;
+  if (!sequential_execution) {
+    parallel_executor = std::unique_ptr<IExecutor>(new ParallelExecutor(session_state, terminate_flag));
+    p_exec = parallel_executor.get();
   }
 
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
@@ -513,6 +527,20 @@ common::Status ExecuteGraph(const SessionState& session_state,
   return status;
 }
 
+common::Status ExecuteGraphWithFinalizedCopyInfo(const SessionState& session_state,
+                                                 const FeedsFetchesManager& feeds_fetches_manager,
+                                                 const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                 bool sequential_execution, const bool& terminate_flag,
+                                                 const logging::Logger& logger) {
+  // create default instances if needed
+  fetches.resize(feeds_fetches_manager.GetFeedsFetchesInfo().output_names.size());
+
+  auto status = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+                                 sequential_execution, terminate_flag, logger);
+
+  return status;
+}
+
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
                                const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
@@ -522,6 +550,43 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
   return status;
 }
 
+common::Status DeadlineExceededStatus() {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to the deadline of the Run being exceeded.");
+}
+
+size_t GetOutputTensorBytes(OpKernelContextInternal& context) {
+  size_t total_bytes = 0;
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const OrtValue* p_ml_value = context.GetOutputMLValue(i);
+    if (p_ml_value != nullptr && p_ml_value->IsAllocated() && p_ml_value->IsTensor()) {
+      total_bytes += p_ml_value->Get<Tensor>().SizeInBytes();
+    }
+  }
+  return total_bytes;
+}
+
+void CollectOutputRanges(CalibrationCollector& collector, OpKernelContextInternal& context, const Node& node) {
+  const auto& output_defs = node.OutputDefs();
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    const OrtValue* p_ml_value = context.GetOutputMLValue(i);
+    if (p_ml_value != nullptr && p_ml_value->IsAllocated() && p_ml_value->IsTensor()) {
+      collector.Collect(output_defs[i]->Name(), p_ml_value->Get<Tensor>());
+    }
+  }
+}
+
+std::string GetInputShapes(const OpKernelContextInternal& context) {
+  std::string shapes;
+  for (int i = 0, end = context.InputCount(); i < end; ++i) {
+    if (i > 0) shapes += ",";
+    const OrtValue* p_ml_value = context.GetInputMLValue(i);
+    if (p_ml_value != nullptr && p_ml_value->IsAllocated() && p_ml_value->IsTensor()) {
+      shapes += p_ml_value->Get<Tensor>().Shape().ToString();
+    }
+  }
+  return shapes;
+}
+
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 std::ostream& operator<<(std::ostream& out, const BFloat16& value) {
   return out << value.ToFloat();
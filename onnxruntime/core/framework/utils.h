@@ -18,6 +18,7 @@ std::ostream& operator<<(std::ostream& out, const TensorProto& tensor_proto);
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {
+class CalibrationCollector;
 class ExecutionProviders;
 struct FeedsFetchesInfo;
 class FeedsFetchesManager;
@@ -27,6 +28,7 @@ class KernelDef;
 class KernelRegistryManager;
 class IExecutionProvider;
 class Node;
+class OpKernelContextInternal;
 class Tensor;
 
 namespace logging {
@@ -69,6 +71,14 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
                             const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
                             bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
 
+// Execute the main graph. The feeds_fetches_manager should have been finalized prior to calling this function
+// for the devices of the feeds and fetches, as done once for a PreparedRun.
+common::Status ExecuteGraphWithFinalizedCopyInfo(const SessionState& session_state,
+                                                 const FeedsFetchesManager& feeds_fetches_manager,
+                                                 const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                 bool sequential_execution, const bool& terminate_flag,
+                                                 const logging::Logger& logger);
+
 // Execute a subgraph. The feeds_fetches_manager should have been finalized prior to calling this function.
 // See IControlFlowNode::SetupSubgraphExecutionInfo usage in the control flow kernels.
 common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
@@ -76,6 +86,18 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                                bool sequential_execution, const bool& terminate_flag, const logging::Logger& logger);
 
+// The status of a Run stopped because its RunOptions::deadline has passed.
+common::Status DeadlineExceededStatus();
+
+// Total size in bytes of the tensors the kernel has output.
+size_t GetOutputTensorBytes(OpKernelContextInternal& context);
+
+// The shapes of the tensor inputs of the kernel for the profiler, e.g. "{3,2},{2}". Other inputs are empty.
+std::string GetInputShapes(const OpKernelContextInternal& context);
+
+// Gives the tensor outputs of the kernel to the calibration collector, under the names of the node outputs.
+void CollectOutputRanges(CalibrationCollector& collector, OpKernelContextInternal& context, const Node& node);
+
 #if defined(DEBUG_NODE_INPUTS_OUTPUTS)
 // to create a build with these enabled run the build script with
 //   --cmake_extra_defines onnxruntime_DEBUG_NODE_INPUTS_OUTPUTS=ON
@@ -41,6 +41,37 @@ void RegisterAutoMLSchemas() {
           "Constrain output type to an AutoML specific Microsoft::Featurizers::TimePoint type"
           "currently not part of ONNX standard. When it becomes a part of the standard we will adjust this"
           "kernel definition and move it to ONNX repo");
+
+  static const char* DateTimeBatchTransformer_ver1_doc = R"DOC(
+    DateTimeBatchTransformer splits every timestamp of an int64 tensor into the fields of
+    Microsoft::DateTimeFeaturizer::TimePoint, as DateTimeTransformer does for a scalar. The fields
+    of each timestamp are stored in the last dimension of the output in the order of TimePoint:
+    year, month, day, hour, minute, second, dayOfWeek, dayOfYear, quarterOfYear and weekOfMonth.
+  )DOC";
+
+  MS_AUTOML_OPERATOR_SCHEMA(DateTimeBatchTransformer)
+      .SinceVersion(1)
+      .SetDomain(kMSAutoMLDomain)
+      .SetDoc(DateTimeBatchTransformer_ver1_doc)
+      .Input(0, "X", "The numbers of seconds passed since the epoch, which can't be negative", "T1")
+      .Output(0, "Y", "The fields of the timestamps, with the shape of X and an extra last dimension of 10", "T2")
+      .TypeConstraint(
+          "T1",
+          {"tensor(int64)"},
+          "Constrain input type to int64 tensor.")
+      .TypeConstraint(
+          "T2",
+          {"tensor(int32)"},
+          "Constrain output type to int32 tensor.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT32);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 0);
+        output_shape.add_dim()->set_dim_value(10);
+        updateOutputShape(ctx, 0, output_shape);
+      });
 }
 }  // namespace automl
 }  // namespace onnxruntime
@@ -189,6 +189,251 @@ void RegisterNchwcSchemas() {
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
       .FillUsing(NchwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Upsample)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "scales",
+          "",
+          AttributeProto::INTS)
+      .Input(0, "X", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        auto& input_shape = getInputShape(ctx, 0);
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("tensor must have rank 4");
+        }
+        std::vector<int64_t> scales;
+        if (!getRepeatedAttribute(ctx, "scales", scales) || scales.size() != 4) {
+          fail_shape_inference("scales must have 4 values");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < 4; i++) {
+          auto* output_dim = output_shape->add_dim();
+          auto& input_dim = input_shape.dim(i);
+          if (input_dim.has_dim_value()) {
+            output_dim->set_dim_value(input_dim.dim_value() * scales[i]);
+          } else if (scales[i] == 1) {
+            *output_dim = input_dim;
+          }
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Mul)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Input(0, "X", "", "T")
+      .Input(1, "S", "", "T")
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+}
+
+// Infers the [N, H, W, M] output shape of a 2D convolution or pooling of a [N, H, W, C] input. Convolution takes
+// M and the kernel shape from the [M, C, kernel_h, kernel_w] weights, and pooling keeps the C channels.
+void NhwcConvPoolShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, bool has_weights) {
+  if (!hasInputShape(ctx, 0) || (has_weights && !hasInputShape(ctx, 1))) {
+    return;
+  }
+
+  auto& input_shape = getInputShape(ctx, 0);
+  if (input_shape.dim_size() != 4) {
+    fail_shape_inference("Input tensor must have 4 dimensions");
+  }
+
+  std::vector<int64_t> kernel_shape;
+  if (has_weights) {
+    auto& weight_shape = getInputShape(ctx, 1);
+    if (weight_shape.dim_size() != 4) {
+      fail_shape_inference("Weight tensor must have 4 dimensions");
+    }
+    for (int i = 2; i < 4; ++i) {
+      if (!weight_shape.dim(i).has_dim_value()) {
+        return;
+      }
+      kernel_shape.push_back(weight_shape.dim(i).dim_value());
+    }
+  } else if (!getRepeatedAttribute(ctx, "kernel_shape", kernel_shape) || kernel_shape.size() != 2) {
+    fail_shape_inference("Attribute kernel_shape must be specified with 2 values");
+  }
+
+  std::vector<int64_t> pads;
+  if (!getRepeatedAttribute(ctx, "pads", pads)) {
+    pads.assign(4, 0);
+  }
+  std::vector<int64_t> strides;
+  if (!getRepeatedAttribute(ctx, "strides", strides)) {
+    strides.assign(2, 1);
+  }
+  std::vector<int64_t> dilations;
+  if (!getRepeatedAttribute(ctx, "dilations", dilations)) {
+    dilations.assign(2, 1);
+  }
+  if (pads.size() != 4 || strides.size() != 2 || dilations.size() != 2) {
+    fail_shape_inference("Attributes pads, strides and dilations must match the 2 spatial dimensions");
+  }
+
+  const auto* auto_pad_attr = ctx.getAttribute("auto_pad");
+  const std::string auto_pad = auto_pad_attr != nullptr ? auto_pad_attr->s() : "NOTSET";
+  const bool ceil_mode = getAttribute(ctx, "ceil_mode", 0) != 0;
+
+  auto* output_shape = getOutputShape(ctx, 0);
+  *output_shape->add_dim() = input_shape.dim(0);
+  for (int i = 0; i < 2; ++i) {
+    auto* output_dim = output_shape->add_dim();
+    if (!input_shape.dim(1 + i).has_dim_value()) {
+      continue;
+    }
+
+    const int64_t input_size = input_shape.dim(1 + i).dim_value();
+    if (auto_pad == "SAME_UPPER" || auto_pad == "SAME_LOWER") {
+      output_dim->set_dim_value((input_size + strides[i] - 1) / strides[i]);
+      continue;
+    }
+
+    const int64_t total_pad = auto_pad == "VALID" ? 0 : pads[i] + pads[i + 2];
+    const int64_t effective_size = input_size + total_pad - dilations[i] * (kernel_shape[i] - 1) - 1;
+    if (effective_size < 0) {
+      fail_shape_inference("The padded input is smaller than the kernel");
+    }
+    output_dim->set_dim_value((ceil_mode ? (effective_size + strides[i] - 1) : effective_size) / strides[i] + 1);
+  }
+  if (has_weights) {
+    *output_shape->add_dim() = getInputShape(ctx, 1).dim(0);
+  } else {
+    *output_shape->add_dim() = input_shape.dim(3);
+  }
+}
+
+void NhwcPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSNhwcDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"));
+  schema.Attr("kernel_shape", "", AttributeProto::INTS);
+  schema.Attr("dilations", "", AttributeProto::INTS, OPTIONAL);
+  schema.Attr("strides", "", AttributeProto::INTS, OPTIONAL);
+  schema.Attr("pads", "", AttributeProto::INTS, OPTIONAL);
+  schema.Attr("ceil_mode", "", AttributeProto::INT, static_cast<int64_t>(0));
+  schema.Input(0, "X", "", "T");
+  schema.Output(0, "Y", "", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+    NhwcConvPoolShapeInference(ctx, false);
+  });
+}
+
+void NhwcGlobalPoolOpSchemaGenerator(OpSchema& schema) {
+  schema.SetDomain(kMSNhwcDomain);
+  schema.SinceVersion(1);
+  schema.SetDoc(R"DOC(For internal use.)DOC");
+  schema.Input(0, "X", "", "T");
+  schema.Output(0, "Y", "", "T");
+  schema.TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors");
+  schema.TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+    if (!hasInputShape(ctx, 0)) {
+      return;
+    }
+    auto& input_shape = getInputShape(ctx, 0);
+    if (input_shape.dim_size() != 4) {
+      fail_shape_inference("Input tensor must have 4 dimensions");
+    }
+    auto* output_shape = getOutputShape(ctx, 0);
+    *output_shape->add_dim() = input_shape.dim(0);
+    output_shape->add_dim()->set_dim_value(1);
+    output_shape->add_dim()->set_dim_value(1);
+    *output_shape->add_dim() = input_shape.dim(3);
+  });
+}
+
+// The NHWC schemas mirror the ONNX Conv/FusedConv and pooling operators for images with the channels innermost.
+void RegisterNhwcSchemas() {
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Conv)
+      .SetDomain(kMSNhwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr(
+          "auto_pad",
+          "",
+          AttributeProto::STRING,
+          std::string("NOTSET"))
+      .Attr(
+          "kernel_shape",
+          "",
+          AttributeProto::INTS,
+          OPTIONAL)
+      .Attr(
+          "dilations",
+          "",
+          AttributeProto::INTS,
+          OPTIONAL)
+      .Attr(
+          "strides",
+          "",
+          AttributeProto::INTS,
+          OPTIONAL)
+      .Attr(
+          "pads",
+          "",
+          AttributeProto::INTS, OPTIONAL)
+      .Attr(
+          "group",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(1))
+      .Attr(
+          "activation",
+          "",
+          AttributeProto::STRING,
+          OPTIONAL)
+      .Attr(
+          "activation_params",
+          "",
+          AttributeProto::FLOATS,
+          OPTIONAL)
+      .Input(0, "X", "", "T")
+      .Input(1, "W", "", "T")
+      .Input(2, "B", "", "T", OpSchema::Optional)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        NhwcConvPoolShapeInference(ctx, true);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MaxPool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr(
+          "storage_order",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(AveragePool)
+      .FillUsing(NhwcPoolOpSchemaGenerator)
+      .Attr(
+          "count_include_pad",
+          "",
+          AttributeProto::INT,
+          static_cast<int64_t>(0));
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalMaxPool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GlobalAveragePool)
+      .FillUsing(NhwcGlobalPoolOpSchemaGenerator);
 }
 
 void RegisterContribSchemas() {
@@ -1271,6 +1516,62 @@ Matrix product that behaves like numpy.matmul: https://docs.scipy.org/doc/numpy-
         matmulShapeInference(ctx, 0, 1);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(DynamicQuantizeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product that behaves like numpy.matmul of A, quantized to uint8 like DynamicQuantizeLinear does, and of the
+quantized B, dequantized to float with the scales of A and B: the fusion of DynamicQuantizeLinear, MatMulInteger,
+Cast and Mul, optionally followed by the Add of a bias.)DOC")
+      .Input(0, "A", "N-dimensional float matrix A", "T1")
+      .Input(1, "B", "N-dimensional quantized matrix B", "T2")
+      .Input(2, "b_scale", "Scale of B, a scalar", "T1")
+      .Input(3, "b_zero_point", "Zero point of B, a scalar. 0 if not specified.", "T2", OpSchema::Optional)
+      .Input(4, "bias", "1D bias of N elements added to each row of the output", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain A, the scales, the bias and Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain B and its zero point to 8-bit unsigned integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        matmulShapeInference(ctx, 0, 1);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulWeightInt8)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product that behaves like numpy.matmul of A and of the 2D B stored as int8 weights with a scale per
+column: B = B_quantized * b_scale, optionally followed by the Add of a bias.)DOC")
+      .Input(0, "A", "N-dimensional float matrix A", "T1")
+      .Input(1, "B", "2D quantized matrix B of shape [K, N]", "T2")
+      .Input(2, "b_scale", "1D scale of the N columns of B", "T1")
+      .Input(3, "bias", "1D bias of N elements added to each row of the output", "T1", OpSchema::Optional)
+      .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain A, the scales, the bias and Y to float tensors.")
+      .TypeConstraint("T2", {"tensor(int8)"}, "Constrain B to 8-bit signed integer tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        matmulShapeInference(ctx, 0, 1);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseToDenseMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+Matrix product of a 2D sparse A and a 2D dense B, as Gemm without C computes it: Y = alpha * A' * B', where
+A' = transpose(A) if transA else A, and B' = transpose(B) if transB else B.)DOC")
+      .Input(0, "A", "2D sparse matrix A", "T1")
+      .Input(1, "B", "2D dense matrix B", "T")
+      .Output(0, "Y", "Dense matrix product", "T")
+      .Attr("alpha", "Scalar multiplier for the product of the input tensors.", AttributeProto::FLOAT, 1.0f)
+      .Attr("transA", "Whether A should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("transB", "Whether B should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .TypeConstraint("T1", {"sparse_tensor(float)"}, "Constrain A to float sparse tensors.")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain B and Y to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 1, 0);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ReduceSumInteger)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1334,6 +1635,37 @@ with the exception that numpy default keepdims to False instead of True.)DOC")
         updateOutputShape(ctx, 0, input_shape);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(HashedEmbedding)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(Feature hashing followed by an embedding lookup. Each element of X is hashed with MurmurHash3_x86_32 as
+by the MurmurHash3 op, and row (hash modulo the number of rows of W) of W is copied to the output. This computes
+MurmurHash3, Mod and Gather in one pass without materializing the hashes.)DOC")
+      .Input(0, "X", "An input tensor to hash.", "T1")
+      .Input(1, "W", "Embedding table of shape [num_buckets, D].", "T")
+      .Output(0, "Y", "The embedding rows of the hashed keys, of shape X.shape + [D].", "T")
+      .TypeConstraint("T1", {"tensor(uint32)", "tensor(int32)", "tensor(string)"}, "Constrain input type to unsigned or signed 32-bit integer tensor, or string tensor. It should be utf-8 encoded if using unicode.")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain the embedding table and output to float tensors.")
+      .Attr(
+          "seed",
+          "Seed for the hashing algorithm, unsigned 32-bit integer, default to 0.",
+          AttributeProto::INT,
+          (int64_t)0LL)
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 1, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1))
+          return;
+
+        auto& table_shape = getInputShape(ctx, 1);
+        if (table_shape.dim_size() != 2) {
+          fail_shape_inference("W must be 2D");
+        }
+
+        ONNX_NAMESPACE::TensorShapeProto output_shape(getInputShape(ctx, 0));
+        *output_shape.add_dim() = table_shape.dim(1);
+        updateOutputShape(ctx, 0, output_shape);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(GatherND)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1627,6 +1959,38 @@ Example 4:
               "T")
       .TypeConstraint("T", {"tensor(float)", "tensor(double)"}, "Constrains input to only numeric types.");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(CDistTopK)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc("CDist followed by a TopK of the k smallest distances of each row, "
+              "computed without materializing the full distance matrix.")
+      .Attr("metric", "The distance metric to use, \"euclidean\" or \"sqeuclidean\".", AttributeProto::STRING,
+            std::string("sqeuclidean"))
+      .Attr("k", "Number of nearest rows of B to retrieve for each row of A.", AttributeProto::INT)
+      .Input(0, "A", "2D matrix with shape (M,N)", "T")
+      .Input(1, "B", "2D matrix with shape (K,N)", "T")
+      .Output(0, "Values", "The k smallest distances of each row of A in ascending order, with shape (M,k)", "T")
+      .Output(1, "Indices", "The rows of B the values are the distances to, with shape (M,k)", "I")
+      .TypeConstraint("T", {"tensor(float)", "tensor(double)"}, "Constrains input to only numeric types.")
+      .TypeConstraint("I", {"tensor(int64)"}, "Constrain index tensor to int64")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        const auto& a_shape = getInputShape(ctx, 0);
+        if (a_shape.dim_size() != 2) {
+          fail_shape_inference("CDistTopK input A must be 2D");
+        }
+        const int64_t k = getAttribute(ctx, "k", 0);
+        ONNX_NAMESPACE::TensorShapeProto output_shape;
+        *output_shape.add_dim() = a_shape.dim(0);
+        output_shape.add_dim()->set_dim_value(k);
+        updateOutputShape(ctx, 0, output_shape);
+        updateOutputShape(ctx, 1, output_shape);
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(CropAndResize)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -1718,6 +2082,330 @@ Example 4:
         a fixed size = [crop_height, crop_width]. The result is a 4-D tensor [num_boxes, crop_height, crop_width, depth].
         The resizing is corner aligned.)DOC");
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(LayerNormalization)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Normalizes each slice of X over the dimensions starting at 'axis' to zero mean and unit variance,
+        then applies the elementwise affine transform: Y = (X - mean) / sqrt(variance + epsilon) * scale + B.
+        This is the computation exported by frameworks as ReduceMean, Sub, Pow, ReduceMean, Add, Sqrt, Div, Mul
+        and Add.)DOC")
+      .Attr("axis",
+            "The first normalization dimension. Negative value means counting dimensions from the back.",
+            AttributeProto::INT, static_cast<int64_t>(-1))
+      .Attr("epsilon",
+            "The epsilon value to use to avoid division by zero.",
+            AttributeProto::FLOAT, 1e-5f)
+      .Input(0, "X", "Input data tensor.", "T")
+      .Input(1, "scale", "Scale tensor with the shape of the normalized dimensions.", "T")
+      .Input(2, "B", "Bias tensor with the shape of the normalized dimensions.", "T")
+      .Output(0, "Y", "Output data tensor with the same shape as X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+        propagateShapeFromInputToOutput(ctx, 0, 0);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Gelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Gaussian Error Linear Unit: Y = 0.5 * X * (1 + erf(X / sqrt(2))).
+        This is the computation exported by frameworks as Div, Erf, Add, Mul and Mul.)DOC")
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor with the same shape as X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FastGelu)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Tanh approximation of the Gaussian Error Linear Unit:
+        Y = 0.5 * X * (1 + tanh(sqrt(2 / pi) * (X + 0.044715 * X^3))).)DOC")
+      .Input(0, "X", "Input data tensor.", "T")
+      .Output(0, "Y", "Output data tensor with the same shape as X.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)", "tensor(double)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(Attention)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Multi-head self attention. The input is projected to Q, K and V with one matrix multiplication by the
+        concatenated weights, and each head computes softmax(Q x K' / sqrt(head_size) + mask) x V.
+        The results of the heads are concatenated along the hidden dimension.)DOC")
+      .Attr("num_heads", "Number of attention heads", AttributeProto::INT)
+      .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .Input(1, "weight", "2D input tensor with shape (hidden_size, 3 * hidden_size), the Q, K and V weights concatenated along the second dimension", "T")
+      .Input(2, "bias", "1D input tensor with shape (3 * hidden_size), the Q, K and V biases", "T")
+      .Input(3, "mask", "Optional additive attention mask with shape (batch_size, sequence_length) or (batch_size, 1, 1, sequence_length)", "T", OpSchema::Optional)
+      .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float16)", "tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(TransposeMatMul)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Matrix product that behaves like numpy.matmul, after optionally swapping the last two dimensions of A
+        and/or B, scaled by alpha. This is the computation of a Transpose of the last two dimensions followed by
+        MatMul, and of a MatMul followed by a multiplication with a scalar.)DOC")
+      .Attr("transA", "Whether A should be transposed on the last two dimensions before the multiplication",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("transB", "Whether B should be transposed on the last two dimensions before the multiplication",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("alpha", "Scalar multiplier for the product of the input tensors", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "A", "N-dimensional matrix A", "T")
+      .Input(1, "B", "N-dimensional matrix B", "T")
+      .Output(0, "Y", "Matrix multiply results", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 2)) {
+          return;
+        }
+
+        auto a_shape = ctx.getInputType(0)->tensor_type().shape();
+        auto b_shape = ctx.getInputType(1)->tensor_type().shape();
+        const int rank = a_shape.dim_size();
+        // only the common case of equal ranks is inferred here, the kernel handles broadcasting the rest
+        if (rank < 2 || b_shape.dim_size() != rank) {
+          return;
+        }
+        if (getAttribute(ctx, "transA", 0) != 0) {
+          a_shape.mutable_dim(rank - 2)->Swap(a_shape.mutable_dim(rank - 1));
+        }
+        if (getAttribute(ctx, "transB", 0) != 0) {
+          b_shape.mutable_dim(rank - 2)->Swap(b_shape.mutable_dim(rank - 1));
+        }
+
+        auto* y_shape = getOutputShape(ctx, 0);
+        for (int i = 0; i < rank - 2; ++i) {
+          const auto& a_dim = a_shape.dim(i);
+          const bool a_is_one = a_dim.has_dim_value() && a_dim.dim_value() == 1;
+          *y_shape->add_dim() = a_is_one ? b_shape.dim(i) : a_dim;
+        }
+        *y_shape->add_dim() = a_shape.dim(rank - 2);
+        *y_shape->add_dim() = b_shape.dim(rank - 1);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedElementwise)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Chain of elementwise operators evaluated in a single pass over the input. Starting from the first input,
+        each entry of 'ops' is applied to the result of the previous one. The unary operators are Abs, Exp, Neg,
+        Relu, Sigmoid and Tanh. The binary operators Add, Sub, Mul and Div each consume the next of the remaining
+        inputs, which must have the same number of elements as the first input, a single element, or the size of
+        the last dimension of the first input to be broadcast along it.)DOC")
+      .Attr("ops", "The operators of the chain, in order of evaluation", AttributeProto::STRINGS)
+      .Attr("operand_first",
+            "For each binary operator, whether its input is the first operand and the chain value the second",
+            AttributeProto::INTS, OPTIONAL)
+      .Input(0, "inputs", "The input of the chain followed by the inputs of its binary operators", "T",
+             OpSchema::Variadic)
+      .Output(0, "Y", "Output data tensor with the same shape as the first input.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(FusedMLPreprocessing)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Chain of the ai.onnx.ml preprocessing operators Imputer, Scaler, Normalizer and Binarizer applied to each
+        row of a [N, C] feature matrix in a single pass. Each entry of 'ops' is applied to the result of the
+        previous one with the semantics of the operator. 'feature_values' holds the C imputed values of each
+        Imputer and the C offsets followed by the C scales of each Scaler, 'scalar_values' the replaced value of
+        each Imputer and the threshold of each Binarizer, and 'norms' the norm of each Normalizer, all in the
+        order of the operators in 'ops'.)DOC")
+      .Attr("ops", "The operators of the chain, in order of evaluation", AttributeProto::STRINGS)
+      .Attr("feature_values", "The per feature parameters of the Imputer and Scaler operators",
+            AttributeProto::FLOATS, OPTIONAL)
+      .Attr("scalar_values", "The replaced values of the Imputer and thresholds of the Binarizer operators",
+            AttributeProto::FLOATS, OPTIONAL)
+      .Attr("norms", "The norms of the Normalizer operators, one of 'MAX', 'L1' or 'L2'",
+            AttributeProto::STRINGS, OPTIONAL)
+      .Input(0, "X", "Feature matrix of shape [N, C].", "T")
+      .Output(0, "Y", "Output data tensor with the same shape as the input.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput);
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GatherSum)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Embedding bag lookup. Each bag along the last axis of 'indices' selects rows of 'data' along its first
+        axis, and the rows of a bag are summed. This is Gather with axis 0 followed by ReduceSum over the last
+        axis of the indices with keepdims 0. An empty bag produces zeros.)DOC")
+      .Input(0, "data", "Tensor of rank r >= 1.", "T")
+      .Input(1, "indices", "Tensor of rank q >= 1.", "Tind")
+      .Output(0, "output", "Tensor of rank q-1+r-1.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeConstraint(
+          "Tind",
+          {"tensor(int32)", "tensor(int64)"},
+          "Constrain indice type to int32 or int64")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 2)) {
+          return;
+        }
+        auto& data_shape = ctx.getInputType(0)->tensor_type().shape();
+        auto& indices_shape = ctx.getInputType(1)->tensor_type().shape();
+        auto data_rank = data_shape.dim_size();
+        auto indices_rank = indices_shape.dim_size();
+        if (data_rank < 1 || indices_rank < 1) {
+          fail_shape_inference("both data and indices tensor need to have rank larger than zero.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < indices_rank - 1; ++i) {
+          *output_shape->add_dim() = indices_shape.dim(i);
+        }
+        for (int i = 1; i < data_rank; ++i) {
+          *output_shape->add_dim() = data_shape.dim(i);
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(GatherWeightInt8)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Gather along axis 0 of an embedding table stored as int8 rows with a scale per row:
+        output = Gather(data * scale[:, None], indices). Only the gathered rows are dequantized.)DOC")
+      .Input(0, "data", "Quantized tensor of rank r >= 1.", "T2")
+      .Input(1, "scale", "1D scale of the rows of data along its first axis.", "T1")
+      .Input(2, "indices", "Tensor of rank q.", "Tind")
+      .Output(0, "output", "Tensor of rank q+r-1.", "T1")
+      .TypeConstraint("T1", {"tensor(float)"}, "Constrain the scale and the output to float tensors.")
+      .TypeConstraint("T2", {"tensor(int8)"}, "Constrain data to 8-bit signed integer tensors.")
+      .TypeConstraint(
+          "Tind",
+          {"tensor(int32)", "tensor(int64)"},
+          "Constrain indice type to int32 or int64")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 1, 0);
+        if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+          return;
+        }
+        auto& data_shape = ctx.getInputType(0)->tensor_type().shape();
+        auto& indices_shape = ctx.getInputType(2)->tensor_type().shape();
+        if (data_shape.dim_size() < 1) {
+          fail_shape_inference("data tensor must have rank larger than zero.");
+        }
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        for (int i = 0; i < indices_shape.dim_size(); ++i) {
+          *output_shape->add_dim() = indices_shape.dim(i);
+        }
+        for (int i = 1; i < data_shape.dim_size(); ++i) {
+          *output_shape->add_dim() = data_shape.dim(i);
+        }
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(SparseGatherSum)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Embedding bag lookup with sparse indices, as GatherSum does with dense ones. Row b of the 2D sparse
+        'indices' is bag b, whose non-zero values are the indices of the rows of 'data' along its first axis
+        summed into output[b], so the bags of different sizes need no padding. An empty bag produces zeros.)DOC")
+      .Input(0, "data", "Tensor of rank r >= 1.", "T")
+      .Input(1, "indices", "Sparse tensor of shape [bags, max_bag_size].", "Tind")
+      .Output(0, "output", "Tensor of rank r, with the first dimension of indices then those of a row of data.", "T")
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeConstraint(
+          "Tind",
+          {"sparse_tensor(int64)"},
+          "Constrain indices to int64 sparse tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        propagateElemTypeFromInputToOutput(ctx, 0, 0);
+      });
+
+  ONNX_CONTRIB_OPERATOR_SCHEMA(BeamSearch)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(
+        Autoregressive generation with beam search, or greedy search when num_beams is 1. The 'decoder' graph is run
+        once per generated token, with the input ids of shape (batch_size * num_beams, sequence_length) followed by
+        the past states, and returns the logits of shape (batch_size * num_beams, vocab_size) or
+        (batch_size * num_beams, sequence_length, vocab_size), of which the last position is used, followed by the
+        present states. The first run gets the whole prompt and the initial states, repeated for the beams of each
+        batch entry. The following runs get the new tokens and the present states of the previous run, reordered
+        to follow the beams. A decoder without states gets the whole sequences every run.
+        The sequences are scored by their sum of log probabilities divided by length ^ length_penalty, and the
+        search of a batch entry stops when num_beams sequences ended with eos_token_id and no running beam can do
+        better, or as soon as they did with early_stopping.)DOC")
+      .Attr("decoder", "The decoder graph run for each generated token.", AttributeProto::GRAPH)
+      .Attr("eos_token_id", "The token ending a sequence.", AttributeProto::INT)
+      .Attr("pad_token_id", "The token filling the sequences after their end. Defaults to eos_token_id.",
+            AttributeProto::INT, OPTIONAL)
+      .Attr("num_beams", "The number of beams searched for each batch entry.", AttributeProto::INT,
+            static_cast<int64_t>(1))
+      .Attr("length_penalty", "The exponent of the sequence length dividing the score of a sequence.",
+            AttributeProto::FLOAT, 1.0f)
+      .Attr("early_stopping", "Whether the search of a batch entry stops when num_beams sequences ended.",
+            AttributeProto::INT, static_cast<int64_t>(0))
+      .Input(0, "input_ids", "The prompt, with shape (batch_size, sequence_length).", "tensor(int64)")
+      .Input(1, "max_length", "Scalar with the length of the sequences including the prompt.", "tensor(int64)")
+      .Input(2, "initial_states", "The past states of the first decoder run, with batch_size entries in dimension 0.",
+             "V", OpSchema::Variadic, false, 0)
+      .Output(0, "sequences", "The best sequence of each batch entry including the prompt, padded to the longest.",
+              "tensor(int64)")
+      .Output(1, "sequences_scores", "The score of each sequence, with shape (batch_size).", "tensor(float)",
+              OpSchema::Optional)
+      .TypeConstraint("V", OpSchema::all_tensor_types(), "All Tensor types")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT64);
+        if (ctx.getNumOutputs() > 1) {
+          ONNX_NAMESPACE::updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::FLOAT);
+        }
+        if (!hasInputShape(ctx, 0)) {
+          return;
+        }
+        auto& input_ids_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_ids_shape.dim_size() != 2) {
+          fail_shape_inference("input_ids should have rank 2.");
+        }
+        auto* sequences_shape = getOutputShape(ctx, 0);
+        *sequences_shape->add_dim() = input_ids_shape.dim(0);
+        sequences_shape->add_dim();
+        if (ctx.getNumOutputs() > 1) {
+          *getOutputShape(ctx, 1)->add_dim() = input_ids_shape.dim(0);
+        }
+      });
+
+  RegisterNhwcSchemas();
+
   // Register the NCHWc schemas if supported by the platform.
   if (MlasNchwcGetBlockSize() > 1) {
     RegisterNchwcSchemas();
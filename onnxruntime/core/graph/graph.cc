@@ -6,6 +6,7 @@
 #pragma warning(disable : 4244)
 #endif
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <numeric>
@@ -22,6 +23,7 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/indexed_sub_graph.h"
 #include "core/graph/schema_registry.h"
+#include "core/graph/symbolic_shape_inference.h"
 #include "core/graph/op.h"
 
 #include "onnx/checker.h"
@@ -86,7 +88,30 @@ static TypeProto TypeProtoFromTensorProto(const TensorProto& tensor) {
   return t;
 }
 
-NodeArg::NodeArg(const std::string& name, const TypeProto* p_node_arg_type) {
+static uint64_t NextNodeArgVersion() {
+  static std::atomic<uint64_t> version{0};
+  return ++version;
+}
+
+static bool ShapesAreEqual(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    const auto& l = lhs.dim(i);
+    const auto& r = rhs.dim(i);
+    if (l.value_case() != r.value_case() || l.denotation() != r.denotation() ||
+        (utils::HasDimValue(l) && l.dim_value() != r.dim_value()) ||
+        (utils::HasDimParam(l) && l.dim_param() != r.dim_param())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+NodeArg::NodeArg(const std::string& name, const TypeProto* p_node_arg_type) : version_(NextNodeArgVersion()) {
   node_arg_info_.set_name(name);
   // If the name is empty, it means the arg does not exist.
   exists_ = !(name.empty());
@@ -141,6 +166,11 @@ const TensorShapeProto* NodeArg::Shape() const {
 }
 
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  const auto* current_shape = Shape();
+  if (current_shape != nullptr && ShapesAreEqual(*current_shape, shape)) {
+    return;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -156,12 +186,15 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
     default:
       return;
   }
+
+  version_ = NextNodeArgVersion();
 }
 
 common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& input_type) {
   if (!utils::HasType(node_arg_info_)) {
     *node_arg_info_.mutable_type() = input_type;
     type_ = DataTypeUtils::ToType(node_arg_info_.type());
+    version_ = NextNodeArgVersion();
     return Status::OK();
   }
 
@@ -191,6 +224,8 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
         } else {
           current_tensor_type = input_tensor_type;
         }
+        // the merge may have filled in dimensions
+        version_ = NextNodeArgVersion();
       }
 
       break;
@@ -212,6 +247,7 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
           // mergeInShapeInfo(input_tensor_type, current_tensor_type);
         } else {
           current_tensor_type = input_tensor_type;
+          version_ = NextNodeArgVersion();
         }
       }
     } break;
@@ -241,11 +277,13 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  version_ = NextNodeArgVersion();
 }
 
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  version_ = NextNodeArgVersion();
 }
 
 bool NodeArg::Exists() const noexcept {
@@ -437,6 +475,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttribute(const std::string& attr_name, const AttributeProto& value) {
   graph_->SetGraphResolveNeeded();
+  graph_->SetNodeInferencingNeeded(index_);
   graph_->SetGraphProtoSyncNeeded();
   attributes_[attr_name] = value;
 }
@@ -444,6 +483,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 #define ADD_BASIC_ATTR_IMPL(type, enumType, field)                           \
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
+    graph_->SetNodeInferencingNeeded(index_);                                \
     graph_->SetGraphProtoSyncNeeded();                                       \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
@@ -455,6 +495,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 #define ADD_ATTR_IMPL(type, enumType, field)                                 \
   void Node::AddAttribute(const std::string& attr_name, const type& value) { \
     graph_->SetGraphResolveNeeded();                                         \
+    graph_->SetNodeInferencingNeeded(index_);                                \
     graph_->SetGraphProtoSyncNeeded();                                       \
     AttributeProto a;                                                        \
     a.set_name(attr_name);                                                   \
@@ -467,6 +508,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
   void Node::AddAttribute(const std::string& attr_name,      \
                           const std::vector<type>& values) { \
     graph_->SetGraphResolveNeeded();                         \
+    graph_->SetNodeInferencingNeeded(index_);                \
     graph_->SetGraphProtoSyncNeeded();                       \
     AttributeProto a;                                        \
     a.set_name(attr_name);                                   \
@@ -479,6 +521,7 @@ void Node::AddAttribute(const std::string& attr_name, const AttributeProto& valu
 
 void Node::AddAttribute(const std::string& attr_name, const GraphProto& value) {
   graph_->SetGraphResolveNeeded();
+  graph_->SetNodeInferencingNeeded(index_);
   graph_->SetGraphProtoSyncNeeded();
   AttributeProto a;
   a.set_name(attr_name);
@@ -503,6 +546,7 @@ ADD_LIST_ATTR_IMPL(SparseTensorProto, AttributeProto_AttributeType::AttributePro
 
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
+  graph_->SetNodeInferencingNeeded(index_);
   graph_->SetGraphProtoSyncNeeded();
   return attributes_.erase(attr_name) > 0;
 }
@@ -1709,12 +1753,13 @@ Status Graph::VerifyNodeAndOpMatch() {
   // and need to call Resolve
   lsc.output_names.insert(outer_scope_node_arg_names_.cbegin(), outer_scope_node_arg_names_.cend());
 
+  // infers the shapes that depend on values computed from other shapes, which ONNX inference loses
+  SymbolicShapeInference symbolic_shape_inference(*this);
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
-    NodeProto node_proto;
-    node.ToProto(node_proto);
     auto& node_name = node.Name();
     auto& domain = node.Domain();
 
@@ -1727,6 +1772,8 @@ Status Graph::VerifyNodeAndOpMatch() {
     }
 
     if (!node.Op()) {
+      NodeProto node_proto;
+      node.ToProto(node_proto);
       try {
         checker::check_node(node_proto, ctx, lsc);
       } catch (const std::exception& ex) {
@@ -1783,17 +1830,69 @@ Status Graph::VerifyNodeAndOpMatch() {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+    // the symbolic inference runs for every node as it needs the values of all the shape computations upstream
+    if (NodeInferencingNeeded(node)) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op)));
+      NO_CHANGE_ON_SYNC_FLAG(symbolic_shape_inference.InferNode(node));
+      SetNodeInferred(node);
+    } else {
+      NO_CHANGE_ON_SYNC_FLAG(symbolic_shape_inference.InferNode(node));
+    }
 
     // Accumulate output names of the iterated Node
-    for (auto& output_name : node_proto.output()) {
-      lsc.output_names.insert(output_name);
+    for (const auto* output_def : node.OutputDefs()) {
+      lsc.output_names.insert(output_def->Name());
     }
   }
 
   return Status::OK();
 }
 
+bool Graph::NodeInferencingNeeded(const Node& node) const {
+  // subgraphs get their inputs from the node containing them, and the outer scope values through names,
+  // neither of which the versions of the NodeArgs of their nodes show, so they are fully inferred
+  if (IsSubgraph() || node.ContainsSubgraph() || nodes_to_infer_.count(node.Index()) != 0 ||
+      node.Index() >= inferred_node_args_.size()) {
+    return true;
+  }
+
+  const auto& inferred = inferred_node_args_[node.Index()];
+  const auto& input_defs = node.GetDefinitions().input_defs;
+  const auto& output_defs = node.GetDefinitions().output_defs;
+  if (inferred.size() != input_defs.size() + output_defs.size()) {
+    return true;
+  }
+
+  size_t i = 0;
+  for (const auto* defs : {&input_defs, &output_defs}) {
+    for (const auto* def : *defs) {
+      if (inferred[i].first != def || inferred[i].second != def->version_) {
+        return true;
+      }
+      ++i;
+    }
+  }
+
+  return false;
+}
+
+void Graph::SetNodeInferred(const Node& node) {
+  if (node.Index() >= inferred_node_args_.size()) {
+    inferred_node_args_.resize(nodes_.size());
+  }
+
+  auto& inferred = inferred_node_args_[node.Index()];
+  inferred.clear();
+  const auto& definitions = node.GetDefinitions();
+  for (const auto* defs : {&definitions.input_defs, &definitions.output_defs}) {
+    for (const auto* def : *defs) {
+      inferred.emplace_back(def, def->version_);
+    }
+  }
+
+  nodes_to_infer_.erase(node.Index());
+}
+
 void Graph::FindAllSubgraphs(std::vector<Graph*>& subgraphs) {
   for (auto& node : Nodes()) {
     for (auto& subgraph : node.MutableSubgraphs()) {
@@ -1984,14 +2083,24 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
     ORT_IGNORE_RETURN_VALUE(GetOrCreateNodeArg(tensor.name(), &t));
   }
 
+  // the inferencing of the consumers may read the value
+  SetNodeArgChanged(tensor.name());
   SetGraphProtoSyncNeeded();
   SetGraphResolveNeeded();
 }
 
+void Graph::SetNodeArgChanged(const std::string& name) {
+  auto iter = node_args_.find(name);
+  if (iter != node_args_.end()) {
+    iter->second->version_ = NextNodeArgVersion();
+  }
+}
+
 void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   auto iter = name_to_initial_tensor_.find(tensor_name);
   if (name_to_initial_tensor_.end() != iter) {
     name_to_initial_tensor_.erase(tensor_name);
+    SetNodeArgChanged(tensor_name);
     SetGraphProtoSyncNeeded();
     SetGraphResolveNeeded();
   }
@@ -2547,6 +2656,10 @@ bool Graph::ReleaseNode(NodeIndex index) {
   // index is valid, but the entry may already be empty
   if (nodes_[index] != nullptr) {
     nodes_[index] = nullptr;
+    if (index < inferred_node_args_.size()) {
+      inferred_node_args_[index].clear();
+    }
+    nodes_to_infer_.erase(index);
     --num_of_nodes_;
     graph_proto_sync_needed_ = true;
     graph_resolve_needed_ = true;
@@ -204,6 +204,20 @@ const ModelMetaData& Model::MetaData() const noexcept {
   return model_metadata_;
 }
 
+void Model::SetMetaDataEntry(const std::string& key, const std::string& value) {
+  model_metadata_[key] = value;
+  for (auto& prop : *model_proto_->mutable_metadata_props()) {
+    if (prop.key() == key) {
+      prop.set_value(value);
+      return;
+    }
+  }
+
+  const gsl::not_null<StringStringEntryProto*> prop{model_proto_->add_metadata_props()};
+  prop->set_key(key);
+  prop->set_value(value);
+}
+
 Graph& Model::MainGraph() noexcept {
   return *graph_;
 }
@@ -276,8 +290,8 @@ Status Model::Load(std::unique_ptr<ModelProto> p_model_proto, std::shared_ptr<Mo
   return Status::OK();
 }
 
-template <typename T>
-static Status LoadModel(const T& file_path, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
+template <typename T, typename TLoader>
+static Status LoadModel(const T& file_path, const TLoader& loader) {
   int fd;
   Status status = Env::Default().FileOpenRd(file_path, fd);
   if (!status.IsOK()) {
@@ -294,7 +308,7 @@ static Status LoadModel(const T& file_path, std::shared_ptr<Model>& p_model, con
     }
   }
   try {
-    status = Model::Load(fd, p_model, local_registries);
+    status = loader(fd);
   } catch (std::exception& ex) {
     GSL_SUPPRESS(es .84)
     ORT_IGNORE_RETURN_VALUE(Env::Default().FileClose(fd));
@@ -332,7 +346,11 @@ static Status SaveModel(Model& model, const T& file_path) {
 GSL_SUPPRESS(r .30)  // spurious warnings. p_model is potentially reset in the internal call to Load
 GSL_SUPPRESS(r .35)
 Status Model::Load(const std::wstring& file_path, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
-  return LoadModel(file_path, p_model, local_registries);
+  return LoadModel(file_path, [&p_model, local_registries](int fd) { return Model::Load(fd, p_model, local_registries); });
+}
+
+Status Model::Load(const std::wstring& file_path, ModelProto& model_proto) {
+  return LoadModel(file_path, [&model_proto](int fd) { return Model::Load(fd, model_proto); });
 }
 
 Status Model::Save(Model& model, const std::wstring& file_path) {
@@ -344,7 +362,11 @@ Status Model::Save(Model& model, const std::wstring& file_path) {
 GSL_SUPPRESS(r .30)  // spurious warnings. p_model is potentially reset in the internal call to Load
 GSL_SUPPRESS(r .35)
 Status Model::Load(const std::string& file_path, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
-  return LoadModel(file_path, p_model, local_registries);
+  return LoadModel(file_path, [&p_model, local_registries](int fd) { return Model::Load(fd, p_model, local_registries); });
+}
+
+Status Model::Load(const std::string& file_path, ModelProto& model_proto) {
+  return LoadModel(file_path, [&model_proto](int fd) { return Model::Load(fd, model_proto); });
 }
 
 Status Model::Save(Model& model, const std::string& file_path) {
@@ -369,15 +391,14 @@ using ::google::protobuf::io::CodedInputStream;
 using ::google::protobuf::io::FileInputStream;
 using ::google::protobuf::io::ZeroCopyInputStream;
 
-Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
+Status Model::Load(int fd, ModelProto& model_proto) {
   if (fd < 0) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "<p_fd> less than 0.");
   }
 
-  std::unique_ptr<ModelProto> model_proto = std::make_unique<ModelProto>();
 #if GOOGLE_PROTOBUF_VERSION >= 3002000
   FileInputStream fs(fd);
-  const bool result = model_proto->ParseFromZeroCopyStream(&fs) && fs.GetErrno() == 0;
+  const bool result = model_proto.ParseFromZeroCopyStream(&fs) && fs.GetErrno() == 0;
   if (!result) {
     return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
   }
@@ -391,10 +412,17 @@ Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOp
 
   // Allows protobuf library versions < 3.2.0 to parse messages greater than 64MB.
   cis.SetTotalBytesLimit(INT_MAX, INT_MAX);
-  if (!model_proto->ParseFromCodedStream(&cis)) {
+  if (!model_proto.ParseFromCodedStream(&cis)) {
     return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
   }
 #endif
+  return Status::OK();
+}
+
+Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
+  std::unique_ptr<ModelProto> model_proto = std::make_unique<ModelProto>();
+  ORT_RETURN_IF_ERROR(Load(fd, *model_proto));
+
   p_model = std::make_shared<Model>(std::move(model_proto), local_registries);
 
   ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
@@ -75,6 +75,8 @@ class Model {
   void SetDocString(const std::string& doc_string);
 
   const ModelMetaData& MetaData() const noexcept;
+  // Add or replace a model metadata entry. It is serialized with the model's metadata_props.
+  void SetMetaDataEntry(const std::string& key, const std::string& value);
 
   // Get model's main graph.
   Graph& MainGraph() noexcept;
@@ -92,6 +94,8 @@ class Model {
   // TODO(Task:132) Use of shared_ptr<X>* in Load/Save methods is confusing.
   static common::Status Load(const std::wstring& file_path, /*out*/ std::shared_ptr<Model>& p_model,
                              const IOnnxRuntimeOpSchemaRegistryList* local_registry = nullptr);
+
+  static common::Status Load(const std::wstring& file_path, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
 #endif
   static common::Status Save(Model& model, const std::string& file_path);
 
@@ -106,6 +110,11 @@ class Model {
   static common::Status Load(int fd, /*out*/ std::shared_ptr<Model>& p_model,
                              const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
 
+  // Parse the ModelProto only, without constructing and resolving the Graph.
+  static common::Status Load(const std::string& file_path, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
+
+  static common::Status Load(int fd, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
+
   // 'int' rather than 'size_t' because of a protobuf design choice; let callers handle type checks
   static common::Status LoadFromBytes(int count, void* pBytes, /*out*/ std::shared_ptr<Model>& p_model,
                                       const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/model_composer.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+
+#include "core/graph/constants.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// "ai.onnx" is the default domain too
+const std::string& NormalizeDomain(const std::string& domain) {
+  static const std::string default_domain;
+  return domain == "ai.onnx" ? default_domain : domain;
+}
+
+// the names of the values of a stage in the composed model
+class StageNames {
+ public:
+  explicit StageNames(const std::string& prefix) : prefix_(prefix) {}
+
+  void Set(const std::string& name, const std::string& composed_name) { names_[name] = composed_name; }
+
+  // an empty name is a missing optional input or output, and stays empty
+  std::string Get(const std::string& name) const {
+    if (name.empty()) {
+      return name;
+    }
+    auto entry = names_.find(name);
+    return entry != names_.cend() ? entry->second : prefix_ + name;
+  }
+
+  const std::string& Prefix() const { return prefix_; }
+
+ private:
+  const std::string prefix_;
+  std::unordered_map<std::string, std::string> names_;
+};
+
+// renames the values and the nodes of the graph, and of its subgraphs which may use its values
+void RenameGraph(GraphProto& graph, const StageNames& names) {
+  auto rename_value_infos = [&names](google::protobuf::RepeatedPtrField<ValueInfoProto>& value_infos) {
+    for (auto& value_info : value_infos) {
+      value_info.set_name(names.Get(value_info.name()));
+    }
+  };
+
+  rename_value_infos(*graph.mutable_input());
+  rename_value_infos(*graph.mutable_output());
+  rename_value_infos(*graph.mutable_value_info());
+  for (auto& initializer : *graph.mutable_initializer()) {
+    initializer.set_name(names.Get(initializer.name()));
+  }
+
+  for (auto& node : *graph.mutable_node()) {
+    if (!node.name().empty()) {
+      node.set_name(names.Prefix() + node.name());
+    }
+    for (auto& input : *node.mutable_input()) {
+      input = names.Get(input);
+    }
+    for (auto& output : *node.mutable_output()) {
+      output = names.Get(output);
+    }
+    for (auto& attribute : *node.mutable_attribute()) {
+      if (attribute.has_g()) {
+        RenameGraph(*attribute.mutable_g(), names);
+      }
+      for (auto& subgraph : *attribute.mutable_graphs()) {
+        RenameGraph(subgraph, names);
+      }
+    }
+  }
+}
+
+// checks that the schemas of the nodes of the graph and its subgraphs are the same in the opset versions the
+// composed model imports as in the ones of their model
+Status CheckSchemas(const GraphProto& graph, const std::unordered_map<std::string, int64_t>& model_opsets,
+                    const std::map<std::string, int64_t>& composed_opsets, size_t stage) {
+  for (const auto& node : graph.node()) {
+    const std::string& domain = NormalizeDomain(node.domain());
+    auto model_opset = model_opsets.find(domain);
+    const auto composed_opset = composed_opsets.find(domain);
+    if (model_opset != model_opsets.cend() && composed_opset != composed_opsets.cend() &&
+        model_opset->second != composed_opset->second) {
+      const auto* schema = OpSchemaRegistry::Schema(node.op_type(), static_cast<int>(model_opset->second), domain);
+      const auto* composed_schema =
+          OpSchemaRegistry::Schema(node.op_type(), static_cast<int>(composed_opset->second), domain);
+      if (schema == nullptr || composed_schema == nullptr ||
+          schema->SinceVersion() != composed_schema->SinceVersion()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The ", node.op_type(), " node '", node.name(),
+                               "' of the stage ", stage, " changed between the versions ", model_opset->second,
+                               " and ", composed_opset->second, " of the opset '", domain,
+                               "'. Convert the models to the same opset version to compose them.");
+      }
+    }
+
+    for (const auto& attribute : node.attribute()) {
+      if (attribute.has_g()) {
+        ORT_RETURN_IF_ERROR(CheckSchemas(attribute.g(), model_opsets, composed_opsets, stage));
+      }
+      for (const auto& subgraph : attribute.graphs()) {
+        ORT_RETURN_IF_ERROR(CheckSchemas(subgraph, model_opsets, composed_opsets, stage));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+// the inputs of the graph that aren't initializers, the others are the default values of initializers
+std::vector<const ValueInfoProto*> FeedInputs(const GraphProto& graph) {
+  std::unordered_set<std::string> initializers;
+  for (const auto& initializer : graph.initializer()) {
+    initializers.insert(initializer.name());
+  }
+  std::vector<const ValueInfoProto*> inputs;
+  for (const auto& input : graph.input()) {
+    if (initializers.count(input.name()) == 0) {
+      inputs.push_back(&input);
+    }
+  }
+  return inputs;
+}
+
+}  // namespace
+
+Status ComposeModels(const std::vector<ModelCompositionStage>& stages, ModelProto& composed_model) {
+  ORT_RETURN_IF_NOT(!stages.empty(), "There are no models to compose.");
+  for (const auto& stage : stages) {
+    ORT_RETURN_IF_NOT(stage.model != nullptr && stage.model->has_graph(), "A model to compose has no graph.");
+  }
+
+  // the stage and the output feeding each input of each stage, or -1 for an input of the composed model
+  struct Source {
+    int stage = -1;
+    std::string output;
+  };
+  std::vector<std::unordered_map<std::string, Source>> sources(stages.size());
+  std::vector<std::unordered_set<std::string>> consumed(stages.size());
+
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const auto inputs = FeedInputs(stages[i].model->graph());
+    for (const auto& entry : stages[i].input_map) {
+      ORT_RETURN_IF_NOT(std::any_of(inputs.cbegin(), inputs.cend(),
+                                    [&entry](const ValueInfoProto* input) { return input->name() == entry.first; }),
+                        "The input map of the stage ", i, " names '", entry.first,
+                        "', which isn't an input of its model.");
+    }
+
+    for (const auto* input : inputs) {
+      auto mapped = stages[i].input_map.find(input->name());
+      const std::string& output_name = mapped != stages[i].input_map.cend() ? mapped->second : input->name();
+
+      Source source;
+      for (int j = static_cast<int>(i) - 1; j >= 0 && source.stage < 0; --j) {
+        for (const auto& output : stages[j].model->graph().output()) {
+          if (output.name() == output_name) {
+            source.stage = j;
+            source.output = output_name;
+            break;
+          }
+        }
+      }
+      ORT_RETURN_IF_NOT(source.stage >= 0 || mapped == stages[i].input_map.cend(), "The input '", input->name(),
+                        "' of the stage ", i, " is mapped to '", output_name,
+                        "', which isn't an output of an earlier stage.");
+
+      if (source.stage >= 0) {
+        consumed[source.stage].insert(source.output);
+      }
+      sources[i][input->name()] = source;
+    }
+  }
+
+  // the composed model imports the latest version of each opset
+  std::vector<std::unordered_map<std::string, int64_t>> model_opsets(stages.size());
+  std::map<std::string, int64_t> composed_opsets;
+  int64_t ir_version = 0;
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const ModelProto& model = *stages[i].model;
+    ir_version = std::max<int64_t>(ir_version, model.ir_version());
+    for (const auto& opset : model.opset_import()) {
+      const std::string& domain = NormalizeDomain(opset.domain());
+      model_opsets[i][domain] = opset.version();
+      auto& version = composed_opsets[domain];
+      version = std::max<int64_t>(version, opset.version());
+    }
+  }
+
+  composed_model.Clear();
+  composed_model.set_ir_version(ir_version);
+  composed_model.set_producer_name(stages.front().model->producer_name());
+  composed_model.set_producer_version(stages.front().model->producer_version());
+  for (const auto& opset : composed_opsets) {
+    auto* opset_import = composed_model.add_opset_import();
+    opset_import->set_domain(opset.first);
+    opset_import->set_version(opset.second);
+  }
+
+  GraphProto& composed_graph = *composed_model.mutable_graph();
+  std::string graph_name;
+  std::vector<StageNames> stage_names;
+  stage_names.reserve(stages.size());
+  // the type of each input and output of the composed model, to check the stages sharing them agree
+  std::unordered_map<std::string, std::string> input_types;
+  std::unordered_set<std::string> output_names;
+
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const GraphProto& graph = stages[i].model->graph();
+    ORT_RETURN_IF_ERROR(CheckSchemas(graph, model_opsets[i], composed_opsets, i));
+
+    stage_names.emplace_back("stage" + std::to_string(i) + "/");
+    StageNames& names = stage_names.back();
+    for (const auto& output : graph.output()) {
+      if (consumed[i].count(output.name()) == 0) {
+        ORT_RETURN_IF_NOT(output_names.insert(output.name()).second, "The output '", output.name(), "' of the stage ",
+                          i, " has the name of an output of an earlier stage the later ones don't use.");
+        names.Set(output.name(), output.name());
+      }
+    }
+    for (const auto& input : sources[i]) {
+      if (input.second.stage >= 0) {
+        names.Set(input.first, stage_names[input.second.stage].Get(input.second.output));
+      } else {
+        names.Set(input.first, input.first);
+      }
+    }
+
+    GraphProto stage_graph = graph;
+    RenameGraph(stage_graph, names);
+    graph_name += (i == 0 ? "" : "+") + graph.name();
+
+    std::unordered_set<std::string> initializers;
+    for (auto& initializer : *stage_graph.mutable_initializer()) {
+      initializers.insert(initializer.name());
+      *composed_graph.add_initializer() = std::move(initializer);
+    }
+
+    for (int k = 0; k < stage_graph.input_size(); ++k) {
+      const ValueInfoProto& input = stage_graph.input(k);
+      const std::string& name = graph.input(k).name();
+      if (initializers.count(input.name()) != 0) {
+        // the default value of an initializer, which is an input under the IR versions below 4
+        *composed_graph.add_input() = input;
+      } else if (sources[i][name].stage >= 0) {
+        // fed by the output of an earlier stage, whose type is kept as the type of the value
+        continue;
+      } else {
+        auto shared = input_types.find(input.name());
+        if (shared == input_types.cend()) {
+          input_types[input.name()] = input.type().SerializeAsString();
+          *composed_graph.add_input() = input;
+        } else if (shared->second != input.type().SerializeAsString()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The input '", input.name(), "' of the stage ", i,
+                                 " has another type than the input of the same name of an earlier stage.");
+        }
+      }
+    }
+
+    for (int k = 0; k < stage_graph.output_size(); ++k) {
+      if (consumed[i].count(graph.output(k).name()) == 0) {
+        *composed_graph.add_output() = stage_graph.output(k);
+      } else {
+        *composed_graph.add_value_info() = stage_graph.output(k);
+      }
+    }
+
+    for (auto& value_info : *stage_graph.mutable_value_info()) {
+      *composed_graph.add_value_info() = std::move(value_info);
+    }
+    for (auto& node : *stage_graph.mutable_node()) {
+      if (NormalizeDomain(node.domain()).empty()) {
+        node.clear_domain();
+      }
+      *composed_graph.add_node() = std::move(node);
+    }
+  }
+
+  composed_graph.set_name(graph_name);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+
+/**
+A model of a pipeline composed by ComposeModels, such as a preprocessing model, a backbone and a postprocessing model.
+*/
+struct ModelCompositionStage {
+  const ONNX_NAMESPACE::ModelProto* model = nullptr;
+
+  // The inputs of the model fed by an output of another name of the earlier stages, as a map from the name of the
+  // input to the name of the output. The other inputs are fed by the output of the same name of the latest earlier
+  // stage producing one, if there is one, and are inputs of the composed model otherwise.
+  std::unordered_map<std::string, std::string> input_map;
+};
+
+/**
+Composes the models of the stages into a single model, so the pipeline runs as one graph in one session: the memory
+planner then reuses the buffers across the models, and the values passed from a model to the next one stay on the
+device of the execution provider producing them instead of being copied through host memory.
+
+The inputs of the composed model are the inputs of the stages that aren't fed by an earlier stage, the stages with
+an input of the same name sharing it. Its outputs are the outputs of the stages that don't feed a later stage. Both
+keep their names. The other values, the nodes and the initializers of the stage i are prefixed with "stage<i>/" so
+the names of the models don't collide.
+
+The stages may import different versions of an opset if the schemas of the nodes of the stages importing the
+older version didn't change in the newer one, whose version the composed model imports.
+*/
+common::Status ComposeModels(const std::vector<ModelCompositionStage>& stages,
+                             ONNX_NAMESPACE::ModelProto& composed_model);
+
+}  // namespace onnxruntime
@@ -0,0 +1,448 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/symbolic_shape_inference.h"
+
+#include <algorithm>
+#include <string>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+// Larger int64 tensors are data rather than shapes.
+static constexpr int64_t kMaxValueSize = 64;
+
+using Dimension = TensorShapeProto_Dimension;
+
+static Dimension MakeDim(int64_t value) {
+  Dimension dim;
+  dim.set_dim_value(value);
+  return dim;
+}
+
+static bool IsKnown(const Dimension& dim) {
+  return utils::HasDimValue(dim) || (utils::HasDimParam(dim) && !dim.dim_param().empty());
+}
+
+// Reads the values of an int64 tensor with at most one dimension.
+static bool GetTensorValues(const TensorProto& tensor, std::vector<int64_t>& values, bool& is_scalar) {
+  if (tensor.data_type() != TensorProto_DataType_INT64 || tensor.dims_size() > 1) {
+    return false;
+  }
+  is_scalar = tensor.dims_size() == 0;
+
+  const int64_t size = tensor.dims_size() == 0 ? 1 : tensor.dims(0);
+  if (size > kMaxValueSize) {
+    return false;
+  }
+
+  values.resize(static_cast<size_t>(size));
+  return utils::UnpackTensor<int64_t>(tensor, utils::HasRawData(tensor) ? tensor.raw_data().data() : nullptr,
+                                      tensor.raw_data().size(), values.data(), size)
+      .IsOK();
+}
+
+// Gets the values of an input that must be known constants, such as the starts of a Slice.
+static bool GetIntValues(const std::vector<Dimension>& dims, std::vector<int64_t>& values) {
+  values.clear();
+  for (const auto& dim : dims) {
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    values.push_back(dim.dim_value());
+  }
+  return true;
+}
+
+static bool GetIntsAttribute(const Node& node, const std::string& name, std::vector<int64_t>& values) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  if (attr == nullptr) {
+    return false;
+  }
+  values.assign(attr->ints().begin(), attr->ints().end());
+  return true;
+}
+
+static int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr == nullptr ? default_value : attr->i();
+}
+
+// Checks whether the axis of an op on a 1-D value is its only dimension.
+static bool IsFirstAxis(int64_t axis) {
+  return axis == 0 || axis == -1;
+}
+
+bool SymbolicShapeInference::GetValue(const NodeArg& node_arg, Value& value) const {
+  auto it = values_.find(&node_arg);
+  if (it != values_.end()) {
+    value = it->second;
+    return true;
+  }
+
+  const auto* initializer = graph_utils::GetConstantInitializer(graph_, node_arg.Name(), true);
+  std::vector<int64_t> values;
+  if (initializer == nullptr || !GetTensorValues(*initializer, values, value.is_scalar)) {
+    return false;
+  }
+
+  value.dims.clear();
+  for (int64_t v : values) {
+    value.dims.push_back(MakeDim(v));
+  }
+  return true;
+}
+
+bool SymbolicShapeInference::GetShapeValue(const NodeArg& node_arg, Dims& value) const {
+  Value shape_value;
+  if (!GetValue(node_arg, shape_value) || shape_value.is_scalar) {
+    return false;
+  }
+  value = std::move(shape_value.dims);
+  return true;
+}
+
+bool SymbolicShapeInference::ComputeOutputValue(const Node& node, Value& value) const {
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+
+  if (op_type == "Shape") {
+    const auto* shape = inputs[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    value.dims.assign(shape->dim().begin(), shape->dim().end());
+    value.is_scalar = false;
+    return true;
+  }
+
+  if (op_type == "Constant") {
+    const auto* attr = graph_utils::GetNodeAttribute(node, "value");
+    std::vector<int64_t> values;
+    if (attr == nullptr || !attr->has_t() || !GetTensorValues(attr->t(), values, value.is_scalar)) {
+      return false;
+    }
+    for (int64_t v : values) {
+      value.dims.push_back(MakeDim(v));
+    }
+    return true;
+  }
+
+  // The remaining operators compute their value from the value of their first input.
+  if (inputs.empty() || !GetValue(*inputs[0], value)) {
+    return false;
+  }
+
+  if (op_type == "Identity") {
+    return true;
+  }
+
+  // Only a scalar and a 1-D value of a single element are squeezed and unsqueezed into each other.
+  if (op_type == "Squeeze" || op_type == "Unsqueeze") {
+    std::vector<int64_t> axes;
+    const bool has_axes = GetIntsAttribute(node, "axes", axes);
+    if (op_type == "Squeeze") {
+      if (value.is_scalar || value.dims.size() != 1 || (has_axes && (axes.size() != 1 || !IsFirstAxis(axes[0])))) {
+        return false;
+      }
+      value.is_scalar = true;
+    } else {
+      if (!value.is_scalar || axes.size() != 1 || !IsFirstAxis(axes[0])) {
+        return false;
+      }
+      value.is_scalar = false;
+    }
+    return true;
+  }
+
+  if (op_type == "Cast") {
+    return GetIntAttribute(node, "to", 0) == TensorProto_DataType_INT64;
+  }
+
+  if (op_type == "Gather") {
+    Value indices_value;
+    std::vector<int64_t> indices;
+    if (value.is_scalar || !IsFirstAxis(GetIntAttribute(node, "axis", 0)) || inputs.size() < 2 ||
+        !GetValue(*inputs[1], indices_value) || !GetIntValues(indices_value.dims, indices)) {
+      return false;
+    }
+
+    const auto size = static_cast<int64_t>(value.dims.size());
+    Dims gathered;
+    for (int64_t index : indices) {
+      if (index < 0) {
+        index += size;
+      }
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      gathered.push_back(value.dims[static_cast<size_t>(index)]);
+    }
+    // the output has the rank of the indices
+    value.dims = std::move(gathered);
+    value.is_scalar = indices_value.is_scalar;
+    return true;
+  }
+
+  if (op_type == "Slice") {
+    if (value.is_scalar) {
+      return false;
+    }
+
+    std::vector<int64_t> starts, ends, axes, steps;
+    if (node.Op()->SinceVersion() < 10) {
+      if (!GetIntsAttribute(node, "starts", starts) || !GetIntsAttribute(node, "ends", ends)) {
+        return false;
+      }
+      GetIntsAttribute(node, "axes", axes);
+    } else {
+      Value starts_value, ends_value, axes_value, steps_value;
+      if (inputs.size() < 3 ||
+          !GetValue(*inputs[1], starts_value) || !GetIntValues(starts_value.dims, starts) ||
+          !GetValue(*inputs[2], ends_value) || !GetIntValues(ends_value.dims, ends)) {
+        return false;
+      }
+      if (inputs.size() > 3 && inputs[3]->Exists() &&
+          (!GetValue(*inputs[3], axes_value) || !GetIntValues(axes_value.dims, axes))) {
+        return false;
+      }
+      if (inputs.size() > 4 && inputs[4]->Exists() &&
+          (!GetValue(*inputs[4], steps_value) || !GetIntValues(steps_value.dims, steps))) {
+        return false;
+      }
+    }
+
+    // only slices of the single dimension of a value with unit steps are supported
+    if (starts.size() != 1 || ends.size() != 1 || (!axes.empty() && (axes.size() != 1 || !IsFirstAxis(axes[0]))) ||
+        (!steps.empty() && (steps.size() != 1 || steps[0] != 1))) {
+      return false;
+    }
+
+    const auto size = static_cast<int64_t>(value.dims.size());
+    auto clamp = [size](int64_t index) {
+      return std::min(std::max(index < 0 ? index + size : index, int64_t{0}), size);
+    };
+    const int64_t start = clamp(starts[0]);
+    const int64_t end = std::max(clamp(ends[0]), start);
+    value.dims = Dims(value.dims.begin() + start, value.dims.begin() + end);
+    return true;
+  }
+
+  if (op_type == "Concat") {
+    if (value.is_scalar || !IsFirstAxis(GetIntAttribute(node, "axis", 0))) {
+      return false;
+    }
+    for (size_t i = 1; i < inputs.size(); ++i) {
+      Dims input_value;
+      if (!GetShapeValue(*inputs[i], input_value)) {
+        return false;
+      }
+      value.dims.insert(value.dims.end(), input_value.begin(), input_value.end());
+    }
+    return true;
+  }
+
+  if (op_type == "Add" || op_type == "Sub" || op_type == "Mul" || op_type == "Div") {
+    Value other_value;
+    if (inputs.size() < 2 || !GetValue(*inputs[1], other_value)) {
+      return false;
+    }
+    const Dims& lhs_dims = value.dims;
+    const Dims& rhs_dims = other_value.dims;
+    if (lhs_dims.size() != rhs_dims.size() && lhs_dims.size() != 1 && rhs_dims.size() != 1) {
+      return false;
+    }
+
+    const size_t size = std::max(lhs_dims.size(), rhs_dims.size());
+    Dims result(size);
+    for (size_t i = 0; i < size; ++i) {
+      const auto& lhs = lhs_dims[lhs_dims.size() == 1 ? 0 : i];
+      const auto& rhs = rhs_dims[rhs_dims.size() == 1 ? 0 : i];
+      // multiplying a symbolic dimension by one, e.g. when computing a flattened size, keeps it
+      if (op_type == "Mul" && utils::HasDimValue(rhs) && rhs.dim_value() == 1) {
+        result[i] = lhs;
+      } else if (op_type == "Mul" && utils::HasDimValue(lhs) && lhs.dim_value() == 1) {
+        result[i] = rhs;
+      } else if (utils::HasDimValue(lhs) && utils::HasDimValue(rhs)) {
+        const int64_t a = lhs.dim_value();
+        const int64_t b = rhs.dim_value();
+        if (op_type == "Div" && b == 0) {
+          return false;
+        }
+        result[i] = MakeDim(op_type == "Add" ? a + b : op_type == "Sub" ? a - b : op_type == "Mul" ? a * b : a / b);
+      }
+    }
+    // the output is 1-D unless both inputs are scalars
+    value.dims = std::move(result);
+    value.is_scalar = value.is_scalar && other_value.is_scalar;
+    return true;
+  }
+
+  return false;
+}
+
+bool SymbolicShapeInference::ComputeOutputShape(const Node& node, Dims& shape) const {
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+
+  if (op_type == "ConstantOfShape") {
+    if (!GetShapeValue(*inputs[0], shape)) {
+      return false;
+    }
+    for (auto& dim : shape) {
+      if (utils::HasDimValue(dim) && dim.dim_value() < 0) {
+        dim.clear_dim_value();
+      }
+    }
+    return true;
+  }
+
+  if (inputs.size() < 2 || !inputs[1]->Exists()) {
+    return false;
+  }
+
+  const auto* data_shape = inputs[0]->Shape();
+
+  if (op_type == "Reshape") {
+    if (!GetShapeValue(*inputs[1], shape)) {
+      return false;
+    }
+
+    int inferred_index = -1;
+    for (int i = 0; i < static_cast<int>(shape.size()); ++i) {
+      auto& dim = shape[i];
+      if (!utils::HasDimValue(dim)) {
+        continue;
+      }
+      if (dim.dim_value() == 0) {
+        // 0 copies the dimension of the input
+        if (data_shape != nullptr && i < data_shape->dim_size()) {
+          dim = data_shape->dim(i);
+        } else {
+          dim.clear_dim_value();
+        }
+      } else if (dim.dim_value() < 0) {
+        dim.clear_dim_value();
+        inferred_index = i;
+      }
+    }
+
+    // -1 is inferred from the size of the input. Symbolic dims that appear in both the input and the output
+    // cancel out, e.g. (batch, 2, 3) reshaped to (batch, -1) infers 6.
+    if (inferred_index >= 0 && data_shape != nullptr) {
+      int64_t input_size = 1;
+      std::vector<std::string> input_params;
+      for (const auto& dim : data_shape->dim()) {
+        if (utils::HasDimValue(dim)) {
+          input_size *= dim.dim_value();
+        } else if (IsKnown(dim)) {
+          input_params.push_back(dim.dim_param());
+        } else {
+          input_size = -1;
+          break;
+        }
+      }
+
+      int64_t known_size = 1;
+      std::vector<std::string> known_params;
+      for (int i = 0; i < static_cast<int>(shape.size()) && known_size > 0; ++i) {
+        if (i == inferred_index) {
+          continue;
+        }
+        if (utils::HasDimValue(shape[i])) {
+          known_size *= shape[i].dim_value();
+        } else if (IsKnown(shape[i])) {
+          known_params.push_back(shape[i].dim_param());
+        } else {
+          known_size = -1;
+        }
+      }
+
+      std::sort(input_params.begin(), input_params.end());
+      std::sort(known_params.begin(), known_params.end());
+      if (input_size >= 0 && known_size > 0 && input_size % known_size == 0 && input_params == known_params) {
+        shape[inferred_index].set_dim_value(input_size / known_size);
+      }
+    }
+    return true;
+  }
+
+  if (op_type == "Expand") {
+    Dims target;
+    if (data_shape == nullptr || !GetShapeValue(*inputs[1], target)) {
+      return false;
+    }
+
+    // multidirectional broadcast of the input shape and the target shape
+    const int data_rank = data_shape->dim_size();
+    const int target_rank = static_cast<int>(target.size());
+    const int rank = std::max(data_rank, target_rank);
+    shape.resize(rank);
+    for (int i = 0; i < rank; ++i) {
+      const Dimension* data_dim = i < rank - data_rank ? nullptr : &data_shape->dim(i - (rank - data_rank));
+      const Dimension* target_dim = i < rank - target_rank ? nullptr : &target[i - (rank - target_rank)];
+      const auto is_one = [](const Dimension* dim) {
+        return dim == nullptr || (utils::HasDimValue(*dim) && dim->dim_value() == 1);
+      };
+      if (is_one(target_dim)) {
+        shape[i] = data_dim == nullptr ? MakeDim(1) : *data_dim;
+      } else if (is_one(data_dim) || !IsKnown(*data_dim)) {
+        shape[i] = *target_dim;
+      } else {
+        shape[i] = *data_dim;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void SymbolicShapeInference::InferNode(Node& node) {
+  if (!graph_utils::MatchesOpSetDomain(node, kOnnxDomain) || node.Op() == nullptr ||
+      node.OutputDefs().empty() || !node.OutputDefs()[0]->Exists()) {
+    return;
+  }
+
+  NodeArg& output = *node.MutableOutputDefs()[0];
+
+  // the value is only recorded when its rank agrees with the one the ONNX inference gave the output
+  Value value;
+  const auto* output_shape = output.Shape();
+  if (ComputeOutputValue(node, value) && static_cast<int64_t>(value.dims.size()) <= kMaxValueSize &&
+      (output_shape == nullptr || output_shape->dim_size() == (value.is_scalar ? 0 : 1))) {
+    values_[&output] = std::move(value);
+    return;
+  }
+
+  Dims shape;
+  if (!ComputeOutputShape(node, shape)) {
+    return;
+  }
+
+  const auto* current_shape = output.Shape();
+  TensorShapeProto inferred_shape;
+  if (current_shape == nullptr) {
+    for (const auto& dim : shape) {
+      *inferred_shape.add_dim() = dim;
+    }
+  } else if (current_shape->dim_size() == static_cast<int>(shape.size())) {
+    // only fill in the dimensions that are unknown
+    inferred_shape = *current_shape;
+    for (int i = 0; i < inferred_shape.dim_size(); ++i) {
+      if (!IsKnown(inferred_shape.dim(i)) && IsKnown(shape[i])) {
+        *inferred_shape.mutable_dim(i) = shape[i];
+      }
+    }
+  } else {
+    return;
+  }
+
+  output.SetShape(inferred_shape);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+/**
+@class SymbolicShapeInference
+
+Complements the ONNX type and shape inference in Graph::Resolve by tracking the values of the small int64
+tensors that models compute from the shapes of other tensors, e.g. Shape -> Gather -> Unsqueeze -> Concat.
+The values are kept as dimensions, so symbolic dimensions (dim_param) survive the computation.
+They are used to infer the output shapes of Reshape, Expand and ConstantOfShape, which ONNX can only infer
+when the shape input is an initializer.
+
+Inferred dimensions only fill in dimensions that the ONNX inference left unknown.
+Nodes must be visited in topological order.
+*/
+class SymbolicShapeInference {
+ public:
+  explicit SymbolicShapeInference(const Graph& graph) noexcept : graph_(graph) {}
+
+  /** Records the value of the output of node if it is computed from shapes, and infers the unknown dimensions
+      of the output shape of node if it takes a shape as input. */
+  void InferNode(Node& node);
+
+ private:
+  using Dims = std::vector<ONNX_NAMESPACE::TensorShapeProto_Dimension>;
+
+  /** The value of a tensor of rank 0 or 1. The values of tensors of a higher rank aren't tracked. */
+  struct Value {
+    Dims dims;
+    bool is_scalar = false;
+  };
+
+  /** Gets the tracked value of node_arg, or its value if it is a constant initializer. */
+  bool GetValue(const NodeArg& node_arg, Value& value) const;
+
+  /** Gets the value of node_arg if it is a 1-D tensor, such as a shape. */
+  bool GetShapeValue(const NodeArg& node_arg, Dims& value) const;
+
+  bool ComputeOutputValue(const Node& node, Value& value) const;
+
+  bool ComputeOutputShape(const Node& node, Dims& shape) const;
+
+  const Graph& graph_;
+  std::unordered_map<const NodeArg*, Value> values_;
+};
+
+}  // namespace onnxruntime
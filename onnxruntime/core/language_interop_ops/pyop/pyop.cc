@@ -32,6 +32,7 @@ PyOpLibProxy::PyOpLibProxy() {
   LOAD_PYOP_SYM("NewInstance", new_instance_, "Failed to import function: NewInstance");
   LOAD_PYOP_SYM("InvokePythonFunc", invoke_python_func_, "Failed to import function: InvokePythonFunc");
   LOAD_PYOP_SYM("ReleaseInstance", release_instance_, "Failed to import function: ReleaseInstance");
+  LOAD_PYOP_SYM("ReleaseOutputs", release_outputs_, "Failed to import function: ReleaseOutputs");
   LOAD_PYOP_SYM("GetLastErrorMessage", get_last_error_message_, "Failed to import function: GetLastErrorMessage");
   ORT_ENFORCE(initialize_(), get_last_error_message_(err));
 }
@@ -64,8 +65,8 @@ void PyCustomKernel::GetOutputShape(OrtKernelContext*, size_t, OrtTensorTypeAndS
 void PyCustomKernel::Compute(OrtKernelContext* context) {
   ORT_ENFORCE(nullptr != context);
   auto inputs_count = (size_t) reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->InputCount();
-  std::vector<const void*> inputs;
-  std::vector<std::unique_ptr<char[]>> outputs;
+  std::vector<const void*> inputs, outputs;
+  std::vector<void*> outputs_obj;
   std::vector<int32_t> inputs_type, outputs_elem_size;
   std::vector<std::vector<int64_t>> inputs_dim, outputs_dim;
 
@@ -79,15 +80,18 @@ void PyCustomKernel::Compute(OrtKernelContext* context) {
   std::string err;
   ORT_ENFORCE(PyOpLibProxy::GetInstance().invoke_python_func_(instance_, compute_.c_str(), inputs, inputs_type,
                                                               inputs_dim, outputs, outputs_elem_size,
-                                                              outputs_dim, logging_func_),
+                                                              outputs_dim, outputs_obj, logging_func_),
               PyOpLibProxy::GetInstance().get_last_error_message_(err));  //ORT_ENFORCE
 
+  // the inputs were passed to Python without copies, and the returned arrays are copied once into the outputs
+  // allocated by onnxruntime, without holding the GIL, before being released
   for (size_t i = 0; i < outputs.size(); ++i) {
     auto ort_output = ort_.KernelContext_GetOutput(context, i, outputs_dim[i].data(), outputs_dim[i].size());
     auto output_mem_addr = ort_.GetTensorMutableData<char>(ort_output);
     auto output_len = std::accumulate(begin(outputs_dim[i]), end(outputs_dim[i]), static_cast<int64_t>(outputs_elem_size[i]), std::multiplies<int64_t>());
-    memcpy(output_mem_addr, outputs[i].get(), output_len);
+    memcpy(output_mem_addr, outputs[i], output_len);
   }
+  PyOpLibProxy::GetInstance().release_outputs_(outputs_obj);
 }
 
 int32_t PyCustomKernel::GetType(const OrtValue* input) const {
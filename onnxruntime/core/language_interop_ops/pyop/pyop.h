@@ -26,10 +26,12 @@ typedef bool InvokePythonFunc(void*,
                               const std::vector<const void*>&,
                               const std::vector<int32_t>&,
                               const std::vector<std::vector<int64_t>>&,
-                              std::vector<std::unique_ptr<char[]>>&,
+                              std::vector<const void*>&,
                               std::vector<int32_t>&,
                               std::vector<std::vector<int64_t>>&,
+                              std::vector<void*>&,
                               std::function<void(const char*)>);
+typedef void ReleaseOutputs(std::vector<void*>&);
 typedef const char* GetLastErrorMessage(std::string&);
 typedef void* NewInstance(const char*, const char*, const OnnxAttrs&);
 
@@ -42,6 +44,7 @@ public:
     NewInstance*         new_instance_           = nullptr;
     InvokePythonFunc*    invoke_python_func_     = nullptr;
     ReleaseInstance*     release_instance_       = nullptr;
+    ReleaseOutputs*      release_outputs_        = nullptr;
     GetLastErrorMessage* get_last_error_message_ = nullptr;
 private:
     PyOpLibProxy();
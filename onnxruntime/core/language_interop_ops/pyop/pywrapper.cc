@@ -16,7 +16,6 @@
 #include <numeric>
 #include <vector>
 #include <memory>
-#include <mutex>
 #include <functional>
 #include <unordered_map>
 
@@ -32,35 +31,43 @@ namespace onnxruntime {
 struct Finalizer
 {
     ~Finalizer() {
+        PyGILState_Ensure();
         Py_Finalize();
     }
 };
 
+// Holds the GIL, so the Python calls of the kernels running in different threads don't overlap,
+// and releases the objects added to it before releasing the GIL.
 class Scope
 {
 public:
     Scope(const vector<PyObject*>& objs = {}): objs_(objs) {
-        mtx_.lock();
+        state_ = PyGILState_Ensure();
     }
     ~Scope() {
         for (auto obj: objs_) {
             Py_XDECREF(obj);
         }
-        mtx_.unlock();
+        PyGILState_Release(state_);
     }
     void Add(PyObject* obj) {
         objs_.push_back(obj);
     }
 private:
-    static std::mutex mtx_;
+    PyGILState_STATE state_;
     vector<PyObject*> objs_;
 };
 
-std::mutex Scope::mtx_;
-
 PYOP_EXPORT bool Initialize() {
+    // the interpreter is already there when onnxruntime runs in Python, otherwise the GIL taken by
+    // Py_Initialize is released for the Scope of the thread calling Python
+    if (!Py_IsInitialized()) {
+        Py_Initialize();
+        PyEval_InitThreads();
+        PyEval_SaveThread();
+        static Finalizer finalizer;
+    }
     Scope scope;
-    Py_Initialize();
     if (_import_array() < 0) {
         return false;
     }
@@ -69,7 +76,6 @@ PYOP_EXPORT bool Initialize() {
         PyList_Append(path_list, PyUnicode_FromString(".")) != 0) {
         return false; 
     }
-    static Finalizer finalizer;
     return true;
 }
 
@@ -90,43 +96,43 @@ PYOP_EXPORT const char* GetLastErrorMessage(std::string& err) {
     return err.c_str();
 }
 
+// Wraps the data of an input without copying it. The array is read-only and only valid during the call.
 PyObject* MakePyObj(const void* data, int32_t type, const vector<int64_t>& dim) {
     std::vector<npy_intp> np_dim;
     for (auto d: dim) {
         np_dim.push_back(static_cast<npy_intp>(d));
     }
-    auto pyObj = static_cast<PyObject*>(PyArray_EMPTY(static_cast<int>(np_dim.size()), np_dim.data(), type, 0));
-    auto data_len = std::accumulate(begin(np_dim), end(np_dim),
-                                    static_cast<int64_t>(PyArray_DescrFromType(type)->elsize),
-                                    std::multiplies<int64_t>());
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    memcpy(PyArray_DATA(np_array), data, data_len);
+    auto pyObj = PyArray_SimpleNewFromData(static_cast<int>(np_dim.size()), np_dim.data(), type,
+                                           const_cast<void*>(data));
+    if (nullptr != pyObj) {
+        PyArray_CLEARFLAGS(reinterpret_cast<PyArrayObject*>(pyObj), NPY_ARRAY_WRITEABLE);
+    }
     return pyObj;
 }
 
-bool ExtractOutput(PyObject*                   pyObj,
-                   vector<unique_ptr<char[]>>& outputs,
-                   vector<int32_t>&            outputs_elem_size,
-                   vector<vector<int64_t>>&    outputs_dim) {
+// Keeps a reference to the data of a returned array instead of copying it, which the caller gives back
+// with ReleaseOutputs. Only the arrays that are not C contiguous are copied, by numpy.
+bool ExtractOutput(PyObject*                pyObj,
+                   vector<const void*>&     outputs,
+                   vector<int32_t>&         outputs_elem_size,
+                   vector<vector<int64_t>>& outputs_dim,
+                   vector<void*>&           outputs_obj) {
     if (!PyArray_Check(pyObj)) {
         return false;
     }
 
-    outputs_dim.push_back({});
-    auto np_array = reinterpret_cast<PyArrayObject*>(pyObj);
-    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
+    auto np_array = PyArray_GETCONTIGUOUS(reinterpret_cast<PyArrayObject*>(pyObj));
+    if (nullptr == np_array) {
+        return false;
+    }
 
+    outputs_obj.push_back(np_array);
+    outputs.push_back(PyArray_DATA(np_array));
+    outputs_elem_size.push_back(static_cast<int32_t>(PyArray_ITEMSIZE(np_array)));
+    outputs_dim.push_back({});
     for (int i = 0; i < PyArray_NDIM(np_array); ++i) {
         outputs_dim.back().push_back(PyArray_SHAPE(np_array)[i]);
     }
-
-    auto data_len = std::accumulate(begin(outputs_dim.back()),
-                                    end(outputs_dim.back()),
-                                    static_cast<int64_t>(outputs_elem_size.back()),
-                                    std::multiplies<int64_t>());
-
-    outputs.push_back(unique_ptr<char[]>(new char[data_len]));
-    memcpy(static_cast<void*>(outputs.back().get()), PyArray_DATA(np_array), data_len);
     return true;
 }
 
@@ -159,14 +165,23 @@ PYOP_EXPORT void ReleaseInstance(void* instance) {
     Scope scope({static_cast<PyObject*>(instance)});
 }
 
+PYOP_EXPORT void ReleaseOutputs(vector<void*>& outputs_obj) {
+    Scope scope;
+    for (auto obj: outputs_obj) {
+        scope.Add(static_cast<PyObject*>(obj));
+    }
+    outputs_obj.clear();
+}
+
 PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
                                   const char*                      function,
                                   const vector<const void*>&       inputs,
                                   const vector<int32_t>&           inputs_type,
                                   const vector<vector<int64_t>>&   inputs_dim,
-                                  vector<unique_ptr<char[]>>&      outputs,
+                                  vector<const void*>&             outputs,
                                   vector<int32_t>&                 outputs_elem_size,
                                   vector<vector<int64_t>>&         outputs_dim,
+                                  vector<void*>&                   outputs_obj,
                                   std::function<void(const char*)> logging_func) {
     Scope scope;
     auto instance = static_cast<PyObject*>(raw_inst);
@@ -183,11 +198,16 @@ PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
 
     scope.Add(pyFunc);
     auto pyArgs = PyTuple_New(inputs.size());
+    scope.Add(pyArgs);
     for (size_t i = 0; i < inputs.size(); ++i) {
-        PyTuple_SetItem(pyArgs, i, MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]));
+        auto pyInput = MakePyObj(inputs[i], inputs_type[i], inputs_dim[i]);
+        if (nullptr == pyInput) {
+            logging_func("InvokePythonFunc: failed to wrap input");
+            return false;
+        }
+        PyTuple_SetItem(pyArgs, i, pyInput);
     }
 
-    scope.Add(pyArgs);
     auto pyResult = PyEval_CallObject(pyFunc, pyArgs);
     if (nullptr == pyResult) {
         logging_func("InvokePythonFunc: no result");
@@ -196,10 +216,17 @@ PYOP_EXPORT bool InvokePythonFunc(void*                            raw_inst,
 
     scope.Add(pyResult);
     if (PyArray_Check(pyResult)) {
-        ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim);
+        if (!ExtractOutput(pyResult, outputs, outputs_elem_size, outputs_dim, outputs_obj)) {
+            logging_func("InvokePythonFunc: failed to extract output");
+            return false;
+        }
     } else if (PyTuple_Check(pyResult)) {
         for (int32_t i = 0; i < PyTuple_Size(pyResult); ++i) {
-            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim)) {
+            if (!ExtractOutput(PyTuple_GetItem(pyResult, i), outputs, outputs_elem_size, outputs_dim, outputs_obj)) {
+                for (auto obj: outputs_obj) {
+                    scope.Add(static_cast<PyObject*>(obj));
+                }
+                outputs_obj.clear();
                 logging_func("InvokePythonFunc: failed to extract output");
                 return false;
             }
@@ -68,6 +68,12 @@ MlasGetPreferredBufferAlignment(
     void
     );
 
+const char*
+MLASCALL
+MlasGetKernelSelection(
+    void
+    );
+
 //
 // Activation routines.
 //
@@ -129,6 +135,193 @@ MlasSgemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Single precision matrix/matrix multiply routine with a fused epilogue that
+// adds the optional bias vector of N elements to each row of the output and
+// then applies the optional activation.
+//
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine that computes the dot
+// products from bfloat16 rounded elements of matrix A and matrix B and
+// accumulates in single precision. Platforms without a bfloat16 dot product
+// kernel compute the full precision SGEMM instead.
+//
+
+void
+MLASCALL
+MlasSgemmBf16(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Batched single precision matrix/matrix multiply routine. Every multiply of
+// the batch shares the same shapes, transposes, leading dimensions and
+// scalars. The batch is spread across threads with each multiply computed on
+// a single thread, which avoids splitting small matrices across threads.
+//
+
+struct MLAS_SGEMM_DATA_PARAMS {
+    const float* A;
+    const float* B;
+    float* C;
+};
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    size_t lda,
+    size_t ldb,
+    float beta,
+    size_t ldc,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routines that use a B matrix that
+// has been packed once ahead of time, for example a constant weight. The
+// packed buffer must be MlasSgemmPackBSize bytes in length and aligned to
+// MlasGetPreferredBufferAlignment.
+//
+
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSgemmPacked(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine that reads matrix B from
+// half precision storage. Each panel of matrix B is converted to single
+// precision as it is packed, so the computation and matrix C remain single
+// precision while the B matrix occupies half the memory.
+//
+
+struct MLAS_FP16 {
+    uint16_t val;
+};
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_FP16* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Single precision matrix/matrix multiply routine that reads matrix B from
+// signed 8-bit storage with a scale per column. Each panel of matrix B is
+// dequantized as it is packed, so the weights occupy a quarter of the memory
+// of the single precision matrix. Matrix B is not transposed.
+//
+
+void
+MLASCALL
+MlasSgemmQuantizedB(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Quantized integer matrix/matrix multiply routine.
 //
@@ -167,6 +360,173 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Quantized integer matrix/matrix multiply routines with a fused epilogue that
+// requantizes the 32-bit output to uint8_t as each slice of the output is
+// completed. The optional bias vector of M elements is added to each row of
+// the 32-bit output before it is scaled, rounded, offset by the zero point and
+// saturated. Matrix C is still written and serves as the accumulator buffer.
+//
+
+struct MLAS_QGEMM_REQUANTIZE {
+    uint8_t* Output;
+    size_t ldo;
+    const int32_t* Bias;
+    float Scale;
+    uint8_t ZeroPoint;
+};
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Requantizes the 32-bit output of a quantized matrix multiply to uint8_t,
+// adding the optional bias vector of M elements to each row.
+//
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+//
+// Quantized integer matrix/matrix multiply routines for a float matrix A that
+// is quantized to uint8_t with the supplied scale and zero point as each block
+// of matrix A is packed, so the quantized matrix A is never stored. The 32-bit
+// output is dequantized to float with a fused epilogue as each slice of the
+// output is completed: it is multiplied by the scale and the optional bias
+// vector of N elements is added to each row. Matrix C is still written and
+// serves as the accumulator buffer.
+//
+
+struct MLAS_QGEMM_DEQUANTIZE {
+    float* Output;
+    size_t ldo;
+    const float* Bias;
+    float Scale;
+};
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float ScaleA,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float ScaleA,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Quantizes a buffer to uint8_t: Output = saturate(round(Input / Scale) + ZeroPoint).
+//
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+//
+// Dequantizes the 32-bit output of a quantized matrix multiply to float,
+// adding the optional bias vector of N elements to each row.
+//
+
+void
+MLASCALL
+MlasDequantizeOutput(
+    const int32_t* Input,
+    float* Output,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    float Scale
+    );
+
+//
+// Finds the minimum and maximum values of a buffer in a single pass.
+//
+
+void
+MLASCALL
+MlasFindMinMaxElement(
+    const float* Input,
+    float* Min,
+    float* Max,
+    size_t N
+    );
+
 //
 // Convolution routines.
 //
@@ -175,6 +535,8 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmDepthwise,
+    MlasConvAlgorithmIndirect,
 };
 
 struct MLAS_CONV_PARAMETERS {
@@ -195,6 +557,7 @@ struct MLAS_CONV_PARAMETERS {
     size_t K;
     MLAS_CONV_ALGORITHM Algorithm;
     int32_t ThreadCount;
+    const size_t* IndirectionBuffer;
     union {
         struct {
             CBLAS_TRANSPOSE TransB;
@@ -203,6 +566,9 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t ThreadStrideN;
+        } Indirect;
     } u;
 };
 
@@ -226,6 +592,19 @@ MlasConvPrepare(
     MLAS_THREADPOOL* ThreadPool
     );
 
+size_t
+MLASCALL
+MlasConvIndirectionBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    );
+
+void
+MLASCALL
+MlasConvBuildIndirectionBuffer(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    size_t* IndirectionBuffer
+    );
+
 void
 MLASCALL
 MlasConv(
@@ -292,6 +671,56 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Normalization routines.
+//
+
+void
+MLASCALL
+MlasComputeChannelScaleShift(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Shift,
+    size_t BatchCount,
+    size_t Channels,
+    size_t ChannelSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeInstanceNormalization(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t BatchCount,
+    size_t Channels,
+    size_t ChannelSize,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -305,6 +734,66 @@ MlasConvertHalfToFloatBuffer(
     size_t Count
     );
 
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+//
+// Integer to floating-point conversion routines.
+//
+
+void
+MLASCALL
+MlasConvertUInt8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count
+    );
+
+//
+// Hashing routines.
+//
+
+void
+MLASCALL
+MlasMurmurHash3U32(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t N,
+    uint32_t Seed
+    );
+
+//
+// Transpose routines. Each routine transposes a batch of contiguous matrices
+// of M rows by N columns to matrices of N rows by M columns.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -386,3 +875,21 @@ MlasNchwcPool(
     float* Output,
     MLAS_THREADPOOL* ThreadPool
     );
+
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output
+    );
+
+void
+MLASCALL
+MlasNchwcScaleChannels(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    float* Output
+    );
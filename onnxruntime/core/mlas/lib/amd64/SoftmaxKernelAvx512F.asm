@@ -0,0 +1,208 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   SoftmaxKernelAvx512F.asm
+;
+; Abstract:
+;
+;   This module implements the kernels for the single precision softmax
+;   operation.
+;
+;   This implementation uses AVX512F instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasExpConstants:NEAR
+
+;
+; Structure layout for the exponential constants block.
+;
+
+ExpConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        RoundingBias DWORD ?
+        Log2Reciprocal DWORD ?
+        Log2High DWORD ?
+        Log2Low DWORD ?
+        poly_0 DWORD ?
+        poly_1 DWORD ?
+        poly_2 DWORD ?
+        poly_3 DWORD ?
+        poly_4 DWORD ?
+        poly_5 DWORD ?
+        poly_56 DWORD ?
+
+ExpConstants ENDS
+
+;
+; Stack frame layout for the softmax kernel.
+;
+
+SoftmaxKernelFrame STRUCT
+
+        SavedXmm6 OWORD ?
+        SavedXmm7 OWORD ?
+        SavedXmm8 OWORD ?
+        SavedXmm9 OWORD ?
+        SavedXmm10 OWORD ?
+        SavedXmm11 OWORD ?
+        SavedXmm12 OWORD ?
+        SavedXmm13 OWORD ?
+        SavedXmm14 OWORD ?
+        SavedXmm15 OWORD ?
+        Padding QWORD ?
+        ReturnAddress QWORD ?
+        PreviousP1Home QWORD ?
+        PreviousP2Home QWORD ?
+        PreviousP3Home QWORD ?
+        PreviousP4Home QWORD ?
+
+SoftmaxKernelFrame ENDS
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the sum of exponential
+;   functions, optionally storing the intermediate exponential values.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Optionally supplies the output buffer. When used for Softmax,
+;       the output buffer is used to store the intermediate exp() results. When
+;       used for LogSoftmax, the intermediate exp() results are not required.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+;   NegativeMaximum (r9) - Supplies the address of the value that is added to
+;       each element before computing the exponential function.
+;
+; Return Value:
+;
+;   Returns the sum of the exponential functions.
+;
+;--
+
+        NESTED_ENTRY MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+        alloc_stack (SoftmaxKernelFrame.ReturnAddress)
+
+        save_xmm128_avx xmm6,SoftmaxKernelFrame.SavedXmm6
+        save_xmm128_avx xmm7,SoftmaxKernelFrame.SavedXmm7
+        save_xmm128_avx xmm8,SoftmaxKernelFrame.SavedXmm8
+        save_xmm128_avx xmm9,SoftmaxKernelFrame.SavedXmm9
+        save_xmm128_avx xmm10,SoftmaxKernelFrame.SavedXmm10
+        save_xmm128_avx xmm11,SoftmaxKernelFrame.SavedXmm11
+        save_xmm128_avx xmm12,SoftmaxKernelFrame.SavedXmm12
+        save_xmm128_avx xmm13,SoftmaxKernelFrame.SavedXmm13
+        save_xmm128_avx xmm14,SoftmaxKernelFrame.SavedXmm14
+        save_xmm128_avx xmm15,SoftmaxKernelFrame.SavedXmm15
+
+        END_PROLOGUE
+
+        lea     rax,MlasExpConstants
+        vbroadcastss zmm4,ExpConstants.LowerRange[rax]
+        vbroadcastss zmm5,ExpConstants.UpperRange[rax]
+        vbroadcastss zmm6,ExpConstants.RoundingBias[rax]
+        vbroadcastss zmm7,ExpConstants.Log2Reciprocal[rax]
+        vbroadcastss zmm8,ExpConstants.Log2High[rax]
+        vbroadcastss zmm9,ExpConstants.Log2Low[rax]
+        vbroadcastss zmm10,ExpConstants.poly_0[rax]
+        vbroadcastss zmm11,ExpConstants.poly_1[rax]
+        vbroadcastss zmm12,ExpConstants.poly_2[rax]
+        vbroadcastss zmm13,ExpConstants.poly_3[rax]
+        vbroadcastss zmm14,ExpConstants.poly_4[rax]
+        vbroadcastss zmm15,ExpConstants.poly_5[rax]
+        vbroadcastss zmm16,ExpConstants.poly_56[rax]
+        vbroadcastss zmm17,DWORD PTR [r9]       ; broadcast negative maximum value
+        vpxord  zmm0,zmm0,zmm0                  ; clear exp() accumulator
+        mov     r10d,-1
+        kmovw   k1,r10d                         ; update mask to access all elements
+
+        sub     r8,16
+        jb      ProcessRemainingCount
+
+ComputeExpBy16Loop:
+        vmovups zmm1{k1}{z},ZMMWORD PTR [rcx]
+        vaddps  zmm1,zmm17,zmm1                 ; bias by negative maximum value
+        vmaxps  zmm1,zmm4,zmm1                  ; clamp lower bound
+        vminps  zmm1,zmm5,zmm1                  ; clamp upper bound
+        vmovaps zmm2,zmm6
+        vfmadd231ps zmm2,zmm1,zmm7              ; (input / ln2) plus rounding bias
+        vsubps  zmm3,zmm2,zmm6                  ; m = round(input / ln2)
+        vfmadd231ps zmm1,zmm3,zmm8              ; range reduce: x -= (m * ln2_high)
+        vfmadd231ps zmm1,zmm3,zmm9              ; range reduce: x -= (m * ln2_low)
+        vmovaps zmm3,zmm10                      ; p = poly_0
+        vfmadd213ps zmm3,zmm1,zmm11             ; p = p * x + poly_1
+        vfmadd213ps zmm3,zmm1,zmm12             ; p = p * x + poly_2
+        vfmadd213ps zmm3,zmm1,zmm13             ; p = p * x + poly_3
+        vfmadd213ps zmm3,zmm1,zmm14             ; p = p * x + poly_4
+        vfmadd213ps zmm3,zmm1,zmm15             ; p = p * x + poly_5
+        vfmadd213ps zmm3,zmm1,zmm16             ; p = p * x + poly_6
+        vfmadd213ps zmm3,zmm1,zmm16             ; p = p * x + poly_6
+        vpslld  zmm2,zmm2,23                    ; shift m to exponent field to form 2^m
+        vmulps  zmm3,zmm3,zmm2                  ; exp = p * 2^m
+        vaddps  zmm0{k1},zmm0,zmm3              ; accumulate exp() results
+        add     rcx,16*4                        ; advance input by 16 elements
+        test    rdx,rdx                         ; store exp() results?
+        jz      SkipStoreResultsBy16
+        vmovups ZMMWORD PTR [rdx]{k1},zmm3
+        add     rdx,16*4                        ; advance output by 16 elements
+
+SkipStoreResultsBy16:
+        sub     r8,16
+        jae     ComputeExpBy16Loop
+
+ProcessRemainingCount:
+        add     r8,16                           ; correct for over-subtract above
+        jz      ReduceAccumulator
+        mov     r9,rcx                          ; save input buffer
+        mov     ecx,r8d
+        mov     r10d,1
+        shl     r10d,cl
+        dec     r10d
+        kmovw   k1,r10d                         ; update mask for remaining elements
+        mov     rcx,r9                          ; restore input buffer
+        xor     r8,r8                           ; no more elements remaining
+        jmp     ComputeExpBy16Loop
+
+ReduceAccumulator:
+        vextractf64x4 ymm1,zmm0,1               ; reduce to single value
+        vaddps  ymm0,ymm0,ymm1
+        vextractf128 xmm1,ymm0,1
+        vaddps  xmm0,xmm0,xmm1
+        vhaddps xmm0,xmm0,xmm0
+        vhaddps xmm0,xmm0,xmm0
+        vzeroupper
+        vmovaps xmm6,SoftmaxKernelFrame.SavedXmm6[rsp]
+        vmovaps xmm7,SoftmaxKernelFrame.SavedXmm7[rsp]
+        vmovaps xmm8,SoftmaxKernelFrame.SavedXmm8[rsp]
+        vmovaps xmm9,SoftmaxKernelFrame.SavedXmm9[rsp]
+        vmovaps xmm10,SoftmaxKernelFrame.SavedXmm10[rsp]
+        vmovaps xmm11,SoftmaxKernelFrame.SavedXmm11[rsp]
+        vmovaps xmm12,SoftmaxKernelFrame.SavedXmm12[rsp]
+        vmovaps xmm13,SoftmaxKernelFrame.SavedXmm13[rsp]
+        vmovaps xmm14,SoftmaxKernelFrame.SavedXmm14[rsp]
+        vmovaps xmm15,SoftmaxKernelFrame.SavedXmm15[rsp]
+        add     rsp,(SoftmaxKernelFrame.ReturnAddress)
+
+        BEGIN_EPILOGUE
+
+        ret
+
+        NESTED_END MlasComputeSumExpF32KernelAvx512F, _TEXT
+
+        END
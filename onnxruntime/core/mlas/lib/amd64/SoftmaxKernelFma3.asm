@@ -0,0 +1,224 @@
+;++
+;
+; Copyright (c) Microsoft Corporation. All rights reserved.
+;
+; Licensed under the MIT License.
+;
+; Module Name:
+;
+;   SoftmaxKernelFma3.asm
+;
+; Abstract:
+;
+;   This module implements the kernels for the single precision softmax
+;   operation.
+;
+;   This implementation uses AVX fused multiply/add instructions.
+;
+;--
+
+        .xlist
+INCLUDE mlasi.inc
+        .list
+
+        EXTERN  MlasMaskMoveAvx:NEAR
+        EXTERN  MlasExpConstants:NEAR
+
+;
+; Structure layout for the exponential constants block.
+;
+
+ExpConstants STRUCT
+
+        LowerRange DWORD ?
+        UpperRange DWORD ?
+        RoundingBias DWORD ?
+        Log2Reciprocal DWORD ?
+        Log2High DWORD ?
+        Log2Low DWORD ?
+        poly_0 DWORD ?
+        poly_1 DWORD ?
+        poly_2 DWORD ?
+        poly_3 DWORD ?
+        poly_4 DWORD ?
+        poly_5 DWORD ?
+        poly_56 DWORD ?
+
+ExpConstants ENDS
+
+;
+; Stack frame layout for the softmax kernel.
+;
+
+SoftmaxKernelFrame STRUCT
+
+        SavedXmm6 OWORD ?
+        SavedXmm7 OWORD ?
+        SavedXmm8 OWORD ?
+        SavedXmm9 OWORD ?
+        SavedXmm10 OWORD ?
+        SavedXmm11 OWORD ?
+        SavedXmm12 OWORD ?
+        SavedXmm13 OWORD ?
+        SavedXmm14 OWORD ?
+        SavedXmm15 OWORD ?
+        Padding0 QWORD ?
+        Padding1 QWORD ?
+        CountN QWORD ?
+        ReturnAddress QWORD ?
+        PreviousP1Home QWORD ?
+        PreviousP2Home QWORD ?
+        PreviousP3Home QWORD ?
+        PreviousP4Home QWORD ?
+
+SoftmaxKernelFrame ENDS
+
+;++
+;
+; Routine Description:
+;
+;   This routine implements a vectorized kernel for the sum of exponential
+;   functions, optionally storing the intermediate exponential values.
+;
+; Arguments:
+;
+;   Input (rcx) - Supplies the input buffer.
+;
+;   Output (rdx) - Optionally supplies the output buffer. When used for Softmax,
+;       the output buffer is used to store the intermediate exp() results. When
+;       used for LogSoftmax, the intermediate exp() results are not required.
+;
+;   N (r8) - Supplies the number of elements to process.
+;
+;   NegativeMaximum (r9) - Supplies the address of the value that is added to
+;       each element before computing the exponential function.
+;
+; Return Value:
+;
+;   Returns the sum of the exponential functions.
+;
+;--
+
+        NESTED_ENTRY MlasComputeSumExpF32KernelFma3, _TEXT
+
+        alloc_stack (SoftmaxKernelFrame.ReturnAddress)
+
+        save_xmm128_avx xmm6,SoftmaxKernelFrame.SavedXmm6
+        save_xmm128_avx xmm7,SoftmaxKernelFrame.SavedXmm7
+        save_xmm128_avx xmm8,SoftmaxKernelFrame.SavedXmm8
+        save_xmm128_avx xmm9,SoftmaxKernelFrame.SavedXmm9
+        save_xmm128_avx xmm10,SoftmaxKernelFrame.SavedXmm10
+        save_xmm128_avx xmm11,SoftmaxKernelFrame.SavedXmm11
+        save_xmm128_avx xmm12,SoftmaxKernelFrame.SavedXmm12
+        save_xmm128_avx xmm13,SoftmaxKernelFrame.SavedXmm13
+        save_xmm128_avx xmm14,SoftmaxKernelFrame.SavedXmm14
+        save_xmm128_avx xmm15,SoftmaxKernelFrame.SavedXmm15
+
+        END_PROLOGUE
+
+        lea     rax,MlasExpConstants
+        vbroadcastss ymm4,ExpConstants.LowerRange[rax]
+        vbroadcastss ymm5,ExpConstants.RoundingBias[rax]
+        vbroadcastss ymm6,ExpConstants.Log2Reciprocal[rax]
+        vbroadcastss ymm7,ExpConstants.Log2High[rax]
+        vbroadcastss ymm8,ExpConstants.Log2Low[rax]
+        vbroadcastss ymm9,DWORD PTR [r9]        ; broadcast negative maximum value
+        vbroadcastss ymm10,ExpConstants.poly_1[rax]
+        vbroadcastss ymm11,ExpConstants.poly_2[rax]
+        vbroadcastss ymm12,ExpConstants.poly_3[rax]
+        vbroadcastss ymm13,ExpConstants.poly_4[rax]
+        vbroadcastss ymm14,ExpConstants.poly_5[rax]
+        vbroadcastss ymm15,ExpConstants.poly_56[rax]
+        vxorps  xmm0,xmm0,xmm0                  ; clear exp() accumulator
+
+        sub     r8,8
+        jb      ProcessRemainingCount
+
+ComputeExpBy8Loop:
+        vaddps  ymm1,ymm9,YMMWORD PTR [rcx]     ; bias by negative maximum value
+        vbroadcastss ymm2,ExpConstants.UpperRange[rax]
+        vmaxps  ymm1,ymm4,ymm1                  ; clamp lower bound
+        vminps  ymm1,ymm2,ymm1                  ; clamp upper bound
+        vmovaps ymm2,ymm5
+        vfmadd231ps ymm2,ymm1,ymm6              ; (input / ln2) plus rounding bias
+        vsubps  ymm3,ymm2,ymm5                  ; m = round(input / ln2)
+        vfmadd231ps ymm1,ymm3,ymm7              ; range reduce: x -= (m * ln2_high)
+        vfmadd231ps ymm1,ymm3,ymm8              ; range reduce: x -= (m * ln2_low)
+        vbroadcastss ymm3,ExpConstants.poly_0[rax]
+        vfmadd213ps ymm3,ymm1,ymm10             ; p = p * x + poly_1
+        vfmadd213ps ymm3,ymm1,ymm11             ; p = p * x + poly_2
+        vfmadd213ps ymm3,ymm1,ymm12             ; p = p * x + poly_3
+        vfmadd213ps ymm3,ymm1,ymm13             ; p = p * x + poly_4
+        vfmadd213ps ymm3,ymm1,ymm14             ; p = p * x + poly_5
+        vfmadd213ps ymm3,ymm1,ymm15             ; p = p * x + poly_6
+        vfmadd213ps ymm3,ymm1,ymm15             ; p = p * x + poly_6
+        vpslld  ymm2,ymm2,23                    ; shift m to exponent field to form 2^m
+        vmulps  ymm3,ymm3,ymm2                  ; exp = p * 2^m
+        vaddps  ymm0,ymm0,ymm3                  ; accumulate exp() results
+        add     rcx,8*4                         ; advance input by 8 elements
+        test    rdx,rdx                         ; store exp() results?
+        jz      SkipStoreResultsBy8
+        vmovups YMMWORD PTR [rdx],ymm3
+        add     rdx,8*4                         ; advance output by 8 elements
+
+SkipStoreResultsBy8:
+        sub     r8,8
+        jae     ComputeExpBy8Loop
+
+ProcessRemainingCount:
+        add     r8,8                            ; correct for over-subtract above
+        jz      ReduceAccumulator
+        mov     DWORD PTR SoftmaxKernelFrame.CountN[rsp],r8d
+        vbroadcastss ymm2,DWORD PTR SoftmaxKernelFrame.CountN[rsp]
+        vpcmpgtd ymm2,ymm2,YMMWORD PTR [MlasMaskMoveAvx]
+        vmaskmovps ymm1,ymm2,YMMWORD PTR [rcx]
+        vaddps  ymm1,ymm9,ymm1                  ; bias by negative maximum value
+        vbroadcastss ymm9,ExpConstants.UpperRange[rax]
+        vmaxps  ymm1,ymm4,ymm1                  ; clamp lower bound
+        vminps  ymm1,ymm9,ymm1                  ; clamp upper bound
+        vmovaps ymm9,ymm5
+        vfmadd231ps ymm9,ymm1,ymm6              ; (input / ln2) plus rounding bias
+        vsubps  ymm3,ymm9,ymm5                  ; m = round(input / ln2)
+        vfmadd231ps ymm1,ymm3,ymm7              ; range reduce: x -= (m * ln2_high)
+        vfmadd231ps ymm1,ymm3,ymm8              ; range reduce: x -= (m * ln2_low)
+        vbroadcastss ymm3,ExpConstants.poly_0[rax]
+        vfmadd213ps ymm3,ymm1,ymm10             ; p = p * x + poly_1
+        vfmadd213ps ymm3,ymm1,ymm11             ; p = p * x + poly_2
+        vfmadd213ps ymm3,ymm1,ymm12             ; p = p * x + poly_3
+        vfmadd213ps ymm3,ymm1,ymm13             ; p = p * x + poly_4
+        vfmadd213ps ymm3,ymm1,ymm14             ; p = p * x + poly_5
+        vfmadd213ps ymm3,ymm1,ymm15             ; p = p * x + poly_6
+        vfmadd213ps ymm3,ymm1,ymm15             ; p = p * x + poly_6
+        vpslld  ymm9,ymm9,23                    ; shift m to exponent field to form 2^m
+        vmulps  ymm3,ymm3,ymm9                  ; exp = p * 2^m
+        vandps  ymm3,ymm2,ymm3                  ; mask exp() results of unused elements
+        vaddps  ymm0,ymm0,ymm3                  ; accumulate exp() results
+        test    rdx,rdx                         ; store exp() results?
+        jz      ReduceAccumulator
+        vmaskmovps YMMWORD PTR [rdx],ymm2,ymm3
+
+ReduceAccumulator:
+        vextractf128 xmm1,ymm0,1                ; reduce to single value
+        vaddps  xmm0,xmm0,xmm1
+        vhaddps xmm0,xmm0,xmm0
+        vhaddps xmm0,xmm0,xmm0
+        vzeroupper
+        vmovaps xmm6,SoftmaxKernelFrame.SavedXmm6[rsp]
+        vmovaps xmm7,SoftmaxKernelFrame.SavedXmm7[rsp]
+        vmovaps xmm8,SoftmaxKernelFrame.SavedXmm8[rsp]
+        vmovaps xmm9,SoftmaxKernelFrame.SavedXmm9[rsp]
+        vmovaps xmm10,SoftmaxKernelFrame.SavedXmm10[rsp]
+        vmovaps xmm11,SoftmaxKernelFrame.SavedXmm11[rsp]
+        vmovaps xmm12,SoftmaxKernelFrame.SavedXmm12[rsp]
+        vmovaps xmm13,SoftmaxKernelFrame.SavedXmm13[rsp]
+        vmovaps xmm14,SoftmaxKernelFrame.SavedXmm14[rsp]
+        vmovaps xmm15,SoftmaxKernelFrame.SavedXmm15[rsp]
+        add     rsp,(SoftmaxKernelFrame.ReturnAddress)
+
+        BEGIN_EPILOGUE
+
+        ret
+
+        NESTED_END MlasComputeSumExpF32KernelFma3, _TEXT
+
+        END
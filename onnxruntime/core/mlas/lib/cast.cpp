@@ -0,0 +1,335 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    cast.cpp
+
+Abstract:
+
+    This module implements the buffer conversion routines used by the cast
+    operator.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+MLAS_FP16
+MlasConvertFloatToHalf(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a single precision float to a half precision float,
+    rounding to the nearest even value.
+
+    Values beyond the half precision range become infinities, NaNs remain
+    NaNs and values below the smallest normal half precision value become
+    denormals by adding a magic floating point constant that aligns the
+    rounded mantissa to the low bits.
+
+Arguments:
+
+    Value - Supplies the single precision float to convert.
+
+Return Value:
+
+    Returns the half precision float.
+
+--*/
+{
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(float));
+
+    const uint32_t Sign = Bits & 0x80000000;
+    Bits ^= Sign;
+
+    uint32_t Half;
+
+    if (Bits >= 0x47800000) {
+
+        Half = (Bits > 0x7F800000) ? 0x7E00 : 0x7C00;
+
+    } else if (Bits < 0x38800000) {
+
+        const uint32_t MagicDenormalBits = 0x3F000000;
+
+        float MagicDenormal;
+        float Denormal;
+
+        memcpy(&MagicDenormal, &MagicDenormalBits, sizeof(float));
+        memcpy(&Denormal, &Bits, sizeof(float));
+
+        Denormal += MagicDenormal;
+
+        memcpy(&Half, &Denormal, sizeof(float));
+        Half -= MagicDenormalBits;
+
+    } else {
+
+        const uint32_t MantissaOdd = (Bits >> 13) & 1;
+
+        Bits += 0xC8000FFF;
+        Bits += MantissaOdd;
+
+        Half = Bits >> 13;
+    }
+
+    MLAS_FP16 Result;
+    Result.val = uint16_t(Half | (Sign >> 16));
+    return Result;
+}
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+MLAS_FORCEINLINE
+__m128i
+MlasConvertFloatToHalf32x4(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a vector of single precision floats to half
+    precision floats using the integer sequence of the scalar form above.
+
+Arguments:
+
+    Vector - Supplies the single precision floats to convert.
+
+Return Value:
+
+    Returns the half precision floats in the low 16 bits of each 32-bit lane.
+
+--*/
+{
+    const __m128i MagicDenormal = _mm_set1_epi32(0x3F000000);
+
+    __m128i Bits = _mm_castps_si128(Vector);
+    __m128i Sign = _mm_and_si128(Bits, _mm_set1_epi32(int32_t(0x80000000)));
+    Bits = _mm_xor_si128(Bits, Sign);
+
+    __m128i IsOverflow = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(0x477FFFFF));
+    __m128i IsNaN = _mm_cmpgt_epi32(Bits, _mm_set1_epi32(0x7F800000));
+    __m128i IsDenormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), Bits);
+
+    __m128i Overflow = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(IsNaN, _mm_set1_epi32(0x0200)));
+
+    __m128i Denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(Bits),
+        _mm_castsi128_ps(MagicDenormal))), MagicDenormal);
+
+    __m128i MantissaOdd = _mm_and_si128(_mm_srli_epi32(Bits, 13), _mm_set1_epi32(1));
+    __m128i Normal = _mm_add_epi32(Bits, _mm_set1_epi32(int32_t(0xC8000FFF)));
+    Normal = _mm_srli_epi32(_mm_add_epi32(Normal, MantissaOdd), 13);
+
+    __m128i Half = _mm_or_si128(_mm_and_si128(IsDenormal, Denormal), _mm_andnot_si128(IsDenormal, Normal));
+    Half = _mm_or_si128(_mm_and_si128(IsOverflow, Overflow), _mm_andnot_si128(IsOverflow, Half));
+
+    return _mm_or_si128(Half, _mm_srli_epi32(Sign, 16));
+}
+
+#endif
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision floats to half
+    precision floats.
+
+Arguments:
+
+    Source - Supplies the buffer of single precision floats.
+
+    Destination - Supplies the buffer that receives the half precision floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+
+    while (Count >= 4) {
+
+        vst1_u16(&Destination[0].val, vreinterpret_u16_f16(vcvt_f16_f32(MlasLoadFloat32x4(Source))));
+
+        Source += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+#elif defined(MLAS_SSE2_INTRINSICS)
+
+    while (Count >= 8) {
+
+        __m128i Low = MlasConvertFloatToHalf32x4(MlasLoadFloat32x4(Source));
+        __m128i High = MlasConvertFloatToHalf32x4(MlasLoadFloat32x4(Source + 4));
+
+        //
+        // Sign extend the 16-bit values so that the signed saturation of the
+        // pack leaves them unchanged.
+        //
+
+        Low = _mm_srai_epi32(_mm_slli_epi32(Low, 16), 16);
+        High = _mm_srai_epi32(_mm_slli_epi32(High, 16), 16);
+
+        _mm_storeu_si128((__m128i*)Destination, _mm_packs_epi32(Low, High));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+#endif
+
+    while (Count > 0) {
+
+        *Destination++ = MlasConvertFloatToHalf(*Source++);
+        Count -= 1;
+    }
+}
+
+#if !defined(_M_AMD64)
+
+//
+// The Windows x64 build implements this routine in assembly.
+//
+
+void
+MLASCALL
+MlasConvertHalfToFloatBuffer(
+    const unsigned short* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision floats to single
+    precision floats.
+
+Arguments:
+
+    Source - Supplies the buffer of half precision floats.
+
+    Destination - Supplies the buffer that receives the single precision
+        floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FP16* Half = reinterpret_cast<const MLAS_FP16*>(Source);
+
+    while (Count >= 4) {
+
+        MlasStoreFloat32x4(Destination, MlasConvertHalfToFloat32x4(Half));
+
+        Half += 4;
+        Destination += 4;
+        Count -= 4;
+    }
+
+    while (Count > 0) {
+
+        *Destination++ = MlasConvertHalfToFloat(*Half++);
+        Count -= 1;
+    }
+}
+
+#endif
+
+void
+MLASCALL
+MlasConvertUInt8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of unsigned 8-bit integers, such as the
+    pixels of an image input, to single precision floats.
+
+Arguments:
+
+    Source - Supplies the buffer of unsigned 8-bit integers.
+
+    Destination - Supplies the buffer that receives the single precision
+        floats.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON_INTRINSICS)
+
+    while (Count >= 8) {
+
+        uint16x8_t Words = vmovl_u8(vld1_u8(Source));
+
+        MlasStoreFloat32x4(Destination, vcvtq_f32_u32(vmovl_u16(vget_low_u16(Words))));
+        MlasStoreFloat32x4(Destination + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(Words))));
+
+        Source += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+#elif defined(MLAS_SSE2_INTRINSICS)
+
+    const __m128i ZeroVector = _mm_setzero_si128();
+
+    while (Count >= 16) {
+
+        __m128i Bytes = _mm_loadu_si128((const __m128i*)Source);
+        __m128i WordsLow = _mm_unpacklo_epi8(Bytes, ZeroVector);
+        __m128i WordsHigh = _mm_unpackhi_epi8(Bytes, ZeroVector);
+
+        MlasStoreFloat32x4(Destination, _mm_cvtepi32_ps(_mm_unpacklo_epi16(WordsLow, ZeroVector)));
+        MlasStoreFloat32x4(Destination + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(WordsLow, ZeroVector)));
+        MlasStoreFloat32x4(Destination + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(WordsHigh, ZeroVector)));
+        MlasStoreFloat32x4(Destination + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(WordsHigh, ZeroVector)));
+
+        Source += 16;
+        Destination += 16;
+        Count -= 16;
+    }
+
+#endif
+
+    while (Count > 0) {
+
+        *Destination++ = float(*Source++);
+        Count -= 1;
+    }
+}
@@ -0,0 +1,670 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements miscellaneous computation routines.
+
+    Our usage requires building platform specific versions of the algorithm to
+    target different instruction sets. The implementation below targets the
+    base instruction set (typically SSE2) while assembly implementations target
+    newer instruction sets (such as FMA3).
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Bundles the constants for use by kernels written in assembly.
+//
+// The exponential function is computed by reducing the input to the range
+// [-ln(2)/2, ln(2)/2] and evaluating the polynomial from the Cephes library.
+// The rounding bias both rounds the scaled input to the nearest integer value
+// and biases that value such that shifting the result left by the mantissa
+// width forms the floating point value 2^m.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float LowerRange;
+    float UpperRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_56;
+} MlasExpConstants = {
+    -87.3365478515625f,
+    88.3762626647949f,
+    12583039.0f,                // 1.5 * 2^23 + 127
+    1.44269504088896341f,
+    -0.693359375f,
+    2.12194440e-4f,
+    1.9875691500E-4f,
+    1.3981999507E-3f,
+    8.3334519073E-3f,
+    4.1665795894E-2f,
+    1.6666665459E-1f,
+    5.0000001201E-1f,
+    1.0f,
+};
+
+//
+// Define the number of elements to process per thread before using another
+// thread to compute the softmax function.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (16 * 1024)
+
+//
+// Structure to supply the softmax parameters to the threaded routine.
+//
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    int32_t ThreadCountN;
+    bool LogSoftmax;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a vector of elements.
+
+Arguments:
+
+    Vector - Supplies the input vector. The caller has clamped the elements
+        to the supported range.
+
+Return Value:
+
+    The exponential function of the input vector.
+
+--*/
+{
+    const MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+
+    MLAS_FLOAT32X4 m = MlasMultiplyAddFloat32x4(Vector, MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = MlasSubtractFloat32x4(m, RoundingBias);
+
+    MLAS_FLOAT32X4 r;
+    r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), r);
+
+    MLAS_FLOAT32X4 p;
+    p = MlasMultiplyAddFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.poly_0), r, MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_56));
+
+    return MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m));
+}
+
+MLAS_FORCEINLINE
+float
+MlasComputeExpScalar(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a single element.
+
+Arguments:
+
+    Value - Supplies the input value. The caller has clamped the value to the
+        supported range.
+
+Return Value:
+
+    The exponential function of the input value.
+
+--*/
+{
+    float m = Value * MlasExpConstants.Log2Reciprocal + MlasExpConstants.RoundingBias;
+    m = m - MlasExpConstants.RoundingBias;
+
+    float r;
+    r = m * MlasExpConstants.Log2High + Value;
+    r = m * MlasExpConstants.Log2Low + r;
+
+    float p;
+    p = MlasExpConstants.poly_0 * r + MlasExpConstants.poly_1;
+    p = p * r + MlasExpConstants.poly_2;
+    p = p * r + MlasExpConstants.poly_3;
+    p = p * r + MlasExpConstants.poly_4;
+    p = p * r + MlasExpConstants.poly_5;
+    p = p * r + MlasExpConstants.poly_56;
+    p = p * r + MlasExpConstants.poly_56;
+
+    union {
+        int32_t i;
+        float f;
+    } Scale;
+
+    Scale.i = (int32_t(m) + 127) << 23;
+
+    return p * Scale.f;
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the sum of exponential
+    functions, optionally storing the intermediate exponential values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. When used for Softmax,
+        the output buffer is used to store the intermediate exp() results. When
+        used for LogSoftmax, the intermediate exp() results are not required.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the value that is added to each element before
+        computing the exponential function.
+
+Return Value:
+
+    Returns the sum of the exponential functions.
+
+--*/
+{
+    MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(*NegativeMaximum);
+    MLAS_FLOAT32X4 AccumulationVector = MlasZeroFloat32x4();
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+
+        Vector = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.LowerRange), Vector);
+        Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+        Vector = MlasComputeExpVector(Vector);
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector);
+            Output += 4;
+        }
+
+        AccumulationVector = MlasAddFloat32x4(AccumulationVector, Vector);
+
+        Input += 4;
+        N -= 4;
+    }
+
+    float Accumulation = MlasExtractLaneFloat32x4<0>(AccumulationVector) +
+        MlasExtractLaneFloat32x4<1>(AccumulationVector) +
+        MlasExtractLaneFloat32x4<2>(AccumulationVector) +
+        MlasExtractLaneFloat32x4<3>(AccumulationVector);
+
+    while (N > 0) {
+
+        float Value = *Input++ + *NegativeMaximum;
+
+        Value = (std::min)(MlasExpConstants.UpperRange, (std::max)(MlasExpConstants.LowerRange, Value));
+        Value = MlasComputeExpScalar(Value);
+
+        if (Output != nullptr) {
+            *Output++ = Value;
+        }
+
+        Accumulation += Value;
+
+        N -= 1;
+    }
+
+    return Accumulation;
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32Kernel(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to find the maximum value of
+    the supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value of the supplied buffer.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector0 = MlasBroadcastFloat32x4(Maximum);
+
+        if (N >= 16) {
+
+            MLAS_FLOAT32X4 MaximumVector1 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector2 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector3 = MaximumVector0;
+
+            while (N >= 16) {
+
+                MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+                MaximumVector1 = MlasMaximumFloat32x4(MaximumVector1, MlasLoadFloat32x4(Input + 4));
+                MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MlasLoadFloat32x4(Input + 8));
+                MaximumVector3 = MlasMaximumFloat32x4(MaximumVector3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                N -= 16;
+            }
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector1);
+            MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MaximumVector3);
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector2);
+        }
+
+        while (N >= 4) {
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        Maximum = (std::max)((std::max)(MlasExtractLaneFloat32x4<0>(MaximumVector0), MlasExtractLaneFloat32x4<1>(MaximumVector0)),
+            (std::max)(MlasExtractLaneFloat32x4<2>(MaximumVector0), MlasExtractLaneFloat32x4<3>(MaximumVector0)));
+    }
+
+    while (N > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        N -= 1;
+    }
+
+    return Maximum;
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32Kernel(
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to produce the final output for
+    the softmax operation.
+
+Arguments:
+
+    Output - Supplies the output buffer, which contains the exp() results of
+        the first pass.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the scale value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Scale = Parameters[0];
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output), ScaleVector));
+
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output = *Output * Scale;
+
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmaxOutputF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to produce the final output for
+    the log softmax operation.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negative maximum value and
+        the logarithm of the sum of the exponential functions.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float NegativeMaximum = Parameters[0];
+    const float Logarithm = Parameters[1];
+    const MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    const MLAS_FLOAT32X4 LogarithmVector = MlasBroadcastFloat32x4(Logarithm);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector);
+        MlasStoreFloat32x4(Output, MlasSubtractFloat32x4(Vector, LogarithmVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output = *Input + NegativeMaximum - Logarithm;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    const size_t WorkPerThread = N / WorkBlock->ThreadCountN;
+    const size_t WorkPerThreadExtra = N % WorkBlock->ThreadCountN;
+
+    size_t n;
+    size_t CountN;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        n = (WorkPerThread + 1) * Index;
+        CountN = WorkPerThread + 1;
+    } else {
+        n = WorkPerThread * Index + WorkPerThreadExtra;
+        CountN = WorkPerThread;
+    }
+
+    //
+    // Compute the softmax or log softmax function.
+    //
+
+    const bool LogSoftmax = WorkBlock->LogSoftmax;
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+    while (CountN > 0) {
+
+        const float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+        const float NegativeMaximum = -Maximum;
+
+        if (LogSoftmax) {
+
+            //
+            // Compute the sum of the exponential functions for the row.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#endif
+
+            //
+            // Compute the log softmax output.
+            //
+
+            float Parameters[] = { NegativeMaximum, std::log(Accumulation) };
+
+            MlasComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
+
+        } else {
+
+            //
+            // Compute the exponential function for each element of the row and
+            // compute the sum of these exponential functions.
+            //
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = MlasPlatform.ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#endif
+
+            //
+            // Normalize the softmax output.
+            //
+
+            float Parameters[] = { 1.0f / Accumulation };
+
+            MlasComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
+        }
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float NegativeMaximum = 0.0f;
+
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.ComputeSumExpF32Kernel(Input, Output, N, &NegativeMaximum);
+#else
+    MlasComputeSumExpF32Kernel(Input, Output, N, &NegativeMaximum);
+#endif
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    //
+    // Capture the softmax parameters to the work block.
+    //
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Compute the number of target threads given the complexity of the softmax
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= N) {
+        TargetThreadCount = int32_t(N);
+    }
+
+    if (TargetThreadCount == 0) {
+        return;
+    }
+
+    WorkBlock.ThreadCountN = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
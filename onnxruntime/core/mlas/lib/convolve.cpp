@@ -23,6 +23,13 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the indirection buffer entry for a kernel position that samples the
+// zero padding of the input image.
+//
+
+#define MLAS_CONV_INDIRECTION_PADDING SIZE_MAX
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -34,6 +41,7 @@ struct MLAS_CONV_WORK_BLOCK {
     const float* Filter;
     const float* Bias;
     float* WorkingBuffer;
+    const size_t* IndirectionBuffer;
     float* Output;
     struct SEGMENT {
         size_t StartN;
@@ -606,6 +614,221 @@ Return Value:
     }
 }
 
+void
+MlasConvIndirectPackB(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const size_t* IndirectionBuffer,
+    float* D,
+    size_t k,
+    size_t CountK,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine gathers the convolution patches for a slice of the output
+    image directly from the input image to a packed panel in the layout
+    consumed by the SGEMM kernels (see MlasSgemmCopyPackB).
+
+    The indirection buffer supplies the offset of each input element sampled
+    by a kernel position for an output element, so no intermediate column
+    buffer is expanded.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    IndirectionBuffer - Supplies the indirection buffer built by
+        MlasConvBuildIndirectionBuffer.
+
+    D - Supplies the address of the destination packed buffer.
+
+    k - Supplies the K to begin sampling the convolution patches.
+
+    CountK - Supplies the count of K to sample for the convolution patches.
+
+    n - Supplies the N to begin sampling the convolution patches.
+
+    CountN - Supplies the count of N to sample for the convolution patches.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t KernelSize = Parameters->K / Parameters->InputChannels;
+
+    //
+    // Gather the panel 16 columns at a time. Any remaining columns less than
+    // 16 elements wide are zero-padded.
+    //
+
+    for (size_t x = 0; x < CountN; x += 16) {
+
+        size_t CountX = CountN - x;
+
+        if (CountX > 16) {
+            CountX = 16;
+        }
+
+        size_t Channel = k / KernelSize;
+        size_t KernelPosition = k % KernelSize;
+
+        for (size_t y = 0; y < CountK; y++) {
+
+            const float* input = Input + Channel * InputSize;
+            const size_t* offsets = IndirectionBuffer + KernelPosition * OutputSize + n + x;
+
+            size_t i = 0;
+
+            for (; i < CountX; i++) {
+                const size_t offset = offsets[i];
+                D[i] = (offset != MLAS_CONV_INDIRECTION_PADDING) ? input[offset] : 0.0f;
+            }
+
+            for (; i < 16; i++) {
+                D[i] = 0.0f;
+            }
+
+            D += 16;
+
+            if (++KernelPosition == KernelSize) {
+                KernelPosition = 0;
+                Channel++;
+            }
+        }
+    }
+}
+
+void
+MlasConvIndirectOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const size_t* IndirectionBuffer,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t SegmentStartN,
+    size_t SegmentCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation using an indirection
+    buffer to pack the convolution patches for the SGEMM kernels.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    IndirectionBuffer - Supplies the indirection buffer built by
+        MlasConvBuildIndirectionBuffer.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output tensor.
+
+    SegmentStartN - Supplies the N to begin sampling the convolution patches.
+
+    SegmentCountN - Supplies the count of N to sample for the convolution
+        patches.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    //
+    // Compute the strides to step through slices of the local segment.
+    //
+    // See MlasSgemmOperation.
+    //
+
+    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
+    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+
+    if (SegmentCountN >= K) {
+
+        while (StrideK / 2 >= K) {
+            StrideN *= 2;
+            StrideK /= 2;
+        }
+
+    } else {
+
+        while (StrideN > 16 && StrideN / 2 >= SegmentCountN) {
+            StrideK *= 2;
+            StrideN /= 2;
+        }
+    }
+
+    //
+    // Step through each slice of the input tensor along the N dimension.
+    //
+
+    size_t CountN;
+
+    for (size_t n = 0; n < SegmentCountN; n += CountN) {
+
+        CountN = SegmentCountN - n;
+
+        if (CountN > StrideN) {
+            CountN = StrideN;
+        }
+
+        //
+        // Step through each slice of the input tensor along the K dimension.
+        //
+
+        size_t CountK;
+        float* SegmentOutput = Output + SegmentStartN + n;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = K - k;
+
+            if (CountK > StrideK) {
+                CountK = StrideK;
+            }
+
+            MlasConvIndirectPackB(Parameters, Input, IndirectionBuffer, PanelB, k,
+                CountK, SegmentStartN + n, CountN);
+
+            MlasSgemmMultiplyPanel(CblasNoTrans, FilterCount, CountN, CountK, 1.0f,
+                Filter + k, K, PanelB, SegmentOutput, OutputSize, k == 0, false);
+        }
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        MlasActivation(Parameters->Activation, SegmentOutput, Bias, FilterCount,
+            CountN, OutputSize);
+    }
+}
+
 void
 MlasConvOperationThreaded(
     void* Context,
@@ -634,6 +857,15 @@ Return Value:
 
     MLAS_CONV_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
 
+    if (WorkBlock->Parameters->Algorithm == MlasConvAlgorithmIndirect) {
+
+        MlasConvIndirectOperation(WorkBlock->Parameters, WorkBlock->Input,
+            WorkBlock->IndirectionBuffer, WorkBlock->Filter, WorkBlock->Bias,
+            WorkBlock->Output, Segment->StartN, Segment->CountN);
+
+        return;
+    }
+
     float* ColumnBuffer =
         WorkBlock->WorkingBuffer + Index * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
 
@@ -736,6 +968,229 @@ Return Value:
     }
 }
 
+void
+MlasConvDepthwiseChannel(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine convolves a single channel of the input tensor with a single
+    channel of the filter tensor for a depthwise convolution operation.
+
+    Each output row is accumulated as a sequence of scaled row additions, one
+    per kernel element, so that unit stride rows can be vectorized.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input channel.
+
+    Filter - Supplies the filter channel.
+
+    Output - Supplies the output channel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const size_t InputHeight = Parameters->InputShape[HeightShapeIndex];
+    const size_t InputWidth = Parameters->InputShape[WidthShapeIndex];
+
+    const size_t OutputHeight = Parameters->OutputShape[HeightShapeIndex];
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
+
+    const size_t DilationHeight = Parameters->DilationShape[HeightShapeIndex];
+    const size_t DilationWidth = Parameters->DilationShape[WidthShapeIndex];
+
+    const size_t PaddingLeftY = Parameters->Padding[HeightShapeIndex];
+    const size_t PaddingLeftX = Parameters->Padding[WidthShapeIndex];
+
+    const size_t StrideHeight = Parameters->StrideShape[HeightShapeIndex];
+    const size_t StrideWidth = Parameters->StrideShape[WidthShapeIndex];
+
+    for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+        float* output = Output + oh * OutputWidth;
+
+        std::fill_n(output, OutputWidth, 0.0f);
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            //
+            // Skip kernel rows that fall in the padding. The unsigned
+            // arithmetic wraps for rows above the input.
+            //
+
+            const size_t ih = oh * StrideHeight + kh * DilationHeight - PaddingLeftY;
+
+            if (ih >= InputHeight) {
+                continue;
+            }
+
+            const float* input = Input + ih * InputWidth;
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                //
+                // Compute the range of output columns that read from inside
+                // the input row for this kernel column.
+                //
+
+                const size_t OffsetX = kw * DilationWidth;
+
+                size_t OutputStart = 0;
+
+                if (OffsetX < PaddingLeftX) {
+                    OutputStart = (PaddingLeftX - OffsetX + StrideWidth - 1) / StrideWidth;
+                }
+
+                size_t OutputEnd = 0;
+
+                if (InputWidth + PaddingLeftX > OffsetX) {
+                    OutputEnd = (InputWidth + PaddingLeftX - OffsetX + StrideWidth - 1) / StrideWidth;
+                }
+
+                if (OutputEnd > OutputWidth) {
+                    OutputEnd = OutputWidth;
+                }
+
+                if (OutputStart >= OutputEnd) {
+                    continue;
+                }
+
+                const float FilterValue = Filter[kh * KernelWidth + kw];
+                const float* in = input + OutputStart * StrideWidth + OffsetX - PaddingLeftX;
+
+                size_t ow = OutputStart;
+
+                if (StrideWidth == 1) {
+
+                    MLAS_FLOAT32X4 FilterVector = MlasBroadcastFloat32x4(FilterValue);
+
+                    for (; ow + 4 <= OutputEnd; ow += 4) {
+
+                        MLAS_FLOAT32X4 Accumulator = MlasLoadFloat32x4(&output[ow]);
+
+                        Accumulator = MlasMultiplyAddFloat32x4(FilterVector, MlasLoadFloat32x4(in), Accumulator);
+
+                        MlasStoreFloat32x4(&output[ow], Accumulator);
+
+                        in += 4;
+                    }
+                }
+
+                for (; ow < OutputEnd; ow++) {
+                    output[ow] += FilterValue * *in;
+                    in += StrideWidth;
+                }
+            }
+        }
+    }
+}
+
+void
+MlasConvDepthwiseThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    depthwise convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of channels to use for this thread.
+    //
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t BatchGroupCount = Parameters->BatchCount * GroupCount;
+
+    const size_t TargetThreadCount = WorkBlock->TargetThreadCount;
+
+    const size_t BatchGroupCountPerThread = BatchGroupCount / TargetThreadCount;
+    const size_t BatchGroupCountExtra = BatchGroupCount % TargetThreadCount;
+
+    size_t BatchGroupStart;
+    size_t BatchGroupEnd;
+
+    if (uint32_t(Index) < BatchGroupCountExtra) {
+        BatchGroupStart = (BatchGroupCountPerThread + 1) * Index;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread + 1;
+    } else {
+        BatchGroupStart = BatchGroupCountPerThread * Index + BatchGroupCountExtra;
+        BatchGroupEnd = BatchGroupStart + BatchGroupCountPerThread;
+    }
+
+    //
+    // Iterate over the channels allocated to this thread. Each group reads a
+    // single input channel and produces FilterCount output channels.
+    //
+
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t K = Parameters->K;
+
+    for (size_t bg = BatchGroupStart; bg < BatchGroupEnd; bg++) {
+
+        size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputSize;
+        const float* filter = WorkBlock->Filter + group * FilterCount * K;
+        float* output = WorkBlock->Output + bg * FilterCount * OutputSize;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            MlasConvDepthwiseChannel(Parameters, input, filter + f * K, output + f * OutputSize);
+        }
+
+        //
+        // Apply the activation with optional bias.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        MlasActivation(Parameters->Activation, output, bias, FilterCount,
+            OutputSize, OutputSize);
+    }
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -744,6 +1199,7 @@ MlasConvTryMultithread(
     const float* Filter,
     const float* Bias,
     float* WorkingBuffer,
+    const size_t* IndirectionBuffer,
     float* Output,
     MLAS_THREADPOOL* ThreadPool
     )
@@ -768,6 +1224,9 @@ Arguments:
     WorkingBuffer - Supplies a working buffer sized to the number of elements
         returned by MlasConvPrepare.
 
+    IndirectionBuffer - Supplies the indirection buffer if the convolution
+        uses the indirect algorithm, else nullptr.
+
     Output - Supplies the output tensor.
 
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
@@ -783,7 +1242,8 @@ Return Value:
     MLAS_CONV_WORK_BLOCK WorkBlock;
 
     const size_t OutputSize = Parameters->OutputSize;
-    const size_t ThreadStrideN = Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
+    const size_t ThreadStrideN = (Parameters->Algorithm == MlasConvAlgorithmIndirect) ?
+        Parameters->u.Indirect.ThreadStrideN : Parameters->u.ExpandThenGemmSegmented.ThreadStrideN;
 
     if (ThreadStrideN >= OutputSize) {
         return false;
@@ -798,6 +1258,7 @@ Return Value:
     WorkBlock.Filter = Filter;
     WorkBlock.Bias = Bias;
     WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.IndirectionBuffer = IndirectionBuffer;
     WorkBlock.Output = Output;
 
     //
@@ -855,7 +1316,8 @@ Arguments:
     Bias - Optionally supplies the bias vector.
 
     WorkingBuffer - Supplies a working buffer sized to the number of elements
-        returned by MlasConvPrepare.
+        returned by MlasConvPrepare. This may be nullptr for the indirect
+        algorithm if Parameters->IndirectionBuffer was supplied.
 
     Output - Supplies the output tensor.
 
@@ -902,6 +1364,7 @@ Return Value:
         WorkBlock.Filter = Filter;
         WorkBlock.Bias = Bias;
         WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.IndirectionBuffer = nullptr;
         WorkBlock.Output = Output;
         WorkBlock.TargetThreadCount = TargetThreadCount;
 
@@ -910,6 +1373,55 @@ Return Value:
         return;
     }
 
+    //
+    // Schedule the channels of a depthwise convolution across multiple
+    // threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmDepthwise) {
+
+        const size_t BatchGroupCount = BatchCount * GroupCount;
+
+        int32_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (size_t(TargetThreadCount) >= BatchGroupCount) {
+            TargetThreadCount = int32_t(BatchGroupCount);
+        }
+
+        MLAS_CONV_WORK_BLOCK WorkBlock;
+
+        WorkBlock.Parameters = Parameters;
+        WorkBlock.Input = Input;
+        WorkBlock.Filter = Filter;
+        WorkBlock.Bias = Bias;
+        WorkBlock.WorkingBuffer = nullptr;
+        WorkBlock.IndirectionBuffer = nullptr;
+        WorkBlock.Output = Output;
+        WorkBlock.TargetThreadCount = TargetThreadCount;
+
+        MlasExecuteThreaded(MlasConvDepthwiseThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+
+        return;
+    }
+
+    //
+    // Build the indirection buffer in the working buffer if the caller has not
+    // supplied one. The buffer only depends on the shape of the convolution,
+    // so it is shared by every batch and group.
+    //
+
+    const size_t* IndirectionBuffer = nullptr;
+
+    if (Algorithm == MlasConvAlgorithmIndirect) {
+
+        IndirectionBuffer = Parameters->IndirectionBuffer;
+
+        if (IndirectionBuffer == nullptr) {
+            MlasConvBuildIndirectionBuffer(Parameters, reinterpret_cast<size_t*>(WorkingBuffer));
+            IndirectionBuffer = reinterpret_cast<const size_t*>(WorkingBuffer);
+        }
+    }
+
     //
     // Iterate over each batch and group.
     //
@@ -981,13 +1493,39 @@ Return Value:
                     //
 
                     if (!MlasConvTryMultithread(Parameters, Input, filter, bias, WorkingBuffer,
-                        Output, ThreadPool)) {
+                        nullptr, Output, ThreadPool)) {
                         MlasConvOperation(Parameters, Input, filter, bias, WorkingBuffer,
                             Output, 0, OutputSize);
                     }
 
                     break;
                 }
+
+                case MlasConvAlgorithmIndirect:
+                {
+                    //
+                    // Attempt to launch the convolution across multiple threads or fall
+                    // back to a single thread.
+                    //
+
+                    if (!MlasConvTryMultithread(Parameters, Input, filter, bias, nullptr,
+                        IndirectionBuffer, Output, ThreadPool)) {
+                        MlasConvIndirectOperation(Parameters, Input, IndirectionBuffer,
+                            filter, bias, Output, 0, OutputSize);
+                    }
+
+                    break;
+                }
+
+                case MlasConvAlgorithmDepthwise:
+                {
+                    //
+                    // Depthwise convolutions are scheduled across all of the batches
+                    // and groups above and never reach this loop.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1064,7 +1602,9 @@ Arguments:
         convolution output.
 
     WorkingBufferSize - Receives the number of elements to allocate for the
-        working buffer for intermediate results.
+        working buffer for intermediate results. For the indirect algorithm,
+        this is the space to build the indirection buffer, which is not needed
+        if the caller supplies Parameters->IndirectionBuffer.
 
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
@@ -1080,6 +1620,7 @@ Return Value:
     //
 
     Parameters->Activation = Activation;
+    Parameters->IndirectionBuffer = nullptr;
     Parameters->Dimensions = Dimensions;
     Parameters->BatchCount = BatchCount;
     Parameters->GroupCount = GroupCount;
@@ -1123,6 +1664,19 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    //
+    // Detect a depthwise convolution where each group reads a single input
+    // channel. These are computed directly from the input tensor instead of
+    // as many small GEMMs over an expanded input.
+    //
+
+    if (Dimensions == 2 && GroupCount > 1 && InputChannels == 1 && K > 1) {
+
+        Parameters->Algorithm = MlasConvAlgorithmDepthwise;
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -1226,9 +1780,139 @@ Return Value:
 
         Parameters->ThreadCount = TargetThreadCount;
 
-        Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
-        Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+        if (Dimensions == 2) {
+
+            //
+            // Pack the convolution patches of each slice directly from the input
+            // image through an indirection buffer instead of expanding them to
+            // the working buffer first.
+            //
+
+            Parameters->Algorithm = MlasConvAlgorithmIndirect;
+            Parameters->u.Indirect.ThreadStrideN = StrideN;
+
+            *WorkingBufferSize = MlasConvIndirectionBufferSize(Parameters) *
+                (sizeof(size_t) / sizeof(float));
+
+        } else {
+
+            Parameters->Algorithm = MlasConvAlgorithmExpandThenGemmSegmented;
+            Parameters->u.ExpandThenGemmSegmented.ThreadStrideN = StrideN;
+
+            *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+        }
+    }
+}
+
+size_t
+MLASCALL
+MlasConvIndirectionBufferSize(
+    const MLAS_CONV_PARAMETERS* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements of the indirection buffer for
+    a convolution prepared by MlasConvPrepare.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+Return Value:
+
+    Returns the number of elements of the indirection buffer, else zero if the
+    convolution does not use the indirect algorithm.
+
+--*/
+{
+    if (Parameters->Algorithm != MlasConvAlgorithmIndirect) {
+        return 0;
+    }
+
+    return (Parameters->K / Parameters->InputChannels) * Parameters->OutputSize;
+}
+
+void
+MLASCALL
+MlasConvBuildIndirectionBuffer(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    size_t* IndirectionBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine builds the indirection buffer for a convolution that uses the
+    indirect algorithm.
+
+    For each kernel position and output element, the buffer stores the offset
+    of the sampled element inside a channel of the input image, or
+    MLAS_CONV_INDIRECTION_PADDING if the element lies in the zero padding.
+    The buffer only depends on the shape of the convolution, so callers may
+    cache it across calls and supply it through Parameters->IndirectionBuffer.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    IndirectionBuffer - Supplies the buffer to receive the number of elements
+        returned by MlasConvIndirectionBufferSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t HeightShapeIndex = 0;
+    constexpr size_t WidthShapeIndex = 1;
+
+    const size_t InputHeight = Parameters->InputShape[HeightShapeIndex];
+    const size_t InputWidth = Parameters->InputShape[WidthShapeIndex];
+
+    const size_t OutputHeight = Parameters->OutputShape[HeightShapeIndex];
+    const size_t OutputWidth = Parameters->OutputShape[WidthShapeIndex];
+
+    const size_t KernelHeight = Parameters->KernelShape[HeightShapeIndex];
+    const size_t KernelWidth = Parameters->KernelShape[WidthShapeIndex];
 
-        *WorkingBufferSize = TargetThreadCount * MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD;
+    const size_t DilationHeight = Parameters->DilationShape[HeightShapeIndex];
+    const size_t DilationWidth = Parameters->DilationShape[WidthShapeIndex];
+
+    const size_t PaddingLeftY = Parameters->Padding[HeightShapeIndex];
+    const size_t PaddingLeftX = Parameters->Padding[WidthShapeIndex];
+
+    const size_t StrideHeight = Parameters->StrideShape[HeightShapeIndex];
+    const size_t StrideWidth = Parameters->StrideShape[WidthShapeIndex];
+
+    for (size_t ky = 0; ky < KernelHeight; ky++) {
+
+        for (size_t kx = 0; kx < KernelWidth; kx++) {
+
+            for (size_t oh = 0; oh < OutputHeight; oh++) {
+
+                //
+                // Out of range rows wrap around to large unsigned values and
+                // are treated as padding.
+                //
+
+                const size_t ih = oh * StrideHeight + ky * DilationHeight - PaddingLeftY;
+
+                for (size_t ow = 0; ow < OutputWidth; ow++) {
+
+                    const size_t iw = ow * StrideWidth + kx * DilationWidth - PaddingLeftX;
+
+                    if (ih < InputHeight && iw < InputWidth) {
+                        *IndirectionBuffer++ = ih * InputWidth + iw;
+                    } else {
+                        *IndirectionBuffer++ = MLAS_CONV_INDIRECTION_PADDING;
+                    }
+                }
+            }
+        }
     }
 }
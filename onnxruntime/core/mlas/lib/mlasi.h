@@ -129,6 +129,13 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 
+//
+// Define the alignment for segmenting a QGEMM operation across multiple
+// threads. The U8X8 kernels process 16 columns of matrix B per iteration.
+//
+
+#define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
+
 //
 // Define the prototypes of the platform optimized routines.
 //
@@ -385,6 +392,28 @@ void
 
 typedef MLAS_ELEMENTWISE_KERNEL_ROUTINE* PMLAS_ELEMENTWISE_KERNEL_ROUTINE;
 
+typedef
+float
+(MLASCALL MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL)(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    );
+
+typedef MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL;
+
+typedef
+void
+(MLASCALL MLAS_MURMUR_HASH3_U32_KERNEL)(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t N,
+    uint32_t Seed
+    );
+
+typedef MLAS_MURMUR_HASH3_U32_KERNEL* PMLAS_MURMUR_HASH3_U32_KERNEL;
+
 extern "C" {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
@@ -393,6 +422,7 @@ extern "C" {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_GEMM_FLOAT_KERNEL MlasGemmFloatKernelFma3;
     MLAS_GEMM_FLOAT_KERNEL MlasGemmFloatKernelAvx512F;
+    MLAS_GEMM_FLOAT_KERNEL MlasGemmFloatKernelAvx512Bf16;
 #endif
 #else
     MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelZero;
@@ -469,10 +499,18 @@ extern "C" {
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasLogisticKernel;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasTanhKernel;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernel;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
 #if defined(MLAS_TARGET_AMD64)
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasLogisticKernelFma3;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasTanhKernelFma3;
     MLAS_ELEMENTWISE_KERNEL_ROUTINE MlasErfKernelFma3;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelFma3;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
+#endif
+
+    MLAS_MURMUR_HASH3_U32_KERNEL MlasMurmurHash3U32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_MURMUR_HASH3_U32_KERNEL MlasMurmurHash3U32KernelAvx2;
 #endif
 
 }
@@ -514,9 +552,18 @@ extern "C" {
 #endif
 
 //
-// Single-threaded single precision matrix/matrix multiply operation.
+// Define the target number of per-thread multiplies before using another
+// thread to perform additional work for a QGEMM operation.
+//
+
+#define MLAS_QGEMM_THREAD_COMPLEXITY                MLAS_SGEMM_THREAD_COMPLEXITY
+
+//
+// Single-threaded single precision matrix/matrix multiply operation. Matrix B
+// is stored as float or MLAS_FP16 elements.
 //
 
+template<typename BType>
 void
 MlasSgemmOperation(
     CBLAS_TRANSPOSE TransA,
@@ -527,11 +574,83 @@ MlasSgemmOperation(
     float alpha,
     const float* A,
     size_t lda,
-    const float* B,
+    const BType* B,
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const float* Bias = nullptr,
+    const MLAS_ACTIVATION* Activation = nullptr,
+    bool UseBf16 = false
+    );
+
+//
+// Multiplies a slice of matrix A by a panel of matrix B that is already in the
+// packed layout produced by MlasSgemmCopyPackB.
+//
+
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    bool UseBf16
+    );
+
+//
+// Requantizes a block of the 32-bit output of a quantized matrix multiply
+// with the supplied leading dimensions.
+//
+
+void
+MlasRequantizeOutputBlock(
+    const int32_t* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+//
+// Quantizes a block of a float matrix to uint8_t and dequantizes a block of
+// the 32-bit output of a quantized matrix multiply to float, with the supplied
+// leading dimensions.
+//
+
+void
+MlasQuantizeLinearBlock(
+    const float* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    );
+
+void
+MlasDequantizeOutputBlock(
+    const int32_t* Input,
+    size_t ldi,
+    float* Output,
+    size_t ldo,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    float Scale
     );
 
 //
@@ -553,6 +672,7 @@ struct MLAS_PLATFORM {
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
+    PMLAS_GEMM_FLOAT_KERNEL GemmFloatBf16Kernel;
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1Routine;
     PMLAS_SGEMM_KERNEL_M1_ROUTINE KernelM1TransposeBRoutine;
     PMLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE TransposePackB16x4Routine;
@@ -564,9 +684,29 @@ struct MLAS_PLATFORM {
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE LogisticKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE TanhKernelRoutine;
     PMLAS_ELEMENTWISE_KERNEL_ROUTINE ErfKernelRoutine;
+    PMLAS_COMPUTE_SUMEXP_FLOAT_KERNEL ComputeSumExpF32Kernel;
+    PMLAS_MURMUR_HASH3_U32_KERNEL MurmurHash3U32Kernel;
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
 #endif
+
+    //
+    // Names of the kernels selected for this platform, reported through
+    // MlasGetKernelSelection.
+    //
+
+    struct KERNEL_NAMES {
+        const char* Sgemm;
+        const char* SgemmBf16;
+        const char* QgemmU8S8;
+        const char* QgemmU8U8;
+        const char* Conv;
+        const char* Pool;
+        const char* Softmax;
+        const char* Elementwise;
+    } KernelNames;
+
+    char KernelSelection[256];
 };
 
 extern MLAS_PLATFORM MlasPlatform;
@@ -937,6 +1077,130 @@ MlasPowerOf2Float32x4(MLAS_FLOAT32X4 Vector)
 #endif
 }
 
+//
+// Half precision conversion helpers.
+//
+
+inline
+float
+MlasConvertHalfToFloat(
+    MLAS_FP16 Value
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a half precision float to a single precision float.
+
+    The conversion uses the same integer sequence as the vector form below:
+    the exponent is rebiased for normal values, infinities and NaNs, and
+    denormal values are normalized by subtracting a magic floating point
+    constant, which remains exact when denormals are flushed to zero.
+
+Arguments:
+
+    Value - Supplies the half precision float to convert.
+
+Return Value:
+
+    Returns the single precision float.
+
+--*/
+{
+    const uint32_t ExponentMantissa = uint32_t(Value.val & 0x7FFF);
+    const uint32_t Sign = uint32_t(Value.val & 0x8000) << 16;
+    const uint32_t Shifted = ExponentMantissa << 13;
+
+    uint32_t Bits;
+
+    if (ExponentMantissa < 0x0400) {
+
+        const uint32_t MagicDenormalBits = 0x38800000;
+        const uint32_t DenormalBits = Shifted + MagicDenormalBits;
+
+        float MagicDenormal;
+        float Denormal;
+
+        memcpy(&MagicDenormal, &MagicDenormalBits, sizeof(float));
+        memcpy(&Denormal, &DenormalBits, sizeof(float));
+
+        Denormal -= MagicDenormal;
+
+        memcpy(&Bits, &Denormal, sizeof(float));
+
+    } else {
+
+        Bits = Shifted + 0x38000000;
+
+        if (ExponentMantissa >= 0x7C00) {
+            Bits += 0x38000000;
+        }
+    }
+
+    Bits |= Sign;
+
+    float Result;
+    memcpy(&Result, &Bits, sizeof(float));
+    return Result;
+}
+
+inline
+MLAS_FLOAT32X4
+MlasConvertHalfToFloat32x4(
+    const MLAS_FP16* Source
+    )
+/*++
+
+Routine Description:
+
+    This routine converts four half precision floats to a vector of single
+    precision floats.
+
+Arguments:
+
+    Source - Supplies the address of the half precision floats.
+
+Return Value:
+
+    Returns the vector of single precision floats.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(&Source[0].val)));
+#elif defined(MLAS_SSE2_INTRINSICS)
+    const __m128i AdjustExponent = _mm_set1_epi32(0x38000000);
+    const __m128i MagicDenormal = _mm_set1_epi32(0x38800000);
+
+    __m128i Half = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)Source), _mm_setzero_si128());
+    __m128i ExponentMantissa = _mm_and_si128(Half, _mm_set1_epi32(0x7FFF));
+    __m128i Sign = _mm_slli_epi32(_mm_xor_si128(Half, ExponentMantissa), 16);
+    __m128i IsFinite = _mm_cmpgt_epi32(_mm_set1_epi32(0x7C00), ExponentMantissa);
+    __m128i IsDenormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x0400), ExponentMantissa);
+    __m128i Shifted = _mm_slli_epi32(ExponentMantissa, 13);
+
+    __m128i Normal = _mm_add_epi32(Shifted, AdjustExponent);
+    Normal = _mm_add_epi32(Normal, _mm_andnot_si128(IsFinite, AdjustExponent));
+
+    __m128 Denormal = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(Shifted, MagicDenormal)),
+        _mm_castsi128_ps(MagicDenormal));
+
+    __m128 Value = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(IsDenormal), Denormal),
+        _mm_andnot_ps(_mm_castsi128_ps(IsDenormal), _mm_castsi128_ps(Normal)));
+
+    return _mm_or_ps(Value, _mm_castsi128_ps(Sign));
+#else
+    float Values[4];
+
+    Values[0] = MlasConvertHalfToFloat(Source[0]);
+    Values[1] = MlasConvertHalfToFloat(Source[1]);
+    Values[2] = MlasConvertHalfToFloat(Source[2]);
+    Values[3] = MlasConvertHalfToFloat(Source[3]);
+
+    return MlasLoadFloat32x4(Values);
+#endif
+}
+
 //
 // Reads a platform specific time stamp counter.
 //
@@ -0,0 +1,144 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    murmurhash.cpp
+
+Abstract:
+
+    This module implements routines to compute the 32-bit MurmurHash3
+    (MurmurHash3_x86_32) of buffers of 32-bit keys, as used for feature
+    hashing.
+
+    MurmurHash3 was written by Austin Appleby, and is placed in the public
+    domain.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+uint32_t
+MlasMurmurHash3U32Key(
+    uint32_t Key,
+    uint32_t Seed
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the MurmurHash3_x86_32 hash of a single 4 byte key,
+    which is a single block with no tail.
+
+Arguments:
+
+    Key - Supplies the key to hash.
+
+    Seed - Supplies the seed of the hash.
+
+Return Value:
+
+    Returns the hash of the key.
+
+--*/
+{
+    uint32_t k1 = Key * 0xcc9e2d51;
+    k1 = (k1 << 15) | (k1 >> 17);
+    k1 *= 0x1b873593;
+
+    uint32_t h1 = Seed ^ k1;
+    h1 = (h1 << 13) | (h1 >> 19);
+    h1 = h1 * 5 + 0xe6546b64;
+
+    //
+    // Finalize with the length of the key and force all bits to avalanche.
+    //
+
+    h1 ^= 4;
+    h1 ^= h1 >> 16;
+    h1 *= 0x85ebca6b;
+    h1 ^= h1 >> 13;
+    h1 *= 0xc2b2ae35;
+    h1 ^= h1 >> 16;
+
+    return h1;
+}
+
+void
+MLASCALL
+MlasMurmurHash3U32Kernel(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t N,
+    uint32_t Seed
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to compute the hash of each
+    key of a buffer. The loop has no branches so that the compiler can
+    vectorize it for the baseline instruction set.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Seed - Supplies the seed of the hash.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n++) {
+        Output[n] = MlasMurmurHash3U32Key(Input[n], Seed);
+    }
+}
+
+void
+MLASCALL
+MlasMurmurHash3U32(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t N,
+    uint32_t Seed
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the MurmurHash3_x86_32 hash of each 32-bit key of
+    the input buffer, hashing the 4 bytes of the key in memory order.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Seed - Supplies the seed of the hash.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+    MlasPlatform.MurmurHash3U32Kernel(Input, Output, N, Seed);
+#else
+    MlasMurmurHash3U32Kernel(Input, Output, N, Seed);
+#endif
+}
@@ -0,0 +1,536 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    normalize.cpp
+
+Abstract:
+
+    This module implements the routines for the inference of the batch and
+    instance normalization operators.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Define the target number of per-thread elements before using another thread
+// to perform additional work.
+//
+
+#define MLAS_NORMALIZATION_THREAD_ELEMENTS          (16 * 1024)
+
+//
+// Define the parameters to execute a normalization on worker threads. Each
+// row of the input is one channel of one batch.
+//
+
+struct MLAS_NORMALIZATION_WORK_BLOCK {
+    const float* Input;
+    float* Output;
+    const float* Scale;
+    const float* Shift;
+    size_t Channels;
+    size_t ChannelSize;
+    size_t RowCount;
+    float Epsilon;
+    int32_t ThreadCount;
+};
+
+void
+MlasChannelScaleShiftRow(
+    const float* Input,
+    float* Output,
+    size_t N,
+    float Scale,
+    float Shift
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Output = Input * Scale + Shift for a row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    N - Supplies the number of elements of the row.
+
+    Scale - Supplies the scale to apply to each element.
+
+    Shift - Supplies the shift to apply to each scaled element.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const MLAS_FLOAT32X4 ShiftVector = MlasBroadcastFloat32x4(Shift);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input);
+        MlasStoreFloat32x4(Output, MlasMultiplyAddFloat32x4(Vector, ScaleVector, ShiftVector));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output = *Input * Scale + Shift;
+
+        Input += 1;
+        Output += 1;
+        N -= 1;
+    }
+}
+
+void
+MlasComputeMeanVarianceRow(
+    const float* Input,
+    size_t N,
+    float* Mean,
+    float* Variance
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the mean and the population variance of a row in a
+    single pass using Welford's algorithm, which avoids the cancellation of
+    the sum of squares formula for rows with a large mean.
+
+    Each lane of a vector accumulates the statistics of every fourth element
+    and the lanes and the remaining elements are then merged.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    N - Supplies the number of elements of the row.
+
+    Mean - Receives the mean of the row.
+
+    Variance - Receives the variance of the row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 MeanVector = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 M2Vector = MlasZeroFloat32x4();
+    size_t VectorCount = 0;
+
+    const float* input = Input;
+    size_t n = N;
+
+    while (n >= 4) {
+
+        VectorCount += 1;
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(input);
+        MLAS_FLOAT32X4 Delta = MlasSubtractFloat32x4(Vector, MeanVector);
+        MLAS_FLOAT32X4 Reciprocal = MlasBroadcastFloat32x4(1.0f / float(VectorCount));
+        MeanVector = MlasMultiplyAddFloat32x4(Delta, Reciprocal, MeanVector);
+        M2Vector = MlasMultiplyAddFloat32x4(Delta, MlasSubtractFloat32x4(Vector, MeanVector), M2Vector);
+
+        input += 4;
+        n -= 4;
+    }
+
+    float LaneMean[4];
+    float LaneM2[4];
+
+    MlasStoreFloat32x4(LaneMean, MeanVector);
+    MlasStoreFloat32x4(LaneM2, M2Vector);
+
+    //
+    // Merge the statistics of the lanes, which all have the same count, then
+    // continue Welford's algorithm through the remaining elements.
+    //
+
+    float mean = 0.0f;
+    float m2 = 0.0f;
+    size_t count = 0;
+
+    if (VectorCount > 0) {
+
+        mean = (LaneMean[0] + LaneMean[1] + LaneMean[2] + LaneMean[3]) * 0.25f;
+        m2 = LaneM2[0] + LaneM2[1] + LaneM2[2] + LaneM2[3];
+
+        for (size_t lane = 0; lane < 4; lane++) {
+            const float delta = LaneMean[lane] - mean;
+            m2 += delta * delta * float(VectorCount);
+        }
+
+        count = VectorCount * 4;
+    }
+
+    while (n > 0) {
+
+        count += 1;
+
+        const float delta = *input - mean;
+        mean += delta / float(count);
+        m2 += delta * (*input - mean);
+
+        input += 1;
+        n -= 1;
+    }
+
+    *Mean = mean;
+    *Variance = (N > 0) ? m2 / float(N) : 0.0f;
+}
+
+void
+MlasNormalizationThreadPartition(
+    const MLAS_NORMALIZATION_WORK_BLOCK* WorkBlock,
+    int32_t Index,
+    size_t* RowStart,
+    size_t* RowCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the range of rows processed by a worker thread.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the normalization
+        parameters.
+
+    Index - Supplies the current index of the threaded operation.
+
+    RowStart - Receives the first row to process.
+
+    RowCount - Receives the number of rows to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t WorkPerThread = WorkBlock->RowCount / WorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = WorkBlock->RowCount % WorkBlock->ThreadCount;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        *RowStart = (WorkPerThread + 1) * Index;
+        *RowCount = WorkPerThread + 1;
+    } else {
+        *RowStart = WorkPerThread * Index + WorkPerThreadExtra;
+        *RowCount = WorkPerThread;
+    }
+}
+
+void
+MlasChannelScaleShiftThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    channel scale and shift operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NORMALIZATION_WORK_BLOCK*)Context;
+
+    size_t RowStart;
+    size_t RowCount;
+
+    MlasNormalizationThreadPartition(WorkBlock, Index, &RowStart, &RowCount);
+
+    const size_t ChannelSize = WorkBlock->ChannelSize;
+
+    for (size_t row = RowStart; row < RowStart + RowCount; row++) {
+
+        const size_t c = row % WorkBlock->Channels;
+
+        MlasChannelScaleShiftRow(WorkBlock->Input + row * ChannelSize,
+            WorkBlock->Output + row * ChannelSize, ChannelSize,
+            WorkBlock->Scale[c], WorkBlock->Shift[c]);
+    }
+}
+
+void
+MlasInstanceNormalizationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    instance normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_NORMALIZATION_WORK_BLOCK*)Context;
+
+    size_t RowStart;
+    size_t RowCount;
+
+    MlasNormalizationThreadPartition(WorkBlock, Index, &RowStart, &RowCount);
+
+    const size_t ChannelSize = WorkBlock->ChannelSize;
+
+    for (size_t row = RowStart; row < RowStart + RowCount; row++) {
+
+        const size_t c = row % WorkBlock->Channels;
+        const float* Input = WorkBlock->Input + row * ChannelSize;
+
+        float Mean;
+        float Variance;
+
+        MlasComputeMeanVarianceRow(Input, ChannelSize, &Mean, &Variance);
+
+        //
+        // Fold the normalization into a scale and shift of the row.
+        //
+
+        const float Scale = WorkBlock->Scale[c] / std::sqrt(Variance + WorkBlock->Epsilon);
+        const float Shift = WorkBlock->Shift[c] - Mean * Scale;
+
+        MlasChannelScaleShiftRow(Input, WorkBlock->Output + row * ChannelSize,
+            ChannelSize, Scale, Shift);
+    }
+}
+
+void
+MlasNormalizationOperation(
+    PMLAS_THREADED_ROUTINE ThreadedRoutine,
+    MLAS_NORMALIZATION_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine partitions the rows of a normalization operation across
+    worker threads.
+
+Arguments:
+
+    ThreadedRoutine - Supplies the routine that processes a range of rows.
+
+    WorkBlock - Supplies the structure that contains the normalization
+        parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (WorkBlock->RowCount == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of rows and try to
+    // keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
+
+    const double Complexity = double(WorkBlock->RowCount) * double(WorkBlock->ChannelSize);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_NORMALIZATION_THREAD_ELEMENTS * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_NORMALIZATION_THREAD_ELEMENTS)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) > WorkBlock->RowCount) {
+        TargetThreadCount = int32_t(WorkBlock->RowCount);
+    }
+
+    WorkBlock->ThreadCount = TargetThreadCount;
+
+    if (TargetThreadCount == 1) {
+        ThreadedRoutine(WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(ThreadedRoutine, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeChannelScaleShift(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Shift,
+    size_t BatchCount,
+    size_t Channels,
+    size_t ChannelSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine applies a per channel scale and shift to a batch of NCHW
+    tensors, which is the inference of batch normalization once its mean,
+    variance, scale and bias are folded into one scale and shift per channel.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input tensor of BatchCount x Channels x ChannelSize
+        elements.
+
+    Output - Supplies the output tensor of the same shape.
+
+    Scale - Supplies the scale of each channel.
+
+    Shift - Supplies the shift of each channel, added after the scale.
+
+    BatchCount - Supplies the number of batches.
+
+    Channels - Supplies the number of channels per batch.
+
+    ChannelSize - Supplies the number of elements per channel.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NORMALIZATION_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Shift = Shift;
+    WorkBlock.Channels = Channels;
+    WorkBlock.ChannelSize = ChannelSize;
+    WorkBlock.RowCount = BatchCount * Channels;
+    WorkBlock.Epsilon = 0.0f;
+
+    MlasNormalizationOperation(MlasChannelScaleShiftThreaded, &WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeInstanceNormalization(
+    const float* Input,
+    float* Output,
+    const float* Scale,
+    const float* Bias,
+    size_t BatchCount,
+    size_t Channels,
+    size_t ChannelSize,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the instance normalization of a batch of NCHW
+    tensors: each channel of each batch is normalized by its own mean and
+    variance, computed in a single pass, then scaled and biased per channel.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input tensor of BatchCount x Channels x ChannelSize
+        elements.
+
+    Output - Supplies the output tensor of the same shape.
+
+    Scale - Supplies the scale of each channel.
+
+    Bias - Supplies the bias of each channel.
+
+    BatchCount - Supplies the number of batches.
+
+    Channels - Supplies the number of channels per batch.
+
+    ChannelSize - Supplies the number of elements per channel.
+
+    Epsilon - Supplies the value added to the variance to avoid dividing by
+        zero.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_NORMALIZATION_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Shift = Bias;
+    WorkBlock.Channels = Channels;
+    WorkBlock.ChannelSize = ChannelSize;
+    WorkBlock.RowCount = BatchCount * Channels;
+    WorkBlock.Epsilon = Epsilon;
+
+    MlasNormalizationOperation(MlasInstanceNormalizationThreaded, &WorkBlock, ThreadPool);
+}
@@ -17,6 +17,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <stdio.h>
+
 //
 // Stores the platform information.
 //
@@ -78,6 +80,28 @@ Return Value:
 --*/
 {
 
+    //
+    // Default to the portable kernels. These are replaced below as the
+    // platform specific kernels are selected.
+    //
+
+#if defined(MLAS_NEON_INTRINSICS)
+    this->KernelNames.Sgemm = "Neon";
+    this->KernelNames.Conv = "Neon";
+    this->KernelNames.Pool = "Neon";
+    this->KernelNames.Softmax = "Neon";
+    this->KernelNames.Elementwise = "Neon";
+#else
+    this->KernelNames.Sgemm = "Portable";
+    this->KernelNames.Conv = "Portable";
+    this->KernelNames.Pool = "Portable";
+    this->KernelNames.Softmax = "Portable";
+    this->KernelNames.Elementwise = "Portable";
+#endif
+    this->KernelNames.SgemmBf16 = "None";
+    this->KernelNames.QgemmU8S8 = "None";
+    this->KernelNames.QgemmU8U8 = "None";
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
     //
@@ -92,6 +116,10 @@ Return Value:
     this->GemmU8U8CopyPackBRoutine = MlasGemmU8U8CopyPackBSse;
     this->GemmU8U8Kernel = MlasGemmU8U8KernelSse;
 
+    this->KernelNames.Sgemm = "Sse";
+    this->KernelNames.QgemmU8S8 = "Sse";
+    this->KernelNames.QgemmU8U8 = "Sse";
+
 #if defined(MLAS_TARGET_AMD64)
 
     this->TransposePackB16x4Routine = MlasSgemmTransposePackB16x4Sse;
@@ -105,9 +133,16 @@ Return Value:
     this->LogisticKernelRoutine = MlasLogisticKernel;
     this->TanhKernelRoutine = MlasTanhKernel;
     this->ErfKernelRoutine = MlasErfKernel;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->MurmurHash3U32Kernel = MlasMurmurHash3U32Kernel;
     this->NchwcBlockSize = 8;
     this->PreferredBufferAlignment = MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
 
+    this->KernelNames.Conv = "Sse";
+    this->KernelNames.Pool = "Sse";
+    this->KernelNames.Softmax = "Sse";
+    this->KernelNames.Elementwise = "Sse";
+
 #endif
 
     //
@@ -133,6 +168,8 @@ Return Value:
 
             this->GemmFloatKernel = MlasGemmFloatKernelAvx;
 
+            this->KernelNames.Sgemm = "Avx";
+
 #if defined(MLAS_TARGET_AMD64)
 
             this->KernelM1Routine = MlasSgemmKernelM1Avx;
@@ -146,6 +183,9 @@ Return Value:
             this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx;
             this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx;
 
+            this->KernelNames.Conv = "Avx";
+            this->KernelNames.Pool = "Avx";
+
             //
             // Check if the processor supports AVX512F (and the operating
             // system supports saving AVX512F state) or AVX2/FMA3 features.
@@ -167,6 +207,11 @@ Return Value:
                 this->GemmU8U8CopyPackBRoutine = MlasGemmU8U8CopyPackBAvx2;
                 this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx2;
 
+                this->MurmurHash3U32Kernel = MlasMurmurHash3U32KernelAvx2;
+
+                this->KernelNames.QgemmU8S8 = "Avx2";
+                this->KernelNames.QgemmU8U8 = "Avx2";
+
                 if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
 
                     this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
@@ -177,9 +222,15 @@ Return Value:
                     this->PoolFloatKernel[MlasMaximumPooling] = MlasPoolMaximumFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingExcludePad] = MlasPoolAverageExcludePadFloatKernelAvx512F;
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
+                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
                     this->NchwcBlockSize = 16;
                     this->PreferredBufferAlignment = 64;
 
+                    this->KernelNames.Sgemm = "Avx512F";
+                    this->KernelNames.Conv = "Avx512F";
+                    this->KernelNames.Pool = "Avx512F";
+                    this->KernelNames.Softmax = "Avx512F";
+
                     //
                     // Check if the processor supports AVX512BW.
                     //
@@ -189,6 +240,9 @@ Return Value:
                         this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512BW;
                         this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512BW;
 
+                        this->KernelNames.QgemmU8S8 = "Avx512BW";
+                        this->KernelNames.QgemmU8U8 = "Avx512BW";
+
                         //
                         // Check if the processor supports AVX512VNNI.
                         //
@@ -197,7 +251,36 @@ Return Value:
 
                             this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
                             this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Vnni;
+
+                            this->KernelNames.QgemmU8S8 = "Avx512Vnni";
+                            this->KernelNames.QgemmU8U8 = "Avx512Vnni";
+                        }
+
+#if defined(MLAS_AVX512BF16_SUPPORTED)
+
+                        //
+                        // Check if the processor supports AVX512-BF16. The
+                        // kernel is only used by MlasSgemmBf16.
+                        //
+
+                        if (Cpuid7[0] >= 1) {
+
+                            unsigned Cpuid7_1[4];
+#if defined(_WIN32)
+                            __cpuidex((int*)Cpuid7_1, 7, 1);
+#else
+                            __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
+#endif
+
+                            if ((Cpuid7_1[0] & 0x20) != 0) {
+
+                                this->GemmFloatBf16Kernel = MlasGemmFloatKernelAvx512Bf16;
+
+                                this->KernelNames.SgemmBf16 = "Avx512Bf16";
+                            }
                         }
+
+#endif
                     }
 
                 } else {
@@ -207,11 +290,18 @@ Return Value:
                     this->ConvNchwcFloatKernel = MlasConvNchwcFloatKernelFma3;
                     this->ConvDepthwiseFloatKernel = MlasConvDepthwiseFloatKernelFma3;
                     this->ConvPointwiseFloatKernel = MlasConvPointwiseFloatKernelFma3;
+                    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+
+                    this->KernelNames.Sgemm = "Fma3";
+                    this->KernelNames.Conv = "Fma3";
+                    this->KernelNames.Softmax = "Fma3";
                 }
 
                 this->LogisticKernelRoutine = MlasLogisticKernelFma3;
                 this->TanhKernelRoutine = MlasTanhKernelFma3;
                 this->ErfKernelRoutine = MlasErfKernelFma3;
+
+                this->KernelNames.Elementwise = "Fma3";
             }
 
 #endif
@@ -221,6 +311,18 @@ Return Value:
 
 #endif
 
+    //
+    // Format the kernel selection report.
+    //
+
+    snprintf(this->KernelSelection, sizeof(this->KernelSelection),
+        "Sgemm=%s SgemmBf16=%s QgemmU8S8=%s QgemmU8U8=%s Conv=%s Pool=%s "
+        "Softmax=%s Elementwise=%s NchwcBlockSize=%zu",
+        this->KernelNames.Sgemm, this->KernelNames.SgemmBf16,
+        this->KernelNames.QgemmU8S8, this->KernelNames.QgemmU8U8,
+        this->KernelNames.Conv, this->KernelNames.Pool,
+        this->KernelNames.Softmax, this->KernelNames.Elementwise,
+        MlasNchwcGetBlockSize());
 }
 
 size_t
@@ -252,3 +354,32 @@ Return Value:
     return MLAS_DEFAULT_PREFERRED_BUFFER_ALIGNMENT;
 #endif
 }
+
+const char*
+MLASCALL
+MlasGetKernelSelection(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns a description of the kernels that were selected for
+    this platform, for example to log which code paths are used on a given
+    processor.
+
+    The description is a space separated list of routine=kernel pairs.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns a null terminated string that is valid for the lifetime of the
+    process.
+
+--*/
+{
+    return MlasPlatform.KernelSelection;
+}
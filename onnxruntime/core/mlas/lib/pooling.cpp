@@ -46,6 +46,29 @@ void
 
 typedef MLAS_POOL_KERNEL_ROUTINE* PMLAS_POOL_KERNEL_ROUTINE;
 
+//
+// Define the parameters to split the channels of a pooling operation across
+// worker threads.
+//
+
+struct MLAS_POOL_THREADED_WORK_BLOCK {
+    const MLAS_WORK_BLOCK* WorkBlock;
+    PMLAS_POOL_KERNEL_ROUTINE PoolKernelRoutine;
+    const float* Input;
+    float* Output;
+    size_t TotalChannelCount;
+    size_t OutputSize;
+    int32_t ThreadCount;
+};
+
+//
+// Define the target number of per-thread elements, the product of the output
+// size and the kernel size, before using another thread to perform additional
+// work.
+//
+
+#define MLAS_POOL_THREAD_ELEMENTS           (64 * 1024)
+
 //
 // Define the number of elements to allocate on the stack for the reduction
 // buffer in the vectorized kernels.
@@ -1171,6 +1194,59 @@ static const PMLAS_POOL_KERNEL_ROUTINE MlasPoolVectorKernels[][2] =
     },
 };
 
+void
+MlasPoolThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    pooling operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* ThreadedWorkBlock = (MLAS_POOL_THREADED_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the channels.
+    //
+
+    const size_t TotalChannelCount = ThreadedWorkBlock->TotalChannelCount;
+
+    const size_t WorkPerThread = TotalChannelCount / ThreadedWorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = TotalChannelCount % ThreadedWorkBlock->ThreadCount;
+
+    size_t c;
+    size_t ChannelCount;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        c = (WorkPerThread + 1) * Index;
+        ChannelCount = WorkPerThread + 1;
+    } else {
+        c = WorkPerThread * Index + WorkPerThreadExtra;
+        ChannelCount = WorkPerThread;
+    }
+
+    const MLAS_WORK_BLOCK* WorkBlock = ThreadedWorkBlock->WorkBlock;
+
+    ThreadedWorkBlock->PoolKernelRoutine(WorkBlock, ChannelCount,
+        ThreadedWorkBlock->Input + c * WorkBlock->InputSize,
+        ThreadedWorkBlock->Output + c * ThreadedWorkBlock->OutputSize);
+}
+
 void
 MLASCALL
 MlasPool(
@@ -1319,35 +1395,57 @@ Return Value:
         }
     }
 
-#ifdef MLAS_NO_ONNXRUNTIME_THREADPOOL
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
-#else
     //
-    // Use an external thread pool if one is provided.
-    // TODO: change to use MlasExecuteThreaded
+    // Compute the number of target threads given the complexity of the pooling
+    // operation. Limit the number of threads to the number of channels and try
+    // to keep each thread processing a minimum number of elements before using
+    // another thread.
+    //
 
-    // TODO: revisit the strategy of multi-threading logic
-    if (0 && !(ThreadPool == nullptr)) {
-        std::function<void(int32_t)> WorkObject = [&](int64_t c) { PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize); };
-        ThreadPool->ParallelFor((int32_t)TotalChannelCount, WorkObject);
-        return;
+    size_t KernelSize = 1;
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        KernelSize *= size_t(WorkBlock.KernelShape[dim]);
     }
-#endif
 
-    //
-    // Execute the pooling kernel routine.
-    //
+    const double Complexity = double(TotalChannelCount) * double(OutputSize) * double(KernelSize);
 
-#if defined(_OPENMP)
+    int32_t TargetThreadCount;
 
-#pragma omp parallel for
-    for (int64_t c = 0; c < int64_t(TotalChannelCount); c++) {
-        PoolKernelRoutine(&WorkBlock, 1, Input + c * InputSize, Output + c * OutputSize);
+    if (Complexity < double(MLAS_POOL_THREAD_ELEMENTS * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_POOL_THREAD_ELEMENTS)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
     }
 
-#else
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
 
-    PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
 
-#endif
+    if (size_t(TargetThreadCount) > TotalChannelCount) {
+        TargetThreadCount = int32_t(TotalChannelCount);
+    }
+
+    if (TargetThreadCount <= 1) {
+        PoolKernelRoutine(&WorkBlock, TotalChannelCount, Input, Output);
+        return;
+    }
+
+    //
+    // Execute the pooling kernel routine on the channels of each thread.
+    //
+
+    MLAS_POOL_THREADED_WORK_BLOCK ThreadedWorkBlock;
+
+    ThreadedWorkBlock.WorkBlock = &WorkBlock;
+    ThreadedWorkBlock.PoolKernelRoutine = PoolKernelRoutine;
+    ThreadedWorkBlock.Input = Input;
+    ThreadedWorkBlock.Output = Output;
+    ThreadedWorkBlock.TotalChannelCount = TotalChannelCount;
+    ThreadedWorkBlock.OutputSize = OutputSize;
+    ThreadedWorkBlock.ThreadCount = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasPoolThreaded, &ThreadedWorkBlock, TargetThreadCount, ThreadPool);
 }
@@ -1093,22 +1093,166 @@ Return Value:
     return 1;
 }
 
+//
+// Define the parameters to execute segments of a QGEMM operation on worker
+// threads.
+//
+
+struct MLAS_GEMM_U8X8_WORK_BLOCK {
+    size_t K;
+    size_t lda;
+    size_t ldb;
+    size_t ldc;
+    uint8_t offa;
+    uint8_t offb;
+    float ScaleA;
+    const MLAS_QGEMM_REQUANTIZE* Requantize;
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize;
+    struct SEGMENT {
+        size_t M;
+        size_t N;
+        const uint8_t* A;
+        const float* FloatA;
+        const uint8_t* B;
+        int32_t* C;
+        uint8_t* Output;
+        const int32_t* Bias;
+        float* FloatOutput;
+        const float* FloatBias;
+    } Segments[MLAS_MAXIMUM_THREAD_COUNT];
+};
+
+inline
 void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
-    const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
-    const int8_t* B,
-    size_t ldb,
-    int8_t offb,
-    int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+MlasGemmU8X8RequantizeSlice(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    const MLAS_GEMM_U8X8_WORK_BLOCK::SEGMENT* Segment,
+    size_t n,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes or dequantizes a completed slice of columns of the
+    32-bit output of a QGEMM segment while the slice is still resident in the
+    cache.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the QGEMM parameters.
+
+    Segment - Supplies the segment of the QGEMM operation.
+
+    n - Supplies the starting column of the slice relative to the segment.
+
+    CountN - Supplies the number of columns of the slice.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_QGEMM_REQUANTIZE* Requantize = WorkBlock->Requantize;
+
+    if (Requantize != nullptr) {
+        MlasRequantizeOutputBlock(Segment->C + n, WorkBlock->ldc, Segment->Output + n,
+            Requantize->ldo, Segment->Bias, Segment->M, CountN, Requantize->Scale,
+            Requantize->ZeroPoint);
+    }
+
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize = WorkBlock->Dequantize;
+
+    if (Dequantize != nullptr) {
+        MlasDequantizeOutputBlock(Segment->C + n, WorkBlock->ldc, Segment->FloatOutput + n,
+            Dequantize->ldo, (Segment->FloatBias != nullptr) ? Segment->FloatBias + n : nullptr,
+            Segment->M, CountN, Dequantize->Scale);
+    }
+}
+
+inline
+void
+MlasGemmU8X8QuantizeBlockA(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    const MLAS_GEMM_U8X8_WORK_BLOCK::SEGMENT* Segment,
+    uint8_t* QuantizedA,
+    size_t m,
+    size_t k,
+    size_t CountM,
+    size_t CountK,
+    const uint8_t*& A,
+    size_t& lda
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the block of matrix A to pack. For a float matrix A,
+    the block is quantized to the supplied buffer first, so that the quantized
+    matrix A is only ever stored one block at a time.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the QGEMM parameters.
+
+    Segment - Supplies the segment of the QGEMM operation.
+
+    QuantizedA - Supplies the buffer of CountM by CountK elements that
+        receives the quantized block of a float matrix A.
+
+    m - Supplies the starting row of the block.
+
+    k - Supplies the starting column of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountK - Supplies the number of columns of the block.
+
+    A - Returns the address of the block to pack.
+
+    lda - Returns the first dimension of the block to pack.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Segment->FloatA != nullptr) {
+        MlasQuantizeLinearBlock(Segment->FloatA + k + m * WorkBlock->lda, WorkBlock->lda, QuantizedA,
+            CountK, CountM, CountK, WorkBlock->ScaleA, WorkBlock->offa);
+        A = QuantizedA;
+        lda = CountK;
+    } else {
+        A = Segment->A + k + m * WorkBlock->lda;
+        lda = WorkBlock->lda;
+    }
+}
+
+void
+MlasGemmU8S8Operation(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    const MLAS_GEMM_U8X8_WORK_BLOCK::SEGMENT* Segment
     )
+/*++
+
+Routine Description:
+
+    This routine implements a single threaded segment of the quantized
+    integer matrix/matrix multiply operation for a signed matrix B.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the QGEMM parameters.
+
+    Segment - Supplies the segment of the QGEMM operation.
+
+Return Value:
+
+    None.
+
+--*/
 {
     MLAS_DECLSPEC_ALIGN(uint8_t PanelA[MLAS_GEMM_U8S8_STRIDEM * MLAS_GEMM_U8S8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(int8_t PanelB[MLAS_GEMM_U8S8_STRIDEN * MLAS_GEMM_U8S8_STRIDEK], 64);
@@ -1116,30 +1260,49 @@ MlasGemm(
     MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8S8_STRIDEM], 16);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8S8_STRIDEN], 16);
 
+    MLAS_DECLSPEC_ALIGN(uint8_t QuantizedA[MLAS_GEMM_U8S8_STRIDEM * MLAS_GEMM_U8S8_STRIDEK], 16);
+
+    const size_t M = Segment->M;
+    const size_t N = Segment->N;
+    const size_t K = WorkBlock->K;
+
+    const int8_t* B = (const int8_t*)Segment->B;
+    int32_t* C = Segment->C;
+
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+
+    const uint8_t offa = WorkBlock->offa;
+    const int8_t offb = int8_t(WorkBlock->offb);
+
     size_t StrideM = MLAS_GEMM_U8S8_STRIDEM;
     size_t StrideN = MLAS_GEMM_U8S8_STRIDEN;
     size_t StrideK = MLAS_GEMM_U8S8_STRIDEK;
 
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    //
+    // Step through each slice of matrix B along the N dimension. The K loop
+    // completes each slice of matrix C so that the optional requantization
+    // runs while the slice is still resident in the cache.
+    //
 
-    size_t CountK;
+    size_t CountN;
 
-    for (size_t k = 0; k < K; k += CountK) {
+    for (size_t n = 0; n < N; n += CountN) {
 
-        CountK = StrideK;
+        CountN = StrideN;
 
-        if (CountK > (K - k)) {
-            CountK = K - k;
+        if (CountN > (N - n)) {
+            CountN = N - n;
         }
 
-        size_t CountN;
+        size_t CountK;
 
-        for (size_t n = 0; n < N; n += CountN) {
+        for (size_t k = 0; k < K; k += CountK) {
 
-            CountN = StrideN;
+            CountK = StrideK;
 
-            if (CountN > (N - n)) {
-                CountN = N - n;
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
 
             MlasPlatform.GemmU8S8CopyPackBRoutine(PanelB, B + n + k * ldb, ldb, CountN, CountK, ColumnSumVector, -int16_t(offa));
@@ -1154,7 +1317,12 @@ MlasGemm(
                     CountM = M - m;
                 }
 
-                MlasPlatform.GemmU8S8CopyPackARoutine(PanelA, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(offb));
+                const uint8_t* a;
+                size_t lda_pack;
+
+                MlasGemmU8X8QuantizeBlockA(WorkBlock, Segment, QuantizedA, m, k, CountM, CountK, a, lda_pack);
+
+                MlasPlatform.GemmU8S8CopyPackARoutine(PanelA, a, lda_pack, CountM, CountK, RowSumVector, -int16_t(offb));
 
                 uint8_t* pa = PanelA;
                 int32_t* c = C + n + m * ldc;
@@ -1177,25 +1345,34 @@ MlasGemm(
                 }
             }
         }
+
+        MlasGemmU8X8RequantizeSlice(WorkBlock, Segment, n, CountN);
     }
 }
 
 void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
-    const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
-    const uint8_t* B,
-    size_t ldb,
-    uint8_t offb,
-    int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+MlasGemmU8U8Operation(
+    const MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock,
+    const MLAS_GEMM_U8X8_WORK_BLOCK::SEGMENT* Segment
     )
+/*++
+
+Routine Description:
+
+    This routine implements a single threaded segment of the quantized
+    integer matrix/matrix multiply operation for an unsigned matrix B.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the QGEMM parameters.
+
+    Segment - Supplies the segment of the QGEMM operation.
+
+Return Value:
+
+    None.
+
+--*/
 {
     MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(uint8_t PanelB[MLAS_GEMM_U8U8_STRIDEN * MLAS_GEMM_U8U8_STRIDEK], 64);
@@ -1203,30 +1380,49 @@ MlasGemm(
     MLAS_DECLSPEC_ALIGN(int32_t RowSumVector[MLAS_GEMM_U8U8_STRIDEM], 16);
     MLAS_DECLSPEC_ALIGN(int32_t ColumnSumVector[MLAS_GEMM_U8U8_STRIDEN], 16);
 
+    MLAS_DECLSPEC_ALIGN(uint8_t QuantizedA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 16);
+
+    const size_t M = Segment->M;
+    const size_t N = Segment->N;
+    const size_t K = WorkBlock->K;
+
+    const uint8_t* B = Segment->B;
+    int32_t* C = Segment->C;
+
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+
+    const uint8_t offa = WorkBlock->offa;
+    const uint8_t offb = WorkBlock->offb;
+
     size_t StrideM = MLAS_GEMM_U8U8_STRIDEM;
     size_t StrideN = MLAS_GEMM_U8U8_STRIDEN;
     size_t StrideK = MLAS_GEMM_U8U8_STRIDEK;
 
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    //
+    // Step through each slice of matrix B along the N dimension. The K loop
+    // completes each slice of matrix C so that the optional requantization
+    // runs while the slice is still resident in the cache.
+    //
 
-    size_t CountK;
+    size_t CountN;
 
-    for (size_t k = 0; k < K; k += CountK) {
+    for (size_t n = 0; n < N; n += CountN) {
 
-        CountK = StrideK;
+        CountN = StrideN;
 
-        if (CountK > (K - k)) {
-            CountK = K - k;
+        if (CountN > (N - n)) {
+            CountN = N - n;
         }
 
-        size_t CountN;
+        size_t CountK;
 
-        for (size_t n = 0; n < N; n += CountN) {
+        for (size_t k = 0; k < K; k += CountK) {
 
-            CountN = StrideN;
+            CountK = StrideK;
 
-            if (CountN > (N - n)) {
-                CountN = N - n;
+            if (CountK > (K - k)) {
+                CountK = K - k;
             }
 
             MlasPlatform.GemmU8U8CopyPackBRoutine(PanelB, B + n + k * ldb, ldb, CountN, CountK, ColumnSumVector, -int16_t(offa));
@@ -1241,7 +1437,12 @@ MlasGemm(
                     CountM = M - m;
                 }
 
-                MlasPlatform.GemmU8U8CopyPackARoutine(PanelA, A + k + m * lda, lda, CountM, CountK, RowSumVector, -int16_t(offb));
+                const uint8_t* a;
+                size_t lda_pack;
+
+                MlasGemmU8X8QuantizeBlockA(WorkBlock, Segment, QuantizedA, m, k, CountM, CountK, a, lda_pack);
+
+                MlasPlatform.GemmU8U8CopyPackARoutine(PanelA, a, lda_pack, CountM, CountK, RowSumVector, -int16_t(offb));
 
                 int16_t* pa = PanelA;
                 int32_t* c = C + n + m * ldc;
@@ -1264,7 +1465,569 @@ MlasGemm(
                 }
             }
         }
+
+        MlasGemmU8X8RequantizeSlice(WorkBlock, Segment, n, CountN);
+    }
+}
+
+void
+MlasGemmU8S8OperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation for a signed matrix B.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock = (MLAS_GEMM_U8X8_WORK_BLOCK*)Context;
+
+    MlasGemmU8S8Operation(WorkBlock, &WorkBlock->Segments[Index]);
+}
+
+void
+MlasGemmU8U8OperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation for an unsigned matrix B.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK* WorkBlock = (MLAS_GEMM_U8X8_WORK_BLOCK*)Context;
+
+    MlasGemmU8U8Operation(WorkBlock, &WorkBlock->Segments[Index]);
+}
+
+void
+MlasGemmU8X8Schedule(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    const float* FloatA,
+    size_t lda,
+    float ScaleA,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize,
+    PMLAS_THREADED_ROUTINE ThreadedRoutine,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine segments a quantized integer matrix/matrix multiply operation
+    (QGEMM) across multiple threads and executes the segments.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A, else nullptr if FloatA is supplied.
+
+    FloatA - Supplies the address of a float matrix A that is quantized as it
+        is packed, else nullptr.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ScaleA - Supplies the scale to quantize FloatA with.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Requantize - Optionally supplies the parameters to requantize matrix C to
+        an 8-bit output as each slice of matrix C is completed.
+
+    Dequantize - Optionally supplies the parameters to dequantize matrix C to
+        a float output as each slice of matrix C is completed.
+
+    ThreadedRoutine - Supplies the routine to execute a segment of the QGEMM
+        operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_GEMM_U8X8_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the QGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
     }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+    WorkBlock.ScaleA = ScaleA;
+    WorkBlock.Requantize = Requantize;
+    WorkBlock.Dequantize = Dequantize;
+
+    uint8_t* Output = (Requantize != nullptr) ? Requantize->Output : nullptr;
+    const int32_t* Bias = (Requantize != nullptr) ? Requantize->Bias : nullptr;
+    size_t ldo = (Requantize != nullptr) ? Requantize->ldo : 0;
+
+    float* FloatOutput = (Dequantize != nullptr) ? Dequantize->Output : nullptr;
+    const float* FloatBias = (Dequantize != nullptr) ? Dequantize->Bias : nullptr;
+    size_t FloatLdo = (Dequantize != nullptr) ? Dequantize->ldo : 0;
+
+    //
+    // Segment the operation across multiple threads. Each segment owns a
+    // disjoint block of matrix C, so the requantization of a segment does not
+    // depend on any other segment.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN =
+            (StrideN + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].FloatA = FloatA;
+            WorkBlock.Segments[Index].B = B + n;
+            WorkBlock.Segments[Index].C = C + n;
+            WorkBlock.Segments[Index].Output = (Output != nullptr) ? Output + n : nullptr;
+            WorkBlock.Segments[Index].Bias = Bias;
+            WorkBlock.Segments[Index].FloatOutput = (FloatOutput != nullptr) ? FloatOutput + n : nullptr;
+            WorkBlock.Segments[Index].FloatBias = (FloatBias != nullptr) ? FloatBias + n : nullptr;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = (A != nullptr) ? A + m * lda : nullptr;
+            WorkBlock.Segments[Index].FloatA = (FloatA != nullptr) ? FloatA + m * lda : nullptr;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+            WorkBlock.Segments[Index].Output = (Output != nullptr) ? Output + m * ldo : nullptr;
+            WorkBlock.Segments[Index].Bias = (Bias != nullptr) ? Bias + m : nullptr;
+            WorkBlock.Segments[Index].FloatOutput = (FloatOutput != nullptr) ? FloatOutput + m * FloatLdo : nullptr;
+            WorkBlock.Segments[Index].FloatBias = FloatBias;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(ThreadedRoutine, &WorkBlock, Index, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for a signed matrix B, optionally requantizing matrix C
+    to an 8-bit output as each slice of matrix C is completed.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Requantize - Optionally supplies the parameters to requantize matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8Schedule(M, N, K, A, nullptr, lda, 0.0f, offa, (const uint8_t*)B, ldb,
+        uint8_t(offb), C, ldc, Requantize, nullptr, MlasGemmU8S8OperationThreaded, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_REQUANTIZE* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for an unsigned matrix B, optionally requantizing matrix
+    C to an 8-bit output as each slice of matrix C is completed.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    offa - Supplies the zero point offset of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Requantize - Optionally supplies the parameters to requantize matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8Schedule(M, N, K, A, nullptr, lda, 0.0f, offa, B, ldb, offb, C, ldc,
+        Requantize, nullptr, MlasGemmU8U8OperationThreaded, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float ScaleA,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for a float matrix A and a signed matrix B. Each block of
+    matrix A is quantized as it is packed and matrix C is optionally
+    dequantized to a float output as each slice of matrix C is completed.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ScaleA - Supplies the scale to quantize matrix A with.
+
+    offa - Supplies the zero point offset to quantize matrix A with.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Dequantize - Optionally supplies the parameters to dequantize matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8Schedule(M, N, K, nullptr, A, lda, ScaleA, offa, (const uint8_t*)B, ldb,
+        uint8_t(offb), C, ldc, nullptr, Dequantize, MlasGemmU8S8OperationThreaded, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const float* A,
+    size_t lda,
+    float ScaleA,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_QGEMM_DEQUANTIZE* Dequantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the quantized integer matrix/matrix multiply
+    operation (QGEMM) for a float matrix A and an unsigned matrix B. Each block
+    of matrix A is quantized as it is packed and matrix C is optionally
+    dequantized to a float output as each slice of matrix C is completed.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ScaleA - Supplies the scale to quantize matrix A with.
+
+    offa - Supplies the zero point offset to quantize matrix A with.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    offb - Supplies the zero point offset of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Dequantize - Optionally supplies the parameters to dequantize matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasGemmU8X8Schedule(M, N, K, nullptr, A, lda, ScaleA, offa, B, ldb, offb, C, ldc,
+        nullptr, Dequantize, MlasGemmU8U8OperationThreaded, ThreadPool);
 }
 
 #endif
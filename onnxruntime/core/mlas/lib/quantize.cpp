@@ -0,0 +1,520 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    quantize.cpp
+
+Abstract:
+
+    This module implements routines to quantize buffers.
+
+--*/
+
+#include <cmath>
+
+#include "mlasi.h"
+
+void
+MlasRequantizeOutputBlock(
+    const int32_t* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the 32-bit accumulators from a quantized matrix
+    multiply to 8-bit values. The optional bias for each row is added to the
+    accumulators, then the sum is scaled, rounded to the nearest integer,
+    offset by the zero point and saturated to the range of uint8_t.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix of M rows by N columns.
+
+    ldo - Supplies the first dimension of the output matrix.
+
+    Bias - Optionally supplies the bias vector of M elements.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Scale - Supplies the scale to apply to each biased accumulator.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+#if defined(MLAS_SSE2_INTRINSICS)
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+#elif defined(MLAS_NEON64_INTRINSICS)
+    const int32x4_t ZeroPointVector = vdupq_n_s32(ZeroPoint);
+#endif
+
+    for (size_t m = 0; m < M; m++) {
+
+        const int32_t RowBias = (Bias != nullptr) ? Bias[m] : 0;
+
+        size_t n = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        const __m128i BiasVector = _mm_set1_epi32(RowBias);
+
+        for (; n + 4 <= N; n += 4) {
+
+            __m128i IntegerVector = _mm_loadu_si128((const __m128i*)&Input[n]);
+
+            IntegerVector = _mm_add_epi32(IntegerVector, BiasVector);
+
+            MLAS_FLOAT32X4 FloatVector = _mm_mul_ps(_mm_cvtepi32_ps(IntegerVector), ScaleVector);
+
+            //
+            // Convert with the default round to nearest even mode, then pack
+            // with signed and then unsigned saturation.
+            //
+
+            IntegerVector = _mm_add_epi32(_mm_cvtps_epi32(FloatVector), ZeroPointVector);
+            IntegerVector = _mm_packs_epi32(IntegerVector, IntegerVector);
+            IntegerVector = _mm_packus_epi16(IntegerVector, IntegerVector);
+
+            *((int32_t*)&Output[n]) = _mm_cvtsi128_si32(IntegerVector);
+        }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+        const int32x4_t BiasVector = vdupq_n_s32(RowBias);
+
+        for (; n + 4 <= N; n += 4) {
+
+            int32x4_t IntegerVector = vld1q_s32(&Input[n]);
+
+            IntegerVector = vaddq_s32(IntegerVector, BiasVector);
+
+            MLAS_FLOAT32X4 FloatVector = vmulq_f32(vcvtq_f32_s32(IntegerVector), ScaleVector);
+
+            IntegerVector = vaddq_s32(vcvtnq_s32_f32(FloatVector), ZeroPointVector);
+
+            int16x4_t ShortVector = vqmovn_s32(IntegerVector);
+            uint8x8_t ByteVector = vqmovun_s16(vcombine_s16(ShortVector, ShortVector));
+
+            vst1_lane_u32((uint32_t*)&Output[n], vreinterpret_u32_u8(ByteVector), 0);
+        }
+
+#else
+
+        MLAS_UNREFERENCED_PARAMETER(ScaleVector);
+
+#endif
+
+        for (; n < N; n++) {
+
+            float FloatValue = float(Input[n] + RowBias) * Scale;
+
+            FloatValue = std::nearbyint(FloatValue) + float(ZeroPoint);
+            FloatValue = std::min(std::max(FloatValue, 0.0f), 255.0f);
+
+            Output[n] = uint8_t(FloatValue);
+        }
+
+        Input += ldi;
+        Output += ldo;
+    }
+}
+
+void
+MLASCALL
+MlasRequantizeOutput(
+    const int32_t* Input,
+    uint8_t* Output,
+    const int32_t* Bias,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes the contiguous 32-bit accumulators from a
+    quantized matrix multiply to 8-bit values.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    Output - Supplies the output matrix of M rows by N columns.
+
+    Bias - Optionally supplies the bias vector of M elements.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Scale - Supplies the scale to apply to each biased accumulator.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasRequantizeOutputBlock(Input, N, Output, N, Bias, M, N, Scale, ZeroPoint);
+}
+
+void
+MlasQuantizeLinearBlock(
+    const float* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    size_t M,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a block of a float matrix to 8-bit values. Each
+    element is divided by the scale, rounded to the nearest even integer,
+    offset by the zero point and saturated to the range of uint8_t, which
+    matches the DynamicQuantizeLinear and QuantizeLinear operators.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix of M rows by N columns.
+
+    ldo - Supplies the first dimension of the output matrix.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Scale - Supplies the scale of the output.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+#if defined(MLAS_SSE2_INTRINSICS)
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+#elif defined(MLAS_NEON64_INTRINSICS)
+    const int32x4_t ZeroPointVector = vdupq_n_s32(ZeroPoint);
+#endif
+
+    for (size_t m = 0; m < M; m++) {
+
+        size_t n = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS)
+
+        for (; n + 4 <= N; n += 4) {
+
+            MLAS_FLOAT32X4 FloatVector = _mm_div_ps(_mm_loadu_ps(&Input[n]), ScaleVector);
+
+            __m128i IntegerVector = _mm_add_epi32(_mm_cvtps_epi32(FloatVector), ZeroPointVector);
+            IntegerVector = _mm_packs_epi32(IntegerVector, IntegerVector);
+            IntegerVector = _mm_packus_epi16(IntegerVector, IntegerVector);
+
+            *((int32_t*)&Output[n]) = _mm_cvtsi128_si32(IntegerVector);
+        }
+
+#elif defined(MLAS_NEON64_INTRINSICS)
+
+        for (; n + 4 <= N; n += 4) {
+
+            MLAS_FLOAT32X4 FloatVector = vdivq_f32(vld1q_f32(&Input[n]), ScaleVector);
+
+            int32x4_t IntegerVector = vaddq_s32(vcvtnq_s32_f32(FloatVector), ZeroPointVector);
+
+            int16x4_t ShortVector = vqmovn_s32(IntegerVector);
+            uint8x8_t ByteVector = vqmovun_s16(vcombine_s16(ShortVector, ShortVector));
+
+            vst1_lane_u32((uint32_t*)&Output[n], vreinterpret_u32_u8(ByteVector), 0);
+        }
+
+#else
+
+        MLAS_UNREFERENCED_PARAMETER(ScaleVector);
+
+#endif
+
+        for (; n < N; n++) {
+
+            float FloatValue = std::nearbyint(Input[n] / Scale) + float(ZeroPoint);
+            FloatValue = std::min(std::max(FloatValue, 0.0f), 255.0f);
+
+            Output[n] = uint8_t(FloatValue);
+        }
+
+        Input += ldi;
+        Output += ldo;
+    }
+}
+
+void
+MLASCALL
+MlasQuantizeLinear(
+    const float* Input,
+    uint8_t* Output,
+    size_t N,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes a contiguous float buffer to 8-bit values.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements of the buffers.
+
+    Scale - Supplies the scale of the output.
+
+    ZeroPoint - Supplies the zero point of the output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasQuantizeLinearBlock(Input, N, Output, N, 1, N, Scale, ZeroPoint);
+}
+
+void
+MlasDequantizeOutputBlock(
+    const int32_t* Input,
+    size_t ldi,
+    float* Output,
+    size_t ldo,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes the 32-bit accumulators from a quantized matrix
+    multiply to float values. The accumulators are scaled, then the optional
+    bias for each column is added.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    ldi - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix of M rows by N columns.
+
+    ldo - Supplies the first dimension of the output matrix.
+
+    Bias - Optionally supplies the bias vector of N elements.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Scale - Supplies the scale to apply to each accumulator.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    for (size_t m = 0; m < M; m++) {
+
+        size_t n = 0;
+
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+
+        for (; n + 4 <= N; n += 4) {
+
+#if defined(MLAS_SSE2_INTRINSICS)
+            MLAS_FLOAT32X4 FloatVector = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&Input[n]));
+#else
+            MLAS_FLOAT32X4 FloatVector = vcvtq_f32_s32(vld1q_s32(&Input[n]));
+#endif
+
+            if (Bias != nullptr) {
+                FloatVector = MlasMultiplyAddFloat32x4(FloatVector, ScaleVector, MlasLoadFloat32x4(&Bias[n]));
+            } else {
+                FloatVector = MlasMultiplyFloat32x4(FloatVector, ScaleVector);
+            }
+
+            MlasStoreFloat32x4(&Output[n], FloatVector);
+        }
+
+#else
+
+        MLAS_UNREFERENCED_PARAMETER(ScaleVector);
+
+#endif
+
+        for (; n < N; n++) {
+
+            float FloatValue = float(Input[n]) * Scale;
+
+            if (Bias != nullptr) {
+                FloatValue += Bias[n];
+            }
+
+            Output[n] = FloatValue;
+        }
+
+        Input += ldi;
+        Output += ldo;
+    }
+}
+
+void
+MLASCALL
+MlasDequantizeOutput(
+    const int32_t* Input,
+    float* Output,
+    const float* Bias,
+    size_t M,
+    size_t N,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes the contiguous 32-bit accumulators from a
+    quantized matrix multiply to float values.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows by N columns.
+
+    Output - Supplies the output matrix of M rows by N columns.
+
+    Bias - Optionally supplies the bias vector of N elements.
+
+    M - Supplies the number of rows of the matrices.
+
+    N - Supplies the number of columns of the matrices.
+
+    Scale - Supplies the scale to apply to each accumulator.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasDequantizeOutputBlock(Input, N, Output, N, Bias, M, N, Scale);
+}
+
+void
+MLASCALL
+MlasFindMinMaxElement(
+    const float* Input,
+    float* Min,
+    float* Max,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine finds the minimum and maximum values of a buffer in a single
+    pass over the buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Min - Returns the minimum value of the buffer.
+
+    Max - Returns the maximum value of the buffer.
+
+    N - Supplies the number of elements of the buffer, which is not zero.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float MinValue = Input[0];
+    float MaxValue = Input[0];
+
+    size_t n = 0;
+
+    if (N >= 4) {
+
+        MLAS_FLOAT32X4 MinVector = MlasLoadFloat32x4(Input);
+        MLAS_FLOAT32X4 MaxVector = MinVector;
+
+        for (n = 4; n + 4 <= N; n += 4) {
+
+            MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[n]);
+
+            MinVector = MlasMinimumFloat32x4(MinVector, InputVector);
+            MaxVector = MlasMaximumFloat32x4(MaxVector, InputVector);
+        }
+
+        MinValue = std::min(std::min(MlasExtractLaneFloat32x4<0>(MinVector), MlasExtractLaneFloat32x4<1>(MinVector)),
+            std::min(MlasExtractLaneFloat32x4<2>(MinVector), MlasExtractLaneFloat32x4<3>(MinVector)));
+        MaxValue = std::max(std::max(MlasExtractLaneFloat32x4<0>(MaxVector), MlasExtractLaneFloat32x4<1>(MaxVector)),
+            std::max(MlasExtractLaneFloat32x4<2>(MaxVector), MlasExtractLaneFloat32x4<3>(MaxVector)));
+    }
+
+    for (; n < N; n++) {
+        MinValue = std::min(MinValue, Input[n]);
+        MaxValue = std::max(MaxValue, Input[n]);
+    }
+
+    *Min = MinValue;
+    *Max = MaxValue;
+}
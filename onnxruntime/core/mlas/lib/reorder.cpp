@@ -165,6 +165,29 @@ Return Value:
     v[2] = _mm_movelh_ps(t[2], t[3]);
     v[3] = _mm_movehl_ps(t[3], t[2]);
 
+    MlasStoreFloat32x4(&D[ScatterStride * 0], v[0]);
+    MlasStoreFloat32x4(&D[ScatterStride * 1], v[1]);
+    MlasStoreFloat32x4(&D[ScatterStride * 2], v[2]);
+    MlasStoreFloat32x4(&D[ScatterStride * 3], v[3]);
+#elif defined(MLAS_NEON64_INTRINSICS)
+    MLAS_FLOAT32X4 v[4];
+    MLAS_FLOAT32X4 t[4];
+
+    v[0] = MlasLoadFloat32x4(&S[GatherStride * 0]);
+    v[1] = MlasLoadFloat32x4(&S[GatherStride * 1]);
+    v[2] = MlasLoadFloat32x4(&S[GatherStride * 2]);
+    v[3] = MlasLoadFloat32x4(&S[GatherStride * 3]);
+
+    t[0] = vtrn1q_f32(v[0], v[1]);
+    t[1] = vtrn2q_f32(v[0], v[1]);
+    t[2] = vtrn1q_f32(v[2], v[3]);
+    t[3] = vtrn2q_f32(v[2], v[3]);
+
+    v[0] = vreinterpretq_f32_f64(vtrn1q_f64(vreinterpretq_f64_f32(t[0]), vreinterpretq_f64_f32(t[2])));
+    v[1] = vreinterpretq_f32_f64(vtrn1q_f64(vreinterpretq_f64_f32(t[1]), vreinterpretq_f64_f32(t[3])));
+    v[2] = vreinterpretq_f32_f64(vtrn2q_f64(vreinterpretq_f64_f32(t[0]), vreinterpretq_f64_f32(t[2])));
+    v[3] = vreinterpretq_f32_f64(vtrn2q_f64(vreinterpretq_f64_f32(t[1]), vreinterpretq_f64_f32(t[3])));
+
     MlasStoreFloat32x4(&D[ScatterStride * 0], v[0]);
     MlasStoreFloat32x4(&D[ScatterStride * 1], v[1]);
     MlasStoreFloat32x4(&D[ScatterStride * 2], v[2]);
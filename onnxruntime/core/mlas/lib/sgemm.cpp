@@ -40,15 +40,44 @@ struct MLAS_SGEMM_WORK_BLOCK {
     size_t ldc;
     float alpha;
     float beta;
+    const MLAS_ACTIVATION* Activation;
+    bool BIsPacked;
+    bool BIsHalf;
+    bool BIsQuantized;
+    bool UseBf16;
     struct SEGMENT {
         size_t M;
         size_t N;
         const float* A;
-        const float* B;
+        const void* B;
+        const float* ScaleB;
         float* C;
+        const float* Bias;
+        size_t OffsetN;
     } Segments[MLAS_MAXIMUM_THREAD_COUNT];
 };
 
+//
+// Define the parameters to execute a batch of SGEMM operations on worker
+// threads.
+//
+
+struct MLAS_SGEMM_BATCH_WORK_BLOCK {
+    CBLAS_TRANSPOSE TransA;
+    CBLAS_TRANSPOSE TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    size_t lda;
+    size_t ldb;
+    size_t ldc;
+    float alpha;
+    float beta;
+    const MLAS_SGEMM_DATA_PARAMS* Data;
+    size_t BatchSize;
+    int32_t ThreadCount;
+};
+
 #if defined(MLAS_TARGET_AMD64_IX86)
 
 //
@@ -121,6 +150,70 @@ Return Value:
     } while (CountM > 0);
 }
 
+void
+MlasSgemmApplyEpilogue(
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the optional per-column bias vector to a block of the
+    output matrix and then applies the optional activation. The block has
+    just been computed, so it is still resident in the cache.
+
+Arguments:
+
+    C - Supplies the address of matrix C.
+
+    CountM - Supplies the number of rows from matrix C.
+
+    CountN - Supplies the number of columns from matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of CountN elements.
+
+    Activation - Supplies the optional parameters for the activation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Bias != nullptr) {
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            while (n + 4 <= CountN) {
+                MlasStoreFloat32x4(c + n, MlasAddFloat32x4(MlasLoadFloat32x4(c + n), MlasLoadFloat32x4(Bias + n)));
+                n += 4;
+            }
+
+            while (n < CountN) {
+                c[n] += Bias[n];
+                n += 1;
+            }
+
+            c += ldc;
+        }
+    }
+
+    if (Activation != nullptr && Activation->ActivationKind != MlasIdentityActivation) {
+        MlasActivation(Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
+
 void
 MlasSgemmTransposeA(
     float* D,
@@ -773,56 +866,35 @@ Return Value:
 }
 
 void
-MlasSgemmOperation(
-    CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
-    size_t M,
-    size_t N,
-    size_t K,
-    float alpha,
-    const float* A,
-    size_t lda,
-    const float* B,
+MlasSgemmCopyPackB(
+    float* D,
+    const MLAS_FP16* B,
     size_t ldb,
-    float beta,
-    float* C,
-    size_t ldc
+    size_t CountX,
+    size_t CountY
     )
 /*++
 
 Routine Description:
 
-    This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
-
-Arguments:
-
-    TransA - Supplies the transpose operation for matrix A.
-
-    TransB - Supplies the transpose operation for matrix B.
-
-    M - Supplies the number of rows of matrix A and matrix C.
-
-    N - Supplies the number of columns of matrix B and matrix C.
-
-    K - Supplies the number of columns of matrix A and the number of rows of
-        matrix B.
-
-    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+    This routine converts elements from the half precision source matrix to
+    the single precision destination packed buffer.
 
-    A - Supplies the address of matrix A.
+    Columns of 16 elements from the source matrix are unrolled to be physically
+    contiguous for better locality inside the SGEMM kernels. Any remaining
+    columns less than 16 elements wide are zero-padded.
 
-    lda - Supplies the first dimension of matrix A.
+Arguments:
 
-    B - Supplies the address of matrix B.
+    D - Supplies the address of the destination packed buffer.
 
-    ldb - Supplies the first dimension of matrix B.
+    B - Supplies the address of the source matrix.
 
-    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+    ldb - Supplies the number of elements per row of the source matrix.
 
-    C - Supplies the address of matrix C.
+    CountX - Supplies the number of columns of the source matrix to copy.
 
-    ldc - Supplies the first dimension of matrix C.
+    CountY - Supplies the number of rows of the source matrix to copy.
 
 Return Value:
 
@@ -830,215 +902,1528 @@ Return Value:
 
 --*/
 {
-    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
-    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
-
     //
-    // Handle the special case of a small M. The data from matrix B is not
-    // referenced multiple times, so using a local packed buffer is a wasted
-    // memory copy.
+    // Convert data from matrix B into the destination buffer 16 columns at a
+    // time.
     //
 
-    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f)) {
+    while (CountX >= 16) {
 
-#if defined(MLAS_TARGET_AMD64)
+        const MLAS_FP16* b = B;
+        size_t y = CountY;
 
-        PMLAS_SGEMM_KERNEL_M1_ROUTINE SgemmKernelM1Routine;
+        do {
 
-        if (TransB == CblasNoTrans) {
-            SgemmKernelM1Routine = MlasPlatform.KernelM1Routine;
-        } else {
-            SgemmKernelM1Routine = MlasPlatform.KernelM1TransposeBRoutine;
-        }
+            MlasStoreAlignedFloat32x4(&D[0], MlasConvertHalfToFloat32x4(&b[0]));
+            MlasStoreAlignedFloat32x4(&D[4], MlasConvertHalfToFloat32x4(&b[4]));
+            MlasStoreAlignedFloat32x4(&D[8], MlasConvertHalfToFloat32x4(&b[8]));
+            MlasStoreAlignedFloat32x4(&D[12], MlasConvertHalfToFloat32x4(&b[12]));
 
-        if (SgemmKernelM1Routine != nullptr) {
-            SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
-            return;
-        }
+            D += 16;
+            b += ldb;
+            y--;
 
-#endif
+        } while (y > 0);
 
+        B += 16;
+        CountX -= 16;
     }
 
     //
-    // Compute the strides to step through slices of the input matrices.
-    //
-    // Expand the N stride if K is small or expand the K stride if N is small
-    // for better utilization of the B panel. Avoid changing the K stride if
-    // the A panel needs to be used for transposing.
+    // Special case the handling of the remaining columns less than 16 elements
+    // wide.
     //
 
-    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
-    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+    if (CountX > 0) {
 
-    if (N >= K) {
+        MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
 
-        while (StrideK / 2 >= K) {
-            StrideN *= 2;
-            StrideK /= 2;
-        }
+        size_t y = CountY;
 
-    } else if (TransA == CblasNoTrans) {
+        do {
 
-        while (StrideN > 16 && StrideN / 2 >= N) {
-            StrideK *= 2;
-            StrideN /= 2;
-        }
-    }
+            MlasStoreAlignedFloat32x4(&D[0], ZeroFloat32x4);
+            MlasStoreAlignedFloat32x4(&D[4], ZeroFloat32x4);
+            MlasStoreAlignedFloat32x4(&D[8], ZeroFloat32x4);
+            MlasStoreAlignedFloat32x4(&D[12], ZeroFloat32x4);
 
-    //
-    // Step through each slice of matrix B along the N dimension.
-    //
+            size_t x = 0;
 
-    size_t CountN;
-    size_t CountK;
+            for (; x + 4 <= CountX; x += 4) {
+                MlasStoreAlignedFloat32x4(&D[x], MlasConvertHalfToFloat32x4(&B[x]));
+            }
 
-    for (size_t n = 0; n < N; n += CountN) {
+            for (; x < CountX; x++) {
+                D[x] = MlasConvertHalfToFloat(B[x]);
+            }
 
-        CountN = StrideN;
+            D += 16;
+            B += ldb;
+            y--;
 
-        if (CountN > (N - n)) {
-            CountN = N - n;
-        }
+        } while (y > 0);
+    }
+}
 
-        //
-        // Multiply the output matrix by beta as needed.
-        //
+void
+MlasSgemmTransposePackB(
+    float* D,
+    const MLAS_FP16* B,
+    size_t ldb,
+    size_t CountY,
+    size_t CountX
+    )
+/*++
 
-        if (beta != 0.0f && beta != 1.0f) {
-            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
-        }
+Routine Description:
 
-        //
-        // Step through each slice of matrix B along the K dimension.
-        //
+    This routine converts and transposes elements from the half precision
+    source matrix to the single precision destination packed buffer.
 
-        for (size_t k = 0; k < K; k += CountK) {
+    Columns of 16 elements from the source matrix are unrolled to be physically
+    contiguous for better locality inside the SGEMM kernels. Any remaining
+    columns less than 16 elements wide are zero-padded.
 
-            bool ZeroMode = (k == 0 && beta == 0.0f);
+Arguments:
 
-            CountK = StrideK;
+    D - Supplies the address of the destination packed buffer.
 
-            if (CountK > (K - k)) {
-                CountK = K - k;
-            }
+    B - Supplies the address of the source matrix.
 
-            //
-            // Copy or transpose a panel of matrix B to a local packed buffer.
-            //
+    ldb - Supplies the number of elements per row of the source matrix.
 
-            if (TransB == CblasNoTrans) {
-                MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
-            } else {
-                MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
-            }
+    CountY - Supplies the number of rows of the source matrix to transpose.
 
-            //
-            // Step through each slice of matrix A along the M dimension.
-            //
+    CountX - Supplies the number of columns of the source matrix to transpose.
 
-            float* c = C + n;
+Return Value:
 
-            size_t RowsRemaining = M;
-            size_t RowsHandled;
+    None.
 
-            if (TransA == CblasNoTrans) {
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Block[16 * 4], 16 * sizeof(float));
 
-                const float* a = A + k;
+    MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
 
-                //
-                // Step through the rows of matrix A.
-                //
+    //
+    // Transpose elements from matrix B into the packed buffer 16 rows at a
+    // time. Each block of 4 columns is converted to a local buffer of 16 rows,
+    // where any missing rows are zero-padded, and then transposed.
+    //
 
-                do {
+    while (CountY > 0) {
 
-#if defined(MLAS_TARGET_AMD64_IX86)
-                    RowsHandled = MlasPlatform.GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
-#else
-                    if (ZeroMode) {
-                        RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    } else {
-                        RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
-                    }
-#endif
+        const size_t RowCount = (CountY < 16) ? CountY : 16;
 
-                    c += ldc * RowsHandled;
-                    a += lda * RowsHandled;
+        const MLAS_FP16* b = B;
+        size_t x = CountX;
 
-                    RowsRemaining -= RowsHandled;
+        while (x >= 4) {
 
-                } while (RowsRemaining > 0);
+            for (size_t y = 0; y < 16; y++) {
+                MLAS_FLOAT32X4 Values = (y < RowCount) ?
+                    MlasConvertHalfToFloat32x4(&b[y * ldb]) : ZeroFloat32x4;
+                MlasStoreAlignedFloat32x4(&Block[y * 4], Values);
+            }
 
-            } else {
+            MlasSgemmTransposePackBNx4<16>(&D[0], &Block[0], 4);
 
-                const float* a = A + k * lda;
+            D += 16 * 4;
+            b += 4;
+            x -= 4;
+        }
 
-                do {
+        while (x > 0) {
 
-                    //
-                    // Transpose elements from matrix A into a local buffer.
-                    //
+            for (size_t y = 0; y < 16; y++) {
+                D[y] = (y < RowCount) ? MlasConvertHalfToFloat(b[y * ldb]) : 0.0f;
+            }
 
-                    size_t RowsTransposed = RowsRemaining;
+            D += 16;
+            b += 1;
+            x--;
+        }
 
-                    if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
-                        RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
-                    }
+        B += ldb * RowCount;
+        CountY -= RowCount;
+    }
+}
 
-                    RowsRemaining -= RowsTransposed;
+void
+MlasSgemmCopyPackB(
+    float* D,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    size_t CountX,
+    size_t CountY
+    )
+/*++
 
-                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+Routine Description:
 
-                    a += RowsTransposed;
+    This routine dequantizes elements from the signed 8-bit source matrix to
+    the single precision destination packed buffer, multiplying each element
+    by the scale of its column.
 
-                    //
-                    // Step through the rows of the local buffer.
-                    //
+    Columns of 16 elements from the source matrix are unrolled to be physically
+    contiguous for better locality inside the SGEMM kernels. Any remaining
+    columns less than 16 elements wide are zero-padded.
 
-                    const float* pa = PanelA;
+Arguments:
 
-                    do {
+    D - Supplies the address of the destination packed buffer.
+
+    B - Supplies the address of the source matrix.
+
+    ldb - Supplies the number of elements per row of the source matrix.
+
+    ScaleB - Supplies the scales of the columns of the source matrix.
+
+    CountX - Supplies the number of columns of the source matrix to copy.
+
+    CountY - Supplies the number of rows of the source matrix to copy.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountX > 0) {
+
+        const size_t Columns = (CountX >= 16) ? 16 : CountX;
+        const int8_t* b = B;
+        size_t y = CountY;
+
+        do {
+
+            size_t x = 0;
+
+            for (; x < Columns; x++) {
+                D[x] = float(b[x]) * ScaleB[x];
+            }
+
+            for (; x < 16; x++) {
+                D[x] = 0.0f;
+            }
+
+            D += 16;
+            b += ldb;
+            y--;
+
+        } while (y > 0);
+
+        B += Columns;
+        ScaleB += Columns;
+        CountX -= Columns;
+    }
+}
+
+void
+MlasSgemmMultiplyPanel(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PanelB,
+    float* C,
+    size_t ldc,
+    bool ZeroMode,
+    bool UseBf16
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies a slice of matrix A by a packed panel of matrix B
+    and stores or accumulates the result to a slice of matrix C.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    CountN - Supplies the number of columns of the panel of matrix B and the
+        slice of matrix C.
+
+    CountK - Supplies the number of columns of the slice of matrix A and the
+        number of rows of the panel of matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PanelB - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of the slice of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ZeroMode - Supplies true if the output slice should be overwritten, else
+        false if the product should be accumulated to the output slice.
+
+    UseBf16 - Supplies true if the platform bfloat16 kernel should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_STRIDEK];
+
+#if defined(MLAS_TARGET_AMD64)
+    PMLAS_GEMM_FLOAT_KERNEL GemmFloatKernel =
+        UseBf16 ? MlasPlatform.GemmFloatBf16Kernel : MlasPlatform.GemmFloatKernel;
+#elif defined(MLAS_TARGET_IX86)
+    PMLAS_GEMM_FLOAT_KERNEL GemmFloatKernel = MlasPlatform.GemmFloatKernel;
+    MLAS_UNREFERENCED_PARAMETER(UseBf16);
+#else
+    MLAS_UNREFERENCED_PARAMETER(UseBf16);
+#endif
+
+    float* c = C;
+
+    size_t RowsRemaining = M;
+    size_t RowsHandled;
+
+    if (TransA == CblasNoTrans) {
+
+        const float* a = A;
+
+        //
+        // Step through the rows of matrix A.
+        //
+
+        do {
+
+#if defined(MLAS_TARGET_AMD64_IX86)
+            RowsHandled = GemmFloatKernel(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha, ZeroMode);
+#else
+            if (ZeroMode) {
+                RowsHandled = MlasSgemmKernelZero(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            } else {
+                RowsHandled = MlasSgemmKernelAdd(a, PanelB, c, CountK, RowsRemaining, CountN, lda, ldc, alpha);
+            }
+#endif
+
+            c += ldc * RowsHandled;
+            a += lda * RowsHandled;
+
+            RowsRemaining -= RowsHandled;
+
+        } while (RowsRemaining > 0);
+
+    } else {
+
+        const float* a = A;
+
+        do {
+
+            //
+            // Transpose elements from matrix A into a local buffer.
+            //
+
+            size_t RowsTransposed = RowsRemaining;
+
+            if (RowsTransposed > MLAS_SGEMM_TRANSA_ROWS) {
+                RowsTransposed = MLAS_SGEMM_TRANSA_ROWS;
+            }
+
+            RowsRemaining -= RowsTransposed;
+
+            MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+            a += RowsTransposed;
+
+            //
+            // Step through the rows of the local buffer.
+            //
+
+            const float* pa = PanelA;
+
+            do {
 
 #if defined(MLAS_TARGET_AMD64_IX86)
-                        RowsHandled = MlasPlatform.GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                RowsHandled = GemmFloatKernel(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+#else
+                if (ZeroMode) {
+                    RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                } else {
+                    RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
+                }
+#endif
+
+                c += ldc * RowsHandled;
+                pa += CountK * RowsHandled;
+
+                RowsTransposed -= RowsHandled;
+
+            } while (RowsTransposed > 0);
+
+        } while (RowsRemaining > 0);
+    }
+}
+
+inline
+bool
+MlasSgemmTryKernelM1(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* A,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to compute a single row of the output matrix with a
+    kernel that reads matrix B directly instead of through a packed buffer.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+Return Value:
+
+    Returns true if the output row was computed, else false if the operation
+    should use the packed path.
+
+--*/
+{
+#if defined(MLAS_TARGET_AMD64)
+
+    PMLAS_SGEMM_KERNEL_M1_ROUTINE SgemmKernelM1Routine;
+
+    if (TransB == CblasNoTrans) {
+        SgemmKernelM1Routine = MlasPlatform.KernelM1Routine;
+    } else {
+        SgemmKernelM1Routine = MlasPlatform.KernelM1TransposeBRoutine;
+    }
+
+    if (SgemmKernelM1Routine != nullptr) {
+        SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+        return true;
+    }
+
 #else
-                        if (ZeroMode) {
-                            RowsHandled = MlasSgemmKernelZero(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        } else {
-                            RowsHandled = MlasSgemmKernelAdd(pa, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha);
-                        }
+
+    MLAS_UNREFERENCED_PARAMETER(TransB);
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(K);
+    MLAS_UNREFERENCED_PARAMETER(A);
+    MLAS_UNREFERENCED_PARAMETER(B);
+    MLAS_UNREFERENCED_PARAMETER(ldb);
+    MLAS_UNREFERENCED_PARAMETER(beta);
+    MLAS_UNREFERENCED_PARAMETER(C);
+
 #endif
 
-                        c += ldc * RowsHandled;
-                        pa += CountK * RowsHandled;
+    return false;
+}
+
+inline
+bool
+MlasSgemmTryKernelM1(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* A,
+    const MLAS_FP16* B,
+    size_t ldb,
+    float beta,
+    float* C
+    )
+/*++
+
+Routine Description:
+
+    This routine handles the single row case for a half precision matrix B.
+    The single row kernels read matrix B directly and have no conversion
+    support, so the operation always uses the packed path.
+
+Arguments:
+
+    See the single precision version of this routine.
+
+Return Value:
+
+    Returns false.
+
+--*/
+{
+    MLAS_UNREFERENCED_PARAMETER(TransB);
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(K);
+    MLAS_UNREFERENCED_PARAMETER(A);
+    MLAS_UNREFERENCED_PARAMETER(B);
+    MLAS_UNREFERENCED_PARAMETER(ldb);
+    MLAS_UNREFERENCED_PARAMETER(beta);
+    MLAS_UNREFERENCED_PARAMETER(C);
+
+    return false;
+}
+
+template<typename BType>
+void
+MlasSgemmOperation(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const BType* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    bool UseBf16
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+    Matrix B is stored as either single or half precision floats. Half
+    precision elements are converted as each panel of matrix B is copied to
+    the local packed buffer.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
+    UseBf16 - Supplies true if the dot products should be computed by the
+        platform bfloat16 kernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    //
+    // Handle the special case of a small M. The data from matrix B is not
+    // referenced multiple times, so using a local packed buffer is a wasted
+    // memory copy.
+    //
+
+    if (M == 1 && TransA == CblasNoTrans && alpha == 1.0f && (beta == 0.0f || beta == 1.0f) && !UseBf16) {
+
+        if (MlasSgemmTryKernelM1(TransB, N, K, A, B, ldb, beta, C)) {
+            MlasSgemmApplyEpilogue(C, M, N, ldc, Bias, Activation);
+            return;
+        }
+    }
+
+    //
+    // Compute the strides to step through slices of the input matrices.
+    //
+    // Expand the N stride if K is small or expand the K stride if N is small
+    // for better utilization of the B panel. Avoid changing the K stride if
+    // the A panel needs to be used for transposing.
+    //
+
+    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
+    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+
+    if (N >= K) {
+
+        while (StrideK / 2 >= K) {
+            StrideN *= 2;
+            StrideK /= 2;
+        }
+
+    } else if (TransA == CblasNoTrans) {
+
+        while (StrideN > 16 && StrideN / 2 >= N) {
+            StrideK *= 2;
+            StrideN /= 2;
+        }
+    }
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = StrideK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            //
+            // Copy or transpose a panel of matrix B to a local packed buffer.
+            //
+
+            if (TransB == CblasNoTrans) {
+                MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, CountN, CountK);
+            } else {
+                MlasSgemmTransposePackB(PanelB, B + k + n * ldb, ldb, CountN, CountK);
+            }
+
+            //
+            // Step through each slice of matrix A along the M dimension.
+            //
+
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode, UseBf16);
+        }
+
+        //
+        // Apply the epilogue to the completed slice of the output matrix.
+        //
+
+        MlasSgemmApplyEpilogue(C + n, M, CountN, ldc, (Bias != nullptr) ? Bias + n : nullptr, Activation);
+    }
+}
+
+template
+void
+MlasSgemmOperation<float>(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    bool UseBf16
+    );
+
+void
+MlasSgemmQuantizedBOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) where matrix B is stored as signed 8-bit integers with
+    a scale per column. Each panel of matrix B is dequantized while it is
+    copied to the local packed buffer.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    ScaleB - Supplies the scales of the N columns of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float PanelB[MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK], 16 * sizeof(float));
+
+    //
+    // Compute the strides to step through slices of the input matrices as
+    // the single precision operation does.
+    //
+
+    uint32_t StrideN = MLAS_SGEMM_STRIDEN;
+    uint32_t StrideK = MLAS_SGEMM_STRIDEK;
+
+    if (N >= K) {
+
+        while (StrideK / 2 >= K) {
+            StrideN *= 2;
+            StrideK /= 2;
+        }
+
+    } else if (TransA == CblasNoTrans) {
+
+        while (StrideN > 16 && StrideN / 2 >= N) {
+            StrideK *= 2;
+            StrideN /= 2;
+        }
+    }
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = StrideK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            MlasSgemmCopyPackB(PanelB, B + n + k * ldb, ldb, ScaleB + n, CountN, CountK);
+
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode, false);
+        }
+
+        MlasSgemmApplyEpilogue(C + n, M, CountN, ldc, (Bias != nullptr) ? Bias + n : nullptr, nullptr);
+    }
+}
+
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* PackedB,
+    size_t AlignedN,
+    size_t OffsetN,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) using a B matrix that was packed by MlasSgemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the packed B matrix.
+
+    AlignedN - Supplies the number of columns of the packed B matrix, rounded
+        up to a multiple of 16.
+
+    OffsetN - Supplies the first column of the packed B matrix to use. This
+        must be a multiple of 16.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // The K stride is fixed by the packed layout, so only expand the N stride
+    // if K is small.
+    //
+
+    size_t StrideN = MLAS_SGEMM_STRIDEN;
+
+    if (N >= K) {
+
+        for (size_t StrideK = MLAS_SGEMM_STRIDEK; StrideK / 2 >= K; StrideK /= 2) {
+            StrideN *= 2;
+        }
+    }
+
+    //
+    // Step through each slice of matrix B along the N dimension.
+    //
+
+    size_t CountN;
+    size_t CountK;
+
+    for (size_t n = 0; n < N; n += CountN) {
+
+        CountN = StrideN;
+
+        if (CountN > (N - n)) {
+            CountN = N - n;
+        }
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(C + n, M, CountN, ldc, beta);
+        }
+
+        //
+        // Step through each slice of matrix B along the K dimension. Each
+        // slice of the packed buffer holds CountK rows of 16 column panels.
+        //
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            bool ZeroMode = (k == 0 && beta == 0.0f);
+
+            CountK = MLAS_SGEMM_STRIDEK;
+
+            if (CountK > (K - k)) {
+                CountK = K - k;
+            }
+
+            const float* PanelB = PackedB + k * AlignedN + (OffsetN + n) * CountK;
+            const float* a = (TransA == CblasNoTrans) ? A + k : A + k * lda;
+
+            MlasSgemmMultiplyPanel(TransA, M, CountN, CountK, alpha, a, lda, PanelB, C + n, ldc, ZeroMode, false);
+        }
+
+        //
+        // Apply the epilogue to the completed slice of the output matrix.
+        //
+
+        MlasSgemmApplyEpilogue(C + n, M, CountN, ldc, (Bias != nullptr) ? Bias + n : nullptr, Activation);
+    }
+}
+
+void
+MlasSgemmOperationThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    SGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
+
+    MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
+
+    if (WorkBlock->BIsPacked) {
+
+        MlasSgemmPackedOperation(WorkBlock->TransA, Segment->M, Segment->N,
+            WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const float*)Segment->B, WorkBlock->ldb, Segment->OffsetN, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc, Segment->Bias, WorkBlock->Activation);
+
+    } else if (WorkBlock->BIsQuantized) {
+
+        MlasSgemmQuantizedBOperation(WorkBlock->TransA, Segment->M, Segment->N,
+            WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const int8_t*)Segment->B, WorkBlock->ldb, Segment->ScaleB, WorkBlock->beta,
+            Segment->C, WorkBlock->ldc, Segment->Bias);
+
+    } else if (WorkBlock->BIsHalf) {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const MLAS_FP16*)Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, Segment->Bias, WorkBlock->Activation);
+
+    } else {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
+            Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
+            (const float*)Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
+            WorkBlock->ldc, Segment->Bias, WorkBlock->Activation, WorkBlock->UseBf16);
+    }
+}
+
+inline
+bool
+MlasSgemmTryMultithread(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* B,
+    size_t ldb,
+    bool BIsPacked,
+    bool BIsHalf,
+    const float* ScaleB,
+    bool UseBf16,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine attempts to launch a single precision matrix/matrix multiply
+    operation (SGEMM) across multiple threads.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B. If matrix B is packed,
+        this is the number of columns of the packed B matrix.
+
+    BIsPacked - Supplies true if matrix B was packed by MlasSgemmPackB.
+
+    BIsHalf - Supplies true if matrix B is stored as half precision floats.
+
+    ScaleB - Supplies the scales of the columns of matrix B if it is stored
+        as signed 8-bit integers, else nullptr.
+
+    UseBf16 - Supplies true if the dot products should be computed by the
+        platform bfloat16 kernel.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the operation was completed across multiple threads, else
+    false if the operation should fall back to a single thread.
+
+--*/
+{
+    MLAS_SGEMM_WORK_BLOCK WorkBlock;
+    int32_t TargetThreadCount;
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    double Complexity = double(M) * double(N) * double(K);
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        return false;
+    }
+
+    //
+    // Initialize the common fields of the work block.
+    //
+
+    WorkBlock.TransA = TransA;
+    WorkBlock.TransB = TransB;
+    WorkBlock.K = K;
+    WorkBlock.lda = lda;
+    WorkBlock.ldb = ldb;
+    WorkBlock.ldc = ldc;
+    WorkBlock.alpha = alpha;
+    WorkBlock.beta = beta;
+    WorkBlock.Activation = Activation;
+    WorkBlock.BIsPacked = BIsPacked;
+    WorkBlock.BIsHalf = BIsHalf;
+    WorkBlock.BIsQuantized = (ScaleB != nullptr);
+    WorkBlock.UseBf16 = UseBf16;
+
+    //
+    // Segment the operation across multiple threads.
+    //
+
+    int32_t Index = 0;
+
+    if (N > M) {
+
+        size_t StrideN = N / TargetThreadCount;
+
+        if ((StrideN * TargetThreadCount) != N) {
+            StrideN++;
+        }
+
+        StrideN =
+            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+
+        size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
+
+        for (size_t CountN, n = 0; n < N; n += CountN) {
+
+            CountN = StrideN;
+
+            if (CountN > (N - n)) {
+                CountN = N - n;
+            }
+
+            const void* SegmentB = B;
+
+            if (BIsHalf) {
+                SegmentB = (const MLAS_FP16*)B + n * pldb;
+            } else if (ScaleB != nullptr) {
+                SegmentB = (const int8_t*)B + n * pldb;
+            } else if (!BIsPacked) {
+                SegmentB = (const float*)B + n * pldb;
+            }
+
+            WorkBlock.Segments[Index].M = M;
+            WorkBlock.Segments[Index].N = CountN;
+            WorkBlock.Segments[Index].A = A;
+            WorkBlock.Segments[Index].B = SegmentB;
+            WorkBlock.Segments[Index].ScaleB = (ScaleB != nullptr) ? ScaleB + n : nullptr;
+            WorkBlock.Segments[Index].C = C + n;
+            WorkBlock.Segments[Index].Bias = (Bias != nullptr) ? Bias + n : nullptr;
+            WorkBlock.Segments[Index].OffsetN = n;
+
+            Index++;
+        }
+
+    } else {
+
+        size_t StrideM = M / TargetThreadCount;
+
+        if ((StrideM * TargetThreadCount) != M) {
+            StrideM++;
+        }
+
+        size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+
+        for (size_t CountM, m = 0; m < M; m += CountM) {
+
+            CountM = StrideM;
+
+            if (CountM > (M - m)) {
+                CountM = M - m;
+            }
+
+            WorkBlock.Segments[Index].M = CountM;
+            WorkBlock.Segments[Index].N = N;
+            WorkBlock.Segments[Index].A = A + m * plda;
+            WorkBlock.Segments[Index].B = B;
+            WorkBlock.Segments[Index].ScaleB = ScaleB;
+            WorkBlock.Segments[Index].C = C + m * ldc;
+            WorkBlock.Segments[Index].Bias = Bias;
+            WorkBlock.Segments[Index].OffsetN = 0;
+
+            Index++;
+        }
+    }
+
+    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+
+    return true;
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM).
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) followed by an epilogue that adds a per-column bias
+    vector and applies an activation to the output matrix. The epilogue runs
+    on each slice of the output matrix as it is completed, while the slice is
+    still resident in the cache.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Try to run the operation across multiple threads or fall back to a
+    // single thread based on the GEMM parameters and system configuration.
+    //
+
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, false, false, nullptr, false, beta, C, ldc, Bias,
+            Activation, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, Bias, Activation);
+    }
+}
+
+void
+MLASCALL
+MlasSgemm(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const MLAS_FP16* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) where matrix B is stored as half precision floats,
+    followed by the optional bias and activation epilogue.
+
+    Each panel of matrix B is converted to single precision while it is
+    copied to the local packed buffer, so the half precision matrix is read
+    directly from memory without a full single precision copy.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of the half precision matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, false, true, nullptr, false, beta, C, ldc, Bias,
+            Activation, ThreadPool)) {
+        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, Bias, Activation);
+    }
+}
+
+void
+MLASCALL
+MlasSgemmQuantizedB(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const int8_t* B,
+    size_t ldb,
+    const float* ScaleB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) where matrix B is stored as signed 8-bit integers with
+    a scale per column, followed by the optional bias epilogue.
+
+    Each panel of matrix B is dequantized while it is copied to the local
+    packed buffer, so the quantized matrix is read directly from memory
+    without a full single precision copy.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
 
-                        RowsTransposed -= RowsHandled;
+    lda - Supplies the first dimension of matrix A.
 
-                    } while (RowsTransposed > 0);
+    B - Supplies the address of the quantized matrix B.
 
-                } while (RowsRemaining > 0);
-            }
-        }
-    }
-}
+    ldb - Supplies the first dimension of matrix B.
 
-void
-MlasSgemmOperationThreaded(
-    void* Context,
-    int32_t Index
-    )
-/*++
+    ScaleB - Supplies the scales of the N columns of matrix B.
 
-Routine Description:
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
-    This routine is invoked from a worker thread to execute a segment of a
-    SGEMM operation.
+    C - Supplies the address of matrix C.
 
-Arguments:
+    ldc - Supplies the first dimension of matrix C.
 
-    Context - Supplies the pointer to the context for the threaded operation.
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
 
-    Index - Supplies the current index of the threaded operation.
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
 
 Return Value:
 
@@ -1046,19 +2431,15 @@ Return Value:
 
 --*/
 {
-    MLAS_SGEMM_WORK_BLOCK* WorkBlock = (MLAS_SGEMM_WORK_BLOCK*)Context;
-
-    MLAS_SGEMM_WORK_BLOCK::SEGMENT* Segment = &WorkBlock->Segments[Index];
-
-    MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, Segment->M,
-        Segment->N, WorkBlock->K, WorkBlock->alpha, Segment->A, WorkBlock->lda,
-        Segment->B, WorkBlock->ldb, WorkBlock->beta, Segment->C,
-        WorkBlock->ldc);
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, B, ldb, false, false, ScaleB, false,
+            beta, C, ldc, Bias, nullptr, ThreadPool)) {
+        MlasSgemmQuantizedBOperation(TransA, M, N, K, alpha, A, lda, B, ldb, ScaleB, beta, C, ldc, Bias);
+    }
 }
 
-inline
-bool
-MlasSgemmTryMultithread(
+void
+MLASCALL
+MlasSgemmBf16(
     CBLAS_TRANSPOSE TransA,
     CBLAS_TRANSPOSE TransB,
     size_t M,
@@ -1078,8 +2459,13 @@ MlasSgemmTryMultithread(
 
 Routine Description:
 
-    This routine attempts to launch a single precision matrix/matrix multiply
-    operation (SGEMM) across multiple threads.
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with the dot products computed from bfloat16 rounded
+    elements of matrix A and matrix B. The products are accumulated in single
+    precision.
+
+    If the platform does not support a bfloat16 dot product kernel, then the
+    operation is computed in full single precision.
 
 Arguments:
 
@@ -1115,20 +2501,161 @@ Arguments:
 
 Return Value:
 
-    Returns true if the operation was completed across multiple threads, else
-    false if the operation should fall back to a single thread.
+    None.
 
 --*/
 {
-    MLAS_SGEMM_WORK_BLOCK WorkBlock;
-    int32_t TargetThreadCount;
+#if defined(MLAS_TARGET_AMD64)
+    if (MlasPlatform.GemmFloatBf16Kernel != nullptr) {
+
+        if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, false, false, nullptr, true, beta,
+                C, ldc, nullptr, nullptr, ThreadPool)) {
+            MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, nullptr, nullptr, true);
+        }
+
+        return;
+    }
+#endif
+
+    MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool);
+}
+
+void
+MlasSgemmBatchThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a range of the
+    operations of a batched SGEMM.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SGEMM_BATCH_WORK_BLOCK*)Context;
 
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Partition the operation along the batch dimension.
     //
 
-    double Complexity = double(M) * double(N) * double(K);
+    const size_t BatchSize = WorkBlock->BatchSize;
+
+    const size_t WorkPerThread = BatchSize / WorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = BatchSize % WorkBlock->ThreadCount;
+
+    size_t b;
+    size_t CountBatch;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        b = (WorkPerThread + 1) * Index;
+        CountBatch = WorkPerThread + 1;
+    } else {
+        b = WorkPerThread * Index + WorkPerThreadExtra;
+        CountBatch = WorkPerThread;
+    }
+
+    const MLAS_SGEMM_DATA_PARAMS* Data = WorkBlock->Data + b;
+
+    while (CountBatch > 0) {
+
+        MlasSgemmOperation(WorkBlock->TransA, WorkBlock->TransB, WorkBlock->M,
+            WorkBlock->N, WorkBlock->K, WorkBlock->alpha, Data->A, WorkBlock->lda,
+            Data->B, WorkBlock->ldb, WorkBlock->beta, Data->C, WorkBlock->ldc);
+
+        Data++;
+        CountBatch--;
+    }
+}
+
+void
+MLASCALL
+MlasSgemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    size_t lda,
+    size_t ldb,
+    float beta,
+    size_t ldc,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a batch of single precision matrix/matrix
+    multiply operations (SGEMM) that share the same shapes and parameters.
+
+    Each operation of the batch is computed on a single thread and the batch
+    is spread across the threads. If the batch is too small to occupy the
+    target number of threads, then each operation is threaded internally
+    instead.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for each matrix A.
+
+    TransB - Supplies the transpose operation for each matrix B.
+
+    M - Supplies the number of rows of each matrix A and matrix C.
+
+    N - Supplies the number of columns of each matrix B and matrix C.
+
+    K - Supplies the number of columns of each matrix A and the number of
+        rows of each matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    lda - Supplies the first dimension of each matrix A.
+
+    ldb - Supplies the first dimension of each matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    ldc - Supplies the first dimension of each matrix C.
+
+    Data - Supplies the array of matrix addresses for each operation.
+
+    BatchSize - Supplies the number of operations in the batch.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the whole
+    // batch.
+    //
+
+    double Complexity = double(M) * double(N) * double(K) * double(BatchSize);
+
+    int32_t TargetThreadCount;
 
     if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
         TargetThreadCount = int32_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
@@ -1142,108 +2669,150 @@ Return Value:
         TargetThreadCount = MaximumThreadCount;
     }
 
-    if (TargetThreadCount == 1) {
-        return false;
-    }
-
     //
-    // Initialize the common fields of the work block.
+    // Fall back to threading each operation if the batch cannot occupy the
+    // target number of threads.
     //
 
+    if (BatchSize < size_t(TargetThreadCount)) {
+
+        for (size_t b = 0; b < BatchSize; b++) {
+            MlasSgemm(TransA, TransB, M, N, K, alpha, Data[b].A, lda, Data[b].B, ldb, beta, Data[b].C, ldc,
+                ThreadPool);
+        }
+
+        return;
+    }
+
+    MLAS_SGEMM_BATCH_WORK_BLOCK WorkBlock;
+
     WorkBlock.TransA = TransA;
     WorkBlock.TransB = TransB;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
     WorkBlock.K = K;
     WorkBlock.lda = lda;
     WorkBlock.ldb = ldb;
     WorkBlock.ldc = ldc;
     WorkBlock.alpha = alpha;
     WorkBlock.beta = beta;
+    WorkBlock.Data = Data;
+    WorkBlock.BatchSize = BatchSize;
+    WorkBlock.ThreadCount = TargetThreadCount;
 
-    //
-    // Segment the operation across multiple threads.
-    //
+    MlasExecuteThreaded(MlasSgemmBatchThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
 
-    int32_t Index = 0;
+size_t
+MLASCALL
+MlasSgemmPackBSize(
+    size_t N,
+    size_t K
+    )
+/*++
 
-    if (N > M) {
+Routine Description:
 
-        size_t StrideN = N / TargetThreadCount;
+    This routine computes the length in bytes of the buffer required to pack
+    a B matrix with MlasSgemmPackB.
 
-        if ((StrideN * TargetThreadCount) != N) {
-            StrideN++;
-        }
+Arguments:
 
-        StrideN =
-            (StrideN + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+    N - Supplies the number of columns of matrix B.
 
-        size_t pldb = (TransB == CblasNoTrans) ? 1 : ldb;
+    K - Supplies the number of rows of matrix B.
 
-        for (size_t CountN, n = 0; n < N; n += CountN) {
+Return Value:
 
-            CountN = StrideN;
+    Returns the size in bytes of the packed buffer.
 
-            if (CountN > (N - n)) {
-                CountN = N - n;
-            }
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
 
-            WorkBlock.Segments[Index].M = M;
-            WorkBlock.Segments[Index].N = CountN;
-            WorkBlock.Segments[Index].A = A;
-            WorkBlock.Segments[Index].B = B + n * pldb;
-            WorkBlock.Segments[Index].C = C + n;
+    return AlignedN * K * sizeof(float);
+}
 
-            Index++;
-        }
+void
+MLASCALL
+MlasSgemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
 
-    } else {
+Routine Description:
 
-        size_t StrideM = M / TargetThreadCount;
+    This routine packs the B matrix of a single precision matrix/matrix
+    multiply operation so that it can be reused across many calls to
+    MlasSgemmPacked without copying the matrix to a local buffer each time.
 
-        if ((StrideM * TargetThreadCount) != M) {
-            StrideM++;
-        }
+    The packed buffer is divided into slices of MLAS_SGEMM_STRIDEK rows. Each
+    slice holds the panels of 16 columns in the same layout that SGEMM builds
+    in its local buffer.
 
-        size_t plda = (TransA == CblasNoTrans) ? lda : 1;
+Arguments:
 
-        for (size_t CountM, m = 0; m < M; m += CountM) {
+    TransB - Supplies the transpose operation for matrix B.
 
-            CountM = StrideM;
+    N - Supplies the number of columns of matrix B.
 
-            if (CountM > (M - m)) {
-                CountM = M - m;
-            }
+    K - Supplies the number of rows of matrix B.
 
-            WorkBlock.Segments[Index].M = CountM;
-            WorkBlock.Segments[Index].N = N;
-            WorkBlock.Segments[Index].A = A + m * plda;
-            WorkBlock.Segments[Index].B = B;
-            WorkBlock.Segments[Index].C = C + m * ldc;
+    B - Supplies the address of matrix B.
 
-            Index++;
-        }
-    }
+    ldb - Supplies the first dimension of matrix B.
 
-    MlasExecuteThreaded(MlasSgemmOperationThreaded, &WorkBlock, Index, ThreadPool);
+    PackedB - Supplies the address of the packed buffer.
 
-    return true;
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    float* D = (float*)PackedB;
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = MLAS_SGEMM_STRIDEK;
+
+        if (CountK > (K - k)) {
+            CountK = K - k;
+        }
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D + k * AlignedN, B + k * ldb, ldb, N, CountK);
+        } else {
+            MlasSgemmTransposePackB(D + k * AlignedN, B + k, ldb, N, CountK);
+        }
+    }
 }
 
 void
 MLASCALL
-MlasSgemm(
+MlasSgemmPacked(
     CBLAS_TRANSPOSE TransA,
-    CBLAS_TRANSPOSE TransB,
     size_t M,
     size_t N,
     size_t K,
     float alpha,
     const float* A,
     size_t lda,
-    const float* B,
-    size_t ldb,
+    const void* PackedB,
     float beta,
     float* C,
     size_t ldc,
+    const float* Bias,
+    const MLAS_ACTIVATION* Activation,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1251,14 +2820,13 @@ MlasSgemm(
 Routine Description:
 
     This routine implements the single precision matrix/matrix multiply
-    operation (SGEMM).
+    operation (SGEMM) using a B matrix that was packed by MlasSgemmPackB,
+    followed by the optional bias and activation epilogue.
 
 Arguments:
 
     TransA - Supplies the transpose operation for matrix A.
 
-    TransB - Supplies the transpose operation for matrix B.
-
     M - Supplies the number of rows of matrix A and matrix C.
 
     N - Supplies the number of columns of matrix B and matrix C.
@@ -1272,9 +2840,7 @@ Arguments:
 
     lda - Supplies the first dimension of matrix A.
 
-    B - Supplies the address of matrix B.
-
-    ldb - Supplies the first dimension of matrix B.
+    PackedB - Supplies the address of the packed B matrix.
 
     beta - Supplies the scalar beta multiplier (see SGEMM definition).
 
@@ -1282,6 +2848,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Bias - Supplies the optional bias vector of N elements that is added to
+        each row of matrix C after the multiplication.
+
+    Activation - Supplies the optional activation that is applied to matrix
+        C after the bias addition.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1291,12 +2863,12 @@ Return Value:
 
 --*/
 {
-    //
-    // Try to run the operation across multiple threads or fall back to a
-    // single thread based on the GEMM parameters and system configuration.
-    //
+    const size_t AlignedN = (N + 15) & ~size_t(15);
+
+    const float* B = (const float*)PackedB;
 
-    if (!MlasSgemmTryMultithread(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, ThreadPool)) {
-        MlasSgemmOperation(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    if (!MlasSgemmTryMultithread(TransA, CblasNoTrans, M, N, K, alpha, A, lda, B, AlignedN, true, false, nullptr, false, beta,
+            C, ldc, Bias, Activation, ThreadPool)) {
+        MlasSgemmPackedOperation(TransA, M, N, K, alpha, A, lda, B, AlignedN, 0, beta, C, ldc, Bias, Activation);
     }
 }
@@ -75,6 +75,14 @@ struct MLAS_NCHWC_POOL_WORK_BLOCK : MLAS_NCHWC_WORK_BLOCK
 #define MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION       0x00000004
 #define MLAS_CONV_KERNEL_FLAG_OTHER_ACTIVATION      0x00000008
 
+//
+// Define the NCHWc block size used by the portable kernels. Four filter blocks
+// of four vectors each keeps the accumulators within the 32 NEON registers
+// available on ARM64.
+//
+
+#define MLAS_NCHWC_PORTABLE_BLOCK_SIZE              16
+
 size_t
 MLASCALL
 MlasNchwcGetBlockSize(
@@ -103,6 +111,8 @@ Return Value:
 {
 #if defined(MLAS_TARGET_AMD64)
     return MlasPlatform.NchwcBlockSize;
+#elif defined(MLAS_TARGET_ARM64)
+    return MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
 #else
     return 1;
 #endif
@@ -1437,12 +1447,468 @@ Return Value:
     MlasExecuteThreaded(MlasNchwcThreaded<MLAS_NCHWC_POOL_ALGORITHM>, &WorkBlock, WorkBlock.tids, ThreadPool);
 }
 
+void
+MLASCALL
+MlasNchwcUpsample(
+    const int64_t* InputShape,
+    const int64_t* Scales,
+    const float* Input,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the NCHWc nearest neighbor upsample operation.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Scales - Supplies the integral height and width scale factors.
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t TotalChannels = size_t(InputShape[0]) * size_t(InputShape[1]);
+    const size_t InputHeight = size_t(InputShape[2]);
+    const size_t InputWidth = size_t(InputShape[3]);
+    const size_t ScaleHeight = size_t(Scales[0]);
+    const size_t ScaleWidth = size_t(Scales[1]);
+    const size_t OutputRowSize = InputWidth * ScaleWidth * BlockSize;
+
+    for (size_t c = 0; c < TotalChannels; c += BlockSize) {
+
+        for (size_t h = 0; h < InputHeight; h++) {
+
+            //
+            // Expand the input row by the width scale factor.
+            //
+
+            const float* OutputRow = Output;
+
+            for (size_t w = 0; w < InputWidth; w++) {
+
+                for (size_t sw = 0; sw < ScaleWidth; sw++) {
+
+                    for (size_t bc = 0; bc < BlockSize; bc += 4) {
+                        MlasStoreFloat32x4(Output + bc, MlasLoadFloat32x4(Input + bc));
+                    }
+
+                    Output += BlockSize;
+                }
+
+                Input += BlockSize;
+            }
+
+            //
+            // Replicate the expanded row by the height scale factor.
+            //
+
+            for (size_t sh = 1; sh < ScaleHeight; sh++) {
+                std::copy_n(OutputRow, OutputRowSize, Output);
+                Output += OutputRowSize;
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasNchwcScaleChannels(
+    const int64_t* InputShape,
+    const float* Input,
+    const float* Scale,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies each channel of a NCHWc tensor by a per channel
+    scale, such as the excitation of a squeeze-and-excitation block.
+
+Arguments:
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Input - Supplies the input tensor.
+
+    Scale - Supplies the NCHWc scale tensor, with one value per batch and
+        channel of the input tensor.
+
+    Output - Supplies the output tensor. This may be the input tensor.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockSize = MlasNchwcGetBlockSize();
+
+    const size_t TotalChannels = size_t(InputShape[0]) * size_t(InputShape[1]);
+    const size_t InputSize = size_t(InputShape[2]) * size_t(InputShape[3]);
+
+    for (size_t c = 0; c < TotalChannels; c += BlockSize) {
+
+        for (size_t i = 0; i < InputSize; i++) {
+
+            for (size_t bc = 0; bc < BlockSize; bc += 4) {
+                MlasStoreFloat32x4(Output + bc, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Input + bc),
+                    MlasLoadFloat32x4(Scale + bc)));
+            }
+
+            Input += BlockSize;
+            Output += BlockSize;
+        }
+
+        Scale += BlockSize;
+    }
+}
+
 #if !defined(MLAS_TARGET_AMD64)
 
 //
-// Convolution and pooling kernel stubs for architectures that do not yet have
-// native support.
+// Portable convolution and pooling kernels built from the cross-platform
+// vector intrinsic wrappers. These kernels are used on architectures that do
+// not have native assembly kernels and operate on blocks of
+// MLAS_NCHWC_PORTABLE_BLOCK_SIZE elements.
 //
+// The kernel parameters match the assembly kernels: the stride, dilation and
+// width parameters are supplied in bytes, the input pointer is biased to
+// include the left padding blocks, and output elements that include padding
+// validate each input block against the InputBase and InputWidth parameters.
+//
+
+constexpr size_t MlasNchwcPortableVectorCount = MLAS_NCHWC_PORTABLE_BLOCK_SIZE / 4;
+
+MLAS_FORCEINLINE
+bool
+MlasNchwcIsInputInBounds(
+    const float* Input,
+    const float* InputBase,
+    size_t InputWidth
+    )
+/*++
+
+Routine Description:
+
+    This routine tests if the input block is within the valid input buffer
+    and not in the left or right width padding region.
+
+Arguments:
+
+    Input - Supplies the address of the input block.
+
+    InputBase - Supplies the address of the valid input buffer for the row.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+Return Value:
+
+    Returns true if the input block is in bounds, else false.
+
+--*/
+{
+    return size_t(reinterpret_cast<const uint8_t*>(Input) -
+        reinterpret_cast<const uint8_t*>(InputBase)) < InputWidth;
+}
+
+template<size_t FilterCount>
+MLAS_FORCEINLINE
+void
+MlasConvPostProcessFloatBlock(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][MlasNchwcPortableVectorCount],
+    float* Output,
+    size_t OutputStride,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the post processing options to an output block and
+    stores the block to the output buffer.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for each filter block.
+
+    Output - Supplies the address of the output block for the first filter.
+
+    OutputStride - Supplies the number of elements to advance the output
+        buffer to the output block associated with the next filter.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputStride;
+
+        for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+
+            MLAS_FLOAT32X4 Value = Accumulators[f][v];
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_ACCUMULATE_OUTPUT) != 0) {
+                Value = MlasAddFloat32x4(Value, MlasLoadFloat32x4(&output[v * 4]));
+            }
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_BIAS_ADDITION) != 0) {
+                Value = MlasAddFloat32x4(Value,
+                    MlasLoadFloat32x4(&Bias[f * MLAS_NCHWC_PORTABLE_BLOCK_SIZE + v * 4]));
+            }
+
+            if ((Flags & MLAS_CONV_KERNEL_FLAG_RELU_ACTIVATION) != 0) {
+                Value = MlasMaximumFloat32x4(Value, ZeroFloat32x4);
+            }
+
+            MlasStoreFloat32x4(&output[v * 4], Value);
+        }
+    }
+}
+
+template<size_t FilterCount, bool InputIsNchwc>
+MLAS_FORCEINLINE
+void
+MlasConvComputeFloatBlock(
+    MLAS_FLOAT32X4 Accumulators[FilterCount][MlasNchwcPortableVectorCount],
+    const float* Input,
+    const float* Filter,
+    size_t FilterStride
+    )
+/*++
+
+Routine Description:
+
+    This routine multiplies and accumulates an input block with a set of
+    filter blocks.
+
+Arguments:
+
+    Accumulators - Supplies the accumulators for each filter block.
+
+    Input - Supplies the address of the input block. If InputIsNchwc is true,
+        the block contains one element per input channel of the block, else
+        the block is a single element of a NCHW input channel.
+
+    Filter - Supplies the address of the filter block for the first filter.
+
+    FilterStride - Supplies the number of elements to advance the filter
+        buffer to the next filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputCount = InputIsNchwc ? MLAS_NCHWC_PORTABLE_BLOCK_SIZE : 1;
+
+    for (size_t ic = 0; ic < InputCount; ic++) {
+
+        const MLAS_FLOAT32X4 InputValue = MlasBroadcastFloat32x4(&Input[ic]);
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            const float* filter = Filter + f * FilterStride + ic * MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
+
+            for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+                Accumulators[f][v] = MlasMultiplyAddFloat32x4(InputValue,
+                    MlasLoadFloat32x4(&filter[v * 4]), Accumulators[f][v]);
+            }
+        }
+    }
+}
+
+template<size_t FilterCount, bool InputIsNchwc>
+void
+MlasConvFloatKernelPortable(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a fixed number of filters.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t StrideWidthElements = StrideWidth / sizeof(float);
+    const size_t DilationWidthElements = DilationWidth / sizeof(float);
+    const size_t InputStrideElements = InputStride / sizeof(float);
+    const size_t FilterStrideElements = FilterStride / sizeof(float);
+    const size_t OutputStrideElements = OutputStride / sizeof(float);
+    const size_t DilatedInputWidthElements = DilatedInputWidth / sizeof(float);
+
+    const size_t FilterBlockElements = InputIsNchwc ?
+        MLAS_NCHWC_PORTABLE_BLOCK_SIZE * MLAS_NCHWC_PORTABLE_BLOCK_SIZE :
+        MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
+
+    const size_t TotalOutputCount = OutputCountLeftPad + OutputCount + OutputCountRightPad;
+
+    for (size_t o = 0; o < TotalOutputCount; o++) {
+
+        //
+        // Only output elements that include padding need to validate each
+        // input block.
+        //
+
+        const bool CheckPadding = (o < OutputCountLeftPad) ||
+            (o >= OutputCountLeftPad + OutputCount);
+
+        MLAS_FLOAT32X4 Accumulators[FilterCount][MlasNchwcPortableVectorCount];
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+                Accumulators[f][v] = MlasZeroFloat32x4();
+            }
+        }
+
+        const float* input = Input + o * StrideWidthElements;
+        const float* inputBase = InputBase;
+        const float* filter = Filter;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckPadding || MlasNchwcIsInputInBounds(input, inputBase, InputWidth)) {
+                    MlasConvComputeFloatBlock<FilterCount, InputIsNchwc>(Accumulators,
+                        input, filter, FilterStrideElements);
+                }
+
+                input += DilationWidthElements;
+                filter += FilterBlockElements;
+            }
+
+            input += InputStrideElements;
+            inputBase += DilatedInputWidthElements;
+        }
+
+        MlasConvPostProcessFloatBlock<FilterCount>(Accumulators,
+            Output + o * MLAS_NCHWC_PORTABLE_BLOCK_SIZE, OutputStrideElements, Bias, Flags);
+    }
+}
+
+template<bool InputIsNchwc>
+void
+MlasConvFloatKernelDispatch(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t FilterCount,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine dispatches to the convolution kernel specialized for the
+    number of filters to process.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+
+        case 1:
+            MlasConvFloatKernelPortable<1, InputIsNchwc>(Input, Filter, Output,
+                StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+                OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
+            break;
+
+        case 2:
+            MlasConvFloatKernelPortable<2, InputIsNchwc>(Input, Filter, Output,
+                StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+                OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
+            break;
+
+        case 3:
+            MlasConvFloatKernelPortable<3, InputIsNchwc>(Input, Filter, Output,
+                StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+                OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
+            break;
+
+        default:
+            MlasConvFloatKernelPortable<4, InputIsNchwc>(Input, Filter, Output,
+                StrideWidth, DilationWidth, InputStride, FilterStride, OutputStride,
+                KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+                OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
+            break;
+    }
+}
 
 void
 MLASCALL
@@ -1467,26 +1933,29 @@ MlasConvNchwFloatKernel(
     const float* Bias,
     unsigned Flags
     )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the input buffer is in
+    NCHW format.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel. The stride, dilation and width parameters
+    are in units of single input elements instead of input blocks.
+
+Return Value:
+
+    None.
+
+--*/
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(FilterCount);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(FilterStride);
-    MLAS_UNREFERENCED_PARAMETER(OutputStride);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(Flags);
+    MlasConvFloatKernelDispatch<false>(Input, Filter, Output, StrideWidth,
+        DilationWidth, FilterCount, InputStride, FilterStride, OutputStride,
+        KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
 }
 
 void
@@ -1512,26 +1981,75 @@ MlasConvNchwcFloatKernel(
     const float* Bias,
     unsigned Flags
     )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the input buffer is in
+    NCHWc format.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer. The address is biased to
+        include padding blocks for the left width dimension.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation
+        width.
+
+    FilterCount - Supplies the number of filters to process in this
+        iteration.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row.
+
+    FilterStride - Supplies the length in bytes to advance the filter buffer
+        to the next set of filters.
+
+    OutputStride - Supplies the length in bytes to advance the output buffer
+        to the next output address associated with the next set of filters.
+
+    KernelHeight - Supplies the height of the kernel to apply.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(FilterCount);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(FilterStride);
-    MLAS_UNREFERENCED_PARAMETER(OutputStride);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(Flags);
+    MlasConvFloatKernelDispatch<true>(Input, Filter, Output, StrideWidth,
+        DilationWidth, FilterCount, InputStride, FilterStride, OutputStride,
+        KernelHeight, KernelWidth, InputBase, InputWidth, DilatedInputWidth,
+        OutputCountLeftPad, OutputCount, OutputCountRightPad, Bias, Flags);
 }
 
 void
@@ -1554,23 +2072,133 @@ MlasConvDepthwiseFloatKernel(
     const float* Bias,
     unsigned Flags
     )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a depthwise separable
+    convolution for the elements of an output row.
+
+Arguments:
+
+    See MlasConvNchwcFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t StrideWidthElements = StrideWidth / sizeof(float);
+    const size_t DilationWidthElements = DilationWidth / sizeof(float);
+    const size_t InputStrideElements = InputStride / sizeof(float);
+    const size_t DilatedInputWidthElements = DilatedInputWidth / sizeof(float);
+
+    const size_t TotalOutputCount = OutputCountLeftPad + OutputCount + OutputCountRightPad;
+
+    for (size_t o = 0; o < TotalOutputCount; o++) {
+
+        const bool CheckPadding = (o < OutputCountLeftPad) ||
+            (o >= OutputCountLeftPad + OutputCount);
+
+        MLAS_FLOAT32X4 Accumulators[1][MlasNchwcPortableVectorCount];
+
+        for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+            Accumulators[0][v] = MlasZeroFloat32x4();
+        }
+
+        const float* input = Input + o * StrideWidthElements;
+        const float* inputBase = InputBase;
+        const float* filter = Filter;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckPadding || MlasNchwcIsInputInBounds(input, inputBase, InputWidth)) {
+
+                    for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+                        Accumulators[0][v] = MlasMultiplyAddFloat32x4(
+                            MlasLoadFloat32x4(&input[v * 4]),
+                            MlasLoadFloat32x4(&filter[v * 4]), Accumulators[0][v]);
+                    }
+                }
+
+                input += DilationWidthElements;
+                filter += MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
+            }
+
+            input += InputStrideElements;
+            inputBase += DilatedInputWidthElements;
+        }
+
+        MlasConvPostProcessFloatBlock<1>(Accumulators,
+            Output + o * MLAS_NCHWC_PORTABLE_BLOCK_SIZE, 0, Bias, Flags);
+    }
+}
+
+template<size_t FilterCount>
+void
+MlasConvPointwiseFloatKernelPortable(
+    const float* Input,
+    const float* Filter,
+    float* Output,
+    size_t StrideWidth,
+    size_t InputChannels,
+    size_t InputStride,
+    size_t FilterStride,
+    size_t OutputStride,
+    size_t OutputCount,
+    const float* Bias,
+    unsigned Flags
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a pointwise convolution for
+    the elements of an output row for a fixed number of filters.
+
+Arguments:
+
+    See MlasConvPointwiseFloatKernel.
+
+Return Value:
+
+    None.
+
+--*/
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(Flags);
+    const size_t StrideWidthElements = StrideWidth / sizeof(float);
+    const size_t InputStrideElements = InputStride / sizeof(float);
+    const size_t FilterStrideElements = FilterStride / sizeof(float);
+    const size_t OutputStrideElements = OutputStride / sizeof(float);
+
+    for (size_t o = 0; o < OutputCount; o++) {
+
+        MLAS_FLOAT32X4 Accumulators[FilterCount][MlasNchwcPortableVectorCount];
+
+        for (size_t f = 0; f < FilterCount; f++) {
+            for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+                Accumulators[f][v] = MlasZeroFloat32x4();
+            }
+        }
+
+        const float* input = Input + o * StrideWidthElements;
+        const float* filter = Filter;
+
+        for (size_t ic = 0; ic < InputChannels; ic++) {
+
+            MlasConvComputeFloatBlock<FilterCount, true>(Accumulators, input,
+                filter, FilterStrideElements);
+
+            input += InputStrideElements;
+            filter += MLAS_NCHWC_PORTABLE_BLOCK_SIZE * MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
+        }
+
+        MlasConvPostProcessFloatBlock<FilterCount>(Accumulators,
+            Output + o * MLAS_NCHWC_PORTABLE_BLOCK_SIZE, OutputStrideElements, Bias, Flags);
+    }
 }
 
 void
@@ -1589,19 +2217,217 @@ MlasConvPointwiseFloatKernel(
     const float* Bias,
     unsigned Flags
     )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute a convolution for the elements
+    of an output row for a set of filter rows where the kernel dimensions are
+    one.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer.
+
+    Filter - Supplies the address of the filter buffer.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    InputChannels - Supplies the number of input channel blocks to process.
+
+    FilterCount - Supplies the number of filters to process in this
+        iteration.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input channel block of the same input row.
+
+    FilterStride - Supplies the length in bytes to advance the filter buffer
+        to the next set of filters.
+
+    OutputStride - Supplies the length in bytes to advance the output buffer
+        to the next output address associated with the next set of filters.
+
+    OutputCount - Supplies the number of output elements.
+
+    Bias - Supplies the address of the bias buffer.
+
+    Flags - Supplies additional flags controlling the convolution operation,
+        especially post calculation options.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (FilterCount) {
+
+        case 1:
+            MlasConvPointwiseFloatKernelPortable<1>(Input, Filter, Output, StrideWidth,
+                InputChannels, InputStride, FilterStride, OutputStride, OutputCount,
+                Bias, Flags);
+            break;
+
+        case 2:
+            MlasConvPointwiseFloatKernelPortable<2>(Input, Filter, Output, StrideWidth,
+                InputChannels, InputStride, FilterStride, OutputStride, OutputCount,
+                Bias, Flags);
+            break;
+
+        case 3:
+            MlasConvPointwiseFloatKernelPortable<3>(Input, Filter, Output, StrideWidth,
+                InputChannels, InputStride, FilterStride, OutputStride, OutputCount,
+                Bias, Flags);
+            break;
+
+        default:
+            MlasConvPointwiseFloatKernelPortable<4>(Input, Filter, Output, StrideWidth,
+                InputChannels, InputStride, FilterStride, OutputStride, OutputCount,
+                Bias, Flags);
+            break;
+    }
+}
+
+template<MLAS_POOLING_KIND PoolingKind>
+void
+MlasPoolFloatKernelPortable(
+    const float* Input,
+    float* Output,
+    size_t StrideWidth,
+    size_t DilationWidth,
+    size_t InputStride,
+    size_t ActualKernelSize,
+    size_t KernelHeight,
+    size_t KernelWidth,
+    const float* InputBase,
+    size_t InputWidth,
+    size_t DilatedInputWidth,
+    size_t OutputCountLeftPad,
+    size_t OutputCount,
+    size_t OutputCountRightPad
+    )
+/*++
+
+Routine Description:
+
+    This routine is the inner kernel to compute pooling for the elements of an
+    output row.
+
+Arguments:
+
+    Input - Supplies the address of the input buffer. The address is biased to
+        include padding blocks for the left width dimension.
+
+    Output - Supplies the address of the output buffer.
+
+    StrideWidth - Supplies the length in bytes of the blocked stride width.
+
+    DilationWidth - Supplies the length in bytes of the blocked dilation
+        width.
+
+    InputStride - Supplies the length in bytes to advance the input buffer to
+        the next input row.
+
+    ActualKernelSize - Supplies the size of the kernel based on the original
+        kernel dimensions, used for PoolingKind=MlasAveragePoolingIncludePad.
+
+    KernelHeight - Supplies the height of the kernel to apply.
+
+    KernelWidth - Supplies the width of the kernel to apply.
+
+    InputBase - Supplies the address of the valid input buffer.
+
+    InputWidth - Supplies the length in bytes of the blocked input width.
+
+    DilatedInputWidth - Supplies the length in bytes to advance the input base
+        buffer to the next input row including dilation.
+
+    OutputCountLeftPad - Supplies the number of output elements that include
+        one or more padding elements from the left edge.
+
+    OutputCount - Supplies the number of output elements that do not include
+        any padding elements.
+
+    OutputCountRightPad - Supplies the number of output elements that include
+        one or more padding elements from the right edge.
+
+Return Value:
+
+    None.
+
+--*/
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Filter);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputChannels);
-    MLAS_UNREFERENCED_PARAMETER(FilterCount);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(FilterStride);
-    MLAS_UNREFERENCED_PARAMETER(OutputStride);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(Bias);
-    MLAS_UNREFERENCED_PARAMETER(Flags);
+    const size_t StrideWidthElements = StrideWidth / sizeof(float);
+    const size_t DilationWidthElements = DilationWidth / sizeof(float);
+    const size_t InputStrideElements = InputStride / sizeof(float);
+    const size_t DilatedInputWidthElements = DilatedInputWidth / sizeof(float);
+
+    const MLAS_FLOAT32X4 InitialValue = (PoolingKind == MlasMaximumPooling) ?
+        MlasBroadcastFloat32x4(std::numeric_limits<float>::lowest()) : MlasZeroFloat32x4();
+    const MLAS_FLOAT32X4 KernelSizeFloat32x4 = MlasBroadcastFloat32x4(float(ActualKernelSize));
+
+    const size_t TotalOutputCount = OutputCountLeftPad + OutputCount + OutputCountRightPad;
+
+    for (size_t o = 0; o < TotalOutputCount; o++) {
+
+        const bool CheckPadding = (o < OutputCountLeftPad) ||
+            (o >= OutputCountLeftPad + OutputCount);
+
+        MLAS_FLOAT32X4 Accumulators[MlasNchwcPortableVectorCount];
+
+        for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+            Accumulators[v] = InitialValue;
+        }
+
+        size_t ValidBlockCount = 0;
+
+        const float* input = Input + o * StrideWidthElements;
+        const float* inputBase = InputBase;
+
+        for (size_t kh = 0; kh < KernelHeight; kh++) {
+
+            for (size_t kw = 0; kw < KernelWidth; kw++) {
+
+                if (!CheckPadding || MlasNchwcIsInputInBounds(input, inputBase, InputWidth)) {
+
+                    for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+
+                        MLAS_FLOAT32X4 InputValue = MlasLoadFloat32x4(&input[v * 4]);
+
+                        if (PoolingKind == MlasMaximumPooling) {
+                            Accumulators[v] = MlasMaximumFloat32x4(Accumulators[v], InputValue);
+                        } else {
+                            Accumulators[v] = MlasAddFloat32x4(Accumulators[v], InputValue);
+                        }
+                    }
+
+                    ValidBlockCount++;
+                }
+
+                input += DilationWidthElements;
+            }
+
+            input += InputStrideElements;
+            inputBase += DilatedInputWidthElements;
+        }
+
+        float* output = Output + o * MLAS_NCHWC_PORTABLE_BLOCK_SIZE;
+
+        for (size_t v = 0; v < MlasNchwcPortableVectorCount; v++) {
+
+            MLAS_FLOAT32X4 Value = Accumulators[v];
+
+            if (PoolingKind == MlasAveragePoolingExcludePad) {
+                Value = MlasDivideFloat32x4(Value, MlasBroadcastFloat32x4(float(ValidBlockCount)));
+            } else if (PoolingKind == MlasAveragePoolingIncludePad) {
+                Value = MlasDivideFloat32x4(Value, KernelSizeFloat32x4);
+            }
+
+            MlasStoreFloat32x4(&output[v * 4], Value);
+        }
+    }
 }
 
 void
@@ -1623,20 +2449,10 @@ MlasPoolMaximumFloatKernel(
     size_t OutputCountRightPad
     )
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(ActualKernelSize);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
+    MlasPoolFloatKernelPortable<MlasMaximumPooling>(Input, Output, StrideWidth,
+        DilationWidth, InputStride, ActualKernelSize, KernelHeight, KernelWidth,
+        InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad, OutputCount,
+        OutputCountRightPad);
 }
 
 void
@@ -1658,20 +2474,10 @@ MlasPoolAverageExcludePadFloatKernel(
     size_t OutputCountRightPad
     )
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(ActualKernelSize);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
+    MlasPoolFloatKernelPortable<MlasAveragePoolingExcludePad>(Input, Output,
+        StrideWidth, DilationWidth, InputStride, ActualKernelSize, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad,
+        OutputCount, OutputCountRightPad);
 }
 
 void
@@ -1693,20 +2499,10 @@ MlasPoolAverageIncludePadFloatKernel(
     size_t OutputCountRightPad
     )
 {
-    MLAS_UNREFERENCED_PARAMETER(Input);
-    MLAS_UNREFERENCED_PARAMETER(Output);
-    MLAS_UNREFERENCED_PARAMETER(StrideWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilationWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputStride);
-    MLAS_UNREFERENCED_PARAMETER(ActualKernelSize);
-    MLAS_UNREFERENCED_PARAMETER(KernelHeight);
-    MLAS_UNREFERENCED_PARAMETER(KernelWidth);
-    MLAS_UNREFERENCED_PARAMETER(InputBase);
-    MLAS_UNREFERENCED_PARAMETER(InputWidth);
-    MLAS_UNREFERENCED_PARAMETER(DilatedInputWidth);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountLeftPad);
-    MLAS_UNREFERENCED_PARAMETER(OutputCount);
-    MLAS_UNREFERENCED_PARAMETER(OutputCountRightPad);
+    MlasPoolFloatKernelPortable<MlasAveragePoolingIncludePad>(Input, Output,
+        StrideWidth, DilationWidth, InputStride, ActualKernelSize, KernelHeight,
+        KernelWidth, InputBase, InputWidth, DilatedInputWidth, OutputCountLeftPad,
+        OutputCount, OutputCountRightPad);
 }
 
 #endif
@@ -0,0 +1,490 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the matrix transpose routines.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of rows and columns of the tiles used to step through the
+// matrices. Each tile of the source and destination matrices fits in the L1
+// cache.
+//
+
+#define MLAS_TRANSPOSE_TILE_SIZE                    32
+
+//
+// Define the target number of per-thread elements before using another thread
+// to perform additional work.
+//
+
+#define MLAS_TRANSPOSE_THREAD_ELEMENTS              (64 * 1024)
+
+//
+// Define the parameters to execute a batched transpose on worker threads.
+//
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_WORK_BLOCK {
+    const ElementType* Input;
+    ElementType* Output;
+    size_t BatchCount;
+    size_t M;
+    size_t N;
+    bool PartitionRows;
+    size_t TilesPerBatch;
+    int32_t ThreadCount;
+};
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint32_t* Input,
+    size_t ldi,
+    uint32_t* Output,
+    size_t ldo
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a 4x4 block of 32-bit elements using in-register
+    shuffles.
+
+Arguments:
+
+    Input - Supplies the address of the source block.
+
+    ldi - Supplies the number of elements per row of the source matrix.
+
+    Output - Supplies the address of the destination block.
+
+    ldo - Supplies the number of elements per row of the destination matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[ldi * 0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[ldi * 1]);
+    __m128i a2 = _mm_loadu_si128((const __m128i*)&Input[ldi * 2]);
+    __m128i a3 = _mm_loadu_si128((const __m128i*)&Input[ldi * 3]);
+
+    __m128i t0 = _mm_unpacklo_epi32(a0, a1);
+    __m128i t1 = _mm_unpacklo_epi32(a2, a3);
+    __m128i t2 = _mm_unpackhi_epi32(a0, a1);
+    __m128i t3 = _mm_unpackhi_epi32(a2, a3);
+
+    _mm_storeu_si128((__m128i*)&Output[ldo * 0], _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*)&Output[ldo * 1], _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128((__m128i*)&Output[ldo * 2], _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128((__m128i*)&Output[ldo * 3], _mm_unpackhi_epi64(t2, t3));
+#elif defined(MLAS_NEON_INTRINSICS)
+    uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(&Input[ldi * 0]), vld1q_u32(&Input[ldi * 1]));
+    uint32x4x2_t t23 = vtrnq_u32(vld1q_u32(&Input[ldi * 2]), vld1q_u32(&Input[ldi * 3]));
+
+    vst1q_u32(&Output[ldo * 0], vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(&Output[ldo * 1], vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(&Output[ldo * 2], vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(&Output[ldo * 3], vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint64_t* Input,
+    size_t ldi,
+    uint64_t* Output,
+    size_t ldo
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a 4x4 block of 64-bit elements using in-register
+    shuffles of 2x2 sub-blocks.
+
+Arguments:
+
+    Input - Supplies the address of the source block.
+
+    ldi - Supplies the number of elements per row of the source matrix.
+
+    Output - Supplies the address of the destination block.
+
+    ldo - Supplies the number of elements per row of the destination matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t i = 0; i < 4; i += 2) {
+        for (size_t j = 0; j < 4; j += 2) {
+
+            const uint64_t* s = &Input[ldi * i + j];
+            uint64_t* d = &Output[ldo * j + i];
+
+#if defined(MLAS_SSE2_INTRINSICS)
+            __m128i a0 = _mm_loadu_si128((const __m128i*)&s[0]);
+            __m128i a1 = _mm_loadu_si128((const __m128i*)&s[ldi]);
+
+            _mm_storeu_si128((__m128i*)&d[0], _mm_unpacklo_epi64(a0, a1));
+            _mm_storeu_si128((__m128i*)&d[ldo], _mm_unpackhi_epi64(a0, a1));
+#elif defined(MLAS_NEON_INTRINSICS)
+            uint64x2_t a0 = vld1q_u64(&s[0]);
+            uint64x2_t a1 = vld1q_u64(&s[ldi]);
+
+            vst1q_u64(&d[0], vcombine_u64(vget_low_u64(a0), vget_low_u64(a1)));
+            vst1q_u64(&d[ldo], vcombine_u64(vget_high_u64(a0), vget_high_u64(a1)));
+#endif
+        }
+    }
+}
+
+template<typename ElementType>
+void
+MlasTransposeBlock(
+    const ElementType* Input,
+    size_t ldi,
+    ElementType* Output,
+    size_t ldo,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a block of the source matrix to the destination
+    matrix. The block is processed in cache sized tiles, with each tile
+    processed as 4x4 blocks using in-register shuffles and any remaining
+    elements copied one at a time.
+
+Arguments:
+
+    Input - Supplies the address of the source block.
+
+    ldi - Supplies the number of elements per row of the source matrix.
+
+    Output - Supplies the address of the destination block.
+
+    ldo - Supplies the number of elements per row of the destination matrix.
+
+    CountM - Supplies the number of rows of the source block.
+
+    CountN - Supplies the number of columns of the source block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t m = 0; m < CountM; m += MLAS_TRANSPOSE_TILE_SIZE) {
+
+        const size_t TileM = std::min(CountM - m, size_t(MLAS_TRANSPOSE_TILE_SIZE));
+
+        for (size_t n = 0; n < CountN; n += MLAS_TRANSPOSE_TILE_SIZE) {
+
+            const size_t TileN = std::min(CountN - n, size_t(MLAS_TRANSPOSE_TILE_SIZE));
+
+            const ElementType* s = Input + m * ldi + n;
+            ElementType* d = Output + n * ldo + m;
+
+            size_t i = 0;
+
+            for (; i + 4 <= TileM; i += 4) {
+
+                size_t j = 0;
+
+                for (; j + 4 <= TileN; j += 4) {
+                    MlasTranspose4x4Block(&s[i * ldi + j], ldi, &d[j * ldo + i], ldo);
+                }
+
+                for (; j < TileN; j++) {
+                    d[j * ldo + i + 0] = s[(i + 0) * ldi + j];
+                    d[j * ldo + i + 1] = s[(i + 1) * ldi + j];
+                    d[j * ldo + i + 2] = s[(i + 2) * ldi + j];
+                    d[j * ldo + i + 3] = s[(i + 3) * ldi + j];
+                }
+            }
+
+            for (; i < TileM; i++) {
+                for (size_t j = 0; j < TileN; j++) {
+                    d[j * ldo + i] = s[i * ldi + j];
+                }
+            }
+        }
+    }
+}
+
+template<typename ElementType>
+void
+MlasTransposeThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    batched transpose operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_TRANSPOSE_WORK_BLOCK<ElementType>*)Context;
+
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t TilesPerBatch = WorkBlock->TilesPerBatch;
+
+    //
+    // Partition the operation along the tiles of every matrix in the batch.
+    //
+
+    const size_t TotalWork = WorkBlock->BatchCount * TilesPerBatch;
+
+    const size_t WorkPerThread = TotalWork / WorkBlock->ThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % WorkBlock->ThreadCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        WorkIndex = (WorkPerThread + 1) * Index;
+        WorkRemaining = WorkPerThread + 1;
+    } else {
+        WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        WorkRemaining = WorkPerThread;
+    }
+
+    while (WorkRemaining > 0) {
+
+        const size_t b = WorkIndex / TilesPerBatch;
+        const size_t Tile = WorkIndex % TilesPerBatch;
+
+        //
+        // Transpose as many tiles of this matrix as were assigned to this
+        // thread.
+        //
+
+        size_t TileCount = std::min(WorkRemaining, TilesPerBatch - Tile);
+
+        const ElementType* Input = WorkBlock->Input + b * M * N;
+        ElementType* Output = WorkBlock->Output + b * M * N;
+
+        size_t Start = Tile * MLAS_TRANSPOSE_TILE_SIZE;
+
+        if (WorkBlock->PartitionRows) {
+
+            size_t CountM = std::min(M - Start, TileCount * MLAS_TRANSPOSE_TILE_SIZE);
+
+            MlasTransposeBlock(Input + Start * N, N, Output + Start, M, CountM, N);
+
+        } else {
+
+            size_t CountN = std::min(N - Start, TileCount * MLAS_TRANSPOSE_TILE_SIZE);
+
+            MlasTransposeBlock(Input + Start, N, Output + Start * M, M, M, CountN);
+        }
+
+        WorkIndex += TileCount;
+        WorkRemaining -= TileCount;
+    }
+}
+
+template<typename ElementType>
+void
+MlasTransposeOperation(
+    const ElementType* Input,
+    ElementType* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the batched matrix transpose operation.
+
+Arguments:
+
+    See MlasTranspose.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (BatchCount == 0 || M == 0 || N == 0) {
+        return;
+    }
+
+    MLAS_TRANSPOSE_WORK_BLOCK<ElementType> WorkBlock;
+
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.BatchCount = BatchCount;
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+
+    //
+    // Split each matrix along the larger dimension so that small batches of
+    // narrow matrices still divide across threads.
+    //
+
+    WorkBlock.PartitionRows = (M >= N);
+    WorkBlock.TilesPerBatch =
+        ((WorkBlock.PartitionRows ? M : N) + MLAS_TRANSPOSE_TILE_SIZE - 1) / MLAS_TRANSPOSE_TILE_SIZE;
+
+    //
+    // Compute the number of target threads given the number of elements to
+    // move. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(BatchCount) * double(M) * double(N);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_TRANSPOSE_THREAD_ELEMENTS * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_TRANSPOSE_THREAD_ELEMENTS)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    const size_t TotalWork = BatchCount * WorkBlock.TilesPerBatch;
+
+    if (size_t(TargetThreadCount) > TotalWork) {
+        TargetThreadCount = int32_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = TargetThreadCount;
+
+    if (TargetThreadCount == 1) {
+        MlasTransposeThreaded<ElementType>(&WorkBlock, 0);
+        return;
+    }
+
+    MlasExecuteThreaded(MlasTransposeThreaded<ElementType>, &WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a batch of matrices of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the address of the source matrices. Each matrix is M rows
+        by N columns and the matrices are contiguous.
+
+    Output - Supplies the address of the destination matrices. Each matrix is
+        N rows by M columns and the matrices are contiguous.
+
+    BatchCount - Supplies the number of matrices to transpose.
+
+    M - Supplies the number of rows of each source matrix.
+
+    N - Supplies the number of columns of each source matrix.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeOperation(Input, Output, BatchCount, M, N, ThreadPool);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint64_t* Input,
+    uint64_t* Output,
+    size_t BatchCount,
+    size_t M,
+    size_t N,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a batch of matrices of 64-bit elements.
+
+Arguments:
+
+    Input - Supplies the address of the source matrices. Each matrix is M rows
+        by N columns and the matrices are contiguous.
+
+    Output - Supplies the address of the destination matrices. Each matrix is
+        N rows by M columns and the matrices are contiguous.
+
+    BatchCount - Supplies the number of matrices to transpose.
+
+    M - Supplies the number of rows of each source matrix.
+
+    N - Supplies the number of columns of each source matrix.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeOperation(Input, Output, BatchCount, M, N, ThreadPool);
+}
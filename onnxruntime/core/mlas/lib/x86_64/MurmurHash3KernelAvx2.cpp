@@ -0,0 +1,98 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    MurmurHash3KernelAvx2.cpp
+
+Abstract:
+
+    This module implements the kernel to compute the 32-bit MurmurHash3 of a
+    buffer of 32-bit keys, eight keys at a time.
+
+    This implementation uses AVX2 instructions.
+
+--*/
+
+#include "mlasi.h"
+
+template<int Count>
+MLAS_FORCEINLINE
+__m256i
+MlasRotateLeftInt32x8(
+    __m256i Vector
+    )
+{
+    return _mm256_or_si256(_mm256_slli_epi32(Vector, Count), _mm256_srli_epi32(Vector, 32 - Count));
+}
+
+void
+MLASCALL
+MlasMurmurHash3U32KernelAvx2(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t N,
+    uint32_t Seed
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vectorized kernel to compute the hash of each
+    key of a buffer, with each 32-bit lane hashing one key.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Seed - Supplies the seed of the hash.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m256i C1 = _mm256_set1_epi32(int32_t(0xcc9e2d51));
+    const __m256i C2 = _mm256_set1_epi32(int32_t(0x1b873593));
+    const __m256i C3 = _mm256_set1_epi32(int32_t(0xe6546b64));
+    const __m256i F1 = _mm256_set1_epi32(int32_t(0x85ebca6b));
+    const __m256i F2 = _mm256_set1_epi32(int32_t(0xc2b2ae35));
+    const __m256i SeedVector = _mm256_set1_epi32(int32_t(Seed));
+    const __m256i Length = _mm256_set1_epi32(4);
+
+    while (N >= 8) {
+
+        __m256i k1 = _mm256_loadu_si256((const __m256i*)Input);
+
+        k1 = _mm256_mullo_epi32(k1, C1);
+        k1 = MlasRotateLeftInt32x8<15>(k1);
+        k1 = _mm256_mullo_epi32(k1, C2);
+
+        __m256i h1 = _mm256_xor_si256(SeedVector, k1);
+        h1 = MlasRotateLeftInt32x8<13>(h1);
+        h1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(h1, 2), h1), C3);
+
+        h1 = _mm256_xor_si256(h1, Length);
+        h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+        h1 = _mm256_mullo_epi32(h1, F1);
+        h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 13));
+        h1 = _mm256_mullo_epi32(h1, F2);
+        h1 = _mm256_xor_si256(h1, _mm256_srli_epi32(h1, 16));
+
+        _mm256_storeu_si256((__m256i*)Output, h1);
+
+        Input += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    MlasMurmurHash3U32Kernel(Input, Output, N, Seed);
+}
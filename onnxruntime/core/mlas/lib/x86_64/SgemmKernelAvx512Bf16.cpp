@@ -0,0 +1,333 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    SgemmKernelAvx512Bf16.cpp
+
+Abstract:
+
+    This module implements the kernel for the single precision matrix/matrix
+    multiply operation (SGEMM) that computes the dot products from bfloat16
+    rounded inputs.
+
+    This implementation uses AVX512F, AVX512BW and AVX512-BF16 instructions.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Indices to interleave the bfloat16 elements of two rows of matrix B so that
+// each 32-bit lane holds the elements of one column for a pair of rows, as
+// expected by vdpbf16ps.
+//
+
+MLAS_DECLSPEC_ALIGN(static const uint16_t MlasSgemmBf16InterleaveIndices[32], 64) = {
+    0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23,
+    8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31,
+};
+
+MLAS_FORCEINLINE
+__m512bh
+MlasSgemmBf16BroadcastPair(
+    __m128 Pair
+    )
+/*++
+
+Routine Description:
+
+    This routine rounds a pair of elements from matrix A to bfloat16 and
+    broadcasts the pair to every 32-bit lane.
+
+Arguments:
+
+    Pair - Supplies the pair of elements in the low two lanes.
+
+Return Value:
+
+    Returns the broadcast pair.
+
+--*/
+{
+    __m256i Packed = (__m256i)_mm512_cvtneps_pbh(_mm512_castps128_ps512(Pair));
+
+    return (__m512bh)_mm512_broadcastd_epi32(_mm256_castsi256_si128(Packed));
+}
+
+template<size_t RowCount, size_t ColumnBlocks>
+MLAS_FORCEINLINE
+void
+MlasSgemmBf16ComputeBlock(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to RowCount rows by up to 32 columns
+    of the output matrix.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of the packed panel of matrix B. The panel is
+        laid out as blocks of 16 columns by CountK rows.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of matrix B.
+
+    CountN - Supplies the number of columns of matrix C to compute. Only the
+        last block may be smaller than 16 * ColumnBlocks columns.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m512i InterleaveIndices = _mm512_load_si512(MlasSgemmBf16InterleaveIndices);
+    const __m512 ZeroVector = _mm512_setzero_ps();
+
+    __m512 Accumulators[RowCount][ColumnBlocks];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnBlocks; c++) {
+            Accumulators[r][c] = ZeroVector;
+        }
+    }
+
+    const float* b = B;
+    size_t k = 0;
+
+    for (; k + 2 <= CountK; k += 2) {
+
+        //
+        // Round two rows of each block of matrix B to bfloat16 and interleave
+        // the rows into column pairs.
+        //
+
+        __m512bh BlockB[ColumnBlocks];
+
+        for (size_t c = 0; c < ColumnBlocks; c++) {
+            const float* bc = b + c * CountK * 16;
+            __m512i Packed = (__m512i)_mm512_cvtne2ps_pbh(_mm512_load_ps(bc + 16), _mm512_load_ps(bc));
+            BlockB[c] = (__m512bh)_mm512_permutexvar_epi16(InterleaveIndices, Packed);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m128 PairA = _mm_castpd_ps(_mm_load_sd((const double*)(A + r * lda + k)));
+            __m512bh BroadcastA = MlasSgemmBf16BroadcastPair(PairA);
+
+            for (size_t c = 0; c < ColumnBlocks; c++) {
+                Accumulators[r][c] = _mm512_dpbf16_ps(Accumulators[r][c], BroadcastA, BlockB[c]);
+            }
+        }
+
+        b += 32;
+    }
+
+    //
+    // Handle the last row of matrix B for an odd count by pairing the row
+    // with zeroes.
+    //
+
+    if (k < CountK) {
+
+        __m512bh BlockB[ColumnBlocks];
+
+        for (size_t c = 0; c < ColumnBlocks; c++) {
+            const float* bc = b + c * CountK * 16;
+            __m512i Packed = (__m512i)_mm512_cvtne2ps_pbh(ZeroVector, _mm512_load_ps(bc));
+            BlockB[c] = (__m512bh)_mm512_permutexvar_epi16(InterleaveIndices, Packed);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            __m128 PairA = _mm_load_ss(A + r * lda + k);
+            __m512bh BroadcastA = MlasSgemmBf16BroadcastPair(PairA);
+
+            for (size_t c = 0; c < ColumnBlocks; c++) {
+                Accumulators[r][c] = _mm512_dpbf16_ps(Accumulators[r][c], BroadcastA, BlockB[c]);
+            }
+        }
+    }
+
+    //
+    // Multiply the accumulators by alpha and store or accumulate to the
+    // output block, masking the columns past the end of the output matrix.
+    //
+
+    const __m512 AlphaVector = _mm512_set1_ps(alpha);
+
+    for (size_t c = 0; c < ColumnBlocks; c++) {
+
+        size_t CountBlockN = CountN - c * 16;
+        __mmask16 Mask = (CountBlockN >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << CountBlockN) - 1);
+
+        for (size_t r = 0; r < RowCount; r++) {
+
+            float* cc = C + r * ldc + c * 16;
+            __m512 Result = _mm512_mul_ps(Accumulators[r][c], AlphaVector);
+
+            if (!ZeroMode) {
+                Result = _mm512_add_ps(Result, _mm512_maskz_loadu_ps(Mask, cc));
+            }
+
+            _mm512_mask_storeu_ps(cc, Mask, Result);
+        }
+    }
+}
+
+template<size_t RowCount>
+void
+MlasSgemmBf16ComputeRows(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of the output matrix by stepping
+    through the packed panel of matrix B 32 columns at a time.
+
+Arguments:
+
+    See MlasSgemmBf16ComputeBlock.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (CountN > 16) {
+
+        size_t CountBlockN = (CountN > 32) ? 32 : CountN;
+
+        MlasSgemmBf16ComputeBlock<RowCount, 2>(A, B, C, CountK, CountBlockN, lda, ldc, alpha, ZeroMode);
+
+        B += CountK * 32;
+        C += 32;
+        CountN -= CountBlockN;
+    }
+
+    if (CountN > 0) {
+        MlasSgemmBf16ComputeBlock<RowCount, 1>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+    }
+}
+
+size_t
+MLASCALL
+MlasGemmFloatKernelAvx512Bf16(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha,
+    bool ZeroMode
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows. The elements of matrix A and matrix B are rounded to bfloat16
+    and the dot products are accumulated in single precision.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns of matrix A and the number of rows
+        of matrix B.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns of matrix B and matrix C.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    ZeroMode - Supplies true if the output matrix must be zero initialized,
+        else false if the output matrix is accumulated into.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    switch (CountM) {
+
+        case 1:
+            MlasSgemmBf16ComputeRows<1>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 1;
+
+        case 2:
+            MlasSgemmBf16ComputeRows<2>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 2;
+
+        case 3:
+            MlasSgemmBf16ComputeRows<3>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 3;
+
+        case 4:
+            MlasSgemmBf16ComputeRows<4>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 4;
+
+        case 5:
+            MlasSgemmBf16ComputeRows<5>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 5;
+
+        default:
+            MlasSgemmBf16ComputeRows<6>(A, B, C, CountK, CountN, lda, ldc, alpha, ZeroMode);
+            return 6;
+    }
+}
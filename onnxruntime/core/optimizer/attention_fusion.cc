@@ -0,0 +1,286 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <cmath>
+#include <cstring>
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static bool HasPerm(const Node& transpose_node, const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return graph_utils::GetRepeatedNodeAttributeValues(transpose_node, "perm", perm) && perm == expected_perm;
+}
+
+// Returns the float initializer for arg if it has the expected shape.
+static const TensorProto* GetFloatInitializer(const Graph& graph, const NodeArg& arg,
+                                              const std::vector<int64_t>& expected_dims) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT ||
+      tensor_proto->dims_size() != static_cast<int>(expected_dims.size())) {
+    return nullptr;
+  }
+  for (int i = 0; i < tensor_proto->dims_size(); ++i) {
+    if (tensor_proto->dims(i) != expected_dims[i]) {
+      return nullptr;
+    }
+  }
+  return tensor_proto;
+}
+
+// Checks whether two dims are known to be equal, either as the same value or the same symbolic dim.
+static bool IsSameDim(const TensorShapeProto_Dimension& a, const TensorShapeProto_Dimension& b) {
+  if (a.has_dim_value() && b.has_dim_value()) {
+    return a.dim_value() == b.dim_value();
+  }
+  return a.has_dim_param() && b.has_dim_param() && a.dim_param() == b.dim_param();
+}
+
+// The nodes projecting the input to the Q, K or V of every head.
+struct AttentionProjection {
+  Node* matmul;
+  Node* add;
+  Node* reshape;
+  Node* transpose;
+  const NodeArg* weight;
+  const NodeArg* bias;
+  int64_t num_heads;
+  int64_t head_size;
+};
+
+// Matches MatMul(X, W) -> Add(B) -> Reshape(0, 0, num_heads, head_size) -> Transpose(perm), ending at transpose.
+static bool MatchProjection(Graph& graph, Node& transpose, const std::vector<int64_t>& perm,
+                            AttentionProjection& projection) {
+  if (!HasPerm(transpose, perm)) {
+    return false;
+  }
+
+  Node* reshape = optimizer_utils::GetInputNode(graph, transpose, 0, "Reshape", {5});
+  std::vector<int64_t> shape;
+  if (reshape == nullptr || !optimizer_utils::GetInt64InitializerValues(graph, *reshape->InputDefs()[1], shape) ||
+      shape.size() != 4 || shape[2] <= 0 || shape[3] <= 0) {
+    return false;
+  }
+
+  Node* add = optimizer_utils::GetInputNode(graph, *reshape, 0, "Add", {7});
+  if (add == nullptr) {
+    return false;
+  }
+
+  int matmul_index = 0;
+  Node* matmul = optimizer_utils::GetInputNode(graph, *add, 0, "MatMul", {1, 9});
+  if (matmul == nullptr) {
+    matmul_index = 1;
+    matmul = optimizer_utils::GetInputNode(graph, *add, 1, "MatMul", {1, 9});
+  }
+  if (matmul == nullptr) {
+    return false;
+  }
+
+  projection = {matmul, add, reshape, &transpose, matmul->InputDefs()[1], add->InputDefs()[1 - matmul_index],
+                shape[2], shape[3]};
+  return true;
+}
+
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& softmax_node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(softmax_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax_node, "Softmax", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(softmax_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // softmax over the last axis of the (batch, heads, sequence, sequence) scores
+    const auto* axis_attr = graph_utils::GetNodeAttribute(softmax_node, "axis");
+    if (axis_attr == nullptr || (axis_attr->i() != 3 && axis_attr->i() != -1)) {
+      continue;
+    }
+
+    // Walk back from the Softmax to the scores, with or without the mask.
+    Node* mask_add_node = optimizer_utils::GetInputNode(graph, softmax_node, 0, "Add", {7});
+    const NodeArg* mask = nullptr;
+    Node* div_node = nullptr;
+    if (mask_add_node != nullptr) {
+      div_node = optimizer_utils::GetInputNode(graph, *mask_add_node, 0, "Div", {7});
+      mask = mask_add_node->InputDefs()[1];
+      if (div_node == nullptr) {
+        div_node = optimizer_utils::GetInputNode(graph, *mask_add_node, 1, "Div", {7});
+        mask = mask_add_node->InputDefs()[0];
+      }
+    } else {
+      div_node = optimizer_utils::GetInputNode(graph, softmax_node, 0, "Div", {7});
+    }
+    if (div_node == nullptr) {
+      continue;
+    }
+
+    Node* qk_matmul_node = optimizer_utils::GetInputNode(graph, *div_node, 0, "MatMul", {1, 9});
+    if (qk_matmul_node == nullptr) {
+      continue;
+    }
+    Node* q_transpose = optimizer_utils::GetInputNode(graph, *qk_matmul_node, 0, "Transpose", {1});
+    Node* k_transpose = optimizer_utils::GetInputNode(graph, *qk_matmul_node, 1, "Transpose", {1});
+
+    // Walk forward from the Softmax to the output.
+    Node* qkv_matmul_node = optimizer_utils::GetOnlyChildNode(graph, softmax_node, "MatMul", {1, 9});
+    if (qkv_matmul_node == nullptr || qkv_matmul_node->InputDefs()[0] != softmax_node.OutputDefs()[0]) {
+      continue;
+    }
+    Node* v_transpose = optimizer_utils::GetInputNode(graph, *qkv_matmul_node, 1, "Transpose", {1});
+
+    Node* output_transpose = optimizer_utils::GetOnlyChildNode(graph, *qkv_matmul_node, "Transpose", {1});
+    if (output_transpose == nullptr || !HasPerm(*output_transpose, {0, 2, 1, 3})) {
+      continue;
+    }
+    Node* output_reshape = optimizer_utils::GetOnlyChildNode(graph, *output_transpose, "Reshape", {5});
+    if (output_reshape == nullptr) {
+      continue;
+    }
+
+    AttentionProjection q, k, v;
+    if (q_transpose == nullptr || k_transpose == nullptr || v_transpose == nullptr ||
+        !MatchProjection(graph, *q_transpose, {0, 2, 1, 3}, q) ||
+        !MatchProjection(graph, *k_transpose, {0, 2, 3, 1}, k) ||
+        !MatchProjection(graph, *v_transpose, {0, 2, 1, 3}, v)) {
+      continue;
+    }
+
+    // All the projections read the same (batch, sequence, hidden) float input and use the same heads.
+    NodeArg* input = q.matmul->MutableInputDefs()[0];
+    const auto* input_shape = input->Shape();
+    if (k.matmul->InputDefs()[0] != input || v.matmul->InputDefs()[0] != input ||
+        input->Type() == nullptr || *input->Type() != "tensor(float)" ||
+        input_shape == nullptr || input_shape->dim_size() != 3 || !input_shape->dim(2).has_dim_value()) {
+      continue;
+    }
+
+    const int64_t num_heads = q.num_heads;
+    const int64_t head_size = q.head_size;
+    const int64_t hidden_size = input_shape->dim(2).dim_value();
+    if (num_heads * head_size != hidden_size ||
+        k.num_heads != num_heads || k.head_size != head_size ||
+        v.num_heads != num_heads || v.head_size != head_size ||
+        !optimizer_utils::IsScalarInitializerWithValue(graph, *div_node->InputDefs()[1],
+                                                       std::sqrt(static_cast<float>(head_size)))) {
+      continue;
+    }
+
+    std::vector<int64_t> output_shape;
+    if (!optimizer_utils::GetInt64InitializerValues(graph, *output_reshape->InputDefs()[1], output_shape) ||
+        output_shape.size() != 3 || output_shape[2] != hidden_size) {
+      continue;
+    }
+
+    // The mask must be a (batch, 1, 1, sequence) tensor, broadcast over the heads and the rows of the scores.
+    // The Attention kernel doesn't broadcast the mask over the batch or the sequence, so those dims must be
+    // known to match the input's, e.g. a mask of batch 1 for a larger batch can't be fused.
+    if (mask != nullptr) {
+      const auto* mask_shape = mask->Shape();
+      if (mask_shape == nullptr || mask->Type() == nullptr || *mask->Type() != "tensor(float)" ||
+          mask_shape->dim_size() != 4 ||
+          !mask_shape->dim(1).has_dim_value() || mask_shape->dim(1).dim_value() != 1 ||
+          !mask_shape->dim(2).has_dim_value() || mask_shape->dim(2).dim_value() != 1 ||
+          !IsSameDim(mask_shape->dim(0), input_shape->dim(0)) || !IsSameDim(mask_shape->dim(3), input_shape->dim(1))) {
+        continue;
+      }
+    }
+
+    const TensorProto* weights[3];
+    const TensorProto* biases[3];
+    bool valid_initializers = true;
+    const AttentionProjection* projections[3] = {&q, &k, &v};
+    for (int i = 0; i < 3; ++i) {
+      weights[i] = GetFloatInitializer(graph, *projections[i]->weight, {hidden_size, hidden_size});
+      biases[i] = GetFloatInitializer(graph, *projections[i]->bias, {hidden_size});
+      valid_initializers = valid_initializers && weights[i] != nullptr && biases[i] != nullptr;
+    }
+    if (!valid_initializers) {
+      continue;
+    }
+
+    // Concatenate the weights to (hidden, 3 * hidden) and the biases to (3 * hidden).
+    std::vector<float> qkv_weights(static_cast<size_t>(hidden_size * 3 * hidden_size));
+    std::vector<float> qkv_bias(static_cast<size_t>(3 * hidden_size));
+    for (int i = 0; i < 3; ++i) {
+      Initializer weight{weights[i]};
+      Initializer bias{biases[i]};
+      for (int64_t row = 0; row < hidden_size; ++row) {
+        memcpy(&qkv_weights[(row * 3 + i) * hidden_size], weight.data<float>() + row * hidden_size,
+               sizeof(float) * hidden_size);
+      }
+      memcpy(&qkv_bias[i * hidden_size], bias.data<float>(), sizeof(float) * hidden_size);
+    }
+
+    TensorProto qkv_weights_tensor_proto;
+    qkv_weights_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    qkv_weights_tensor_proto.set_name(graph.GenerateNodeArgName("qkv_weights"));
+    qkv_weights_tensor_proto.set_raw_data(qkv_weights.data(), qkv_weights.size() * sizeof(float));
+    qkv_weights_tensor_proto.add_dims(hidden_size);
+    qkv_weights_tensor_proto.add_dims(3 * hidden_size);
+    graph.AddInitializedTensor(qkv_weights_tensor_proto);
+
+    TensorProto qkv_bias_tensor_proto;
+    qkv_bias_tensor_proto.set_data_type(TensorProto_DataType_FLOAT);
+    qkv_bias_tensor_proto.set_name(graph.GenerateNodeArgName("qkv_bias"));
+    qkv_bias_tensor_proto.set_raw_data(qkv_bias.data(), qkv_bias.size() * sizeof(float));
+    qkv_bias_tensor_proto.add_dims(3 * hidden_size);
+    graph.AddInitializedTensor(qkv_bias_tensor_proto);
+
+    std::vector<NodeArg*> attention_input_defs{input,
+                                               &graph.GetOrCreateNodeArg(qkv_weights_tensor_proto.name(), nullptr),
+                                               &graph.GetOrCreateNodeArg(qkv_bias_tensor_proto.name(), nullptr)};
+    if (mask != nullptr) {
+      attention_input_defs.push_back(const_cast<NodeArg*>(mask));
+    }
+
+    Node& attention_node = graph.AddNode(graph.GenerateNodeName("Attention"),
+                                         "Attention",
+                                         "fused multi-head attention subgraph",
+                                         attention_input_defs,
+                                         output_reshape->MutableOutputDefs(), nullptr, kMSDomain);
+    attention_node.AddAttribute("num_heads", num_heads);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention_node.SetExecutionProviderType(softmax_node.GetExecutionProviderType());
+
+    // Every node in the list is consumed only by nodes after it, so removing them back to front never leaves a
+    // removed producer behind a remaining consumer.
+    std::vector<Node*> fused_nodes;
+    for (const AttentionProjection* projection : projections) {
+      fused_nodes.insert(fused_nodes.end(),
+                         {projection->matmul, projection->add, projection->reshape, projection->transpose});
+    }
+    fused_nodes.insert(fused_nodes.end(), {qk_matmul_node, div_node});
+    if (mask_add_node != nullptr) {
+      fused_nodes.push_back(mask_add_node);
+    }
+    fused_nodes.insert(fused_nodes.end(), {&softmax_node, qkv_matmul_node, output_transpose, output_reshape});
+    for (Node* fused_node : fused_nodes) {
+      removed_nodes.push_front(fused_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AttentionFusion
+
+Fuse the multi-head self attention subgraph exported by frameworks into a single Attention contrib node:
+  for each of Q, K and V: MatMul(X, W) -> Add(B) -> Reshape(0, 0, num_heads, head_size) -> Transpose
+  MatMul(Q, K) -> Div(sqrt(head_size)) -> [Add(mask)] -> Softmax -> MatMul(V) -> Transpose -> Reshape(0, 0, hidden)
+The Q, K and V weights and biases are concatenated into new initializers.
+*/
+class AttentionFusion : public GraphTransformer {
+ public:
+  AttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("AttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/graph/graph_utils.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+// Builds a string that is equal for two nodes if and only if they compute the same values.
+// NodeArg names are unique within a graph, so the inputs are identified by name.
+static std::string GetNodeSignature(const Node& node) {
+  std::string signature = node.OpType();
+  signature += '\n';
+  signature += node.Domain();
+  signature += '\n';
+  signature += node.GetExecutionProviderType();
+  signature += '\n';
+
+  for (const NodeArg* input : node.InputDefs()) {
+    signature += input->Exists() ? input->Name() : "";
+    signature += '\n';
+  }
+
+  // a missing optional output can change what a node computes, so the used outputs are part of the signature
+  for (const NodeArg* output : node.OutputDefs()) {
+    signature += output->Exists() ? '1' : '0';
+  }
+  signature += '\n';
+
+  // sort the attributes by name so that the signature doesn't depend on the order of the map
+  const auto& attributes = node.GetAttributes();
+  std::vector<const std::string*> attr_names;
+  attr_names.reserve(attributes.size());
+  for (const auto& entry : attributes) {
+    attr_names.push_back(&entry.first);
+  }
+  std::sort(attr_names.begin(), attr_names.end(),
+            [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+  for (const std::string* attr_name : attr_names) {
+    signature += attributes.at(*attr_name).SerializeAsString();
+    signature += '\n';
+  }
+
+  return signature;
+}
+
+// Checks that the consumers of duplicate can be connected to the outputs of original instead.
+static bool CanReplaceOutputs(const Graph& graph, const Node& original, const Node& duplicate) {
+  // the names of graph outputs have to be preserved
+  if (graph.IsNodeOutputsInGraphOutputs(duplicate)) {
+    return false;
+  }
+
+  const auto& original_outputs = original.OutputDefs();
+  const auto& duplicate_outputs = duplicate.OutputDefs();
+  for (size_t i = 0; i < duplicate_outputs.size(); ++i) {
+    if (duplicate_outputs[i]->Exists() && original_outputs[i]->Type() != duplicate_outputs[i]->Type()) {
+      return false;
+    }
+  }
+
+  // be conservative with implicit inputs of subgraphs, as renaming them would require updating the subgraphs
+  for (auto it = duplicate.OutputEdgesBegin(); it != duplicate.OutputEdgesEnd(); ++it) {
+    if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status CommonSubexpressionElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::unordered_map<std::string, NodeIndex> equivalent_nodes;
+
+  for (NodeIndex i : order) {
+    auto* node = graph.GetNode(i);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    // Nodes from custom domains may have side effects, and nodes that include subgraphs (control flow operators,
+    // such as If/Loop/Scan) or consume implicit inputs are not merged. Individual nodes in the subgraphs are
+    // processed by the Recurse call above.
+    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) ||
+        excluded_op_types_.find(node->OpType()) != excluded_op_types_.end() ||
+        !(graph_utils::MatchesOpSetDomain(*node, kOnnxDomain) || graph_utils::MatchesOpSetDomain(*node, kMSDomain)) ||
+        node->ContainsSubgraph() ||
+        !node->ImplicitInputDefs().empty()) {
+      continue;
+    }
+
+    auto result = equivalent_nodes.emplace(GetNodeSignature(*node), node->Index());
+    if (result.second) {
+      continue;
+    }
+
+    const Node& original = *graph.GetNode(result.first->second);
+    if (!CanReplaceOutputs(graph, original, *node)) {
+      continue;
+    }
+
+    // Move the output edges of the duplicate to the original node, which also updates the inputs of the consumers.
+    std::vector<Node::EdgeEnd> output_edges(node->OutputEdgesBegin(), node->OutputEdgesEnd());
+    for (const auto& edge : output_edges) {
+      graph.RemoveEdge(node->Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+      graph.AddEdge(original.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    }
+
+    graph.RemoveNode(node->Index());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
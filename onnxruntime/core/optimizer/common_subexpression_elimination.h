@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class CommonSubexpressionElimination
+
+Transformer that traverses the graph top-down and merges equivalent nodes, i.e., nodes with the same op type,
+domain, attributes and inputs. The consumers of a duplicate node are connected to the outputs of the first
+equivalent node and the duplicate is removed. As the graph is traversed in topological order, whole chains of
+duplicated nodes (e.g. Shape -> Gather -> Unsqueeze) are merged in a single pass.
+*/
+class CommonSubexpressionElimination : public GraphTransformer {
+ public:
+  CommonSubexpressionElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("CommonSubexpressionElimination", compatible_execution_providers) {}
+
+ private:
+  /** Nodes whose op_type is included in this set are never merged.
+      All non-deterministic operators should be included in this set. */
+  const std::unordered_set<std::string> excluded_op_types_ =
+      {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -11,6 +11,28 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
+constexpr size_t ConstantFolding::kDefaultMaxOutputBytes;
+
+// Size of the tensor described by node_arg, if its type and shape are fully known.
+static bool GetStaticSizeInBytes(const NodeArg& node_arg, size_t& size) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape == nullptr) {
+    return false;
+  }
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_data_type(type->tensor_type().elem_type());
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    tensor_proto.add_dims(dim.dim_value());
+  }
+
+  return utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size).IsOK();
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -39,6 +61,27 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
       continue;
     }
 
+    size_t input_bytes = 0;
+    for (const auto& constant_input : constant_inputs) {
+      size_t size = 0;
+      if (utils::GetSizeInBytesFromTensorProto<0>(*constant_input.second, &size).IsOK()) {
+        input_bytes += size;
+      }
+    }
+
+    // Skip nodes whose inferred output shapes are already known to be over budget without running them.
+    size_t inferred_output_bytes = 0;
+    bool output_sizes_known = true;
+    for (const auto* node_out : node->OutputDefs()) {
+      size_t size = 0;
+      output_sizes_known = output_sizes_known && node_out->Exists() && GetStaticSizeInBytes(*node_out, size);
+      inferred_output_bytes += size;
+    }
+
+    if (output_sizes_known && ExceedsSizeBudget(input_bytes, inferred_output_bytes)) {
+      continue;
+    }
+
     // Create execution frame for executing constant nodes.
     OptimizerExecutionFrame::Info info({node}, constant_inputs);
 
@@ -60,6 +103,17 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level)
     // Go over all output node args and substitute them with the newly computed tensors, which will be
     // added to the graph as initializers.
     ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
+
+    size_t output_bytes = 0;
+    for (const auto& ort_value : fetches) {
+      ORT_ENFORCE(ort_value.IsTensor());
+      output_bytes += ort_value.Get<Tensor>().SizeInBytes();
+    }
+
+    if (ExceedsSizeBudget(input_bytes, output_bytes)) {
+      continue;
+    }
+
     for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
       OrtValue& ort_value = fetches[fetch_idx];
 
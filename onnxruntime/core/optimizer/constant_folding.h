@@ -13,11 +13,18 @@ namespace onnxruntime {
 
 Transformer that traverses the graph top-down and performs constant folding, i.e.,
 it statically computes parts of the graph that rely only on constant initializers.
+
+Nodes whose folded outputs would be larger than both their constant inputs and max_output_bytes are skipped,
+so that e.g. a Tile or Expand of a small constant does not bloat the initializers of the model.
 */
 class ConstantFolding : public GraphTransformer {
  public:
-  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept :
-    GraphTransformer("ConstantFolding", compatible_execution_providers) {}
+  /** Default limit on the size of the outputs of a folded node that grows its inputs. */
+  static constexpr size_t kDefaultMaxOutputBytes = 4 * 1024 * 1024;
+
+  ConstantFolding(const std::unordered_set<std::string>& compatible_execution_providers = {},
+                  size_t max_output_bytes = kDefaultMaxOutputBytes) noexcept :
+    GraphTransformer("ConstantFolding", compatible_execution_providers), max_output_bytes_(max_output_bytes) {}
 
  private:
   /** Constant folding will not be applied to nodes whose op_type is included in this set.
@@ -25,8 +32,15 @@ class ConstantFolding : public GraphTransformer {
   const std::unordered_set<std::string> excluded_op_types_ =
       {"RandomUniform", "RandomNormal", "RandomUniformLike", "RandomNormalLike", "Multinomial"};
 
+  const size_t max_output_bytes_;
+
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
 
+  /** Returns true if outputs of output_bytes are too large to replace inputs of input_bytes with. */
+  bool ExceedsSizeBudget(size_t input_bytes, size_t output_bytes) const {
+    return output_bytes > input_bytes && output_bytes > max_output_bytes_;
+  }
+
   /** Create a TensorProto that has the same value as the given OrtValue
   and the same type and dimensions as the given NodeArg. */
   void BuildTensorProtoForInitializer(const OrtValue& ort_value, const NodeArg& constant_node_arg,
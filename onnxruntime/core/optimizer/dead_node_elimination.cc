@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dead_node_elimination.h"
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Reads the condition of an If node when it is a constant.
+static bool GetConstantCondition(const Graph& graph, const Node& if_node, bool& condition) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, if_node.InputDefs()[0]->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_BOOL) {
+    return false;
+  }
+
+  int64_t size = 1;
+  for (auto dim : tensor_proto->dims()) {
+    size *= dim;
+  }
+  return size == 1 &&
+         utils::UnpackTensor<bool>(*tensor_proto,
+                                   utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().data() : nullptr,
+                                   tensor_proto->raw_data().size(), &condition, 1)
+             .IsOK();
+}
+
+// Replaces an If node with the nodes of the branch taken, hoisted into the graph of the If node. The values of the
+// branch are renamed to keep them unique in the graph, and its outputs become those of the If node. Returns false,
+// leaving the graph as is, if the branch can't be hoisted.
+static bool InlineBranch(Graph& graph, Node& if_node, bool condition) {
+  Graph& branch = *if_node.GetMutableGraphAttribute(condition ? "then_branch" : "else_branch");
+  auto& if_outputs = if_node.MutableOutputDefs();
+  const auto& branch_outputs = branch.GetOutputs();
+  if (!branch.GetInputs().empty() || branch_outputs.size() != if_outputs.size()) {
+    return false;
+  }
+
+  // The values of the branch, as the NodeArgs of the graph they are hoisted into. The outer scope values are the
+  // implicit inputs of the If node, unless an initializer of the branch shadows them.
+  std::unordered_map<std::string, NodeArg*> values;
+  for (auto* implicit_input : if_node.MutableImplicitInputDefs()) {
+    values[implicit_input->Name()] = implicit_input;
+  }
+  std::unordered_set<std::string> branch_values;
+  for (const auto& entry : branch.GetAllInitializedTensors()) {
+    branch_values.insert(entry.first);
+  }
+  for (const auto& branch_node : branch.Nodes()) {
+    // the nodes of a nested subgraph refer to the values of the branch by name, which renaming them would break
+    if (branch_node.ContainsSubgraph()) {
+      return false;
+    }
+    for (const auto* output : branch_node.OutputDefs()) {
+      branch_values.insert(output->Name());
+    }
+  }
+  auto is_known = [&](const NodeArg& value) {
+    return !value.Exists() || branch_values.count(value.Name()) != 0 || values.count(value.Name()) != 0;
+  };
+  for (const auto& branch_node : branch.Nodes()) {
+    for (const auto* input : branch_node.InputDefs()) {
+      if (!is_known(*input)) {
+        return false;
+      }
+    }
+  }
+  for (const auto* output : branch_outputs) {
+    if (!is_known(*output)) {
+      return false;
+    }
+  }
+
+  for (const auto& entry : branch.GetAllInitializedTensors()) {
+    TensorProto tensor(*entry.second);
+    tensor.set_name(graph.GenerateNodeArgName(entry.first));
+    graph.AddInitializedTensor(tensor);
+    const auto* branch_arg = branch.GetNodeArg(entry.first);
+    values[entry.first] = &graph.GetOrCreateNodeArg(tensor.name(),
+                                                     branch_arg != nullptr ? branch_arg->TypeAsProto() : nullptr);
+  }
+
+  // The outputs of the branch produced by its nodes are produced as the outputs of the If node directly. The others,
+  // such as initializers, outer scope values or those output twice, are copied to them by Identity nodes.
+  std::unordered_map<std::string, NodeArg*> produced_outputs;
+  std::vector<size_t> copied_outputs;
+  for (size_t i = 0; i < branch_outputs.size(); ++i) {
+    const auto& name = branch_outputs[i]->Name();
+    if (values.count(name) == 0 && produced_outputs.emplace(name, if_outputs[i]).second) {
+      continue;
+    }
+    copied_outputs.push_back(i);
+  }
+
+  values[""] = &graph.GetOrCreateNodeArg("", nullptr);
+  for (const auto& branch_node : branch.Nodes()) {
+    for (const auto* output : branch_node.OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+      auto produced_output = produced_outputs.find(output->Name());
+      values[output->Name()] = produced_output != produced_outputs.end()
+                                   ? produced_output->second
+                                   : &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name()),
+                                                               output->TypeAsProto());
+    }
+  }
+
+  for (const auto& branch_node : branch.Nodes()) {
+    std::vector<NodeArg*> inputs;
+    for (const auto* input : branch_node.InputDefs()) {
+      inputs.push_back(values[input->Name()]);
+    }
+    std::vector<NodeArg*> outputs;
+    for (const auto* output : branch_node.OutputDefs()) {
+      outputs.push_back(values[output->Name()]);
+    }
+    auto& node = graph.AddNode(graph.GenerateNodeName(branch_node.Name()), branch_node.OpType(),
+                               branch_node.Description(), inputs, outputs, &branch_node.GetAttributes(),
+                               branch_node.Domain());
+    node.SetExecutionProviderType(if_node.GetExecutionProviderType());
+  }
+  for (size_t i : copied_outputs) {
+    auto& node = graph.AddNode(graph.GenerateNodeName(if_node.Name() + "_output"), "Identity", "",
+                               {values[branch_outputs[i]->Name()]}, {if_outputs[i]});
+    node.SetExecutionProviderType(if_node.GetExecutionProviderType());
+  }
+
+  graph_utils::RemoveNodeOutputEdges(graph, if_node);
+  graph.RemoveNode(if_node.Index());
+  return true;
+}
+
+// Checks whether a node has to be kept even if its outputs aren't used.
+static bool MustKeep(const Node& node, const std::unordered_set<std::string>& compatible_execution_providers) {
+  return !graph_utils::IsSupportedProvider(node, compatible_execution_providers) || node.OutputDefs().empty() ||
+         !(graph_utils::MatchesOpSetDomain(node, kOnnxDomain) || graph_utils::MatchesOpSetDomain(node, kMLDomain) ||
+           graph_utils::MatchesOpSetDomain(node, kMSDomain));
+}
+
+Status DeadNodeElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (NodeIndex i : order) {
+    auto* node = graph.GetNode(i);
+    if (!node) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    bool condition = false;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "If", {1, 11}) &&
+        graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders()) &&
+        GetConstantCondition(graph, *node, condition) && InlineBranch(graph, *node, condition)) {
+      modified = true;
+    }
+  }
+
+  // Walk back from the outputs of the graph to find the nodes and values they depend on. The values of the nodes are
+  // found by name, as the nodes hoisted from the branches of If nodes aren't connected by edges yet.
+  std::unordered_map<std::string, Node*> producers;
+  for (auto& node : graph.Nodes()) {
+    for (const auto* output : node.OutputDefs()) {
+      if (output->Exists()) {
+        producers[output->Name()] = &node;
+      }
+    }
+  }
+
+  std::unordered_set<std::string> used_values;
+  std::unordered_set<NodeIndex> live_nodes;
+  std::vector<Node*> nodes_to_visit;
+  auto use_value = [&](const NodeArg& value) {
+    if (value.Exists() && used_values.insert(value.Name()).second) {
+      auto producer = producers.find(value.Name());
+      if (producer != producers.end()) {
+        nodes_to_visit.push_back(producer->second);
+      }
+    }
+  };
+
+  for (const auto* output : graph.GetOutputs()) {
+    use_value(*output);
+  }
+  for (auto& node : graph.Nodes()) {
+    if (MustKeep(node, GetCompatibleExecutionProviders())) {
+      nodes_to_visit.push_back(&node);
+    }
+  }
+  while (!nodes_to_visit.empty()) {
+    Node* node = nodes_to_visit.back();
+    nodes_to_visit.pop_back();
+    if (!live_nodes.insert(node->Index()).second) {
+      continue;
+    }
+    for (const auto* input : node->InputDefs()) {
+      use_value(*input);
+    }
+    for (const auto* input : node->ImplicitInputDefs()) {
+      use_value(*input);
+    }
+  }
+
+  std::vector<NodeIndex> dead_nodes;
+  for (const auto& node : graph.Nodes()) {
+    if (live_nodes.count(node.Index()) == 0) {
+      dead_nodes.push_back(node.Index());
+    }
+  }
+  // the consumers of a dead node are dead as well, so its output edges can be removed in any order
+  for (NodeIndex index : dead_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *graph.GetNode(index));
+    graph.RemoveNode(index);
+    modified = true;
+  }
+
+  // The outputs that aren't used are left out where the operator allows it, by replacing them with an empty name.
+  for (auto& node : graph.Nodes()) {
+    if (node.Op() == nullptr || !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+    const auto& formal_outputs = node.Op()->outputs();
+    auto& outputs = node.MutableOutputDefs();
+    for (size_t i = 0; i < outputs.size() && i < formal_outputs.size(); ++i) {
+      if (outputs[i]->Exists() && used_values.count(outputs[i]->Name()) == 0 &&
+          formal_outputs[i].GetOption() == OpSchema::Optional) {
+        outputs[i] = &graph.GetOrCreateNodeArg("", nullptr);
+        modified = true;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
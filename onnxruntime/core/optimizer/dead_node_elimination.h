@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class DeadNodeElimination
+
+Transformer that removes the nodes whose outputs don't reach the outputs of the graph, and the outputs of the
+remaining nodes that aren't used when their operator marks them as optional, so that the kernels can skip computing
+them (e.g. the indices of a MaxPool or the mask of a Dropout). Required outputs that aren't used, such as the extra
+outputs of a Split, are left as the kernels have to produce them.
+
+If nodes whose condition is a constant are replaced with the nodes of the branch taken, which are hoisted into the
+graph of the If node.
+
+Nodes from custom domains may have side effects and are never removed.
+*/
+class DeadNodeElimination : public GraphTransformer {
+ public:
+  DeadNodeElimination(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DeadNodeElimination", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
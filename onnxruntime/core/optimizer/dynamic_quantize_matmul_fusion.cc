@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the input of a binary node that isn't `known`, or nullptr if `known` isn't an input of the node.
+static NodeArg* GetOtherInput(Node& node, const NodeArg* known) {
+  auto& input_defs = node.MutableInputDefs();
+  if (input_defs[0] == known) {
+    return input_defs[1];
+  }
+  return input_defs[1] == known ? input_defs[0] : nullptr;
+}
+
+// Returns the producer of input input_index of node if it has the given op type and version and is assigned to
+// the same execution provider. The producer may have other consumers.
+static Node* GetProducer(Graph& graph, const Node& node, int input_index, const std::string& op_type,
+                         const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    const Node& input_node = it->GetNode();
+    if (it->GetDstArgIndex() == input_index &&
+        graph_utils::IsSupportedOptypeVersionAndDomain(input_node, op_type, versions) &&
+        input_node.GetExecutionProviderType() == node.GetExecutionProviderType()) {
+      return graph.GetNode(input_node.Index());
+    }
+  }
+  return nullptr;
+}
+
+// Returns the constant 1D float initializer of N elements added by add_node to the output of node, or nullptr.
+static NodeArg* GetBias(Graph& graph, Node& add_node, const Node& node, const TensorShapeProto& b_shape) {
+  NodeArg* bias = GetOtherInput(add_node, node.OutputDefs()[0]);
+  const auto* bias_tensor = bias == nullptr ? nullptr : graph_utils::GetConstantInitializer(graph, bias->Name());
+  if (bias_tensor == nullptr || bias_tensor->data_type() != TensorProto_DataType_FLOAT ||
+      bias_tensor->dims_size() != 1 || b_shape.dim_size() != 2 || !b_shape.dim(1).has_dim_value() ||
+      bias_tensor->dims(0) != b_shape.dim(1).dim_value()) {
+    return nullptr;
+  }
+  return bias;
+}
+
+Status DynamicQuantizeMatMulFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulInteger", {10}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // A is dynamically quantized and its zero point is that of MatMulInteger
+    auto& matmul_inputs = node.MutableInputDefs();
+    Node* quantize_node = GetProducer(graph, node, 0, "DynamicQuantizeLinear", {11});
+    if (quantize_node == nullptr || matmul_inputs.size() < 3 ||
+        matmul_inputs[0] != quantize_node->OutputDefs()[0] || matmul_inputs[2] != quantize_node->OutputDefs()[2] ||
+        graph.IsNodeOutputsInGraphOutputs(*quantize_node)) {
+      continue;
+    }
+
+    // the CPU kernel takes a uint8 B
+    const auto* b_type = matmul_inputs[1]->Type();
+    if (b_type == nullptr || *b_type != "tensor(uint8)") {
+      continue;
+    }
+
+    Node* cast_node = optimizer_utils::GetOnlyChildNode(graph, node, "Cast", {6, 9});
+    const auto* to = cast_node == nullptr ? nullptr : graph_utils::GetNodeAttribute(*cast_node, "to");
+    if (to == nullptr || to->i() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    Node* mul_node = optimizer_utils::GetOnlyChildNode(graph, *cast_node, "Mul", {7});
+    NodeArg* scale = mul_node == nullptr ? nullptr : GetOtherInput(*mul_node, cast_node->OutputDefs()[0]);
+    if (scale == nullptr) {
+      continue;
+    }
+
+    // the scale of the product is Mul(A scale, B scale), consumed by the Mul only
+    Node* scale_node = nullptr;
+    for (auto it = mul_node->InputNodesBegin(); it != mul_node->InputNodesEnd(); ++it) {
+      if (it->OutputDefs()[0] == scale) {
+        scale_node = graph.GetNode(it->Index());
+      }
+    }
+    if (scale_node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*scale_node, "Mul", {7}) ||
+        optimizer_utils::GetOnlyChildNode(graph, *scale_node, "Mul", {7}) != mul_node) {
+      continue;
+    }
+    NodeArg* b_scale = GetOtherInput(*scale_node, quantize_node->OutputDefs()[1]);
+    float b_scale_value;
+    if (b_scale == nullptr || !optimizer_utils::GetScalarInitializerValue(graph, *b_scale, b_scale_value)) {
+      continue;
+    }
+
+    // the outputs of DynamicQuantizeLinear are only used by the fused nodes
+    if (quantize_node->GetOutputEdgesCount() != 3) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs{quantize_node->MutableInputDefs()[0], matmul_inputs[1], b_scale};
+    NodeArg* b_zero_point = matmul_inputs.size() > 3 ? matmul_inputs[3] : nullptr;
+
+    Node* last_node = mul_node;
+    Node* add_node = optimizer_utils::GetOnlyChildNode(graph, *mul_node, "Add", {7});
+    NodeArg* bias = nullptr;
+    if (add_node != nullptr && matmul_inputs[1]->Shape() != nullptr) {
+      bias = GetBias(graph, *add_node, *mul_node, *matmul_inputs[1]->Shape());
+    }
+    if (bias != nullptr) {
+      fused_inputs.push_back(b_zero_point != nullptr ? b_zero_point : &graph.GetOrCreateNodeArg("", nullptr));
+      fused_inputs.push_back(bias);
+      last_node = add_node;
+    } else if (b_zero_point != nullptr) {
+      fused_inputs.push_back(b_zero_point);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("DynamicQuantizeMatMul"),
+                                     "DynamicQuantizeMatMul",
+                                     "fused DynamicQuantizeLinear, MatMulInteger, Cast and Mul",
+                                     fused_inputs,
+                                     last_node->MutableOutputDefs(), nullptr, kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (Node* fused : {quantize_node, scale_node, &node, cast_node, mul_node}) {
+      removed_nodes.push_front(fused->Index());
+    }
+    if (last_node == add_node) {
+      removed_nodes.push_front(add_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeMatMulFusion
+
+Fuse the dynamic quantization of a MatMul into a single DynamicQuantizeMatMul contrib node:
+  DynamicQuantizeLinear(A) -> MatMulInteger(B) -> Cast(float) -> Mul(Mul(A scale, B scale)), optionally followed by
+  the Add of a 1D bias, becomes DynamicQuantizeMatMul(A, B, B scale, B zero point, bias).
+B has to be uint8 and its scale a constant scalar, as for the CPU kernel.
+*/
+class DynamicQuantizeMatMulFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeMatMulFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeMatMulFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
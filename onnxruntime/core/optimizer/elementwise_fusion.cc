@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// An op of the chain. operand_index is the input of a binary op that isn't the chain value, or -1.
+struct ChainOp {
+  Node* node;
+  int operand_index;
+};
+
+}  // namespace
+
+static bool IsFusableOp(const Node& node, bool& is_binary) {
+  const auto* type = node.OutputDefs()[0]->Type();
+  if (type == nullptr || *type != "tensor(float)") {
+    return false;
+  }
+
+  is_binary = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7}) ||
+              graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7});
+  return is_binary ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6});
+}
+
+// Checks whether the FusedElementwise kernel can broadcast an input of operand_shape to shape: either the shapes
+// are the same, the operand has a single element, or it has the shape (..., 1, D) of the last dimension.
+static bool CanBroadcastOperand(const TensorShapeProto* operand_shape, const TensorShapeProto& shape) {
+  if (operand_shape == nullptr || operand_shape->dim_size() > shape.dim_size()) {
+    return false;
+  }
+  if (optimizer_utils::IsSameShape(operand_shape, &shape)) {
+    return true;
+  }
+
+  const int rank = operand_shape->dim_size();
+  for (int i = 0; i < rank - 1; ++i) {
+    const auto& dim = operand_shape->dim(i);
+    if (!dim.has_dim_value() || dim.dim_value() != 1) {
+      return false;
+    }
+  }
+
+  if (rank == 0) {
+    return true;
+  }
+  const auto& last_dim = operand_shape->dim(rank - 1);
+  return (last_dim.has_dim_value() && last_dim.dim_value() == 1) ||
+         optimizer_utils::IsSameDim(last_dim, shape.dim(shape.dim_size() - 1));
+}
+
+// Checks whether node can be part of a chain of the given shape that computes value.
+static bool MatchChainOp(Node& node, const NodeArg* value, const TensorShapeProto& shape, ChainOp& op) {
+  bool is_binary = false;
+  if (!IsFusableOp(node, is_binary) || !optimizer_utils::IsSameShape(node.OutputDefs()[0]->Shape(), &shape)) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  op.node = &node;
+  if (!is_binary) {
+    op.operand_index = -1;
+    return input_defs[0] == value;
+  }
+
+  // x * x can't be expressed with a separate operand
+  if (input_defs[0] == value && input_defs[1] != value) {
+    op.operand_index = 1;
+  } else if (input_defs[1] == value && input_defs[0] != value) {
+    op.operand_index = 0;
+  } else {
+    return false;
+  }
+
+  return CanBroadcastOperand(input_defs[op.operand_index]->Shape(), shape);
+}
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::unordered_set<onnxruntime::NodeIndex> fused_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        fused_nodes.find(node_index) != fused_nodes.end()) {
+      continue;
+    }
+
+    const auto* shape = node.OutputDefs()[0]->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    // The chain starts from the input that has the shape of the output.
+    auto& input_defs = node.MutableInputDefs();
+    NodeArg* chain_input = input_defs[0];
+    if (input_defs.size() == 2 && !optimizer_utils::IsSameShape(chain_input->Shape(), shape)) {
+      chain_input = input_defs[1];
+    }
+
+    ChainOp first_op;
+    if (!optimizer_utils::IsSameShape(chain_input->Shape(), shape) ||
+        !MatchChainOp(node, chain_input, *shape, first_op)) {
+      continue;
+    }
+
+    std::vector<ChainOp> chain{first_op};
+    Node* last_node = &node;
+    while (last_node->GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(*last_node)) {
+      Node& next_node = *graph.GetNode(last_node->OutputNodesBegin()->Index());
+      ChainOp op;
+      // a node can't be in two chains, e.g. when two chains meet at a binary op
+      if (fused_nodes.count(next_node.Index()) != 0 ||
+          next_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          !MatchChainOp(next_node, last_node->OutputDefs()[0], *shape, op)) {
+        break;
+      }
+      chain.push_back(op);
+      last_node = &next_node;
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    std::vector<NodeArg*> fused_inputs{chain_input};
+    std::vector<std::string> ops;
+    std::vector<int64_t> operand_first;
+    for (const auto& op : chain) {
+      ops.push_back(op.node->OpType());
+      if (op.operand_index >= 0) {
+        fused_inputs.push_back(op.node->MutableInputDefs()[op.operand_index]);
+        operand_first.push_back(op.operand_index == 0 ? 1 : 0);
+      }
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused elementwise ops",
+                                     fused_inputs,
+                                     last_node->MutableOutputDefs(), nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    if (!operand_first.empty()) {
+      fused_node.AddAttribute("operand_first", operand_first);
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (const auto& op : chain) {
+      removed_nodes.push_front(op.node->Index());
+      fused_nodes.insert(op.node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
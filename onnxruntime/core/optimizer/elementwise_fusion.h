@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Fuse chains of float elementwise ops, e.g. Add -> Mul -> Relu -> Sub, into a single FusedElementwise contrib
+node that evaluates the whole chain in one pass over memory. Each op of the chain must produce the shape of the
+chain input and be the only consumer of the previous op. The other input of a binary op must have the same
+shape, a single element, or the size of the last dimension.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
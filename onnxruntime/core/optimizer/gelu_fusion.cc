@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the input of a binary node that isn't `known`, or nullptr if `known` isn't an input of the node.
+static const NodeArg* GetOtherInput(const Node& node, const NodeArg* known) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs[0] == known) {
+    return input_defs[1];
+  }
+  return input_defs[1] == known ? input_defs[0] : nullptr;
+}
+
+// Matches the tail 0.5 * x * (1 + f) that is common to both forms, starting at the consumer of the node that
+// computes f. The matched nodes are appended to nodes in topological order and the last one is returned.
+static Node* MatchGeluTail(Graph& graph, const Node& f_node, const NodeArg* x, std::vector<Node*>& nodes) {
+  Node* add_node = optimizer_utils::GetOnlyChildNode(graph, f_node, "Add", {7});
+  const NodeArg* one = add_node == nullptr ? nullptr : GetOtherInput(*add_node, f_node.OutputDefs()[0]);
+  if (one == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *one, 1.0f)) {
+    return nullptr;
+  }
+  nodes.push_back(add_node);
+
+  Node* mul_node = optimizer_utils::GetOnlyChildNode(graph, *add_node, "Mul", {7});
+  const NodeArg* other = mul_node == nullptr ? nullptr : GetOtherInput(*mul_node, add_node->OutputDefs()[0]);
+  if (other == nullptr) {
+    return nullptr;
+  }
+
+  if (other == x) {
+    // (x * (1 + f)) * 0.5
+    nodes.push_back(mul_node);
+    Node* half_node = optimizer_utils::GetOnlyChildNode(graph, *mul_node, "Mul", {7});
+    const NodeArg* half = half_node == nullptr ? nullptr : GetOtherInput(*half_node, mul_node->OutputDefs()[0]);
+    if (half == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *half, 0.5f)) {
+      return nullptr;
+    }
+    nodes.push_back(half_node);
+    return half_node;
+  }
+
+  // (x * 0.5) * (1 + f)
+  for (auto it = mul_node->InputNodesBegin(); it != mul_node->InputNodesEnd(); ++it) {
+    const Node& half_node = *it;
+    if (half_node.OutputDefs()[0] != other) {
+      continue;
+    }
+
+    const NodeArg* half = GetOtherInput(half_node, x);
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(half_node, "Mul", {7}) ||
+        half_node.GetExecutionProviderType() != mul_node->GetExecutionProviderType() ||
+        optimizer_utils::GetOnlyChildNode(graph, half_node, "Mul", {7}) != mul_node ||
+        half == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *half, 0.5f)) {
+      return nullptr;
+    }
+
+    nodes.push_back(graph.GetNode(half_node.Index()));
+    nodes.push_back(mul_node);
+    return mul_node;
+  }
+
+  return nullptr;
+}
+
+// Matches Div(x, sqrt(2)) -> Erf -> tail.
+static Node* MatchGelu(Graph& graph, Node& div_node, std::vector<Node*>& nodes) {
+  const NodeArg* x = div_node.InputDefs()[0];
+  if (!optimizer_utils::IsScalarInitializerWithValue(graph, *div_node.InputDefs()[1], 1.4142135623730951f)) {
+    return nullptr;
+  }
+  nodes.push_back(&div_node);
+
+  Node* erf_node = optimizer_utils::GetOnlyChildNode(graph, div_node, "Erf", {9});
+  if (erf_node == nullptr) {
+    return nullptr;
+  }
+  nodes.push_back(erf_node);
+
+  return MatchGeluTail(graph, *erf_node, x, nodes);
+}
+
+// Matches Pow(x, 3) -> Mul(0.044715) -> Add(x) -> Mul(sqrt(2 / pi)) -> Tanh -> tail.
+static Node* MatchFastGelu(Graph& graph, Node& pow_node, std::vector<Node*>& nodes) {
+  const NodeArg* x = pow_node.InputDefs()[0];
+  if (!optimizer_utils::IsScalarInitializerWithValue(graph, *pow_node.InputDefs()[1], 3.0f)) {
+    return nullptr;
+  }
+  nodes.push_back(&pow_node);
+
+  Node* cube_mul_node = optimizer_utils::GetOnlyChildNode(graph, pow_node, "Mul", {7});
+  const NodeArg* beta = cube_mul_node == nullptr ? nullptr
+                                                 : GetOtherInput(*cube_mul_node, pow_node.OutputDefs()[0]);
+  if (beta == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *beta, 0.044715f)) {
+    return nullptr;
+  }
+  nodes.push_back(cube_mul_node);
+
+  Node* add_node = optimizer_utils::GetOnlyChildNode(graph, *cube_mul_node, "Add", {7});
+  if (add_node == nullptr || GetOtherInput(*add_node, cube_mul_node->OutputDefs()[0]) != x) {
+    return nullptr;
+  }
+  nodes.push_back(add_node);
+
+  Node* alpha_mul_node = optimizer_utils::GetOnlyChildNode(graph, *add_node, "Mul", {7});
+  const NodeArg* alpha = alpha_mul_node == nullptr ? nullptr
+                                                   : GetOtherInput(*alpha_mul_node, add_node->OutputDefs()[0]);
+  if (alpha == nullptr || !optimizer_utils::IsScalarInitializerWithValue(graph, *alpha, 0.7978845608028654f)) {
+    return nullptr;
+  }
+  nodes.push_back(alpha_mul_node);
+
+  Node* tanh_node = optimizer_utils::GetOnlyChildNode(graph, *alpha_mul_node, "Tanh", {6});
+  if (tanh_node == nullptr) {
+    return nullptr;
+  }
+  nodes.push_back(tanh_node);
+
+  return MatchGeluTail(graph, *tanh_node, x, nodes);
+}
+
+Status GeluFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // The CPU kernels are only implemented for float.
+    const auto* input_type = node.InputDefs()[0]->Type();
+    if (input_type == nullptr) {
+      continue;
+    }
+    const bool is_cuda_type = *input_type == "tensor(float16)" || *input_type == "tensor(double)";
+    if (*input_type != "tensor(float)" &&
+        !(is_cuda_type && node.GetExecutionProviderType() == kCudaExecutionProvider)) {
+      continue;
+    }
+
+    std::vector<Node*> nodes;
+    Node* last_node = nullptr;
+    std::string op_type;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7})) {
+      last_node = MatchGelu(graph, node, nodes);
+      op_type = "Gelu";
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pow", {7})) {
+      last_node = MatchFastGelu(graph, node, nodes);
+      op_type = "FastGelu";
+    }
+
+    if (last_node == nullptr) {
+      continue;
+    }
+
+    Node& gelu_node = graph.AddNode(graph.GenerateNodeName(op_type),
+                                    op_type,
+                                    "fused " + op_type + " subgraph",
+                                    {node.MutableInputDefs()[0]},
+                                    last_node->MutableOutputDefs(), nullptr, kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    gelu_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (Node* fused_node : nodes) {
+      removed_nodes.push_front(fused_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
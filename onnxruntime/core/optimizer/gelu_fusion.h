@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GeluFusion
+
+Fuse the elementwise expansions of GELU into a single contrib node:
+  Div(sqrt(2)) -> Erf -> Add(1) -> Mul(x) -> Mul(0.5) becomes Gelu, and
+  Pow(3) -> Mul(0.044715) -> Add(x) -> Mul(sqrt(2 / pi)) -> Tanh -> Add(1) -> Mul(x) -> Mul(0.5) becomes FastGelu.
+The scaling by 0.5 may also be applied to x before the multiplication.
+*/
+class GeluFusion : public GraphTransformer {
+ public:
+  GeluFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GeluFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
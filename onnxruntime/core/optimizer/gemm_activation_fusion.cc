@@ -15,7 +15,10 @@ bool IsFusableActivation(const Node& node) {
   return graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
          graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
-         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6});
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         // the CUDA FusedGemm applies it in the epilogue of the GEMM, the CPU one has no FastGelu
+         (graph_utils::IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) &&
+          node.GetExecutionProviderType() == kCudaExecutionProvider);
 }
 
 void HandleActivationNodeEdges(Graph& g, const Node& act, Node& fused_gemm) {
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gemm_add_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Adds the values as a new initializer, so that the one they were computed from is left as is for its other users.
+static NodeArg& AddInitializer(Graph& graph, const std::string& base_name, const Initializer& values) {
+  TensorProto tensor;
+  values.ToProto(&tensor);
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(tensor.data_type());
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : tensor.dims()) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(tensor.name(), &type);
+}
+
+// Checks whether values broadcast to dims by repeating them along the last axis: they are a single value, a row
+// or already have the dims.
+static bool BroadcastsAlongLastAxis(const Initializer& values, const std::vector<int64_t>& dims) {
+  const auto& values_dims = values.dims();
+  return values.size() == 1 || values_dims == dims ||
+         (!values_dims.empty() && values_dims.size() <= dims.size() && values_dims.back() == dims.back() &&
+          values.size() == values_dims.back());
+}
+
+// Returns the values broadcast to dims, which BroadcastsAlongLastAxis has to allow.
+static std::unique_ptr<Initializer> Broadcast(const Initializer& values, const std::vector<int64_t>& dims) {
+  if (values.dims() == dims) {
+    return std::make_unique<Initializer>(values);
+  }
+  auto result = std::make_unique<Initializer>(static_cast<TensorProto_DataType>(values.data_type()), "", dims);
+  result->add(1.0f).scale_by_last_axis(values);
+  return result;
+}
+
+Status GemmAddFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  auto& gemm_node = node;
+  const auto& add_node = *gemm_node.OutputNodesBegin();
+  const auto& gemm_inputs = gemm_node.InputDefs();
+  const int bias_index = gemm_node.OutputEdgesBegin()->GetDstArgIndex() == 0 ? 1 : 0;
+
+  const auto* C_tensor_proto = graph_utils::GetConstantInitializer(graph, gemm_inputs[2]->Name());
+  ORT_ENFORCE(C_tensor_proto);
+
+  const auto* bias_tensor_proto = graph_utils::GetConstantInitializer(graph, add_node.InputDefs()[bias_index]->Name());
+  ORT_ENFORCE(bias_tensor_proto);
+
+  if (!Initializer::IsSupportedDataType(C_tensor_proto) ||
+      C_tensor_proto->data_type() != bias_tensor_proto->data_type()) {
+    return Status::OK();
+  }
+
+  // The new C is broadcast to the output as the bias of the Add is, which it must not broadcast to a higher rank.
+  if (!optimizer_utils::IsSameShape(add_node.OutputDefs()[0]->Shape(), gemm_node.OutputDefs()[0]->Shape())) {
+    return Status::OK();
+  }
+
+  // Calculate beta * C + bias, in the shape of whichever of the two the other broadcasts to.
+  auto C = std::make_unique<Initializer>(C_tensor_proto);
+  auto bias = std::make_unique<Initializer>(bias_tensor_proto);
+  std::vector<int64_t> dims;
+  if (BroadcastsAlongLastAxis(*C, bias->dims())) {
+    dims = bias->dims();
+  } else if (BroadcastsAlongLastAxis(*bias, C->dims())) {
+    dims = C->dims();
+  } else {
+    return Status::OK();
+  }
+
+  const auto* beta_attr = graph_utils::GetNodeAttribute(gemm_node, "beta");
+  Initializer beta(static_cast<TensorProto_DataType>(C->data_type()), "", {});
+  beta.add(beta_attr != nullptr ? beta_attr->f() : 1.0f);
+
+  auto new_C = Broadcast(*C, dims);
+  new_C->scale_by_last_axis(beta);
+  new_C->add(*Broadcast(*bias, dims));
+
+  // Remove the Add node, then replace C with the one including the bias.
+  auto* add_node_to_remove = graph.GetNode(add_node.Index());
+  if (graph_utils::RemoveNode(graph, *add_node_to_remove)) {
+    gemm_node.MutableInputDefs()[2] = &AddInitializer(graph, gemm_inputs[2]->Name(), *new_C);
+    gemm_node.ClearAttribute("beta");
+    gemm_node.AddAttribute("beta", 1.0f);
+
+    rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+  }
+
+  return Status::OK();
+}
+
+bool GemmAddFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9}) ||
+      node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+
+  const auto& next_node = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Add", {7}) ||
+      next_node.GetInputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(next_node) ||
+      // Make sure the two nodes do not span execution providers.
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // Check that C and the bias added to the output are constants.
+  const int bias_index = node.OutputEdgesBegin()->GetDstArgIndex() == 0 ? 1 : 0;
+  if (!graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[2]) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[bias_index])) {
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmAddFusion
+
+Rewrite rule that folds an Add of a constant following a Gemm into the constant C of the Gemm.
+
+It is attempted to be triggered only on nodes with op type "Gemm".
+*/
+class GemmAddFusion : public RewriteRule {
+ public:
+  GemmAddFusion() noexcept : RewriteRule("GemmAddFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Gemm"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
@@ -8,7 +8,9 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
-common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level) const {
+common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level,
+                                                         profiling::Profiler* profiler,
+                                                         OptimizationReport* report) const {
   const auto& transformers = level_to_transformer_map_.find(level);
   if (transformers == level_to_transformer_map_.end()) {
     return Status::OK();
@@ -18,7 +20,19 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     bool graph_changed = false;
     for (const auto& transformer : transformers->second) {
       bool modified = false;
+      const bool record_event = profiler != nullptr && profiler->IsEnabled();
+      const int node_count_before = record_event ? graph.NumberOfNodes() : 0;
+      auto tp = record_event ? profiler->StartTime() : TimePoint{};
+      if (report != nullptr) report->BeforeApply(graph);
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified));
+      if (report != nullptr) report->AfterApply(*transformer, static_cast<int>(level), graph, modified);
+      if (record_event) {
+        profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer->Name(), tp,
+                                        {{"level", std::to_string(static_cast<int>(level))},
+                                         {"step", std::to_string(step)},
+                                         {"node_count_before", std::to_string(node_count_before)},
+                                         {"node_count_after", std::to_string(graph.NumberOfNodes())}});
+      }
       graph_changed = graph_changed || modified;
     }
     if (!graph_changed) {
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "core/common/profiler.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/optimization_report.h"
 #include "core/optimizer/rewrite_rule.h"
 
 namespace onnxruntime {
@@ -19,8 +21,12 @@ class GraphTransformerManager {
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);  
 
-  // Apply all transformers registered for the given level on the given graph
-  common::Status ApplyTransformers(Graph& graph, TransformerLevel level) const;
+  // Apply all transformers registered for the given level on the given graph.
+  // If profiler is enabled, each application of a transformer is recorded as an event with the node counts.
+  // If report is given, each application of a transformer is recorded in it.
+  common::Status ApplyTransformers(Graph& graph, TransformerLevel level,
+                                   profiling::Profiler* profiler = nullptr,
+                                   OptimizationReport* report = nullptr) const;
 
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformerManager);  
@@ -7,17 +7,33 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
+#include "core/optimizer/matmul_mul_fusion.h"
+#include "core/optimizer/gemm_add_fusion.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/dead_node_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
+#include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/matmul_scale_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/ml_preprocessing_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/relu_clip_fusion.h"
+#include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/shape_to_initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/nhwc_transformer.h"
 #include "core/optimizer/free_dim_override_transformer.h"
+#include "core/optimizer/qdq_fusion.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/inference_session.h"
 
@@ -37,8 +53,10 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
       rules.push_back(std::make_unique<EliminateIdentity>());
       rules.push_back(std::make_unique<EliminateSlice>());
       rules.push_back(std::make_unique<UnsqueezeElimination>());
+      rules.push_back(std::make_unique<ReshapeFusion>());
       rules.push_back(std::make_unique<EliminateDropout>());
       rules.push_back(std::make_unique<FuseReluClip>());
+      rules.push_back(std::make_unique<PadFusion>());
       rules.push_back(std::make_unique<ShapeToInitializer>());
       break;
 
@@ -46,6 +64,8 @@ std::vector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(TransformerLevel
       rules.push_back(std::make_unique<ConvAddFusion>());
       rules.push_back(std::make_unique<ConvMulFusion>());
       rules.push_back(std::make_unique<ConvBNFusion>());
+      rules.push_back(std::make_unique<MatMulMulFusion>());
+      rules.push_back(std::make_unique<GemmAddFusion>());
       break;
 
     case TransformerLevel::Level3:
@@ -98,6 +118,8 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       std::unordered_set<std::string> l1_execution_providers = {};
 
       transformers.emplace_back(std::make_unique<ConstantFolding>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<CommonSubexpressionElimination>(l1_execution_providers));
+      transformers.emplace_back(std::make_unique<DeadNodeElimination>(l1_execution_providers));
       transformers.emplace_back(std::make_unique<FreeDimensionOverrideTransformer>(free_dimension_overrides));
 
       rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l1_execution_providers);
@@ -105,20 +127,35 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
 
     case TransformerLevel::Level2: {
       std::unordered_set<std::string> l2_execution_providers = {onnxruntime::kCpuExecutionProvider};
+      // fusions whose contrib kernels are implemented by the CUDA execution provider as well
+      std::unordered_set<std::string> cpu_cuda_execution_providers = {onnxruntime::kCpuExecutionProvider,
+                                                                      onnxruntime::kCudaExecutionProvider};
 
       // create rule based transformer consisting of all the level2 rewrite rules
       rule_transformer = GenerateRuleBasedGraphTransformer(level, transformers_and_rules_to_enable, l2_execution_providers);
 
       // create standalone transformers
+      transformers.emplace_back(std::make_unique<QDQFusion>(l2_execution_providers));
 #ifndef DISABLE_CONTRIB_OPS
-      transformers.emplace_back(std::make_unique<GemmActivationFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_cuda_execution_providers));
       transformers.emplace_back(std::make_unique<MatMulAddFusion>(l2_execution_providers));
-      transformers.emplace_back(std::make_unique<ConvActivationFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<LayerNormFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<GeluFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<AttentionFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<MatMulTransposeFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<MatMulScaleFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_cuda_execution_providers));
+      transformers.emplace_back(std::make_unique<MLPreprocessingFusion>(l2_execution_providers));
+      transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(l2_execution_providers));
 #endif
     } break;
 
     case TransformerLevel::Level3: {
 #ifndef DISABLE_CONTRIB_OPS
+      // Runs first so that the convolutions between NHWC transposes keep the NHWC layout rather than NCHWc.
+      transformers.emplace_back(std::make_unique<NhwcTransformer>());
+
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
         transformers.emplace_back(std::make_unique<NchwcTransformer>());
@@ -456,6 +456,49 @@ class Initializer final {
     }
   }
 
+  // Multiplies the values along the last axis by those of other, like the columns of a matrix by a row vector.
+  // other has as many values as the last dimension, or a single one.
+  inline void scale_by_last_axis(const Initializer& other) {
+    const int64_t num = dims_.empty() ? 1 : dims_.back();
+    const bool is_scalar = other.size() == 1;
+    int64_t n = num == 0 ? 0 : size() / num;
+    switch (data_type_) {
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16: {
+        uint16_t* dst = data<uint16_t>();
+        const uint16_t* src = other.data<uint16_t>();
+        for (int64_t i = 0; i < n; i++) {
+          for (int64_t j = 0; j < num; j++) {
+            auto k = i * num + j;
+            dst[k] = math::floatToHalf(math::halfToFloat(dst[k]) * math::halfToFloat(src[is_scalar ? 0 : j]));
+          }
+        }
+        break;
+      }
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
+        float* dst = data<float>();
+        const float* src = other.data<float>();
+        for (int64_t i = 0; i < n; i++) {
+          for (int64_t j = 0; j < num; j++) {
+            dst[i * num + j] *= src[is_scalar ? 0 : j];
+          }
+        }
+        break;
+      }
+      case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE: {
+        double* dst = data<double>();
+        const double* src = other.data<double>();
+        for (int64_t i = 0; i < n; i++) {
+          for (int64_t j = 0; j < num; j++) {
+            dst[i * num + j] *= src[is_scalar ? 0 : j];
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
  private:
   int data_type_;
   std::string name_;
@@ -7,15 +7,6 @@
 using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
-class IdGenerator {
- public:
-  int Next() {
-    return id++;
-  }
-
- private:
-  int id = 0;
-};
 
 bool InsertCastTransformer::NeedInsertCast(const onnxruntime::Node* node, const onnxruntime::NodeArg* input) const {
   //If the node's input is float16 and currently the node is not assigned to any XP.
@@ -34,17 +25,18 @@ onnxruntime::NodeArg* AddCastNode(onnxruntime::Graph& graph,
                                   int64_t to_type,
                                   onnxruntime::ProviderType providerType) {
   //insert cast op to cast input
-  int id = id_generator.Next();
-
   char str[32];
-  snprintf(str, 32, "CastDef_%d", id);
+  do {
+    // skip the names of the Cast nodes inserted by an earlier transformer
+    snprintf(str, 32, "CastDef_%d", id_generator.Next());
+  } while (graph.GetNodeArg(str) != nullptr);
 
   auto* new_arg = &graph.GetOrCreateNodeArg(str, new_type);
 
   std::vector<onnxruntime::NodeArg*> input_defs = {new_on_input ? new_arg : old_arg};
   std::vector<onnxruntime::NodeArg*> output_defs = {new_on_input ? old_arg : new_arg};
 
-  auto& cast_node = graph.AddNode(str, "Cast", "cast node to cast from float16 to float32 on cpu", input_defs, output_defs);
+  auto& cast_node = graph.AddNode(str, "Cast", "cast node to cast between float16 and float32", input_defs, output_defs);
   cast_node.AddAttribute("to", to_type);
   cast_node.SetExecutionProviderType(providerType);
   return new_arg;
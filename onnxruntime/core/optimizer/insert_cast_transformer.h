@@ -9,6 +9,26 @@
 
 namespace onnxruntime {
 
+class IdGenerator {
+ public:
+  int Next() {
+    return id++;
+  }
+
+ private:
+  int id = 0;
+};
+
+// Inserts a Cast node on provider for old_arg, and returns the NodeArg of new_type on its other side.
+// If new_on_input the Cast converts the new NodeArg into old_arg, otherwise old_arg into the new NodeArg.
+onnxruntime::NodeArg* AddCastNode(onnxruntime::Graph& graph,
+                                  IdGenerator& id_generator,
+                                  onnxruntime::NodeArg* old_arg,
+                                  ONNX_NAMESPACE::TypeProto* new_type,
+                                  bool new_on_input,
+                                  int64_t to_type,
+                                  onnxruntime::ProviderType providerType);
+
 /**
 @Class InsertCastTransformer
 
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <algorithm>
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the first axis of a ReduceMean that reduces trailing axes of its rank `rank` input with keepdims=1,
+// or -1 if the reduction doesn't have that form.
+static int64_t GetTrailingReduceAxis(const Node& reduce_mean, int64_t rank) {
+  const auto* keepdims_attr = graph_utils::GetNodeAttribute(reduce_mean, "keepdims");
+  if (keepdims_attr != nullptr && keepdims_attr->i() == 0) {
+    return -1;
+  }
+
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(reduce_mean, "axes", axes) || axes.empty()) {
+    return -1;
+  }
+
+  for (auto& axis : axes) {
+    if (axis < 0) {
+      axis += rank;
+    }
+  }
+  std::sort(axes.begin(), axes.end());
+
+  for (size_t i = 0; i < axes.size(); ++i) {
+    if (axes[i] != rank - static_cast<int64_t>(axes.size() - i)) {
+      return -1;
+    }
+  }
+
+  return axes[0];
+}
+
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& reduce_mean_node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(reduce_mean_node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(reduce_mean_node, "ReduceMean", {1}) ||
+        !graph_utils::IsSupportedProvider(reduce_mean_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const NodeArg* input = reduce_mean_node.InputDefs()[0];
+    const auto* input_shape = input->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() == 0) {
+      continue;
+    }
+    const int64_t axis = GetTrailingReduceAxis(reduce_mean_node, input_shape->dim_size());
+    if (axis < 0) {
+      continue;
+    }
+
+    // Sub(X, mean) feeds both the variance computation and the final Div.
+    Node* sub_node = optimizer_utils::GetOnlyChildNode(graph, reduce_mean_node, "Sub", {7});
+    if (sub_node == nullptr || sub_node->InputDefs()[0] != input ||
+        sub_node->GetOutputEdgesCount() != 2 || graph.IsNodeOutputsInGraphOutputs(*sub_node)) {
+      continue;
+    }
+
+    Node* pow_node = nullptr;
+    Node* div_node = nullptr;
+    for (auto it = sub_node->OutputNodesBegin(); it != sub_node->OutputNodesEnd(); ++it) {
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Pow", {7})) {
+        pow_node = graph.GetNode(it->Index());
+      } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*it, "Div", {7})) {
+        div_node = graph.GetNode(it->Index());
+      }
+    }
+    float exponent = 0.0f;
+    if (pow_node == nullptr || div_node == nullptr ||
+        pow_node->GetExecutionProviderType() != sub_node->GetExecutionProviderType() ||
+        div_node->GetExecutionProviderType() != sub_node->GetExecutionProviderType() ||
+        pow_node->InputDefs()[0] != sub_node->OutputDefs()[0] ||
+        div_node->InputDefs()[0] != sub_node->OutputDefs()[0] ||
+        !optimizer_utils::GetScalarInitializerValue(graph, *pow_node->InputDefs()[1], exponent) ||
+        exponent != 2.0f) {
+      continue;
+    }
+
+    Node* variance_node = optimizer_utils::GetOnlyChildNode(graph, *pow_node, "ReduceMean", {1});
+    if (variance_node == nullptr || GetTrailingReduceAxis(*variance_node, input_shape->dim_size()) != axis) {
+      continue;
+    }
+
+    float epsilon = 0.0f;
+    Node* add_eps_node = optimizer_utils::GetOnlyChildNode(graph, *variance_node, "Add", {7});
+    if (add_eps_node == nullptr ||
+        !optimizer_utils::GetScalarInitializerValue(graph, *add_eps_node->InputDefs()[1], epsilon)) {
+      continue;
+    }
+
+    Node* sqrt_node = optimizer_utils::GetOnlyChildNode(graph, *add_eps_node, "Sqrt", {6});
+    if (sqrt_node == nullptr || optimizer_utils::GetOnlyChildNode(graph, *sqrt_node, "Div", {7}) != div_node ||
+        div_node->InputDefs()[1] != sqrt_node->OutputDefs()[0]) {
+      continue;
+    }
+
+    // The scale and bias must be constants covering exactly the normalized dimensions.
+    Node* mul_node = optimizer_utils::GetOnlyChildNode(graph, *div_node, "Mul", {7});
+    if (mul_node == nullptr) {
+      continue;
+    }
+    Node* add_node = optimizer_utils::GetOnlyChildNode(graph, *mul_node, "Add", {7});
+    if (add_node == nullptr) {
+      continue;
+    }
+
+    const NodeArg* scale = mul_node->InputDefs()[0] == div_node->OutputDefs()[0] ? mul_node->InputDefs()[1]
+                                                                                   : mul_node->InputDefs()[0];
+    const NodeArg* bias = add_node->InputDefs()[0] == mul_node->OutputDefs()[0] ? add_node->InputDefs()[1]
+                                                                                  : add_node->InputDefs()[0];
+    const auto* scale_shape = scale->Shape();
+    const auto* bias_shape = bias->Shape();
+    if (scale_shape == nullptr || bias_shape == nullptr) {
+      continue;
+    }
+
+    const int64_t norm_rank = input_shape->dim_size() - axis;
+    auto matches_normalized_dims = [&](const ONNX_NAMESPACE::TensorShapeProto& shape) {
+      if (shape.dim_size() != norm_rank) {
+        return false;
+      }
+      for (int i = 0; i < norm_rank; ++i) {
+        const auto& dim = shape.dim(i);
+        const auto& input_dim = input_shape->dim(static_cast<int>(axis) + i);
+        if (!dim.has_dim_value() || !input_dim.has_dim_value() || dim.dim_value() != input_dim.dim_value()) {
+          return false;
+        }
+      }
+      return true;
+    };
+    if (!matches_normalized_dims(*scale_shape) || !matches_normalized_dims(*bias_shape)) {
+      continue;
+    }
+
+    std::vector<NodeArg*> layer_norm_input_defs{const_cast<NodeArg*>(input),
+                                               const_cast<NodeArg*>(scale),
+                                               const_cast<NodeArg*>(bias)};
+    Node& layer_norm_node = graph.AddNode(graph.GenerateNodeName("LayerNormalization"),
+                                          "LayerNormalization",
+                                          "fused LayerNorm subgraph",
+                                          layer_norm_input_defs,
+                                          add_node->MutableOutputDefs(), nullptr, kMSDomain);
+    layer_norm_node.AddAttribute("axis", axis);
+    layer_norm_node.AddAttribute("epsilon", epsilon);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm_node.SetExecutionProviderType(reduce_mean_node.GetExecutionProviderType());
+
+    for (Node* fused_node : {&reduce_mean_node, sub_node, pow_node, variance_node, add_eps_node,
+                             sqrt_node, div_node, mul_node, add_node}) {
+      removed_nodes.push_front(fused_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
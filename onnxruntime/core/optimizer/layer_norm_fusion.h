@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class LayerNormFusion
+
+Fuse the decomposed layer normalization subgraph
+  ReduceMean -> Sub -> Pow(2) -> ReduceMean -> Add(epsilon) -> Sqrt -> Div -> Mul(scale) -> Add(bias)
+into a single LayerNormalization contrib node.
+*/
+class LayerNormFusion : public GraphTransformer {
+ public:
+  LayerNormFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LayerNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
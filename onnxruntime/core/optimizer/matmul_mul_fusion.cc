@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_mul_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Adds the values as a new initializer, so that the one they were computed from is left as is for its other users.
+static NodeArg& AddInitializer(Graph& graph, const std::string& base_name, const Initializer& values) {
+  TensorProto tensor;
+  values.ToProto(&tensor);
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(tensor.data_type());
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : tensor.dims()) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(tensor.name(), &type);
+}
+
+// Returns the index of the input of the Mul or Div that isn't the output of the MatMul or Gemm.
+static int GetScaleInputIndex(const Node& node) {
+  return node.OutputEdgesBegin()->GetDstArgIndex() == 0 ? 1 : 0;
+}
+
+Status MatMulMulFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  auto& matmul_node = node;
+  const auto& mul_node = *matmul_node.OutputNodesBegin();
+  const auto& matmul_inputs = matmul_node.InputDefs();
+  const bool is_gemm = matmul_node.OpType() == "Gemm";
+  const bool is_div = mul_node.OpType() == "Div";
+
+  const auto* B_tensor_proto = graph_utils::GetConstantInitializer(graph, matmul_inputs[1]->Name());
+  ORT_ENFORCE(B_tensor_proto);
+
+  const auto* scale_tensor_proto =
+      graph_utils::GetConstantInitializer(graph, mul_node.InputDefs()[GetScaleInputIndex(matmul_node)]->Name());
+  ORT_ENFORCE(scale_tensor_proto);
+
+  if (!Initializer::IsSupportedDataType(B_tensor_proto) ||
+      B_tensor_proto->data_type() != scale_tensor_proto->data_type() ||
+      B_tensor_proto->dims_size() != 2) {
+    return Status::OK();
+  }
+
+  const auto* trans_B_attr = is_gemm ? graph_utils::GetNodeAttribute(matmul_node, "transB") : nullptr;
+  const bool trans_B = trans_B_attr != nullptr && trans_B_attr->i() != 0;
+  const int64_t num_columns = B_tensor_proto->dims(trans_B ? 0 : 1);
+
+  // The scale has to be one value or one per column of the output, like [N] or [1, N], and must not broadcast the
+  // output to a higher rank.
+  const auto* output_shape = matmul_node.OutputDefs()[0]->Shape();
+  const int output_rank = is_gemm ? 2 : (output_shape != nullptr ? output_shape->dim_size() : 1);
+  const int scale_rank = scale_tensor_proto->dims_size();
+  if (scale_rank > 2 || scale_rank > output_rank) {
+    return Status::OK();
+  }
+  for (int i = 0; i + 1 < scale_rank; i++) {
+    if (scale_tensor_proto->dims(i) != 1) {
+      return Status::OK();
+    }
+  }
+  auto scale = std::make_unique<Initializer>(scale_tensor_proto);
+  if (scale->size() != 1 && (scale_rank == 0 || scale_tensor_proto->dims(scale_rank - 1) != num_columns)) {
+    return Status::OK();
+  }
+
+  // A per-column scale folds into C only when C has a value per column.
+  const TensorProto* C_tensor_proto = nullptr;
+  if (is_gemm) {
+    C_tensor_proto = graph_utils::GetConstantInitializer(graph, matmul_inputs[2]->Name());
+    ORT_ENFORCE(C_tensor_proto);
+    if (C_tensor_proto->data_type() != B_tensor_proto->data_type() ||
+        (scale->size() != 1 &&
+         (C_tensor_proto->dims_size() == 0 || C_tensor_proto->dims(C_tensor_proto->dims_size() - 1) != num_columns))) {
+      return Status::OK();
+    }
+  }
+
+  if (is_div) {
+    auto reciprocal = std::make_unique<Initializer>(static_cast<TensorProto_DataType>(scale->data_type()), "",
+                                                    scale->dims());
+    reciprocal->add(1.0f).div(*scale);
+    scale = std::move(reciprocal);
+  }
+
+  // Calculate the new weights. The columns of the output are the rows of B when it is transposed.
+  auto B = std::make_unique<Initializer>(B_tensor_proto);
+  if (trans_B) {
+    B->scale_by_axis(*scale, 1);
+  } else {
+    B->scale_by_last_axis(*scale);
+  }
+
+  std::unique_ptr<Initializer> C = nullptr;
+  if (is_gemm) {
+    C = std::make_unique<Initializer>(C_tensor_proto);
+    C->scale_by_last_axis(*scale);
+  }
+
+  // Remove the Mul or Div node, then replace the weights with the scaled ones.
+  auto* mul_node_to_remove = graph.GetNode(mul_node.Index());
+  if (graph_utils::RemoveNode(graph, *mul_node_to_remove)) {
+    auto& matmul_mutable_inputs = matmul_node.MutableInputDefs();
+    matmul_mutable_inputs[1] = &AddInitializer(graph, matmul_inputs[1]->Name(), *B);
+    if (is_gemm) {
+      matmul_mutable_inputs[2] = &AddInitializer(graph, matmul_inputs[2]->Name(), *C);
+    }
+
+    rule_effect = RewriteRuleEffect::kModifiedRestOfGraph;
+  }
+
+  return Status::OK();
+}
+
+bool MatMulMulFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if ((!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9}) &&
+       !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9})) ||
+      node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+
+  const auto& next_node = *node.OutputNodesBegin();
+  if ((!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Mul", {7}) &&
+       !graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Div", {7})) ||
+      next_node.GetInputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(next_node) ||
+      // Make sure the two nodes do not span execution providers.
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  // The output of the MatMul or Gemm has to be divided, not the divisor.
+  const int scale_index = GetScaleInputIndex(node);
+  if (next_node.OpType() == "Div" && scale_index != 1) {
+    return false;
+  }
+
+  // Check that the weights, the C of a Gemm and the scale are constants.
+  if (!graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[1]) ||
+      (node.OpType() == "Gemm" && !graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[2])) ||
+      !graph_utils::NodeArgIsConstant(graph, *next_node.InputDefs()[scale_index])) {
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulMulFusion
+
+Rewrite rule that folds a Mul or Div by a constant scalar or per-column scale following a MatMul or Gemm into the
+constant weights of the MatMul or Gemm, and into the constant C of the Gemm.
+
+It is attempted to be triggered only on nodes with op type "MatMul" or "Gemm".
+*/
+class MatMulMulFusion : public RewriteRule {
+ public:
+  MatMulMulFusion() noexcept : RewriteRule("MatMulMulFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"MatMul", "Gemm"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_scale_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Checks whether scale_node multiplies value by a constant scalar, or divides it by one, without broadcasting
+// value to a larger shape, and returns the factor it is multiplied by.
+static bool GetScale(const Graph& graph, const Node& scale_node, const NodeArg* value, float& scale) {
+  const bool is_mul = graph_utils::IsSupportedOptypeVersionAndDomain(scale_node, "Mul", {7});
+  const bool is_div = graph_utils::IsSupportedOptypeVersionAndDomain(scale_node, "Div", {7});
+  if (!is_mul && !is_div) {
+    return false;
+  }
+
+  const auto& input_defs = scale_node.InputDefs();
+  const NodeArg* scale_arg;
+  if (input_defs[0] == value) {
+    scale_arg = input_defs[1];
+  } else if (is_mul && input_defs[1] == value) {
+    scale_arg = input_defs[0];
+  } else {
+    return false;
+  }
+
+  const auto* scale_shape = scale_arg->Shape();
+  if (!optimizer_utils::GetScalarInitializerValue(graph, *scale_arg, scale) ||
+      (!(scale_shape != nullptr && scale_shape->dim_size() == 0) &&
+       !optimizer_utils::IsSameShape(scale_node.OutputDefs()[0]->Shape(), value->Shape()))) {
+    return false;
+  }
+
+  if (is_div) {
+    if (scale == 0.0f) {
+      return false;
+    }
+    scale = 1.0f / scale;
+  }
+  return true;
+}
+
+static float GetFloatAttribute(const Node& node, const std::string& attr_name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, attr_name);
+  return attr == nullptr ? default_value : attr->f();
+}
+
+Status MatMulScaleFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9});
+    const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9});
+    const bool is_transpose_matmul =
+        graph_utils::IsSupportedOptypeVersionAndDomain(node, "TransposeMatMul", {1}, kMSDomain);
+    if ((!is_gemm && !is_matmul && !is_transpose_matmul) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // TransposeMatMul is only implemented for float
+    const auto* type = node.InputDefs()[0]->Type();
+    if (type == nullptr || *type != "tensor(float)") {
+      continue;
+    }
+
+    auto input_defs = node.MutableInputDefs();
+    std::vector<Node*> scale_nodes;
+    float input_scale = 1.0f;
+    for (int i = 0; i < 2; ++i) {
+      for (const auto* op_type : {"Mul", "Div"}) {
+        Node* scale_node = optimizer_utils::GetInputNode(graph, node, i, op_type, {7});
+        float scale;
+        if (scale_node != nullptr) {
+          // the scaled value is the first input of a Div, and either input of a Mul
+          for (auto* scaled_input : scale_node->MutableInputDefs()) {
+            if (GetScale(graph, *scale_node, scaled_input, scale)) {
+              input_defs[i] = scaled_input;
+              input_scale *= scale;
+              scale_nodes.push_back(scale_node);
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    float output_scale = 1.0f;
+    Node* output_scale_node = nullptr;
+    for (const auto* op_type : {"Mul", "Div"}) {
+      Node* scale_node = optimizer_utils::GetOnlyChildNode(graph, node, op_type, {7});
+      if (scale_node != nullptr && GetScale(graph, *scale_node, node.OutputDefs()[0], output_scale)) {
+        output_scale_node = scale_node;
+        scale_nodes.push_back(scale_node);
+      }
+    }
+
+    if (scale_nodes.empty()) {
+      continue;
+    }
+
+    auto& output_defs = output_scale_node != nullptr ? output_scale_node->MutableOutputDefs()
+                                                     : node.MutableOutputDefs();
+    const float alpha = GetFloatAttribute(node, "alpha", 1.0f) * input_scale * output_scale;
+    Node* new_node;
+    if (is_gemm) {
+      new_node = &graph.AddNode(graph.GenerateNodeName("Gemm"),
+                                "Gemm",
+                                "fused Gemm with scale",
+                                input_defs,
+                                output_defs,
+                                &node.GetAttributes(),
+                                node.Domain());
+      // scaling the output also scales the bias
+      new_node->AddAttribute("beta", GetFloatAttribute(node, "beta", 1.0f) * output_scale);
+    } else {
+      new_node = &graph.AddNode(graph.GenerateNodeName("TransposeMatMul"),
+                                "TransposeMatMul",
+                                "fused MatMul with scale",
+                                input_defs,
+                                output_defs,
+                                is_transpose_matmul ? &node.GetAttributes() : nullptr,
+                                kMSDomain);
+    }
+    new_node->AddAttribute("alpha", alpha);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    new_node->SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (Node* scale_node : scale_nodes) {
+      if (scale_node != output_scale_node) {
+        removed_nodes.push_front(scale_node->Index());
+      }
+    }
+    removed_nodes.push_front(node.Index());
+    if (output_scale_node != nullptr) {
+      removed_nodes.push_front(output_scale_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
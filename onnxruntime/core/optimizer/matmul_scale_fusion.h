@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulScaleFusion
+
+Fold multiplications and divisions by a constant scalar into the alpha of the matrix product that consumes or
+produces them, so the scaling is applied by the GEMM instead of a separate pass over memory:
+  Mul/Div(scalar) -> MatMul and MatMul -> Mul/Div(scalar) become TransposeMatMul with alpha,
+  and the same around TransposeMatMul or Gemm update their alpha (and the beta of Gemm for scaled outputs).
+*/
+class MatMulScaleFusion : public GraphTransformer {
+ public:
+  MatMulScaleFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulScaleFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
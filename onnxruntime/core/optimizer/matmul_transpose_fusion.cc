@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/utils.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Returns the Transpose producing input input_index of node if it only swaps the last two dimensions and node
+// is its only consumer.
+static Node* GetLastTwoDimsTranspose(Graph& graph, const Node& node, int input_index) {
+  Node* transpose_node = optimizer_utils::GetInputNode(graph, node, input_index, "Transpose", {1});
+  if (transpose_node == nullptr) {
+    return nullptr;
+  }
+
+  std::vector<int64_t> perm;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(*transpose_node, "perm", perm)) {
+    // the default perm reverses the dimensions, which only swaps the last two of a 2D input
+    const auto* shape = transpose_node->InputDefs()[0]->Shape();
+    return shape != nullptr && shape->dim_size() == 2 ? transpose_node : nullptr;
+  }
+
+  const auto rank = static_cast<int64_t>(perm.size());
+  if (rank < 2 || perm[rank - 2] != rank - 1 || perm[rank - 1] != rank - 2) {
+    return nullptr;
+  }
+  for (int64_t i = 0; i < rank - 2; ++i) {
+    if (perm[i] != i) {
+      return nullptr;
+    }
+  }
+  return transpose_node;
+}
+
+static int64_t GetTransAttribute(const Node& node, const std::string& attr_name) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, attr_name);
+  return attr == nullptr ? 0 : attr->i();
+}
+
+Status MatMulTransposeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9}) ||
+                         graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedGemm", {1}, kMSDomain);
+    const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9});
+    if ((!is_gemm && !is_matmul) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // TransposeMatMul is only implemented for float
+    if (is_matmul && *node.InputDefs()[0]->Type() != "tensor(float)") {
+      continue;
+    }
+
+    // a Transpose feeding both inputs has two output edges, so it is never matched here
+    Node* transpose_a = GetLastTwoDimsTranspose(graph, node, 0);
+    Node* transpose_b = GetLastTwoDimsTranspose(graph, node, 1);
+    if (transpose_a == nullptr && transpose_b == nullptr) {
+      continue;
+    }
+
+    auto input_defs = node.MutableInputDefs();
+    if (transpose_a != nullptr) {
+      input_defs[0] = transpose_a->MutableInputDefs()[0];
+    }
+    if (transpose_b != nullptr) {
+      input_defs[1] = transpose_b->MutableInputDefs()[0];
+    }
+
+    int64_t trans_a = transpose_a != nullptr ? 1 : 0;
+    int64_t trans_b = transpose_b != nullptr ? 1 : 0;
+    Node* new_node;
+    if (is_gemm) {
+      // transposing an operand that Gemm already transposes cancels out
+      trans_a ^= GetTransAttribute(node, "transA") != 0 ? 1 : 0;
+      trans_b ^= GetTransAttribute(node, "transB") != 0 ? 1 : 0;
+      new_node = &graph.AddNode(graph.GenerateNodeName(node.OpType()),
+                                node.OpType(),
+                                "fused Transpose and " + node.OpType(),
+                                input_defs,
+                                node.MutableOutputDefs(),
+                                &node.GetAttributes(),
+                                node.Domain());
+    } else {
+      new_node = &graph.AddNode(graph.GenerateNodeName("TransposeMatMul"),
+                                "TransposeMatMul",
+                                "fused Transpose and MatMul",
+                                input_defs,
+                                node.MutableOutputDefs(),
+                                nullptr,
+                                kMSDomain);
+    }
+    new_node->AddAttribute("transA", trans_a);
+    new_node->AddAttribute("transB", trans_b);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    new_node->SetExecutionProviderType(node.GetExecutionProviderType());
+
+    if (transpose_a != nullptr) {
+      removed_nodes.push_front(transpose_a->Index());
+    }
+    if (transpose_b != nullptr) {
+      removed_nodes.push_front(transpose_b->Index());
+    }
+    removed_nodes.push_front(node.Index());
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
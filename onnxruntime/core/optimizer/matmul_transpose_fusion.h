@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulTransposeFusion
+
+Fold a Transpose that swaps the last two dimensions of an input of Gemm or MatMul into the GEMM call:
+  Transpose -> Gemm toggles the transA or transB attribute of the Gemm, and
+  Transpose -> MatMul becomes a TransposeMatMul contrib node with transA or transB set.
+*/
+class MatMulTransposeFusion : public GraphTransformer {
+ public:
+  MatMulTransposeFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulTransposeFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
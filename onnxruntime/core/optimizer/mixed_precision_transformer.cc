@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/mixed_precision_transformer.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/insert_cast_transformer.h"
+#include "core/util/math.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// the type of a float NodeArg once converted, which keeps its shape
+TypeProto Float16Type(const NodeArg& arg) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT16);
+  return type;
+}
+
+NodeArg& AddFloat16Initializer(Graph& graph, const TensorProto& float_tensor, const TypeProto& float16_type) {
+  Initializer float_data(&float_tensor);
+  Initializer float16_data(TensorProto_DataType_FLOAT16, graph.GenerateNodeArgName(float_tensor.name() + "_fp16"),
+                           float_data.dims());
+  const float* src = float_data.data<float>();
+  uint16_t* dst = float16_data.data<uint16_t>();
+  for (int64_t i = 0; i < float_data.size(); i++) {
+    dst[i] = math::floatToHalf(src[i]);
+  }
+
+  TensorProto float16_tensor;
+  float16_data.ToProto(&float16_tensor);
+  graph.AddInitializedTensor(float16_tensor);
+  return graph.GetOrCreateNodeArg(float16_tensor.name(), &float16_type);
+}
+
+}  // namespace
+
+const std::vector<std::string>& MixedPrecisionTransformer::DefaultAllowList() {
+  // compute bound or memory bound ops which float16 doesn't make less accurate
+  static const std::vector<std::string> allow_list = {
+      "Conv", "ConvTranspose", "FusedConv", "MatMul", "Gemm", "FusedGemm",
+      "Add", "Sub", "Mul", "Div", "Sum", "Abs", "Neg",
+      "Relu", "LeakyRelu", "Sigmoid", "Tanh", "Elu", "Selu", "Softplus", "ThresholdedRelu", "PRelu", "Clip",
+      "MaxPool", "AveragePool", "GlobalAveragePool", "GlobalMaxPool",
+      "Concat", "Split", "Slice", "Gather", "Transpose", "Reshape", "Flatten", "Squeeze", "Unsqueeze",
+      "Identity", "Pad", "Tile", "Expand"};
+  return allow_list;
+}
+
+const std::vector<std::string>& MixedPrecisionTransformer::DefaultDenyList() {
+  // ops whose accumulation or range needs float, even if they are in a custom allow list
+  static const std::vector<std::string> deny_list = {
+      "Softmax", "LogSoftmax", "LayerNormalization", "BatchNormalization", "InstanceNormalization", "LRN",
+      "ReduceSum", "ReduceMean", "ReduceSumSquare", "ReduceL1", "ReduceL2", "ReduceLogSum", "ReduceLogSumExp",
+      "ReduceProd", "Exp", "Log", "Pow", "Sqrt", "Reciprocal", "Erf"};
+  return deny_list;
+}
+
+MixedPrecisionTransformer::MixedPrecisionTransformer(const KernelRegistryManager& registry_manager,
+                                                     const std::vector<std::string>& allow_list,
+                                                     const std::vector<std::string>& deny_list,
+                                                     const std::string& provider_type)
+    : GraphTransformer("MixedPrecisionTransformer"),
+      registry_manager_{registry_manager},
+      provider_type_{provider_type} {
+  const auto& allowed = allow_list.empty() ? DefaultAllowList() : allow_list;
+  const auto& denied = deny_list.empty() ? DefaultDenyList() : deny_list;
+  op_types_.insert(allowed.cbegin(), allowed.cend());
+  for (const auto& op_type : denied) {
+    op_types_.erase(op_type);
+  }
+}
+
+bool MixedPrecisionTransformer::CanConvert(Node& node) const {
+  if (node.GetExecutionProviderType() != provider_type_ || op_types_.count(node.OpType()) == 0) {
+    return false;
+  }
+
+  const auto& outputs = node.OutputDefs();
+  if (std::none_of(outputs.cbegin(), outputs.cend(), [](const NodeArg* output) { return IsFloatTensor(*output); })) {
+    return false;
+  }
+
+  // look the kernel up with the float tensors of the node retyped to float16, then restore them.
+  // this also rejects the nodes with inputs that have to stay float, such as the scales of Upsample.
+  std::vector<std::pair<NodeArg*, TypeProto>> float_args;
+  for (auto* defs : {&node.MutableInputDefs(), &node.MutableOutputDefs()}) {
+    for (auto* arg : *defs) {
+      if (IsFloatTensor(*arg)) {
+        float_args.emplace_back(arg, *arg->TypeAsProto());
+        arg->SetType(Float16Type(*arg));
+      }
+    }
+  }
+
+  const KernelCreateInfo* kernel_create_info = nullptr;
+  const bool found = registry_manager_.SearchKernelRegistry(node, &kernel_create_info).IsOK();
+
+  for (auto& entry : float_args) {
+    entry.first->SetType(entry.second);
+  }
+  return found;
+}
+
+Status MixedPrecisionTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::unordered_set<const Node*> float16_nodes;
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node)
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (CanConvert(*node)) {
+      float16_nodes.insert(node);
+    }
+  }
+
+  if (float16_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // the values which are still needed in float: inputs of the other nodes, values used by subgraphs and graph outputs
+  std::unordered_set<const NodeArg*> float_uses;
+  for (const auto& node : graph.Nodes()) {
+    if (float16_nodes.count(&node) == 0) {
+      float_uses.insert(node.InputDefs().cbegin(), node.InputDefs().cend());
+    }
+    float_uses.insert(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+  }
+  float_uses.insert(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+
+  IdGenerator id_generator;
+  // float value -> its float16 version for the converted nodes
+  std::unordered_map<const NodeArg*, NodeArg*> float16_args;
+
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (float16_nodes.count(node) == 0) {
+      continue;
+    }
+
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+    for (auto* output : node->MutableOutputDefs()) {
+      if (!IsFloatTensor(*output)) {
+        continue;
+      }
+
+      auto float16_type = Float16Type(*output);
+      if (float_uses.count(output) == 0) {
+        output->SetType(float16_type);
+        float16_args[output] = output;
+      } else {
+        // the float users keep the original value, which a Cast now produces from the float16 output
+        auto* float16_output = AddCastNode(graph, id_generator, output, &float16_type, true,
+                                           static_cast<int64_t>(TensorProto_DataType_FLOAT), provider_type_);
+        replacement_defs[output] = float16_output;
+        float16_args[output] = float16_output;
+      }
+    }
+    node->ReplaceDefs(replacement_defs);
+  }
+
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (float16_nodes.count(node) == 0) {
+      continue;
+    }
+
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+    for (auto* input : node->MutableInputDefs()) {
+      auto converted = float16_args.find(input);
+      if (converted == float16_args.end()) {
+        if (!IsFloatTensor(*input)) {
+          continue;
+        }
+
+        // constant weights are converted once, any other float value is cast at the edge of the region
+        NodeArg* float16_input = nullptr;
+        const auto* initializer = graph_utils::GetConstantInitializer(graph, input->Name(), false);
+        if (initializer != nullptr) {
+          float16_input = &AddFloat16Initializer(graph, *initializer, Float16Type(*input));
+        } else {
+          auto float16_type = Float16Type(*input);
+          float16_input = AddCastNode(graph, id_generator, input, &float16_type, false,
+                                      static_cast<int64_t>(TensorProto_DataType_FLOAT16), provider_type_);
+        }
+        converted = float16_args.emplace(input, float16_input).first;
+      }
+
+      if (converted->second != input) {
+        replacement_defs[input] = converted->second;
+      }
+    }
+    node->ReplaceDefs(replacement_defs);
+  }
+
+  modified = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
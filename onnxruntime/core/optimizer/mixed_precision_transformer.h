@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MixedPrecisionTransformer
+
+Transformer that runs the float nodes of an execution provider in float16 where it has float16 kernels.
+The nodes whose op type is allowed, and not denied, are converted: their float tensors become float16, their
+constant float initializers are converted once, and Cast nodes are inserted only where a float16 tensor meets a
+float one, i.e. at the edges of the converted regions and at the graph inputs and outputs.
+By default the numerically sensitive ops, such as Softmax, the reductions and LayerNormalization, stay in float.
+
+It runs after the graph partitioning, as it needs to know where the nodes are placed.
+*/
+class MixedPrecisionTransformer : public GraphTransformer {
+ public:
+  // allow_list and deny_list replace the default lists when they are not empty.
+  MixedPrecisionTransformer(const KernelRegistryManager& registry_manager,
+                            const std::vector<std::string>& allow_list = {},
+                            const std::vector<std::string>& deny_list = {},
+                            const std::string& provider_type = kCudaExecutionProvider);
+
+  static const std::vector<std::string>& DefaultAllowList();
+  static const std::vector<std::string>& DefaultDenyList();
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  bool CanConvert(Node& node) const;
+
+  const KernelRegistryManager& registry_manager_;
+  std::unordered_set<std::string> op_types_;
+  const std::string provider_type_;
+};
+
+}  // namespace onnxruntime
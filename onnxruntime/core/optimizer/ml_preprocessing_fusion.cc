@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/ml_preprocessing_fusion.h"
+#include "core/graph/graph_utils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The attributes of the fused node that the ops of the chain append their parameters to.
+struct FusedParameters {
+  std::vector<std::string> ops;
+  std::vector<float> feature_values;
+  std::vector<float> scalar_values;
+  std::vector<std::string> norms;
+};
+
+}  // namespace
+
+static std::vector<float> GetFloats(const Node& node, const std::string& name) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  if (attr == nullptr) {
+    return {};
+  }
+  return std::vector<float>(attr->floats().begin(), attr->floats().end());
+}
+
+static float GetFloat(const Node& node, const std::string& name, float default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_f() ? attr->f() : default_value;
+}
+
+// Appends the parameters of node to params if it is a preprocessing op the FusedMLPreprocessing kernel can apply
+// to rows of feature_count features with the result of the kernel of the op. The values that the kernels of the
+// ops either take per feature or broadcast from a single one are expanded to feature_count values.
+static bool AppendChainOp(const Node& node, int64_t feature_count, FusedParameters& params) {
+  const size_t count = static_cast<size_t>(feature_count);
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Imputer", {1}, kMLDomain)) {
+    auto imputed_values = GetFloats(node, "imputed_value_floats");
+    if (imputed_values.empty()) {
+      return false;
+    }
+    // the Imputer kernel uses the first value for all the features unless there is one per feature
+    if (imputed_values.size() != count) {
+      imputed_values.assign(count, imputed_values[0]);
+    }
+    params.feature_values.insert(params.feature_values.end(), imputed_values.begin(), imputed_values.end());
+    params.scalar_values.push_back(GetFloat(node, "replaced_value_float", 0.0f));
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Scaler", {1}, kMLDomain)) {
+    auto offset = GetFloats(node, "offset");
+    auto scale = GetFloats(node, "scale");
+    if (scale.empty() || offset.size() != scale.size()) {
+      return false;
+    }
+    if (scale.size() == 1) {
+      offset.assign(count, offset[0]);
+      scale.assign(count, scale[0]);
+    } else if (scale.size() != count) {
+      return false;
+    }
+    params.feature_values.insert(params.feature_values.end(), offset.begin(), offset.end());
+    params.feature_values.insert(params.feature_values.end(), scale.begin(), scale.end());
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Normalizer", {1}, kMLDomain)) {
+    const auto* attr = graph_utils::GetNodeAttribute(node, "norm");
+    if (attr == nullptr || (attr->s() != "MAX" && attr->s() != "L1" && attr->s() != "L2")) {
+      return false;
+    }
+    params.norms.push_back(attr->s());
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Binarizer", {1}, kMLDomain)) {
+    params.scalar_values.push_back(GetFloat(node, "threshold", 1.0f));
+  } else {
+    return false;
+  }
+
+  params.ops.push_back(node.OpType());
+  return true;
+}
+
+Status MLPreprocessingFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+  std::unordered_set<onnxruntime::NodeIndex> fused_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        fused_nodes.find(node_index) != fused_nodes.end()) {
+      continue;
+    }
+
+    // The ops give the rows of a 2D input to the Normalizer, and the features along the second dimension
+    // to the per feature parameters of the others.
+    NodeArg* chain_input = node.MutableInputDefs()[0];
+    const auto* type = chain_input->Type();
+    const auto* shape = chain_input->Shape();
+    if (type == nullptr || *type != "tensor(float)" || shape == nullptr || shape->dim_size() != 2 ||
+        !shape->dim(1).has_dim_value() || shape->dim(1).dim_value() <= 0) {
+      continue;
+    }
+    const int64_t feature_count = shape->dim(1).dim_value();
+
+    FusedParameters params;
+    if (!AppendChainOp(node, feature_count, params)) {
+      continue;
+    }
+
+    // All the ops produce float tensors of the shape of their input from a float input.
+    std::vector<Node*> chain{&node};
+    Node* last_node = &node;
+    while (last_node->GetOutputEdgesCount() == 1 && !graph.IsNodeOutputsInGraphOutputs(*last_node)) {
+      Node& next_node = *graph.GetNode(last_node->OutputNodesBegin()->Index());
+      if (next_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          next_node.InputDefs()[0] != last_node->OutputDefs()[0] ||
+          !AppendChainOp(next_node, feature_count, params)) {
+        break;
+      }
+      chain.push_back(&next_node);
+      last_node = &next_node;
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedMLPreprocessing"),
+                                     "FusedMLPreprocessing",
+                                     "fused ML preprocessing ops",
+                                     {chain_input},
+                                     last_node->MutableOutputDefs(), nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", params.ops);
+    if (!params.feature_values.empty()) {
+      fused_node.AddAttribute("feature_values", params.feature_values);
+    }
+    if (!params.scalar_values.empty()) {
+      fused_node.AddAttribute("scalar_values", params.scalar_values);
+    }
+    if (!params.norms.empty()) {
+      fused_node.AddAttribute("norms", params.norms);
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (const auto* chain_node : chain) {
+      removed_nodes.push_front(chain_node->Index());
+      fused_nodes.insert(chain_node->Index());
+    }
+  }
+
+  // Have to remove node in reversed order for now to walk around the issue in RemoveNode
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MLPreprocessingFusion
+
+Fuse chains of the ONNX-ML preprocessing ops Imputer, Scaler, Normalizer and Binarizer, as converted scikit-learn
+pipelines produce them, into a single FusedMLPreprocessing contrib node that applies the whole chain to each row
+of the feature matrix while it is in cache. The chain input must be a float tensor of shape [N, C] with a known
+number of features C, and each op must be the only consumer of the previous one.
+*/
+class MLPreprocessingFusion : public GraphTransformer {
+ public:
+  MLPreprocessingFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MLPreprocessingFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
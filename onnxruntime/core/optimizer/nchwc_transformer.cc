@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <deque>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
@@ -107,6 +108,7 @@ class NchwcTransformerImpl {
   void CreateNchwcArgument(Node& node, Node& nchwc_node, int64_t channels, const NchwcArgument::Shape& shape);
   void FuseNchwcArgument(Node& node, const NchwcArgument& nchwc_arg);
   void InsertReorderInput(Node& node);
+  NodeArg* AddFloatInitializer(const std::vector<float>& data, const std::vector<int64_t>& dims);
 
   void ConvPoolShapeInference(const Node& node,
                               const NchwcArgument::Shape& input_shape,
@@ -115,9 +117,12 @@ class NchwcTransformerImpl {
 
   void TransformConv(Node& node);
   void TransformPool(Node& node);
-  void TransformAdd(Node& node);
+  void TransformBinary(Node& node, bool add_node);
+  bool TransformChannelScale(Node& node, const std::vector<NchwcArgument*>& nchwc_inputs);
   void TransformConcat(Node& node);
   void TransformActivation(Node& node);
+  void TransformBatchNormalization(Node& node);
+  void TransformUpsample(Node& node);
 
   Graph& graph_;
 
@@ -204,6 +209,23 @@ void NchwcTransformerImpl::InsertReorderInput(Node& node) {
   }
 }
 
+NodeArg* NchwcTransformerImpl::AddFloatInitializer(const std::vector<float>& data,
+                                                   const std::vector<int64_t>& dims) {
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+
+  tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  tensor_proto.set_name(graph_.GenerateNodeArgName("reorder"));
+  tensor_proto.set_raw_data(data.data(), data.size() * sizeof(float));
+
+  for (auto dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+
+  graph_.AddInitializedTensor(tensor_proto);
+
+  return &graph_.GetOrCreateNodeArg(tensor_proto.name(), nullptr);
+}
+
 void NchwcTransformerImpl::ConvPoolShapeInference(const Node& node,
                                                   const NchwcArgument::Shape& input_shape,
                                                   NchwcArgument::Shape& output_shape,
@@ -506,10 +528,10 @@ void NchwcTransformerImpl::TransformPool(Node& node) {
   removed_nodes_.push_front(node.Index());
 }
 
-// The existing Add/Sum operator implementations can be used with tensors
+// The existing Add/Sum/Mul operator implementations can be used with tensors
 // in NCHWc format if the tensor shapes are exactly the same (elementwise
-// add).
-void NchwcTransformerImpl::TransformAdd(Node& node) {
+// add or multiply).
+void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
   auto& input_defs = node.MutableInputDefs();
 
   // Verify that all of the inputs to this operator are from NCHWc outputs.
@@ -524,6 +546,11 @@ void NchwcTransformerImpl::TransformAdd(Node& node) {
     nchwc_inputs.push_back(it->second.get());
   }
 
+  // A multiply by a channel vector broadcasts differently in NCHWc format.
+  if (!add_node && TransformChannelScale(node, nchwc_inputs)) {
+    return;
+  }
+
   // Test if all of the NCHWc inputs have a compatible shape.
   auto* nchwc_input_0 = nchwc_inputs[0];
   auto* nchwc_input_0_shape = input_defs[0]->Shape();
@@ -558,7 +585,7 @@ void NchwcTransformerImpl::TransformAdd(Node& node) {
 
   // If one of the inputs to the Add/Sum node is a NCHWc convolution, then
   // attempt to fuse the addition into the convolution itself.
-  if (input_defs_count == 2) {
+  if (add_node && input_defs_count == 2) {
     for (size_t n = 0; n < 2; n++) {
       auto* nchwc_input_n = nchwc_inputs[n];
       auto& nchwc_node = nchwc_input_n->output_node_;
@@ -588,6 +615,77 @@ void NchwcTransformerImpl::TransformAdd(Node& node) {
   CreateNchwcArgument(node, node, nchwc_input_0->channels_, nchwc_input_0->shape_);
 }
 
+// Squeeze-and-excitation blocks multiply a tensor by a [N, C, 1, 1] tensor
+// derived from it by global pooling. With both in NCHWc format, each channel
+// block of the tensor is scaled by the matching block of the channel vector.
+bool NchwcTransformerImpl::TransformChannelScale(Node& node, const std::vector<NchwcArgument*>& nchwc_inputs) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  if (input_defs.size() != 2) {
+    return false;
+  }
+
+  auto is_channel_vector = [](const NodeArg* arg) {
+    auto* shape = arg->Shape();
+    if ((shape == nullptr) || (shape->dim_size() != kNchwcDims)) {
+      return false;
+    }
+    for (int i = kNchwcBatchChannelDims; i < kNchwcDims; i++) {
+      auto& dim = shape->dim(i);
+      if (!utils::HasDimValue(dim) || (dim.dim_value() != 1)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t scale_index;
+  if (is_channel_vector(input_defs[1]) && !is_channel_vector(input_defs[0])) {
+    scale_index = 1;
+  } else if (is_channel_vector(input_defs[0]) && !is_channel_vector(input_defs[1])) {
+    scale_index = 0;
+  } else {
+    return false;
+  }
+
+  auto* nchwc_input = nchwc_inputs[scale_index ^ 1];
+  auto* nchwc_scale = nchwc_inputs[scale_index];
+
+  // Require the same batch and channel counts.
+  if (nchwc_input->channels_ != nchwc_scale->channels_) {
+    return false;
+  }
+  if (!nchwc_input->shape_.IsDimEqual(nchwc_scale->shape_, 0)) {
+    auto* input_shape = input_defs[scale_index ^ 1]->Shape();
+    auto& input_batch_dim = input_shape->dim(0);
+    auto& scale_batch_dim = input_defs[scale_index]->Shape()->dim(0);
+    if (!utils::HasDimValue(input_batch_dim) ||
+        !utils::HasDimValue(scale_batch_dim) ||
+        (input_batch_dim.dim_value() != scale_batch_dim.dim_value())) {
+      return false;
+    }
+  }
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Mul",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_scale->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  nchwc_input->remaining_original_uses_--;
+  nchwc_scale->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+  return true;
+}
+
 void NchwcTransformerImpl::TransformConcat(Node& node) {
   auto& input_defs = node.MutableInputDefs();
   auto& output_defs = node.MutableOutputDefs();
@@ -660,6 +758,172 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
   }
 }
 
+// BatchNormalization is a per channel scale and shift, so it runs as a 1x1
+// depthwise NCHWc convolution, which may then be fused with an activation.
+void NchwcTransformerImpl::TransformBatchNormalization(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  // Bail out if the node has the optional training outputs specified.
+  if (output_defs.size() > 1) {
+    return;
+  }
+
+  // Don't transform the node if the input is not already in NCHWc format.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  // Depthwise convolution requires the channel count to be block aligned.
+  const size_t nchwc_block_size = MlasNchwcGetBlockSize();
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % nchwc_block_size) != 0) {
+    return;
+  }
+
+  // Require that the scale, bias, mean and variance tensors be static.
+  std::unique_ptr<Initializer> bn_params[4];
+  for (size_t i = 0; i < 4; i++) {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[i + 1]) ||
+        !graph_.GetInitializedTensor(input_defs[i + 1]->Name(), tensor_proto) ||
+        (tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (tensor_proto->dims_size() != 1) ||
+        (tensor_proto->dims(0) != channels)) {
+      return;
+    }
+    bn_params[i] = std::make_unique<Initializer>(tensor_proto);
+  }
+
+  float epsilon = 1e-5f;
+  const ONNX_NAMESPACE::AttributeProto* epsilon_attr = graph_utils::GetNodeAttribute(node, "epsilon");
+  if (epsilon_attr != nullptr && utils::HasFloat(*epsilon_attr)) {
+    epsilon = epsilon_attr->f();
+  }
+
+  // Fold the normalization into the weights and biases of the convolution:
+  // Y = X * scale / sqrt(var + epsilon) + (B - mean * scale / sqrt(var + epsilon))
+  const float* bn_scale = bn_params[0]->data<float>();
+  const float* bn_B = bn_params[1]->data<float>();
+  const float* bn_mean = bn_params[2]->data<float>();
+  const float* bn_var = bn_params[3]->data<float>();
+
+  std::vector<float> conv_W(channels);
+  std::vector<float> conv_B(channels);
+  for (int64_t c = 0; c < channels; c++) {
+    conv_W[c] = bn_scale[c] / std::sqrt(bn_var[c] + epsilon);
+    conv_B[c] = bn_B[c] - bn_mean[c] * conv_W[c];
+  }
+
+  const std::vector<int64_t> conv_W_dims{channels, 1, 1, 1};
+  std::vector<float> reordered_filter(channels);
+  MlasReorderFilterOIHWBo(conv_W_dims.data(), conv_W.data(), reordered_filter.data());
+
+  NodeArg* nchwc_conv_W_arg = AddFloatInitializer(reordered_filter, conv_W_dims);
+  NodeArg* nchwc_conv_B_arg = AddFloatInitializer(conv_B, {channels});
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Conv",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_, nchwc_conv_W_arg, nchwc_conv_B_arg},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("group", channels);
+
+  nchwc_input->remaining_original_uses_--;
+
+  CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+  removed_nodes_.push_front(node.Index());
+}
+
+// Nearest neighbor Upsample/Resize with integral spatial scales replicates
+// whole NCHWc blocks.
+void NchwcTransformerImpl::TransformUpsample(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  const ONNX_NAMESPACE::AttributeProto* mode_attr = graph_utils::GetNodeAttribute(node, "mode");
+  if (mode_attr != nullptr && utils::HasString(*mode_attr) && mode_attr->s() != "nearest") {
+    return;
+  }
+
+  // Don't transform the node if the input is not already in NCHWc format.
+  auto it = nchwc_args_.find(input_defs[0]);
+  if (it == nchwc_args_.end()) {
+    return;
+  }
+  auto* nchwc_input = it->second.get();
+
+  // The scales are an attribute of Upsample-7 and a static input of the later
+  // versions and Resize.
+  std::vector<float> scales;
+  if (input_defs.size() >= 2) {
+    const ONNX_NAMESPACE::TensorProto* scales_tensor_proto = nullptr;
+    if (!graph_utils::NodeArgIsConstant(graph_, *input_defs[1]) ||
+        !graph_.GetInitializedTensor(input_defs[1]->Name(), scales_tensor_proto) ||
+        (scales_tensor_proto->data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) ||
+        (scales_tensor_proto->dims_size() != 1) ||
+        (scales_tensor_proto->dims(0) != kNchwcDims)) {
+      return;
+    }
+    Initializer scales_initializer(scales_tensor_proto);
+    const float* scales_data = scales_initializer.data<float>();
+    scales.assign(scales_data, scales_data + kNchwcDims);
+  } else {
+    const ONNX_NAMESPACE::AttributeProto* scales_attr = graph_utils::GetNodeAttribute(node, "scales");
+    if (scales_attr == nullptr || scales_attr->floats_size() != kNchwcDims) {
+      return;
+    }
+    scales.assign(scales_attr->floats().begin(), scales_attr->floats().end());
+  }
+
+  // Require integral scales, with the batch and channel dimensions unscaled.
+  std::vector<int64_t> nchwc_scales(kNchwcDims);
+  for (int i = 0; i < kNchwcDims; i++) {
+    const int64_t scale = static_cast<int64_t>(scales[i]);
+    if ((scale < 1) || (static_cast<float>(scale) != scales[i]) ||
+        (i < kNchwcBatchChannelDims && scale != 1)) {
+      return;
+    }
+    nchwc_scales[i] = scale;
+  }
+
+  // Create the replacement node.
+  std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+  Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                    "Upsample",
+                                    nchwc_node_name,
+                                    {nchwc_input->nchwc_arg_},
+                                    output_defs,
+                                    nullptr,
+                                    kMSNchwcDomain);
+  nchwc_node.SetExecutionProviderType(node.GetExecutionProviderType());
+  nchwc_node.AddAttribute("scales", nchwc_scales);
+
+  nchwc_input->remaining_original_uses_--;
+
+  // Maintain the batch and channel dimensions and any spatial dimension that
+  // isn't scaled from the NCHWc input.
+  NchwcArgument::Shape output_shape(output_defs[0]);
+  for (int i = 0; i < kNchwcDims; i++) {
+    if (nchwc_scales[i] == 1) {
+      output_shape.dims_[i] = nchwc_input->shape_.dims_[i];
+      if (i >= kNchwcBatchChannelDims) {
+        output_shape.shifts_[i - kNchwcBatchChannelDims] = nchwc_input->shape_.shifts_[i - kNchwcBatchChannelDims];
+      }
+    }
+  }
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, output_shape);
+  removed_nodes_.push_front(node.Index());
+}
+
 void NchwcTransformerImpl::Transform(Node& node) {
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1}) ||
       graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
@@ -677,11 +941,20 @@ void NchwcTransformerImpl::Transform(Node& node) {
     // nodes unrelated to this transformer.
     if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7}) ||
         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8})) {
-      TransformAdd(node);
+      TransformBinary(node, true);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7})) {
+      TransformBinary(node, false);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4})) {
       TransformConcat(node);
-    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6})) {
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6})) {
       TransformActivation(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9})) {
+      TransformBatchNormalization(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {7, 9}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10})) {
+      TransformUpsample(node);
     }
   }
 
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <deque>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/nhwc_transformer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+static bool IsTransposeWithPerm(const Node& node, const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1}) &&
+         graph_utils::GetRepeatedNodeAttributeValues(node, "perm", perm) && perm == expected_perm;
+}
+
+// Returns whether the node has an NHWC equivalent. Only 2D convolutions without groups are supported, which is
+// implied by the 4D input of the chain.
+static bool IsLayoutSensitiveNode(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
+    const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+    return group_attr == nullptr || group_attr->i() == 1;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11})) {
+    // the NHWC MaxPool doesn't produce the indices output
+    return node.OutputDefs().size() == 1 || !node.OutputDefs()[1]->Exists();
+  }
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1});
+}
+
+// Returns whether the node computes each element of its output from the same element of its first input, so it
+// works on either layout.
+static bool IsElementwiseNode(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11});
+}
+
+// Returns the node consuming the first output of node through its first input, if that is the only use of any
+// output of node.
+static Node* GetOnlyChildOnFirstInput(Graph& graph, const Node& node) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+
+  const auto edge = node.OutputEdgesBegin();
+  if (edge->GetSrcArgIndex() != 0 || edge->GetDstArgIndex() != 0 ||
+      edge->GetNode().GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return graph.GetNode(edge->GetNode().Index());
+}
+
+Status NhwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  std::deque<NodeIndex> removed_nodes;
+
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto& node = *graph.GetNode(index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level));
+
+    // NHWC -> NCHW
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider || !IsTransposeWithPerm(node, {0, 3, 1, 2}) ||
+        *node.InputDefs()[0]->Type() != "tensor(float)") {
+      continue;
+    }
+
+    // Follow the chain of nodes to the Transpose back to NHWC.
+    std::vector<Node*> chain;
+    Node* output_transpose = nullptr;
+    for (Node* next = GetOnlyChildOnFirstInput(graph, node); next != nullptr;) {
+      if (IsTransposeWithPerm(*next, {0, 2, 3, 1})) {
+        output_transpose = next;
+        break;
+      }
+      if (!IsLayoutSensitiveNode(*next) && !IsElementwiseNode(*next)) {
+        break;
+      }
+      chain.push_back(next);
+      next = GetOnlyChildOnFirstInput(graph, *next);
+    }
+    if (output_transpose == nullptr || chain.empty()) {
+      continue;
+    }
+
+    // Recreate the chain between the NHWC tensors, with the NHWC nodes in place of the layout sensitive ones.
+    NodeArg* input_arg = node.MutableInputDefs()[0];
+    for (size_t i = 0; i < chain.size(); ++i) {
+      Node& chain_node = *chain[i];
+      NodeArg* output_arg = i + 1 == chain.size()
+                                ? output_transpose->MutableOutputDefs()[0]
+                                : &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("nhwc"), nullptr);
+
+      auto input_defs = chain_node.MutableInputDefs();
+      input_defs[0] = input_arg;
+
+      const bool is_layout_sensitive = IsLayoutSensitiveNode(chain_node);
+      std::string op_type = chain_node.OpType() == "FusedConv" ? "Conv" : chain_node.OpType();
+      std::string node_name = graph.GenerateNodeName(chain_node.Name() + (is_layout_sensitive ? "_nhwc" : ""));
+      Node& new_node = graph.AddNode(node_name,
+                                     op_type,
+                                     node_name,
+                                     input_defs,
+                                     {output_arg},
+                                     &chain_node.GetAttributes(),
+                                     is_layout_sensitive ? kMSNhwcDomain : chain_node.Domain());
+      new_node.SetExecutionProviderType(chain_node.GetExecutionProviderType());
+
+      removed_nodes.push_front(chain_node.Index());
+      input_arg = output_arg;
+    }
+
+    removed_nodes.push_front(node.Index());
+    removed_nodes.push_front(output_transpose->Index());
+  }
+
+  for (auto index : removed_nodes) {
+    graph.RemoveNode(index);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
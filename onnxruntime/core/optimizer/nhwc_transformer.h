@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NhwcTransformer
+
+Transformer that removes the Transpose pairs models exported from NHWC frameworks wrap their convolutions in.
+A chain of 2D Conv, FusedConv and pooling nodes, and of the element-wise activations in between, that starts at a
+Transpose from NHWC to NCHW and ends at a Transpose back to NHWC is replaced by the NHWC nodes of the same operators,
+which work on the NHWC tensors directly.
+*/
+class NhwcTransformer : public GraphTransformer {
+ public:
+  NhwcTransformer() noexcept : GraphTransformer("NhwcTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/optimization_report.h"
+
+#include <algorithm>
+
+#include "core/optimizer/rule_based_graph_transformer.h"
+
+namespace onnxruntime {
+namespace {
+std::string EscapeJson(const std::string& s) {
+  std::string escaped;
+  escaped.reserve(s.size());
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      escaped += ' ';
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+void WriteCounts(std::ostream& out, const std::map<std::string, size_t>& counts) {
+  out << "{";
+  bool first = true;
+  for (const auto& entry : counts) {
+    out << (first ? "" : ", ") << "\"" << EscapeJson(entry.first) << "\": " << entry.second;
+    first = false;
+  }
+  out << "}";
+}
+}  // namespace
+
+void OptimizationReport::AfterApply(const GraphTransformer& transformer, int level, const Graph& graph,
+                                    bool modified) {
+  auto record = std::find_if(transformers_.begin(), transformers_.end(), [&](const TransformerRecord& r) {
+    return r.name == transformer.Name() && r.level == level;
+  });
+  if (record == transformers_.end()) {
+    transformers_.push_back(TransformerRecord{transformer.Name(), level});
+    record = transformers_.end() - 1;
+  }
+
+  ++record->applications;
+  if (modified) ++record->modifications;
+
+  // the nodes a transformer adds get new indices, so the ones at or above the previous max index were added
+  size_t added = 0;
+  for (int i = max_node_index_before_; i < graph.MaxNodeIndex(); ++i) {
+    if (graph.GetNode(i) != nullptr) ++added;
+  }
+  record->nodes_added += added;
+  record->nodes_removed += static_cast<size_t>(node_count_before_) + added - static_cast<size_t>(graph.NumberOfNodes());
+
+  const auto* rule_based = dynamic_cast<const RuleBasedGraphTransformer*>(&transformer);
+  if (rule_based != nullptr) {
+    record->rule_applications = rule_based->RuleApplicationCounts();
+  }
+}
+
+void OptimizationReport::AddNodes(const Graph& graph) {
+  for (const auto& node : graph.Nodes()) {
+    std::string op_type = node.Domain().empty() || node.Domain() == kOnnxDomainAlias
+                              ? node.OpType()
+                              : node.Domain() + "." + node.OpType();
+    ++op_types_[op_type][node.GetExecutionProviderType()];
+    ++execution_providers_[node.GetExecutionProviderType()];
+    ++final_node_count_;
+
+    for (const auto* subgraph : node.GetSubgraphs()) {
+      AddNodes(*subgraph);
+    }
+  }
+}
+
+void OptimizationReport::SetFinalGraph(const Graph& graph) {
+  final_node_count_ = 0;
+  op_types_.clear();
+  execution_providers_.clear();
+  AddNodes(graph);
+}
+
+void OptimizationReport::WriteJson(std::ostream& out) const {
+  out << "{\n  \"transformers\": [";
+  for (size_t i = 0; i < transformers_.size(); ++i) {
+    const auto& record = transformers_[i];
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\"name\": \"" << EscapeJson(record.name) << "\", \"level\": " << record.level
+        << ", \"applications\": " << record.applications << ", \"modifications\": " << record.modifications
+        << ", \"nodes_removed\": " << record.nodes_removed << ", \"nodes_added\": " << record.nodes_added;
+    if (!record.rule_applications.empty()) {
+      out << ", \"rules\": ";
+      WriteCounts(out, record.rule_applications);
+    }
+    out << "}";
+  }
+  out << "\n  ],\n  \"node_count\": " << final_node_count_ << ",\n  \"op_types\": {";
+  bool first = true;
+  for (const auto& entry : op_types_) {
+    out << (first ? "\n" : ",\n") << "    \"" << EscapeJson(entry.first) << "\": ";
+    WriteCounts(out, entry.second);
+    first = false;
+  }
+  out << "\n  },\n  \"execution_providers\": ";
+  WriteCounts(out, execution_providers_);
+  out << "\n}\n";
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "core/graph/graph.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class OptimizationReport
+
+Records what each graph transformer of a session did to the main graph, and the op types and execution providers of
+the nodes of the graph the transformers left, so it can be checked that the expected optimizations fired.
+*/
+class OptimizationReport {
+ public:
+  struct TransformerRecord {
+    std::string name;
+    // TransformerLevel the transformer was registered with, Default for the ones the session runs itself
+    int level;
+    // number of calls of Apply, and of the calls that modified the graph
+    size_t applications = 0;
+    size_t modifications = 0;
+    size_t nodes_removed = 0;
+    size_t nodes_added = 0;
+    // for a RuleBasedGraphTransformer, the number of nodes each rewrite rule modified the graph on
+    std::map<std::string, size_t> rule_applications;
+  };
+
+  /** Start recording an application of a transformer on graph. */
+  void BeforeApply(const Graph& graph) {
+    node_count_before_ = graph.NumberOfNodes();
+    max_node_index_before_ = graph.MaxNodeIndex();
+  }
+
+  /** Record the application of transformer on graph started by BeforeApply. */
+  void AfterApply(const GraphTransformer& transformer, int level, const Graph& graph, bool modified);
+
+  /** Record the op types and execution providers of the nodes of graph and its subgraphs. */
+  void SetFinalGraph(const Graph& graph);
+
+  const std::vector<TransformerRecord>& Transformers() const { return transformers_; }
+
+  void WriteJson(std::ostream& out) const;
+
+ private:
+  void AddNodes(const Graph& graph);
+
+  int node_count_before_ = 0;
+  int max_node_index_before_ = 0;
+
+  std::vector<TransformerRecord> transformers_;
+
+  size_t final_node_count_ = 0;
+  // op type, prefixed by the domain if it isn't the ONNX domain -> execution provider -> number of nodes
+  std::map<std::string, std::map<std::string, size_t>> op_types_;
+  std::map<std::string, size_t> execution_providers_;
+};
+
+}  // namespace onnxruntime
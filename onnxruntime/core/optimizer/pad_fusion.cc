@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/pad_fusion.h"
+
+#include <algorithm>
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+// Reads the pads of a Pad that pads with zeros. The opset 11 Pad has them as inputs, which must be constant.
+static bool GetZeroPads(const Graph& graph, const Node& pad_node, std::vector<int64_t>& pads) {
+  const auto* mode_attr = graph_utils::GetNodeAttribute(pad_node, "mode");
+  if (mode_attr != nullptr && mode_attr->s() != "constant") {
+    return false;
+  }
+
+  if (graph_utils::MatchesOpSinceVersion(pad_node, {2})) {
+    const auto* value_attr = graph_utils::GetNodeAttribute(pad_node, "value");
+    return (value_attr == nullptr || value_attr->f() == 0.0f) &&
+           graph_utils::GetRepeatedNodeAttributeValues(pad_node, "pads", pads);
+  }
+
+  const auto& inputs = pad_node.InputDefs();
+  if (inputs.size() < 2 || !optimizer_utils::GetInt64InitializerValues(graph, *inputs[1], pads)) {
+    return false;
+  }
+  float value = 0.0f;
+  return inputs.size() < 3 || !inputs[2]->Exists() ||
+         (optimizer_utils::GetScalarInitializerValue(graph, *inputs[2], value) && value == 0.0f);
+}
+
+// Checks whether zeros padded in front of the spatial dimensions of the input of node give the same results as the
+// same pads in its 'pads' attribute.
+static bool CanFoldZeroPads(const Node& node, const Node& pad_node, const std::vector<int64_t>& pads) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11})) {
+    // the implicit padding of Conv is zeros
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {7, 10, 11})) {
+    // the padded zeros are averaged in only when the implicit padding is counted
+    const auto* count_include_pad_attr = graph_utils::GetNodeAttribute(node, "count_include_pad");
+    return count_include_pad_attr != nullptr && count_include_pad_attr->i() != 0;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11})) {
+    // the implicit padding of MaxPool is ignored, which is the same as zeros only for an input that isn't negative,
+    // such as the output of a Relu, and for the windows that aren't only padding. The indices would change.
+    if (node.OutputDefs().size() > 1 && node.OutputDefs()[1]->Exists()) {
+      return false;
+    }
+    if (pad_node.GetInputEdgesCount() != 1 ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(pad_node.InputEdgesBegin()->GetNode(), "Relu", {6})) {
+      return false;
+    }
+
+    std::vector<int64_t> kernel_shape;
+    std::vector<int64_t> dilations;
+    std::vector<int64_t> node_pads;
+    if (!graph_utils::GetRepeatedNodeAttributeValues(node, "kernel_shape", kernel_shape) ||
+        (graph_utils::GetRepeatedNodeAttributeValues(node, "dilations", dilations) &&
+         std::any_of(dilations.cbegin(), dilations.cend(), [](int64_t dilation) { return dilation != 1; }))) {
+      return false;
+    }
+    graph_utils::GetRepeatedNodeAttributeValues(node, "pads", node_pads);
+
+    const size_t rank = pads.size() / 2;
+    const size_t spatial_rank = rank - 2;
+    if (kernel_shape.size() != spatial_rank) {
+      return false;
+    }
+    for (size_t i = 0; i < spatial_rank; ++i) {
+      const int64_t begin = pads[2 + i] + (node_pads.empty() ? 0 : node_pads[i]);
+      const int64_t end = pads[rank + 2 + i] + (node_pads.empty() ? 0 : node_pads[spatial_rank + i]);
+      if (begin >= kernel_shape[i] || end >= kernel_shape[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+Status PadFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  auto& pad_node = node;
+  const auto& next_node = *pad_node.OutputNodesBegin();
+
+  std::vector<int64_t> pads;
+  ORT_ENFORCE(GetZeroPads(graph, pad_node, pads));
+  const size_t rank = pads.size() / 2;
+  const size_t spatial_rank = rank - 2;
+
+  // the pads of the spatial dimensions are added to those of the next node, like [x1_begin, x2_begin, x1_end, x2_end]
+  std::vector<int64_t> fused_pads;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(next_node, "pads", fused_pads)) {
+    fused_pads.assign(2 * spatial_rank, 0);
+  }
+  for (size_t i = 0; i < spatial_rank; ++i) {
+    fused_pads[i] += pads[2 + i];
+    fused_pads[spatial_rank + i] += pads[rank + 2 + i];
+  }
+
+  if (graph_utils::RemoveNode(graph, pad_node)) {
+    auto* mutable_next_node = graph.GetNode(next_node.Index());
+    mutable_next_node->ClearAttribute("pads");
+    mutable_next_node->AddAttribute("pads", fused_pads);
+
+    rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  }
+
+  return Status::OK();
+}
+
+bool PadFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pad", {2, 11}) ||
+      node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+
+  // the padded tensor has to be the input of the next node, not its weights
+  const auto& next_node = *node.OutputNodesBegin();
+  if (node.OutputEdgesBegin()->GetDstArgIndex() != 0 ||
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return false;
+  }
+
+  const auto* auto_pad_attr = graph_utils::GetNodeAttribute(next_node, "auto_pad");
+  if (auto_pad_attr != nullptr && auto_pad_attr->s() != "NOTSET") {
+    return false;
+  }
+
+  // only the spatial dimensions can be padded, without cropping
+  std::vector<int64_t> pads;
+  if (!GetZeroPads(graph, node, pads) || pads.size() % 2 != 0 || pads.size() < 6) {
+    return false;
+  }
+  const size_t rank = pads.size() / 2;
+  if (pads[0] != 0 || pads[1] != 0 || pads[rank] != 0 || pads[rank + 1] != 0 ||
+      std::any_of(pads.cbegin(), pads.cend(), [](int64_t pad) { return pad < 0; })) {
+    return false;
+  }
+
+  std::vector<int64_t> next_pads;
+  if (graph_utils::GetRepeatedNodeAttributeValues(next_node, "pads", next_pads) &&
+      next_pads.size() != 2 * (rank - 2)) {
+    return false;
+  }
+
+  return CanFoldZeroPads(next_node, node, pads);
+}
+
+}  // namespace onnxruntime
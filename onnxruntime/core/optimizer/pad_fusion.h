@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class PadFusion
+
+Rewrite rule that folds a Pad of zeros of the spatial dimensions into the 'pads' attribute of the following
+Conv, AveragePool or MaxPool, so the padded copy of the input isn't materialized.
+
+It is attempted to be triggered only on nodes with op type "Pad".
+*/
+class PadFusion : public RewriteRule {
+ public:
+  PadFusion() noexcept : RewriteRule("PadFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Pad"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,388 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_fusion.h"
+
+#include <cmath>
+#include <vector>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+struct QuantizationParams {
+  float scale{1.f};
+  uint8_t zero_point{0};
+
+  bool operator==(const QuantizationParams& other) const {
+    return scale == other.scale && zero_point == other.zero_point;
+  }
+};
+
+bool IsUint8Tensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_UINT8;
+}
+
+// the type of a NodeArg once quantized, which keeps its shape
+TypeProto QuantizedType(const NodeArg& arg) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  return type;
+}
+
+template <typename T>
+bool GetInitializerValues(const Graph& graph, const NodeArg& arg, TensorProto_DataType data_type,
+                          std::vector<T>& values) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != data_type) {
+    return false;
+  }
+
+  int64_t size = 1;
+  for (auto dim : tensor_proto->dims()) {
+    size *= dim;
+  }
+  values.resize(static_cast<size_t>(size));
+  return utils::UnpackTensor<T>(*tensor_proto,
+                                utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().data() : nullptr,
+                                tensor_proto->raw_data().size(), values.data(), size)
+      .IsOK();
+}
+
+template <typename T>
+NodeArg& AddInitializer(Graph& graph, const std::string& base_name, TensorProto_DataType data_type,
+                        const std::vector<int64_t>& dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  tensor.set_data_type(data_type);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    shape->add_dim()->set_dim_value(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(tensor.name(), &type);
+}
+
+// Reads the constant scalar scale and zero point of a QuantizeLinear or DequantizeLinear node with a uint8
+// quantized value. The zero point is 0 if the node has none.
+bool GetQuantizationParams(const Graph& graph, const Node& node, QuantizationParams& params) {
+  const auto& inputs = node.InputDefs();
+  if (!optimizer_utils::GetScalarInitializerValue(graph, *inputs[1], params.scale)) {
+    return false;
+  }
+
+  params.zero_point = 0;
+  if (inputs.size() > 2 && inputs[2]->Exists()) {
+    std::vector<uint8_t> zero_point;
+    if (!GetInitializerValues(graph, *inputs[2], TensorProto_DataType_UINT8, zero_point) || zero_point.size() != 1) {
+      return false;
+    }
+    params.zero_point = zero_point[0];
+  }
+
+  return IsUint8Tensor(node.OpType() == "DequantizeLinear" ? *inputs[0] : *node.OutputDefs()[0]);
+}
+
+// the zero point input of a QuantizeLinear or DequantizeLinear node, which is created if the node has none
+NodeArg& GetZeroPointArg(Graph& graph, Node& node) {
+  auto& inputs = node.MutableInputDefs();
+  if (inputs.size() > 2 && inputs[2]->Exists()) {
+    return *inputs[2];
+  }
+  return AddInitializer<uint8_t>(graph, node.Name() + "_zero_point", TensorProto_DataType_UINT8, {}, {0});
+}
+
+// Returns the producer of input input_index of node if it has the given op type and is assigned to the same
+// execution provider. Unlike optimizer_utils::GetInputNode the producer may have other consumers.
+Node* GetProducer(Graph& graph, const Node& node, int input_index, const std::string& op_type) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    const Node& input_node = it->GetNode();
+    if (it->GetDstArgIndex() == input_index &&
+        graph_utils::IsSupportedOptypeVersionAndDomain(input_node, op_type, {10}) &&
+        input_node.GetExecutionProviderType() == node.GetExecutionProviderType()) {
+      return graph.GetNode(input_node.Index());
+    }
+  }
+  return nullptr;
+}
+
+// Removes node if its outputs aren't used anymore.
+void RemoveIfUnused(Graph& graph, Node& node) {
+  if (node.GetOutputEdgesCount() == 0 && !graph.IsNodeOutputsInGraphOutputs(node)) {
+    graph.RemoveNode(node.Index());
+  }
+}
+
+// Makes the consumers of the output of node use value instead.
+// Returns false if the output is a graph output or is used by a subgraph, which keep the name of the value.
+bool ReplaceOutputUses(Graph& graph, Node& node, NodeArg& value) {
+  if (graph.IsNodeOutputsInGraphOutputs(node)) {
+    return false;
+  }
+
+  std::vector<std::pair<NodeIndex, int>> uses;
+  for (auto it = node.OutputEdgesBegin(); it != node.OutputEdgesEnd(); ++it) {
+    if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+      return false;
+    }
+    uses.emplace_back(it->GetNode().Index(), it->GetDstArgIndex());
+  }
+
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  for (const auto& use : uses) {
+    graph.GetNode(use.first)->MutableInputDefs()[use.second] = &value;
+  }
+  return true;
+}
+
+// Reads the float values of the bias of a Conv, either a float initializer or the DequantizeLinear of an int32
+// initializer, which is returned in bias_dequantize.
+bool GetBiasValues(Graph& graph, const Node& conv, std::vector<float>& values, Node*& bias_dequantize) {
+  const auto& bias = *conv.InputDefs()[2];
+  bias_dequantize = nullptr;
+  if (GetInitializerValues(graph, bias, TensorProto_DataType_FLOAT, values)) {
+    return true;
+  }
+
+  bias_dequantize = GetProducer(graph, conv, 2, "DequantizeLinear");
+  if (bias_dequantize == nullptr) {
+    return false;
+  }
+
+  const auto& inputs = bias_dequantize->InputDefs();
+  std::vector<int32_t> quantized;
+  float scale;
+  std::vector<int32_t> zero_point{0};
+  if (!GetInitializerValues(graph, *inputs[0], TensorProto_DataType_INT32, quantized) ||
+      !optimizer_utils::GetScalarInitializerValue(graph, *inputs[1], scale) ||
+      (inputs.size() > 2 && inputs[2]->Exists() &&
+       (!GetInitializerValues(graph, *inputs[2], TensorProto_DataType_INT32, zero_point) ||
+        zero_point.size() != 1))) {
+    return false;
+  }
+
+  values.resize(quantized.size());
+  for (size_t i = 0; i < quantized.size(); ++i) {
+    values[i] = (quantized[i] - zero_point[0]) * scale;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool QDQFusion::MoveQDQThroughDataMovement(Graph& graph) const {
+  bool modified = false;
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr ||
+        !(graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Reshape", {5}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Transpose", {1})) ||
+        !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    QuantizationParams params;
+    auto& input = *node->MutableInputDefs()[0];
+    auto& output = *node->MutableOutputDefs()[0];
+
+    // DequantizeLinear -> node becomes node -> DequantizeLinear
+    Node* dequantize = optimizer_utils::GetInputNode(graph, *node, 0, "DequantizeLinear", {10});
+    if (dequantize != nullptr && GetQuantizationParams(graph, *dequantize, params)) {
+      auto quantized_type = QuantizedType(output);
+      auto& quantized_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output.Name() + "_quantized"),
+                                                        &quantized_type);
+      auto inputs = node->MutableInputDefs();
+      inputs[0] = dequantize->MutableInputDefs()[0];
+      auto dequantize_inputs = dequantize->MutableInputDefs();
+      dequantize_inputs[0] = &quantized_output;
+
+      graph.AddNode(graph.GenerateNodeName(node->Name()), node->OpType(), node->Description(), inputs,
+                    {&quantized_output}, &node->GetAttributes(), node->Domain())
+          .SetExecutionProviderType(node->GetExecutionProviderType());
+      graph.AddNode(graph.GenerateNodeName(dequantize->Name()), "DequantizeLinear", "", dequantize_inputs, {&output})
+          .SetExecutionProviderType(dequantize->GetExecutionProviderType());
+
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+      graph.RemoveNode(dequantize->Index());
+      modified = true;
+      continue;
+    }
+
+    // node -> QuantizeLinear becomes QuantizeLinear -> node
+    Node* quantize = optimizer_utils::GetOnlyChildNode(graph, *node, "QuantizeLinear", {10});
+    if (quantize != nullptr && quantize->InputDefs()[0] == &output && GetQuantizationParams(graph, *quantize, params)) {
+      auto quantized_type = QuantizedType(input);
+      auto& quantized_input = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(input.Name() + "_quantized"),
+                                                       &quantized_type);
+      auto quantize_inputs = quantize->MutableInputDefs();
+      quantize_inputs[0] = &input;
+      auto inputs = node->MutableInputDefs();
+      inputs[0] = &quantized_input;
+
+      graph.AddNode(graph.GenerateNodeName(quantize->Name()), "QuantizeLinear", "", quantize_inputs,
+                    {&quantized_input})
+          .SetExecutionProviderType(quantize->GetExecutionProviderType());
+      graph.AddNode(graph.GenerateNodeName(node->Name()), node->OpType(), node->Description(), inputs,
+                    quantize->MutableOutputDefs(), &node->GetAttributes(), node->Domain())
+          .SetExecutionProviderType(node->GetExecutionProviderType());
+
+      graph_utils::RemoveNodeOutputEdges(graph, *quantize);
+      graph.RemoveNode(quantize->Index());
+      graph.RemoveNode(node->Index());
+      modified = true;
+    }
+  }
+
+  return modified;
+}
+
+bool QDQFusion::FuseQLinearOps(Graph& graph) const {
+  bool modified = false;
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr || !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const bool is_conv = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Conv", {1, 11});
+    const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMul", {1, 9});
+    if (!is_conv && !is_matmul) {
+      continue;
+    }
+
+    QuantizationParams input_params, weights_params, output_params;
+    Node* input_dequantize = GetProducer(graph, *node, 0, "DequantizeLinear");
+    Node* weights_dequantize = GetProducer(graph, *node, 1, "DequantizeLinear");
+    Node* quantize = optimizer_utils::GetOnlyChildNode(graph, *node, "QuantizeLinear", {10});
+    if (input_dequantize == nullptr || weights_dequantize == nullptr || input_dequantize == weights_dequantize ||
+        quantize == nullptr || !GetQuantizationParams(graph, *input_dequantize, input_params) ||
+        !GetQuantizationParams(graph, *weights_dequantize, weights_params) ||
+        !GetQuantizationParams(graph, *quantize, output_params)) {
+      continue;
+    }
+
+    // the bias of QLinearConv is int32 with the scale of the accumulators and no zero point
+    NodeArg* quantized_bias = nullptr;
+    Node* bias_dequantize = nullptr;
+    const auto& inputs = node->InputDefs();
+    if (inputs.size() > 2 && inputs[2]->Exists()) {
+      std::vector<float> bias;
+      if (!GetBiasValues(graph, *node, bias, bias_dequantize)) {
+        continue;
+      }
+
+      const float bias_scale = input_params.scale * weights_params.scale;
+      std::vector<int32_t> quantized(bias.size());
+      for (size_t i = 0; i < bias.size(); ++i) {
+        quantized[i] = static_cast<int32_t>(std::round(bias[i] / bias_scale));
+      }
+      quantized_bias = &AddInitializer(graph, inputs[2]->Name() + "_quantized", TensorProto_DataType_INT32,
+                                       {static_cast<int64_t>(quantized.size())}, quantized);
+    }
+
+    std::vector<NodeArg*> qlinear_inputs{
+        input_dequantize->MutableInputDefs()[0], input_dequantize->MutableInputDefs()[1],
+        &GetZeroPointArg(graph, *input_dequantize),
+        weights_dequantize->MutableInputDefs()[0], weights_dequantize->MutableInputDefs()[1],
+        &GetZeroPointArg(graph, *weights_dequantize),
+        quantize->MutableInputDefs()[1], &GetZeroPointArg(graph, *quantize)};
+    if (quantized_bias != nullptr) {
+      qlinear_inputs.push_back(quantized_bias);
+    }
+
+    graph.AddNode(graph.GenerateNodeName(node->Name() + "_quantized"), is_conv ? "QLinearConv" : "QLinearMatMul",
+                  "fused " + node->OpType() + " with DequantizeLinear/QuantizeLinear",
+                  qlinear_inputs, quantize->MutableOutputDefs(), is_conv ? &node->GetAttributes() : nullptr)
+        .SetExecutionProviderType(node->GetExecutionProviderType());
+
+    graph_utils::RemoveNodeOutputEdges(graph, *quantize);
+    graph.RemoveNode(quantize->Index());
+    graph.RemoveNode(node->Index());
+    for (Node* dequantize : {input_dequantize, weights_dequantize, bias_dequantize}) {
+      if (dequantize != nullptr) {
+        RemoveIfUnused(graph, *dequantize);
+      }
+    }
+    modified = true;
+  }
+
+  return modified;
+}
+
+bool QDQFusion::RemovePairs(Graph& graph, bool dequantize_first) const {
+  const std::string first_op_type = dequantize_first ? "DequantizeLinear" : "QuantizeLinear";
+  const std::string second_op_type = dequantize_first ? "QuantizeLinear" : "DequantizeLinear";
+
+  bool modified = false;
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    auto* node = graph.GetNode(index);
+    if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, second_op_type, {10}) ||
+        !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    QuantizationParams params, first_params;
+    Node* first = GetProducer(graph, *node, 0, first_op_type);
+    if (first == nullptr || !GetQuantizationParams(graph, *node, params) ||
+        !GetQuantizationParams(graph, *first, first_params) || !(params == first_params) ||
+        !ReplaceOutputUses(graph, *node, *first->MutableInputDefs()[0])) {
+      continue;
+    }
+
+    graph.RemoveNode(node->Index());
+    RemoveIfUnused(graph, *first);
+    modified = true;
+  }
+
+  return modified;
+}
+
+Status QDQFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
+    ORT_RETURN_IF_ERROR(Recurse(*graph.GetNode(index), modified, graph_level));
+  }
+
+  // each pass matches the edges of the graph resolved after the previous one
+  while (MoveQDQThroughDataMovement(graph)) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  if (RemovePairs(graph, /*dequantize_first*/ true)) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  if (FuseQLinearOps(graph)) {
+    modified = true;
+    ORT_RETURN_IF_ERROR(graph.Resolve());
+  }
+
+  // last, as removing them earlier would break the patterns of the QLinear ops
+  if (RemovePairs(graph, /*dequantize_first*/ false)) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QDQFusion
+
+Transformer that runs the DequantizeLinear -> op -> QuantizeLinear patterns of quantized models in uint8:
+  - DequantizeLinear moves down, and QuantizeLinear up, through Reshape and Transpose, which then move the uint8
+    values instead of the float ones.
+  - DequantizeLinear -> QuantizeLinear with the same scale and zero point is removed, as it's exact.
+  - DequantizeLinear(x), DequantizeLinear(w) -> Conv/MatMul -> QuantizeLinear become QLinearConv/QLinearMatMul,
+    with the bias of Conv requantized to int32 with the scale of the accumulators.
+  - QuantizeLinear -> DequantizeLinear with the same scale and zero point left between float nodes is removed,
+    which only drops the rounding of the pair.
+The scales and zero points have to be constant scalars, and the quantized values uint8, as for the CPU kernels.
+*/
+class QDQFusion : public GraphTransformer {
+ public:
+  QDQFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  bool MoveQDQThroughDataMovement(Graph& graph) const;
+  bool FuseQLinearOps(Graph& graph) const;
+  bool RemovePairs(Graph& graph, bool dequantize_first) const;
+};
+
+}  // namespace onnxruntime
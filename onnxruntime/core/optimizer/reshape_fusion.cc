@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/reshape_fusion.h"
+#include "core/graph/graph.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+
+static bool IsShapeOnlyOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Flatten", {1, 9}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1});
+}
+
+// Checks that the only input of node produced by another node is the data input, so that the other inputs
+// (the 'shape' of a Reshape) are initializers that don't leave any nodes behind when node is removed.
+static bool HasOnlyDataInputEdge(const Node& node) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the shape-only node producing the data input of node if node is its only consumer.
+static const Node* GetShapeOnlyInputNode(const Graph& graph, const Node& node) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() != 0) {
+      continue;
+    }
+
+    const Node& input_node = it->GetNode();
+    if (!IsShapeOnlyOp(input_node) || !HasOnlyDataInputEdge(input_node) ||
+        input_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        input_node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(input_node)) {
+      return nullptr;
+    }
+    return &input_node;
+  }
+
+  return nullptr;
+}
+
+// Computes the 'shape' input of a Reshape from input_shape to output_shape: known dimensions are given
+// explicitly, symbolic dimensions at the same position of the input are copied with 0, and at most one
+// other dimension is inferred with -1.
+static bool GetReshapeDims(const TensorShapeProto* input_shape, const TensorShapeProto& output_shape,
+                           std::vector<int64_t>& dims) {
+  bool has_inferred_dim = false;
+  for (int i = 0; i < output_shape.dim_size(); ++i) {
+    const auto& dim = output_shape.dim(i);
+    if (dim.has_dim_value()) {
+      // 0 would be interpreted as copying the input dimension
+      if (dim.dim_value() <= 0) {
+        return false;
+      }
+      dims.push_back(dim.dim_value());
+    } else if (input_shape != nullptr && i < input_shape->dim_size() &&
+               optimizer_utils::IsSameDim(dim, input_shape->dim(i))) {
+      dims.push_back(0);
+    } else if (!has_inferred_dim) {
+      has_inferred_dim = true;
+      dims.push_back(-1);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status ReshapeFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const {
+  const auto* output_shape = node.OutputDefs()[0]->Shape();
+
+  // Remove the node if it doesn't change the shape.
+  if (optimizer_utils::IsSameShape(node.InputDefs()[0]->Shape(), output_shape)) {
+    if (!graph.IsNodeOutputsInGraphOutputs(node) && graph_utils::RemoveNode(graph, node)) {
+      rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+    }
+    return Status::OK();
+  }
+
+  const Node* input_node = GetShapeOnlyInputNode(graph, node);
+  if (input_node == nullptr || output_shape == nullptr) {
+    return Status::OK();
+  }
+
+  NodeArg* data_arg = graph.GetNode(input_node->Index())->MutableInputDefs()[0];
+  std::vector<int64_t> dims;
+  if (!GetReshapeDims(data_arg->Shape(), *output_shape, dims)) {
+    return Status::OK();
+  }
+
+  ONNX_NAMESPACE::TensorProto shape_tensor_proto;
+  shape_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  shape_tensor_proto.set_name(graph.GenerateNodeArgName(node.Name() + "_shape"));
+  shape_tensor_proto.set_raw_data(dims.data(), dims.size() * sizeof(int64_t));
+  shape_tensor_proto.add_dims(static_cast<int64_t>(dims.size()));
+  graph.AddInitializedTensor(shape_tensor_proto);
+  NodeArg* shape_arg = &graph.GetOrCreateNodeArg(shape_tensor_proto.name(), nullptr);
+
+  Node& reshape_node = graph.AddNode(graph.GenerateNodeName("Reshape"),
+                                     "Reshape",
+                                     "fused " + input_node->OpType() + " and " + node.OpType(),
+                                     {data_arg, shape_arg},
+                                     node.MutableOutputDefs());
+  reshape_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+  // Move the edges of the two nodes to the Reshape and remove them.
+  for (auto it = input_node->InputEdgesBegin(); it != input_node->InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() == 0) {
+      graph.AddEdge(it->GetNode().Index(), reshape_node.Index(), it->GetSrcArgIndex(), 0);
+    }
+  }
+  std::vector<Node::EdgeEnd> output_edges(node.OutputEdgesBegin(), node.OutputEdgesEnd());
+  for (const auto& edge : output_edges) {
+    graph.RemoveEdge(node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+    graph.AddEdge(reshape_node.Index(), edge.GetNode().Index(), edge.GetSrcArgIndex(), edge.GetDstArgIndex());
+  }
+
+  const NodeIndex input_node_index = input_node->Index();
+  graph.RemoveNode(node.Index());
+  graph.RemoveNode(input_node_index);
+  rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+
+  return Status::OK();
+}
+
+bool ReshapeFusion::SatisfyCondition(const Graph& graph, const Node& node) const {
+  ORT_UNUSED_PARAMETER(graph);
+  // The data input and output of these operators are always the first.
+  return IsShapeOnlyOp(node) && HasOnlyDataInputEdge(node) && node.OutputDefs()[0]->Shape() != nullptr;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class ReshapeFusion
+
+Rewrite rule that collapses a chain of two shape-only operators (Reshape, Flatten, Squeeze, Unsqueeze) into a
+single Reshape, provided the output shape of the chain is statically known. Symbolic dimensions are kept when
+they are copied from the same position of the input, and a single remaining unknown dimension is inferred.
+Longer chains are collapsed pairwise. The rule also removes shape-only operators whose output shape equals
+their input shape.
+
+It is attempted to be triggered only on nodes with op type "Reshape", "Flatten", "Squeeze" or "Unsqueeze".
+*/
+class ReshapeFusion : public RewriteRule {
+ public:
+  ReshapeFusion() noexcept : RewriteRule("ReshapeFusion") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Reshape", "Flatten", "Squeeze", "Unsqueeze"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect) const override;
+};
+
+}  // namespace onnxruntime
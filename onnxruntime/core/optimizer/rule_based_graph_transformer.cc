@@ -29,7 +29,12 @@ Status RuleBasedGraphTransformer::ApplyRulesOnNode(Graph& graph, Node& node,
                                                    const std::vector<std::reference_wrapper<const RewriteRule>>& rules,
                                                    RuleEffect& rule_effect) const {
   for (const RewriteRule& rule : rules) {
-    ORT_RETURN_IF_ERROR(rule.CheckConditionAndApply(graph, node, rule_effect));
+    auto effect = RuleEffect::kNone;
+    ORT_RETURN_IF_ERROR(rule.CheckConditionAndApply(graph, node, effect));
+    if (effect != RuleEffect::kNone) {
+      rule_effect = effect;
+      ++rule_application_counts_[rule.Name()];
+    }
     // If the current node was removed as a result of a rule, stop rule application for that node.
     if (rule_effect == RuleEffect::kRemovedCurrentNode) {
       break;
@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/static_quantization_transformer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <vector>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// uint8 linear quantization: x = (q - zero_point) * scale
+struct QuantizationParams {
+  float scale{1.f};
+  uint8_t zero_point{0};
+};
+
+// The scale and zero point of the values in [min, max]
+QuantizationParams ComputeQuantizationParams(float min, float max) {
+  // the range has to contain 0, which is then exactly representable, e.g. for the padding of Conv
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+
+  QuantizationParams params;
+  if (max > min) {
+    params.scale = (max - min) / 255.f;
+    params.zero_point = static_cast<uint8_t>(std::min(255.f, std::max(0.f, std::round(-min / params.scale))));
+  }
+  return params;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// the type of a float NodeArg once quantized, which keeps its shape
+TypeProto QuantizedType(const NodeArg& arg) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_UINT8);
+  return type;
+}
+
+template <typename T>
+NodeArg& AddInitializer(Graph& graph, const std::string& base_name, TensorProto_DataType data_type,
+                        const std::vector<int64_t>& dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  tensor.set_data_type(data_type);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    shape->add_dim()->set_dim_value(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(tensor.name(), &type);
+}
+
+// a quantized value with its scale and zero point inputs of the QLinear ops
+struct QuantizedValue {
+  NodeArg* value;
+  NodeArg* scale;
+  NodeArg* zero_point;
+  QuantizationParams params;
+};
+
+QuantizedValue AddQuantizedValue(Graph& graph, const std::string& base_name, const QuantizationParams& params,
+                                   NodeArg* value) {
+  return {value,
+          &AddInitializer<float>(graph, base_name + "_scale", TensorProto_DataType_FLOAT, {}, {params.scale}),
+          &AddInitializer<uint8_t>(graph, base_name + "_zero_point", TensorProto_DataType_UINT8, {},
+                                   {params.zero_point}),
+          params};
+}
+
+NodeArg& AddQuantizedArg(Graph& graph, const NodeArg& arg) {
+  auto quantized_type = QuantizedType(arg);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(arg.Name() + "_quantized"), &quantized_type);
+}
+
+// Quantizes the weights per tensor, with the range of their values.
+NodeArg& AddQuantizedWeights(Graph& graph, const TensorProto& weights, QuantizationParams& params) {
+  Initializer float_data(&weights);
+  const float* data = float_data.data<float>();
+  const auto size = static_cast<size_t>(float_data.size());
+  const auto min_max = std::minmax_element(data, data + size);
+  params = ComputeQuantizationParams(*min_max.first, *min_max.second);
+
+  std::vector<uint8_t> quantized(size);
+  for (size_t i = 0; i < size; ++i) {
+    quantized[i] = static_cast<uint8_t>(
+        std::min(255.f, std::max(0.f, std::round(data[i] / params.scale) + params.zero_point)));
+  }
+
+  return AddInitializer(graph, weights.name() + "_quantized", TensorProto_DataType_UINT8,
+                        float_data.dims(), quantized);
+}
+
+// Quantizes the bias of QLinearConv to int32, with the scale of the accumulators and no zero point.
+NodeArg& AddQuantizedBias(Graph& graph, const TensorProto& bias, float scale) {
+  Initializer float_data(&bias);
+  const float* data = float_data.data<float>();
+  std::vector<int32_t> quantized(static_cast<size_t>(float_data.size()));
+  for (size_t i = 0; i < quantized.size(); ++i) {
+    quantized[i] = static_cast<int32_t>(std::round(data[i] / scale));
+  }
+
+  return AddInitializer(graph, bias.name() + "_quantized", TensorProto_DataType_INT32, float_data.dims(), quantized);
+}
+
+bool IsFusedConvWithRelu(const Node& node) {
+  if (node.OpType() != "FusedConv" || node.Domain() != kMSDomain) {
+    return false;
+  }
+  const auto* activation = graph_utils::GetNodeAttribute(node, "activation");
+  return activation != nullptr && activation->s() == "Relu";
+}
+
+}  // namespace
+
+bool StaticQuantizationTransformer::CanQuantize(const Graph& graph, const Node& node) const {
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return false;
+  }
+
+  const bool is_conv = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+                       IsFusedConvWithRelu(node);
+  const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9});
+  if (!is_conv && !is_matmul) {
+    return false;
+  }
+
+  const auto& inputs = node.InputDefs();
+  const auto& output = *node.OutputDefs()[0];
+  if (inputs.size() > (is_conv ? 3u : 2u) || !IsFloatTensor(*inputs[0]) || !IsFloatTensor(output) ||
+      ranges_.count(inputs[0]->Name()) == 0 || ranges_.count(output.Name()) == 0) {
+    return false;
+  }
+
+  // the weights of QLinearMatMul have to be a matrix, as they are quantized per tensor
+  const auto* weights = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+  if (weights == nullptr || weights->data_type() != TensorProto_DataType_FLOAT ||
+      (is_matmul && weights->dims_size() != 2)) {
+    return false;
+  }
+
+  return inputs.size() < 3 || !inputs[2]->Exists() ||
+         graph_utils::GetConstantInitializer(graph, inputs[2]->Name()) != nullptr;
+}
+
+Status StaticQuantizationTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  // QuantizeLinear, DequantizeLinear and the QLinear ops are in opset 10
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  if (ranges_.empty() || onnx_version == domain_to_version.cend() || onnx_version->second < 10) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // float value -> its quantized version, produced by a QLinear node or a QuantizeLinear
+  std::unordered_map<const NodeArg*, QuantizedValue> quantized_values;
+  std::vector<NodeIndex> dequantize_nodes;
+
+  auto get_quantized_input = [&](NodeArg& input) -> const QuantizedValue& {
+    auto quantized = quantized_values.find(&input);
+    if (quantized == quantized_values.end()) {
+      const auto& range = ranges_.at(input.Name());
+      auto quantized_input = AddQuantizedValue(graph, input.Name(), ComputeQuantizationParams(range.min, range.max),
+                                                 &AddQuantizedArg(graph, input));
+      graph.AddNode(graph.GenerateNodeName(input.Name() + "_QuantizeLinear"), "QuantizeLinear", "",
+                    {&input, quantized_input.scale, quantized_input.zero_point}, {quantized_input.value})
+          .SetExecutionProviderType(kCpuExecutionProvider);
+      quantized = quantized_values.emplace(&input, quantized_input).first;
+    }
+    return quantized->second;
+  };
+
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node)
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (!CanQuantize(graph, *node)) {
+      continue;
+    }
+
+    const bool is_matmul = node->OpType() == "MatMul";
+    const auto& inputs = node->InputDefs();
+    auto& output = *node->MutableOutputDefs()[0];
+
+    const auto quantized_input = get_quantized_input(*node->MutableInputDefs()[0]);
+
+    QuantizationParams weights_params;
+    auto& weights = AddQuantizedWeights(graph, *graph_utils::GetConstantInitializer(graph, inputs[1]->Name()),
+                                        weights_params);
+    const auto quantized_weights = AddQuantizedValue(graph, inputs[1]->Name(), weights_params, &weights);
+
+    // the Relu of FusedConv is the clipping of the output at its zero point, which is then 0
+    auto output_range = ranges_.at(output.Name());
+    if (node->OpType() == "FusedConv") {
+      output_range.min = 0.f;
+    }
+    const auto quantized_output = AddQuantizedValue(graph, output.Name(),
+                                                      ComputeQuantizationParams(output_range.min, output_range.max),
+                                                      &AddQuantizedArg(graph, output));
+
+    std::vector<NodeArg*> quantized_inputs{quantized_input.value, quantized_input.scale, quantized_input.zero_point,
+                                           quantized_weights.value, quantized_weights.scale,
+                                           quantized_weights.zero_point,
+                                           quantized_output.scale, quantized_output.zero_point};
+    if (inputs.size() > 2 && inputs[2]->Exists()) {
+      quantized_inputs.push_back(&AddQuantizedBias(graph,
+                                                   *graph_utils::GetConstantInitializer(graph, inputs[2]->Name()),
+                                                   quantized_input.params.scale * weights_params.scale));
+    }
+
+    NodeAttributes attributes = node->GetAttributes();
+    attributes.erase("activation");
+    attributes.erase("activation_params");
+
+    const std::string name = node->Name();
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+
+    graph.AddNode(graph.GenerateNodeName(name + "_quantized"), is_matmul ? "QLinearMatMul" : "QLinearConv", "",
+                  quantized_inputs, {quantized_output.value}, &attributes)
+        .SetExecutionProviderType(kCpuExecutionProvider);
+
+    // the float value for the other users, which is removed below if there are none
+    auto& dequantize = graph.AddNode(graph.GenerateNodeName(output.Name() + "_DequantizeLinear"), "DequantizeLinear",
+                                     "", {quantized_output.value, quantized_output.scale, quantized_output.zero_point},
+                                     {&output});
+    dequantize.SetExecutionProviderType(kCpuExecutionProvider);
+    dequantize_nodes.push_back(dequantize.Index());
+    quantized_values.emplace(&output, quantized_output);
+    modified = true;
+  }
+
+  if (dequantize_nodes.empty()) {
+    return Status::OK();
+  }
+
+  std::unordered_set<const NodeArg*> float_uses;
+  for (const auto& node : graph.Nodes()) {
+    float_uses.insert(node.InputDefs().cbegin(), node.InputDefs().cend());
+    float_uses.insert(node.ImplicitInputDefs().cbegin(), node.ImplicitInputDefs().cend());
+  }
+  float_uses.insert(graph.GetOutputs().cbegin(), graph.GetOutputs().cend());
+
+  for (NodeIndex index : dequantize_nodes) {
+    auto* node = graph.GetNode(index);
+    if (float_uses.count(node->OutputDefs()[0]) == 0) {
+      graph.RemoveNode(index);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
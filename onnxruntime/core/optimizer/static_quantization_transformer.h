@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/framework/calibration_collector.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class StaticQuantizationTransformer
+
+Transformer that quantizes the Conv, FusedConv with a Relu activation and MatMul nodes of the CPU execution provider
+to uint8 QLinearConv and QLinearMatMul, with the ranges of their input and output collected by calibration, see
+CalibrationCollector. Their weights are quantized once, per tensor.
+QuantizeLinear and DequantizeLinear nodes are inserted only where a quantized value meets a float one, so the
+consecutive quantized nodes pass uint8 tensors to each other.
+The nodes whose input or output has no range are left in float.
+
+It runs after the graph partitioning and the other optimizations, as the ranges are those of the tensors of the
+optimized graph the calibration Runs executed.
+*/
+class StaticQuantizationTransformer : public GraphTransformer {
+ public:
+  explicit StaticQuantizationTransformer(const std::unordered_map<std::string, TensorRange>& ranges)
+      : GraphTransformer("StaticQuantizationTransformer"), ranges_{ranges} {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+
+  bool CanQuantize(const Graph& graph, const Node& node) const;
+
+  const std::unordered_map<std::string, TensorRange>& ranges_;
+};
+
+}  // namespace onnxruntime
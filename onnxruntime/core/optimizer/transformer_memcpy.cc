@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "transformer_memcpy.h"
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/execution_providers.h"
 
@@ -18,9 +21,14 @@ class TransformerMemcpyImpl {
   bool ModifyGraph(const KernelRegistryManager& schema_registries);
 
  private:
+  bool IsProviderNode(const onnxruntime::Node& node) const;
+  void BuildProducersAndConsumers();
+  bool PlaceNodes(const KernelRegistryManager& kernel_registries);
+  int CountCrossings(const onnxruntime::NodeArg* arg, const KernelRegistryManager& kernel_registries) const;
   void ProcessDefs(onnxruntime::Node& node, const KernelRegistryManager& kernel_registries, InitializedTensorSet& initializers_consumed);
   void BuildDefsMapping(const onnxruntime::NodeArg* arg, const KernelRegistryManager& kernel_registries);
-  void AddCopyNode(onnxruntime::NodeArg* arg, bool is_input);
+  void AddCopyNodes(const std::vector<onnxruntime::NodeArg*>& args, bool is_input);
+  void AddCopyNode(const std::vector<onnxruntime::NodeArg*>& args, bool is_input);
   bool ProcessInitializers(const KernelRegistryManager& kernel_registries, const InitializedTensorSet& initializers_consumed);
 
  private:
@@ -48,6 +56,12 @@ class TransformerMemcpyImpl {
   std::map<const onnxruntime::NodeArg*, std::set<onnxruntime::Node*, NodeCompare>> provider_input_nodes_;
   std::map<const onnxruntime::NodeArg*, std::set<onnxruntime::Node*, NodeCompare>> provider_output_nodes_;
 
+  // the node and output index that produce each value of the graph, and the nodes and input indices that consume it.
+  // an input index of -1 is an implicit input.
+  std::unordered_map<const onnxruntime::NodeArg*, std::pair<onnxruntime::Node*, int>> producers_;
+  std::unordered_map<const onnxruntime::NodeArg*, std::vector<std::pair<onnxruntime::Node*, int>>> consumers_;
+  std::unordered_set<const onnxruntime::NodeArg*> graph_outputs_;
+
   onnxruntime::Graph& graph_;
   std::string provider_;
 };
@@ -116,12 +130,24 @@ considered to be non-provider here.)
 Note that every ml-value is computed at a unique point (either provider or non-provider),
 but it may be referenced and used at multiple points (by both provider and non-provider).
 
+The copies of (2) and (3) are coalesced: the ml-values computed by the same node (or the
+graph inputs) that cross devices in the same direction are copied by one copy node, so the
+data transfer can batch them.
+
+Before that, provider nodes that compute only integer ml-values (typically shape computations
+such as Gather or Concat of shapes) are placed on CPU if a CPU kernel exists and doing so
+reduces the number of ml-values that cross devices. The partitioning of the provider already
+places nodes whose inputs all come from CPU there, this also catches the ones fed by graph
+inputs or whose results are only used on CPU.
+
 This transformer does not currently optimize copies between, e.g., two different GPU devices, etc.
 
 */
 
 bool TransformerMemcpyImpl::ModifyGraph(const KernelRegistryManager& kernel_registries) {
-  bool modified = false;
+  BuildProducersAndConsumers();
+
+  bool modified = PlaceNodes(kernel_registries);
   InitializedTensorSet initializers_consumed;
   // find defs that require copy
   for (auto& node : graph_.Nodes()) {
@@ -142,33 +168,161 @@ bool TransformerMemcpyImpl::ModifyGraph(const KernelRegistryManager& kernel_regi
   for (auto arg : non_provider_output_defs_)
     BuildDefsMapping(arg, kernel_registries);
 
+  std::vector<onnxruntime::NodeArg*> copy_in_args;
+  std::vector<onnxruntime::NodeArg*> copy_out_args;
+
   for (auto arg : graph_.GetInputs())
     // For inputs we need to create a copy node only when the input is connected to both provider
     // and non-provider nodes. Otherwise utils::CopyInputsAcrossDevices() will do the job.
     if (provider_input_defs_.count(arg) && non_provider_input_defs_.count(arg)) {
-      AddCopyNode(const_cast<onnxruntime::NodeArg*>(arg), true);
-      modified = true;
+      copy_in_args.push_back(const_cast<onnxruntime::NodeArg*>(arg));
     }
 
   for (auto arg : non_provider_output_defs_)
     if (provider_input_defs_.count(arg)) {
-      AddCopyNode(arg, true);
-      modified = true;
+      copy_in_args.push_back(arg);
     }
 
   for (auto arg : provider_output_defs_)
     if (non_provider_input_defs_.count(arg)) {
-      AddCopyNode(arg, false);
-      modified = true;
+      copy_out_args.push_back(arg);
+    }
+
+  AddCopyNodes(copy_in_args, true);
+  AddCopyNodes(copy_out_args, false);
+
+  return modified || !copy_in_args.empty() || !copy_out_args.empty();
+}
+
+bool TransformerMemcpyImpl::IsProviderNode(const onnxruntime::Node& node) const {
+  return node.GetExecutionProviderType() == provider_ ||
+         (node.GetExecutionProviderType() == kCudaExecutionProvider && provider_ == kTensorrtExecutionProvider) ||
+         (node.GetExecutionProviderType() == kTensorrtExecutionProvider && provider_ == kCudaExecutionProvider);
+}
+
+void TransformerMemcpyImpl::BuildProducersAndConsumers() {
+  for (auto& node : graph_.Nodes()) {
+    onnxruntime::Node::ForEachWithIndex(node.OutputDefs(), [this, &node](const onnxruntime::NodeArg& arg, size_t index) {
+      producers_[&arg] = {&node, static_cast<int>(index)};
+      return Status::OK();
+    });
+    onnxruntime::Node::ForEachWithIndex(node.InputDefs(), [this, &node](const onnxruntime::NodeArg& arg, size_t index) {
+      consumers_[&arg].push_back({&node, static_cast<int>(index)});
+      return Status::OK();
+    });
+    for (const auto* arg : node.ImplicitInputDefs()) {
+      consumers_[arg].push_back({&node, -1});
+    }
+  }
+
+  for (const auto* arg : graph_.GetOutputs()) {
+    graph_outputs_.insert(arg);
+  }
+}
+
+// Returns 1 if arg is used on another device than the one it's computed on, 0 otherwise.
+// Graph inputs and outputs, outer scope values and implicit inputs are on CPU.
+int TransformerMemcpyImpl::CountCrossings(const onnxruntime::NodeArg* arg,
+                                          const KernelRegistryManager& kernel_registries) const {
+  bool produced_on_cpu = true;
+  auto producer = producers_.find(arg);
+  if (producer != producers_.end() && IsProviderNode(*producer->second.first)) {
+    const KernelCreateInfo* kci = nullptr;
+    kernel_registries.SearchKernelRegistry(*producer->second.first, &kci);
+    produced_on_cpu = kci && kci->kernel_def->IsOutputOnCpu(producer->second.second);
+  }
+
+  bool used_on_cpu = graph_outputs_.count(arg) > 0;
+  bool used_on_provider = false;
+  auto consumers = consumers_.find(arg);
+  if (consumers != consumers_.end()) {
+    for (const auto& consumer : consumers->second) {
+      if (consumer.second == -1 || !IsProviderNode(*consumer.first)) {
+        used_on_cpu = true;
+        continue;
+      }
+      const KernelCreateInfo* kci = nullptr;
+      kernel_registries.SearchKernelRegistry(*consumer.first, &kci);
+      if (kci && kci->kernel_def->IsInputOnCpu(consumer.second))
+        used_on_cpu = true;
+      else
+        used_on_provider = true;
+    }
+  }
+
+  return (produced_on_cpu ? used_on_provider : used_on_cpu) ? 1 : 0;
+}
+
+static bool HasOnlyIntegerOutputs(const onnxruntime::Node& node) {
+  bool has_outputs = false;
+  for (const auto* arg : node.OutputDefs()) {
+    if (!arg->Exists())
+      continue;
+    const auto* type = arg->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type())
+      return false;
+    const auto elem_type = type->tensor_type().elem_type();
+    if (elem_type != TensorProto_DataType_INT64 && elem_type != TensorProto_DataType_INT32)
+      return false;
+    has_outputs = true;
+  }
+  return has_outputs;
+}
+
+bool TransformerMemcpyImpl::PlaceNodes(const KernelRegistryManager& kernel_registries) {
+  // every move strictly reduces the number of values crossing devices, so this terminates
+  bool modified = false;
+  bool moved = true;
+  while (moved) {
+    moved = false;
+    for (auto& node : graph_.Nodes()) {
+      if (!IsProviderNode(node) || node.ContainsSubgraph() || !node.ImplicitInputDefs().empty() ||
+          !HasOnlyIntegerOutputs(node))
+        continue;
+
+      std::vector<const onnxruntime::NodeArg*> args;
+      for (const auto* arg : node.InputDefs()) {
+        if (arg->Exists() && GetInitializer(graph_, arg->Name(), true) == nullptr &&
+            std::find(args.begin(), args.end(), arg) == args.end())
+          args.push_back(arg);
+      }
+      for (const auto* arg : node.OutputDefs()) {
+        if (arg->Exists())
+          args.push_back(arg);
+      }
+
+      int crossings = 0;
+      for (const auto* arg : args)
+        crossings += CountCrossings(arg, kernel_registries);
+      if (crossings == 0)
+        continue;
+
+      const auto provider_type = node.GetExecutionProviderType();
+      node.SetExecutionProviderType(kCpuExecutionProvider);
+
+      const KernelCreateInfo* cpu_kci = nullptr;
+      int cpu_crossings = crossings;
+      if (kernel_registries.SearchKernelRegistry(node, &cpu_kci).IsOK() && cpu_kci->kernel_def &&
+          cpu_kci->kernel_def->Provider() == kCpuExecutionProvider) {
+        cpu_crossings = 0;
+        for (const auto* arg : args)
+          cpu_crossings += CountCrossings(arg, kernel_registries);
+      }
+
+      if (cpu_crossings < crossings) {
+        moved = true;
+        modified = true;
+      } else {
+        node.SetExecutionProviderType(provider_type);
+      }
     }
+  }
 
   return modified;
 }
 
 void TransformerMemcpyImpl::ProcessDefs(onnxruntime::Node& node, const KernelRegistryManager& kernel_registries, InitializedTensorSet& initializers_consumed) {
-  if (node.GetExecutionProviderType() == provider_
-      || (node.GetExecutionProviderType() == kCudaExecutionProvider && provider_ == kTensorrtExecutionProvider)
-      || (node.GetExecutionProviderType() == kTensorrtExecutionProvider && provider_ == kCudaExecutionProvider)) {
+  if (IsProviderNode(node)) {
     provider_nodes_.insert(&node);
     // note KernelCreateInfo might be nullptr for custom kernel
     const KernelCreateInfo* kci = nullptr;
@@ -256,32 +410,55 @@ void TransformerMemcpyImpl::BuildDefsMapping(const onnxruntime::NodeArg* arg, co
   }
 }
 
-void TransformerMemcpyImpl::AddCopyNode(onnxruntime::NodeArg* arg, bool is_input) {
-  // create unique name for new def
-  std::string new_def_name = graph_.GenerateNodeArgName(arg->Name() + "_" + provider_);
+// Groups the values by the node that computes them, and adds a copy node for each group.
+// The values of a group are all available at the same time, so copying them together doesn't delay any of them.
+void TransformerMemcpyImpl::AddCopyNodes(const std::vector<onnxruntime::NodeArg*>& args, bool is_input) {
+  // graph inputs and outer scope values have no producer, and go in the last group
+  const NodeIndex no_producer = std::numeric_limits<NodeIndex>::max();
+  std::map<NodeIndex, std::vector<onnxruntime::NodeArg*>> groups;
+  for (auto* arg : args) {
+    auto producer = producers_.find(arg);
+    groups[producer != producers_.end() ? producer->second.first->Index() : no_producer].push_back(arg);
+  }
+
+  for (const auto& group : groups)
+    AddCopyNode(group.second, is_input);
+}
 
-  auto* new_arg = &graph_.GetOrCreateNodeArg(new_def_name, arg->TypeAsProto());
-  auto* src_arg = is_input ? arg : new_arg;
-  auto* dst_arg = is_input ? new_arg : arg;
+void TransformerMemcpyImpl::AddCopyNode(const std::vector<onnxruntime::NodeArg*>& args, bool is_input) {
+  std::vector<onnxruntime::NodeArg*> src_args;
+  std::vector<onnxruntime::NodeArg*> dst_args;
+  std::vector<onnxruntime::NodeArg*> new_args;
+  for (auto* arg : args) {
+    // create unique name for new def
+    std::string new_def_name = graph_.GenerateNodeArgName(arg->Name() + "_" + provider_);
+
+    auto* new_arg = &graph_.GetOrCreateNodeArg(new_def_name, arg->TypeAsProto());
+    src_args.push_back(is_input ? arg : new_arg);
+    dst_args.push_back(is_input ? new_arg : arg);
+    new_args.push_back(new_arg);
+  }
 
   // create unique name for copy node
   std::string new_node_name = graph_.GenerateNodeName("Memcpy");
 
   const auto op_name = is_input ? "MemcpyFromHost" : "MemcpyToHost";
-  auto& new_node = graph_.AddNode(new_node_name, op_name, "Copy from/to host memory",
-                                  std::vector<onnxruntime::NodeArg*>{src_arg},
-                                  std::vector<onnxruntime::NodeArg*>{dst_arg});
+  auto& new_node = graph_.AddNode(new_node_name, op_name, "Copy from/to host memory", src_args, dst_args);
   new_node.SetExecutionProviderType(provider_);
-  std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> map = {{arg, new_arg}};
-  auto it = provider_input_nodes_.find(arg);
-  if (it != provider_input_nodes_.end()) {
-    for (auto* node : it->second)
-      node->ReplaceDefs(map);
-  }
-  it = provider_output_nodes_.find(arg);
-  if (it != provider_output_nodes_.end()) {
-    for (auto* node : it->second)
-      node->ReplaceDefs(map);
+
+  for (size_t i = 0; i < args.size(); ++i) {
+    // the nodes are updated one value at a time, as a node may use another value of the group from CPU memory
+    std::map<const onnxruntime::NodeArg*, onnxruntime::NodeArg*> map = {{args[i], new_args[i]}};
+    auto it = provider_input_nodes_.find(args[i]);
+    if (it != provider_input_nodes_.end()) {
+      for (auto* node : it->second)
+        node->ReplaceDefs(map);
+    }
+    it = provider_output_nodes_.find(args[i]);
+    if (it != provider_output_nodes_.end()) {
+      for (auto* node : it->second)
+        node->ReplaceDefs(map);
+    }
   }
 }
 
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/utils.h"
+
+#include <cmath>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace optimizer_utils {
+
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& input_arg, float& value) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr ||
+      (tensor_proto->data_type() != TensorProto_DataType_FLOAT &&
+       tensor_proto->data_type() != TensorProto_DataType_DOUBLE)) {
+    return false;
+  }
+
+  Initializer initializer{tensor_proto};
+  if (initializer.size() != 1) {
+    return false;
+  }
+
+  value = tensor_proto->data_type() == TensorProto_DataType_FLOAT
+              ? *initializer.data<float>()
+              : static_cast<float>(*initializer.data<double>());
+  return true;
+}
+
+bool IsScalarInitializerWithValue(const Graph& graph, const NodeArg& input_arg, float expected_value) {
+  float value;
+  return GetScalarInitializerValue(graph, input_arg, value) &&
+         std::fabs(value - expected_value) <= 1e-4f * std::fabs(expected_value);
+}
+
+Node* GetOnlyChildNode(Graph& graph, const Node& node, const std::string& op_type,
+                       const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                       const std::string& domain) {
+  if (node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(node)) {
+    return nullptr;
+  }
+
+  const Node& next_node = *node.OutputNodesBegin();
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(next_node, op_type, versions, domain) ||
+      next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+
+  return graph.GetNode(next_node.Index());
+}
+
+Node* GetInputNode(Graph& graph, const Node& node, int input_index, const std::string& op_type,
+                   const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                   const std::string& domain) {
+  for (auto it = node.InputEdgesBegin(); it != node.InputEdgesEnd(); ++it) {
+    if (it->GetDstArgIndex() != input_index) {
+      continue;
+    }
+
+    const Node& input_node = it->GetNode();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(input_node, op_type, versions, domain) ||
+        input_node.GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        input_node.GetOutputEdgesCount() != 1 || graph.IsNodeOutputsInGraphOutputs(input_node)) {
+      return nullptr;
+    }
+    return graph.GetNode(input_node.Index());
+  }
+
+  return nullptr;
+}
+
+bool GetInt64InitializerValues(const Graph& graph, const NodeArg& input_arg, std::vector<int64_t>& values) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() != 1) {
+    return false;
+  }
+
+  values.resize(static_cast<size_t>(tensor_proto->dims(0)));
+  return utils::UnpackTensor<int64_t>(*tensor_proto,
+                                      utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().data() : nullptr,
+                                      tensor_proto->raw_data().size(),
+                                      values.data(),
+                                      static_cast<int64_t>(values.size()))
+      .IsOK();
+}
+
+bool IsSameDim(const TensorShapeProto_Dimension& lhs, const TensorShapeProto_Dimension& rhs) {
+  return (lhs.has_dim_value() && rhs.has_dim_value() && lhs.dim_value() == rhs.dim_value()) ||
+         (lhs.has_dim_param() && rhs.has_dim_param() && !lhs.dim_param().empty() &&
+          lhs.dim_param() == rhs.dim_param());
+}
+
+bool IsSameShape(const TensorShapeProto* lhs, const TensorShapeProto* rhs) {
+  if (lhs == nullptr || rhs == nullptr || lhs->dim_size() != rhs->dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < lhs->dim_size(); ++i) {
+    if (!IsSameDim(lhs->dim(i), rhs->dim(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
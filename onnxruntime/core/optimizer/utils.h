@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace optimizer_utils {
+
+/** Checks whether the given NodeArg is a constant float or double scalar initializer equal to expected_value,
+allowing for the limited precision exporters write constants such as sqrt(2) with. */
+bool IsScalarInitializerWithValue(const Graph& graph, const NodeArg& input_arg, float expected_value);
+
+/** Reads the value of a constant float or double initializer with a single element.
+@returns false if the NodeArg isn't such an initializer. */
+bool GetScalarInitializerValue(const Graph& graph, const NodeArg& input_arg, float& value);
+
+/** Returns the only consumer of the outputs of node if it has the given op type and version and is assigned to
+the same execution provider, and none of the outputs of node are graph outputs. Otherwise returns nullptr. */
+Node* GetOnlyChildNode(Graph& graph, const Node& node, const std::string& op_type,
+                       const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                       const std::string& domain = kOnnxDomainAlias);
+
+/** Returns the producer of input input_index of node if it has the given op type and version, is assigned to the
+same execution provider and node is the only consumer of its outputs, none of which are graph outputs.
+Otherwise returns nullptr. */
+Node* GetInputNode(Graph& graph, const Node& node, int input_index, const std::string& op_type,
+                   const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions,
+                   const std::string& domain = kOnnxDomainAlias);
+
+/** Reads the values of a constant 1D int64 initializer, such as the shape input of a Reshape.
+@returns false if the NodeArg isn't such an initializer. */
+bool GetInt64InitializerValues(const Graph& graph, const NodeArg& input_arg, std::vector<int64_t>& values);
+
+/** Checks whether two dimensions are the same known value or the same named symbolic dimension. */
+bool IsSameDim(const ONNX_NAMESPACE::TensorShapeProto_Dimension& lhs,
+               const ONNX_NAMESPACE::TensorShapeProto_Dimension& rhs);
+
+/** Checks whether two shapes are known to be the same, i.e. they have the same rank and IsSameDim holds for
+every dimension. */
+bool IsSameShape(const ONNX_NAMESPACE::TensorShapeProto* lhs, const ONNX_NAMESPACE::TensorShapeProto* rhs);
+
+}  // namespace optimizer_utils
+}  // namespace onnxruntime
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/weight_only_quantization_transformer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+template <typename T>
+NodeArg& AddInitializer(Graph& graph, const std::string& base_name, TensorProto_DataType data_type,
+                        const std::vector<int64_t>& dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  tensor.set_data_type(data_type);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    shape->add_dim()->set_dim_value(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(tensor.name(), &type);
+}
+
+// the int8 weights and their scales
+struct QuantizedWeights {
+  NodeArg* weights;
+  NodeArg* scale;
+};
+
+// Quantizes the rows x columns matrix data symmetrically to int8, with a scale per column if per_column, else per
+// row: x = q * scale with q in [-127, 127]. A transposed matrix is stored transposed, as columns x rows.
+QuantizedWeights AddQuantizedWeights(Graph& graph, const std::string& base_name, const float* data, int64_t rows,
+                                     int64_t columns, bool per_column, bool transpose) {
+  const int64_t channels = per_column ? columns : rows;
+  std::vector<float> scale(static_cast<size_t>(channels), 0.f);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < columns; ++c) {
+      float& channel_scale = scale[per_column ? c : r];
+      channel_scale = std::max(channel_scale, std::abs(data[r * columns + c]));
+    }
+  }
+  // a channel of zeros quantizes to 0 with any scale
+  for (auto& channel_scale : scale) {
+    channel_scale = channel_scale > 0.f ? channel_scale / 127.f : 1.f;
+  }
+
+  std::vector<int8_t> quantized(static_cast<size_t>(rows * columns));
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < columns; ++c) {
+      const float q = std::round(data[r * columns + c] / scale[per_column ? c : r]);
+      quantized[transpose ? c * rows + r : r * columns + c] =
+          static_cast<int8_t>(std::min(127.f, std::max(-127.f, q)));
+    }
+  }
+
+  const std::vector<int64_t> dims = transpose ? std::vector<int64_t>{columns, rows}
+                                               : std::vector<int64_t>{rows, columns};
+  return {&AddInitializer(graph, base_name + "_int8", TensorProto_DataType_INT8, dims, quantized),
+          &AddInitializer(graph, base_name + "_scale", TensorProto_DataType_FLOAT, {channels}, scale)};
+}
+
+const TensorProto* GetFloatMatrix(const Graph& graph, const NodeArg& arg) {
+  const auto* tensor = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor == nullptr || tensor->data_type() != TensorProto_DataType_FLOAT || tensor->dims_size() != 2) {
+    return nullptr;
+  }
+  return tensor;
+}
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+float GetFloatAttribute(const Node& node, const std::string& name, float default_value) {
+  const auto* attribute = graph_utils::GetNodeAttribute(node, name);
+  return attribute == nullptr ? default_value : attribute->f();
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attribute = graph_utils::GetNodeAttribute(node, name);
+  return attribute == nullptr ? default_value : attribute->i();
+}
+
+}  // namespace
+
+Status WeightOnlyQuantizationTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  // the weights already quantized, by the name of the float initializer and the layout
+  std::unordered_map<std::string, QuantizedWeights> quantized_weights;
+  auto get_quantized_weights = [&](const TensorProto& tensor, bool per_column, bool transpose) {
+    const std::string key = tensor.name() + (per_column ? "/columns" : "/rows") + (transpose ? "/transposed" : "");
+    auto entry = quantized_weights.find(key);
+    if (entry == quantized_weights.end()) {
+      Initializer float_data(&tensor);
+      entry = quantized_weights.emplace(key, AddQuantizedWeights(graph, tensor.name(), float_data.data<float>(),
+                                                                 float_data.dims()[0], float_data.dims()[1],
+                                                                 per_column, transpose))
+                  .first;
+    }
+    return entry->second;
+  };
+
+  for (NodeIndex index : order) {
+    auto* node = graph.GetNode(index);
+    if (!node)
+      return Status(ONNXRUNTIME, INVALID_ARGUMENT);
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level));
+
+    if (node->GetExecutionProviderType() != kCpuExecutionProvider) {
+      continue;
+    }
+
+    const bool is_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMul", {1, 9});
+    const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Gemm", {7, 9});
+    const bool is_gather = graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Gather", {1, 11});
+    if (!is_matmul && !is_gemm && !is_gather) {
+      continue;
+    }
+
+    const auto& inputs = node->InputDefs();
+    auto& output = *node->MutableOutputDefs()[0];
+    const NodeArg& weights_arg = is_gather ? *inputs[0] : *inputs[1];
+    const auto* weights = GetFloatMatrix(graph, weights_arg);
+    if (weights == nullptr || !IsFloatTensor(output)) {
+      continue;
+    }
+
+    std::vector<NodeArg*> new_inputs;
+    std::string op_type;
+    if (is_gather) {
+      if (GetIntAttribute(*node, "axis", 0) != 0) {
+        continue;
+      }
+      const auto quantized = get_quantized_weights(*weights, false, false);
+      new_inputs = {quantized.weights, quantized.scale, node->MutableInputDefs()[1]};
+      op_type = "GatherWeightInt8";
+    } else if (is_matmul) {
+      if (!IsFloatTensor(*inputs[0])) {
+        continue;
+      }
+      const auto quantized = get_quantized_weights(*weights, true, false);
+      new_inputs = {node->MutableInputDefs()[0], quantized.weights, quantized.scale};
+      op_type = "MatMulWeightInt8";
+    } else {
+      // Y = alpha * A * B' + beta * C, with alpha folded into the scales and beta * C into the bias
+      if (GetIntAttribute(*node, "transA", 0) != 0 || !IsFloatTensor(*inputs[0])) {
+        continue;
+      }
+      const bool trans_b = GetIntAttribute(*node, "transB", 0) != 0;
+      const int64_t n = weights->dims(trans_b ? 0 : 1);
+      const TensorProto* c = nullptr;
+      if (inputs.size() > 2 && inputs[2]->Exists()) {
+        c = graph_utils::GetConstantInitializer(graph, inputs[2]->Name());
+        const bool is_bias = c != nullptr && c->data_type() == TensorProto_DataType_FLOAT &&
+                             ((c->dims_size() == 1 && c->dims(0) == n) ||
+                              (c->dims_size() == 2 && c->dims(0) == 1 && c->dims(1) == n));
+        if (!is_bias) {
+          continue;
+        }
+      }
+
+      const float alpha = GetFloatAttribute(*node, "alpha", 1.f);
+      auto quantized = get_quantized_weights(*weights, !trans_b, trans_b);
+      if (alpha != 1.f) {
+        // the scales are specific to this node then
+        Initializer scale_data(graph_utils::GetConstantInitializer(graph, quantized.scale->Name()));
+        std::vector<float> scale(scale_data.data<float>(), scale_data.data<float>() + n);
+        for (auto& channel_scale : scale) {
+          channel_scale *= alpha;
+        }
+        quantized.scale = &AddInitializer(graph, weights->name() + "_scale", TensorProto_DataType_FLOAT, {n}, scale);
+      }
+      new_inputs = {node->MutableInputDefs()[0], quantized.weights, quantized.scale};
+
+      if (c != nullptr) {
+        const float beta = GetFloatAttribute(*node, "beta", 1.f);
+        Initializer c_data(c);
+        std::vector<float> bias(c_data.data<float>(), c_data.data<float>() + n);
+        for (auto& value : bias) {
+          value *= beta;
+        }
+        new_inputs.push_back(&AddInitializer(graph, c->name() + "_bias", TensorProto_DataType_FLOAT, {n}, bias));
+      }
+      op_type = "MatMulWeightInt8";
+    }
+
+    const std::string name = node->Name();
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+
+    graph.AddNode(graph.GenerateNodeName(name + "_int8"), op_type, "", new_inputs, {&output}, nullptr, kMSDomain)
+        .SetExecutionProviderType(kCpuExecutionProvider);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class WeightOnlyQuantizationTransformer
+
+Transformer that stores the float weights of the MatMul, Gemm and Gather nodes of the CPU execution provider as int8,
+with a symmetric scale per output channel, and replaces the nodes with MatMulWeightInt8 and GatherWeightInt8.
+The activations stay in float, the weights are dequantized as they are used: a panel at a time by the SGEMM of
+MatMulWeightInt8, and only the gathered rows of an embedding table by GatherWeightInt8.
+
+The weights are the constant initializers that are a 2D B of MatMul, a 2D B of Gemm without transA whose C, if any,
+is a bias of N elements, and the 2D data of Gather along axis 0. A weight used by several nodes is quantized once.
+*/
+class WeightOnlyQuantizationTransformer : public GraphTransformer {
+ public:
+  WeightOnlyQuantizationTransformer() noexcept : GraphTransformer("WeightOnlyQuantizationTransformer") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
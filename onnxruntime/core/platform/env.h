@@ -63,6 +63,32 @@ class Env {
 
   virtual int GetNumCpuCores() const = 0;
 
+  /// \brief Pins the calling thread to the given logical processor.
+  /// Returns false if the platform doesn't support it or the call failed.
+  virtual bool SetCurrentThreadAffinity(int logical_processor) const = 0;
+
+  /// \brief Returns the number of NUMA nodes, 1 if the topology isn't known.
+  virtual int GetNumaNodeCount() const = 0;
+
+  /// \brief Returns the logical processors of a NUMA node. Empty if the node doesn't exist or the topology
+  /// isn't known.
+  virtual std::vector<int> GetNumaNodeProcessors(int numa_node) const = 0;
+
+  /// \brief Allocates size bytes of page aligned memory placed on a NUMA node.
+  /// Returns nullptr if the platform doesn't support it or the allocation failed.
+  /// The memory must be freed by FreeOnNumaNode with the same size.
+  virtual void* AllocOnNumaNode(size_t size, int numa_node) const = 0;
+  virtual void FreeOnNumaNode(void* p, size_t size) const = 0;
+
+  /// \brief Returns the size of the huge pages, 0 if the platform doesn't support them.
+  virtual size_t GetHugePageSize() const = 0;
+
+  /// \brief Allocates size bytes, rounded up to a multiple of GetHugePageSize(), backed by huge pages, and placed
+  /// on a NUMA node if numa_node isn't -1. Returns nullptr if the platform doesn't support huge pages or none are
+  /// available. The memory must be freed by FreeHugePages with the same size.
+  virtual void* AllocHugePages(size_t size, int numa_node) const = 0;
+  virtual void FreeHugePages(void* p, size_t size) const = 0;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const { return env_time_->NowMicros(); }
 
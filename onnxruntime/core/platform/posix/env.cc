@@ -25,8 +25,19 @@ limitations under the License.
 #include <dlfcn.h>
 #include <string.h>
 #include <thread>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#include <algorithm>
+#include <cerrno>
 #include <vector>
+#include <fstream>
+#include <sstream>
 #include <assert.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 #include "core/platform/env.h"
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -61,6 +72,52 @@ static void UnmapFile(void* param) noexcept {
   delete p;
 }
 
+#if defined(__linux__)
+// parse a cpu list of /sys/devices/system/node, such as "0-11,24-35"
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> cpus;
+  std::istringstream ss(cpu_list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    const auto dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    } catch (const std::exception&) {
+      return {};
+    }
+  }
+  return cpus;
+}
+
+// the memory policy of mbind preferring the given node, from linux/mempolicy.h
+constexpr int kMpolPreferred = 1;
+
+// places the pages of [p, p + size) on the node when they are first touched. preferring the node rather than
+// binding to it lets the kernel fall back to other nodes instead of failing when the node is out of memory.
+void PreferNumaNode(void* p, size_t size, int numa_node) {
+#if defined(SYS_mbind)
+  unsigned long node_mask = 1UL << numa_node;
+  if (syscall(SYS_mbind, p, size, kMpolPreferred, &node_mask, sizeof(unsigned long) * 8, 0) != 0) {
+    LOGS_DEFAULT(INFO) << "mbind to NUMA node " << numa_node << " failed. error code:" << errno;
+  }
+#else
+  ORT_UNUSED_PARAMETER(p);
+  ORT_UNUSED_PARAMETER(size);
+  ORT_UNUSED_PARAMETER(numa_node);
+#endif
+}
+
+// whether madvise(MADV_HUGEPAGE) has an effect, which it doesn't when transparent huge pages are disabled
+bool TransparentHugePagesEnabled() {
+  std::ifstream enabled("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  return enabled && std::getline(enabled, modes) && modes.find("[never]") == std::string::npos;
+}
+#endif
+
 class PosixEnv : public Env {
  public:
   static PosixEnv& Instance() {
@@ -75,6 +132,145 @@ class PosixEnv : public Env {
     return std::thread::hardware_concurrency();
   }
 
+  bool SetCurrentThreadAffinity(int logical_processor) const override {
+#if defined(__linux__)
+    if (logical_processor < 0 || logical_processor >= CPU_SETSIZE) return false;
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(logical_processor, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+    ORT_UNUSED_PARAMETER(logical_processor);
+    return false;
+#endif
+  }
+
+  int GetNumaNodeCount() const override {
+    int count = 0;
+#if defined(__linux__)
+    while (count < 1024) {
+      std::ifstream node_cpus("/sys/devices/system/node/node" + std::to_string(count) + "/cpulist");
+      if (!node_cpus) break;
+      ++count;
+    }
+#endif
+    return std::max(count, 1);
+  }
+
+  std::vector<int> GetNumaNodeProcessors(int numa_node) const override {
+#if defined(__linux__)
+    if (numa_node < 0) return {};
+    std::ifstream node_cpus("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    std::string cpu_list;
+    if (!node_cpus || !std::getline(node_cpus, cpu_list)) return {};
+    return ParseCpuList(cpu_list);
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+    return {};
+#endif
+  }
+
+  void* AllocOnNumaNode(size_t size, int numa_node) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMaxNodes = sizeof(unsigned long) * 8;
+    if (size == 0 || numa_node < 0 || numa_node >= kMaxNodes) return nullptr;
+
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return nullptr;
+
+    PreferNumaNode(p, size, numa_node);
+    return p;
+#else
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return nullptr;
+#endif
+  }
+
+  void FreeOnNumaNode(void* p, size_t size) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (p != nullptr) munmap(p, size);
+#else
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+#endif
+  }
+
+  size_t GetHugePageSize() const override {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    static const size_t huge_page_size = [] {
+      std::ifstream meminfo("/proc/meminfo");
+      std::string line;
+      while (std::getline(meminfo, line)) {
+        if (line.compare(0, 13, "Hugepagesize:") == 0) {
+          // the size is in kB
+          return static_cast<size_t>(strtoull(line.c_str() + 13, nullptr, 10)) * 1024;
+        }
+      }
+      return size_t{0};
+    }();
+    return huge_page_size;
+#else
+    return 0;
+#endif
+  }
+
+  void* AllocHugePages(size_t size, int numa_node) const override {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    constexpr int kMaxNodes = sizeof(unsigned long) * 8;
+    const size_t huge_page_size = GetHugePageSize();
+    if (size == 0 || huge_page_size == 0 || numa_node >= kMaxNodes) return nullptr;
+    const size_t rounded_size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+    // the huge pages reserved by the administrator, see vm.nr_hugepages
+    void* p = mmap(nullptr, rounded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED) {
+#if defined(MADV_HUGEPAGE)
+      // otherwise transparent huge pages, for a region aligned to the huge page size so that all of it can be
+      // backed by them. the unaligned head and tail of a larger region are unmapped.
+      static const bool transparent_huge_pages = TransparentHugePagesEnabled();
+      if (!transparent_huge_pages) return nullptr;
+
+      void* region = mmap(nullptr, rounded_size + huge_page_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (region == MAP_FAILED) return nullptr;
+
+      const auto start = reinterpret_cast<uintptr_t>(region);
+      const auto aligned = (start + huge_page_size - 1) & ~(static_cast<uintptr_t>(huge_page_size) - 1);
+      if (aligned > start) munmap(region, aligned - start);
+      const size_t tail = start + huge_page_size - aligned;
+      if (tail > 0) munmap(reinterpret_cast<void*>(aligned + rounded_size), tail);
+
+      p = reinterpret_cast<void*>(aligned);
+      if (madvise(p, rounded_size, MADV_HUGEPAGE) != 0) {
+        LOGS_DEFAULT(INFO) << "madvise(MADV_HUGEPAGE) failed. error code:" << errno;
+        munmap(p, rounded_size);
+        return nullptr;
+      }
+#else
+      return nullptr;
+#endif
+    }
+
+    if (numa_node >= 0) PreferNumaNode(p, rounded_size, numa_node);
+    return p;
+#else
+    ORT_UNUSED_PARAMETER(size);
+    ORT_UNUSED_PARAMETER(numa_node);
+    return nullptr;
+#endif
+  }
+
+  void FreeHugePages(void* p, size_t size) const override {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    const size_t huge_page_size = GetHugePageSize();
+    if (p != nullptr) munmap(p, (size + huge_page_size - 1) / huge_page_size * huge_page_size);
+#else
+    ORT_UNUSED_PARAMETER(p);
+    ORT_UNUSED_PARAMETER(size);
+#endif
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
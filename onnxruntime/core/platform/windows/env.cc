@@ -60,6 +60,61 @@ class WindowsEnv : public Env {
     return processorCoreCount;
   }
 
+  bool SetCurrentThreadAffinity(int logical_processor) const override {
+    // affinity masks only cover the processors of the current processor group
+    if (logical_processor < 0 || logical_processor >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << logical_processor) != 0;
+  }
+
+  int GetNumaNodeCount() const override {
+    ULONG highest_node = 0;
+    return GetNumaHighestNodeNumber(&highest_node) ? static_cast<int>(highest_node) + 1 : 1;
+  }
+
+  std::vector<int> GetNumaNodeProcessors(int numa_node) const override {
+    std::vector<int> processors;
+    ULONGLONG mask = 0;
+    if (numa_node < 0 || numa_node > 0xFF || !GetNumaNodeProcessorMask(static_cast<UCHAR>(numa_node), &mask)) {
+      return processors;
+    }
+    // as for SetCurrentThreadAffinity, only the processors of the current processor group
+    for (int i = 0; i < static_cast<int>(sizeof(DWORD_PTR) * 8); ++i) {
+      if (mask & (static_cast<ULONGLONG>(1) << i)) processors.push_back(i);
+    }
+    return processors;
+  }
+
+  void* AllocOnNumaNode(size_t size, int numa_node) const override {
+    if (size == 0 || numa_node < 0) return nullptr;
+    return VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                              static_cast<DWORD>(numa_node));
+  }
+
+  void FreeOnNumaNode(void* p, size_t /*size*/) const override {
+    if (p != nullptr) VirtualFree(p, 0, MEM_RELEASE);
+  }
+
+  size_t GetHugePageSize() const override {
+    return GetLargePageMinimum();
+  }
+
+  void* AllocHugePages(size_t size, int numa_node) const override {
+    // large pages require the SeLockMemoryPrivilege of the account, the allocation fails without it
+    const size_t huge_page_size = GetHugePageSize();
+    if (size == 0 || huge_page_size == 0) return nullptr;
+    const size_t rounded_size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+    const DWORD type = MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES;
+    if (numa_node >= 0) {
+      return VirtualAllocExNuma(GetCurrentProcess(), nullptr, rounded_size, type, PAGE_READWRITE,
+                                static_cast<DWORD>(numa_node));
+    }
+    return VirtualAlloc(nullptr, rounded_size, type, PAGE_READWRITE);
+  }
+
+  void FreeHugePages(void* p, size_t /*size*/) const override {
+    if (p != nullptr) VirtualFree(p, 0, MEM_RELEASE);
+  }
+
   static WindowsEnv& Instance() {
     static WindowsEnv default_env;
     return default_env;
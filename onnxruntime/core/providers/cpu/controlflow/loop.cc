@@ -163,6 +163,12 @@ class LoopImpl {
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // custom allocators for the loop carried var outputs of the subgraph, so each can be written to the buffer fed
+  // to the previous iteration instead of a new one. only used when the outputs are on CPU and need no copies.
+  void CreateLoopCarriedVarAllocators(const FeedsFetchesManager& ffm, const std::vector<OrtValue>& feeds,
+                                      std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators);
+  Status AllocateLoopCarriedVar(int index, MLDataType data_type, const TensorShape& shape, OrtValue& ort_value);
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
@@ -178,6 +184,12 @@ class LoopImpl {
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
+  AllocatorPtr allocator_;
+
+  // for each loop carried var, the buffer fed to the previous iteration if nothing else uses it.
+  // the output of the next iteration is written to it, so the state alternates between two buffers.
+  std::vector<OrtValue> free_loop_carried_vars_;
+
   // collection of OrtValue outputs from each loop iteration for the loop outputs.
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
@@ -330,6 +342,8 @@ Status LoopImpl::Initialize() {
   condition_mlvalue_ = MakeScalarMLValue<bool>(allocator, condition_, condition_rank);
 
   loop_output_tensors_.resize(info_.num_outputs - info_.num_loop_carried_vars);
+  free_loop_carried_vars_.resize(info_.num_loop_carried_vars);
+  allocator_ = allocator;
 
   return status;
 }
@@ -359,6 +373,18 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
 
   // simple copy for cond and loop carried vars. start at 1 to skip iter_num in input
   for (int i = 1; i < info_.num_subgraph_inputs; ++i) {
+    if (i > 1) {
+      // the loop carried var fed to the last iteration can be written to by the next one if nothing else has it.
+      // the Loop inputs fed to the first iteration, outer scope values and initializers never are as they have
+      // other owners.
+      OrtValue& last_input = next_inputs[i];
+      auto& free_value = free_loop_carried_vars_[i - 2];
+      free_value = std::move(last_input);
+      if (!free_value.IsUnique() || !free_value.IsTensor()) {
+        free_value = OrtValue();
+      }
+    }
+
     next_inputs[i] = last_outputs[i - 1];
   }
 
@@ -368,6 +394,48 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   }
 }
 
+void LoopImpl::CreateLoopCarriedVarAllocators(const FeedsFetchesManager& ffm, const std::vector<OrtValue>& feeds,
+                                              std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
+  if (ffm.GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+    return;
+  }
+
+  const auto& fetch_copy_info = ffm.GetFetchesDeviceCopyInfo();
+  for (int i = 0; i < info_.num_loop_carried_vars; ++i) {
+    const auto& initial_value = feeds[i + 2];  // skip iter_num and cond
+    const size_t output = i + 1;               // skip cond
+    if (!initial_value.IsTensor() || fetch_copy_info[output].source_device.Type() != OrtDevice::CPU) {
+      continue;
+    }
+
+    auto* data_type = initial_value.Get<Tensor>().DataType();
+    fetch_allocators[output] = [this, i, data_type](const TensorShape& shape, OrtValue& ort_value) {
+      return AllocateLoopCarriedVar(i, data_type, shape, ort_value);
+    };
+  }
+}
+
+Status LoopImpl::AllocateLoopCarriedVar(int index, MLDataType data_type, const TensorShape& shape,
+                                        OrtValue& ort_value) {
+  auto& free_value = free_loop_carried_vars_[index];
+  if (free_value.IsAllocated()) {
+    const auto& tensor = free_value.Get<Tensor>();
+    if (tensor.DataType() == data_type && tensor.Shape() == shape) {
+      ort_value = std::move(free_value);
+      free_value = OrtValue();
+      return Status::OK();
+    }
+
+    // the shape changed, so the buffer can't be reused
+    free_value = OrtValue();
+  }
+
+  auto p_tensor = std::make_unique<Tensor>(data_type, shape, allocator_);
+  ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  return Status::OK();
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   size_t bytes_per_iteration = first_output.SizeInBytes();
@@ -414,6 +482,9 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   CreateInitialFeeds(feeds);
 
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  CreateLoopCarriedVarAllocators(ffm, feeds, fetch_allocators);
+
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
@@ -422,7 +493,7 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     /*sequential_execution*/ true, context_.GetTerminateFlag(), context_.Logger());
 
     ORT_RETURN_IF_ERROR(status);
@@ -8,6 +8,8 @@
 #pragma warning(push)
 #pragma warning(disable : 4996)
 #endif
+#include <algorithm>
+
 #include "core/providers/cpu/controlflow/scan.h"
 #include "core/providers/cpu/controlflow/scan_utils.h"
 #include "core/providers/cpu/controlflow/utils.h"
@@ -438,10 +440,47 @@ Status ScanImpl::Execute(const FeedsFetchesManager& ffm) {
     }
   }
 
-  // Call the subgraph for each item in the sequence
-  status = IterateSequence(context_, session_state_, loop_state_variables, scan_input_stream_iterators,
-                           sequence_len_, info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
-                           implicit_inputs_, output_iterators_, ffm);
+  // without loop state variables the iterations are independent, so can be run in parallel on the inter-op thread
+  // pool if there is one. the first iteration is always run here, as it allocates the outputs with symbolic
+  // dimensions in their shape.
+  auto* thread_pool = session_state_.GetInterOpThreadPool();
+  if (info_.num_loop_state_variables == 0 && thread_pool != nullptr && sequence_len_ > 2) {
+    // the iterators are copied before IterateSequence moves them
+    auto first_input_iterators = scan_input_stream_iterators;
+    status = IterateSequence(context_, session_state_, loop_state_variables, scan_input_stream_iterators,
+                             1, info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
+                             implicit_inputs_, output_iterators_, ffm);
+    ORT_RETURN_IF_ERROR(status);
+
+    // split the other iterations into a block per thread, so each is a single IterateSequence call
+    const int64_t num_iterations = sequence_len_ - 1;
+    const int64_t num_blocks = std::min<int64_t>(thread_pool->NumThreads() + 1, num_iterations);
+    status = RunInParallel(*thread_pool, num_blocks, [&](int64_t block) {
+      const int64_t first = 1 + block * num_iterations / num_blocks;
+      const int64_t last = 1 + (block + 1) * num_iterations / num_blocks;
+
+      auto input_iterators = first_input_iterators;
+      for (auto& iterator : input_iterators) {
+        // += moves backwards through the input for a reverse iterator
+        iterator += first;
+      }
+
+      std::vector<std::unique_ptr<OutputIterator>> output_iterators(info_.num_outputs);
+      for (int output = 0; output < info_.num_outputs; ++output) {
+        ORT_RETURN_IF_ERROR(output_iterators_[output]->CreateOffsetIterator(first, output_iterators[output]));
+      }
+
+      std::vector<LoopStateVariable> no_loop_state_variables;
+      return IterateSequence(context_, session_state_, no_loop_state_variables, input_iterators, last - first,
+                             info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs, implicit_inputs_,
+                             output_iterators, ffm);
+    });
+  } else {
+    // Call the subgraph for each item in the sequence
+    status = IterateSequence(context_, session_state_, loop_state_variables, scan_input_stream_iterators,
+                             sequence_len_, info_.num_loop_state_variables, info_.num_inputs, info_.num_outputs,
+                             implicit_inputs_, output_iterators_, ffm);
+  }
 
   ORT_RETURN_IF_ERROR(status);
 
@@ -11,6 +11,11 @@
 
 #include "core/providers/cpu/controlflow/scan_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 #include "gsl/gsl_algorithm"
 
 #include "core/framework/mldata_type_utils.h"
@@ -18,6 +23,7 @@
 #include "core/framework/sequential_executor.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
 #ifdef _MSC_VER
@@ -266,6 +272,61 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
   return status;
 }
 
+Status RunInParallel(concurrency::ThreadPool& thread_pool, int64_t total, const std::function<Status(int64_t)>& fn) {
+  if (total <= 0) {
+    return Status::OK();
+  }
+
+  // shared with the helpers, which may start after all the work is done and this function has returned
+  struct State {
+    State(int64_t total_in, const std::function<Status(int64_t)>& fn_in)
+        : total{total_in}, fn{fn_in}, statuses(static_cast<size_t>(total_in)) {}
+
+    const int64_t total;
+    // only called for the entries claimed before 'done' reaches 'total', while the caller is still waiting
+    const std::function<Status(int64_t)>& fn;
+    std::vector<Status> statuses;
+    std::atomic<int64_t> next{0};
+    std::atomic<int64_t> done{0};
+    std::mutex mutex;
+    std::condition_variable all_done;
+  };
+
+  auto state = std::make_shared<State>(total, fn);
+  auto work = [state]() {
+    for (int64_t i = state->next++; i < state->total; i = state->next++) {
+      try {
+        state->statuses[i] = state->fn(i);
+      } catch (const std::exception& ex) {
+        state->statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      }
+
+      if (++state->done == state->total) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->all_done.notify_all();
+      }
+    }
+  };
+
+  const int64_t num_helpers = std::min<int64_t>(thread_pool.NumThreads(), total - 1);
+  for (int64_t i = 0; i < num_helpers; ++i) {
+    thread_pool.Schedule(work);
+  }
+
+  // the entries this thread doesn't get to are being run by helpers that started, so the wait can't deadlock
+  work();
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->all_done.wait(lock, [&state]() { return state->done == state->total; });
+  }
+
+  for (const auto& status : state->statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
 OrtValue AllocateTensorInMLValue(const MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator) {
   auto new_tensor = std::make_unique<Tensor>(data_type,
                                              shape,
@@ -404,7 +465,7 @@ OutputIterator::OutputIterator(OpKernelContextInternal& context,
   if (is_v8) {
     // there are one or two dimensions being iterated depending on whether it's a loop state variable or scan input.
     auto num_iteration_dims = is_loop_state_var_ ? 1 : 2;
-    num_iterations_ = final_shape_.Slice(0, num_iteration_dims).Size();
+    num_iterations_ = final_shape_.SizeToDimension(num_iteration_dims);
   } else {
     // batch dimension is not handled in v9 and later so for a loop state var there are no iterations, and for
     // the scan outputs we use dimension 0 which is the sequence length.
@@ -510,6 +571,34 @@ Status OutputIterator::AllocateSubgraphOutput(const TensorShape& shape, OrtValue
   return Status::OK();
 }
 
+Status OutputIterator::CreateOffsetIterator(int64_t offset, std::unique_ptr<OutputIterator>& iterator) const {
+  ORT_ENFORCE(is_concrete_shape_ && final_output_mlvalue_, "The final output must be allocated to be split.");
+  ORT_ENFORCE(!is_loop_state_var_, "Loop state variables are not iterated in parts.");
+
+  iterator.reset(new OutputIterator(context_, output_index_, is_loop_state_var_, is_v8_, final_shape_,
+                                    direction_, temporary_, data_type_));
+  iterator->final_output_mlvalue_ = final_output_mlvalue_;
+
+  if (is_v8_) {
+    // the sequence (dim 1) of the batch entry
+    ORT_ENFORCE(offset >= 0 && offset < final_shape_[0], "Invalid batch entry ", offset);
+    auto slicer = OrtValueTensorSlicer<OrtValue>::Create(*final_output_mlvalue_, 1, offset);
+    iterator->slicer_iterators_.push_back(direction_ == ScanDirection::kForward ? slicer.begin() : slicer.rbegin());
+    iterator->num_iterations_ = final_shape_[1];
+  } else {
+    ORT_ENFORCE(offset >= 0 && offset <= final_shape_[0], "Invalid iteration ", offset);
+    auto slicer = OrtValueTensorSlicer<OrtValue>::Create(*final_output_mlvalue_);
+    iterator->slicer_iterators_.push_back(direction_ == ScanDirection::kForward ? slicer.begin() : slicer.rbegin());
+    // for a reverse iterator += moves backwards through the output
+    iterator->slicer_iterators_.back() += offset;
+    iterator->num_iterations_ = final_shape_[0] - offset;
+  }
+
+  iterator->cur_slicer_iterator_ = iterator->slicer_iterators_.begin();
+
+  return Status::OK();
+}
+
 OrtValue& OutputIterator::operator*() {
   ORT_ENFORCE(cur_iteration_ < num_iterations_);
   ORT_ENFORCE(is_concrete_shape_,
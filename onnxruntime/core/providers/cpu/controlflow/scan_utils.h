@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,9 @@
 namespace onnxruntime {
 class GraphViewer;
 class OrtValueNameIdxMap;
+namespace concurrency {
+class ThreadPool;
+}
 class OpKernelContextInternal;
 class Node;
 
@@ -134,6 +138,11 @@ class OutputIterator {
     return *final_output_mlvalue_;
   }
 
+  // Create an iterator over part of this scan output, so parts of the Scan can be run in parallel.
+  // The final output must have been allocated.
+  // v8: the sequence of batch entry 'offset'. v9: the iterations from 'offset' on.
+  Status CreateOffsetIterator(int64_t offset, std::unique_ptr<OutputIterator>& iterator) const;
+
  private:
   OutputIterator(OpKernelContextInternal& context,
                  int output_index,
@@ -197,6 +206,13 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
                        std::vector<std::unique_ptr<OutputIterator>>& output_iterators,
                        const FeedsFetchesManager& ffm);
 
+/**
+Run fn(i) for i in [0, total) on the calling thread, helped by the threads of thread_pool that are free.
+Unlike ThreadPool::ParallelFor it never waits for work queued behind busy threads, so it may be called from a thread
+of the pool itself, as the nodes run by the parallel executor are. Returns the first failure.
+*/
+Status RunInParallel(concurrency::ThreadPool& thread_pool, int64_t total, const std::function<Status(int64_t)>& fn);
+
 OrtValue AllocateTensorInMLValue(MLDataType data_type, const TensorShape& shape, AllocatorPtr& allocator);
 
 /**
@@ -12,6 +12,14 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // Bytes of freed small chunks each thread may keep for reuse before returning them to the arena. 0 disables it.
+  size_t arena_thread_cache_bytes{0};
+  // NUMA node to allocate the memory on, -1 for none.
+  int numa_node{-1};
+  // back the allocations of at least a huge page, such as the regions of the arena, with huge pages.
+  bool use_huge_pages{false};
+  // let the float MatMul kernel compute its dot products from bfloat16 rounded inputs, see MlasSgemmBf16.
+  bool use_bf16_matmul{false};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -26,10 +34,24 @@ using FuseRuleFn = std::function<void(const onnxruntime::GraphViewer&,
 class CPUExecutionProvider : public IExecutionProvider {
  public:
   explicit CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-      : IExecutionProvider{onnxruntime::kCpuExecutionProvider} {
+      : IExecutionProvider{onnxruntime::kCpuExecutionProvider}, use_bf16_matmul_(info.use_bf16_matmul) {
     DeviceAllocatorRegistrationInfo device_info{OrtMemTypeDefault,
-                                                [](int) { return std::make_unique<CPUAllocator>(); },
-                                                std::numeric_limits<size_t>::max()};
+                                                [numa_node = info.numa_node, use_huge_pages = info.use_huge_pages](int) -> std::unique_ptr<IDeviceAllocator> {
+                                                  std::unique_ptr<IDeviceAllocator> allocator;
+                                                  if (numa_node >= 0) {
+                                                    allocator = std::make_unique<NumaCPUAllocator>(
+                                                        std::make_unique<OrtMemoryInfo>(CPU, OrtAllocatorType::OrtDeviceAllocator),
+                                                        numa_node);
+                                                  } else {
+                                                    allocator = std::make_unique<CPUAllocator>();
+                                                  }
+                                                  if (use_huge_pages) {
+                                                    return std::make_unique<HugePageCPUAllocator>(std::move(allocator), numa_node);
+                                                  }
+                                                  return allocator;
+                                                },
+                                                std::numeric_limits<size_t>::max(),
+                                                info.arena_thread_cache_bytes};
 #ifdef USE_JEMALLOC
     ORT_UNUSED_PARAMETER(info);
     //JEMalloc already has memory pool, so just use device allocator.
@@ -49,7 +71,10 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  bool UseBf16MatMul() const { return use_bf16_matmul_; }
+
  private:
   std::vector<FuseRuleFn> fuse_rules_;
+  bool use_bf16_matmul_;
 };
 }  // namespace onnxruntime
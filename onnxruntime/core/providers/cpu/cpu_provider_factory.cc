@@ -10,22 +10,48 @@
 namespace onnxruntime {
 
 struct CpuProviderFactory : IExecutionProviderFactory {
-  CpuProviderFactory(bool create_arena) : create_arena_(create_arena) {}
+  CpuProviderFactory(bool create_arena, int numa_node, bool use_huge_pages, bool use_bf16_matmul)
+      : create_arena_(create_arena),
+        numa_node_(numa_node),
+        use_huge_pages_(use_huge_pages),
+        use_bf16_matmul_(use_bf16_matmul) {}
   ~CpuProviderFactory() override = default;
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
   bool create_arena_;
+  int numa_node_;
+  bool use_huge_pages_;
+  bool use_bf16_matmul_;
 };
 
 std::unique_ptr<IExecutionProvider> CpuProviderFactory::CreateProvider() {
   CPUExecutionProviderInfo info;
   info.create_arena = create_arena_;
+  info.numa_node = numa_node_;
+  info.use_huge_pages = use_huge_pages_;
+  info.use_bf16_matmul = use_bf16_matmul_;
   return std::make_unique<CPUExecutionProvider>(info);
 }
 
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena, int numa_node,
+                                                                              bool use_huge_pages,
+                                                                              bool use_bf16_matmul) {
+  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0, numa_node, use_huge_pages,
+                                                           use_bf16_matmul);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena, int numa_node,
+                                                                              bool use_huge_pages) {
+  return CreateExecutionProviderFactory_CPU(use_arena, numa_node, use_huge_pages, false);
+}
+
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena, int numa_node) {
+  return CreateExecutionProviderFactory_CPU(use_arena, numa_node, false);
+}
+
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena) {
-  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0);
+  return CreateExecutionProviderFactory_CPU(use_arena, -1);
 }
 
 }  // namespace onnxruntime
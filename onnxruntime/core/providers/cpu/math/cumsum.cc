@@ -2,51 +2,10 @@
 // Licensed under the MIT License.
 
 #include "cumsum.h"
-#include "core/providers/cpu/tensor/utils.h"
+#include <algorithm>
 #include "core/framework/op_kernel.h"
-#include "core/framework/tensorprotoutils.h"
-
-using namespace onnxruntime;
-
-namespace {
-// static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(rank, 0);
-  starts[axis] = index;
-  return starts;
-}
-template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
-  }
-}
-template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
-  }
-}
-template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               const std::vector<int64_t>& slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
-  }
-}
-}  // namespace
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/parallel_scan.h"
 
 namespace onnxruntime {
 
@@ -99,61 +58,87 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  auto dim(output_tensor.Shape()[axis]);    // dimension size for the axis
-  TensorShape slice_shape(input->Shape());  // the shape of one slice of input/output for the given value of the axis
-  slice_shape[axis] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(rank, 1);  // steps for the slice -- always set to 1
-
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
+  // The input and output are viewed as outer x dim x inner, with the accumulation along dim.
+  const int64_t dim = output_shape[axis];
+  const int64_t outer = output_shape.SizeToDimension(axis);
+  const int64_t inner = output_shape.SizeFromDimension(axis + 1);
+
+  const T* input_data = input->template Data<T>();
+  T* output_data = output_tensor.template MutableData<T>();
+
+  // Step t of the accumulation writes the output at Position(t) along the axis. It adds the input at Position(t)
+  // to the sum of the previous steps, or with exclusive the input at the position of the previous step.
+  const bool reverse = reverse_ != 0;
+  const bool exclusive = exclusive_ != 0;
+  const auto position = [dim, reverse](int64_t t) { return reverse ? dim - 1 - t : t; };
+
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+
+  if (inner == 1 && tp != nullptr && outer <= tp->NumThreads()) {
+    // Few long rows: scan each row in parallel blocks.
+    for (int64_t o = 0; o < outer; ++o) {
+      const T* input_row = input_data + o * dim;
+      T* output_row = output_data + o * dim;
+      const auto step_value = [=](int64_t t) {
+        if (exclusive) {
+          return t == 0 ? T{} : input_row[position(t - 1)];
+        }
+        return input_row[position(t)];
+      };
+
+      ParallelPrefixScan<T> scan(tp, dim, 1.0);
+      scan.Reduce([&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        T sum{};
+        for (std::ptrdiff_t t = first; t < last; ++t) {
+          sum += step_value(t);
+        }
+        return sum;
+      });
+      scan.Scan([&](std::ptrdiff_t first, std::ptrdiff_t last, T sum) {
+        for (std::ptrdiff_t t = first; t < last; ++t) {
+          sum += step_value(t);
+          output_row[position(t)] = sum;
+        }
+      });
     }
+    return Status::OK();
+  }
 
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
-    {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
+  // Otherwise every column of the outer x inner planes is independent. A block of columns walks the axis adding
+  // whole runs of contiguous columns from one step to the next.
+  auto accumulate_columns = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    while (first < last) {
+      const int64_t o = first / inner;
+      const int64_t column_begin = first % inner;
+      const int64_t column_end = std::min<int64_t>(inner, column_begin + (last - first));
+      const T* input_plane = input_data + o * dim * inner;
+      T* output_plane = output_data + o * dim * inner;
+
+      for (int64_t t = 0; t < dim; ++t) {
+        T* output_run = output_plane + position(t) * inner;
+        if (t == 0) {
+          const T* input_run = input_plane + position(t) * inner;
+          for (int64_t c = column_begin; c < column_end; ++c) {
+            output_run[c] = exclusive ? T{} : input_run[c];
+          }
+        } else {
+          const T* previous_run = output_plane + position(t - 1) * inner;
+          const T* input_run = input_plane + position(exclusive ? t - 1 : t) * inner;
+          for (int64_t c = column_begin; c < column_end; ++c) {
+            output_run[c] = previous_run[c] + input_run[c];
+          }
+        }
+      }
+
+      first += column_end - column_begin;
     }
+  };
 
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
+  const std::ptrdiff_t columns = outer * inner;
+  if (tp == nullptr) {
+    accumulate_columns(0, columns);
+  } else {
+    tp->ParallelFor(columns, static_cast<double>(dim), accumulate_columns);
   }
 
   return Status::OK();
@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include <unsupported/Eigen/SpecialFunctions>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
 
@@ -18,6 +20,30 @@ namespace onnxruntime {
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       KERNEL_CLASS<TYPE>);
 
+// the input and output are read and written at the same index, so the output may use the buffer of an input of the
+// same size. the variadic ops such as Sum and Max aren't registered in-place.
+#define REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
+      OP_TYPE,                                                                     \
+      VERSION,                                                                     \
+      TYPE,                                                                        \
+      KernelDefBuilder()                                                           \
+          .MayInplace(0, 0)                                                        \
+          .MayInplace(1, 0)                                                        \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),               \
+      KERNEL_CLASS<TYPE>);
+
+// the unary ops only have the input 0 to write their output over.
+#define REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                        \
+      OP_TYPE,                                                                           \
+      VERSION,                                                                           \
+      TYPE,                                                                              \
+      KernelDefBuilder()                                                                 \
+          .MayInplace(0, 0)                                                              \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                     \
+      KERNEL_CLASS<TYPE>);
+
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
       OP_TYPE,                                                                     \
@@ -44,58 +70,58 @@ namespace onnxruntime {
                         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),                    \
       KERNEL_CLASS<TYPE>);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 7, int64_t, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, float, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, double, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, int32_t, Add);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Add, 7, int64_t, Add);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, float, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, double, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, int32_t, Sub);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Sub, 7, int64_t, Sub);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, float, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, double, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, int32_t, Mul);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Mul, 7, int64_t, Mul);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 7, int64_t, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, float, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, double, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, int32_t, Div);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Div, 7, int64_t, Div);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, float, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, double, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, int64_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, float, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, double, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, int8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, int16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, int32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, int64_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, uint8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, uint16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, uint32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 6, uint64_t, Abs);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, float, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, double, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int8_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 6, int32_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 6, float, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 6, double, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 6, int8_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 6, int32_t, Neg);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 6, float, Floor);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Floor, 6, float, Floor);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 6, float, Ceil);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Ceil, 6, float, Ceil);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Reciprocal, 6, float, Reciprocal);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 6, float, Sqrt);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 6, double, Sqrt);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, float, Pow);
-REG_ELEMENTWISE_TYPED_KERNEL(Pow, 7, double, Pow);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Pow, 7, float, Pow);
+REG_ELEMENTWISE_INPLACE_TYPED_KERNEL(Pow, 7, double, Pow);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, float, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 6, double, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Exp, 6, float, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Exp, 6, double, Exp);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 6, float, Log);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Log, 6, float, Log);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, float, Sum_6);
 REG_ELEMENTWISE_TYPED_KERNEL(Sum, 8, float, Sum_8);
@@ -124,7 +150,7 @@ REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(Equal, 11, float, Equal);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mean, 6, 7, float, Mean_6);
 REG_ELEMENTWISE_TYPED_KERNEL(Mean, 8, float, Mean_8);
 
-REG_ELEMENTWISE_TYPED_KERNEL(Erf, 9, float, Erf);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Erf, 9, float, Erf);
 
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(Not, 1, bool, Not);
 // REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(And, 7, bool, And);
@@ -161,8 +187,9 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 template <typename T>
 Status Add<T>::Compute(OpKernelContext* context) const {
-  return BroadcastTwo<T, T>(
+  return ParallelBroadcastTwo<T, T>(
       *context,
+      static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool(),
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 + input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() + input1; },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 + input1; });
@@ -170,8 +197,9 @@ Status Add<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Sub<T>::Compute(OpKernelContext* context) const {
-  return BroadcastTwo<T, T>(
+  return ParallelBroadcastTwo<T, T>(
       *context,
+      static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool(),
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 - input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() - input1; },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0 - input1; });
@@ -179,8 +207,9 @@ Status Sub<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Mul<T>::Compute(OpKernelContext* context) const {
-  return BroadcastTwo<T, T>(
+  return ParallelBroadcastTwo<T, T>(
       *context,
+      static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool(),
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 * input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() * input1; },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseProduct(input1); });
@@ -188,8 +217,9 @@ Status Mul<T>::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status Div<T>::Compute(OpKernelContext* context) const {
-  return BroadcastTwo<T, T>(
+  return ParallelBroadcastTwo<T, T>(
       *context,
+      static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool(),
       [](EigenVectorMap<T> output, T input0, ConstEigenVectorMap<T> input1) { output = input0 / input1.array(); },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, T input1) { output = input0.array() / input1; },
       [](EigenVectorMap<T> output, ConstEigenVectorMap<T> input0, ConstEigenVectorMap<T> input1) { output = input0.cwiseQuotient(input1); });
@@ -790,35 +820,9 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     PRelu<float>);
 
-// This is a special case version of TBroadcaster just for Expand that only has a shape as the second parameter
-template <typename T>
-struct TBroadcasterExpand {
-  TBroadcasterExpand(const Tensor& input, const std::vector<int64_t>& shape)
-      : input_tensor_(input),
-        broadcaster_(input.Shape().GetDims(), shape) {
-  }
-
-  TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
-  size_t GetSpanSize() const { return span_size_; }
-
-  bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
-
-  T NextScalar() { return *Next(); }
-
-  ConstEigenVectorMap<T> NextEigen() { return ConstEigenVectorMap<T>(Next(), span_size_); }
-
- private:
-  const T* Next() { return input_ + broadcaster_.iterator1_.AdvanceBy(span_size_); }
-
-  const Tensor& input_tensor_;
-  Broadcaster broadcaster_;
-  size_t span_size_{broadcaster_.GetSpanSize()};
-
-  const T* input_{input_tensor_.template Data<T>()};
-};
-
 template <typename T>
 Status Expand_8<T>::Compute(OpKernelContext* context) const {
+  const auto& input = *context->Input<Tensor>(0);
   auto& tensor_shape = *context->Input<Tensor>(1);
   ORT_ENFORCE(tensor_shape.Shape().GetDims().size() == 1, "Shape must be 1 dimensional as it's tensor data is a shape");
 
@@ -826,19 +830,31 @@ Status Expand_8<T>::Compute(OpKernelContext* context) const {
   const auto* p_shape = tensor_shape.template Data<int64_t>();
   std::vector<int64_t> shape{p_shape, p_shape + tensor_shape.Shape().Size()};
 
-  TBroadcasterExpand<T> bc(*context->Input<Tensor>(0), shape);
-  TBroadcastOutput<T> output(bc.GetSpanSize(), *context->Output(0, bc.GetOutputShape()));
-
-  // This doesn't use BroadcastLoop since there is no second tensor, just duplicating the first
-  if (bc.IsInput0Scalar()) {
-    // Input0 being a scalar is the only special case here, since we're duplicating a single value
-    while (output)
-      output.NextEigenOutput().array() = bc.NextScalar();
-  } else {
-    // Input1 being a scalar doesn't matter (as there's no actual input1). We're still duplicating Input0 in the same sized chunks
-    while (output)
-      output.NextEigenOutput() = bc.NextEigen();
+  // The Broadcaster validates the shapes and computes the output shape
+  const auto& input_dims = input.Shape().GetDims();
+  const std::vector<int64_t> output_dims = Broadcaster(input_dims, shape).output_shape_;
+  auto& output = *context->Output(0, TensorShape::ReinterpretBaseType(output_dims));
+
+  // Expand is a strided copy of the input that steps by zero along the broadcast axes
+  const size_t rank = output_dims.size();
+  const size_t rank_offset = rank - input_dims.size();
+  std::vector<int64_t> input_strides(rank, 0);
+  std::vector<int64_t> output_strides(rank, 0);
+  int64_t input_pitch = 1;
+  int64_t output_pitch = 1;
+  for (size_t i = rank; i-- > 0;) {
+    output_strides[i] = output_pitch;
+    output_pitch *= output_dims[i];
+    if (i >= rank_offset) {
+      const int64_t input_dim = input_dims[i - rank_offset];
+      input_strides[i] = input_dim == 1 ? 0 : input_pitch;
+      input_pitch *= input_dim;
+    }
   }
+
+  auto tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  StridedCopy(tp, output.template MutableData<T>(), output_strides, input.template Data<T>(), input_strides,
+              output_dims);
   return Status::OK();
 }
 
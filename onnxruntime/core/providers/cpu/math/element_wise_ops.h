@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -320,6 +321,19 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Positions the iterator at the given element of the output so that a range of the
+  // output can be iterated independently. The position must be a multiple of the span size.
+  void SeekTo(size_t position) {
+    index_ = 0;
+    size_t stride = 1;
+    for (size_t counterIndex = 0; counterIndex < counts_.size(); counterIndex++) {
+      size_t steps = position / stride;
+      index_ += static_cast<size_t>(deltas_[counterIndex] * static_cast<ptrdiff_t>(steps));
+      counters_[counterIndex] = steps % counts_[counterIndex];
+      stride *= counts_[counterIndex];
+    }
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(max_dims);
     counts_.reserve(max_dims);
@@ -467,7 +481,7 @@ struct TBroadcaster {
         input_tensor1_(input1) {
   }
 
-  TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
+  const TensorShape& GetOutputShape() const { return TensorShape::ReinterpretBaseType(broadcaster_.output_shape_); }
   size_t GetSpanSize() const { return span_size_; }
 
   bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
@@ -592,6 +606,86 @@ Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1S
   return Status::OK();
 }
 
+// Threaded broadcast loop for when using eigen, the functions are in the same form as for BroadcastLoop.
+// The output is split into contiguous blocks of elements that run on the thread pool, and each block
+// walks its own copy of the broadcast iterators. A block may start or end inside a span, so the
+// functions can be handed spans shorter than the broadcast span. The common cases map onto it as:
+//   scalar broadcast  : a single span covering the output, split across the blocks
+//   last dim broadcast: one general span per row of the larger input
+//   channel broadcast : one scalar span per channel plane, e.g. {N, C, H, W} with {C, 1, 1}
+template <typename TInput0, typename TInput1, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(const Broadcaster& broadcaster, const TInput0* input0, const TInput1* input1,
+                           TOutput* output, ptrdiff_t output_size, concurrency::ThreadPool* tp,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const ptrdiff_t span_size = static_cast<ptrdiff_t>(broadcaster.GetSpanSize());
+  const bool input0_is_scalar = broadcaster.iterator1_.deltas_.front() == 0;
+  const bool input1_is_scalar = broadcaster.iterator2_.deltas_.front() == 0;
+
+  auto for_each_span = [&](ptrdiff_t first, ptrdiff_t last, auto fn) {
+    BroadcastIterator iterator0 = broadcaster.iterator1_;
+    BroadcastIterator iterator1 = broadcaster.iterator2_;
+
+    ptrdiff_t span_start = first - first % span_size;
+    iterator0.SeekTo(span_start);
+    iterator1.SeekTo(span_start);
+
+    for (ptrdiff_t position = first; position < last; span_start += span_size) {
+      const ptrdiff_t offset = position - span_start;
+      const ptrdiff_t count = std::min(span_size - offset, last - position);
+      const TInput0* span0 = input0 + iterator0.AdvanceBy(span_size) + (input0_is_scalar ? 0 : offset);
+      const TInput1* span1 = input1 + iterator1.AdvanceBy(span_size) + (input1_is_scalar ? 0 : offset);
+      fn(EigenVectorMap<TOutput>(output + position, count), span0, span1, count);
+      position += count;
+    }
+  };
+
+  std::function<void(ptrdiff_t, ptrdiff_t)> compute_range;
+  if (input0_is_scalar) {
+    compute_range = [&](ptrdiff_t first, ptrdiff_t last) {
+      for_each_span(first, last, [&](EigenVectorMap<TOutput> out, const TInput0* in0, const TInput1* in1, ptrdiff_t count) {
+        input0scalar(out, *in0, ConstEigenVectorMap<TInput1>(in1, count));
+      });
+    };
+  } else if (input1_is_scalar) {
+    compute_range = [&](ptrdiff_t first, ptrdiff_t last) {
+      for_each_span(first, last, [&](EigenVectorMap<TOutput> out, const TInput0* in0, const TInput1* in1, ptrdiff_t count) {
+        input1scalar(out, ConstEigenVectorMap<TInput0>(in0, count), *in1);
+      });
+    };
+  } else {
+    compute_range = [&](ptrdiff_t first, ptrdiff_t last) {
+      for_each_span(first, last, [&](EigenVectorMap<TOutput> out, const TInput0* in0, const TInput1* in1, ptrdiff_t count) {
+        general(out, ConstEigenVectorMap<TInput0>(in0, count), ConstEigenVectorMap<TInput1>(in1, count));
+      });
+    };
+  }
+
+  if (tp == nullptr) {
+    compute_range(0, output_size);
+  } else {
+    tp->ParallelFor(output_size, 1.0, compute_range);
+  }
+}
+
+// Same as BroadcastTwo, but the output is computed using ParallelBroadcastLoop on the supplied thread pool.
+template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
+Status ParallelBroadcastTwo(OpKernelContext& context, concurrency::ThreadPool* tp,
+                            Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const Tensor& input0 = *context.Input<Tensor>(0);
+  const Tensor& input1 = *context.Input<Tensor>(1);
+  Broadcaster broadcaster(input0.Shape().GetDims(), input1.Shape().GetDims());
+  Tensor& output = *context.Output(0, TensorShape::ReinterpretBaseType(broadcaster.output_shape_));
+
+  ptrdiff_t output_size = static_cast<ptrdiff_t>(output.Shape().Size());
+  if (output_size != 0) {
+    ParallelBroadcastLoop(broadcaster, input0.template Data<TInput>(), input1.template Data<TInput>(),
+                          output.template MutableData<TOutput>(), output_size, tp,
+                          input0scalar, input1scalar, general);
+  }
+
+  return Status::OK();
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
 Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
   auto input_count = node.InputArgCount().front();
@@ -9,6 +9,7 @@
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -25,6 +26,29 @@ class Gemm : public OpKernel {
 
     ORT_ENFORCE(info.GetAttr<float>("alpha", &alpha_).IsOK());
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
+
+    activation_.ActivationKind = MlasIdentityActivation;
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer, bool& is_packed) override {
+    is_packed = false;
+
+    // A constant W is packed once here so that each Compute can skip repacking it.
+    if (input_idx == 1 && tensor.DataType() == DataTypeImpl::GetType<float>() &&
+        tensor.Shape().NumDimensions() == 2 && tensor.Shape().Size() > 0) {
+      w_shape_ = tensor.Shape();
+      const auto K = static_cast<size_t>(trans_B_ == CblasNoTrans ? w_shape_[0] : w_shape_[1]);
+      const auto N = static_cast<size_t>(trans_B_ == CblasNoTrans ? w_shape_[1] : w_shape_[0]);
+
+      auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+      packed_buffer = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+      MlasSgemmPackB(trans_B_, N, K, tensor.template Data<float>(), trans_B_ == CblasNoTrans ? N : K,
+                     packed_buffer.get());
+      packed_b_ = packed_buffer.get();
+      is_packed = true;
+    }
+
+    return Status::OK();
   }
 
   Status Compute(OpKernelContext* context) const override {
@@ -32,9 +56,11 @@ class Gemm : public OpKernel {
     concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
 
     const auto X = context->Input<Tensor>(0);
-    const auto W = context->Input<Tensor>(1);
+    // the session may have released a packed W
+    const auto W = packed_b_ ? nullptr : context->Input<Tensor>(1);
     const auto B = context->Input<Tensor>(2);
-    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, W->Shape(), trans_B_ != CblasNoTrans, B->Shape());
+    GemmHelper helper(X->Shape(), trans_A_ != CblasNoTrans, packed_b_ ? w_shape_ : W->Shape(),
+                      trans_B_ != CblasNoTrans, B->Shape());
 
     if (!helper.State().IsOK())
       return helper.State();
@@ -47,7 +73,9 @@ class Gemm : public OpKernel {
       return Status::OK();
     T* y_data = Y->template MutableData<T>();
 
-    // Broadcast the bias as needed.
+    // Broadcast the bias as needed. A bias of (N,) or (1, N) that isn't scaled is added by the GEMM epilogue
+    // instead, along with the activation, while each block of the output is still in the cache.
+    const T* column_bias = nullptr;
     if (beta_ != 0) {
       auto output_mat = EigenMatrixMapRowMajor<T>(y_data, M, N);
       const auto& b_shape = B->Shape();
@@ -57,7 +85,11 @@ class Gemm : public OpKernel {
         output_mat.setConstant(*b_data);
       } else if (b_shape.NumDimensions() == 1 || b_shape[0] == 1) {
         // B is (N,) or (1, N)
-        output_mat.rowwise() = ConstEigenVectorMap<T>(b_data, N).transpose();
+        if (beta_ == 1) {
+          column_bias = b_data;
+        } else {
+          output_mat.rowwise() = ConstEigenVectorMap<T>(b_data, N).transpose();
+        }
       } else if (b_shape[1] == 1) {
         // B is (M, 1)
         output_mat.colwise() = ConstEigenVectorMap<T>(b_data, M);
@@ -68,21 +100,45 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
+    const int64_t K = helper.K();
+    if (packed_b_) {
+      MlasSgemmPacked(
+          trans_A_,
+          static_cast<size_t>(M),
+          static_cast<size_t>(N),
+          static_cast<size_t>(K),
+          alpha_,
+          X->template Data<T>(),
+          static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+          packed_b_,
+          column_bias != nullptr ? 0.0f : beta_,
+          y_data,
+          static_cast<size_t>(N),
+          column_bias,
+          &activation_,
+          tp);
+
+      return Status::OK();
+    }
+
+    MlasSgemm(
         trans_A_,
         trans_B_,
-        M,
-        N,
-        helper.K(),
+        static_cast<size_t>(M),
+        static_cast<size_t>(N),
+        static_cast<size_t>(K),
         alpha_,
         X->template Data<T>(),
+        static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
         W->template Data<T>(),
-        beta_,
+        static_cast<size_t>(trans_B_ == CblasNoTrans ? N : K),
+        column_bias != nullptr ? 0.0f : beta_,
         y_data,
+        static_cast<size_t>(N),
+        column_bias,
+        &activation_,
         tp);
 
-    FuseActivation<T>(activation_, y_data, M * N, leaky_relu_alpha_);
-
     return Status::OK();
   }
 
@@ -92,10 +148,13 @@ class Gemm : public OpKernel {
   float alpha_;
   float beta_;
 
+  // W packed by MlasSgemmPackB when it is a constant initializer, and its shape
+  const void* packed_b_ = nullptr;
+  TensorShape w_shape_;
+
  protected:
-  // For fused gemm + activation
-  std::string activation_;
-  float leaky_relu_alpha_;
+  // For fused gemm + activation, applied by the GEMM epilogue
+  MLAS_ACTIVATION activation_;
 };
 
 }  // namespace onnxruntime
@@ -2,9 +2,12 @@
 // Licensed under the MIT License.
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "Eigen/src/Core/arch/GPU/Half.h"
 #include "matmul_helper.h"
 
 namespace onnxruntime {
@@ -23,6 +26,13 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     MatMul<double>);
 
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 9,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     9, 9,
@@ -78,4 +88,148 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  // if the output is empty there's nothing to compute
+  if (M == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // Only the left operand and the output are expanded to float. The right operand, usually the weight,
+  // is read from half precision storage and converted a panel at a time while MLAS packs it.
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+
+  const int64_t left_size = left_X->Shape().Size();
+  const int64_t output_size = Y->Shape().Size();
+
+  auto left_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * left_size), BufferDeleter(alloc));
+  auto output_buffer = BufferUniquePtr(alloc->Alloc(sizeof(float) * output_size), BufferDeleter(alloc));
+  auto* left_data = static_cast<float*>(left_buffer.get());
+  auto* output_data = static_cast<float*>(output_buffer.get());
+
+  EigenVectorMap<float>(left_data, left_size) =
+      ConstEigenVectorMap<Eigen::half>(reinterpret_cast<const Eigen::half*>(left_X->Data<MLFloat16>()), left_size)
+          .template cast<float>();
+
+  const auto* right_data = reinterpret_cast<const MLAS_FP16*>(right_X->Data<MLFloat16>());
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, left_data + helper.LeftOffsets()[i], K,
+              right_data + helper.RightOffsets()[i], N, 0.0f, output_data + helper.OutputOffsets()[i], N,
+              nullptr, nullptr, thread_pool);
+  }
+
+  EigenVectorMap<Eigen::half>(reinterpret_cast<Eigen::half*>(Y->MutableData<MLFloat16>()), output_size) =
+      ConstEigenVectorMap<float>(output_data, output_size).template cast<Eigen::half>();
+
+  return Status::OK();
+}
+
+MatMul<float>::MatMul(const OpKernelInfo& info) : OpKernel(info) {
+  const auto* provider = info.GetExecutionProvider();
+  use_bf16_ = provider != nullptr && provider->Type() == kCpuExecutionProvider &&
+              static_cast<const CPUExecutionProvider*>(provider)->UseBf16MatMul();
+}
+
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer, bool& is_packed) {
+  is_packed = false;
+
+  // MlasSgemmBf16 packs the right operand itself
+  if (use_bf16_) {
+    return Status::OK();
+  }
+
+  // A constant 2D right operand is shared by every matrix in the batch, so pack it once here
+  // and skip repacking it on each Compute.
+  if (input_idx == 1 && tensor.DataType() == DataTypeImpl::GetType<float>() &&
+      tensor.Shape().NumDimensions() == 2 && tensor.Shape().Size() > 0) {
+    b_shape_ = tensor.Shape();
+    const auto K = static_cast<size_t>(b_shape_[0]);
+    const auto N = static_cast<size_t>(b_shape_[1]);
+
+    auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+    packed_buffer = BufferUniquePtr(alloc->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(alloc));
+    MlasSgemmPackB(CblasNoTrans, N, K, tensor.Data<float>(), N, packed_buffer.get());
+    packed_b_ = packed_buffer.get();
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  // the session may have released a packed right operand
+  const auto* right_X = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), packed_b_ ? b_shape_ : right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  // if the output is empty there's nothing to compute
+  if (M == 0) {
+    return Status::OK();
+  }
+
+  const float* left_data = left_X->Data<float>();
+  float* output_data = Y->MutableData<float>();
+
+  size_t max_len = helper.OutputOffsets().size();
+
+  if (use_bf16_) {
+    const float* right_data = right_X->Data<float>();
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSgemmBf16(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, left_data + helper.LeftOffsets()[i], K,
+                    right_data + helper.RightOffsets()[i], N, 0.0f, output_data + helper.OutputOffsets()[i], N,
+                    thread_pool);
+    }
+  } else if (packed_b_) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSgemmPacked(CblasNoTrans, M, N, K, 1.0f, left_data + helper.LeftOffsets()[i], K,
+                      packed_b_, 0.0f, output_data + helper.OutputOffsets()[i], N,
+                      nullptr, nullptr, thread_pool);
+    }
+  } else {
+    // Broadcasting produces many small multiplies of the same shape, so hand the whole batch to MLAS
+    // to spread across the threads rather than threading each one.
+    const float* right_data = right_X->Data<float>();
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
+    for (size_t i = 0; i < max_len; i++) {
+      data[i].A = left_data + helper.LeftOffsets()[i];
+      data[i].B = right_data + helper.RightOffsets()[i];
+      data[i].C = output_data + helper.OutputOffsets()[i];
+    }
+
+    MlasSgemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, K, N, 0.0f, N, data.data(), max_len, thread_pool);
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
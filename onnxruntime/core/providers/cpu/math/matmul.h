@@ -18,4 +18,25 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+// the right operand stays in half precision storage and is converted as MLAS packs it
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* context) const;
+
+template <>
+class MatMul<float> final : public OpKernel {
+ public:
+  MatMul(const OpKernelInfo& info);
+
+  Status PrePack(const Tensor& tensor, int input_idx, BufferUniquePtr& packed_buffer, bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // the right operand packed by MlasSgemmPackB when it is a constant 2D initializer, and its shape
+  const void* packed_b_ = nullptr;
+  TensorShape b_shape_;
+  // the products are computed from bfloat16 rounded inputs, see CPUExecutionProviderInfo::use_bf16_matmul
+  bool use_bf16_ = false;
+};
+
 }  // namespace onnxruntime
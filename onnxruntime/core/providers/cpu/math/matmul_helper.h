@@ -9,7 +9,10 @@ namespace onnxruntime {
 
 class MatMulComputeHelper {
  public:
-  Status Compute(const TensorShape& left_shape, const TensorShape& right_shape) {
+  // transa/transb swap the last two dims of the corresponding operand, which must then be at least 2D.
+  // The shapes and offsets computed are those of the transposed operands.
+  Status Compute(const TensorShape& orig_left_shape, const TensorShape& orig_right_shape,
+                 bool transa = false, bool transb = false) {
     // Following numpy.matmul for shape inference:
     // https://docs.scipy.org/doc/numpy/reference/generated/numpy.matmul.html
     // The behavior depends on the arguments in the following way.
@@ -18,13 +21,19 @@ class MatMulComputeHelper {
     // * If the first argument is 1 - D, it is promoted to a matrix by prepending a 1 to its dimensions.After matrix multiplication the prepended 1 is removed.
     // * If the second argument is 1 - D, it is promoted to a matrix by appending a 1 to its dimensions.After matrix multiplication the appended 1 is removed.
 
+    ORT_RETURN_IF_NOT(!transa || orig_left_shape.NumDimensions() >= 2, "transposed left operand must be at least 2D");
+    ORT_RETURN_IF_NOT(!transb || orig_right_shape.NumDimensions() >= 2, "transposed right operand must be at least 2D");
+    const TensorShape left_shape = transa ? SwapLastTwoDims(orig_left_shape) : orig_left_shape;
+    const TensorShape right_shape = transb ? SwapLastTwoDims(orig_right_shape) : orig_right_shape;
+
     size_t left_num_dims = left_shape.NumDimensions();
     size_t right_num_dims = right_shape.NumDimensions();
     ORT_RETURN_IF_NOT(left_num_dims >= 1 && right_num_dims >= 1);
 
     // special case for right_shape being 2D and left_shape > 2D by flattening left_shape to 2D
     // note that padding 1s in front of the right shape can be flattened too
-    if (left_num_dims >= 2 && right_num_dims >= 2 &&
+    // a transposed left operand can't be flattened as its matrices are no longer contiguous rows
+    if (!transa && left_num_dims >= 2 && right_num_dims >= 2 &&
         right_shape.SizeToDimension(right_num_dims - 1) == right_shape[right_num_dims - 2]) {
       M_ = left_shape.SizeToDimension(left_num_dims - 1);
       K_ = left_shape[left_num_dims - 1];
@@ -121,6 +130,12 @@ class MatMulComputeHelper {
   }
 
  private:
+  static TensorShape SwapLastTwoDims(const TensorShape& shape) {
+    std::vector<int64_t> dims = shape.GetDims();
+    std::swap(dims[dims.size() - 2], dims[dims.size() - 1]);
+    return TensorShape(dims);
+  }
+
   void ComputeBroadcastOffsets() {
     num_broadcasted_dims_ = left_padded_dims_.size() - 2;
 
@@ -236,6 +251,18 @@ class MatMulComputeHelper {
     return output_offsets_;
   }
 
+  // The matrices are stride elements apart when the offsets are the multiples of it, with a stride of 0 for an
+  // operand broadcast over the batch. false for the offsets of a broadcast over some of the batch dims only.
+  static bool GetBatchStride(const std::vector<size_t>& offsets, int64_t& stride) {
+    stride = offsets.size() > 1 ? static_cast<int64_t>(offsets[1] - offsets[0]) : 0;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      if (static_cast<int64_t>(offsets[i]) != static_cast<int64_t>(i) * stride) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   template <typename T>
   static void OffsetToArrays(T* p, const std::vector<size_t>& offsets, gsl::span<T*> arrays) {
     auto len = offsets.size();
@@ -4,6 +4,8 @@
 #include "core/providers/cpu/math/quantize_linear_matmul.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/common.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 
@@ -56,22 +58,36 @@ Status QLinearMatMul<uint8_t, uint8_t, uint8_t>::Compute(OpKernelContext* ctx) c
   auto y_scale_data = *(y_scale->template Data<float>());
 
   const float real_multiplier = (a_scale_data * b_scale_data) / y_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+
+  // The 32-bit accumulators for one matrix, requantized to the output by the GEMM.
+  const size_t gemm_output_size = static_cast<size_t>(helper.M() * helper.N());
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * gemm_output_size);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
 
   for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
-    GemmlowpMultiplyu8u8_u8(a->template Data<uint8_t>() + helper.LeftOffsets()[i],
-                            b->template Data<uint8_t>() + helper.RightOffsets()[i],
-                            y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
-                            *a_offset->template Data<uint8_t>(),
-                            *b_offset->template Data<uint8_t>(),
-                            *y_offset->template Data<uint8_t>(),
-                            static_cast<int>(helper.M()),
-                            static_cast<int>(helper.N()),
-                            static_cast<int>(helper.K()),
-                            integer_multiplier,
-                            right_shift);
+    QGemmu8u8_u8(static_cast<int>(helper.M()),
+                 static_cast<int>(helper.N()),
+                 static_cast<int>(helper.K()),
+                 a->template Data<uint8_t>() + helper.LeftOffsets()[i],
+                 static_cast<int>(helper.K()),
+                 *a_offset->template Data<uint8_t>(),
+                 b->template Data<uint8_t>() + helper.RightOffsets()[i],
+                 static_cast<int>(helper.N()),
+                 *b_offset->template Data<uint8_t>(),
+                 nullptr,
+                 gemm_output,
+                 y->template MutableData<uint8_t>() + helper.OutputOffsets()[i],
+                 static_cast<int>(helper.N()),
+                 real_multiplier,
+                 *y_offset->template Data<uint8_t>(),
+                 thread_pool);
   }
 
   return Status::OK();
@@ -19,9 +19,13 @@
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
-#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 using namespace std;
 namespace onnxruntime {
 
@@ -44,16 +48,66 @@ static int64_t SizeFromDim(size_t k, const vector<int64_t>& dims) {
   return r;
 }
 
-template <typename T>
-struct ValueCmp {
-  bool operator()(
-      const pair<T, int64_t>& lhs,
-      const pair<T, int64_t>& rhs) {
-    return (
-        lhs.first > rhs.first ||
-        (lhs.first == rhs.first && lhs.second < rhs.second));
+// Orders (value, index) pairs the way they are written to the outputs: by descending value and then by
+// ascending index. NaN is placed after every number so that this is a strict weak ordering.
+static inline bool ComesBefore(float lhs_value, int64_t lhs_index, float rhs_value, int64_t rhs_index) {
+  if (lhs_value > rhs_value) return true;
+  if (lhs_value < rhs_value) return false;
+  const bool lhs_nan = std::isnan(lhs_value);
+  const bool rhs_nan = std::isnan(rhs_value);
+  if (lhs_nan != rhs_nan) return rhs_nan;
+  return lhs_index < rhs_index;
+}
+
+// Largest k that is selected by insertion into a small sorted buffer. Beyond it, the indices are
+// partitioned with nth_element and only the selected ones are sorted.
+static constexpr unsigned kSmallTopK = 16;
+
+// Selects the k largest of the n values read with the given stride into sorted values and indices.
+// Most values fail the comparison against the last entry, so this approaches one compare per value.
+static void SelectTopKSmall(const float* input, int64_t stride, int64_t n, unsigned k,
+                            float* top_values, int64_t* top_indices) {
+  unsigned count = 0;
+  for (int64_t l = 0; l < n; ++l) {
+    const float value = input[l * stride];
+    if (count == k && !ComesBefore(value, l, top_values[k - 1], top_indices[k - 1])) {
+      continue;
+    }
+    unsigned pos = count < k ? count++ : k - 1;
+    while (pos > 0 && ComesBefore(value, l, top_values[pos - 1], top_indices[pos - 1])) {
+      top_values[pos] = top_values[pos - 1];
+      top_indices[pos] = top_indices[pos - 1];
+      --pos;
+    }
+    top_values[pos] = value;
+    top_indices[pos] = l;
+  }
+}
+
+// Selects the k largest of the n contiguous values into sorted values and indices.
+static void SelectTopKLarge(const float* input, int64_t n, unsigned k, std::vector<int64_t>& order,
+                            float* top_values, int64_t* top_indices) {
+  order.resize(n);
+  std::iota(order.begin(), order.end(), int64_t{0});
+  auto cmp = [input](int64_t lhs, int64_t rhs) { return ComesBefore(input[lhs], lhs, input[rhs], rhs); };
+  if (static_cast<int64_t>(k) < n) {
+    std::nth_element(order.begin(), order.begin() + k, order.end(), cmp);
+  }
+  std::sort(order.begin(), order.begin() + k, cmp);
+  for (unsigned l = 0; l < k; ++l) {
+    top_values[l] = input[order[l]];
+    top_indices[l] = order[l];
+  }
+}
+
+void SelectTopK(const float* input, int64_t n, unsigned k, std::vector<int64_t>& scratch,
+                float* top_values, int64_t* top_indices) {
+  if (k <= kSmallTopK) {
+    SelectTopKSmall(input, 1, n, k, top_values, top_indices);
+  } else {
+    SelectTopKLarge(input, n, k, scratch, top_values, top_indices);
   }
-};
+}
 
 // Core TopK implementation
 Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int axis, const unsigned k) {
@@ -78,10 +132,7 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
 
   const int64_t rows = SizeToDim(axis_parsed, in_dims);
   const int64_t cols = X->Shape().Size() / rows;
-  auto input_map = ConstEigenMatrixMapRowMajor<float>(
-      static_cast<const float*>(X->template Data<float>()),
-      rows,
-      cols);
+  const float* input_data = X->template Data<float>();
 
   // Resize output tensors to be the same shape as the input except
   // for the specified dimension ((i.e.) axis_parsed), which will be of size k. E.x. for an input tensor
@@ -91,45 +142,55 @@ Status TopKImpl(OpKernelContext* p_op_kernel_context, const Tensor* X, const int
   auto* Values = p_op_kernel_context->Output(0, output_linear_shape);
   auto* Indices = p_op_kernel_context->Output(1, output_linear_shape);
 
-  // Use Eigen maps to allow indexing into the 2d tensors like Values_map(i,j)
+  float* values_data = Values->template MutableData<float>();
+  int64_t* indices_data = Indices->template MutableData<int64_t>();
+
   const int64_t reduced_cols = SizeFromDim(axis_parsed, output_linear_shape);
-  auto Values_map = EigenMatrixMapRowMajor<float>(
-      Values->template MutableData<float>(), rows, reduced_cols);
-  auto Indices_map = EigenMatrixMapRowMajor<int64_t>(
-      Indices->template MutableData<int64_t>(), rows, reduced_cols);
+  const int64_t axis_dim = in_dims[axis_parsed];
 
   // This is basically the number of elements within each of the "k" rows
   const int64_t block_slice = reduced_cols / k;
-  // Sort preserving Indices
-  for (int64_t i = 0; i < rows; ++i) {
-    for (int64_t j = 0; j < block_slice; ++j) {
-      // Build a min-heap, the heap element is pair of (value, idx)
-      // the top of the heap is the smallest value
-      priority_queue<
-          pair<float, int64_t>,
-          vector<pair<float, int64_t>>,
-          ValueCmp<float>>
-          min_heap;
-      // Maintain the size of heap to be less or equal to k_, so the
-      // heap will hold the k largest Values
-      for (int64_t l = 0; l < in_dims[axis_parsed]; ++l) {
-        const auto value = input_map(i, l * block_slice + j);
-        if (min_heap.size() < k || value > min_heap.top().first) {
-          min_heap.push({value, l});
-        }
-        if (min_heap.size() > k) {
-          min_heap.pop();
+
+  // Each (row, slice) pair selects independently, so the pairs are split across the thread pool.
+  auto select_range = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<float> top_values(k);
+    std::vector<int64_t> top_indices(k);
+    std::vector<float> gathered;
+    std::vector<int64_t> order;
+
+    for (std::ptrdiff_t n = first; n < last; ++n) {
+      const int64_t i = n / block_slice;
+      const int64_t j = n % block_slice;
+      const float* input = input_data + i * cols + j;
+
+      if (k <= kSmallTopK) {
+        SelectTopKSmall(input, block_slice, axis_dim, k, top_values.data(), top_indices.data());
+      } else {
+        if (block_slice != 1) {
+          gathered.resize(axis_dim);
+          for (int64_t l = 0; l < axis_dim; ++l) {
+            gathered[l] = input[l * block_slice];
+          }
+          input = gathered.data();
         }
+        SelectTopKLarge(input, axis_dim, k, order, top_values.data(), top_indices.data());
       }
-      // Extract these k elements and place them in the results placeholder
-      for (int64_t l = 0; l < k; ++l) {
-        auto& pqElem = min_heap.top();
-        auto col_index = (k - l - 1) * block_slice + j;
-        Values_map(i, col_index) = pqElem.first;
-        Indices_map(i, col_index) = pqElem.second;
-        min_heap.pop();
+
+      // Place the k elements in the results placeholder
+      for (unsigned l = 0; l < k; ++l) {
+        const int64_t col_index = i * reduced_cols + l * block_slice + j;
+        values_data[col_index] = top_values[l];
+        indices_data[col_index] = top_indices[l];
       }
     }
+  };
+
+  const std::ptrdiff_t total = rows * block_slice;
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    select_range(0, total);
+  } else {
+    tp->ParallelFor(total, static_cast<double>(axis_dim), select_range);
   }
 
   return Status::OK();
@@ -3,9 +3,16 @@
 
 #pragma once
 
+#include <vector>
+
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
+// Selects the k largest of the n contiguous values into top_values and top_indices, ordered by descending value
+// and then ascending index, as TopK outputs them. k must not exceed n. scratch is reused across calls for a large k.
+void SelectTopK(const float* input, int64_t n, unsigned k, std::vector<int64_t>& scratch,
+                float* top_values, int64_t* top_indices);
+
 template <int OpSet, typename T>
 class TopK final : public OpKernel {
  public:
@@ -2,8 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/category_mapper.h"
-#include <algorithm>
-#include <gsl/span>
+#include "core/framework/op_kernel_context_internal.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -25,43 +24,23 @@ Status CategoryMapper::Compute(OpKernelContext* context) const {
   if (tensor_pointer == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
   const Tensor& X = *tensor_pointer;
   const TensorShape& shape = X.Shape();
-  Tensor& Y = *context->Output(0, TensorShape(shape));
+  Tensor& Y = *context->Output(0, shape);
 
   auto input_type = X.DataType();
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
   if (input_type == DataTypeImpl::GetType<std::string>()) {
     if (Y.DataType() != DataTypeImpl::GetType<int64_t>())
       return Status(ONNXRUNTIME, FAIL, "Input of string must have output of int64");
 
-    auto input = gsl::make_span(X.template Data<std::string>(), shape.Size());
-    auto output = gsl::make_span(Y.template MutableData<int64_t>(), shape.Size());
-    auto out = output.begin();
-
-    // map isn't going to change so get end() once instead of calling inside the for_each loop
-    const auto map_end = string_to_int_map_.end();
-
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const std::string& value) {
-                    auto map_to = string_to_int_map_.find(value);
-                    *out = map_to == map_end ? default_int_ : map_to->second;
-                    ++out;
-                  });
+    string_to_int_map_.Lookup(X.template Data<std::string>(), Y.template MutableData<int64_t>(), shape.Size(),
+                              default_int_, tp);
   } else {
     if (Y.DataType() != DataTypeImpl::GetType<std::string>())
       return Status(ONNXRUNTIME, FAIL, "Input of int64 must have output of string ");
 
-    auto input = gsl::make_span(X.template Data<int64_t>(), shape.Size());
-    auto output = gsl::make_span(Y.template MutableData<std::string>(), shape.Size());
-    auto out = output.begin();
-
-    const auto map_end = int_to_string_map_.end();
-
-    std::for_each(input.cbegin(), input.cend(),
-                  [&out, &map_end, this](const int64_t& value) {
-                    auto map_to = int_to_string_map_.find(value);
-                    *out = map_to == map_end ? default_string_ : map_to->second;
-                    ++out;
-                  });
+    int_to_string_map_.Lookup(X.template Data<int64_t>(), Y.template MutableData<std::string>(), shape.Size(),
+                              default_string_, tp);
   }
 
   return Status::OK();
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <vector>
 #include "core/common/common.h"
@@ -16,24 +18,54 @@ class DictVectorizerOp final : public OpKernel {
     //In some stupid models, the vocabulary could have duplicated elements.
     //We must support that, otherwise some tests will be break.
     ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary_).IsOK());
+
+    sorted_vocabulary_indices_.resize(vocabulary_.size());
+    std::iota(sorted_vocabulary_indices_.begin(), sorted_vocabulary_indices_.end(), size_t{0});
+    std::stable_sort(sorted_vocabulary_indices_.begin(), sorted_vocabulary_indices_.end(),
+                     [this](size_t a, size_t b) { return vocabulary_[a] < vocabulary_[b]; });
   }
   common::Status Compute(OpKernelContext* ctx) const override {
     auto map = ctx->Input<std::map<AttrType, TargetType> >(0);
     auto Y = ctx->Output(0, TensorShape({1, static_cast<int64_t>(vocabulary_.size())}));
     auto* y_data = Y->template MutableData<TargetType>();
-    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
-      auto index = map->find(vocabulary_[i]);
-      if (index != map->end()) {
-        *y_data++ = index->second;
-      } else {
-        //Any keys not present in the input dictionary, will be zero in the output array
-        *y_data++ = TargetType();
+
+    //Any keys not present in the input dictionary, will be zero in the output array
+    std::fill_n(y_data, vocabulary_.size(), TargetType());
+
+    if (map->size() <= kMergeMapSizeFactor * vocabulary_.size()) {
+      // Walk the map and the sorted vocabulary together instead of looking up every word.
+      auto index = map->begin();
+      for (size_t i : sorted_vocabulary_indices_) {
+        const auto& word = vocabulary_[i];
+        while (index != map->end() && index->first < word) {
+          ++index;
+        }
+        if (index == map->end()) {
+          break;
+        }
+        if (!(word < index->first)) {
+          y_data[i] = index->second;
+        }
+      }
+    } else {
+      for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
+        auto index = map->find(vocabulary_[i]);
+        if (index != map->end()) {
+          y_data[i] = index->second;
+        }
       }
     }
     return Status::OK();
   }
 
   std::vector<AttrType> vocabulary_;
+
+ private:
+  // Maps much larger than the vocabulary are cheaper to search than to walk.
+  static constexpr size_t kMergeMapSizeFactor = 8;
+
+  // The indices of the vocabulary in key order.
+  std::vector<size_t> sorted_vocabulary_indices_;
 };
 
 }  // namespace ml
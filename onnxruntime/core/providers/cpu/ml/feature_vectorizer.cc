@@ -3,7 +3,10 @@
 
 #include "core/providers/cpu/ml/feature_vectorizer.h"
 
-#include <gsl/span>
+#include <type_traits>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -19,13 +22,8 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
     FeatureVectorizer);
 
 template <typename T>
-static void VectorizeTensor(const Tensor& input_tensor, int64_t feature_size, int64_t sum_input_dimensions,
-                            typename gsl::span<float>::iterator out_iter);
-
-template <typename T>
-static void CopyWithCast(typename gsl::span<const T>::const_iterator begin,
-                         typename gsl::span<const T>::const_iterator end,
-                         gsl::span<float>::iterator out_iter);
+static void VectorizeTensor(concurrency::ThreadPool* tp, const Tensor& input_tensor, int64_t feature_size,
+                            int64_t sum_input_dimensions, int64_t N, float* out);
 
 Status FeatureVectorizer::Compute(OpKernelContext* context) const {
   int input_count = context->NumVariadicInputs(0);
@@ -40,14 +38,9 @@ Status FeatureVectorizer::Compute(OpKernelContext* context) const {
   // assumes all inputs have the same batch size
   int64_t N = X.Shape().NumDimensions() == 1 ? 1 : x_dims[0];
 
-  // initialize all the output to 0.f
   Tensor* Y = context->Output(0, TensorShape({N, total_dimensions_}));
   auto Y_data = Y->template MutableData<float>();
-
-  auto out = gsl::make_span(Y_data, Y->Shape().Size());
-
-  // init all to 0.f so we don't need to do that each loop if we have to add padding
-  std::fill_n(out.data(), out.size(), 0.f);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
   int64_t feature_offset = 0;
 
@@ -60,17 +53,16 @@ Status FeatureVectorizer::Compute(OpKernelContext* context) const {
     auto feature_size = input_dimensions_[index];
 
     auto data_type = input_tensor.DataType();
-    auto cur_out = out.begin() + feature_offset;
+    auto cur_out = Y_data + feature_offset;
 
     if (data_type == DataTypeImpl::GetType<float>()) {
-      // straight copy for float to float
-      VectorizeTensor<float>(input_tensor, feature_size, total_dimensions_, cur_out);
+      VectorizeTensor<float>(tp, input_tensor, feature_size, total_dimensions_, N, cur_out);
     } else if (data_type == DataTypeImpl::GetType<int32_t>()) {
-      VectorizeTensor<int32_t>(input_tensor, feature_size, total_dimensions_, cur_out);
+      VectorizeTensor<int32_t>(tp, input_tensor, feature_size, total_dimensions_, N, cur_out);
     } else if (data_type == DataTypeImpl::GetType<int64_t>()) {
-      VectorizeTensor<int64_t>(input_tensor, feature_size, total_dimensions_, cur_out);
+      VectorizeTensor<int64_t>(tp, input_tensor, feature_size, total_dimensions_, N, cur_out);
     } else if (data_type == DataTypeImpl::GetType<double>()) {
-      VectorizeTensor<double>(input_tensor, feature_size, total_dimensions_, cur_out);
+      VectorizeTensor<double>(tp, input_tensor, feature_size, total_dimensions_, N, cur_out);
     } else {
       // should never happen. graph validation should have failed
       ORT_THROW("Invalid input type:", data_type);
@@ -83,47 +75,38 @@ Status FeatureVectorizer::Compute(OpKernelContext* context) const {
   return Status::OK();
 }  // namespace ml
 
+// Writes the feature_size columns of a feature, which start at out, in each of the N rows of sum_input_dimensions
+// columns of the output.
 template <typename T>
-static void VectorizeTensor(const Tensor& input_tensor, int64_t feature_size, int64_t sum_input_dimensions,
-                            typename gsl::span<float>::iterator out_iter) {
+static void VectorizeTensor(concurrency::ThreadPool* tp, const Tensor& input_tensor, int64_t feature_size,
+                            int64_t sum_input_dimensions, int64_t N, float* out) {
   auto& shape = input_tensor.Shape();
   auto& input_dims = shape.GetDims();
 
   auto input_size = input_dims.size() == 1 ? input_dims[0] : input_tensor.Shape().SizeFromDimension(1);
-  auto N = input_dims.size() == 1 ? 1 : input_dims[0];
+  auto input_rows = std::min<int64_t>(N, input_dims.size() == 1 ? 1 : input_dims[0]);
 
   // if there's extra data, ignore it
-  auto stride = input_size;
-  if (input_size > feature_size) {
-    stride = feature_size;
-  }
+  auto stride = std::min(input_size, feature_size);
 
   auto data = input_tensor.template Data<T>();
-  auto input = gsl::make_span(data, shape.Size());
-  auto input_iter = input.cbegin();
-
-  for (int i = 0; i < N;) {
-    // copy each row to the output. iters are passed by value
-    CopyWithCast<T>(input_iter, input_iter + stride, out_iter);
-
-    // skip to start of next input row, and start of next output
-    // if we have more input. otherwise we go past then end of the input and the bounds checking errors out
-    if (++i < N) {
-      input_iter += input_size;
-      out_iter += sum_input_dimensions;
+  if (std::is_same<T, float>::value) {
+    // straight copy for float to float, with a memcpy per row
+    StridedCopy(tp, DataTypeImpl::GetType<float>(), out, {sum_input_dimensions, 1}, data, {input_size, 1},
+                {input_rows, stride});
+  } else {
+    for (int64_t i = 0; i < input_rows; ++i) {
+      const T* row = data + i * input_size;
+      std::transform(row, row + stride, out + i * sum_input_dimensions,
+                     [](T value) { return static_cast<float>(value); });
     }
   }
-}
 
-template <typename T>
-static void CopyWithCast(typename gsl::span<const T>::const_iterator begin,
-                         typename gsl::span<const T>::const_iterator end,
-                         gsl::span<float>::iterator out_iter) {
-  std::for_each(begin, end,
-                [&out_iter](const typename gsl::span<T>::const_iterator::reference value) {
-                  *out_iter = static_cast<float>(value);
-                  ++out_iter;
-                });
+  // pad the columns the input doesn't have with 0.f, and all the columns of the rows of a shorter batch
+  for (int64_t i = 0; i < N; ++i) {
+    float* row = out + i * sum_input_dimensions;
+    std::fill(row + (i < input_rows ? stride : 0), row + feature_size, 0.f);
+  }
 }
 
 }  // namespace ml
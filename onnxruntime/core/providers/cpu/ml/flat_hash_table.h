@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {
+
+namespace flat_hash_detail {
+
+// Final mix of MurmurHash3, so that small and sequential integer keys use all the bits of the hash.
+inline uint64_t Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+inline uint64_t Hash(int64_t key) { return Mix(static_cast<uint64_t>(key)); }
+
+inline uint64_t Hash(float key) {
+  // -0.0f and 0.0f compare equal, so they must hash the same
+  uint32_t bits = 0;
+  if (key != 0.0f) {
+    memcpy(&bits, &key, sizeof(bits));
+  }
+  return Mix(bits);
+}
+
+inline uint64_t Hash(const std::string& key) { return Mix(static_cast<uint64_t>(std::hash<std::string>()(key))); }
+
+}  // namespace flat_hash_detail
+
+// Hash table from keys to values for the lookup tables of the ML encoders. It is filled when the kernel is
+// created and only read afterwards, so lookups may run concurrently.
+//
+// The keys and values are stored densely in insertion order. The slots are open addressed with linear
+// probing and hold the index of their entry along with the upper bits of its hash, so a probe reads one
+// small contiguous array and only compares keys whose hashes match. The table is kept at most half full.
+template <typename TKey, typename TValue>
+class FlatHashTable {
+ public:
+  void Reserve(size_t count) {
+    size_t capacity = kMinCapacity;
+    while (capacity < count * 2) {
+      capacity *= 2;
+    }
+    if (capacity > slots_.size()) {
+      Rehash(capacity);
+    }
+  }
+
+  // Maps key to value. As with std::unordered_map::operator[], the value of an existing equal key is replaced.
+  void Insert(const TKey& key, const TValue& value) {
+    if ((keys_.size() + 1) * 2 > slots_.size()) {
+      Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+    }
+
+    const uint64_t hash = flat_hash_detail::Hash(key);
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t index = static_cast<size_t>(hash) & mask_;; index = (index + 1) & mask_) {
+      Slot& slot = slots_[index];
+      if (slot.entry == 0) {
+        ORT_ENFORCE(keys_.size() < UINT32_MAX, "Too many keys in the lookup table.");
+        keys_.push_back(key);
+        values_.push_back(value);
+        hashes_.push_back(hash);
+        slot.tag = tag;
+        slot.entry = static_cast<uint32_t>(keys_.size());
+        return;
+      }
+      if (slot.tag == tag && keys_[slot.entry - 1] == key) {
+        values_[slot.entry - 1] = value;
+        return;
+      }
+    }
+  }
+
+  // Returns the value mapped to key, or nullptr when there is none.
+  const TValue* Find(const TKey& key) const {
+    if (keys_.empty()) {
+      return nullptr;
+    }
+
+    const uint64_t hash = flat_hash_detail::Hash(key);
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t index = static_cast<size_t>(hash) & mask_;; index = (index + 1) & mask_) {
+      const Slot& slot = slots_[index];
+      if (slot.entry == 0) {
+        return nullptr;
+      }
+      if (slot.tag == tag && keys_[slot.entry - 1] == key) {
+        return &values_[slot.entry - 1];
+      }
+    }
+  }
+
+  size_t Size() const { return keys_.size(); }
+
+  // Maps input[i] to output[i] for count elements, using default_value for the keys that aren't in the table.
+  // The elements are split over the thread pool when there is one.
+  void Lookup(const TKey* input, TValue* output, int64_t count, const TValue& default_value,
+              concurrency::ThreadPool* tp) const {
+    auto lookup = [this, input, output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        const TValue* value = Find(input[i]);
+        output[i] = value != nullptr ? *value : default_value;
+      }
+    };
+
+    if (tp == nullptr) {
+      lookup(0, static_cast<std::ptrdiff_t>(count));
+    } else {
+      tp->ParallelFor(static_cast<std::ptrdiff_t>(count), kLookupCost, lookup);
+    }
+  }
+
+ private:
+  // Approximate cost, in cycles, of hashing a key and probing the table for it.
+  static constexpr double kLookupCost = 64.0;
+
+  static constexpr size_t kMinCapacity = 16;
+
+  struct Slot {
+    uint32_t tag;    // upper bits of the hash of the key
+    uint32_t entry;  // index of the key plus one, or zero for an empty slot
+  };
+
+  void Rehash(size_t capacity) {
+    slots_.assign(capacity, Slot{0, 0});
+    mask_ = capacity - 1;
+    for (size_t entry = 0; entry < keys_.size(); ++entry) {
+      size_t index = static_cast<size_t>(hashes_[entry]) & mask_;
+      while (slots_[index].entry != 0) {
+        index = (index + 1) & mask_;
+      }
+      slots_[index].tag = static_cast<uint32_t>(hashes_[entry] >> 32);
+      slots_[index].entry = static_cast<uint32_t>(entry + 1);
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_{0};
+
+  std::vector<TKey> keys_;
+  std::vector<TValue> values_;
+  std::vector<uint64_t> hashes_;
+};
+
+template <typename TKey, typename TValue>
+constexpr double FlatHashTable<TKey, TValue>::kLookupCost;
+
+template <typename TKey, typename TValue>
+constexpr size_t FlatHashTable<TKey, TValue>::kMinCapacity;
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/linearclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -73,26 +75,34 @@ Status LinearClassifier<T>::Compute(OpKernelContext* ctx) const {
   }
   Tensor* Z = ctx->Output(1, TensorShape({N, output_classes}));
 
+  if (N == 0) {
+    return Status::OK();
+  }
+
   int64_t zindex = 0;
   const auto* x_data = X->template Data<T>();
 
+  // Score the whole batch against the coefficients of every class with a
+  // single GEMM.
+  std::vector<float> x_buffer;
+  const float* x_float = float_input_data(x_data, N * stride, x_buffer);
+  std::vector<float> batch_scores(N * class_count_);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  math::Gemm<float, concurrency::ThreadPool>(CblasNoTrans, CblasTrans, N, class_count_, stride,
+                                             1.f, x_float, coefficients_.data(), 0.f, batch_scores.data(), tp);
+
   auto class_count = static_cast<size_t>(class_count_);
   std::vector<float> scores;
   scores.reserve(class_count);
   for (int64_t i = 0; i < N; i++)  //for each point
   {
     scores.clear();
-    size_t current_weight_0 = i * stride;
+    const float* point_scores = batch_scores.data() + i * class_count_;
     int maxclass = -1;
     float maxweight = 0.f;
     for (int j = 0; j < class_count_; j++)  // for each class
     {
-      size_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight += static_cast<float>(x_data[current_weight_0 + k] * coefficients_[current_coeff_0 + k]);
-      }
+      float weight = point_scores[j];
       if (intercepts_.size() == class_count) {
         weight += intercepts_[j];
       }
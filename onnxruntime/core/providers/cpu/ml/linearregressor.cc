@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/linearregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -31,27 +33,31 @@ Status LinearRegressor<float>::Compute(OpKernelContext* ctx) const {
   int64_t stride = X->Shape().NumDimensions() == 1 ? X->Shape()[0] : X->Shape()[1];
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
   Tensor* Y = ctx->Output(0, TensorShape({N, targets_}));
+  if (N == 0) {
+    return Status::OK();
+  }
   const auto* Xdata = X->template Data<float>();
   int64_t yindex = 0;
 
+  // Compute the targets of the whole batch with a single GEMM, which starts
+  // from the intercepts when there are any.
+  std::vector<float> batch_scores(N * targets_);
   bool useIntercepts = intercepts_.size() == static_cast<size_t>(targets_);
+  if (useIntercepts) {
+    for (int64_t i = 0; i < N; i++) {
+      std::copy(intercepts_.begin(), intercepts_.end(), batch_scores.begin() + i * targets_);
+    }
+  }
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  math::Gemm<float, concurrency::ThreadPool>(CblasNoTrans, CblasTrans, N, targets_, stride,
+                                             1.f, Xdata, coefficients_.data(), useIntercepts ? 1.f : 0.f,
+                                             batch_scores.data(), tp);
+
+  std::vector<float> scores;
+  scores.reserve(targets_);
   for (int64_t i = 0; i < N; i++)  //for each point
   {
-    std::vector<float> scores;
-    int64_t current_weight_0 = i * stride;
-    for (int j = 0; j < targets_; j++)  //for each target
-    {
-      int64_t current_coeff_0 = j * stride;
-      float weight = 0.f;
-      for (int64_t k = 0; k < stride; k++)  //for each weight
-      {
-        weight = weight + Xdata[current_weight_0 + k] * coefficients_[current_coeff_0 + k];
-      }
-      if (useIntercepts) {
-        weight = weight + intercepts_[j];
-      }
-      scores.push_back(weight);
-    }
+    scores.assign(batch_scores.begin() + i * targets_, batch_scores.begin() + (i + 1) * targets_);
     ::onnxruntime::ml::write_scores(scores, post_transform_, yindex, Y, -1);
     yindex += scores.size();
   }
@@ -358,5 +358,17 @@ void write_scores(std::vector<T>& scores, POST_EVAL_TRANSFORM post_transform, in
   memcpy(out_p, scores.data(), len);
 }
 
+// The batch as float for the GEMM based kernels, converted into buffer unless T is float.
+template <typename T>
+inline const float* float_input_data(const T* data, int64_t size, std::vector<float>& buffer) {
+  buffer.assign(data, data + size);
+  return buffer.data();
+}
+
+template <>
+inline const float* float_input_data<float>(const float* data, int64_t /*size*/, std::vector<float>& /*buffer*/) {
+  return data;
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -63,6 +64,9 @@ SVMClassifier<T>::SVMClassifier(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  if (get_kernel_type() == KERNEL::RBF) {
+    support_vector_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
   ORT_ENFORCE(classlabels_strings_.size() > 0 || classlabels_ints_.size() > 0);
   ORT_ENFORCE(proba_.size() == probb_.size());
   ORT_ENFORCE(coefficients_.size() > 0);
@@ -121,35 +125,41 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
   std::vector<int64_t> dims{N, nb_columns};
   Tensor* Z = ctx->Output(1, TensorShape(dims));
 
+  if (N == 0) {
+    return Status::OK();
+  }
+
+  const bool linear = vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR;
+  if (!linear && vector_count_ == 0)
+    return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
+
+  // Evaluate the kernels of the whole batch with the support vectors, or the
+  // liblinear scores, with a single GEMM.
   const T* x_data = X->template Data<T>();
+  std::vector<float> x_buffer;
+  const float* x_float = float_input_data(x_data, N * stride, x_buffer);
+  const int64_t kernel_count = linear ? class_count_ : vector_count_;
+  std::vector<float> batch_kernels(N * kernel_count);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  batch_kernel_dot(x_float, stride, N, linear ? coefficients_ : support_vectors_, kernel_count, feature_count_,
+                   get_kernel_type(), support_vector_norms_, batch_kernels.data(), tp);
+
   int64_t zindex = 0;
 
   for (int64_t n = 0; n < N; n++)  //for each example
   {
-    int64_t current_weight_0 = n * stride;
     int64_t maxclass = -1;
-    std::vector<float> decisions;
     std::vector<float> scores;
-    std::vector<float> kernels;
     std::vector<int64_t> votes;
+    const float* kernels = batch_kernels.data() + n * kernel_count;
 
-    if (vector_count_ == 0 && mode_ == SVM_TYPE::SVM_LINEAR) {
+    if (linear) {
       for (int64_t j = 0; j < class_count_; j++) {  //for each class
-        auto val = kernel_dot(x_data, current_weight_0, coefficients_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        val += rho_[0];
-        scores.push_back(val);
+        scores.push_back(kernels[j] + rho_[0]);
       }
     } else {
-      if (vector_count_ == 0)
-        return Status(common::ONNXRUNTIME, common::FAIL, "No support vectors.");
       int evals = 0;
 
-      for (int64_t j = 0; j < vector_count_; j++) {
-        auto val = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j,
-                              feature_count_, get_kernel_type());
-        kernels.push_back(val);
-      }
       votes.resize(class_count_, 0);
       for (int64_t i = 0; i < class_count_; i++) {        // for each class
         for (int64_t j = i + 1; j < class_count_; j++) {  // for each class
@@ -163,12 +173,12 @@ Status SVMClassifier<T>::Compute(OpKernelContext* ctx) const {
           int64_t pos1 = (vector_count_) * (j - 1);
           int64_t pos2 = (vector_count_) * (i);
           const float* val1 = &(coefficients_[pos1 + start_index_i]);
-          const float* val2 = &(kernels[start_index_i]);
+          const float* val2 = kernels + start_index_i;
           for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
             sum += *val1 * *val2;
 
           val1 = &(coefficients_[pos2 + start_index_j]);
-          val2 = &(kernels[start_index_j]);
+          val2 = kernels + start_index_j;
           for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
             sum += *val1 * *val2;
 
@@ -5,7 +5,9 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/mlas/inc/mlas.h"
 #include "ml_common.h"
 
 namespace onnxruntime {
@@ -29,31 +31,51 @@ class SVMCommon {
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
-  float kernel_dot(const T* A, int64_t a, const std::vector<float>& B, int64_t b, int64_t len, KERNEL k) const {
-    double sum = 0;
-    const T* pA = A + a;
-    const float* pB = B.data() + b;
+  // Squared norms of the count rows of len values of B, which the RBF kernel of batch_kernel_dot requires.
+  static std::vector<float> squared_norms(const std::vector<float>& B, int64_t count, int64_t len) {
+    std::vector<float> norms(count);
+    const float* pB = B.data();
+    for (int64_t i = 0; i < count; i++) {
+      float sum = 0.f;
+      for (int64_t j = 0; j < len; ++j, ++pB)
+        sum += *pB * *pB;
+      norms[i] = sum;
+    }
+    return norms;
+  }
+
+  // The kernel of each of the N rows of A, lda values apart, with each of the count rows of B, as the N x count
+  // matrix out. A single GEMM computes the dot products, which are then transformed for the kernel type. The RBF
+  // kernel expands |a - b|^2 as |a|^2 + |b|^2 - 2 a.b, with B_norms from squared_norms.
+  void batch_kernel_dot(const float* A, int64_t lda, int64_t N, const std::vector<float>& B, int64_t count,
+                        int64_t len, KERNEL k, const std::vector<float>& B_norms, float* out,
+                        concurrency::ThreadPool* tp) const {
+    const float alpha = k == KERNEL::RBF ? -2.f : 1.f;
+    math::GemmEx<float, concurrency::ThreadPool>(CblasNoTrans, CblasTrans,
+                                                 static_cast<int>(N), static_cast<int>(count), static_cast<int>(len),
+                                                 alpha, A, static_cast<int>(lda), B.data(), static_cast<int>(len),
+                                                 0.f, out, static_cast<int>(count), tp);
+
+    const size_t size = static_cast<size_t>(N * count);
     if (k == KERNEL::POLY) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::pow(sum, degree_);
+      for (size_t i = 0; i < size; i++)
+        out[i] = static_cast<float>(std::pow(gamma_ * out[i] + coef0_, degree_));
     } else if (k == KERNEL::SIGMOID) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
-      sum = gamma_ * sum + coef0_;
-      sum = std::tanh(sum);
+      for (size_t i = 0; i < size; i++)
+        out[i] = gamma_ * out[i] + coef0_;
+      MlasComputeTanh(out, out, size);
     } else if (k == KERNEL::RBF) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB) {
-        double val = *pA - *pB;
-        sum += val * val;
+      for (int64_t n = 0; n < N; n++) {
+        const float* pA = A + n * lda;
+        float A_norm = 0.f;
+        for (int64_t j = 0; j < len; j++)
+          A_norm += pA[j] * pA[j];
+        float* row = out + n * count;
+        for (int64_t j = 0; j < count; j++)
+          row[j] = -gamma_ * std::max(0.f, row[j] + A_norm + B_norms[j]);
       }
-      sum = std::exp(-gamma_ * sum);
-    } else if (k == KERNEL::LINEAR) {
-      for (int64_t i = len; i > 0; --i, ++pA, ++pB)
-        sum += *pA * *pB;
+      MlasComputeExp(out, out, size);
     }
-    return (float)sum;
   }
 
  private:
@@ -65,7 +87,8 @@ class SVMCommon {
 
 template <typename T>
 class SVMClassifier final : public OpKernel, private SVMCommon<T> {
-  using SVMCommon<T>::kernel_dot;
+  using SVMCommon<T>::squared_norms;
+  using SVMCommon<T>::batch_kernel_dot;
   using SVMCommon<T>::set_kernel_type;
   using SVMCommon<T>::get_kernel_type;
 
@@ -86,6 +109,7 @@ class SVMClassifier final : public OpKernel, private SVMCommon<T> {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  std::vector<float> support_vector_norms_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/svmregressor.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -34,6 +35,9 @@ SVMRegressor<T>::SVMRegressor(const OpKernelInfo& info)
     mode_ = SVM_TYPE::SVM_LINEAR;
     set_kernel_type(KERNEL::LINEAR);
   }
+  if (get_kernel_type() == KERNEL::RBF) {
+    support_vector_norms_ = squared_norms(support_vectors_, vector_count_, feature_count_);
+  }
 }
 
 template <typename T>
@@ -44,31 +48,41 @@ Status SVMRegressor<T>::Compute(OpKernelContext* ctx) const {
   int64_t N = X->Shape().NumDimensions() == 1 ? 1 : X->Shape()[0];
 
   Tensor* Y = ctx->Output(0, TensorShape({N, 1}));  // this op outputs for one target only
+  if (N == 0) {
+    return Status::OK();
+  }
+
+  // Evaluate the kernels of the whole batch with the support vectors, or the
+  // liblinear scores, with a single GEMM.
   const auto* x_data = X->template Data<T>();
+  std::vector<float> x_buffer;
+  const float* x_float = float_input_data(x_data, N * stride, x_buffer);
+  const bool svc = mode_ == SVM_TYPE::SVM_SVC;
+  const int64_t kernel_count = svc ? vector_count_ : 1;
+  std::vector<float> batch_kernels(N * kernel_count);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  batch_kernel_dot(x_float, stride, N, svc ? support_vectors_ : coefficients_, kernel_count, feature_count_,
+                   get_kernel_type(), support_vector_norms_, batch_kernels.data(), tp);
 
+  auto* y_data = Y->template MutableData<float>();
   for (int64_t n = 0; n < N; n++) {  //for each example
-    int64_t current_weight_0 = n * stride;
-    std::vector<float> scores;
+    const float* kernels = batch_kernels.data() + n * kernel_count;
 
     float sum = 0.f;
-    if (mode_ == SVM_TYPE::SVM_SVC) {
+    if (svc) {
       for (int64_t j = 0; j < vector_count_; j++) {
-        float val1 = kernel_dot(x_data, current_weight_0, support_vectors_, feature_count_ * j, feature_count_, get_kernel_type());
-        float val2 = coefficients_[j];
-        float val3 = val1 * val2;
-        sum += val3;
+        sum += kernels[j] * coefficients_[j];
       }
-      sum += rho_[0];
-    } else if (mode_ == SVM_TYPE::SVM_LINEAR) {  //liblinear
-      sum = kernel_dot(x_data, current_weight_0, coefficients_, 0, feature_count_, get_kernel_type());
-      sum += rho_[0];
+    } else {  //liblinear
+      sum = kernels[0];
     }
+    sum += rho_[0];
     if (one_class_ && sum > 0) {
-      Y->template MutableData<float>()[n] = 1.f;
+      y_data[n] = 1.f;
     } else if (one_class_) {
-      Y->template MutableData<float>()[n] = -1.f;
+      y_data[n] = -1.f;
     } else {
-      Y->template MutableData<float>()[n] = sum;
+      y_data[n] = sum;
     }
   }
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/tree_ensemble_classifier.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
@@ -214,32 +215,9 @@ void TreeEnsembleClassifier<T>::Initialize() {
     nodes_modes_.push_back(MakeTreeNodeMode(nodes_modes_names_[i]));
   }
 
-  // leafnode data, these are the votes that leaves do
-  for (size_t i = 0, end = class_nodeids_.size(); i < end; ++i) {
-    leafnodedata_.push_back(std::make_tuple(class_treeids_[i], class_nodeids_[i], class_ids_[i], class_weights_[i]));
+  for (size_t i = 0, end = class_ids_.size(); i < end; ++i) {
     weights_classes_.insert(class_ids_[i]);
   }
-  std::sort(std::begin(leafnodedata_), std::end(leafnodedata_), [](auto const& t1, auto const& t2) {
-    if (std::get<0>(t1) != std::get<0>(t2))
-      return std::get<0>(t1) < std::get<0>(t2);
-
-    return std::get<1>(t1) < std::get<1>(t2);
-  });
-  // make an index so we can find the leafnode data quickly when evaluating
-  int64_t field0 = -1;
-  int64_t field1 = -1;
-  for (size_t i = 0, end = leafnodedata_.size(); i < end; ++i) {
-    int64_t id0 = std::get<0>(leafnodedata_[i]);
-    int64_t id1 = std::get<1>(leafnodedata_[i]);
-    if (id0 != field0 || id1 != field1) {
-      int64_t id = id0 * kOffset_ + id1;
-      auto position = static_cast<int64_t>(i);
-      auto p3 = std::make_pair(id, position);
-      leafdata_map_.insert(p3);
-      field0 = id;
-      field1 = position;
-    }
-  }
 
   // treenode ids, some are roots_, and roots_ have no parents
   std::unordered_map<int64_t, int64_t> parents;  // holds count of all who point to you
@@ -291,6 +269,12 @@ void TreeEnsembleClassifier<T>::Initialize() {
   ORT_ENFORCE(base_values_.empty() ||
               base_values_.size() == static_cast<size_t>(class_count_) ||
               base_values_.size() == weights_classes_.size());
+
+  layout_ = std::make_unique<TreeEnsembleLayout>(
+      nodes_treeids_, nodes_nodeids_, nodes_featureids_, nodes_values_, nodes_modes_,
+      nodes_truenodeids_, nodes_falsenodeids_, missing_tracks_true_, roots_,
+      class_treeids_, class_nodeids_, class_ids_, class_weights_, kMaxTreeDepth_,
+      std::max(static_cast<size_t>(class_count_), base_values_.size()));
 }
 
 template <typename T>
@@ -307,207 +291,134 @@ common::Status TreeEnsembleClassifier<T>::Compute(OpKernelContext* context) cons
   Tensor* Y = context->Output(0, TensorShape({N}));
   auto* Z = context->Output(1, TensorShape({N, class_count_}));
 
-  int64_t zindex = 0;
   const T* x_data = X.template Data<T>();
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
-  // for each class
-  std::vector<float> scores;
-  scores.reserve(class_count_);
-  for (int64_t i = 0; i < N; ++i) {
-    scores.clear();
-    int64_t current_weight_0 = i * stride;
-    std::map<int64_t, float> classes;
-    // fill in base values, this might be empty but that is ok
-    for (int64_t k = 0, end = static_cast<int64_t>(base_values_.size()); k < end; ++k) {
-      auto p1 = std::make_pair<int64_t&, const float&>(k, base_values_[k]);
-      classes.insert(p1);
-    }
-    // walk each tree from its root
-    for (size_t j = 0, end = roots_.size(); j < end; ++j) {
-      ORT_RETURN_IF_ERROR(ProcessTreeNode(classes, roots_[j], x_data, current_weight_0));
-    }
-    float maxweight = 0.f;
-    int64_t maxclass = -1;
-    // write top class
-    int write_additional_scores = -1;
-    if (class_count_ > 2) {
-      for (auto& classe : classes) {
-        if (maxclass == -1 || classe.second > maxweight) {
-          maxclass = classe.first;
-          maxweight = classe.second;
-        }
-      }
-      if (using_strings_) {
-        Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
-      } else {
-        Y->template MutableData<int64_t>()[i] = classlabels_int64s_[maxclass];
-      }
-    } else  // binary case
-    {
-      maxweight = !classes.empty() ? classes[0] : 0.f;  // only 1 class
-      if (using_strings_) {
-        auto* y_data = Y->template MutableData<std::string>();
-        if (classlabels_strings_.size() == 2 &&
-            weights_are_all_positive_ &&
-            maxweight > 0.5 &&
-            weights_classes_.size() == 1) {
-          y_data[i] = classlabels_strings_[1];  // positive label
-          write_additional_scores = 0;
-        } else if (classlabels_strings_.size() == 2 &&
-                   weights_are_all_positive_ &&
-                   maxweight <= 0.5 &&
-                   weights_classes_.size() == 1) {
-          y_data[i] = classlabels_strings_[0];  // negative label
-          write_additional_scores = 1;
-        } else if (classlabels_strings_.size() == 2 &&
-                   maxweight > 0 &&
-                   !weights_are_all_positive_ && weights_classes_.size() == 1) {
-          y_data[i] = classlabels_strings_[1];  // pos label
-          write_additional_scores = 2;
-        } else if (classlabels_strings_.size() == 2 &&
-                   maxweight <= 0 &&
-                   !weights_are_all_positive_ &&
-                   weights_classes_.size() == 1) {
-          y_data[i] = classlabels_strings_[0];  // neg label
-          write_additional_scores = 3;
-        } else if (maxweight > 0) {
-          y_data[i] = "1";  // positive label
-        } else {
-          y_data[i] = "0";  // negative label
-        }
-      } else {
-        auto* y_data = Y->template MutableData<int64_t>();
-        if (classlabels_int64s_.size() == 2 &&
-            weights_are_all_positive_ &&
-            maxweight > 0.5 &&
-            weights_classes_.size() == 1) {
-          y_data[i] = classlabels_int64s_[1];  // positive label
-          write_additional_scores = 0;
-        } else if (classlabels_int64s_.size() == 2 &&
-                   weights_are_all_positive_ &&
-                   maxweight <= 0.5 &&
-                   weights_classes_.size() == 1) {
-          y_data[i] = classlabels_int64s_[0];  // negative label
-          write_additional_scores = 1;
-        } else if (classlabels_int64s_.size() == 2 &&
-                   maxweight > 0 &&
-                   !weights_are_all_positive_ &&
-                   weights_classes_.size() == 1) {
-          y_data[i] = classlabels_int64s_[1];  // pos label
-          write_additional_scores = 2;
-        } else if (classlabels_int64s_.size() == 2 &&
-                   maxweight <= 0 &&
-                   !weights_are_all_positive_ &&
-                   weights_classes_.size() == 1) {
-          y_data[i] = classlabels_int64s_[0];  // neg label
-          write_additional_scores = 3;
-        } else if (maxweight > 0) {
-          y_data[i] = 1;  // positive label
-        } else {
-          y_data[i] = 0;  // negative label
-        }
-      }
-    }
-    // write float values, might not have all the classes in the output yet
-    // for example a 10 class case where we only found 2 classes in the leaves
-    if (weights_classes_.size() == static_cast<size_t>(class_count_)) {
-      for (int64_t k = 0; k < class_count_; ++k) {
-        auto it_classes = classes.find(k);
-        if (it_classes != classes.end()) {
-          scores.push_back(it_classes->second);
-        } else {
-          scores.push_back(0.f);
-        }
-      }
-    } else {
-      for (auto& classe : classes) {
-        scores.push_back(classe.second);
-      }
-    }
-    write_scores(scores, post_transform_, zindex, Z, write_additional_scores);
-    zindex += scores.size();
-  }  // for every batch
-  return Status::OK();
+  return layout_->Evaluate(x_data, N, stride, tp,
+                           [this, Y, Z](int64_t row, const TreeEnsembleAggregates& aggregates, int64_t aggregate_row) {
+                             WriteRow(row, aggregates, aggregate_row, Y, Z);
+                           });
 }
 
 template <typename T>
-common::Status TreeEnsembleClassifier<T>::ProcessTreeNode(std::map<int64_t, float>& classes,
-                                                          int64_t treeindex,
-                                                          const T* x_data,
-                                                          int64_t feature_base) const {
-  // walk down tree to the leaf
-  auto mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-  int64_t loopcount = 0;
-  int64_t root = treeindex;
-  while (mode != NODE_MODE::LEAF) {
-    T val = x_data[feature_base + nodes_featureids_[treeindex]];
-    bool tracktrue = true;
-    if (missing_tracks_true_.size() != nodes_truenodeids_.size()) {
-      tracktrue = false;
+void TreeEnsembleClassifier<T>::WriteRow(int64_t i, const TreeEnsembleAggregates& aggregates, int64_t aggregate_row,
+                                         Tensor* Y, Tensor* Z) const {
+  // a class has a score if it has a base value or received a vote
+  const size_t target_count = layout_->TargetCount();
+  const float* sums = aggregates.Sums(aggregate_row);
+  const uint8_t* has_votes = aggregates.HasVotes(aggregate_row);
+  std::vector<float> classes(target_count);
+  std::vector<uint8_t> has_classes(target_count);
+  bool any_class = false;
+  for (size_t k = 0; k < target_count; ++k) {
+    const bool has_base = k < base_values_.size();
+    classes[k] = (has_base ? base_values_[k] : 0.f) + sums[k];
+    has_classes[k] = has_base || has_votes[k];
+    any_class = any_class || has_classes[k];
+  }
+
+  float maxweight = 0.f;
+  int64_t maxclass = -1;
+  // write top class
+  int write_additional_scores = -1;
+  if (class_count_ > 2) {
+    for (size_t k = 0; k < target_count; ++k) {
+      if (has_classes[k] && (maxclass == -1 || classes[k] > maxweight)) {
+        maxclass = static_cast<int64_t>(k);
+        maxweight = classes[k];
+      }
+    }
+    if (using_strings_) {
+      Y->template MutableData<std::string>()[i] = classlabels_strings_[maxclass];
     } else {
-      tracktrue = missing_tracks_true_[treeindex] && std::isnan(static_cast<float>(val));
+      Y->template MutableData<int64_t>()[i] = classlabels_int64s_[maxclass];
+    }
+  } else  // binary case
+  {
+    if (any_class) {
+      maxweight = classes[0];  // only 1 class
+      has_classes[0] = 1;
     }
-    float threshold = nodes_values_[treeindex];
-    switch (mode) {
-      case NODE_MODE::BRANCH_LEQ:
-        treeindex = val <= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_LT:
-        treeindex = val < threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GTE:
-        treeindex = val >= threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_GT:
-        treeindex = val > threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_EQ:
-        treeindex = val == threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      case NODE_MODE::BRANCH_NEQ:
-        treeindex = val != threshold || tracktrue ? nodes_truenodeids_[treeindex] : nodes_falsenodeids_[treeindex];
-        break;
-      default: {
-        std::ostringstream err_msg;
-        err_msg << "Invalid mode of value: " << static_cast<std::underlying_type<NODE_MODE>::type>(mode);
-        return Status(ONNXRUNTIME, INVALID_ARGUMENT, err_msg.str());
+    if (using_strings_) {
+      auto* y_data = Y->template MutableData<std::string>();
+      if (classlabels_strings_.size() == 2 &&
+          weights_are_all_positive_ &&
+          maxweight > 0.5 &&
+          weights_classes_.size() == 1) {
+        y_data[i] = classlabels_strings_[1];  // positive label
+        write_additional_scores = 0;
+      } else if (classlabels_strings_.size() == 2 &&
+                 weights_are_all_positive_ &&
+                 maxweight <= 0.5 &&
+                 weights_classes_.size() == 1) {
+        y_data[i] = classlabels_strings_[0];  // negative label
+        write_additional_scores = 1;
+      } else if (classlabels_strings_.size() == 2 &&
+                 maxweight > 0 &&
+                 !weights_are_all_positive_ && weights_classes_.size() == 1) {
+        y_data[i] = classlabels_strings_[1];  // pos label
+        write_additional_scores = 2;
+      } else if (classlabels_strings_.size() == 2 &&
+                 maxweight <= 0 &&
+                 !weights_are_all_positive_ &&
+                 weights_classes_.size() == 1) {
+        y_data[i] = classlabels_strings_[0];  // neg label
+        write_additional_scores = 3;
+      } else if (maxweight > 0) {
+        y_data[i] = "1";  // positive label
+      } else {
+        y_data[i] = "0";  // negative label
+      }
+    } else {
+      auto* y_data = Y->template MutableData<int64_t>();
+      if (classlabels_int64s_.size() == 2 &&
+          weights_are_all_positive_ &&
+          maxweight > 0.5 &&
+          weights_classes_.size() == 1) {
+        y_data[i] = classlabels_int64s_[1];  // positive label
+        write_additional_scores = 0;
+      } else if (classlabels_int64s_.size() == 2 &&
+                 weights_are_all_positive_ &&
+                 maxweight <= 0.5 &&
+                 weights_classes_.size() == 1) {
+        y_data[i] = classlabels_int64s_[0];  // negative label
+        write_additional_scores = 1;
+      } else if (classlabels_int64s_.size() == 2 &&
+                 maxweight > 0 &&
+                 !weights_are_all_positive_ &&
+                 weights_classes_.size() == 1) {
+        y_data[i] = classlabels_int64s_[1];  // pos label
+        write_additional_scores = 2;
+      } else if (classlabels_int64s_.size() == 2 &&
+                 maxweight <= 0 &&
+                 !weights_are_all_positive_ &&
+                 weights_classes_.size() == 1) {
+        y_data[i] = classlabels_int64s_[0];  // neg label
+        write_additional_scores = 3;
+      } else if (maxweight > 0) {
+        y_data[i] = 1;  // positive label
+      } else {
+        y_data[i] = 0;  // negative label
       }
     }
-    ORT_ENFORCE(treeindex >= 0);
-    treeindex = treeindex + root;
-    mode = static_cast<NODE_MODE>(nodes_modes_[treeindex]);
-    loopcount++;
-    if (loopcount > kMaxTreeDepth_) break;
   }
-  // should be at leaf
-  int64_t id = nodes_treeids_[treeindex] * kOffset_ + nodes_nodeids_[treeindex];
-  auto it_lp = leafdata_map_.find(id);
-  if (it_lp == leafdata_map_.end()) {  // if not found, simply return
-    return Status::OK();
-  }
-  int64_t index = it_lp->second;
-  int64_t treeid = std::get<0>(leafnodedata_[index]);
-  int64_t nodeid = std::get<1>(leafnodedata_[index]);
-  while (treeid == nodes_treeids_[treeindex] && nodeid == nodes_nodeids_[treeindex]) {
-    int64_t classid = std::get<2>(leafnodedata_[index]);
-    float weight = std::get<3>(leafnodedata_[index]);
-    std::map<int64_t, float>::iterator it_classes;
-    it_classes = classes.find(classid);
-    if (it_classes != classes.end()) {
-      it_classes->second += weight;
-    } else {
-      auto p1 = std::make_pair(classid, weight);
-      classes.insert(p1);
+  // write float values, might not have all the classes in the output yet
+  // for example a 10 class case where we only found 2 classes in the leaves
+  std::vector<float> scores;
+  scores.reserve(class_count_ + 1);
+  if (weights_classes_.size() == static_cast<size_t>(class_count_)) {
+    for (int64_t k = 0; k < class_count_; ++k) {
+      scores.push_back(classes[k]);
     }
-    ++index;
-    // some tree node will be last
-    if (index >= static_cast<int64_t>(leafnodedata_.size())) {
-      break;
+  } else {
+    for (size_t k = 0; k < target_count; ++k) {
+      if (has_classes[k]) {
+        scores.push_back(classes[k]);
+      }
     }
-    treeid = std::get<0>(leafnodedata_[index]);
-    nodeid = std::get<1>(leafnodedata_[index]);
   }
-  return Status::OK();
+  write_scores(scores, post_transform_, i * class_count_, Z, write_additional_scores);
 }
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/ml/tree_ensemble_layout.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace onnxruntime {
+namespace ml {
+
+constexpr int64_t TreeEnsembleLayout::kRowBlockSize;
+constexpr double TreeEnsembleLayout::kCostPerTree;
+constexpr uint32_t TreeEnsembleLayout::kInvalidNode;
+
+TreeEnsembleLayout::TreeEnsembleLayout(const std::vector<int64_t>& nodes_treeids,
+                                       const std::vector<int64_t>& nodes_nodeids,
+                                       const std::vector<int64_t>& nodes_featureids,
+                                       const std::vector<float>& nodes_values,
+                                       const std::vector<NODE_MODE>& nodes_modes,
+                                       const std::vector<int64_t>& nodes_truenodeids,
+                                       const std::vector<int64_t>& nodes_falsenodeids,
+                                       const std::vector<int64_t>& missing_tracks_true,
+                                       const std::vector<int64_t>& roots,
+                                       const std::vector<int64_t>& target_treeids,
+                                       const std::vector<int64_t>& target_nodeids,
+                                       const std::vector<int64_t>& target_ids,
+                                       const std::vector<float>& target_weights,
+                                       int64_t max_tree_depth,
+                                       size_t min_target_count)
+    : target_count_(min_target_count),
+      max_tree_depth_(max_tree_depth) {
+  const int64_t kOffset = 4000000000L;
+  const int64_t node_count = static_cast<int64_t>(nodes_nodeids.size());
+  ORT_ENFORCE(node_count < static_cast<int64_t>(kInvalidNode));
+  const bool has_missing_tracks = missing_tracks_true.size() == nodes_truenodeids.size();
+
+  // group the votes of each node, keeping the order in which they are listed
+  std::vector<size_t> vote_order(target_nodeids.size());
+  for (size_t i = 0; i < vote_order.size(); ++i) {
+    vote_order[i] = i;
+    ORT_ENFORCE(target_ids[i] >= 0 && target_ids[i] < static_cast<int64_t>(kInvalidNode),
+                "Invalid target id: ", target_ids[i]);
+    target_count_ = std::max(target_count_, static_cast<size_t>(target_ids[i]) + 1);
+  }
+  std::stable_sort(vote_order.begin(), vote_order.end(), [&](size_t v1, size_t v2) {
+    if (target_treeids[v1] != target_treeids[v2])
+      return target_treeids[v1] < target_treeids[v2];
+    return target_nodeids[v1] < target_nodeids[v2];
+  });
+  std::unordered_map<int64_t, std::pair<size_t, size_t>> node_votes;  // range in vote_order
+  for (size_t i = 0; i < vote_order.size();) {
+    size_t end = i + 1;
+    while (end < vote_order.size() &&
+           target_treeids[vote_order[end]] == target_treeids[vote_order[i]] &&
+           target_nodeids[vote_order[end]] == target_nodeids[vote_order[i]]) {
+      ++end;
+    }
+    node_votes.insert({target_treeids[vote_order[i]] * kOffset + target_nodeids[vote_order[i]], {i, end}});
+    i = end;
+  }
+
+  // lay out the nodes reachable from each root in depth first order
+  std::unordered_map<int64_t, uint32_t> compiled;
+  std::vector<int64_t> sources;
+  std::vector<int64_t> pending;
+  vote_offsets_.push_back(0);
+
+  auto child_of = [&](int64_t root, int64_t child) -> int64_t {
+    return (child < 0 || root + child >= node_count) ? -1 : root + child;
+  };
+
+  for (int64_t root : roots) {
+    compiled.clear();
+    const size_t first = sources.size();
+    roots_.push_back(static_cast<uint32_t>(first));
+
+    pending.push_back(root);
+    while (!pending.empty()) {
+      int64_t node = pending.back();
+      pending.pop_back();
+      if (compiled.find(node) != compiled.end()) continue;
+
+      compiled.insert({node, static_cast<uint32_t>(sources.size())});
+      sources.push_back(node);
+
+      const int32_t feature_id = static_cast<int32_t>(nodes_featureids[node]);
+      ORT_ENFORCE(nodes_modes[node] == NODE_MODE::LEAF || (feature_id >= 0 && feature_id == nodes_featureids[node]),
+                  "Invalid feature id: ", nodes_featureids[node]);
+      feature_ids_.push_back(feature_id);
+      thresholds_.push_back(nodes_values[node]);
+      modes_.push_back(nodes_modes[node]);
+      missing_tracks_true_.push_back(has_missing_tracks && missing_tracks_true[node] != 0);
+
+      auto votes = node_votes.find(nodes_treeids[node] * kOffset + nodes_nodeids[node]);
+      if (votes != node_votes.end()) {
+        for (size_t i = votes->second.first; i < votes->second.second; ++i) {
+          vote_targets_.push_back(static_cast<uint32_t>(target_ids[vote_order[i]]));
+          vote_weights_.push_back(target_weights[vote_order[i]]);
+        }
+      }
+      ORT_ENFORCE(vote_targets_.size() < static_cast<size_t>(kInvalidNode));
+      vote_offsets_.push_back(static_cast<uint32_t>(vote_targets_.size()));
+
+      if (nodes_modes[node] != NODE_MODE::LEAF) {
+        // the true branch is popped first so that it is placed right after its parent
+        int64_t false_child = child_of(root, nodes_falsenodeids[node]);
+        int64_t true_child = child_of(root, nodes_truenodeids[node]);
+        if (false_child >= 0) pending.push_back(false_child);
+        if (true_child >= 0) pending.push_back(true_child);
+      }
+    }
+
+    // link the children now that every node reachable from this root has its index
+    for (size_t index = first; index < sources.size(); ++index) {
+      uint32_t true_index = kInvalidNode;
+      uint32_t false_index = kInvalidNode;
+      if (modes_[index] != NODE_MODE::LEAF) {
+        int64_t node = sources[index];
+        int64_t true_child = child_of(root, nodes_truenodeids[node]);
+        int64_t false_child = child_of(root, nodes_falsenodeids[node]);
+        if (true_child >= 0) true_index = compiled[true_child];
+        if (false_child >= 0) false_index = compiled[false_child];
+      }
+      true_children_.push_back(true_index);
+      false_children_.push_back(false_index);
+    }
+  }
+
+  ORT_ENFORCE(sources.size() < static_cast<size_t>(kInvalidNode));
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -0,0 +1,268 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cmath>
+#include <mutex>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+
+// Votes of the trees for a block of rows, stored densely by row and then by target.
+struct TreeEnsembleAggregates {
+  void Reset(int64_t row_count, size_t target_count) {
+    const size_t size = static_cast<size_t>(row_count) * target_count;
+    target_count_ = target_count;
+    sums_.assign(size, 0.f);
+    mins_.assign(size, 0.f);
+    maxs_.assign(size, 0.f);
+    has_votes_.assign(size, 0);
+  }
+
+  void Add(int64_t row, size_t target, float weight) {
+    const size_t index = static_cast<size_t>(row) * target_count_ + target;
+    if (has_votes_[index]) {
+      sums_[index] += weight;
+      if (weight < mins_[index]) mins_[index] = weight;
+      if (weight > maxs_[index]) maxs_[index] = weight;
+    } else {
+      sums_[index] = weight;
+      mins_[index] = weight;
+      maxs_[index] = weight;
+      has_votes_[index] = 1;
+    }
+  }
+
+  // Combines the votes of another set of trees evaluated for the same rows.
+  void Merge(const TreeEnsembleAggregates& other) {
+    for (size_t index = 0; index < sums_.size(); ++index) {
+      if (!other.has_votes_[index]) continue;
+      if (has_votes_[index]) {
+        sums_[index] += other.sums_[index];
+        if (other.mins_[index] < mins_[index]) mins_[index] = other.mins_[index];
+        if (other.maxs_[index] > maxs_[index]) maxs_[index] = other.maxs_[index];
+      } else {
+        sums_[index] = other.sums_[index];
+        mins_[index] = other.mins_[index];
+        maxs_[index] = other.maxs_[index];
+        has_votes_[index] = 1;
+      }
+    }
+  }
+
+  const float* Sums(int64_t row) const { return sums_.data() + row * target_count_; }
+  const float* Mins(int64_t row) const { return mins_.data() + row * target_count_; }
+  const float* Maxs(int64_t row) const { return maxs_.data() + row * target_count_; }
+  const uint8_t* HasVotes(int64_t row) const { return has_votes_.data() + row * target_count_; }
+
+ private:
+  size_t target_count_{0};
+  std::vector<float> sums_;
+  std::vector<float> mins_;
+  std::vector<float> maxs_;
+  std::vector<uint8_t> has_votes_;
+};
+
+// Compiled form of the node and vote attributes shared by TreeEnsembleClassifier and TreeEnsembleRegressor.
+// It is built once when the kernel is created. The nodes of each tree are stored as structure of arrays in
+// depth first order, so the true branch of a node immediately follows it, children are referenced by their
+// index in the layout and the votes of each node are a contiguous range of dense target ids. Evaluation
+// needs no map lookups and is split over the rows, or over the trees when there are few rows.
+class TreeEnsembleLayout {
+ public:
+  // The node ids must already be rebased so that the children of a node are found at the index of
+  // its root plus the child id, which is how the kernels walked the attribute arrays.
+  TreeEnsembleLayout(const std::vector<int64_t>& nodes_treeids,
+                     const std::vector<int64_t>& nodes_nodeids,
+                     const std::vector<int64_t>& nodes_featureids,
+                     const std::vector<float>& nodes_values,
+                     const std::vector<NODE_MODE>& nodes_modes,
+                     const std::vector<int64_t>& nodes_truenodeids,
+                     const std::vector<int64_t>& nodes_falsenodeids,
+                     const std::vector<int64_t>& missing_tracks_true,
+                     const std::vector<int64_t>& roots,
+                     const std::vector<int64_t>& target_treeids,
+                     const std::vector<int64_t>& target_nodeids,
+                     const std::vector<int64_t>& target_ids,
+                     const std::vector<float>& target_weights,
+                     int64_t max_tree_depth,
+                     size_t min_target_count);
+
+  size_t TreeCount() const { return roots_.size(); }
+
+  // Number of targets in the aggregates, at least the minimum supplied when built.
+  size_t TargetCount() const { return target_count_; }
+
+  // Evaluates rows [0, N) of x_data and calls finalize(row, aggregates, aggregate_row) once for every row
+  // with the aggregated votes of all the trees. finalize may be called concurrently for different rows.
+  template <typename T, typename Finalize>
+  common::Status Evaluate(const T* x_data, int64_t N, int64_t stride, concurrency::ThreadPool* tp,
+                          Finalize finalize) const;
+
+ private:
+  // Number of rows run through each tree before moving to the next one, so that the nodes
+  // of a tree stay in cache while they are used.
+  static constexpr int64_t kRowBlockSize = 16;
+
+  // Approximate cost, in cycles, of walking one tree for one row.
+  static constexpr double kCostPerTree = 32.0;
+
+  static constexpr uint32_t kInvalidNode = UINT32_MAX;
+
+  template <typename T>
+  uint32_t Walk(const T* x, uint32_t index) const;
+
+  template <typename T>
+  common::Status Accumulate(const T* x_data, int64_t stride, int64_t row_count,
+                            size_t tree_begin, size_t tree_end, TreeEnsembleAggregates& aggregates) const;
+
+  std::vector<int32_t> feature_ids_;
+  std::vector<float> thresholds_;
+  std::vector<NODE_MODE> modes_;
+  std::vector<uint8_t> missing_tracks_true_;
+  std::vector<uint32_t> true_children_;
+  std::vector<uint32_t> false_children_;
+
+  // Votes of node i are [vote_offsets_[i], vote_offsets_[i + 1]).
+  std::vector<uint32_t> vote_offsets_;
+  std::vector<uint32_t> vote_targets_;
+  std::vector<float> vote_weights_;
+
+  std::vector<uint32_t> roots_;
+  size_t target_count_;
+  int64_t max_tree_depth_;
+};
+
+template <typename T>
+uint32_t TreeEnsembleLayout::Walk(const T* x, uint32_t index) const {
+  int64_t loopcount = 0;
+  NODE_MODE mode = modes_[index];
+  while (mode != NODE_MODE::LEAF) {
+    const T val = x[feature_ids_[index]];
+    const float threshold = thresholds_[index];
+    bool take_true;
+    switch (mode) {
+      case NODE_MODE::BRANCH_LEQ:
+        take_true = val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        take_true = val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        take_true = val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        take_true = val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        take_true = val == threshold;
+        break;
+      default:
+        take_true = val != threshold;
+        break;
+    }
+    if (missing_tracks_true_[index] && std::isnan(static_cast<float>(val))) {
+      take_true = true;
+    }
+    index = take_true ? true_children_[index] : false_children_[index];
+    if (index == kInvalidNode) break;
+    mode = modes_[index];
+    if (++loopcount > max_tree_depth_) break;
+  }
+  return index;
+}
+
+template <typename T>
+common::Status TreeEnsembleLayout::Accumulate(const T* x_data, int64_t stride, int64_t row_count,
+                                              size_t tree_begin, size_t tree_end,
+                                              TreeEnsembleAggregates& aggregates) const {
+  for (size_t tree = tree_begin; tree < tree_end; ++tree) {
+    for (int64_t row = 0; row < row_count; ++row) {
+      const uint32_t node = Walk(x_data + row * stride, roots_[tree]);
+      if (node == kInvalidNode) {
+        return common::Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION,
+                              "treeindex evaluated to an invalid value, which should not happen.");
+      }
+      for (uint32_t vote = vote_offsets_[node], end = vote_offsets_[node + 1]; vote < end; ++vote) {
+        aggregates.Add(row, vote_targets_[vote], vote_weights_[vote]);
+      }
+    }
+  }
+  return common::Status::OK();
+}
+
+template <typename T, typename Finalize>
+common::Status TreeEnsembleLayout::Evaluate(const T* x_data, int64_t N, int64_t stride,
+                                            concurrency::ThreadPool* tp, Finalize finalize) const {
+  if (N <= 0) {
+    return common::Status::OK();
+  }
+
+  const size_t tree_count = roots_.size();
+
+  // With fewer rows than threads, split the trees instead and combine the partial aggregates in a fixed order.
+  if (tp != nullptr && tree_count > 1 && N < static_cast<int64_t>(tp->NumThreads()) + 1) {
+    const std::ptrdiff_t block_count = tp->ComputeBlockCount(static_cast<std::ptrdiff_t>(tree_count),
+                                                             kCostPerTree * static_cast<double>(N));
+    if (block_count > 1) {
+      std::vector<TreeEnsembleAggregates> partials(block_count);
+      std::vector<common::Status> statuses(block_count);
+
+      tp->ParallelFor(block_count, 0.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const size_t tree_begin = tree_count * block / block_count;
+          const size_t tree_end = tree_count * (block + 1) / block_count;
+          partials[block].Reset(N, target_count_);
+          statuses[block] = Accumulate(x_data, stride, N, tree_begin, tree_end, partials[block]);
+        }
+      });
+
+      for (std::ptrdiff_t block = 0; block < block_count; ++block) {
+        ORT_RETURN_IF_ERROR(statuses[block]);
+        if (block > 0) {
+          partials[0].Merge(partials[block]);
+        }
+      }
+      for (int64_t row = 0; row < N; ++row) {
+        finalize(row, partials[0], row);
+      }
+      return common::Status::OK();
+    }
+  }
+
+  std::mutex status_mutex;
+  common::Status status;
+
+  auto compute_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    TreeEnsembleAggregates aggregates;
+    for (int64_t row = first; row < last; row += kRowBlockSize) {
+      const int64_t row_count = std::min<int64_t>(kRowBlockSize, last - row);
+      aggregates.Reset(row_count, target_count_);
+      common::Status block_status = Accumulate(x_data + row * stride, stride, row_count, 0, tree_count, aggregates);
+      if (!block_status.IsOK()) {
+        std::lock_guard<std::mutex> lock(status_mutex);
+        status = block_status;
+        return;
+      }
+      for (int64_t r = 0; r < row_count; ++r) {
+        finalize(row + r, aggregates, r);
+      }
+    }
+  };
+
+  if (tp == nullptr) {
+    compute_rows(0, N);
+  } else {
+    tp->ParallelFor(N, kCostPerTree * static_cast<double>(tree_count), compute_rows);
+  }
+
+  return status;
+}
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "ml_common.h"
+#include "tree_ensemble_layout.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -15,7 +16,7 @@ class TreeEnsembleRegressor final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
-  common::Status ProcessTreeNode(std::unordered_map < int64_t, std::tuple<float, float, float>>& classes, int64_t treeindex, const T* Xdata, int64_t feature_base) const;
+  void WriteRow(int64_t row, const TreeEnsembleAggregates& aggregates, int64_t aggregate_row, Tensor* Y) const;
 
   std::vector<int64_t> nodes_treeids_;
   std::vector<int64_t> nodes_nodeids_;
@@ -36,9 +37,8 @@ class TreeEnsembleRegressor final : public OpKernel {
   int64_t n_targets_;
   ::onnxruntime::ml::POST_EVAL_TRANSFORM transform_;
   ::onnxruntime::ml::AGGREGATE_FUNCTION aggregate_function_;
-  std::vector<std::tuple<int64_t, int64_t, int64_t, float>> leafnode_data_;
-  std::unordered_map<int64_t, size_t> leafdata_map_;
   std::vector<int64_t> roots_;
+  std::unique_ptr<TreeEnsembleLayout> layout_;
   int64_t offset_;
   int64_t max_tree_depth_;
   const int64_t four_billion_ = 4000000000L;
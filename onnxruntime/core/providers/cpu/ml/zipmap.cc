@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+#include <algorithm>
+#include <numeric>
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/master/onnx/defs/traditionalml/defs.cc
@@ -42,6 +44,55 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+
+  const size_t label_count = using_strings_ ? classlabels_strings_.size() : classlabels_int64s_.size();
+  sorted_label_indices_.resize(label_count);
+  std::iota(sorted_label_indices_.begin(), sorted_label_indices_.end(), size_t{0});
+  auto sort_labels = [this](const auto& labels) {
+    std::stable_sort(sorted_label_indices_.begin(), sorted_label_indices_.end(),
+                     [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+    // A repeated label maps to the value of its last occurrence.
+    std::vector<size_t> unique_indices;
+    unique_indices.reserve(sorted_label_indices_.size());
+    for (size_t i = 0; i < sorted_label_indices_.size(); ++i) {
+      if (i + 1 < sorted_label_indices_.size() &&
+          labels[sorted_label_indices_[i]] == labels[sorted_label_indices_[i + 1]]) {
+        continue;
+      }
+      unique_indices.push_back(sorted_label_indices_[i]);
+    }
+    sorted_label_indices_ = std::move(unique_indices);
+  };
+  if (using_strings_) {
+    sort_labels(classlabels_strings_);
+  } else {
+    sort_labels(classlabels_int64s_);
+  }
+}
+
+template <typename TKey>
+common::Status ZipMapOp::ComputeImpl(OpKernelContext& context, const std::vector<TKey>& classlabels,
+                                     const float* x_data, int64_t batch_size, int64_t features_per_batch) const {
+  if (features_per_batch != static_cast<int64_t>(classlabels.size())) {
+    return Status(ONNXRUNTIME,
+                  INVALID_ARGUMENT,
+                  "Input features_per_batch[" + std::to_string(features_per_batch) +
+                      "] != number of classlabels[" + std::to_string(classlabels.size()) + "]");
+  }
+  auto* y_data = context.Output<std::vector<std::map<TKey, float>>>(0);
+  if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
+
+  y_data->resize(batch_size);
+  for (int64_t n = 0; n < batch_size; n++) {
+    auto& map = (*y_data)[n];
+    map.clear();
+    // the labels are visited in key order, so each insertion goes at the end of the map
+    for (size_t j : sorted_label_indices_) {
+      map.emplace_hint(map.end(), classlabels[j], x_data[j]);
+    }
+    x_data += features_per_batch;
+  }
+  return common::Status::OK();
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -69,48 +120,9 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
   const auto* x_data = X.template Data<float>();
 
   if (using_strings_) {
-    if (features_per_batch != static_cast<int64_t>(classlabels_strings_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_strings_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-
-    //auto* y_data = Y->template MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map1);
-    }
-  } else {
-    if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
-      return Status(ONNXRUNTIME,
-                    INVALID_ARGUMENT,
-                    "Input features_per_batch[" + std::to_string(features_per_batch) +
-                        "] != number of classlabels[" + std::to_string(classlabels_int64s_.size()) + "]");
-    }
-    auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
-    if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    //auto* y_data = Y->template MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(batch_size);
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    return ComputeImpl(*context, classlabels_strings_, x_data, batch_size, features_per_batch);
   }
-  return common::Status::OK();
+  return ComputeImpl(*context, classlabels_int64s_, x_data, batch_size, features_per_batch);
 }
 }  // namespace ml
 }  // namespace onnxruntime
@@ -13,9 +13,17 @@ class ZipMapOp final : public OpKernel {
   common::Status Compute(OpKernelContext* context) const override;
 
  private:
+  template <typename TKey>
+  common::Status ComputeImpl(OpKernelContext& context, const std::vector<TKey>& classlabels,
+                             const float* x_data, int64_t batch_size, int64_t features_per_batch) const;
+
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+
+  // The indices of the class labels in key order, keeping only the last of a repeated label,
+  // so every map of the output is built with end-hinted insertions.
+  std::vector<size_t> sorted_label_indices_;
 };
 
 }  // namespace ml
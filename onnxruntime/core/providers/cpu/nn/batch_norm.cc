@@ -17,6 +17,8 @@
 
 #include "core/providers/cpu/nn/batch_norm.h"
 #include "core/providers/cpu/nn/batch_norm_helper.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 // spec: https://github.com/onnx/onnx/blob/master/docs/Operators.md#BatchNormalization
@@ -24,7 +26,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     BatchNormalization,
     7,
     9,
-    KernelDefBuilder().TypeConstraint("X", DataTypeImpl::GetTensorType<float>()).TypeConstraint("scale", DataTypeImpl::GetTensorType<float>()).TypeConstraint("B", DataTypeImpl::GetTensorType<float>()).TypeConstraint("mean", DataTypeImpl::GetTensorType<float>()).TypeConstraint("var", DataTypeImpl::GetTensorType<float>()),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("X", DataTypeImpl::GetTensorType<float>()).TypeConstraint("scale", DataTypeImpl::GetTensorType<float>()).TypeConstraint("B", DataTypeImpl::GetTensorType<float>()).TypeConstraint("mean", DataTypeImpl::GetTensorType<float>()).TypeConstraint("var", DataTypeImpl::GetTensorType<float>()),
     BatchNorm<float>);
 
 template <>
@@ -50,29 +52,24 @@ Status BatchNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const {
     sample_size *= dims_vec[i];
   }
 
-  ConstEigenVectorArrayMap<float> scale_arr(scale->template Data<float>(), C);
-  ConstEigenVectorArrayMap<float> bias_arr(B->template Data<float>(), C);
-
   // Regardless of training or testing, we will apply the estimated mean
   // and standard deviation to the input. For testing, they are
   // specified directly by the input, and for training, they are computed
   // by the op.
-  Eigen::Array<float, Eigen::Dynamic, 1> inv_std(C);
-  ConstEigenVectorArrayMap<float> var_arr(var->template Data<float>(), C);
-  inv_std = (var_arr + epsilon_).sqrt().inverse();
-  ConstEigenVectorArrayMap<float> mean_arr(mean->template Data<float>(), C);
-  // We can fuse the output computation as follows:
-  //   ((x - est_mean) * (inv_var) * scale + bias
-  // to
-  //   (x * inv_var * scale) + (bias - est_mean * inv_var * scale)
-  Eigen::Array<float, Eigen::Dynamic, 1> new_scale = inv_std * scale_arr;
-  Eigen::Array<float, Eigen::Dynamic, 1> new_bias = bias_arr - mean_arr * new_scale;
-  EigenArrayMap<float> Y_arr(Y->template MutableData<float>(), sample_size, N * C);
-  ConstEigenArrayMap<float> X_arr(X->template Data<float>(), sample_size, N * C);
-  for (size_t nc = 0; nc < N * C; ++nc) {
-    Y_arr.col(nc) = X_arr.col(nc) * new_scale(nc % C) + new_bias(nc % C);
+  std::vector<float> runtime_scale;
+  std::vector<float> runtime_shift;
+  const std::vector<float>* fused_scale = &fused_scale_;
+  const std::vector<float>* fused_shift = &fused_shift_;
+  if (fused_scale_.empty()) {
+    FoldScaleShift(*scale, *B, *mean, *var, epsilon_, runtime_scale, runtime_shift);
+    fused_scale = &runtime_scale;
+    fused_shift = &runtime_shift;
   }
 
+  MlasComputeChannelScaleShift(X->template Data<float>(), Y->template MutableData<float>(),
+                               fused_scale->data(), fused_shift->data(), N, C, sample_size,
+                               static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool());
+
   return Status::OK();
 }
 }  // namespace onnxruntime
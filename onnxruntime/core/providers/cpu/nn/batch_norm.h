@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <cmath>
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/common/exceptions.h"
 #include "core/framework/op_kernel.h"
@@ -40,12 +43,48 @@ class BatchNorm : public OpKernel {
     }
 
     //TODO: momentum
+
+    // The inference of the operator is a scale and shift per channel, which can be folded once when scale, B, mean
+    // and var are all initializers.
+    const Tensor* scale;
+    const Tensor* B;
+    const Tensor* mean;
+    const Tensor* var;
+    if (op_kernel_info.TryGetConstantInput(1, &scale) && op_kernel_info.TryGetConstantInput(2, &B) &&
+        op_kernel_info.TryGetConstantInput(3, &mean) && op_kernel_info.TryGetConstantInput(4, &var)) {
+      const auto num_channels = scale->Shape().Size();
+      if (scale->Shape().NumDimensions() == 1 && B->Shape().Size() == num_channels &&
+          mean->Shape().Size() == num_channels && var->Shape().Size() == num_channels) {
+        FoldScaleShift(*scale, *B, *mean, *var, epsilon_, fused_scale_, fused_shift_);
+      }
+    }
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override;
 
   protected:
+   // Computes the scale and shift per channel that the normalization reduces to:
+   //   ((x - mean) * inv_std) * scale + B = x * (inv_std * scale) + (B - mean * inv_std * scale)
+   static void FoldScaleShift(const Tensor& scale, const Tensor& B, const Tensor& mean, const Tensor& var,
+                              float epsilon, std::vector<float>& fused_scale, std::vector<float>& fused_shift) {
+     const size_t num_channels = static_cast<size_t>(scale.Shape().Size());
+     const float* scale_data = scale.template Data<float>();
+     const float* B_data = B.template Data<float>();
+     const float* mean_data = mean.template Data<float>();
+     const float* var_data = var.template Data<float>();
+     fused_scale.resize(num_channels);
+     fused_shift.resize(num_channels);
+     for (size_t c = 0; c < num_channels; ++c) {
+       fused_scale[c] = scale_data[c] / std::sqrt(var_data[c] + epsilon);
+       fused_shift[c] = B_data[c] - mean_data[c] * fused_scale[c];
+     }
+   }
+
    float epsilon_;
    //int64_t is_test_;   ignored in this implementation since we're doing inferencing only.
+
+   // the folded scale and shift when the parameters are initializers, else empty
+   std::vector<float> fused_scale_;
+   std::vector<float> fused_shift_;
 };
 }  // namespace onnxruntime
@@ -54,15 +54,16 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   }
 
   std::vector<int64_t> Y_dims;
+  Y_dims.reserve(2 + kernel_shape.size());
   Y_dims.insert(Y_dims.begin(), {N, M});
   TensorShape input_shape = X->Shape().Slice(2);
   ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
+  Tensor* Y = context->Output(0, TensorShape(std::move(Y_dims)));
+  const int64_t* output_shape = Y->Shape().GetDims().data() + 2;
 
   const int64_t input_image_size = input_shape.Size();
-  const int64_t output_image_size = output_shape.Size();
-  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t output_image_size = Y->Shape().SizeFromDimension(2);
+  const int64_t kernel_size = TensorShape::ReinterpretBaseType(kernel_shape).Size();
   const int64_t X_offset = C / group_ * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
   const int64_t W_offset = W->Shape().Size() / group_;
@@ -79,10 +80,14 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   const T* Xdata = X->template Data<T>();
   T* Ydata = Y->template MutableData<T>();
 
-  TensorShape image_shape = X->Shape().Slice(1);
-  std::vector<int64_t> col_buffer_shape{kernel_dim};
-  col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
-                          output_shape.GetDims().end());
+  // The image shape and the column buffer shape are only needed by Im2colNd.
+  const int64_t* image_shape = X->Shape().GetDims().data() + 1;
+  std::vector<int64_t> col_buffer_shape;
+  if (!Is2DKernel) {
+    col_buffer_shape.reserve(1 + kernel_shape.size());
+    col_buffer_shape.push_back(kernel_dim);
+    col_buffer_shape.insert(col_buffer_shape.end(), output_shape, output_shape + kernel_shape.size());
+  }
 
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
@@ -107,7 +112,7 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
       } else {
         math::Im2colNd<T, CPUMathUtil, StorageOrder::NCHW>()(
             Xdata + group_id * X_offset,
-            image_shape.GetDims().data(),
+            image_shape,
             col_buffer_shape.data(),
             C * input_image_size,
             col_buffer_size,
@@ -146,6 +151,18 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+std::shared_ptr<std::vector<size_t>> Conv<float>::GetIndirectionBuffer(const MLAS_CONV_PARAMETERS& parameters,
+                                                                        std::vector<int64_t> shape_key) const {
+  std::lock_guard<OrtMutex> lock(indirection_mutex_);
+  if (indirection_buffer_ == nullptr || indirection_shape_key_ != shape_key) {
+    auto buffer = std::make_shared<std::vector<size_t>>(MlasConvIndirectionBufferSize(&parameters));
+    MlasConvBuildIndirectionBuffer(&parameters, buffer->data());
+    indirection_buffer_ = std::move(buffer);
+    indirection_shape_key_ = std::move(shape_key);
+  }
+  return indirection_buffer_;
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
   concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
@@ -176,11 +193,12 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   }
 
   std::vector<int64_t> Y_dims;
+  Y_dims.reserve(2 + kernel_shape.size());
   Y_dims.insert(Y_dims.begin(), {N, M});
   TensorShape input_shape = X->Shape().Slice(2);
   ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
-  Tensor* Y = context->Output(0, TensorShape(Y_dims));
-  TensorShape output_shape = Y->Shape().Slice(2);
+  Tensor* Y = context->Output(0, TensorShape(std::move(Y_dims)));
+  const int64_t* output_shape = Y->Shape().GetDims().data() + 2;
 
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
@@ -204,12 +222,22 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     dilations.data(),
                     pads.data(),
                     strides.data(),
-                    output_shape.GetDims().data(),
+                    output_shape,
                     static_cast<size_t>(M / group_),
                     &activation_,
                     &WorkingBufferSize,
                     tp);
 
+    // The indirection buffer replaces the working buffer of the indirect algorithm, so build it once per shape.
+    std::shared_ptr<std::vector<size_t>> indirection_buffer;
+    if (Parameters.Algorithm == MlasConvAlgorithmIndirect) {
+      std::vector<int64_t> shape_key(input_shape.GetDims());
+      shape_key.insert(shape_key.end(), kernel_shape.begin(), kernel_shape.end());
+      indirection_buffer = GetIndirectionBuffer(Parameters, std::move(shape_key));
+      Parameters.IndirectionBuffer = indirection_buffer->data();
+      WorkingBufferSize = 0;
+    }
+
     auto working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * WorkingBufferSize) : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
 
@@ -222,8 +250,8 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
              tp);
   } else {
     const int64_t input_image_size = input_shape.Size();
-    const int64_t output_image_size = output_shape.Size();
-    const int64_t kernel_size = TensorShape(kernel_shape).Size();
+    const int64_t output_image_size = Y->Shape().SizeFromDimension(2);
+    const int64_t kernel_size = TensorShape::ReinterpretBaseType(kernel_shape).Size();
     const int64_t X_offset = C / group_ * input_image_size;
     const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
     const int64_t W_offset = W->Shape().Size() / group_;
@@ -234,16 +262,17 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
     BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
     auto* col_buffer_data = static_cast<float*>(col_buffer.get());
 
-    TensorShape image_shape = X->Shape().Slice(1);
-    std::vector<int64_t> col_buffer_shape{kernel_dim};
-    col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
-                            output_shape.GetDims().end());
+    const int64_t* image_shape = X->Shape().GetDims().data() + 1;
+    std::vector<int64_t> col_buffer_shape;
+    col_buffer_shape.reserve(1 + kernel_rank);
+    col_buffer_shape.push_back(kernel_dim);
+    col_buffer_shape.insert(col_buffer_shape.end(), output_shape, output_shape + kernel_rank);
 
     for (int image_id = 0; image_id < N; ++image_id) {
       for (int group_id = 0; group_id < group_; ++group_id) {
         math::Im2colNd<float, CPUMathUtil, StorageOrder::NCHW>()(
             Xdata + group_id * X_offset,
-            image_shape.GetDims().data(),
+            image_shape,
             col_buffer_shape.data(),
             C * input_image_size,
             col_buffer_size,
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/platform/ort_mutex.h"
 #include "core/providers/cpu/nn/conv_base.h"
 #include "core/mlas/inc/mlas.h"
 
@@ -28,6 +29,16 @@ class Conv<float> : public OpKernel, public ConvBase {
 
  protected:
   MLAS_ACTIVATION activation_;
+
+ private:
+  // Returns the indirection buffer of an MLAS indirect convolution, which only depends on the input and kernel
+  // shapes. The buffer for the most recent shapes is cached as Run can be called concurrently.
+  std::shared_ptr<std::vector<size_t>> GetIndirectionBuffer(const MLAS_CONV_PARAMETERS& parameters,
+                                                            std::vector<int64_t> shape_key) const;
+
+  mutable OrtMutex indirection_mutex_;
+  mutable std::vector<int64_t> indirection_shape_key_;
+  mutable std::shared_ptr<std::vector<size_t>> indirection_buffer_;
 };
 
 }  // namespace onnxruntime
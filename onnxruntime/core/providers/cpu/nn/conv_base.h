@@ -152,6 +152,24 @@ class ConvBase {
     return Status::OK();
   }
 
+  // Returns true if the convolution maps each input pixel to the output pixel at the same position, so the
+  // input image can be used directly as the GEMM's right operand without an im2col expansion.
+  static bool IsPointwiseConv(const std::vector<int64_t>& kernel_shape,
+                              const std::vector<int64_t>& strides,
+                              const std::vector<int64_t>& pads) {
+    for (size_t i = 0; i < kernel_shape.size(); ++i) {
+      if (kernel_shape[i] != 1 || strides[i] != 1) {
+        return false;
+      }
+    }
+    for (auto pad : pads) {
+      if (pad != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   template <bool ForceSymmetricAutoPadding = false>
   Status InferOutputShape(const TensorShape& input_shape,
                           const std::vector<int64_t>& kernel_shape,
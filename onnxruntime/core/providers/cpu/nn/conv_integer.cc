@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/conv_integer.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
@@ -69,19 +70,25 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
   const auto* Xdata = X->template Data<uint8_t>();
   auto* Ydata = Y->template MutableData<int32_t>();
 
   const int64_t input_image_size = input_shape.Size();
   const int64_t output_image_size = output_shape.Size();
-  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t kernel_size = TensorShape::ReinterpretBaseType(kernel_shape).Size();
   const int64_t X_offset = C / group_ * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
   const int64_t W_offset = W->Shape().Size() / group_;
   const int64_t kernel_dim = C / group_ * kernel_size;
   const int64_t col_buffer_size = kernel_dim * output_image_size;
 
-  auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
+  // A pointwise convolution reads the input image directly as the GEMM's right operand.
+  const bool is_pointwise = IsPointwiseConv(kernel_shape, strides, pads);
+
+  auto col_data = is_pointwise ? nullptr : alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
@@ -92,21 +99,25 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
 
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
-      math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
-          Xdata + group_id * X_offset,
-          image_shape.GetDims().data(),
-          col_buffer_shape.data(),
-          C * input_image_size,
-          col_buffer_size,
-          kernel_shape.data(),
-          strides.data(),
-          dilations.data(),
-          pads.data(),
-          static_cast<int>(kernel_shape.size()),
-          col_buffer_data,
-          &CPUMathUtil::Instance(),
-          false,
-          input_offset);
+      const uint8_t* gemm_input = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance(),
+            false,
+            input_offset);
+        gemm_input = col_buffer_data;
+      }
 
       QGemmu8u8_s32(static_cast<int>(M / group_),
                     static_cast<int>(output_image_size),
@@ -114,12 +125,12 @@ Status ConvInteger::Compute(OpKernelContext* context) const {
                     W->template Data<uint8_t>() + group_id * W_offset,
                     static_cast<int>(kernel_dim),
                     filter_offset,
-                    col_buffer_data,
+                    gemm_input,
                     static_cast<int>(output_image_size),
                     input_offset,
                     Ydata + group_id * Y_offset,
                     static_cast<int>(output_image_size),
-                    nullptr);
+                    thread_pool);
     }
 
     Xdata += X_offset * group_;
@@ -17,6 +17,7 @@
 
 #include "core/providers/cpu/nn/conv_transpose.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -254,8 +255,15 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
 
   const T* Xdata = p.X->template Data<T>();
   const T* filter_data = p.F->template Data<T>();
+  const T* Bdata = p.B != nullptr ? p.B->template Data<T>() : nullptr;
   T* Ydata = p.Y->template MutableData<T>();
 
+  // Each output channel only reads its own rows of the column buffer and writes its own plane of Y, so the
+  // channels of a group are scattered in parallel, with the bias added while the plane is in cache.
+  const int64_t output_channels_per_group = p.num_output_channels / group_;
+  const int64_t col_channel_size = p.kernel_shape[0] * p.kernel_shape[1] * input_image_size;
+  const double col2im_cost = static_cast<double>(col_channel_size + output_image_size);
+
   for (auto image_id = 0; image_id < p.N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
       // Weight term
@@ -273,29 +281,39 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
           tp);
 
       // Col2im
-      math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
-          col_buffer_data,
-          p.num_output_channels / group_,
-          p.Y->Shape()[2],
-          p.Y->Shape()[3],
-          p.kernel_shape[0],
-          p.kernel_shape[1],
-          p.dilations[0],
-          p.dilations[1],
-          p.pads[0],
-          p.pads[1],
-          p.pads[2],
-          p.pads[3],
-          p.strides[0],
-          p.strides[1],
-          Ydata + group_id * Y_offset,
-          &CPUMathUtil::Instance());
-    }
-
-    if (p.B != nullptr) {
-      auto Ymatrix = EigenMatrixMap<T>(Ydata, output_image_size, p.num_output_channels);
-      auto Bvec = ConstEigenVectorMap<T>(p.B->template Data<T>(), p.num_output_channels);
-      Ymatrix.rowwise() += Bvec.transpose();
+      T* Ygroup = Ydata + group_id * Y_offset;
+      auto col2im = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        math::Col2im<T, CPUMathUtil, StorageOrder::NCHW>(
+            col_buffer_data + first * col_channel_size,
+            last - first,
+            p.Y->Shape()[2],
+            p.Y->Shape()[3],
+            p.kernel_shape[0],
+            p.kernel_shape[1],
+            p.dilations[0],
+            p.dilations[1],
+            p.pads[0],
+            p.pads[1],
+            p.pads[2],
+            p.pads[3],
+            p.strides[0],
+            p.strides[1],
+            Ygroup + first * output_image_size,
+            &CPUMathUtil::Instance());
+
+        if (Bdata != nullptr) {
+          for (std::ptrdiff_t c = first; c < last; ++c) {
+            EigenVectorArrayMap<T>(Ygroup + c * output_image_size, output_image_size) +=
+                Bdata[group_id * output_channels_per_group + c];
+          }
+        }
+      };
+
+      if (tp == nullptr) {
+        col2im(0, output_channels_per_group);
+      } else {
+        tp->ParallelFor(output_channels_per_group, col2im_cost, col2im);
+      }
     }
 
     Xdata += X_offset * group_;
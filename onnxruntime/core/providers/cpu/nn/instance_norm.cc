@@ -3,7 +3,8 @@
 
 #include "core/providers/cpu/nn/instance_norm.h"
 #include "core/providers/cpu/nn/instance_norm_helper.h"
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/mlas/inc/mlas.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -28,16 +29,12 @@ Status InstanceNorm<float>::Compute(OpKernelContext* p_op_kernel_context) const
   const TensorShape& x_shape = input->Shape();
   Tensor* Y = p_op_kernel_context->Output(0, x_shape);
 
-  for (auto i = 0; i < N * C; ++i) {
-    ConstEigenVectorArrayMap<float> Xi(input->template Data<float>() + W * i, W);
-    const float Xi_mean = Xi.mean();
-    const float squared_norm = (Xi - Xi_mean).matrix().squaredNorm();
-    const float inv_stdev = 1.0f / std::sqrt(squared_norm / W + epsilon_);
-    EigenVectorArrayMap<float> Yi(Y->template MutableData<float>() + W * i, W);
-    const float channel_scale = inv_stdev * scale->template Data<float>()[i % C];
-    const float channel_shift = B->template Data<float>()[i % C] - Xi_mean * channel_scale;
-    Yi = Xi * channel_scale + channel_shift;
-  }
+  // one pass over each channel for its mean and variance, and one to normalize it, with the channels of all the
+  // batches spread across the thread pool
+  MlasComputeInstanceNormalization(input->template Data<float>(), Y->template MutableData<float>(),
+                                   scale->template Data<float>(), B->template Data<float>(),
+                                   static_cast<size_t>(N), static_cast<size_t>(C), static_cast<size_t>(W), epsilon_,
+                                   static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool());
 
   return Status::OK();
 }
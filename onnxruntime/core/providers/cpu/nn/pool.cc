@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <functional>
+#include <numeric>
+
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/nn/pool.h"
 
@@ -8,6 +11,27 @@ using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
 
+// Runs fn for each of the total_channels channels, splitting them across the thread pool when there is one.
+template <typename F>
+static void RunOnChannels(concurrency::ThreadPool* thread_pool, int64_t total_channels, double cost_per_channel,
+                          const F& fn) {
+  if (thread_pool != nullptr) {
+    thread_pool->ParallelFor(total_channels, cost_per_channel, [&fn](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t c = first; c < last; ++c) {
+        fn(static_cast<int64_t>(c));
+      }
+    });
+    return;
+  }
+
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+  for (int64_t c = 0; c < total_channels; ++c) {
+    fn(c);
+  }
+}
+
 template <typename T, typename PoolType>
 Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -38,6 +62,9 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
   int64_t pooled_height = output_dims[2];
   int64_t pooled_width = kernel_shape.size() > 1 ? output_dims[3] : 1;
   int64_t pooled_depth = kernel_shape.size() > 2 ? output_dims[4] : 1;
+  const int64_t kernel_size = std::accumulate(kernel_shape.begin(), kernel_shape.end(), int64_t{1},
+                                              std::multiplies<int64_t>());
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
   switch (kernel_shape.size()) {
     case 1: {
@@ -45,10 +72,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
       int64_t y_step = pooled_height;
       const int64_t total_channels = x_shape[0] * channels;
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
 
@@ -67,7 +91,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
           }
           y_d[ph] = Yh;
         }
-      }
+      });
 
       break;
     }
@@ -77,10 +101,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
       int64_t y_step = pooled_height * pooled_width;
       const int64_t total_channels = x_shape[0] * channels;
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
 
@@ -108,7 +129,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
             y_d[pool_index] = Yh;
           }
         }
-      }
+      });
 
       break;
     }
@@ -117,10 +138,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
       int64_t y_step = pooled_height * pooled_width * pooled_depth;
       const int64_t total_channels = x_shape[0] * channels;
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
 
@@ -157,7 +175,7 @@ Status Pool<T, PoolType>::Compute(OpKernelContext* context) const {
             }
           }
         }
-      }
+      });
 
       break;
     }
@@ -256,6 +274,9 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
   int64_t pooled_height = output_dims[2];
   int64_t pooled_width = kernel_shape.size() > 1 ? output_dims[3] : 1;
   int64_t pooled_depth = kernel_shape.size() > 2 ? output_dims[4] : 1;
+  const int64_t kernel_size = std::accumulate(kernel_shape.begin(), kernel_shape.end(), int64_t{1},
+                                              std::multiplies<int64_t>());
+  concurrency::ThreadPool* thread_pool = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
 
   switch (kernel_shape.size()) {
     case 1: {
@@ -264,10 +285,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
       const int64_t total_channels = x_shape[0] * channels;
       const int64_t dilation_h = pool_attrs_.dilations[0];
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
         int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
@@ -287,7 +305,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
           y_d[ph] = Yh;
           if (i_d != nullptr) i_d[ph] = c * x_step + h_index;
         }
-      }
+      });
 
       break;
     }
@@ -299,10 +317,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
       const int64_t dilation_h = pool_attrs_.dilations[0];
       const int64_t dilation_w = pool_attrs_.dilations[1];
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
         int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
@@ -337,7 +352,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
                                                                : c * x_step + h_index + w_index * height;
           }
         }
-      }
+      });
 
       break;
     }
@@ -349,10 +364,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
       const int64_t dilation_w = pool_attrs_.dilations[1];
       const int64_t dilation_d = pool_attrs_.dilations[2];
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-      for (int64_t c = 0; c < total_channels; ++c) {
+      RunOnChannels(thread_pool, total_channels, static_cast<double>(y_step * kernel_size), [&](int64_t c) {
         const float* x_d = X_data + c * x_step;
         float* y_d = Y_data + c * y_step;
         int64_t* i_d = I_data ? I_data + c * y_step : nullptr;
@@ -398,7 +410,7 @@ Status Pool<float, MaxPool<8 /*VERSION*/>>::Compute(OpKernelContext* context) co
             }
           }
         }
-      }
+      });
 
       break;
     }
@@ -2,8 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 #include "core/providers/common.h"
 
 namespace onnxruntime {
@@ -50,9 +52,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_scale_data = *(result_scale->template Data<float>());
 
   const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -91,12 +90,15 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
 
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(context);
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
+
   const auto* Xdata = X->template Data<uint8_t>();
   auto* Ydata = Y->template MutableData<uint8_t>();
 
   const int64_t input_image_size = input_shape.Size();
   const int64_t output_image_size = output_shape.Size();
-  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+  const int64_t kernel_size = TensorShape::ReinterpretBaseType(kernel_shape).Size();
   const int64_t X_offset = C / group_ * input_image_size;
   const int64_t Y_offset = Y->Shape().Size() / Y->Shape()[0] / group_;
   const int64_t W_offset = W->Shape().Size() / group_;
@@ -104,10 +106,22 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   const int64_t col_buffer_size = kernel_dim * output_image_size;
   const int bias_offset = static_cast<int>(M / group_);
 
-  auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
+  // A pointwise convolution reads the input image directly as the GEMM's right operand.
+  const bool is_pointwise = IsPointwiseConv(kernel_shape, strides, pads);
+
+  auto col_data = is_pointwise ? nullptr : alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
   auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
 
+  // The 32-bit accumulators for one group, requantized to the output by the GEMM.
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * Y_offset);
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
+
+  const uint8_t input_zero_point = *input_offset->template Data<uint8_t>();
+  const uint8_t filter_zero_point = *filter_offset->template Data<uint8_t>();
+  const uint8_t result_zero_point = *result_offset->template Data<uint8_t>();
+
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
@@ -115,34 +129,42 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
 
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < group_; ++group_id) {
-      math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
-          Xdata + group_id * X_offset,
-          image_shape.GetDims().data(),
-          col_buffer_shape.data(),
-          C * input_image_size,
-          col_buffer_size,
-          kernel_shape.data(),
-          strides.data(),
-          dilations.data(),
-          pads.data(),
-          static_cast<int>(kernel_shape.size()),
-          col_buffer_data,
-          &CPUMathUtil::Instance(),
-          false,
-          *input_offset->template Data<uint8_t>());
-
-      GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
-                              Ydata + group_id * Y_offset,
-                              *filter_offset->template Data<uint8_t>(),
-                              *input_offset->template Data<uint8_t>(),
-                              *result_offset->template Data<uint8_t>(),
-                              static_cast<int>(M / group_),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+      const uint8_t* gemm_input = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance(),
+            false,
+            input_zero_point);
+        gemm_input = col_buffer_data;
+      }
+
+      QGemmu8u8_u8(static_cast<int>(M / group_),
+                   static_cast<int>(output_image_size),
+                   static_cast<int>(kernel_dim),
+                   W->template Data<uint8_t>() + group_id * W_offset,
+                   static_cast<int>(kernel_dim),
+                   filter_zero_point,
+                   gemm_input,
+                   static_cast<int>(output_image_size),
+                   input_zero_point,
+                   bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset,
+                   gemm_output,
+                   Ydata + group_id * Y_offset,
+                   static_cast<int>(output_image_size),
+                   real_multiplier,
+                   result_zero_point,
+                   thread_pool);
     }
 
     Xdata += X_offset * group_;
@@ -4,16 +4,20 @@
 #include "string_normalizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #include <locale.h>
 #endif
 
+#include <algorithm>
 #include <codecvt>
 #include <locale>
 #include <functional>
 #include <unordered_set>
+#include <vector>
 
 namespace onnxruntime {
 
@@ -101,54 +105,71 @@ const std::string default_locale("en_US.UTF-8");
 
 #endif
 
-template <class ForwardIter>
-Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
-                      const Locale& loc,
-                      std::wstring_convert<std::codecvt_utf8<wchar_t>>& converter,
-                      size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
-  std::vector<int64_t> output_dims;
-  if (N == 1) {
-    output_dims.push_back(1);
+using Converter = std::wstring_convert<std::codecvt_utf8<wchar_t>>;
+
+// Approximate cost, in cycles, of normalizing one input string.
+constexpr double kCostPerString = 256.0;
+
+// Writes s with its case changed by caseaction to output.
+Status ChangeCase(const std::string& s, const Locale& loc, Converter& converter,
+                  StringNormalizer::CaseAction caseaction, std::string& output) {
+  std::wstring wstr = converter.from_bytes(s);
+  if (wstr == wconv_error) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Input contains invalid utf8 chars at: " + s);
   }
+  // In place transform
+  loc.ChangeCase(caseaction, wstr);
+  output = converter.to_bytes(wstr);
+  return Status::OK();
+}
 
-  // Empty output case
-  if (C == 0) {
-    output_dims.push_back(1);
-    TensorShape output_shape(output_dims);
-    // This will create one empty string
-    ctx->Output(0, output_shape);
+// Splits the strings [0, count) into blocks that run on the thread pool and calls fn(first, last, converter)
+// for each block with a converter of its own, as std::wstring_convert keeps state. Returns the status of the
+// first block that failed.
+template <typename Fn>
+Status ForEachBlock(concurrency::ThreadPool* tp, size_t count, Fn fn) {
+  if (count == 0) {
     return Status::OK();
   }
 
-  output_dims.push_back(C);
-
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  auto const output_data = output_tensor->template MutableData<std::string>();
+  const std::ptrdiff_t block_count =
+      tp == nullptr ? 1 : tp->ComputeBlockCount(static_cast<std::ptrdiff_t>(count), kCostPerString);
+  std::vector<Status> statuses(block_count);
 
-  size_t output_idx = 0;
-  while (first != end) {
-    auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
-      std::wstring wstr = converter.from_bytes(s);
-      if (wstr == wconv_error) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                      "Input contains invalid utf8 chars at: " + static_cast<const std::string&>(s));
-      }
-      // In place transform
-      loc.ChangeCase(caseaction, wstr);
-      *(output_data + output_idx) = converter.to_bytes(wstr);
-    } else {
-      assert(caseaction == StringNormalizer::NONE);
-      // Simple copy or move if the iterator points to a non-const string
-      *(output_data + output_idx) = std::move(s);
+  auto run_blocks = [&](std::ptrdiff_t first_block, std::ptrdiff_t last_block) {
+    Converter converter(conv_error, wconv_error);
+    for (std::ptrdiff_t b = first_block; b < last_block; ++b) {
+      statuses[b] = fn(count * b / block_count, count * (b + 1) / block_count, converter);
     }
-    ++output_idx;
-    ++first;
+  };
+
+  if (block_count == 1) {
+    run_blocks(0, 1);
+  } else {
+    tp->ParallelFor(block_count, 0.0, run_blocks);
+  }
+
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
   }
   return Status::OK();
 }
+
+// Creates the output for count strings and returns its data.
+std::string* CreateOutput(OpKernelContext* ctx, size_t N, size_t count) {
+  std::vector<int64_t> output_dims;
+  if (N == 1) {
+    output_dims.push_back(1);
+  }
+
+  // Empty output case. This will create one empty string
+  output_dims.push_back(count == 0 ? 1 : static_cast<int64_t>(count));
+
+  TensorShape output_shape(output_dims);
+  auto output_tensor = ctx->Output(0, output_shape);
+  return output_tensor->template MutableData<std::string>();
+}
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
@@ -181,8 +202,8 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
   }
 
   locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+  locale_ = std::make_unique<Locale>(locale_name_);
+  Converter converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
   for (const auto& sw : swords) {
@@ -193,13 +214,15 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     } else {
       std::wstring wstr = converter.from_bytes(sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
+      locale_->ChangeCase(compare_caseaction_, wstr);
       auto p = wstopwords_.insert(wstr);
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -227,70 +250,68 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
                   "Input dimensions are either[C > 0] or [1][C > 0] allowed");
   }
 
-  Status status;
-  Locale locale(locale_name_);
-  std::wstring_convert<std::codecvt_utf8<wchar_t>> converter(conv_error, wconv_error);
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
   auto const input_data = X->template Data<std::string>();
-  using StrRef = std::reference_wrapper<const std::string>;
-  if (is_case_sensitive_) {
-    if (!stopwords_.empty()) {
-      std::vector<StrRef> filtered_strings;
-      filtered_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
-        if (0 == stopwords_.count(s)) {
-          filtered_strings.push_back(std::cref(s));
+  const Locale& locale = *locale_;
+
+  const bool has_stopwords = is_case_sensitive_ ? !stopwords_.empty() : !wstopwords_.empty();
+  if (!has_stopwords) {
+    // Nothing to filter. Copy input to output and change case if needed
+    auto const output_data = CreateOutput(ctx, N, C);
+    return ForEachBlock(tp, C, [&](size_t first, size_t last, Converter& converter) {
+      for (size_t i = first; i < last; ++i) {
+        if (case_change_action_ == NONE) {
+          output_data[i] = input_data[i];
+        } else {
+          ORT_RETURN_IF_ERROR(ChangeCase(input_data[i], locale, converter, case_change_action_, output_data[i]));
         }
-        ++first;
       }
-      status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
-    }
-  } else {
-    if (!wstopwords_.empty()) {
-      // Filter input. When no case action is required
-      // we simply store original string references.
-      // Otherwise, we store converted strings.
-      std::vector<StrRef> filtered_orignal_strings;
-      std::vector<std::string> filtered_cased_strings;
-      filtered_orignal_strings.reserve(C);
-      filtered_cased_strings.reserve(C);
-      auto first = input_data;
-      auto const last = input_data + C;
-      while (first != last) {
-        const std::string& s = *first;
+      return Status::OK();
+    });
+  }
+
+  // Filter input. When no case action is required the kept strings are copied from the input.
+  // Otherwise, their converted form is stored and moved to the output.
+  std::vector<uint8_t> keep(C);
+  std::vector<std::string> cased_strings(case_change_action_ == NONE ? 0 : C);
+  ORT_RETURN_IF_ERROR(ForEachBlock(tp, C, [&](size_t first, size_t last, Converter& converter) {
+    for (size_t i = first; i < last; ++i) {
+      const std::string& s = input_data[i];
+      if (is_case_sensitive_) {
+        keep[i] = 0 == stopwords_.count(s);
+        if (keep[i] && case_change_action_ != NONE) {
+          ORT_RETURN_IF_ERROR(ChangeCase(s, locale, converter, case_change_action_, cased_strings[i]));
+        }
+      } else {
         std::wstring wstr = converter.from_bytes(s);
         if (wstr == wconv_error) {
           return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                         "Input contains invalid utf8 chars at: " + s);
         }
+        // compare_caseaction_ is the same as case_change_action_ when there is one
         locale.ChangeCase(compare_caseaction_, wstr);
-        if (0 == wstopwords_.count(wstr)) {
-          if (case_change_action_ == NONE) {
-            filtered_orignal_strings.push_back(std::cref(s));
-          } else {
-            filtered_cased_strings.push_back(converter.to_bytes(wstr));
-          }
+        keep[i] = 0 == wstopwords_.count(wstr);
+        if (keep[i] && case_change_action_ != NONE) {
+          cased_strings[i] = converter.to_bytes(wstr);
         }
-        ++first;
       }
+    }
+    return Status::OK();
+  }));
+
+  const auto filtered_count = static_cast<size_t>(std::count(keep.cbegin(), keep.cend(), uint8_t{1}));
+  auto const output_data = CreateOutput(ctx, N, filtered_count);
+  size_t output_idx = 0;
+  for (size_t i = 0; i < C; ++i) {
+    if (keep[i]) {
       if (case_change_action_ == NONE) {
-        status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
+        output_data[output_idx] = input_data[i];
       } else {
-        status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+        output_data[output_idx] = std::move(cased_strings[i]);
       }
-    } else {
-      // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      ++output_idx;
     }
   }
-  return status;
+  return Status::OK();
 }
 }  // namespace onnxruntime
@@ -4,12 +4,12 @@
 #include "tfidfvectorizer.h"
 #include "onnx/defs/schema.h"
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
-#include <unordered_set>
-#include <ostream>
-#include <iterator>
 
 namespace onnxruntime {
 
@@ -42,148 +42,154 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
 
 namespace ngram_details {
 
-class NgramEntryBase {
-  size_t id_;  // Id in the pool
- protected:
-  NgramEntryBase(size_t id) : id_(id) {}
-  ~NgramEntryBase() = default;
+inline size_t HashItem(int64_t v) { return std::hash<int64_t>()(v); }
+inline size_t HashItem(const std::string& s) { return std::hash<std::string>()(s); }
 
- public:
-  size_t Id() const { return id_; }
-};
+// Extends the hash of the leading items of an n-gram with the hash of its next item.
+inline size_t CombineHash(size_t hash, size_t item_hash) {
+  return hash ^ (item_hash + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
 
-template <class T>
-class NgramEntry;
+// Final mix of MurmurHash3. std::hash of an integer is the integer itself, so the combined
+// hash is mixed before it picks a slot.
+inline uint64_t MixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
 
-template <>
-class NgramEntry<int64_t> : public NgramEntryBase {
-  std::vector<int64_t> items_;
-  size_t hash_ = 0;
+// Index of the n-grams of the pool. It is filled when the kernel is created and only read
+// afterwards, so rows may be matched concurrently.
+//
+// The items of all the n-grams are stored contiguously. The slots are open addressed with linear
+// probing and hold the index of their n-gram plus one, so a probe reads one small array and only compares
+// the items of n-grams whose hash matches. A lookup is given the combined hash of the items it
+// searches for, which lets the caller extend the hash of an n-gram by one item to look up the next size.
+template <typename TItem>
+class NgramIndex {
+ public:
+  static constexpr size_t kNotFound = SIZE_MAX;
+
+  // Adds the n-gram items[0..ngram_size) with the id ngram_id.
+  // Returns false when an equal n-gram is already in the index.
+  bool Insert(const TItem* items, size_t ngram_size, size_t ngram_id) {
+    size_t hash = 0;
+    for (size_t i = 0; i < ngram_size; ++i) {
+      hash = CombineHash(hash, HashItem(items[i]));
+    }
+    if (Find(items, ngram_size, 1, hash) != kNotFound) {
+      return false;
+    }
 
-  void RunningHash(int64_t v) {
-    std::hash<int64_t> hf{};
-    hash_ ^= hf(v) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
+    ORT_ENFORCE(entries_.size() < UINT32_MAX, "Too many n-grams in the pool.");
+    if ((entries_.size() + 1) * 2 > slots_.size()) {
+      Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+    }
+    entries_.push_back({hash, items_.size(), ngram_size, ngram_id});
+    items_.insert(items_.end(), items, items + ngram_size);
+    size_t index = static_cast<size_t>(MixHash(hash)) & mask_;
+    while (slots_[index] != 0) {
+      index = (index + 1) & mask_;
+    }
+    slots_[index] = static_cast<uint32_t>(entries_.size());
+    return true;
   }
 
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(*first);
-      ++first;
+  // Returns the id of the n-gram made of the ngram_size items first[0], first[skip_distance],
+  // first[2 * skip_distance], ... whose combined hash is hash, or kNotFound when the pool does not have it.
+  template <typename T>
+  size_t Find(const T* first, size_t ngram_size, size_t skip_distance, size_t hash) const {
+    if (entries_.empty()) {
+      return kNotFound;
+    }
+
+    for (size_t index = static_cast<size_t>(MixHash(hash)) & mask_;; index = (index + 1) & mask_) {
+      const uint32_t slot = slots_[index];
+      if (slot == 0) {
+        return kNotFound;
+      }
+      const Entry& entry = entries_[slot - 1];
+      if (entry.hash == hash && entry.ngram_size == ngram_size) {
+        const TItem* items = items_.data() + entry.offset;
+        size_t i = 0;
+        while (i < ngram_size && items[i] == first[i * skip_distance]) {
+          ++i;
+        }
+        if (i == ngram_size) {
+          return entry.ngram_id;
+        }
+      }
     }
-    assert(!items_.empty());
-  }
-  // For sampling
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(int64_t v) {
-    items_.push_back(v);
-    RunningHash(v);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<int64_t>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
-  bool operator==(const NgramEntry& o) const {
-    return items_ == o.items_;
   }
-  size_t Hash() const {
-    return hash_;
+
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  static constexpr size_t kMinCapacity = 16;
+
+  struct Entry {
+    size_t hash;
+    size_t offset;  // of the first item in items_
+    size_t ngram_size;
+    size_t ngram_id;
+  };
+
+  void Rehash(size_t capacity) {
+    slots_.assign(capacity, 0);
+    mask_ = capacity - 1;
+    for (size_t entry = 0; entry < entries_.size(); ++entry) {
+      size_t index = static_cast<size_t>(MixHash(entries_[entry].hash)) & mask_;
+      while (slots_[index] != 0) {
+        index = (index + 1) & mask_;
+      }
+      slots_[index] = static_cast<uint32_t>(entry + 1);
+    }
   }
-};
 
-template <>
-class NgramEntry<int32_t> : public NgramEntry<int64_t> {
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntry<int64_t>(id, first, last) {}
-  explicit NgramEntry() = default;
+  std::vector<uint32_t> slots_;
+  size_t mask_{0};
+  std::vector<Entry> entries_;
+  std::vector<TItem> items_;
 };
 
-template <>
-class NgramEntry<std::string> : public NgramEntryBase {
- private:
-  std::vector<std::reference_wrapper<const std::string>> items_;
-  size_t hash_ = 0;
+template <typename TItem>
+constexpr size_t NgramIndex<TItem>::kNotFound;
 
-  void RunningHash(const std::string& s) {
-    std::hash<std::string> hf{};
-    hash_ ^= hf(s) + 0x9e3779b9 + (hash_ << 6) + (hash_ >> 2);
-  }
+template <typename TItem>
+constexpr size_t NgramIndex<TItem>::kMinCapacity;
 
- public:
-  template <typename ForwardIter>
-  explicit NgramEntry(size_t id, ForwardIter first, ForwardIter last) : NgramEntryBase(id) {
-    while (first != last) {
-      RunningHash(*first);
-      items_.push_back(std::cref(*first));
-      ++first;
-    }
-    assert(!items_.empty());
-  }
-  explicit NgramEntry() : NgramEntryBase(0) {}
-  void AddItem(const std::string& s) {
-    items_.push_back(std::cref(s));
-    RunningHash(s);
-  }
-  void DebugPrint() const {
-    std::copy(items_.cbegin(), items_.cend(), std::ostream_iterator<std::string>(std::cout, ","));
-    std::cout << std::endl;
-  }
-  void Clear() {
-    items_.clear();
-    hash_ = 0;
-  }
+// Integer inputs of either width are matched against pool_int64s.
+template <typename T>
+struct PoolItem {
+  using type = int64_t;
+};
 
-  bool operator==(const NgramEntry& o) const {
-    if (items_.size() == o.items_.size()) {
-      return std::equal(items_.cbegin(), items_.cend(),
-                        o.items_.cbegin(), o.items_.cend(),
-                        std::equal_to<std::string>());
-    }
-    return false;
-  }
-  size_t Hash() const {
-    return hash_;
-  }
+template <>
+struct PoolItem<std::string> {
+  using type = std::string;
 };
 
-using IntegerPoolSet = std::unordered_set<NgramEntry<int64_t>>;
-// Does not own strings, contains references to them. This helps
-// to search by string references that point to the current input.
-using StringPoolSet = std::unordered_set<NgramEntry<std::string>>;
+// Approximate cost, in cycles, of hashing an n-gram and probing the index for it.
+constexpr double kCostPerLookup = 64.0;
 
-template <typename ForwardIter, typename Cont>
-inline void Emplace(ForwardIter first, size_t ngrams, size_t ngram_size, size_t& ngram_id, Cont& c) {
+template <typename TItem>
+inline void Emplace(const TItem* first, size_t ngrams, size_t ngram_size, size_t& ngram_id,
+                    NgramIndex<TItem>& index, size_t& duplicates) {
   for (; ngrams > 0; --ngrams) {
-    c.emplace(ngram_id, first, first + ngram_size);
+    if (!index.Insert(first, ngram_size, ngram_id)) {
+      ++duplicates;
+    }
     first += ngram_size;
     ++ngram_id;
   }
 }
 
 }  // namespace ngram_details
-}  // namespace onnxruntime
 
-using namespace onnxruntime::ngram_details;
-
-namespace std {
-template <typename T>
-struct hash<NgramEntry<T>> {
-  typedef NgramEntry<T> argument_type;
-  typedef size_t result_type;
-  result_type operator()(const argument_type& a) const {
-    return a.Hash();
-  }
-};
-}  // namespace std
-
-namespace onnxruntime {
+using namespace ngram_details;
 
 // The weighting criteria.
 // "TF"(term frequency),
@@ -219,12 +225,10 @@ struct TfIdfVectorizer::Impl {
   std::vector<int64_t> ngram_indexes_;
   std::vector<float> weights_;
 
-  std::vector<std::string> pool_strings_;
-  // This set contains references to pool_string_ entries
-  // of pool_strings attribute
-  StringPoolSet str_set_;
-  // This set contains pool_int64s entries
-  IntegerPoolSet int64_set_;
+  // The n-grams of pool_strings or pool_int64s whose size is in
+  // [min_gram_length_, max_gram_length_], only one of them is filled
+  NgramIndex<std::string> str_index_;
+  NgramIndex<int64_t> int64_index_;
   size_t output_size_ = 0;
 
   Impl() = default;
@@ -233,48 +237,89 @@ struct TfIdfVectorizer::Impl {
   Impl& operator=(const Impl&) = delete;
 
   template <typename T>
-  auto PoolEnd() const;
-
-  template <typename T>
-  auto PoolFind(const ngram_details::NgramEntry<T>&) const;
+  const NgramIndex<typename PoolItem<T>::type>& Index() const;
 
-  void IncrementCount(size_t ngram_id, size_t row_num,
-                      std::vector<uint32_t>& frequencies) const {
+  // Applies the weighting criteria to a match of ngram_id in a row of the output.
+  void Record(size_t ngram_id, float* output_row) const {
     assert(ngram_id < ngram_indexes_.size());
-    auto output_idx = row_num * output_size_ + ngram_indexes_[ngram_id];
-    assert(static_cast<size_t>(output_idx) < frequencies.size());
-    ++frequencies[output_idx];
+    float& y = output_row[ngram_indexes_[ngram_id]];
+    const float weight = (weighting_criteria_ == kTF || weights_.empty()) ? 1.0f : weights_[ngram_id];
+    if (weighting_criteria_ == kIDF) {
+      y = weight;
+    } else {
+      y += weight;
+    }
   }
+
+  // Matches the C items of row against the pool and writes the output_size_ values of output_row.
+  // item_hashes is scratch space for C hashes.
+  template <typename T>
+  void ComputeRow(const T* row, size_t C, size_t* item_hashes, float* output_row) const;
 };
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int64_t>() const {
-  return int64_set_.cend();
+inline const NgramIndex<int64_t>& TfIdfVectorizer::Impl::Index<int64_t>() const {
+  return int64_index_;
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<int32_t>() const {
-  return PoolEnd<int64_t>();
+inline const NgramIndex<int64_t>& TfIdfVectorizer::Impl::Index<int32_t>() const {
+  return int64_index_;
 }
 
 template <>
-inline auto TfIdfVectorizer::Impl::PoolEnd<std::string>() const {
-  return str_set_.cend();
+inline const NgramIndex<std::string>& TfIdfVectorizer::Impl::Index<std::string>() const {
+  return str_index_;
 }
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int64_t>(const NgramEntry<int64_t>& i) const {
-  return int64_set_.find(i);
-}
+template <typename T>
+void TfIdfVectorizer::Impl::ComputeRow(const T* row, size_t C, size_t* item_hashes, float* output_row) const {
+  using PoolIndex = NgramIndex<typename PoolItem<T>::type>;
+  const PoolIndex& index = Index<T>();
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<int32_t>(const NgramEntry<int32_t>& i) const {
-  return int64_set_.find(i);
-}
+  std::fill(output_row, output_row + output_size_, 0.0f);
 
-template <>
-inline auto TfIdfVectorizer::Impl::PoolFind<std::string>(const NgramEntry<std::string>& i) const {
-  return str_set_.find(i);
+  // Every item is hashed once and the hash of an n-gram is extended one item at a time
+  for (size_t i = 0; i < C; ++i) {
+    item_hashes[i] = HashItem(row[i]);
+  }
+
+  const size_t max_gram_length = static_cast<size_t>(max_gram_length_);
+  const size_t max_skip_distance = static_cast<size_t>(max_skip_count_) + 1;  // Convert to distance
+  size_t start_ngram_size = static_cast<size_t>(min_gram_length_);
+
+  // Treat 1-grams in a special way
+  if (start_ngram_size == 1) {
+    for (size_t i = 0; i < C; ++i) {
+      const size_t ngram_id = index.Find(row + i, 1, 1, CombineHash(0, item_hashes[i]));
+      if (ngram_id != PoolIndex::kNotFound) {
+        Record(ngram_id, output_row);
+      }
+    }
+    if (++start_ngram_size > max_gram_length) {
+      return;
+    }
+  }
+
+  for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    // Only start n-grams where at least start_ngram_size items fit before the end of the row
+    for (size_t start = 0; start + skip_distance * (start_ngram_size - 1) < C; ++start) {
+      size_t hash = 0;
+      for (size_t ngram_size = 1, item = start;
+           ngram_size <= max_gram_length && item < C;
+           ++ngram_size, item += skip_distance) {
+        hash = CombineHash(hash, item_hashes[item]);
+
+        // Do not test anything before start_ngram_size
+        if (ngram_size >= start_ngram_size) {
+          const size_t ngram_id = index.Find(row + start, ngram_size, skip_distance, hash);
+          if (ngram_id != PoolIndex::kNotFound) {
+            Record(ngram_id, output_row);
+          }
+        }
+      }
+    }
+  }
 }
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(new Impl) {
@@ -334,16 +379,17 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
   }
 
   std::vector<int64_t> pool_int64s;
-  status = info.GetAttrs("pool_strings", impl_->pool_strings_);
+  std::vector<std::string> pool_strings;
+  status = info.GetAttrs("pool_strings", pool_strings);
   if (status.IsOK()) {
-    ORT_ENFORCE(!impl_->pool_strings_.empty(), "pool_strings must not be empty if specified");
+    ORT_ENFORCE(!pool_strings.empty(), "pool_strings must not be empty if specified");
   } else {
     status = info.GetAttrs("pool_int64s", pool_int64s);
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (impl_->pool_strings_.empty()) ? pool_int64s.size() : impl_->pool_strings_.size();
+  const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
   size_t ngram_id = 0;
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = impl_->min_gram_length_;
@@ -359,16 +405,15 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       ORT_ENFORCE((items % ngram_size == 0),
                   "Number of items must compose whole ", std::to_string(ngram_size), "-grams");
       auto ngrams = items / ngram_size;
-      // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
+      // Skip loading into the index ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (impl_->pool_strings_.empty()) {
-          auto before_insert = impl_->int64_set_.size();
-          Emplace(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->int64_set_.size(), "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
+        size_t duplicates = 0;
+        if (pool_strings.empty()) {
+          Emplace(pool_int64s.data() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_index_, duplicates);
+          ORT_ENFORCE(duplicates == 0, "pool_int64s duplicate ", std::to_string(ngram_size), "-grams detected");
         } else {
-          auto before_insert = impl_->str_set_.size();
-          Emplace(impl_->pool_strings_.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_set_);
-          ORT_ENFORCE((before_insert + ngrams) == impl_->str_set_.size(), "poll_strings duplicate ", std::to_string(ngram_size), "-grams detected");
+          Emplace(pool_strings.data() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_index_, duplicates);
+          ORT_ENFORCE(duplicates == 0, "pool_strings duplicate ", std::to_string(ngram_size), "-grams detected");
         }
       } else {
         ngram_id += ngrams;
@@ -380,62 +425,9 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::vector<uint32_t>& frequences) const {
-  const Impl& impl = *impl_;
-  std::vector<int64_t> output_dims;
-  if (B == 0) {
-    output_dims.push_back(impl.output_size_);
-  } else {
-    output_dims.push_back(B);
-    output_dims.push_back(impl.output_size_);
-  }
-
-  TensorShape output_shape(output_dims);
-  assert(frequences.size() == static_cast<size_t>(output_shape.Size()));
-
-  auto Y = ctx->Output(0, output_shape);
-  auto output_data = Y->MutableData<float>();
-  const auto& w = impl.weights_;
-  switch (impl.weighting_criteria_) {
-    case kTF: {
-      for (auto f : frequences) {
-        *output_data++ = static_cast<float>(f);
-      }
-    } break;
-    case kIDF: {
-      if (!w.empty()) {
-        assert(frequences.size() == w.size());
-        for (size_t i = 0; i < frequences.size(); ++i) {
-          *output_data++ = (frequences[i] > 0) ? w[i] : 0;
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = (f > 0) ? 1.0f : 0;
-        }
-      }
-    } break;
-    case kTFIDF: {
-      if (!w.empty()) {
-        assert(frequences.size() == w.size());
-        for (size_t i = 0; i < frequences.size(); ++i) {
-          *output_data++ = frequences[i] * w[i];
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = static_cast<float>(f);
-        }
-      }
-    } break;
-    case kNone:  // fall-through
-    default:
-      assert(false);
-  }
-}
-
 template <typename T>
 Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
   const auto& impl = *impl_;
-  auto const set_end = impl.PoolEnd<T>();
 
   auto X = ctx->Input<Tensor>(0);
   auto& input_shape = X->Shape();
@@ -465,99 +457,46 @@ Status TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx) const {
                   "Input shape must have either [C] or [B,C] dimensions with B > 0.");
   }
 
-  // Frequency holder allocate [B..output_size_]
-  // and init all to zero
-  std::vector<uint32_t> frequencies;
-  frequencies.resize(b_dim * impl.output_size_, 0);
-
-  if (input_shape.Size() == 0) {
-    // TfidfVectorizer may receive an empty input when it follows a Tokenizer
-    // (for example for a string containing only stopwords).
-    // TfidfVectorizer returns a zero tensor of shape
-    // {b_dim, output_size} when b_dim is the number of received observations
-    // and output_size the is the maximum value in ngram_indexes attribute plus 1.
-    OutputResult(ctx, B, frequencies);
-    return Status::OK();
-  }
-
   assert((b_dim * C) == total_items);
 
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+  std::vector<int64_t> output_dims;
+  if (B == 0) {
+    output_dims.push_back(impl.output_size_);
+  } else {
+    output_dims.push_back(B);
+    output_dims.push_back(impl.output_size_);
+  }
+  auto Y = ctx->Output(0, TensorShape(output_dims));
+  auto output_data = Y->template MutableData<float>();
+
+  // TfidfVectorizer may receive an empty input when it follows a Tokenizer
+  // (for example for a string containing only stopwords).
+  // TfidfVectorizer returns a zero tensor of shape
+  // {b_dim, output_size} when b_dim is the number of received observations
+  // and output_size the is the maximum value in ngram_indexes attribute plus 1.
+  // ComputeRow clears every row first, so this needs no special case.
   auto const input_data = X->template Data<T>();
-  auto const end_data = input_data + total_items;
-  NgramEntry<T> sample;
+  const size_t output_size = impl.output_size_;
 
-  // Treat 1-grams in a special way
-  if (start_ngram_size == 1) {
-    size_t row_num = 0;
-    auto ngram_start = input_data;
-    while (ngram_start < end_data) {
-      auto const ngram_row_end = ngram_start + C;
-      while (ngram_start < ngram_row_end) {
-        sample.Clear();
-        sample.AddItem(*ngram_start);
-        auto hit = impl.PoolFind<T>(sample);
-        if (hit != set_end) {
-          // record frequency
-          auto ngram_id = hit->Id();
-          impl.IncrementCount(ngram_id, row_num, frequencies);
-        }
-        ++ngram_start;
-      }
-      ++row_num;
-      ngram_start = ngram_row_end;
-    }
-    if (++start_ngram_size > max_gram_length) {
-      OutputResult(ctx, B, frequencies);
-      return Status::OK();
+  // Each row writes its own row of the output
+  auto compute_rows = [&impl, input_data, output_data, C, output_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<size_t> item_hashes(C);
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      impl.ComputeRow(input_data + row * C, C, item_hashes.data(), output_data + row * output_size);
     }
-  }
+  };
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = input_data;
-    size_t row_num = 0;
-    while (ngram_start < end_data) {
-      assert((B == 0) || (row_num < B));
-      auto const ngram_row_end = ngram_start + C;
-      assert(ngram_row_end <= end_data);
-      while (ngram_start < ngram_row_end) {
-        // Check if any n-gram size in [start_ngram_size..max_gram_length] range
-        // fit before the end of the row so we do not waste time adding [1..start_ngram_size)
-        // At least items of start_ngram_size should fit
-        // last row should match end_data
-        auto at_least_this = ngram_start + skip_distance * (start_ngram_size - 1);
-        if (at_least_this >= ngram_row_end) {
-          break;
-        }
-        sample.Clear();
-        auto ngram_item = ngram_start;
-        for (auto ngram_size = 1;
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item += skip_distance) {
-          sample.AddItem(*ngram_item);
-
-          // Do not test anything before start_ngram_size
-          if (ngram_size >= start_ngram_size) {
-            auto hit = impl.PoolFind<T>(sample);
-            if (hit != set_end) {
-              // record frequency
-              auto ngram_id = hit->Id();
-              impl.IncrementCount(ngram_id, row_num, frequencies);
-            }
-          }
-        }
-        // Sliding window shift
-        ++ngram_start;
-      }
-      // Next row
-      ngram_start = ngram_row_end;
-      ++row_num;
-    }
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp == nullptr || b_dim == 1) {
+    compute_rows(0, static_cast<std::ptrdiff_t>(b_dim));
+  } else {
+    const auto lookups_per_row = C * static_cast<size_t>(impl.max_gram_length_ - impl.min_gram_length_ + 1) *
+                                 static_cast<size_t>(impl.max_skip_count_ + 1);
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(b_dim),
+                    kCostPerLookup * static_cast<double>(lookups_per_row) + static_cast<double>(output_size),
+                    compute_rows);
   }
-  OutputResult(ctx, B, frequencies);
+
   return Status::OK();
 }
 
@@ -13,7 +13,10 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 #include "non_max_suppression_helper.h"
-#include <queue>
+#include <algorithm>
+#include <vector>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -27,12 +30,10 @@ ONNX_OPERATOR_KERNEL_EX(
 
 using namespace nms_helpers;
 
-// CPU version
-namespace nms_helpers {
-Status GetThresholdsFromInputs(const PrepareContext& pc,
-                               int64_t& max_output_boxes_per_class,
-                               float& iou_threshold,
-                               float& score_threshold) {
+Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
+                                                      int64_t& max_output_boxes_per_class,
+                                                      float& iou_threshold,
+                                                      float& score_threshold) {
   if (pc.max_output_boxes_per_class_ != nullptr) {
     max_output_boxes_per_class = std::max<int64_t>(*pc.max_output_boxes_per_class_, 0);
   }
@@ -48,7 +49,6 @@ Status GetThresholdsFromInputs(const PrepareContext& pc,
 
   return Status::OK();
 }
-}  // namespace nms_helpers
 
 Status NonMaxSuppressionBase::PrepareCompute(OpKernelContext* ctx, PrepareContext& pc) {
   const auto* boxes_tensor = ctx->Input<Tensor>(0);
@@ -103,6 +103,134 @@ Status NonMaxSuppressionBase::PrepareCompute(OpKernelContext* ctx, PrepareContex
   return Status::OK();
 }
 
+namespace {
+
+// Approximate cost, in cycles, of filtering and sorting the score of one box and checking it against the
+// selected boxes of its class.
+constexpr double kCostPerBox = 64.0;
+
+// Number of selected boxes checked together before testing whether any of them suppresses the candidate.
+constexpr size_t kSuppressBlockSize = 16;
+
+// Candidates sorted by the first call to std::partial_sort. Later calls sort twice as many as the previous one.
+constexpr size_t kMinSortCount = 64;
+
+// Corners and areas of boxes, stored as structure of arrays so that the IoU between a candidate and a
+// block of selected boxes is computed by a loop without branches that the compiler vectorizes.
+struct BoxCorners {
+  void Resize(size_t count) {
+    x_min.resize(count);
+    y_min.resize(count);
+    x_max.resize(count);
+    y_max.resize(count);
+    area.resize(count);
+  }
+
+  void Set(size_t index, const float* box, int64_t center_point_box) {
+    float box_x_min, box_y_min, box_x_max, box_y_max;
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], box_x_min, box_x_max);
+      MaxMin(box[0], box[2], box_y_min, box_y_max);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      box_x_min = box[0] - width_half;
+      box_x_max = box[0] + width_half;
+      box_y_min = box[1] - height_half;
+      box_y_max = box[1] + height_half;
+    }
+    x_min[index] = box_x_min;
+    y_min[index] = box_y_min;
+    x_max[index] = box_x_max;
+    y_max[index] = box_y_max;
+    area[index] = (box_x_max - box_x_min) * (box_y_max - box_y_min);
+  }
+
+  void Append(const BoxCorners& other, size_t index) {
+    x_min.push_back(other.x_min[index]);
+    y_min.push_back(other.y_min[index]);
+    x_max.push_back(other.x_max[index]);
+    y_max.push_back(other.y_max[index]);
+    area.push_back(other.area[index]);
+  }
+
+  size_t Size() const { return area.size(); }
+
+  void Clear() {
+    x_min.clear();
+    y_min.clear();
+    x_max.clear();
+    y_max.clear();
+    area.clear();
+  }
+
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+};
+
+// Returns true when the IoU of box index of candidates with any of the selected boxes exceeds iou_threshold.
+// The tests are the same as SuppressByIOU with the selected box as the first box.
+bool SuppressedBySelected(const BoxCorners& selected, const BoxCorners& candidates, size_t index,
+                          float iou_threshold) {
+  const float x_min = candidates.x_min[index];
+  const float y_min = candidates.y_min[index];
+  const float x_max = candidates.x_max[index];
+  const float y_max = candidates.y_max[index];
+  const float area = candidates.area[index];
+  if (area <= .0f) {
+    return false;
+  }
+
+  const float* selected_x_min = selected.x_min.data();
+  const float* selected_y_min = selected.y_min.data();
+  const float* selected_x_max = selected.x_max.data();
+  const float* selected_y_max = selected.y_max.data();
+  const float* selected_area = selected.area.data();
+  const size_t selected_count = selected.Size();
+
+  for (size_t block = 0; block < selected_count; block += kSuppressBlockSize) {
+    const size_t block_end = std::min(block + kSuppressBlockSize, selected_count);
+    int suppressed = 0;
+    for (size_t i = block; i < block_end; ++i) {
+      const float intersection_x_min = std::max(selected_x_min[i], x_min);
+      const float intersection_y_min = std::max(selected_y_min[i], y_min);
+      const float intersection_x_max = std::min(selected_x_max[i], x_max);
+      const float intersection_y_max = std::min(selected_y_max[i], y_max);
+      const float intersection_area = std::max(intersection_x_max - intersection_x_min, .0f) *
+                                      std::max(intersection_y_max - intersection_y_min, .0f);
+      const float union_area = selected_area[i] + area - intersection_area;
+      suppressed |= static_cast<int>(intersection_area > .0f) & static_cast<int>(selected_area[i] > .0f) &
+                    static_cast<int>(union_area > .0f) &
+                    static_cast<int>(intersection_area / union_area > iou_threshold);
+    }
+    if (suppressed != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct ScoreIndexPair {
+  float score_{};
+  int64_t index_{};
+
+  ScoreIndexPair() = default;
+  explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+
+  // orders by descending score, keeping the lower index first for equal scores
+  bool operator<(const ScoreIndexPair& rhs) const {
+    return score_ > rhs.score_ || (score_ == rhs.score_ && index_ < rhs.index_);
+  }
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   auto ret = PrepareCompute(ctx, pc);
@@ -122,76 +250,94 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
+  const auto center_point_box = GetCenterPointBox();
+  const bool has_score_threshold = pc.score_threshold_ != nullptr;
 
-  struct ScoreIndexPair {
-    float score_{};
-    int64_t index_{};
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
 
-    ScoreIndexPair() = default;
-    explicit ScoreIndexPair(float score, int64_t idx) : score_(score), index_(idx) {}
+  // The corners of each box are computed once and shared by all the classes.
+  const size_t total_boxes = static_cast<size_t>(pc.num_batches_ * pc.num_boxes_);
+  BoxCorners corners;
+  corners.Resize(total_boxes);
+  for (size_t i = 0; i < total_boxes; ++i) {
+    corners.Set(i, boxes_data + 4 * i, center_point_box);
+  }
 
-    bool operator<(const ScoreIndexPair& rhs) const {
-      return score_ < rhs.score_;
-    }
-  };
+  // Each (batch, class) pair is selected independently into its own list, and the lists are
+  // concatenated in order afterwards so that the output doesn't depend on the threads.
+  const int64_t num_tasks = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<int64_t>> selected_per_task(static_cast<size_t>(num_tasks));
 
-  const auto center_point_box = GetCenterPointBox();
+  auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<ScoreIndexPair> candidates;
+    BoxCorners selected_corners;
+
+    for (std::ptrdiff_t task = first; task < last; ++task) {
+      const int64_t batch_index = task / pc.num_classes_;
+      const size_t box_offset = static_cast<size_t>(batch_index * pc.num_boxes_);
 
-  std::vector<SelectedIndex> selected_indices;
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      int64_t box_offset = batch_index * pc.num_boxes_ * 4;
       // Filter by score_threshold_
-      std::priority_queue<ScoreIndexPair, std::deque<ScoreIndexPair>> sorted_scores_with_index;
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
-          }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          sorted_scores_with_index.push(ScoreIndexPair(*class_scores, box_index));
+      candidates.clear();
+      const auto* class_scores = scores_data + task * pc.num_boxes_;
+      for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index) {
+        if (!has_score_threshold || class_scores[box_index] > score_threshold) {
+          candidates.emplace_back(class_scores[box_index], box_index);
         }
       }
 
-      ScoreIndexPair next_top_score;
-      std::vector<int64_t> selected_indices_inside_class;
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_scores_with_index.empty()) {
-        next_top_score = sorted_scores_with_index.top();
-        sorted_scores_with_index.pop();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (int64_t selected_index : selected_indices_inside_class) {
-          if (SuppressByIOU(boxes_data + box_offset, selected_index, next_top_score.index_,
-                            center_point_box, iou_threshold)) {
-            selected = false;
-            break;
-          }
+      std::vector<int64_t>& selected_indices_inside_class = selected_per_task[task];
+      selected_corners.Clear();
+
+      // The candidates are sorted a chunk at a time as the selection usually stops long before
+      // the lowest scores are reached.
+      auto sorted_end = candidates.begin();
+      size_t sort_count = kMinSortCount;
+      for (auto next = candidates.begin(); next != candidates.end(); ++next) {
+        if (next == sorted_end) {
+          sorted_end = next + static_cast<std::ptrdiff_t>(
+              std::min(sort_count, static_cast<size_t>(candidates.end() - next)));
+          std::partial_sort(next, sorted_end, candidates.end());
+          sort_count *= 2;
         }
 
-        if (selected) {
+        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
+        const size_t box = box_offset + static_cast<size_t>(next->index_);
+        if (!SuppressedBySelected(selected_corners, corners, box, iou_threshold)) {
+          selected_indices_inside_class.push_back(next->index_);
           if (max_output_boxes_per_class > 0 &&
               static_cast<int64_t>(selected_indices_inside_class.size()) >= max_output_boxes_per_class) {
             break;
           }
-          selected_indices_inside_class.push_back(next_top_score.index_);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          selected_corners.Append(corners, box);
         }
-      }  //while
-    }    //for class_index
-  }      //for batch_index
+      }
+    }
+  };
+
+  if (tp == nullptr) {
+    select_boxes(0, static_cast<std::ptrdiff_t>(num_tasks));
+  } else {
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(num_tasks), kCostPerBox * static_cast<double>(pc.num_boxes_),
+                    select_boxes);
+  }
+
+  size_t num_selected = 0;
+  for (const auto& selected_indices_inside_class : selected_per_task) {
+    num_selected += selected_indices_inside_class.size();
+  }
 
   const auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
-  memcpy(output->MutableData<int64_t>(), selected_indices.data(), num_selected * sizeof(SelectedIndex));
+  auto* selected_indices = reinterpret_cast<SelectedIndex*>(output->MutableData<int64_t>());
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    const int64_t batch_index = task / pc.num_classes_;
+    const int64_t class_index = task % pc.num_classes_;
+    for (int64_t box_index : selected_per_task[task]) {
+      *selected_indices++ = SelectedIndex(batch_index, class_index, box_index);
+    }
+  }
 
   return Status::OK();
 }
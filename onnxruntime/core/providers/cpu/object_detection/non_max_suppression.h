@@ -19,6 +19,12 @@ class NonMaxSuppressionBase {
 
   static Status PrepareCompute(OpKernelContext* ctx, PrepareContext& pc);
 
+  // Reads the optional inputs, which are in CPU memory, keeping the defaults of the ones that are missing.
+  static Status GetThresholdsFromInputs(const PrepareContext& pc,
+                                        int64_t& max_output_boxes_per_class,
+                                        float& iou_threshold,
+                                        float& score_threshold);
+
   int64_t GetCenterPointBox() const {
     return center_point_box_;
   }
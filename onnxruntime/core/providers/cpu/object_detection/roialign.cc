@@ -154,6 +154,9 @@ void pre_calc_for_bilinear_interpolate(
   }
 }
 
+// Approximate cost, in cycles, of one bilinear sample of one channel.
+constexpr double kCostPerSample = 8.0;
+
 template <typename T>
 void RoiAlignForward(
     int64_t nthreads,
@@ -170,58 +173,75 @@ void RoiAlignForward(
     T* top_data,
     RoiAlignMode mode,
     const int64_t* batch_indices_ptr,
-    const ThreadPool* ttp) {
+    ThreadPool* ttp) {
+  if (nthreads == 0) {
+    return;
+  }
+
   int64_t n_rois = nthreads / channels / pooled_width / pooled_height;
 
-  std::function<void(int32_t)> work_object = [&](int32_t n) {
-    int64_t index_n = n * channels * pooled_width * pooled_height;
-
-    const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
-    const auto roi_batch_ind = batch_indices_ptr[n];
-
-    // Do not using rounding; this implementation detail is critical
-    T roi_start_w = offset_bottom_rois[0] * spatial_scale;
-    T roi_start_h = offset_bottom_rois[1] * spatial_scale;
-    T roi_end_w = offset_bottom_rois[2] * spatial_scale;
-    T roi_end_h = offset_bottom_rois[3] * spatial_scale;
-
-    // Force malformed ROIs to be 1x1
-    T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
-    T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
-    T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
-    T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
-
-    // We use roi_bin_grid to sample the grid and mimic integral
-    int64_t roi_bin_grid_h = (sampling_ratio > 0)
-                                 ? sampling_ratio
-                                 : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
-    int64_t roi_bin_grid_w =
-        (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
-
-    // We do average (integral) pooling inside a bin
-    const int64_t count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
-
-    // we want to precalculate indices and weights shared by all channels,
-    // this is the key point of optimization
-    std::vector<PreCalc<T>> pre_calc(
-        roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
-    pre_calc_for_bilinear_interpolate(
-        height,
-        width,
-        pooled_height,
-        pooled_width,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        roi_start_h,
-        roi_start_w,
-        bin_size_h,
-        bin_size_w,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        pre_calc);
-
-    for (int64_t c = 0; c < channels; c++) {
-      int64_t index_n_c = index_n + c * pooled_width * pooled_height;
+  // The (roi, channel) pairs are split over the thread pool. A block of pairs computes the bilinear
+  // weights of each of its ROIs once and reuses them for all the channels of that ROI in the block.
+  auto work_object = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<PreCalc<T>> pre_calc;
+    int64_t current_n = -1;
+    int64_t roi_bin_grid_h = 0;
+    int64_t roi_bin_grid_w = 0;
+    int64_t count = 0;
+    int64_t roi_batch_ind = 0;
+
+    for (std::ptrdiff_t n_c = first; n_c < last; ++n_c) {
+      const int64_t n = n_c / channels;
+      const int64_t c = n_c % channels;
+
+      if (n != current_n) {
+        current_n = n;
+
+        const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
+        roi_batch_ind = batch_indices_ptr[n];
+
+        // Do not using rounding; this implementation detail is critical
+        T roi_start_w = offset_bottom_rois[0] * spatial_scale;
+        T roi_start_h = offset_bottom_rois[1] * spatial_scale;
+        T roi_end_w = offset_bottom_rois[2] * spatial_scale;
+        T roi_end_h = offset_bottom_rois[3] * spatial_scale;
+
+        // Force malformed ROIs to be 1x1
+        T roi_width = std::max(roi_end_w - roi_start_w, (T)1.);
+        T roi_height = std::max(roi_end_h - roi_start_h, (T)1.);
+        T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+        T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+
+        // We use roi_bin_grid to sample the grid and mimic integral
+        roi_bin_grid_h = (sampling_ratio > 0)
+                             ? sampling_ratio
+                             : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
+        roi_bin_grid_w =
+            (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
+
+        // We do average (integral) pooling inside a bin
+        count = roi_bin_grid_h * roi_bin_grid_w;  // e.g. = 4
+
+        // we want to precalculate indices and weights shared by all channels,
+        // this is the key point of optimization
+        pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
+        pre_calc_for_bilinear_interpolate(
+            height,
+            width,
+            pooled_height,
+            pooled_width,
+            roi_bin_grid_h,
+            roi_bin_grid_w,
+            roi_start_h,
+            roi_start_w,
+            bin_size_h,
+            bin_size_w,
+            roi_bin_grid_h,
+            roi_bin_grid_w,
+            pre_calc);
+      }
+
+      int64_t index_n_c = n_c * pooled_width * pooled_height;
       const T* offset_bottom_data =
           bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
       int64_t pre_calc_index = 0;
@@ -234,7 +254,7 @@ void RoiAlignForward(
           if (mode == RoiAlignMode::avg) {  // avg pooling
             for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
               for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
+                const PreCalc<T>& pc = pre_calc[pre_calc_index];
                 output_val += pc.w1 * offset_bottom_data[pc.pos1] +
                               pc.w2 * offset_bottom_data[pc.pos2] +
                               pc.w3 * offset_bottom_data[pc.pos3] +
@@ -248,11 +268,11 @@ void RoiAlignForward(
             bool max_flag = false;
             for (int64_t iy = 0; iy < roi_bin_grid_h; iy++) {
               for (int64_t ix = 0; ix < roi_bin_grid_w; ix++) {
-                PreCalc<T> pc = pre_calc[pre_calc_index];
+                const PreCalc<T>& pc = pre_calc[pre_calc_index];
                 T val = std::max(std::max(std::max(pc.w1 * offset_bottom_data[pc.pos1],
-                                            pc.w2 * offset_bottom_data[pc.pos2]),
-                                   pc.w3 * offset_bottom_data[pc.pos3]),
-                          pc.w4 * offset_bottom_data[pc.pos4]);
+                                                   pc.w2 * offset_bottom_data[pc.pos2]),
+                                          pc.w3 * offset_bottom_data[pc.pos3]),
+                                 pc.w4 * offset_bottom_data[pc.pos4]);
                 if (!max_flag) {
                   output_val = val;
                   max_flag = true;
@@ -268,9 +288,18 @@ void RoiAlignForward(
           top_data[index] = output_val;
         }  // for pw
       }    // for ph
-    }      // for c
-  };       // for n
-  if (ttp != nullptr) const_cast<ThreadPool*>(ttp)->ParallelFor(static_cast<int32_t>(n_rois), work_object);
+    }      // for n_c
+  };
+
+  const std::ptrdiff_t total = static_cast<std::ptrdiff_t>(n_rois * channels);
+  if (ttp == nullptr) {
+    work_object(0, total);
+  } else {
+    // the number of samples of a bin depends on the size of the ROI when sampling_ratio isn't set
+    const int64_t samples_per_bin = sampling_ratio > 0 ? sampling_ratio * sampling_ratio : 4;
+    ttp->ParallelFor(total, kCostPerSample * static_cast<double>(pooled_height * pooled_width * samples_per_bin),
+                     work_object);
+  }
 }
 }  // namespace
 
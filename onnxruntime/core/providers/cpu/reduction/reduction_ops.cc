@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
 using namespace std;
@@ -239,6 +241,145 @@ bool PrepareForReduce(OpKernelContext* ctx,
   return false;
 }
 
+// Input layouts that can be reduced in place, without the transpose done by PrepareForReduce.
+enum class FastReduceKind {
+  kNone,
+  kReduceTail,  // reduced axes are the trailing ones: input is a row major [kept_size, reduced_size] matrix
+  kReduceHead,  // reduced axes are the leading ones: input is a row major [reduced_size, kept_size] matrix
+};
+
+// Creates the output and returns the layout of the input if the reduced axes are contiguous at either end
+// of the input shape. Returns kNone, without creating the output, otherwise.
+static FastReduceKind PrepareForFastReduce(OpKernelContext* ctx,
+                                           Tensor** reduced_tensor,
+                                           int64_t& kept_size,
+                                           int64_t& reduced_size,
+                                           const std::vector<int64_t>& axes_,
+                                           bool keepdims_) {
+  const Tensor& input = *ctx->Input<Tensor>(0);
+  const auto& in_dims = input.Shape().GetDims();
+  const size_t ndim = in_dims.size();
+  if (ndim == 0 || input.Shape().Size() == 0) {
+    return FastReduceKind::kNone;
+  }
+
+  std::vector<bool> reduce_axis(ndim, axes_.empty());
+  for (int64_t axis : axes_) {
+    reduce_axis[HandleNegativeAxis(axis, static_cast<int64_t>(ndim))] = true;
+  }
+
+  // find the single run of reduced axes
+  size_t first = 0;
+  while (first < ndim && !reduce_axis[first]) {
+    ++first;
+  }
+  size_t last = first;
+  while (last < ndim && reduce_axis[last]) {
+    ++last;
+  }
+  if (first == ndim || std::find(reduce_axis.begin() + last, reduce_axis.end(), true) != reduce_axis.end()) {
+    return FastReduceKind::kNone;
+  }
+
+  FastReduceKind kind;
+  if (last == ndim) {
+    kind = FastReduceKind::kReduceTail;
+  } else if (first == 0) {
+    kind = FastReduceKind::kReduceHead;
+  } else {
+    return FastReduceKind::kNone;
+  }
+
+  std::vector<int64_t> reduced_dims;
+  reduced_size = 1;
+  for (size_t i = 0; i < ndim; ++i) {
+    if (reduce_axis[i]) {
+      reduced_size *= in_dims[i];
+      if (keepdims_) {
+        reduced_dims.push_back(1);
+      }
+    } else {
+      reduced_dims.push_back(in_dims[i]);
+    }
+  }
+
+  kept_size = input.Shape().Size() / reduced_size;
+  *reduced_tensor = ctx->Output(0, reduced_dims);
+  return kind;
+}
+
+// Element-wise reduction policies for FastReduce. Row() reduces a contiguous range of values, Init() and
+// Accumulate() reduce matching elements of consecutive rows.
+template <typename T>
+struct FastReduceSum {
+  static T Row(const ConstEigenVectorMap<T>& values) { return values.sum(); }
+  static void Init(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = values; }
+  static void Accumulate(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc += values; }
+};
+
+template <typename T>
+struct FastReduceSumSquare {
+  static T Row(const ConstEigenVectorMap<T>& values) { return values.squaredNorm(); }
+  static void Init(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = values.cwiseAbs2(); }
+  static void Accumulate(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc += values.cwiseAbs2(); }
+};
+
+template <typename T>
+struct FastReduceMax {
+  static T Row(const ConstEigenVectorMap<T>& values) { return values.maxCoeff(); }
+  static void Init(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = values; }
+  static void Accumulate(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = acc.cwiseMax(values); }
+};
+
+template <typename T>
+struct FastReduceMin {
+  static T Row(const ConstEigenVectorMap<T>& values) { return values.minCoeff(); }
+  static void Init(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = values; }
+  static void Accumulate(EigenVectorMap<T>& acc, const ConstEigenVectorMap<T>& values) { acc = acc.cwiseMin(values); }
+};
+
+// Reduce the input in place if the layout allows it, splitting the kept elements across the operator thread pool.
+// Returns false if the caller has to fall back to PrepareForReduce.
+template <typename T, typename Agg>
+bool FastReduce(OpKernelContext* ctx, const std::vector<int64_t>& axes_, bool keepdims_, Tensor** reduced) {
+  int64_t kept_size;
+  int64_t reduced_size;
+  FastReduceKind kind = PrepareForFastReduce(ctx, reduced, kept_size, reduced_size, axes_, keepdims_);
+  if (kind == FastReduceKind::kNone) {
+    return false;
+  }
+
+  const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
+  T* output_data = (*reduced)->template MutableData<T>();
+
+  std::function<void(std::ptrdiff_t, std::ptrdiff_t)> reduce_range;
+  if (kind == FastReduceKind::kReduceTail) {
+    reduce_range = [input_data, output_data, reduced_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        output_data[i] = Agg::Row(ConstEigenVectorMap<T>(input_data + i * reduced_size, reduced_size));
+      }
+    };
+  } else {
+    reduce_range = [input_data, output_data, reduced_size, kept_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+      const std::ptrdiff_t len = last - first;
+      EigenVectorMap<T> acc(output_data + first, len);
+      Agg::Init(acc, ConstEigenVectorMap<T>(input_data + first, len));
+      for (int64_t r = 1; r < reduced_size; ++r) {
+        Agg::Accumulate(acc, ConstEigenVectorMap<T>(input_data + r * kept_size + first, len));
+      }
+    };
+  }
+
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    reduce_range(0, kept_size);
+  } else {
+    tp->ParallelFor(kept_size, static_cast<double>(reduced_size), reduce_range);
+  }
+
+  return true;
+}
+
 template <typename T>
 Status ReduceL1<T>::Compute(OpKernelContext* ctx) const {
   std::vector<T> transposedInputData;
@@ -317,75 +458,64 @@ Status ReduceLogSumExp<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceMax<T>::Compute(OpKernelContext* ctx) const {
+  Tensor* reduced;
+  if (FastReduce<T, FastReduceMax<T>>(ctx, axes_, keepdims_, &reduced)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).maxCoeff();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().maxCoeff();
 
   return Status::OK();
 }
 
 template <typename T>
 Status ReduceMean<T>::Compute(OpKernelContext* ctx) const {
+  Tensor* reduced;
+  if (FastReduce<T, FastReduceSum<T>>(ctx, axes_, keepdims_, &reduced)) {
+    const Tensor& input = *ctx->Input<Tensor>(0);
+    const int64_t kept_size = reduced->Shape().Size();
+    EigenVectorMap<T> out_vec(reduced->template MutableData<T>(), kept_size);
+    out_vec /= static_cast<T>(input.Shape().Size() / kept_size);
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).mean();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().mean();
 
   return Status::OK();
 }
 
 template <typename T>
 Status ReduceMin<T>::Compute(OpKernelContext* ctx) const {
+  Tensor* reduced;
+  if (FastReduce<T, FastReduceMin<T>>(ctx, axes_, keepdims_, &reduced)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).minCoeff();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().minCoeff();
 
   return Status::OK();
 }
@@ -408,37 +538,34 @@ Status ReduceProd<T>::Compute(OpKernelContext* ctx) const {
 
 template <typename T>
 Status ReduceSum<T>::Compute(OpKernelContext* ctx) const {
+  Tensor* reduced;
+  if (FastReduce<T, FastReduceSum<T>>(ctx, axes_, keepdims_, &reduced)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
-  Tensor* reduced;
-  bool no_transpose = PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_, true);
+  PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
 
-  if (no_transpose) {
-    const T* input_data = ctx->Input<Tensor>(0)->template Data<T>();
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-    for (int64_t i = 0; i < block_size; ++i) {
-      output_data[i] = ConstEigenVectorMap<T>(input_data + (i * blocks), blocks).sum();
-    }
-  } else {
-    EigenVectorMap<T> out_vec(output_data, block_size);
-    out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
-  }
+  EigenVectorMap<T> out_vec(output_data, block_size);
+  out_vec = ConstEigenMatrixMap<T>(&transposedInputData[0], block_size, blocks).rowwise().sum();
 
   return Status::OK();
 }
 
 template <typename T>
 Status ReduceSumSquare<T>::Compute(OpKernelContext* ctx) const {
+  Tensor* reduced;
+  if (FastReduce<T, FastReduceSumSquare<T>>(ctx, axes_, keepdims_, &reduced)) {
+    return Status::OK();
+  }
+
   std::vector<T> transposedInputData;
   int64_t block_size;
   int64_t blocks;
-  Tensor* reduced;
   PrepareForReduce<T>(ctx, transposedInputData, &reduced, block_size, blocks, axes_, keepdims_);
 
   T* output_data = reduced->template MutableData<T>();
@@ -172,8 +172,11 @@ class UniDirectionalGru {
                     const ActivationFuncs::Entry& activation_func_g, float clip,
                     onnxruntime::concurrency::ThreadPool* ttp);
 
+  // packed_recurrent_weights_zr and packed_recurrent_weights_h are R[zr] and R[h] packed by PackWeights,
+  // or nullptr if they aren't packed.
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
                const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const PackedWeights* packed_recurrent_weights_zr, const PackedWeights* packed_recurrent_weights_h,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
@@ -322,6 +325,13 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
+  auto packed_zr = [this](int direction) {
+    return packed_recurrent_weights_zr_.empty() ? nullptr : &packed_recurrent_weights_zr_[direction];
+  };
+  auto packed_h = [this](int direction) {
+    return packed_recurrent_weights_h_.empty() ? nullptr : &packed_recurrent_weights_h_[direction];
+  };
+
   gsl::span<const T> input = X.DataAsSpan<T>();
   gsl::span<const int> sequence_lens_span = sequence_lens != nullptr ? sequence_lens->DataAsSpan<int>()
                                                                      : gsl::span<const int>();
@@ -377,7 +387,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
     fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+               packed_zr(0), packed_h(0), output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
@@ -385,7 +395,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
     bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+               packed_zr(1), packed_h(1), output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
@@ -393,7 +403,7 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
     gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+                  packed_zr(0), packed_h(0), output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -494,6 +504,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const int num_directions,
                                    const gsl::span<const T>& input_weights,
                                    const gsl::span<const T>& recurrent_weights,
+                                   const PackedWeights* packed_recurrent_weights_zr,
+                                   const PackedWeights* packed_recurrent_weights_h,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -609,13 +621,22 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
 
     // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
     // Ht-1 * R[zr] + Xt*(W[zr]^T)
-    ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                prev_Ht, prev_Ht_end,
-                hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, beta,
-                outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                hidden_size_x3, ttp_);
+    if (packed_recurrent_weights_zr != nullptr) {
+      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+                  prev_Ht, prev_Ht_end,
+                  hidden_size_,
+                  *packed_recurrent_weights_zr, beta,
+                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                  hidden_size_x3, ttp_);
+    } else {
+      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+                  prev_Ht, prev_Ht_end,
+                  hidden_size_,
+                  recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
+                  hidden_size_, beta,
+                  outputZRH_.begin() + out_added_offset, outputZRH_.end(),
+                  hidden_size_x3, ttp_);
+    }
 
     DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -625,13 +646,22 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(), batched_bias_Rh_local_end - batched_bias_Rh_local), linear_output_);
 
       // compute Ht-1 * (Rh^T) + Rbh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                  prev_Ht, prev_Ht_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
-                  linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
-                  hidden_size_, ttp_);
+      if (packed_recurrent_weights_h != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    prev_Ht, prev_Ht_end,  // Ht-1
+                    hidden_size_,
+                    *packed_recurrent_weights_h, beta,  // Rh^T
+                    linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
+                    hidden_size_, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    prev_Ht, prev_Ht_end,  // Ht-1
+                    hidden_size_,
+                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
+                    hidden_size_, beta,
+                    linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
+                    hidden_size_, ttp_);
+      }
 
       DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
     }
@@ -696,13 +726,22 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
 
       // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-      ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                  cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                  hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
-                  out_H, outputZRH_.end(),
-                  hidden_size_x3, ttp_);
+      if (packed_recurrent_weights_h != nullptr) {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    cur_h_local, cur_h_local_end,  // rt (.) Ht-1
+                    hidden_size_,
+                    *packed_recurrent_weights_h, beta,  // Rh^T
+                    out_H, outputZRH_.end(),
+                    hidden_size_x3, ttp_);
+      } else {
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    cur_h_local, cur_h_local_end,  // rt (.) Ht-1
+                    hidden_size_,
+                    recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
+                    hidden_size_, beta,
+                    out_H, outputZRH_.end(),
+                    hidden_size_x3, ttp_);
+      }
     }
 
     DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
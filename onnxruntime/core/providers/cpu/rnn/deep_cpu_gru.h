@@ -50,6 +50,25 @@ class DeepCpuGruOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // A constant R is packed once here so that each step of the recurrence can skip repacking it.
+    // R[zr] and R[h] are packed separately as they are applied by separate GEMMs.
+    const Tensor* R;
+    if (info.TryGetConstantInput(2, &R) && R->DataType() == DataTypeImpl::GetType<float>()) {
+      const auto& r_shape = R->Shape();
+      if (r_shape.NumDimensions() == 3 && r_shape[0] == num_directions_ &&
+          r_shape[1] == 3 * hidden_size_ && r_shape[2] == hidden_size_) {
+        auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+        const size_t H = static_cast<size_t>(hidden_size_);
+        packed_recurrent_weights_zr_.resize(num_directions_);
+        packed_recurrent_weights_h_.resize(num_directions_);
+        for (int i = 0; i < num_directions_; ++i) {
+          const float* R_i = R->Data<float>() + i * 3 * H * H;
+          rnn::detail::PackWeights(alloc, R_i, 2 * H, H, packed_recurrent_weights_zr_[i]);
+          rnn::detail::PackWeights(alloc, R_i + 2 * H * H, H, H, packed_recurrent_weights_h_[i]);
+        }
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -66,6 +85,10 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // R[zr] and R[h] of each direction packed by MlasSgemmPackB when R is a constant initializer
+  std::vector<rnn::detail::PackedWeights> packed_recurrent_weights_zr_;
+  std::vector<rnn::detail::PackedWeights> packed_recurrent_weights_h_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
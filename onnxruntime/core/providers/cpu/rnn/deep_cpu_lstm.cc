@@ -196,11 +196,12 @@ class UniDirectionalLstm {
                      const gsl::span<const T>& initial_hidden_state, const gsl::span<const T>& initial_cell_state,
                      const ActivationFuncs::Entry& activation_func_f, const ActivationFuncs::Entry& activation_func_g,
                      const ActivationFuncs::Entry& activation_func_h, float clip,
-                     concurrency::ThreadPool& lstm_tp_,
-                     concurrency::ThreadPool* mlas_tp_);
+                     concurrency::ThreadPool* thread_pool);
 
+  // packed_recurrent_weights is recurrent_weights packed by PackWeights, or nullptr if it isn't packed.
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
                const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const PackedWeights* packed_recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -279,8 +280,7 @@ class UniDirectionalLstm {
   ActivationInfo<deepcpu::ActivationFuncPtr> activation_g_;
   ActivationInfo<deepcpu::LstmMergeGatesFuncPtr> activation_h_;
 
-  concurrency::ThreadPool& lstm_tp_;
-  concurrency::ThreadPool* mlas_tp_;
+  concurrency::ThreadPool* thread_pool_;
 };
 
 }  // namespace detail
@@ -315,7 +315,7 @@ DeepCpuLstmOp::Compute(OpKernelContext* context) const {
 template <typename T>
 Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   auto ctx_internal = static_cast<OpKernelContextInternal*>(&context);
-  concurrency::ThreadPool* mlas_thread_pool = ctx_internal->GetOperatorThreadPool();
+  concurrency::ThreadPool* thread_pool = ctx_internal->GetOperatorThreadPool();
 
   auto& logger = context.Logger();
 
@@ -382,6 +382,9 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
       peephole_weights.empty() ? peephole_weights
                                : peephole_weights.subspan(0, peephole_weights_size_per_direction);
 
+  const rnn::detail::PackedWeights* packed_recurrent_weights_1 =
+      packed_recurrent_weights_.empty() ? nullptr : &packed_recurrent_weights_[0];
+
   gsl::span<const T> input = X.DataAsSpan<T>();
   gsl::span<const int> sequence_lens_span = sequence_lens != nullptr ? sequence_lens->DataAsSpan<int>()
                                                                      : gsl::span<const int>();
@@ -460,7 +463,7 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[0],
                                      activation_funcs_.Entries()[1],
                                      activation_funcs_.Entries()[2],
-                                     clip_, lstm_tp_, mlas_thread_pool);
+                                     clip_, thread_pool);
 
     detail::UniDirectionalLstm<T> bw(alloc, logger, seq_length, batch_size, input_size,
                                      hidden_size_, Direction::kReverse, input_forget_,
@@ -468,11 +471,12 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[3],
                                      activation_funcs_.Entries()[4],
                                      activation_funcs_.Entries()[5],
-                                     clip_, lstm_tp_, mlas_thread_pool);
+                                     clip_, thread_pool);
 
     fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1, last_cell_1);
+               packed_recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
     bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, hidden_weights_2,
+               packed_recurrent_weights_.empty() ? nullptr : &packed_recurrent_weights_[1],
                output_2, hidden_output_2, last_cell_2);
   } else {
     detail::UniDirectionalLstm<T> fw(alloc, logger, seq_length, batch_size, input_size,
@@ -481,10 +485,10 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
                                      activation_funcs_.Entries()[0],
                                      activation_funcs_.Entries()[1],
                                      activation_funcs_.Entries()[2],
-                                     clip_, lstm_tp_, mlas_thread_pool);
+                                     clip_, thread_pool);
 
     fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1, last_cell_1);
+               packed_recurrent_weights_1, output_1, hidden_output_1, last_cell_1);
   }
 
   if (!output.empty())
@@ -554,8 +558,7 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
                                           const ActivationFuncs::Entry& activation_func_g,
                                           const ActivationFuncs::Entry& activation_func_h,
                                           const float clip,
-                                          concurrency::ThreadPool& lstm_tp,
-                                          concurrency::ThreadPool* mlas_tp)
+                                          concurrency::ThreadPool* thread_pool)
     : allocator_(allocator),
       logger_(logger),
       seq_length_(seq_length),
@@ -567,8 +570,7 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
       clip_(clip),
       use_bias_(!bias.empty()),
       use_peepholes_(!peephole_weights.empty()),
-      lstm_tp_(lstm_tp),
-      mlas_tp_(mlas_tp) {
+      thread_pool_(thread_pool) {
   activation_f_ = {deepcpu::ActivationFuncByName(activation_func_f.name),
                    activation_func_f.alpha,
                    activation_func_f.beta};
@@ -722,6 +724,7 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const int num_directions,
                                     const gsl::span<const T>& input_weights,
                                     const gsl::span<const T>& recurrent_weights,
+                                    const PackedWeights* packed_recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -784,12 +787,33 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
               input_weights.cbegin(), input_weights.cend(),  // W[iofc]
               input_size_, beta,
               output_iofc_.begin(), output_iofc_.end(),
-              hidden_size_x4, mlas_tp_);
+              hidden_size_x4, thread_pool_);
 
   DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
 
   beta = 1.0f;  // calls to ComputeGemm now add to existing data
 
+  // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc] for rows of the batch, using the packed R[iofc] if there is one
+  auto recurrent_gemm = [&](int rows, span_T_const_iter previous_state, span_T_const_iter previous_state_end,
+                            span_T_iter step_out_IOFC, concurrency::ThreadPool* tp) {
+    if (packed_recurrent_weights != nullptr) {
+      ComputeGemm(rows, hidden_size_x4, hidden_size_, alpha,
+                  previous_state, previous_state_end,  // Ht-1
+                  hidden_size_,
+                  *packed_recurrent_weights, beta,  // R[iofc]
+                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                  hidden_size_x4, tp);
+    } else {
+      ComputeGemm(rows, hidden_size_x4, hidden_size_, alpha,
+                  previous_state, previous_state_end,  // Ht-1
+                  hidden_size_,
+                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
+                  hidden_size_, beta,
+                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
+                  hidden_size_x4, tp);
+    }
+  };
+
   // NOTE: we could refine the bounds checking in the calls below that use these values to instead
   // explicitly check just the range for each iteration, however if it's going to run over
   // it should also run over on the last iteration, so this should be good enough to catch any
@@ -828,13 +852,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + row) * hidden_size_x4;
 
         // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-        ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
-                    previous_state, previous_state_end,  // Ht-1
-                    hidden_size_,
-                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta,
-                    step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                    hidden_size_x4, mlas_tp_);
+        // the batch rows are already split over the thread pool, so the GEMM runs on this thread
+        recurrent_gemm(local_fused_hidden_rows, previous_state, previous_state_end, step_out_IOFC, nullptr);
 
         DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str,
                    &*step_out_IOFC, local_fused_hidden_rows, hidden_size_x4);
@@ -885,7 +904,7 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       }
     };
 
-    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, lstm_tp_, logger_);
+    ExecuteLambdaInParallel("Processing batch", hidden_gemm_and_activations, batch_size_, fused_hidden_rows, thread_pool_, logger_);
 
   } else {
     span_T_const_iter previous_state_end = batched_hidden_state_one_step.cend();
@@ -908,13 +927,7 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_) * hidden_size_x4;
 
       // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-      ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
-                  previous_state, previous_state_end,  // Ht-1
-                  hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, beta,
-                  step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4, mlas_tp_);
+      recurrent_gemm(batch_size_, previous_state, previous_state_end, step_out_IOFC, thread_pool_);
 
       span_T_iter batched_output;
       span_T_iter batched_output_end;
@@ -1124,12 +1137,8 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
 
 template <typename T>
 void UniDirectionalLstm<T>::SetNumThreads() {
-  int threads = std::thread::hardware_concurrency() - 1;
-
-  if (threads < 1)
-    threads = 1;
-
-  hidden_num_threads_ = threads;
+  // the calling thread runs one of the tasks along with the threads of the pool
+  hidden_num_threads_ = thread_pool_ != nullptr ? thread_pool_->NumThreads() + 1 : 1;
   batch_parallel_ = false;
 
   // for readability of the below logic
@@ -1137,7 +1146,7 @@ void UniDirectionalLstm<T>::SetNumThreads() {
   const auto num_columns = hidden_size_;
 
   // parallelize by partitioning the batch rows
-  if (num_rows > 4 || (num_rows >= 2 && num_columns <= 256)) {
+  if (hidden_num_threads_ > 1 && (num_rows > 4 || (num_rows >= 2 && num_columns <= 256))) {
     batch_parallel_ = true;
     VLOGS(logger_, 1) << "Hidden Threads : " << hidden_num_threads_;
   }
@@ -49,6 +49,22 @@ class DeepCpuLstmOp final : public OpKernel {
     activation_funcs_ = rnn::detail::ActivationFuncs(activation_func_names,
                                                      activation_func_alphas,
                                                      activation_func_betas);
+
+    // A constant R is packed once here so that each step of the recurrence can skip repacking it.
+    const Tensor* R;
+    if (info.TryGetConstantInput(2, &R) && R->DataType() == DataTypeImpl::GetType<float>()) {
+      const auto& r_shape = R->Shape();
+      if (r_shape.NumDimensions() == 3 && r_shape[0] == num_directions_ &&
+          r_shape[1] == 4 * hidden_size_ && r_shape[2] == hidden_size_) {
+        auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+        const size_t N = 4 * static_cast<size_t>(hidden_size_);
+        const size_t K = static_cast<size_t>(hidden_size_);
+        packed_recurrent_weights_.resize(num_directions_);
+        for (int i = 0; i < num_directions_; ++i) {
+          rnn::detail::PackWeights(alloc, R->Data<float>() + i * N * K, N, K, packed_recurrent_weights_[i]);
+        }
+      }
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -78,12 +94,8 @@ class DeepCpuLstmOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
-  // Threadpool for operator. If concurrent Compute calls are possible, it will be shared
-  // across them. mutable due to this.
-  // The alternative would be to create a threadpool in each call to Compute but that would incur thread creation
-  // cost on every call.
-  mutable onnxruntime::concurrency::ThreadPool lstm_tp_{"DEEPCPU_LSTM",
-                                                        static_cast<int>(std::thread::hardware_concurrency())};
+  // R[iofc] of each direction packed by MlasSgemmPackB when R is a constant initializer
+  std::vector<rnn::detail::PackedWeights> packed_recurrent_weights_;
 };
 
 }  // namespace onnxruntime
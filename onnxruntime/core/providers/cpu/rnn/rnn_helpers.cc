@@ -23,6 +23,18 @@ namespace detail {
 
 using namespace ::onnxruntime::common;
 
+void PackWeights(const AllocatorPtr& allocator, const float* weights, size_t N, size_t K, PackedWeights& packed) {
+  PackWeights(allocator, CblasTrans, weights, N, K, K, packed);
+}
+
+void PackWeights(const AllocatorPtr& allocator, CBLAS_TRANSPOSE trans, const float* weights, size_t N, size_t K,
+                 size_t ldb, PackedWeights& packed) {
+  packed.buffer = BufferUniquePtr(allocator->Alloc(MlasSgemmPackBSize(N, K)), BufferDeleter(allocator));
+  MlasSgemmPackB(trans, N, K, weights, ldb, packed.buffer.get());
+  packed.N = N;
+  packed.K = K;
+}
+
 Status ValidateCommonRnnInputs(const Tensor& X,
                                const Tensor& W,
                                const Tensor& R,
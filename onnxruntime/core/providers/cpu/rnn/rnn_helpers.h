@@ -8,8 +8,9 @@
 #endif
 
 #include <algorithm>
+#include <exception>
 #include <functional>
-#include <future>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,8 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -175,6 +178,50 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// Weights of N rows and K columns, used transposed as the B operand of ComputeGemm, packed once by
+// MlasSgemmPackB so that the GEMM in each step of the recurrence doesn't repack them.
+struct PackedWeights {
+  BufferUniquePtr buffer;
+  size_t N = 0;
+  size_t K = 0;
+};
+
+void PackWeights(const AllocatorPtr& allocator, const float* weights, size_t N, size_t K, PackedWeights& packed);
+
+// Packs the N x K B operand of ComputeGemm from weights with ldb elements per row, stored as N x K when trans is
+// CblasTrans or as K x N when it is CblasNoTrans.
+void PackWeights(const AllocatorPtr& allocator, CBLAS_TRANSPOSE trans, const float* weights, size_t N, size_t K,
+                 size_t ldb, PackedWeights& packed);
+
+// A has size M x K, the packed B has size N x K (transposed), and C has size M x N
+template <typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const PackedWeights& B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  // validate all the inputs
+  // need to use the lda/ldc strides which should be >= the columns for the span
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(B.N == static_cast<size_t>(N) && B.K == static_cast<size_t>(K));
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasSgemmPacked(CblasNoTrans,
+                  static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha,
+                  &*A, static_cast<size_t>(lda),
+                  B.buffer.get(), beta,
+                  &*C, static_cast<size_t>(ldc),
+                  nullptr, nullptr, tp);
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -213,7 +260,7 @@ T* SafeRawPointer(typename gsl::span<T> span, size_t offset, size_t size) {
 
 template <typename TLambda>
 void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, int step,
-                             onnxruntime::concurrency::ThreadPool& ttp,
+                             onnxruntime::concurrency::ThreadPool* ttp,
                              const ::onnxruntime::logging::Logger& logger) {
   // #define NOTHREADS to execute the lambdas directly and in order if you need to do that to debug
 
@@ -230,55 +277,37 @@ void ExecuteLambdaInParallel(const std::string& name, TLambda lambda, int max, i
   ORT_UNUSED_PARAMETER(name);
   ORT_UNUSED_PARAMETER(logger);
 
+  const int total_tasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
+
+  if (ttp == nullptr || total_tasks <= 1) {
+    for (int i = 0; i < max; i += step) {
+      lambda(i);
+    }
+    return;
+  }
+
   // ORT_ENFORCE may and does throw at times from within the tasks that run
   // on a thread-pool. Without propagating exceptions the process exits silently
   // which will make diagnosing bugs more difficult.
-
-  // \! UGLY
-  // We have a problem here with the current thread-pool is that it takes std::function
-  // by value and copies it more than once (even though it is movable).
-  //
-  // To report status and exceptions properly it's better to use
-  // futures and promises but they are not copyable, so we can't come up with a functor
-  // with a promise member and we are downgrading to C++11 where we can't have captures that moved in.
   //
-  // At the same time promises MUST live in the child thread so if we throw from the main thread
-  // we don't destroy any promises that are on the main thread stack which children threads may still be using.
-  //
-  // The only solution with the current Eigen that comes to mind is to have shared_ptr to with std::promise.
-  //
-  const int total_tasks = max / (step > 0 ? step : 1) + (max % step > 0 ? 1 : 0);
-  std::vector<std::future<void> > futures;
-  futures.reserve(total_tasks);
+  // We'd like to wait until all of the tasks have finished even though one or
+  // more have already thrown, so the first exception is stored and re-thrown on
+  // the calling thread at the end.
+  std::mutex exception_mutex;
+  std::exception_ptr pending_exception;
 
-  for (int i = 0, t = 0; i < max; i += step, ++t) {
-    auto p_ptr = std::make_shared<std::promise<void> >();
-    futures.push_back(p_ptr->get_future());
-    ttp.Schedule([p_ptr, lambda, i]() {
+  ttp->ParallelFor(static_cast<std::ptrdiff_t>(total_tasks), 0.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t t = first; t < last; ++t) {
       try {
-        lambda(i);
-        p_ptr->set_value();
+        lambda(static_cast<int>(t) * step);
       } catch (...) {
-        p_ptr->set_exception(std::current_exception());
-      }
-    });
-  }
-
-  // We'd like to wait until all of the tasks have finished
-  // even though one or more have already thrown. We will store
-  // the first exception and then will re-throw at the end.
-  std::exception_ptr pending_exception;
-  for (auto& fut : futures) {
-    try {
-      // get() will re-throw any exceptions
-      // the running task may throw
-      fut.get();
-    } catch (...) {
-      if (!pending_exception) {
-        pending_exception = std::current_exception();
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!pending_exception) {
+          pending_exception = std::current_exception();
+        }
       }
     }
-  }
+  });
 
   if (pending_exception) {
     std::rethrow_exception(pending_exception);
@@ -1,57 +1,64 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
-
-#include <sstream>
+#include <cstdio>
+#include <type_traits>
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
-#include "Eigen/src/Core/arch/GPU/Half.h"
-#include "core/common/common.h"
-
-#if defined(_M_AMD64)
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/mlas/inc/mlas.h"
-#endif
 
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 
+// Converts count elements, the range of the tensor that one thread of the cast converts.
 template <typename SrcType,
           typename DstType>
-inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<SrcType>(in->template Data<SrcType>(), shape_size);
-  auto output_vector = EigenVectorMap<DstType>(out->template MutableData<DstType>(), shape_size);
+inline void CastSpan(const SrcType* in, DstType* out, std::ptrdiff_t count) {
+  auto in_vector = ConstEigenVectorMap<SrcType>(in, count);
+  auto output_vector = EigenVectorMap<DstType>(out, count);
   output_vector = in_vector.template cast<DstType>();
 }
 
 template <>
-inline void CastData<float, MLFloat16>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<MLFloat16>();
-  auto shape_size = shape.Size();
-  auto in_vector = ConstEigenVectorMap<float>(in->template Data<float>(), shape_size);
-  auto output_vector = EigenVectorMap<Eigen::half>(static_cast<Eigen::half*>(static_cast<void*>(out_data)), shape_size);
-  output_vector = in_vector.template cast<Eigen::half>();
+inline void CastSpan<float, MLFloat16>(const float* in, MLFloat16* out, std::ptrdiff_t count) {
+  MlasConvertFloatToHalfBuffer(in, reinterpret_cast<MLAS_FP16*>(out), static_cast<size_t>(count));
 }
 
 template <>
-inline void CastData<MLFloat16, float>(const Tensor* in, Tensor* out, const TensorShape& shape) {
-  auto out_data = out->template MutableData<float>();
-  auto in_data = in->template Data<MLFloat16>();
-  auto shape_size = shape.Size();
-#if defined(_M_AMD64)
-  MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
-#else
-  auto in_vector = ConstEigenVectorMap<Eigen::half>(static_cast<const Eigen::half*>(static_cast<const void*>(in_data)), shape_size);
-  auto output_vector = EigenVectorMap<float>(out_data, shape_size);
-  output_vector = in_vector.template cast<float>();
-#endif
+inline void CastSpan<MLFloat16, float>(const MLFloat16* in, float* out, std::ptrdiff_t count) {
+  MlasConvertHalfToFloatBuffer(&in[0].val, out, static_cast<size_t>(count));
+}
+
+template <>
+inline void CastSpan<uint8_t, float>(const uint8_t* in, float* out, std::ptrdiff_t count) {
+  MlasConvertUInt8ToFloatBuffer(in, out, static_cast<size_t>(count));
+}
+
+template <typename SrcType,
+          typename DstType>
+inline void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) {
+  const auto* in_data = in->template Data<SrcType>();
+  auto* out_data = out->template MutableData<DstType>();
+  const std::ptrdiff_t shape_size = static_cast<std::ptrdiff_t>(shape.Size());
+  if (tp == nullptr) {
+    CastSpan<SrcType, DstType>(in_data, out_data, shape_size);
+    return;
+  }
+
+  // the thread pool keeps small casts on the calling thread
+  tp->ParallelFor(shape_size, static_cast<double>(sizeof(SrcType) + sizeof(DstType)),
+                  [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+                    CastSpan<SrcType, DstType>(in_data + first, out_data + first, last - first);
+                  });
 }
 
 template <typename SrcType,
           typename DstType>
-inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator) {
+inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, const AllocatorPtr& allocator,
+                            concurrency::ThreadPool* tp) {
   ORT_ENFORCE(allocator != nullptr);
   const int64_t len = shape.Size();
   ORT_ENFORCE(len > 0);
@@ -59,32 +66,68 @@ inline void CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& sh
   ORT_ENFORCE(buffer);
   Tensor tmp_tensor(DataTypeImpl::GetType<float>(), shape, buffer, allocator->Info());
   if (std::is_same<SrcType, MLFloat16>::value) {
-    CastData<MLFloat16, float>(in, &tmp_tensor, shape);  // first cast to float
-    CastData<float, DstType>(&tmp_tensor, out, shape);   // then cast to the destination type.
+    CastData<MLFloat16, float>(in, &tmp_tensor, shape, tp);  // first cast to float
+    CastData<float, DstType>(&tmp_tensor, out, shape, tp);   // then cast to the destination type.
   } else if (std::is_same<DstType, MLFloat16>::value) {
-    CastData<SrcType, float>(in, &tmp_tensor, shape);
-    CastData<float, MLFloat16>(&tmp_tensor, out, shape);
+    CastData<SrcType, float>(in, &tmp_tensor, shape, tp);
+    CastData<float, MLFloat16>(&tmp_tensor, out, shape, tp);
   }
   allocator->Free(buffer);
 }
 
+// Write value to buffer the way std::ostream formats it by default, returning the length, so the conversion
+// needs no stream and the short result fits in the inline storage of the output string.
+inline size_t FormatValue(char* buffer, size_t size, int64_t value) {
+  return static_cast<size_t>(snprintf(buffer, size, "%lld", static_cast<long long>(value)));
+}
+
+inline size_t FormatValue(char* buffer, size_t size, uint64_t value) {
+  return static_cast<size_t>(snprintf(buffer, size, "%llu", static_cast<unsigned long long>(value)));
+}
+
+inline size_t FormatValue(char* buffer, size_t size, double value) {
+  return static_cast<size_t>(snprintf(buffer, size, "%g", value));
+}
+
+template <typename SrcType>
+inline size_t FormatValue(char* buffer, size_t size, SrcType value) {
+  using FormatType = typename std::conditional<std::is_floating_point<SrcType>::value, double,
+                                               typename std::conditional<std::is_signed<SrcType>::value,
+                                                                         int64_t, uint64_t>::type>::type;
+  return FormatValue(buffer, size, static_cast<FormatType>(value));
+}
+
+// std::ostream writes the 8 bit integers as characters
+template <>
+inline size_t FormatValue<int8_t>(char* buffer, size_t, int8_t value) {
+  buffer[0] = static_cast<char>(value);
+  return 1;
+}
+
+template <>
+inline size_t FormatValue<uint8_t>(char* buffer, size_t, uint8_t value) {
+  buffer[0] = static_cast<char>(value);
+  return 1;
+}
+
 template <typename SrcType>
 inline void CastToStringData(const Tensor* in, Tensor* out, const TensorShape& shape) {
   const int64_t len = shape.Size();
   ORT_ENFORCE(len > 0);
-  for (int i = 0; i < len; ++i) {
-    if (std::is_floating_point<SrcType>::value && std::isnan(in->Data<SrcType>()[i])) {
-      out->MutableData<std::string>()[i] = "NaN";
-    } else if (std::is_floating_point<SrcType>::value && std::isinf(in->Data<SrcType>()[i])) {
-      if (in->Data<SrcType>()[i] < std::numeric_limits<SrcType>::lowest()) {
-        out->MutableData<std::string>()[i] = "-INF";
+  const SrcType* input = in->Data<SrcType>();
+  std::string* output = out->MutableData<std::string>();
+  char buffer[32];
+  for (int64_t i = 0; i < len; ++i) {
+    if (std::is_floating_point<SrcType>::value && std::isnan(input[i])) {
+      output[i] = "NaN";
+    } else if (std::is_floating_point<SrcType>::value && std::isinf(input[i])) {
+      if (input[i] < std::numeric_limits<SrcType>::lowest()) {
+        output[i] = "-INF";
       } else {
-        out->MutableData<std::string>()[i] = "INF";
+        output[i] = "INF";
       }
     } else {
-      std::ostringstream convert;
-      convert << in->Data<SrcType>()[i];
-      out->MutableData<std::string>()[i] = convert.str();
+      output[i].assign(buffer, FormatValue(buffer, sizeof(buffer), input[i]));
     }
   }
 }
@@ -168,8 +211,8 @@ class Cast final : public OpKernel {
  private:
   template <typename SrcType,
             typename DstType>
-  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape) const {
-    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape);
+  void CastData(const Tensor* in, Tensor* out, const TensorShape& shape, concurrency::ThreadPool* tp) const {
+    ::onnxruntime::CastData<SrcType, DstType>(in, out, shape, tp);
   }
 
   template <typename SrcType,
@@ -177,7 +220,8 @@ class Cast final : public OpKernel {
   Status CastFloat16Data(const Tensor* in, Tensor* out, const TensorShape& shape, OpKernelContext* context) const {
     AllocatorPtr allocator;
     ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator);
+    ::onnxruntime::CastFloat16Data<SrcType, DstType>(in, out, shape, allocator,
+                                                      static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
     return Status::OK();
   }
 
@@ -218,52 +262,53 @@ const std::vector<MLDataType> castOpTypeConstraints{
       6,                                                                                                                           \
       9,                                                                                                                           \
       in_type,                                                                                                                     \
-      KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T1", DataTypeImpl::GetTensorType<in_type>()).TypeConstraint("T2", castOpTypeConstraints), \
       Cast<in_type>);                                                                                                              \
                                                                                                                                    \
   template <>                                                                                                                      \
   Status Cast<in_type>::Compute(OpKernelContext* context) const {                                                                  \
     const Tensor* X = context->Input<Tensor>(0);                                                                                   \
     const TensorShape& shape = X->Shape();                                                                                         \
-    Tensor* Y = context->Output(0, TensorShape(shape));                                                                            \
+    Tensor* Y = context->Output(0, shape);                                                                                         \
+    concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();                         \
                                                                                                                                    \
     switch (to_) {                                                                                                                 \
       case TensorProto_DataType_BOOL:                                                                                              \
-        CastData<in_type, bool>(X, Y, shape);                                                                                      \
+        CastData<in_type, bool>(X, Y, shape, tp);                                                                                  \
         break;                                                                                                                     \
       case TensorProto_DataType_INT16:                                                                                             \
-        CastData<in_type, int16_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int16_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT32:                                                                                             \
-        CastData<in_type, int32_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int32_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_INT64:                                                                                             \
-        CastData<in_type, int64_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, int64_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT8:                                                                                             \
-        CastData<in_type, uint8_t>(X, Y, shape);                                                                                   \
+        CastData<in_type, uint8_t>(X, Y, shape, tp);                                                                               \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT16:                                                                                            \
-        CastData<in_type, uint16_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint16_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT32:                                                                                            \
-        CastData<in_type, uint32_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint32_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_UINT64:                                                                                            \
-        CastData<in_type, uint64_t>(X, Y, shape);                                                                                  \
+        CastData<in_type, uint64_t>(X, Y, shape, tp);                                                                              \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT:                                                                                             \
-        CastData<in_type, float>(X, Y, shape);                                                                                     \
+        CastData<in_type, float>(X, Y, shape, tp);                                                                                 \
         break;                                                                                                                     \
       case TensorProto_DataType_DOUBLE:                                                                                            \
-        CastData<in_type, double>(X, Y, shape);                                                                                    \
+        CastData<in_type, double>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_INT8:                                                                                              \
-        CastData<in_type, int8_t>(X, Y, shape);                                                                                    \
+        CastData<in_type, int8_t>(X, Y, shape, tp);                                                                                \
         break;                                                                                                                     \
       case TensorProto_DataType_FLOAT16:                                                                                           \
         if (std::is_same<in_type, float>::value) {                                                                                 \
-          CastData<float, MLFloat16>(X, Y, shape);                                                                                 \
+          CastData<float, MLFloat16>(X, Y, shape, tp);                                                                             \
         } else {                                                                                                                   \
           auto st = CastFloat16Data<in_type, MLFloat16>(X, Y, shape, context);                                                     \
           if (!st.IsOK()) return st;                                                                                               \
@@ -297,14 +342,14 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     6,
     9,
     MLFloat16,
-    KernelDefBuilder().TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T1", DataTypeImpl::GetTensorType<MLFloat16>()).TypeConstraint("T2", castOpTypeConstraints),
     Cast<MLFloat16>);
 
 template <>
 Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const TensorShape& shape = X->Shape();
-  Tensor* Y = context->Output(0, TensorShape(shape));
+  Tensor* Y = context->Output(0, shape);
   Status st;
   switch (to_) {
     case TensorProto_DataType_BOOL:
@@ -332,7 +377,8 @@ Status Cast<MLFloat16>::Compute(OpKernelContext* context) const {
       st = CastFloat16Data<MLFloat16, uint64_t>(X, Y, shape, context);
       break;
     case TensorProto_DataType_FLOAT:
-      CastData<MLFloat16, float>(X, Y, shape);
+      CastData<MLFloat16, float>(X, Y, shape,
+                                 static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool());
       break;
     case TensorProto_DataType_FLOAT16: {
       auto X_type = X->DataType();
@@ -374,7 +420,7 @@ Status Cast<std::string>::Compute(OpKernelContext* context) const {
   if (X == nullptr) return Status(common::ONNXRUNTIME, common::FAIL,
                                   "Input is missing. The operator Cast expects one and only one input");
   const TensorShape& shape = X->Shape();
-  Tensor* Y = context->Output(0, TensorShape(shape));
+  Tensor* Y = context->Output(0, shape);
   Status st;
   switch (to_) {
     case TensorProto_DataType_INT16:
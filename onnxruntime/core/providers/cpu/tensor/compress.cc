@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/compress.h"
+#include <algorithm>
+#include <functional>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/parallel_scan.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -25,39 +29,52 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->template Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[axis_] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  auto run = [tp](std::ptrdiff_t total, double cost_per_unit,
+                  const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+    if (tp != nullptr) {
+      tp->ParallelFor(total, cost_per_unit, fn);
+    } else {
+      fn(0, total);
     }
-  }
-
-  std::vector<int64_t> output_dims(input_dimensions);
-  if (has_axis_) {
-    output_dims[axis_] = positive_condition_count;
-  } else {
-    output_dims.resize(1);
-    output_dims[0] = positive_condition_count;
-  }
-
-  TensorShape output_shape(output_dims);
-  auto output_tensor = ctx->Output(0, output_shape);
-  if (positive_condition_count <= 0) {
-    return Status::OK();
-  }
+  };
 
   const auto* input_data = static_cast<const uint8_t*>(input_tensor->DataRaw());
-  auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->DataType() == DataTypeImpl::GetType<std::string>();
-  int64_t output_index = 0;
+
+  // copies count elements from the input to the output, both given by element index
+  auto copy_elements = [=](uint8_t* output_data, int64_t output_index, int64_t input_index, int64_t count) {
+    if (is_string_type) {
+      const auto* input_strings = reinterpret_cast<const std::string*>(input_data) + input_index;
+      std::copy(input_strings, input_strings + count, reinterpret_cast<std::string*>(output_data) + output_index);
+    } else {
+      memcpy(output_data + output_index * element_bytes, input_data + input_index * element_bytes,
+             static_cast<size_t>(count) * element_bytes);
+    }
+  };
 
   if (has_axis_) {
+    // the selected positions along the axis; each slice of the axis is copied whole
+    std::vector<int64_t> selected;
+    for (int64_t i = 0; i < valid_condition_length; ++i) {
+      if (condition_data[i]) {
+        selected.push_back(i);
+      }
+    }
+    const auto positive_condition_count = static_cast<int64_t>(selected.size());
+
+    std::vector<int64_t> output_dims(input_dimensions);
+    output_dims[axis_] = positive_condition_count;
+    auto output_tensor = ctx->Output(0, TensorShape(output_dims));
+    if (positive_condition_count <= 0) {
+      return Status::OK();
+    }
+
     int64_t axes_left_stride = 1;
     int64_t axes_right_stride = 1;
     for (int i = 0; i < axis_; ++i) {
@@ -68,45 +85,49 @@ Status Compress::Compute(OpKernelContext* ctx) const {
       axes_right_stride *= input_dimensions[i];
     }
     int64_t axes_included_right_stride = axes_right_stride * input_dimensions[axis_];
-    int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
     ORT_ENFORCE(axes_right_stride >= 0 &&
                 static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
     size_t axes_right_stride_bytes = 0;
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
-          continue;
-        }
-        if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-              reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
+
+    // output slice u is slice selected[u % count] of the outer index u / count
+    auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
+    run(axes_left_stride * positive_condition_count, static_cast<double>(axes_right_stride_bytes),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t u = first; u < last; ++u) {
+            const int64_t i = u / positive_condition_count;
+            const int64_t j = selected[u % positive_condition_count];
+            copy_elements(output_data, u * axes_right_stride,
+                          i * axes_included_right_stride + j * axes_right_stride, axes_right_stride);
           }
-          output_index += axes_right_stride;
-        } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
-        }
-      }
-    }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
+        });
+    return Status::OK();
+  }
+
+  // Compact the flattened input with a prefix sum: count the selected elements of each block of the condition,
+  // which gives every block the position of its first output element, then copy the blocks independently.
+  ParallelPrefixScan<int64_t> scan(tp, valid_condition_length, static_cast<double>(element_bytes + 1));
+  const int64_t positive_condition_count = scan.Reduce([condition_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    return static_cast<int64_t>(std::count(condition_data + first, condition_data + last, true));
+  });
+
+  auto output_tensor = ctx->Output(0, TensorShape(std::vector<int64_t>{positive_condition_count}));
+  if (positive_condition_count <= 0) {
+    return Status::OK();
+  }
+
+  auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
+  scan.Scan([&](std::ptrdiff_t first, std::ptrdiff_t last, int64_t output_index) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      if (condition_data[i]) {
+        copy_elements(output_data, output_index++, i, 1);
       }
-      ++output_index;
     }
-  }
+  });
 
-return Status::OK();
+  return Status::OK();
 }
 
 }  // namespace onnxruntime
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/concat.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 namespace onnxruntime {
 
@@ -109,41 +111,25 @@ Status Concat::Compute(OpKernelContext* ctx) const {
   if (p.output_num_elements == 0)
     return Status::OK();
 
-  auto is_string_type = ctx->Input<Tensor>(0)->DataType() == DataTypeImpl::GetType<std::string>();
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  const auto element_type = p.output_tensor->DataType();
+  const auto element_bytes = element_type->Size();
+  uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
   int64_t initial_output_offset = 0;  // initial offset for each input
-  auto element_bytes = p.output_tensor->DataType()->Size();
   for (int input_index = 0; input_index < input_count; input_index++) {
     const auto& prep = p.inputs[input_index];
     // no data in this tensor - so skip it
     if (prep.num_elements == 0)
       continue;
     auto input_axis_pitch = prep.axis_pitch;
-    const uint8_t* input = static_cast<const uint8_t*>(prep.tensor->DataRaw());
-
-    auto input_size = prep.num_elements;
 
     // Copy the data across. For every 'input_axis_pitch' values copied, we move over by the 'output_axis_pitch'
-    uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
-    int64_t cur_out_offset = 0;
-    int64_t cur_in_offset = 0;
-    for (size_t idx_copy = 0, end = input_size / input_axis_pitch; idx_copy < end; ++idx_copy) {
-      if (is_string_type) {
-        size_t out = initial_output_offset + cur_out_offset;
-        for (int idx_item = 0; idx_item < input_axis_pitch; ++idx_item) {
-          reinterpret_cast<std::string*>(output)[out + idx_item] =
-              reinterpret_cast<const std::string*>(input)[cur_in_offset + idx_item];
-        }
-      } else {
-        memcpy(
-            output + (initial_output_offset + cur_out_offset) * element_bytes,
-            input + cur_in_offset * element_bytes,
-            input_axis_pitch * element_bytes);
-      }
-
-      cur_out_offset += p.output_axis_pitch;
-      cur_in_offset += input_axis_pitch;
-    }
+    const int64_t copies = static_cast<int64_t>(prep.num_elements) / input_axis_pitch;
+    StridedCopy(tp, element_type,
+                output + initial_output_offset * element_bytes, {p.output_axis_pitch, 1},
+                prep.tensor->DataRaw(), {input_axis_pitch, 1},
+                {copies, input_axis_pitch});
 
     initial_output_offset += input_axis_pitch;
   }
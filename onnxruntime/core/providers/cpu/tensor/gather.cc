@@ -3,7 +3,11 @@
 
 //https://github.com/onnx/onnx/blob/master/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+
+#include <algorithm>
+
 #include "core/common/common.h"
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 
@@ -43,12 +47,11 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
-                      const int64_t N, const int64_t data_batch_bytes, const int64_t gathered_batch_bytes,
-                      const TensorShape& input_data_shape, const int64_t axis) {
+                      const int64_t N, const int64_t data_batch_bytes, const TensorShape& input_data_shape,
+                      const int64_t axis, concurrency::ThreadPool* tp) {
   const Tin* indices_data = indices_tensor->template Data<Tin>();
 
-  // Check the indices first in case there's a out of bound index.
-  // We can't merge this code in the omp loop below as omp does not allow return in the loop
+  // Check the indices first in case there's a out of bound index, so the copy below can't fail part way.
   for (int64_t i = 0; i < N; ++i) {
     Tin idx = indices_data[i];
     if (idx < 0 || idx >= input_data_shape[axis]) {
@@ -57,27 +60,32 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int64_t index = 0; index < M * N; ++index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+  // Row 'index' of the output is block 'indices_data[i]' of batch 'batch' of the input. The gathered rows of
+  // consecutive batches are contiguous, so row 'index' is written at index * block_size.
+  auto source = [=](std::ptrdiff_t index) {
+    const int64_t batch = index / N;
+    const int64_t i = index % N;
+    return src_base + batch * data_batch_bytes + static_cast<int64_t>(indices_data[i]) * block_size;
+  };
+
+  if (is_string_type) {
+    const int64_t block = block_size / static_cast<int64_t>(element_bytes);
+    auto copy_strings = [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t index = first; index < last; ++index) {
+        const auto* src = reinterpret_cast<const std::string*>(source(index));
+        auto* dst = reinterpret_cast<std::string*>(dst_base) + index * block;
+        std::copy(src, src + block, dst);
+      }
+    };
+    if (tp == nullptr) {
+      copy_strings(0, static_cast<std::ptrdiff_t>(M * N));
     } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, block_size);
+      tp->ParallelFor(static_cast<std::ptrdiff_t>(M * N), 64.0 * static_cast<double>(block), copy_strings);
     }
+    return Status::OK();
   }
 
+  GatherRows(dst_base, M * N, static_cast<size_t>(block_size), tp, source);
   return Status::OK();
 }
 
@@ -95,19 +103,20 @@ Status Gather::Compute(OpKernelContext* context) const {
   const int64_t M = input_data_shape.SizeToDimension(p.axis);
   const int64_t N = p.indices_tensor->Shape().Size();
   const int64_t data_batch_bytes = input_data_shape.SizeFromDimension(p.axis) * element_bytes;
-  const int64_t gathered_batch_bytes = N * block * element_bytes;
 
   const auto* src_base = static_cast<const uint8_t*>(p.input_tensor->DataRaw());
   auto* dst_base = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   MLDataType Tind_type = p.indices_tensor->DataType();
   if (Tind_type == DataTypeImpl::GetType<int32_t>()) {
     return GatherCopyData<int32_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, input_data_shape, p.axis, tp);
   }
   if (Tind_type == DataTypeImpl::GetType<int64_t>()) {
     return GatherCopyData<int64_t>(p.indices_tensor, src_base, dst_base, is_string_type, element_bytes,
-                                   block_size, M, N, data_batch_bytes, gathered_batch_bytes, input_data_shape, p.axis);
+                                   block_size, M, N, data_batch_bytes, input_data_shape, p.axis, tp);
   }
 
   return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Type for Tind not supported yet in Gather.");
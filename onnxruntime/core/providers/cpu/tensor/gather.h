@@ -3,12 +3,79 @@
 
 #pragma once
 
+#include <cstring>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
+
+#if defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define ORT_GATHER_PREFETCH(p) _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0)
+#elif defined(__GNUC__)
+#define ORT_GATHER_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define ORT_GATHER_PREFETCH(p)
+#endif
 
 namespace onnxruntime {
 
+namespace gather_detail {
+
+// Number of rows ahead of the one being copied whose source is prefetched. The rows of an embedding
+// lookup are scattered over the table, so the hardware prefetcher cannot predict them.
+constexpr std::ptrdiff_t kPrefetchDistance = 8;
+
+template <size_t RowBytes, typename TSource>
+void CopyRows(uint8_t* dst, std::ptrdiff_t first, std::ptrdiff_t last, size_t row_bytes, TSource& source) {
+  // a constant size lets the compiler replace memcpy with a single load and store
+  const size_t bytes = RowBytes != 0 ? RowBytes : row_bytes;
+  for (std::ptrdiff_t i = first; i < last; ++i) {
+    if (i + kPrefetchDistance < last) {
+      ORT_GATHER_PREFETCH(source(i + kPrefetchDistance));
+    }
+    memcpy(dst + i * bytes, source(i), bytes);
+  }
+}
+
+}  // namespace gather_detail
+
+// Copies rows [0, row_count) of row_bytes bytes each to consecutive rows of dst, where source(i) returns
+// the address of row i. The rows are split over the thread pool when there is one.
+template <typename TSource>
+void GatherRows(uint8_t* dst, int64_t row_count, size_t row_bytes, concurrency::ThreadPool* tp, TSource source) {
+  auto copy_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    switch (row_bytes) {
+      case 1:
+        gather_detail::CopyRows<1>(dst, first, last, row_bytes, source);
+        break;
+      case 2:
+        gather_detail::CopyRows<2>(dst, first, last, row_bytes, source);
+        break;
+      case 4:
+        gather_detail::CopyRows<4>(dst, first, last, row_bytes, source);
+        break;
+      case 8:
+        gather_detail::CopyRows<8>(dst, first, last, row_bytes, source);
+        break;
+      case 16:
+        gather_detail::CopyRows<16>(dst, first, last, row_bytes, source);
+        break;
+      default:
+        gather_detail::CopyRows<0>(dst, first, last, row_bytes, source);
+        break;
+    }
+  };
+
+  if (tp == nullptr) {
+    copy_rows(0, static_cast<std::ptrdiff_t>(row_count));
+  } else {
+    // the cost of a row is dominated by the cache miss on its source, plus a cycle for every byte copied
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(row_count), 64.0 + static_cast<double>(row_bytes), copy_rows);
+  }
+}
+
 class GatherBase {
  protected:
   GatherBase(const OpKernelInfo& info) {
@@ -3,10 +3,12 @@
 
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
-#include "core/util/math_cpuonly.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/util/parallel_scan.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -45,27 +47,53 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto X = context->Input<Tensor>(0);
   ORT_ENFORCE(X, "X input is required!");
 
-  const auto X_shape = X->Shape();
+  const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : X_shape.NumDimensions();
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(X_shape.Size() * coordinate_size);
-
+  const int64_t coordinate_size = X_shape.IsScalar() ? 1 : static_cast<int64_t>(X_shape.NumDimensions());
   const T* data = X->Data<T>();
 
+  // Count the non-zero values of each block of X first, which sizes the output and gives every block the
+  // column of its first non-zero value, so the blocks can then write their coordinates straight to the output.
+  auto tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  ParallelPrefixScan<int64_t> scan(tp, X_shape.Size(), static_cast<double>(sizeof(T)));
+  const int64_t num_non_zero_values = scan.Reduce([data](std::ptrdiff_t first, std::ptrdiff_t last) {
+    return static_cast<int64_t>(std::count_if(data + first, data + last, [](const T& value) { return value != T{}; }));
+  });
+
+  Tensor* const Y = context->Output(0, TensorShape{coordinate_size, num_non_zero_values});
+  ORT_ENFORCE(Y, "failed to get first output!");
+
+  // Y holds one row per dimension of X and one column per non-zero value.
+  int64_t* Y_data = Y->MutableData<int64_t>();
+  if (num_non_zero_values == 0) {
+    return Status::OK();
+  }
+
   if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
-    }
-  } else {
+    Y_data[0] = 0;
+    return Status::OK();
+  }
+
+  scan.Scan([&](std::ptrdiff_t first, std::ptrdiff_t last, int64_t column) {
+    // the coordinate of the first entry of the block
     std::vector<int64_t> coordinate(coordinate_size, 0);
+    int64_t remaining = first;
+    for (int64_t idx = coordinate_size - 1; idx >= 0; --idx) {
+      coordinate[idx] = remaining % X_shape[idx];
+      remaining /= X_shape[idx];
+    }
 
     // as we iterate the entries, increment the coordinate for the current entry
     // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      if (data[i] != T{}) {
+        for (int64_t idx = 0; idx < coordinate_size; ++idx) {
+          Y_data[idx * num_non_zero_values + column] = coordinate[idx];
+        }
+        ++column;
+      }
+
       for (int64_t idx = coordinate_size - 1; idx >= 0; --idx) {
         int64_t& cur_coord = coordinate[idx];
         if (cur_coord != X_shape[idx] - 1) {
@@ -74,34 +102,9 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
         }
         cur_coord = 0;
       }
-    };
-
-    for (size_t i = 0, end = X_shape.Size(); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
-      }
-
-      increment_coordinate();
     }
-  }
-
-  const Eigen::Index num_non_zero_values = non_zero_indices_buffer.size() / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
-
-  Tensor* const Y = context->Output(0, TensorShape{coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
-
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+  });
 
   return Status::OK();
-}  // namespace onnxruntime
+}
 }  // namespace onnxruntime
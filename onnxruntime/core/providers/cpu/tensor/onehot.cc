@@ -15,12 +15,10 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #include "core/providers/cpu/tensor/onehot.h"
-#include "core/util/eigen_common_wrapper.h"
-#include "core/platform/env.h"
+#include <algorithm>
+#include <functional>
+#include "core/framework/op_kernel_context_internal.h"
 
-#ifndef EIGEN_USE_THREADS
-#define EIGEN_USE_THREADS
-#endif
 using namespace ::onnxruntime::common;
 using namespace std;
 
@@ -70,40 +68,6 @@ Status ValidateInputs(const Tensor* depth,
   return Status::OK();
 }
 
-// Helper to define Tensor types given that the scalar is of type T.
-template <typename T, int NDIMS = 1, typename IndexType = Eigen::DenseIndex>
-struct EigenTensorTypes {
-  using EigenTensorMap = Eigen::TensorMap<Eigen::Tensor<T, NDIMS, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstEigenTensorMap = Eigen::TensorMap<Eigen::Tensor<const T, NDIMS, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using Scalar = Eigen::TensorMap<Eigen::TensorFixedSize<T, Eigen::Sizes<>, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstScalar = Eigen::TensorMap<Eigen::TensorFixedSize<const T, Eigen::Sizes<>, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-  using ConstMatrix = Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor, IndexType>, Eigen::Aligned>;
-};
-
-namespace generator {
-template <typename in_type, typename out_type>
-class OneGenerator {
- public:
-  EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE
-  OneGenerator(const typename EigenTensorTypes<in_type>::ConstMatrix& indices,
-               const typename EigenTensorTypes<out_type>::ConstScalar& on_value,
-               const typename EigenTensorTypes<out_type>::ConstScalar& off_value)
-      : indices_(indices), on_value_(on_value), off_value_(off_value) {}
-
-  EIGEN_DEVICE_FUNC EIGEN_ALWAYS_INLINE out_type
-  operator()(const Eigen::array<Eigen::DenseIndex, 3>& pre_depth_suff) const {
-    return (indices_(pre_depth_suff[0], pre_depth_suff[2]) == pre_depth_suff[1])
-               ? on_value_()
-               : off_value_();
-  }
-
- private:
-  const typename EigenTensorTypes<in_type>::ConstMatrix indices_;
-  const typename EigenTensorTypes<out_type>::ConstScalar on_value_;
-  const typename EigenTensorTypes<out_type>::ConstScalar off_value_;
-};
-}  // namespace generator
-
 template <typename in_type, typename out_type, typename depth_type>
 Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_kernel_context) const {
   const auto* indices = p_op_kernel_context->Input<Tensor>(0);
@@ -148,29 +112,56 @@ Status OneHotOp<in_type, out_type, depth_type>::Compute(OpKernelContext* p_op_ke
   for (int64_t i = 0; i < true_axis; ++i) {
     prefix_dim_size *= indices_dims[i];
   }
-  const int64_t suffix_dim_size = indices_shape.Size() / prefix_dim_size;
+  const int64_t suffix_dim_size = prefix_dim_size == 0 ? 0 : indices_shape.Size() / prefix_dim_size;
 
-  // Split indices into matrix of size prefix_dim_size x suffix_dim_size
-  Eigen::array<Eigen::DenseIndex, 2> indices_dims_e = {
-    {static_cast<Eigen::DenseIndex>(prefix_dim_size), static_cast<Eigen::DenseIndex>(suffix_dim_size)}};
+  // The indices are a prefix_dim_size x suffix_dim_size matrix and the output a
+  // prefix_dim_size x depth x suffix_dim_size tensor.
   const auto* indices_data = indices->Data<in_type>();
-  typename EigenTensorTypes<in_type, 2>::ConstEigenTensorMap indices_tensor_e(indices_data, indices_dims_e);
-
-  // Split output into 3-Tensor of size:
-  //   prefix_dim_size x depth x suffix_dim_size.
-  Eigen::array<Eigen::DenseIndex, 3> output_dims_e = {
-    {static_cast<Eigen::DenseIndex>(prefix_dim_size), static_cast<Eigen::DenseIndex>(depth_val), static_cast<Eigen::DenseIndex>(suffix_dim_size)}};
   auto* output_data = output->MutableData<out_type>();
-  typename EigenTensorTypes<out_type, 3>::EigenTensorMap output_tensor_e(output_data, output_dims_e);
-
-  typename EigenTensorTypes<out_type>::ConstScalar on_value_e(values_data + 1);
-  typename EigenTensorTypes<out_type>::ConstScalar off_value_e(values_data);
-
-  generator::OneGenerator<in_type, out_type> generator(indices_tensor_e, on_value_e, off_value_e);
-
-  // TODO potential optimization opportunity
-  // TODO figure out the eigen threadpool stuff for use here
-  output_tensor_e = output_tensor_e.generate(generator);
+  const out_type off_value = values_data[0];
+  const out_type on_value = values_data[1];
+
+  auto tp = static_cast<OpKernelContextInternal*>(p_op_kernel_context)->GetOperatorThreadPool();
+  const auto run = [tp](std::ptrdiff_t total, double cost_per_unit,
+                        const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+    if (tp != nullptr) {
+      tp->ParallelFor(total, cost_per_unit, fn);
+    } else {
+      fn(0, total);
+    }
+  };
+
+  if (suffix_dim_size == 1) {
+    // The depth axis is innermost, so each index owns one contiguous output row of depth values.
+    run(prefix_dim_size, static_cast<double>(depth_val * sizeof(out_type)),
+        [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            out_type* output_row = output_data + i * depth_val;
+            std::fill(output_row, output_row + depth_val, off_value);
+
+            const in_type index = indices_data[i];
+            if (index >= 0 && index < depth_val) {
+              const auto depth_index = static_cast<int64_t>(index);
+              if (static_cast<in_type>(depth_index) == index) {
+                output_row[depth_index] = on_value;
+              }
+            }
+          }
+        });
+  } else {
+    // Each (prefix, depth) pair selects on or off for a contiguous output row of suffix_dim_size values.
+    run(prefix_dim_size * depth_val, static_cast<double>(suffix_dim_size * (sizeof(in_type) + sizeof(out_type))),
+        [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const in_type* indices_row = indices_data + (i / depth_val) * suffix_dim_size;
+            const auto depth_index = static_cast<in_type>(i % depth_val);
+            out_type* output_row = output_data + i * suffix_dim_size;
+            for (int64_t j = 0; j < suffix_dim_size; ++j) {
+              output_row[j] = indices_row[j] == depth_index ? on_value : off_value;
+            }
+          }
+        });
+  }
 
   return Status::OK();
 }
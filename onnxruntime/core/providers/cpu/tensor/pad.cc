@@ -8,6 +8,8 @@
 #pragma warning(disable : 4996)
 #endif
 #include "core/providers/cpu/tensor/pad.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -121,7 +123,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
   input_starts.reserve(2 * new_dims_count);
   input_extents.reserve(2 * new_dims_count);
   for (size_t i = 0; i < new_dims_count; i++) {
-    input_starts.push_back(reshaped_slice[i]);
+    input_starts.push_back(-reshaped_slice[i]);
     input_extents.push_back(reshaped_input_dims[i] + reshaped_slice[i] + reshaped_slice[i + new_dims_count]);
     reshaped_output_dims[i] += reshaped_pad[i] + reshaped_pad[i + new_dims_count] + reshaped_slice[i] + reshaped_slice[i + new_dims_count];
   }
@@ -131,9 +133,6 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
   }
   TensorShape output_shape(output_dims);
 
-  TensorShape input_shape(reshaped_input_dims);
-  SliceIterator<float> input(input_tensor, input_shape, input_starts, input_extents, {});
-
   // output_shape need to keep original.
   auto& output_tensor = *ctx->Output(0, output_shape);
   auto* output = output_tensor.template MutableData<float>();
@@ -145,6 +144,16 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
   for (size_t i = 0; i < new_dims_count; i++)
     alignSkip += reshaped_pad[i] * output_pitches[i];
 
+  // Copy the input to its place in the output up front, the loops below then only write the padding around
+  // it. The edge and reflect padding read the copied data back from the output.
+  TensorPitches input_pitches(reshaped_input_dims);
+  const float* input = input_tensor.template Data<float>();
+  for (size_t i = 0; i < new_dims_count; i++)
+    input += input_starts[i] * input_pitches[i];
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  StridedCopy(tp, output + alignSkip, output_pitches, input, input_pitches, input_extents);
+
+  const int64_t inner_extent = input_extents[inner_axis];
   ExtentAxisCounters input_counters(input_extents);
 
   switch (mode) {
@@ -156,7 +165,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
         output += alignSkip;
         {
           float* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
+          output += inner_extent;
 
           int64_t prePad = reshaped_pad[inner_axis];
           int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
@@ -187,7 +196,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
         output += alignSkip;
         {
           float* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
+          output += inner_extent;
 
           int64_t prePad = reshaped_pad[inner_axis];
           int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
@@ -218,7 +227,7 @@ Status PadCpuImpl<float>(OpKernelContext* ctx,
         output += alignSkip;
         {
           float* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
+          output += inner_extent;
 
           int64_t prePad = reshaped_pad[inner_axis];
           int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/slice.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include <unordered_map>
 #include <limits>
@@ -255,16 +257,18 @@ Status SliceImpl(OpKernelContext* ctx,
   if (output_shape.Size() == 0)
     return Status::OK();
 
-  auto* output = output_tensor.template MutableData<T>();
-  const auto* output_end = output + output_tensor.Shape().Size();
-
-  SliceIterator<T> input_iterator(input_tensor, starts, output_dims, steps);
-  while (output != output_end) {
-    *output = *input_iterator;
-    ++output;
-    ++input_iterator;
+  // The slice is a strided view of the input, starting at 'starts' and moving by 'steps' along each axis
+  TensorPitches input_pitches(input_tensor);
+  std::vector<int64_t> input_strides(input_pitches.size());
+  const auto* input = input_tensor.template Data<T>();
+  for (size_t i = 0; i < input_pitches.size(); ++i) {
+    input += starts[i] * input_pitches[i];
+    input_strides[i] = steps[i] * input_pitches[i];
   }
 
+  auto tp = static_cast<OpKernelContextInternal*>(ctx)->GetOperatorThreadPool();
+  StridedCopy<T>(tp, output_tensor.template MutableData<T>(), TensorPitches(output_dims), input, input_strides, output_dims);
+
   return Status::OK();
 }
 
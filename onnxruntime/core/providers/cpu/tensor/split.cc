@@ -2,9 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/split.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
-#include "core/util/math.h"
-#include "core/util/math_cpuonly.h"
+#include "core/providers/cpu/tensor/strided_copy.h"
 
 #include "gsl/gsl_util"
 
@@ -76,17 +76,6 @@ Status Split::Compute(OpKernelContext* context) const {
   return status;
 }
 
-template <typename T>
-inline void copy_data(const T* src, T* dst, size_t count) {
-  memcpy(dst, src, count * sizeof(T));
-}
-
-template<>
-inline void copy_data<std::string>(const std::string* src, std::string* dst, size_t count) {
-  const std::string* end = src + count;
-  std::copy(src, end, dst);
-}
-
 template <typename T>
 Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
   auto& input_shape = input.Shape();
@@ -109,6 +98,7 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
   auto& input_dims = input_shape.GetDims();
   std::vector<int64_t> output_dimensions{input_dims};
 
+  auto tp = static_cast<OpKernelContextInternal*>(&context)->GetOperatorThreadPool();
   int64_t input_offset = 0;
   const T* input_data = input.template Data<T>();
 
@@ -120,16 +110,12 @@ Status Split::ComputeImpl(OpKernelContext& context, const Tensor& input) const {
     Tensor* output = context.Output(i, TensorShape{output_dimensions});
     T* output_data = output->template MutableData<T>();
 
-    ::onnxruntime::math::CopyMatrix<T>(
-        before_dims,                                       // M
-        split_size * after_dims_excluding_split,           // N
-        static_cast<const T*>(input_data + input_offset),  // A
-        after_dims_including_split_axis,                   // lda
-        static_cast<T*>(output_data),                      // B
-        split_size * after_dims_excluding_split,           // ldb
-        [](const T* src, T* dst, size_t count) {
-          copy_data<T>(src, dst, count);
-        });
+    // copy a [before_dims, N] block of the input, where N is the size of this split times the inner dims
+    const int64_t N = static_cast<int64_t>(split_size) * after_dims_excluding_split;
+    StridedCopy<T>(tp,
+                   output_data, {N, 1},
+                   input_data + input_offset, {after_dims_including_split_axis, 1},
+                   {before_dims, N});
 
     input_offset += split_size * after_dims_excluding_split;  // offset by the N data we used in this iteration
   }
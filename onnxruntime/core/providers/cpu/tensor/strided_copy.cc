@@ -0,0 +1,209 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tensor/strided_copy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace onnxruntime {
+
+namespace {
+
+// Approximate cost, in cycles, of copying one byte of a run, of assigning one std::string and of starting a run.
+constexpr double kCostPerByte = 0.125;
+constexpr double kCostPerString = 64.0;
+constexpr double kCostPerRun = 16.0;
+
+// Contiguous runs longer than this are split into segments that may be copied on different threads.
+constexpr int64_t kSegmentBytes = 256 * 1024;
+
+struct CopyAxis {
+  int64_t extent;
+  int64_t src_stride;
+  int64_t dst_stride;
+};
+
+// Returns the axes of the region from the outermost, without the axes of extent 1 and with every axis merged
+// into the next inner one when both tensors are contiguous across them. There is always at least one axis.
+std::vector<CopyAxis> CoalesceAxes(const std::vector<int64_t>& shape,
+                                   const std::vector<int64_t>& src_strides,
+                                   const std::vector<int64_t>& dst_strides) {
+  std::vector<CopyAxis> axes;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] == 1) {
+      continue;
+    }
+
+    CopyAxis axis{shape[i], src_strides[i], dst_strides[i]};
+    if (!axes.empty()) {
+      const CopyAxis& outer = axes.back();
+      if (outer.src_stride == axis.src_stride * axis.extent && outer.dst_stride == axis.dst_stride * axis.extent) {
+        axis.extent *= outer.extent;
+        axes.pop_back();
+      }
+    }
+    axes.push_back(axis);
+  }
+
+  if (axes.empty()) {
+    axes.push_back({1, 1, 1});
+  }
+  return axes;
+}
+
+template <typename U>
+inline void CopyContiguous(U* dst, const U* src, int64_t count) {
+  memcpy(dst, src, static_cast<size_t>(count) * sizeof(U));
+}
+
+inline void CopyContiguous(std::string* dst, const std::string* src, int64_t count) {
+  std::copy(src, src + count, dst);
+}
+
+template <typename U>
+inline void CopyElement(U* dst, const U* src) {
+  // memcpy of a fixed size avoids reading the elements through a type other than their own
+  memcpy(dst, src, sizeof(U));
+}
+
+inline void CopyElement(std::string* dst, const std::string* src) {
+  *dst = *src;
+}
+
+template <typename U>
+void CopyRun(U* dst, const U* src, int64_t count, int64_t dst_stride, int64_t src_stride) {
+  if (dst_stride == 1 && src_stride == 1) {
+    CopyContiguous(dst, src, count);
+    return;
+  }
+  for (int64_t i = 0; i < count; ++i) {
+    CopyElement(dst, src);
+    dst += dst_stride;
+    src += src_stride;
+  }
+}
+
+// Copies the region described by axes, whose innermost axis is copied as runs and the outer ones
+// are iterated over. Each unit of work is one run, or one segment of a long contiguous run.
+template <typename U>
+void CopyRegion(concurrency::ThreadPool* tp, U* dst, const U* src,
+                const std::vector<CopyAxis>& axes, double cost_per_element) {
+  const CopyAxis& inner = axes.back();
+  const size_t outer_rank = axes.size() - 1;
+
+  int64_t outer_count = 1;
+  for (size_t axis = 0; axis < outer_rank; ++axis) {
+    outer_count *= axes[axis].extent;
+  }
+
+  const bool contiguous = inner.src_stride == 1 && inner.dst_stride == 1;
+  const int64_t segment_length = contiguous
+                                     ? std::max<int64_t>(kSegmentBytes / static_cast<int64_t>(sizeof(U)), 1)
+                                     : inner.extent;
+  const int64_t segments = (inner.extent + segment_length - 1) / segment_length;
+
+  auto copy_units = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // position of the run of the first unit
+    std::vector<int64_t> index(outer_rank);
+    int64_t src_offset = 0;
+    int64_t dst_offset = 0;
+    int64_t outer = first / segments;
+    int64_t segment = first % segments;
+    for (size_t axis = outer_rank; axis-- > 0;) {
+      index[axis] = outer % axes[axis].extent;
+      outer /= axes[axis].extent;
+      src_offset += index[axis] * axes[axis].src_stride;
+      dst_offset += index[axis] * axes[axis].dst_stride;
+    }
+
+    for (std::ptrdiff_t unit = first; unit < last; ++unit) {
+      const int64_t begin = segment * segment_length;
+      const int64_t count = std::min(segment_length, inner.extent - begin);
+      CopyRun(dst + dst_offset + begin * inner.dst_stride, src + src_offset + begin * inner.src_stride,
+              count, inner.dst_stride, inner.src_stride);
+
+      if (++segment == segments) {
+        segment = 0;
+        for (size_t axis = outer_rank; axis-- > 0;) {
+          src_offset += axes[axis].src_stride;
+          dst_offset += axes[axis].dst_stride;
+          if (++index[axis] < axes[axis].extent) {
+            break;
+          }
+          src_offset -= axes[axis].src_stride * axes[axis].extent;
+          dst_offset -= axes[axis].dst_stride * axes[axis].extent;
+          index[axis] = 0;
+        }
+      }
+    }
+  };
+
+  const std::ptrdiff_t units = static_cast<std::ptrdiff_t>(outer_count * segments);
+  if (tp == nullptr || units == 1) {
+    copy_units(0, units);
+  } else {
+    const double cost_per_unit = static_cast<double>(std::min(segment_length, inner.extent)) * cost_per_element +
+                                 kCostPerRun;
+    tp->ParallelFor(units, cost_per_unit, copy_units);
+  }
+}
+
+}  // namespace
+
+void StridedCopy(concurrency::ThreadPool* tp, MLDataType element_type,
+                 void* dst, const std::vector<int64_t>& dst_strides,
+                 const void* src, const std::vector<int64_t>& src_strides,
+                 const std::vector<int64_t>& shape) {
+  ORT_ENFORCE(dst_strides.size() == shape.size() && src_strides.size() == shape.size(),
+              "StridedCopy expects a stride for every axis of the region");
+  if (std::find(shape.cbegin(), shape.cend(), 0) != shape.cend()) {
+    return;
+  }
+
+  if (element_type == DataTypeImpl::GetType<std::string>()) {
+    CopyRegion(tp, static_cast<std::string*>(dst), static_cast<const std::string*>(src),
+               CoalesceAxes(shape, src_strides, dst_strides), kCostPerString);
+    return;
+  }
+
+  const size_t element_size = element_type->Size();
+  switch (element_size) {
+    case 1:
+      CopyRegion(tp, static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src),
+                 CoalesceAxes(shape, src_strides, dst_strides), kCostPerByte);
+      break;
+    case 2:
+      CopyRegion(tp, static_cast<uint16_t*>(dst), static_cast<const uint16_t*>(src),
+                 CoalesceAxes(shape, src_strides, dst_strides), 2 * kCostPerByte);
+      break;
+    case 4:
+      CopyRegion(tp, static_cast<uint32_t*>(dst), static_cast<const uint32_t*>(src),
+                 CoalesceAxes(shape, src_strides, dst_strides), 4 * kCostPerByte);
+      break;
+    case 8:
+      CopyRegion(tp, static_cast<uint64_t*>(dst), static_cast<const uint64_t*>(src),
+                 CoalesceAxes(shape, src_strides, dst_strides), 8 * kCostPerByte);
+      break;
+    default: {
+      // copy other sizes as bytes, with the bytes of an element as the innermost axis
+      std::vector<int64_t> byte_shape(shape);
+      std::vector<int64_t> byte_src_strides(src_strides);
+      std::vector<int64_t> byte_dst_strides(dst_strides);
+      const int64_t size = static_cast<int64_t>(element_size);
+      for (size_t axis = 0; axis < shape.size(); ++axis) {
+        byte_src_strides[axis] *= size;
+        byte_dst_strides[axis] *= size;
+      }
+      byte_shape.push_back(size);
+      byte_src_strides.push_back(1);
+      byte_dst_strides.push_back(1);
+      CopyRegion(tp, static_cast<uint8_t*>(dst), static_cast<const uint8_t*>(src),
+                 CoalesceAxes(byte_shape, byte_src_strides, byte_dst_strides), kCostPerByte);
+      break;
+    }
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Copies a region of shape elements from src to dst, where src_strides and dst_strides hold the distance in
+// elements between consecutive positions along each axis of the region. Strides may be zero, to repeat the
+// same source elements, or negative. src and dst must not overlap.
+//
+// Axes of extent 1 are dropped and an axis is merged into the next inner one when neither tensor has a gap
+// between them, so the innermost contiguous runs are as long as possible and are copied with memcpy. When there
+// are enough bytes to copy, the runs, and long runs themselves, are split over the thread pool if there is one.
+//
+// Fixed size element types are copied by their size, std::string elements by assignment.
+void StridedCopy(concurrency::ThreadPool* tp, MLDataType element_type,
+                 void* dst, const std::vector<int64_t>& dst_strides,
+                 const void* src, const std::vector<int64_t>& src_strides,
+                 const std::vector<int64_t>& shape);
+
+template <typename T>
+inline void StridedCopy(concurrency::ThreadPool* tp,
+                        T* dst, const std::vector<int64_t>& dst_strides,
+                        const T* src, const std::vector<int64_t>& src_strides,
+                        const std::vector<int64_t>& shape) {
+  StridedCopy(tp, DataTypeImpl::GetType<T>(), dst, dst_strides, src, src_strides, shape);
+}
+
+}  // namespace onnxruntime
@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/tensor/transpose.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
@@ -175,7 +177,112 @@ static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& tar
   }
 }
 
-static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+bool TransposeBase::IsBatchedTranspose2D(const std::vector<size_t>& permutations,
+                                         const std::vector<int64_t>& input_dims,
+                                         size_t& batch_count, size_t& rows, size_t& cols,
+                                         size_t& elements_per_item) {
+  const size_t rank = permutations.size();
+
+  // Number the input axes that are not of size one.
+  std::vector<int64_t> compact_axis(rank, -1);
+  int64_t compact_rank = 0;
+  for (size_t i = 0; i < rank; ++i) {
+    if (input_dims[i] != 1) {
+      compact_axis[i] = compact_rank++;
+    }
+  }
+
+  // Walk the output axes, merging an axis into the previous group if it follows it in the input.
+  std::vector<int64_t> group_start;
+  std::vector<size_t> group_size;
+  int64_t previous = -2;
+  for (size_t i = 0; i < rank; ++i) {
+    const int64_t axis = compact_axis[permutations[i]];
+    if (axis < 0) {
+      continue;
+    }
+    if (axis == previous + 1) {
+      group_size.back() *= static_cast<size_t>(input_dims[permutations[i]]);
+    } else {
+      group_start.push_back(axis);
+      group_size.push_back(static_cast<size_t>(input_dims[permutations[i]]));
+    }
+    previous = axis;
+  }
+
+  batch_count = 1;
+  elements_per_item = 1;
+
+  // The groups are listed in output order, so an output group order of (1, 0) is a plain transpose, (0, 2, 1)
+  // adds a leading batch, (1, 0, 2) adds a trailing item and (0, 2, 1, 3) adds both.
+  switch (group_start.size()) {
+    case 2:
+      rows = group_size[1];
+      cols = group_size[0];
+      return true;
+    case 3:
+      if (group_start[0] < group_start[2] && group_start[2] < group_start[1]) {
+        batch_count = group_size[0];
+        rows = group_size[2];
+        cols = group_size[1];
+        return true;
+      }
+      if (group_start[1] < group_start[0] && group_start[0] < group_start[2]) {
+        rows = group_size[1];
+        cols = group_size[0];
+        elements_per_item = group_size[2];
+        return true;
+      }
+      return false;
+    case 4:
+      if (group_start[0] < group_start[2] && group_start[2] < group_start[1] && group_start[1] < group_start[3]) {
+        batch_count = group_size[0];
+        rows = group_size[2];
+        cols = group_size[1];
+        elements_per_item = group_size[3];
+        return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// TryTransposeWithMlas: transposes with the MLAS tiled kernels if the permutation is a batched 2D transpose of
+// 4 or 8 byte items.
+static bool TryTransposeWithMlas(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                 size_t element_size, concurrency::ThreadPool* tp) {
+  size_t batch_count, rows, cols, elements_per_item;
+  if (!TransposeBase::IsBatchedTranspose2D(permutations, input.Shape().GetDims(), batch_count, rows, cols,
+                                           elements_per_item)) {
+    return false;
+  }
+
+  const size_t item_size = element_size * elements_per_item;
+  const void* input_data = input.DataRaw();
+  void* output_data = output.MutableDataRaw();
+
+  if ((reinterpret_cast<uintptr_t>(input_data) | reinterpret_cast<uintptr_t>(output_data)) % item_size != 0) {
+    return false;
+  }
+
+  if (item_size == sizeof(uint32_t)) {
+    MlasTranspose(static_cast<const uint32_t*>(input_data), static_cast<uint32_t*>(output_data),
+                  batch_count, rows, cols, tp);
+    return true;
+  }
+
+  if (item_size == sizeof(uint64_t)) {
+    MlasTranspose(static_cast<const uint64_t*>(input_data), static_cast<uint64_t*>(output_data),
+                  batch_count, rows, cols, tp);
+    return true;
+  }
+
+  return false;
+}
+
+static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                 concurrency::ThreadPool* tp) {
   const auto& input_shape = input.Shape();
   const auto& input_dims = input_shape.GetDims();
   auto rank = input_shape.NumDimensions();
@@ -227,6 +334,8 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
     auto* output_data = reinterpret_cast<uint8_t*>(output.MutableDataRaw());
     if (1 == prefix_blocksize) {
       DoTransposeSingleBlock(suffix_blocksize, input_data, output_data, element_size);
+    } else if (TryTransposeWithMlas(permutations, input, output, element_size, tp)) {
+      return Status::OK();
     } else if (1 == suffix_blocksize) {
       DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
                          input_data, output_data, element_size);
@@ -239,7 +348,8 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
   return Status::OK();
 }
 
-Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                  concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -249,7 +359,7 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
   } else {
-    status = DoUntypedTranspose(permutations, input, output);
+    status = DoUntypedTranspose(permutations, input, output, tp);
   }
 
   return status;
@@ -274,7 +384,10 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
-  DoUntypedTranspose(*p_perm, X, Y);
+  auto ctx_internal = static_cast<OpKernelContextInternal*>(ctx);
+  concurrency::ThreadPool* tp = ctx_internal->GetOperatorThreadPool();
+
+  DoUntypedTranspose(*p_perm, X, Y, tp);
 
   return Status::OK();
 }
@@ -15,8 +15,18 @@ class TransposeBase {
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
   Both Tensors must have the same data type. 
+  The optional thread pool is used to split large transposes across threads.
   */
-  static Status DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output);
+  static Status DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                            concurrency::ThreadPool* tp = nullptr);
+
+  /**
+  Check whether the permutation is a batched 2D transpose once size one axes are dropped and runs of axes that
+  stay adjacent are merged. If so, each of the batch_count input matrices of rows x cols items is transposed,
+  where an item is elements_per_item consecutive values that keep their position.
+  */
+  static bool IsBatchedTranspose2D(const std::vector<size_t>& permutations, const std::vector<int64_t>& input_dims,
+                                   size_t& batch_count, size_t& rows, size_t& cols, size_t& elements_per_item);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
@@ -4,6 +4,8 @@
 #include "core/providers/cpu/tensor/upsample.h"
 #include <cmath>
 #include <sstream>
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime::common;
 using namespace std;
@@ -30,40 +32,22 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<uint8_t>()),
     Upsample<uint8_t>);
 
-template <typename T>
-void UpsampleNearest2x(
-    int64_t batch_size,
-    int64_t num_channels,
-    int64_t input_height,
-    int64_t input_width,
-    const T* input,
-    T* output) {
-  const int64_t output_height = input_height * 2;
-  const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
-        }
-      }
-      input += input_height * input_width;
-      output += output_height * output_width;
-    }
-  }
-}
+// Approximate cost, in cycles, of producing one element of the output.
+constexpr double kNearestCostPerElement = 2.0;
+constexpr double kBilinearCostPerElement = 16.0;
 
+// Nearest mode treats the output as rows of its innermost dimension. The input offset of every output
+// coordinate is computed once per dimension, so each row only adds the offsets of its outer coordinates
+// and then gathers (or, when the innermost dimension isn't scaled, copies) its elements. The rows are
+// split over the thread pool.
 template <typename T>
 Status UpsampleNearest(const T* input,
                        T* output,
                        const TensorShape& input_shape,
                        const TensorShape& output_shape,
                        const vector<float>& scales,
-                       bool is_resize) {
+                       bool is_resize,
+                       concurrency::ThreadPool* tp) {
   if (!input || !output)
     return Status(ONNXRUNTIME, FAIL, is_resize ? "Resize: input/output value is nullptr" : 
                                                  "Upsample: input/output value is nullptr");
@@ -76,114 +60,76 @@ Status UpsampleNearest(const T* input,
                               "Upsample: input shape needs to be at least a single dimension.");
   }
 
-  int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
+  const int64_t output_size = output_shape.Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const int64_t n_dim = static_cast<int64_t>(input_shape.NumDimensions());
 
-  std::vector<int64_t> input_dim_counters(n_dim);
   std::vector<int64_t> input_dim_factor(n_dim);
   input_dim_factor[n_dim - 1] = 1;  // initialize dimension factor
   for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
     input_dim_factor[dim_idx] = input_dim_factor[dim_idx + 1] * input_shape[dim_idx + 1];
   }
 
-  int64_t output_idx = 0;
-  int64_t input_idx = 0;
-
-#define OneDemensionProcessor(dim_inx)                                                                                                                  \
-  int64_t input_dim##dim_inx##_inx =                                                                                                                    \
-      static_cast<int64_t>(scales[dim_inx] < 1 ? std::ceil(output_dim##dim_inx##_inx / scales[dim_inx]) : output_dim##dim_inx##_inx / scales[dim_inx]); \
-  if (input_dim##dim_inx##_inx > input_shape[dim_inx] - 1) input_dim##dim_inx##_inx = input_shape[dim_inx] - 1;                                         \
-  if (input_dim##dim_inx##_inx != input_dim_counters[dim_inx]) {                                                                                        \
-    input_idx += (input_dim##dim_inx##_inx - input_dim_counters[dim_inx]) * input_dim_factor[dim_inx];                                                  \
-    input_dim_counters[dim_inx] = input_dim##dim_inx##_inx;                                                                                             \
+  // input_mapping[output_dim_offset[dim_idx] + i] is the input offset of output coordinate i of dimension dim_idx
+  std::vector<int64_t> output_dim_offset(n_dim + 1);
+  for (int64_t dim_idx = 0; dim_idx < n_dim; dim_idx++) {
+    output_dim_offset[dim_idx + 1] = output_dim_offset[dim_idx] + output_shape[dim_idx];
   }
-
-  if (n_dim == 1) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      output[output_idx++] = input[input_idx];
+  std::vector<int64_t> input_mapping(output_dim_offset[n_dim]);
+  for (int64_t dim_idx = 0; dim_idx < n_dim; dim_idx++) {
+    for (int64_t output_dim_inx = 0; output_dim_inx < output_shape[dim_idx]; output_dim_inx++) {
+      int64_t input_dim_inx = static_cast<int64_t>(scales[dim_idx] < 1 ? std::ceil(output_dim_inx / scales[dim_idx])
+                                                                       : output_dim_inx / scales[dim_idx]);
+      if (input_dim_inx > input_shape[dim_idx] - 1) input_dim_inx = input_shape[dim_idx] - 1;
+      input_mapping[output_dim_offset[dim_idx] + output_dim_inx] = input_dim_inx * input_dim_factor[dim_idx];
     }
-    return Status::OK();
   }
 
-  if (n_dim == 2) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        output[output_idx++] = input[input_idx];
-      }
+  const int64_t inner_size = output_shape[n_dim - 1];
+  const int64_t* inner_mapping = input_mapping.data() + output_dim_offset[n_dim - 1];
+  const bool copy_rows = inner_size == input_shape[n_dim - 1] && scales[n_dim - 1] == 1;
+  const int64_t row_count = output_size / inner_size;
+
+  auto upsample_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // coordinates of row first in the outer dimensions
+    std::vector<int64_t> output_dim_counter(n_dim);
+    int64_t remaining = first;
+    for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
+      output_dim_counter[dim_idx] = remaining % output_shape[dim_idx];
+      remaining /= output_shape[dim_idx];
     }
-    return Status::OK();
-  }
 
-  if (n_dim == 3) {
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDemensionProcessor(2);
-          output[output_idx++] = input[input_idx];
-        }
+    T* output_row = output + first * inner_size;
+    for (std::ptrdiff_t row = first; row < last; ++row, output_row += inner_size) {
+      int64_t input_idx = 0;
+      for (int64_t dim_idx = 0; dim_idx < n_dim - 1; dim_idx++) {
+        input_idx += input_mapping[output_dim_offset[dim_idx] + output_dim_counter[dim_idx]];
       }
-    }
-    return Status::OK();
-  }
 
-  if (n_dim == 4) {
-    if (scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-      UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-      return Status::OK();
-    }
-    for (int64_t output_dim0_inx = 0; output_dim0_inx < output_shape[0]; output_dim0_inx++) {
-      OneDemensionProcessor(0);
-      for (int64_t output_dim1_inx = 0; output_dim1_inx < output_shape[1]; output_dim1_inx++) {
-        OneDemensionProcessor(1);
-        for (int64_t output_dim2_inx = 0; output_dim2_inx < output_shape[2]; output_dim2_inx++) {
-          OneDemensionProcessor(2);
-          for (int64_t output_dim3_inx = 0; output_dim3_inx < output_shape[3]; output_dim3_inx++) {
-            OneDemensionProcessor(3);
-            output[output_idx++] = input[input_idx];
-          }
+      const T* input_row = input + input_idx;
+      if (copy_rows) {
+        memcpy(output_row, input_row, inner_size * sizeof(T));
+      } else {
+        for (int64_t output_dim_inx = 0; output_dim_inx < inner_size; output_dim_inx++) {
+          output_row[output_dim_inx] = input_row[inner_mapping[output_dim_inx]];
         }
       }
-    }
-    return Status::OK();
-  }
-
-#undef OneDemensionProcessor
-
-  std::vector<int64_t> output_dim_counter(n_dim);
-  output_dim_counter[n_dim - 1] = -1;  // initialize dimension counter
-
-  for (; output_idx < output_shape.Size(); output_idx++) {
-    for (int64_t dim_idx = n_dim - 1; dim_idx >= 0; dim_idx--) {
-      if (++output_dim_counter[dim_idx] < output_shape[dim_idx]) {
-        int64_t current_input_dim_counter = 0;
-        if (scales[dim_idx] < 1)  //downsample
-        {
-          current_input_dim_counter = static_cast<int64_t>(std::ceil(output_dim_counter[dim_idx] / scales[dim_idx]));
-        } else  //upsample
-        {
-          current_input_dim_counter = static_cast<int64_t>(output_dim_counter[dim_idx] / scales[dim_idx]);
-        }
 
-        if (current_input_dim_counter >= input_shape[dim_idx] - 1)
-          current_input_dim_counter = input_shape[dim_idx] - 1;
-
-        if (current_input_dim_counter != input_dim_counters[dim_idx]) {
-          input_idx += (current_input_dim_counter - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-          input_dim_counters[dim_idx] = current_input_dim_counter;
-        }
-        break;
-      } else {
+      for (int64_t dim_idx = n_dim - 2; dim_idx >= 0; dim_idx--) {
+        if (++output_dim_counter[dim_idx] < output_shape[dim_idx]) break;
         output_dim_counter[dim_idx] = 0;
-        input_idx += (0 - input_dim_counters[dim_idx]) * input_dim_factor[dim_idx];
-        input_dim_counters[dim_idx] = 0;
       }
     }
+  };
 
-    output[output_idx] = input[input_idx];
+  if (tp == nullptr) {
+    upsample_rows(0, static_cast<std::ptrdiff_t>(row_count));
+  } else {
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(row_count), kNearestCostPerElement * static_cast<double>(inner_size),
+                    upsample_rows);
   }
 
   return Status::OK();
@@ -265,7 +211,8 @@ void upsampleBilinear(
     float width_scale,
     const T* Xdata,
     T* Ydata,
-    AllocatorPtr& alloc) {
+    AllocatorPtr& alloc,
+    concurrency::ThreadPool* tp) {
   auto output_width = static_cast<int64_t>(input_width * width_scale);
   auto output_height = static_cast<int64_t>(input_height * height_scale);
 
@@ -313,24 +260,33 @@ void upsampleBilinear(
     }
   }
 
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        for (int64_t x = 0; x < output_width; ++x) {
-          T X11 = Xdata[input_width_mul_y1[y] + in_x1[x]];
-          T X21 = Xdata[input_width_mul_y1[y] + in_x2[x]];
-          T X12 = Xdata[input_width_mul_y2[y] + in_x1[x]];
-          T X22 = Xdata[input_width_mul_y2[y] + in_x2[x]];
-
-          Ydata[output_width * y + x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
-                                                       dx1[x] * dy2[y] * X21 +
-                                                       dx2[x] * dy1[y] * X12 +
-                                                       dx1[x] * dy1[y] * X22);
-        }
+  // the rows of all the output planes are split over the thread pool, reusing the tables above for every channel
+  const int64_t row_count = batch_size * num_channels * output_height;
+  auto upsample_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const int64_t plane = row / output_height;
+      const int64_t y = row % output_height;
+      const T* Xplane = Xdata + plane * input_height * input_width;
+      T* Yrow = Ydata + row * output_width;
+      for (int64_t x = 0; x < output_width; ++x) {
+        T X11 = Xplane[input_width_mul_y1[y] + in_x1[x]];
+        T X21 = Xplane[input_width_mul_y1[y] + in_x2[x]];
+        T X12 = Xplane[input_width_mul_y2[y] + in_x1[x]];
+        T X22 = Xplane[input_width_mul_y2[y] + in_x2[x]];
+
+        Yrow[x] = static_cast<T>(dx2[x] * dy2[y] * X11 +
+                                 dx1[x] * dy2[y] * X21 +
+                                 dx2[x] * dy1[y] * X12 +
+                                 dx1[x] * dy1[y] * X22);
       }
-      Xdata += input_height * input_width;
-      Ydata += output_width * output_height;
     }
+  };
+
+  if (tp == nullptr) {
+    upsample_rows(0, static_cast<std::ptrdiff_t>(row_count));
+  } else {
+    tp->ParallelFor(static_cast<std::ptrdiff_t>(row_count),
+                    kBilinearCostPerElement * static_cast<double>(output_width), upsample_rows);
   }
 }
 
@@ -360,9 +316,12 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
     return Status::OK();
   }
 
+  concurrency::ThreadPool* tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+
   switch (mode_) {
     case UpsampleMode::NN:
-      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales, is_resize);
+      return UpsampleNearest<T>(X->template Data<T>(), Y->template MutableData<T>(), X->Shape(), Y->Shape(), scales,
+                                is_resize, tp);
     case UpsampleMode::LINEAR: {
       //The correct behavior of 'linear' mode for an N-D input is not clear right now,
       //so only support 'bilinear' with 2-D or 4-D input tensor with outermost 2 scales as 1 in the 4-D case 
@@ -384,7 +343,7 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context, const std::vector<floa
       ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
       upsampleBilinear(batch_size, num_channels, input_height, input_width,
                        is_2D ? scales[0] : scales[2], is_2D ? scales[1] : scales[3], 
-                       X->template Data<T>(), Y->template MutableData<T>(), alloc);
+                       X->template Data<T>(), Y->template MutableData<T>(), alloc, tp);
       return Status::OK();
     }
     default:
@@ -4,9 +4,9 @@
 #include "core/providers/cpu/tensor/where_op.h"
 
 #include <algorithm>
-#include <type_traits>
+#include <vector>
 
-#include "core/providers/cpu/math/element_wise_ops.h"  // for broadcast utilities
+#include "core/framework/op_kernel_context_internal.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -41,124 +41,102 @@ WHERE_TYPED_KERNEL_WITH_TYPE_NAME(std::string, string)
 #undef WHERE_TYPED_KERNEL
 
 namespace {
-template <typename T>
-constexpr bool IsEigenScalarCompatible = std::is_arithmetic<T>::value;
-
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target,
-                    TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoop(
-      *select_broadcaster, *select_broadcast_output,
-      [target](EigenVectorMap<T> output, bool condition, ConstEigenVectorMap<T> value) {
-        if (condition == target) {
-          output = value;
-        } else {
-          output = EigenVectorMap<T>::PlainObject::Constant(value.size(), T{});
-        }
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, const T& value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      },
-      [target](EigenVectorMap<T> output, ConstEigenVectorMap<bool> condition, ConstEigenVectorMap<T> value) {
-        output = (condition.array() == target)
-                     .select(value, EigenVectorMap<T>::PlainObject::Constant(condition.size(), T{}));
-      });
+struct SelectAxis {
+  int64_t extent;
+  int64_t condition_stride;
+  int64_t X_stride;
+  int64_t Y_stride;
+};
+
+// Returns the strides, in elements, of a tensor of the given shape broadcast to output_dims.
+// Broadcast axes have a stride of zero.
+std::vector<int64_t> BroadcastStrides(const std::vector<int64_t>& dims, const std::vector<int64_t>& output_dims) {
+  const size_t rank_offset = output_dims.size() - dims.size();
+  std::vector<int64_t> strides(output_dims.size(), 0);
+  int64_t pitch = 1;
+  for (size_t i = dims.size(); i-- > 0;) {
+    strides[rank_offset + i] = dims[i] == 1 ? 0 : pitch;
+    pitch *= dims[i];
+  }
+  return strides;
 }
 
-template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-SelectBroadcastLoop(bool target, TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoopSpan(
-      *select_broadcaster, *select_broadcast_output,
-      [target](gsl::span<T> output, bool condition, gsl::span<const T> value) {
-        if (condition == target) {
-          std::copy(value.cbegin(), value.cend(), output.begin());
-        } else {
-          std::fill(output.begin(), output.end(), T{});
-        }
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, const T& value) {
-        std::transform(condition.cbegin(), condition.cend(), output.begin(),
-                       [target, &value](bool condition_element) {
-                         return condition_element == target ? value : T{};
-                       });
-      },
-      [target](gsl::span<T> output, gsl::span<const bool> condition, gsl::span<const T> value) {
-        std::transform(condition.cbegin(), condition.cend(), value.cbegin(), output.begin(),
-                       [target](bool condition_element, const T& value_element) {
-                         return condition_element == target ? value_element : T{};
-                       });
-      });
+// Computes the output shape of broadcasting condition, X and Y together.
+Status BroadcastShapes(const std::vector<std::vector<int64_t>>& input_dims, std::vector<int64_t>& output_dims) {
+  size_t rank = 0;
+  for (const auto& dims : input_dims) {
+    rank = std::max(rank, dims.size());
+  }
+
+  output_dims.assign(rank, 1);
+  for (const auto& dims : input_dims) {
+    const size_t rank_offset = rank - dims.size();
+    for (size_t i = 0; i < dims.size(); ++i) {
+      int64_t& output_dim = output_dims[rank_offset + i];
+      if (dims[i] == 1) {
+        continue;
+      }
+      if (output_dim != 1 && output_dim != dims[i]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Where inputs can not be broadcast together. ",
+                               "Dimension ", output_dim, " does not match ", dims[i], " on axis ", rank_offset + i,
+                               " of the output.");
+      }
+      output_dim = dims[i];
+    }
+  }
+  return Status::OK();
 }
 
-template <typename T>
-std::unique_ptr<Tensor> Select(bool target, const Tensor& condition_tensor, const Tensor& value_tensor,
-                               TensorAllocator<T>& tensor_allocator) {
-  TBroadcaster<bool, T> select_broadcaster{condition_tensor, value_tensor};
-  std::unique_ptr<Tensor> select_tensor{
-      tensor_allocator.Allocate(select_broadcaster.GetOutputShape())};
-  TBroadcastOutput<T> select_broadcast_output{
-      select_broadcaster.GetSpanSize(), *select_tensor};
+// Returns the axes of the output from the outermost, without the axes of extent 1 and with every axis merged
+// into the next inner one when all the inputs step across them uniformly. There is always at least one axis,
+// and the innermost axis strides are 0 for a broadcast input and 1 otherwise.
+std::vector<SelectAxis> CoalesceAxes(const std::vector<int64_t>& output_dims,
+                                     const std::vector<int64_t>& condition_strides,
+                                     const std::vector<int64_t>& X_strides,
+                                     const std::vector<int64_t>& Y_strides) {
+  std::vector<SelectAxis> axes;
+  for (size_t i = 0; i < output_dims.size(); ++i) {
+    if (output_dims[i] == 1) {
+      continue;
+    }
 
-  SelectBroadcastLoop(target, &select_broadcaster, &select_broadcast_output);
+    SelectAxis axis{output_dims[i], condition_strides[i], X_strides[i], Y_strides[i]};
+    if (!axes.empty()) {
+      const SelectAxis& outer = axes.back();
+      if (outer.condition_stride == axis.condition_stride * axis.extent &&
+          outer.X_stride == axis.X_stride * axis.extent &&
+          outer.Y_stride == axis.Y_stride * axis.extent) {
+        axis.extent *= outer.extent;
+        axes.pop_back();
+      }
+    }
+    axes.push_back(axis);
+  }
 
-  return select_tensor;
+  if (axes.empty()) {
+    axes.push_back({1, 1, 1, 1});
+  }
+  return axes;
 }
 
-template <typename T>
-std::enable_if_t<IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](EigenVectorMap<T> output,
-                                      const T& scalar_value, ConstEigenVectorMap<T> vector_value) {
-    if (scalar_value != T{}) {
-      output = EigenVectorMap<T>::PlainObject::Constant(vector_value.size(), scalar_value);
-    } else {
-      output = vector_value;
-    }
-  };
-
-  BroadcastLoop(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](EigenVectorMap<T> output, const T& X_selection, ConstEigenVectorMap<T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](EigenVectorMap<T> output, ConstEigenVectorMap<T> X_selection, ConstEigenVectorMap<T> Y_selection) {
-        output = X_selection.binaryExpr(Y_selection, [](T x, T y) -> T {
-          return x != T{} ? x : y;
-        });
-      });
+// Selects count elements from X where condition is true and from Y elsewhere. The strides are compile time
+// constants of 0 or 1 so that the loop has no index arithmetic or branches and vectorizes as a blend.
+template <typename T, int64_t ConditionStride, int64_t XStride, int64_t YStride>
+void SelectRun(T* output, const bool* condition, const T* X, const T* Y, int64_t count) {
+  for (int64_t i = 0; i < count; ++i) {
+    output[i] = condition[i * ConditionStride] ? X[i * XStride] : Y[i * YStride];
+  }
 }
 
 template <typename T>
-std::enable_if_t<!IsEigenScalarCompatible<T>, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
-  const auto merge_scalar_and_vector = [](gsl::span<T> output, const T& scalar_value, gsl::span<const T> vector_value) {
-    if (!scalar_value.empty()) {
-      std::fill(output.begin(), output.end(), scalar_value);
-    } else {
-      std::copy(vector_value.cbegin(), vector_value.cend(), output.begin());
-    }
-  };
+using SelectRunFn = void (*)(T*, const bool*, const T*, const T*, int64_t);
 
-  BroadcastLoopSpan(
-      *merge_broadcaster, *merge_broadcast_output,
-      [merge_scalar_and_vector](gsl::span<T> output, const T& X_selection, gsl::span<const T> Y_selection) {
-        merge_scalar_and_vector(output, X_selection, Y_selection);
-      },
-      [merge_scalar_and_vector](gsl::span<T> output, gsl::span<const T> X_selection, const T& Y_selection) {
-        merge_scalar_and_vector(output, Y_selection, X_selection);
-      },
-      [](gsl::span<T> output, gsl::span<const T> X_selection, gsl::span<const T> Y_selection) {
-        std::transform(X_selection.cbegin(), X_selection.cend(), Y_selection.cbegin(), output.begin(),
-                       [](const T& x, const T& y) { return !x.empty() ? x : y; });
-      });
+template <typename T>
+SelectRunFn<T> GetSelectRun(const SelectAxis& inner) {
+  static const SelectRunFn<T> select_runs[] = {
+      SelectRun<T, 0, 0, 0>, SelectRun<T, 0, 0, 1>, SelectRun<T, 0, 1, 0>, SelectRun<T, 0, 1, 1>,
+      SelectRun<T, 1, 0, 0>, SelectRun<T, 1, 0, 1>, SelectRun<T, 1, 1, 0>, SelectRun<T, 1, 1, 1>};
+  return select_runs[(inner.condition_stride << 2) | (inner.X_stride << 1) | inner.Y_stride];
 }
 }  // namespace
 
@@ -169,24 +147,82 @@ Status Where<T>::Compute(OpKernelContext* context) const {
   const auto* const Y = context->Input<Tensor>(2);
   ORT_ENFORCE(condition && X && Y, "condition, X, and Y inputs are required!");
 
-  // The current implementation is limited to broadcasting over two tensors at once.
-  // So, we first broadcast over condition and X to select the values from X:
-  //   X_selection = condition ? X : default value
-  // Similarly, we broadcast over condition and Y to select the values from Y:
-  //   Y_selection = !condition ? Y : default value
-  // Finally, we broadcast over and merge X_selection and Y_selection:
-  //   output = (X_selection != default value) ? X_selection : Y_selection
-  TensorAllocator<T> tensor_allocator{*context};
-  auto X_selection_tensor = Select<T>(true, *condition, *X, tensor_allocator);
-  auto Y_selection_tensor = Select<T>(false, *condition, *Y, tensor_allocator);
-
-  TBroadcaster<T, T> merge_broadcaster{*X_selection_tensor, *Y_selection_tensor};
-  Tensor* const output = context->Output(0, merge_broadcaster.GetOutputShape());
+  const auto& condition_dims = condition->Shape().GetDims();
+  const auto& X_dims = X->Shape().GetDims();
+  const auto& Y_dims = Y->Shape().GetDims();
+
+  std::vector<int64_t> output_dims;
+  ORT_RETURN_IF_ERROR(BroadcastShapes({condition_dims, X_dims, Y_dims}, output_dims));
+  Tensor* const output = context->Output(0, TensorShape::ReinterpretBaseType(output_dims));
   ORT_ENFORCE(output, "failed to get first output!");
-  TBroadcastOutput<T> merge_broadcast_output{
-      merge_broadcaster.GetSpanSize(), *output};
 
-  MergeBroadcastLoop(&merge_broadcaster, &merge_broadcast_output);
+  const int64_t output_size = output->Shape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // The output is selected in a single pass, as runs along the innermost coalesced axis between which the
+  // broadcast inputs are stepped by their strides.
+  const std::vector<SelectAxis> axes = CoalesceAxes(output_dims,
+                                                    BroadcastStrides(condition_dims, output_dims),
+                                                    BroadcastStrides(X_dims, output_dims),
+                                                    BroadcastStrides(Y_dims, output_dims));
+  const SelectAxis& inner = axes.back();
+  const size_t outer_rank = axes.size() - 1;
+  const SelectRunFn<T> select_run = GetSelectRun<T>(inner);
+
+  const bool* condition_data = condition->template Data<bool>();
+  const T* X_data = X->template Data<T>();
+  const T* Y_data = Y->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  auto select_range = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    // position of the run holding the first element
+    std::vector<int64_t> index(outer_rank);
+    int64_t condition_offset = 0;
+    int64_t X_offset = 0;
+    int64_t Y_offset = 0;
+    int64_t outer = first / inner.extent;
+    int64_t begin = first % inner.extent;
+    for (size_t axis = outer_rank; axis-- > 0;) {
+      index[axis] = outer % axes[axis].extent;
+      outer /= axes[axis].extent;
+      condition_offset += index[axis] * axes[axis].condition_stride;
+      X_offset += index[axis] * axes[axis].X_stride;
+      Y_offset += index[axis] * axes[axis].Y_stride;
+    }
+
+    for (std::ptrdiff_t position = first; position < last;) {
+      const int64_t count = std::min<int64_t>(inner.extent - begin, last - position);
+      select_run(output_data + position,
+                 condition_data + condition_offset + begin * inner.condition_stride,
+                 X_data + X_offset + begin * inner.X_stride,
+                 Y_data + Y_offset + begin * inner.Y_stride,
+                 count);
+      position += count;
+      begin = 0;
+
+      for (size_t axis = outer_rank; axis-- > 0;) {
+        condition_offset += axes[axis].condition_stride;
+        X_offset += axes[axis].X_stride;
+        Y_offset += axes[axis].Y_stride;
+        if (++index[axis] < axes[axis].extent) {
+          break;
+        }
+        condition_offset -= axes[axis].condition_stride * axes[axis].extent;
+        X_offset -= axes[axis].X_stride * axes[axis].extent;
+        Y_offset -= axes[axis].Y_stride * axes[axis].extent;
+        index[axis] = 0;
+      }
+    }
+  };
+
+  auto tp = static_cast<OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (tp == nullptr) {
+    select_range(0, output_size);
+  } else {
+    tp->ParallelFor(output_size, static_cast<double>(sizeof(bool) + 3 * sizeof(T)), select_range);
+  }
 
   return Status::OK();
 }
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include "bias_activation_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+struct OP_FusedIdentity {
+  __device__ __inline__ T operator()(const T& a) const { return a; }
+};
+
+template <typename T>
+struct OP_FusedRelu {
+  __device__ __inline__ T operator()(const T& a) const { return _Max(a, (T)0); }
+};
+
+template <typename T>
+struct OP_FusedSigmoid {
+  __device__ __inline__ T operator()(const T& a) const {
+    return a > T(0) ? (T)1 / ((T)1. + _Exp(-_Abs(a))) : (T)1 - (T)1 / ((T)1 + _Exp(-_Abs(a)));
+  }
+};
+
+template <typename T>
+struct OP_FusedTanh {
+  __device__ __inline__ T operator()(const T& a) const { return _Tanh(a); }
+};
+
+template <typename T>
+struct OP_FusedLeakyRelu {
+  T alpha;
+  __device__ __inline__ T operator()(const T& a) const { return a > (T)0 ? a : alpha * a; }
+};
+
+template <typename T>
+struct OP_FusedClip {
+  T min;
+  T max;
+  __device__ __inline__ T operator()(const T& a) const { return _Min(_Max(a, min), max); }
+};
+
+template <typename T>
+struct OP_FusedFastGelu {
+  __device__ __inline__ T operator()(const T& a) const {
+    // sqrt(2 / pi)
+    return (T)0.5f * a * ((T)1 + _Tanh((T)0.7978845608028654f * a * ((T)1 + (T)0.044715f * a * a)));
+  }
+};
+
+template <typename T, typename FuncT, bool has_bias>
+__global__ void _BiasActivation(
+    T* data,
+    const T* bias,
+    T bias_scale,
+    fast_divmod bias_inner,
+    fast_divmod bias_size,
+    FuncT functor,
+    CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  T value = data[id];
+  if (has_bias) {
+    int q, r;
+    bias_size.divmod(bias_inner.div(id), q, r);
+    value += bias_scale * bias[r];
+  }
+  data[id] = functor(value);
+}
+
+template <typename T, typename FuncT>
+void LaunchBiasActivation(T* data, const T* bias, float bias_scale, int64_t bias_inner, int64_t bias_size,
+                          const FuncT& functor, size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  if (bias != nullptr) {
+    _BiasActivation<T, FuncT, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        data, bias, (T)bias_scale, fast_divmod(static_cast<int>(bias_inner)), fast_divmod(static_cast<int>(bias_size)),
+        functor, N);
+  } else {
+    _BiasActivation<T, FuncT, false><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        data, bias, (T)bias_scale, fast_divmod(), fast_divmod(), functor, N);
+  }
+}
+
+template <typename T>
+void BiasActivationImpl(
+    T* data,
+    const T* bias,
+    float bias_scale,
+    int64_t bias_inner,
+    int64_t bias_size,
+    const FusedActivation& activation,
+    size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  switch (activation.kind) {
+    case FusedActivationKind::Identity:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size, OP_FusedIdentity<T>(), count);
+      break;
+    case FusedActivationKind::Relu:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size, OP_FusedRelu<T>(), count);
+      break;
+    case FusedActivationKind::Sigmoid:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size, OP_FusedSigmoid<T>(), count);
+      break;
+    case FusedActivationKind::Tanh:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size, OP_FusedTanh<T>(), count);
+      break;
+    case FusedActivationKind::LeakyRelu:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size,
+                           OP_FusedLeakyRelu<T>{(T)activation.alpha}, count);
+      break;
+    case FusedActivationKind::Clip:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size,
+                           OP_FusedClip<T>{(T)activation.alpha, (T)activation.beta}, count);
+      break;
+    case FusedActivationKind::FastGelu:
+      LaunchBiasActivation(data, bias, bias_scale, bias_inner, bias_size, OP_FusedFastGelu<T>(), count);
+      break;
+  }
+}
+
+#define SPECIALIZED_BIAS_ACTIVATION_IMPL(T)                                                              \
+  template void BiasActivationImpl<T>(T * data, const T* bias, float bias_scale, int64_t bias_inner, \
+                                      int64_t bias_size, const FusedActivation& activation, size_t count);
+
+SPECIALIZED_BIAS_ACTIVATION_IMPL(half)
+SPECIALIZED_BIAS_ACTIVATION_IMPL(float)
+SPECIALIZED_BIAS_ACTIVATION_IMPL(double)
+
+}  // namespace cuda
+}  // namespace onnxruntime
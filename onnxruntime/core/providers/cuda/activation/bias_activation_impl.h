@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// Activation of the fused Conv and Gemm kernels, which mirrors the MLAS_ACTIVATION of the CPU kernels.
+enum class FusedActivationKind : int {
+  Identity,
+  Relu,
+  Sigmoid,
+  Tanh,
+  LeakyRelu,
+  Clip,
+  // the tanh approximation of Gelu, only fused into Gemm
+  FastGelu,
+};
+
+struct FusedActivation {
+  FusedActivationKind kind;
+  float alpha;  // alpha of LeakyRelu, minimum of Clip
+  float beta;   // maximum of Clip
+};
+
+// data[i] = activation(data[i] + bias_scale * bias[(i / bias_inner) % bias_size]) for count elements, in a single
+// pass over data. bias may be null to only apply the activation.
+template <typename T>
+void BiasActivationImpl(
+    T* data,
+    const T* bias,
+    float bias_scale,
+    int64_t bias_inner,
+    int64_t bias_size,
+    const FusedActivation& activation,
+    size_t count);
+
+}  // namespace cuda
+}  // namespace onnxruntime
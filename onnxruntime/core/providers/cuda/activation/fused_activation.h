@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/common/common.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cuda/activation/bias_activation_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Converts the activation the fusions attach to FusedConv and FusedGemm, see GetFusedActivationAttr.
+inline FusedActivation ToFusedActivation(const MLAS_ACTIVATION& activation) {
+  switch (activation.ActivationKind) {
+    case MlasIdentityActivation:
+      return {FusedActivationKind::Identity, 0.0f, 0.0f};
+    case MlasReluActivation:
+      return {FusedActivationKind::Relu, 0.0f, 0.0f};
+    case MlasLogisticActivation:
+      return {FusedActivationKind::Sigmoid, 0.0f, 0.0f};
+    case MlasTanhActivation:
+      return {FusedActivationKind::Tanh, 0.0f, 0.0f};
+    case MlasLeakyReluActivation:
+      return {FusedActivationKind::LeakyRelu, activation.Parameters.LeakyRelu.alpha, 0.0f};
+    case MlasClipActivation:
+      return {FusedActivationKind::Clip, activation.Parameters.Clip.minimum, activation.Parameters.Clip.maximum};
+    default:
+      ORT_THROW("Unsupported fused activation ", static_cast<int>(activation.ActivationKind));
+  }
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
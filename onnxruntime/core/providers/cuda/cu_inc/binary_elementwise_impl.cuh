@@ -3,6 +3,7 @@
 
 #pragma once
 #include <stdint.h>
+#include <type_traits>
 #include "core/providers/cuda/shared_inc/cuda_utils.h"
 #include "common.cuh"
 
@@ -57,9 +58,9 @@ __global__ void _BinaryElementWiseSimple(
   output_data[id] = func(lhs_data[IncL ? id : 0], rhs_data[IncR ? id : 0]);
 }
 
-// for rhs per-channel broadcast case
-template <typename T, typename FuncT>
-__global__ void _BinaryElementWiseRhsPerChannelBatch1(
+// for per-channel broadcast case of lhs(C,1) or rhs(C,1) with an output of (1,C,H)
+template <bool PerChannelL, typename T, typename FuncT>
+__global__ void _BinaryElementWisePerChannelBatch1(
     const T* lhs_data,
     const T* rhs_data,
     const fast_divmod fdm_H,
@@ -67,12 +68,13 @@ __global__ void _BinaryElementWiseRhsPerChannelBatch1(
     FuncT func,
     CUDA_LONG N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
-  CUDA_LONG rhs_id = fdm_H.div(id);
-  output_data[id] = func(lhs_data[id], rhs_data[rhs_id]);
+  CUDA_LONG channel_id = fdm_H.div(id);
+  output_data[id] = func(lhs_data[PerChannelL ? channel_id : id], rhs_data[PerChannelL ? id : channel_id]);
 }
 
-template <typename T, typename FuncT>
-__global__ void _BinaryElementWiseRhsPerChannelBatchN(
+// for per-channel broadcast case of lhs(C,1) or rhs(C,1) with an output of (N,C,H)
+template <bool PerChannelL, typename T, typename FuncT>
+__global__ void _BinaryElementWisePerChannelBatchN(
     const T* lhs_data,
     const T* rhs_data,
     const fast_divmod fdm_H,
@@ -81,23 +83,162 @@ __global__ void _BinaryElementWiseRhsPerChannelBatchN(
     FuncT func,
     CUDA_LONG N) {
   CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
-  CUDA_LONG rhs_id = fdm_H.div(id);
+  CUDA_LONG channel_id = fdm_H.div(id);
   int q, r;
-  fdm_C.divmod(rhs_id, q, r);
-  rhs_id = r;
-  output_data[id] = func(lhs_data[id], rhs_data[rhs_id]);
+  fdm_C.divmod(channel_id, q, r);
+  channel_id = r;
+  output_data[id] = func(lhs_data[PerChannelL ? channel_id : id], rhs_data[PerChannelL ? id : channel_id]);
 }
 
-template <typename T, typename FuncT>
-void BinaryElementWiseNoBroadcastImpl(
+// The vectorized kernels below compute kElementsPerThread<T> consecutive outputs per thread, which they read and
+// write with 128-bit accesses. They are used when the data is aligned for these accesses.
+template <typename T>
+struct VectorizedElements {
+  static constexpr int value = sizeof(T) < 16 ? 16 / sizeof(T) : 1;
+};
+
+template <typename T, int N>
+struct alignas(sizeof(T) * N) AlignedVector {
+  T val[N];
+};
+
+// Functors of the ops that also take the fp16 values in pairs, as half2, which the vectorized kernels then use
+// for their fp16 math.
+template <typename FuncT>
+struct HasHalf2Op {
+  static constexpr bool value = false;
+};
+
+template <typename T, typename FuncT, bool UseHalf2 = std::is_same<T, half>::value && HasHalf2Op<FuncT>::value>
+struct VectorizedBinaryOp {
+  template <int N>
+  __device__ __inline__ static void Apply(const FuncT& func, const T (&lhs)[N], const T (&rhs)[N], T (&out)[N]) {
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      out[i] = func(lhs[i], rhs[i]);
+    }
+  }
+};
+
+template <typename FuncT>
+struct VectorizedBinaryOp<half, FuncT, true> {
+  template <int N>
+  __device__ __inline__ static void Apply(const FuncT& func, const half (&lhs)[N], const half (&rhs)[N],
+                                          half (&out)[N]) {
+    static_assert(N % 2 == 0, "the fp16 values are computed in pairs");
+#pragma unroll
+    for (int i = 0; i < N; i += 2) {
+      *reinterpret_cast<half2*>(&out[i]) =
+          func(*reinterpret_cast<const half2*>(&lhs[i]), *reinterpret_cast<const half2*>(&rhs[i]));
+    }
+  }
+};
+
+// loads the N elements of a vector from data + offset, or N copies of data[0] for a scalar
+template <bool Inc, typename T, int N>
+__device__ __inline__ void LoadVector(const T* data, CUDA_LONG offset, T (&values)[N]) {
+  if (Inc) {
+    const AlignedVector<T, N> vector = *reinterpret_cast<const AlignedVector<T, N>*>(data + offset);
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      values[i] = vector.val[i];
+    }
+  } else {
+    const T value = data[0];
+#pragma unroll
+    for (int i = 0; i < N; i++) {
+      values[i] = value;
+    }
+  }
+}
+
+template <typename T, int N>
+__device__ __inline__ void StoreVector(T* data, CUDA_LONG offset, const T (&values)[N]) {
+  AlignedVector<T, N> vector;
+#pragma unroll
+  for (int i = 0; i < N; i++) {
+    vector.val[i] = values[i];
+  }
+  *reinterpret_cast<AlignedVector<T, N>*>(data + offset) = vector;
+}
+
+// for scalar broadcast or non-broadcast case; the last thread computes the outputs that don't fill a vector
+template <bool IncL, bool IncR, typename T, typename FuncT>
+__global__ void _BinaryElementWiseSimpleVectorized(
+    const T* lhs_data,
+    const T* rhs_data,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG N) {
+  constexpr int kElements = VectorizedElements<T>::value;
+  const CUDA_LONG id = GridDim::GetLinearThreadId() * kElements;
+  if (id >= N)
+    return;
+
+  if (id + kElements <= N) {
+    T lhs[kElements], rhs[kElements], out[kElements];
+    LoadVector<IncL>(lhs_data, id, lhs);
+    LoadVector<IncR>(rhs_data, id, rhs);
+    VectorizedBinaryOp<T, FuncT>::Apply(func, lhs, rhs, out);
+    StoreVector(output_data, id, out);
+  } else {
+    for (CUDA_LONG i = id; i < N; i++) {
+      output_data[i] = func(lhs_data[IncL ? i : 0], rhs_data[IncR ? i : 0]);
+    }
+  }
+}
+
+// for the broadcast of lhs(C) or rhs(C) over the last dim of the output, with C a multiple of the vector size
+template <bool PerChannelL, typename T, typename FuncT>
+__global__ void _BinaryElementWiseLastDimVectorized(
+    const T* lhs_data,
+    const T* rhs_data,
+    const fast_divmod fdm_C,
+    T* output_data,
+    FuncT func,
+    CUDA_LONG N) {
+  constexpr int kElements = VectorizedElements<T>::value;
+  const CUDA_LONG id = GridDim::GetLinearThreadId() * kElements;
+  if (id >= N)
+    return;
+
+  int q, channel_id;
+  fdm_C.divmod(id, q, channel_id);
+  T lhs[kElements], rhs[kElements], out[kElements];
+  LoadVector<true>(lhs_data, PerChannelL ? channel_id : id, lhs);
+  LoadVector<true>(rhs_data, PerChannelL ? id : channel_id, rhs);
+  VectorizedBinaryOp<T, FuncT>::Apply(func, lhs, rhs, out);
+  StoreVector(output_data, id, out);
+}
+
+template <typename T>
+bool IsVectorAligned(const T* data) {
+  return reinterpret_cast<uintptr_t>(data) % (sizeof(T) * VectorizedElements<T>::value) == 0;
+}
+
+// launches the vectorized kernel of the scalar broadcast or non-broadcast case if the data is aligned for it
+template <bool IncL, bool IncR, typename T, typename FuncT>
+void LaunchBinaryElementWiseSimple(
     const T* lhs_data,
     const T* rhs_data,
     T* output_data,
     const FuncT& func,
-    size_t count) {
-  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
-  CUDA_LONG N = static_cast<CUDA_LONG>(count);
-  _BinaryElementWiseSimple<true, true, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    CUDA_LONG N) {
+  constexpr int kElements = VectorizedElements<T>::value;
+  if (kElements > 1 && (!IncL || IsVectorAligned(lhs_data)) && (!IncR || IsVectorAligned(rhs_data)) &&
+      IsVectorAligned(output_data)) {
+    int blocksPerGrid = (int)(ceil(static_cast<float>(CeilDiv(N, kElements)) / GridDim::maxThreadsPerBlock));
+    _BinaryElementWiseSimpleVectorized<IncL, IncR, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        lhs_data,
+        rhs_data,
+        output_data,
+        func,
+        N);
+    return;
+  }
+
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _BinaryElementWiseSimple<IncL, IncR, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
       lhs_data,
       rhs_data,
       output_data,
@@ -105,52 +246,42 @@ void BinaryElementWiseNoBroadcastImpl(
       N);
 }
 
-template <typename T, typename FuncT>
-void BinaryElementWiseImpl(
-    size_t output_rank_or_simple_broadcast,
-    const int64_t* lhs_padded_strides,
+// launches the per-channel broadcast kernel, which is vectorized when the channels are the last dim
+template <bool PerChannelL, typename T, typename FuncT>
+void LaunchBinaryElementWisePerChannel(
+    bool batch1,
     const T* lhs_data,
-    const int64_t* rhs_padded_strides,
     const T* rhs_data,
-    const fast_divmod* fdm_output_strides,
     const fast_divmod& fdm_H,
     const fast_divmod& fdm_C,
     T* output_data,
     const FuncT& func,
-    size_t count) {
-  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
-  CUDA_LONG N = static_cast<CUDA_LONG>(count);
-  if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::NoBroadcast)) {
-    _BinaryElementWiseSimple<true, true, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        lhs_data,
-        rhs_data,
-        output_data,
-        func,
-        N);
-  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftScalar)) {
-    _BinaryElementWiseSimple<false, true, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
-        lhs_data,
-        rhs_data,
-        output_data,
-        func,
-        N);
-  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightScalar)) {
-    _BinaryElementWiseSimple<true, false, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    CUDA_LONG N) {
+  constexpr int kElements = VectorizedElements<T>::value;
+  if (kElements > 1 && !batch1 && fdm_H.d_ == 1 && fdm_C.d_ % kElements == 0 && IsVectorAligned(lhs_data) &&
+      IsVectorAligned(rhs_data) && IsVectorAligned(output_data)) {
+    int blocksPerGrid = (int)(ceil(static_cast<float>(N / kElements) / GridDim::maxThreadsPerBlock));
+    _BinaryElementWiseLastDimVectorized<PerChannelL, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
+        fdm_C,
         output_data,
         func,
         N);
-  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatch1)) {
-    _BinaryElementWiseRhsPerChannelBatch1<T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+    return;
+  }
+
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  if (batch1) {
+    _BinaryElementWisePerChannelBatch1<PerChannelL, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
         fdm_H,
         output_data,
         func,
         N);
-  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatchN)) {
-    _BinaryElementWiseRhsPerChannelBatchN<T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+  } else {
+    _BinaryElementWisePerChannelBatchN<PerChannelL, T, FuncT><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
         lhs_data,
         rhs_data,
         fdm_H,
@@ -158,6 +289,50 @@ void BinaryElementWiseImpl(
         output_data,
         func,
         N);
+  }
+}
+
+template <typename T, typename FuncT>
+void BinaryElementWiseNoBroadcastImpl(
+    const T* lhs_data,
+    const T* rhs_data,
+    T* output_data,
+    const FuncT& func,
+    size_t count) {
+  LaunchBinaryElementWiseSimple<true, true>(lhs_data, rhs_data, output_data, func, static_cast<CUDA_LONG>(count));
+}
+
+template <typename T, typename FuncT>
+void BinaryElementWiseImpl(
+    size_t output_rank_or_simple_broadcast,
+    const int64_t* lhs_padded_strides,
+    const T* lhs_data,
+    const int64_t* rhs_padded_strides,
+    const T* rhs_data,
+    const fast_divmod* fdm_output_strides,
+    const fast_divmod& fdm_H,
+    const fast_divmod& fdm_C,
+    T* output_data,
+    const FuncT& func,
+    size_t count) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(count) / GridDim::maxThreadsPerBlock));
+  CUDA_LONG N = static_cast<CUDA_LONG>(count);
+  if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::NoBroadcast)) {
+    LaunchBinaryElementWiseSimple<true, true>(lhs_data, rhs_data, output_data, func, N);
+  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftScalar)) {
+    LaunchBinaryElementWiseSimple<false, true>(lhs_data, rhs_data, output_data, func, N);
+  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightScalar)) {
+    LaunchBinaryElementWiseSimple<true, false>(lhs_data, rhs_data, output_data, func, N);
+  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatch1) ||
+             output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatchN)) {
+    LaunchBinaryElementWisePerChannel<false>(
+        output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::RightPerChannelBatch1),
+        lhs_data, rhs_data, fdm_H, fdm_C, output_data, func, N);
+  } else if (output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftPerChannelBatch1) ||
+             output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftPerChannelBatchN)) {
+    LaunchBinaryElementWisePerChannel<true>(
+        output_rank_or_simple_broadcast == static_cast<size_t>(SimpleBroadcast::LeftPerChannelBatch1),
+        lhs_data, rhs_data, fdm_H, fdm_C, output_data, func, N);
   } else {
     if (lhs_padded_strides && rhs_padded_strides)
       _BinaryElementWise<T, FuncT, true, true><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
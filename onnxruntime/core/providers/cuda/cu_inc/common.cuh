@@ -275,5 +275,19 @@ struct GridDim {
   if (id >= N)                                     \
     return;
 
+// the segment of a TensorSegmentTable holding the position pos of a row, skipping the empty segments
+__device__ __forceinline__ int FindTensorSegment(const int32_t* segment_offsets, int size, int32_t pos) {
+  int first = 0;
+  int last = size - 1;
+  while (first < last) {
+    const int middle = (first + last + 1) / 2;
+    if (segment_offsets[middle] <= pos)
+      first = middle;
+    else
+      last = middle - 1;
+  }
+  return first;
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "cuda_allocator.h"
+#include <iterator>
 #include "cuda_common.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/session_state.h"
@@ -26,18 +27,239 @@ void CUDAAllocator::CheckDevice() const {
 #endif
 }
 
+// A cached block is reused for an allocation if it isn't more than this fraction larger than the request,
+// as the rest of it would be wasted.
+static constexpr size_t kMaxCachedBlockWasteFraction = 4;
+
+CUDAMemoryCache& CUDAMemoryCache::Get(int device_id) {
+  struct Caches {
+    OrtMutex mutex;
+    std::unordered_map<int, CUDAMemoryCache*> caches;
+  };
+  static Caches* caches = new Caches();
+
+  std::lock_guard<OrtMutex> lock(caches->mutex);
+  auto& cache = caches->caches[device_id];
+  if (cache == nullptr) {
+    cache = new CUDAMemoryCache();
+  }
+  return *cache;
+}
+
+void CUDAMemoryCache::SetLimit(size_t bytes) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (bytes > 0 && (bytes_limit_ == 0 || bytes < bytes_limit_)) {
+    bytes_limit_ = bytes;
+  }
+}
+
+void* CUDAMemoryCache::Alloc(size_t size) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  void* p = TakeCachedBlock(size);
+  if (p != nullptr) {
+    return p;
+  }
+
+  if (bytes_limit_ > 0) {
+    if (bytes_in_use_ > bytes_limit_ || size > bytes_limit_ - bytes_in_use_) {
+      return nullptr;
+    }
+    ReleaseCachedBlocks(size);
+  }
+
+  cudaError_t result = cudaMalloc(&p, size);
+  if (result == cudaErrorMemoryAllocation && !cached_blocks_.empty()) {
+    // the memory held in the cache may be what the allocation needs
+    cudaGetLastError();
+    ReleaseAllCachedBlocks();
+    result = cudaMalloc(&p, size);
+  }
+  CUDA_CALL_THROW(result);
+
+  ++num_cuda_mallocs_;
+  block_sizes_[p] = size;
+  bytes_in_use_ += size;
+  return p;
+}
+
+void CUDAMemoryCache::Free(void* p) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto block = block_sizes_.find(p);
+  if (block == block_sizes_.end()) {
+    cudaFree(p);
+    return;
+  }
+
+  // an event on the legacy stream completes once the work issued to all the blocking streams, including the
+  // per-thread streams of every thread, is done
+  CachedBlock cached{p, nullptr};
+  if (cudaEventCreateWithFlags(&cached.freed_event, cudaEventDisableTiming) != cudaSuccess ||
+      cudaEventRecord(cached.freed_event, cudaStreamLegacy) != cudaSuccess) {
+    // it's OK for CUDA calls to fail during shutdown, so the block is released instead
+    cudaGetLastError();
+    if (cached.freed_event != nullptr) {
+      cudaEventDestroy(cached.freed_event);
+    }
+    cudaFree(p);
+    bytes_in_use_ -= block->second;
+    block_sizes_.erase(block);
+    return;
+  }
+
+  cached_blocks_.emplace(block->second, cached);
+  bytes_cached_ += block->second;
+  bytes_in_use_ -= block->second;
+  block_sizes_.erase(block);
+}
+
+void* CUDAMemoryCache::TakeCachedBlock(size_t size) {
+  auto cached = cached_blocks_.lower_bound(size);
+  if (cached == cached_blocks_.end() || cached->first - size > size / kMaxCachedBlockWasteFraction) {
+    return nullptr;
+  }
+
+  const size_t block_size = cached->first;
+  CachedBlock block = cached->second;
+  cached_blocks_.erase(cached);
+  if (block.freed_event != nullptr) {
+    // the work on the block may not be done yet, so the work of this thread waits for it on the device
+    if (cudaEventQuery(block.freed_event) != cudaSuccess) {
+      CUDA_CALL_THROW(cudaStreamWaitEvent(cudaStreamPerThread, block.freed_event, 0));
+    }
+    cudaEventDestroy(block.freed_event);
+  }
+
+  ++num_cache_hits_;
+  block_sizes_[block.ptr] = block_size;
+  bytes_cached_ -= block_size;
+  bytes_in_use_ += block_size;
+  return block.ptr;
+}
+
+void CUDAMemoryCache::ReleaseCachedBlocks(size_t bytes_needed) {
+  // release the largest blocks first, as they are the least likely to fit the next allocations
+  while (!cached_blocks_.empty() && bytes_in_use_ + bytes_cached_ + bytes_needed > bytes_limit_) {
+    auto largest = std::prev(cached_blocks_.end());
+    ReleaseCachedBlock(largest->second);
+    bytes_cached_ -= largest->first;
+    cached_blocks_.erase(largest);
+  }
+}
+
+size_t CUDAMemoryCache::ReleaseAllCachedBlocks() {
+  const size_t released_bytes = bytes_cached_;
+  for (const auto& cached : cached_blocks_) {
+    ReleaseCachedBlock(cached.second);
+  }
+  cached_blocks_.clear();
+  bytes_cached_ = 0;
+  return released_bytes;
+}
+
+void CUDAMemoryCache::ReleaseCachedBlock(const CachedBlock& block) {
+  // cudaFree waits for the work on the device to finish
+  if (block.freed_event != nullptr) {
+    cudaEventDestroy(block.freed_event);
+  }
+  cudaFree(block.ptr);  // do not throw error since it's OK for cudaFree to fail during shutdown
+}
+
+size_t CUDAMemoryCache::ReleaseCachedMemory() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return ReleaseAllCachedBlocks();
+}
+
+CUDAMemoryCache::Stats CUDAMemoryCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return Stats{bytes_in_use_, bytes_cached_, bytes_limit_, cached_blocks_.size(), num_cuda_mallocs_, num_cache_hits_};
+}
+
+CUDAPinnedStagingPool& CUDAPinnedStagingPool::Get(int device_id) {
+  struct Pools {
+    OrtMutex mutex;
+    std::unordered_map<int, CUDAPinnedStagingPool*> pools;
+  };
+  static Pools* pools = new Pools();
+
+  std::lock_guard<OrtMutex> lock(pools->mutex);
+  auto& pool = pools->pools[device_id];
+  if (pool == nullptr) {
+    pool = new CUDAPinnedStagingPool();
+  }
+  return *pool;
+}
+
+void* CUDAPinnedStagingPool::Acquire() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  ++num_acquired_;
+  for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+    if (cudaEventQuery(it->released_event) == cudaSuccess) {
+      Buffer buffer = *it;
+      free_buffers_.erase(it);
+      in_use_[buffer.ptr] = buffer.released_event;
+      return buffer.ptr;
+    }
+  }
+
+  if (num_buffers_ < kMaxBuffers) {
+    Buffer buffer{nullptr, nullptr};
+    if (cudaHostAlloc(&buffer.ptr, kBufferSize, cudaHostAllocDefault) == cudaSuccess) {
+      if (cudaEventCreateWithFlags(&buffer.released_event, cudaEventDisableTiming) == cudaSuccess) {
+        ++num_buffers_;
+        in_use_[buffer.ptr] = buffer.released_event;
+        return buffer.ptr;
+      }
+      cudaFreeHost(buffer.ptr);
+    }
+    // the caller copies without staging instead
+    cudaGetLastError();
+  }
+
+  if (free_buffers_.empty()) {
+    return nullptr;
+  }
+
+  Buffer oldest = free_buffers_.front();
+  free_buffers_.pop_front();
+  in_use_[oldest.ptr] = oldest.released_event;
+  ++num_waits_;
+  lock.unlock();
+  CUDA_CALL_THROW(cudaEventSynchronize(oldest.released_event));
+  return oldest.ptr;
+}
+
+void CUDAPinnedStagingPool::Release(void* buffer, cudaStream_t stream) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = in_use_.find(buffer);
+  ORT_ENFORCE(it != in_use_.end(), "The buffer doesn't belong to the pinned staging pool.");
+  if (cudaEventRecord(it->second, stream) != cudaSuccess) {
+    // the copies using the buffer are waited for instead. the event still holds its last record, which is done.
+    cudaGetLastError();
+    cudaStreamSynchronize(stream);
+  }
+  free_buffers_.push_back({buffer, it->second});
+  in_use_.erase(it);
+}
+
+CUDAPinnedStagingPool::Stats CUDAPinnedStagingPool::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return Stats{num_buffers_, num_acquired_, num_waits_};
+}
+
 void* CUDAAllocator::Alloc(size_t size) {
   CheckDevice();
   void* p = nullptr;
   if (size > 0) {
-    CUDA_CALL_THROW(cudaMalloc((void**)&p, size));
+    p = CUDAMemoryCache::Get(info_.id).Alloc(size);
   }
   return p;
 }
 
 void CUDAAllocator::Free(void* p) {
   CheckDevice();
-  cudaFree(p);  // do not throw error since it's OK for cudaFree to fail during shutdown
+  if (p != nullptr) {
+    CUDAMemoryCache::Get(info_.id).Free(p);
+  }
 }
 
 const OrtMemoryInfo& CUDAAllocator::Info() const {
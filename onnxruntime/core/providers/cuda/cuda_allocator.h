@@ -3,10 +3,119 @@
 
 #pragma once
 
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include "cuda_pch.h"
 #include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
+// Cache of the device memory of all the CUDA allocators of a device, and so of all the sessions using it.
+// The blocks freed by the arena of a session are kept to be reused by the arenas of the others rather than
+// returned to the driver, which only happens when the limit would be exceeded, when cudaMalloc fails or on
+// ReleaseCachedMemory.
+// Device work issued before a block was freed may still be using it, so the stream of the allocating thread
+// waits for that work before a cached block is reused.
+class CUDAMemoryCache {
+ public:
+  struct Stats {
+    size_t bytes_in_use;       // bytes of the blocks handed out
+    size_t bytes_cached;       // bytes of the free blocks kept for reuse
+    size_t bytes_limit;        // limit of bytes_in_use + bytes_cached, 0 if there is none
+    size_t num_cached_blocks;  // fewer and larger cached blocks are more likely to fit the next allocations
+    int64_t num_cuda_mallocs;
+    int64_t num_cache_hits;
+  };
+
+  // Returns the cache of a device. It is never destroyed, as allocators may still free memory during shutdown.
+  static CUDAMemoryCache& Get(int device_id);
+
+  // Lowers the limit of the memory held by the cache to bytes, unless it is 0 or a lower limit is already set.
+  void SetLimit(size_t bytes);
+
+  // Returns nullptr if the memory held by the cache would exceed the limit.
+  void* Alloc(size_t size);
+  void Free(void* p);
+
+  // Returns the cached blocks to the driver, and the number of bytes released.
+  size_t ReleaseCachedMemory();
+
+  Stats GetStats() const;
+
+ private:
+  CUDAMemoryCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAMemoryCache);
+
+  struct CachedBlock {
+    void* ptr;
+    cudaEvent_t freed_event;  // recorded when the block was freed, nullptr if the event couldn't be created
+  };
+
+  // all require mutex_ to be held
+  void* TakeCachedBlock(size_t size);
+  // releases cached blocks until bytes_needed more fit in the limit
+  void ReleaseCachedBlocks(size_t bytes_needed);
+  size_t ReleaseAllCachedBlocks();
+  static void ReleaseCachedBlock(const CachedBlock& block);
+
+  mutable OrtMutex mutex_;
+  std::multimap<size_t, CachedBlock> cached_blocks_;  // by size
+  std::unordered_map<void*, size_t> block_sizes_;     // size of the blocks handed out
+  size_t bytes_in_use_ = 0;
+  size_t bytes_cached_ = 0;
+  size_t bytes_limit_ = 0;
+  int64_t num_cuda_mallocs_ = 0;
+  int64_t num_cache_hits_ = 0;
+};
+
+// Pool of the pinned host buffers through which GPUDataTransfer copies between the device and pageable host
+// memory, such as the feeds and fetches of a Run on the CPU. A copy larger than a buffer is done in chunks, so that
+// the memcpy of a chunk to the device overlaps with the transfer of the previous ones.
+// A buffer returns to the pool with an event of the stream its copy was issued to, and is only handed out again
+// once the event completed, so a host to device copy doesn't wait for the transfer.
+class CUDAPinnedStagingPool {
+ public:
+  static constexpr size_t kBufferSize = 4 << 20;
+
+  struct Stats {
+    size_t num_buffers;  // allocated by cudaHostAlloc
+    int64_t num_acquired;
+    int64_t num_waits;  // acquires that had to wait for the copy of a released buffer to finish
+  };
+
+  // Returns the pool of a device. It is never destroyed, as copies may still be done during shutdown.
+  static CUDAPinnedStagingPool& Get(int device_id);
+
+  // Returns a buffer of kBufferSize bytes, or nullptr if no pinned memory could be allocated.
+  void* Acquire();
+
+  // Returns a buffer to the pool once the work issued to stream so far is done.
+  void Release(void* buffer, cudaStream_t stream);
+
+  Stats GetStats() const;
+
+ private:
+  // beyond it, an acquire waits for the oldest released buffer instead of allocating one
+  static constexpr size_t kMaxBuffers = 16;
+
+  CUDAPinnedStagingPool() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAPinnedStagingPool);
+
+  struct Buffer {
+    void* ptr;
+    cudaEvent_t released_event;
+  };
+
+  mutable OrtMutex mutex_;
+  std::deque<Buffer> free_buffers_;                // in release order
+  std::unordered_map<void*, cudaEvent_t> in_use_;  // events of the buffers handed out
+  size_t num_buffers_ = 0;
+  int64_t num_acquired_ = 0;
+  int64_t num_waits_ = 0;
+};
+
 class CUDAAllocator : public IDeviceAllocator {
  public:
   CUDAAllocator(int device_id, const char* name) : info_(name, OrtAllocatorType::OrtDeviceAllocator, OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id), device_id, OrtMemTypeDefault) {}
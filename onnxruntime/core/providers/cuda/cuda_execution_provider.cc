@@ -6,9 +6,13 @@
 #include "core/framework/memcpy.h"
 #include "cuda_fence.h"
 #include "cuda_allocator.h"
+#include "cuda_profiler.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/compute_capability.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include "core/providers/cuda/math/cublaslt_gemm.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
 
 #ifndef DISABLE_CONTRIB_OPS
 #include "contrib_ops/cuda_contrib_kernels.h"
@@ -26,7 +30,7 @@ ONNX_OPERATOR_KERNEL_EX(
     1,
     kCudaExecutionProvider,
     KernelDefBuilder()
-        .InputMemoryType<OrtMemTypeCPUInput>(0)
+        .SetDefaultInputsMemoryType(OrtMemTypeCPUInput)
         .ExecQueueId(kCudaStreamCopyIn)
         .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
     Memcpy);
@@ -37,7 +41,7 @@ ONNX_OPERATOR_KERNEL_EX(
     1,
     kCudaExecutionProvider,
     KernelDefBuilder()
-        .OutputMemoryType<OrtMemTypeCPUOutput>(0)
+        .SetDefaultOutputMemoryType(OrtMemTypeCPUOutput)
         .ExecQueueId(kCudaStreamCopyOut)
         .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
     Memcpy);
@@ -50,6 +54,16 @@ CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id));
   CUBLAS_CALL_THROW(cublasCreate(&cublas_handle_));
   CUDNN_CALL_THROW(cudnnCreate(&cudnn_handle_));
+#ifdef USE_CUBLASLT
+  CUBLAS_CALL_THROW(cublasLtCreate(&cublaslt_handle_));
+#endif
+
+  // The kernels are launched on the per-thread default stream (see cuda_pch.h and --default-stream per-thread),
+  // so that concurrent Run calls overlap on the device. The libraries would otherwise use the legacy default
+  // stream, which synchronizes with every other blocking stream. cudaStreamPerThread is resolved on every
+  // call, so the handles follow the thread that uses them when a pooled context moves to another thread.
+  CUBLAS_CALL_THROW(cublasSetStream(cublas_handle_, cudaStreamPerThread));
+  CUDNN_CALL_THROW(cudnnSetStream(cudnn_handle_, cudaStreamPerThread));
 
   DeviceAllocatorRegistrationInfo default_memory_info(
       {OrtMemTypeDefault,
@@ -60,11 +74,36 @@ CUDAExecutionProvider::PerThreadContext::PerThreadContext(int device_id) {
 CUDAExecutionProvider::PerThreadContext::~PerThreadContext() {
   CUBLAS_CALL_THROW(cublasDestroy(cublas_handle_));
   CUDNN_CALL_THROW(cudnnDestroy(cudnn_handle_));
+#ifdef USE_CUBLASLT
+  CUBLAS_CALL_THROW(cublasLtDestroy(cublaslt_handle_));
+#endif
 }
 
 CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kCudaExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kCudaExecutionProvider},
+      device_id_(info.device_id),
+      shrink_arena_on_idle_(info.shrink_arena_on_idle),
+      cudnn_conv_algo_cache_path_(info.cudnn_conv_algo_cache_path),
+      cublaslt_algo_cache_path_(info.cublaslt_algo_cache_path) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
+  CUDAMemoryCache::Get(device_id_).SetLimit(info.gpu_mem_limit);
+
+  if (!cudnn_conv_algo_cache_path_.empty()) {
+    // the convolutions are benchmarked again when the file can't be used
+    auto status = cuda::CudnnConvAlgoCache::Instance().Load(cudnn_conv_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to load the cuDNN convolution algorithms: " << status.ErrorMessage();
+    }
+  }
+
+#ifdef USE_CUBLASLT
+  if (!cublaslt_algo_cache_path_.empty()) {
+    auto status = cuda::CublasLtAlgoCache::Instance().Load(cublaslt_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to load the cuBLASLt GEMM algorithms: " << status.ErrorMessage();
+    }
+  }
+#endif
 
   DeviceAllocatorRegistrationInfo default_memory_info(
       {OrtMemTypeDefault, [](int device_id) { return std::make_unique<CUDAAllocator>(device_id, CUDA); }, std::numeric_limits<size_t>::max()});
@@ -99,6 +138,22 @@ CUDAExecutionProvider::~CUDAExecutionProvider() {
     it = deferred_release_cpu_ptr_.erase(it);
   }
   ReleasePerThreadStuffs();
+
+  if (!cudnn_conv_algo_cache_path_.empty()) {
+    auto status = cuda::CudnnConvAlgoCache::Instance().Save(cudnn_conv_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << status.ErrorMessage();
+    }
+  }
+
+#ifdef USE_CUBLASLT
+  if (!cublaslt_algo_cache_path_.empty()) {
+    auto status = cuda::CublasLtAlgoCache::Instance().Save(cublaslt_algo_cache_path_);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << status.ErrorMessage();
+    }
+  }
+#endif
 }
 
 CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadContext() const {
@@ -119,6 +174,25 @@ CUDAExecutionProvider::PerThreadContext& CUDAExecutionProvider::GetPerThreadCont
   return *(p->at(this));
 }
 
+void CUDAExecutionProvider::ShrinkIdleArenas() const {
+  // the contexts in the pool aren't used by any thread, and can't be taken by one while the pool is locked
+  std::lock_guard<OrtMutex> lock(context_pool_mutex_);
+  size_t released_bytes = 0;
+  for (const auto& context : context_pool_) {
+    auto* arena = dynamic_cast<IArenaAllocator*>(context->GetAllocator().get());
+    if (arena != nullptr) {
+      released_bytes += arena->Shrink();
+    }
+  }
+
+  if (released_bytes > 0) {
+    auto stats = CUDAMemoryCache::Get(device_id_).GetStats();
+    LOGS_DEFAULT(VERBOSE) << "Released " << released_bytes << " bytes of the idle CUDA arenas. Device memory in use: "
+                          << stats.bytes_in_use << ", cached: " << stats.bytes_cached << " in "
+                          << stats.num_cached_blocks << " blocks";
+  }
+}
+
 void CUDAExecutionProvider::ReleasePerThreadStuffs() const {
   if (per_thread_context_map_ != nullptr && !per_thread_context_map_->empty()) {
     auto iter_ctx = per_thread_context_map_->find(this);
@@ -164,6 +238,7 @@ void CUDAExecutionProvider::AddDeferredReleaseCPUPtr(void* p) {
 }
 
 Status CUDAExecutionProvider::OnRunStart() {
+  ++num_active_runs_;
   auto cpu_alloc = GetAllocator(0, OrtMemTypeCPU);
   // check if cudaEvents has passed for deferred release
   // note that we need to take a mutex in case of multi-threaded Run()
@@ -192,15 +267,87 @@ Status CUDAExecutionProvider::OnRunStart() {
 }
 
 Status CUDAExecutionProvider::OnRunEnd() {
-  // record deferred release event on default stream, and release per_thread_context
+  const bool idle = --num_active_runs_ == 0;
+
+  // record deferred release event on the per-thread stream, and release per_thread_context
   auto current_deferred_release_event = GetPerThreadContext().GetCurrentDeferredReleaseEvent();
-  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, nullptr));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(current_deferred_release_event, cudaStreamPerThread));
   ReleasePerThreadStuffs();
-  std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
-  deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  {
+    std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+    deferred_release_cpu_ptr_[current_deferred_release_event].recorded = true;
+  }
+
+  if (idle && shrink_arena_on_idle_) {
+    ShrinkIdleArenas();
+  }
   return Status::OK();
 }
 
+std::unique_ptr<profiling::EpProfiler> CUDAExecutionProvider::GetProfiler() {
+  return std::make_unique<CUDAProfiler>([this]() -> size_t {
+    auto arena = std::dynamic_pointer_cast<BFCArena>(GetAllocator(device_id_, OrtMemTypeDefault));
+    return arena != nullptr ? arena->Used() : 0;
+  });
+}
+
+Status CUDAExecutionProvider::BeginGraphCapture() {
+#if CUDART_VERSION >= 10010
+  auto& context = GetPerThreadContext();
+  ORT_RETURN_IF_NOT(context.GraphAllocator() == nullptr, "A CUDA graph is already being captured on this thread.");
+
+  // relaxed, as the arena may still need to grow with cudaMalloc, which isn't captured
+  CUDA_RETURN_IF_ERROR(cudaStreamBeginCapture(cudaStreamPerThread, cudaStreamCaptureModeRelaxed));
+  context.GraphAllocator() = std::make_shared<CUDAGraphAllocator>(context.GetAllocator());
+  return Status::OK();
+#else
+  return IExecutionProvider::BeginGraphCapture();
+#endif
+}
+
+Status CUDAExecutionProvider::EndGraphCapture(std::unique_ptr<CapturedGraph>& graph) {
+#if CUDART_VERSION >= 10010
+  auto& context = GetPerThreadContext();
+  std::shared_ptr<CUDAGraphAllocator> graph_allocator = std::move(context.GraphAllocator());
+  ORT_RETURN_IF_NOT(graph_allocator != nullptr, "No CUDA graph is being captured on this thread.");
+
+  // a capture is invalidated by the work that can't be captured, such as synchronizing with the device.
+  // that isn't worth logging as an error, the caller decides whether to run without the graph.
+  cudaGraph_t cuda_graph = nullptr;
+  cudaError_t result = cudaStreamEndCapture(cudaStreamPerThread, &cuda_graph);
+  if (result != cudaSuccess) {
+    cudaGetLastError();
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CUDA graph capture failed: ", cudaGetErrorString(result));
+  }
+
+  cudaGraphExec_t graph_exec = nullptr;
+  result = cudaGraphInstantiate(&graph_exec, cuda_graph, nullptr, nullptr, 0);
+  CUDA_CALL(cudaGraphDestroy(cuda_graph));
+  CUDA_RETURN_IF_ERROR(result);
+
+  cudaEvent_t replayed_event = nullptr;
+  if (!CUDA_CALL(cudaEventCreateWithFlags(&replayed_event, cudaEventDisableTiming))) {
+    CUDA_CALL(cudaGraphExecDestroy(graph_exec));
+    return Status(common::ONNXRUNTIME, common::FAIL);
+  }
+
+  // the pinned CPU buffers the graph copies from are released with the graph rather than after this Run
+  std::vector<void*> cpu_ptrs;
+  auto current_deferred_release_event = context.GetCurrentDeferredReleaseEvent();
+  if (current_deferred_release_event) {
+    std::lock_guard<OrtMutex> lock(deferred_release_cpu_ptr_mutex_);
+    cpu_ptrs.swap(deferred_release_cpu_ptr_[current_deferred_release_event].cpu_ptrs);
+  }
+
+  graph = std::make_unique<CUDACapturedGraph>(graph_exec, replayed_event, std::move(graph_allocator),
+                                              GetAllocator(CPU_ALLOCATOR_DEVICE_ID, OrtMemTypeCPU),
+                                              std::move(cpu_ptrs));
+  return Status::OK();
+#else
+  return IExecutionProvider::EndGraphCapture(graph);
+#endif
+}
+
 namespace cuda {
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyToHost);
@@ -449,6 +596,10 @@ class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain,
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, float, ReduceLogSumExp);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, double, ReduceLogSumExp);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MLFloat16, ReduceLogSumExp);
+class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, float, TopK);
+class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, MLFloat16, TopK);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, TopK);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, MLFloat16, TopK);
 class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, float, Cast);
 class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, double, Cast);
 class ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, MLFloat16, Cast);
@@ -540,6 +691,12 @@ class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain,
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, Dropout);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign);
 class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, NonMaxSuppression);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger);
+class ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, ConvInteger);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearConv);
 
 static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
   static const BuildKernelCreateInfoFn function_table[] = {
@@ -790,6 +947,10 @@ static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, float, ReduceLogSumExp)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, double, ReduceLogSumExp)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MLFloat16, ReduceLogSumExp)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, float, TopK)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, 9, MLFloat16, TopK)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, TopK)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, MLFloat16, TopK)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, float, Cast)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, double, Cast)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 6, 8, MLFloat16, Cast)>,
@@ -880,6 +1041,12 @@ static void RegisterCudaKernels(KernelRegistry& kernel_registry) {
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 9, MLFloat16, Less)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, float, RoiAlign)>,
       BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, double, RoiAlign)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, NonMaxSuppression)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, uint8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_TYPED_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, int8_t, MatMulInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearMatMul)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, ConvInteger)>,
+      BuildKernelCreateInfo<ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 10, QLinearConv)>,
   };
 
   for (auto& function_table_entry : function_table) {
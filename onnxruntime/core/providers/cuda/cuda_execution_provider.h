@@ -7,9 +7,12 @@
 #include "core/graph/constants.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/execution_provider.h"
+#include "core/providers/cuda/cuda_graph.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "shared_inc/cuda_utils.h"
+#include <atomic>
 #include <deque>
+#include <string>
 
 namespace onnxruntime {
 
@@ -18,6 +21,17 @@ const int CPU_ALLOCATOR_DEVICE_ID = 0;
 // Information needed to construct CUDA execution providers.
 struct CUDAExecutionProviderInfo {
   int device_id{0};
+  // Limit of the device memory held by all the CUDA execution providers of the device, see CUDAMemoryCache.
+  // When several providers set one, the lowest applies. 0 for no limit.
+  size_t gpu_mem_limit{0};
+  // Return the free regions of the arenas to the device memory cache whenever the provider has no Run in
+  // progress, so that other sessions on the device can use the memory.
+  bool shrink_arena_on_idle{false};
+  // File of the cuDNN convolution algorithms found by earlier processes, see CudnnConvAlgoCache. The cache is
+  // loaded from it when the provider is created and saved back to it, with the new entries, when it's destroyed.
+  std::string cudnn_conv_algo_cache_path;
+  // Same for the cuBLASLt GEMM algorithms, see CublasLtAlgoCache. Ignored without cuBLASLt.
+  std::string cublaslt_algo_cache_path;
 };
 
 // Logical device representation.
@@ -34,6 +48,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   Status OnRunEnd() override;
 
+  Status BeginGraphCapture() override;
+
+  Status EndGraphCapture(std::unique_ptr<CapturedGraph>& graph) override;
+
+  std::unique_ptr<profiling::EpProfiler> GetProfiler() override;
+
   cublasHandle_t PerThreadCublasHandle() {
     return GetPerThreadContext().CublasHandle();
   }
@@ -42,6 +62,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
     return GetPerThreadContext().CudnnHandle();
   }
 
+#ifdef USE_CUBLASLT
+  cublasLtHandle_t PerThreadCublasLtHandle() {
+    return GetPerThreadContext().CublasLtHandle();
+  }
+#endif
+
   template <typename T>
   const T* GetConstOnes(size_t count) {
     return GetPerThreadContext().template GetConstOnes<T>(count);
@@ -68,6 +94,10 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
  private:
   int device_id_;
+  bool shrink_arena_on_idle_;
+  std::string cudnn_conv_algo_cache_path_;
+  std::string cublaslt_algo_cache_path_;
+  std::atomic<int> num_active_runs_{0};
 
   struct DeferredReleaseCPUPtrs {
     bool recorded = false;
@@ -89,6 +119,12 @@ class CUDAExecutionProvider : public IExecutionProvider {
       return cudnn_handle_;
     }
 
+#ifdef USE_CUBLASLT
+    cublasLtHandle_t CublasLtHandle() const {
+      return cublaslt_handle_;
+    }
+#endif
+
     cudaEvent_t& GetCurrentDeferredReleaseEvent() {
       return current_deferred_release_event_;
     }
@@ -116,12 +152,24 @@ class CUDAExecutionProvider : public IExecutionProvider {
     }
 
     AllocatorPtr GetAllocator() const {
+      if (graph_allocator_) {
+        return graph_allocator_;
+      }
       return allocator_;
     }
 
+    // set while the work of the thread is captured into a CUDA graph
+    std::shared_ptr<CUDAGraphAllocator>& GraphAllocator() {
+      return graph_allocator_;
+    }
+
    private:
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
+#ifdef USE_CUBLASLT
+    // cuBLASLt takes the stream on every call
+    cublasLtHandle_t cublaslt_handle_ = nullptr;
+#endif
 
     // deferred release for temporary CPU pinned memory used in cudaMemcpyAsync
     // note that cudaEvent will be assigned at OnRunEnd() when PerThreadContext destory
@@ -133,6 +181,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
     std::unique_ptr<cuda::IConstantBuffer<half>> constant_ones_half_;
 
     AllocatorPtr allocator_;
+    std::shared_ptr<CUDAGraphAllocator> graph_allocator_;
   };
 
   // thread local context during execution
@@ -145,6 +194,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   PerThreadContext& GetPerThreadContext() const;
   void ReleasePerThreadStuffs() const;
+  void ShrinkIdleArenas() const;
 };
 
 }  // namespace onnxruntime
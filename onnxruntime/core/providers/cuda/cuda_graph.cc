@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "cuda_common.h"
+#include "cuda_graph.h"
+
+namespace onnxruntime {
+
+CUDAGraphAllocator::~CUDAGraphAllocator() {
+  for (auto p : released_) {
+    allocator_->Free(p);
+  }
+}
+
+void CUDAGraphAllocator::Free(void* p) {
+  std::lock_guard<OrtMutex> lock(released_mutex_);
+  released_.push_back(p);
+}
+
+#if CUDART_VERSION >= 10010
+
+CUDACapturedGraph::~CUDACapturedGraph() {
+  // the buffers can only be released once the last replay is done with them
+  CUDA_CALL(cudaEventSynchronize(replayed_event_));
+  CUDA_CALL(cudaEventDestroy(replayed_event_));
+  CUDA_CALL(cudaGraphExecDestroy(graph_exec_));
+  for (auto p : cpu_ptrs_) {
+    cpu_allocator_->Free(p);
+  }
+}
+
+Status CUDACapturedGraph::Replay() {
+  // an event that was never recorded is complete, so the first replay doesn't wait
+  CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(cudaStreamPerThread, replayed_event_, 0));
+  CUDA_RETURN_IF_ERROR(cudaGraphLaunch(graph_exec_, cudaStreamPerThread));
+  CUDA_RETURN_IF_ERROR(cudaEventRecord(replayed_event_, cudaStreamPerThread));
+  return Status::OK();
+}
+
+#endif
+
+}  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "cuda_pch.h"
+#include "core/platform/ort_mutex.h"
+#include "core/framework/allocator.h"
+#include "core/framework/execution_provider.h"
+
+namespace onnxruntime {
+
+// Allocator of the device memory of a Run that is captured into a CUDA graph.
+// The buffers come from the arena of the capturing thread, but are only returned to it when the allocator is
+// destroyed, as every replay of the graph writes to the same buffers even though the Run released them.
+class CUDAGraphAllocator : public IAllocator {
+ public:
+  explicit CUDAGraphAllocator(AllocatorPtr allocator) : allocator_(allocator) {}
+  ~CUDAGraphAllocator() override;
+
+  void* Alloc(size_t size) override { return allocator_->Alloc(size); }
+  void Free(void* p) override;
+  const OrtMemoryInfo& Info() const override { return allocator_->Info(); }
+  FencePtr CreateFence(const SessionState* session_state) override { return allocator_->CreateFence(session_state); }
+
+ private:
+  AllocatorPtr allocator_;
+
+  OrtMutex released_mutex_;
+  std::vector<void*> released_;
+};
+
+#if CUDART_VERSION >= 10010
+
+// Executable CUDA graph recorded from the per-thread stream of a Run.
+// Replays are ordered on the device, whichever thread submits them, as they share the same buffers.
+// Submitting replays concurrently from several threads is not supported.
+class CUDACapturedGraph final : public CapturedGraph {
+ public:
+  CUDACapturedGraph(cudaGraphExec_t graph_exec, cudaEvent_t replayed_event,
+                    std::shared_ptr<CUDAGraphAllocator> graph_allocator,
+                    AllocatorPtr cpu_allocator, std::vector<void*> cpu_ptrs)
+      : graph_exec_(graph_exec),
+        replayed_event_(replayed_event),
+        graph_allocator_(std::move(graph_allocator)),
+        cpu_allocator_(cpu_allocator),
+        cpu_ptrs_(std::move(cpu_ptrs)) {}
+  ~CUDACapturedGraph() override;
+
+  common::Status Replay() override;
+
+ private:
+  cudaGraphExec_t graph_exec_;
+
+  // recorded after the last replay submitted
+  cudaEvent_t replayed_event_;
+
+  // device buffers written by the graph
+  std::shared_ptr<CUDAGraphAllocator> graph_allocator_;
+
+  // pinned CPU buffers the graph copies to the device, see CUDAExecutionProvider::AddDeferredReleaseCPUPtr
+  AllocatorPtr cpu_allocator_;
+  std::vector<void*> cpu_ptrs_;
+};
+
+#endif
+
+}  // namespace onnxruntime
@@ -8,6 +8,11 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <cublas_v2.h>
+// cuBLASLt runs the GEMMs when available, see cublaslt_gemm.h. Its API is stable since CUDA 11.
+#if CUDART_VERSION >= 11000
+#include <cublasLt.h>
+#define USE_CUBLASLT 1
+#endif
 #include <cusparse.h>
 #include <curand.h>
 #include <cudnn.h>
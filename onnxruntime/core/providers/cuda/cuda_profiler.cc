@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_profiler.h"
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+
+CUDAProfiler::CUDAProfiler(std::function<size_t()> device_memory_in_use)
+    : device_memory_in_use_(std::move(device_memory_in_use)) {
+}
+
+CUDAProfiler::~CUDAProfiler() {
+  for (auto& entry : started_) {
+    free_events_.push_back(entry.second.start);
+  }
+  for (auto& kernel : stopped_) {
+    free_events_.push_back(kernel.start);
+    free_events_.push_back(kernel.stop);
+  }
+  for (auto event : free_events_) {
+    cudaEventDestroy(event);
+  }
+}
+
+cudaEvent_t CUDAProfiler::AcquireEvent() {
+  if (!free_events_.empty()) {
+    auto event = free_events_.back();
+    free_events_.pop_back();
+    return event;
+  }
+
+  cudaEvent_t event = nullptr;
+  CUDA_CALL_THROW(cudaEventCreate(&event));
+  return event;
+}
+
+size_t CUDAProfiler::Start() {
+  KernelEvents kernel;
+  kernel.launch_time = std::chrono::high_resolution_clock::now();
+  kernel.thread_id = logging::GetThreadId();
+  kernel.memory_in_use = device_memory_in_use_();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  kernel.start = AcquireEvent();
+  CUDA_CALL_THROW(cudaEventRecord(kernel.start, cudaStreamPerThread));
+
+  const size_t id = next_id_++;
+  started_.emplace(id, std::move(kernel));
+  return id;
+}
+
+void CUDAProfiler::Stop(size_t id, const std::string& event_name,
+                        std::unordered_map<std::string, std::string>&& event_args) {
+  const size_t memory_in_use = device_memory_in_use_();
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto entry = started_.find(id);
+  if (entry == started_.end()) return;
+
+  KernelEvents kernel = std::move(entry->second);
+  started_.erase(entry);
+
+  kernel.stop = AcquireEvent();
+  CUDA_CALL_THROW(cudaEventRecord(kernel.stop, cudaStreamPerThread));
+  kernel.name = event_name;
+  kernel.args = std::move(event_args);
+  kernel.args["device_memory_delta"] = std::to_string(static_cast<int64_t>(memory_in_use) -
+                                                      static_cast<int64_t>(kernel.memory_in_use));
+  stopped_.push_back(std::move(kernel));
+}
+
+void CUDAProfiler::Collect(bool wait, TimePoint profiling_start_time, std::vector<EventRecord>& events) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (auto kernel = stopped_.begin(); kernel != stopped_.end();) {
+    // the kernels of different threads are on different streams, so later ones may have completed first
+    const cudaError_t completed = wait ? cudaEventSynchronize(kernel->stop) : cudaEventQuery(kernel->stop);
+    if (completed == cudaErrorNotReady) {
+      ++kernel;
+      continue;
+    }
+
+    float elapsed_ms = 0.f;
+    if (completed == cudaSuccess &&
+        cudaEventElapsedTime(&elapsed_ms, kernel->start, kernel->stop) == cudaSuccess) {
+      events.emplace_back(profiling::NODE_EVENT, logging::GetProcessId(), kernel->thread_id, kernel->name,
+                          TimeDiffMicroSeconds(profiling_start_time, kernel->launch_time),
+                          static_cast<long long>(elapsed_ms * 1000), std::move(kernel->args));
+    } else {
+      // e.g. recorded while the stream was captured into a CUDA graph, which has no device time of its own
+      cudaGetLastError();
+    }
+
+    free_events_.push_back(kernel->start);
+    free_events_.push_back(kernel->stop);
+    kernel = stopped_.erase(kernel);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "cuda_pch.h"
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "core/common/profiler.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Times the kernels of the CUDA execution provider with a pair of CUDA events recorded around each kernel on the
+// per-thread stream it's launched on, so the stream is never synchronized while profiling. The events are
+// resolved after the Runs, once the device has passed them.
+// An event has the host time of the launch as time stamp, the device time of the kernel as duration, and the
+// change of the device memory in use over the kernel in its arguments.
+class CUDAProfiler final : public profiling::EpProfiler {
+ public:
+  // device_memory_in_use returns the bytes in use in the arena of the calling thread
+  explicit CUDAProfiler(std::function<size_t()> device_memory_in_use);
+  ~CUDAProfiler() override;
+
+  size_t Start() override;
+  void Stop(size_t id, const std::string& event_name, std::unordered_map<std::string, std::string>&& event_args) override;
+  void Collect(bool wait, TimePoint profiling_start_time, std::vector<EventRecord>& events) override;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CUDAProfiler);
+
+  struct KernelEvents {
+    cudaEvent_t start = nullptr;
+    cudaEvent_t stop = nullptr;
+    TimePoint launch_time;
+    int thread_id = 0;
+    size_t memory_in_use = 0;
+    std::string name;
+    std::unordered_map<std::string, std::string> args;
+  };
+
+  cudaEvent_t AcquireEvent();
+
+  std::function<size_t()> device_memory_in_use_;
+
+  OrtMutex mutex_;
+  size_t next_id_ = 0;
+  // started and not stopped yet, by id
+  std::unordered_map<size_t, KernelEvents> started_;
+  // stopped, in the order they were stopped
+  std::list<KernelEvents> stopped_;
+  std::vector<cudaEvent_t> free_events_;
+};
+
+}  // namespace onnxruntime
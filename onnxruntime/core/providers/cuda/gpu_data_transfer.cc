@@ -2,12 +2,117 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include <algorithm>
+#include <set>
+#include "core/platform/ort_mutex.h"
+#include "cuda_allocator.h"
 #include "cuda_common.h"
 
 namespace onnxruntime {
+
+// The copies of a stream captured into a CUDA graph would be replayed from the staging buffers of the capture,
+// so they are not staged.
+static bool CanStage(cudaStream_t stream) {
+#if CUDART_VERSION >= 10010
+  cudaStreamCaptureStatus capture_status = cudaStreamCaptureStatusNone;
+  if (cudaStreamIsCapturing(stream, &capture_status) != cudaSuccess) {
+    cudaGetLastError();
+    return false;
+  }
+  return capture_status == cudaStreamCaptureStatusNone;
+#else
+  ORT_UNUSED_PARAMETER(stream);
+  return true;
+#endif
+}
+
+// Copies pageable host memory to the device through the pinned staging buffers, which returns once the data is
+// staged rather than when the transfer is done. The copy is ordered with the work of stream.
+static Status CopyHostToDeviceStaged(void* dst, const void* src, size_t bytes, int device_id, cudaStream_t stream) {
+  auto& pool = CUDAPinnedStagingPool::Get(device_id);
+  size_t offset = 0;
+  while (offset < bytes) {
+    void* buffer = pool.Acquire();
+    if (buffer == nullptr) {
+      break;
+    }
+    const size_t chunk = std::min(bytes - offset, CUDAPinnedStagingPool::kBufferSize);
+    memcpy(buffer, static_cast<const char*>(src) + offset, chunk);
+    const cudaError_t result = cudaMemcpyAsync(static_cast<char*>(dst) + offset, buffer, chunk,
+                                               cudaMemcpyHostToDevice, stream);
+    pool.Release(buffer, stream);
+    CUDA_RETURN_IF_ERROR(result);
+    offset += chunk;
+  }
+
+  if (offset < bytes) {
+    // no pinned memory is available, so the rest is copied from the pageable memory, which blocks
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, static_cast<const char*>(src) + offset,
+                                         bytes - offset, cudaMemcpyHostToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
+  }
+  return Status::OK();
+}
+
+// Copies device memory to pageable host memory through a pinned staging buffer, one chunk at a time.
+static Status CopyDeviceToHostStaged(void* dst, const void* src, size_t bytes, int device_id, cudaStream_t stream) {
+  auto& pool = CUDAPinnedStagingPool::Get(device_id);
+  void* buffer = pool.Acquire();
+  if (buffer == nullptr) {
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst, src, bytes, cudaMemcpyDeviceToHost, stream));
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
+    return Status::OK();
+  }
+
+  cudaError_t result = cudaSuccess;
+  for (size_t offset = 0; offset < bytes && result == cudaSuccess; offset += CUDAPinnedStagingPool::kBufferSize) {
+    const size_t chunk = std::min(bytes - offset, CUDAPinnedStagingPool::kBufferSize);
+    result = cudaMemcpyAsync(buffer, static_cast<const char*>(src) + offset, chunk, cudaMemcpyDeviceToHost, stream);
+    if (result == cudaSuccess) {
+      result = cudaStreamSynchronize(stream);
+    }
+    if (result == cudaSuccess) {
+      memcpy(static_cast<char*>(dst) + offset, buffer, chunk);
+    }
+  }
+  pool.Release(buffer, stream);
+  CUDA_RETURN_IF_ERROR(result);
+  return Status::OK();
+}
+// Lets dst_device_id access the memory of src_device_id, so the copies between them go over the peer to peer link
+// rather than through the host. This is done once for each pair of devices, and is skipped when they have no link.
+static void EnablePeerAccess(int src_device_id, int dst_device_id) {
+  static OrtMutex mutex;
+  static std::set<std::pair<int, int>> checked;
+  std::lock_guard<OrtMutex> lock(mutex);
+  if (!checked.emplace(src_device_id, dst_device_id).second) {
+    return;
+  }
+
+  int can_access = 0;
+  if (cudaDeviceCanAccessPeer(&can_access, dst_device_id, src_device_id) != cudaSuccess || !can_access) {
+    cudaGetLastError();
+    return;
+  }
+
+  int current_device = 0;
+  if (cudaGetDevice(&current_device) != cudaSuccess) {
+    cudaGetLastError();
+    return;
+  }
+  if (cudaSetDevice(dst_device_id) == cudaSuccess) {
+    // the peer access may have been enabled by the application already
+    if (cudaDeviceEnablePeerAccess(src_device_id, 0) != cudaSuccess) {
+      cudaGetLastError();
+    }
+  }
+  cudaSetDevice(current_device);
+}
+
 GPUDataTransfer::GPUDataTransfer() {
-  // create streams, default is nullptr
-  streams_[kCudaStreamDefault] = nullptr;
+  // create streams, the default one is the per-thread stream the kernels of the calling thread run on,
+  // so copies between GPU buffers do not synchronize with the Run calls of other threads
+  streams_[kCudaStreamDefault] = cudaStreamPerThread;
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyIn], cudaStreamNonBlocking));
   CUDA_CALL_THROW(cudaStreamCreateWithFlags(&streams_[kCudaStreamCopyOut], cudaStreamNonBlocking));
 }
@@ -34,20 +139,35 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
     if (src_device.Type() == OrtDevice::CPU && src_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copy from pinned memory to GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[exec_queue_id]));
+    } else if (src_device.Type() == OrtDevice::GPU && src_device.Id() != dst_device.Id()) {
+      // copying between the memory of different GPUs, such as the stages of a pipeline, this is non-blocking
+      EnablePeerAccess(src_device.Id(), dst_device.Id());
+      CUDA_RETURN_IF_ERROR(cudaMemcpyPeerAsync(dst_data, dst_device.Id(), src_data, src_device.Id(), bytes,
+                                               streams_[kCudaStreamDefault]));
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, streams_[kCudaStreamDefault]));
+    } else if (CanStage(streams_[kCudaStreamDefault])) {
+      // copy from other CPU memory to GPU through pinned memory, this is non-blocking once the data is staged
+      ORT_RETURN_IF_ERROR(CopyHostToDeviceStaged(dst_data, src_data, bytes, dst_device.Id(),
+                                                 streams_[kCudaStreamDefault]));
     } else {
-      // copy from other CPU memory to GPU, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
+      // copy from other CPU memory to GPU, this is blocking for the calling thread only
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, streams_[kCudaStreamDefault]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[kCudaStreamDefault]));
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU && dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED) {
       // copying from GPU to pinned memory, this is non-blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[exec_queue_id]));
+    } else if (CanStage(streams_[kCudaStreamDefault])) {
+      // copying from GPU to CPU memory through pinned memory, this is blocking for the calling thread only
+      ORT_RETURN_IF_ERROR(CopyDeviceToHostStaged(dst_data, src_data, bytes, src_device.Id(),
+                                                 streams_[kCudaStreamDefault]));
     } else {
-      // copying from GPU to CPU memory, this is blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
+      // copying from GPU to CPU memory, this is blocking for the calling thread only
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, streams_[kCudaStreamDefault]));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(streams_[kCudaStreamDefault]));
     }
   } else {
     // copying between cpu memory
@@ -57,4 +177,100 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst, int e
   return Status::OK();
 }
 
+static bool IsPageableHost(const OrtDevice& device) {
+  return device.Type() == OrtDevice::CPU && device.MemType() != OrtDevice::MemType::CUDA_PINNED;
+}
+
+// offset of the next tensor packed in a staging buffer, aligned for the copies
+static size_t AlignStagingOffset(size_t offset) {
+  constexpr size_t kAlignment = 256;
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs, int exec_queue_id) const {
+  if (src_dst_pairs.empty()) {
+    return Status::OK();
+  }
+
+  // the pairs are from DataTransferManager::CopyTensors, so they all go between the same devices
+  const auto& src_device = src_dst_pairs.front().src.get().Location().device;
+  const auto& dst_device = src_dst_pairs.front().dst.get().Location().device;
+  const bool to_device = IsPageableHost(src_device) && dst_device.Type() == OrtDevice::GPU;
+  const bool to_host = src_device.Type() == OrtDevice::GPU && IsPageableHost(dst_device);
+  cudaStream_t stream = streams_[kCudaStreamDefault];
+  if ((!to_device && !to_host) || !CanStage(stream)) {
+    return IDataTransfer::CopyTensors(src_dst_pairs, exec_queue_id);
+  }
+
+  auto& pool = CUDAPinnedStagingPool::Get(to_device ? dst_device.Id() : src_device.Id());
+  char* buffer = nullptr;
+  size_t buffer_offset = 0;
+  // the copies to the host whose data is in the current buffer
+  std::vector<std::pair<const SrcDstPair*, size_t>> pending;
+
+  // returns the current buffer to the pool, once the data it received from the device is copied to the host
+  auto flush = [&]() -> Status {
+    if (buffer == nullptr) {
+      return Status::OK();
+    }
+    cudaError_t result = cudaSuccess;
+    if (to_host) {
+      result = cudaStreamSynchronize(stream);
+      if (result == cudaSuccess) {
+        for (const auto& entry : pending) {
+          const Tensor& src = entry.first->src;
+          Tensor& dst = entry.first->dst;
+          memcpy(dst.MutableDataRaw(), buffer + entry.second, src.SizeInBytes());
+        }
+      }
+      pending.clear();
+    }
+    pool.Release(buffer, stream);
+    buffer = nullptr;
+    CUDA_RETURN_IF_ERROR(result);
+    return Status::OK();
+  };
+
+  for (const auto& pair : src_dst_pairs) {
+    const Tensor& src = pair.src;
+    Tensor& dst = pair.dst;
+    const size_t bytes = src.SizeInBytes();
+    if (bytes == 0) {
+      continue;
+    }
+    if (bytes > CUDAPinnedStagingPool::kBufferSize) {
+      ORT_RETURN_IF_ERROR(CopyTensor(src, dst, exec_queue_id));
+      continue;
+    }
+
+    if (buffer == nullptr || AlignStagingOffset(buffer_offset) + bytes > CUDAPinnedStagingPool::kBufferSize) {
+      ORT_RETURN_IF_ERROR(flush());
+      buffer = static_cast<char*>(pool.Acquire());
+      buffer_offset = 0;
+      if (buffer == nullptr) {
+        ORT_RETURN_IF_ERROR(CopyTensor(src, dst, exec_queue_id));
+        continue;
+      }
+    }
+
+    const size_t packed_offset = AlignStagingOffset(buffer_offset);
+    cudaError_t result;
+    if (to_device) {
+      memcpy(buffer + packed_offset, src.DataRaw(), bytes);
+      result = cudaMemcpyAsync(dst.MutableDataRaw(), buffer + packed_offset, bytes, cudaMemcpyHostToDevice, stream);
+    } else {
+      result = cudaMemcpyAsync(buffer + packed_offset, src.DataRaw(), bytes, cudaMemcpyDeviceToHost, stream);
+      pending.emplace_back(&pair, packed_offset);
+    }
+    if (result != cudaSuccess) {
+      pending.clear();
+      pool.Release(buffer, stream);
+      CUDA_RETURN_IF_ERROR(result);
+    }
+    buffer_offset = packed_offset + bytes;
+  }
+
+  return flush();
+}
+
 }  // namespace onnxruntime
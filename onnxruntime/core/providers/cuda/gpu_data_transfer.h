@@ -24,6 +24,10 @@ class GPUDataTransfer : public IDataTransfer {
 
   common::Status CopyTensor(const Tensor& src, Tensor& dst, int exec_queue_id) const override;
 
+  // The small tensors copied between the device and pageable host memory share pinned staging buffers, so that
+  // the copies to the host wait for the device once per buffer rather than once per tensor.
+  common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs, int exec_queue_id) const override;
+
   cudaStream_t GetStream(int queue_id) const {
     ORT_ENFORCE(queue_id >= 0 && queue_id < kTotalCudaStreams);
     return streams_[queue_id];
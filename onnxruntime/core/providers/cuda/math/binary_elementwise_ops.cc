@@ -92,6 +92,21 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, Bin
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       x<T>);
 
+// the output of an op that doesn't broadcast an input may use the buffer of that input.
+// Sum, Max and Min with more than 2 inputs accumulate into the output, so they aren't registered in-place.
+#define BINARY_ELEMENTWISE_REGISTER_INPLACE_KERNEL_TYPED(x, ver, T)             \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
+      x,                                                                        \
+      kOnnxDomain,                                                              \
+      ver,                                                                      \
+      T,                                                                        \
+      kCudaExecutionProvider,                                                   \
+      KernelDefBuilder()                                                        \
+          .MayInplace(0, 0)                                                     \
+          .MayInplace(1, 0)                                                     \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),               \
+      x<T>);
+
 #define BINARY_ELEMENTWISE_LOGICALOP_REGISTER_KERNEL_TYPED(x, ver, T)           \
   ONNX_OPERATOR_TYPED_KERNEL_EX(                                                \
       x,                                                                        \
@@ -134,8 +149,8 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, Bin
     return Status::OK();                                                                                         \
   }
 
-#define BINARY_OP_TYPED(name, ver, T)                    \
-  BINARY_ELEMENTWISE_REGISTER_KERNEL_TYPED(name, ver, T) \
+#define BINARY_OP_TYPED(name, ver, T)                            \
+  BINARY_ELEMENTWISE_REGISTER_INPLACE_KERNEL_TYPED(name, ver, T) \
   BINARY_ELEMENTWISE_COMPUTE(name, T)
 
 #define BINARY_LOGICALOP_TYPED(name, ver, T)                       \
@@ -56,23 +56,15 @@ struct BinaryElementwisePreparation {
     // special case for lhs(N,C,H) and rhs (C,1) which is used in conv bias
     // when N == 1: out[id] = op(lhs[id], rhs[id / H])
     // When N > 1:  out[id] = op(lhs[id], rhs[id / H % C])
+    // and the same for lhs (C,1) and rhs(N,C,H), such as a bias added to a MatMul output of (N,C)
     if (lhs_shape == output_shape) {
-      const auto& rhs_dims = rhs_shape.GetDims();
-      int64_t C = 0;
-      if (1 == std::count_if(rhs_dims.begin(), rhs_dims.end(), [&C](int64_t dim) { if (dim > 1) C = dim; return (dim > 1); })) {
-        auto dim_C = std::find(rhs_dims.begin(), rhs_dims.end(), C) - rhs_dims.begin() + output_shape.NumDimensions() - rhs_shape.NumDimensions();
-        int64_t N = output_shape.SizeToDimension(dim_C);
-        int64_t H = (dim_C < out_rank - 1 ? output_shape.SizeFromDimension(dim_C + 1) : 1);
-
-        std::vector<int64_t> new_output_dims;
-        if (N == 1) {
-          output_rank_or_simple_broadcast = static_cast<size_t>(SimpleBroadcast::RightPerChannelBatch1);
-          fdm_H = fast_divmod(gsl::narrow_cast<int>(H));
-        } else {
-          output_rank_or_simple_broadcast = static_cast<size_t>(SimpleBroadcast::RightPerChannelBatchN);
-          fdm_H = fast_divmod(gsl::narrow_cast<int>(H));
-          fdm_C = fast_divmod(gsl::narrow_cast<int>(C));
-        }
+      if (TryPerChannelBroadcast(rhs_shape, output_shape, SimpleBroadcast::RightPerChannelBatch1,
+                                 SimpleBroadcast::RightPerChannelBatchN)) {
+        return Status::OK();
+      }
+    } else if (rhs_shape == output_shape) {
+      if (TryPerChannelBroadcast(lhs_shape, output_shape, SimpleBroadcast::LeftPerChannelBatch1,
+                                 SimpleBroadcast::LeftPerChannelBatchN)) {
         return Status::OK();
       }
     }
@@ -99,6 +91,29 @@ struct BinaryElementwisePreparation {
     ORT_RETURN_IF_NOT(CalculateFdmStrides(fdm_output_strides.CpuSpan(), output_shape.GetDims()));
     return Status::OK();
   }
+
+ private:
+  // checks whether the broadcast input has a single dim C > 1, for the per-channel broadcast cases
+  bool TryPerChannelBroadcast(const TensorShape& channel_shape, const TensorShape& output_shape,
+                              SimpleBroadcast batch1, SimpleBroadcast batchN) {
+    const auto& channel_dims = channel_shape.GetDims();
+    int64_t C = 0;
+    if (1 != std::count_if(channel_dims.begin(), channel_dims.end(), [&C](int64_t dim) { if (dim > 1) C = dim; return (dim > 1); }))
+      return false;
+
+    auto dim_C = std::find(channel_dims.begin(), channel_dims.end(), C) - channel_dims.begin() + output_shape.NumDimensions() - channel_shape.NumDimensions();
+    int64_t N = output_shape.SizeToDimension(dim_C);
+    int64_t H = (dim_C < output_shape.NumDimensions() - 1 ? output_shape.SizeFromDimension(dim_C + 1) : 1);
+
+    fdm_H = fast_divmod(gsl::narrow_cast<int>(H));
+    if (N == 1) {
+      output_rank_or_simple_broadcast = static_cast<size_t>(batch1);
+    } else {
+      output_rank_or_simple_broadcast = static_cast<size_t>(batchN);
+      fdm_C = fast_divmod(gsl::narrow_cast<int>(C));
+    }
+    return true;
+  }
 };
 
 // trait classes to indicate if the kernel supports broadcast
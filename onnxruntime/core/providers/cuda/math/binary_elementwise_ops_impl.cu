@@ -62,6 +62,35 @@ namespace cuda {
 BINARY_OPS()
 #undef BINARY_OP_NAME_EXPR
 
+// fp16 Add, Sub, Mul and Div compute pairs of values with the half2 intrinsics in the vectorized kernels,
+// and in float on the devices before sm5.3, which have no fp16 arithmetic
+#if __CUDA_ARCH__ >= 530
+#define HALF2_OP(name, op, intrinsic) \
+  __device__ __inline__ half2 _##name##2(half2 a, half2 b) { return intrinsic(a, b); }
+#else
+#define HALF2_OP(name, op, intrinsic)                                                               \
+  __device__ __inline__ half2 _##name##2(half2 a, half2 b) {                                        \
+    return __floats2half2_rn(__low2float(a) op __low2float(b), __high2float(a) op __high2float(b)); \
+  }
+#endif
+
+#define HALF2_OP_SPECIALIZATION(name, op, intrinsic)                                            \
+  HALF2_OP(name, op, intrinsic)                                                                 \
+  template <>                                                                                   \
+  struct OP_##name<half> {                                                                      \
+    __device__ __inline__ half operator()(half a, half b) const { return a op b; }              \
+    __device__ __inline__ half2 operator()(half2 a, half2 b) const { return _##name##2(a, b); } \
+  };                                                                                            \
+  template <>                                                                                   \
+  struct HasHalf2Op<OP_##name<half>> {                                                          \
+    static constexpr bool value = true;                                                         \
+  };
+
+HALF2_OP_SPECIALIZATION(Add, +, __hadd2)
+HALF2_OP_SPECIALIZATION(Sub, -, __hsub2)
+HALF2_OP_SPECIALIZATION(Mul, *, __hmul2)
+HALF2_OP_SPECIALIZATION(Div, /, __h2div)
+
 // create specialized impl
 // the postfix of means the types supported by the op:
 // B: uint8_t
@@ -0,0 +1,417 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/math/cublaslt_gemm.h"
+
+#ifdef USE_CUBLASLT
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// first word of the files, followed by the version of cuBLASLt that benchmarked the entries
+constexpr const char* kFileTag = "onnxruntime_cublaslt_algo_cache";
+
+constexpr uint64_t kMaxWorkspaceBytes = 32 * 1024 * 1024;
+constexpr int kMaxCandidates = 8;
+constexpr int kBenchmarkRuns = 3;
+
+static_assert(sizeof(cublasLtMatmulAlgo_t) == sizeof(CublasLtAlgoCache::Result::algo),
+              "The cache doesn't hold a cublasLtMatmulAlgo_t");
+
+template <typename CudaT>
+struct CublasLtTypes;
+
+template <>
+struct CublasLtTypes<float> {
+  using Scale = float;
+  static cudaDataType_t DataType() { return CUDA_R_32F; }
+  static cublasComputeType_t ComputeType() { return CUBLAS_COMPUTE_32F; }
+  static cudaDataType_t ScaleType() { return CUDA_R_32F; }
+};
+
+template <>
+struct CublasLtTypes<double> {
+  using Scale = double;
+  static cudaDataType_t DataType() { return CUDA_R_64F; }
+  static cublasComputeType_t ComputeType() { return CUBLAS_COMPUTE_64F; }
+  static cudaDataType_t ScaleType() { return CUDA_R_64F; }
+};
+
+template <>
+struct CublasLtTypes<half> {
+  using Scale = float;
+  static cudaDataType_t DataType() { return CUDA_R_16F; }
+  static cublasComputeType_t ComputeType() { return CUBLAS_COMPUTE_32F; }
+  static cudaDataType_t ScaleType() { return CUDA_R_32F; }
+};
+
+// largest power of 2 up to 256 the address is a multiple of
+uint32_t Alignment(const void* p) {
+  uint32_t alignment = 256;
+  while (alignment > 1 && reinterpret_cast<uintptr_t>(p) % alignment != 0) {
+    alignment /= 2;
+  }
+  return alignment;
+}
+
+bool ToCublasLtEpilogue(CublasLtEpilogue epilogue, cublasLtEpilogue_t& lt_epilogue) {
+  switch (epilogue) {
+    case CublasLtEpilogue::Default:
+      lt_epilogue = CUBLASLT_EPILOGUE_DEFAULT;
+      return true;
+    case CublasLtEpilogue::Bias:
+      lt_epilogue = CUBLASLT_EPILOGUE_BIAS;
+      return true;
+    case CublasLtEpilogue::ReluBias:
+      lt_epilogue = CUBLASLT_EPILOGUE_RELU_BIAS;
+      return true;
+    case CublasLtEpilogue::GeluBias:
+#if CUDART_VERSION >= 11030
+      lt_epilogue = CUBLASLT_EPILOGUE_GELU_BIAS;
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+// the descriptors of a GEMM
+class GemmDescriptors {
+ public:
+  GemmDescriptors() = default;
+
+  ~GemmDescriptors() {
+    if (preference_ != nullptr) cublasLtMatmulPreferenceDestroy(preference_);
+    if (c_ != nullptr) cublasLtMatrixLayoutDestroy(c_);
+    if (b_ != nullptr) cublasLtMatrixLayoutDestroy(b_);
+    if (a_ != nullptr) cublasLtMatrixLayoutDestroy(a_);
+    if (op_ != nullptr) cublasLtMatmulDescDestroy(op_);
+  }
+
+  Status Init(cudaDataType_t data_type, cublasComputeType_t compute_type, cudaDataType_t scale_type,
+              cublasLtEpilogue_t epilogue, const CublasLtGemmArgs& args) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescCreate(&op_, compute_type, scale_type));
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(op_, CUBLASLT_MATMUL_DESC_TRANSA, &args.trans_a,
+                                                          sizeof(args.trans_a)));
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(op_, CUBLASLT_MATMUL_DESC_TRANSB, &args.trans_b,
+                                                          sizeof(args.trans_b)));
+    if (epilogue != CUBLASLT_EPILOGUE_DEFAULT) {
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(op_, CUBLASLT_MATMUL_DESC_EPILOGUE, &epilogue,
+                                                            sizeof(epilogue)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescSetAttribute(op_, CUBLASLT_MATMUL_DESC_BIAS_POINTER, &args.bias,
+                                                            sizeof(args.bias)));
+    }
+
+    const bool trans_a = args.trans_a != CUBLAS_OP_N;
+    const bool trans_b = args.trans_b != CUBLAS_OP_N;
+    ORT_RETURN_IF_ERROR(CreateLayout(a_, data_type, trans_a ? args.k : args.m, trans_a ? args.m : args.k, args.lda,
+                                     args.stride_a, args.batch_count));
+    ORT_RETURN_IF_ERROR(CreateLayout(b_, data_type, trans_b ? args.n : args.k, trans_b ? args.k : args.n, args.ldb,
+                                     args.stride_b, args.batch_count));
+    ORT_RETURN_IF_ERROR(CreateLayout(c_, data_type, args.m, args.n, args.ldc, args.stride_c, args.batch_count));
+
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceCreate(&preference_));
+    uint64_t max_workspace = kMaxWorkspaceBytes;
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceSetAttribute(
+        preference_, CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &max_workspace, sizeof(max_workspace)));
+    // the heuristic otherwise assumes the pointers are aligned on 256 bytes
+    for (const auto& pointer : {std::make_pair(CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_A_BYTES, args.a),
+                                std::make_pair(CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_B_BYTES, args.b),
+                                std::make_pair(CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_C_BYTES,
+                                               static_cast<const void*>(args.c)),
+                                std::make_pair(CUBLASLT_MATMUL_PREF_MIN_ALIGNMENT_D_BYTES,
+                                               static_cast<const void*>(args.c))}) {
+      uint32_t alignment = Alignment(pointer.second);
+      CUBLAS_RETURN_IF_ERROR(
+          cublasLtMatmulPreferenceSetAttribute(preference_, pointer.first, &alignment, sizeof(alignment)));
+    }
+    return Status::OK();
+  }
+
+  cublasLtMatmulDesc_t op_ = nullptr;
+  cublasLtMatrixLayout_t a_ = nullptr;
+  cublasLtMatrixLayout_t b_ = nullptr;
+  cublasLtMatrixLayout_t c_ = nullptr;
+  cublasLtMatmulPreference_t preference_ = nullptr;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GemmDescriptors);
+
+  static Status CreateLayout(cublasLtMatrixLayout_t& layout, cudaDataType_t data_type, int rows, int cols, int ld,
+                             int64_t stride, int batch_count) {
+    CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutCreate(&layout, data_type, rows, cols, ld));
+    if (batch_count > 1) {
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutSetAttribute(layout, CUBLASLT_MATRIX_LAYOUT_BATCH_COUNT,
+                                                              &batch_count, sizeof(batch_count)));
+      CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutSetAttribute(layout, CUBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET,
+                                                              &stride, sizeof(stride)));
+    }
+    return Status::OK();
+  }
+};
+
+class BenchmarkEvents {
+ public:
+  BenchmarkEvents() = default;
+  ~BenchmarkEvents() {
+    if (start_ != nullptr) cudaEventDestroy(start_);
+    if (stop_ != nullptr) cudaEventDestroy(stop_);
+  }
+
+  Status Init() {
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&start_));
+    CUDA_RETURN_IF_ERROR(cudaEventCreate(&stop_));
+    return Status::OK();
+  }
+
+  cudaEvent_t start_ = nullptr;
+  cudaEvent_t stop_ = nullptr;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BenchmarkEvents);
+};
+
+}  // namespace
+
+CublasLtAlgoCache& CublasLtAlgoCache::Instance() {
+  // leaked, as kernels may still use it while the static objects are destroyed
+  static CublasLtAlgoCache* cache = new CublasLtAlgoCache();
+  return *cache;
+}
+
+CublasLtAlgoCache::Key CublasLtAlgoCache::MakeKey(cudaDataType_t data_type, int device_id,
+                                                  const CublasLtGemmArgs& args) {
+  int major = 0;
+  int minor = 0;
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+
+  return {static_cast<int64_t>(data_type), major * 10 + minor,
+          static_cast<int64_t>(args.trans_a), static_cast<int64_t>(args.trans_b),
+          args.m, args.n, args.k,
+          args.lda, args.stride_a, args.ldb, args.stride_b, args.ldc, args.stride_c, args.batch_count,
+          static_cast<int64_t>(args.epilogue),
+          Alignment(args.a), Alignment(args.b), Alignment(args.c),
+          args.bias != nullptr ? Alignment(args.bias) : 0};
+}
+
+bool CublasLtAlgoCache::Find(const Key& key, Result& result) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!results_.contains(key)) {
+    return false;
+  }
+  result = results_.at(key);
+  return true;
+}
+
+void CublasLtAlgoCache::Insert(const Key& key, const Result& result) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.insert(key, result);
+}
+
+Status CublasLtAlgoCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string tag;
+  size_t version = 0;
+  if (!(file >> tag >> version) || tag != kFileTag) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, path, " is not a cuBLASLt GEMM algorithm cache");
+  }
+  if (version != cublasLtGetVersion()) {
+    LOGS_DEFAULT(WARNING) << "Ignoring the cuBLASLt GEMM algorithms of " << path << ", which were found with cuBLASLt "
+                          << version << " instead of " << cublasLtGetVersion();
+    return Status::OK();
+  }
+
+  // parse the whole file before adding any entry, so that a damaged file doesn't leave half of it in the cache
+  std::vector<std::pair<Key, Result>> entries;
+  size_t key_size = 0;
+  while (file >> key_size) {
+    Key key(key_size);
+    for (auto& value : key) {
+      file >> value;
+    }
+    Result result{};
+    file >> result.found;
+    for (auto& value : result.algo) {
+      file >> value;
+    }
+    if (!(file >> result.workspace_size)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Truncated entry in cuBLASLt GEMM algorithm cache ",
+                             path);
+    }
+    entries.emplace_back(std::move(key), result);
+  }
+  if (!file.eof()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid entry in cuBLASLt GEMM algorithm cache ", path);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : entries) {
+    // the entries benchmarked by this process are more recent
+    if (!results_.contains(entry.first)) {
+      results_.insert(entry.first, entry.second);
+    }
+  }
+  return Status::OK();
+}
+
+Status CublasLtAlgoCache::Save(const std::string& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", path, " to save the cuBLASLt GEMM algorithms");
+  }
+
+  file << kFileTag << ' ' << cublasLtGetVersion() << '\n';
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.for_each([&file](const Key& key, const Result& result) {
+    file << key.size();
+    for (auto value : key) {
+      file << ' ' << value;
+    }
+    file << ' ' << result.found;
+    for (auto value : result.algo) {
+      file << ' ' << value;
+    }
+    file << ' ' << result.workspace_size << '\n';
+  });
+
+  file.flush();
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the cuBLASLt GEMM algorithms to ", path);
+  }
+  return Status::OK();
+}
+
+size_t CublasLtAlgoCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return results_.size();
+}
+
+void CublasLtAlgoCache::Clear() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.clear();
+}
+
+template <typename CudaT>
+Status CublasLtGemm(const CudaKernel& kernel, cublasLtHandle_t handle, int device_id, const CublasLtGemmArgs& args,
+                    bool& computed) {
+  using Types = CublasLtTypes<CudaT>;
+  using Scale = typename Types::Scale;
+  computed = false;
+
+  // the empty GEMMs are left to the cuBLAS API
+  cublasLtEpilogue_t epilogue;
+  if (args.m <= 0 || args.n <= 0 || args.k <= 0 || args.batch_count <= 0 ||
+      !ToCublasLtEpilogue(args.epilogue, epilogue)) {
+    return Status::OK();
+  }
+
+  GemmDescriptors descriptors;
+  ORT_RETURN_IF_ERROR(descriptors.Init(Types::DataType(), Types::ComputeType(), Types::ScaleType(), epilogue, args));
+  const Scale alpha = static_cast<Scale>(args.alpha);
+  const Scale beta = static_cast<Scale>(args.beta);
+
+  auto& cache = CublasLtAlgoCache::Instance();
+  const auto key = CublasLtAlgoCache::MakeKey(Types::DataType(), device_id, args);
+  CublasLtAlgoCache::Result result{};
+  if (!cache.Find(key, result)) {
+    cublasLtMatmulHeuristicResult_t candidates[kMaxCandidates];
+    int num_candidates = 0;
+    if (cublasLtMatmulAlgoGetHeuristic(handle, descriptors.op_, descriptors.a_, descriptors.b_, descriptors.c_,
+                                       descriptors.c_, descriptors.preference_, kMaxCandidates, candidates,
+                                       &num_candidates) != CUBLAS_STATUS_SUCCESS) {
+      num_candidates = 0;
+    }
+
+    cudaStreamCaptureStatus capture_status = cudaStreamCaptureStatusNone;
+    CUDA_RETURN_IF_ERROR(cudaStreamIsCapturing(cudaStreamPerThread, &capture_status));
+    const bool capturing = capture_status != cudaStreamCaptureStatusNone;
+
+    int best = num_candidates > 0 ? 0 : -1;
+    if (num_candidates > 1 && !capturing) {
+      // the candidates write to a scratch C, as the GEMM may read C
+      const size_t c_elements = static_cast<size_t>(args.stride_c) * (args.batch_count - 1) +
+                                static_cast<size_t>(args.ldc) * args.n;
+      auto scratch_c = kernel.GetScratchBuffer<CudaT>(c_elements);
+      CUDA_RETURN_IF_ERROR(cudaMemsetAsync(scratch_c.get(), 0, c_elements * sizeof(CudaT), cudaStreamPerThread));
+      size_t max_workspace = 0;
+      for (int i = 0; i < num_candidates; ++i) {
+        max_workspace = std::max(max_workspace, candidates[i].workspaceSize);
+      }
+      auto workspace = kernel.GetScratchBuffer<void>(max_workspace);
+
+      BenchmarkEvents events;
+      ORT_RETURN_IF_ERROR(events.Init());
+      float best_time = std::numeric_limits<float>::max();
+      best = -1;
+      for (int i = 0; i < num_candidates; ++i) {
+        auto run = [&]() {
+          return cublasLtMatmul(handle, descriptors.op_, &alpha, args.a, descriptors.a_, args.b, descriptors.b_, &beta,
+                                scratch_c.get(), descriptors.c_, scratch_c.get(), descriptors.c_,
+                                &candidates[i].algo, workspace.get(), candidates[i].workspaceSize,
+                                cudaStreamPerThread);
+        };
+        // the first run warms up, an algorithm that fails is skipped
+        if (candidates[i].state != CUBLAS_STATUS_SUCCESS || run() != CUBLAS_STATUS_SUCCESS) {
+          continue;
+        }
+        CUDA_RETURN_IF_ERROR(cudaEventRecord(events.start_, cudaStreamPerThread));
+        for (int r = 0; r < kBenchmarkRuns; ++r) {
+          run();
+        }
+        CUDA_RETURN_IF_ERROR(cudaEventRecord(events.stop_, cudaStreamPerThread));
+        CUDA_RETURN_IF_ERROR(cudaEventSynchronize(events.stop_));
+        float time = 0.f;
+        CUDA_RETURN_IF_ERROR(cudaEventElapsedTime(&time, events.start_, events.stop_));
+        if (time < best_time) {
+          best_time = time;
+          best = i;
+        }
+      }
+    }
+
+    result.found = best >= 0;
+    if (result.found) {
+      memcpy(result.algo.data(), &candidates[best].algo, sizeof(result.algo));
+      result.workspace_size = candidates[best].workspaceSize;
+    }
+    // a choice made without timing the candidates is not kept
+    if (!capturing || num_candidates <= 1) {
+      cache.Insert(key, result);
+    }
+  }
+
+  if (!result.found) {
+    return Status::OK();
+  }
+
+  cublasLtMatmulAlgo_t algo;
+  memcpy(&algo, result.algo.data(), sizeof(algo));
+  auto workspace = kernel.GetScratchBuffer<void>(result.workspace_size);
+  CUBLAS_RETURN_IF_ERROR(cublasLtMatmul(handle, descriptors.op_, &alpha, args.a, descriptors.a_, args.b,
+                                        descriptors.b_, &beta, args.c, descriptors.c_, args.c, descriptors.c_, &algo,
+                                        workspace.get(), result.workspace_size, cudaStreamPerThread));
+  computed = true;
+  return Status::OK();
+}
+
+template Status CublasLtGemm<float>(const CudaKernel&, cublasLtHandle_t, int, const CublasLtGemmArgs&, bool&);
+template Status CublasLtGemm<double>(const CudaKernel&, cublasLtHandle_t, int, const CublasLtGemmArgs&, bool&);
+template Status CublasLtGemm<half>(const CudaKernel&, cublasLtHandle_t, int, const CublasLtGemmArgs&, bool&);
+
+}  // namespace cuda
+}  // namespace onnxruntime
+
+#endif  // USE_CUBLASLT
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+
+#ifdef USE_CUBLASLT
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// Epilogues cuBLASLt applies to the result of the GEMM before writing it
+enum class CublasLtEpilogue : int64_t {
+  Default = 0,
+  // adds the bias, one value per row of C
+  Bias = 1,
+  // Relu of the result with the bias
+  ReluBias = 2,
+  // FastGelu, the tanh approximation of Gelu, of the result with the bias
+  GeluBias = 3,
+};
+
+// A GEMM of column-major matrices, as the cuBLAS API takes them:
+// C = epilogue(alpha * op(A) x op(B) + beta * C) with op(A) m x k, op(B) k x n and C m x n, for each of the
+// batch_count matrices. The matrices of A, B and C are stride_a, stride_b and stride_c elements apart, with a
+// stride of 0 for a matrix A or B shared by the whole batch.
+struct CublasLtGemmArgs {
+  cublasOperation_t trans_a = CUBLAS_OP_N;
+  cublasOperation_t trans_b = CUBLAS_OP_N;
+  int m = 0;
+  int n = 0;
+  int k = 0;
+  const void* a = nullptr;
+  int lda = 0;
+  int64_t stride_a = 0;
+  const void* b = nullptr;
+  int ldb = 0;
+  int64_t stride_b = 0;
+  void* c = nullptr;
+  int ldc = 0;
+  int64_t stride_c = 0;
+  int batch_count = 1;
+  double alpha = 1.0;
+  double beta = 0.0;
+  CublasLtEpilogue epilogue = CublasLtEpilogue::Default;
+  // m values of the type of C for the epilogues with a bias
+  const void* bias = nullptr;
+};
+
+// Process-wide cache of the cuBLASLt algorithms picked for the GEMMs, shared by the MatMul and Gemm kernels of
+// all sessions, so that a GEMM is only benchmarked once per process. Like CudnnConvAlgoCache, the entries can be
+// saved to a file and loaded back by a later process, see CUDAExecutionProviderInfo::cublaslt_algo_cache_path.
+//
+// A key holds the data type, the compute capability of the device, every argument of the GEMM but the pointers
+// and alpha and beta, and the alignment of the pointers, which the algorithms may depend on. A file saved with
+// another version of cuBLASLt is ignored.
+class CublasLtAlgoCache {
+ public:
+  struct Result {
+    // false when cuBLASLt has no algorithm for the GEMM, which the kernels then run through the cuBLAS API
+    bool found;
+    // the opaque cublasLtMatmulAlgo_t
+    std::array<uint64_t, 8> algo;
+    size_t workspace_size;
+  };
+
+  using Key = std::vector<int64_t>;
+
+  static CublasLtAlgoCache& Instance();
+
+  static Key MakeKey(cudaDataType_t data_type, int device_id, const CublasLtGemmArgs& args);
+
+  bool Find(const Key& key, Result& result);
+  void Insert(const Key& key, const Result& result);
+
+  // Adds the entries of the file to the cache. A file that doesn't exist is not an error.
+  common::Status Load(const std::string& path);
+  common::Status Save(const std::string& path) const;
+
+  size_t Size() const;
+  void Clear();
+
+ private:
+  CublasLtAlgoCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CublasLtAlgoCache);
+
+  mutable OrtMutex mutex_;
+  lru_unordered_map<Key, Result, vector_hash<int64_t>> results_{MAX_CACHED_ALGO_PERF_RESULTS};
+};
+
+// Runs the GEMM through cuBLASLt with the algorithm of CublasLtAlgoCache. When the cache has none yet, the
+// candidates of the cuBLASLt heuristic are timed and the fastest one is cached, except while the work is captured
+// into a CUDA graph, which then takes the first candidate. computed is false when cuBLASLt can't run the GEMM,
+// which is left to the caller.
+// CudaT is float, double or half, whose GEMMs accumulate in float as with cublasGemmHelper.
+template <typename CudaT>
+Status CublasLtGemm(const CudaKernel& kernel, cublasLtHandle_t handle, int device_id, const CublasLtGemmArgs& args,
+                    bool& computed);
+
+}  // namespace cuda
+}  // namespace onnxruntime
+
+#endif  // USE_CUBLASLT
@@ -4,6 +4,7 @@
 #include "gemm.h"
 #include "core/providers/cpu/math/gemm_helper.h"
 #include "core/providers/cuda/cudnn_common.h"
+#include "core/providers/cuda/math/cublaslt_gemm.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 
 namespace onnxruntime {
@@ -34,6 +35,25 @@ REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 REGISTER_KERNEL_TYPED(MLFloat16)
 
+#ifdef USE_CUBLASLT
+// The cuBLASLt epilogue adding the bias and applying the activation, if there is one
+static bool ToBiasEpilogue(FusedActivationKind kind, CublasLtEpilogue& epilogue) {
+  switch (kind) {
+    case FusedActivationKind::Identity:
+      epilogue = CublasLtEpilogue::Bias;
+      return true;
+    case FusedActivationKind::Relu:
+      epilogue = CublasLtEpilogue::ReluBias;
+      return true;
+    case FusedActivationKind::FastGelu:
+      epilogue = CublasLtEpilogue::GeluBias;
+      return true;
+    default:
+      return false;
+  }
+}
+#endif
+
 template <typename T>
 Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
@@ -55,8 +75,47 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
   CudaT zero = ToCudaType<T>::FromFloat(0.0f);
 
+  // With an activation, the bias is added by the same pass over Y that applies it, after the product.
+  const FusedActivation& activation = activation_;
+  const bool fuse_bias = activation.kind != FusedActivationKind::Identity;
+
+#ifdef USE_CUBLASLT
+  // Y(N,M) = alpha * op(W) x op(X) + beta * Y, as below
+  CublasLtGemmArgs args;
+  args.trans_a = trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  args.trans_b = trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N;
+  args.m = N;
+  args.n = M;
+  args.k = K;
+  args.a = W->template Data<T>();
+  args.lda = trans_B_ ? K : N;
+  args.b = X->template Data<T>();
+  args.ldb = trans_A_ ? M : K;
+  args.c = out_data;
+  args.ldc = N;
+  args.alpha = alpha_;
+
+  // A bias of N values, one per column of Y, is added by the epilogue of the GEMM, with a Relu or FastGelu
+  // activation, instead of being copied to Y first.
+  const auto& bias_shape = B->Shape();
+  const bool bias_vector = bias_shape.Size() == N &&
+                           (bias_shape.NumDimensions() == 1 || (bias_shape.NumDimensions() == 2 && bias_shape[0] == 1));
+  CublasLtEpilogue epilogue;
+  if (beta_ == 1.0f && bias_vector && ToBiasEpilogue(activation.kind, epilogue)) {
+    args.epilogue = epilogue;
+    args.bias = B->template Data<T>();
+    bool computed = false;
+    ORT_RETURN_IF_ERROR(CublasLtGemm<CudaT>(*this, CublasLtHandle(), GetDeviceId(), args, computed));
+    if (computed) {
+      return Status::OK();
+    }
+    args.epilogue = CublasLtEpilogue::Default;
+    args.bias = nullptr;
+  }
+#endif
+
   // broadcast bias if needed
-  if (beta_ != 0) {
+  if (beta_ != 0 && !fuse_bias) {
     auto& b_shape = B->Shape();
     const CudaT* b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
 
@@ -100,20 +159,43 @@ Status Gemm<T>::ComputeInternal(OpKernelContext* ctx) const {
   }
 
   CudaT alpha = ToCudaType<T>::FromFloat(alpha_);
-  CudaT beta = ToCudaType<T>::FromFloat(beta_);
-  // Gemm, note that CUDA assumes col-major, so Y(N,M) = alpha * op(W) x op(X) + beta * Y
-  CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
-      CublasHandle(),
-      trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N,
-      trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N,
-      N, M, K,
-      &alpha,
-      reinterpret_cast<const CudaT*>(W->template Data<T>()),
-      (trans_B_ ? K : N),
-      reinterpret_cast<const CudaT*>(X->template Data<T>()),
-      (trans_A_ ? M : K),
-      &beta,
-      out_data, N));
+  CudaT beta = fuse_bias ? zero : ToCudaType<T>::FromFloat(beta_);
+  bool computed = false;
+#ifdef USE_CUBLASLT
+  args.beta = fuse_bias ? 0.0f : beta_;
+  ORT_RETURN_IF_ERROR(CublasLtGemm<CudaT>(*this, CublasLtHandle(), GetDeviceId(), args, computed));
+#endif
+  if (!computed) {
+    // Gemm, note that CUDA assumes col-major, so Y(N,M) = alpha * op(W) x op(X) + beta * Y
+    CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
+        CublasHandle(),
+        trans_B_ ? CUBLAS_OP_T : CUBLAS_OP_N,
+        trans_A_ ? CUBLAS_OP_T : CUBLAS_OP_N,
+        N, M, K,
+        &alpha,
+        reinterpret_cast<const CudaT*>(W->template Data<T>()),
+        (trans_B_ ? K : N),
+        reinterpret_cast<const CudaT*>(X->template Data<T>()),
+        (trans_A_ ? M : K),
+        &beta,
+        out_data, N));
+  }
+
+  if (fuse_bias) {
+    const CudaT* b_data = nullptr;
+    int64_t b_inner = 1;
+    int64_t b_size = 1;
+    if (beta_ != 0) {
+      auto& b_shape = B->Shape();
+      b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
+      b_size = b_shape.Size();
+      if (b_size != 1 && b_shape.NumDimensions() == 2 && b_shape[1] == 1 && b_shape[0] != 1) {
+        // B is (M, 1), one value per row
+        b_inner = N;
+      }
+    }
+    BiasActivationImpl(out_data, b_data, beta_, b_inner, b_size, activation, static_cast<size_t>(M) * N);
+  }
 
   return Status::OK();
 }
@@ -4,11 +4,12 @@
 #pragma once
 
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/activation/fused_activation.h"
 
 namespace onnxruntime {
 namespace cuda {
 template <typename T>
-class Gemm final : public CudaKernel {
+class Gemm : public CudaKernel {
   using Base = CudaKernel;
 
  public:
@@ -26,6 +27,10 @@ class Gemm final : public CudaKernel {
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+ protected:
+  // applied to the output along with the bias, set by FusedGemm
+  FusedActivation activation_{FusedActivationKind::Identity, 0.0f, 0.0f};
+
  private:
   bool trans_A_;
   bool trans_B_;
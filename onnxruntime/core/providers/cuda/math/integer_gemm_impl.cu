@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "integer_gemm_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// Each block computes a 64 x 64 tile of C with 16 x 16 threads, every thread 4 x 4 values of the tile that are
+// 16 rows and columns apart, and walks K in steps of 16.
+constexpr int kTileM = 64;
+constexpr int kTileN = 64;
+constexpr int kTileK = 16;
+constexpr int kThreadsX = 16;
+constexpr int kThreadsY = 16;
+constexpr int kThreads = kThreadsX * kThreadsY;
+constexpr int kValuesPerThreadM = kTileM / kThreadsY;
+constexpr int kValuesPerThreadN = kTileN / kThreadsX;
+constexpr int64_t kMaxGridZ = 65535;
+
+__device__ __forceinline__ void StoreAccumulator(int32_t* c, int32_t accumulator, const GemmRequantization&,
+                                                 int64_t, int64_t) {
+  *c = accumulator;
+}
+
+__device__ __forceinline__ void StoreAccumulator(uint8_t* c, int32_t accumulator,
+                                                 const GemmRequantization& requantization,
+                                                 int64_t batch, int64_t row) {
+  if (requantization.bias != nullptr) {
+    accumulator += requantization.bias[batch * requantization.bias_stride + row];
+  }
+  const int32_t value = __float2int_rn(static_cast<float>(accumulator) * requantization.scale) +
+                        static_cast<int32_t>(requantization.zero_point);
+  *c = static_cast<uint8_t>(max(0, min(255, value)));
+}
+
+}  // namespace
+
+template <typename TA, typename TB, typename TC>
+__global__ void _IntegerGemmKernel(int64_t M, int64_t N, int64_t K,
+                                   const TA* a, int64_t lda, int64_t stride_a, int32_t a_zero_point,
+                                   const TB* b, int64_t ldb, int64_t stride_b, int32_t b_zero_point,
+                                   TC* c, int64_t ldc, int64_t stride_c,
+                                   int64_t batch_offset,
+                                   const GemmRequantization requantization) {
+  __shared__ int32_t a_tile[kTileK][kTileM];
+  __shared__ int32_t b_tile[kTileK][kTileN];
+
+  const int64_t batch = batch_offset + blockIdx.z;
+  a += batch * stride_a;
+  b += batch * stride_b;
+  c += batch * stride_c;
+
+  const int64_t tile_row = static_cast<int64_t>(blockIdx.y) * kTileM;
+  const int64_t tile_col = static_cast<int64_t>(blockIdx.x) * kTileN;
+  const int thread_id = threadIdx.y * kThreadsX + threadIdx.x;
+
+  int32_t accumulators[kValuesPerThreadM][kValuesPerThreadN] = {};
+  for (int64_t k0 = 0; k0 < K; k0 += kTileK) {
+    // the padding of the tiles past the matrices is 0 so that it adds nothing
+#pragma unroll
+    for (int i = thread_id; i < kTileM * kTileK; i += kThreads) {
+      const int64_t row = tile_row + i / kTileK;
+      const int64_t k = k0 + i % kTileK;
+      a_tile[i % kTileK][i / kTileK] =
+          (row < M && k < K) ? static_cast<int32_t>(a[row * lda + k]) - a_zero_point : 0;
+    }
+#pragma unroll
+    for (int i = thread_id; i < kTileK * kTileN; i += kThreads) {
+      const int64_t k = k0 + i / kTileN;
+      const int64_t col = tile_col + i % kTileN;
+      b_tile[i / kTileN][i % kTileN] =
+          (k < K && col < N) ? static_cast<int32_t>(b[k * ldb + col]) - b_zero_point : 0;
+    }
+    __syncthreads();
+
+#pragma unroll
+    for (int k = 0; k < kTileK; ++k) {
+      int32_t a_values[kValuesPerThreadM];
+      int32_t b_values[kValuesPerThreadN];
+#pragma unroll
+      for (int i = 0; i < kValuesPerThreadM; ++i) {
+        a_values[i] = a_tile[k][threadIdx.y + i * kThreadsY];
+      }
+#pragma unroll
+      for (int j = 0; j < kValuesPerThreadN; ++j) {
+        b_values[j] = b_tile[k][threadIdx.x + j * kThreadsX];
+      }
+#pragma unroll
+      for (int i = 0; i < kValuesPerThreadM; ++i) {
+#pragma unroll
+        for (int j = 0; j < kValuesPerThreadN; ++j) {
+          accumulators[i][j] += a_values[i] * b_values[j];
+        }
+      }
+    }
+    __syncthreads();
+  }
+
+#pragma unroll
+  for (int i = 0; i < kValuesPerThreadM; ++i) {
+    const int64_t row = tile_row + threadIdx.y + i * kThreadsY;
+    if (row >= M)
+      break;
+#pragma unroll
+    for (int j = 0; j < kValuesPerThreadN; ++j) {
+      const int64_t col = tile_col + threadIdx.x + j * kThreadsX;
+      if (col < N) {
+        StoreAccumulator(c + row * ldc + col, accumulators[i][j], requantization, batch, row);
+      }
+    }
+  }
+}
+
+template <typename TA, typename TB, typename TC>
+static void LaunchIntegerGemm(int64_t M, int64_t N, int64_t K,
+                              const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,
+                              const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,
+                              TC* c, int64_t ldc, int64_t stride_c,
+                              int64_t batch_count,
+                              const GemmRequantization& requantization) {
+  if (M == 0 || N == 0 || batch_count == 0)
+    return;
+
+  const dim3 threads(kThreadsX, kThreadsY);
+  for (int64_t batch_offset = 0; batch_offset < batch_count; batch_offset += kMaxGridZ) {
+    const dim3 blocks(static_cast<unsigned int>((N + kTileN - 1) / kTileN),
+                      static_cast<unsigned int>((M + kTileM - 1) / kTileM),
+                      static_cast<unsigned int>(std::min(kMaxGridZ, batch_count - batch_offset)));
+    _IntegerGemmKernel<TA, TB, TC><<<blocks, threads, 0>>>(
+        M, N, K,
+        a, lda, stride_a, static_cast<int32_t>(a_zero_point),
+        b, ldb, stride_b, static_cast<int32_t>(b_zero_point),
+        c, ldc, stride_c,
+        batch_offset, requantization);
+  }
+}
+
+template <typename TA, typename TB>
+void IntegerGemmImpl(int64_t M, int64_t N, int64_t K,
+                     const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,
+                     const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,
+                     int32_t* c, int64_t ldc, int64_t stride_c,
+                     int64_t batch_count) {
+  LaunchIntegerGemm(M, N, K, a, lda, stride_a, a_zero_point, b, ldb, stride_b, b_zero_point,
+                    c, ldc, stride_c, batch_count, GemmRequantization{nullptr, 0, 1.0f, 0});
+}
+
+template <typename TA, typename TB>
+void QuantizedGemmImpl(int64_t M, int64_t N, int64_t K,
+                       const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,
+                       const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,
+                       uint8_t* c, int64_t ldc, int64_t stride_c,
+                       int64_t batch_count,
+                       const GemmRequantization& requantization) {
+  LaunchIntegerGemm(M, N, K, a, lda, stride_a, a_zero_point, b, ldb, stride_b, b_zero_point,
+                    c, ldc, stride_c, batch_count, requantization);
+}
+
+#define SPECIALIZED_IMPL(TA, TB)                                                                               \
+  template void IntegerGemmImpl<TA, TB>(int64_t M, int64_t N, int64_t K,                                       \
+                                        const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,           \
+                                        const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,           \
+                                        int32_t* c, int64_t ldc, int64_t stride_c,                             \
+                                        int64_t batch_count);                                                  \
+  template void QuantizedGemmImpl<TA, TB>(int64_t M, int64_t N, int64_t K,                                     \
+                                          const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,         \
+                                          const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,         \
+                                          uint8_t* c, int64_t ldc, int64_t stride_c,                           \
+                                          int64_t batch_count,                                                 \
+                                          const GemmRequantization& requantization);
+
+SPECIALIZED_IMPL(uint8_t, uint8_t)
+SPECIALIZED_IMPL(uint8_t, int8_t)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The requantization of the int32 accumulators of a quantized GEMM to uint8, as MlasRequantizeOutput does it:
+// the int32 bias of the row, when there is one, is added to the accumulator, then the sum is scaled, rounded to
+// the nearest even integer, offset by the zero point and saturated to [0, 255].
+struct GemmRequantization {
+  // one value per row of C, bias_stride values apart for the matrices of the batch
+  const int32_t* bias;
+  int64_t bias_stride;
+  float scale;
+  uint8_t zero_point;
+};
+
+// C = (A - a_zero_point) x (B - b_zero_point) for the batch_count row-major matrices A of M x K, B of K x N and
+// C of M x N, which are stride_a, stride_b and stride_c elements apart, with a stride of 0 for a matrix A or B
+// shared by the whole batch. TA and TB are uint8_t or int8_t, and the products accumulate in int32.
+template <typename TA, typename TB>
+void IntegerGemmImpl(int64_t M, int64_t N, int64_t K,
+                     const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,
+                     const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,
+                     int32_t* c, int64_t ldc, int64_t stride_c,
+                     int64_t batch_count);
+
+// The same GEMM with the accumulators requantized to uint8 as they are written to C.
+template <typename TA, typename TB>
+void QuantizedGemmImpl(int64_t M, int64_t N, int64_t K,
+                       const TA* a, int64_t lda, int64_t stride_a, TA a_zero_point,
+                       const TB* b, int64_t ldb, int64_t stride_b, TB b_zero_point,
+                       uint8_t* c, int64_t ldc, int64_t stride_c,
+                       int64_t batch_count,
+                       const GemmRequantization& requantization);
+
+}  // namespace cuda
+}  // namespace onnxruntime
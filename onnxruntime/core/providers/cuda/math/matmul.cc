@@ -5,6 +5,7 @@
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/cuda/shared_inc/fpgeneric.h"
 #include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/math/cublaslt_gemm.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -49,7 +50,44 @@ Status MatMul<T>::ComputeInternal(OpKernelContext* ctx) const {
   CudaT one = ToCudaType<T>::FromFloat(1.0f);
   CudaT zero = ToCudaType<T>::FromFloat(0.0f);
 
-  if (helper.OutputOffsets().size() == 1) {
+  // note that onnxruntime OrtValue is row major, while cublas is column major,
+  // so swap left/right operands
+  const CudaT* left_data = reinterpret_cast<const CudaT*>(left_X->template Data<T>());
+  const CudaT* right_data = reinterpret_cast<const CudaT*>(right_X->template Data<T>());
+  CudaT* output_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
+  const int batch_count = static_cast<int>(helper.OutputOffsets().size());
+  int64_t left_stride = 0;
+  int64_t right_stride = 0;
+  int64_t output_stride = 0;
+  const bool strided = MatMulComputeHelper::GetBatchStride(helper.LeftOffsets(), left_stride) &&
+                       MatMulComputeHelper::GetBatchStride(helper.RightOffsets(), right_stride) &&
+                       MatMulComputeHelper::GetBatchStride(helper.OutputOffsets(), output_stride);
+
+#ifdef USE_CUBLASLT
+  if (strided) {
+    CublasLtGemmArgs args;
+    args.m = static_cast<int>(helper.N());
+    args.n = static_cast<int>(helper.M());
+    args.k = static_cast<int>(helper.K());
+    args.a = right_data;
+    args.lda = static_cast<int>(helper.N());
+    args.stride_a = right_stride;
+    args.b = left_data;
+    args.ldb = static_cast<int>(helper.K());
+    args.stride_b = left_stride;
+    args.c = output_data;
+    args.ldc = static_cast<int>(helper.N());
+    args.stride_c = output_stride;
+    args.batch_count = batch_count;
+    bool computed = false;
+    ORT_RETURN_IF_ERROR(CublasLtGemm<CudaT>(*this, CublasLtHandle(), GetDeviceId(), args, computed));
+    if (computed) {
+      return Status::OK();
+    }
+  }
+#endif
+
+  if (batch_count == 1) {
     CUBLAS_RETURN_IF_ERROR(cublasGemmHelper(
         Base::CublasHandle(),
         CUBLAS_OP_N,
@@ -58,27 +96,50 @@ Status MatMul<T>::ComputeInternal(OpKernelContext* ctx) const {
         static_cast<int>(helper.M()),
         static_cast<int>(helper.K()),
         &one,
-        reinterpret_cast<const CudaT*>(right_X->template Data<T>()),
+        right_data,
         static_cast<int>(helper.N()),
-        reinterpret_cast<const CudaT*>(left_X->template Data<T>()),
+        left_data,
         static_cast<int>(helper.K()),
         &zero,
-        reinterpret_cast<CudaT*>(Y->template MutableData<T>()),
+        output_data,
         static_cast<int>(helper.N())));
     return Status::OK();
   }
+
+  // the strided batched GEMM doesn't upload arrays of pointers
+  if (strided) {
+    CUBLAS_RETURN_IF_ERROR(cublasGemmStridedBatchedHelper(
+        Base::CublasHandle(),
+        CUBLAS_OP_N,
+        CUBLAS_OP_N,
+        static_cast<int>(helper.N()),
+        static_cast<int>(helper.M()),
+        static_cast<int>(helper.K()),
+        &one,
+        right_data,
+        static_cast<int>(helper.N()),
+        right_stride,
+        left_data,
+        static_cast<int>(helper.K()),
+        left_stride,
+        &zero,
+        output_data,
+        static_cast<int>(helper.N()),
+        output_stride,
+        batch_count));
+    return Status::OK();
+  }
+
   CudaAsyncBuffer<const CudaT*> left_arrays(this, helper.LeftOffsets().size());
   CudaAsyncBuffer<const CudaT*> right_arrays(this, helper.RightOffsets().size());
   CudaAsyncBuffer<CudaT*> output_arrays(this, helper.OutputOffsets().size());
-  MatMulComputeHelper::OffsetToArrays(reinterpret_cast<const CudaT*>(left_X->template Data<T>()), helper.LeftOffsets(), left_arrays.CpuSpan());
-  MatMulComputeHelper::OffsetToArrays(reinterpret_cast<const CudaT*>(right_X->template Data<T>()), helper.RightOffsets(), right_arrays.CpuSpan());
-  MatMulComputeHelper::OffsetToArrays(reinterpret_cast<CudaT*>(Y->template MutableData<T>()), helper.OutputOffsets(), output_arrays.CpuSpan());
+  MatMulComputeHelper::OffsetToArrays(left_data, helper.LeftOffsets(), left_arrays.CpuSpan());
+  MatMulComputeHelper::OffsetToArrays(right_data, helper.RightOffsets(), right_arrays.CpuSpan());
+  MatMulComputeHelper::OffsetToArrays(output_data, helper.OutputOffsets(), output_arrays.CpuSpan());
   ORT_RETURN_IF_ERROR(left_arrays.CopyToGpu());
   ORT_RETURN_IF_ERROR(right_arrays.CopyToGpu());
   ORT_RETURN_IF_ERROR(output_arrays.CopyToGpu());
 
-  // note that onnxruntime OrtValue is row major, while cublas is column major,
-  // so swap left/right operands
   CUBLAS_RETURN_IF_ERROR(cublasGemmBatchedHelper(
       Base::CublasHandle(),
       CUBLAS_OP_N,
@@ -94,7 +155,7 @@ Status MatMul<T>::ComputeInternal(OpKernelContext* ctx) const {
       &zero,
       output_arrays.GpuPtr(),
       static_cast<int>(helper.N()),
-      static_cast<int>(helper.OutputOffsets().size())));
+      batch_count));
 
   return Status::OK();
 }
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "matmul_integer.h"
+#include "integer_gemm_impl.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T2)                                        \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                         \
+      MatMulInteger,                                                     \
+      kOnnxDomain,                                                       \
+      10,                                                                \
+      T2,                                                                \
+      kCudaExecutionProvider,                                            \
+      KernelDefBuilder()                                                 \
+          .InputMemoryType<OrtMemTypeCPUInput>(2)                        \
+          .InputMemoryType<OrtMemTypeCPUInput>(3)                        \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())  \
+          .TypeConstraint("T2", DataTypeImpl::GetTensorType<T2>())       \
+          .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()), \
+      MatMulInteger<uint8_t, T2>);
+
+REGISTER_KERNEL_TYPED(uint8_t)
+REGISTER_KERNEL_TYPED(int8_t)
+
+template <typename T1, typename T2>
+Status MatMulInteger<T1, T2>::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  ORT_ENFORCE(a != nullptr && b != nullptr);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  // the zero points are on the CPU
+  T1 a_zero_point = 0;
+  T2 b_zero_point = 0;
+  const Tensor* a_zero_point_tensor = ctx->Input<Tensor>(2);
+  if (a_zero_point_tensor != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_zero_point_tensor),
+                      "MatmulInteger : input1 zero point must be a scalar or 1D tensor of size 1");
+    a_zero_point = *a_zero_point_tensor->template Data<T1>();
+  }
+  const Tensor* b_zero_point_tensor = ctx->Input<Tensor>(3);
+  if (b_zero_point_tensor != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_zero_point_tensor),
+                      "MatmulInteger : input2 zero point must be a scalar or 1D tensor of size 1");
+    b_zero_point = *b_zero_point_tensor->template Data<T2>();
+  }
+
+  const T1* a_data = a->template Data<T1>();
+  const T2* b_data = b->template Data<T2>();
+  int32_t* y_data = y->template MutableData<int32_t>();
+
+  int64_t a_stride = 0;
+  int64_t b_stride = 0;
+  int64_t y_stride = 0;
+  if (MatMulComputeHelper::GetBatchStride(helper.LeftOffsets(), a_stride) &&
+      MatMulComputeHelper::GetBatchStride(helper.RightOffsets(), b_stride) &&
+      MatMulComputeHelper::GetBatchStride(helper.OutputOffsets(), y_stride)) {
+    IntegerGemmImpl(helper.M(), helper.N(), helper.K(),
+                    a_data, helper.K(), a_stride, a_zero_point,
+                    b_data, helper.N(), b_stride, b_zero_point,
+                    y_data, helper.N(), y_stride,
+                    static_cast<int64_t>(helper.OutputOffsets().size()));
+    return Status::OK();
+  }
+
+  // a broadcast over some of the batch dims only
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    IntegerGemmImpl(helper.M(), helper.N(), helper.K(),
+                    a_data + helper.LeftOffsets()[i], helper.K(), 0, a_zero_point,
+                    b_data + helper.RightOffsets()[i], helper.N(), 0, b_zero_point,
+                    y_data + helper.OutputOffsets()[i], helper.N(), 0,
+                    1);
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "quantize_linear_matmul.h"
+#include "integer_gemm_impl.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearMatMul,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(4)
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6)
+        .InputMemoryType<OrtMemTypeCPUInput>(7)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    QLinearMatMul);
+
+Status QLinearMatMul::ComputeInternal(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(3);
+  ORT_ENFORCE(a != nullptr && b != nullptr);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // the scales and the zero points are on the CPU
+  const Tensor* a_scale = ctx->Input<Tensor>(1);
+  const Tensor* a_offset = ctx->Input<Tensor>(2);
+  const Tensor* b_scale = ctx->Input<Tensor>(4);
+  const Tensor* b_offset = ctx->Input<Tensor>(5);
+  const Tensor* y_scale = ctx->Input<Tensor>(6);
+  const Tensor* y_offset = ctx->Input<Tensor>(7);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_offset),
+                    "QLinearMatmul : input zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_offset),
+                    "QLinearMatmul : weight zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_offset),
+                    "QLinearMatmul : result zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(a_scale),
+                    "QLinearMatmul : input scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(b_scale),
+                    "QLinearMatmul : weight scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(y_scale),
+                    "QLinearMatmul : result scale must be a scalar or 1D tensor of size 1");
+
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  GemmRequantization requantization;
+  requantization.bias = nullptr;
+  requantization.bias_stride = 0;
+  requantization.scale = (*a_scale->template Data<float>() * *b_scale->template Data<float>()) /
+                         *y_scale->template Data<float>();
+  requantization.zero_point = *y_offset->template Data<uint8_t>();
+
+  const uint8_t a_zero_point = *a_offset->template Data<uint8_t>();
+  const uint8_t b_zero_point = *b_offset->template Data<uint8_t>();
+  const uint8_t* a_data = a->template Data<uint8_t>();
+  const uint8_t* b_data = b->template Data<uint8_t>();
+  uint8_t* y_data = y->template MutableData<uint8_t>();
+
+  int64_t a_stride = 0;
+  int64_t b_stride = 0;
+  int64_t y_stride = 0;
+  if (MatMulComputeHelper::GetBatchStride(helper.LeftOffsets(), a_stride) &&
+      MatMulComputeHelper::GetBatchStride(helper.RightOffsets(), b_stride) &&
+      MatMulComputeHelper::GetBatchStride(helper.OutputOffsets(), y_stride)) {
+    QuantizedGemmImpl(helper.M(), helper.N(), helper.K(),
+                      a_data, helper.K(), a_stride, a_zero_point,
+                      b_data, helper.N(), b_stride, b_zero_point,
+                      y_data, helper.N(), y_stride,
+                      static_cast<int64_t>(helper.OutputOffsets().size()),
+                      requantization);
+    return Status::OK();
+  }
+
+  // a broadcast over some of the batch dims only
+  for (size_t i = 0; i < helper.OutputOffsets().size(); i++) {
+    QuantizedGemmImpl(helper.M(), helper.N(), helper.K(),
+                      a_data + helper.LeftOffsets()[i], helper.K(), 0, a_zero_point,
+                      b_data + helper.RightOffsets()[i], helper.N(), 0, b_zero_point,
+                      y_data + helper.OutputOffsets()[i], helper.N(), 0,
+                      1,
+                      requantization);
+  }
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <math_constants.h>
+#include "core/common/common.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "softmax_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kWarpSize = 32;
+constexpr int kSoftmaxThreadsPerBlock = 128;
+
+template <bool is_max, int kWidth>
+__device__ __inline__ float _WarpReduce(float value) {
+#pragma unroll
+  for (int offset = kWidth / 2; offset > 0; offset /= 2) {
+    const float other = __shfl_xor_sync(0xffffffff, value, offset, kWidth);
+    value = is_max ? fmaxf(value, other) : value + other;
+  }
+  return value;
+}
+
+// A row of up to 2^kLog2Elements elements is computed by kWidth threads, which keep kIterations of its elements
+// each in registers. The rows past the end still take part in the shuffles of their warp.
+template <typename T, int kLog2Elements>
+__global__ void _SoftmaxWarpForward(T* output, const T* input, const T* mask, int rows, int row_size,
+                                    int rows_per_mask) {
+  constexpr int kElements = 1 << kLog2Elements;
+  constexpr int kWidth = kElements < kWarpSize ? kElements : kWarpSize;
+  constexpr int kIterations = kElements / kWidth;
+
+  const int row = blockIdx.x * blockDim.y + threadIdx.y;
+  const bool is_valid_row = row < rows;
+  const T* row_input = input + static_cast<int64_t>(row) * row_size;
+  const T* row_mask = mask == nullptr ? nullptr : mask + static_cast<int64_t>(row / rows_per_mask) * row_size;
+
+  float values[kIterations];
+  float max_value = -CUDART_INF_F;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int i = it * kWidth + threadIdx.x;
+    float value = -CUDART_INF_F;
+    if (is_valid_row && i < row_size) {
+      value = static_cast<float>(row_input[i]);
+      if (row_mask != nullptr) {
+        value += static_cast<float>(row_mask[i]);
+      }
+    }
+    values[it] = value;
+    max_value = fmaxf(max_value, value);
+  }
+  max_value = _WarpReduce<true, kWidth>(max_value);
+
+  float sum = 0.0f;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    values[it] = expf(values[it] - max_value);
+    sum += values[it];
+  }
+  const float inv_sum = 1.0f / _WarpReduce<false, kWidth>(sum);
+
+  if (!is_valid_row) {
+    return;
+  }
+
+  T* row_output = output + static_cast<int64_t>(row) * row_size;
+#pragma unroll
+  for (int it = 0; it < kIterations; ++it) {
+    const int i = it * kWidth + threadIdx.x;
+    if (i < row_size) {
+      row_output[i] = static_cast<T>(values[it] * inv_sum);
+    }
+  }
+}
+
+template <typename T, int kLog2Elements>
+static void SoftmaxWarpForward(T* output, const T* input, const T* mask, int rows, int row_size,
+                               int rows_per_mask) {
+  constexpr int kElements = 1 << kLog2Elements;
+  constexpr int kWidth = kElements < kWarpSize ? kElements : kWarpSize;
+  const dim3 block(kWidth, kSoftmaxThreadsPerBlock / kWidth);
+  const int blocks = (rows + block.y - 1) / block.y;
+  _SoftmaxWarpForward<T, kLog2Elements><<<blocks, block, 0>>>(output, input, mask, rows, row_size, rows_per_mask);
+}
+
+template <typename T>
+void SoftmaxWarpForwardImpl(T* output, const T* input, const T* mask, int rows, int row_size, int rows_per_mask) {
+  int log2_elements = 0;
+  while ((1 << log2_elements) < row_size) {
+    ++log2_elements;
+  }
+
+  switch (log2_elements) {
+#define CASE_LOG2_ELEMENTS(n)                                                     \
+  case n:                                                                         \
+    SoftmaxWarpForward<T, n>(output, input, mask, rows, row_size, rows_per_mask); \
+    break;
+    CASE_LOG2_ELEMENTS(0)
+    CASE_LOG2_ELEMENTS(1)
+    CASE_LOG2_ELEMENTS(2)
+    CASE_LOG2_ELEMENTS(3)
+    CASE_LOG2_ELEMENTS(4)
+    CASE_LOG2_ELEMENTS(5)
+    CASE_LOG2_ELEMENTS(6)
+    CASE_LOG2_ELEMENTS(7)
+    CASE_LOG2_ELEMENTS(8)
+    CASE_LOG2_ELEMENTS(9)
+    CASE_LOG2_ELEMENTS(10)
+#undef CASE_LOG2_ELEMENTS
+    default:
+      ORT_THROW("The warp softmax handles rows of at most ", kMaxWarpSoftmaxElements, " elements, not ", row_size);
+  }
+}
+
+#define SPECIALIZED_IMPL(T) \
+  template void SoftmaxWarpForwardImpl<T>(T * output, const T* input, const T* mask, int rows, int row_size, int rows_per_mask);
+
+SPECIALIZED_IMPL(float)
+SPECIALIZED_IMPL(half)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The longest rows SoftmaxWarpForwardImpl computes, which are held in the registers of a warp.
+constexpr int kMaxWarpSoftmaxElements = 1024;
+
+// Computes the softmax of each of the rows of row_size elements of the input, row_size being at most
+// kMaxWarpSoftmaxElements. Each row is computed by a warp, or by fewer threads for the rows shorter than a warp,
+// with the reductions done by shuffles in float, including for half. The optional mask is added to the input
+// before the softmax, a row of the mask being shared by rows_per_mask consecutive rows of the input.
+// The output may be the input.
+template <typename T>
+void SoftmaxWarpForwardImpl(T* output, const T* input, const T* mask, int rows, int row_size, int rows_per_mask);
+
+}  // namespace cuda
+}  // namespace onnxruntime
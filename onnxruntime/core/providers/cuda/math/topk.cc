@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "topk.h"
+#include "topk_impl.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+#define REGISTER_KERNEL_TYPED(T)                                                   \
+  ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                         \
+      TopK,                                                                        \
+      kOnnxDomain,                                                                 \
+      1, 9,                                                                        \
+      T,                                                                           \
+      kCudaExecutionProvider,                                                      \
+      KernelDefBuilder()                                                           \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                   \
+          .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),            \
+      TopK<T>);                                                                    \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                   \
+      TopK,                                                                        \
+      kOnnxDomain,                                                                 \
+      10,                                                                          \
+      T,                                                                           \
+      kCudaExecutionProvider,                                                      \
+      KernelDefBuilder()                                                           \
+          .InputMemoryType<OrtMemTypeCPUInput>(1)                                  \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                   \
+          .TypeConstraint("I", DataTypeImpl::GetTensorType<int64_t>()),            \
+      TopK<T>);
+
+template <typename T>
+TopK<T>::TopK(const OpKernelInfo& info) : CudaKernel(info) {
+  ORT_ENFORCE(info.GetAttr<int64_t>("axis", &axis_).IsOK());
+  // k is an attribute before opset 10 and an input since
+  if (info.GetAttr<int64_t>("k", &k_).IsOK()) {
+    ORT_ENFORCE(k_ > 0);
+  } else {
+    k_ = -1;
+  }
+}
+
+template <typename T>
+Status TopK<T>::ComputeInternal(OpKernelContext* ctx) const {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  const Tensor* X = ctx->Input<Tensor>(0);
+  ORT_ENFORCE(X != nullptr);
+
+  int64_t k = k_;
+  if (k < 0) {
+    const Tensor* K = ctx->Input<Tensor>(1);
+    if (K == nullptr || K->Shape().NumDimensions() != 1 || K->Shape()[0] != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k tensor should be a 1D tensor of size 1");
+    }
+    k = K->template Data<int64_t>()[0];
+    if (k < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "value of k must not be negative");
+    }
+  }
+
+  const auto& input_dims = X->Shape().GetDims();
+  const auto axis = HandleNegativeAxis(axis_, input_dims.size());
+  const int64_t dim = input_dims[axis];
+  if (dim < k) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "k argment [", k, "] should not be greater than specified axis dim value [",
+                           dim, "]");
+  }
+
+  std::vector<int64_t> output_dims = input_dims;
+  output_dims[axis] = k;
+  Tensor* values = ctx->Output(0, output_dims);
+  Tensor* indices = ctx->Output(1, output_dims);
+  if (values->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t outer = X->Shape().SizeToDimension(axis);
+  const int64_t inner = X->Shape().SizeFromDimension(axis + 1);
+  const size_t workspace_bytes = TopKWorkspaceSize(outer * inner, k);
+  auto workspace = GetScratchBuffer<void>(workspace_bytes);
+  TopKImpl(reinterpret_cast<const CudaT*>(X->template Data<T>()),
+           reinterpret_cast<CudaT*>(values->template MutableData<T>()),
+           indices->template MutableData<int64_t>(),
+           outer, dim, inner, k, workspace.get(), workspace_bytes);
+  return Status::OK();
+}
+
+REGISTER_KERNEL_TYPED(float)
+REGISTER_KERNEL_TYPED(MLFloat16)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+class TopK final : public CudaKernel {
+ public:
+  TopK(const OpKernelInfo& info);
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  int64_t axis_;
+  // the k attribute before opset 10, -1 when k is the second input
+  int64_t k_;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
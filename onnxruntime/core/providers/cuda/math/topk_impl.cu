@@ -0,0 +1,228 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include <cub/cub.cuh>
+#include "topk_impl.h"
+#include "core/common/common.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kSelectBlockSize = 256;
+constexpr int kRadixBits = 8;
+constexpr int kRadixSize = 1 << kRadixBits;
+constexpr uint32_t kRadixMask = kRadixSize - 1;
+
+// Maps the values to keys with the same order, so that the select and the sort compare unsigned integers.
+// NaN is mapped below -inf, and -0 to +0 so that they are equal as in the CPU kernel.
+__device__ __inline__ uint32_t OrderedKey(float value) {
+  if (isnan(value)) {
+    return 0;
+  }
+  if (value == 0.0f) {
+    return 0x80000000u;
+  }
+  const uint32_t bits = __float_as_uint(value);
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Each block selects the k largest keys of a slice. The digits of the k-th largest key are found from the most
+// significant one, by counting the keys that share the digits found so far. The keys above it and the first
+// keys equal to it are then written to the k entries of the slice, in index order.
+template <typename T>
+__global__ void _RadixSelectTopK(const T* input, int64_t dim, int64_t inner, int64_t k,
+                                 uint32_t* keys, int32_t* indices) {
+  typedef cub::BlockScan<unsigned long long, kSelectBlockSize> BlockScan;
+  __shared__ typename BlockScan::TempStorage scan_storage;
+  __shared__ int histogram[kRadixSize];
+  __shared__ uint32_t kth_prefix;
+  __shared__ int kth_remaining;
+
+  const int64_t slice = blockIdx.x;
+  const T* slice_input = input + (slice / inner) * dim * inner + slice % inner;
+  const int n = static_cast<int>(dim);
+
+  uint32_t prefix = 0;
+  uint32_t prefix_mask = 0;
+  // the number of keys still to select among the ones that match prefix
+  int remaining = static_cast<int>(k);
+  for (int shift = 32 - kRadixBits; shift >= 0; shift -= kRadixBits) {
+    for (int i = threadIdx.x; i < kRadixSize; i += kSelectBlockSize) {
+      histogram[i] = 0;
+    }
+    __syncthreads();
+
+    for (int i = threadIdx.x; i < n; i += kSelectBlockSize) {
+      const uint32_t key = OrderedKey(static_cast<float>(slice_input[i * inner]));
+      if ((key & prefix_mask) == prefix) {
+        atomicAdd(&histogram[(key >> shift) & kRadixMask], 1);
+      }
+    }
+    __syncthreads();
+
+    if (threadIdx.x == 0) {
+      int count = remaining;
+      for (int digit = kRadixSize - 1; digit >= 0; --digit) {
+        if (histogram[digit] >= count) {
+          kth_prefix = prefix | (static_cast<uint32_t>(digit) << shift);
+          kth_remaining = count;
+          break;
+        }
+        count -= histogram[digit];
+      }
+    }
+    __syncthreads();
+
+    prefix = kth_prefix;
+    remaining = kth_remaining;
+    prefix_mask |= kRadixMask << shift;
+  }
+
+  // prefix is now the k-th largest key, of which the first remaining ones are selected.
+  // the counts of the greater and of the equal keys are scanned together, in the low and high halves.
+  uint32_t* slice_keys = keys + slice * k;
+  int32_t* slice_indices = indices + slice * k;
+  unsigned long long counts_before_chunk = 0;
+  for (int chunk = 0; chunk < n; chunk += kSelectBlockSize) {
+    const int i = chunk + threadIdx.x;
+    const uint32_t key = i < n ? OrderedKey(static_cast<float>(slice_input[i * inner])) : 0;
+    const bool greater = i < n && key > prefix;
+    const bool equal = i < n && key == prefix;
+    const unsigned long long count = (equal ? (1ull << 32) : 0ull) | (greater ? 1ull : 0ull);
+
+    unsigned long long counts_before = 0;
+    unsigned long long chunk_counts = 0;
+    BlockScan(scan_storage).ExclusiveSum(count, counts_before, chunk_counts);
+    counts_before += counts_before_chunk;
+    counts_before_chunk += chunk_counts;
+
+    const int greater_before = static_cast<int>(counts_before & 0xffffffffull);
+    const int equal_before = static_cast<int>(counts_before >> 32);
+    if (greater || (equal && equal_before < remaining)) {
+      const int position = greater_before + (equal_before < remaining ? equal_before : remaining);
+      slice_keys[position] = key;
+      slice_indices[position] = i;
+    }
+    __syncthreads();
+  }
+}
+
+__global__ void _FillSegmentOffsets(int* offsets, int segment_size, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  offsets[id] = id * segment_size;
+}
+
+template <typename T>
+__global__ void _WriteTopK(const T* input, const int32_t* sorted_indices, T* values, int64_t* indices,
+                           int64_t dim, fast_divmod fdm_k, fast_divmod fdm_inner, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int slice, l;
+  fdm_k.divmod(id, slice, l);
+  int o, j;
+  fdm_inner.divmod(slice, o, j);
+
+  const int32_t index = sorted_indices[id];
+  const CUDA_LONG output_index = (o * fdm_k.d_ + l) * fdm_inner.d_ + j;
+  values[output_index] = input[(o * dim + index) * fdm_inner.d_ + j];
+  indices[output_index] = index;
+}
+
+size_t AlignUp(size_t bytes) {
+  constexpr size_t kAlignment = 256;
+  return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+struct TopKWorkspace {
+  uint32_t* keys;
+  uint32_t* sorted_keys;
+  int32_t* indices;
+  int32_t* sorted_indices;
+  int* offsets;
+  void* sort_storage;
+  size_t sort_storage_bytes;
+};
+
+// Lays the buffers out from base, which may be null to only compute the size.
+size_t GetWorkspace(int64_t num_slices, int64_t k, char* base, TopKWorkspace& workspace) {
+  const int num_items = static_cast<int>(num_slices * k);
+  const int num_segments = static_cast<int>(num_slices);
+
+  workspace.sort_storage_bytes = 0;
+  cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      nullptr, workspace.sort_storage_bytes, static_cast<const uint32_t*>(nullptr), static_cast<uint32_t*>(nullptr),
+      static_cast<const int32_t*>(nullptr), static_cast<int32_t*>(nullptr), num_items, num_segments,
+      static_cast<int*>(nullptr), static_cast<int*>(nullptr));
+
+  size_t offset = 0;
+  auto take = [&](size_t bytes) {
+    char* p = base == nullptr ? nullptr : base + offset;
+    offset += AlignUp(bytes);
+    return p;
+  };
+  workspace.keys = reinterpret_cast<uint32_t*>(take(num_items * sizeof(uint32_t)));
+  workspace.sorted_keys = reinterpret_cast<uint32_t*>(take(num_items * sizeof(uint32_t)));
+  workspace.indices = reinterpret_cast<int32_t*>(take(num_items * sizeof(int32_t)));
+  workspace.sorted_indices = reinterpret_cast<int32_t*>(take(num_items * sizeof(int32_t)));
+  workspace.offsets = reinterpret_cast<int*>(take((num_segments + 1) * sizeof(int)));
+  workspace.sort_storage = take(workspace.sort_storage_bytes);
+  return offset;
+}
+
+}  // namespace
+
+size_t TopKWorkspaceSize(int64_t num_slices, int64_t k) {
+  TopKWorkspace workspace;
+  return GetWorkspace(num_slices, k, nullptr, workspace);
+}
+
+template <typename T>
+void TopKImpl(const T* input, T* values, int64_t* indices, int64_t outer, int64_t dim, int64_t inner, int64_t k,
+              void* workspace_data, size_t workspace_bytes) {
+  const int64_t num_slices = outer * inner;
+  if (num_slices == 0 || k == 0) {
+    return;
+  }
+
+  TopKWorkspace workspace;
+  const size_t required_bytes = GetWorkspace(num_slices, k, static_cast<char*>(workspace_data), workspace);
+  ORT_ENFORCE(workspace_bytes >= required_bytes, "TopK workspace of ", workspace_bytes, " bytes instead of ",
+              required_bytes);
+
+  _RadixSelectTopK<T><<<static_cast<int>(num_slices), kSelectBlockSize, 0>>>(
+      input, dim, inner, k, workspace.keys, workspace.indices);
+
+  const int32_t* sorted_indices = workspace.indices;
+  if (k > 1) {
+    // the sort is stable, so the equal values stay in index order
+    const CUDA_LONG num_offsets = static_cast<CUDA_LONG>(num_slices + 1);
+    int blocksPerGrid = (int)(ceil(static_cast<float>(num_offsets) / GridDim::maxThreadsPerBlock));
+    _FillSegmentOffsets<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+        workspace.offsets, static_cast<int>(k), num_offsets);
+
+    cub::DeviceSegmentedRadixSort::SortPairsDescending(
+        workspace.sort_storage, workspace.sort_storage_bytes, workspace.keys, workspace.sorted_keys,
+        workspace.indices, workspace.sorted_indices, static_cast<int>(num_slices * k), static_cast<int>(num_slices),
+        workspace.offsets, workspace.offsets + 1);
+    sorted_indices = workspace.sorted_indices;
+  }
+
+  const CUDA_LONG N = static_cast<CUDA_LONG>(num_slices * k);
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _WriteTopK<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input, sorted_indices, values, indices, dim, fast_divmod(static_cast<int>(k)),
+      fast_divmod(static_cast<int>(inner)), N);
+}
+
+#define SPECIALIZED_TOPK_IMPL(T)                                                                                 \
+  template void TopKImpl<T>(const T* input, T* values, int64_t* indices, int64_t outer, int64_t dim,             \
+                            int64_t inner, int64_t k, void* workspace_data, size_t workspace_bytes);
+
+SPECIALIZED_TOPK_IMPL(half)
+SPECIALIZED_TOPK_IMPL(float)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// Size in bytes of the workspace of TopKImpl.
+size_t TopKWorkspaceSize(int64_t num_slices, int64_t k);
+
+// Writes the k largest values of each slice of input, viewed as [outer, dim, inner], along its middle dimension,
+// with their indices, into values and indices of shape [outer, k, inner]. They are sorted by descending value and
+// then by ascending index, and NaN is ordered after every number, as in the CPU kernel.
+// Each slice is processed by a block, which finds the k-th largest value with a radix select and gathers the
+// selected values in index order, then all the slices are sorted at once with a stable segmented radix sort.
+template <typename T>
+void TopKImpl(const T* input, T* values, int64_t* indices, int64_t outer, int64_t dim, int64_t inner, int64_t k,
+              void* workspace, size_t workspace_bytes);
+
+}  // namespace cuda
+}  // namespace onnxruntime
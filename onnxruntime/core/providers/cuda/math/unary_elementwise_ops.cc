@@ -20,7 +20,9 @@ Status UnaryElementwise::Prepare(OpKernelContext* context, UnaryElementwisePrepa
       ver,                                                                      \
       T,                                                                        \
       kCudaExecutionProvider,                                                   \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      KernelDefBuilder()                                                        \
+          .MayInplace(0, 0)                                                     \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),               \
       x<T>);
 
 #define UNARY_ELEMENTWISE_LOGICALOP_REGISTER_KERNEL_TYPED(x, ver, T)                     \
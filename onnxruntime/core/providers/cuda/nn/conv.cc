@@ -44,17 +44,14 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
 
   {
     std::lock_guard<OrtMutex> lock(s_.mutex);
-    // TODO: add a global cache if need to handle cases for multiple frames running simultaneuously with different batch_size
     bool input_dims_changed = (s_.last_x_dims != x_dims);
     bool w_dims_changed = (s_.last_w_dims != w_dims);
     if (input_dims_changed || w_dims_changed) {
       if (input_dims_changed)
         s_.last_x_dims = x_dims;
 
-      if (w_dims_changed) {
+      if (w_dims_changed)
         s_.last_w_dims = w_dims;
-        s_.cached_benchmark_results.clear();
-      }
 
       const int64_t N = X->Shape()[0];
       const int64_t M = W->Shape()[0];
@@ -116,19 +113,28 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
           b_dims[2 + i] = 1;
 
         ORT_RETURN_IF_ERROR(s_.b_tensor.Set(b_dims, CudnnTensor::GetDataType<CudaT>()));
+
+        if (activation_.ActivationKind == MlasReluActivation)
+          ORT_RETURN_IF_ERROR(s_.activation_desc.Set(CUDNN_ACTIVATION_RELU, 0.0));
       }
 
       Tensor* Y = context->Output(0, TensorShape(s_.y_dims));
       y_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
 
-      if (!s_.cached_benchmark_results.contains(x_dims_cudnn)) {
+      auto& algo_cache = CudnnConvAlgoCache::Instance();
+      const auto algo_key = CudnnConvAlgoCache::MakeKey(CudnnConvAlgoCache::Search::Forward,
+                                                        CudnnTensor::GetDataType<CudaT>(), GetDeviceId(),
+                                                        x_dims_cudnn, w_dims, y_dims_cudnn, pads, strides, dilations,
+                                                        group_);
+      CudnnConvAlgoCache::Result perf;
+      if (!algo_cache.Find(algo_key, perf)) {
         IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
 
         // set math type to tensor core before algorithm search
         if (std::is_same<T, MLFloat16>::value)
           CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
 
-        cudnnConvolutionFwdAlgoPerf_t perf;
+        cudnnConvolutionFwdAlgoPerf_t found;
         int algo_count = 1;
         CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionForwardAlgorithmEx(
             CudnnHandle(),
@@ -141,15 +147,15 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
             y_data,
             1,
             &algo_count,
-            &perf,
+            &found,
             algo_search_workspace.get(),
             AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims_cudnn, {perf.algo, perf.memory, perf.mathType});
+        perf = {static_cast<int>(found.algo), found.memory, found.mathType};
+        algo_cache.Insert(algo_key, perf);
       }
 
-      const auto& perf = s_.cached_benchmark_results.at(x_dims_cudnn);
-      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.mathType));
-      s_.algo = perf.algo;
+      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.math_type));
+      s_.algo = static_cast<cudnnConvolutionFwdAlgo_t>(perf.algo);
       s_.workspace_bytes = perf.memory;
     }
   }
@@ -164,6 +170,34 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
 
   IAllocatorUniquePtr<void> workspace = GetScratchBuffer<void>(s_.workspace_bytes);
 
+  const FusedActivation activation = ToFusedActivation(activation_);
+  const CudaT* b_data = has_bias ? reinterpret_cast<const CudaT*>(context->Input<Tensor>(2)->template Data<T>())
+                                 : nullptr;
+
+  // of the activations and data types here, cudnnConvolutionBiasActivationForward only supports Relu on float
+  if (std::is_same<T, float>::value && has_bias && activation.kind == FusedActivationKind::Relu) {
+    // y = relu(conv(x) + 0 * y + b) in a single call
+    CUDNN_RETURN_IF_ERROR(cudnnConvolutionBiasActivationForward(CudnnHandle(),
+                                                                &alpha,
+                                                                s_.x_tensor,
+                                                                x_data,
+                                                                s_.filter_desc,
+                                                                w_data,
+                                                                s_.conv_desc,
+                                                                s_.algo,
+                                                                workspace.get(),
+                                                                s_.workspace_bytes,
+                                                                &beta,
+                                                                s_.y_tensor,
+                                                                y_data,
+                                                                s_.b_tensor,
+                                                                b_data,
+                                                                s_.activation_desc,
+                                                                s_.y_tensor,
+                                                                y_data));
+    return Status::OK();
+  }
+
   CUDNN_RETURN_IF_ERROR(cudnnConvolutionForward(CudnnHandle(),
                                                 &alpha,
                                                 s_.x_tensor,
@@ -178,15 +212,36 @@ Status Conv<T>::ComputeInternal(OpKernelContext* context) const {
                                                 s_.y_tensor,
                                                 y_data));
 
-  if (has_bias) {
-    const Tensor* B = context->Input<Tensor>(2);
-    auto b_data = reinterpret_cast<const CudaT*>(B->template Data<T>());
+  if (activation.kind != FusedActivationKind::Identity) {
+    // add the bias of each channel and apply the activation in the same pass over y
+    const TensorShape y_shape(s_.y_dims);
+    BiasActivationImpl(y_data, b_data, 1.0f, y_shape.SizeFromDimension(2), y_shape[1], activation,
+                       static_cast<size_t>(y_shape.Size()));
+  } else if (has_bias) {
     CUDNN_RETURN_IF_ERROR(cudnnAddTensor(CudnnHandle(), &alpha, s_.b_tensor, b_data, &alpha, s_.y_tensor, y_data));
   }
 
   return Status::OK();
 }
 
+CudnnActivationDescriptor::CudnnActivationDescriptor() : desc_(nullptr) {
+}
+
+CudnnActivationDescriptor::~CudnnActivationDescriptor() {
+  if (desc_ != nullptr) {
+    cudnnDestroyActivationDescriptor(desc_);
+    desc_ = nullptr;
+  }
+}
+
+Status CudnnActivationDescriptor::Set(cudnnActivationMode_t mode, double coef) {
+  if (!desc_)
+    CUDNN_RETURN_IF_ERROR(cudnnCreateActivationDescriptor(&desc_));
+
+  CUDNN_RETURN_IF_ERROR(cudnnSetActivationDescriptor(desc_, mode, CUDNN_NOT_PROPAGATE_NAN, coef));
+  return Status::OK();
+}
+
 CudnnConvolutionDescriptor::CudnnConvolutionDescriptor() : desc_(nullptr) {
 }
 
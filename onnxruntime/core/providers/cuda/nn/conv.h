@@ -8,7 +8,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cpu/nn/conv_base.h"
-#include <list>
+#include "core/providers/cuda/activation/fused_activation.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -31,84 +32,19 @@ class CudnnConvolutionDescriptor final {
   cudnnConvolutionDescriptor_t desc_;
 };
 
-template <typename T>
-struct vector_hash {
-  std::size_t operator()(const std::vector<T>& values) const {
-    std::size_t seed = values.size();
-    for (auto& val : values)
-      seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    return seed;
-  }
-};
-
-template <typename Key, typename T,
-          typename Hash = std::hash<Key>,
-          typename KeyEqual = std::equal_to<Key>,
-          typename ListAllocator = std::allocator<Key>>
-class lru_unordered_map {
+class CudnnActivationDescriptor final {
  public:
-  lru_unordered_map(size_t max_size) : max_size_(max_size) {}
-
-  void insert(const Key& key, const T& value) {
-    auto it = items_.find(key);
-    if (it != items_.end()) {
-      it->second.value = value;
-      move_to_front(it->second.lru_iterator);
-      return;
-    }
-
-    while (size() + 1 > max_size_) {
-      items_.erase(lru_list_.back());
-      lru_list_.pop_back();
-    }
-
-    lru_list_.emplace_front(key);
-    items_.emplace(key, value_type{value, lru_list_.begin()});
-  }
+  CudnnActivationDescriptor();
+  ~CudnnActivationDescriptor();
 
-  T& at(const Key& key) {
-    auto it = items_.find(key);
-    if (it == items_.end()) {
-      throw std::out_of_range("There is no such key in cache");
-    }
-    move_to_front(it->second.lru_iterator);
-    return it->second.value;
-  }
+  Status Set(cudnnActivationMode_t mode, double coef);
 
-  bool contains(const Key& key) const {
-    return items_.find(key) != items_.end();
-  }
+  operator cudnnActivationDescriptor_t() const { return desc_; }
 
-  size_t size() const {
-    return items_.size();
-  }
-
-  void clear() {
-    items_.clear();
-    lru_list_.clear();
-  }
-
-private:
-  using list_type = std::list<Key, ListAllocator>;
-  using iterator_type = typename list_type::iterator;
-  struct value_type {
-    T value;
-    iterator_type lru_iterator;
-  };
-  using MapAllocator = std::allocator<std::pair<const Key, value_type>>;
-
-  void move_to_front(iterator_type it) {
-    lru_list_.splice(lru_list_.begin(), lru_list_, it);
-  }
-
-  size_t max_size_;
-  std::unordered_map<Key, value_type, Hash, KeyEqual, MapAllocator> items_;
-  list_type lru_list_;
+ private:
+  cudnnActivationDescriptor_t desc_;
 };
 
-// cached cudnn descriptors
-constexpr size_t MAX_CACHED_ALGO_PERF_RESULTS = 10000;
-
 template <typename AlgoPerfType>
 struct CudnnConvState {
   // if x/w dims changed, update algo and cudnnTensors
@@ -124,14 +60,7 @@ struct CudnnConvState {
   CudnnTensor b_tensor;
   CudnnTensor y_tensor;
   CudnnConvolutionDescriptor conv_desc;
-
-  struct PerfResultParams {
-    decltype(AlgoPerfType().algo)     algo;
-    decltype(AlgoPerfType().memory)   memory;
-    decltype(AlgoPerfType().mathType) mathType;
-  };
-
-  lru_unordered_map<std::vector<int64_t>, PerfResultParams, vector_hash<int64_t>> cached_benchmark_results { MAX_CACHED_ALGO_PERF_RESULTS };
+  CudnnActivationDescriptor activation_desc;
 
   // note that conv objects are shared between execution frames, and a lock is needed to avoid multi-thread racing
   OrtMutex mutex;
@@ -151,10 +80,15 @@ class Conv : public CudaKernel, public ConvBase {
     for (size_t i = 0; i < rank; i++) {
       ORT_ENFORCE(pads_[i] == pads_[i + rank], "cudnn only supports symmetric padding");
     }
+    activation_.ActivationKind = MlasIdentityActivation;
   }
 
   Status ComputeInternal(OpKernelContext* context) const override;
 
+ protected:
+  // applied to the output along with the bias, set by FusedConv
+  MLAS_ACTIVATION activation_;
+
  private:
   mutable CudnnConvState<cudnnConvolutionFwdAlgoPerf_t> s_;
 };
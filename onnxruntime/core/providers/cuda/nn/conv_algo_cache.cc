@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+#include <fstream>
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// first word of the files, followed by the version of cuDNN that benchmarked the entries
+constexpr const char* kFileTag = "onnxruntime_cudnn_conv_algo_cache";
+
+}  // namespace
+
+CudnnConvAlgoCache& CudnnConvAlgoCache::Instance() {
+  // leaked, as kernels may still use it while the static objects are destroyed
+  static CudnnConvAlgoCache* cache = new CudnnConvAlgoCache();
+  return *cache;
+}
+
+CudnnConvAlgoCache::Key CudnnConvAlgoCache::MakeKey(Search search, cudnnDataType_t data_type, int device_id,
+                                                    const std::vector<int64_t>& x_dims,
+                                                    const std::vector<int64_t>& w_dims,
+                                                    const std::vector<int64_t>& y_dims,
+                                                    const std::vector<int64_t>& pads,
+                                                    const std::vector<int64_t>& strides,
+                                                    const std::vector<int64_t>& dilations,
+                                                    int64_t group) {
+  int major = 0;
+  int minor = 0;
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, device_id));
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, device_id));
+
+  // every list is prefixed by its size, so two different convolutions never make the same key
+  Key key{static_cast<int64_t>(search), static_cast<int64_t>(data_type), major * 10 + minor, group};
+  for (const auto* dims : {&x_dims, &w_dims, &y_dims, &pads, &strides, &dilations}) {
+    key.push_back(static_cast<int64_t>(dims->size()));
+    key.insert(key.end(), dims->cbegin(), dims->cend());
+  }
+  return key;
+}
+
+bool CudnnConvAlgoCache::Find(const Key& key, Result& result) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (!results_.contains(key)) {
+    return false;
+  }
+  result = results_.at(key);
+  return true;
+}
+
+void CudnnConvAlgoCache::Insert(const Key& key, const Result& result) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.insert(key, result);
+}
+
+Status CudnnConvAlgoCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    return Status::OK();
+  }
+
+  std::string tag;
+  size_t version = 0;
+  if (!(file >> tag >> version) || tag != kFileTag) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, path, " is not a cuDNN convolution algorithm cache");
+  }
+  if (version != cudnnGetVersion()) {
+    LOGS_DEFAULT(WARNING) << "Ignoring the cuDNN convolution algorithms of " << path << ", which were found with cuDNN "
+                          << version << " instead of " << cudnnGetVersion();
+    return Status::OK();
+  }
+
+  // parse the whole file before adding any entry, so that a damaged file doesn't leave half of it in the cache
+  std::vector<std::pair<Key, Result>> entries;
+  size_t key_size = 0;
+  while (file >> key_size) {
+    Key key(key_size);
+    for (auto& value : key) {
+      file >> value;
+    }
+    int math_type = 0;
+    Result result{};
+    if (!(file >> result.algo >> result.memory >> math_type)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Truncated entry in cuDNN convolution algorithm cache ",
+                             path);
+    }
+    result.math_type = static_cast<cudnnMathType_t>(math_type);
+    entries.emplace_back(std::move(key), result);
+  }
+  if (!file.eof()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid entry in cuDNN convolution algorithm cache ", path);
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& entry : entries) {
+    // the entries benchmarked by this process are more recent
+    if (!results_.contains(entry.first)) {
+      results_.insert(entry.first, entry.second);
+    }
+  }
+  return Status::OK();
+}
+
+Status CudnnConvAlgoCache::Save(const std::string& path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open ", path, " to save the cuDNN convolution algorithms");
+  }
+
+  file << kFileTag << ' ' << cudnnGetVersion() << '\n';
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.for_each([&file](const Key& key, const Result& result) {
+    file << key.size();
+    for (auto value : key) {
+      file << ' ' << value;
+    }
+    file << ' ' << result.algo << ' ' << result.memory << ' ' << static_cast<int>(result.math_type) << '\n';
+  });
+
+  file.flush();
+  if (!file) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to save the cuDNN convolution algorithms to ", path);
+  }
+  return Status::OK();
+}
+
+size_t CudnnConvAlgoCache::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return results_.size();
+}
+
+void CudnnConvAlgoCache::Clear() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  results_.clear();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+template <typename T>
+struct vector_hash {
+  std::size_t operator()(const std::vector<T>& values) const {
+    std::size_t seed = values.size();
+    for (auto& val : values)
+      seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+
+template <typename Key, typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>,
+          typename ListAllocator = std::allocator<Key>>
+class lru_unordered_map {
+ public:
+  lru_unordered_map(size_t max_size) : max_size_(max_size) {}
+
+  void insert(const Key& key, const T& value) {
+    auto it = items_.find(key);
+    if (it != items_.end()) {
+      it->second.value = value;
+      move_to_front(it->second.lru_iterator);
+      return;
+    }
+
+    while (size() + 1 > max_size_) {
+      items_.erase(lru_list_.back());
+      lru_list_.pop_back();
+    }
+
+    lru_list_.emplace_front(key);
+    items_.emplace(key, value_type{value, lru_list_.begin()});
+  }
+
+  T& at(const Key& key) {
+    auto it = items_.find(key);
+    if (it == items_.end()) {
+      throw std::out_of_range("There is no such key in cache");
+    }
+    move_to_front(it->second.lru_iterator);
+    return it->second.value;
+  }
+
+  bool contains(const Key& key) const {
+    return items_.find(key) != items_.end();
+  }
+
+  size_t size() const {
+    return items_.size();
+  }
+
+  void clear() {
+    items_.clear();
+    lru_list_.clear();
+  }
+
+  // visits the entries from the least recently used, so that inserting them in order restores the same order
+  template <typename Fn>
+  void for_each(Fn fn) const {
+    for (auto it = lru_list_.rbegin(); it != lru_list_.rend(); ++it) {
+      fn(*it, items_.at(*it).value);
+    }
+  }
+
+private:
+  using list_type = std::list<Key, ListAllocator>;
+  using iterator_type = typename list_type::iterator;
+  struct value_type {
+    T value;
+    iterator_type lru_iterator;
+  };
+  using MapAllocator = std::allocator<std::pair<const Key, value_type>>;
+
+  void move_to_front(iterator_type it) {
+    lru_list_.splice(lru_list_.begin(), lru_list_, it);
+  }
+
+  size_t max_size_;
+  std::unordered_map<Key, value_type, Hash, KeyEqual, MapAllocator> items_;
+  list_type lru_list_;
+};
+
+// cached cudnn descriptors
+constexpr size_t MAX_CACHED_ALGO_PERF_RESULTS = 10000;
+
+// Process-wide cache of the convolution algorithms picked by cudnnFind*AlgorithmEx, shared by all Conv and
+// ConvTranspose kernels of all sessions, so that a convolution is only benchmarked once per process.
+// The entries can be saved to a file and loaded back by a later process, see
+// CUDAExecutionProviderInfo::cudnn_conv_algo_cache_path.
+//
+// A key holds everything the choice depends on: the kind of search, the data type, the compute capability of
+// the device and the descriptors of the convolution. A file saved with another version of cuDNN is ignored.
+class CudnnConvAlgoCache {
+ public:
+  enum class Search : int64_t {
+    Forward = 0,
+    BackwardData = 1,
+  };
+
+  struct Result {
+    int algo;
+    size_t memory;
+    cudnnMathType_t math_type;
+  };
+
+  using Key = std::vector<int64_t>;
+
+  static CudnnConvAlgoCache& Instance();
+
+  // The dims, pads, strides and dilations are the ones given to the cudnn descriptors. y_dims is part of the key
+  // as the output of a ConvTranspose isn't determined by the others.
+  static Key MakeKey(Search search, cudnnDataType_t data_type, int device_id,
+                     const std::vector<int64_t>& x_dims,
+                     const std::vector<int64_t>& w_dims,
+                     const std::vector<int64_t>& y_dims,
+                     const std::vector<int64_t>& pads,
+                     const std::vector<int64_t>& strides,
+                     const std::vector<int64_t>& dilations,
+                     int64_t group);
+
+  bool Find(const Key& key, Result& result);
+  void Insert(const Key& key, const Result& result);
+
+  // Adds the entries of the file to the cache. A file that doesn't exist is not an error.
+  common::Status Load(const std::string& path);
+  common::Status Save(const std::string& path) const;
+
+  size_t Size() const;
+  void Clear();
+
+ private:
+  CudnnConvAlgoCache() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudnnConvAlgoCache);
+
+  mutable OrtMutex mutex_;
+  lru_unordered_map<Key, Result, vector_hash<int64_t>> results_{MAX_CACHED_ALGO_PERF_RESULTS};
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+#include "conv_integer.h"
+#include "im2col_impl.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    ConvInteger,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<int32_t>()),
+    ConvInteger);
+
+static void RunGemm(int64_t M, int64_t N, int64_t K,
+                    const uint8_t* a, int64_t lda, int64_t stride_a, uint8_t a_zero_point,
+                    const uint8_t* b, int64_t ldb, int64_t stride_b, uint8_t b_zero_point,
+                    int32_t* c, int64_t ldc, int64_t stride_c,
+                    int64_t batch_count,
+                    const GemmRequantization&) {
+  IntegerGemmImpl(M, N, K, a, lda, stride_a, a_zero_point, b, ldb, stride_b, b_zero_point,
+                  c, ldc, stride_c, batch_count);
+}
+
+static void RunGemm(int64_t M, int64_t N, int64_t K,
+                    const uint8_t* a, int64_t lda, int64_t stride_a, uint8_t a_zero_point,
+                    const uint8_t* b, int64_t ldb, int64_t stride_b, uint8_t b_zero_point,
+                    uint8_t* c, int64_t ldc, int64_t stride_c,
+                    int64_t batch_count,
+                    const GemmRequantization& requantization) {
+  QuantizedGemmImpl(M, N, K, a, lda, stride_a, a_zero_point, b, ldb, stride_b, b_zero_point,
+                    c, ldc, stride_c, batch_count, requantization);
+}
+
+template <typename TY>
+Status IntegerConvBase::ComputeConv(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                                    uint8_t x_zero_point, uint8_t w_zero_point,
+                                    const GemmRequantization& requantization) const {
+  const int64_t N = X->Shape()[0];
+  const int64_t C = X->Shape()[1];
+  const int64_t M = W->Shape()[0];
+  ORT_RETURN_IF_ERROR(ValidateInputShape(X, W));
+
+  std::vector<int64_t> kernel_shape;
+  ORT_RETURN_IF_ERROR(ComputeKernelShape(W->Shape(), kernel_shape));
+  const size_t rank = kernel_shape.size();
+  if (rank > static_cast<size_t>(kMaxIm2ColRank)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Quantized convolutions on CUDA have at most ",
+                           kMaxIm2ColRank, " spatial dims, not ", rank);
+  }
+
+  std::vector<int64_t> pads(pads_);
+  if (pads.empty()) {
+    pads.resize(rank * 2, 0);
+  }
+  std::vector<int64_t> dilations(dilations_);
+  if (dilations.empty()) {
+    dilations.resize(rank, 1);
+  }
+  std::vector<int64_t> strides(strides_);
+  if (strides.empty()) {
+    strides.resize(rank, 1);
+  }
+
+  std::vector<int64_t> Y_dims;
+  Y_dims.insert(Y_dims.begin(), {N, M});
+  TensorShape input_shape = X->Shape().Slice(2);
+  ORT_RETURN_IF_ERROR(InferOutputShape(input_shape, kernel_shape, strides, dilations, &pads, &Y_dims));
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(2);
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape::ReinterpretBaseType(kernel_shape).Size();
+  const int64_t kernel_dim = C / group_ * kernel_size;
+  const int64_t col_buffer_size = C * kernel_size * output_image_size;
+  if (C * input_image_size > std::numeric_limits<int32_t>::max() ||
+      col_buffer_size > std::numeric_limits<int32_t>::max()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "The images of quantized convolutions on CUDA have at "
+                           "most 2^31 values, and so do their im2col columns");
+  }
+
+  // A pointwise convolution reads the input image directly as the GEMM's right operand.
+  const bool is_pointwise = IsPointwiseConv(kernel_shape, strides, pads);
+  IAllocatorUniquePtr<uint8_t> col_buffer;
+  Im2ColArgs im2col_args;
+  if (!is_pointwise) {
+    col_buffer = GetScratchBuffer<uint8_t>(col_buffer_size);
+    im2col_args.rank = static_cast<int>(rank);
+    for (size_t d = 0; d < rank; ++d) {
+      im2col_args.image_dims[d] = static_cast<int32_t>(input_shape[d]);
+      im2col_args.output_dims[d] = static_cast<int32_t>(output_shape[d]);
+      im2col_args.kernel_dims[d] = static_cast<int32_t>(kernel_shape[d]);
+      im2col_args.strides[d] = static_cast<int32_t>(strides[d]);
+      im2col_args.dilations[d] = static_cast<int32_t>(dilations[d]);
+      im2col_args.pads[d] = static_cast<int32_t>(pads[d]);
+    }
+    im2col_args.image_size = static_cast<int32_t>(input_image_size);
+    im2col_args.output_size = static_cast<int32_t>(output_image_size);
+    im2col_args.kernel_size = static_cast<int32_t>(kernel_size);
+  }
+
+  const uint8_t* x_data = X->template Data<uint8_t>();
+  const uint8_t* w_data = W->template Data<uint8_t>();
+  TY* y_data = Y->template MutableData<TY>();
+
+  // the groups of an image are the batch of its GEMM, with the columns of a group kernel_dim rows apart
+  GemmRequantization group_requantization = requantization;
+  group_requantization.bias_stride = M / group_;
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    const uint8_t* gemm_input = x_data;
+    if (!is_pointwise) {
+      Im2ColImpl(x_data, col_buffer.get(), C, im2col_args, x_zero_point);
+      gemm_input = col_buffer.get();
+    }
+
+    RunGemm(M / group_, output_image_size, kernel_dim,
+            w_data, kernel_dim, W->Shape().Size() / group_, w_zero_point,
+            gemm_input, output_image_size, kernel_dim * output_image_size, x_zero_point,
+            y_data, output_image_size, M / group_ * output_image_size,
+            group_,
+            group_requantization);
+
+    x_data += C * input_image_size;
+    y_data += M * output_image_size;
+  }
+
+  return Status::OK();
+}
+
+template Status IntegerConvBase::ComputeConv<int32_t>(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                                                      uint8_t x_zero_point, uint8_t w_zero_point,
+                                                      const GemmRequantization& requantization) const;
+template Status IntegerConvBase::ComputeConv<uint8_t>(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                                                      uint8_t x_zero_point, uint8_t w_zero_point,
+                                                      const GemmRequantization& requantization) const;
+
+Status ConvInteger::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(1);
+
+  // the zero points are on the CPU
+  uint8_t input_offset = 0;
+  uint8_t filter_offset = 0;
+  const Tensor* X_Zero_Point = context->Input<Tensor>(2);
+  if (X_Zero_Point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(X_Zero_Point), "Must be a scalar or 1D tensor or size 1.");
+    input_offset = *(X_Zero_Point->Data<uint8_t>());
+  }
+  const Tensor* W_Zero_Point = context->Input<Tensor>(3);
+  if (W_Zero_Point != nullptr) {
+    ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(W_Zero_Point), "Non per-tensor quantization is not supported now.");
+    filter_offset = *(W_Zero_Point->Data<uint8_t>());
+  }
+
+  return ComputeConv<int32_t>(context, X, W, input_offset, filter_offset, GemmRequantization{nullptr, 0, 1.0f, 0});
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
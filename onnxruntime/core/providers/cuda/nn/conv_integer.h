@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cpu/nn/conv_base.h"
+#include "core/providers/cuda/math/integer_gemm_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+// The quantized convolutions run, for each image, as an im2col of the image into uint8 columns padded with the
+// zero point of X, and a GEMM of the weights with the columns batched over the groups.
+class IntegerConvBase : public CudaKernel, public ConvBase {
+ protected:
+  explicit IntegerConvBase(const OpKernelInfo& info) : CudaKernel(info), ConvBase(info) {
+  }
+
+  // Computes Y, int32_t accumulators or uint8_t values requantized with requantization, whose bias, if any, has
+  // the M values of the output channels.
+  template <typename TY>
+  Status ComputeConv(OpKernelContext* context, const Tensor* X, const Tensor* W,
+                     uint8_t x_zero_point, uint8_t w_zero_point,
+                     const GemmRequantization& requantization) const;
+};
+
+class ConvInteger final : public IntegerConvBase {
+ public:
+  explicit ConvInteger(const OpKernelInfo& info) : IntegerConvBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
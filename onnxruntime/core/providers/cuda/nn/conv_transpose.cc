@@ -46,17 +46,14 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
 
   {
     std::lock_guard<OrtMutex> lock(s_.mutex);
-    // TODO: add a global cache if need to handle cases for multiple frames running simultaneuously with different batch_size
     bool input_dims_changed = (s_.last_x_dims != x_dims);
     bool w_dims_changed = (s_.last_w_dims != w_dims);
     if (input_dims_changed || w_dims_changed) {
       if (input_dims_changed)
         s_.last_x_dims = x_dims;
 
-      if (w_dims_changed) {
+      if (w_dims_changed)
         s_.last_w_dims = w_dims;
-        s_.cached_benchmark_results.clear();
-      }
 
       Prepare p;
       ORT_RETURN_IF_ERROR(PrepareForCompute(context, has_bias, p, dynamic_padding));
@@ -88,14 +85,20 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
 
       y_data = reinterpret_cast<CudaT*>(p.Y->template MutableData<T>());
 
-      if (!s_.cached_benchmark_results.contains(x_dims)) {
+      auto& algo_cache = CudnnConvAlgoCache::Instance();
+      const auto algo_key = CudnnConvAlgoCache::MakeKey(CudnnConvAlgoCache::Search::BackwardData,
+                                                        CudnnTensor::GetDataType<CudaT>(), GetDeviceId(),
+                                                        x_dims, w_dims, y_dims, p.pads, p.strides, p.dilations,
+                                                        group_);
+      CudnnConvAlgoCache::Result perf;
+      if (!algo_cache.Find(algo_key, perf)) {
         IAllocatorUniquePtr<void> algo_search_workspace = GetScratchBuffer<void>(AlgoSearchWorkspaceSize);
 
         // set math type to tensor core before algorithm search
         if (std::is_same<T, MLFloat16>::value)
           CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, CUDNN_TENSOR_OP_MATH));
 
-        cudnnConvolutionBwdDataAlgoPerf_t perf;
+        cudnnConvolutionBwdDataAlgoPerf_t found;
         int algo_count = 1;
         CUDNN_RETURN_IF_ERROR(cudnnFindConvolutionBackwardDataAlgorithmEx(
             CudnnHandle(),
@@ -108,15 +111,15 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
             y_data,
             1,
             &algo_count,
-            &perf,
+            &found,
             algo_search_workspace.get(),
             AlgoSearchWorkspaceSize));
-        s_.cached_benchmark_results.insert(x_dims, {perf.algo, perf.memory, perf.mathType});
+        perf = {static_cast<int>(found.algo), found.memory, found.mathType};
+        algo_cache.Insert(algo_key, perf);
       }
 
-      const auto& perf = s_.cached_benchmark_results.at(x_dims);
-      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.mathType));
-      s_.algo = perf.algo;
+      CUDNN_RETURN_IF_ERROR(cudnnSetConvolutionMathType(s_.conv_desc, perf.math_type));
+      s_.algo = static_cast<cudnnConvolutionBwdDataAlgo_t>(perf.algo);
       s_.workspace_bytes = perf.memory;
     }
   }
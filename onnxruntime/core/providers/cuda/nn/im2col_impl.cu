@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "im2col_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+__global__ void _Im2ColKernel(const uint8_t* image,
+                              uint8_t* col,
+                              const Im2ColArgs args,
+                              const fast_divmod output_size_div,
+                              const fast_divmod kernel_size_div,
+                              const uint8_t pad_value,
+                              const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int row, output_pos;
+  output_size_div.divmod(id, row, output_pos);
+  int channel, kernel_pos;
+  kernel_size_div.divmod(row, channel, kernel_pos);
+
+  // the last dim is the innermost of the image, the output and the kernel
+  int image_offset = 0;
+  int image_pitch = 1;
+  bool is_padding = false;
+  for (int d = args.rank - 1; d >= 0; --d) {
+    const int output_index = output_pos % args.output_dims[d];
+    output_pos /= args.output_dims[d];
+    const int kernel_index = kernel_pos % args.kernel_dims[d];
+    kernel_pos /= args.kernel_dims[d];
+
+    const int image_index = output_index * args.strides[d] - args.pads[d] + kernel_index * args.dilations[d];
+    is_padding = is_padding || image_index < 0 || image_index >= args.image_dims[d];
+    image_offset += image_index * image_pitch;
+    image_pitch *= args.image_dims[d];
+  }
+
+  col[id] = is_padding ? pad_value : image[channel * args.image_size + image_offset];
+}
+
+void Im2ColImpl(const uint8_t* image, uint8_t* col, int64_t channels, const Im2ColArgs& args, uint8_t pad_value) {
+  const size_t N = static_cast<size_t>(channels) * args.kernel_size * args.output_size;
+  if (N == 0)
+    return;
+
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _Im2ColKernel<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      image, col, args, fast_divmod(args.output_size), fast_divmod(args.kernel_size), pad_value, (CUDA_LONG)N);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+#include "core/providers/cuda/shared_inc/cuda_utils.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+constexpr int kMaxIm2ColRank = 3;
+
+// The spatial geometry of an NCHW convolution of up to kMaxIm2ColRank dims, passed to the kernel by value. pads
+// are the pads at the beginning of the dims.
+struct Im2ColArgs {
+  int rank;
+  int32_t image_dims[kMaxIm2ColRank];
+  int32_t output_dims[kMaxIm2ColRank];
+  int32_t kernel_dims[kMaxIm2ColRank];
+  int32_t strides[kMaxIm2ColRank];
+  int32_t dilations[kMaxIm2ColRank];
+  int32_t pads[kMaxIm2ColRank];
+  int32_t image_size;
+  int32_t output_size;
+  int32_t kernel_size;
+};
+
+// Im2colNd of channels uint8 images into col, the row-major matrix of channels * kernel_size rows of
+// output_size values. The values of the padding are pad_value, the zero point of the images, so that the
+// padding adds nothing to the quantized GEMM.
+void Im2ColImpl(const uint8_t* image, uint8_t* col, int64_t channels, const Im2ColArgs& args, uint8_t pad_value);
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "qlinearconv.h"
+#include "core/providers/common.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    QLinearConv,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(1)
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(4)
+        .InputMemoryType<OrtMemTypeCPUInput>(5)
+        .InputMemoryType<OrtMemTypeCPUInput>(6)
+        .InputMemoryType<OrtMemTypeCPUInput>(7)
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>())
+        .TypeConstraint("T4", DataTypeImpl::GetTensorType<int32_t>()),
+    QLinearConv);
+
+Status QLinearConv::ComputeInternal(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W = context->Input<Tensor>(3);
+
+  // the scales and the zero points are on the CPU, the bias on the device
+  const Tensor* input_scale = context->Input<Tensor>(1);
+  const Tensor* input_offset = context->Input<Tensor>(2);
+  const Tensor* filter_scale = context->Input<Tensor>(4);
+  const Tensor* filter_offset = context->Input<Tensor>(5);
+  const Tensor* result_scale = context->Input<Tensor>(6);
+  const Tensor* result_offset = context->Input<Tensor>(7);
+  const Tensor* bias = context->Input<Tensor>(8);
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(input_offset),
+                    "QLinearConv : input zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(filter_offset),
+                    "QLinearConv : filter zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(result_offset),
+                    "QLinearConv : result zero point must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(input_scale),
+                    "QLinearConv : input scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(filter_scale),
+                    "QLinearConv : filter scale must be a scalar or 1D tensor of size 1");
+  ORT_RETURN_IF_NOT(IsScalarOr1ElementVector(result_scale),
+                    "QLinearConv : result scale must be a scalar or 1D tensor of size 1");
+
+  GemmRequantization requantization;
+  requantization.bias = bias == nullptr ? nullptr : bias->template Data<int32_t>();
+  requantization.bias_stride = 0;
+  requantization.scale = (*input_scale->template Data<float>() * *filter_scale->template Data<float>()) /
+                         *result_scale->template Data<float>();
+  requantization.zero_point = *result_offset->template Data<uint8_t>();
+
+  return ComputeConv<uint8_t>(context, X, W,
+                              *input_offset->template Data<uint8_t>(),
+                              *filter_offset->template Data<uint8_t>(),
+                              requantization);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "conv_integer.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+class QLinearConv final : public IntegerConvBase {
+ public:
+  explicit QLinearConv(const OpKernelInfo& info) : IntegerConvBase(info) {
+  }
+
+  Status ComputeInternal(OpKernelContext* context) const override;
+};
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <limits>
+#include "non_max_suppression.h"
+#include "non_max_suppression_impl.h"
+#include "core/providers/cpu/object_detection/non_max_suppression_helper.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    NonMaxSuppression,
+    kOnnxDomain,
+    10,
+    kCudaExecutionProvider,
+    KernelDefBuilder()
+        .InputMemoryType<OrtMemTypeCPUInput>(2)
+        .InputMemoryType<OrtMemTypeCPUInput>(3)
+        .InputMemoryType<OrtMemTypeCPUInput>(4),
+    NonMaxSuppression);
+
+Status NonMaxSuppression::ComputeInternal(OpKernelContext* ctx) const {
+  PrepareContext pc;
+  ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
+
+  int64_t max_output_boxes_per_class = 0;
+  float iou_threshold = .0f;
+  float score_threshold = .0f;
+  ORT_RETURN_IF_ERROR(GetThresholdsFromInputs(pc, max_output_boxes_per_class, iou_threshold, score_threshold));
+
+  const int64_t num_tasks = pc.num_batches_ * pc.num_classes_;
+  if (0 == max_output_boxes_per_class || 0 == num_tasks || 0 == pc.num_boxes_) {
+    ctx->Output(0, {0, 3});
+    return Status::OK();
+  }
+
+  if (pc.num_boxes_ > kNmsMaxBoxes || num_tasks * pc.num_boxes_ > std::numeric_limits<int32_t>::max()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NonMaxSuppression on CUDA selects from at most ",
+                           kNmsMaxBoxes, " boxes per class and 2^31 scores, not ", pc.num_boxes_,
+                           " boxes of ", num_tasks, " classes");
+  }
+
+  const int64_t max_selected = std::min(max_output_boxes_per_class, pc.num_boxes_);
+  auto selected_counts = GetScratchBuffer<int32_t>(num_tasks);
+  auto selected_boxes = GetScratchBuffer<int32_t>(num_tasks * max_selected);
+  const size_t workspace_bytes = NonMaxSuppressionWorkspaceSize(pc.num_batches_, pc.num_classes_, pc.num_boxes_);
+  auto workspace = GetScratchBuffer<void>(workspace_bytes);
+
+  NonMaxSuppressionImpl(pc.boxes_data_, pc.scores_data_, GetCenterPointBox(),
+                        pc.num_batches_, pc.num_classes_, pc.num_boxes_, max_selected,
+                        iou_threshold, pc.score_threshold_ != nullptr, score_threshold,
+                        selected_counts.get(), selected_boxes.get(), workspace.get(), workspace_bytes);
+
+  // The size of the output depends on the selection, so the counts of the tasks are copied back, and the
+  // selected boxes stay on the device.
+  CudaAsyncBuffer<int32_t> offsets(this, num_tasks);
+  CUDA_RETURN_IF_ERROR(cudaMemcpy(offsets.CpuPtr(), selected_counts.get(), num_tasks * sizeof(int32_t),
+                                  cudaMemcpyDeviceToHost));
+  int64_t num_selected = 0;
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    const int32_t count = offsets.CpuPtr()[task];
+    offsets.CpuPtr()[task] = static_cast<int32_t>(num_selected);
+    num_selected += count;
+  }
+
+  Tensor* output = ctx->Output(0, {num_selected, 3});
+  if (num_selected == 0) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(offsets.CopyToGpu());
+  WriteSelectedIndicesImpl(selected_counts.get(), selected_boxes.get(), offsets.GpuPtr(), num_tasks,
+                           pc.num_classes_, max_selected, output->MutableData<int64_t>());
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,256 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cub/cub.cuh>
+#include "core/common/common.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+#include "core/providers/cpu/object_detection/non_max_suppression_helper.h"
+#include "non_max_suppression_impl.h"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+// the boxes of a word of the masks
+constexpr int kNmsBlockSize = 64;
+constexpr int kNmsSelectBlockSize = 256;
+
+// The masks of a chunk of tasks are at most this large, the chunks having at least one task, and the tasks of a
+// chunk are the z dimension of the grid of the masks.
+constexpr size_t kMaxMaskBytes = 64 * 1024 * 1024;
+constexpr int64_t kMaxTasksPerChunk = 65535;
+
+size_t AlignUp(size_t bytes) {
+  constexpr size_t kAlignment = 256;
+  return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+int64_t NumColBlocks(int64_t num_boxes) {
+  return (num_boxes + kNmsBlockSize - 1) / kNmsBlockSize;
+}
+
+int64_t TasksPerChunk(int64_t num_tasks, int64_t num_boxes) {
+  const size_t task_mask_bytes = static_cast<size_t>(num_boxes * NumColBlocks(num_boxes)) * sizeof(uint64_t);
+  const int64_t tasks = static_cast<int64_t>(kMaxMaskBytes / std::max<size_t>(task_mask_bytes, 1));
+  return std::max<int64_t>(1, std::min({num_tasks, kMaxTasksPerChunk, tasks}));
+}
+
+struct NmsWorkspace {
+  int32_t* indices;
+  int32_t* sorted_indices;
+  float* sorted_scores;
+  int* offsets;
+  uint64_t* masks;
+  void* sort_storage;
+  size_t sort_storage_bytes;
+};
+
+// Lays the buffers out from base, which may be null to only compute the size.
+size_t GetWorkspace(int64_t num_tasks, int64_t num_boxes, char* base, NmsWorkspace& workspace) {
+  const int num_items = static_cast<int>(num_tasks * num_boxes);
+  const int num_segments = static_cast<int>(num_tasks);
+
+  workspace.sort_storage_bytes = 0;
+  cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      nullptr, workspace.sort_storage_bytes, static_cast<const float*>(nullptr), static_cast<float*>(nullptr),
+      static_cast<const int32_t*>(nullptr), static_cast<int32_t*>(nullptr), num_items, num_segments,
+      static_cast<int*>(nullptr), static_cast<int*>(nullptr));
+
+  size_t offset = 0;
+  auto take = [&](size_t bytes) {
+    char* p = base == nullptr ? nullptr : base + offset;
+    offset += AlignUp(bytes);
+    return p;
+  };
+  const size_t mask_words = static_cast<size_t>(TasksPerChunk(num_tasks, num_boxes) * num_boxes *
+                                                NumColBlocks(num_boxes));
+  workspace.indices = reinterpret_cast<int32_t*>(take(num_items * sizeof(int32_t)));
+  workspace.sorted_indices = reinterpret_cast<int32_t*>(take(num_items * sizeof(int32_t)));
+  workspace.sorted_scores = reinterpret_cast<float*>(take(num_items * sizeof(float)));
+  workspace.offsets = reinterpret_cast<int*>(take((num_segments + 1) * sizeof(int)));
+  workspace.masks = reinterpret_cast<uint64_t*>(take(mask_words * sizeof(uint64_t)));
+  workspace.sort_storage = take(workspace.sort_storage_bytes);
+  return offset;
+}
+
+}  // namespace
+
+__global__ void _FillBoxIndices(int32_t* indices, int* offsets, int num_boxes, int num_tasks, int num_items,
+                                CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  if (id < num_items) {
+    indices[id] = id % num_boxes;
+  }
+  if (id <= num_tasks) {
+    offsets[id] = id * num_boxes;
+  }
+}
+
+// Block (x, y, z) sets the bits of the boxes of column block x that the boxes of row block y suppress, for task
+// first_task + z, as (row box, word x) of the mask of the task. Only the boxes after the row box are tested, as the
+// boxes are in score order, so the blocks below the diagonal have nothing to do.
+__global__ void _NmsMask(const float* boxes, const int32_t* sorted_indices, int64_t first_task, int num_classes,
+                         int num_boxes, int col_blocks, int64_t center_point_box, float iou_threshold,
+                         uint64_t* masks) {
+  const int row_block = blockIdx.y;
+  const int col_block = blockIdx.x;
+  if (col_block < row_block) {
+    return;
+  }
+
+  const int64_t task = first_task + blockIdx.z;
+  const float* batch_boxes = boxes + (task / num_classes) * num_boxes * 4;
+  const int32_t* task_indices = sorted_indices + task * num_boxes;
+
+  // the column boxes, and then the row boxes
+  __shared__ float block_boxes[2 * kNmsBlockSize * 4];
+  const int col = col_block * kNmsBlockSize + threadIdx.x;
+  const int row = row_block * kNmsBlockSize + threadIdx.x;
+  if (col < num_boxes) {
+    const float* box = batch_boxes + task_indices[col] * 4;
+    for (int i = 0; i < 4; ++i) {
+      block_boxes[threadIdx.x * 4 + i] = box[i];
+    }
+  }
+  if (row < num_boxes) {
+    const float* box = batch_boxes + task_indices[row] * 4;
+    for (int i = 0; i < 4; ++i) {
+      block_boxes[(kNmsBlockSize + threadIdx.x) * 4 + i] = box[i];
+    }
+  }
+  __syncthreads();
+
+  if (row >= num_boxes) {
+    return;
+  }
+
+  const int cols = min(num_boxes - col_block * kNmsBlockSize, kNmsBlockSize);
+  uint64_t bits = 0;
+  for (int i = col_block == row_block ? threadIdx.x + 1 : 0; i < cols; ++i) {
+    if (nms_helpers::SuppressByIOU(block_boxes, kNmsBlockSize + threadIdx.x, i, center_point_box, iou_threshold)) {
+      bits |= 1ull << i;
+    }
+  }
+  masks[(blockIdx.z * static_cast<int64_t>(num_boxes) + row) * col_blocks + col_block] = bits;
+}
+
+// A block per task walks the boxes in score order, skipping the ones removed by the selected boxes, whose bits are
+// kept in shared memory.
+__global__ void _NmsSelect(const uint64_t* masks, const int32_t* sorted_indices, const float* sorted_scores,
+                           int64_t first_task, int num_boxes, int col_blocks, int max_selected,
+                           bool has_score_threshold, float score_threshold,
+                           int32_t* selected_counts, int32_t* selected_boxes) {
+  extern __shared__ uint64_t removed[];
+
+  const int64_t task = first_task + blockIdx.x;
+  const int32_t* task_indices = sorted_indices + task * num_boxes;
+  const float* task_scores = sorted_scores + task * num_boxes;
+  const uint64_t* task_masks = masks + blockIdx.x * static_cast<int64_t>(num_boxes) * col_blocks;
+  int32_t* task_selected = selected_boxes + task * max_selected;
+
+  for (int i = threadIdx.x; i < col_blocks; i += blockDim.x) {
+    removed[i] = 0;
+  }
+  __syncthreads();
+
+  int count = 0;
+  for (int box = 0; box < num_boxes && count < max_selected; ++box) {
+    // the scores are sorted, so the boxes below the threshold are all at the end
+    if (has_score_threshold && !(task_scores[box] > score_threshold)) {
+      break;
+    }
+
+    // The word of box may be read while the threads that are ahead update it below for this box, but the mask of a
+    // box only has the bits of the boxes after it, so every thread sees the same bit.
+    if ((removed[box / kNmsBlockSize] >> (box % kNmsBlockSize)) & 1) {
+      continue;
+    }
+
+    if (threadIdx.x == 0) {
+      task_selected[count] = task_indices[box];
+    }
+    ++count;
+
+    const uint64_t* box_mask = task_masks + static_cast<int64_t>(box) * col_blocks;
+    for (int i = box / kNmsBlockSize + threadIdx.x; i < col_blocks; i += blockDim.x) {
+      removed[i] |= box_mask[i];
+    }
+    __syncthreads();
+  }
+
+  if (threadIdx.x == 0) {
+    selected_counts[task] = count;
+  }
+}
+
+size_t NonMaxSuppressionWorkspaceSize(int64_t num_batches, int64_t num_classes, int64_t num_boxes) {
+  NmsWorkspace workspace;
+  return GetWorkspace(num_batches * num_classes, num_boxes, nullptr, workspace);
+}
+
+void NonMaxSuppressionImpl(const float* boxes, const float* scores, int64_t center_point_box,
+                           int64_t num_batches, int64_t num_classes, int64_t num_boxes, int64_t max_selected,
+                           float iou_threshold, bool has_score_threshold, float score_threshold,
+                           int32_t* selected_counts, int32_t* selected_boxes,
+                           void* workspace_data, size_t workspace_bytes) {
+  const int64_t num_tasks = num_batches * num_classes;
+  NmsWorkspace workspace;
+  const size_t required_bytes = GetWorkspace(num_tasks, num_boxes, static_cast<char*>(workspace_data), workspace);
+  ORT_ENFORCE(workspace_bytes >= required_bytes, "NonMaxSuppression workspace of ", workspace_bytes,
+              " bytes instead of ", required_bytes);
+
+  // the sort is stable, so the boxes of equal scores stay in index order, as in the CPU kernel
+  const CUDA_LONG num_items = static_cast<CUDA_LONG>(num_tasks * num_boxes);
+  const CUDA_LONG N = std::max(num_items, static_cast<CUDA_LONG>(num_tasks + 1));
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _FillBoxIndices<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      workspace.indices, workspace.offsets, static_cast<int>(num_boxes), static_cast<int>(num_tasks), num_items, N);
+  cub::DeviceSegmentedRadixSort::SortPairsDescending(
+      workspace.sort_storage, workspace.sort_storage_bytes, scores, workspace.sorted_scores,
+      workspace.indices, workspace.sorted_indices, num_items, static_cast<int>(num_tasks),
+      workspace.offsets, workspace.offsets + 1);
+
+  const int col_blocks = static_cast<int>(NumColBlocks(num_boxes));
+  const int64_t tasks_per_chunk = TasksPerChunk(num_tasks, num_boxes);
+  for (int64_t first_task = 0; first_task < num_tasks; first_task += tasks_per_chunk) {
+    const int64_t chunk_tasks = std::min(tasks_per_chunk, num_tasks - first_task);
+    const dim3 mask_grid(col_blocks, col_blocks, static_cast<unsigned int>(chunk_tasks));
+    _NmsMask<<<mask_grid, kNmsBlockSize, 0>>>(
+        boxes, workspace.sorted_indices, first_task, static_cast<int>(num_classes), static_cast<int>(num_boxes),
+        col_blocks, center_point_box, iou_threshold, workspace.masks);
+    _NmsSelect<<<static_cast<unsigned int>(chunk_tasks), kNmsSelectBlockSize, col_blocks * sizeof(uint64_t)>>>(
+        workspace.masks, workspace.sorted_indices, workspace.sorted_scores, first_task,
+        static_cast<int>(num_boxes), col_blocks, static_cast<int>(max_selected), has_score_threshold,
+        score_threshold, selected_counts, selected_boxes);
+  }
+}
+
+__global__ void _WriteSelectedIndices(const int32_t* selected_counts, const int32_t* selected_boxes,
+                                      const int32_t* offsets, fast_divmod fdm_max_selected, int num_classes,
+                                      int64_t* output, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int task, i;
+  fdm_max_selected.divmod(id, task, i);
+  if (i >= selected_counts[task]) {
+    return;
+  }
+  int64_t* selected = output + (static_cast<int64_t>(offsets[task]) + i) * 3;
+  selected[0] = task / num_classes;
+  selected[1] = task % num_classes;
+  selected[2] = selected_boxes[id];
+}
+
+void WriteSelectedIndicesImpl(const int32_t* selected_counts, const int32_t* selected_boxes,
+                              const int32_t* offsets, int64_t num_tasks, int64_t num_classes, int64_t max_selected,
+                              int64_t* output) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(num_tasks * max_selected);
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _WriteSelectedIndices<<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      selected_counts, selected_boxes, offsets, fast_divmod(static_cast<int>(max_selected)),
+      static_cast<int>(num_classes), output, N);
+}
+
+}  // namespace cuda
+}  // namespace onnxruntime
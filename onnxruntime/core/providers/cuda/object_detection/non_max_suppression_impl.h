@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+// The most boxes per class NonMaxSuppressionImpl selects from, for which the boxes it has removed fit in shared
+// memory, a bit per box.
+constexpr int64_t kNmsMaxBoxes = 48 * 1024 * 8;
+
+// Size in bytes of the workspace of NonMaxSuppressionImpl.
+size_t NonMaxSuppressionWorkspaceSize(int64_t num_batches, int64_t num_classes, int64_t num_boxes);
+
+// Selects the boxes of each of the num_batches * num_classes (batch, class) tasks as the CPU kernel does, writing
+// the count of task t to selected_counts[t] and its box indices to selected_boxes[t * max_selected ...], in the
+// order they are selected.
+// The scores of all the tasks are sorted at once with a stable segmented radix sort. Then, for a chunk of tasks
+// at a time, a bit mask of the boxes each box suppresses, among the ones after it, is computed by blocks of 64 x 64
+// boxes, and a block per task walks its sorted boxes, selecting each box that no selected box suppresses.
+void NonMaxSuppressionImpl(const float* boxes, const float* scores, int64_t center_point_box,
+                           int64_t num_batches, int64_t num_classes, int64_t num_boxes, int64_t max_selected,
+                           float iou_threshold, bool has_score_threshold, float score_threshold,
+                           int32_t* selected_counts, int32_t* selected_boxes,
+                           void* workspace, size_t workspace_bytes);
+
+// Writes the (batch, class, box) indices of the selected boxes to output, the ones of task t from row offsets[t].
+void WriteSelectedIndicesImpl(const int32_t* selected_counts, const int32_t* selected_boxes,
+                              const int32_t* offsets, int64_t num_tasks, int64_t num_classes, int64_t max_selected,
+                              int64_t* output);
+
+}  // namespace cuda
+}  // namespace onnxruntime
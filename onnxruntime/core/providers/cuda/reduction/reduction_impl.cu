@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cuda_runtime.h>
+#include <cub/cub.cuh>
+#include "reduction_impl.h"
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+namespace onnxruntime {
+namespace cuda {
+
+namespace {
+
+constexpr int kWarpSize = 32;
+
+// a warp per row up to this row size, a block per row beyond it
+constexpr int64_t kMaxWarpRowSize = 4096;
+constexpr int kRowsBlockSize = 256;
+constexpr int kLongRowBlockSize = 512;
+
+// blocks of the reductions with inner > 1: 32 adjacent inner values by 8 reduced rows
+constexpr int kInnerPerBlock = 32;
+constexpr int kReducedPerBlock = 8;
+constexpr int64_t kMaxGridDimY = 65535;
+
+template <typename T>
+struct AccumulateType {
+  typedef T type;
+};
+
+template <>
+struct AccumulateType<half> {
+  typedef float type;
+};
+
+// The reductions are given by functors with an accumulator type Acc:
+//   Acc Init(): the accumulator of an empty row
+//   Acc Load(T value, int64_t index): the accumulator of a single value
+//   Acc operator()(Acc, Acc): combines two accumulators, used as the cub reduction operator as well
+//   OutT Finalize(Acc, int64_t count): the output of a row of count values
+
+template <typename T, ReduceOp op>
+struct ReduceFunctor {
+  typedef typename AccumulateType<T>::type Acc;
+
+  __device__ __inline__ Acc Init() const {
+    switch (op) {
+      case ReduceOp::Max:
+        return Acc(-INFINITY);
+      case ReduceOp::Min:
+        return Acc(INFINITY);
+      case ReduceOp::Prod:
+        return Acc(1);
+      default:
+        return Acc(0);
+    }
+  }
+
+  __device__ __inline__ Acc Load(const T& value, int64_t) const {
+    const Acc x = static_cast<Acc>(value);
+    switch (op) {
+      case ReduceOp::L1:
+        return _Abs(x);
+      case ReduceOp::L2:
+      case ReduceOp::SumSquare:
+        return x * x;
+      default:
+        return x;
+    }
+  }
+
+  __device__ __inline__ Acc operator()(const Acc& a, const Acc& b) const {
+    switch (op) {
+      case ReduceOp::Max:
+        // propagates NaN like CUDNN_PROPAGATE_NAN
+        return (isnan(a) || a > b) ? a : b;
+      case ReduceOp::Min:
+        return (isnan(a) || a < b) ? a : b;
+      case ReduceOp::Prod:
+        return a * b;
+      default:
+        return a + b;
+    }
+  }
+
+  __device__ __inline__ T Finalize(const Acc& a, int64_t count) const {
+    switch (op) {
+      case ReduceOp::Mean:
+        return static_cast<T>(a / static_cast<Acc>(count));
+      case ReduceOp::L2:
+        return static_cast<T>(_Sqrt(a));
+      case ReduceOp::LogSum:
+        return static_cast<T>(_Log(a));
+      default:
+        return static_cast<T>(a);
+    }
+  }
+};
+
+template <typename AccT>
+struct LogSumExpAcc {
+  AccT max;
+  AccT sum;  // of exp(x - max)
+};
+
+// single pass log(sum(exp(x))), which rescales the partial sums to the running maximum
+template <typename T>
+struct LogSumExpFunctor {
+  typedef typename AccumulateType<T>::type AccT;
+  typedef LogSumExpAcc<AccT> Acc;
+
+  __device__ __inline__ Acc Init() const { return {AccT(-INFINITY), AccT(0)}; }
+
+  __device__ __inline__ Acc Load(const T& value, int64_t) const { return {static_cast<AccT>(value), AccT(1)}; }
+
+  __device__ __inline__ Acc operator()(const Acc& a, const Acc& b) const {
+    // equal maxima include the infinite ones, whose difference would be NaN
+    if (a.max == b.max) {
+      return {a.max, a.sum + b.sum};
+    }
+    if (a.max > b.max) {
+      return {a.max, a.sum + b.sum * _Exp(b.max - a.max)};
+    }
+    return {b.max, b.sum + a.sum * _Exp(a.max - b.max)};
+  }
+
+  __device__ __inline__ T Finalize(const Acc& a, int64_t) const { return static_cast<T>(a.max + _Log(a.sum)); }
+};
+
+template <typename AccT>
+struct ArgReduceAcc {
+  AccT value;
+  int64_t index;  // -1 for no value
+};
+
+template <typename T, bool is_max>
+struct ArgReduceFunctor {
+  typedef typename AccumulateType<T>::type AccT;
+  typedef ArgReduceAcc<AccT> Acc;
+
+  __device__ __inline__ Acc Init() const { return {AccT(0), -1}; }
+
+  __device__ __inline__ Acc Load(const T& value, int64_t index) const { return {static_cast<AccT>(value), index}; }
+
+  __device__ __inline__ Acc operator()(const Acc& a, const Acc& b) const {
+    if (a.index < 0) return b;
+    if (b.index < 0) return a;
+    const bool b_better = is_max ? b.value > a.value : b.value < a.value;
+    return (b_better || (b.value == a.value && b.index < a.index)) ? b : a;
+  }
+
+  __device__ __inline__ int64_t Finalize(const Acc& a, int64_t) const { return a.index < 0 ? 0 : a.index; }
+};
+
+template <typename T, typename OutT, typename Functor>
+__global__ void _ReduceRowsPerWarp(const T* input, OutT* output, int64_t rows, int64_t row_size, Functor f) {
+  typedef cub::WarpReduce<typename Functor::Acc> WarpReduce;
+  __shared__ typename WarpReduce::TempStorage temp_storage[kRowsBlockSize / kWarpSize];
+
+  const int warp = threadIdx.x / kWarpSize;
+  const int lane = threadIdx.x % kWarpSize;
+  const int64_t row = static_cast<int64_t>(blockIdx.x) * (kRowsBlockSize / kWarpSize) + warp;
+  if (row >= rows) {
+    return;
+  }
+
+  const T* row_input = input + row * row_size;
+  auto acc = f.Init();
+  for (int64_t i = lane; i < row_size; i += kWarpSize) {
+    acc = f(acc, f.Load(row_input[i], i));
+  }
+  acc = WarpReduce(temp_storage[warp]).Reduce(acc, f);
+  if (lane == 0) {
+    output[row] = f.Finalize(acc, row_size);
+  }
+}
+
+template <typename T, typename OutT, typename Functor>
+__global__ void _ReduceRowsPerBlock(const T* input, OutT* output, int64_t row_size, Functor f) {
+  typedef cub::BlockReduce<typename Functor::Acc, kLongRowBlockSize> BlockReduce;
+  __shared__ typename BlockReduce::TempStorage temp_storage;
+
+  const int64_t row = blockIdx.x;
+  const T* row_input = input + row * row_size;
+  auto acc = f.Init();
+  for (int64_t i = threadIdx.x; i < row_size; i += kLongRowBlockSize) {
+    acc = f(acc, f.Load(row_input[i], i));
+  }
+  acc = BlockReduce(temp_storage).Reduce(acc, f);
+  if (threadIdx.x == 0) {
+    output[row] = f.Finalize(acc, row_size);
+  }
+}
+
+template <typename T, typename OutT, typename Functor>
+__global__ void _ReduceStrided(const T* input, OutT* output, int64_t outer, int64_t reduce, int64_t inner,
+                               Functor f) {
+  __shared__ typename Functor::Acc partial[kReducedPerBlock][kInnerPerBlock];
+
+  const int64_t j = static_cast<int64_t>(blockIdx.x) * kInnerPerBlock + threadIdx.x;
+  for (int64_t o = blockIdx.y; o < outer; o += gridDim.y) {
+    auto acc = f.Init();
+    if (j < inner) {
+      const T* column = input + o * reduce * inner + j;
+      for (int64_t r = threadIdx.y; r < reduce; r += kReducedPerBlock) {
+        acc = f(acc, f.Load(column[r * inner], r));
+      }
+    }
+    partial[threadIdx.y][threadIdx.x] = acc;
+    __syncthreads();
+
+    if (threadIdx.y == 0 && j < inner) {
+      for (int y = 1; y < kReducedPerBlock; y++) {
+        acc = f(acc, partial[y][threadIdx.x]);
+      }
+      output[o * inner + j] = f.Finalize(acc, reduce);
+    }
+    __syncthreads();
+  }
+}
+
+template <typename T, typename OutT, typename Functor>
+void LaunchReduce(const T* input, OutT* output, int64_t outer, int64_t reduce, int64_t inner, const Functor& f) {
+  if (outer == 0 || inner == 0) {
+    return;
+  }
+
+  if (inner == 1) {
+    if (reduce <= kMaxWarpRowSize) {
+      constexpr int rows_per_block = kRowsBlockSize / kWarpSize;
+      const int blocks = static_cast<int>((outer + rows_per_block - 1) / rows_per_block);
+      _ReduceRowsPerWarp<T, OutT, Functor><<<blocks, kRowsBlockSize, 0>>>(input, output, outer, reduce, f);
+    } else {
+      _ReduceRowsPerBlock<T, OutT, Functor><<<static_cast<int>(outer), kLongRowBlockSize, 0>>>(
+          input, output, reduce, f);
+    }
+  } else {
+    dim3 block(kInnerPerBlock, kReducedPerBlock);
+    dim3 grid(static_cast<unsigned>((inner + kInnerPerBlock - 1) / kInnerPerBlock),
+              static_cast<unsigned>(outer < kMaxGridDimY ? outer : kMaxGridDimY));
+    _ReduceStrided<T, OutT, Functor><<<grid, block, 0>>>(input, output, outer, reduce, inner, f);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void ReduceImpl(const T* input, T* output, int64_t outer, int64_t reduce, int64_t inner, ReduceOp op) {
+  switch (op) {
+    case ReduceOp::Sum:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::Sum>());
+      break;
+    case ReduceOp::Mean:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::Mean>());
+      break;
+    case ReduceOp::Max:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::Max>());
+      break;
+    case ReduceOp::Min:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::Min>());
+      break;
+    case ReduceOp::Prod:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::Prod>());
+      break;
+    case ReduceOp::L1:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::L1>());
+      break;
+    case ReduceOp::L2:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::L2>());
+      break;
+    case ReduceOp::SumSquare:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::SumSquare>());
+      break;
+    case ReduceOp::LogSum:
+      LaunchReduce(input, output, outer, reduce, inner, ReduceFunctor<T, ReduceOp::LogSum>());
+      break;
+    case ReduceOp::LogSumExp:
+      LaunchReduce(input, output, outer, reduce, inner, LogSumExpFunctor<T>());
+      break;
+  }
+}
+
+template <typename T>
+void ArgReduceImpl(const T* input, int64_t* output, int64_t outer, int64_t reduce, int64_t inner, bool is_max) {
+  if (is_max) {
+    LaunchReduce(input, output, outer, reduce, inner, ArgReduceFunctor<T, true>());
+  } else {
+    LaunchReduce(input, output, outer, reduce, inner, ArgReduceFunctor<T, false>());
+  }
+}
+
+#define SPECIALIZED_REDUCE_IMPL(T)                                                                              \
+  template void ReduceImpl<T>(const T* input, T* output, int64_t outer, int64_t reduce, int64_t inner,         \
+                              ReduceOp op);                                                                    \
+  template void ArgReduceImpl<T>(const T* input, int64_t* output, int64_t outer, int64_t reduce, int64_t inner, \
+                                 bool is_max);
+
+SPECIALIZED_REDUCE_IMPL(half)
+SPECIALIZED_REDUCE_IMPL(float)
+SPECIALIZED_REDUCE_IMPL(double)
+
+}  // namespace cuda
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace cuda {
+
+enum class ReduceOp : int {
+  Sum,
+  Mean,
+  Max,
+  Min,
+  Prod,
+  L1,
+  L2,
+  SumSquare,
+  LogSum,
+  LogSumExp,
+};
+
+// Reduces input, viewed as [outer, reduce, inner], over its middle dimension into output of shape [outer, inner].
+// The rows of a last axis reduction (inner == 1) are reduced by a warp each, or by a block when they are long, and
+// the other reductions by blocks that read 32 adjacent inner values per step, so that the loads are coalesced.
+// half is accumulated in float.
+template <typename T>
+void ReduceImpl(const T* input, T* output, int64_t outer, int64_t reduce, int64_t inner, ReduceOp op);
+
+// Writes the index in [0, reduce) of the largest (is_max) or the smallest value of each reduced row of input,
+// viewed as for ReduceImpl. The first index wins on ties.
+template <typename T>
+void ArgReduceImpl(const T* input, int64_t* output, int64_t outer, int64_t reduce, int64_t inner, bool is_max);
+
+}  // namespace cuda
+}  // namespace onnxruntime
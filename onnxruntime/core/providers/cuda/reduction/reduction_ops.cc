@@ -55,6 +55,65 @@ class CudnnReduceDescriptor final {
   cudnnReduceTensorDescriptor_t desc_;
 };
 
+// Views the input as [outer, reduce, inner] when the reduced axes are adjacent, ignoring the axes of size 1.
+static bool GetReduceView(const std::vector<int64_t>& input_dims, const std::vector<bool>& reduced,
+                          int64_t& outer, int64_t& reduce, int64_t& inner) {
+  outer = reduce = inner = 1;
+  bool in_reduced = false;
+  bool after_reduced = false;
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    if (input_dims[i] == 1) {
+      continue;
+    }
+    if (reduced[i]) {
+      if (after_reduced) {
+        return false;
+      }
+      in_reduced = true;
+      reduce *= input_dims[i];
+    } else if (in_reduced || after_reduced) {
+      after_reduced = true;
+      in_reduced = false;
+      inner *= input_dims[i];
+    } else {
+      outer *= input_dims[i];
+    }
+  }
+  return true;
+}
+
+// The block reductions give each row to a warp or a block, so a few long rows leave most of the device idle.
+// cuDNN splits such rows across blocks.
+static bool UseBlockReduce(int64_t outer, int64_t reduce, int64_t inner) {
+  constexpr int64_t kMinOutputs = 128;
+  constexpr int64_t kMaxReduceOfFewOutputs = 16384;
+  return outer * inner >= kMinOutputs || reduce <= kMaxReduceOfFewOutputs;
+}
+
+template <bool allow_multi_axes>
+ReduceOp ReduceKernel<allow_multi_axes>::GetReduceOp(cudnnReduceTensorOp_t cudnnReduceOp) const {
+  switch (cudnnReduceOp) {
+    case CUDNN_REDUCE_TENSOR_ADD:
+      return log_sum_exp_ ? ReduceOp::LogSumExp
+                          : calculate_sqt_ ? ReduceOp::SumSquare
+                                           : calculate_log_ ? ReduceOp::LogSum : ReduceOp::Sum;
+    case CUDNN_REDUCE_TENSOR_AVG:
+      return ReduceOp::Mean;
+    case CUDNN_REDUCE_TENSOR_MAX:
+      return ReduceOp::Max;
+    case CUDNN_REDUCE_TENSOR_MIN:
+      return ReduceOp::Min;
+    case CUDNN_REDUCE_TENSOR_MUL:
+      return ReduceOp::Prod;
+    case CUDNN_REDUCE_TENSOR_NORM1:
+      return ReduceOp::L1;
+    case CUDNN_REDUCE_TENSOR_NORM2:
+      return ReduceOp::L2;
+    default:
+      ORT_THROW("Unsupported reduction ", static_cast<int>(cudnnReduceOp));
+  }
+}
+
 template <bool allow_multi_axes>
 template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices>
 Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnReduceTensorOp_t cudnnReduceOp) const {
@@ -64,13 +123,10 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
   const TensorShape input_shape{X->Shape()};
   const auto rank = input_shape.NumDimensions();
 
-  if (rank > 8) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "cuDNN only supports up to 8-D tensors in reduction");
-  }
-
   const auto& input_dims = input_shape.GetDims();
   std::vector<int64_t> output_dims;
-  std::vector<bool> reduced(rank, false);
+  // no axes reduce all of them
+  std::vector<bool> reduced(rank, axes_.empty());
   std::vector<int64_t> squeezed_output_dims;
   if (axes_.size() > 0) {
     output_dims = input_dims;
@@ -94,6 +150,26 @@ Status ReduceKernel<allow_multi_axes>::ComputeImpl(OpKernelContext* ctx, cudnnRe
 
   Tensor* Y = ctx->Output(0, TensorShape(squeezed_output_dims));
 
+  // the common reductions, over adjacent axes, are done in a single pass without the workspace of cuDNN
+  int64_t outer = 0;
+  int64_t reduce = 0;
+  int64_t inner = 0;
+  if (GetReduceView(input_dims, reduced, outer, reduce, inner) && UseBlockReduce(outer, reduce, inner)) {
+    const CudaT* input_data = reinterpret_cast<const CudaT*>(X->template Data<T>());
+    if (ReduceTensorIndices == CUDNN_REDUCE_TENSOR_FLATTENED_INDICES) {
+      ArgReduceImpl(input_data, Y->template MutableData<int64_t>(), outer, reduce, inner,
+                    cudnnReduceOp == CUDNN_REDUCE_TENSOR_MAX);
+    } else {
+      ReduceImpl(input_data, reinterpret_cast<CudaT*>(Y->template MutableData<T>()), outer, reduce, inner,
+                 GetReduceOp(cudnnReduceOp));
+    }
+    return Status::OK();
+  }
+
+  if (rank > 8) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "cuDNN only supports up to 8-D tensors in reduction");
+  }
+
   int64_t input_count = input_shape.Size();
   IAllocatorUniquePtr<float> temp_X;
   cudnnDataType_t cudnn_type_X = CudnnTensor::GetDataType<CudaT>();
@@ -4,6 +4,7 @@
 #pragma once
 #include "core/providers/cuda/cuda_common.h"
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include "core/providers/cuda/reduction/reduction_impl.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -22,6 +23,9 @@ class ReduceKernel : public CudaKernel, public ReduceKernelBase<allow_multi_axes
   template <typename T, cudnnReduceTensorIndices_t ReduceTensorIndices = CUDNN_REDUCE_TENSOR_NO_INDICES>
   Status ComputeImpl(OpKernelContext* ctx, cudnnReduceTensorOp_t cudnnReduceOp) const;
 
+  // the reduction of the block kernels that computes the same as cudnnReduceOp with the flags below
+  ReduceOp GetReduceOp(cudnnReduceTensorOp_t cudnnReduceOp) const;
+
   using ReduceKernelBase<allow_multi_axes>::axes_;
   using ReduceKernelBase<allow_multi_axes>::keepdims_;
 
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <functional>
+#include <type_traits>
 #include "cudnn_rnn_base.h"
 #include "rnn_impl.h"
 #include "core/providers/cpu/rnn/rnn_helpers.h"
@@ -72,7 +74,7 @@ template <typename T>
 Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                                           IAllocatorUniquePtr<void>& reorganized_w_data,
                                           CudnnFilterDescriptor& target_w_desc,
-                                          CudnnRNN& rnn_desc) const {
+                                          const CudnnRNN& rnn_desc) const {
   typedef typename ToCudaType<T>::MappedType CudaT;
   int64_t input_size = W->Shape()[2];
   // RNN W[num_directions_, hidden_size_, input_size]
@@ -109,6 +111,22 @@ Status CudnnRnnBase<T>::ReorganizeWeights(const Tensor* W, const Tensor* R, cons
 template <typename T>
 Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   typedef typename ToCudaType<T>::MappedType CudaT;
+  ORT_RETURN_IF_ERROR(rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                    cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
+  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
+  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+
+  // The persistent kernels need a Pascal or newer device, and don't run in double
+  int major = 0;
+  CUDA_RETURN_IF_ERROR(cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, GetDeviceId()));
+  if (major >= 6 && !std::is_same<T, double>::value) {
+    ORT_RETURN_IF_ERROR(persistent_rnn_desc_.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
+                                                 cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>(),
+                                                 CUDNN_RNN_ALGO_PERSIST_STATIC));
+    CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(persistent_rnn_desc_, CUDNN_RNN_PADDED_IO_ENABLED));
+    persistent_rnn_supported_ = true;
+  }
+
   // Cache the weight
   const Tensor* W;
   const Tensor* R;
@@ -118,13 +136,10 @@ Status CudnnRnnBase<T>::CacheCudnnRnnWeights(const OpKernelInfo& info) {
   bool get_B = info.TryGetConstantInput(RNN_Input_Index::B, &B);
 
   if (get_W && get_R) {
-    CudnnRNN tmp_rnn_desc;
-    ORT_RETURN_IF_ERROR(tmp_rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                         cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
     if (get_B) {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, B, w_data_cache_, w_desc_cache_, rnn_desc_));
     } else {
-      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, tmp_rnn_desc));
+      ORT_RETURN_IF_ERROR(ReorganizeWeights(W, R, nullptr, w_data_cache_, w_desc_cache_, rnn_desc_));
     }
     weight_cached_ = true;
   }
@@ -210,10 +225,6 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
 
   const int32_t* sequence_lens_data = (sequence_lens == nullptr) ? nullptr : sequence_lens->template Data<int32_t>();
 
-  CudnnRNN rnn_desc;
-  ORT_RETURN_IF_ERROR(rnn_desc.Set(CudnnHandle(), hidden_size_, RNN_NUM_LAYERS, cudnn_dropout_desc_,
-                                   cudnn_direction_mode_, rnn_mode_, CudnnTensor::GetDataType<CudaT>()));
-
   // Prepare the weight data
   IAllocatorUniquePtr<void> w_data;
   CudnnFilterDescriptor w_desc;
@@ -221,39 +232,53 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
     const Tensor& W = *ctx->Input<Tensor>(RNN_Input_Index::W);
     const Tensor& R = *ctx->Input<Tensor>(RNN_Input_Index::R);
     const Tensor* B = ctx->Input<Tensor>(RNN_Input_Index::B);
-    ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc);
+    ORT_RETURN_IF_ERROR(ReorganizeWeights(&W, &R, B, w_data, w_desc, rnn_desc_));
   }
 
-  // CUDNN_RNN_DATA_LAYOUT_SEQ_MAJOR_UNPACKED works with CUDNN_RNN_PADDED_IO_ENABLED, so that it will auto fill 0 for the shorter sequences
-  CUDNN_RETURN_IF_ERROR(cudnnSetRNNPaddingMode(rnn_desc, CUDNN_RNN_PADDED_IO_ENABLED));
+  // Small batches run with the persistent kernels, unless cuDNN can't run them for this RNN, e.g. as the weights
+  // don't fit on the device, in which case the standard algorithm runs instead.
+  const bool use_persistent_rnn = persistent_rnn_supported_ && batch_size <= RNN_MAX_PERSISTENT_BATCH_SIZE;
+  auto run_with_fallback = [&](const std::function<cudnnStatus_t(const cudnnRNNDescriptor_t rnn_desc)>& run) {
+    if (use_persistent_rnn) {
+      const cudnnStatus_t status = run(persistent_rnn_desc_);
+      if (status != CUDNN_STATUS_NOT_SUPPORTED)
+        return status;
+    }
+    return run(rnn_desc_);
+  };
 
-  size_t workspace_bytes;
-  CUDNN_RETURN_IF_ERROR(cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length), x_desc.data(), &workspace_bytes));
-  auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
   int32_t zero_seq_count = 0;
   std::vector<int32_t> zero_seq_index_cache(batch_size, 0);
   int64_t zero_seq_index_cache_size = 0;
 
   if (CUDNN_RNN_RELU == rnn_mode_ || CUDNN_RNN_TANH == rnn_mode_ || nullptr == sequence_lens_data) {
-    CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInference(CudnnHandle(),
-                                                   rnn_desc,
-                                                   gsl::narrow_cast<int>(seq_length),
-                                                   x_desc.data(),
-                                                   x_data_input,
-                                                   hx_desc,
-                                                   hx_data,
-                                                   cx_desc,
-                                                   cx_data,
-                                                   weight_cached_ ? w_desc_cache_ : w_desc,
-                                                   weight_cached_ ? w_data_cache_.get() : w_data.get(),
-                                                   y_desc.data(),
-                                                   y_data,
-                                                   y_h_desc,
-                                                   y_h_data,
-                                                   y_c_desc,
-                                                   y_c_data,
-                                                   workspace_cuda.get(),
-                                                   workspace_bytes));
+    CUDNN_RETURN_IF_ERROR(run_with_fallback([&](const cudnnRNNDescriptor_t rnn_desc) {
+      size_t workspace_bytes;
+      cudnnStatus_t status = cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length),
+                                                      x_desc.data(), &workspace_bytes);
+      if (status != CUDNN_STATUS_SUCCESS)
+        return status;
+      auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+      return cudnnRNNForwardInference(CudnnHandle(),
+                                      rnn_desc,
+                                      gsl::narrow_cast<int>(seq_length),
+                                      x_desc.data(),
+                                      x_data_input,
+                                      hx_desc,
+                                      hx_data,
+                                      cx_desc,
+                                      cx_data,
+                                      weight_cached_ ? w_desc_cache_ : w_desc,
+                                      weight_cached_ ? w_data_cache_.get() : w_data.get(),
+                                      y_desc.data(),
+                                      y_data,
+                                      y_h_desc,
+                                      y_h_data,
+                                      y_c_desc,
+                                      y_c_data,
+                                      workspace_cuda.get(),
+                                      workspace_bytes);
+    }));
   } else {
     // cudnn doesn't support 0 sequence inside the batch, find the 0 sequence and set it to 1
     // there's a ZeroMask kernel to reset the result to 0 for the 0 sequence
@@ -277,31 +302,39 @@ Status CudnnRnnBase<T>::ComputeInternal(OpKernelContext* ctx) const {
       }
     }
 
-    CudnnDataTensor x_desc;
-    x_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, input_size, seq_len_array.data());
-    CudnnDataTensor y_desc;
-    y_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, hidden_size_ * num_directions_, seq_len_array.data());
-
-    CUDNN_RETURN_IF_ERROR(cudnnRNNForwardInferenceEx(CudnnHandle(),
-                                                     rnn_desc,
-                                                     x_desc,
-                                                     x_data_input,
-                                                     hx_desc,
-                                                     hx_data,
-                                                     cx_desc,
-                                                     cx_data,
-                                                     weight_cached_ ? w_desc_cache_ : w_desc,
-                                                     weight_cached_ ? w_data_cache_.get() : w_data.get(),
-                                                     y_desc,
-                                                     y_data,
-                                                     y_h_desc,
-                                                     y_h_data,
-                                                     y_c_desc,
-                                                     y_c_data,
-                                                     nullptr, nullptr, nullptr, nullptr,
-                                                     nullptr, nullptr, nullptr, nullptr,
-                                                     workspace_cuda.get(),
-                                                     workspace_bytes));
+    CudnnDataTensor x_data_desc;
+    x_data_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, input_size, seq_len_array.data());
+    CudnnDataTensor y_data_desc;
+    y_data_desc.Set(CudnnTensor::GetDataType<CudaT>(), seq_length, batch_size, hidden_size_ * num_directions_, seq_len_array.data());
+
+    CUDNN_RETURN_IF_ERROR(run_with_fallback([&](const cudnnRNNDescriptor_t rnn_desc) {
+      size_t workspace_bytes;
+      cudnnStatus_t status = cudnnGetRNNWorkspaceSize(CudnnHandle(), rnn_desc, gsl::narrow_cast<int>(seq_length),
+                                                      x_desc.data(), &workspace_bytes);
+      if (status != CUDNN_STATUS_SUCCESS)
+        return status;
+      auto workspace_cuda = GetScratchBuffer<void>(workspace_bytes);
+      return cudnnRNNForwardInferenceEx(CudnnHandle(),
+                                        rnn_desc,
+                                        x_data_desc,
+                                        x_data_input,
+                                        hx_desc,
+                                        hx_data,
+                                        cx_desc,
+                                        cx_data,
+                                        weight_cached_ ? w_desc_cache_ : w_desc,
+                                        weight_cached_ ? w_data_cache_.get() : w_data.get(),
+                                        y_data_desc,
+                                        y_data,
+                                        y_h_desc,
+                                        y_h_data,
+                                        y_c_desc,
+                                        y_c_data,
+                                        nullptr, nullptr, nullptr, nullptr,
+                                        nullptr, nullptr, nullptr, nullptr,
+                                        workspace_cuda.get(),
+                                        workspace_bytes);
+    }));
 
     // Early terminate for this case since Y data is not required, and Y_h is obtained correctly, no need the following code to retrive Y_h from Y data.
     if (nullptr == Y) {
@@ -24,6 +24,10 @@ enum RNN_Input_Index {
 // Onnx RNN/GRU/LSTM only support 1 layer
 const int RNN_NUM_LAYERS = 1;
 
+// The largest batch run with CUDNN_RNN_ALGO_PERSIST_STATIC, whose kernels keep the recurrent weights on chip for
+// all the steps of the sequence. That pays off when the batch is too small to fill the GPU at each step.
+const int64_t RNN_MAX_PERSISTENT_BATCH_SIZE = 32;
+
 class CudnnRNN {
  public:
   CudnnRNN() : cudnn_rnn_desc_(nullptr) {
@@ -38,7 +42,8 @@ class CudnnRNN {
 
   Status Set(const cudnnHandle_t& cudnnHandle, int64_t hidden_size, int num_layers,
              cudnnDropoutDescriptor_t cudnn_dropout_desc, cudnnDirectionMode_t cudnn_direction_model,
-             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType) {
+             cudnnRNNMode_t rnn_mode, cudnnDataType_t dataType,
+             cudnnRNNAlgo_t rnn_algo = CUDNN_RNN_ALGO_STANDARD) {
     if (!cudnn_rnn_desc_)
       CUDNN_RETURN_IF_ERROR(cudnnCreateRNNDescriptor(&cudnn_rnn_desc_));
 
@@ -50,7 +55,7 @@ class CudnnRNN {
                                                 CUDNN_LINEAR_INPUT,  // We can also skip the input matrix transformation
                                                 cudnn_direction_model,
                                                 rnn_mode,
-                                                CUDNN_RNN_ALGO_STANDARD,  //CUDNN_RNN_ALGO_PERSIST_STATIC, CUDNN_RNN_ALGO_PERSIST_DYNAMIC
+                                                rnn_algo,
                                                 dataType));
 
     return Status::OK();
@@ -91,7 +96,8 @@ class CudnnRnnBase : public CudaKernel {
     rnn_mode_ = CUDNN_LSTM;
     weight_cached_ = false;
     w_data_cache_ = nullptr;
-    
+    persistent_rnn_supported_ = false;
+
     size_t state_size;
     cudnn_dropout_desc_.CreateDescriptorIfNeeded();
     cudnn_dropout_desc_.GetCudnnDropoutStatesSize(CudnnHandle(), state_size);
@@ -99,6 +105,8 @@ class CudnnRnnBase : public CudaKernel {
     cudnn_dropout_desc_.Set(CudnnHandle(), state_buffer_.get(), state_size);
   }
 
+  // Sets up the RNN descriptors for the mode of the derived kernel, and reorganizes the weights into the cuDNN
+  // layout once if they are constant.
   Status CacheCudnnRnnWeights(const OpKernelInfo& info);
 
   Status ComputeInternal(OpKernelContext* ctx) const override;
@@ -118,7 +126,7 @@ class CudnnRnnBase : public CudaKernel {
   Status ReorganizeWeights(const Tensor* W, const Tensor* R, const Tensor* B,
                            IAllocatorUniquePtr<void>& target_w_data,
                            CudnnFilterDescriptor& target_w_desc,
-                           CudnnRNN& rnn_desc) const;
+                           const CudnnRNN& rnn_desc) const;
 
   void SetWeightBias(const cudnnHandle_t handle,
                      const cudnnRNNDescriptor_t rnn_desc,
@@ -150,6 +158,11 @@ class CudnnRnnBase : public CudaKernel {
   // hidden_size_ from attribute
   int64_t hidden_size_;
   cudnnRNNMode_t rnn_mode_;
+  // rnn_desc_ runs CUDNN_RNN_ALGO_STANDARD and persistent_rnn_desc_, when the device and the type support it,
+  // CUDNN_RNN_ALGO_PERSIST_STATIC. Both are set in CacheCudnnRnnWeights and never changed after.
+  CudnnRNN rnn_desc_;
+  CudnnRNN persistent_rnn_desc_;
+  bool persistent_rnn_supported_;
   // w_desc_cache_ & w_data_cache_ are changed in Constructor if we can get the weights as constant input
   CudnnFilterDescriptor w_desc_cache_;
   IAllocatorUniquePtr<void> w_data_cache_;
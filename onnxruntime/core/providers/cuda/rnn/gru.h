@@ -24,7 +24,7 @@ class GRU final : public CudnnRnnBase<T> {
     // ONNX B layout is Wbzrh, Rbzrh, mapping to RNNLinLayerMatrixParams
     // the linLayerID is 1, 0, 2, 4, 3, 5, we can reuse it from W_lin_layer_id & R_lin_layer_id
 
-    CudnnRnnBase<T>::CacheCudnnRnnWeights(info);
+    ORT_THROW_IF_ERROR(CudnnRnnBase<T>::CacheCudnnRnnWeights(info));
   }
 };
 
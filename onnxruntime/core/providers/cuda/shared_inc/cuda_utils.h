@@ -5,6 +5,7 @@
 // as currently nvcc cannot compile all onnxruntime headers
 
 #pragma once
+#include <stdint.h>
 #include <memory>
 #include <vector>
 #include "fast_divmod.h"
@@ -18,8 +19,33 @@ enum class SimpleBroadcast : size_t {
   RightScalar = (size_t)-3,
   RightPerChannelBatch1 = (size_t)-4,
   RightPerChannelBatchN = (size_t)-5,
+  LeftPerChannelBatch1 = (size_t)-6,
+  LeftPerChannelBatchN = (size_t)-7,
 };
 
+// The tensors a Concat joins or a Split fills, passed to the kernel by value in its parameters so that no table
+// has to be copied to the device before the launch. Each tensor is a segment of every row of the concatenated
+// tensor: segment i is the range [segment_offsets[i], segment_offsets[i + 1]) of the row, and the row of tensor i
+// is only that segment.
+constexpr int kMaxSegmentTableSize = 64;
+
+template <typename PtrT>
+struct TensorSegmentTable {
+  PtrT data[kMaxSegmentTableSize];
+  int32_t segment_offsets[kMaxSegmentTableSize + 1];
+  int32_t size;
+};
+
+// The widest of the 16, 8, 4, 2 and 1 byte units that divides all the sizes and addresses or'ed into bits, to copy
+// the data in vectors of that many bytes
+inline size_t VectorSizeOf(uint64_t bits) {
+  size_t vector_size = 16;
+  while (vector_size > 1 && (bits & (vector_size - 1)) != 0) {
+    vector_size /= 2;
+  }
+  return vector_size;
+}
+
 template <typename T>
 class IConstantBuffer {
  public:
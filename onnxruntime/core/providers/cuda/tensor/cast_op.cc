@@ -31,6 +31,7 @@ const std::vector<MLDataType> castOpTypeConstraints{
       T,                                                          \
       kCudaExecutionProvider,                                     \
       KernelDefBuilder()                                          \
+          .MayInplace(0, 0)                                       \
           .TypeConstraint("T1", DataTypeImpl::GetTensorType<T>()) \
           .TypeConstraint("T2", castOpTypeConstraints),           \
       Cast<T>);                                                   \
@@ -41,6 +42,7 @@ const std::vector<MLDataType> castOpTypeConstraints{
       T,                                                          \
       kCudaExecutionProvider,                                     \
       KernelDefBuilder()                                          \
+          .MayInplace(0, 0)                                       \
           .TypeConstraint("T1", DataTypeImpl::GetTensorType<T>()) \
           .TypeConstraint("T2", castOpTypeConstraints),           \
       Cast<T>);
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include "concat.h"
 #include "concat_impl.h"
 
@@ -25,6 +26,30 @@ Status Concat::ComputeInternal(OpKernelContext* ctx) const {
   if (p.output_num_elements == 0)
     return Status::OK();
 
+  auto element_bytes = p.output_tensor->DataType()->Size();
+  if (input_count <= kMaxSegmentTableSize) {
+    // Each input is a segment of the rows of the output, so the table of the inputs goes to the kernel in its
+    // parameters and the data is copied in the widest vectors that divide the segments.
+    TensorSegmentTable<const void*> inputs;
+    inputs.size = input_count;
+    uint64_t bits = reinterpret_cast<uintptr_t>(p.output_tensor->DataRaw());
+    for (int i = 0; i < input_count; ++i) {
+      inputs.data[i] = p.inputs[i].tensor->DataRaw();
+      bits |= reinterpret_cast<uintptr_t>(inputs.data[i]) | (p.inputs[i].axis_pitch * element_bytes);
+    }
+    const size_t vector_size = VectorSizeOf(bits);
+    const int64_t num_vectors = p.output_num_elements * element_bytes / vector_size;
+    if (num_vectors <= std::numeric_limits<int32_t>::max()) {
+      int64_t segment_offset = 0;
+      for (int i = 0; i < input_count; ++i) {
+        inputs.segment_offsets[i] = static_cast<int32_t>(segment_offset);
+        segment_offset += p.inputs[i].axis_pitch * element_bytes / vector_size;
+      }
+      inputs.segment_offsets[input_count] = static_cast<int32_t>(segment_offset);
+      return ConcatSegmentsImpl(vector_size, inputs, p.output_tensor->MutableDataRaw(), num_vectors);
+    }
+  }
+
   std::vector<int64_t> concat_sizes(input_count);
 
   CudaAsyncBuffer<const void*> input_ptr(this, input_count);
@@ -53,7 +78,6 @@ Status Concat::ComputeInternal(OpKernelContext* ctx) const {
   input_ptr.CopyToGpu();
   int block_size_inside_axis_dim = static_cast<int>(p.output_axis_pitch / p.output_tensor->Shape()[p.axis]);
   int block_size_including_axis_dim = static_cast<int>(p.output_axis_pitch);
-  auto element_bytes = p.output_tensor->DataType()->Size();
   ORT_RETURN_IF_ERROR(ConcatImpl(element_bytes,
                                  block_size_including_axis_dim,
                                  block_size_inside_axis_dim,
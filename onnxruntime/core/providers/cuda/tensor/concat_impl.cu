@@ -98,5 +98,58 @@ Status ConcatImpl(const size_t element_bytes,
   return Status::OK();
 }
 
+template <typename T>
+__global__ void _ConcatSegmentsKernel(const fast_divmod row_size_div,
+                                      const TensorSegmentTable<const void*> inputs,
+                                      T* output_data,
+                                      const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int row = 0;
+  int pos = 0;
+  row_size_div.divmod(id, row, pos);
+
+  const int input_index = FindTensorSegment(inputs.segment_offsets, inputs.size, pos);
+  const int32_t segment_begin = inputs.segment_offsets[input_index];
+  const int32_t segment_size = inputs.segment_offsets[input_index + 1] - segment_begin;
+  output_data[id] = reinterpret_cast<const T*>(inputs.data[input_index])[row * segment_size + pos - segment_begin];
+}
+
+template <typename T>
+static void ConcatSegments(const TensorSegmentTable<const void*>& inputs, void* output_data, const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _ConcatSegmentsKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      fast_divmod(inputs.segment_offsets[inputs.size]),
+      inputs,
+      reinterpret_cast<T*>(output_data),
+      (CUDA_LONG)N);
+}
+
+Status ConcatSegmentsImpl(const size_t vector_size,
+                          const TensorSegmentTable<const void*>& inputs,
+                          void* output_data,
+                          const size_t N) {
+  switch (vector_size) {
+    case sizeof(int8_t):
+      ConcatSegments<int8_t>(inputs, output_data, N);
+      break;
+    case sizeof(int16_t):
+      ConcatSegments<int16_t>(inputs, output_data, N);
+      break;
+    case sizeof(int32_t):
+      ConcatSegments<int32_t>(inputs, output_data, N);
+      break;
+    case sizeof(int64_t):
+      ConcatSegments<int64_t>(inputs, output_data, N);
+      break;
+    case sizeof(uint4):
+      ConcatSegments<uint4>(inputs, output_data, N);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Vector size not supported for Concat operator");
+  }
+
+  return Status::OK();
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
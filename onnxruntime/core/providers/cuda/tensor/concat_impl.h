@@ -20,5 +20,13 @@ Status ConcatImpl(const size_t element_bytes,
                   const void** input_ptr,
                   const size_t N);
 
+// Concatenates the rows of the inputs in a single launch without copying a table to the device. The segments of
+// the table and N, the size of the output, are in vectors of vector_size bytes, which divide the segments and
+// align the inputs and the output.
+Status ConcatSegmentsImpl(const size_t vector_size,
+                          const TensorSegmentTable<const void*>& inputs,
+                          void* output_data,
+                          const size_t N);
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -60,6 +60,34 @@ Status Gather::ComputeInternal(OpKernelContext* context) const {
   const int64_t output_block_size = N * block_size;
   const int64_t indices_max = input_shape[p.axis];
 
+  if (output_block_size == 0 || p.output_tensor->Shape().Size() == 0)
+    return Status::OK();
+
+  // The blocks of the dims after the axis, such as the rows of an embedding, are gathered in the widest vectors
+  // that divide them when those are wider than the elements.
+  const size_t element_bytes = p.input_tensor->DataType()->Size();
+  const size_t vector_size = VectorSizeOf(reinterpret_cast<uintptr_t>(p.input_tensor->DataRaw()) |
+                                          reinterpret_cast<uintptr_t>(p.output_tensor->DataRaw()) |
+                                          (block_size * element_bytes));
+  if (vector_size > element_bytes) {
+    const int64_t vectors_per_block = block_size * element_bytes / vector_size;
+    const fast_divmod output_block_size_div(gsl::narrow_cast<int>(N * vectors_per_block));
+    const fast_divmod block_size_div(gsl::narrow_cast<int>(vectors_per_block));
+    const int64_t num_vectors = p.output_tensor->Shape().Size() * element_bytes / vector_size;
+    if (p.indices_tensor->DataType() == DataTypeImpl::GetType<int32_t>()) {
+      GatherVectorizedImpl(vector_size, input_block_size * element_bytes / vector_size, indices_max,
+                           p.indices_tensor->Data<int32_t>(), output_block_size_div, block_size_div,
+                           p.input_tensor->DataRaw(), p.output_tensor->MutableDataRaw(), num_vectors);
+      return Status::OK();
+    }
+    if (p.indices_tensor->DataType() == DataTypeImpl::GetType<int64_t>()) {
+      GatherVectorizedImpl(vector_size, input_block_size * element_bytes / vector_size, indices_max,
+                           p.indices_tensor->Data<int64_t>(), output_block_size_div, block_size_div,
+                           p.input_tensor->DataRaw(), p.output_tensor->MutableDataRaw(), num_vectors);
+      return Status::OK();
+    }
+  }
+
   // Put the output_block_size and block_size into div_strides
   // for divmod calling in _GatherKernel to calculate the input index
   CudaAsyncBuffer<fast_divmod> div_strides(this, 2);
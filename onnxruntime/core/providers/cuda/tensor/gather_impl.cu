@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/common.h"
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "gather_impl.h"
 
@@ -47,6 +48,82 @@ void GatherImpl(
       input_block_size, indices_max, indices_data, div_strides, input_data, output_data, (CUDA_LONG)N);
 }
 
+template <typename T, typename Tin>
+__global__ void _GatherVectorizedKernel(
+    const int64_t input_block_size,
+    const int64_t indices_max,
+    const Tin* indices_data,
+    const fast_divmod output_block_size_div,
+    const fast_divmod block_size_div,
+    const T* input_data,
+    T* output_data,
+    const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int input_block_index, block_offset;
+  output_block_size_div.divmod(id, input_block_index, block_offset);
+  int indices_index, offset;
+  block_size_div.divmod(block_offset, indices_index, offset);
+  int64_t idx = indices_data[indices_index];
+  if (idx < 0 || idx >= indices_max) {
+    output_data[id] = T();
+    return;
+  }
+
+  output_data[id] = input_data[input_block_index * input_block_size + idx * block_size_div.d_ + offset];
+}
+
+template <typename T, typename Tin>
+static void GatherVectorized(
+    const int64_t input_block_size,
+    const int64_t indices_max,
+    const Tin* indices_data,
+    const fast_divmod& output_block_size,
+    const fast_divmod& block_size,
+    const void* input_data,
+    void* output_data,
+    const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _GatherVectorizedKernel<T, Tin><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      input_block_size, indices_max, indices_data, output_block_size, block_size,
+      reinterpret_cast<const T*>(input_data), reinterpret_cast<T*>(output_data), (CUDA_LONG)N);
+}
+
+template <typename Tin>
+void GatherVectorizedImpl(
+    const size_t vector_size,
+    const int64_t input_block_size,
+    const int64_t indices_max,
+    const Tin* indices_data,
+    const fast_divmod& output_block_size,
+    const fast_divmod& block_size,
+    const void* input_data,
+    void* output_data,
+    const size_t N) {
+  switch (vector_size) {
+    case sizeof(uint16_t):
+      GatherVectorized<uint16_t>(input_block_size, indices_max, indices_data, output_block_size, block_size,
+                                 input_data, output_data, N);
+      break;
+    case sizeof(uint32_t):
+      GatherVectorized<uint32_t>(input_block_size, indices_max, indices_data, output_block_size, block_size,
+                                 input_data, output_data, N);
+      break;
+    case sizeof(uint2):
+      GatherVectorized<uint2>(input_block_size, indices_max, indices_data, output_block_size, block_size,
+                              input_data, output_data, N);
+      break;
+    case sizeof(uint4):
+      GatherVectorized<uint4>(input_block_size, indices_max, indices_data, output_block_size, block_size,
+                              input_data, output_data, N);
+      break;
+    default:
+      ORT_THROW("Unsupported vector size for Gather: ", vector_size);
+  }
+}
+
+template void GatherVectorizedImpl<int32_t>(const size_t vector_size, const int64_t input_block_size, const int64_t indices_max, const int32_t* indices_data, const fast_divmod& output_block_size, const fast_divmod& block_size, const void* input_data, void* output_data, const size_t N);
+template void GatherVectorizedImpl<int64_t>(const size_t vector_size, const int64_t input_block_size, const int64_t indices_max, const int64_t* indices_data, const fast_divmod& output_block_size, const fast_divmod& block_size, const void* input_data, void* output_data, const size_t N);
+
 #define SPECIALIZED_IMPL(T)                                                                                                                                                                                          \
   template void GatherImpl<T, int32_t>(const int64_t input_block_size, const int64_t indices_max, const int32_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N); \
   template void GatherImpl<T, int64_t>(const int64_t input_block_size, const int64_t indices_max, const int64_t* indices_data, const fast_divmod* div_strides, const T* input_data, T* output_data, const size_t N);
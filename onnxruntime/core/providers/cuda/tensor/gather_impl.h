@@ -18,5 +18,19 @@ void GatherImpl(
     T* output_data,
     const size_t N);
 
+// Gathers the blocks of the dims after the axis, the rows of an embedding, in vectors of vector_size bytes, which
+// divide the blocks and align the data. input_block_size, the divisors and N are in vectors.
+template <typename Tin>
+void GatherVectorizedImpl(
+    const size_t vector_size,
+    const int64_t input_block_size,
+    const int64_t indices_max,
+    const Tin* indices_data,
+    const fast_divmod& output_block_size,
+    const fast_divmod& block_size,
+    const void* input_data,
+    void* output_data,
+    const size_t N);
+
 }  // namespace cuda
 }  // namespace onnxruntime
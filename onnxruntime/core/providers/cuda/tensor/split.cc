@@ -57,6 +57,32 @@ Status Split::ComputeInternal(OpKernelContext* ctx) const {
       axis_dimension_input_output_mapping.at(index++) = i;
     }
   }
+
+  if (input_shape.Size() == 0)
+    return Status::OK();
+
+  size_t element_size = input_tensor->DataType()->Size();
+  if (num_outputs <= kMaxSegmentTableSize) {
+    // Each output is a segment of the rows of the input, so the table of the outputs goes to the kernel in its
+    // parameters and the data is copied in the widest vectors that divide the segments.
+    TensorSegmentTable<void*> outputs;
+    outputs.size = num_outputs;
+    uint64_t bits = reinterpret_cast<uintptr_t>(input_data);
+    for (int i = 0; i < num_outputs; ++i) {
+      outputs.data[i] = output_ptr_span[i];
+      bits |= reinterpret_cast<uintptr_t>(outputs.data[i]) |
+              (split_sizes[i] * block_size_inside_axis_dim * element_size);
+    }
+    const size_t vector_size = VectorSizeOf(bits);
+    int64_t segment_offset = 0;
+    for (int i = 0; i < num_outputs; ++i) {
+      outputs.segment_offsets[i] = static_cast<int32_t>(segment_offset);
+      segment_offset += split_sizes[i] * block_size_inside_axis_dim * element_size / vector_size;
+    }
+    outputs.segment_offsets[num_outputs] = static_cast<int32_t>(segment_offset);
+    return SplitSegmentsImpl(vector_size, input_data, outputs, input_shape.Size() * element_size / vector_size);
+  }
+
   output_ptr.CopyToGpu();
 
   CudaAsyncBuffer<int64_t> split_sizes_gpu(this, split_sizes);
@@ -72,7 +98,6 @@ Status Split::ComputeInternal(OpKernelContext* ctx) const {
   CudaAsyncBuffer<int64_t> axis_dimension_input_output_mapping_gpu(this, axis_dimension_input_output_mapping);
   axis_dimension_input_output_mapping_gpu.CopyToGpu();
 
-  size_t element_size = input_tensor->DataType()->Size();
   ORT_RETURN_IF_ERROR(SplitImpl(element_size,
                                 block_size_including_axis_dim,
                                 block_size_inside_axis_dim,
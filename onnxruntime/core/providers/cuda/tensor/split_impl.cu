@@ -94,5 +94,58 @@ Status SplitImpl(const size_t element_size,
   return Status::OK();
 }
 
+template <typename T>
+__global__ void _SplitSegmentsKernel(const fast_divmod row_size_div,
+                                     const T* input_data,
+                                     const TensorSegmentTable<void*> outputs,
+                                     const CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+  int row = 0;
+  int pos = 0;
+  row_size_div.divmod(id, row, pos);
+
+  const int output_index = FindTensorSegment(outputs.segment_offsets, outputs.size, pos);
+  const int32_t segment_begin = outputs.segment_offsets[output_index];
+  const int32_t segment_size = outputs.segment_offsets[output_index + 1] - segment_begin;
+  reinterpret_cast<T*>(outputs.data[output_index])[row * segment_size + pos - segment_begin] = input_data[id];
+}
+
+template <typename T>
+static void SplitSegments(const void* input_data, const TensorSegmentTable<void*>& outputs, const size_t N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _SplitSegmentsKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      fast_divmod(outputs.segment_offsets[outputs.size]),
+      reinterpret_cast<const T*>(input_data),
+      outputs,
+      (CUDA_LONG)N);
+}
+
+Status SplitSegmentsImpl(const size_t vector_size,
+                         const void* input_data,
+                         const TensorSegmentTable<void*>& outputs,
+                         const size_t N) {
+  switch (vector_size) {
+    case sizeof(int8_t):
+      SplitSegments<int8_t>(input_data, outputs, N);
+      break;
+    case sizeof(int16_t):
+      SplitSegments<int16_t>(input_data, outputs, N);
+      break;
+    case sizeof(int32_t):
+      SplitSegments<int32_t>(input_data, outputs, N);
+      break;
+    case sizeof(int64_t):
+      SplitSegments<int64_t>(input_data, outputs, N);
+      break;
+    case sizeof(uint4):
+      SplitSegments<uint4>(input_data, outputs, N);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Vector size not supported for Split operator");
+  }
+
+  return Status::OK();
+}
+
 }  // namespace cuda
 }  // namespace onnxruntime
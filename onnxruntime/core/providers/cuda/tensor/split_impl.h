@@ -20,5 +20,13 @@ Status SplitImpl(const size_t element_size,
                  void** output_ptr,
                  const size_t N);
 
+// Splits the rows of the input into the outputs in a single launch without copying a table to the device. The
+// segments of the table and N, the size of the input, are in vectors of vector_size bytes, which divide the
+// segments and align the input and the outputs.
+Status SplitSegmentsImpl(const size_t vector_size,
+                         const void* input_data,
+                         const TensorSegmentTable<void*>& outputs,
+                         const size_t N);
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -1,10 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <limits>
 #include "transpose.h"
 #include "transpose_impl.h"
 #include "core/providers/cpu/tensor/utils.h"
-#include "core/providers/cuda/shared_inc/fpgeneric.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -20,30 +21,38 @@ namespace cuda {
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       Transpose<T>);
 
-// special case acceleration using cublas matrix transpose
-std::tuple<int, int> TryTransposeWithCublas(const std::vector<size_t>& perm, const TensorShape& input_shape) {
-  int M = 0;
-  int N = 0;
-
-  if (perm.size() == 4 && input_shape[0] == 1 && perm[0] == 0) {
-    // NCHW <-> NHWC when N == 1
-    if ((perm[1] == 2 && perm[2] == 3 && perm[3] == 1) ||
-        (perm[1] == 3 && perm[2] == 1 && perm[3] == 2)) {
-      if (perm[1] == 2) {
-        M = gsl::narrow<int>(input_shape[1]);
-        N = gsl::narrow<int>(input_shape[2] * input_shape[3]);
-      } else {
-        M = gsl::narrow<int>(input_shape[1] * input_shape[2]);
-        N = gsl::narrow<int>(input_shape[3]);
-      }
-    }
-  } else if (perm.size() == 2 && perm[1] == 0 && perm[0] == 1) {
-    // 2D matrix transpose
-    M = gsl::narrow<int>(input_shape[0]);
-    N = gsl::narrow<int>(input_shape[1]);
+// Transposes with the tiled kernels if the permutation is a batched 2D transpose, which covers NCHW <-> NHWC and
+// the 0213 permutations of attention. The items of 2, 4 or 8 bytes are transposed through shared memory tiles,
+// the larger ones, and the batches the tiles can't be launched for, are copied with the widest vectors the size
+// and alignment of the items allow.
+static bool TryTransposeBatched2D(const std::vector<size_t>& perm, const Tensor& X, Tensor& Y) {
+  size_t batch_count, rows, cols, elements_per_item;
+  if (!TransposeBase::IsBatchedTranspose2D(perm, X.Shape().GetDims(), batch_count, rows, cols, elements_per_item)) {
+    return false;
   }
 
-  return std::make_tuple(M, N);
+  const int64_t size = X.Shape().Size();
+  if (size > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+
+  const void* input_data = X.DataRaw();
+  void* output_data = Y.MutableDataRaw();
+  const size_t item_size = X.DataType()->Size() * elements_per_item;
+
+  // the largest power of 2 that divides the item size and both addresses
+  const size_t combined = reinterpret_cast<uintptr_t>(input_data) | reinterpret_cast<uintptr_t>(output_data) |
+                          item_size;
+  const size_t alignment = combined & (~combined + 1);
+
+  if (alignment == item_size && item_size <= sizeof(uint64_t) && CanDoTranspose3D(batch_count, rows, cols)) {
+    Transpose3DImpl(item_size, input_data, output_data, batch_count, rows, cols);
+    return true;
+  }
+
+  const size_t vector_size = std::min<size_t>(alignment, 16);
+  TransposeItemsImpl(vector_size, input_data, output_data, batch_count, rows, cols, item_size / vector_size);
+  return true;
 }
 
 template <typename T>
@@ -65,30 +74,7 @@ Status Transpose<T>::ComputeInternal(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor* Y = ctx->Output(0, output_shape);
 
-  auto mn = TryTransposeWithCublas(*p_perm, input_shape);
-  int M = std::get<0>(mn);
-  int N = std::get<1>(mn);
-  if (M != 0 && N != 0) {
-    typedef typename ToCudaType<T>::MappedType CudaT;
-    CudaT one = ToCudaType<T>::FromFloat(1.0f);
-    CudaT zero = ToCudaType<T>::FromFloat(0.0f);
-    const CudaT* input_data = reinterpret_cast<const CudaT*>(X.template Data<T>());
-    CudaT* output_data = reinterpret_cast<CudaT*>(Y->template MutableData<T>());
-    CUBLAS_RETURN_IF_ERROR(
-        cublasTransposeHelper(
-            CublasHandle(),
-            CUBLAS_OP_T,
-            CUBLAS_OP_T,
-            M,
-            N,
-            &one,
-            input_data,
-            N,
-            &zero,
-            input_data,
-            N,
-            output_data,
-            M));
+  if (output_shape.Size() == 0 || TryTransposeBatched2D(*p_perm, X, *Y)) {
     return Status::OK();
   }
 
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+#include "core/common/common.h"
 #include "core/providers/cuda/cu_inc/common.cuh"
 #include "transpose_impl.h"
 
@@ -32,6 +34,123 @@ void TransposeImpl(size_t shape_rank, const int64_t* input_strides, const size_t
       fdm_output_strides, output_data, N);
 }
 
+// A block of kTileDim x kTileRows threads transposes a tile of kTileDim x kTileDim items, each thread moving
+// kTileDim / kTileRows of them. The padding column keeps the reads of the columns of the tile free of shared memory
+// bank conflicts.
+constexpr int kTileDim = 32;
+constexpr int kTileRows = 8;
+
+template <typename T>
+__global__ void _Transpose3DKernel(const T* input_data, T* output_data, int rows, int cols) {
+  __shared__ T tile[kTileDim][kTileDim + 1];
+
+  const CUDA_LONG matrix_offset = static_cast<CUDA_LONG>(blockIdx.z) * rows * cols;
+  input_data += matrix_offset;
+  output_data += matrix_offset;
+
+  int x = blockIdx.x * kTileDim + threadIdx.x;
+  int y = blockIdx.y * kTileDim + threadIdx.y;
+  if (x < cols) {
+    for (int i = 0; i < kTileDim && y + i < rows; i += kTileRows) {
+      tile[threadIdx.y + i][threadIdx.x] = input_data[(y + i) * cols + x];
+    }
+  }
+
+  __syncthreads();
+
+  x = blockIdx.y * kTileDim + threadIdx.x;
+  y = blockIdx.x * kTileDim + threadIdx.y;
+  if (x < rows) {
+    for (int i = 0; i < kTileDim && y + i < cols; i += kTileRows) {
+      output_data[(y + i) * rows + x] = tile[threadIdx.x][threadIdx.y + i];
+    }
+  }
+}
+
+bool CanDoTranspose3D(int64_t batch_count, int64_t rows, int64_t cols) {
+  // the tiles of the rows and the matrices are the y and z dimensions of the grid, which are limited to 65535
+  constexpr int64_t max_grid_dim = 65535;
+  return batch_count <= max_grid_dim && (rows + kTileDim - 1) / kTileDim <= max_grid_dim &&
+         batch_count * rows * cols <= std::numeric_limits<CUDA_LONG>::max();
+}
+
+template <typename T>
+static void Transpose3DImpl(const void* input_data, void* output_data, int batch_count, int rows, int cols) {
+  const dim3 grid((cols + kTileDim - 1) / kTileDim, (rows + kTileDim - 1) / kTileDim, batch_count);
+  const dim3 block(kTileDim, kTileRows);
+  _Transpose3DKernel<T><<<grid, block, 0>>>(reinterpret_cast<const T*>(input_data),
+                                            reinterpret_cast<T*>(output_data), rows, cols);
+}
+
+void Transpose3DImpl(size_t item_size, const void* input_data, void* output_data,
+                     int64_t batch_count, int64_t rows, int64_t cols) {
+  // the items are only moved, so they are transposed as unsigned integers of their size
+  switch (item_size) {
+    case sizeof(uint16_t):
+      Transpose3DImpl<uint16_t>(input_data, output_data, static_cast<int>(batch_count), static_cast<int>(rows),
+                                static_cast<int>(cols));
+      break;
+    case sizeof(uint32_t):
+      Transpose3DImpl<uint32_t>(input_data, output_data, static_cast<int>(batch_count), static_cast<int>(rows),
+                                static_cast<int>(cols));
+      break;
+    case sizeof(uint64_t):
+      Transpose3DImpl<uint64_t>(input_data, output_data, static_cast<int>(batch_count), static_cast<int>(rows),
+                                static_cast<int>(cols));
+      break;
+    default:
+      ORT_THROW("Unsupported item size of the tiled transpose: ", item_size);
+  }
+}
+
+template <typename T>
+__global__ void _TransposeItemsKernel(const T* input_data, T* output_data, fast_divmod fdm_vectors_per_item,
+                                      fast_divmod fdm_rows, fast_divmod fdm_cols, CUDA_LONG N) {
+  CALCULATE_ELEMENTWISE_INDEX_OR_EXIT(id, N);
+
+  // the output is [batch, cols, rows, vectors_per_item] and the input [batch, rows, cols, vectors_per_item]
+  int item, vector, matrix_col, row, matrix, col;
+  fdm_vectors_per_item.divmod(id, item, vector);
+  fdm_rows.divmod(item, matrix_col, row);
+  fdm_cols.divmod(matrix_col, matrix, col);
+  const CUDA_LONG input_item = (matrix * fdm_rows.d_ + row) * fdm_cols.d_ + col;
+  output_data[id] = input_data[input_item * fdm_vectors_per_item.d_ + vector];
+}
+
+template <typename T>
+static void TransposeItemsImpl(const void* input_data, void* output_data, int rows, int cols, int vectors_per_item,
+                               CUDA_LONG N) {
+  int blocksPerGrid = (int)(ceil(static_cast<float>(N) / GridDim::maxThreadsPerBlock));
+  _TransposeItemsKernel<T><<<blocksPerGrid, GridDim::maxThreadsPerBlock, 0>>>(
+      reinterpret_cast<const T*>(input_data), reinterpret_cast<T*>(output_data),
+      fast_divmod(vectors_per_item), fast_divmod(rows), fast_divmod(cols), N);
+}
+
+void TransposeItemsImpl(size_t vector_size, const void* input_data, void* output_data,
+                        int64_t batch_count, int64_t rows, int64_t cols, int64_t vectors_per_item) {
+  const CUDA_LONG N = static_cast<CUDA_LONG>(batch_count * rows * cols * vectors_per_item);
+  switch (vector_size) {
+    case sizeof(uint16_t):
+      TransposeItemsImpl<uint16_t>(input_data, output_data, static_cast<int>(rows), static_cast<int>(cols),
+                                   static_cast<int>(vectors_per_item), N);
+      break;
+    case sizeof(uint32_t):
+      TransposeItemsImpl<uint32_t>(input_data, output_data, static_cast<int>(rows), static_cast<int>(cols),
+                                   static_cast<int>(vectors_per_item), N);
+      break;
+    case sizeof(uint2):
+      TransposeItemsImpl<uint2>(input_data, output_data, static_cast<int>(rows), static_cast<int>(cols),
+                                static_cast<int>(vectors_per_item), N);
+      break;
+    case sizeof(uint4):
+      TransposeItemsImpl<uint4>(input_data, output_data, static_cast<int>(rows), static_cast<int>(cols),
+                                static_cast<int>(vectors_per_item), N);
+      break;
+    default:
+      ORT_THROW("Unsupported vector size of the transpose: ", vector_size);
+  }
+}
+
 #define SPECIALIZED_IMPL(T)                                                                                  \
   template void TransposeImpl<T>(size_t shape_rank, const int64_t* input_strides, const size_t* perm,        \
                                  const T* input_data, const fast_divmod* fdm_output_strides, T* output_data, \
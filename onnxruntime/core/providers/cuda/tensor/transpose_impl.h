@@ -12,5 +12,19 @@ template <typename T>
 void TransposeImpl(size_t shape_rank, const int64_t* input_strides, const size_t* perm, const T* input_data,
                    const fast_divmod* fdm_output_strides, T* output_data, size_t N);
 
+// Whether Transpose3DImpl can launch the tiles of the batch of matrices.
+bool CanDoTranspose3D(int64_t batch_count, int64_t rows, int64_t cols);
+
+// Transposes each of the batch_count input matrices of rows x cols items of item_size bytes, 2, 4 or 8, through
+// shared memory tiles, so that both the reads of the input and the writes of the output are coalesced.
+void Transpose3DImpl(size_t item_size, const void* input_data, void* output_data,
+                     int64_t batch_count, int64_t rows, int64_t cols);
+
+// Transposes each of the batch_count input matrices of rows x cols items, where an item is vectors_per_item
+// vectors of vector_size bytes, 2, 4, 8 or 16. The items are copied a vector per thread, which keeps the accesses
+// coalesced for the items of a few vectors and more, such as the heads moved by the 0213 permutations of attention.
+void TransposeItemsImpl(size_t vector_size, const void* input_data, void* output_data,
+                        int64_t batch_count, int64_t rows, int64_t cols, int64_t vectors_per_item);
+
 }  // namespace cuda
 }  // namespace onnxruntime
@@ -18,6 +18,16 @@ mkldnn::memory::data_type MklDnnType<float>() {
   return mkldnn::memory::data_type::f32;
 }
 
+template <>
+mkldnn::memory::data_type MklDnnType<uint8_t>() {
+  return mkldnn::memory::data_type::u8;
+}
+
+template <>
+mkldnn::memory::data_type MklDnnType<int8_t>() {
+  return mkldnn::memory::data_type::s8;
+}
+
 static mkldnn::engine& GetEngine() {
   static mkldnn::engine cpu_engine = mkldnn::engine(mkldnn::engine::cpu, 0);
   return cpu_engine;
@@ -8,6 +8,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/providers/mkldnn/subgraph/mkldnn_func_kernel.h"
 #include "mkldnn_execution_provider.h"
 #include "mkldnn_fwd.h"
@@ -36,6 +37,11 @@ MKLDNNExecutionProvider::MKLDNNExecutionProvider(const MKLDNNExecutionProviderIn
     InsertAllocator(std::shared_ptr<IArenaAllocator>(
         std::make_unique<DummyArena>(cpu_memory_info.factory(0))));
   }
+
+  const char* cached_primitives_env = getenv("ORT_MKLDNN_MAX_CACHED_PRIMITIVES");
+  if (cached_primitives_env) {
+    max_cached_primitives_ = static_cast<size_t>(std::max(1, atoi(cached_primitives_env)));
+  }
 }  // namespace onnxruntime
 
 MKLDNNExecutionProvider::~MKLDNNExecutionProvider() {
@@ -132,6 +138,84 @@ bool MKLDNNExecutionProvider::UseSubgraph(const onnxruntime::GraphViewer& graph_
   return use_subgraph;
 }
 
+namespace {
+template <typename T>
+bool GetInitializerValues(const onnxruntime::GraphViewer& graph_viewer, const NodeArg* arg,
+                          ONNX_NAMESPACE::TensorProto_DataType data_type, std::vector<T>& values) {
+  const auto& initializers = graph_viewer.GetAllInitializedTensors();
+  auto it = initializers.find(arg->Name());
+  if (it == initializers.end() || it->second->data_type() != data_type) {
+    return false;
+  }
+  const auto* tensor_proto = it->second;
+
+  int64_t size = 1;
+  for (auto dim : tensor_proto->dims()) {
+    size *= dim;
+  }
+  values.resize(static_cast<size_t>(size));
+  return utils::UnpackTensor<T>(*tensor_proto,
+                                utils::HasRawData(*tensor_proto) ? tensor_proto->raw_data().data() : nullptr,
+                                tensor_proto->raw_data().size(), values.data(), size)
+      .IsOK();
+}
+}  // namespace
+
+bool MKLDNNExecutionProvider::IsQLinearConvSupported(const onnxruntime::GraphViewer& graph_viewer,
+                                                     const Node* node) const {
+  const auto& node_inputs = node->InputDefs();
+  if (!HasRank(node_inputs[0], 4) || node_inputs[0]->Type() == nullptr ||
+      *node_inputs[0]->Type() != "tensor(uint8)") {
+    return false;
+  }
+
+  std::vector<float> x_scale, w_scale, y_scale;
+  std::vector<uint8_t> x_zero_point, w, w_zero_point, y_zero_point;
+  if (!GetInitializerValues(graph_viewer, node_inputs[1], ONNX_NAMESPACE::TensorProto_DataType_FLOAT, x_scale) ||
+      !GetInitializerValues(graph_viewer, node_inputs[2], ONNX_NAMESPACE::TensorProto_DataType_UINT8, x_zero_point) ||
+      !GetInitializerValues(graph_viewer, node_inputs[3], ONNX_NAMESPACE::TensorProto_DataType_UINT8, w) ||
+      !GetInitializerValues(graph_viewer, node_inputs[4], ONNX_NAMESPACE::TensorProto_DataType_FLOAT, w_scale) ||
+      !GetInitializerValues(graph_viewer, node_inputs[5], ONNX_NAMESPACE::TensorProto_DataType_UINT8, w_zero_point) ||
+      !GetInitializerValues(graph_viewer, node_inputs[6], ONNX_NAMESPACE::TensorProto_DataType_FLOAT, y_scale) ||
+      !GetInitializerValues(graph_viewer, node_inputs[7], ONNX_NAMESPACE::TensorProto_DataType_UINT8, y_zero_point)) {
+    return false;
+  }
+  if (node_inputs.size() > 8 &&
+      graph_viewer.GetAllInitializedTensors().count(node_inputs[8]->Name()) == 0) {
+    return false;
+  }
+
+  const auto& w_dims = graph_viewer.GetAllInitializedTensors().at(node_inputs[3]->Name())->dims();
+  if (w_dims.size() != 4 || x_scale.size() != 1 || x_zero_point.size() != 1 || w_zero_point.size() != 1 ||
+      y_scale.size() != 1 || y_zero_point.size() != 1 ||
+      (w_scale.size() != 1 && static_cast<int64_t>(w_scale.size()) != w_dims[0])) {
+    return false;
+  }
+
+  // the weights are shifted to s8
+  for (auto value : w) {
+    int shifted = static_cast<int>(value) - w_zero_point[0];
+    if (shifted < -128 || shifted > 127)
+      return false;
+  }
+
+  // the input zero point is folded into the bias, which doesn't account for the padding
+  if (x_zero_point[0] != 0) {
+    const auto& attributes = node->GetAttributes();
+    auto attr = attributes.find("auto_pad");
+    if (attr != attributes.end() && attr->second.s().find("SAME") != std::string::npos)
+      return false;
+    attr = attributes.find("pads");
+    if (attr != attributes.end()) {
+      for (auto pad : attr->second.ints()) {
+        if (pad != 0)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
 void MKLDNNExecutionProvider::CreateOrUpdateMklDnnNode(const Node* node,
                                                        std::shared_ptr<mkl_dnn::Subgraph>& subgraph_ptr,
                                                        mkl_dnn::Subgraph::SubgraphVariables& sub_var,
@@ -149,9 +233,12 @@ void MKLDNNExecutionProvider::CreateOrUpdateMklDnnNode(const Node* node,
     mkldnn_node.node_index = static_cast<int>(subgraph_ptr->mkldnn_nodes.size()) + 1;
     const auto& node_outputs = node->OutputDefs();
     mkldnn_node.output_name = node_outputs[0]->Name();
-    if (node->OpType() == "Conv") {
+    if (node->OpType() == "Conv" || node->OpType() == "Gemm" || node->OpType() == "MatMul") {
       mkldnn_node.weight_name = node->InputDefs()[1]->Name();
     }
+    if (node->OpType() == "QLinearConv") {
+      mkldnn_node.weight_name = node->InputDefs()[3]->Name();
+    }
     for (size_t i = 0; i < node_inputs.size(); i++) {
       auto iter = output_to_source_node_map.find(node_inputs[i]->Name());
       if (iter != output_to_source_node_map.end())
@@ -227,7 +314,7 @@ std::vector<std::unique_ptr<ComputeCapability>> MKLDNNExecutionProvider::GetCapa
       continue;
     }
 
-    if (IsDimensionSupported(node) == false) {
+    if (IsDimensionSupported(graph_viewer, node) == false) {
       node_index++;
       if (subgraph_ptr->mkldnn_nodes.size() > 0) {
         CreateMetaDef(graph_viewer, subgraph_attributes, subgraph_ptr, sub_var, result);
@@ -245,7 +332,8 @@ std::vector<std::unique_ptr<ComputeCapability>> MKLDNNExecutionProvider::GetCapa
       // can we fuse (at mkldnn level) nodes?
       bool fused = false;
       if (sub_var.subgraph_node_indexes.size() > 1 && node->OpType() == "Relu") {
-        if (subgraph_ptr->mkldnn_nodes.back().name == "BatchNormalization" || subgraph_ptr->mkldnn_nodes.back().name == "Conv") {
+        const auto& last_name = subgraph_ptr->mkldnn_nodes.back().name;
+        if (last_name == "BatchNormalization" || last_name == "Conv" || last_name == "Gemm" || last_name == "MatMul") {
           subgraph_ptr->mkldnn_nodes.back().name += "-Relu";
           fused = true;
         }
@@ -273,7 +361,8 @@ std::vector<std::unique_ptr<ComputeCapability>> MKLDNNExecutionProvider::GetCapa
             const auto& next_node_inputs = next_node->InputDefs();
             bool input_from_subgraph = true;
             size_t inputs_count = 1;
-            if (next_node->OpType() == "Sum")
+            // all inputs of the n-ary kernels are either from the subgraph or the subgraph inputs
+            if (next_node->OpType() == "Sum" || next_node->OpType() == "Add" || next_node->OpType() == "Concat")
               inputs_count = next_node_inputs.size();
             for (size_t i = 0; i < inputs_count; i++) {
               auto in = next_node_inputs[i];
@@ -282,6 +371,9 @@ std::vector<std::unique_ptr<ComputeCapability>> MKLDNNExecutionProvider::GetCapa
                 input_from_subgraph = false;
               }
             }
+            // the u8 outputs of QLinearConv are only passed on to QLinearConv
+            if ((next_node->OpType() == "QLinearConv") != (node->OpType() == "QLinearConv"))
+              input_from_subgraph = false;
             if (input_from_subgraph == false) {
               CreateMetaDef(graph_viewer, subgraph_attributes, subgraph_ptr, sub_var, result);
               subgraph_attributes.clear();
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <list>
@@ -29,6 +30,18 @@ struct MKLDNNExecutionProviderInfo {
   MKLDNNExecutionProviderInfo() = default;
 };
 
+// Lookups of the subgraph primitive caches of a provider. A miss builds the primitives of a subgraph for the
+// dims of its inputs, an eviction destroys the ones of the least recently used dims.
+struct MKLDNNPrimitiveCacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t evictions{0};
+
+  double HitRate() const {
+    return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+  }
+};
+
 // Logical device representation.
 class MKLDNNExecutionProvider : public IExecutionProvider {
  public:
@@ -58,6 +71,35 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
     reordered_buffers_.push_back(std::move(buffer));
   }
 
+  // input dims whose primitives are kept for each subgraph.
+  // The ORT_MKLDNN_MAX_CACHED_PRIMITIVES environment variable overrides it.
+  size_t GetMaxCachedPrimitives() const {
+    return max_cached_primitives_;
+  }
+
+  void SetMaxCachedPrimitives(size_t max_cached_primitives) {
+    max_cached_primitives_ = max_cached_primitives;
+  }
+
+  MKLDNNPrimitiveCacheStats GetPrimitiveCacheStats() const {
+    MKLDNNPrimitiveCacheStats stats;
+    stats.hits = primitive_cache_hits_;
+    stats.misses = primitive_cache_misses_;
+    stats.evictions = primitive_cache_evictions_;
+    return stats;
+  }
+
+  void RecordPrimitiveCacheLookup(bool hit) {
+    if (hit)
+      primitive_cache_hits_++;
+    else
+      primitive_cache_misses_++;
+  }
+
+  void RecordPrimitiveCacheEviction() {
+    primitive_cache_evictions_++;
+  }
+
   std::vector<std::unique_ptr<ComputeCapability>>
   GetCapability(const onnxruntime::GraphViewer& graph,
                 const std::vector<const KernelRegistry*>& /*kernel_registries*/) const override;
@@ -73,6 +115,11 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
   std::vector<IAllocatorUniquePtr<void>> reordered_buffers_;
   OrtMutex mutex_;
 
+  size_t max_cached_primitives_ = 16;
+  std::atomic<size_t> primitive_cache_hits_{0};
+  std::atomic<size_t> primitive_cache_misses_{0};
+  std::atomic<size_t> primitive_cache_evictions_{0};
+
   // SUBGRAPH
  private:
   static int GetOnnxOpSet(const GraphViewer& graph_viewer) {
@@ -103,8 +150,16 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
   // Some dimensions are not supported by MKL-DNN
   // example: Pool with NumDimensions <= 3 is not supported
   // Fall back to CPU implementation
-  bool IsDimensionSupported(const Node* node) const {
+  bool IsDimensionSupported(const onnxruntime::GraphViewer& graph_viewer, const Node* node) const {
     bool supported = true;
+    if (node->OpType() == "QLinearConv") {
+      return IsQLinearConvSupported(graph_viewer, node);
+    }
+    // the other kernels are float only
+    if (!node->InputDefs().empty() && node->InputDefs()[0]->Type() != nullptr &&
+        *node->InputDefs()[0]->Type() != "tensor(float)") {
+      supported = false;
+    }
     if (node->OpType() == "BatchNormalization") {
       auto node_inputs = node->InputDefs();
       if (node_inputs[0]->Shape() != nullptr && node_inputs[0]->Shape()->dim_size() == 3) {
@@ -123,9 +178,66 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
       if (node->OutputDefs().size() > 1)
         supported = false;
     }
+    if (node->OpType() == "Gemm" || node->OpType() == "MatMul") {
+      // inner product of 2-D A with a constant B, reordered once, and an optional 1-D bias
+      auto node_inputs = node->InputDefs();
+      if (!HasRank(node_inputs[0], 2) || !HasRank(node_inputs[1], 2) ||
+          graph_viewer.GetAllInitializedTensors().count(node_inputs[1]->Name()) == 0) {
+        supported = false;
+      }
+      if (node->OpType() == "Gemm") {
+        const auto& attributes = node->GetAttributes();
+        auto attr = attributes.find("transA");
+        if (attr != attributes.end() && attr->second.i() != 0)
+          supported = false;
+        attr = attributes.find("alpha");
+        if (attr != attributes.end() && attr->second.f() != 1.0f)
+          supported = false;
+        if (node_inputs.size() > 2) {
+          attr = attributes.find("beta");
+          if ((attr != attributes.end() && attr->second.f() != 1.0f) || !HasRank(node_inputs[2], 1))
+            supported = false;
+        }
+      }
+    }
+    if (node->OpType() == "Add") {
+      // no broadcasting, both inputs must have the same known shape
+      auto node_inputs = node->InputDefs();
+      const auto* a_shape = node_inputs[0]->Shape();
+      const auto* b_shape = node_inputs[1]->Shape();
+      if (a_shape == nullptr || b_shape == nullptr ||
+          a_shape->dim_size() == 0 || a_shape->dim_size() > 5 ||
+          a_shape->dim_size() != b_shape->dim_size()) {
+        supported = false;
+      } else {
+        for (int i = 0; i < a_shape->dim_size(); i++) {
+          const auto& a_dim = a_shape->dim(i);
+          const auto& b_dim = b_shape->dim(i);
+          bool same_dim = (a_dim.has_dim_value() && b_dim.has_dim_value() && a_dim.dim_value() == b_dim.dim_value()) ||
+                          (a_dim.has_dim_param() && b_dim.has_dim_param() && a_dim.dim_param() == b_dim.dim_param());
+          if (!same_dim)
+            supported = false;
+        }
+      }
+    }
+    if (node->OpType() == "Concat") {
+      // the plain formats of 2-D and 4-D are nc and nchw
+      for (const auto* input : node->InputDefs()) {
+        if (!HasRank(input, 2) && !HasRank(input, 4))
+          supported = false;
+      }
+    }
     return supported;
   }
 
+  // QLinearConv of a 4-D u8 input with constant quantization parameters, weights and bias,
+  // whose weights less their zero point fit in s8, and whose input zero point can be folded into the bias
+  bool IsQLinearConvSupported(const onnxruntime::GraphViewer& graph_viewer, const Node* node) const;
+
+  static bool HasRank(const NodeArg* node_arg, int rank) {
+    return node_arg->Shape() != nullptr && node_arg->Shape()->dim_size() == rank;
+  }
+
   void CreateOrUpdateMklDnnNode(const Node* node,
                                 std::shared_ptr<mkl_dnn::Subgraph>& subgraph_ptr,
                                 mkl_dnn::Subgraph::SubgraphVariables& sub_var,
@@ -151,7 +263,9 @@ class MKLDNNExecutionProvider : public IExecutionProvider {
 
   // supported MklDnn Operators
   std::set<std::string> mkldnn_ops_ = {"Conv", "BatchNormalization", "Relu", "Sum",
-                                       "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN"};
+                                       "AveragePool", "GlobalMaxPool", "GlobalAveragePool", "MaxPool", "LRN",
+                                       "Gemm", "MatMul", "Concat", "Add", "QLinearConv",
+                                       "LeakyRelu", "Elu", "Tanh", "Sigmoid", "Abs", "Sqrt"};
 
   mutable std::unordered_map<std::string, std::shared_ptr<mkl_dnn::Subgraph>> mkl_subgraphs_;
 };
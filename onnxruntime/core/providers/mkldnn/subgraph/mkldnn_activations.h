@@ -13,14 +13,13 @@ namespace onnxruntime {
 namespace mkl_dnn {
 
 template <typename T>
-class MklDnnRelu : public MklDnnKernel {
+class MklDnnActivation : public MklDnnKernel {
  public:
-  MklDnnRelu(const MklDnnNode& node,
-             MKLDNNExecutionProvider* provider,
-             const NodeAttributes& attributes,
-             const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
-    ORT_UNUSED_PARAMETER(attributes);
-    ORT_UNUSED_PARAMETER(attributes_prefix);
+  MklDnnActivation(const MklDnnNode& node,
+                   MKLDNNExecutionProvider* provider,
+                   const NodeAttributes& attributes,
+                   const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
   }
 
   Status CreatePrimitives(const OrtCustomOpApi* api,
@@ -68,38 +67,37 @@ class MklDnnRelu : public MklDnnKernel {
     primitive_dst_shape_ = TensorShape(x_shape);
 
     mkldnn::memory::dims dst_dims_mkl(primitive_dst_shape_.GetDims().begin(), primitive_dst_shape_.GetDims().end());
-    mkldnn::algorithm algo = mkldnn::algorithm::eltwise_relu;
     fwd_desc_.reset(new mkldnn::eltwise_forward::desc(
-        mkldnn::prop_kind::forward_inference, algo, *src_md_, 0));
+        mkldnn::prop_kind::forward_inference, algo_, *src_md_, alpha_));
 
-    relu_fwd_pd_.reset(new mkldnn::eltwise_forward::primitive_desc(
+    eltwise_fwd_pd_.reset(new mkldnn::eltwise_forward::primitive_desc(
         *fwd_desc_, cpu_engine));
 
     primitive_src_format_ = static_cast<mkldnn::memory::format>(
-        relu_fwd_pd_.get()->src_primitive_desc().desc().data.format);
+        eltwise_fwd_pd_.get()->src_primitive_desc().desc().data.format);
     primitive_dst_format_ = static_cast<mkldnn::memory::format>(
-        relu_fwd_pd_.get()->dst_primitive_desc().desc().data.format);
+        eltwise_fwd_pd_.get()->dst_primitive_desc().desc().data.format);
 
     if (mklnode_ptr_->output_index >= 0) {
       // last node of sub-graph. need to allocate memory for output_tensor
       if (primitive_dst_format_ != ort_source_format_) {
         // reorder neded. Use primitive output as input to reorder and
         // allocate buffer for reorder output, final output of this subgraph
-        primitive_dst_mem_.reset(new mkldnn::memory(relu_fwd_pd_.get()->dst_primitive_desc()));
+        primitive_dst_mem_.reset(new mkldnn::memory(eltwise_fwd_pd_.get()->dst_primitive_desc()));
       } else {
         // Last node but re-order not needed. Allocate buffer to output of this node
-        primitive_dst_mem_.reset(new mkldnn::memory(relu_fwd_pd_.get()->dst_primitive_desc(), nullptr));
+        primitive_dst_mem_.reset(new mkldnn::memory(eltwise_fwd_pd_.get()->dst_primitive_desc(), nullptr));
       }
     } else {
       // Intermediate node. Use mkldnn kernel internal memory for output and
       // use this as input to next node.
-      primitive_dst_mem_.reset(new mkldnn::memory(relu_fwd_pd_.get()->dst_primitive_desc()));
+      primitive_dst_mem_.reset(new mkldnn::memory(eltwise_fwd_pd_.get()->dst_primitive_desc()));
     }
 
-    relu_fwd_.reset(
-        new mkldnn::eltwise_forward(*relu_fwd_pd_, *src_mem_, *primitive_dst_mem_));
+    eltwise_fwd_.reset(
+        new mkldnn::eltwise_forward(*eltwise_fwd_pd_, *src_mem_, *primitive_dst_mem_));
 
-    net.push_back(*relu_fwd_);
+    net.push_back(*eltwise_fwd_);
 
     if (mklnode_ptr_->output_index >= 0) {
       // one of the end nodes. Allocate output buffer memory and
@@ -140,11 +138,42 @@ class MklDnnRelu : public MklDnnKernel {
   }
 
  private:
+  // the eltwise algorithm of the node's op, and its alpha (relu negative slope, elu scale)
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    const std::string& op_type = mklnode_ptr_->name;
+    if (op_type == "LeakyRelu") {
+      algo_ = mkldnn::algorithm::eltwise_relu;
+      alpha_ = 0.01f;
+    } else if (op_type == "Elu") {
+      algo_ = mkldnn::algorithm::eltwise_elu;
+      alpha_ = 1.0f;
+    } else if (op_type == "Tanh") {
+      algo_ = mkldnn::algorithm::eltwise_tanh;
+    } else if (op_type == "Sigmoid") {
+      algo_ = mkldnn::algorithm::eltwise_logistic;
+    } else if (op_type == "Abs") {
+      algo_ = mkldnn::algorithm::eltwise_abs;
+    } else if (op_type == "Sqrt") {
+      algo_ = mkldnn::algorithm::eltwise_sqrt;
+    }
+
+    auto attr = attributes.find(attributes_prefix + "alpha");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetFloatAttr(proto, alpha_);
+    }
+  }
+
+ private:
+  mkldnn::algorithm algo_ = mkldnn::algorithm::eltwise_relu;
+  float alpha_ = 0.0f;
+
   std::shared_ptr<mkldnn::memory> src_mem_;
 
   std::unique_ptr<mkldnn::eltwise_forward::desc> fwd_desc_;
-  std::unique_ptr<mkldnn::eltwise_forward::primitive_desc> relu_fwd_pd_;
-  std::unique_ptr<mkldnn::primitive> relu_fwd_;
+  std::unique_ptr<mkldnn::eltwise_forward::primitive_desc> eltwise_fwd_pd_;
+  std::unique_ptr<mkldnn::primitive> eltwise_fwd_;
 
   std::unique_ptr<mkldnn::memory::desc> src_md_;
 };
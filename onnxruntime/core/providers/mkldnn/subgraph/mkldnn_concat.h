@@ -0,0 +1,170 @@
+// Copyright(C) 2019 Intel Corporation
+// Licensed under the MIT License
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/providers/common.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_kernel.h"
+#include "core/util/math.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+template <typename T>
+class MklDnnConcat : public MklDnnKernel {
+ public:
+  explicit MklDnnConcat(const MklDnnNode& node,
+                        MKLDNNExecutionProvider* provider,
+                        const NodeAttributes& attributes,
+                        const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  Status CreatePrimitives(const OrtCustomOpApi* api,
+                          OrtKernelContext* context,
+                          mkldnn::engine& cpu_engine,
+                          std::vector<mkldnn::primitive>& net,
+                          mkldnn::memory::format& source_format) override {
+    Ort::CustomOpApi ort{*api};
+    int num_inputs = mklnode_ptr_->num_inputs;
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    std::vector<int64_t> y_dims;
+    int64_t axis = 0;
+    for (int i = 0; i < num_inputs; i++) {
+      TensorShape x_shape;
+      if (mklnode_ptr_->parent_nodes.empty()) {
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + i);
+        auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        auto tensor_shape = ort.GetTensorShape(tensor_info);
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        auto xshape = tensor_shape.data();
+        auto xdim = tensor_shape.size();
+
+        ort_source_format_ = GetSourceFormat(static_cast<int>(xdim));
+        source_format = ort_source_format_;
+        src_format_ = ort_source_format_;
+        x_shape = TensorShape(xshape, xdim);
+
+        mkldnn::memory::dims src_dims_mkl(x_shape.GetDims().begin(), x_shape.GetDims().end());
+        auto mpd = mkldnn::memory::primitive_desc(
+            mkldnn::memory::desc({src_dims_mkl}, MklDnnType<T>(), src_format_), cpu_engine);
+        srcs_pd_.push_back(mpd);
+        srcs_memory_.push_back(mkldnn::memory(mpd, nullptr));
+      } else {
+        // keep the blocked format of the parents, concat reads it as is
+        x_shape = parents_[i].get()->primitive_dst_shape_;
+        auto mpd = mkldnn::memory::primitive_desc(
+            parents_[i].get()->primitive_dst_mem_.get()->get_primitive_desc().desc(), cpu_engine);
+        srcs_pd_.push_back(mpd);
+        srcs_memory_.push_back(*parents_[i].get()->primitive_dst_mem_);
+        ort_source_format_ = source_format;
+        src_format_ = parents_[0].get()->primitive_dst_format_;
+      }
+
+      if (i == 0) {
+        axis = HandleNegativeAxis(axis_, static_cast<int64_t>(x_shape.NumDimensions()));
+        y_dims = x_shape.GetDims();
+      } else {
+        if (x_shape.NumDimensions() != y_dims.size()) {
+          primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Concat inputs must have the same rank.",
+                                               " input ", i, ": ", x_shape.ToString().c_str());
+          return primitive_created_;
+        }
+        y_dims[axis] += x_shape[axis];
+      }
+    }
+    primitive_dst_shape_ = TensorShape(y_dims);
+
+    // the dst format is derived from the srcs, blocked ones stay blocked
+    concat_pd_.reset(new mkldnn::concat::primitive_desc(static_cast<int>(axis), srcs_pd_));
+    primitive_dst_format_ = static_cast<mkldnn::memory::format>(concat_pd_->dst_primitive_desc().desc().data.format);
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // last node of sub-graph. need to allocate memory for output_tensor
+      if (primitive_dst_format_ != ort_source_format_) {
+        // reorder neded. Use primitive output as input to reorder and
+        // allocate buffer for reorder output, final output of this subgraph
+        primitive_dst_mem_.reset(new mkldnn::memory(concat_pd_->dst_primitive_desc()));
+      } else {
+        // Last node but re-order not needed. Allocate buffer to output of this node
+        primitive_dst_mem_.reset(new mkldnn::memory(concat_pd_->dst_primitive_desc(), nullptr));
+      }
+    } else {
+      // Intermediate node. Use mkldnn kernel internal memory for output and
+      // use this as input to next node.
+      primitive_dst_mem_.reset(new mkldnn::memory(concat_pd_->dst_primitive_desc()));
+    }
+
+    std::vector<mkldnn::primitive::at> inputs;
+    for (int i = 0; i < num_inputs; i++) {
+      inputs.push_back(srcs_memory_[i]);
+    }
+    auto c = mkldnn::concat(*concat_pd_, inputs, *primitive_dst_mem_);
+    net.push_back(c);
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // one of the end nodes. Allocate output buffer memory and
+      // reorder is necessary
+      mkldnn::memory::data_type t = MklDnnType<T>();
+      InitDstReorderOutput(cpu_engine, t, net);
+    }
+    primitive_created_ = Status::OK();
+    return primitive_created_;
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    if (!primitive_created_.IsOK()) {
+      return primitive_created_;
+    }
+
+    int num_inputs = mklnode_ptr_->num_inputs;
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      for (int i = 0; i < num_inputs; i++) {
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + i);
+        const T* src_data = const_cast<T*>(ort.GetTensorData<T>(input_tensor));
+        srcs_memory_[i].set_data_handle(static_cast<void*>(const_cast<T*>(src_data)));
+      }
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      const auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0], static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      T* dst_data = ort.GetTensorMutableData<T>(output);
+
+      if (primitive_dst_format_ != ort_source_format_) {
+        reorder_dst_mem_to_->set_data_handle(dst_data);
+      } else {
+        primitive_dst_mem_->set_data_handle(dst_data);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    axis_ = 0;
+    auto attr = attributes.find(attributes_prefix + "axis");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      Status status = GetIntAttr(proto, axis_);
+    }
+  }
+
+ private:
+  int64_t axis_;
+
+  std::vector<mkldnn::memory> srcs_memory_;
+  std::vector<mkldnn::memory::primitive_desc> srcs_pd_;
+  std::unique_ptr<mkldnn::concat::primitive_desc> concat_pd_;
+};
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
@@ -14,7 +14,13 @@
 #include "core/providers/mkldnn/subgraph/mkldnn_pool.h"
 #include "core/providers/mkldnn/subgraph/mkldnn_sum.h"
 #include "core/providers/mkldnn/subgraph/mkldnn_lrn.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_gemm.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_concat.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_qlinearconv.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/common/logging/logging.h"
+#include <algorithm>
+#include <list>
 
 namespace onnxruntime {
 namespace mkl_dnn {
@@ -35,13 +41,6 @@ class SubgraphPrimitive : public PrimitiveBase {
     }
   }
 
-  void UpdateProvider(const SubgraphParams& params) {
-    if (context_.kernels.size() > 0 && context_.kernels[0]->GetProvider() != params.provider)
-      for (auto& kernel : context_.kernels) {
-        kernel->SetProvider(params.provider);
-      }
-  }
-
   Status Compute(const OrtCustomOpApi* api, OrtKernelContext* context) {
     Status status;
 
@@ -79,11 +78,13 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
-      } else if (mkldnn_node.name == "Relu") {
+      } else if (mkldnn_node.name == "Relu" || mkldnn_node.name == "LeakyRelu" || mkldnn_node.name == "Elu" ||
+                 mkldnn_node.name == "Tanh" || mkldnn_node.name == "Sigmoid" || mkldnn_node.name == "Abs" ||
+                 mkldnn_node.name == "Sqrt") {
         std::ostringstream os;
-        os << "Relu-" << mkldnn_node.node_index << "-";
-        std::shared_ptr<MklDnnRelu<T>> kernel;
-        kernel.reset(new MklDnnRelu<T>(mkldnn_node, params.provider, params.attributes, os.str()));
+        os << mkldnn_node.name << "-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnActivation<T>> kernel;
+        kernel.reset(new MklDnnActivation<T>(mkldnn_node, params.provider, params.attributes, os.str()));
         for (auto index : mkldnn_node.parent_nodes) {
           kernel->parents_.push_back(context_.kernels[index]);
         }
@@ -143,9 +144,10 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
-      } else if (mkldnn_node.name == "Sum") {
+      } else if (mkldnn_node.name == "Sum" || mkldnn_node.name == "Add") {
+        // Add of same shape inputs is a Sum of 2
         std::ostringstream os;
-        os << "Sum-" << mkldnn_node.node_index << "-";
+        os << mkldnn_node.name << "-" << mkldnn_node.node_index << "-";
         std::shared_ptr<MklDnnSum<T>> kernel;
         kernel.reset(new MklDnnSum<T>(mkldnn_node, params.provider, params.attributes, os.str()));
         for (auto index : mkldnn_node.parent_nodes) {
@@ -161,6 +163,43 @@ class SubgraphPrimitive : public PrimitiveBase {
           kernel->parents_.push_back(context_.kernels[index]);
         }
         context_.kernels.push_back(kernel);
+      } else if (mkldnn_node.name == "Gemm" || mkldnn_node.name == "MatMul") {
+        std::ostringstream os;
+        os << mkldnn_node.name << "-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnGemm<T>> kernel;
+        kernel.reset(new MklDnnGemm<T>(mkldnn_node, params.provider, params.attributes, os.str()));
+        for (auto index : mkldnn_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
+      } else if (mkldnn_node.name == "Gemm-Relu" || mkldnn_node.name == "MatMul-Relu") {
+        std::ostringstream os;
+        os << mkldnn_node.name.substr(0, mkldnn_node.name.find('-')) << "-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnGemm<T>> kernel;
+        kernel.reset(new MklDnnGemm<T>(mkldnn_node, params.provider, params.attributes, os.str()));
+        kernel->fuse_relu_ = true;
+        for (auto index : mkldnn_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
+      } else if (mkldnn_node.name == "Concat") {
+        std::ostringstream os;
+        os << "Concat-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnConcat<T>> kernel;
+        kernel.reset(new MklDnnConcat<T>(mkldnn_node, params.provider, params.attributes, os.str()));
+        for (auto index : mkldnn_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
+      } else if (mkldnn_node.name == "QLinearConv") {
+        std::ostringstream os;
+        os << "QLinearConv-" << mkldnn_node.node_index << "-";
+        std::shared_ptr<MklDnnQLinearConv> kernel;
+        kernel.reset(new MklDnnQLinearConv(mkldnn_node, params.provider, params.attributes, os.str()));
+        for (auto index : mkldnn_node.parent_nodes) {
+          kernel->parents_.push_back(context_.kernels[index]);
+        }
+        context_.kernels.push_back(kernel);
       }
     }
   }
@@ -192,58 +231,112 @@ class SubgraphPrimitive : public PrimitiveBase {
   mkldnn::engine& cpu_engine_;
 };
 
-// Pool which allows for reuse of MKLDNN Conv primitives which are expensive to instantiate.
-// To address thread safety, the primitives are stored in a map on thread local storage.
+// Key of the primitives built for the dims of the subgraph inputs.
+static std::string GetInputDimsKey(const OrtCustomOpApi* api, OrtKernelContext* context) {
+  Ort::CustomOpApi ort{*api};
+  std::string dims_str;
+  size_t input_count = ort.KernelContext_GetInputCount(context);
+  for (size_t i = 0; i < input_count; i++) {
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
+    auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+    auto tensor_shape = ort.GetTensorShape(tensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+
+    mkldnn::memory::dims src_dims(tensor_shape.begin(), tensor_shape.end());
+    AddDimsToKey(dims_str, src_dims);
+  }
+  return dims_str;
+}
+}  // namespace
+
+// Bounded LRU cache of the primitives of a subgraph, keyed by the dims of its inputs.
+// A Run takes a primitive of its dims that no other Run is using, or builds one, and gives it back once computed,
+// so concurrent Runs share the cache but never a primitive.
 template <typename T>
-class SubgraphPrimitivePool : public PrimitivePool<T> {
+class SubgraphPrimitiveCache {
  public:
-  static SubgraphPrimitive<T>* Get(const OrtCustomOpApi* api,
-                                   OrtKernelContext* context,
-                                   const SubgraphParams& params) {
-    Ort::CustomOpApi ort{*api};
-    std::string dims_str;
-    for (auto i = 0; i < params.subgraph->mkldnn_nodes[0].num_inputs; i++) {
-      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
-      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-      auto tensor_shape = ort.GetTensorShape(tensor_info);
-      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
-      auto shape = tensor_shape.data();
-      auto dim = tensor_shape.size();
+  struct Entry {
+    std::string dims_key;
+    // the built primitives that no Run is using
+    std::vector<std::unique_ptr<SubgraphPrimitive<T>>> free_primitives;
+  };
 
-      TensorShape x_shape(shape, dim);
-      mkldnn::memory::dims src_dims(x_shape.GetDims().begin(), x_shape.GetDims().end());
-      AddDimsToKey(dims_str, src_dims);
-    }
+  explicit SubgraphPrimitiveCache(MKLDNNExecutionProvider* provider) : provider_(provider) {}
 
-    SubgraphPrimitive<T>* primitive = dynamic_cast<SubgraphPrimitive<T>*>(
-        SubgraphPrimitivePool<T>::GetInstance().GetPrimitive(params.subgraph_key + dims_str));
+  // Get the entry of the dims, which the Run holds on to even if it's evicted meanwhile,
+  // and take one of its free primitives, or nullptr if the primitives for the dims need to be built.
+  std::unique_ptr<SubgraphPrimitive<T>> Acquire(const std::string& dims_key, std::shared_ptr<Entry>& entry) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&dims_key](const std::shared_ptr<Entry>& e) { return e->dims_key == dims_key; });
+    if (it != entries_.end()) {
+      // move to the front as the most recently used
+      entries_.splice(entries_.begin(), entries_, it);
+      entry = entries_.front();
+    } else {
+      entry = std::make_shared<Entry>();
+      entry->dims_key = dims_key;
+      entries_.push_front(entry);
+      while (entries_.size() > provider_->GetMaxCachedPrimitives()) {
+        entries_.pop_back();
+        provider_->RecordPrimitiveCacheEviction();
+      }
+    }
 
-    if (primitive == nullptr) {
-      auto subgraph_primitive = std::make_unique<SubgraphPrimitive<T>>(api, context, params);
-      primitive = subgraph_primitive.get();
-      SubgraphPrimitivePool<T>::GetInstance().SetPrimitive(params.subgraph_key + dims_str, std::move(subgraph_primitive));
+    std::unique_ptr<SubgraphPrimitive<T>> primitive;
+    if (!entry->free_primitives.empty()) {
+      primitive = std::move(entry->free_primitives.back());
+      entry->free_primitives.pop_back();
     }
+    provider_->RecordPrimitiveCacheLookup(primitive != nullptr);
     return primitive;
   }
 
+  void Release(Entry& entry, std::unique_ptr<SubgraphPrimitive<T>> primitive) {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    entry.free_primitives.push_back(std::move(primitive));
+  }
+
  private:
-  SubgraphPrimitivePool() = default;
-  ~SubgraphPrimitivePool() = default;
+  MKLDNNExecutionProvider* provider_;
+  OrtMutex mutex_;
+  // the most recently used first
+  std::list<std::shared_ptr<Entry>> entries_;
+};
+
+template <typename T>
+MkldnnFuncKernel<T>::MkldnnFuncKernel(const ComputeContext* context,
+                                      const NodeAttributes& attributes,
+                                      MKLDNNExecutionProvider* provider) {
+  ORT_UNUSED_PARAMETER(context);
 
-  static SubgraphPrimitivePool& GetInstance() {
-    static SubgraphPrimitivePool pool;
-    return pool;
+  params_.provider = provider;
+  params_.attributes = attributes;
+
+  auto sub_it = attributes.find("subgraph_id");
+  if (sub_it->second.type() == ONNX_NAMESPACE::AttributeProto_AttributeType::AttributeProto_AttributeType_STRING) {
+    params_.subgraph_id = sub_it->second.s();
+    params_.subgraph = provider->GetMklDnnSubgraph(params_.subgraph_id);
   }
-};
-}  // namespace
+  primitive_cache_ = std::make_unique<SubgraphPrimitiveCache<T>>(provider);
+}
+
+template <typename T>
+MkldnnFuncKernel<T>::~MkldnnFuncKernel() = default;
 
 template <typename T>
 Status MkldnnFuncKernel<T>::Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const {
   Status status;
   try {
-    SubgraphPrimitive<T>* primitive = SubgraphPrimitivePool<T>::Get(api, context, params_);
-    primitive->UpdateProvider(params_);
+    std::shared_ptr<typename SubgraphPrimitiveCache<T>::Entry> entry;
+    std::unique_ptr<SubgraphPrimitive<T>> primitive = primitive_cache_->Acquire(GetInputDimsKey(api, context), entry);
+    if (primitive == nullptr) {
+      LOGS_DEFAULT(VERBOSE) << "Building MKL-DNN primitives of subgraph " << params_.subgraph_id
+                            << " for input dims " << entry->dims_key;
+      primitive = std::make_unique<SubgraphPrimitive<T>>(api, context, params_);
+    }
     status = primitive->Compute(api, context);
+    primitive_cache_->Release(*entry, std::move(primitive));
   } catch (const mkldnn::error& e) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Status: ", e.status,
                            ", message: ", e.message.c_str());
@@ -0,0 +1,292 @@
+// Copyright(C) 2019 Intel Corporation
+// Licensed under the MIT License
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/mkldnn_execution_provider.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_kernel.h"
+#include "core/util/math.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+// Gemm (transA = 0, alpha = 1, beta = 1, 1-D C) and 2-D MatMul as an MKL-DNN inner product,
+// whose constant B is reordered once to the weights format of the primitive.
+template <typename T>
+class MklDnnGemm : public MklDnnKernel {
+ public:
+  MklDnnGemm(const MklDnnNode& node,
+             MKLDNNExecutionProvider* provider,
+             const NodeAttributes& attributes,
+             const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  Status CreatePrimitives(const OrtCustomOpApi* api,
+                          OrtKernelContext* context,
+                          mkldnn::engine& cpu_engine,
+                          std::vector<mkldnn::primitive>& net,
+                          mkldnn::memory::format& source_format) override {
+    Ort::CustomOpApi ort{*api};
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+    const OrtValue* winput_tensor = ort.KernelContext_GetInput(context, input_index + 1);
+    auto wtensor_info = ort.GetTensorTypeAndShape(winput_tensor);
+    auto wtensor_shape = ort.GetTensorShape(wtensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(wtensor_info);
+    TensorShape w_shape(wtensor_shape.data(), wtensor_shape.size());
+
+    TensorShape x_shape;
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+      auto tensor_shape = ort.GetTensorShape(tensor_info);
+      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+      auto xshape = tensor_shape.data();
+      auto xdim = tensor_shape.size();
+
+      ort_source_format_ = GetSourceFormat(static_cast<int>(xdim));
+      source_format = ort_source_format_;
+      src_format_ = ort_source_format_;
+      x_shape = TensorShape(xshape, xdim);
+
+      mkldnn::memory::dims src_dims_mkl(x_shape.GetDims().begin(), x_shape.GetDims().end());
+      src_md_.reset(new mkldnn::memory::desc(
+          {src_dims_mkl}, MklDnnType<T>(), src_format_));
+      src_mem_.reset(
+          new mkldnn::memory({*src_md_, cpu_engine}, nullptr));
+    } else {
+      src_md_.reset(
+          new mkldnn::memory::desc(parents_[0].get()->primitive_dst_mem_.get()->get_primitive_desc().desc()));
+      src_mem_ = parents_[0].get()->primitive_dst_mem_;
+      x_shape = parents_[0].get()->primitive_dst_shape_;
+      ort_source_format_ = source_format;
+      src_format_ = parents_[0].get()->primitive_dst_format_;
+    }
+
+    if (x_shape.NumDimensions() != 2 || w_shape.NumDimensions() != 2) {
+      primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "A and B must be 2-D.",
+                                           " A: ", x_shape.ToString().c_str(),
+                                           " B: ", w_shape.ToString().c_str());
+      return primitive_created_;
+    }
+
+    const int64_t M = x_shape[0];
+    const int64_t K = x_shape[1];
+    const int64_t N = trans_b_ ? w_shape[0] : w_shape[1];
+    if ((trans_b_ ? w_shape[1] : w_shape[0]) != K) {
+      primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "A and B dimensions mismatch.",
+                                           " A: ", x_shape.ToString().c_str(),
+                                           " B: ", w_shape.ToString().c_str());
+      return primitive_created_;
+    }
+
+    mkldnn::memory::dims bias_dims_mkl;
+    if (mklnode_ptr_->num_inputs == 3) {
+      const OrtValue* binput_tensor = ort.KernelContext_GetInput(context, input_index + 2);
+      auto btensor_info = ort.GetTensorTypeAndShape(binput_tensor);
+      auto btensor_shape = ort.GetTensorShape(btensor_info);
+      ort.ReleaseTensorTypeAndShapeInfo(btensor_info);
+      TensorShape b_shape(btensor_shape.data(), btensor_shape.size());
+      if (b_shape.NumDimensions() != 1 || b_shape[0] != N) {
+        primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "C must be 1-D of size N.",
+                                             " C: ", b_shape.ToString().c_str());
+        return primitive_created_;
+      }
+      bias_dims_mkl.assign(b_shape.GetDims().begin(), b_shape.GetDims().end());
+    }
+
+    std::vector<int64_t> y_dims{M, N};
+    primitive_dst_shape_ = TensorShape(y_dims);
+    mkldnn::memory::dims dst_dims_mkl(y_dims.begin(), y_dims.end());
+    primitive_dst_md_.reset(new mkldnn::memory::desc(
+        {dst_dims_mkl}, MklDnnType<T>(), mkldnn::memory::format::any));
+
+    // inner product weights are (N, K), which B is as is with transB and transposed (io) without
+    filter_dims_mkl_.assign({static_cast<int>(N), static_cast<int>(K)});
+    filter_format_ = trans_b_ ? mkldnn::memory::format::oi : mkldnn::memory::format::io;
+    filter_md_.reset(new mkldnn::memory::desc(
+        {filter_dims_mkl_}, MklDnnType<T>(), mkldnn::memory::format::any));
+
+    if (!bias_dims_mkl.empty()) {
+      bias_md_.reset(new mkldnn::memory::desc(
+          {bias_dims_mkl}, MklDnnType<T>(), mkldnn::memory::format::x));
+      fwd_desc_.reset(new mkldnn::inner_product_forward::desc(
+          mkldnn::prop_kind::forward_inference, *src_md_, *filter_md_, *bias_md_, *primitive_dst_md_));
+    } else {
+      fwd_desc_.reset(new mkldnn::inner_product_forward::desc(
+          mkldnn::prop_kind::forward_inference, *src_md_, *filter_md_, *primitive_dst_md_));
+    }
+
+    if (fuse_relu_) {
+      mkldnn::primitive_attr attr;
+      // Execute RELU as Fuse PostOps
+      const float ops_scale = 1.f;
+      const float ops_alpha = 0.f;  // relu negative slope
+      const float ops_beta = 0.f;
+      mkldnn::post_ops ops;
+      ops.append_eltwise(ops_scale, mkldnn::algorithm::eltwise_relu, ops_alpha, ops_beta);
+      attr.set_post_ops(ops);
+
+      gemm_fwd_pd_.reset(new mkldnn::inner_product_forward::primitive_desc(
+          *fwd_desc_, attr, cpu_engine));
+    } else {
+      gemm_fwd_pd_.reset(new mkldnn::inner_product_forward::primitive_desc(
+          *fwd_desc_, cpu_engine));
+    }
+
+    primitive_src_format_ = static_cast<mkldnn::memory::format>(
+        gemm_fwd_pd_.get()->src_primitive_desc().desc().data.format);
+    primitive_dst_format_ = static_cast<mkldnn::memory::format>(
+        gemm_fwd_pd_.get()->dst_primitive_desc().desc().data.format);
+    filter_size_ = gemm_fwd_pd_.get()->weights_primitive_desc().get_size();
+
+    filter_mem_.reset(
+        new mkldnn::memory(gemm_fwd_pd_.get()->weights_primitive_desc(), nullptr));
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // last node of sub-graph. need to allocate memory for output_tensor
+      if (primitive_dst_format_ != ort_source_format_) {
+        // reorder neded. Use primitive output as input to reorder and
+        // allocate buffer for reorder output, final output of this subgraph
+        primitive_dst_mem_.reset(new mkldnn::memory(gemm_fwd_pd_.get()->dst_primitive_desc()));
+      } else {
+        // Last node but re-order not needed. Allocate buffer to output of this node
+        primitive_dst_mem_.reset(new mkldnn::memory(gemm_fwd_pd_.get()->dst_primitive_desc(), nullptr));
+      }
+    } else {
+      // Intermediate node. Use mkldnn kernel internal memory for output and
+      // use this as input to next node.
+      primitive_dst_mem_.reset(new mkldnn::memory(gemm_fwd_pd_.get()->dst_primitive_desc()));
+    }
+
+    if (!bias_dims_mkl.empty()) {
+      bias_mem_.reset(new mkldnn::memory(gemm_fwd_pd_.get()->bias_primitive_desc(), nullptr));
+      gemm_fwd_.reset(new mkldnn::inner_product_forward(*gemm_fwd_pd_, *src_mem_, *filter_mem_,
+                                                        *bias_mem_, *primitive_dst_mem_));
+    } else {
+      gemm_fwd_.reset(new mkldnn::inner_product_forward(*gemm_fwd_pd_, *src_mem_,
+                                                        *filter_mem_, *primitive_dst_mem_));
+    }
+    net.push_back(*gemm_fwd_);
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // one of the end nodes. Allocate output buffer memory and
+      // reorder is necessary
+      mkldnn::memory::data_type t = MklDnnType<T>();
+      InitDstReorderOutput(cpu_engine, t, net);
+    }
+    primitive_created_ = Status::OK();
+    return primitive_created_;
+  }
+
+  void ReorderWeights(const OrtCustomOpApi* api, OrtKernelContext* context, mkldnn::engine& cpu_engine) override {
+    Ort::CustomOpApi ort{*api};
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index + 1);
+    const T* filter_data = const_cast<T*>(ort.GetTensorData<T>(input_tensor));
+
+    {
+      // lock to make sure reordering is done only once
+      std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+      std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+
+      if (filter_dst_mem == nullptr) {
+        auto pd = mkldnn::memory::primitive_desc(
+            mkldnn::memory::desc(filter_dims_mkl_, MklDnnType<T>(), filter_format_), cpu_engine);
+        mkldnn::memory src = mkldnn::memory(pd, (void*)filter_data);
+        IAllocatorUniquePtr<void> filter_reorder_buffer =
+            IAllocator::MakeUniquePtr<void>(alloc_, filter_size_);
+        filter_dst_mem.reset(
+            new mkldnn::memory(gemm_fwd_pd_->weights_primitive_desc(), filter_reorder_buffer.get()));
+
+        MemoryReorderParams params(src, *filter_dst_mem);
+        DoReorder<T>(params);
+        provider_->SaveAllocatedMemory(std::move(filter_reorder_buffer));
+        provider_->SetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_dst_mem);
+      }
+    }
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+
+    if (!primitive_created_.IsOK()) {
+      return primitive_created_;
+    }
+
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+
+    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    if (filter_dst_mem == nullptr) {
+      ReorderWeights(api, context, GetEngine());
+      filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    }
+    filter_mem_->set_data_handle(filter_dst_mem->get_data_handle());
+
+    if (mklnode_ptr_->num_inputs == 3) {
+      const OrtValue* binput_tensor = ort.KernelContext_GetInput(context, input_index + 2);
+      const T* bias_data = const_cast<T*>(ort.GetTensorData<T>(binput_tensor));
+      bias_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(bias_data)));
+    }
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      // Sub-graph's first node. Read input from input buffer
+      const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index);
+      const T* src_data = const_cast<T*>(ort.GetTensorData<T>(input_tensor));
+      src_mem_->set_data_handle(static_cast<void*>(const_cast<T*>(src_data)));
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0], static_cast<int>(primitive_dst_shape_.GetDims().size()));
+      T* dst_data = ort.GetTensorMutableData<T>(output);
+
+      if (primitive_dst_format_ != ort_source_format_) {
+        reorder_dst_mem_to_->set_data_handle(dst_data);
+      } else {
+        primitive_dst_mem_->set_data_handle(dst_data);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    // MatMul has no transB, its B is (K, N)
+    trans_b_ = false;
+    auto attr = attributes.find(attributes_prefix + "transB");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      int64_t trans_b = 0;
+      if (GetIntAttr(proto, trans_b) == Status::OK())
+        trans_b_ = trans_b != 0;
+    }
+  }
+
+ private:
+  bool trans_b_;
+
+  mkldnn::memory::dims filter_dims_mkl_;
+  mkldnn::memory::format filter_format_;
+  size_t filter_size_;
+
+  std::shared_ptr<mkldnn::memory> src_mem_;
+  std::unique_ptr<mkldnn::memory> filter_mem_;
+  std::unique_ptr<mkldnn::memory> bias_mem_;
+
+  std::unique_ptr<mkldnn::memory::desc> src_md_;
+  std::unique_ptr<mkldnn::memory::desc> filter_md_;
+  std::unique_ptr<mkldnn::memory::desc> bias_md_;
+
+  std::unique_ptr<mkldnn::inner_product_forward::desc> fwd_desc_;
+  std::unique_ptr<mkldnn::inner_product_forward::primitive_desc> gemm_fwd_pd_;
+  std::unique_ptr<mkldnn::primitive> gemm_fwd_;
+};
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
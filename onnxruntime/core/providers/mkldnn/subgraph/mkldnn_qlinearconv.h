@@ -0,0 +1,382 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "core/framework/op_kernel.h"
+#include "core/providers/mkldnn/mkldnn_fwd.h"
+#include "core/providers/mkldnn/mkldnn_common.h"
+#include "core/providers/mkldnn/mkldnn_execution_provider.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_conv.h"
+#include "core/providers/mkldnn/subgraph/mkldnn_kernel.h"
+
+namespace onnxruntime {
+namespace mkl_dnn {
+
+// 2-D QLinearConv as an MKL-DNN int8 convolution of u8 activations and s8 weights, whose requantization to the
+// u8 output is fused in the primitive: the output scales are x_scale * w_scale / y_scale, and a float bias holds
+// the quantized bias, the input zero point times the sums of the weights, and the output zero point.
+// The weights are shifted by their zero point to s8 and reordered once. The input zero point is folded into the
+// bias, which is exact only where the kernel doesn't overlap the padding, so the provider assigns the QLinearConvs
+// whose input zero point is 0 or that have no padding (see MKLDNNExecutionProvider::IsQLinearConvSupported).
+// Consecutive QLinearConvs of a subgraph pass their u8 outputs in the blocked format of MKL-DNN.
+class MklDnnQLinearConv : public MklDnnKernel {
+ public:
+  MklDnnQLinearConv(const MklDnnNode& node,
+                    MKLDNNExecutionProvider* provider,
+                    const NodeAttributes& attributes,
+                    const std::string attributes_prefix = "") : MklDnnKernel(node, provider) {
+    ReadAttributes(attributes, attributes_prefix);
+  }
+
+  Status CreatePrimitives(const OrtCustomOpApi* api,
+                          OrtKernelContext* context,
+                          mkldnn::engine& cpu_engine,
+                          std::vector<mkldnn::primitive>& net,
+                          mkldnn::memory::format& source_format) override {
+    Ort::CustomOpApi ort{*api};
+
+    const OrtValue* winput_tensor = GetInput(ort, context, 3);
+    auto wtensor_info = ort.GetTensorTypeAndShape(winput_tensor);
+    auto wtensor_shape = ort.GetTensorShape(wtensor_info);
+    ort.ReleaseTensorTypeAndShapeInfo(wtensor_info);
+    TensorShape w_shape(wtensor_shape.data(), wtensor_shape.size());
+
+    TensorShape x_shape;
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      const OrtValue* input_tensor = GetInput(ort, context, 0);
+      auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+      auto tensor_shape = ort.GetTensorShape(tensor_info);
+      ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+      x_shape = TensorShape(tensor_shape.data(), tensor_shape.size());
+    } else {
+      // the u8 output of the previous QLinearConv, in its blocked format
+      x_shape = parents_[0].get()->primitive_dst_shape_;
+      ort_source_format_ = source_format;
+      src_format_ = parents_[0].get()->primitive_dst_format_;
+    }
+
+    if (x_shape.NumDimensions() != 4 || w_shape.NumDimensions() != 4) {
+      primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "X and W must be 4-D.",
+                                           " X: ", x_shape.ToString().c_str(),
+                                           " W: ", w_shape.ToString().c_str());
+      return primitive_created_;
+    }
+
+    const int64_t M = w_shape[0];
+    if (x_shape[1] != w_shape[1] * group_ || M % group_ != 0) {
+      primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "X and W are incompatible with group.",
+                                           " X: ", x_shape.ToString().c_str(),
+                                           " W: ", w_shape.ToString().c_str(),
+                                           " group: ", group_);
+      return primitive_created_;
+    }
+
+    std::vector<int64_t> pads(pads_);
+    pads.resize(4, 0);
+    std::vector<int64_t> strides(strides_);
+    strides.resize(2, 1);
+    std::vector<int64_t> dilations(dilations_);
+    dilations.resize(2, 1);
+
+    std::vector<int64_t> y_dims{x_shape[0], M};
+    for (size_t dim = 0; dim < 2; ++dim) {
+      int64_t dim_size = 0;
+      primitive_created_ = ComputePadAndOutputShape<false>(x_shape[dim + 2], strides[dim], w_shape[dim + 2],
+                                                           dilations[dim], auto_pad_, &pads[dim], &pads[dim + 2],
+                                                           &dim_size);
+      if (!primitive_created_.IsOK())
+        return primitive_created_;
+      if (dim_size <= 0) {
+        primitive_created_ = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input shape: ", x_shape);
+        return primitive_created_;
+      }
+      y_dims.push_back(dim_size);
+    }
+    primitive_dst_shape_ = TensorShape(y_dims);
+
+    ComputeRequantization(ort, context, M, w_shape.Size() / M);
+
+    if (src_format_ == mkldnn::memory::format::any) {
+      src_format_ = mkldnn::memory::format::nchw;
+      ort_source_format_ = mkldnn::memory::format::nchw;
+      source_format = mkldnn::memory::format::nchw;
+    }
+    filter_format_ = group_ == 1 ? mkldnn::memory::format::oihw : mkldnn::memory::format::goihw;
+
+    mkldnn::memory::dims src_dims_mkl(x_shape.GetDims().begin(), x_shape.GetDims().end());
+    mkldnn::memory::dims dst_dims_mkl(y_dims.begin(), y_dims.end());
+    mkldnn::memory::dims bias_dims_mkl{static_cast<int>(M)};
+    if (group_ == 1) {
+      filter_dims_mkl_.assign(w_shape.GetDims().begin(), w_shape.GetDims().end());
+    } else {
+      filter_dims_mkl_.assign({static_cast<int>(group_), static_cast<int>(M / group_)});
+      filter_dims_mkl_.insert(filter_dims_mkl_.end(), w_shape.GetDims().begin() + 1, w_shape.GetDims().end());
+    }
+    mkldnn::memory::dims strides_mkl(strides.begin(), strides.end());
+    mkldnn::memory::dims dilations_mkl(dilations.begin(), dilations.end());
+    // mkldnn dilations start from 0 so we need to subtract 1 from each dim.
+    for (auto& dilation : dilations_mkl) {
+      dilation -= 1;
+    }
+    mkldnn::memory::dims padding_left_mkl(pads.begin(), pads.begin() + 2);
+    mkldnn::memory::dims padding_right_mkl(pads.begin() + 2, pads.end());
+
+    // Set the memory descriptors to format::any to allow MKLDNN to decide what the optimal memory layout should be
+    mkldnn::memory::desc src_md({src_dims_mkl}, MklDnnType<uint8_t>(), mkldnn::memory::format::any);
+    mkldnn::memory::desc filter_md({filter_dims_mkl_}, MklDnnType<int8_t>(), mkldnn::memory::format::any);
+    mkldnn::memory::desc bias_md({bias_dims_mkl}, MklDnnType<float>(), mkldnn::memory::format::x);
+    primitive_dst_md_.reset(new mkldnn::memory::desc(
+        {dst_dims_mkl}, MklDnnType<uint8_t>(), mkldnn::memory::format::any));
+
+    mkldnn::convolution_forward::desc fwd_desc(
+        mkldnn::prop_kind::forward_inference, mkldnn::convolution_direct, src_md,
+        filter_md, bias_md, *primitive_dst_md_,
+        strides_mkl, dilations_mkl, padding_left_mkl,
+        padding_right_mkl, mkldnn::padding_kind::zero);
+
+    mkldnn::primitive_attr attr;
+    attr.set_int_output_round_mode(mkldnn::round_mode::round_nearest);
+    // per output channel scales when the weights are quantized per channel
+    attr.set_output_scales(output_scales_.size() > 1 ? 1 << 1 : 0, output_scales_);
+    conv_fwd_pd_.reset(new mkldnn::convolution_forward::primitive_desc(fwd_desc, attr, cpu_engine));
+
+    primitive_src_format_ = static_cast<mkldnn::memory::format>(
+        conv_fwd_pd_.get()->src_primitive_desc().desc().data.format);
+    primitive_dst_format_ = static_cast<mkldnn::memory::format>(
+        conv_fwd_pd_.get()->dst_primitive_desc().desc().data.format);
+    filter_size_ = conv_fwd_pd_.get()->weights_primitive_desc().get_size();
+
+    filter_mem_.reset(new mkldnn::memory(conv_fwd_pd_.get()->weights_primitive_desc(), nullptr));
+    bias_mem_.reset(new mkldnn::memory(conv_fwd_pd_.get()->bias_primitive_desc(), bias_.data()));
+
+    if (primitive_src_format_ != src_format_) {
+      auto src_plain_md = mkldnn::memory::desc(src_dims_mkl, MklDnnType<uint8_t>(), src_format_);
+      auto pd = mkldnn::memory::primitive_desc(src_plain_md, cpu_engine);
+
+      if (mklnode_ptr_->parent_nodes.empty())
+        src_mem_from_.reset(new mkldnn::memory(pd, nullptr));
+      else
+        src_mem_from_ = parents_[0].get()->primitive_dst_mem_;
+
+      src_mem_.reset(new mkldnn::memory(conv_fwd_pd_->src_primitive_desc(), nullptr));
+      net.push_back(mkldnn::reorder(*src_mem_from_, *src_mem_));
+    } else {
+      if (mklnode_ptr_->parent_nodes.empty()) {
+        src_mem_.reset(new mkldnn::memory(conv_fwd_pd_->src_primitive_desc(), nullptr));
+      } else {
+        src_mem_ = parents_[0].get()->primitive_dst_mem_;
+      }
+    }
+
+    if (mklnode_ptr_->output_index >= 0 && primitive_dst_format_ == ort_source_format_) {
+      // the output tensor is bound as the dst of the primitive
+      primitive_dst_mem_.reset(new mkldnn::memory(conv_fwd_pd_.get()->dst_primitive_desc(), nullptr));
+    } else {
+      primitive_dst_mem_.reset(new mkldnn::memory(conv_fwd_pd_.get()->dst_primitive_desc()));
+    }
+
+    conv_fwd_.reset(new mkldnn::convolution_forward(*conv_fwd_pd_, *src_mem_, *filter_mem_,
+                                                    *bias_mem_, *primitive_dst_mem_));
+    net.push_back(*conv_fwd_);
+
+    if (mklnode_ptr_->output_index >= 0) {
+      // one of the end nodes. Allocate output buffer memory and
+      // reorder is necessary
+      mkldnn::memory::data_type t = MklDnnType<uint8_t>();
+      InitDstReorderOutput(cpu_engine, t, net);
+    }
+    primitive_created_ = Status::OK();
+    return primitive_created_;
+  }
+
+  void ReorderWeights(const OrtCustomOpApi* api, OrtKernelContext* context, mkldnn::engine& cpu_engine) override {
+    Ort::CustomOpApi ort{*api};
+    const OrtValue* winput_tensor = GetInput(ort, context, 3);
+    const uint8_t* filter_data = ort.GetTensorData<uint8_t>(winput_tensor);
+    const uint8_t w_zero_point = *ort.GetTensorData<uint8_t>(GetInput(ort, context, 5));
+
+    // lock to make sure reordering is done only once
+    std::lock_guard<OrtMutex> lock(provider_->GetMutex());
+    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    if (filter_dst_mem != nullptr) {
+      return;
+    }
+
+    size_t filter_count = 1;
+    for (auto dim : filter_dims_mkl_) {
+      filter_count *= static_cast<size_t>(dim);
+    }
+    // the provider checked that the shifted weights fit in s8
+    std::vector<int8_t> shifted_filter(filter_count);
+    for (size_t i = 0; i < filter_count; ++i) {
+      shifted_filter[i] = static_cast<int8_t>(static_cast<int>(filter_data[i]) - w_zero_point);
+    }
+
+    auto pd = mkldnn::memory::primitive_desc(
+        mkldnn::memory::desc(filter_dims_mkl_, MklDnnType<int8_t>(), filter_format_), cpu_engine);
+    mkldnn::memory src = mkldnn::memory(pd, shifted_filter.data());
+    IAllocatorUniquePtr<void> filter_reorder_buffer = IAllocator::MakeUniquePtr<void>(alloc_, filter_size_);
+    filter_dst_mem.reset(
+        new mkldnn::memory(conv_fwd_pd_->weights_primitive_desc(), filter_reorder_buffer.get()));
+
+    MemoryReorderParams params(src, *filter_dst_mem);
+    DoReorder<int8_t>(params);
+    provider_->SaveAllocatedMemory(std::move(filter_reorder_buffer));
+    provider_->SetWeightsMemoryBuffer(mklnode_ptr_->weight_name, filter_dst_mem);
+  }
+
+  Status Bind(const OrtCustomOpApi* api, OrtKernelContext* context) override {
+    Ort::CustomOpApi ort{*api};
+    if (!primitive_created_.IsOK()) {
+      return primitive_created_;
+    }
+
+    std::shared_ptr<mkldnn::memory> filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    if (filter_dst_mem == nullptr) {
+      ReorderWeights(api, context, GetEngine());
+      filter_dst_mem = provider_->GetWeightsMemoryBuffer(mklnode_ptr_->weight_name);
+    }
+    filter_mem_->set_data_handle(filter_dst_mem->get_data_handle());
+
+    if (mklnode_ptr_->parent_nodes.empty()) {
+      const OrtValue* input_tensor = GetInput(ort, context, 0);
+      void* src_data = const_cast<uint8_t*>(ort.GetTensorData<uint8_t>(input_tensor));
+      if (primitive_src_format_ != src_format_) {
+        src_mem_from_->set_data_handle(src_data);
+      } else {
+        src_mem_->set_data_handle(src_data);
+      }
+    } else if (primitive_src_format_ != src_format_) {
+      src_mem_from_ = parents_[0].get()->primitive_dst_mem_;
+    } else {
+      src_mem_ = parents_[0].get()->primitive_dst_mem_;
+    }
+
+    if (primitive_src_format_ != src_format_) {
+      src_reorder_buffer_ = IAllocator::MakeUniquePtr<void>(alloc_, conv_fwd_pd_.get()->src_primitive_desc().get_size());
+      src_mem_->set_data_handle(src_reorder_buffer_.get());
+    }
+
+    if (mklnode_ptr_->output_index >= 0) {
+      auto& y_dims = primitive_dst_shape_.GetDims();
+      // Allocate memory for output bufffer
+      OrtValue* output = ort.KernelContext_GetOutput(context, mklnode_ptr_->output_index, &y_dims[0],
+                                                     static_cast<int>(y_dims.size()));
+      uint8_t* dst_data = ort.GetTensorMutableData<uint8_t>(output);
+
+      if (primitive_dst_format_ != ort_source_format_) {
+        reorder_dst_mem_to_->set_data_handle(dst_data);
+      } else {
+        primitive_dst_mem_->set_data_handle(dst_data);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  // The inputs are x, x_scale, x_zero_point, w, w_scale, w_zero_point, y_scale, y_zero_point and the optional B.
+  // The subgraph input of the first one is at the node's input start index, and the others follow it.
+  const OrtValue* GetInput(Ort::CustomOpApi& ort, OrtKernelContext* context, int index) const {
+    int input_index = mklnode_ptr_->input_start_index < 0 ? 0 : mklnode_ptr_->input_start_index;
+    return ort.KernelContext_GetInput(context, input_index + index);
+  }
+
+  // Computes the output scales and the float bias of the requantization, from the constant scales, zero points,
+  // weights and bias.
+  void ComputeRequantization(Ort::CustomOpApi& ort, OrtKernelContext* context, int64_t M, int64_t filter_size) {
+    const float x_scale = *ort.GetTensorData<float>(GetInput(ort, context, 1));
+    const int32_t x_zero_point = *ort.GetTensorData<uint8_t>(GetInput(ort, context, 2));
+    const uint8_t* filter_data = ort.GetTensorData<uint8_t>(GetInput(ort, context, 3));
+    const OrtValue* w_scale_tensor = GetInput(ort, context, 4);
+    const float* w_scale = ort.GetTensorData<float>(w_scale_tensor);
+    const int32_t w_zero_point = *ort.GetTensorData<uint8_t>(GetInput(ort, context, 5));
+    const float y_scale = *ort.GetTensorData<float>(GetInput(ort, context, 6));
+    const float y_zero_point = static_cast<float>(*ort.GetTensorData<uint8_t>(GetInput(ort, context, 7)));
+    const int32_t* bias_data = nullptr;
+    if (mklnode_ptr_->num_inputs == 9) {
+      bias_data = ort.GetTensorData<int32_t>(GetInput(ort, context, 8));
+    }
+
+    auto w_scale_info = ort.GetTensorTypeAndShape(w_scale_tensor);
+    const size_t w_scale_count = ort.GetTensorShapeElementCount(w_scale_info);
+    ort.ReleaseTensorTypeAndShapeInfo(w_scale_info);
+
+    output_scales_.resize(w_scale_count > 1 ? static_cast<size_t>(M) : 1);
+    for (size_t m = 0; m < output_scales_.size(); ++m) {
+      output_scales_[m] = x_scale * w_scale[m] / y_scale;
+    }
+
+    bias_.resize(static_cast<size_t>(M));
+    for (int64_t m = 0; m < M; ++m) {
+      int64_t filter_sum = 0;
+      const uint8_t* filter = filter_data + m * filter_size;
+      for (int64_t i = 0; i < filter_size; ++i) {
+        filter_sum += static_cast<int32_t>(filter[i]) - w_zero_point;
+      }
+      const float scale = output_scales_[output_scales_.size() > 1 ? m : 0];
+      const int64_t quantized_bias = (bias_data ? bias_data[m] : 0) - x_zero_point * filter_sum;
+      bias_[m] = static_cast<float>(quantized_bias) + y_zero_point / scale;
+    }
+  }
+
+  void ReadAttributes(const NodeAttributes& attributes,
+                      const std::string attributes_prefix = "") override {
+    std::string auto_pad;
+    auto attr = attributes.find(attributes_prefix + "auto_pad");
+    if (attr != attributes.end() &&
+        attr->second.type() == ::ONNX_NAMESPACE::AttributeProto_AttributeType::AttributeProto_AttributeType_STRING) {
+      auto_pad = attr->second.s();
+    }
+    auto_pad_ = (auto_pad != "") ? StringToAutoPadType(auto_pad) : AutoPadType::NOTSET;
+
+    attr = attributes.find(attributes_prefix + "strides");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      GetIntsAttr(proto, strides_);
+    }
+
+    attr = attributes.find(attributes_prefix + "pads");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      GetIntsAttr(proto, pads_);
+    }
+
+    attr = attributes.find(attributes_prefix + "dilations");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      GetIntsAttr(proto, dilations_);
+    }
+
+    attr = attributes.find(attributes_prefix + "group");
+    if (attr != attributes.end()) {
+      ONNX_NAMESPACE::AttributeProto proto = attr->second;
+      GetIntAttr(proto, group_);
+    }
+  }
+
+ private:
+  mkldnn::memory::format filter_format_;
+  mkldnn::memory::dims filter_dims_mkl_;
+  size_t filter_size_ = 0;
+
+  std::vector<float> output_scales_;
+  std::vector<float> bias_;
+
+  std::shared_ptr<mkldnn::memory> src_mem_from_;
+  std::shared_ptr<mkldnn::memory> src_mem_;
+  std::unique_ptr<mkldnn::memory> filter_mem_;
+  std::unique_ptr<mkldnn::memory> bias_mem_;
+
+  std::unique_ptr<mkldnn::convolution_forward::primitive_desc> conv_fwd_pd_;
+  std::unique_ptr<mkldnn::primitive> conv_fwd_;
+
+  IAllocatorUniquePtr<void> src_reorder_buffer_;
+
+  AutoPadType auto_pad_ = AutoPadType::NOTSET;
+  int64_t group_ = 1;
+  std::vector<int64_t> strides_;
+  std::vector<int64_t> pads_;
+  std::vector<int64_t> dilations_;
+};
+}  // namespace mkl_dnn
+}  // namespace onnxruntime
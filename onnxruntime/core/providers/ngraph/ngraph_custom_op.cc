@@ -3,7 +3,9 @@
 
 #include <fstream>
 #include <iostream>
+#include <list>
 #include <string>
+#include <unordered_map>
 
 #if defined(_MSC_VER)
 #pragma warning(disable : 4244 4245)
@@ -37,6 +39,90 @@ static bool check_ngraph_dump_ops() {
 #endif
 }
 
+static size_t get_ngraph_lru_cache_size() {
+  // Get cache size from environment
+  std::string tempSize;
+  #ifdef _WIN32
+  char *buf{nullptr};
+  size_t bufSize = 0;
+  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
+    tempSize = buf;
+    free(buf);
+  }
+  #else
+  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
+    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
+  }
+  #endif
+  return tempSize.empty() ? NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE : std::stoi(tempSize);
+}
+
+// The executables compiled by all the sessions of the process, keyed by subgraph and input shapes,
+// so that a session loading a model again, or another one sharing a subgraph, doesn't recompile it.
+// ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE bounds the number of executables, the least recently used is
+// removed from its backend when it's exceeded. A Compute still running it keeps it alive until done.
+class NGRAPHExecutableCache {
+ public:
+  static NGRAPHExecutableCache& Instance() {
+    static NGRAPHExecutableCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<NGRAPHExecutable> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+      return nullptr;
+
+    // update reference
+    lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_it);
+    return it->second.executable;
+  }
+
+  // Returns the executable cached for the key, which is another one than the given if a concurrent Compute added it first.
+  std::shared_ptr<NGRAPHExecutable> Add(const std::string& key,
+                                        const std::shared_ptr<NGRAPHExecutable>& executable,
+                                        const std::shared_ptr<ngraph::runtime::Backend>& ng_backend) {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ng_backend->remove_compiled_function(executable->exe);
+      lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_it);
+      return it->second.executable;
+    }
+
+    // Delete least recently used elements
+    while (!lru_keys_.empty() && lru_keys_.size() >= capacity_) {
+      auto last = entries_.find(lru_keys_.back());
+      last->second.ng_backend->remove_compiled_function(last->second.executable->exe);
+      entries_.erase(last);
+      lru_keys_.pop_back();
+    }
+
+    if (capacity_ == 0)
+      return executable;
+
+    lru_keys_.push_front(key);
+    entries_.emplace(key, Entry{executable, ng_backend, lru_keys_.begin()});
+    return executable;
+  }
+
+ private:
+  NGRAPHExecutableCache() : capacity_{get_ngraph_lru_cache_size()} {}
+
+  struct Entry {
+    std::shared_ptr<NGRAPHExecutable> executable;
+    std::shared_ptr<ngraph::runtime::Backend> ng_backend;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  const size_t capacity_;
+  std::mutex lock_;
+  // most recently used first
+  std::list<std::string> lru_keys_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
 NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
                                const ONNX_NAMESPACE::ModelProto& model_proto,
                                const std::shared_ptr<ngraph::runtime::Backend>& ng_backend) :
@@ -51,25 +137,35 @@ NGRAPHCustomOp::NGRAPHCustomOp(const ComputeContext* context,
     std::fstream dump(name_ + ".onnx", std::ios::out | std::ios::trunc | std::ios::binary);
     model_proto_.SerializeToOstream(&dump);
   }
-}
 
-NGRAPHCustomOp::~NGRAPHCustomOp() {
-  for (const auto& compiled_exe : ng_exe_map_) {
-    ng_backend_->remove_compiled_function(compiled_exe.second);
-  }
+  // The graph is named after the fused node, which is numbered differently by each session.
+  ONNX_NAMESPACE::ModelProto subgraph_proto = model_proto_;
+  subgraph_proto.mutable_graph()->clear_name();
+  const std::string serialized_subgraph = subgraph_proto.SerializeAsString();
+  const size_t subgraph_hash = std::hash<std::string>{}(serialized_subgraph);
+  const size_t subgraph_size = serialized_subgraph.size();
+  subgraph_key_.append(reinterpret_cast<const char*>(&subgraph_hash), sizeof(subgraph_hash));
+  subgraph_key_.append(reinterpret_cast<const char*>(&subgraph_size), sizeof(subgraph_size));
+
+  // An executable runs only on the backend it's compiled on, which the cache keeps alive meanwhile.
+  const auto* backend = ng_backend_.get();
+  subgraph_key_.append(reinterpret_cast<const char*>(&backend), sizeof(backend));
 }
 
+// The cached executables outlive the op, for the next session compiling the same subgraph.
+NGRAPHCustomOp::~NGRAPHCustomOp() = default;
+
 //This method gets called in critical path of execution: Optimize
-void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const {
+std::shared_ptr<NGRAPHExecutable> NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const {
   Ort::CustomOpApi ort{*api};
 
   size_t num_inputs = ort.KernelContext_GetInputCount(context);
 
-  //Key for ng_exe_map
-  std::string uniq_input_shape;
+  //Key for the executable cache: subgraph and input shapes
+  std::string uniq_input_shape = subgraph_key_;
 
   //Optimizing for general case of 4D tensors
-  uniq_input_shape.reserve(4 * sizeof(int64_t) * num_inputs + num_inputs);
+  uniq_input_shape.reserve(subgraph_key_.size() + 4 * sizeof(int64_t) * num_inputs + num_inputs);
 
   for (size_t i = 0; i < num_inputs; i++) {
     const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
@@ -82,51 +178,16 @@ void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* con
     uniq_input_shape.append(reinterpret_cast<const char*>(tensor_shape.data()), ndim * sizeof(int64_t));
   }
 
-  // Get cache size from environment
-  std::string tempSize;
-  #ifdef _WIN32
-  char *buf{nullptr};
-  size_t bufSize = 0;
-  if (!_dupenv_s(&buf, &bufSize, "ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE") && buf) {
-    tempSize = buf;
-    free(buf);
-  }
-  #else
-  if (std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE")) {
-    tempSize = std::getenv("ONNXRUNTIME_NGRAPH_LRU_CACHE_SIZE");
-  }
-  #endif
-  size_t cacheSize = tempSize.empty() ? NGRAPH_EP_LRU_CACHE_DEFAULT_SIZE : std::stoi(tempSize);
-
-  // Not in cache
-  if (ng_exe_map_.find(uniq_input_shape) == ng_exe_map_.end()) {
-    // Check if full
-    if (keyCache.size() == cacheSize) {
-      // Delete least recently used element
-      std::string last = keyCache.back();
-  
-      // Pop the last elmeent
-      keyCache.pop_back();
-  
-      // Erase the last element from cache
-      ng_exe_map_.erase(ng_exe_map_.find(last)); 
-    } 
-  } 
-  
-  // Found in cache 
-  else {
-    keyCache.remove(uniq_input_shape);
+  //ng_exe with current shape already exists
+  auto& cache = NGRAPHExecutableCache::Instance();
+  auto executable = cache.Get(uniq_input_shape);
+  if (executable != nullptr) {
+    return executable;
   }
-  
-  // update reference
-  keyCache.push_front(uniq_input_shape);
-  auto it = ng_exe_map_.insert({uniq_input_shape, nullptr});
 
-  //ng_exe with current shape already exists
-  if (!it.second) {
-    ng_curr_exe_ = it.first->second;
-    return;
-  } else {
+  std::shared_ptr<ngraph::Function> ng_function;
+  {
+    std::lock_guard<std::mutex> lock(compile_lock_);
     auto graph_proto = model_proto_.mutable_graph();
 
     LOGS_DEFAULT(INFO) << "[NGRAPHCustomOp] Compiling customOp: " << name_;
@@ -147,7 +208,6 @@ void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* con
     }
 
     std::istringstream model_stream{model_proto_.SerializeAsString()};
-    std::shared_ptr<ngraph::Function> ng_function;
     try {
       ng_function = ngraph::onnx_import::import_onnx_model(model_stream);
     } catch (const std::exception& exp) {
@@ -159,35 +219,41 @@ void NGRAPHCustomOp::Initialize(const OrtCustomOpApi* api, OrtKernelContext* con
                           << "Unknown exception while importing model to nGraph";
       throw;
     }
+  }
 
-    for (auto& result : ng_function->get_results()) {
-      result->set_needs_default_layout(true);
-    }
+  for (auto& result : ng_function->get_results()) {
+    result->set_needs_default_layout(true);
+  }
 
-    // Finally compile nGraph with backend.
-    try {
-      ng_curr_exe_ = ng_backend_->compile(ng_function);
-    } catch (const std::exception& exp) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
-                          << "Exception while compiling ngraph::Function: " << std::string(exp.what());
-    } catch (...) {
-      LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - " << "Unknown exception while compiling ngraph::Function";
-    }
-    it.first->second = ng_curr_exe_;
+  // Finally compile nGraph with backend.
+  executable = std::make_shared<NGRAPHExecutable>();
+  try {
+    executable->exe = ng_backend_->compile(ng_function);
+  } catch (const std::exception& exp) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - "
+                        << "Exception while compiling ngraph::Function: " << std::string(exp.what());
+  } catch (...) {
+    LOGS_DEFAULT(FATAL) << "[NGRAPHCustomOp] " << " - " << name_ << " - " << "Unknown exception while compiling ngraph::Function";
   }
-}  // namespace ngraph_ep
+
+  if (executable->exe == nullptr) {
+    return nullptr;
+  }
+  return cache.Add(uniq_input_shape, executable, ng_backend_);
+}
 
 //This method gets called in critical path of execution: Optimize
 Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* context) const {
   Ort::CustomOpApi ort{*api};
 
   // Initialize nGraph function if it is not already initialized.
-  {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    Initialize(api, context);
-  }
+  auto executable = Initialize(api, context);
+
+  ORT_ENFORCE(executable != nullptr);
+  const auto& ng_curr_exe = executable->exe;
 
-  ORT_ENFORCE(ng_curr_exe_ != nullptr);
+  // The executable may be shared with the Computes of other sessions.
+  std::lock_guard<std::mutex> lock(executable->call_lock);
 
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_inputs;
   std::vector<std::shared_ptr<ngraph::runtime::Tensor>> ng_outputs;
@@ -195,10 +261,9 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   // Write ONNXR input data to nGraph input tensors.
   try {
     unsigned input_index = 0;
-    for (const auto& ng_param : ng_curr_exe_->get_parameters()) {
+    for (const auto& ng_param : ng_curr_exe->get_parameters()) {
       const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_index++);
       void* input_data = const_cast<void*>(ort.GetTensorData<void>(input_tensor));
-      std::lock_guard<std::mutex> lock(compute_lock_);
       ng_inputs.emplace_back(ng_backend_->create_tensor(ng_param->get_output_element_type(0), ng_param->get_output_shape(0), input_data));
     }
   } catch (const std::exception& exp) {
@@ -211,14 +276,13 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
   try {
     //TODO: Optimize
     unsigned output_index = 0;
-    for (auto& ng_result : ng_curr_exe_->get_results()) {
+    for (auto& ng_result : ng_curr_exe->get_results()) {
       const auto& dtype = ng_result->get_element_type();
       const auto& shape = ng_result->get_shape();
 
       std::vector<int64_t> ort_shape{shape.begin(), shape.end()};
       OrtValue* output_tensor = ort.KernelContext_GetOutput(context, output_index++, ort_shape.data(), ort_shape.size());
       void* output_data = ort.GetTensorMutableData<void>(output_tensor);
-      std::lock_guard<std::mutex> lock(compute_lock_);
       ng_outputs.emplace_back(ng_backend_->create_tensor(dtype, shape, output_data));
     }
   } catch (const std::exception& exp) {
@@ -229,8 +293,7 @@ Status NGRAPHCustomOp::Compute(const OrtCustomOpApi* api, OrtKernelContext* cont
 
   // Run the graph through nGraph.
   try {
-    std::lock_guard<std::mutex> lock(compute_lock_);
-    if (!ng_curr_exe_->call(ng_outputs, ng_inputs))
+    if (!ng_curr_exe->call(ng_outputs, ng_inputs))
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Error while executing nGraph computation");
   } catch (const std::exception& exp) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, name_ + ": Exception while executing nGraph computation: " + std::string(exp.what()));
@@ -20,9 +20,18 @@
 #include "core/framework/func_api.h"
 #include "core/graph/onnx_protobuf.h"
 
+#include <mutex>
+
 namespace onnxruntime {
 namespace ngraph_ep {
 
+// An nGraph::Executable compiled for a subgraph and input shapes. Runs of all the sessions
+// with these call it one at a time.
+struct NGRAPHExecutable {
+  std::shared_ptr<ngraph::runtime::Executable> exe;
+  std::mutex call_lock;
+};
+
 class NGRAPHCustomOp {
  public:
   NGRAPHCustomOp(const ComputeContext* context,
@@ -34,12 +43,11 @@ class NGRAPHCustomOp {
   ~NGRAPHCustomOp();
 
  private:
-  void Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const;
+  // Get the executable for the input shapes from the process wide cache, compiling it on a miss.
+  std::shared_ptr<NGRAPHExecutable> Initialize(const OrtCustomOpApi* api, OrtKernelContext* context) const;
 
   std::shared_ptr<ngraph::runtime::Backend> ng_backend_;
 
-  mutable std::shared_ptr<ngraph::runtime::Executable> ng_curr_exe_ = nullptr;
-
   AllocateFunc allocate_func_ = nullptr;
 
   DestroyFunc release_func_ = nullptr;
@@ -48,17 +56,12 @@ class NGRAPHCustomOp {
 
   std::string name_;
 
-  /*
-  nGraph::Executable objects are specific to input shapes.
-  Here we keep of a cache of nGraph::Executable objects with key as input shapes. TODO: Configure size of this cache.
-  Logically, key = [i0.rank,[i0.dims],i1.rank,[i1.dims] ... iN.rank,[iN.dims]] raw bytes enclosed inside a string.
-  Example: input0.shape(1,2,3) input1.shape(4,5)
-  key = [3,1,2,3,2,4,5]
-*/
-  mutable std::unordered_map<std::string, std::shared_ptr<ngraph::runtime::Executable>> ng_exe_map_;
-  mutable std::list<std::string> keyCache;
-  
-  mutable std::mutex compute_lock_;
+  // Hash of the subgraph, the same for the identical subgraphs of different sessions,
+  // whose executables are shared through the cache.
+  std::string subgraph_key_;
+
+  // guards the input shapes of model_proto_ set to compile
+  mutable std::mutex compile_lock_;
 
   mutable ONNX_NAMESPACE::ModelProto model_proto_;
 };
@@ -11,6 +11,9 @@
 #include "ngraph_execution_provider.h"
 #include "ngraph_custom_op.h"
 
+#include <mutex>
+#include <unordered_map>
+
 #if defined(_MSC_VER)
 #pragma warning(disable : 4244 4245)
 #elif __GNUC__
@@ -64,8 +67,19 @@ NGRAPHExecutionProvider::NGRAPHExecutionProvider(const NGRAPHExecutionProviderIn
 
   InsertAllocator(CreateAllocator(cpu_memory_info));
 
+  // The backend is shared by the providers of all sessions, so that the executables it compiled
+  // for a session are reused by the next ones. See NGRAPHExecutableCache.
+  static std::mutex backends_lock;
+  static std::unordered_map<std::string, std::weak_ptr<ngraph::runtime::Backend>> backends;
+  std::lock_guard<std::mutex> lock(backends_lock);
+  ng_backend_ = backends[info.ng_backend_type].lock();
+  if (ng_backend_ != nullptr) {
+    return;
+  }
+
   try {
     ng_backend_ = ngraph::runtime::Backend::create(info.ng_backend_type);
+    backends[info.ng_backend_type] = ng_backend_;
   } catch (const std::exception& exp) {
     LOGS_DEFAULT(FATAL) << "Exception while creating nGraph " << info.ng_backend_type << " Backend: " << std::string(exp.what());
   } catch (...) {
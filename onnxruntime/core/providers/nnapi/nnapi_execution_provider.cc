@@ -192,6 +192,33 @@ NnapiExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+std::shared_ptr<NnapiExecutionProvider::CompiledModel>
+NnapiExecutionProvider::GetOrCompileModel(const ONNX_NAMESPACE::ModelProto& model_proto) {
+  // The compiled models are keyed by the hash and size of the serialized subgraph, which includes its initializers.
+  // They are released with the last session that uses them.
+  static OrtMutex models_mutex;
+  static std::unordered_map<std::string, std::weak_ptr<CompiledModel>> models;
+
+  const std::string serialized = model_proto.SerializeAsString();
+  const std::string key = std::to_string(std::hash<std::string>{}(serialized)) + "_" + std::to_string(serialized.size());
+
+  std::lock_guard<OrtMutex> lock(models_mutex);
+  auto compiled_model = models[key].lock();
+  if (compiled_model != nullptr) {
+    return compiled_model;
+  }
+
+  dnn::OnnxReader onnx_reader;
+  dnn::ModelBuilder model_builder;
+  onnx_reader.ReadOnnx(model_proto, model_builder);
+  model_builder.AllowFp16(true);
+
+  compiled_model = std::make_shared<CompiledModel>();
+  compiled_model->model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
+  models[key] = compiled_model;
+  return compiled_model;
+}
+
 common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                                std::vector<NodeComputeInfo>& node_compute_funcs) {
   for (const auto* fused_node : fused_nodes) {
@@ -207,12 +234,7 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     *(model_proto.mutable_graph()) = graph_body.ToGraphProto();
     model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
 
-    dnn::OnnxReader onnx_reader;
-    dnn::ModelBuilder model_builder;
-    onnx_reader.ReadOnnx(model_proto, model_builder);
-    model_builder.AllowFp16(true);
-    auto dnn_model = model_builder.Compile(model_builder.PREFERENCE_SUSTAINED_SPEED);
-    dnn_models_.emplace(fused_node->Name(), std::move(dnn_model));
+    dnn_models_[fused_node->Name()] = GetOrCompileModel(model_proto);
 
     NodeComputeInfo compute_info;
     compute_info.create_state_func = [&](ComputeContext* context, FunctionState* state) {
@@ -221,20 +243,22 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
     };
 
     compute_info.release_state_func = [](FunctionState state) {
-      // the `state` is a dnn::model managed by unique_ptr
+      // the `state` is a CompiledModel owned by dnn_models_
       ORT_UNUSED_PARAMETER(state);
     };
 
     compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
-      dnn::Model* model = reinterpret_cast<dnn::Model*>(state);
+      CompiledModel* compiled_model = reinterpret_cast<CompiledModel*>(state);
+      std::lock_guard<OrtMutex> lock(compiled_model->mutex);
+      dnn::Model* model = compiled_model->model.get();
       const size_t num_inputs = ort.KernelContext_GetInputCount(context);
       const size_t num_outputs = ort.KernelContext_GetOutputCount(context);
       ORT_ENFORCE(model->GetInputs().size() <= num_inputs, "Inconsistent input sizes");
       ORT_ENFORCE(model->GetOutputs().size() == num_outputs, "Inconsistent output sizes");
       // Maintain the created nhwc buffers so that they can be deleted after inferencing
-      std::vector<float*> nhwc_inputs;
-      std::vector<std::tuple<size_t, float*, std::vector<int64_t>>> nhwc_outputs;
+      std::vector<std::vector<float>> nhwc_inputs;
+      std::vector<std::tuple<size_t, std::vector<float>, std::vector<int64_t>>> nhwc_outputs;
       for (size_t i = 0; i < num_outputs; i++) {
         const auto output_name = model->GetOutputs()[i];
         const auto output_shape = model->GetShape(output_name);
@@ -243,9 +267,9 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           // NHWC to NCHW
           std::swap(int64_output_shape[1], int64_output_shape[3]);
           std::swap(int64_output_shape[2], int64_output_shape[3]);
-          float* nhwc_output = new float[model->GetSize(output_name)];
-          model->SetOutputBuffer(i, nhwc_output);
-          nhwc_outputs.push_back(std::make_tuple(i, nhwc_output, int64_output_shape));
+          std::vector<float> nhwc_output(model->GetSize(output_name));
+          model->SetOutputBuffer(i, nhwc_output.data());
+          nhwc_outputs.push_back(std::make_tuple(i, std::move(nhwc_output), int64_output_shape));
         } else {
           auto* output_tensor = ort.KernelContext_GetOutput(context, i, int64_output_shape.data(), int64_output_shape.size());
           model->SetOutputBuffer(i, ort.GetTensorMutableData<float>(output_tensor));
@@ -262,7 +286,7 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
         if (tensor_shape.size() == 4) {
           // Transpose nchw -> nhwc manually
           const int N = tensor_shape[0], C = tensor_shape[1], H = tensor_shape[2], W = tensor_shape[3];
-          float* nhwc_input = new float[N * C * H * W];
+          std::vector<float> nhwc_input(static_cast<size_t>(N) * C * H * W);
           for (int n = 0; n < N; n++) {
             for (int c = 0; c < C; c++) {
               for (int h = 0; h < H; h++) {
@@ -272,8 +296,8 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
               }
             }
           }
-          inputs.push_back(nhwc_input);
-          nhwc_inputs.push_back(nhwc_input);
+          inputs.push_back(nhwc_input.data());
+          nhwc_inputs.push_back(std::move(nhwc_input));
         } else {
           inputs.push_back(input);
         }
@@ -282,11 +306,10 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
       model->Predict(inputs);
       // Transpose nhwc -> nchw manually
       for (size_t i = 0; i < nhwc_outputs.size(); i++) {
-        const auto output = nhwc_outputs[i];
-        size_t index;
-        float* nhwc_data;
-        std::vector<int64_t> nchw_shape;
-        std::tie(index, nhwc_data, nchw_shape) = output;
+        const auto& output = nhwc_outputs[i];
+        const size_t index = std::get<0>(output);
+        const float* nhwc_data = std::get<1>(output).data();
+        const std::vector<int64_t>& nchw_shape = std::get<2>(output);
         auto* output_tensor = ort.KernelContext_GetOutput(context, index, nchw_shape.data(), nchw_shape.size());
         const int N = nchw_shape[0], C = nchw_shape[1], H = nchw_shape[2], W = nchw_shape[3];
         float* nchw_output = ort.GetTensorMutableData<float>(output_tensor);
@@ -300,12 +323,6 @@ common::Status NnapiExecutionProvider::Compile(const std::vector<onnxruntime::No
           }
         }
       }
-      for (auto nhwc_input : nhwc_inputs) {
-        delete[] nhwc_input;
-      }
-      for (auto nhwc_output : nhwc_outputs) {
-        delete[] std::get<1>(nhwc_output);
-      }
       return Status::OK();
     };
 
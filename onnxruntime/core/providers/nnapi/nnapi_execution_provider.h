@@ -4,6 +4,7 @@
 
 #include "core/framework/execution_provider.h"
 #include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
 #include "dnnlibrary/Model.h"
 
 namespace onnxruntime {
@@ -19,7 +20,16 @@ class NnapiExecutionProvider : public IExecutionProvider {
                          std::vector<NodeComputeInfo>& node_compute_funcs) override;
 
  private:
-  std::unordered_map<std::string, std::unique_ptr<dnn::Model>> dnn_models_;
+  // A compiled NNAPI model, shared by the providers of all the sessions that load the same subgraph so that only
+  // the first one compiles it. Predict runs on the buffers set on the model, so a run holds the mutex.
+  struct CompiledModel {
+    std::unique_ptr<dnn::Model> model;
+    OrtMutex mutex;
+  };
+
+  static std::shared_ptr<CompiledModel> GetOrCompileModel(const ONNX_NAMESPACE::ModelProto& model_proto);
+
+  std::unordered_map<std::string, std::shared_ptr<CompiledModel>> dnn_models_;
   std::vector<std::vector<int>> GetSupportedNodes(const ONNX_NAMESPACE::ModelProto& model_proto) const;
 };
 }  // namespace onnxruntime
@@ -32,6 +32,10 @@ static const std::unordered_set<std::string> valid_keys = {
     kNupharCacheSoName,
     kNupharCacheModelChecksum,
     kNupharCacheForceNoJIT,
+    kNupharBackgroundCompile,
+    kNupharScheduleTuning,
+    kNupharScheduleTuningDim,
+    kNupharParallelScanBatch,
     kNupharCodeGenTarget};
 
 void SetDefaultOptions(std::map<std::string, std::string>& options) {
@@ -18,6 +18,15 @@ constexpr static const char* kNupharCacheVersion = "nuphar_cache_version";
 constexpr static const char* kNupharCacheSoName = "nuphar_cache_so_name";
 constexpr static const char* kNupharCacheModelChecksum = "nuphar_cache_model_checksum";
 constexpr static const char* kNupharCacheForceNoJIT = "nuphar_cache_force_no_jit";
+// compile in a background thread, while the fused subgraphs run on CPU kernels
+constexpr static const char* kNupharBackgroundCompile = "nuphar_background_compile";
+// search the schedule factors of each JIT function on the host, the factors are saved in the cache
+constexpr static const char* kNupharScheduleTuning = "nuphar_schedule_tuning";
+// value of the symbolic dimensions when running the functions for tuning
+constexpr static const char* kNupharScheduleTuningDim = "nuphar_schedule_tuning_dim";
+constexpr static int64_t kNupharScheduleTuningDim_Default = 16;
+// run the iterations of Scan in slices of the batch on the intra-op thread pool, with at least this many rows per slice
+constexpr static const char* kNupharParallelScanBatch = "nuphar_parallel_scan_batch";
 // force to use IMatMulExternMKL/IMatMul16ExternMKL
 constexpr static const char* kNupharIMatMulForceMkl = "nuphar_imatmul_force_mkl";
 
@@ -126,25 +126,90 @@ static bool VerifyTVMModuleChecksum(const std::string& so_path) {
   return last_checksum_validated;
 }
 
-tvm::runtime::PackedFunc LoadTVMPackedFuncFromCache(const std::string& func_name) {
-  std::string so_path;
-  if (!GetCacheSoFilePath(so_path))
+// The JIT functions are also saved as LLVM IR to <cache path>/<version>/<model checksum>,
+// and loaded from there when the cache so doesn't have them, so that no offline step is needed to link a so.
+// The directory is keyed by the model checksum, so that the IR of another model is never loaded.
+static bool GetOrCreateTVMModuleIRDirectory(fs::path& path, bool create) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+
+  if (!settings.HasOption(kNupharCacheModelChecksum))
+    return false;
+
+  if (!GetOrCreateTVMModuleCacheDirectory(path, create))
+    return false;
+
+  path.append(settings.GetOptionValue(kNupharCacheModelChecksum));
+  if (!create && !fs::is_directory(path))
+    return false;
+
+  if (!fs::is_directory(path))
+    if (!fs::create_directory(path)) {
+      throw std::runtime_error("Failed to create directory " + path.string());
+    }
+
+  return true;
+}
+
+static tvm::runtime::PackedFunc LoadTVMPackedFuncFromIR(const std::string& func_name) {
+  fs::path path;
+  if (!GetOrCreateTVMModuleIRDirectory(path, /*create*/ false))
     return nullptr;
 
-  if (!VerifyTVMModuleChecksum(so_path))
+  path.append(func_name + ".ll");
+  if (!fs::is_regular_file(path))
     return nullptr;
 
-  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(so_path);
-  tvm::runtime::PackedFunc func = module.GetFunction(func_name);
+  tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(path.string(), "ll");
+  return module.GetFunction(func_name);
+}
+
+static void SaveTVMModuleIRToCache(const std::string& func_name, tvm::runtime::Module& module) {
+  // only LLVM modules can be loaded from IR
+  if (std::string(module->type_key()) != "llvm")
+    return;
+
+  static std::mutex save_ir_mutex;
+  std::lock_guard<std::mutex> lock(save_ir_mutex);
+  fs::path path;
+  if (!GetOrCreateTVMModuleIRDirectory(path, /*create*/ true))
+    return;
+
+  path.append(func_name + ".ll");
+  if (fs::exists(path))
+    return;
+
+  // rename a complete file, so that another process loading the cache never reads a partial one
+  fs::path tmp_path = path;
+  tmp_path += ".tmp";
+  module->SaveToFile(tmp_path.string(), "ll");
+  fs::rename(tmp_path, path);
+}
+
+tvm::runtime::PackedFunc LoadTVMPackedFuncFromCache(const std::string& func_name) {
+  tvm::runtime::PackedFunc func;
+  std::string so_path;
+  bool has_so = GetCacheSoFilePath(so_path) && VerifyTVMModuleChecksum(so_path);
+  if (has_so) {
+    tvm::runtime::Module module = tvm::runtime::Module::LoadFromFile(so_path);
+    func = module.GetFunction(func_name);
+  }
+
   if (func == nullptr) {
+    func = LoadTVMPackedFuncFromIR(func_name);
+  }
+
+  if (func == nullptr && has_so) {
     LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Cannot find " << func_name << " in cache, using JIT...";
   }
   return func;
 }
 
-thread_local int saved_tvm_model_cnt = 0;
+// not thread_local, as the background compile saves from a thread per fused node
+static int saved_tvm_model_cnt = 0;
 
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module) {
+  SaveTVMModuleIRToCache(filename, module);
+
   fs::path path;
 
   if (disable_caching_due_to_checksum_failure)
@@ -165,6 +230,64 @@ void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& mod
   }
 }
 
+// The schedule factors are saved with the IR of the model checksum if it's set,
+// otherwise in the cache version directory, where another model's factors only make its functions slower.
+static bool GetScheduleParamsFilePath(const std::string& func_name, bool create, fs::path& path) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  bool has_directory = settings.HasOption(kNupharCacheModelChecksum)
+                           ? GetOrCreateTVMModuleIRDirectory(path, create)
+                           : GetOrCreateTVMModuleCacheDirectory(path, create);
+  if (!has_directory)
+    return false;
+
+  path.append(func_name + ".schedule");
+  return true;
+}
+
+bool LoadScheduleParamsFromCache(const std::string& func_name, tvm_codegen::ScheduleParams& params) {
+  fs::path path;
+  if (!GetScheduleParamsFilePath(func_name, /*create*/ false, path) || !fs::is_regular_file(path))
+    return false;
+
+  std::ifstream file(path.string());
+  tvm_codegen::ScheduleParams loaded = params;
+  std::string key;
+  int64_t value;
+  while (file >> key >> value) {
+    if (key == "vector_width") {
+      loaded.vector_width = value;
+    } else if (key == "block_size") {
+      loaded.block_size = gsl::narrow<int>(value);
+    } else if (key == "parallel") {
+      loaded.parallel = value != 0;
+    } else {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "Unknown schedule factor " << key << " in " << path << ", retuning...";
+      return false;
+    }
+  }
+
+  params = loaded;
+  return true;
+}
+
+void SaveScheduleParamsToCache(const std::string& func_name, const tvm_codegen::ScheduleParams& params) {
+  static std::mutex save_params_mutex;
+  std::lock_guard<std::mutex> lock(save_params_mutex);
+  fs::path path;
+  if (!GetScheduleParamsFilePath(func_name, /*create*/ true, path))
+    return;
+
+  fs::path tmp_path = path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream file(tmp_path.string());
+    file << "vector_width " << params.vector_width << std::endl
+         << "block_size " << params.block_size << std::endl
+         << "parallel " << (params.parallel ? 1 : 0) << std::endl;
+  }
+  fs::rename(tmp_path, path);
+}
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target) {
   // in C, a function does not allow its name starting with a digit.
   return NormalizeCppName("_" + subgraph.UniqueId() + " " + codegen_target.GetTargetName());
@@ -5,6 +5,7 @@
 #include <tvm/tvm.h>
 #include <string>
 
+#include "core/codegen/passes/scheduler/tvm_scheduler.h"
 #include "core/graph/graph.h"
 
 namespace onnxruntime {
@@ -16,10 +17,15 @@ struct NupharSubgraphUnit;  //forward
 // Helper functions to create or load from offline cached dll
 // note after saving to obj file, we need to use tvm Python to create dll
 // using script at onnxruntime/core/codegen/mti/scripts/create_shared.py
+// unless nuphar_cache_model_checksum is set, which saves and loads LLVM IR of the functions as well
 tvm::runtime::PackedFunc
 LoadTVMPackedFuncFromCache(const std::string& func_name);
 void SaveTVMModuleToCache(const std::string& filename, tvm::runtime::Module& module);
 
+// Helper functions to save and load the tuned schedule factors of a function in the cache
+bool LoadScheduleParamsFromCache(const std::string& func_name, tvm_codegen::ScheduleParams& params);
+void SaveScheduleParamsToCache(const std::string& func_name, const tvm_codegen::ScheduleParams& params);
+
 std::string GetPackedFuncName(const nuphar::NupharSubgraphUnit& subgraph, const CodeGenTarget& codegen_target);
 
 }  // namespace nuphar
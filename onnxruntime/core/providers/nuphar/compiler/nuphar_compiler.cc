@@ -15,6 +15,12 @@
 #include "core/providers/nuphar/compiler/nuphar_op_ir_builder.h"
 #include "core/providers/nuphar/compiler/nuphar_schedule_builder.h"
 
+#include <tvm/ir_pass.h>
+#include <tvm/ir_visitor.h>
+
+#include <chrono>
+#include <limits>
+
 namespace onnxruntime {
 namespace nuphar {
 
@@ -140,6 +146,171 @@ Status NupharCompiler::BuildSubgraph(const Node& node) {
   return Status::OK();
 }
 
+tvm::runtime::Module NupharCompiler::BuildModule(
+    const std::string& func_name,
+    tvm::Target tvm_target,
+    tvm::Target tvm_host_target,
+    const tvm::BuildConfig& config,
+    const tvm_codegen::ScheduleParams& params,
+    tvm_codegen::ScheduleParamsUsage* params_used,
+    const std::string& subgraph_type,
+    const std::string& subgraph_name) {
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+
+  tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_, params, params_used);
+  std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
+  tvm::Array<tvm::LoweredFunc> lowered = tvm::lower(tvm_schedule, tvm_args_, func_name, binds, config);
+
+  if (settings.HasOption(codegen::CodeGenSettings::kCodeGenDumpLower)) {
+    if (settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, "verbose") ||
+        settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, subgraph_type)) {
+      for (const auto& func : lowered)
+        LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[CODEGEN_DUMP_LOWER] Dumping lowered func: " << func << std::endl
+                                                 << func->body;
+    } else if (settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, "concise")) {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[CODEGEN_DUMP_LOWER] Subgraph Type: "
+                                               << subgraph_type << ", name: " << subgraph_name
+                                               << " #lowered funcs: " << lowered.size() << std::endl;
+    }
+  }
+
+  return tvm::build(lowered, tvm_target, tvm_host_target, config);
+}
+
+// Evaluate a dimension of a func arg, with every symbolic dimension set to symbolic_dim
+static int64_t TuningDimValue(const tvm::Expr& dim, int64_t symbolic_dim) {
+  const int64_t* value = tvm::as_const_int(dim);
+  if (nullptr != value)
+    return *value;
+
+  std::unordered_map<const tvm::Variable*, tvm::Expr> symbols;
+  tvm::ir::PostOrderVisit(dim, [&](const tvm::NodeRef& node) {
+    const tvm::Variable* symbol = node.as<tvm::Variable>();
+    if (nullptr != symbol)
+      symbols[symbol] = tvm::make_const(symbol->type, symbolic_dim);
+  });
+  tvm::Expr simplified = tvm::ir::Simplify(tvm::ir::Substitute(dim, symbols));
+  value = tvm::as_const_int(simplified);
+  ORT_ENFORCE(nullptr != value, "Cannot evaluate dimension ", dim, " for schedule tuning");
+  return *value;
+}
+
+// Run the func of a module on zero filled args, and return the fastest of several runs in microseconds
+double NupharCompiler::BenchmarkModule(tvm::runtime::Module& module, const std::string& func_name) const {
+  constexpr int num_runs = 10;
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  int64_t symbolic_dim = kNupharScheduleTuningDim_Default;
+  if (settings.HasOption(kNupharScheduleTuningDim)) {
+    symbolic_dim = std::stoll(settings.GetOptionValue(kNupharScheduleTuningDim));
+  }
+
+  int num_args = gsl::narrow<int>(tvm_args_.size());
+  std::vector<std::vector<int64_t>> shapes(num_args);
+  std::vector<IAllocatorUniquePtr<void>> buffers;
+  std::vector<DLTensor> dl_tensors(num_args);
+  std::vector<TVMValue> lvalues(num_args);
+  DLContext tvm_ctx{kDLCPU, 0};
+  for (int i = 0; i < num_args; ++i) {
+    const tvm::Tensor& arg = tvm_args_[i];
+    int64_t size = 1;
+    for (const auto& dim : arg->shape) {
+      shapes[i].push_back(TuningDimValue(dim, symbolic_dim));
+      size *= shapes[i].back();
+    }
+
+    DLDataType dtype{static_cast<uint8_t>(arg->dtype.code()),
+                     static_cast<uint8_t>(arg->dtype.bits()),
+                     static_cast<uint16_t>(arg->dtype.lanes())};
+    size_t bytes = gsl::narrow<size_t>(size) * ((dtype.bits * dtype.lanes + 7) / 8);
+    // zeros keep integer inputs, like gather indices, in range
+    buffers.push_back(context_.Allocate(bytes));
+    memset(buffers.back().get(), 0, bytes);
+
+    dl_tensors[i] = {buffers.back().get(), tvm_ctx,
+                     gsl::narrow<int>(shapes[i].size()), dtype,
+                     shapes[i].data(), nullptr, 0};
+    lvalues[i].v_handle = &(dl_tensors[i]);
+  }
+
+  auto types_code = std::vector<int>(num_args, kNDArrayContainer);
+  tvm::TVMArgs tvm_args(lvalues.data(), types_code.data(), num_args);
+  tvm::TVMRetValue rvalue;
+  tvm::runtime::PackedFunc func = module.GetFunction(func_name);
+
+  func.CallPacked(tvm_args, &rvalue);  // warm up
+  double best_time = std::numeric_limits<double>::max();
+  for (int run = 0; run < num_runs; ++run) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func.CallPacked(tvm_args, &rvalue);
+    auto end = std::chrono::high_resolution_clock::now();
+    best_time = std::min(best_time, std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  return best_time;
+}
+
+// Search the schedule factors that the schedulers read, one factor at a time,
+// and return the fastest module with its factors in params
+tvm::runtime::Module NupharCompiler::TuneModule(
+    const std::string& func_name,
+    tvm::Target tvm_target,
+    tvm::Target tvm_host_target,
+    const tvm::BuildConfig& config,
+    tvm_codegen::ScheduleParams& params,
+    const std::string& subgraph_type,
+    const std::string& subgraph_name) {
+  tvm_codegen::ScheduleParamsUsage params_used;
+  tvm::runtime::Module best_module =
+      BuildModule(func_name, tvm_target, tvm_host_target, config, params, &params_used, subgraph_type, subgraph_name);
+  double best_time = BenchmarkModule(best_module, func_name);
+
+  auto try_params = [&](const tvm_codegen::ScheduleParams& candidate) {
+    try {
+      tvm::runtime::Module module =
+          BuildModule(func_name, tvm_target, tvm_host_target, config, candidate, nullptr, subgraph_type, subgraph_name);
+      double time = BenchmarkModule(module, func_name);
+      if (time < best_time) {
+        best_time = time;
+        best_module = module;
+        params = candidate;
+      }
+    } catch (const std::exception& ex) {
+      LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[NUPHAR_SCHEDULE_TUNING] Skipping a schedule of "
+                                               << func_name << ": " << ex.what();
+    }
+  };
+
+  if (params_used.vector_width) {
+    for (int64_t vector_width : {4, 8, 16, 32, 64}) {
+      tvm_codegen::ScheduleParams candidate = params;
+      candidate.vector_width = vector_width;
+      if (vector_width != params.vector_width)
+        try_params(candidate);
+    }
+  }
+
+  if (params_used.block_size) {
+    for (int block_size : {8, 16, 32, 64}) {
+      tvm_codegen::ScheduleParams candidate = params;
+      candidate.block_size = block_size;
+      if (block_size != params.block_size)
+        try_params(candidate);
+    }
+  }
+
+  if (params_used.parallel) {
+    tvm_codegen::ScheduleParams candidate = params;
+    candidate.parallel = !params.parallel;
+    try_params(candidate);
+  }
+
+  LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[NUPHAR_SCHEDULE_TUNING] " << func_name
+                                           << ": vector_width " << params.vector_width
+                                           << ", block_size " << params.block_size
+                                           << ", parallel " << params.parallel
+                                           << ", " << best_time << "us";
+  return best_module;
+}
+
 tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
     const std::string& func_name,
     tvm::Target tvm_target,
@@ -161,24 +332,18 @@ tvm::runtime::PackedFunc NupharCompiler::GetLoweredPackedFunc(
       }
     }
 
-    tvm::Schedule tvm_schedule = CreateSchedule(tvm_outputs_, context_);
-    std::unordered_map<tvm::Tensor, tvm::Buffer> binds;
-    tvm::Array<tvm::LoweredFunc> lowered = tvm::lower(tvm_schedule, tvm_args_, func_name, binds, config);
-
-    if (settings.HasOption(codegen::CodeGenSettings::kCodeGenDumpLower)) {
-      if (settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, "verbose") ||
-          settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, subgraph_type)) {
-        for (const auto& func : lowered)
-          LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[CODEGEN_DUMP_LOWER] Dumping lowered func: " << func << std::endl
-                                                   << func->body;
-      } else if (settings.OptionMatches(codegen::CodeGenSettings::kCodeGenDumpLower, "concise")) {
-        LOGS_DEFAULT(CODEGEN_SETTINGS_LOG_LEVEL) << "[CODEGEN_DUMP_LOWER] Subgraph Type: "
-                                                 << subgraph_type << ", name: " << subgraph_name
-                                                 << " #lowered funcs: " << lowered.size() << std::endl;
-      }
+    // the rule schedules' factors, unless the ones tuned before are in the cache
+    tvm_codegen::ScheduleParams params;
+    params.parallel = context_.GetCodeGenHandle()->enable_per_node_parallelized;
+    tvm::runtime::Module module;
+    if (nuphar::LoadScheduleParamsFromCache(func_name, params) ||
+        !settings.OptionMatches(kNupharScheduleTuning, "on")) {
+      module = BuildModule(func_name, tvm_target, tvm_host_target, config, params, nullptr, subgraph_type, subgraph_name);
+    } else {
+      module = TuneModule(func_name, tvm_target, tvm_host_target, config, params, subgraph_type, subgraph_name);
+      nuphar::SaveScheduleParamsToCache(func_name, params);
     }
 
-    tvm::runtime::Module module = tvm::build(lowered, tvm_target, tvm_host_target, config);
     tvm_codegen::DumpTVMModuleToFile(func_name, module);
     nuphar::SaveTVMModuleToCache(func_name, module);
     cached_func = module.GetFunction(func_name);
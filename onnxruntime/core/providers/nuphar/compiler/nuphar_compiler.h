@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/codegen/common/common.h"
+#include "core/codegen/passes/scheduler/tvm_scheduler.h"
 #include "core/providers/nuphar/common/nuphar_subgraph.h"
 #include "core/providers/nuphar/compiler/func_info.h"
 #include "core/providers/nuphar/compiler/initializer_info.h"
@@ -52,6 +53,29 @@ class NupharCompiler {
  private:
   size_t num_initializers_in_graph_inputs_;
 
+  // Schedule, lower and build the func with the given schedule factors
+  tvm::runtime::Module BuildModule(
+      const std::string& func_name,
+      tvm::Target tvm_target,
+      tvm::Target tvm_host_target,
+      const tvm::BuildConfig& config,
+      const tvm_codegen::ScheduleParams& params,
+      tvm_codegen::ScheduleParamsUsage* params_used,
+      const std::string& subgraph_type,
+      const std::string& subgraph_name);
+
+  // Build the func with the schedule factors that run fastest on the host, which are returned in params
+  tvm::runtime::Module TuneModule(
+      const std::string& func_name,
+      tvm::Target tvm_target,
+      tvm::Target tvm_host_target,
+      const tvm::BuildConfig& config,
+      tvm_codegen::ScheduleParams& params,
+      const std::string& subgraph_type,
+      const std::string& subgraph_name);
+
+  double BenchmarkModule(tvm::runtime::Module& module, const std::string& func_name) const;
+
   // BuildSubgraph builds tvm IR and apply passes for a subgraph
   Status BuildSubgraph(const Node& node);
 
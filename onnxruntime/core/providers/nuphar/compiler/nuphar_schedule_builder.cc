@@ -34,10 +34,7 @@ static void Traverse(const tvm::Tensor& tensor,
                         Promote<CodeGenUnitStats>(ctx_codegen.GetGraphStats())->IsOutputNode(node);
 
   if (is_real_output) {
-    // TODO change it to the value from Target
-    int64_t natural_vector_size = 16;
-
-    TryVectorization(tensor, natural_vector_size, ctx_schedule);  // to x86
+    TryVectorization(tensor, ctx_schedule.VectorWidth(), ctx_schedule);  // to x86
     InsertRootScheduleAndClosure(tensor, ctx_schedule);
   }
 
@@ -52,7 +49,9 @@ static void Traverse(const tvm::Tensor& tensor,
 }
 
 tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
-                             NupharCodeGenCtx& ctx_codegen) {
+                             NupharCodeGenCtx& ctx_codegen,
+                             const tvm_codegen::ScheduleParams& params,
+                             tvm_codegen::ScheduleParamsUsage* params_used) {
   // Create scheudule object
   tvm::Array<tvm::Operation> out_ops;
   for (auto& t : outs) {
@@ -62,7 +61,7 @@ tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
   if (codegen::CodeGenSettings::Instance().HasOption(codegen::CodeGenSettings::kCodeGenDumpSchedule))
     ctx_codegen.GetCodeGenHandle()->schedule_builder->DumpAllSchedulers();
 
-  tvm_codegen::ScheduleContext ctx_schedule(out_ops);
+  tvm_codegen::ScheduleContext ctx_schedule(out_ops, params);
 
   // Schedule all outputs
   for (const auto& t : outs) {
@@ -70,6 +69,9 @@ tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
     Traverse(t, node, ctx_codegen, ctx_schedule);
   }
 
+  if (nullptr != params_used)
+    *params_used = ctx_schedule.params_used;
+
   return ctx_schedule.schedule;
 }
 
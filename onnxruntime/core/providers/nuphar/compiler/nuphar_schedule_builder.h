@@ -5,6 +5,7 @@
 
 #include <tvm/tvm.h>
 #include "core/common/common.h"
+#include "core/codegen/passes/scheduler/tvm_scheduler.h"
 #include "core/providers/nuphar/compiler/nuphar_codegen_ctx.h"
 
 // TODO change name space
@@ -13,8 +14,11 @@ namespace nuphar {
 
 // Traverse iterates tvm::Array<tvm::Tensor> a single node
 // and builds the whole schedule (in CodeGenContext)
+// with the factors in params, returning the ones read in params_used if it's not null
 tvm::Schedule CreateSchedule(const tvm::Array<tvm::Tensor>& outs,
-                             NupharCodeGenCtx& ctx_codegen);
+                             NupharCodeGenCtx& ctx_codegen,
+                             const tvm_codegen::ScheduleParams& params = tvm_codegen::ScheduleParams(),
+                             tvm_codegen::ScheduleParamsUsage* params_used = nullptr);
 
 }  // namespace nuphar
 }  // namespace onnxruntime
@@ -53,6 +53,17 @@ static Status EvaluateMatMulInteger(
         }
         output_shape.push_back(tvm::Expr(gsl::narrow_cast<int>(embed_dim)));
 
+        const codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+        bool force_mkl = settings.HasOption(kNupharIMatMulForceMkl);
+
+        // On AVX512 hosts, the U8S8 kernels of MLAS use AVX512BW or VNNI, which are faster than the AVX2 extern
+        if (is8bitAsymm && !force_mkl &&
+            (CPUIDInfo::GetCPUIDInfo().HasAVX512_VNNI() || CPUIDInfo::GetCPUIDInfo().HasAVX512f())) {
+          outputs.push_back(IMatMulExternMLAS(B, A, output_shape, input_dim, embed_dim,
+                                              name + "_IMatMulExternMLAS"));
+          return Status::OK();
+        }
+
         tvm::Tensor B_marshalled;
         auto B_NodeArg = node.InputDefs()[1];
         const std::string& B_name = B_NodeArg->Name();
@@ -66,8 +77,7 @@ static Status EvaluateMatMulInteger(
 
         // TODO: add reserved_bits attribute
         bool use_AVX2;
-        const codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
-        if (settings.HasOption(kNupharIMatMulForceMkl)) {
+        if (force_mkl) {
           use_AVX2 = false;
         } else {
           use_AVX2 = CPUIDInfo::GetCPUIDInfo().HasAVX2();
@@ -17,10 +17,7 @@ namespace nuphar {
 bool TryVectorizationX86(
     const tvm::Tensor& tensor,
     tvm_codegen::ScheduleContext& ctx) {
-  // TODO change it to the value from Target
-  int64_t natural_vector_size = 16;
-
-  return TryVectorization(tensor, natural_vector_size, ctx);
+  return TryVectorization(tensor, ctx.VectorWidth(), ctx);
 }
 
 bool InputRootScheduleWithVectorizationX86(
@@ -141,7 +138,6 @@ bool TVM_SCHEDULER_CLASS(Gemm, NupharX86OrtOpType)::Evaluate(
 
 // OLD code from Conv schedule
 static Status ConvScheduleX86(const tvm::Tensor& tensor,
-                              NupharCodeGenCtx& ctx_codegen,
                               tvm_codegen::ScheduleContext& ctx_sched,
                               int block_size) {
   if (tensor->shape.size() != 4)
@@ -172,7 +168,7 @@ static Status ConvScheduleX86(const tvm::Tensor& tensor,
 
   ctx_sched.schedule[tensor->op].reorder({b, oc_chunk, y, xo, ic_chunk, m, n, ic_block, xi, oc_block});
 
-  if (ctx_codegen.GetCodeGenHandle()->enable_per_node_parallelized) {
+  if (ctx_sched.Parallel()) {
     tvm::Array<tvm::IterVar> fused_axis;
     fused_axis.push_back(b);
     fused_axis.push_back(oc_chunk);
@@ -190,16 +186,14 @@ static Status ConvScheduleX86(const tvm::Tensor& tensor,
 bool TVM_SCHEDULER_CLASS(Conv, NupharX86OrtOpType)::Evaluate(
     const tvm::Tensor& tensor,
     const Node* node,
-    tvm_codegen::CodeGenContext& ctx_codegen,
+    tvm_codegen::CodeGenContext&,
     tvm_codegen::ScheduleContext& ctx_sched) {
-  NupharCodeGenCtx* ctx_nuphar = Promote<NupharCodeGenCtx>(&ctx_codegen);
-  return ConvScheduleX86(tensor, *ctx_nuphar, ctx_sched, 16).IsOK();
+  return ConvScheduleX86(tensor, ctx_sched, ctx_sched.BlockSize()).IsOK();
 }  // namespace tvm_codegen
 
 // seems only tested in double path
 static Status MatMul_2DWeight_Schedule(
     const tvm::Tensor& tensor_C,
-    NupharCodeGenCtx& ctx_codegen,
     tvm_codegen::ScheduleContext& ctx_sched,
     int block_size) {
   // implementation adapted from:
@@ -239,7 +233,7 @@ static Status MatMul_2DWeight_Schedule(
   ctx_sched.schedule[CC->op].unroll(ki);
   ctx_sched.schedule[CC->op].vectorize(yc);
 
-  if (ctx_codegen.GetCodeGenHandle()->enable_per_node_parallelized) {
+  if (ctx_sched.Parallel()) {
     // parallelize
     tvm::Array<tvm::IterVar> fused_axis;
     for (size_t d = 0; d < C_rank - 2; ++d)
@@ -256,12 +250,10 @@ static Status MatMul_2DWeight_Schedule(
 bool TVM_SCHEDULER_CLASS(MatMul, NupharX86OrtOpType)::Evaluate(
     const tvm::Tensor& tensor,
     const Node* node,
-    tvm_codegen::CodeGenContext& ctx_codegen,
+    tvm_codegen::CodeGenContext&,
     tvm_codegen::ScheduleContext& ctx_sched) {
-  NupharCodeGenCtx* ctx_nuphar = Promote<NupharCodeGenCtx>(&ctx_codegen);
-
   if (tensor->dtype != HalideIR::Float(32)) {
-    return MatMul_2DWeight_Schedule(tensor, *ctx_nuphar, ctx_sched, 16).IsOK();
+    return MatMul_2DWeight_Schedule(tensor, ctx_sched, ctx_sched.BlockSize()).IsOK();
   }
   return InsertRootSchedule(tensor, ctx_sched);
 }
@@ -5,12 +5,16 @@
 
 #include "core/codegen/passes/utils/codegen_context.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/graph/model.h"
+#include "core/platform/ort_mutex.h"
 #include "core/providers/nuphar/common/analysis/subgraph_codegen_stats.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
 #include "core/providers/nuphar/compiler/initializer_info.h"
 #include "core/providers/nuphar/nuphar_execution_provider.h"
 #include "core/providers/nuphar/partition/subgraph_partitioner.h"
 #include "core/providers/nuphar/runtime/sequential/basic.h"
 #include "core/providers/nuphar/runtime/sequential/loop.h"
+#include "core/session/inference_session.h"
 
 namespace onnxruntime {
 namespace nuphar {
@@ -34,7 +38,49 @@ NupharKernelState::NupharKernelState(
       subgraphs,
       [&](const std::string& name) { return provider_.GetConstantInitializer(name); });
 
+  codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.OptionMatches(kNupharBackgroundCompile, "on")) {
+    Status s = CreateFallbackSession(node);
+    if (s.IsOK()) {
+      subgraphs_ = std::move(subgraphs);
+      compile_thread_ = std::thread([this, name = node.Name()]() {
+        // compile one fused node at a time, the way the synchronous compile does
+        static OrtMutex background_compile_mutex;
+        std::lock_guard<OrtMutex> lock(background_compile_mutex);
+        try {
+          CompileSubgraphs(subgraphs_);
+        } catch (const std::exception& ex) {
+          codegen_status_ = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+        }
+
+        if (cancel_compile_) {
+          return;
+        }
+
+        if (codegen_status_.IsOK()) {
+          compiled_.store(true, std::memory_order_release);
+        } else {
+          LOGS_DEFAULT(WARNING) << "Nuphar failed to compile " << name
+                                << ", it keeps running on CPU kernels: " << codegen_status_.ErrorMessage();
+        }
+      });
+      return;
+    }
+
+    LOGS_DEFAULT(WARNING) << "Nuphar compiles " << node.Name()
+                          << " synchronously, as it could not run on CPU kernels: " << s.ErrorMessage();
+    fallback_session_.reset();
+  }
+
+  CompileSubgraphs(subgraphs);
+}
+
+void NupharKernelState::CompileSubgraphs(const std::vector<NupharSubgraphUnit>& subgraphs) {
   for (auto& subgraph : subgraphs) {
+    if (cancel_compile_) {
+      return;
+    }
+
     Compile(subgraph);
     if (!codegen_status_.IsOK()) {
       return;  // early return
@@ -46,6 +92,39 @@ NupharKernelState::NupharKernelState(
   BuildExecBlocksAndCalls(subgraphs);
 }
 
+Status NupharKernelState::CreateFallbackSession(const Node& fused_node) {
+  const auto* func_body = fused_node.GetFunctionBody();
+  if (func_body == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Function body is empty");
+  }
+
+  // Reconstruct the model of the fused node's function body
+  const Graph& graph_body = func_body->Body();
+  Model model(graph_body.Name(), true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              graph_body.DomainToVersionMap());
+  ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
+  *(model_proto.mutable_graph()) = graph_body.ToGraphProto();
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  std::string model_data;
+  model_proto.SerializeToString(&model_data);
+
+  // No provider is registered, so the session runs on the CPU execution provider
+  SessionOptions so;
+  so.session_logid = "NupharFallback_" + fused_node.Name();
+  fallback_session_ = std::make_unique<InferenceSession>(so);
+  ORT_RETURN_IF_ERROR(fallback_session_->Load(model_data.data(), static_cast<int>(model_data.size())));
+  ORT_RETURN_IF_ERROR(fallback_session_->Initialize());
+
+  for (const auto* def : fused_node.InputDefs()) {
+    const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+    fallback_feed_names_.push_back(graph_body.GetInitializedTensor(def->Name(), initializer) ? "" : def->Name());
+  }
+  for (const auto* def : fused_node.OutputDefs()) {
+    fallback_output_names_.push_back(def->Name());
+  }
+  return Status::OK();
+}
+
 void NupharKernelState::Compile(const NupharSubgraphUnit& subgraph) {
   // TODO: rename tvm_target to a proper name
   auto tvm_target = provider_.GetTVMTarget();
@@ -82,11 +161,48 @@ void NupharKernelState::BuildExecBlocksAndCalls(const std::vector<NupharSubgraph
 }
 
 NupharKernelState::~NupharKernelState() {
+  if (compile_thread_.joinable()) {
+    // the subgraph being compiled is finished, the rest are skipped
+    cancel_compile_ = true;
+    compile_thread_.join();
+  }
+
   if (nullptr != nuphar_compute_ctx_map_)
     nuphar_compute_ctx_map_->erase(this);
 }
 
+Status NupharKernelState::ComputeFallback(OpKernelContext* op_kernel_context) const {
+  NameMLValMap feeds;
+  for (int i = 0; i < op_kernel_context->InputCount(); ++i) {
+    if (fallback_feed_names_[i].empty()) {
+      continue;
+    }
+
+    // feed the input without copying it, its OrtValue outlives the run
+    const Tensor* input = op_kernel_context->Input<Tensor>(i);
+    OrtValue feed;
+    feed.Init(const_cast<Tensor*>(input), DataTypeImpl::GetType<Tensor>(), [](void*) {});
+    feeds.emplace(fallback_feed_names_[i], feed);
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(fallback_session_->Run(RunOptions(), feeds, fallback_output_names_, &fetches));
+
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    const Tensor& fetch = fetches[i].Get<Tensor>();
+    Tensor* output = op_kernel_context->Output(static_cast<int>(i), fetch.Shape());
+    ORT_RETURN_IF_NOT(output != nullptr, "Failed to get output ", i, " of ", fallback_output_names_[i]);
+    memcpy(output->MutableDataRaw(), fetch.DataRaw(), fetch.SizeInBytes());
+  }
+
+  return Status::OK();
+}
+
 Status NupharKernelState::Compute(OpKernelContext* op_kernel_context) const {
+  if (fallback_session_ != nullptr && !compiled_.load(std::memory_order_acquire)) {
+    return ComputeFallback(op_kernel_context);
+  }
+
   if (!codegen_status_.IsOK()) {
     return codegen_status_;
   }
@@ -14,11 +14,14 @@
 
 #include <tvm/build_module.h>
 
+#include <atomic>
 #include <map>
+#include <thread>
 #include <unordered_map>
 
 namespace onnxruntime {
 
+class InferenceSession;
 class NupharExecutionProvider;
 
 namespace nuphar {
@@ -43,6 +46,14 @@ class NupharKernelState {
   void BuildExecBlocksAndCalls(const std::vector<NupharSubgraphUnit>& subgraphs);
 
  private:
+  // Compile the subgraphs and build the ExecBlocks, stopping at the first codegen failure
+  void CompileSubgraphs(const std::vector<NupharSubgraphUnit>& subgraphs);
+
+  // Create a session running the function body of the fused node on CPU kernels
+  Status CreateFallbackSession(const Node& fused_node);
+
+  Status ComputeFallback(OpKernelContext* op_kernel_context) const;
+
   const NupharExecutionProvider& provider_;
 
   // A owner of generated Tensor for weight layout for now
@@ -67,6 +78,18 @@ class NupharKernelState {
   // Here ComputeContext of Ort is used for allocator
   ComputeContext ctx_;  // the compute context from IExecutionProvider::Compile interface
 
+  // With background compile, the partitioned subgraphs are compiled by compile_thread_,
+  // and Compute runs fallback_session_ until compiled_ is set.
+  // A codegen failure leaves compiled_ unset, so that the fallback keeps running.
+  std::vector<NupharSubgraphUnit> subgraphs_;
+  std::unique_ptr<InferenceSession> fallback_session_;
+  // fallback_session_ feeds of the fused node inputs, empty for the initializers of the function body
+  std::vector<std::string> fallback_feed_names_;
+  std::vector<std::string> fallback_output_names_;
+  std::atomic<bool> compiled_{false};
+  std::atomic<bool> cancel_compile_{false};
+  std::thread compile_thread_;
+
   static thread_local std::unique_ptr<NupharFuncStateToComputeCtxMap> nuphar_compute_ctx_map_;
 };
 
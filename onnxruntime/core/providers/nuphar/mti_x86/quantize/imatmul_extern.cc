@@ -7,6 +7,7 @@
 #include "core/codegen/mti/mti_tvm_utils.h"
 #include "core/providers/nuphar/extern/igemv_mkl.h"
 #include "core/providers/nuphar/extern/igemv_avx2.h"
+#include "core/mlas/inc/mlas.h"
 #include <topi/detail/extern.h>
 
 namespace onnxruntime {
@@ -75,6 +76,35 @@ TVM_REGISTER_GLOBAL("tvm.contrib.onnxruntime.imatmul.extern.avx2")
     });
 #endif
 
+// MLAS picks its AVX512VNNI, AVX512BW or AVX2 U8S8 kernel from the CPU it runs on
+TVM_REGISTER_GLOBAL("tvm.contrib.onnxruntime.imatmul.extern.mlas")
+    .set_body([](tvm::TVMArgs args, tvm::TVMRetValue* /*ret*/) {
+      DLTensor* B = args[0];
+      DLTensor* A = args[1];
+      DLTensor* batch_seq_tensor = args[2];
+      DLTensor* Y = args[3];
+      int input_dim = args[4];
+      int embed_dim = args[5];
+
+      DCHECK(B->strides == nullptr);
+      DCHECK(A->strides == nullptr);
+      DCHECK(Y->strides == nullptr);
+
+      auto B_data = reinterpret_cast<int8_t*>(static_cast<char*>(B->data) + B->byte_offset);
+      auto A_data = reinterpret_cast<uint8_t*>(static_cast<char*>(A->data) + A->byte_offset);
+      auto Y_data = reinterpret_cast<int32_t*>(static_cast<char*>(Y->data) + Y->byte_offset);
+      auto batch_seq = *reinterpret_cast<int*>(static_cast<char*>(batch_seq_tensor->data) + batch_seq_tensor->byte_offset);
+
+      if (batch_seq == 0)
+        return;
+
+      MlasGemm(batch_seq, embed_dim, input_dim,
+               A_data, input_dim, 0,
+               B_data, embed_dim, 0,
+               Y_data, embed_dim,
+               nullptr);
+    });
+
 tvm::Tensor
 IMatMulExternMKL(const tvm::Tensor& B,
                  const tvm::Tensor& A,
@@ -139,5 +169,32 @@ IMatMulExternAVX2(const tvm::Tensor& B,
 #endif
 }
 
+tvm::Tensor
+IMatMulExternMLAS(const tvm::Tensor& B,
+                  const tvm::Tensor& A,
+                  const tvm::Array<tvm::Expr>& output_shape,
+                  int input_dim,
+                  int embed_dim,
+                  const std::string& name) {
+  tvm::Expr batch_seq_dim = tvm_codegen::SizeToDimension(output_shape, -1);
+
+  std::string func_str = "tvm.contrib.onnxruntime.imatmul.extern.mlas";
+
+  return topi::detail::make_extern(
+      {output_shape}, {tvm::Int(32)},
+      tvm_codegen::MakeInputsForExtern(
+          {B, A, tvm_codegen::Promote(batch_seq_dim, {16}, name + "_batch_seq")}),
+      [&](tvm::Array<tvm::Buffer> ins, tvm::Array<tvm::Buffer> outs) {
+        return topi::detail::call_packed({tvm::Expr(func_str),
+                                          topi::detail::pack_buffer(ins[0]),
+                                          topi::detail::pack_buffer(ins[1]),
+                                          topi::detail::pack_buffer(ins[2]),
+                                          topi::detail::pack_buffer(outs[0]),
+                                          input_dim,
+                                          embed_dim});
+      },
+      name, "", {})[0];
+}
+
 }  // namespace nuphar
 }  // namespace onnxruntime
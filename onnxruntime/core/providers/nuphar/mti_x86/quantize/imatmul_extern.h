@@ -25,5 +25,14 @@ IMatMulExternMKL(const tvm::Tensor& transposed_quantized_param,
                  int embed_dim,
                  const std::string& name = "IMatMulExternMKL");
 
+// Unlike the externs above, the quantized param is not transposed, as MLAS takes B of input_dim x embed_dim
+tvm::Tensor
+IMatMulExternMLAS(const tvm::Tensor& quantized_param,
+                  const tvm::Tensor& Q_X,
+                  const tvm::Array<tvm::Expr>& output_shape,
+                  int input_dim,
+                  int embed_dim,
+                  const std::string& name = "IMatMulExternMLAS");
+
 }  // namespace nuphar
 }  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #include "core/framework/func_api.h"
 #include "core/framework/func_kernel.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/tensor.h"
 #include "gsl/gsl_util"
 
@@ -133,6 +134,11 @@ class KernelComputeCtx {
     return handle_;
   }
 
+  // intra-op thread pool of the session, nullptr when the session runs single threaded
+  inline concurrency::ThreadPool* GetThreadPool() const {
+    return static_cast<OpKernelContextInternal*>(op_kernel_ctx_)->GetOperatorThreadPool();
+  }
+
   inline std::unordered_map<std::string, int64_t>& GetRealizedDims() {
     return realized_dims_;
   }
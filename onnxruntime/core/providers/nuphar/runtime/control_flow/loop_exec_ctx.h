@@ -5,6 +5,10 @@
 #include "core/providers/nuphar/compiler/func_info.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace nuphar {
 
 class KernelComputeCtx;
@@ -26,6 +30,15 @@ class LoopExecCtx {
   virtual void LoopFinalizer() = 0;
   // Marching to next loop iteration
   virtual void Advance(const ControlFlowInfo* cf_info) = 0;
+  // Runs the current iteration in slices of the batch on tp, with at least min_rows_per_slice rows per slice.
+  // Returns false, without running anything, when the iteration should run as a whole instead.
+  virtual bool RunIterationInBatchSlices(KernelComputeCtx* compute_ctx,
+                                         const NupharFuncInfo* func_info,
+                                         int64_t min_rows_per_slice,
+                                         concurrency::ThreadPool* tp) {
+    return false;
+  }
+
   virtual bool IsValid() {
     return current_loop_step_ < max_loop_step_;
   }
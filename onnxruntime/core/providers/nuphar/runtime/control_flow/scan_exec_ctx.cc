@@ -9,8 +9,10 @@
 #include "core/providers/nuphar/runtime/compute_ctx.h"
 #include "core/providers/nuphar/runtime/utils.h"
 
+#include "core/platform/threadpool.h"
 #include "gsl/gsl_util"
 #include <tvm/tvm.h>
+#include <algorithm>
 
 namespace onnxruntime {
 namespace nuphar {
@@ -323,6 +325,8 @@ void ScanExecCtx::InitContext(KernelComputeCtx* kernel_compute_ctx,
                                        data_type);
     state_bytes_size_[ort_state_idx] = BytesOfShape(dl_output_shapes[tvm_output_idx], data_type);
   }
+
+  InitBatchPartition(func_info, subgraph_compute_ctx);
 }
 
 // UpdateContext is for an existing KernelComputeCtx, and only needs to update non-initializer input/output
@@ -520,6 +524,141 @@ void ScanExecCtx::UpdateContext(KernelComputeCtx* kernel_compute_ctx,
                                        data_type);
     state_bytes_size_[ort_state_idx] = BytesOfShape(dl_output_shapes[tvm_output_idx], data_type);
   }
+
+  InitBatchPartition(func_info, subgraph_compute_ctx);
+}
+
+void ScanExecCtx::InitBatchPartition(const NupharFuncInfo* func_info,
+                                     const FuncComputeCtx& subgraph_compute_ctx) {
+  batch_size_ = 0;
+  batch_slices_.clear();
+
+  const ScanExecInfo* scan_info = Promote<ScanExecInfo>(func_info->cf_info.get());
+  ORT_ENFORCE_DEBUG(nullptr != scan_info);
+  int num_state_variables = gsl::narrow<int>(scan_info->num_state_variables);
+  int num_states_and_scan_inputs = gsl::narrow<int>(scan_info->num_state_variables + scan_info->num_scan_inputs);
+
+  // the batch dim is the leading symbolic dim of the first scan input
+  const std::string* batch_symbol = nullptr;
+  size_t batch_tvm_idx = 0;
+  for (const auto& input_meta : func_info->input_metas) {
+    if (input_meta.ort_arg_index >= num_state_variables && input_meta.ort_arg_index < num_states_and_scan_inputs) {
+      for (const auto& s_pair : input_meta.dim_symbols) {
+        if (s_pair.first == 0)
+          batch_symbol = &s_pair.second;
+      }
+      break;
+    }
+    ++batch_tvm_idx;
+  }
+
+  if (nullptr == batch_symbol)
+    return;
+
+  // 1 when the arg leads with the batch dim, 0 when it doesn't have it, and -1 when it has it elsewhere
+  auto batch_dim_of = [batch_symbol](const NupharFuncInfo::FuncArgMeta& meta) {
+    int result = 0;
+    for (const auto& s_pair : meta.dim_symbols) {
+      if (s_pair.second == *batch_symbol) {
+        if (s_pair.first != 0)
+          return -1;
+        result = 1;
+      }
+    }
+    return result;
+  };
+
+  const std::vector<DLTensor>& dl_tensors = subgraph_compute_ctx.dl_tensors;
+  batch_args_.assign(dl_tensors.size(), false);
+  batch_row_bytes_.assign(dl_tensors.size(), 0);
+  auto set_batch_arg = [&](size_t tvm_idx, MLDataType data_type) {
+    const DLTensor& dl_tensor = dl_tensors[tvm_idx];
+    batch_args_[tvm_idx] = true;
+    batch_row_bytes_[tvm_idx] = BytesOfShape(dl_tensor.shape + 1, gsl::narrow<size_t>(dl_tensor.ndim - 1), data_type);
+  };
+
+  // states and scan inputs must have the batch dim, while implicit inputs may be shared by the batch
+  size_t tvm_input_idx = 0;
+  for (const auto& input_meta : func_info->input_metas) {
+    int batch_dim = batch_dim_of(input_meta);
+    bool is_implicit_input = input_meta.ort_arg_index >= num_states_and_scan_inputs;
+    if (batch_dim < 0 || (batch_dim == 0 && !is_implicit_input))
+      return;
+    if (batch_dim > 0)
+      set_batch_arg(tvm_input_idx, input_meta.dtype);
+    ++tvm_input_idx;
+  }
+
+  // initializers have no symbolic dims, and every output must have the batch dim
+  size_t tvm_output_idx = func_info->func_input_count;
+  for (const auto& output_meta : func_info->output_metas) {
+    if (batch_dim_of(output_meta) <= 0)
+      return;
+    set_batch_arg(tvm_output_idx, output_meta.dtype);
+    ++tvm_output_idx;
+  }
+
+  batch_size_ = dl_tensors[batch_tvm_idx].shape[0];
+}
+
+bool ScanExecCtx::RunIterationInBatchSlices(KernelComputeCtx* kernel_compute_ctx,
+                                            const NupharFuncInfo* func_info,
+                                            int64_t min_rows_per_slice,
+                                            concurrency::ThreadPool* tp) {
+  if (nullptr == tp || min_rows_per_slice <= 0)
+    return false;
+
+  int64_t num_slices = std::min(batch_size_ / min_rows_per_slice, static_cast<int64_t>(tp->NumThreads()) + 1);
+  if (num_slices < 2)
+    return false;
+
+  FuncComputeCtx& subgraph_compute_ctx = kernel_compute_ctx->GetFuncComputeCtx(func_info);
+  const std::vector<DLTensor>& dl_tensors = subgraph_compute_ctx.dl_tensors;
+  size_t num_args = dl_tensors.size();
+
+  // The slices keep their shapes for the whole loop, so only the data ptrs change from an iteration to the next.
+  // Note the vectors of a slice are sized before taking ptrs to them.
+  if (batch_slices_.size() != gsl::narrow<size_t>(num_slices)) {
+    batch_slices_.clear();
+    batch_slices_.resize(gsl::narrow<size_t>(num_slices));
+    for (int64_t slice_idx = 0; slice_idx < num_slices; ++slice_idx) {
+      BatchSlice& slice = batch_slices_[slice_idx];
+      slice.begin = batch_size_ * slice_idx / num_slices;
+      int64_t rows = batch_size_ * (slice_idx + 1) / num_slices - slice.begin;
+      slice.dl_tensors = dl_tensors;
+      slice.lvalues.resize(num_args);
+      slice.shapes.resize(num_args);
+      for (size_t arg_idx = 0; arg_idx < num_args; ++arg_idx) {
+        DLTensor& dl_tensor = slice.dl_tensors[arg_idx];
+        if (batch_args_[arg_idx]) {
+          std::vector<int64_t>& shape = slice.shapes[arg_idx];
+          shape.assign(dl_tensor.shape, dl_tensor.shape + dl_tensor.ndim);
+          shape[0] = rows;
+          dl_tensor.shape = shape.data();
+        }
+        slice.lvalues[arg_idx].v_handle = &dl_tensor;
+      }
+    }
+  }
+
+  // each slice is a contiguous block of rows of every batch arg, as the args are compact
+  tp->ParallelFor(gsl::narrow<int32_t>(num_slices), [&](int32_t slice_idx) {
+    BatchSlice& slice = batch_slices_[slice_idx];
+    for (size_t arg_idx = 0; arg_idx < num_args; ++arg_idx) {
+      slice.dl_tensors[arg_idx].data =
+          batch_args_[arg_idx]
+              ? static_cast<char*>(dl_tensors[arg_idx].data) + slice.begin * batch_row_bytes_[arg_idx]
+              : dl_tensors[arg_idx].data;
+    }
+
+    tvm::TVMArgs tvm_args(slice.lvalues.data(),
+                          func_info->type_codes.data(),
+                          gsl::narrow<int>(num_args));
+    tvm::TVMRetValue rvalue;
+    func_info->packed_func.CallPacked(tvm_args, &rvalue);
+  });
+
+  return true;
 }
 
 void ScanExecCtx::LoopFinalizer() {
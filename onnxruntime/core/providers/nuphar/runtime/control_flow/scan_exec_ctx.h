@@ -8,6 +8,8 @@
 namespace onnxruntime {
 namespace nuphar {
 
+struct FuncComputeCtx;
+
 // Note ScanExecInfo have all ort related meta data
 struct ScanExecInfo : ControlFlowInfo {
   std::vector<bool> scan_input_forwards;
@@ -29,7 +31,7 @@ struct ScanExecInfo : ControlFlowInfo {
 
 class ScanExecCtx final : public LoopExecCtx {
  public:
-  ScanExecCtx() : seq_length_(0) {
+  ScanExecCtx() : seq_length_(0), batch_size_(0) {
   }
 
   void InitContext(KernelComputeCtx* compute_ctx,
@@ -42,7 +44,23 @@ class ScanExecCtx final : public LoopExecCtx {
   void LoopFinalizer() override;
   void Advance(const ControlFlowInfo* cf_info) override;
 
+  bool RunIterationInBatchSlices(KernelComputeCtx* compute_ctx,
+                                 const NupharFuncInfo* func_info,
+                                 int64_t min_rows_per_slice,
+                                 concurrency::ThreadPool* tp) override;
+
  private:
+  // Finds the func args sharing the leading batch dim, after InitContext or UpdateContext
+  void InitBatchPartition(const NupharFuncInfo* func_info, const FuncComputeCtx& subgraph_compute_ctx);
+
+  // The args of the func for the rows [begin, end) of the batch
+  struct BatchSlice {
+    int64_t begin;
+    std::vector<DLTensor> dl_tensors;
+    std::vector<TVMValue> lvalues;
+    std::vector<std::vector<int64_t>> shapes;
+  };
+
   // Current input/output holds the current ptr of Scan, not PackedFunc
   std::vector<void*> current_input_ptrs_;
   std::vector<void*> current_output_ptrs_;
@@ -80,7 +98,15 @@ class ScanExecCtx final : public LoopExecCtx {
 
   int64_t seq_length_;
 
-  ;
+  // Batch partitioning
+  // The rows of the batch are independent when every state, scan input and output leads with the batch dim,
+  // and no other arg has it. batch_size_ is 0 when the func can't run in slices of the batch.
+  int64_t batch_size_;
+  // whether each func arg has the batch dim, and the bytes of one of its rows
+  std::vector<bool> batch_args_;
+  std::vector<int64_t> batch_row_bytes_;
+  // created at the first sliced iteration, reset when the context is updated
+  std::vector<BatchSlice> batch_slices_;
 };
 
 }  // namespace nuphar
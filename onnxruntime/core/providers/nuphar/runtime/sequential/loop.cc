@@ -4,6 +4,8 @@
 #include "core/providers/nuphar/runtime/sequential/loop.h"
 #include "core/providers/nuphar/runtime/control_flow/loop_exec_ctx.h"
 #include "core/codegen/common/profile.h"
+#include "core/codegen/common/settings.h"
+#include "core/providers/nuphar/common/nuphar_settings.h"
 
 // TODO: refactor it
 #include "core/providers/nuphar/runtime/control_flow/scan_exec_ctx.h"
@@ -12,7 +14,12 @@ namespace onnxruntime {
 namespace nuphar {
 
 LoopExecBlock::LoopExecBlock(const NupharFuncInfo* func_info, const std::string& name)
-    : ExecBlock(func_info, name, "LoopExecBlock") {}
+    : ExecBlock(func_info, name, "LoopExecBlock"), min_rows_per_slice_(0) {
+  const codegen::CodeGenSettings& settings = codegen::CodeGenSettings::Instance();
+  if (settings.HasOption(kNupharParallelScanBatch)) {
+    min_rows_per_slice_ = std::stoll(settings.GetOptionValue(kNupharParallelScanBatch));
+  }
+}
 
 void LoopExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
   if (!kernel_compute_ctx->IsInitialized(func_info_)) {
@@ -33,7 +40,10 @@ void LoopExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
                         num_func_args);
   tvm::TVMRetValue rvalue;
 
+  concurrency::ThreadPool* tp = min_rows_per_slice_ > 0 ? kernel_compute_ctx->GetThreadPool() : nullptr;
+
   // Do it sequentially sicne it is a sequential ExecBlock
+  // Only the rows of the batch of an iteration may run in parallel on the thread pool
   while (subgraph_compute_ctx.loop_cf_ctx->IsValid()) {
     // Note InitIteration would change values of std::vector<DLTensor> and std::vector<TVMValue>, not ptr.
     subgraph_compute_ctx.loop_cf_ctx->InitIteration(kernel_compute_ctx, func_info_);
@@ -41,7 +51,10 @@ void LoopExecBlock::Run(KernelComputeCtx* kernel_compute_ctx) {
     // Profiling event (no op for non-profiling build)
     CODEGEN_PROFILER_EVENT(func_info_->name);
 
-    func.CallPacked(tvm_args, &rvalue);
+    if (!subgraph_compute_ctx.loop_cf_ctx->RunIterationInBatchSlices(kernel_compute_ctx, func_info_,
+                                                                     min_rows_per_slice_, tp)) {
+      func.CallPacked(tvm_args, &rvalue);
+    }
 
     subgraph_compute_ctx.loop_cf_ctx->Advance(func_info_->cf_info.get());
   }
@@ -23,6 +23,9 @@ class LoopExecBlock : public ExecBlock {
   void UpdateContext(KernelComputeCtx* compute_ctx) const override;
 
  private:
+  // minimal rows of the batch per slice running on the thread pool, 0 when iterations run as a whole
+  int64_t min_rows_per_slice_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(LoopExecBlock);
 };
 
@@ -26,8 +26,11 @@ namespace onnxruntime {
 constexpr const char* OpenVINO = "OpenVINO";
 
 OpenVINOExecutionProvider::OpenVINOExecutionProvider(OpenVINOExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kOpenVINOExecutionProvider} {
-  ORT_UNUSED_PARAMETER(info);
+    : IExecutionProvider{onnxruntime::kOpenVINOExecutionProvider}, info_(info) {
+  const char* num_infer_requests_env = getenv("ORT_OPENVINO_NUM_INFER_REQUESTS");
+  if (num_infer_requests_env) {
+    info_.num_infer_requests = static_cast<size_t>(std::max(1, atoi(num_infer_requests_env)));
+  }
 
   DeviceAllocatorRegistrationInfo device_info({OrtMemTypeDefault, [](int) { return std::make_unique<CPUAllocator>(std::make_unique<OrtMemoryInfo>(OPENVINO, OrtDeviceAllocator)); }, std::numeric_limits<size_t>::max()});
   InsertAllocator(CreateAllocator(device_info));
@@ -483,13 +486,32 @@ std::vector<std::unique_ptr<ComputeCapability>> OpenVINOExecutionProvider::GetCa
 
   std::string xml_string, weights_string;
 
-  // Try converting with OpenVINO's Model Optimizer
-  try {
-    openvino_ep::OpenVINOGraph::ConvertONNXModelToOpenVINOIR(model_proto_strbuf, xml_string, weights_string, precision_fp32);
-  } catch (const char* msg) {
-    // Model Optimizer cannot convert this model.
-    LOGS_DEFAULT(WARNING) << openvino_ep::OpenVINOGraph::log_tag << "Rejecting as Model Optimizer cannot convert this model." << msg;
-    return result;
+  // The IR converted for the same subgraph and precision by an earlier session is reused
+  const std::string cache_dir = openvino_ep::OpenVINOGraph::GetCacheDir();
+  std::string ir_path;
+  if (!cache_dir.empty()) {
+    ir_path = cache_dir + "/" +
+              openvino_ep::OpenVINOGraph::GetCacheKey(device_id + (precision_fp32 ? "_FP32" : "_FP16"),
+                                                      model_proto_strbuf, std::string());
+  }
+
+  if (ir_path.empty() ||
+      !openvino_ep::OpenVINOGraph::ReadCacheFile(ir_path + ".xml", xml_string) ||
+      !openvino_ep::OpenVINOGraph::ReadCacheFile(ir_path + ".bin", weights_string)) {
+    // Try converting with OpenVINO's Model Optimizer
+    try {
+      openvino_ep::OpenVINOGraph::ConvertONNXModelToOpenVINOIR(model_proto_strbuf, xml_string, weights_string, precision_fp32);
+    } catch (const char* msg) {
+      // Model Optimizer cannot convert this model.
+      LOGS_DEFAULT(WARNING) << openvino_ep::OpenVINOGraph::log_tag << "Rejecting as Model Optimizer cannot convert this model." << msg;
+      return result;
+    }
+
+    if (!ir_path.empty()) {
+      // the weights are written first, so that a cached xml always has its weights
+      openvino_ep::OpenVINOGraph::WriteCacheFile(ir_path + ".bin", weights_string);
+      openvino_ep::OpenVINOGraph::WriteCacheFile(ir_path + ".xml", xml_string);
+    }
   }
 
   auto node_indexes = graph_viewer.GetNodesInTopologicalOrder();
@@ -554,7 +576,7 @@ common::Status OpenVINOExecutionProvider::Compile(
   for (auto fused_node : fused_nodes) {
     std::shared_ptr<openvino_ep::OpenVINOGraph> openvino_graph;
     try {
-      openvino_graph = std::make_shared<openvino_ep::OpenVINOGraph>(fused_node);
+      openvino_graph = std::make_shared<openvino_ep::OpenVINOGraph>(fused_node, info_.num_infer_requests);
 
     } catch (const char* msg) {
       LOGS_DEFAULT(ERROR) << openvino_ep::OpenVINOGraph::log_tag << "Compilation error: " << msg;
@@ -17,6 +17,10 @@ constexpr const char* OPENVINO = "OpenVINO";
 // Information needed to construct OpenVINO execution providers.
 struct OpenVINOExecutionProviderInfo {
   const char* device{"CPU_FP32"};
+  // Infer requests created for each compiled network, which concurrent Runs and the slices of a batch run on
+  // in parallel. On CPU, as many throughput streams are set. 0 is 8 on VAD-M (HDDL) and 1 otherwise.
+  // The ORT_OPENVINO_NUM_INFER_REQUESTS environment variable overrides it.
+  size_t num_infer_requests{0};
 
   explicit OpenVINOExecutionProviderInfo(const char* dev) : device(dev) {
   }
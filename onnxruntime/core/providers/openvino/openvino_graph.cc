@@ -1,13 +1,17 @@
 // Copyright(C) 2019 Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <map>
 #include <string>
 #include <memory>
 #include <cstdlib>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <iterator>
 #include <Python.h>
 
 #include <inference_engine.hpp>
@@ -32,7 +36,7 @@ namespace openvino_ep {
 
 const std::string OpenVINOGraph::log_tag = "[OpenVINO-EP] ";
 
-OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
+OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node, size_t num_infer_requests) {
   device_id_ = "CPU";
   precision_ = InferenceEngine::Precision::FP32;
   std::string precision_str = "FP32";
@@ -73,9 +77,12 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   // Infer Requests hold resources representing the entire network on their target hardware. So,
   // having more Infer Requests than needed would waste system resources.
   // In VAD-M (HDDL) accelerator, there are 8 parallel execution units. So, creating 8 instances
-  // of Infer Requests only if the VAD-M accelerator is being used.
+  // of Infer Requests by default only if the VAD-M accelerator is being used.
   // sets number of maximum parallel inferences
-  num_inf_reqs_ = (device_id_ == "HDDL") ? 8 : 1;
+  num_inf_reqs_ = num_infer_requests;
+  if (num_inf_reqs_ == 0) {
+    num_inf_reqs_ = (device_id_ == "HDDL") ? 8 : 1;
+  }
 
   fused_node_ = fused_node;
 
@@ -109,20 +116,99 @@ OpenVINOGraph::OpenVINOGraph(const onnxruntime::Node* fused_node) {
   
 
    plugin_ = InferenceEngine::PluginDispatcher().getPluginByDevice(device_id_);
-  //Loading model to the plugin
-  InferenceEngine::ExecutableNetwork exeNetwork = plugin_.LoadNetwork(*openvino_network_, {});
+  // On CPU, the infer requests run in parallel on as many throughput streams
+  std::map<std::string, std::string> config;
+  if (device_id_ == "CPU" && num_inf_reqs_ > 1) {
+    config[CONFIG_KEY(CPU_THROUGHPUT_STREAMS)] = std::to_string(num_inf_reqs_);
+  }
 
-  LOGS_DEFAULT(INFO) << log_tag << "Network loaded into accelerator plug-in succesfully";
+  // Compiling for the VPUs takes the longest, and their plug-ins can export the compiled network
+  const std::string cache_dir = GetCacheDir();
+  std::string blob_path;
+  if (!cache_dir.empty() && (device_id_ == "MYRIAD" || device_id_ == "HDDL")) {
+    const auto& attributes = fused_node_->GetAttributes();
+    blob_path = cache_dir + "/" +
+                GetCacheKey(device_id_, attributes.at("xml_str").s(), attributes.at("weights_str").s()) + ".blob";
+  }
+
+  InferenceEngine::ExecutableNetwork exeNetwork;
+  bool imported = false;
+  if (!blob_path.empty() && std::ifstream(blob_path).good()) {
+    try {
+      exeNetwork = plugin_.ImportNetwork(blob_path, config);
+      imported = true;
+      LOGS_DEFAULT(INFO) << log_tag << "Compiled network imported from " << blob_path;
+    } catch (const std::exception& e) {
+      LOGS_DEFAULT(WARNING) << log_tag << "Failed to import the compiled network " << blob_path << ": " << e.what();
+    }
+  }
+
+  if (!imported) {
+    //Loading model to the plugin
+    exeNetwork = plugin_.LoadNetwork(*openvino_network_, config);
+
+    LOGS_DEFAULT(INFO) << log_tag << "Network loaded into accelerator plug-in succesfully";
+
+    if (!blob_path.empty()) {
+      const std::string temp_path = blob_path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(this));
+      try {
+        exeNetwork.Export(temp_path);
+        std::rename(temp_path.c_str(), blob_path.c_str());
+      } catch (const std::exception& e) {
+        LOGS_DEFAULT(WARNING) << log_tag << "Failed to export the compiled network " << blob_path << ": " << e.what();
+      }
+      std::remove(temp_path.c_str());
+    }
+  }
 
   //Create infer request
   for (size_t i = 0; i < num_inf_reqs_; i++) {
     auto infRequest = exeNetwork.CreateInferRequestPtr();
 
-    infer_requests_.push_back(infRequest);
+    free_infer_requests_.push_back(infRequest);
   }
   LOGS_DEFAULT(INFO) << log_tag << "Infer requests created: " << num_inf_reqs_;
 }
 
+std::string OpenVINOGraph::GetCacheDir() {
+  const char* cache_dir = std::getenv("ORT_OPENVINO_CACHE_DIR");
+  return cache_dir ? std::string(cache_dir) : std::string();
+}
+
+std::string OpenVINOGraph::GetCacheKey(const std::string& device_id, const std::string& first,
+                                       const std::string& second) {
+  std::hash<std::string> hash;
+  return device_id + "_" + std::to_string(hash(first)) + "_" + std::to_string(hash(second)) + "_" +
+         std::to_string(first.size() + second.size());
+}
+
+bool OpenVINOGraph::ReadCacheFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+void OpenVINOGraph::WriteCacheFile(const std::string& path, const std::string& contents) {
+  const std::string temp_path = path + ".tmp" + std::to_string(reinterpret_cast<uintptr_t>(&contents));
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    if (!file) {
+      LOGS_DEFAULT(WARNING) << log_tag << "Failed to write the cache file " << path;
+      file.close();
+      std::remove(temp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    // another session cached the same file first
+    std::remove(temp_path.c_str());
+  }
+}
+
 std::vector<std::string> OpenVINOGraph::GetEnvLdLibraryPath() const {
   std::string plugin_path = std::getenv("LD_LIBRARY_PATH");
   std::vector<std::string> paths;
@@ -333,11 +419,10 @@ size_t OpenVINOGraph::DeduceBatchSize(Ort::CustomOpApi ort, const OrtValue* inpu
 }
 
 // Starts an asynchronous inference request for data in slice indexed by batch_slice_idx on
-// an Infer Request indexed by infer_req_idx
+// an Infer Request
 void OpenVINOGraph::StartAsyncInference(Ort::CustomOpApi ort, std::vector<const OrtValue*> input_tensors,
                                         size_t batch_slice_idx,
-                                        size_t infer_req_idx) {
-  auto infer_request = infer_requests_[infer_req_idx];
+                                        InferenceEngine::InferRequest::Ptr infer_request) {
   auto graph_input_info = openvino_network_->getInputsInfo();
 
   size_t i = 0;
@@ -360,12 +445,11 @@ void OpenVINOGraph::StartAsyncInference(Ort::CustomOpApi ort, std::vector<const
   infer_request->StartAsync();
 }
 
-// Wait for asynchronous inference completion on an Infer Request object indexed by infer_req_idx
+// Wait for asynchronous inference completion on an Infer Request object
 // and copy the results into a slice location within the batched output buffer indexed by batch_slice_idx
 void OpenVINOGraph::CompleteAsyncInference(Ort::CustomOpApi ort, std::vector<OrtValue*> output_tensors,
                                            size_t batch_slice_idx,
-                                           size_t infer_req_idx) {
-  auto infer_request = infer_requests_[infer_req_idx];
+                                           InferenceEngine::InferRequest::Ptr infer_request) {
 
   // Wait for Async inference completion
   infer_request->Wait(InferenceEngine::IInferRequest::WaitMode::RESULT_READY);
@@ -398,13 +482,13 @@ std::vector<const OrtValue*> OpenVINOGraph::GetInputTensors(Ort::CustomOpApi ort
   return input_tensors;
 }
 
-std::vector<OrtValue*> OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, size_t batch_size) {
+std::vector<OrtValue*> OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, size_t batch_size,
+                                                       InferenceEngine::InferRequest::Ptr infer_request) {
   std::vector<OrtValue*> output_tensors;
   auto graph_output_info = openvino_network_->getOutputsInfo();
 
   // All infer_requests process identical tensor slices from the batch.
-  // So using info from first infer_request to allocate all output tensors.
-  auto infer_request = infer_requests_[0];
+  // So using info from one of the Run's infer_requests to allocate all output tensors.
 
   size_t i = 0;
   for (auto output_info_iter = graph_output_info.begin();
@@ -429,11 +513,27 @@ std::vector<OrtValue*> OpenVINOGraph::GetOutputTensors(Ort::CustomOpApi ort, Ort
   return output_tensors;
 }
 
-void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
-  // Preliminary Thread safety mechanism
-  // Currently allows only one Infer execution at a time
-  std::lock_guard<std::mutex> lock(compute_lock_);
+std::vector<InferenceEngine::InferRequest::Ptr> OpenVINOGraph::AcquireInferRequests(size_t max_count) {
+  std::unique_lock<std::mutex> lock(infer_requests_lock_);
+  infer_request_released_.wait(lock, [this]() { return !free_infer_requests_.empty(); });
 
+  size_t count = std::min(max_count, free_infer_requests_.size());
+  std::vector<InferenceEngine::InferRequest::Ptr> infer_requests(free_infer_requests_.end() - count,
+                                                                 free_infer_requests_.end());
+  free_infer_requests_.resize(free_infer_requests_.size() - count);
+  return infer_requests;
+}
+
+void OpenVINOGraph::ReleaseInferRequests(std::vector<InferenceEngine::InferRequest::Ptr>& infer_requests) {
+  {
+    std::lock_guard<std::mutex> lock(infer_requests_lock_);
+    free_infer_requests_.insert(free_infer_requests_.end(), infer_requests.begin(), infer_requests.end());
+  }
+  infer_requests.clear();
+  infer_request_released_.notify_all();
+}
+
+void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   LOGS_DEFAULT(INFO) << log_tag << "Starting inference";
 
   auto input_tensors = GetInputTensors(ort, context);
@@ -442,35 +542,46 @@ void OpenVINOGraph::Infer(Ort::CustomOpApi ort, OrtKernelContext* context) {
   auto batch_size = DeduceBatchSize(ort, input_tensors[0],
                                     openvino_network_->getInputsInfo().begin()->second->getTensorDesc().getDims());
 
-  size_t full_parallel_runs = batch_size / num_inf_reqs_;
-  size_t remainder_parallel_runs = batch_size % num_inf_reqs_;
-
-  auto output_tensors = GetOutputTensors(ort, context, batch_size);
-
-  // Distribute the batched inputs among available Infer Requests
-  // for parallel inference.
+  // Concurrent Runs run on different Infer Requests in parallel. A Run takes the free ones
+  // it can use for its batch slices, at least one.
+  auto infer_requests = AcquireInferRequests(batch_size);
+  size_t num_run_reqs = infer_requests.size();
+
+  try {
+    size_t full_parallel_runs = batch_size / num_run_reqs;
+    size_t remainder_parallel_runs = batch_size % num_run_reqs;
+
+    auto output_tensors = GetOutputTensors(ort, context, batch_size, infer_requests[0]);
+
+    // Distribute the batched inputs among the Run's Infer Requests
+    // for parallel inference.
+
+    // Run parallel inferences as sets of num_run_reqs
+    for (size_t set = 0; set < full_parallel_runs; set++) {
+      for (size_t inf_req_idx = 0; inf_req_idx < num_run_reqs; inf_req_idx++) {
+        size_t batch_slice_idx = set * num_run_reqs + inf_req_idx;
+        StartAsyncInference(ort, input_tensors, batch_slice_idx, infer_requests[inf_req_idx]);
+      }
+      for (size_t inf_req_idx = 0; inf_req_idx < num_run_reqs; inf_req_idx++) {
+        size_t batch_slice_idx = set * num_run_reqs + inf_req_idx;
+        CompleteAsyncInference(ort, output_tensors, batch_slice_idx, infer_requests[inf_req_idx]);
+      }
+    }
 
-  // Run parallel inferences as sets of num_inf_reqs_
-  for (size_t set = 0; set < full_parallel_runs; set++) {
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
+    // Run parallel inferences for remaining batch slices
+    for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
+      size_t batch_slice_idx = full_parallel_runs * num_run_reqs + inf_req_idx;
+      StartAsyncInference(ort, input_tensors, batch_slice_idx, infer_requests[inf_req_idx]);
     }
-    for (size_t inf_req_idx = 0; inf_req_idx < num_inf_reqs_; inf_req_idx++) {
-      size_t batch_slice_idx = set * num_inf_reqs_ + inf_req_idx;
-      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
+    for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
+      size_t batch_slice_idx = full_parallel_runs * num_run_reqs + inf_req_idx;
+      CompleteAsyncInference(ort, output_tensors, batch_slice_idx, infer_requests[inf_req_idx]);
     }
+  } catch (...) {
+    ReleaseInferRequests(infer_requests);
+    throw;
   }
-
-  // Run parallel inferences for remaining batch slices
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    StartAsyncInference(ort, input_tensors, batch_slice_idx, inf_req_idx);
-  }
-  for (size_t inf_req_idx = 0; inf_req_idx < remainder_parallel_runs; inf_req_idx++) {
-    size_t batch_slice_idx = full_parallel_runs * num_inf_reqs_ + inf_req_idx;
-    CompleteAsyncInference(ort, output_tensors, batch_slice_idx, inf_req_idx);
-  }
+  ReleaseInferRequests(infer_requests);
 
   LOGS_DEFAULT(INFO) << log_tag << "Inference successful";
 }
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <inference_engine.hpp>
 #include <ie_utils.hpp>
@@ -21,12 +23,26 @@ namespace openvino_ep {
 class OpenVINOGraph {
  public:
 
-  OpenVINOGraph(const onnxruntime::Node* fused_node);
+  // num_infer_requests 0 is the default of the device
+  OpenVINOGraph(const onnxruntime::Node* fused_node, size_t num_infer_requests = 0);
 
   void Infer(Ort::CustomOpApi ort, OrtKernelContext* context);
 
   static void ConvertONNXModelToOpenVINOIR(const std::string& onnx_model, std::string& openvino_xml, std::string& openvino_bin, bool precision_fp32);
 
+  // The directory that the converted IR and the exported compiled networks are cached in, so that later sessions
+  // skip the Model Optimizer conversion and the compilation. Set with the ORT_OPENVINO_CACHE_DIR environment
+  // variable; empty if caching is off.
+  static std::string GetCacheDir();
+
+  // The cache file name of a network compiled for device_id, from the hashes and sizes of its serialized parts.
+  static std::string GetCacheKey(const std::string& device_id, const std::string& first, const std::string& second);
+
+  static bool ReadCacheFile(const std::string& path, std::string& contents);
+
+  // Writes a temporary file that is renamed to path, so that concurrent sessions never read a partial file.
+  static void WriteCacheFile(const std::string& path, const std::string& contents);
+
   static const std::string log_tag;
 
  private:
@@ -42,11 +58,19 @@ class OpenVINOGraph {
 
   std::vector<const OrtValue*> GetInputTensors(Ort::CustomOpApi ort, OrtKernelContext* context);
 
-  std::vector<OrtValue*> GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, size_t batch_size);
+  std::vector<OrtValue*> GetOutputTensors(Ort::CustomOpApi ort, OrtKernelContext* context, size_t batch_size,
+                                          InferenceEngine::InferRequest::Ptr infer_request);
+
+  void StartAsyncInference(Ort::CustomOpApi ort, std::vector<const OrtValue*> input_tensors, size_t batch_slice_idx,
+                           InferenceEngine::InferRequest::Ptr infer_request);
+
+  void CompleteAsyncInference(Ort::CustomOpApi ort, std::vector<OrtValue*> output_tensors, size_t batch_slice_idx,
+                              InferenceEngine::InferRequest::Ptr infer_request);
 
-  void StartAsyncInference(Ort::CustomOpApi ort, std::vector<const OrtValue*> input_tensors, size_t batch_slice_idx, size_t infer_req_idx);
+  // Take up to max_count of the free infer requests, waiting for one if none is free.
+  std::vector<InferenceEngine::InferRequest::Ptr> AcquireInferRequests(size_t max_count);
 
-  void CompleteAsyncInference(Ort::CustomOpApi ort, std::vector<OrtValue*> output_tensors, size_t batch_slice_idx, size_t infer_req_idx);
+  void ReleaseInferRequests(std::vector<InferenceEngine::InferRequest::Ptr>& infer_requests);
 
   std::vector<std::string> GetEnvLdLibraryPath() const;
 
@@ -54,9 +78,11 @@ class OpenVINOGraph {
   std::shared_ptr<InferenceEngine::CNNNetwork> openvino_network_;
   size_t num_inf_reqs_;
   InferenceEngine::InferencePlugin plugin_;
-  std::vector<InferenceEngine::InferRequest::Ptr> infer_requests_;
+  // the infer requests that no Run is using
+  std::vector<InferenceEngine::InferRequest::Ptr> free_infer_requests_;
+  std::mutex infer_requests_lock_;
+  std::condition_variable infer_request_released_;
   std::string device_id_;
-  mutable std::mutex compute_lock_;
   std::vector<int> input_indexes_;
   InferenceEngine::Precision precision_;
   const onnxruntime::Graph* onnx_graph_;
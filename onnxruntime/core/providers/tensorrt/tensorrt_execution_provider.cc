@@ -19,6 +19,12 @@
 #include "core/graph/model.h"
 #include "cuda_runtime_api.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 using namespace std;
 using namespace ONNX_NAMESPACE;
@@ -41,7 +47,12 @@ TensorrtLogger& GetTensorrtLogger() {
   } while (0)
 
 TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider}, device_id_(info.device_id) {
+    : IExecutionProvider{onnxruntime::kTensorrtExecutionProvider},
+      engine_cache_path_(info.engine_cache_path),
+      fp16_enable_(info.fp16_enable),
+      int8_enable_(info.int8_enable),
+      int8_calibration_table_path_(info.int8_calibration_table_path),
+      device_id_(info.device_id) {
   CUDA_CALL_THROW(cudaSetDevice(device_id_));
 
   DeviceAllocatorRegistrationInfo default_memory_info(
@@ -294,30 +305,421 @@ TensorrtExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph,
   return result;
 }
 
+namespace {
+
+// Gives TensorRT the dynamic ranges of a calibration table, instead of calibrating with batches of data
+class TensorrtInt8Calibrator : public nvinfer1::IInt8EntropyCalibrator2 {
+ public:
+  explicit TensorrtInt8Calibrator(const std::string& calibration_table) : calibration_table_(calibration_table) {}
+
+  int getBatchSize() const override { return 1; }
+
+  bool getBatch(void* /*bindings*/[], const char* /*names*/[], int /*nbBindings*/) override { return false; }
+
+  const void* readCalibrationCache(size_t& length) override {
+    length = calibration_table_.size();
+    return calibration_table_.data();
+  }
+
+  void writeCalibrationCache(const void* /*ptr*/, size_t /*length*/) override {}
+
+ private:
+  const std::string& calibration_table_;
+};
+
+}  // namespace
+
+TensorrtExecutionContext::~TensorrtExecutionContext() {
+  // the last Run using the context may still be running
+  if (stream != nullptr) {
+    cudaStreamSynchronize(stream);
+    cudaStreamDestroy(stream);
+  }
+  if (inputs_ready != nullptr) {
+    cudaEventDestroy(inputs_ready);
+  }
+  if (outputs_ready != nullptr) {
+    cudaEventDestroy(outputs_ready);
+  }
+}
+
+static common::Status CreateExecutionContext(nvinfer1::ICudaEngine& engine,
+                                             std::unique_ptr<TensorrtExecutionContext>& context) {
+  auto new_context = std::make_unique<TensorrtExecutionContext>();
+  new_context->context = TensorrtUniquePtr<nvinfer1::IExecutionContext>(engine.createExecutionContext());
+  if (new_context->context == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create TRT execution context.");
+  }
+  CUDA_RETURN_IF_ERROR(cudaStreamCreate(&new_context->stream));
+  CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&new_context->inputs_ready, cudaEventDisableTiming));
+  CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&new_context->outputs_ready, cudaEventDisableTiming));
+  context = std::move(new_context);
+  return Status::OK();
+}
+
+// Takes a free context of the engine, or creates one if concurrent Runs use all of them
+static common::Status AcquireExecutionContext(TensorrtEngine& engine,
+                                              std::unique_ptr<TensorrtExecutionContext>& context) {
+  {
+    std::lock_guard<OrtMutex> lock(engine.contexts_mutex);
+    if (!engine.free_contexts.empty()) {
+      context = std::move(engine.free_contexts.back());
+      engine.free_contexts.pop_back();
+      return Status::OK();
+    }
+  }
+  return CreateExecutionContext(*engine.engine, context);
+}
+
+namespace {
+
+// Gives the context of a Run back to its engine when the Run returns. The work of the Run is ordered on the stream
+// of the context, so the next Run may use it right away.
+struct ExecutionContextRelease {
+  TensorrtEngine& engine;
+  std::unique_ptr<TensorrtExecutionContext>& context;
+  ~ExecutionContextRelease() {
+    std::lock_guard<OrtMutex> lock(engine.contexts_mutex);
+    engine.free_contexts.push_back(std::move(context));
+  }
+};
+
+}  // namespace
+
+// 64-bit FNV-1a, which unlike std::hash is the same for every build
+static uint64_t HashString(const std::string& data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string TensorrtExecutionProvider::GetEngineCacheFile(const std::string& engine_cache_path,
+                                                          const std::string& serialized_subgraph,
+                                                          const nvinfer1::IBuilder& builder,
+                                                          int max_batch_size) const {
+  cudaDeviceProp prop;
+  CUDA_CALL_THROW(cudaGetDeviceProperties(&prop, device_id_));
+  std::string gpu_name = prop.name;
+  for (auto& c : gpu_name) {
+    if (!isalnum(static_cast<unsigned char>(c))) {
+      c = '_';
+    }
+  }
+
+  std::ostringstream file_name;
+  file_name << engine_cache_path << "/trt" << getInferLibVersion()
+            << "_" << gpu_name << "_sm" << prop.major << prop.minor
+            << "_b" << max_batch_size << "_w" << max_workspace_size_
+            << (builder.getFp16Mode() ? "_fp16" : "") << (builder.getInt8Mode() ? "_int8" : "")
+            << std::hex;
+  if (builder.getInt8Mode()) {
+    // the dynamic ranges of the int8 layers come from the calibration table
+    file_name << "_" << std::setw(16) << std::setfill('0') << HashString(int8_calibration_table_);
+  }
+  file_name << "_" << std::setw(16) << std::setfill('0') << HashString(serialized_subgraph)
+            << std::dec << "_" << serialized_subgraph.size() << ".engine";
+  return file_name.str();
+}
+
+TensorrtExecutionProvider::unique_pointer<nvinfer1::ICudaEngine>
+TensorrtExecutionProvider::LoadEngine(const std::string& engine_cache_file) {
+  std::ifstream file(engine_cache_file, std::ios::in | std::ios::binary);
+  if (!file) {
+    return nullptr;
+  }
+  std::string engine_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (engine_data.empty()) {
+    return nullptr;
+  }
+
+  if (runtime_ == nullptr) {
+    runtime_ = unique_pointer<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTensorrtLogger()));
+  }
+  auto engine = unique_pointer<nvinfer1::ICudaEngine>(
+      runtime_->deserializeCudaEngine(engine_data.data(), engine_data.size(), nullptr));
+  if (engine == nullptr) {
+    LOGS_DEFAULT(WARNING) << "Failed to deserialize TensorRT engine " << engine_cache_file << ", rebuilding it";
+  }
+  return engine;
+}
+
+void TensorrtExecutionProvider::SaveEngine(const std::string& engine_cache_file, nvinfer1::ICudaEngine& engine) const {
+  auto serialized_engine = unique_pointer<nvinfer1::IHostMemory>(engine.serialize());
+  if (serialized_engine == nullptr) {
+    LOGS_DEFAULT(WARNING) << "Failed to serialize TensorRT engine " << engine_cache_file;
+    return;
+  }
+
+  // write to a temporary file first, so sessions sharing the directory never load a partial engine
+  const std::string temp_file = engine_cache_file + "." + std::to_string(Env::Default().GetSelfPid()) + ".tmp";
+  {
+    std::ofstream file(temp_file, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(static_cast<const char*>(serialized_engine->data()), serialized_engine->size());
+    if (!file) {
+      LOGS_DEFAULT(WARNING) << "Failed to write TensorRT engine cache file " << temp_file;
+      std::remove(temp_file.c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_file.c_str(), engine_cache_file.c_str()) != 0) {
+    LOGS_DEFAULT(WARNING) << "Failed to write TensorRT engine cache file " << engine_cache_file;
+    std::remove(temp_file.c_str());
+  }
+}
+
+common::Status TensorrtExecutionProvider::BuildEngine(TensorrtSubgraph& subgraph,
+                                                      const std::vector<std::vector<int64_t>>& input_shapes,
+                                                      int max_batch_size, std::shared_ptr<TensorrtEngine>& engine) {
+  // Set the non-batch dimensions of the subgraph inputs to the ones the engine is built for
+  ONNX_NAMESPACE::ModelProto& model_proto = subgraph.model_proto;
+  for (auto& input : *model_proto.mutable_graph()->mutable_input()) {
+    auto iter = subgraph.input_map.find(input.name());
+    if (iter == subgraph.input_map.end() || subgraph.input_is_initializer[iter->second]) {
+      continue;
+    }
+    const auto& dims = input_shapes[iter->second];
+    auto* shape = input.mutable_type()->mutable_tensor_type()->mutable_shape();
+    if (shape->dim_size() != static_cast<int>(dims.size()) + 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "TensorRT input ", input.name(), " has rank ",
+                             dims.size() + 1, " instead of ", shape->dim_size());
+    }
+    for (size_t j = 0; j < dims.size(); ++j) {
+      shape->mutable_dim(static_cast<int>(j) + 1)->set_dim_value(dims[j]);
+    }
+  }
+  string string_buf;
+  model_proto.SerializeToString(&string_buf);
+
+  // Create TensorRT engine
+  TensorrtLogger& trt_logger = GetTensorrtLogger();
+  auto trt_builder = unique_pointer<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(trt_logger));
+  trt_builder->setMaxBatchSize(max_batch_size);
+  trt_builder->setMaxWorkspaceSize(max_workspace_size_);
+
+  // Reduced precisions are allowed rather than enforced, TensorRT keeps fp32 for the layers that don't support
+  // them or aren't faster with them
+  std::unique_ptr<TensorrtInt8Calibrator> trt_calibrator;
+  if (fp16_enable_) {
+    if (trt_builder->platformHasFastFp16()) {
+      trt_builder->setFp16Mode(true);
+    } else {
+      LOGS_DEFAULT(WARNING) << "The GPU has no fast fp16, TensorRT fp16 mode is ignored";
+    }
+  }
+  if (int8_enable_) {
+    if (trt_builder->platformHasFastInt8()) {
+      trt_calibrator = std::make_unique<TensorrtInt8Calibrator>(int8_calibration_table_);
+      trt_builder->setInt8Mode(true);
+      trt_builder->setInt8Calibrator(trt_calibrator.get());
+    } else {
+      LOGS_DEFAULT(WARNING) << "The GPU has no fast int8, TensorRT int8 mode is ignored";
+    }
+  }
+
+  // Deserialize the engine if it was built by an earlier session, the parser is only needed to build it
+  unique_pointer<nvinfer1::ICudaEngine> trt_engine;
+  std::string engine_cache_file;
+  if (!engine_cache_path_.empty()) {
+    engine_cache_file = GetEngineCacheFile(engine_cache_path_, string_buf, *trt_builder, max_batch_size);
+    trt_engine = LoadEngine(engine_cache_file);
+  }
+
+  if (trt_engine == nullptr) {
+    auto trt_network = unique_pointer<nvinfer1::INetworkDefinition>(trt_builder->createNetwork());
+    auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
+    if (!trt_parser->parse(string_buf.data(), string_buf.size())) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "TensorRT failed to parse subgraph ", model_proto.graph().name());
+    }
+    trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildCudaEngine(*trt_network.get()));
+    if (trt_engine == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "TensorRT failed to build engine of subgraph ",
+                             model_proto.graph().name(), " for max batch size ", max_batch_size);
+    }
+    if (!engine_cache_file.empty()) {
+      SaveEngine(engine_cache_file, *trt_engine);
+    }
+  }
+
+  // Build the first TensorRT context
+  std::unique_ptr<TensorrtExecutionContext> trt_context;
+  ORT_RETURN_IF_ERROR(CreateExecutionContext(*trt_engine, trt_context));
+
+  // Map the names of the subgraph outputs to their index, the bindings have the same names
+  std::unordered_map<std::string, int> graph_output_map;
+  const auto& graph_output = model_proto.graph().output();
+  for (int i = 0, end = graph_output.size(); i < end; ++i) {
+    graph_output_map[graph_output[i].name()] = i;
+  }
+
+  // Get input and output binding indexes and output shapes from the engine. Input bindings come first.
+  const int num_bindings = trt_engine->getNbBindings();
+  int num_inputs = 0;
+  for (int i = 0; i < num_bindings; ++i) {
+    if (trt_engine->bindingIsInput(i)) {
+      ++num_inputs;
+    }
+  }
+  const int num_outputs = num_bindings - num_inputs;
+
+  auto new_engine = std::make_shared<TensorrtEngine>();
+  new_engine->input_shapes = input_shapes;
+  new_engine->max_batch_size = max_batch_size;
+  new_engine->input_indexes.resize(num_inputs);
+  new_engine->output_indexes.resize(num_outputs);
+  new_engine->output_types.resize(num_outputs);
+  new_engine->output_shapes.resize(num_outputs);
+  for (int bindingIndex = 0; bindingIndex < num_inputs; ++bindingIndex) {
+    ORT_ENFORCE(trt_engine->bindingIsInput(bindingIndex));
+    auto iter = subgraph.input_map.find(trt_engine->getBindingName(bindingIndex));
+    if (iter != subgraph.input_map.end()) {
+      new_engine->input_indexes[bindingIndex] = iter->second;
+    }
+  }
+
+  for (int bindingIndex = 0; bindingIndex < num_outputs; ++bindingIndex) {
+    const std::string name = trt_engine->getBindingName(num_inputs + bindingIndex);
+    nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(num_inputs + bindingIndex);
+    auto iter = subgraph.output_map.find(name);
+    if (iter != subgraph.output_map.end()) {
+      new_engine->output_indexes[bindingIndex] = iter->second;
+    }
+    auto& output_shape = new_engine->output_shapes[bindingIndex];
+    for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
+      output_shape.push_back(dimensions.d[j]);
+    }
+
+    auto graph_output_iter = graph_output_map.find(name);
+    ORT_ENFORCE(graph_output_iter != graph_output_map.end(), "TensorRT engine output ", name, " is not a subgraph output");
+    const auto& tensor_type = graph_output[graph_output_iter->second].type().tensor_type();
+    new_engine->output_types[bindingIndex] = tensor_type.elem_type();
+
+    const auto& tensor_shape = tensor_type.shape();
+    if (tensor_shape.dim_size() == 1 && !output_shape.empty() && output_shape.back() == 1) {
+      output_shape.pop_back();
+    }
+  }
+
+  new_engine->engine = std::move(trt_engine);
+  new_engine->free_contexts.push_back(std::move(trt_context));
+  engine = std::move(new_engine);
+  return Status::OK();
+}
+
+common::Status TensorrtExecutionProvider::GetEngine(TensorrtSubgraph& subgraph,
+                                                    const std::vector<std::vector<int64_t>>& input_shapes,
+                                                    int batch_size, std::shared_ptr<TensorrtEngine>& engine) {
+  std::lock_guard<OrtMutex> lock(subgraph.engines_mutex);
+  auto& engines = subgraph.engines;
+  for (auto iter = engines.begin(); iter != engines.end(); ++iter) {
+    if ((*iter)->input_shapes == input_shapes && batch_size <= (*iter)->max_batch_size) {
+      engines.splice(engines.begin(), engines, iter);
+      engine = engines.front();
+      return Status::OK();
+    }
+  }
+
+  // Grow the max batch size by powers of 2, so that increasing batch sizes cause few rebuilds
+  int max_batch_size = std::max(max_batch_size_, 1);
+  while (max_batch_size < batch_size) {
+    max_batch_size *= 2;
+  }
+  LOGS_DEFAULT(INFO) << "Building TensorRT engine of subgraph " << subgraph.model_proto.graph().name()
+                     << " for batch size " << batch_size << ", max batch size " << max_batch_size;
+
+  std::shared_ptr<TensorrtEngine> new_engine;
+  {
+    std::lock_guard<OrtMutex> build_lock(tensorrt_mu_);
+    ORT_RETURN_IF_ERROR(BuildEngine(subgraph, input_shapes, max_batch_size, new_engine));
+  }
+
+  // The engines of the shapes that the new one covers with a smaller max batch size aren't needed anymore,
+  // nor the least recently used ones beyond the limit. The Runs using them keep them until they are done.
+  for (auto iter = engines.begin(); iter != engines.end();) {
+    if ((*iter)->input_shapes == input_shapes) {
+      iter = engines.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  engines.push_front(std::move(new_engine));
+  while (engines.size() > std::max<size_t>(max_cached_engines_, 1)) {
+    engines.pop_back();
+  }
+
+  engine = engines.front();
+  return Status::OK();
+}
+
 common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime::Node*>& fused_nodes,
                                                   std::vector<NodeComputeInfo>& node_compute_funcs) {
+  const char* batch_env = getenv("ORT_TENSORRT_MAX_BATCH_SIZE");
+  if (batch_env) {
+    const int max_batch_size = atoi(batch_env);
+    SetMaxBatchSize(max_batch_size);
+  }
+
+  const char* workspace_env = getenv("ORT_TENSORRT_MAX_WORKSPACE_SIZE");
+  if (workspace_env) {
+    const size_t max_workspace_size = atoi(workspace_env);
+    SetMaxWorkspaceSize(max_workspace_size);
+  }
+
+  const char* cached_engines_env = getenv("ORT_TENSORRT_MAX_CACHED_ENGINES");
+  if (cached_engines_env) {
+    const size_t max_cached_engines = atoi(cached_engines_env);
+    SetMaxCachedEngines(max_cached_engines);
+  }
+
+  const char* engine_cache_env = getenv("ORT_TENSORRT_ENGINE_CACHE_PATH");
+  if (engine_cache_env) {
+    engine_cache_path_ = engine_cache_env;
+  }
+
+  const char* fp16_env = getenv("ORT_TENSORRT_FP16_ENABLE");
+  if (fp16_env) {
+    fp16_enable_ = atoi(fp16_env) != 0;
+  }
+
+  const char* int8_env = getenv("ORT_TENSORRT_INT8_ENABLE");
+  if (int8_env) {
+    int8_enable_ = atoi(int8_env) != 0;
+  }
+
+  const char* calibration_table_env = getenv("ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH");
+  if (calibration_table_env) {
+    int8_calibration_table_path_ = calibration_table_env;
+  }
+
+  if (int8_enable_ && int8_calibration_table_.empty()) {
+    std::ifstream file(int8_calibration_table_path_, std::ios::in | std::ios::binary);
+    if (file) {
+      int8_calibration_table_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    if (int8_calibration_table_.empty()) {
+      LOGS_DEFAULT(WARNING) << "TensorRT int8 mode needs a calibration table, which can't be read from '"
+                            << int8_calibration_table_path_ << "'. The engines are built without int8.";
+      int8_enable_ = false;
+    }
+  }
+
   for (const auto* fused_node : fused_nodes) {
-    std::vector<int> input_indexes;
-    std::vector<int> input_dim_sizes;
-    std::vector<int> output_indexes;
-    std::vector<int> output_dim_sizes;
-    std::vector<std::vector<int64_t>> output_shapes;
-    std::vector<int> output_types;
+    auto subgraph = std::make_unique<TensorrtSubgraph>();
 
     // Build map from input name to its index in input definitions
-    std::unordered_map<std::string, int> input_map;
     const auto& input_defs = fused_node->InputDefs();
-    input_map.reserve(input_defs.size());
+    subgraph->input_map.reserve(input_defs.size());
     for (int i = 0, end = input_defs.size(); i < end; ++i) {
-      input_map[input_defs[i]->Name()] = i;
+      subgraph->input_map[input_defs[i]->Name()] = i;
     }
 
     // Build map from output name to its index in output definitions
-    std::unordered_map<std::string, int> output_map;
     const auto& output_defs = fused_node->OutputDefs();
-    output_map.reserve(output_defs.size());
+    subgraph->output_map.reserve(output_defs.size());
     for (int i = 0, end = output_defs.size(); i < end; ++i) {
-      output_map[output_defs[i]->Name()] = i;
+      subgraph->output_map[output_defs[i]->Name()] = i;
     }
 
     // Reconstruct graph proto from fused node's function body
@@ -327,111 +729,50 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     }
     const Graph& graph_body = func_body->Body();
     onnxruntime::Model model(graph_body.Name(), true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), graph_body.DomainToVersionMap());
-    ONNX_NAMESPACE::ModelProto model_proto = model.ToProto();
-    *(model_proto.mutable_graph()) = graph_body.ToGraphProto();
-    model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
-    string string_buf;
-    model_proto.SerializeToString(&string_buf);
-
-    // Create TensorRT engine
-    TensorrtLogger& trt_logger = GetTensorrtLogger();
-    auto trt_builder = unique_pointer<nvinfer1::IBuilder>(nvinfer1::createInferBuilder(trt_logger));
-    auto trt_network = unique_pointer<nvinfer1::INetworkDefinition>(trt_builder->createNetwork());
-    auto trt_parser = unique_pointer<nvonnxparser::IParser>(nvonnxparser::createParser(*trt_network, trt_logger));
-    trt_parser->parse(string_buf.data(), string_buf.size());
-
-    const char* batch_env = getenv("ORT_TENSORRT_MAX_BATCH_SIZE");
-    if (batch_env) {
-      const int max_batch_size = atoi(batch_env);
-      SetMaxBatchSize(max_batch_size);
-    }
-
-    const char* workspace_env = getenv("ORT_TENSORRT_MAX_WORKSPACE_SIZE");
-    if (workspace_env) {
-      const size_t max_workspace_size = atoi(workspace_env);
-      SetMaxWorkspaceSize(max_workspace_size);
-    }
-
-    trt_builder->setMaxBatchSize(max_batch_size_);
-    trt_builder->setMaxWorkspaceSize(max_workspace_size_);
-    auto trt_engine = unique_pointer<nvinfer1::ICudaEngine>(trt_builder->buildCudaEngine(*trt_network.get()));
-    ORT_ENFORCE(trt_engine != nullptr);
-
-    // Build TensorRT context
-    auto trt_context = unique_pointer<nvinfer1::IExecutionContext>(trt_engine->createExecutionContext());
-    ORT_ENFORCE(trt_context != nullptr);
-
-    // Get input shape and binding index
-    int num_inputs = trt_network->getNbInputs();
-    input_indexes.resize(num_inputs);
-    input_dim_sizes.resize(num_inputs);
-    for (int i = 0; i < num_inputs; ++i) {
-      const std::string& name = trt_network->getInput(i)->getName();
-      size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
-      nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
-      auto iter = input_map.find(name);
-      if (iter != input_map.end()) {
-        input_indexes[bindingIndex] = iter->second;
-      }
-      size_t dim_size = 1;
-      for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
-        dim_size *= dimensions.d[j];
-      }
-      input_dim_sizes[bindingIndex] = dim_size;
-    }
-
-    // Get output shape and binding index
-    int num_outputs = trt_network->getNbOutputs();
-    output_indexes.resize(num_outputs);
-    output_dim_sizes.resize(num_outputs);
-    output_shapes.resize(num_outputs);
-    output_types.resize(num_outputs);
-    for (int i = 0; i < num_outputs; ++i) {
-      const std::string& name = trt_network->getOutput(i)->getName();
-      size_t bindingIndex = trt_engine->getBindingIndex(name.c_str());
-      nvinfer1::Dims dimensions = trt_engine->getBindingDimensions(static_cast<int>(bindingIndex));
-      bindingIndex -= num_inputs;
-      auto iter = output_map.find(name);
-      if (iter != output_map.end()) {
-        output_indexes[bindingIndex] = iter->second;
-      }
-      size_t dim_size = 1;
-      for (int j = 0, end = dimensions.nbDims; j < end; ++j) {
-        output_shapes[bindingIndex].push_back(dimensions.d[j]);
-        dim_size *= dimensions.d[j];
-      }
-      output_dim_sizes[bindingIndex] = dim_size;
+    subgraph->model_proto = model.ToProto();
+    *(subgraph->model_proto.mutable_graph()) = graph_body.ToGraphProto();
+    subgraph->model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
 
-      const auto& graph_output = model_proto.graph().output();
-      const auto& tensor_type = graph_output[i].type().tensor_type();
-      output_types[bindingIndex] = tensor_type.elem_type();
+    subgraph->input_is_initializer.resize(input_defs.size());
+    for (int i = 0, end = input_defs.size(); i < end; ++i) {
+      const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+      subgraph->input_is_initializer[i] = graph_body.GetInitializedTensor(input_defs[i]->Name(), initializer);
+    }
 
-      const auto& tensor_shape = tensor_type.shape();
-      if (tensor_shape.dim_size() == 1 && output_shapes[bindingIndex].back() == 1) {
-        output_shapes[bindingIndex].pop_back();
+    // Build the first engine now if the non-batch dimensions of the inputs are known, otherwise on the first run
+    std::vector<std::vector<int64_t>> input_shapes(input_defs.size());
+    bool static_shapes = true;
+    for (int i = 0, end = input_defs.size(); i < end && static_shapes; ++i) {
+      const auto* shape = input_defs[i]->Shape();
+      if (subgraph->input_is_initializer[i]) {
+        continue;
+      }
+      if (shape == nullptr || shape->dim_size() == 0) {
+        static_shapes = false;
+        break;
+      }
+      for (int j = 1, dim_size = shape->dim_size(); j < dim_size; ++j) {
+        if (!shape->dim(j).has_dim_value()) {
+          static_shapes = false;
+          break;
+        }
+        input_shapes[i].push_back(shape->dim(j).dim_value());
       }
     }
+    if (static_shapes) {
+      std::shared_ptr<TensorrtEngine> engine;
+      ORT_RETURN_IF_ERROR(BuildEngine(*subgraph, input_shapes, std::max(max_batch_size_, 1), engine));
+      subgraph->engines.push_front(std::move(engine));
+    }
 
-    ORT_ENFORCE(trt_engine->getNbBindings() == (num_inputs + num_outputs));
-
-    // Save engine, context and input/output info to map
-    parsers_.emplace(fused_node->Name(), std::move(trt_parser));
-    engines_.emplace(fused_node->Name(), std::move(trt_engine));
-    contexts_.emplace(fused_node->Name(), std::move(trt_context));
-    input_info_[fused_node->Name()].push_back(input_indexes);
-    input_info_[fused_node->Name()].push_back(input_dim_sizes);
-    output_info_[fused_node->Name()].push_back(output_indexes);
-    output_info_[fused_node->Name()].push_back(output_dim_sizes);
-    output_info_[fused_node->Name()].push_back(output_types);
-    output_shapes_[fused_node->Name()] = output_shapes;
+    subgraphs_[fused_node->Name()] = std::move(subgraph);
 
     // Create function state
-    // TODO: remove default capture
     NodeComputeInfo compute_info;
-    compute_info.create_state_func = [=](ComputeContext* context, FunctionState* state) {
+    compute_info.create_state_func = [this](ComputeContext* context, FunctionState* state) {
       std::unique_ptr<TensorrtFuncState> p = std::make_unique<TensorrtFuncState>();
-      *p = {context->allocate_func, context->release_func, context->allocator_handle, parsers_[context->node_name].get(), engines_[context->node_name].get(), contexts_[context->node_name].get(),
-            input_info_[context->node_name], output_info_[context->node_name], output_shapes_[context->node_name], &tensorrt_mu_};
+      *p = {context->allocate_func, context->release_func, context->allocator_handle,
+            subgraphs_[context->node_name].get()};
       *state = p.release();
       return 0;
     };
@@ -443,34 +784,55 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
     };
 
     // Create compute function
-    compute_info.compute_func = [](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
+    compute_info.compute_func = [this](FunctionState state, const OrtCustomOpApi* api, OrtKernelContext* context) {
       Ort::CustomOpApi ort{*api};
       TensorrtFuncState* trt_state = reinterpret_cast<TensorrtFuncState*>(state);
-      const std::vector<int>& input_indexes = (trt_state->input_info)[0];
-      const std::vector<int>& output_indexes = (trt_state->output_info)[0];
-      const std::vector<int>& output_types = (trt_state->output_info)[2];
-      std::vector<std::vector<int64_t>> output_shapes = trt_state->output_shapes;
+      TensorrtSubgraph& subgraph = *trt_state->subgraph;
+
+      // Get batch size and the non-batch dimensions of the inputs, which select the engine
+      const int num_inputs = static_cast<int>(subgraph.input_is_initializer.size());
+      std::vector<std::vector<int64_t>> input_shapes(num_inputs);
+      int batch_size = 1;
+      bool has_batch_size = false;
+      for (int i = 0; i < num_inputs; ++i) {
+        if (subgraph.input_is_initializer[i]) {
+          continue;
+        }
+        const OrtValue* input_tensor = ort.KernelContext_GetInput(context, i);
+        auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
+        const auto& tensor_shape = ort.GetTensorShape(tensor_info);
+        ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
+        if (tensor_shape.empty()) {
+          return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "TensorRT inputs need a batch dimension");
+        }
 
+        const int input_batch_size = static_cast<int>(tensor_shape[0]);
+        if (has_batch_size && batch_size != input_batch_size) {
+          return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Input batch size is inconsistent");
+        }
+        batch_size = input_batch_size;
+        has_batch_size = true;
+        input_shapes[i].assign(tensor_shape.begin() + 1, tensor_shape.end());
+      }
+
+      // The engine may have to be built first
+      std::shared_ptr<TensorrtEngine> trt_engine;
+      ORT_RETURN_IF_ERROR(GetEngine(subgraph, input_shapes, batch_size, trt_engine));
+
+      const std::vector<int>& input_indexes = trt_engine->input_indexes;
+      const std::vector<int>& output_indexes = trt_engine->output_indexes;
+      const std::vector<int>& output_types = trt_engine->output_types;
       int num_binding_inputs = input_indexes.size();
       int num_binding_outputs = output_indexes.size();
       int total_bindings = num_binding_inputs + num_binding_outputs;
       std::vector<void*> buffers(total_bindings);
-      int batch_size = 1;
 
-      // Get batch size and allocate cuda memory for inputs
       for (int i = 0, end = num_binding_inputs; i < end; ++i) {
         const OrtValue* input_tensor = ort.KernelContext_GetInput(context, input_indexes[i]);
         auto tensor_info = ort.GetTensorTypeAndShape(input_tensor);
-        const auto& tensor_shape = ort.GetTensorShape(tensor_info);
         auto tensor_type = ort.GetTensorElementType(tensor_info);
         ort.ReleaseTensorTypeAndShapeInfo(tensor_info);
 
-        const int input_batch_size = tensor_shape[0];
-        if (i > 0 && batch_size != input_batch_size) {
-          ORT_THROW("Input batch size is inconsistent");
-        }
-        batch_size = input_batch_size;
-
         if (tensor_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
           buffers[i] = const_cast<float*>(ort.GetTensorData<float>(input_tensor));
         } else if (tensor_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
@@ -485,9 +847,10 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
       // Allocate cuda memory for outputs
       for (int i = 0, end = num_binding_outputs; i < end; ++i) {
         int output_index = output_indexes[i];
-        output_shapes[i].insert(output_shapes[i].begin(), batch_size);
+        std::vector<int64_t> output_shape = trt_engine->output_shapes[i];
+        output_shape.insert(output_shape.begin(), batch_size);
 
-        OrtValue* output_tensor = ort.KernelContext_GetOutput(context, output_index, output_shapes[i].data(), output_shapes[i].size());
+        OrtValue* output_tensor = ort.KernelContext_GetOutput(context, output_index, output_shape.data(), output_shape.size());
         if (output_types[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
           buffers[i + num_binding_inputs] = ort.GetTensorMutableData<float>(output_tensor);
         } else if (output_types[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8) {
@@ -499,16 +862,19 @@ common::Status TensorrtExecutionProvider::Compile(const std::vector<onnxruntime:
         }
       }
 
-      // Run TRT inference
-      std::lock_guard<OrtMutex> lock(*(trt_state->tensorrt_mu_ptr));
-      bool ret = trt_state->context->enqueue(batch_size, &buffers[0], nullptr, nullptr);
+      // Run TRT inference on a context of its own. Its stream starts once the inputs are computed on the stream of
+      // this thread, which waits the outputs in turn, so the Runs of other threads overlap.
+      std::unique_ptr<TensorrtExecutionContext> trt_context;
+      ORT_RETURN_IF_ERROR(AcquireExecutionContext(*trt_engine, trt_context));
+      ExecutionContextRelease context_release{*trt_engine, trt_context};
+      CUDA_RETURN_IF_ERROR(cudaEventRecord(trt_context->inputs_ready, cudaStreamPerThread));
+      CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(trt_context->stream, trt_context->inputs_ready, 0));
+      bool ret = trt_context->context->enqueue(batch_size, &buffers[0], trt_context->stream, nullptr);
       if (!ret) {
-        if (trt_state->context->getEngine().getMaxBatchSize() < batch_size) {
-          return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
-                                "TRT enqueue failed: Set ORT_TENSORRT_MAX_BATCH_SIZE environment variable to at least " + to_string(batch_size));
-        }
         return common::Status(common::ONNXRUNTIME, common::FAIL, "Failed to enqueue to TRT execution context.");
       }
+      CUDA_RETURN_IF_ERROR(cudaEventRecord(trt_context->outputs_ready, trt_context->stream));
+      CUDA_RETURN_IF_ERROR(cudaStreamWaitEvent(cudaStreamPerThread, trt_context->outputs_ready, 0));
 
       return Status::OK();
     };
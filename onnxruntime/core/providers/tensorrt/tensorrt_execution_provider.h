@@ -3,8 +3,10 @@
 
 #pragma once
 #include <ctime>
+#include <list>
 #include "core/common/logging/logging.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/onnx_protobuf.h"
 #include "NvInfer.h"
 #include "NvOnnxParser.h"
 #include "core/platform/ort_mutex.h"
@@ -33,6 +35,72 @@ class TensorrtLogger : public nvinfer1::ILogger {
 // Information needed to construct trt execution providers.
 struct TensorrtExecutionProviderInfo {
   int device_id{0};
+  // Existing directory where the built engines are serialized to and loaded from on later sessions.
+  // Empty disables the cache. The ORT_TENSORRT_ENGINE_CACHE_PATH environment variable overrides it.
+  std::string engine_cache_path;
+  // Let TensorRT run the layers in fp16 where it's faster, if the GPU supports it.
+  // The ORT_TENSORRT_FP16_ENABLE environment variable overrides it.
+  bool fp16_enable{false};
+  // Let TensorRT run the layers in int8 where it's faster, with the dynamic ranges of a calibration table produced by
+  // TensorRT's calibration (e.g. with trtexec --calib) of the same model. Both are required.
+  // The ORT_TENSORRT_INT8_ENABLE and ORT_TENSORRT_INT8_CALIBRATION_TABLE_PATH environment variables override them.
+  bool int8_enable{false};
+  std::string int8_calibration_table_path;
+};
+
+struct TensorrtInferDeleter {
+  template <typename T>
+  void operator()(T* obj) const {
+    if (obj) {
+      obj->destroy();
+    }
+  }
+};
+
+template <typename T>
+using TensorrtUniquePtr = std::unique_ptr<T, TensorrtInferDeleter>;
+
+// An execution context of an engine, and the stream it runs on. A Run uses it alone, so Runs of the same engine
+// on different contexts execute in parallel.
+struct TensorrtExecutionContext {
+  ~TensorrtExecutionContext();
+
+  TensorrtUniquePtr<nvinfer1::IExecutionContext> context;
+  cudaStream_t stream = nullptr;
+  // recorded on the stream of the calling thread once the inputs are computed, and on stream once the outputs are
+  cudaEvent_t inputs_ready = nullptr;
+  cudaEvent_t outputs_ready = nullptr;
+};
+
+// An engine of a fused subgraph. It runs inputs with the non-batch dimensions it's built for,
+// and batch sizes up to its max batch size.
+struct TensorrtEngine {
+  TensorrtUniquePtr<nvinfer1::ICudaEngine> engine;
+  // the contexts that no Run is using, one is created when a Run finds none
+  std::vector<std::unique_ptr<TensorrtExecutionContext>> free_contexts;
+  OrtMutex contexts_mutex;
+  // non-batch dimensions of each fused node input, empty for the initializers
+  std::vector<std::vector<int64_t>> input_shapes;
+  int max_batch_size = 1;
+  // fused node input and output index of each binding
+  std::vector<int> input_indexes;
+  std::vector<int> output_indexes;
+  std::vector<int> output_types;
+  // non-batch dimensions of each output binding
+  std::vector<std::vector<int64_t>> output_shapes;
+};
+
+// A fused subgraph, and the engines built for the input shapes it ran with.
+struct TensorrtSubgraph {
+  // the function body of the fused node, whose input dimensions are set to the ones of each engine built
+  ONNX_NAMESPACE::ModelProto model_proto;
+  std::unordered_map<std::string, int> input_map;
+  std::unordered_map<std::string, int> output_map;
+  // whether each fused node input is an initializer, which isn't an engine input
+  std::vector<bool> input_is_initializer;
+  // the most recently used first. Runs share the ownership of the engine they use, which may be evicted meanwhile.
+  std::list<std::shared_ptr<TensorrtEngine>> engines;
+  OrtMutex engines_mutex;
 };
 
 // Information to construct kernel function state.
@@ -40,13 +108,7 @@ struct TensorrtFuncState {
   AllocateFunc test_allocate_func = nullptr;
   DestroyFunc test_release_func = nullptr;
   AllocatorHandle allocator = nullptr;
-  nvonnxparser::IParser* parser = nullptr;
-  nvinfer1::ICudaEngine* engine = nullptr;
-  nvinfer1::IExecutionContext* context = nullptr;
-  std::vector<std::vector<int>> input_info;
-  std::vector<std::vector<int>> output_info;
-  std::vector<std::vector<int64_t>> output_shapes;
-  OrtMutex* tensorrt_mu_ptr = nullptr;
+  TensorrtSubgraph* subgraph = nullptr;
 };
 
 // Logical device representation.
@@ -74,31 +136,32 @@ class TensorrtExecutionProvider : public IExecutionProvider {
     max_workspace_size_ = workspace_size;
   }
 
+  void SetMaxCachedEngines(const size_t max_cached_engines) {
+    max_cached_engines_ = max_cached_engines;
+  }
+
  private:
   int max_batch_size_ = 1;
   size_t max_workspace_size_ = 1 << 30;  // 1GB
   int max_parser_iterations_ = 6;
-
-  struct InferDeleter {
-    template <typename T>
-    void operator()(T* obj) const {
-      if (obj) {
-        obj->destroy();
-      }
-    }
-  };
+  // engines kept for each fused subgraph, beyond it the least recently used one is destroyed
+  size_t max_cached_engines_ = 4;
+  std::string engine_cache_path_;
+  bool fp16_enable_ = false;
+  bool int8_enable_ = false;
+  std::string int8_calibration_table_path_;
+  // content of the calibration table, read once by Compile
+  std::string int8_calibration_table_;
 
   template <typename T>
-  using unique_pointer = std::unique_ptr<T, InferDeleter>;
+  using unique_pointer = TensorrtUniquePtr<T>;
 
+  // serializes the engine builds, and the creation of runtime_
   OrtMutex tensorrt_mu_;
   int device_id_;
-  std::unordered_map<std::string, unique_pointer<nvonnxparser::IParser>> parsers_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::ICudaEngine>> engines_;
-  std::unordered_map<std::string, unique_pointer<nvinfer1::IExecutionContext>> contexts_;
-  std::unordered_map<std::string, std::vector<std::vector<int>>> input_info_;
-  std::unordered_map<std::string, std::vector<std::vector<int>>> output_info_;
-  std::unordered_map<std::string, std::vector<std::vector<int64_t>>> output_shapes_;
+  // deserializes the cached engines, it's created on the first cache hit and outlives the engines
+  unique_pointer<nvinfer1::IRuntime> runtime_;
+  std::unordered_map<std::string, std::unique_ptr<TensorrtSubgraph>> subgraphs_;
 
   /**Get IndexedSubGraph based on node list of the subgraph*/
   std::unique_ptr<IndexedSubGraph> GetSubGraph(SubGraph_t graph_nodes_index, int& kernels_index,
@@ -113,6 +176,34 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   */
   SubGraphCollection_t GetSupportedList(SubGraphCollection_t supported_nodes_list, int iterations, const int max_iterations,
                                         const onnxruntime::GraphViewer& graph, bool* early_termination) const;
+
+  /**
+  Get the engine cache file of a subgraph. Its name is made of everything the engine depends on: the serialized
+  subgraph, the TensorRT version, the GPU model and the builder settings, so that a change of any of them
+  misses the cache instead of loading a stale engine.
+  */
+  std::string GetEngineCacheFile(const std::string& engine_cache_path, const std::string& serialized_subgraph,
+                                 const nvinfer1::IBuilder& builder, int max_batch_size) const;
+
+  /**Deserialize an engine from the cache, returns nullptr if it's not there or can't be deserialized.*/
+  unique_pointer<nvinfer1::ICudaEngine> LoadEngine(const std::string& engine_cache_file);
+
+  /**Serialize an engine to the cache.*/
+  void SaveEngine(const std::string& engine_cache_file, nvinfer1::ICudaEngine& engine) const;
+
+  /**
+  Build (or load from the engine cache) an engine of a subgraph for inputs with the given non-batch dimensions,
+  and batch sizes up to max_batch_size.
+  */
+  common::Status BuildEngine(TensorrtSubgraph& subgraph, const std::vector<std::vector<int64_t>>& input_shapes,
+                             int max_batch_size, std::unique_ptr<TensorrtEngine>& engine);
+
+  /**
+  Get the most recently used engine of a subgraph that runs the given input shapes and batch size. If none does,
+  build one for these shapes, whose max batch size is the configured one or the next power of 2 covering batch_size.
+  */
+  common::Status GetEngine(TensorrtSubgraph& subgraph, const std::vector<std::vector<int64_t>>& input_shapes,
+                           int batch_size, std::shared_ptr<TensorrtEngine>& engine);
 };
 
 }  // namespace onnxruntime
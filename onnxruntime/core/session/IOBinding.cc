@@ -73,30 +73,103 @@ common::Status IOBinding::SynchronizeOutputs() {
   return Status::OK();
 }
 
-common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml_value) {
-  auto rc = Contains(output_names_, name);
+static common::Status BindOutputImpl(std::vector<std::string>& output_names, std::vector<OrtValue>& outputs,
+                                     std::vector<const OrtMemoryInfo*>& outputs_location, const std::string& name,
+                                     const OrtValue& ml_value, const OrtMemoryInfo* location) {
+  auto rc = Contains(output_names, name);
   if (rc.first) {
-    outputs_[rc.second] = ml_value;
+    outputs[rc.second] = ml_value;
+    outputs_location[rc.second] = location;
     return Status::OK();
   }
 
-  output_names_.push_back(name);
-  outputs_.push_back(ml_value);
+  output_names.push_back(name);
+  outputs.push_back(ml_value);
+  outputs_location.push_back(location);
   return Status::OK();
 }
 
+common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml_value) {
+  return BindOutputImpl(output_names_, outputs_, outputs_location_, name, ml_value, nullptr);
+}
+
+common::Status IOBinding::BindOutput(const std::string& name, OrtDevice device) {
+  // unallocated outputs are returned on CPU by default
+  const OrtMemoryInfo* location = nullptr;
+  if (device != OrtDevice()) {
+    for (const auto& xp : session_state_.GetExecutionProviders()) {
+      auto allocator = xp->GetAllocator(device.Id(), OrtMemTypeDefault);
+      if (allocator != nullptr && allocator->Info().device == device) {
+        location = &allocator->Info();
+        break;
+      }
+    }
+
+    if (location == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No execution provider of the session allocates on the "
+                             "device of type ", static_cast<int>(device.Type()), " and id ", device.Id(),
+                             " to bind output ", name);
+    }
+  }
+
+  return BindOutputImpl(output_names_, outputs_, outputs_location_, name, OrtValue(), location);
+}
+
+void IOBinding::ClearInputs() {
+  feed_names_.clear();
+  feeds_.clear();
+}
+
+void IOBinding::ClearOutputs() {
+  output_names_.clear();
+  outputs_.clear();
+  outputs_location_.clear();
+}
+
 const std::vector<std::string>& IOBinding::GetOutputNames() const {
   return output_names_;
 }
 
 std::vector<OrtValue>& IOBinding::GetOutputs() { return outputs_; }
 
+const std::vector<OrtValue>& IOBinding::GetOutputs() const { return outputs_; }
+
+common::Status IOBinding::CopyOutputsToCpu(std::vector<OrtValue>& cpu_outputs) const {
+  cpu_outputs.clear();
+  cpu_outputs.reserve(outputs_.size());
+
+  AllocatorPtr cpu_allocator;
+  std::vector<IDataTransfer::SrcDstPair> copy_pairs;
+  for (const auto& output : outputs_) {
+    if (!output.IsTensor() || output.Get<Tensor>().Location().device.Type() == OrtDevice::CPU) {
+      cpu_outputs.push_back(output);
+      continue;
+    }
+
+    if (cpu_allocator == nullptr) {
+      cpu_allocator = session_state_.GetExecutionProviders().Get(onnxruntime::kCpuExecutionProvider)
+                          ->GetAllocator(0, OrtMemTypeDefault);
+    }
+
+    const Tensor& tensor = output.Get<Tensor>();
+    OrtValue cpu_output;
+    cpu_output.Init(new Tensor(tensor.DataType(), tensor.Shape(), cpu_allocator), DataTypeImpl::GetType<Tensor>(),
+                    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    copy_pairs.push_back({tensor, *cpu_output.GetMutable<Tensor>()});
+    cpu_outputs.push_back(cpu_output);
+  }
+
+  return session_state_.GetDataTransferMgr().CopyTensors(copy_pairs);
+}
+
 const std::vector<std::string>& IOBinding::GetInputNames() const {
   return feed_names_;
 }
 
 const std::vector<OrtValue>& IOBinding::GetInputs() const { return feeds_; }
 
+const std::vector<const OrtMemoryInfo*>& IOBinding::GetOutputLocations() const { return outputs_location_; }
+
 AllocatorPtr IOBinding::GetCPUAllocator(int id, onnxruntime::ProviderType provider_type) const {
   auto& exec_providers = session_state_.GetExecutionProviders();
   auto* p_provider = exec_providers.Get(provider_type);
@@ -63,15 +63,38 @@ class IOBinding {
     */
   common::Status BindOutput(const std::string& name, const OrtValue& ml_value);
 
+  /**
+    * Binds an output that is allocated by Run() on the given device, and stays there, instead of being copied to CPU.
+    * The device must be the one of an allocator of an execution provider of the session.
+    */
+  common::Status BindOutput(const std::string& name, OrtDevice device);
+
+  /**
+    * Remove all the bound inputs or outputs, to bind a different set for the next Run().
+    */
+  void ClearInputs();
+  void ClearOutputs();
+
   /**
     * This simply collects the outputs obtained after calling Run() inside the @param outputs.
     */
   const std::vector<std::string>& GetOutputNames() const;
   std::vector<OrtValue>& GetOutputs();
+  const std::vector<OrtValue>& GetOutputs() const;
+
+  /**
+    * The outputs, with the tensors that are on a device copied to CPU.
+    */
+  common::Status CopyOutputsToCpu(std::vector<OrtValue>& cpu_outputs) const;
 
   const std::vector<std::string>& GetInputNames() const;
   const std::vector<OrtValue>& GetInputs() const;
 
+  /**
+    * The location each output is allocated in when it's not preallocated, nullptr for the default of CPU.
+    */
+  const std::vector<const OrtMemoryInfo*>& GetOutputLocations() const;
+
   /**
     * Get a CPU allocator from provider for async copy later if the provider supports that
     * If it doesn't support that, return the default allocator from CPU provider
@@ -88,6 +111,7 @@ class IOBinding {
   std::vector<OrtValue> feeds_;
   std::vector<std::string> output_names_;
   std::vector<OrtValue> outputs_;
+  std::vector<const OrtMemoryInfo*> outputs_location_;
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 };
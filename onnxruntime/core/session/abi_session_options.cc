@@ -52,6 +52,35 @@ ORT_API_STATUS_IMPL(OrtApis::SetOptimizedModelFilePath, _In_ OrtSessionOptions*
   return nullptr;
 }
 
+// set filepath to write the optimization report to.
+ORT_API_STATUS_IMPL(OrtApis::SetOptimizationReportFilePath, _Inout_ OrtSessionOptions* options,
+                    _In_ const ORTCHAR_T* optimization_report_filepath) {
+  options->value.optimization_report_filepath = optimization_report_filepath;
+  return nullptr;
+}
+
+// place the nodes on the execution providers other than CPU where it is estimated to be faster.
+ORT_API_STATUS_IMPL(OrtApis::EnableCostBasedPartitioning, _Inout_ OrtSessionOptions* options,
+                    _In_opt_ const ORTCHAR_T* cost_filepath) {
+  options->value.enable_cost_based_partitioning = true;
+  options->value.partitioning_cost_filepath = cost_filepath == nullptr ? ORT_TSTR("") : cost_filepath;
+  return nullptr;
+}
+
+// back the large allocations of the default CPU execution provider with huge pages.
+ORT_API_STATUS_IMPL(OrtApis::EnableHugePages, _Inout_ OrtSessionOptions* options) {
+  options->value.use_huge_pages = true;
+  return nullptr;
+}
+
+// run the session at the end of its initialization.
+ORT_API_STATUS_IMPL(OrtApis::SetSessionWarmup, _Inout_ OrtSessionOptions* options, unsigned warmup_runs,
+                    _In_opt_ const ORTCHAR_T* warmup_inputs_path) {
+  options->value.warmup_runs = warmup_runs;
+  options->value.warmup_inputs_path = warmup_inputs_path == nullptr ? ORT_TSTR("") : warmup_inputs_path;
+  return nullptr;
+}
+
 // enable profiling for this session.
 ORT_API_STATUS_IMPL(OrtApis::EnableProfiling, _In_ OrtSessionOptions* options, _In_ const ORTCHAR_T* profile_file_prefix) {
   options->value.enable_profiling = true;
@@ -144,8 +173,39 @@ ORT_API_STATUS_IMPL(OrtApis::SetInterOpNumThreads, _In_ OrtSessionOptions* optio
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::DisablePerSessionThreads, _In_ OrtSessionOptions* options) {
+  options->value.use_per_session_threads = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpThreadAffinity, _Inout_ OrtSessionOptions* options,
+                    _In_ const int* logical_processors, size_t count) {
+  if (count > 0 && logical_processors == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "logical_processors is null");
+  }
+  options->value.intra_op_thread_affinity.assign(logical_processors, logical_processors + count);
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionNumaNode, _Inout_ OrtSessionOptions* options, int numa_node) {
+  if (numa_node < -1) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "numa_node must be -1 or a NUMA node number");
+  }
+  options->value.numa_node = numa_node;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::OrtAddFreeDimensionOverride, _Inout_ OrtSessionOptions* options,
                     _In_ const char* symbolic_dim, _In_ int64_t dim_override) {
   options->value.free_dimension_overrides.push_back(onnxruntime::FreeDimensionOverride{symbolic_dim, dim_override});
   return nullptr;
 }
+
+ORT_API_STATUS_IMPL(OrtApis::AddInitializer, _Inout_ OrtSessionOptions* options, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  if (name == nullptr || val == nullptr || !val->IsTensor()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "An initializer needs a name and a tensor");
+  }
+  options->value.initializers_to_share[name] = *val;
+  return nullptr;
+}
@@ -0,0 +1,352 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_inference_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include "core/framework/tensor.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+
+struct BatchingInferenceSession::Request {
+  const RunOptions* run_options;
+  const std::vector<std::string>* feed_names;
+  const std::vector<OrtValue>* feeds;
+  const std::vector<std::string>* output_names;
+  std::vector<OrtValue>* fetches;
+  int64_t batch_size;
+  std::chrono::steady_clock::time_point enqueue_time;
+  std::promise<Status> result;
+};
+
+namespace {
+
+// Copies num_blocks blocks of block_size elements, which are src_stride elements apart in src and dst_stride
+// elements apart in dst. The offsets and strides are in elements.
+void CopyBlocks(MLDataType type, const void* src, int64_t src_offset, int64_t src_stride,
+                void* dst, int64_t dst_offset, int64_t dst_stride, int64_t num_blocks, int64_t block_size) {
+  if (type == DataTypeImpl::GetType<std::string>()) {
+    const auto* src_strings = static_cast<const std::string*>(src) + src_offset;
+    auto* dst_strings = static_cast<std::string*>(dst) + dst_offset;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      std::copy_n(src_strings + b * src_stride, block_size, dst_strings + b * dst_stride);
+    }
+    return;
+  }
+
+  const auto element_size = static_cast<int64_t>(type->Size());
+  const auto* src_bytes = static_cast<const char*>(src) + src_offset * element_size;
+  auto* dst_bytes = static_cast<char*>(dst) + dst_offset * element_size;
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    memcpy(dst_bytes + b * dst_stride * element_size, src_bytes + b * src_stride * element_size,
+           static_cast<size_t>(block_size * element_size));
+  }
+}
+
+OrtValue MakeTensorValue(std::unique_ptr<Tensor> tensor) {
+  return OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+}  // namespace
+
+BatchingInferenceSession::BatchingInferenceSession(InferenceSession& session, const BatchingSessionOptions& options)
+    : session_{session}, options_{options}, allocator_{std::make_shared<CPUAllocator>()} {
+  ORT_ENFORCE(options_.batch_axis >= 0, "The batch axis must not be negative, got ", options_.batch_axis);
+  ORT_ENFORCE(options_.max_batch_size >= 1, "The maximum batch size must be at least 1, got ",
+              options_.max_batch_size);
+  if (options_.max_batch_size > 1) {
+    worker_ = std::thread(&BatchingInferenceSession::WorkerLoop, this);
+  }
+}
+
+BatchingInferenceSession::~BatchingInferenceSession() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+common::Status BatchingInferenceSession::Run(const RunOptions& run_options,
+                                             const std::vector<std::string>& feed_names,
+                                             const std::vector<OrtValue>& feeds,
+                                             const std::vector<std::string>& output_names,
+                                             std::vector<OrtValue>* p_fetches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+
+  // a request that fills a batch on its own gains nothing from waiting for others
+  const int64_t batch_size = p_fetches->empty() ? BatchSize(feeds) : -1;
+  if (batch_size < 0 || batch_size >= options_.max_batch_size) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_requests;
+      ++stats_.num_runs;
+    }
+    return session_.Run(run_options, feed_names, feeds, output_names, p_fetches);
+  }
+
+  Request request;
+  request.run_options = &run_options;
+  request.feed_names = &feed_names;
+  request.feeds = &feeds;
+  request.output_names = &output_names;
+  request.fetches = p_fetches;
+  request.batch_size = batch_size;
+  request.enqueue_time = std::chrono::steady_clock::now();
+  auto result = request.result.get_future();
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    queue_.push_back(&request);
+  }
+  cv_.notify_all();
+
+  return result.get();
+}
+
+BatchingInferenceSession::Stats BatchingInferenceSession::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return stats_;
+}
+
+int64_t BatchingInferenceSession::BatchSize(const std::vector<OrtValue>& feeds) const {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return -1;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.Location().device.Type() != OrtDevice::CPU ||
+        static_cast<int64_t>(shape.NumDimensions()) <= options_.batch_axis) {
+      return -1;
+    }
+
+    const int64_t size = shape[options_.batch_axis];
+    if (size <= 0 || (batch_size != -1 && size != batch_size)) {
+      return -1;
+    }
+    batch_size = size;
+  }
+
+  return batch_size;
+}
+
+bool BatchingInferenceSession::IsCompatible(const Request& lhs, const Request& rhs) const {
+  if (lhs.run_options != rhs.run_options || *lhs.feed_names != *rhs.feed_names ||
+      *lhs.output_names != *rhs.output_names) {
+    return false;
+  }
+
+  for (size_t i = 0; i < lhs.feeds->size(); ++i) {
+    const auto& lhs_tensor = (*lhs.feeds)[i].Get<Tensor>();
+    const auto& rhs_tensor = (*rhs.feeds)[i].Get<Tensor>();
+    if (lhs_tensor.DataType() != rhs_tensor.DataType()) {
+      return false;
+    }
+
+    const auto& lhs_dims = lhs_tensor.Shape().GetDims();
+    const auto& rhs_dims = rhs_tensor.Shape().GetDims();
+    if (lhs_dims.size() != rhs_dims.size()) {
+      return false;
+    }
+    for (size_t d = 0; d < lhs_dims.size(); ++d) {
+      if (static_cast<int64_t>(d) != options_.batch_axis && lhs_dims[d] != rhs_dims[d]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void BatchingInferenceSession::DropExpiredRequests() {
+  const auto now = std::chrono::steady_clock::now();
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    if (now >= (*it)->run_options->deadline) {
+      ++stats_.num_requests;
+      ++stats_.num_expired;
+      (*it)->result.set_value(utils::DeadlineExceededStatus());
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+BatchingInferenceSession::Request* BatchingInferenceSession::NextRequest() const {
+  Request* next = queue_.front();
+  for (auto* request : queue_) {
+    if (request->run_options->priority > next->run_options->priority) {
+      next = request;
+    }
+  }
+  return next;
+}
+
+void BatchingInferenceSession::WorkerLoop() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+    DropExpiredRequests();
+    if (queue_.empty()) {
+      if (shutdown_) {
+        return;
+      }
+      continue;
+    }
+
+    // wait for enough requests compatible with the next one to fill a batch, or for the next one to reach the
+    // latency limit or its deadline
+    Request* const next = NextRequest();
+    const auto deadline = std::min(next->enqueue_time + options_.max_latency, next->run_options->deadline);
+    while (!shutdown_) {
+      int64_t batch_size = 0;
+      for (const auto* request : queue_) {
+        if (IsCompatible(*next, *request)) {
+          batch_size += request->batch_size;
+        }
+      }
+
+      const auto now = std::chrono::steady_clock::now();
+      if (batch_size >= options_.max_batch_size || now >= deadline) {
+        break;
+      }
+      cv_.wait_for(lock, deadline - now);
+    }
+
+    // the next request may have expired while waiting for the others, the next iteration drops it then
+    if (std::chrono::steady_clock::now() >= next->run_options->deadline) {
+      continue;
+    }
+
+    std::vector<Request*> batch{next};
+    int64_t batch_size = next->batch_size;
+    queue_.erase(std::find(queue_.begin(), queue_.end(), next));
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (IsCompatible(*next, **it) && batch_size + (*it)->batch_size <= options_.max_batch_size) {
+        batch_size += (*it)->batch_size;
+        batch.push_back(*it);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    stats_.num_requests += batch.size();
+
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+void BatchingInferenceSession::RunBatch(const std::vector<Request*>& batch) {
+  if (batch.size() > 1) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_runs;
+    }
+
+    Status status;
+    try {
+      status = RunBatched(batch);
+    } catch (const std::exception& ex) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+
+    if (status.IsOK()) {
+      for (auto* request : batch) {
+        request->result.set_value(Status::OK());
+      }
+      return;
+    }
+    // e.g. the model has a fixed batch size. Each request gets its own result from running it alone.
+  }
+
+  for (auto* request : batch) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_runs;
+    }
+    request->result.set_value(session_.Run(*request->run_options, *request->feed_names, *request->feeds,
+                                           *request->output_names, request->fetches));
+  }
+}
+
+common::Status BatchingInferenceSession::RunBatched(const std::vector<Request*>& batch) {
+  const auto axis = static_cast<size_t>(options_.batch_axis);
+  const Request& first = *batch.front();
+  int64_t total_size = 0;
+  for (const auto* request : batch) {
+    total_size += request->batch_size;
+  }
+
+  // concatenate the inputs along the batch axis
+  std::vector<OrtValue> feeds;
+  feeds.reserve(first.feeds->size());
+  for (size_t i = 0; i < first.feeds->size(); ++i) {
+    const auto& first_input = (*first.feeds)[i].Get<Tensor>();
+    std::vector<int64_t> dims = first_input.Shape().GetDims();
+    dims[axis] = total_size;
+    auto input = std::make_unique<Tensor>(first_input.DataType(), TensorShape(dims), allocator_);
+
+    const int64_t outer_size = input->Shape().SizeToDimension(axis);
+    const int64_t inner_size = input->Shape().SizeFromDimension(axis + 1);
+    int64_t offset = 0;
+    for (const auto* request : batch) {
+      const auto& tensor = (*request->feeds)[i].Get<Tensor>();
+      const int64_t block_size = request->batch_size * inner_size;
+      CopyBlocks(tensor.DataType(), tensor.DataRaw(), 0, block_size, input->MutableDataRaw(), offset * inner_size,
+                 total_size * inner_size, outer_size, block_size);
+      offset += request->batch_size;
+    }
+
+    feeds.push_back(MakeTensorValue(std::move(input)));
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(session_.Run(*first.run_options, *first.feed_names, feeds, *first.output_names, &fetches));
+
+  // split the outputs back along the batch axis
+  std::vector<std::vector<OrtValue>> results(batch.size());
+  for (const auto& fetch : fetches) {
+    if (!fetch.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Outputs that are not tensors can't be split into requests.");
+    }
+
+    const auto& output = fetch.Get<Tensor>();
+    const auto& shape = output.Shape();
+    if (output.Location().device.Type() != OrtDevice::CPU || shape.NumDimensions() <= axis ||
+        shape[axis] != total_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output of shape ", shape, " doesn't carry the batch axis of size ",
+                             total_size);
+    }
+
+    std::vector<int64_t> dims = shape.GetDims();
+    const int64_t outer_size = shape.SizeToDimension(axis);
+    const int64_t inner_size = shape.SizeFromDimension(axis + 1);
+    int64_t offset = 0;
+    for (size_t r = 0; r < batch.size(); ++r) {
+      dims[axis] = batch[r]->batch_size;
+      auto result = std::make_unique<Tensor>(output.DataType(), TensorShape(dims), allocator_);
+      const int64_t block_size = batch[r]->batch_size * inner_size;
+      CopyBlocks(output.DataType(), output.DataRaw(), offset * inner_size, total_size * inner_size,
+                 result->MutableDataRaw(), 0, block_size, outer_size, block_size);
+      offset += batch[r]->batch_size;
+      results[r].push_back(MakeTensorValue(std::move(result)));
+    }
+  }
+
+  for (size_t r = 0; r < batch.size(); ++r) {
+    *batch[r]->fetches = std::move(results[r]);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
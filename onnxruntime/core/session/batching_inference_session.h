@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+struct BatchingSessionOptions {
+  // Axis of the inputs the requests are concatenated along, and of the outputs they are split back along.
+  int64_t batch_axis = 0;
+
+  // Maximum size of the batch axis summed over the requests run together. A request with more is run on its own.
+  int64_t max_batch_size = 8;
+
+  // Maximum time the first request of a batch waits for more requests to arrive.
+  std::chrono::microseconds max_latency{1000};
+};
+
+/**
+ * Merges the concurrent Run calls on a session into a single Run, for applications that embed the session in their
+ * own serving framework and get requests of a single or a few samples each.
+ * Requests are run together when they use the same inputs, outputs and run options, and their inputs are CPU tensors
+ * matching in type and in every dimension but the batch axis. The batched outputs are split back along the batch axis;
+ * if one of them doesn't carry the batch axis, or the batched Run fails, the requests are run one by one instead.
+ * The queued requests are run in the order of their RunOptions::priority, and the ones whose RunOptions::deadline
+ * has passed are dropped before they are run, so an overloaded session sheds the requests it can't run in time.
+ *
+ * Example:
+ *  BatchingSessionOptions options;
+ *  options.max_batch_size = 16;
+ *  options.max_latency = std::chrono::milliseconds(2);
+ *  BatchingInferenceSession batching_session(session, options);
+ *  // from any number of threads
+ *  batching_session.Run(run_options, feed_names, feeds, output_names, &fetches);
+ */
+class BatchingInferenceSession {
+ public:
+  struct Stats {
+    uint64_t num_requests = 0;
+    uint64_t num_runs = 0;
+    // requests dropped from the queue as their deadline had passed
+    uint64_t num_expired = 0;
+  };
+
+  // session must be initialized, and outlive this object.
+  BatchingInferenceSession(InferenceSession& session, const BatchingSessionOptions& options);
+
+  // Completes the requests already queued.
+  ~BatchingInferenceSession();
+
+  /**
+    * Blocks until the request has been run, batched with the concurrent ones or on its own. Thread-safe.
+    * The outputs are new values in CPU memory, and a request with preallocated outputs is run on its own.
+    * See InferenceSession::Run.
+    */
+  common::Status Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                     const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>* p_fetches);
+
+  Stats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BatchingInferenceSession);
+
+  struct Request;
+
+  // The size of the batch axis of the inputs, or -1 if the request can't be batched.
+  int64_t BatchSize(const std::vector<OrtValue>& feeds) const;
+  bool IsCompatible(const Request& lhs, const Request& rhs) const;
+  // Completes the queued requests whose deadline has passed with an error. Called with mutex_ held.
+  void DropExpiredRequests();
+  // The queued request of the highest priority, the oldest among equals. Called with mutex_ held.
+  Request* NextRequest() const;
+  void WorkerLoop();
+  void RunBatch(const std::vector<Request*>& batch);
+  // Runs the requests as one batch. Fails without setting any of their outputs if they can't be batched.
+  common::Status RunBatched(const std::vector<Request*>& batch);
+
+  InferenceSession& session_;
+  const BatchingSessionOptions options_;
+  AllocatorPtr allocator_;
+
+  mutable OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::deque<Request*> queue_;  // GUARDED_BY(mutex_)
+  bool shutdown_ = false;       // GUARDED_BY(mutex_)
+  Stats stats_;                 // GUARDED_BY(mutex_)
+  std::thread worker_;
+};
+
+}  // namespace onnxruntime
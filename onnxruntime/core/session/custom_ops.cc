@@ -51,6 +51,22 @@ ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetOutput, _Inout_ OrtKernelContext*
   return nullptr;
 };
 
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_ParallelFor, _Inout_ OrtKernelContext* context, _In_ OrtParallelForFn fn,
+                    _In_opt_ void* user_data, size_t total, double cost_per_unit) {
+  API_IMPL_BEGIN
+  auto* thread_pool = reinterpret_cast<onnxruntime::OpKernelContextInternal*>(context)->GetOperatorThreadPool();
+  if (thread_pool == nullptr) {
+    fn(user_data, 0, total);
+  } else {
+    thread_pool->ParallelFor(static_cast<std::ptrdiff_t>(total), cost_per_unit,
+                             [fn, user_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+                               fn(user_data, static_cast<size_t>(first), static_cast<size_t>(last));
+                             });
+  }
+  return nullptr;
+  API_IMPL_END
+};
+
 ORT_API_STATUS_IMPL(OrtApis::KernelInfoGetAttribute_string, _In_ const OrtKernelInfo* info, _In_ const char* name, _Out_ char* out, _Inout_ size_t* size) {
   std::string value;
   auto status = reinterpret_cast<const onnxruntime::OpKernelInfo*>(info)->GetAttr<std::string>(name, &value);
@@ -72,9 +88,9 @@ namespace onnxruntime {
 
 struct CustomOpKernel : OpKernel {
   CustomOpKernel(const OpKernelInfo& info, OrtCustomOp& op) : OpKernel(info), op_(op) {
-    if (op_.version != 1)
+    if (op_.version < 1 || op_.version > ORT_CUSTOM_OP_VERSION)
       throw std::invalid_argument("Unsupported version '" + std::to_string(op_.version) + "' in custom op '" + op.GetName(&op));
-    op_kernel_ = op_.CreateKernel(&op_, OrtGetApi(op_.version), reinterpret_cast<OrtKernelInfo*>(const_cast<OpKernelInfo*>(&info)));
+    op_kernel_ = op_.CreateKernel(&op_, OrtGetApi(ORT_API_VERSION), reinterpret_cast<OrtKernelInfo*>(const_cast<OpKernelInfo*>(&info)));
   }
 
   ~CustomOpKernel() override { op_.KernelDestroy(op_kernel_); }
@@ -92,6 +108,36 @@ struct CustomOpKernel : OpKernel {
   void* op_kernel_;
 };
 
+// Declares the in-place, alias and output memory hints of a custom op of version 2 the way built-in kernels do.
+static Status AddKernelDefHints(OrtCustomOp& op, size_t output_count, KernelDefBuilder& def_builder) {
+  for (size_t i = 0; i < output_count; i++) {
+    const int output_index = static_cast<int>(i);
+    if (op.GetMayInplaceInput) {
+      int input_index = op.GetMayInplaceInput(&op, i);
+      if (input_index >= 0)
+        def_builder.MayInplace(input_index, output_index);
+    }
+    if (op.GetAliasInput) {
+      int input_index = op.GetAliasInput(&op, i);
+      if (input_index >= 0)
+        def_builder.Alias(input_index, output_index);
+    }
+    if (op.GetOutputMemoryType) {
+      switch (op.GetOutputMemoryType(&op, i)) {
+        case OrtMemTypeDefault:
+          break;
+        case OrtMemTypeCPUOutput:
+          def_builder.OutputMemoryType<OrtMemTypeCPUOutput>(output_index);
+          break;
+        default:
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Custom op '", op.GetName(&op), "' output ", i,
+                                 " must be in OrtMemTypeDefault or OrtMemTypeCPUOutput memory");
+      }
+    }
+  }
+  return Status::OK();
+}
+
 common::Status CreateCustomRegistry(const std::vector<OrtCustomOpDomain*>& op_domains, std::shared_ptr<CustomRegistry>& output) {
   output = std::make_shared<CustomRegistry>();
 
@@ -133,6 +179,8 @@ common::Status CreateCustomRegistry(const std::vector<OrtCustomOpDomain*>& op_do
         def_builder.Provider(provider_type);
       else
         def_builder.Provider(onnxruntime::kCpuExecutionProvider);
+      if (op->version >= 2)
+        ORT_RETURN_IF_ERROR(AddKernelDefHints(*op, output_count, def_builder));
 
       KernelCreateFn kernel_create_fn = [&op](const OpKernelInfo& info) -> OpKernel* { return new CustomOpKernel(info, *op); };
       KernelCreateInfo create_info(def_builder.Build(), kernel_create_fn);
@@ -5,6 +5,7 @@
 #include "core/framework/allocatormgr.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
+#include "core/util/thread_utils.h"
 #include "onnx/defs/operator_sets.h"
 #include "onnx/defs/operator_sets-ml.h"
 #ifndef DISABLE_CONTRIB_OPS
@@ -28,6 +29,20 @@ Status Environment::Create(std::unique_ptr<Environment>& environment) {
   return status;
 }
 
+Status Environment::Create(std::unique_ptr<Environment>& environment, const ThreadingOptions& threading_options) {
+  ORT_RETURN_IF_ERROR(Create(environment));
+
+  auto& env = *environment;
+  env.create_global_thread_pools_ = true;
+  env.intra_op_thread_pool_ = concurrency::CreateThreadPool("env_global_intra_op_thread_pool",
+                                                            threading_options.intra_op_num_threads,
+                                                            threading_options.intra_op_thread_options);
+  env.inter_op_thread_pool_ = concurrency::CreateThreadPool("env_global_inter_op_thread_pool",
+                                                            threading_options.inter_op_num_threads,
+                                                            threading_options.inter_op_thread_options);
+  return Status::OK();
+}
+
 Status Environment::Initialize() {
   auto status = Status::OK();
 
@@ -36,6 +51,7 @@ Status Environment::Initialize() {
     std::call_once(schemaRegistrationOnceFlag, []() {
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSDomain, 1, 1);
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSNchwcDomain, 1, 1);
+      ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSNhwcDomain, 1, 1);
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSAutoMLDomain, 1, 1);
       // Register contributed schemas.
       // The corresponding kernels are registered inside the appropriate execution provider.
@@ -51,27 +67,37 @@ Status Environment::Initialize() {
 
     // Register MemCpy schema;
 
-    // These ops are internal-only, so register outside of onnx
+    // These ops are internal-only, so register outside of onnx.
+    // Output i is the copy of input i, several tensors crossing devices at the same point share one copy node.
+    auto propagate_memcpy_shapes_and_types = [](InferenceContext& ctx) {
+      for (size_t i = 0; i < ctx.getNumInputs(); ++i) {
+        propagateElemTypeFromInputToOutput(ctx, i, i);
+        if (hasInputShape(ctx, i)) {
+          propagateShapeFromInputToOutput(ctx, i, i);
+        }
+      }
+    };
+
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyFromHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "input", "T", OpSchema::Variadic, false)
+        .Output(0, "Y", "output", "T", OpSchema::Variadic, false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(propagate_memcpy_shapes_and_types)
         .SetDoc(R"DOC(
 Internal copy node
 )DOC");
 
     ORT_ATTRIBUTE_UNUSED ONNX_OPERATOR_SCHEMA(MemcpyToHost)
-        .Input(0, "X", "input", "T")
-        .Output(0, "Y", "output", "T")
+        .Input(0, "X", "input", "T", OpSchema::Variadic, false)
+        .Output(0, "Y", "output", "T", OpSchema::Variadic, false)
         .TypeConstraint(
             "T",
             OpSchema::all_tensor_types(),
             "Constrain to any tensor type. If the dtype attribute is not provided this must be a valid output type.")
-        .TypeAndShapeInferenceFunction(propagateShapeAndTypeFromFirstInput)
+        .TypeAndShapeInferenceFunction(propagate_memcpy_shapes_and_types)
         .SetDoc(R"DOC(
 Internal copy node
 )DOC");
@@ -87,6 +113,9 @@ Internal copy node
 }
 
 Environment::~Environment() {
+  // the threads of the pools stop before protobuf shuts down
+  inter_op_thread_pool_.reset();
+  intra_op_thread_pool_.reset();
   ::google::protobuf::ShutdownProtobufLibrary();
 }
 
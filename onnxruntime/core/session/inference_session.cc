@@ -7,6 +7,8 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -21,13 +23,18 @@
 #include "core/graph/graph_viewer.h"
 #include "core/graph/graph_utils.h"
 #include "core/graph/model.h"
+#include "core/graph/model_composer.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/framework/allocatormgr.h"
+#include "core/framework/bfc_arena.h"
 #include "core/framework/customregistry.h"
 #include "core/session/environment.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/graph_partitioner.h"
+#include "core/framework/partition_cost_model.h"
+#include "core/framework/path_lib.h"
 #include "core/framework/kernel_def_builder.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -37,20 +44,27 @@
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/parallel_executor.h"
 #include "core/framework/session_state_initializer.h"
+#include "core/framework/sparse_tensor.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/utils.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/optimizer/static_quantization_transformer.h"
+#include "core/optimizer/weight_only_quantization_transformer.h"
+#include "core/optimizer/optimization_report.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "core/session/custom_ops.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
+#include "core/platform/env.h"
 #include "core/util/thread_utils.h"
 
 using namespace ONNX_NAMESPACE;
@@ -90,23 +104,157 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+// Model metadata entry recording the node placement of a serialized optimized model, so that reloading it can
+// skip graph transformation and partitioning.
+constexpr const char* kOptimizedNodePlacementKey = "onnxruntime.optimized_node_placement";
+
+std::vector<std::string> SplitPlacementList(const std::string& list) {
+  std::vector<std::string> items;
+  size_t begin = 0;
+  for (size_t end = list.find(','); end != std::string::npos; end = list.find(',', begin)) {
+    items.push_back(list.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return items;
+}
+
+// The placement is "<provider>,...;<provider of node 0>,<provider of node 1>,..." where nodes are listed in the
+// topological order Graph::ToGraphProto serializes them in, which is the node index order once reloaded.
+// Returns false if the placement can't be replayed, i.e. the graph has fused nodes or subgraphs.
+bool EncodeNodePlacement(const Graph& graph, const ExecutionProviders& providers, std::string& placement) {
+  std::ostringstream oss;
+  for (const auto& provider : providers.GetIds()) {
+    oss << provider << ',';
+  }
+  oss << ';';
+
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node& node = *graph.GetNode(node_index);
+    if (node.NodeType() == Node::Type::Fused || node.ContainsSubgraph()) {
+      return false;
+    }
+    oss << node.GetExecutionProviderType() << ',';
+  }
+
+  placement = oss.str();
+  return true;
+}
+
+// Assign the recorded providers to the nodes of a freshly loaded optimized model. Nothing is changed unless the
+// placement matches the graph and the registered providers exactly.
+bool RestoreNodePlacement(Graph& graph, const ExecutionProviders& providers, const std::string& placement) {
+  const auto separator = placement.find(';');
+  if (separator == std::string::npos ||
+      SplitPlacementList(placement.substr(0, separator)) != providers.GetIds()) {
+    return false;
+  }
+
+  const auto node_providers = SplitPlacementList(placement.substr(separator + 1));
+  if (node_providers.size() != static_cast<size_t>(graph.MaxNodeIndex()) ||
+      graph.NumberOfNodes() != graph.MaxNodeIndex()) {
+    return false;
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    if (node.ContainsSubgraph() || node_providers[node.Index()].empty()) {
+      return false;
+    }
+  }
+
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(node_providers[node.Index()]);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+namespace {
+// the Environment whose thread pools the session uses, or nullptr if the session creates its own
+const Environment* GetThreadPoolsEnvironment(const SessionOptions& session_options, const Environment* session_env) {
+  if (session_options.use_per_session_threads) {
+    return nullptr;
+  }
+
+  ORT_ENFORCE(session_env != nullptr && session_env->HasGlobalThreadPools(),
+              "use_per_session_threads is false but the session wasn't created with an Environment "
+              "that has global thread pools.");
+  return session_env;
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateIntraOpThreadPool(const SessionOptions& session_options) {
+  int thread_pool_size = session_options.intra_op_num_threads;
+  concurrency::ThreadOptions thread_options;
+  thread_options.affinity = session_options.intra_op_thread_affinity;
+  thread_options.section_spin_duration_us = session_options.intra_op_spin_duration_us;
+
+  if (session_options.numa_node >= 0) {
+    auto node_processors = Env::Default().GetNumaNodeProcessors(session_options.numa_node);
+    ORT_ENFORCE(!node_processors.empty(), "NUMA node ", session_options.numa_node,
+                " doesn't exist or the NUMA topology isn't available.");
+    if (thread_options.affinity.empty()) {
+      thread_options.affinity = node_processors;
+    }
+    if (thread_pool_size <= 0) {
+      thread_pool_size = static_cast<int>(node_processors.size());
+    }
+  }
+
+  return concurrency::CreateThreadPool("intra_op_thread_pool", thread_pool_size, thread_options);
+}
+
+// apply a transformer the session runs itself, recording it like the ones of the GraphTransformerManager
+Status ApplyTransformer(const GraphTransformer& transformer, Graph& graph, bool& modified,
+                        profiling::Profiler& profiler, OptimizationReport* report) {
+  const int node_count_before = graph.NumberOfNodes();
+  auto tp = profiler.StartTime();
+  if (report != nullptr) report->BeforeApply(graph);
+  ORT_RETURN_IF_ERROR(transformer.Apply(graph, modified));
+  if (report != nullptr) {
+    report->AfterApply(transformer, static_cast<int>(TransformerLevel::Default), graph, modified);
+  }
+  if (profiler.IsEnabled()) {
+    profiler.EndTimeAndRecordEvent(profiling::SESSION_EVENT, transformer.Name(), tp,
+                                   {{"node_count_before", std::to_string(node_count_before)},
+                                    {"node_count_after", std::to_string(graph.NumberOfNodes())}});
+  }
+  return Status::OK();
+}
 }  // namespace
 
 InferenceSession::InferenceSession(const SessionOptions& session_options,
                                    logging::LoggingManager* logging_manager)
+    : InferenceSession(session_options, nullptr, logging_manager) {
+}
+
+InferenceSession::InferenceSession(const SessionOptions& session_options, const Environment& session_env,
+                                   logging::LoggingManager* logging_manager)
+    : InferenceSession(session_options, &session_env, logging_manager) {
+}
+
+InferenceSession::InferenceSession(const SessionOptions& session_options, const Environment* session_env,
+                                   logging::LoggingManager* logging_manager)
     : session_options_{session_options},
       graph_transformation_mgr_{session_options.max_num_graph_transformation_steps},
       logging_manager_{logging_manager},
-      thread_pool_(concurrency::CreateThreadPool("intra_op_thread_pool",
-                                                 session_options.intra_op_num_threads)),
-      inter_op_thread_pool_(!session_options.enable_sequential_execution
+      thread_pool_(GetThreadPoolsEnvironment(session_options, session_env) == nullptr
+                       ? CreateIntraOpThreadPool(session_options)
+                       : nullptr),
+      inter_op_thread_pool_(GetThreadPoolsEnvironment(session_options, session_env) == nullptr &&
+                                    !session_options.enable_sequential_execution
                                 ? concurrency::CreateThreadPool("inter_op_thread_pool",
                                                                 session_options.inter_op_num_threads)
                                 : nullptr),
       session_state_(execution_providers_,
-                     session_options.enable_mem_pattern && session_options.enable_sequential_execution,
-                     thread_pool_.get(),
-                     inter_op_thread_pool_.get()),
+                     session_options.enable_mem_pattern,
+                     session_options.use_per_session_threads ? thread_pool_.get()
+                                                             : session_env->GetIntraOpThreadPool(),
+                     session_options.use_per_session_threads
+                         ? inter_op_thread_pool_.get()
+                         : (session_options.enable_sequential_execution ? nullptr
+                                                                        : session_env->GetInterOpThreadPool())),
       insert_cast_transformer_{"CastFloat16Transformer"} {
   ORT_ENFORCE(Environment::IsInitialized(),
               "Environment must be initialized before creating an InferenceSession.");
@@ -114,6 +262,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
   InitLogger(logging_manager);
 
   session_state_.SetDataTransferMgr(&data_transfer_mgr_);
+  session_state_.SetMemoryPatternCacheOptions(session_options.mem_pattern_cache_size,
+                                              session_options.mem_pattern_dim_buckets);
+  session_state_.SetMaxExecutionFrames(session_options.execution_frame_pool_size);
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
   if (session_options.enable_profiling) {
@@ -122,6 +273,9 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
 }
 
 InferenceSession::~InferenceSession() {
+  // the pool completes the pending Runs of RunAsync before its threads exit
+  async_run_thread_pool_.reset();
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -240,7 +394,13 @@ common::Status InferenceSession::Load(const std::basic_string<T>& model_uri) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    auto model_proto = std::make_unique<ModelProto>();
+    auto tp = session_profiler_.StartTime();
+    ORT_RETURN_IF_ERROR(onnxruntime::Model::Load(model_location_, *model_proto));
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_proto_parsing", tp);
+    }
+    return CreateModel(std::move(model_proto), model);
   };
 
   common::Status st = Load(loader, "model_loading_uri");
@@ -270,7 +430,7 @@ common::Status InferenceSession::Load(const ModelProto& model_proto) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return CreateModel(std::make_unique<ModelProto>(model_proto), model);
   };
 
   return Load(loader, "model_loading_proto");
@@ -284,30 +444,65 @@ common::Status InferenceSession::Load(std::unique_ptr<ModelProto> p_model_proto)
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(std::move(p_model_proto), model,
-                                    HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return CreateModel(std::move(p_model_proto), model);
   };
 
   return Load(loader, "model_loading_proto");
 }
 
+common::Status InferenceSession::LoadComposed(
+    const std::vector<std::basic_string<ORTCHAR_T>>& model_uris,
+    const std::vector<std::unordered_map<std::string, std::string>>& input_maps) {
+  if (model_uris.empty() || (!input_maps.empty() && input_maps.size() != model_uris.size())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected one input map per model, or none, got ",
+                           input_maps.size(), " for ", model_uris.size(), " models.");
+  }
+
+  model_location_ = ToWideString(model_uris.front());
+  auto loader = [this, &model_uris, &input_maps](std::shared_ptr<onnxruntime::Model>& model) {
+    auto tp = session_profiler_.StartTime();
+    std::vector<ModelProto> model_protos(model_uris.size());
+    std::vector<ModelCompositionStage> stages(model_uris.size());
+    for (size_t i = 0; i < model_uris.size(); ++i) {
+      ORT_RETURN_IF_ERROR(onnxruntime::Model::Load(model_uris[i], model_protos[i]));
+      stages[i].model = &model_protos[i];
+      if (!input_maps.empty()) {
+        stages[i].input_map = input_maps[i];
+      }
+    }
+
+    auto model_proto = std::make_unique<ModelProto>();
+    ORT_RETURN_IF_ERROR(ComposeModels(stages, *model_proto));
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_proto_parsing", tp);
+    }
+    return CreateModel(std::move(model_proto), model);
+  };
+
+  return Load(loader, "model_loading_composed");
+}
+
 common::Status InferenceSession::Load(std::istream& model_istream) {
   auto loader = [this, &model_istream](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    auto model_proto = std::make_unique<ModelProto>();
 
+    auto tp = session_profiler_.StartTime();
     google::protobuf::io::IstreamInputStream zero_copy_input(&model_istream);
-    const bool result = model_proto.ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
+    const bool result = model_proto->ParseFromZeroCopyStream(&zero_copy_input) && model_istream.eof();
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_proto_parsing", tp);
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return CreateModel(std::move(model_proto), model);
   };
 
   return Load(loader, "model_loading_istream");
@@ -315,32 +510,66 @@ common::Status InferenceSession::Load(std::istream& model_istream) {
 
 common::Status InferenceSession::Load(const void* model_data, int model_data_len) {
   auto loader = [this, model_data, model_data_len](std::shared_ptr<onnxruntime::Model>& model) {
-    ModelProto model_proto;
+    auto model_proto = std::make_unique<ModelProto>();
 
-    const bool result = model_proto.ParseFromArray(model_data, model_data_len);
+    auto tp = session_profiler_.StartTime();
+    const bool result = model_proto->ParseFromArray(model_data, model_data_len);
     if (!result) {
       return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
                     "Failed to load model because protobuf parsing failed.");
     }
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_proto_parsing", tp);
+    }
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
-    LoadInterOp(model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
+    LoadInterOp(*model_proto, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
     for (const auto& domain : interop_domains_) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
 
-    return onnxruntime::Model::Load(model_proto, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    return CreateModel(std::move(model_proto), model);
   };
 
   return Load(loader, "model_loading_array");
 }
 
+common::Status InferenceSession::CreateModel(std::unique_ptr<ModelProto> p_model_proto,
+                                             std::shared_ptr<onnxruntime::Model>& model) {
+  // we expect a graph to be present
+  if (!utils::HasGraph(*p_model_proto)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "No graph was found in the protobuf.");
+  }
+
+  auto tp = session_profiler_.StartTime();
+  try {
+    model = std::make_shared<onnxruntime::Model>(std::move(p_model_proto),
+                                                 HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+  } catch (const std::exception& ex) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                  "Failed to load model with error: " + std::string(ex.what()));
+  }
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_construction", tp,
+                                            {{"node_count", std::to_string(model->MainGraph().NumberOfNodes())}});
+  }
+
+  tp = session_profiler_.StartTime();
+  ORT_RETURN_IF_ERROR(model->MainGraph().Resolve(true));
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_resolve", tp);
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
                                                 const onnxruntime::GraphTransformerManager& graph_transformer_mgr,
                                                 const ExecutionProviders& providers,
                                                 KernelRegistryManager& kernel_registry_manager,
                                                 const InsertCastTransformer& insert_cast_transformer,
-                                                SessionState& session_state) {
+                                                SessionState& session_state,
+                                                OptimizationReport* report) {
   // The transformer order:
   // 1. built-in graph rewriter
   // 2. each execution provider's transformer
@@ -349,21 +578,55 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
   // 5. insert cast nodes.
 
   // first apply global(execution provider independent),  level 1(default/system/basic) graph to graph optimizations
-  ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1));
+  ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, TransformerLevel::Level1, &session_profiler_, report));
 
   // Do partitioning based on execution providers' capability.
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  std::unique_ptr<PartitionCostModel> cost_model;
+  if (session_options_.enable_cost_based_partitioning) {
+    cost_model = std::make_unique<PartitionCostModel>();
+    if (!session_options_.partitioning_cost_filepath.empty()) {
+      ORT_RETURN_IF_ERROR(cost_model->Load(session_options_.partitioning_cost_filepath));
+    }
+  }
+
+  GraphPartitioner partitioner(kernel_registry_manager, providers, &session_profiler_, cost_model.get());
   ORT_RETURN_IF_ERROR(partitioner.Partition(graph, session_state.ExportDll(), session_state.GetMutableFuncMgr()));
 
+  if (cost_model && !session_options_.partitioning_cost_filepath.empty()) {
+    ORT_RETURN_IF_ERROR(cost_model->Save(session_options_.partitioning_cost_filepath));
+  }
+
   // apply transformers except default transformers
   // Default transformers are required for correctness and they are owned and run by inference session
   for (int i = static_cast<int>(TransformerLevel::Level1); i < static_cast<int>(TransformerLevel::MaxTransformerLevel); i++) {
-    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i)));
+    ORT_RETURN_IF_ERROR(graph_transformer_mgr.ApplyTransformers(graph, static_cast<TransformerLevel>(i),
+                                                                &session_profiler_, report));
   }
 
   bool modified = false;
+  // Convert the eligible nodes to float16 first, the casts of the float16 nodes on CPU come after.
+  if (session_options_.enable_mixed_precision) {
+    MixedPrecisionTransformer mixed_precision_transformer{kernel_registry_manager,
+                                                          session_options_.mixed_precision_allow_list,
+                                                          session_options_.mixed_precision_deny_list};
+    ORT_RETURN_IF_ERROR(ApplyTransformer(mixed_precision_transformer, graph, modified, session_profiler_, report));
+  }
+
+  // Quantize the CPU nodes with calibrated ranges, before the casts which the quantized graph may need.
+  if (!session_options_.static_quantization_ranges.empty()) {
+    StaticQuantizationTransformer static_quantization_transformer{session_options_.static_quantization_ranges};
+    ORT_RETURN_IF_ERROR(ApplyTransformer(static_quantization_transformer, graph, modified, session_profiler_, report));
+  }
+
+  // Store the remaining float weights on CPU as int8, after the nodes the static quantization converted.
+  if (session_options_.enable_weight_only_quantization) {
+    WeightOnlyQuantizationTransformer weight_only_quantization_transformer;
+    ORT_RETURN_IF_ERROR(ApplyTransformer(weight_only_quantization_transformer, graph, modified, session_profiler_,
+                                         report));
+  }
+
   // Insert cast node/s.
-  ORT_RETURN_IF_ERROR(insert_cast_transformer.Apply(graph, modified));
+  ORT_RETURN_IF_ERROR(ApplyTransformer(insert_cast_transformer, graph, modified, session_profiler_, report));
 
   // Now every node should be already assigned to an execution provider
   for (auto& node : graph.Nodes()) {
@@ -386,7 +649,7 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph,
 
   // Insert copy node/s.
   MemcpyTransformer copy_transformer{provider_types, kernel_registry_manager};
-  ORT_RETURN_IF_ERROR(copy_transformer.Apply(graph, modified));
+  ORT_RETURN_IF_ERROR(ApplyTransformer(copy_transformer, graph, modified, session_profiler_, report));
 
   return common::Status::OK();
 }
@@ -406,6 +669,9 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
                                                                    session_state.GetInterOpThreadPool());
       subgraph_session_state->SetProfiler(session_profiler_);
       subgraph_session_state->SetLogger(*session_logger_);
+      subgraph_session_state->SetMemoryPatternCacheOptions(session_state.GetMaxMemoryPatterns(),
+                                                           session_state.GetMemoryPatternDimBuckets());
+      subgraph_session_state->SetMaxExecutionFrames(session_state.GetMaxExecutionFrames());
       // Pass data transfer manager to subgraph.
       subgraph_session_state->SetDataTransferMgr(&session_state.GetDataTransferMgr());
       // Pass fused function manager to subgraph
@@ -489,10 +755,24 @@ common::Status InferenceSession::Initialize() {
     if (!execution_providers_.Get(onnxruntime::kCpuExecutionProvider)) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.numa_node = session_options_.numa_node;
+      epi.use_huge_pages = session_options_.use_huge_pages;
+      epi.use_bf16_matmul = session_options_.use_bf16_matmul;
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
     }
 
+    // the providers that time their kernels on the device, used once profiling is started
+    for (auto& xp : execution_providers_) {
+      auto ep_profiler = xp->GetProfiler();
+      if (ep_profiler != nullptr) {
+        session_profiler_.AddEpProfiler(xp->Type(), std::move(ep_profiler));
+      }
+    }
+
+    // Report the MLAS kernels chosen for this processor so performance can be compared across hosts.
+    LOGS(*session_logger_, INFO) << "MLAS kernel selection: " << MlasGetKernelSelection();
+
     if (!session_options_.enable_sequential_execution &&
         execution_providers_.Get(onnxruntime::kCudaExecutionProvider)) {
       LOGS(*session_logger_, ERROR) << "Parallel execution is currently not supported "
@@ -517,23 +797,86 @@ common::Status InferenceSession::Initialize() {
     // Register 2nd registries into KernelRegistryManager.
     ORT_RETURN_IF_ERROR(kernel_registry_manager_.RegisterKernels(execution_providers_));
 
+    // the shared initializers are looked up before the transformations, so that the ones they replace are known
+    std::unordered_map<std::string, const ONNX_NAMESPACE::TensorProto*> shared_initializer_protos;
+    for (const auto& entry : session_options_.initializers_to_share) {
+      const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+      if (!graph.GetInitializedTensor(entry.first, tensor_proto)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The shared initializer ", entry.first,
+                               " is not an initializer of the main graph.");
+      }
+      shared_initializer_protos[entry.first] = tensor_proto;
+    }
+
+    std::unordered_map<std::string, OrtValue> initializers_to_share;
     SessionStateInitializer session_initializer(session_options_.enable_mem_pattern, model_location_, graph,
-                                                session_state_, execution_providers_, kernel_registry_manager_);
+                                                session_state_, execution_providers_, kernel_registry_manager_,
+                                                &initializers_to_share);
 
     // create SessionState for subgraphs as it's needed by the transformers
     ORT_RETURN_IF_ERROR(CreateSubgraphSessionState(graph, session_state_));
 
-    // apply any transformations to the main graph and any subgraphs
-    ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
-                                       execution_providers_, kernel_registry_manager_,
-                                       insert_cast_transformer_,
-                                       session_state_));
+    std::unique_ptr<OptimizationReport> optimization_report;
+    if (!session_options_.optimization_report_filepath.empty()) {
+      optimization_report = std::make_unique<OptimizationReport>();
+    }
+
+    // a model saved through optimized_model_filepath is already transformed and records where each node was
+    // placed, so reloading it only needs the placement to be restored.
+    const auto& model_metadata = model_->MetaData();
+    auto placement = model_metadata.find(kOptimizedNodePlacementKey);
+    if (placement != model_metadata.cend() &&
+        RestoreNodePlacement(graph, execution_providers_, placement->second)) {
+      LOGS(*session_logger_, INFO) << "Restored node placement of the optimized model. Skipping graph transformation.";
+    } else {
+      // apply any transformations to the main graph and any subgraphs
+      ORT_RETURN_IF_ERROR(TransformGraph(graph, graph_transformation_mgr_,
+                                         execution_providers_, kernel_registry_manager_,
+                                         insert_cast_transformer_,
+                                         session_state_, optimization_report.get()));
+    }
 
     // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
+    auto resolve_tp = session_profiler_.StartTime();
     ORT_RETURN_IF_ERROR(graph.Resolve());
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_resolve", resolve_tp);
+    }
+
+    if (optimization_report) {
+      optimization_report->SetFinalGraph(graph);
+      std::ofstream report_file(session_options_.optimization_report_filepath, std::ios::out | std::ios::trunc);
+      if (!report_file) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to open the optimization report file ",
+                               ToMBString(session_options_.optimization_report_filepath));
+      }
+      optimization_report->WriteJson(report_file);
+    }
+
+    // a transformation replaces an initializer with a new TensorProto, which the shared value doesn't match.
+    // the replaced TensorProtos are kept by the graph until its initializers are cleaned, so the addresses are unique.
+    for (const auto& entry : shared_initializer_protos) {
+      const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+      if (!graph.GetInitializedTensor(entry.first, tensor_proto)) {
+        continue;
+      }
+      if (tensor_proto != entry.second) {
+        LOGS(*session_logger_, WARNING) << "The shared initializer " << entry.first
+                                        << " was replaced by graph transformation and is loaded from the model.";
+        continue;
+      }
+      initializers_to_share[entry.first] = session_options_.initializers_to_share.at(entry.first);
+    }
 
     if (!session_options_.optimized_model_filepath.empty()) {
       if (session_options_.graph_optimization_level < TransformerLevel::Level3) {
+        std::string node_placement;
+        // an empty placement invalidates one that may have been loaded with the model.
+        if (!EncodeNodePlacement(graph, execution_providers_, node_placement)) {
+          node_placement.clear();
+        }
+        model_->SetMetaDataEntry(kOptimizedNodePlacementKey, node_placement);
+
         // Serialize optimized ONNX model.
         ORT_RETURN_IF_ERROR(Model::Save(*model_, session_options_.optimized_model_filepath));
       } else {
@@ -544,10 +887,54 @@ common::Status InferenceSession::Initialize() {
 
     ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.enable_sequential_execution));
 
+    if (session_options_.enable_node_stats) {
+      node_stats_recorder_ = std::make_unique<NodeStatsRecorder>(graph.MaxNodeIndex());
+      session_state_.SetNodeStatsRecorder(node_stats_recorder_.get());
+    }
+
+    if (session_options_.enable_calibration) {
+      calibration_collector_ = std::make_unique<CalibrationCollector>();
+      session_state_.SetCalibrationCollector(calibration_collector_.get());
+    }
+
+    if (session_options_.enable_shape_subgraph_cache) {
+      shape_subgraph_cache_ = std::make_unique<ShapeSubgraphCache>(session_state_);
+      if (shape_subgraph_cache_->NumCachedNodes() == 0) {
+        shape_subgraph_cache_.reset();
+      }
+      session_state_.SetShapeSubgraphCache(shape_subgraph_cache_.get());
+    }
+
     // handle any subgraphs
     ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
+
+    if (session_options_.enable_graph_capture) {
+      ORT_RETURN_IF_ERROR(InitializeGraphCapture(graph));
+    }
     is_inited_ = true;
 
+    if (session_options_.warmup_runs > 0) {
+      // the session isn't ready unless the warmup succeeds
+      try {
+        status = WarmUp();
+      } catch (...) {
+        is_inited_ = false;
+        throw;
+      }
+      if (!status.IsOK()) {
+        is_inited_ = false;
+        return status;
+      }
+    }
+
+    if (session_options_.use_huge_pages) {
+      size_t bytes_in_use = 0;
+      size_t max_bytes_in_use = 0;
+      GetArenaUsage(bytes_in_use, max_bytes_in_use);
+      LOGS(*session_logger_, INFO) << GetHugePageBytes() << " bytes of the arenas are backed by huge pages, "
+                                   << bytes_in_use << " bytes are in use.";
+    }
+
     LOGS(*session_logger_, INFO) << "Session successfully initialized.";
   } catch (const NotImplementedException& ex) {
     status = ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Exception during initialization: ", ex.what());
@@ -566,6 +953,249 @@ common::Status InferenceSession::Initialize() {
   return status;
 }
 
+Status InferenceSession::InitializeGraphCapture(const Graph& graph) {
+  const std::string* provider_type = nullptr;
+  for (const auto& node : graph.Nodes()) {
+    if (node.ContainsSubgraph()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Graph capture doesn't support the control flow node ",
+                             node.Name(), " (", node.OpType(), ").");
+    }
+    if (provider_type == nullptr) {
+      provider_type = &node.GetExecutionProviderType();
+    } else if (*provider_type != node.GetExecutionProviderType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Graph capture requires all the nodes to be assigned"
+                             " to one execution provider, but they are assigned to both ", *provider_type, " and ",
+                             node.GetExecutionProviderType(), ".");
+    }
+  }
+
+  if (provider_type != nullptr) {
+    for (auto& xp : execution_providers_) {
+      if (xp->Type() == *provider_type) {
+        graph_capture_provider_ = xp.get();
+      }
+    }
+  }
+  if (graph_capture_provider_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Graph capture requires a model with nodes.");
+  }
+
+  LOGS(*session_logger_, INFO) << "Capturing the Runs of the session with " << *provider_type;
+  return Status::OK();
+}
+
+Status InferenceSession::WarmUp() {
+  auto tp = session_profiler_.StartTime();
+  const auto& graph_inputs = model_->MainGraph().GetInputs();
+  auto allocator = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault);
+
+  NameMLValMap feeds;
+  // the buffers of the inputs loaded from files, and the callbacks releasing their external data
+  std::vector<std::unique_ptr<char[]>> buffers;
+  std::vector<OrtCallback> deleters;
+  Status status;
+  if (!session_options_.warmup_inputs_path.empty()) {
+    for (size_t i = 0; status.IsOK(); ++i) {
+      const auto file_path = ConcatPathComponent<ORTCHAR_T>(session_options_.warmup_inputs_path,
+                                                            ToWideString("input_" + std::to_string(i) + ".pb"));
+      std::ifstream stream(file_path, std::ios::binary);
+      if (!stream) {
+        break;
+      }
+
+      ONNX_NAMESPACE::TensorProto tensor_proto;
+      if (!tensor_proto.ParseFromIstream(&stream)) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to parse the warmup input ",
+                                 ToMBString(file_path));
+        break;
+      }
+
+      // an unnamed input is the input of the graph at the same position
+      std::string name = tensor_proto.name();
+      if (name.empty() && i < graph_inputs.size()) {
+        name = graph_inputs[i]->Name();
+      }
+
+      size_t length = 0;
+      status = utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &length);
+      if (status.IsOK()) {
+        buffers.emplace_back(new char[length]);
+        OrtValue value;
+        OrtCallback deleter{nullptr, nullptr};
+        status = utils::TensorProtoToMLValue(Env::Default(), file_path.c_str(), tensor_proto,
+                                             MemBuffer(buffers.back().get(), length, allocator->Info()), value,
+                                             deleter);
+        if (deleter.f != nullptr) {
+          deleters.push_back(deleter);
+        }
+        feeds[name] = value;
+      }
+    }
+
+    if (status.IsOK() && feeds.empty()) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No warmup input ",
+                               ToMBString(session_options_.warmup_inputs_path), "/input_0.pb was found.");
+    }
+  } else {
+    for (const auto* input : graph_inputs) {
+      const auto* type = input->TypeAsProto();
+      if (type == nullptr || !type->has_tensor_type() || input->Shape() == nullptr) {
+        LOGS(*session_logger_, WARNING) << "Skipping the warmup: inputs can't be generated for the input "
+                                        << input->Name() << ", which isn't a tensor of known rank.";
+        return Status::OK();
+      }
+
+      std::vector<int64_t> dims;
+      for (const auto& dim : input->Shape()->dim()) {
+        dims.push_back(dim.has_dim_value() ? dim.dim_value() : 1);
+      }
+      MLDataType element_type = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType();
+      auto tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), allocator);
+      if (element_type != DataTypeImpl::GetType<std::string>()) {
+        memset(tensor->MutableDataRaw(), 0, tensor->SizeInBytes());
+      }
+
+      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+      feeds[input->Name()].Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+    }
+  }
+
+  std::vector<std::string> output_names;
+  for (const auto* output : output_def_list_) {
+    output_names.push_back(output->Name());
+  }
+
+  RunOptions run_options;
+  run_options.run_tag = "warmup";
+  for (unsigned i = 0; status.IsOK() && i < session_options_.warmup_runs; ++i) {
+    std::vector<OrtValue> fetches;
+    status = Run(run_options, feeds, output_names, &fetches);
+  }
+
+  for (auto& deleter : deleters) {
+    OrtRunCallback(&deleter);
+  }
+
+  if (!status.IsOK()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Warmup failed: ", status.ErrorMessage());
+  }
+
+  // the statistics are those of the Runs of the user
+  if (node_stats_recorder_ != nullptr) {
+    node_stats_recorder_->Reset();
+  }
+  if (calibration_collector_ != nullptr) {
+    calibration_collector_->Reset();
+  }
+
+  LOGS(*session_logger_, INFO) << "Warmed up the session with " << session_options_.warmup_runs << " Runs.";
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "warmup", tp,
+                                            {{"runs", std::to_string(session_options_.warmup_runs)}});
+  }
+  return Status::OK();
+}
+
+// Number of Runs executed normally for the shapes and buffers of a graph before it is captured, so that
+// the work done once, such as the algorithm search of the kernels or the growth of the arena, isn't captured.
+static constexpr size_t kRunsBeforeGraphCapture = 1;
+
+// A Run can only be captured when its feeds and fetches are tensors on the device of the provider and the
+// fetches are preallocated, as a replay reads and writes the buffers of the captured Run. The key holds their
+// indices, shapes and buffers, so that a replay always executes the same work on the same memory.
+static bool GetGraphCaptureKey(const IExecutionProvider& provider, const FeedsFetchesManager& feeds_fetches_manager,
+                               const std::vector<OrtValue>& feeds, const std::vector<OrtValue>& fetches,
+                               std::vector<int64_t>& key) {
+  const OrtDevice device = provider.GetAllocator(0, OrtMemTypeDefault)->Info().device;
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  if (fetches.size() != info.fetches_mlvalue_idxs.size()) {
+    return false;
+  }
+
+  auto add_tensor = [&device, &key](int idx, const OrtValue& value) {
+    if (!value.IsAllocated() || !value.IsTensor()) {
+      return false;
+    }
+    const Tensor& tensor = value.Get<Tensor>();
+    if (tensor.Location().device != device) {
+      return false;
+    }
+    const auto& dims = tensor.Shape().GetDims();
+    key.push_back(idx);
+    key.push_back(static_cast<int64_t>(dims.size()));
+    key.insert(key.end(), dims.cbegin(), dims.cend());
+    key.push_back(static_cast<int64_t>(reinterpret_cast<intptr_t>(tensor.DataRaw())));
+    return true;
+  };
+
+  key.clear();
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!add_tensor(info.feeds_mlvalue_idxs[i], feeds[i])) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    if (!add_tensor(info.fetches_mlvalue_idxs[i], fetches[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status InferenceSession::ExecuteGraphWithCapture(FeedsFetchesManager& feeds_fetches_manager, bool copy_info_finalized,
+                                                 const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                                 const RunOptions& run_options, const logging::Logger& run_logger) {
+  auto execute_graph = [&]() {
+    if (copy_info_finalized) {
+      return utils::ExecuteGraphWithFinalizedCopyInfo(session_state_, feeds_fetches_manager, feeds, fetches,
+                                                      session_options_.enable_sequential_execution,
+                                                      run_options.terminate, run_logger);
+    }
+    return utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, fetches,
+                               session_options_.enable_sequential_execution, run_options.terminate, run_logger);
+  };
+
+  std::vector<int64_t> key;
+  if (!GetGraphCaptureKey(*graph_capture_provider_, feeds_fetches_manager, feeds, fetches, key)) {
+    return execute_graph();
+  }
+
+  // the replays of a graph share its buffers, so the Runs that may capture or replay are serialized
+  std::lock_guard<OrtMutex> lock(captured_graphs_mutex_);
+  CapturedGraphInfo& captured = captured_graphs_[key];
+  if (captured.graph != nullptr) {
+    return captured.graph->Replay();
+  }
+  if (captured.capture_failed || captured.num_runs++ < kRunsBeforeGraphCapture) {
+    return execute_graph();
+  }
+
+  Status status = graph_capture_provider_->BeginGraphCapture();
+  if (status.IsOK()) {
+    try {
+      status = execute_graph();
+    } catch (const std::exception& ex) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    }
+
+    std::unique_ptr<CapturedGraph> graph;
+    Status capture_status = graph_capture_provider_->EndGraphCapture(graph);
+    if (status.IsOK() && capture_status.IsOK()) {
+      captured.graph = std::move(graph);
+      return captured.graph->Replay();
+    }
+    if (status.IsOK()) {
+      status = capture_status;
+    }
+  }
+
+  // none of the work was executed while capturing, so the Run is executed again without the graph
+  LOGS(run_logger, WARNING) << "Executing the Runs with these inputs without graph capture, as it failed: "
+                            << status.ErrorMessage();
+  captured.capture_failed = true;
+  return execute_graph();
+}
+
 int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
@@ -625,6 +1255,43 @@ static common::Status CheckTypes(MLDataType actual, MLDataType expected) {
                 "Unexpected input data type. Actual: (" + actual_name + ") , expected: (" + expected_name + ")");
 }
 
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, MLDataType expected_type,
+                                               const TensorShape& expected_shape,
+                                               const OrtValue& input_ml_value) const {
+  if (input_ml_value.IsTensor()) {
+    // check for type
+    if (!expected_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
+                             feed_name, " is not expected to be of type tensor.");
+    }
+
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
+
+    // check for shape
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
+    }
+  } else if (input_ml_value.IsSparseTensor()) {
+    // as for a tensor, the value holds the generic sparse tensor type and the element type is checked
+    if (!expected_type->IsSparseTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
+                             feed_name, " is not expected to be of type sparse tensor.");
+    }
+
+    auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
+    auto input_element_type = input_ml_value.Get<SparseTensor>().Values().DataType();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
+  } else {
+    auto input_type = input_ml_value.Type();
+    ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::ValidateInputs(const std::vector<std::string>& feed_names,
                                                 const std::vector<OrtValue>& feeds) const {
   if (feed_names.size() != feeds.size()) {
@@ -643,29 +1310,7 @@ common::Status InferenceSession::ValidateInputs(const std::vector<std::string>&
                              "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds.at(i);
-    if (input_ml_value.IsTensor()) {
-      // check for type
-      if (!expected_type->IsTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ",
-                               feed_name, " is not expected to be of type tensor.");
-      }
-
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_element_type, expected_element_type));
-
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR(CheckTypes(input_type, expected_type));
-    }
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_name, iter->second.ml_data_type, iter->second.tensor_shape, feeds[i]));
   }
 
   return Status::OK();
@@ -703,30 +1348,25 @@ common::Status InferenceSession::ValidateOutputs(const std::vector<std::string>&
   return common::Status::OK();
 }
 
-Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
-                             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
-                             std::vector<OrtValue>* p_fetches) {
+Status InferenceSession::ExecuteRun(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                                    bool copy_info_finalized, const std::vector<OrtValue>& feeds,
+                                    std::vector<OrtValue>& fetches) {
+  // a Run that can't complete in time doesn't take the threads from the ones that still can
+  if (std::chrono::steady_clock::now() >= run_options.deadline) {
+    LOGS(*session_logger_, WARNING) << "Not running as the deadline of the Run has passed.";
+    return utils::DeadlineExceededStatus();
+  }
+
   auto tp = session_profiler_.StartTime();
   Status retval = Status::OK();
 
-  try {
-    if (!is_inited_) {
-      LOGS(*session_logger_, ERROR) << "Session was not initialized";
-      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
-    }
-
-    ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
-    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
-
-    FeedsFetchesInfo info(feed_names, output_names, session_state_.GetOrtValueNameIdxMap());
-    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+  ++current_num_runs_;
 
+  try {
     if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
 
-    ++current_num_runs_;
-
     // TODO should we add this exec to the list of executors? i guess its not needed now?
 
     // scope of owned_run_logger is just the call to Execute.
@@ -740,11 +1380,37 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
       ORT_CHECK_AND_SET_RETVAL(xp->OnRunStart());
     }
 
+    // cap the intra-op threads the kernels of this Run use
+    concurrency::ThreadPool::ScopedParallelismLimit parallelism_limit(run_options.intra_op_num_threads);
+    // stop the kernels of this Run at its deadline
+    concurrency::ThreadPool::ScopedDeadline deadline(run_options.deadline);
+
+    // the executors collect the ranges of the node outputs, the graph inputs are collected here
+    if (calibration_collector_ != nullptr) {
+      const auto& feed_names = feeds_fetches_manager.GetFeedsFetchesInfo().feed_names;
+      for (size_t i = 0; i < feeds.size(); ++i) {
+        if (feeds[i].IsTensor()) {
+          calibration_collector_->Collect(feed_names[i], feeds[i].Get<Tensor>());
+        }
+      }
+    }
+
     // execute the graph
-    ORT_CHECK_AND_SET_RETVAL(
-        utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                            session_options_.enable_sequential_execution,
-                            run_options.terminate, run_logger));
+    if (graph_capture_provider_ != nullptr) {
+      ORT_CHECK_AND_SET_RETVAL(
+          ExecuteGraphWithCapture(feeds_fetches_manager, copy_info_finalized, feeds, fetches, run_options,
+                                  run_logger));
+    } else if (copy_info_finalized) {
+      ORT_CHECK_AND_SET_RETVAL(
+          utils::ExecuteGraphWithFinalizedCopyInfo(session_state_, feeds_fetches_manager, feeds, fetches,
+                                                   session_options_.enable_sequential_execution,
+                                                   run_options.terminate, run_logger));
+    } else {
+      ORT_CHECK_AND_SET_RETVAL(
+          utils::ExecuteGraph(session_state_, feeds_fetches_manager, feeds, fetches,
+                              session_options_.enable_sequential_execution,
+                              run_options.terminate, run_logger));
+    }
 
   } catch (const std::exception& e) {
     retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
@@ -760,11 +1426,171 @@ Status InferenceSession::Run(const RunOptions& run_options, const std::vector<st
   --current_num_runs_;
   if (session_profiler_.IsEnabled()) {
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run", tp);
+
+    // the high-water marks of the arenas, which the memory events of the Runs attribute to values and nodes
+    for (const auto& xp : execution_providers_) {
+      for (const auto& allocator : xp->GetAllocators()) {
+        const auto* arena = dynamic_cast<const BFCArena*>(allocator.get());
+        if (arena == nullptr) continue;
+
+        TimePoint now = session_profiler_.StartTime();
+        session_profiler_.EndTimeAndRecordEvent(profiling::MEMORY_EVENT, "arena_peak", now,
+                                                {{"provider", xp->Type()},
+                                                 {"location", arena->Info().name},
+                                                 {"bytes_in_use", std::to_string(arena->Used())},
+                                                 {"max_bytes_in_use", std::to_string(arena->MaxUsed())}});
+      }
+    }
+
+    // the device events of this Run are recorded once the device has completed them, by a later Run if need be
+    session_profiler_.CollectEpEvents();
   }
 
   return retval;
 }
 
+Status InferenceSession::Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                             const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                             std::vector<OrtValue>* p_fetches) {
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+
+  try {
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
+    ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, p_fetches));
+
+    FeedsFetchesInfo info(feed_names, output_names, session_state_.GetOrtValueNameIdxMap());
+    feeds_fetches_manager = std::make_unique<FeedsFetchesManager>(std::move(info));
+  } catch (const std::exception& e) {
+    return Status(common::ONNXRUNTIME, common::FAIL, e.what());
+  } catch (...) {
+    return Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+  }
+
+  return ExecuteRun(run_options, *feeds_fetches_manager, /*copy_info_finalized*/ false, feeds, *p_fetches);
+}
+
+common::Status InferenceSession::NewPreparedRun(const std::vector<std::string>& feed_names,
+                                                const std::vector<std::string>& output_names,
+                                                const std::vector<const OrtMemoryInfo*>& feed_locations,
+                                                const std::vector<const OrtMemoryInfo*>& fetch_locations,
+                                                std::unique_ptr<PreparedRun>* prepared_run) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  if (!feed_locations.empty() && feed_locations.size() != feed_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: feed_names has ", feed_names.size(),
+                           " elements, but feed_locations has ", feed_locations.size(), " elements.");
+  }
+
+  if (!fetch_locations.empty() && fetch_locations.size() != output_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: output_names has ", output_names.size(),
+                           " elements, but fetch_locations has ", fetch_locations.size(), " elements.");
+  }
+
+  // private constructor, can't use make_unique
+  std::unique_ptr<PreparedRun> prepared{new PreparedRun()};
+
+  prepared->expected_inputs_.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Invalid Feed Input Name:", feed_name);
+    }
+    prepared->expected_inputs_.push_back({iter->second.ml_data_type, iter->second.tensor_shape});
+  }
+
+  const std::vector<OrtValue> no_fetches;
+  ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &no_fetches));
+
+  auto& feeds_fetches_manager = prepared->feeds_fetches_manager_;
+  ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                                  feeds_fetches_manager));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state_, *feeds_fetches_manager));
+
+  // the copy info is finalized here for the given devices, instead of for the values of each Run
+  prepared->check_devices_ = feeds_fetches_manager->GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy;
+  std::vector<const OrtMemoryInfo*> fetch_alloc_info = fetch_locations;
+  fetch_alloc_info.resize(output_names.size(), nullptr);
+  prepared->feed_devices_.resize(feed_names.size());
+  for (size_t i = 0; i < feed_locations.size(); ++i) {
+    if (feed_locations[i] != nullptr) {
+      prepared->feed_devices_[i] = feed_locations[i]->device;
+    }
+  }
+  prepared->fetch_devices_.reserve(output_names.size());
+  for (const auto* alloc_info : fetch_alloc_info) {
+    prepared->fetch_devices_.push_back(alloc_info != nullptr ? alloc_info->device : OrtDevice());
+  }
+  utils::FinalizeFeedFetchCopyInfo(session_state_, *feeds_fetches_manager, prepared->feed_devices_,
+                                   fetch_alloc_info);
+
+  *prepared_run = std::move(prepared);
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  const auto& feed_names = prepared_run.GetInputNames();
+  if (feed_names.size() != feeds.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Size mismatch: the prepared run has ", feed_names.size(),
+                           " inputs, but feeds has ", feeds.size(), " elements.");
+  }
+
+  const auto& output_names = prepared_run.GetOutputNames();
+  if (p_fetches == nullptr) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                          "Output vector pointer is NULL");
+  }
+  if (!p_fetches->empty() && output_names.size() != p_fetches->size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Output vector incorrectly sized: the prepared run has ", output_names.size(),
+                           " outputs, p_fetches->size(): ", p_fetches->size());
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& expected = prepared_run.expected_inputs_[i];
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_names[i], expected.ml_data_type, expected.tensor_shape, feeds[i]));
+
+    if (prepared_run.check_devices_ && feeds[i].IsTensor() &&
+        feeds[i].Get<Tensor>().Location().device != prepared_run.feed_devices_[i]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_names[i],
+                             " is not on the device the prepared run was created for.");
+    }
+  }
+
+  if (prepared_run.check_devices_) {
+    for (size_t i = 0; i < p_fetches->size(); ++i) {
+      const auto& fetch = (*p_fetches)[i];
+      if (fetch.IsAllocated() && fetch.IsTensor() &&
+          fetch.Get<Tensor>().Location().device != prepared_run.fetch_devices_[i]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output with name: ", output_names[i],
+                               " is not on the device the prepared run was created for.");
+      }
+    }
+  }
+
+  // the copy info isn't modified by a Run with its finalized copy info, which lets concurrent Runs share it
+  return ExecuteRun(run_options, *prepared_run.feeds_fetches_manager_, /*copy_info_finalized*/ true,
+                    feeds, *p_fetches);
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, const std::vector<std::string>& output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -787,6 +1613,58 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches);
 }
 
+void InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names,
+                                std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  concurrency::ThreadPool* thread_pool;
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(async_run_mutex_);
+    if (async_run_thread_pool_ == nullptr) {
+      int num_threads = session_options_.inter_op_num_threads;
+      if (num_threads <= 0) {
+        num_threads = std::max<int>(1, std::thread::hardware_concurrency() / 2);
+      }
+      async_run_thread_pool_ = std::make_unique<concurrency::ThreadPool>("async_run_thread_pool", num_threads);
+    }
+    thread_pool = async_run_thread_pool_.get();
+  }
+
+  // the lambda is copied by the pool, so the arguments are moved into a shared state instead of captured.
+  // the run options are copied, the caller may release them once RunAsync returns.
+  struct AsyncRun {
+    RunOptions run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+  auto async_run = std::make_shared<AsyncRun>();
+  async_run->run_options.run_log_severity_level = run_options.run_log_severity_level;
+  async_run->run_options.run_log_verbosity_level = run_options.run_log_verbosity_level;
+  async_run->run_options.run_tag = run_options.run_tag;
+  async_run->run_options.terminate = run_options.terminate;
+  async_run->run_options.intra_op_num_threads = run_options.intra_op_num_threads;
+  async_run->run_options.deadline = run_options.deadline;
+  async_run->run_options.priority = run_options.priority;
+  async_run->feed_names = std::move(feed_names);
+  async_run->feeds = std::move(feeds);
+  async_run->output_names = std::move(output_names);
+  async_run->fetches = std::move(fetches);
+  async_run->callback = std::move(callback);
+
+  thread_pool->Schedule([this, async_run]() {
+    Status status;
+    try {
+      status = Run(async_run->run_options, async_run->feed_names, async_run->feeds, async_run->output_names,
+                   &async_run->fetches);
+    } catch (const std::exception& ex) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+    }
+    async_run->callback(status, async_run->fetches);
+  });
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -858,8 +1736,56 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
-             io_binding.GetOutputNames(), &io_binding.GetOutputs());
+  const auto& output_locations = io_binding.GetOutputLocations();
+  if (std::all_of(output_locations.cbegin(), output_locations.cend(),
+                  [](const OrtMemoryInfo* location) { return location == nullptr; })) {
+    return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
+               io_binding.GetOutputNames(), &io_binding.GetOutputs());
+  }
+
+  // some outputs are allocated on a device, so the copy info is finalized with their locations instead of the CPU
+  // default of unallocated outputs
+  const auto& feed_names = io_binding.GetInputNames();
+  const auto& feeds = io_binding.GetInputs();
+  const auto& output_names = io_binding.GetOutputNames();
+  auto& fetches = io_binding.GetOutputs();
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager;
+
+  try {
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
+    ORT_RETURN_IF_ERROR(ValidateInputs(feed_names, feeds));
+    ORT_RETURN_IF_ERROR(ValidateOutputs(output_names, &fetches));
+
+    ORT_RETURN_IF_ERROR(FeedsFetchesManager::Create(feed_names, output_names, session_state_.GetOrtValueNameIdxMap(),
+                                                    feeds_fetches_manager));
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state_, *feeds_fetches_manager));
+
+    std::vector<OrtDevice> feed_locations(feeds.size());
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      if (feeds[i].IsTensor()) {
+        feed_locations[i] = feeds[i].Get<Tensor>().Location().device;
+      }
+    }
+
+    std::vector<const OrtMemoryInfo*> fetch_alloc_info(output_locations);
+    for (size_t i = 0; i < fetches.size(); ++i) {
+      if (fetches[i].IsAllocated() && fetches[i].IsTensor()) {
+        fetch_alloc_info[i] = &fetches[i].Get<Tensor>().Location();
+      }
+    }
+
+    utils::FinalizeFeedFetchCopyInfo(session_state_, *feeds_fetches_manager, feed_locations, fetch_alloc_info);
+  } catch (const std::exception& e) {
+    return Status(common::ONNXRUNTIME, common::FAIL, e.what());
+  } catch (...) {
+    return Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
+  }
+
+  return ExecuteRun(run_options, *feeds_fetches_manager, /*copy_info_finalized*/ true, feeds, fetches);
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -901,6 +1827,85 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+void InferenceSession::GetArenaUsage(size_t& bytes_in_use, size_t& max_bytes_in_use) const {
+  bytes_in_use = 0;
+  max_bytes_in_use = 0;
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      const auto* arena = dynamic_cast<const BFCArena*>(allocator.get());
+      if (arena == nullptr) continue;
+
+      bytes_in_use += arena->Used();
+      max_bytes_in_use += arena->MaxUsed();
+    }
+  }
+}
+
+size_t InferenceSession::GetHugePageBytes() const {
+  size_t huge_page_bytes = 0;
+  for (const auto& xp : execution_providers_) {
+    for (const auto& allocator : xp->GetAllocators()) {
+      const auto* arena = dynamic_cast<const IArenaAllocator*>(allocator.get());
+      if (arena != nullptr) huge_page_bytes += arena->HugePageBytes();
+    }
+  }
+  return huge_page_bytes;
+}
+
+common::Status InferenceSession::GetNodeStats(std::vector<NodeStats>& node_stats) const {
+  node_stats.clear();
+  if (node_stats_recorder_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Node statistics are not collected. Set enable_node_stats in the SessionOptions.");
+  }
+
+  const auto& graph_viewer = *session_state_.GetGraphViewer();
+  for (auto& stats : node_stats_recorder_->GetStats()) {
+    const auto* node = graph_viewer.GetNode(stats.node_index);
+    if (node == nullptr || stats.count == 0) continue;
+
+    stats.node_name = node->Name();
+    stats.op_type = node->OpType();
+    node_stats.push_back(std::move(stats));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ResetNodeStats() {
+  if (node_stats_recorder_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Node statistics are not collected. Set enable_node_stats in the SessionOptions.");
+  }
+
+  node_stats_recorder_->Reset();
+  return Status::OK();
+}
+
+common::Status InferenceSession::GetCalibrationRanges(float percentile,
+                                                      std::unordered_map<std::string, TensorRange>& ranges) const {
+  if (calibration_collector_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Calibration ranges are not collected. Set enable_calibration in the SessionOptions.");
+  }
+  if (!(percentile > 0.f && percentile <= 100.f)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "percentile must be in (0, 100], got ", percentile);
+  }
+
+  ranges = calibration_collector_->GetRanges(percentile);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ResetCalibration() {
+  if (calibration_collector_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Calibration ranges are not collected. Set enable_calibration in the SessionOptions.");
+  }
+
+  calibration_collector_->Reset();
+  return Status::OK();
+}
+
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
   // TODO add other post load processing here
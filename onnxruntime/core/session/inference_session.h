@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
 #include <string>
 #include <unordered_map>
 
@@ -14,7 +16,10 @@
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/calibration_collector.h"
+#include "core/framework/node_stats_recorder.h"
 #include "core/framework/session_state.h"
+#include "core/framework/shape_subgraph_cache.h"
 #include "core/graph/basic_types.h"
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
@@ -38,9 +43,13 @@ struct OrtCustomOpDomain {
 
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
+class FeedsFetchesManager;
 class IOBinding;
+class PreparedRun;
 class CustomRegistry;
+class Environment;
 class Notification;
+class OptimizationReport;
 
 namespace logging {
 class LoggingManager;
@@ -64,13 +73,31 @@ struct SessionOptions {
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
+  // non empty filepath enables writing what each graph transformer did to the graph, and the op types and
+  // execution providers of the nodes of the final graph, to the specified filepath as JSON.
+  std::basic_string<ORTCHAR_T> optimization_report_filepath;
+
   // enable the memory pattern optimization.
   // The idea is if the input shapes are the same, we could trace the internal memory allocation
   // and generate a memory pattern for future request. So next time we could just do one allocation
   // with a big chunk for all the internal memory allocation.
-  // See class 'OrtValuePatternPlanner'.
+  // If the shapes of all the internal values are known, the pattern is computed at initialization instead.
+  // See classes 'OrtValuePatternPlanner' and 'StaticMemPatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // maximum number of memory patterns cached per graph. the least recently used pattern is evicted once
+  // the limit is reached. 0 means unbounded.
+  size_t mem_pattern_cache_size = 16;
+
+  // maximum number of execution frames, with their pre-allocated buffers, kept per graph for reuse by later
+  // Runs. frames released by concurrent Runs beyond it are freed. 0 disables the reuse.
+  size_t execution_frame_pool_size = 4;
+
+  // optional ascending bucket boundaries for the memory pattern cache. each input dimension is rounded up to
+  // the smallest boundary not less than it, so variable-length inputs within a bucket share a single pattern,
+  // and a pattern traced for a larger bucket is reused when there is none for the current one.
+  std::vector<int64_t> mem_pattern_dim_buckets;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
@@ -99,9 +126,111 @@ struct SessionOptions {
   // configuring this makes sense only when you're using parallel executor
   int inter_op_num_threads = 0;
 
+  // set to false to use the thread pools of the Environment instead of creating the session's own, so the
+  // sessions of a process share their threads. Requires the session to be created with an Environment that
+  // has global thread pools; intra_op_num_threads and inter_op_num_threads are ignored then.
+  bool use_per_session_threads = true;
+
+  // logical processors the threads of the session's intra-op thread pool are pinned to, the i-th thread to
+  // the (i % size)-th processor. Empty doesn't pin them, unless numa_node is set.
+  std::vector<int> intra_op_thread_affinity;
+
+  // time, in microseconds, the threads of the session's intra-op thread pool spin between the operators of a Run
+  // waiting for the next parallel loop, before they go back to the pool. Lower it, or set it to 0, on hosts where
+  // other processes need the cores that would be spinning.
+  int intra_op_spin_duration_us = 100;
+
+  // NUMA node the session runs on, -1 for none. The threads of the session's intra-op thread pool are pinned to
+  // the processors of the node if intra_op_thread_affinity is empty, the pool has as many threads as the node has
+  // processors if intra_op_num_threads is 0, and the memory of the default CPU execution provider is allocated
+  // on the node. Running one session per node keeps the threads and the memory of each session on one socket.
+  int numa_node = -1;
+
+  // back the large allocations of the default CPU execution provider, the regions of its arena including the ones
+  // holding the initializers, with huge pages: the ones reserved by the administrator if there are, else the
+  // transparent huge pages on Linux, and the large pages on Windows, which require the SeLockMemoryPrivilege. The
+  // allocations fall back to the usual pages when none are available. See InferenceSession::GetHugePageBytes.
+  bool use_huge_pages = false;
+
+  // let the float MatMul of the CPU execution provider multiply inputs rounded to bfloat16, accumulating in float,
+  // on processors with bfloat16 dot product instructions such as AVX512-BF16. Faster, but the results lose
+  // precision, so it is off by default. Processors without the instructions compute the full precision MatMul.
+  bool use_bf16_matmul = false;
+
+  // collect the count, kernel time and output bytes of every node of the main graph in lock-free counters.
+  // cheap enough to be left on, unlike enable_profiling. See InferenceSession::GetNodeStats.
+  bool enable_node_stats = false;
+
+  // copy the outputs of the nodes of the main graph that only depend on the outputs of Shape and Size nodes, such as
+  // the chains computing the targets of Reshape nodes in exported models, from an earlier Run with the same shapes
+  // instead of running them. See ShapeSubgraphCache.
+  bool enable_shape_subgraph_cache = true;
+
+  // place the nodes that an execution provider other than CPU claims on it only where it is estimated to be faster
+  // than leaving them to the CPU execution provider, including the copies between the two, instead of placing all
+  // of them. The estimates need the shapes of the values, which free_dimension_overrides can fix. See
+  // PartitionCostModel.
+  bool enable_cost_based_partitioning = false;
+
+  // file the decisions of the cost based partitioning are loaded from, if it exists, and saved to, so that the
+  // sessions of the same model with the same options reuse them. Default is empty for none.
+  std::basic_string<ORTCHAR_T> partitioning_cost_filepath;
+
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
+
+  // capture the device work of a Run into a graph of the execution provider, such as a CUDA graph, and replay it
+  // on later Runs with the same input shapes and the same input and output buffers, instead of executing the
+  // nodes. The inputs and the preallocated outputs have to be on the device, typically bound with IOBinding,
+  // otherwise the Run executes the nodes as usual. Requires all the nodes of the model to be assigned to one
+  // execution provider that supports graph capture, and no control flow nodes.
+  bool enable_graph_capture = false;
+
+  // run the float nodes placed on the CUDA execution provider in float16 where it has float16 kernels, with Cast
+  // nodes only at the edges of the converted regions. See MixedPrecisionTransformer.
+  bool enable_mixed_precision = false;
+
+  // op types converted to float16 by enable_mixed_precision. Default is empty, which uses the default list of
+  // MixedPrecisionTransformer.
+  std::vector<std::string> mixed_precision_allow_list;
+
+  // op types kept in float even if they are allowed. Default is empty, which keeps the numerically sensitive ops,
+  // such as Softmax, the reductions and LayerNormalization, in float.
+  std::vector<std::string> mixed_precision_deny_list;
+
+  // collect the ranges of the float graph inputs and node outputs of the main graph on CPU, over the Runs of a
+  // calibration dataset. See InferenceSession::GetCalibrationRanges. The Runs are slower, this isn't meant to be
+  // left on.
+  bool enable_calibration = false;
+
+  // ranges of the tensors, by name, as returned by GetCalibrationRanges for a session of the same model with the same
+  // graph optimization level. When not empty, the Conv, MatMul and FusedConv with a Relu activation nodes of the CPU
+  // execution provider whose input and output have a range are quantized to uint8 QLinearConv and QLinearMatMul.
+  // See StaticQuantizationTransformer.
+  std::unordered_map<std::string, TensorRange> static_quantization_ranges;
+
+  // store the constant float weights of the MatMul and Gemm nodes and the embedding tables of the Gather nodes of
+  // the CPU execution provider as int8 with a scale per channel, a quarter of their float size. The activations stay
+  // in float and the weights are dequantized as they are used. See WeightOnlyQuantizationTransformer.
+  bool enable_weight_only_quantization = false;
+
+  // initializers of the main graph, by name, that are used as is instead of being loaded from the model, so that
+  // sessions of the same model can share the memory of their weights. the values must be tensors with the type and
+  // shape of the initializers, on the device their consumers are placed on, and must outlive the sessions.
+  // an initializer replaced by a graph transformation, such as a Conv/BatchNormalization fusion, uses the value of
+  // the transformed model instead.
+  std::unordered_map<std::string, OrtValue> initializers_to_share;
+
+  // number of Runs executed at the end of Initialize, before the session is ready, so that the work of the first
+  // Runs, such as the growth of the arenas, the tracing of the memory pattern, the algorithm search of the kernels
+  // or the compilation of the execution providers, happens when the model is loaded.
+  unsigned warmup_runs = 0;
+
+  // directory with the inputs of the warmup Runs as TensorProto files input_0.pb, input_1.pb, ..., in the layout of
+  // the ONNX test data sets. Default is empty, which generates zero-filled tensors for the inputs, with 1 for the
+  // free dimensions that free_dimension_overrides doesn't set.
+  std::basic_string<ORTCHAR_T> warmup_inputs_path;
 };
 
 /**
@@ -152,6 +281,13 @@ class InferenceSession {
   explicit InferenceSession(const SessionOptions& session_options,
                             logging::LoggingManager* logging_manager = nullptr);
 
+  /**
+    Create a new InferenceSession that may use the thread pools of the Environment.
+    See SessionOptions::use_per_session_threads. The Environment must outlive the session.
+    */
+  InferenceSession(const SessionOptions& session_options, const Environment& session_env,
+                   logging::LoggingManager* logging_manager = nullptr);
+
   virtual ~InferenceSession();
 
   /**
@@ -222,6 +358,19 @@ class InferenceSession {
     */
   common::Status Load(const void* model_data, int model_data_len);
 
+  /**
+    * Load the ONNX models of a pipeline, such as a preprocessing model, a backbone and a postprocessing model,
+    * composed into a single graph, so the values passed from a model to the next one share the memory planning of
+    * the session and stay on the device producing them. See ComposeModels for how the models are connected.
+    * The external data of the initializers of the models is looked up relative to the first model.
+    * @param model_uris paths of the model files, in the order of the pipeline.
+    * @param input_maps optional, the inputs of each model fed by an output of another name of the earlier models,
+    *        as a map from the name of the input to the name of the output.
+    * @return OK if success.
+    */
+  common::Status LoadComposed(const std::vector<std::basic_string<ORTCHAR_T>>& model_uris,
+                              const std::vector<std::unordered_map<std::string, std::string>>& input_maps = {});
+
   /**
     * Initializes a previously loaded model. Initialization includes but is not
     * limited to graph transformations, construction of kernels, etc.
@@ -266,6 +415,48 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   common::Status Run(IOBinding& io_binding);
 
+  /**
+    * Creates a prepared run for the inputs and outputs of the given names, which are resolved once, so that
+    * Runs with it only do the work that depends on their values. See PreparedRun class for more info.
+    * @param feed_locations the memory the feeds will be on, in the order of feed_names.
+    *        Empty, or nullptr for a feed, means CPU memory.
+    * @param fetch_locations the memory the fetches will be returned in, in the order of output_names.
+    *        Empty, or nullptr for a fetch, means CPU memory.
+    */
+  common::Status NewPreparedRun(const std::vector<std::string>& feed_names,
+                                const std::vector<std::string>& output_names,
+                                const std::vector<const OrtMemoryInfo*>& feed_locations,
+                                const std::vector<const OrtMemoryInfo*>& fetch_locations,
+                                std::unique_ptr<PreparedRun>* prepared_run);
+
+  /**
+    * Run with a prepared run of this session.
+    * @param feeds the inputs in the order of the names the prepared run was created with,
+    *        on the memory it was created with.
+    * @param p_fetches output values in the order of the output names of the prepared run.
+    */
+  common::Status Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                     const std::vector<OrtValue>& feeds, std::vector<OrtValue>* p_fetches);
+
+  /**
+    * Called on a thread of the session when a RunAsync completes, with the status of the Run and its fetches.
+    */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Queue a Run and return immediately. The Run executes on a thread pool of the session of
+    * SessionOptions::inter_op_num_threads threads, created by the first call, which then calls callback.
+    * The pool is separate from the inter-op pool of the parallel executor, as its Runs wait for their
+    * work on that pool.
+    * The run options are copied, so setting their terminate flag after this call doesn't stop the Run; use a
+    * deadline instead. The memory of the feeds and of the preallocated fetches must stay valid until callback is
+    * called.
+    * Pending Runs complete before the session is released.
+    * @param fetches preallocated output values in the order of output_names, or empty.
+    */
+  void RunAsync(const RunOptions& run_options, std::vector<std::string> feed_names, std::vector<OrtValue> feeds,
+                std::vector<std::string> output_names, std::vector<OrtValue> fetches, RunAsyncCallback callback);
+
   /**
     * @return pair.first = OK; FAIL otherwise. pair.second is non-NULL when pair.first = OK.
     * @note lifetime of the returned pointer is valid as long as the Session object is live.
@@ -312,6 +503,19 @@ class InferenceSession {
    */
   const SessionOptions& GetSessionOptions() const;
 
+  /**
+    * Get the bytes in use and the high-water mark of the bytes in use, summed over the memory arenas of the
+    * execution providers. Can be called at any time, including while Runs are in progress.
+    */
+  void GetArenaUsage(size_t& bytes_in_use, size_t& max_bytes_in_use) const;
+
+  /**
+    * Get the bytes of the memory held by the arenas of the execution providers that is backed by huge pages,
+    * see SessionOptions::use_huge_pages. With transparent huge pages these are the bytes the kernel was asked to
+    * back with them, it may still back some with the usual pages.
+    */
+  size_t GetHugePageBytes() const;
+
   /**
     * Start profiling on this inference session. This simply turns on profiling events to be
     * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
@@ -334,6 +538,26 @@ class InferenceSession {
     */
   std::string EndProfiling();
 
+  /**
+    * Get the statistics of the nodes of the main graph that ran since the session was initialized or
+    * ResetNodeStats was called. Can be called at any time, including while Runs are in progress.
+    * Requires SessionOptions::enable_node_stats.
+    */
+  common::Status GetNodeStats(std::vector<NodeStats>& node_stats) const;
+
+  common::Status ResetNodeStats();
+
+  /**
+    * Get the ranges of the float tensors of the main graph collected by the Runs since the session was
+    * initialized or ResetCalibration was called, to be used as SessionOptions::static_quantization_ranges.
+    * @param percentile With a value < 100, the ranges are clipped to the magnitude covering that percentage of the
+    *        values, which keeps the rare outliers from wasting the 8 bit range. 100 returns the min and max.
+    * Requires SessionOptions::enable_calibration.
+    */
+  common::Status GetCalibrationRanges(float percentile, std::unordered_map<std::string, TensorRange>& ranges) const;
+
+  common::Status ResetCalibration();
+
  protected:
   /**
     * Load an ONNX model.
@@ -386,12 +610,17 @@ class InferenceSession {
 
   common::Status Load(std::function<common::Status(std::shared_ptr<Model>&)> loader, const std::string& event_name);
 
+  // Construct the Model from a parsed ModelProto and resolve its main graph, recording a profiling event for each.
+  common::Status CreateModel(std::unique_ptr<ONNX_NAMESPACE::ModelProto> p_model_proto,
+                             std::shared_ptr<Model>& model);
+
   common::Status TransformGraph(onnxruntime::Graph& graph,
                                 const onnxruntime::GraphTransformerManager& graph_transformer_mgr,
                                 const ExecutionProviders& providers,
                                 KernelRegistryManager& kernel_registry_manager,
                                 const InsertCastTransformer& insert_cast_transformer,
-                                SessionState& session_state);
+                                SessionState& session_state,
+                                OptimizationReport* report);
 
   common::Status CreateSubgraphSessionState(Graph& graph, SessionState& session_state);
 
@@ -407,12 +636,30 @@ class InferenceSession {
                              const TensorShape& input_shape,
                              const TensorShape& expected_shape) const;
 
+  common::Status ValidateInput(const std::string& feed_name, MLDataType expected_type,
+                               const TensorShape& expected_shape, const OrtValue& input_ml_value) const;
+
   common::Status ValidateInputs(const std::vector<std::string>& feed_names, const std::vector<OrtValue>& feeds) const;
 
   common::Status ValidateOutputs(const std::vector<std::string>& output_names, const std::vector<OrtValue>* p_fetches) const;
 
   common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
+  common::Status InitializeGraphCapture(const Graph& graph);
+
+  // Runs the session SessionOptions::warmup_runs times. See SessionOptions::warmup_inputs_path.
+  common::Status WarmUp();
+
+  // Execute the graph for the validated feeds and fetches of feeds_fetches_manager. Its copy info is finalized
+  // for their devices unless copy_info_finalized, as for a PreparedRun.
+  common::Status ExecuteRun(const RunOptions& run_options, FeedsFetchesManager& feeds_fetches_manager,
+                            bool copy_info_finalized, const std::vector<OrtValue>& feeds,
+                            std::vector<OrtValue>& fetches);
+
+  common::Status ExecuteGraphWithCapture(FeedsFetchesManager& feeds_fetches_manager, bool copy_info_finalized,
+                                         const std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
+                                         const RunOptions& run_options, const logging::Logger& run_logger);
+
   template <typename T>
   common::Status Load(const std::basic_string<T>& model_uri);
 
@@ -437,11 +684,23 @@ class InferenceSession {
   // Profiler for this session.
   profiling::Profiler session_profiler_;
 
+  // Per node statistics of the main graph, when SessionOptions::enable_node_stats is set.
+  std::unique_ptr<NodeStatsRecorder> node_stats_recorder_;
+
+  // Ranges of the tensors of the main graph, when SessionOptions::enable_calibration is set.
+  std::unique_ptr<CalibrationCollector> calibration_collector_;
+
+  // memoized outputs of the nodes of the main graph that only depend on shapes. nullptr if disabled.
+  std::unique_ptr<ShapeSubgraphCache> shape_subgraph_cache_;
+
   // The list of execution providers.
   ExecutionProviders execution_providers_;
 
  private:
-  // Threadpool for this session
+  InferenceSession(const SessionOptions& session_options, const Environment* session_env,
+                   logging::LoggingManager* logging_manager);
+
+  // Threadpool for this session. nullptr if the session uses the thread pools of the Environment.
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
@@ -477,6 +736,21 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Graphs captured by graph_capture_provider_, keyed by the shapes and buffers of the feeds and fetches.
+  // See SessionOptions::enable_graph_capture.
+  struct CapturedGraphInfo {
+    size_t num_runs = 0;
+    bool capture_failed = false;
+    std::unique_ptr<CapturedGraph> graph;
+  };
+  IExecutionProvider* graph_capture_provider_ = nullptr;
+  std::map<std::vector<int64_t>, CapturedGraphInfo> captured_graphs_;  // GUARDED_BY(captured_graphs_mutex_)
+  onnxruntime::OrtMutex captured_graphs_mutex_;
+
+  // Runs the Runs of RunAsync. Created by its first call.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;  // GUARDED_BY(async_run_mutex_)
+  onnxruntime::OrtMutex async_run_mutex_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
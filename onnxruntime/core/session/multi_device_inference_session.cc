@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/multi_device_inference_session.h"
+
+#include <fstream>
+#include "core/graph/model.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Session of a device, which loads the model parsed by MultiDeviceInferenceSession.
+class DeviceInferenceSession : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  common::Status LoadProto(const ModelProto& model_proto, const std::basic_string<ORTCHAR_T>& model_location) {
+    // the external data of the initializers is found next to the model file
+    model_location_ = model_location;
+    return InferenceSession::Load(model_proto);
+  }
+};
+
+}  // namespace
+
+MultiDeviceInferenceSession::MultiDeviceInferenceSession(const SessionOptions& session_options,
+                                                         const std::vector<int>& device_ids,
+                                                         const ProviderFactory& provider_factory,
+                                                         logging::LoggingManager* logging_manager)
+    : session_options_{session_options},
+      device_ids_{device_ids},
+      provider_factory_{provider_factory},
+      logging_manager_{logging_manager},
+      num_runs_{new std::atomic<int>[device_ids.size()]} {
+  ORT_ENFORCE(!device_ids_.empty(), "MultiDeviceInferenceSession requires at least one device.");
+  ORT_ENFORCE(provider_factory_, "MultiDeviceInferenceSession requires an execution provider factory.");
+  for (size_t i = 0; i < device_ids_.size(); ++i) {
+    num_runs_[i] = 0;
+  }
+}
+
+MultiDeviceInferenceSession::~MultiDeviceInferenceSession() = default;
+
+common::Status MultiDeviceInferenceSession::Load(const std::string& model_uri) {
+  std::ifstream model_istream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_istream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Load model from ", model_uri, " failed: can't open the file.");
+  }
+
+  ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(Model::Load(model_istream, &model_proto));
+  model_location_ = ToWideString(model_uri);
+  return Load(model_proto);
+}
+
+common::Status MultiDeviceInferenceSession::Load(const void* model_data, int model_data_len) {
+  ModelProto model_proto;
+  if (!model_proto.ParseFromArray(model_data, model_data_len)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
+                  "Failed to load model because protobuf parsing failed.");
+  }
+  return Load(model_proto);
+}
+
+common::Status MultiDeviceInferenceSession::Load(const ModelProto& model_proto) {
+  if (!sessions_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "A model is already loaded.");
+  }
+
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int device_id : device_ids_) {
+    SessionOptions device_options = session_options_;
+    if (!device_options.session_logid.empty()) {
+      device_options.session_logid += "_device" + std::to_string(device_id);
+    }
+
+    auto session = std::make_unique<DeviceInferenceSession>(device_options, logging_manager_);
+    auto provider = provider_factory_(device_id);
+    if (provider == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "No execution provider was created for device ", device_id);
+    }
+    ORT_RETURN_IF_ERROR(session->RegisterExecutionProvider(std::move(provider)));
+    ORT_RETURN_IF_ERROR(session->LoadProto(model_proto, model_location_));
+    sessions.push_back(std::move(session));
+  }
+
+  sessions_ = std::move(sessions);
+  return Status::OK();
+}
+
+common::Status MultiDeviceInferenceSession::Initialize() {
+  if (sessions_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded.");
+  }
+
+  for (auto& session : sessions_) {
+    ORT_RETURN_IF_ERROR(session->Initialize());
+  }
+  return Status::OK();
+}
+
+size_t MultiDeviceInferenceSession::AcquireDevice() {
+  const size_t num_devices = device_ids_.size();
+  const size_t first = next_device_++ % num_devices;
+  size_t best = first;
+  int best_num_runs = num_runs_[first].load();
+  for (size_t i = 1; i < num_devices && best_num_runs > 0; ++i) {
+    const size_t index = (first + i) % num_devices;
+    const int num_runs = num_runs_[index].load();
+    if (num_runs < best_num_runs) {
+      best = index;
+      best_num_runs = num_runs;
+    }
+  }
+
+  ++num_runs_[best];
+  return best;
+}
+
+void MultiDeviceInferenceSession::ReleaseDevice(size_t index) {
+  --num_runs_[index];
+}
+
+template <typename RunFn>
+common::Status MultiDeviceInferenceSession::RunOnLeastLoadedDevice(const RunFn& run) {
+  if (sessions_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded.");
+  }
+
+  // the Run stops counting on its device when it returns or throws
+  struct DeviceRelease {
+    MultiDeviceInferenceSession& session;
+    size_t index;
+    ~DeviceRelease() { session.ReleaseDevice(index); }
+  } device_release{*this, AcquireDevice()};
+
+  return run(*sessions_[device_release.index]);
+}
+
+common::Status MultiDeviceInferenceSession::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                                const std::vector<std::string>& output_names,
+                                                std::vector<OrtValue>* p_fetches) {
+  return RunOnLeastLoadedDevice([&](InferenceSession& session) {
+    return session.Run(run_options, feeds, output_names, p_fetches);
+  });
+}
+
+common::Status MultiDeviceInferenceSession::Run(const RunOptions& run_options,
+                                                const std::vector<std::string>& feed_names,
+                                                const std::vector<OrtValue>& feeds,
+                                                const std::vector<std::string>& output_names,
+                                                std::vector<OrtValue>* p_fetches) {
+  return RunOnLeastLoadedDevice([&](InferenceSession& session) {
+    return session.Run(run_options, feed_names, feeds, output_names, p_fetches);
+  });
+}
+
+std::pair<common::Status, const InputDefList*> MultiDeviceInferenceSession::GetModelInputs() const {
+  if (sessions_.empty()) {
+    return std::make_pair(ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded."), nullptr);
+  }
+  return sessions_.front()->GetModelInputs();
+}
+
+std::pair<common::Status, const OutputDefList*> MultiDeviceInferenceSession::GetModelOutputs() const {
+  if (sessions_.empty()) {
+    return std::make_pair(ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded."), nullptr);
+  }
+  return sessions_.front()->GetModelOutputs();
+}
+
+}  // namespace onnxruntime
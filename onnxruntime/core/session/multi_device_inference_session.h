@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+ * Serves a model from several devices of the same kind, such as all the GPUs of a host, in one process.
+ * The model is read and parsed once, and a session with its own execution provider, kernels and session state is
+ * created for each device from it. Each Run call goes to the device with the fewest Run calls in progress.
+ *
+ * Example:
+ *  MultiDeviceInferenceSession session(so, {0, 1, 2, 3}, [](int device_id) {
+ *    CUDAExecutionProviderInfo info;
+ *    info.device_id = device_id;
+ *    return std::make_unique<CUDAExecutionProvider>(info);
+ *  });
+ *  session.Load(model_uri);
+ *  session.Initialize();
+ *  session.Run(run_options, feeds, output_names, &fetches);
+ */
+class MultiDeviceInferenceSession {
+ public:
+  // Creates the execution provider of a device. It's registered first, so it has the highest priority.
+  using ProviderFactory = std::function<std::unique_ptr<IExecutionProvider>(int device_id)>;
+
+  MultiDeviceInferenceSession(const SessionOptions& session_options, const std::vector<int>& device_ids,
+                              const ProviderFactory& provider_factory,
+                              logging::LoggingManager* logging_manager = nullptr);
+
+  ~MultiDeviceInferenceSession();
+
+  /**
+    * Load an ONNX model, and create the session of each device from it.
+    * @return OK if success.
+    */
+  common::Status Load(const std::string& model_uri);
+  common::Status Load(const void* model_data, int model_data_len);
+
+  /**
+    * Initializes the sessions of all the devices.
+    * @return OK if success.
+    */
+  common::Status Initialize();
+
+  /**
+    * Runs the model on the least loaded device. See InferenceSession::Run, this is thread-safe as well.
+    */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  common::Status Run(const RunOptions& run_options, const std::vector<std::string>& feed_names,
+                     const std::vector<OrtValue>& feeds, const std::vector<std::string>& output_names,
+                     std::vector<OrtValue>* p_fetches);
+
+  std::pair<common::Status, const InputDefList*> GetModelInputs() const;
+  std::pair<common::Status, const OutputDefList*> GetModelOutputs() const;
+
+  size_t NumDevices() const { return device_ids_.size(); }
+
+  int GetDeviceId(size_t index) const { return device_ids_.at(index); }
+
+  /**
+    * Get the session of a device, e.g. to bind its inputs and outputs to the memory of the device with an IOBinding.
+    * Only valid after Load.
+    */
+  InferenceSession& GetSession(size_t index) const { return *sessions_.at(index); }
+
+  /**
+    * Get the number of Run calls in progress on a device through this object.
+    */
+  int GetCurrentNumRuns(size_t index) const { return num_runs_[index].load(); }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MultiDeviceInferenceSession);
+
+  common::Status Load(const ONNX_NAMESPACE::ModelProto& model_proto);
+
+  // Picks the device of a Run and counts the Run on it. ReleaseDevice has to follow.
+  size_t AcquireDevice();
+  void ReleaseDevice(size_t index);
+
+  template <typename RunFn>
+  common::Status RunOnLeastLoadedDevice(const RunFn& run);
+
+  const SessionOptions session_options_;
+  const std::vector<int> device_ids_;
+  const ProviderFactory provider_factory_;
+  logging::LoggingManager* logging_manager_;
+  std::basic_string<ORTCHAR_T> model_location_;
+
+  std::vector<std::unique_ptr<InferenceSession>> sessions_;
+  std::unique_ptr<std::atomic<int>[]> num_runs_;
+  // rotates the device picked among the equally loaded ones
+  std::atomic<size_t> next_device_{0};
+};
+
+}  // namespace onnxruntime
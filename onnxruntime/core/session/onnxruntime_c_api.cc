@@ -21,6 +21,8 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/prepared_run.h"
+#include "core/session/IOBinding.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
@@ -112,6 +114,64 @@ ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithCustomLogger, OrtLoggingFunction loggi
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, _In_ const OrtThreadingOptions* threading_options,
+                    _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  auto default_logging_manager = std::make_unique<LoggingManager>(std::unique_ptr<ISink>{new CLogSink{}},
+                                                                  static_cast<Severity>(default_warning_level), false,
+                                                                  LoggingManager::InstanceType::Default,
+                                                                  &name);
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env, *reinterpret_cast<const ThreadingOptions*>(threading_options));
+  if (status.IsOK()) {
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+    return nullptr;
+  }
+  *out = nullptr;
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out) {
+  API_IMPL_BEGIN
+  *out = reinterpret_cast<OrtThreadingOptions*>(new ThreadingOptions());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int intra_op_num_threads) {
+  reinterpret_cast<ThreadingOptions*>(tp_options)->intra_op_num_threads = intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int inter_op_num_threads) {
+  reinterpret_cast<ThreadingOptions*>(tp_options)->inter_op_num_threads = inter_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalSpinControl, _Inout_ OrtThreadingOptions* tp_options, int allow_spinning) {
+  auto* options = reinterpret_cast<ThreadingOptions*>(tp_options);
+  options->intra_op_thread_options.allow_spinning = allow_spinning != 0;
+  options->inter_op_thread_options.allow_spinning = allow_spinning != 0;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_ const int* logical_processors, size_t count) {
+  API_IMPL_BEGIN
+  if (count > 0 && logical_processors == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "logical_processors is null");
+  }
+  reinterpret_cast<ThreadingOptions*>(tp_options)->intra_op_thread_options.affinity.assign(logical_processors,
+                                                                                          logical_processors + count);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateEnv, OrtLoggingLevel default_warning_level,
                     _In_ const char* logid, _Outptr_ OrtEnv** out) {
   API_IMPL_BEGIN
@@ -334,7 +394,7 @@ template <typename Loader>
 OrtStatus* CreateSessionImpl(_In_ const OrtEnv* env, _In_ const OrtSessionOptions* options,
                              Loader loader, _Outptr_ OrtSession** out) {
   auto sess = std::make_unique<::onnxruntime::InferenceSession>(
-      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager);
+      options == nullptr ? onnxruntime::SessionOptions() : options->value, *env->value, env->loggingManager);
   Status status;
   if (options != nullptr) {
     if (!options->custom_op_domains_.empty()) {
@@ -381,6 +441,24 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromModels, _In_ const OrtEnv* env,
+                    _In_ const ORTCHAR_T* const* model_paths, size_t num_models,
+                    _In_ const OrtSessionOptions* options, _Outptr_ OrtSession** out) {
+  API_IMPL_BEGIN
+  std::vector<std::basic_string<ORTCHAR_T>> model_uris;
+  for (size_t i = 0; i < num_models; ++i) {
+    if (model_paths[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "model path cannot be null");
+    }
+    model_uris.emplace_back(model_paths[i]);
+  }
+  const auto loader = [&model_uris](InferenceSession& sess) {
+    return sess.LoadComposed(model_uris);
+  };
+  return CreateSessionImpl(env, options, loader, out);
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
                     _In_opt_ const OrtRunOptions* run_options,
                     _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
@@ -443,6 +521,244 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  static const OrtRunOptions default_run_options;
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+    feeds[i] = *input[i];
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  std::vector<OrtValue> fetches(output_names_len);
+  // the preallocated outputs are passed back to the callback as they were given
+  std::vector<OrtValue*> preallocated(output, output + output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+    if (output[i] != nullptr) {
+      fetches[i] = *output[i];
+    }
+  }
+
+  session->RunAsync(run_options == nullptr ? default_run_options : *run_options, std::move(feed_names),
+                    std::move(feeds), std::move(output_names), std::move(fetches),
+                    [callback, user_data, preallocated](const Status& status, std::vector<OrtValue>& fetches) {
+                      std::vector<OrtValue*> outputs(fetches.size(), nullptr);
+                      std::unique_ptr<OrtStatus, decltype(&OrtApis::ReleaseStatus)> ort_status(
+                          status.IsOK() ? nullptr : ToOrtStatus(status), &OrtApis::ReleaseStatus);
+                      if (status.IsOK()) {
+                        for (size_t i = 0; i != fetches.size(); ++i) {
+                          outputs[i] = preallocated[i] != nullptr ? preallocated[i] : new OrtValue(fetches[i]);
+                        }
+                      }
+                      callback(user_data, outputs.data(), status.IsOK() ? outputs.size() : 0, ort_status.get());
+                    });
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, _In_opt_ const OrtMemoryInfo* const* input_memory_infos,
+                    size_t input_len, _In_ const char* const* output_names1,
+                    _In_opt_ const OrtMemoryInfo* const* output_memory_infos, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names(input_len);
+  std::vector<const OrtMemoryInfo*> feed_locations;
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names[i] = input_names[i];
+  }
+  if (input_memory_infos != nullptr) {
+    feed_locations.assign(input_memory_infos, input_memory_infos + input_len);
+  }
+
+  std::vector<std::string> output_names(output_names_len);
+  std::vector<const OrtMemoryInfo*> fetch_locations;
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names[i] = output_names1[i];
+  }
+  if (output_memory_infos != nullptr) {
+    fetch_locations.assign(output_memory_infos, output_memory_infos + output_names_len);
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->NewPreparedRun(feed_names, output_names, feed_locations, fetch_locations, &prepared_run);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options, _In_ const OrtPreparedRun* prepared_run1,
+                    _In_ const OrtValue* const* input, size_t input_len,
+                    _Outptr_ OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const auto& prepared_run = *reinterpret_cast<const ::onnxruntime::PreparedRun*>(prepared_run1);
+  const int queue_id = 0;
+
+  std::vector<OrtValue> feeds(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    auto& ort_value = feeds[i] = *reinterpret_cast<const ::OrtValue*>(input[i]);
+    if (ort_value.Fence()) ort_value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+  }
+
+  std::vector<OrtValue> fetches(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      ::OrtValue& value = *(output[i]);
+      if (value.Fence())
+        value.Fence()->BeforeUsingAsOutput(onnxruntime::kCpuExecutionProvider, queue_id);
+      fetches[i] = value;
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, prepared_run, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, prepared_run, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  for (size_t i = 0; i != output_len; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtIoBinding*>(binding.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* val_ptr) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  if (name == nullptr || name[0] == '\0') {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+  }
+  auto status = binding->BindInput(name, *val_ptr);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtValue* val_ptr) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  if (name == nullptr || name[0] == '\0') {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+  }
+  auto status = binding->BindOutput(name, *val_ptr);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* val_ptr) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  if (name == nullptr || name[0] == '\0') {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+  }
+  auto status = binding->BindOutput(name, val_ptr->device);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding_ptr) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto binding = reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr);
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, *binding);
+  } else {
+    status = session->Run(*run_options, *binding);
+  }
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputCount, _In_ const OrtIoBinding* binding_ptr, _Out_ size_t* out) {
+  auto binding = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding_ptr);
+  *out = binding->GetOutputNames().size();
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputValues, _In_ const OrtIoBinding* binding_ptr, _Outptr_ OrtValue** output,
+                    size_t output_len) {
+  API_IMPL_BEGIN
+  auto binding = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding_ptr);
+  const auto& outputs = binding->GetOutputs();
+  if (output_len != outputs.size()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output_len doesn't match the count of the bound outputs");
+  }
+  for (size_t i = 0; i != output_len; ++i) {
+    output[i] = new OrtValue(outputs[i]);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ClearBoundInputs, _Inout_ OrtIoBinding* binding_ptr) {
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr)->ClearInputs();
+}
+
+ORT_API(void, OrtApis::ClearBoundOutputs, _Inout_ OrtIoBinding* binding_ptr) {
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding_ptr)->ClearOutputs();
+}
+
 ORT_API_STATUS_IMPL(OrtApis::IsTensor, _In_ const OrtValue* value, int* out) {
   auto v = reinterpret_cast<const ::OrtValue*>(value);
   *out = v->IsTensor() ? 1 : 0;
@@ -557,6 +873,23 @@ ORT_API_STATUS_IMPL(OrtApis::SessionGetOverridableInitializerCount, _In_ const O
   return GetNodeDefListCountHelper(sess, get_overridable_initializers_fn, out);
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetArenaUsage, _In_ const OrtSession* sess, _Out_ size_t* bytes_in_use,
+                    _Out_ size_t* max_bytes_in_use) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  session->GetArenaUsage(*bytes_in_use, *max_bytes_in_use);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetHugePageBytes, _In_ const OrtSession* sess, _Out_ size_t* bytes) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *bytes = session->GetHugePageBytes();
+  return nullptr;
+  API_IMPL_END
+}
+
 static OrtStatus* GetNodeDefTypeInfoHelper(const OrtSession* sess, GetDefListFn get_fn, size_t index, _Outptr_ struct OrtTypeInfo** out) {
   API_IMPL_BEGIN
   auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
@@ -1228,6 +1561,48 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::AddInitializer,
+
+    &OrtApis::CreateIoBinding,
+    &OrtApis::BindInput,
+    &OrtApis::BindOutput,
+    &OrtApis::BindOutputToDevice,
+    &OrtApis::RunWithBinding,
+    &OrtApis::GetBoundOutputCount,
+    &OrtApis::GetBoundOutputValues,
+    &OrtApis::ClearBoundInputs,
+    &OrtApis::ClearBoundOutputs,
+    &OrtApis::ReleaseIoBinding,
+
+    &OrtApis::RunOptionsSetIntraOpNumThreads,
+    &OrtApis::RunOptionsGetIntraOpNumThreads,
+
+    &OrtApis::CreateEnvWithGlobalThreadPools,
+    &OrtApis::CreateThreadingOptions,
+    &OrtApis::SetGlobalIntraOpNumThreads,
+    &OrtApis::SetGlobalInterOpNumThreads,
+    &OrtApis::SetGlobalSpinControl,
+    &OrtApis::SetGlobalIntraOpThreadAffinity,
+    &OrtApis::ReleaseThreadingOptions,
+    &OrtApis::DisablePerSessionThreads,
+    &OrtApis::SetIntraOpThreadAffinity,
+    &OrtApis::SetSessionNumaNode,
+    &OrtApis::SetOptimizationReportFilePath,
+    &OrtApis::SessionGetArenaUsage,
+    &OrtApis::SetSessionWarmup,
+    &OrtApis::RunAsync,
+    &OrtApis::KernelContext_ParallelFor,
+    &OrtApis::EnableCostBasedPartitioning,
+    &OrtApis::EnableHugePages,
+    &OrtApis::SessionGetHugePageBytes,
+    &OrtApis::RunOptionsSetTimeout,
+    &OrtApis::RunOptionsSetPriority,
+    &OrtApis::RunOptionsGetPriority,
+    &OrtApis::CreateSessionFromModels,
 };
 
 const OrtApi* ORT_API_CALL OrtGetApi(uint32_t version) NO_EXCEPTION {
@@ -1241,3 +1616,6 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(IoBinding, ::onnxruntime::IOBinding)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ThreadingOptions, ::onnxruntime::ThreadingOptions)
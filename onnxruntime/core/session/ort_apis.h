@@ -13,6 +13,9 @@ ORT_API(void, ReleaseTypeInfo, OrtTypeInfo*);
 ORT_API(void, ReleaseTensorTypeAndShapeInfo, OrtTensorTypeAndShapeInfo*);
 ORT_API(void, ReleaseSessionOptions, OrtSessionOptions*);
 ORT_API(void, ReleaseCustomOpDomain, OrtCustomOpDomain*);
+ORT_API(void, ReleasePreparedRun, OrtPreparedRun*);
+ORT_API(void, ReleaseIoBinding, OrtIoBinding*);
+ORT_API(void, ReleaseThreadingOptions, OrtThreadingOptions*);
 
 ORT_API_STATUS_IMPL(CreateStatus, OrtErrorCode code, _In_ const char* msg);
 OrtErrorCode ORT_API_CALL GetErrorCode(_In_ const OrtStatus* status) NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
@@ -33,6 +36,17 @@ ORT_API_STATUS_IMPL(Run, _Inout_ OrtSession* sess,
                     _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
                     _In_ const char* const* output_names, size_t output_names_len, _Outptr_ OrtValue** output);
 
+ORT_API_STATUS_IMPL(CreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_ const char* const* input_names, _In_opt_ const OrtMemoryInfo* const* input_memory_infos,
+                    size_t input_len, _In_ const char* const* output_names,
+                    _In_opt_ const OrtMemoryInfo* const* output_memory_infos, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options, _In_ const OrtPreparedRun* prepared_run,
+                    _In_ const OrtValue* const* input, size_t input_len,
+                    _Outptr_ OrtValue** output, size_t output_len);
+
 ORT_API_STATUS_IMPL(CreateSessionOptions, OrtSessionOptions** out);
 ORT_API_STATUS_IMPL(CloneSessionOptions, const OrtSessionOptions* input, OrtSessionOptions** out);
 ORT_API_STATUS_IMPL(EnableSequentialExecution, _In_ OrtSessionOptions* options);
@@ -79,6 +93,42 @@ ORT_API_STATUS_IMPL(RunOptionsGetRunTag, _In_ const OrtRunOptions*, _Out_ const
 
 ORT_API_STATUS_IMPL(RunOptionsSetTerminate, _Inout_ OrtRunOptions* options);
 ORT_API_STATUS_IMPL(RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* options);
+ORT_API_STATUS_IMPL(RunOptionsSetIntraOpNumThreads, _Inout_ OrtRunOptions* options, int value);
+ORT_API_STATUS_IMPL(RunOptionsGetIntraOpNumThreads, _In_ const OrtRunOptions* options, _Out_ int* out);
+
+ORT_API_STATUS_IMPL(CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                    _In_ const OrtThreadingOptions* threading_options, _Outptr_ OrtEnv** out);
+ORT_API_STATUS_IMPL(CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads);
+ORT_API_STATUS_IMPL(SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads);
+ORT_API_STATUS_IMPL(SetGlobalSpinControl, _Inout_ OrtThreadingOptions* tp_options, int allow_spinning);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpThreadAffinity, _Inout_ OrtThreadingOptions* tp_options,
+                    _In_ const int* logical_processors, size_t count);
+ORT_API_STATUS_IMPL(DisablePerSessionThreads, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetIntraOpThreadAffinity, _Inout_ OrtSessionOptions* options,
+                    _In_ const int* logical_processors, size_t count);
+ORT_API_STATUS_IMPL(SetSessionNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+ORT_API_STATUS_IMPL(SetOptimizationReportFilePath, _Inout_ OrtSessionOptions* options,
+                    _In_ const ORTCHAR_T* optimization_report_filepath);
+ORT_API_STATUS_IMPL(SessionGetArenaUsage, _In_ const OrtSession* sess, _Out_ size_t* bytes_in_use,
+                    _Out_ size_t* max_bytes_in_use);
+ORT_API_STATUS_IMPL(SetSessionWarmup, _Inout_ OrtSessionOptions* options, unsigned warmup_runs,
+                    _In_opt_ const ORTCHAR_T* warmup_inputs_path);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(KernelContext_ParallelFor, _Inout_ OrtKernelContext* context, _In_ OrtParallelForFn fn,
+                    _In_opt_ void* user_data, size_t total, double cost_per_unit);
+ORT_API_STATUS_IMPL(EnableCostBasedPartitioning, _Inout_ OrtSessionOptions* options,
+                    _In_opt_ const ORTCHAR_T* cost_filepath);
+ORT_API_STATUS_IMPL(EnableHugePages, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SessionGetHugePageBytes, _In_ const OrtSession* sess, _Out_ size_t* bytes);
+ORT_API_STATUS_IMPL(RunOptionsSetTimeout, _Inout_ OrtRunOptions* options, int64_t timeout_us);
+ORT_API_STATUS_IMPL(RunOptionsSetPriority, _Inout_ OrtRunOptions* options, int value);
+ORT_API_STATUS_IMPL(RunOptionsGetPriority, _In_ const OrtRunOptions* options, _Out_ int* out);
+ORT_API_STATUS_IMPL(CreateSessionFromModels, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* const* model_paths,
+                    size_t num_models, _In_ const OrtSessionOptions* options, _Outptr_ OrtSession** out);
 
 ORT_API_STATUS_IMPL(CreateTensorAsOrtValue, _Inout_ OrtAllocator* allocator,
                     _In_ const int64_t* shape, size_t shape_len, ONNXTensorElementDataType type,
@@ -105,6 +155,20 @@ ORT_API_STATUS_IMPL(GetTensorTypeAndShape, _In_ const OrtValue* value, _Outptr_
 ORT_API_STATUS_IMPL(GetTypeInfo, _In_ const OrtValue* value, _Outptr_ OrtTypeInfo** out);
 ORT_API_STATUS_IMPL(GetValueType, _In_ const OrtValue* value, _Out_ enum ONNXType* out);
 ORT_API_STATUS_IMPL(OrtAddFreeDimensionOverride, _Inout_ OrtSessionOptions* options, _In_ const char* symbolic_dim, _In_ int64_t dim_override);
+ORT_API_STATUS_IMPL(AddInitializer, _Inout_ OrtSessionOptions* options, _In_ const char* name, _In_ const OrtValue* val);
+
+ORT_API_STATUS_IMPL(CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out);
+ORT_API_STATUS_IMPL(BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr);
+ORT_API_STATUS_IMPL(BindOutput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr);
+ORT_API_STATUS_IMPL(BindOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* val_ptr);
+ORT_API_STATUS_IMPL(RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding_ptr);
+ORT_API_STATUS_IMPL(GetBoundOutputCount, _In_ const OrtIoBinding* binding_ptr, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(GetBoundOutputValues, _In_ const OrtIoBinding* binding_ptr, _Outptr_ OrtValue** output,
+                    size_t output_len);
+ORT_API(void, ClearBoundInputs, _Inout_ OrtIoBinding* binding_ptr);
+ORT_API(void, ClearBoundOutputs, _Inout_ OrtIoBinding* binding_ptr);
 
 ORT_API_STATUS_IMPL(CreateMemoryInfo, _In_ const char* name1, enum OrtAllocatorType type, int id1, enum OrtMemType mem_type1, _Outptr_ OrtMemoryInfo** out);
 ORT_API_STATUS_IMPL(CreateCpuMemoryInfo, enum OrtAllocatorType type, enum OrtMemType mem_type1, _Outptr_ OrtMemoryInfo** out)
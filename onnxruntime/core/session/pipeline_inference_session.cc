@@ -0,0 +1,520 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_inference_session.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include "core/framework/tensor.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "core/session/IOBinding.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Session of a stage, which loads the part of the model split by PipelineInferenceSession.
+class StageInferenceSession : public InferenceSession {
+ public:
+  using InferenceSession::InferenceSession;
+
+  common::Status LoadProto(const ModelProto& model_proto, const std::basic_string<ORTCHAR_T>& model_location) {
+    // the external data of the initializers is found next to the model file
+    model_location_ = model_location;
+    return InferenceSession::Load(model_proto);
+  }
+};
+
+// The nodes of a stage, and the values it exchanges with the other stages.
+struct StagePartition {
+  std::vector<const Node*> nodes;
+  std::vector<const NodeArg*> inputs;
+  std::vector<const NodeArg*> outputs;
+  std::vector<std::string> initializers;
+};
+
+// Splits the nodes in topological order into num_stages consecutive ranges of about the same cost, which is the
+// size of the initializers a node uses first, or 1 for the other nodes.
+std::vector<StagePartition> PartitionNodes(const Graph& graph, size_t num_stages) {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  const auto& initializers = graph.GetAllInitializedTensors();
+
+  std::vector<const Node*> nodes;
+  std::vector<size_t> costs;
+  std::unordered_set<std::string> counted;
+  size_t total_cost = 0;
+  for (NodeIndex index : order) {
+    const Node* node = graph.GetNode(index);
+    size_t cost = 1;
+    for (const auto* def : node->InputDefs()) {
+      auto entry = initializers.find(def->Name());
+      if (entry != initializers.cend() && counted.insert(def->Name()).second) {
+        cost += entry->second->ByteSizeLong();
+      }
+    }
+    nodes.push_back(node);
+    costs.push_back(cost);
+    total_cost += cost;
+  }
+
+  std::vector<StagePartition> stages(num_stages);
+  size_t stage = 0;
+  size_t stage_cost = 0;
+  size_t cost_before = 0;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    // move to the next stage once this one has its share, keeping at least a node for each of the rest
+    const size_t remaining_nodes = nodes.size() - i;
+    const size_t remaining_stages = num_stages - stage;
+    const size_t target = (total_cost - cost_before) / remaining_stages;
+    if (!stages[stage].nodes.empty() && stage + 1 < num_stages &&
+        (remaining_nodes < remaining_stages || stage_cost + costs[i] / 2 > target)) {
+      cost_before += stage_cost;
+      stage_cost = 0;
+      ++stage;
+    }
+    stages[stage].nodes.push_back(nodes[i]);
+    stage_cost += costs[i];
+  }
+
+  // the stage producing each value, and the last stage using it
+  std::unordered_map<const NodeArg*, size_t> producers;
+  std::unordered_map<const NodeArg*, size_t> last_consumers;
+  for (size_t s = 0; s < stages.size(); ++s) {
+    for (const Node* node : stages[s].nodes) {
+      for (const auto* def : node->OutputDefs()) {
+        if (def->Exists()) {
+          producers[def] = s;
+        }
+      }
+    }
+  }
+
+  for (size_t s = 0; s < stages.size(); ++s) {
+    auto& partition = stages[s];
+    std::unordered_set<const NodeArg*> seen;
+    auto add_input = [&](const NodeArg* def) {
+      if (!def->Exists() || !seen.insert(def).second) {
+        return;
+      }
+      auto producer = producers.find(def);
+      if (producer != producers.cend() && producer->second == s) {
+        return;
+      }
+      last_consumers[def] = s;
+      if (initializers.count(def->Name()) != 0) {
+        partition.initializers.push_back(def->Name());
+      } else {
+        partition.inputs.push_back(def);
+      }
+    };
+
+    for (const Node* node : partition.nodes) {
+      for (const auto* def : node->InputDefs()) {
+        add_input(def);
+      }
+      for (const auto* def : node->ImplicitInputDefs()) {
+        add_input(def);
+      }
+    }
+  }
+
+  const auto& graph_outputs = graph.GetOutputs();
+  for (size_t s = 0; s < stages.size(); ++s) {
+    for (const Node* node : stages[s].nodes) {
+      for (const auto* def : node->OutputDefs()) {
+        if (!def->Exists()) {
+          continue;
+        }
+        auto consumer = last_consumers.find(def);
+        if ((consumer != last_consumers.cend() && consumer->second > s) ||
+            std::find(graph_outputs.cbegin(), graph_outputs.cend(), def) != graph_outputs.cend()) {
+          stages[s].outputs.push_back(def);
+        }
+      }
+    }
+  }
+
+  return stages;
+}
+
+// Makes the model of a stage, which has the opsets and initializers of the model it's split from.
+common::Status MakeStageModel(const ModelProto& model_proto, const Graph& graph, const StagePartition& partition,
+                              size_t index, ModelProto& stage_proto) {
+  stage_proto.set_ir_version(model_proto.ir_version());
+  *stage_proto.mutable_opset_import() = model_proto.opset_import();
+  stage_proto.set_producer_name(model_proto.producer_name());
+  stage_proto.set_domain(model_proto.domain());
+  stage_proto.set_model_version(model_proto.model_version());
+
+  auto& stage_graph = *stage_proto.mutable_graph();
+  stage_graph.set_name(graph.Name() + "_stage" + std::to_string(index));
+  for (const Node* node : partition.nodes) {
+    node->ToProto(*stage_graph.add_node());
+  }
+
+  auto add_value_info = [](const NodeArg* def, ValueInfoProto& value_info) -> Status {
+    if (def->TypeAsProto() == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The type of ", def->Name(),
+                             " is unknown, so the model can't be split at it.");
+    }
+    value_info = def->ToProto();
+    return Status::OK();
+  };
+  for (const auto* def : partition.inputs) {
+    ORT_RETURN_IF_ERROR(add_value_info(def, *stage_graph.add_input()));
+  }
+  for (const auto* def : partition.outputs) {
+    ORT_RETURN_IF_ERROR(add_value_info(def, *stage_graph.add_output()));
+  }
+
+  const auto& initializers = graph.GetAllInitializedTensors();
+  for (const auto& name : partition.initializers) {
+    *stage_graph.add_initializer() = *initializers.at(name);
+    if (model_proto.ir_version() < 4) {
+      // the initializers have to be graph inputs as well before IR version 4
+      ValueInfoProto& value_info = *stage_graph.add_input();
+      value_info.set_name(name);
+      const NodeArg* def = graph.GetNodeArg(name);
+      if (def != nullptr && def->TypeAsProto() != nullptr) {
+        *value_info.mutable_type() = *def->TypeAsProto();
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+// The size of the first dimension all the feeds have, or -1 if they can't be split into micro-batches.
+int64_t BatchSize(const NameMLValMap& feeds) {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.second.IsTensor()) {
+      return -1;
+    }
+
+    const auto& tensor = feed.second.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || shape.NumDimensions() == 0 ||
+        tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+      return -1;
+    }
+
+    const int64_t size = shape[0];
+    if (size <= 0 || (batch_size != -1 && size != batch_size)) {
+      return -1;
+    }
+    batch_size = size;
+  }
+
+  return batch_size;
+}
+
+OrtValue MakeTensorValue(std::unique_ptr<Tensor> tensor) {
+  return OrtValue{tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()};
+}
+
+// A tensor of the rows [begin, end) of the first dimension of a CPU tensor, which shares its buffer.
+OrtValue SliceBatch(const Tensor& tensor, int64_t begin, int64_t end) {
+  std::vector<int64_t> dims = tensor.Shape().GetDims();
+  const int64_t row_size = dims[0] == 0 ? 0 : tensor.Shape().Size() / dims[0];
+  dims[0] = end - begin;
+  auto* data = const_cast<char*>(static_cast<const char*>(tensor.DataRaw())) +
+               begin * row_size * static_cast<int64_t>(tensor.DataType()->Size());
+  return MakeTensorValue(std::make_unique<Tensor>(tensor.DataType(), TensorShape(dims), data, tensor.Location()));
+}
+
+// Concatenates the fetches of the micro-batches along their first dimension.
+common::Status ConcatBatches(const std::string& name, const std::vector<const OrtValue*>& parts,
+                             const AllocatorPtr& allocator, OrtValue& result) {
+  const Tensor* first = nullptr;
+  int64_t batch_size = 0;
+  for (const OrtValue* part : parts) {
+    if (!part->IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", name,
+                             " is not a tensor, so the micro-batches can't be concatenated.");
+    }
+    const auto& tensor = part->Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() == 0 || tensor.Location().device.Type() != OrtDevice::CPU ||
+        (first != nullptr && (tensor.DataType() != first->DataType() ||
+                              shape.Slice(1) != first->Shape().Slice(1)))) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", name,
+                             " has no batch dimension, so the micro-batches can't be concatenated.");
+    }
+    first = first == nullptr ? &tensor : first;
+    batch_size += shape[0];
+  }
+
+  std::vector<int64_t> dims = first->Shape().GetDims();
+  dims[0] = batch_size;
+  auto output = std::make_unique<Tensor>(first->DataType(), TensorShape(dims), allocator);
+  const auto element_size = first->DataType()->Size();
+  size_t offset = 0;
+  for (const OrtValue* part : parts) {
+    const auto& tensor = part->Get<Tensor>();
+    const auto count = static_cast<size_t>(tensor.Shape().Size());
+    if (tensor.DataType() == DataTypeImpl::GetType<std::string>()) {
+      std::copy_n(tensor.Data<std::string>(), count, output->MutableData<std::string>() + offset);
+    } else if (count > 0) {
+      memcpy(static_cast<char*>(output->MutableDataRaw()) + offset * element_size, tensor.DataRaw(),
+             count * element_size);
+    }
+    offset += count;
+  }
+
+  result = MakeTensorValue(std::move(output));
+  return Status::OK();
+}
+
+}  // namespace
+
+PipelineInferenceSession::PipelineInferenceSession(const SessionOptions& session_options,
+                                                   const std::vector<int>& device_ids,
+                                                   const ProviderFactory& provider_factory,
+                                                   size_t num_micro_batches,
+                                                   logging::LoggingManager* logging_manager)
+    : session_options_{session_options},
+      device_ids_{device_ids},
+      provider_factory_{provider_factory},
+      num_micro_batches_{num_micro_batches},
+      logging_manager_{logging_manager} {
+  ORT_ENFORCE(!device_ids_.empty(), "PipelineInferenceSession requires at least one device.");
+  ORT_ENFORCE(provider_factory_, "PipelineInferenceSession requires an execution provider factory.");
+  ORT_ENFORCE(num_micro_batches_ >= 1, "PipelineInferenceSession requires at least one micro-batch.");
+}
+
+PipelineInferenceSession::~PipelineInferenceSession() = default;
+
+common::Status PipelineInferenceSession::Load(const std::string& model_uri) {
+  std::ifstream model_istream(model_uri, std::ios::in | std::ios::binary);
+  if (!model_istream) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NO_SUCHFILE, "Load model from ", model_uri, " failed: can't open the file.");
+  }
+
+  ModelProto model_proto;
+  ORT_RETURN_IF_ERROR(Model::Load(model_istream, &model_proto));
+  model_location_ = ToWideString(model_uri);
+  return Load(model_proto);
+}
+
+common::Status PipelineInferenceSession::Load(const void* model_data, int model_data_len) {
+  ModelProto model_proto;
+  if (!model_proto.ParseFromArray(model_data, model_data_len)) {
+    return Status(common::ONNXRUNTIME, common::INVALID_PROTOBUF,
+                  "Failed to load model because protobuf parsing failed.");
+  }
+  return Load(model_proto);
+}
+
+common::Status PipelineInferenceSession::Load(const ModelProto& model_proto) {
+  if (!stages_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "A model is already loaded.");
+  }
+
+  // resolve the graph for the types of the values passed between the stages
+  std::shared_ptr<Model> model;
+  ORT_RETURN_IF_ERROR(Model::Load(model_proto, model));
+  const Graph& graph = model->MainGraph();
+  if (static_cast<size_t>(graph.NumberOfNodes()) < device_ids_.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The model has ", graph.NumberOfNodes(),
+                           " nodes, which is too few for ", device_ids_.size(), " stages.");
+  }
+
+  const auto partitions = PartitionNodes(graph, device_ids_.size());
+  std::unordered_set<std::string> used_later;
+  for (const auto& partition : partitions) {
+    for (const auto* def : partition.inputs) {
+      used_later.insert(def->Name());
+    }
+  }
+  const auto& graph_outputs = graph.GetOutputs();
+
+  std::vector<Stage> stages;
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    const int device_id = device_ids_[i];
+    ModelProto stage_proto;
+    ORT_RETURN_IF_ERROR(MakeStageModel(model_proto, graph, partitions[i], i, stage_proto));
+
+    SessionOptions stage_options = session_options_;
+    if (!stage_options.session_logid.empty()) {
+      stage_options.session_logid += "_stage" + std::to_string(i);
+    }
+
+    Stage stage;
+    auto session = std::make_unique<StageInferenceSession>(stage_options, logging_manager_);
+    auto provider = provider_factory_(device_id);
+    if (provider != nullptr) {
+      auto allocator = provider->GetAllocator(device_id, OrtMemTypeDefault);
+      if (allocator != nullptr && allocator->Info().device.Type() != OrtDevice::CPU) {
+        stage.device = std::make_unique<OrtDevice>(allocator->Info().device);
+      }
+      ORT_RETURN_IF_ERROR(session->RegisterExecutionProvider(std::move(provider)));
+    }
+    ORT_RETURN_IF_ERROR(session->LoadProto(stage_proto, model_location_));
+
+    for (const auto* def : partitions[i].inputs) {
+      stage.inputs.push_back(def->Name());
+    }
+    for (const auto* def : partitions[i].outputs) {
+      stage.outputs.push_back(def->Name());
+      // the fetches go to CPU, the values only the later stages use stay where they are
+      const bool is_graph_output = std::find(graph_outputs.cbegin(), graph_outputs.cend(), def) !=
+                                   graph_outputs.cend();
+      stage.outputs_on_device.push_back(stage.device != nullptr && !is_graph_output &&
+                                        used_later.count(def->Name()) != 0);
+    }
+    stage.session = std::move(session);
+    stages.push_back(std::move(stage));
+  }
+
+  stages_ = std::move(stages);
+  return Status::OK();
+}
+
+common::Status PipelineInferenceSession::Initialize() {
+  if (stages_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded.");
+  }
+
+  for (auto& stage : stages_) {
+    ORT_RETURN_IF_ERROR(stage.session->Initialize());
+  }
+  return Status::OK();
+}
+
+common::Status PipelineInferenceSession::RunStage(const Stage& stage, const RunOptions& run_options,
+                                                  NameMLValMap& values) const {
+  std::unique_ptr<IOBinding> io_binding;
+  ORT_RETURN_IF_ERROR(stage.session->NewIOBinding(&io_binding));
+  for (const auto& name : stage.inputs) {
+    auto value = values.find(name);
+    if (value == values.cend()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Missing input: ", name);
+    }
+    // the values of another device are copied to this one peer to peer
+    ORT_RETURN_IF_ERROR(io_binding->BindInput(name, value->second));
+  }
+  ORT_RETURN_IF_ERROR(io_binding->SynchronizeInputs());
+
+  for (size_t i = 0; i < stage.outputs.size(); ++i) {
+    if (stage.outputs_on_device[i]) {
+      ORT_RETURN_IF_ERROR(io_binding->BindOutput(stage.outputs[i], *stage.device));
+    } else {
+      ORT_RETURN_IF_ERROR(io_binding->BindOutput(stage.outputs[i], OrtValue()));
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(stage.session->Run(run_options, *io_binding));
+  ORT_RETURN_IF_ERROR(io_binding->SynchronizeOutputs());
+
+  const auto& outputs = io_binding->GetOutputs();
+  for (size_t i = 0; i < stage.outputs.size(); ++i) {
+    values[stage.outputs[i]] = outputs[i];
+  }
+  return Status::OK();
+}
+
+common::Status PipelineInferenceSession::Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                                             const std::vector<std::string>& output_names,
+                                             std::vector<OrtValue>* p_fetches) {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+  if (stages_.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Model was not loaded.");
+  }
+
+  // split the feeds into the micro-batches, as views of their rows
+  const int64_t batch_size = BatchSize(feeds);
+  const size_t num_micro_batches = batch_size < 0
+                                       ? 1
+                                       : std::min(num_micro_batches_, static_cast<size_t>(batch_size));
+  std::vector<NameMLValMap> values(num_micro_batches);
+  if (num_micro_batches == 1) {
+    values[0] = feeds;
+  } else {
+    for (size_t m = 0; m < num_micro_batches; ++m) {
+      const int64_t begin = batch_size * static_cast<int64_t>(m) / static_cast<int64_t>(num_micro_batches);
+      const int64_t end = batch_size * static_cast<int64_t>(m + 1) / static_cast<int64_t>(num_micro_batches);
+      for (const auto& feed : feeds) {
+        values[m][feed.first] = SliceBatch(feed.second.Get<Tensor>(), begin, end);
+      }
+    }
+  }
+
+  // stage s runs micro-batch m once stage s - 1 is done with it, so the stages work on different micro-batches
+  const size_t num_stages = stages_.size();
+  std::vector<std::vector<std::promise<Status>>> done(num_stages);
+  std::vector<std::vector<std::future<Status>>> ready(num_stages);
+  for (size_t s = 0; s < num_stages; ++s) {
+    done[s].resize(num_micro_batches);
+    for (auto& promise : done[s]) {
+      ready[s].push_back(promise.get_future());
+    }
+  }
+
+  auto run_stage = [&](size_t s) {
+    // the micro-batches after a failed one are skipped, but every stage still hands them on
+    Status failure;
+    for (size_t m = 0; m < num_micro_batches; ++m) {
+      Status status = s == 0 ? Status::OK() : ready[s - 1][m].get();
+      if (status.IsOK() && !failure.IsOK()) {
+        status = failure;
+      } else if (status.IsOK()) {
+        try {
+          status = RunStage(stages_[s], run_options, values[m]);
+        } catch (const std::exception& ex) {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Stage ", s, " failed: ", ex.what());
+        }
+      }
+      if (!status.IsOK()) {
+        failure = status;
+      }
+      done[s][m].set_value(status);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t s = 1; s < num_stages; ++s) {
+    workers.emplace_back(run_stage, s);
+  }
+  run_stage(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  for (auto& result : ready[num_stages - 1]) {
+    ORT_RETURN_IF_ERROR(result.get());
+  }
+
+  std::vector<OrtValue> fetches;
+  for (const auto& name : output_names) {
+    std::vector<const OrtValue*> parts;
+    for (const auto& micro_batch : values) {
+      auto value = micro_batch.find(name);
+      if (value == micro_batch.cend()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Output Name:", name);
+      }
+      parts.push_back(&value->second);
+    }
+
+    if (parts.size() == 1) {
+      fetches.push_back(*parts[0]);
+    } else {
+      OrtValue fetch;
+      ORT_RETURN_IF_ERROR(ConcatBatches(name, parts, std::make_shared<CPUAllocator>(), fetch));
+      fetches.push_back(fetch);
+    }
+  }
+
+  *p_fetches = std::move(fetches);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+/**
+ * Runs a model too large for one device split across several, such as the GPUs of a host, or a GPU and the CPU.
+ * The graph is partitioned into consecutive stages, one per device, balanced by the size of their initializers.
+ * Each stage is a session with the execution provider of its device. The values a stage passes to the later ones
+ * stay on its device, and are copied straight to the device of the stage using them.
+ * The feeds of a Run are split along their first dimension into micro-batches, which are pipelined through the
+ * stages, so every device works on a different micro-batch at the same time. The fetches are concatenated back.
+ *
+ * Example:
+ *  PipelineInferenceSession session(so, {0, 1}, [](int device_id) {
+ *    CUDAExecutionProviderInfo info;
+ *    info.device_id = device_id;
+ *    return std::make_unique<CUDAExecutionProvider>(info);
+ *  }, 8);
+ *  session.Load(model_uri);
+ *  session.Initialize();
+ *  session.Run(run_options, feeds, output_names, &fetches);
+ */
+class PipelineInferenceSession {
+ public:
+  // Creates the execution provider of the device of a stage, nullptr for a stage on the CPU provider only.
+  using ProviderFactory = std::function<std::unique_ptr<IExecutionProvider>(int device_id)>;
+
+  // The stages are on device_ids in order. The feeds are split into up to num_micro_batches micro-batches.
+  PipelineInferenceSession(const SessionOptions& session_options, const std::vector<int>& device_ids,
+                           const ProviderFactory& provider_factory, size_t num_micro_batches = 1,
+                           logging::LoggingManager* logging_manager = nullptr);
+
+  ~PipelineInferenceSession();
+
+  /**
+    * Load an ONNX model, split it into stages and create the session of each stage.
+    * @return OK if success.
+    */
+  common::Status Load(const std::string& model_uri);
+  common::Status Load(const void* model_data, int model_data_len);
+
+  /**
+    * Initializes the sessions of all the stages.
+    * @return OK if success.
+    */
+  common::Status Initialize();
+
+  /**
+    * Runs the model through the stages. See InferenceSession::Run, this is thread-safe as well.
+    * The feeds have to be on CPU. They're run as one micro-batch if they aren't all tensors of the same first
+    * dimension, and the fetches of several micro-batches have to be tensors with the batch as their first dimension.
+    */
+  common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
+                     const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
+
+  size_t NumStages() const { return stages_.size(); }
+
+  /**
+    * Get the session of a stage. Only valid after Load.
+    */
+  InferenceSession& GetSession(size_t index) const { return *stages_.at(index).session; }
+
+  /**
+    * Get the names of the values a stage gets from the feeds or from the earlier stages, and that it produces for the
+    * later stages or the fetches. Only valid after Load.
+    */
+  const std::vector<std::string>& GetStageInputs(size_t index) const { return stages_.at(index).inputs; }
+  const std::vector<std::string>& GetStageOutputs(size_t index) const { return stages_.at(index).outputs; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineInferenceSession);
+
+  struct Stage {
+    std::unique_ptr<InferenceSession> session;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+    // whether each output is left on the device of the stage, for a later stage
+    std::vector<bool> outputs_on_device;
+    // the memory of the execution provider of the stage, nullptr for CPU
+    std::unique_ptr<OrtDevice> device;
+  };
+
+  common::Status Load(const ONNX_NAMESPACE::ModelProto& model_proto);
+
+  // Runs a stage on the values of a micro-batch, adding its outputs to them.
+  common::Status RunStage(const Stage& stage, const RunOptions& run_options, NameMLValMap& values) const;
+
+  const SessionOptions session_options_;
+  const std::vector<int> device_ids_;
+  const ProviderFactory provider_factory_;
+  const size_t num_micro_batches_;
+  logging::LoggingManager* logging_manager_;
+  std::basic_string<ORTCHAR_T> model_location_;
+
+  std::vector<Stage> stages_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+ * The work of a Run that only depends on the names of its inputs and outputs and their devices, done once.
+ * Usage is as follows:
+ *
+ * InferenceSession session;
+ * session.Load();
+ * session.Initialize();
+ * ...
+ * std::unique_ptr<PreparedRun> prepared_run;
+ * session.NewPreparedRun(feed_names, output_names, {}, {}, &prepared_run);
+ *
+ * session.Run(run_options, *prepared_run, feeds, &fetches);
+ * session.Run(run_options, *prepared_run, other_feeds, &other_fetches);
+ *
+ * The names are resolved to OrtValue indices and the device copies of the feeds and fetches are planned when it's
+ * created, so a Run only validates the types and shapes of the feeds.
+ * It can be used by concurrent Runs, and must not outlive the session.
+ */
+class PreparedRun {
+ public:
+  const std::vector<std::string>& GetInputNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().feed_names;
+  }
+
+  const std::vector<std::string>& GetOutputNames() const {
+    return feeds_fetches_manager_->GetFeedsFetchesInfo().output_names;
+  }
+
+ private:
+  friend InferenceSession;
+
+  struct ExpectedInput {
+    MLDataType ml_data_type;
+    TensorShape tensor_shape;
+  };
+
+  PreparedRun() = default;
+
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  std::vector<ExpectedInput> expected_inputs_;
+
+  // False when the session has only CPU based execution providers and nothing is ever copied.
+  bool check_devices_ = false;
+  // the devices the copies are planned for, which the feeds and preallocated fetches must be on
+  std::vector<OrtDevice> feed_devices_;
+  std::vector<OrtDevice> fetch_devices_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+};
+}  // namespace onnxruntime
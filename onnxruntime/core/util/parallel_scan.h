@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Splits the range [0, total) into contiguous blocks, one per thread of the pool when there is enough work, for
+// algorithms that make more than one pass over the same blocks with a serial step in between. Without a thread
+// pool the whole range is a single block.
+class BlockPartition {
+ public:
+  BlockPartition(concurrency::ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit)
+      : tp_(tp),
+        total_(std::max<std::ptrdiff_t>(total, 0)),
+        block_count_(tp == nullptr ? 1 : std::max<std::ptrdiff_t>(tp->ComputeBlockCount(total, cost_per_unit), 1)) {
+  }
+
+  std::ptrdiff_t BlockCount() const { return block_count_; }
+
+  // Returns the first index of the block. BlockBegin(BlockCount()) is the total.
+  std::ptrdiff_t BlockBegin(std::ptrdiff_t block) const { return total_ * block / block_count_; }
+
+  // Calls fn(block, first, last) for every block, running the blocks in parallel on the thread pool.
+  template <typename Fn>
+  void ForEachBlock(Fn fn) const {
+    auto run_blocks = [this, &fn](std::ptrdiff_t first_block, std::ptrdiff_t last_block) {
+      for (std::ptrdiff_t block = first_block; block < last_block; ++block) {
+        fn(block, BlockBegin(block), BlockBegin(block + 1));
+      }
+    };
+
+    if (block_count_ == 1) {
+      run_blocks(0, 1);
+    } else {
+      tp_->ParallelFor(block_count_, 0.0, run_blocks);
+    }
+  }
+
+ private:
+  concurrency::ThreadPool* tp_;
+  std::ptrdiff_t total_;
+  std::ptrdiff_t block_count_;
+};
+
+// Two pass parallel prefix sum over the range [0, total).
+//
+// Reduce(reduce) calls reduce(first, last), which returns the sum of its block, for every block in parallel and
+// returns the sum of the whole range. Scan(scan) then calls scan(first, last, offset) for every block in parallel,
+// where offset is the sum of all the blocks before it, so each block can produce its part of the result on its own.
+// Serial work that depends on the sum of the range, such as allocating an output of that size, goes between the
+// two passes.
+template <typename T>
+class ParallelPrefixScan {
+ public:
+  ParallelPrefixScan(concurrency::ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit)
+      : partition_(tp, total, cost_per_unit),
+        offsets_(static_cast<size_t>(partition_.BlockCount()), T{}) {
+  }
+
+  template <typename ReduceFn>
+  T Reduce(ReduceFn reduce) {
+    partition_.ForEachBlock([this, &reduce](std::ptrdiff_t block, std::ptrdiff_t first, std::ptrdiff_t last) {
+      offsets_[block] = reduce(first, last);
+    });
+
+    // turn the block sums into the exclusive prefix sums of the blocks
+    T sum{};
+    for (T& offset : offsets_) {
+      const T block_sum = offset;
+      offset = sum;
+      sum += block_sum;
+    }
+    return sum;
+  }
+
+  template <typename ScanFn>
+  void Scan(ScanFn scan) const {
+    partition_.ForEachBlock([this, &scan](std::ptrdiff_t block, std::ptrdiff_t first, std::ptrdiff_t last) {
+      scan(first, last, offsets_[block]);
+    });
+  }
+
+ private:
+  BlockPartition partition_;
+  std::vector<T> offsets_;
+};
+
+}  // namespace onnxruntime
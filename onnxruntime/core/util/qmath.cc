@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/util/qmath.h"
+
+#include <vector>
+
 #include "core/common/common.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -69,6 +72,83 @@ void QGemmu8u8_s32(
 #else
   MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, result_data, ldc, thread_pool);
 
+#endif
+}
+
+void QGemmu8u8_u8(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    const int32_t* bias,
+    int32_t* accumulators,
+    uint8_t* result_data,
+    int ldc,
+    float real_multiplier,
+    const uint8_t result_offset,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+
+  ORT_ENFORCE(lda == K && ldb == N && ldc == N, "For gemmlowp only RowMajor*RowMajor=RowMajor format is supported");
+
+  GemmlowpMultiplyu8u8_s32(lhs_data, rhs_data, accumulators, lhs_offset, rhs_offset, M, N, K, thread_pool);
+  MlasRequantizeOutput(accumulators, result_data, bias, M, N, real_multiplier, result_offset);
+
+#else
+  MLAS_QGEMM_REQUANTIZE requantize;
+  requantize.Output = result_data;
+  requantize.ldo = ldc;
+  requantize.Bias = bias;
+  requantize.Scale = real_multiplier;
+  requantize.ZeroPoint = result_offset;
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, accumulators, N, &requantize, thread_pool);
+
+#endif
+}
+
+void QGemmf32u8_f32(
+    int M,
+    int N,
+    int K,
+    const float* lhs_data,
+    int lda,
+    float lhs_scale,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    const float* bias,
+    int32_t* accumulators,
+    float* result_data,
+    int ldc,
+    float output_scale,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+
+  ORT_ENFORCE(lda == K && ldb == N && ldc == N, "For gemmlowp only RowMajor*RowMajor=RowMajor format is supported");
+
+  std::vector<uint8_t> quantized_lhs(static_cast<size_t>(M) * K);
+  MlasQuantizeLinear(lhs_data, quantized_lhs.data(), quantized_lhs.size(), lhs_scale, lhs_offset);
+  GemmlowpMultiplyu8u8_s32(quantized_lhs.data(), rhs_data, accumulators, lhs_offset, rhs_offset, M, N, K,
+                           thread_pool);
+  MlasDequantizeOutput(accumulators, result_data, bias, M, N, output_scale);
+
+#else
+  MLAS_QGEMM_DEQUANTIZE dequantize;
+  dequantize.Output = result_data;
+  dequantize.ldo = ldc;
+  dequantize.Bias = bias;
+  dequantize.Scale = output_scale;
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_scale, lhs_offset, rhs_data, ldb, rhs_offset, accumulators, N, &dequantize,
+           thread_pool);
+
 #endif
 }
 }  // namespace onnxruntime
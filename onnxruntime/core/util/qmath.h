@@ -35,4 +35,48 @@ void QGemmu8u8_s32(
     int ldc,
     concurrency::ThreadPool* thread_pool);
 
+// Computes the uint8 product of lhs and rhs requantized with real_multiplier and result_offset. The
+// optional bias of M elements is added to each row of the 32-bit product first. The accumulators
+// buffer of M x N elements receives the 32-bit product; when MLAS is available the requantization
+// is fused into the GEMM as each block of the product is completed.
+void QGemmu8u8_u8(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    const int32_t* bias,
+    int32_t* accumulators,
+    uint8_t* result_data,
+    int ldc,
+    float real_multiplier,
+    const uint8_t result_offset,
+    concurrency::ThreadPool* thread_pool);
+
+// Computes the float product of lhs, quantized to uint8 with lhs_scale and lhs_offset, and rhs. The 32-bit
+// product is multiplied by output_scale and the optional bias of N elements is added to each row. The
+// accumulators buffer of M x N elements receives the 32-bit product; when MLAS is available lhs is quantized
+// as each block of it is packed and the product dequantized as each block of it is completed.
+void QGemmf32u8_f32(
+    int M,
+    int N,
+    int K,
+    const float* lhs_data,
+    int lda,
+    float lhs_scale,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    const float* bias,
+    int32_t* accumulators,
+    float* result_data,
+    int ldc,
+    float output_scale,
+    concurrency::ThreadPool* thread_pool);
+
 }  // namespace onnxruntime
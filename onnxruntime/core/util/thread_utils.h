@@ -6,5 +6,8 @@ namespace onnxruntime {
 namespace concurrency {
 
 std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size);
+
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size,
+                                             const ThreadOptions& thread_options);
 }  // namespace concurrency
 }  // namespace onnxruntime
\ No newline at end of file
@@ -95,6 +95,39 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+// Releases a numpy array when the tensor wrapping its memory is released.
+// It never allocates, it only holds a reference on the array.
+class NumpyArrayOwner : public IAllocator {
+ public:
+  NumpyArrayOwner(PyArrayObject* darray, const OrtMemoryInfo& info) : darray_(darray), info_(info) {}
+
+  void* Alloc(size_t /*size*/) override {
+    throw std::runtime_error("A numpy array can't allocate memory.");
+  }
+
+  void Free(void* /*p*/) override {
+    // the last reference on the tensor may be dropped on a thread that doesn't hold the GIL
+    py::gil_scoped_acquire acquire;
+    Py_XDECREF(darray_);
+    darray_ = nullptr;
+  }
+
+  const OrtMemoryInfo& Info() const override { return info_; }
+
+ private:
+  PyArrayObject* darray_;
+  const OrtMemoryInfo info_;
+};
+
+static bool CanWrapNumpyArray(const AllocatorPtr& alloc, PyArrayObject* darray, int npy_type) {
+  if (npy_type == NPY_UNICODE || npy_type == NPY_STRING || npy_type == NPY_VOID || npy_type == NPY_OBJECT) {
+    return false;
+  }
+  // the kernels read the memory as an array of the element type, in host memory
+  return PyArray_ISALIGNED(darray) && PyArray_ISNOTSWAPPED(darray) &&
+         alloc->Info().device.Type() == OrtDevice::CPU;
+}
+
 void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject,
                          OrtValue* p_mlvalue) {
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
@@ -115,6 +148,18 @@ void CreateTensorMLValue(AllocatorPtr alloc, const std::string& name_input, PyAr
 
     TensorShape shape(dims);
     auto element_type = NumpyToOnnxRuntimeTensorType(npy_type);
+    if (CanWrapNumpyArray(alloc, darray, npy_type)) {
+      // The tensor uses the memory of the contiguous array, and keeps the reference
+      // PyArray_GETCONTIGUOUS returned until it's released.
+      std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, shape, PyArray_DATA(darray),
+                                                                  std::make_shared<NumpyArrayOwner>(darray, alloc->Info()));
+      dref = true;
+      p_mlvalue->Init(p_tensor.release(),
+                      DataTypeImpl::GetType<Tensor>(),
+                      DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+      return;
+    }
+
     std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(element_type, shape, alloc);
     if (npy_type == NPY_UNICODE) {
       // Copy string data which needs to be done after Tensor is allocated.
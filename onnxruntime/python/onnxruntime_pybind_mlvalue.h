@@ -22,6 +22,8 @@ namespace py = pybind11;
 
 int OnnxRuntimeTensorToNumpyType(const DataTypeImpl* tensor_type);
 
+const DataTypeImpl* NumpyToOnnxRuntimeTensorType(int numpy_type);
+
 void CreateGenericMLValue(AllocatorPtr alloc, const std::string& name_input, py::object& value, OrtValue* p_mlvalue);
 
 }  // namespace python
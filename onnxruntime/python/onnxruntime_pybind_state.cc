@@ -9,6 +9,7 @@
 #include <numpy/arrayobject.h>
 
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/IOBinding.h"
 #include "core/graph/graph_viewer.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
@@ -78,6 +79,7 @@
 
 #define BACKEND_DEVICE BACKEND_PROC BACKEND_MKLDNN BACKEND_MKLML BACKEND_NGRAPH BACKEND_OPENVINO BACKEND_NUPHAR BACKEND_OPENBLAS
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/prepared_run.h"
 #include "core/providers/providers.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/cpu_provider_factory.h"
@@ -107,6 +109,9 @@ std::string nuphar_settings;
 
 namespace onnxruntime {
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena);
+std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CPU(int use_arena, int numa_node,
+                                                                              bool use_huge_pages,
+                                                                              bool use_bf16_matmul);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_CUDA(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Tensorrt(int device_id);
 std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Mkldnn(int use_arena);
@@ -120,6 +125,7 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_BrainS
 #pragma warning(disable : 4267 4996 4503 4003)
 #endif  // _MSC_VER
 
+#include <future>
 #include <iterator>
 
 #if defined(_MSC_VER)
@@ -193,6 +199,24 @@ void AddTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
 
   MLDataType dtype = rtensor.DataType();
   const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+
+  // A numeric tensor in host memory that owns its buffer is returned without a copy: the array uses the
+  // buffer, and its base is a capsule holding a reference on the tensor, so the buffer lives as long as the array.
+  if (numpy_type != NPY_OBJECT && rtensor.OwnsBuffer() && rtensor.Location().device.Type() == OrtDevice::CPU &&
+      rtensor.DataRaw() != nullptr) {
+    py::capsule owner(new OrtValue(val), [](void* p) { delete reinterpret_cast<OrtValue*>(p); });
+    py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+        shape.NumDimensions(), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw())));
+    if (!obj) {
+      throw py::error_already_set();
+    }
+    if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), owner.release().ptr()) != 0) {
+      throw py::error_already_set();
+    }
+    pyobjs.push_back(obj);
+    return;
+  }
+
   py::object obj = py::reinterpret_steal<py::object>(PyArray_SimpleNew(
       shape.NumDimensions(), npy_dims.data(), numpy_type));
 
@@ -279,7 +303,10 @@ const std::vector<std::string>& GetAvailableProviders() {
 void RegisterExecutionProviders(InferenceSession* sess, const std::vector<std::string>& provider_types) {
   for (const std::string& type : provider_types) {
     if (type == kCpuExecutionProvider) {
-      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena));
+      RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_CPU(sess->GetSessionOptions().enable_cpu_mem_arena,
+                                                                                 sess->GetSessionOptions().numa_node,
+                                                                                 sess->GetSessionOptions().use_huge_pages,
+                                                                                 sess->GetSessionOptions().use_bf16_matmul));
     } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
       RegisterExecutionProvider(sess, *onnxruntime::CreateExecutionProviderFactory_Tensorrt(0));
@@ -327,6 +354,187 @@ void InitializeSession(InferenceSession* sess, const std::vector<std::string>& p
   OrtPybindThrowIfError(sess->Initialize());
 }
 
+static void CreateFeedMLValue(const std::string& name, py::object& value, OrtValue* p_mlvalue) {
+  CreateGenericMLValue(GetAllocator(), name, value, p_mlvalue);
+  if (PyErr_Occurred()) {
+    PyObject *ptype, *pvalue, *ptraceback;
+    PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+
+    PyObject* pStr = PyObject_Str(ptype);
+    std::string sType = py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    pStr = PyObject_Str(pvalue);
+    sType += ": ";
+    sType += py::reinterpret_borrow<py::str>(pStr);
+    Py_XDECREF(pStr);
+    throw std::runtime_error(sType);
+  }
+}
+
+static std::vector<py::object> FetchesToPyObjects(const std::vector<OrtValue>& fetches) {
+  std::vector<py::object> rfetch;
+  rfetch.reserve(fetches.size());
+  for (auto _ : fetches) {
+    if (_.IsTensor()) {
+      AddTensorAsPyObj(_, rfetch);
+    } else {
+      AddNonTensorAsPyObj(_, rfetch);
+    }
+  }
+  return rfetch;
+}
+
+// An IOBinding that keeps the numpy arrays bound as preallocated outputs alive
+struct PyIOBinding {
+  std::unique_ptr<IOBinding> binding;
+  std::unordered_map<std::string, py::object> output_arrays;
+};
+
+// Wraps the memory of a numpy array, so that a Run writes the output into it
+static OrtValue WrapArrayAsOutput(const std::string& name, py::object& value) {
+  if (!PyArray_Check(value.ptr())) {
+    throw std::runtime_error("The buffer bound to output '" + name + "' must be a numpy array.");
+  }
+
+  PyArrayObject* arr = reinterpret_cast<PyArrayObject*>(value.ptr());
+  if (!PyArray_ISCARRAY(arr)) {
+    throw std::runtime_error("The array bound to output '" + name + "' must be contiguous and writeable.");
+  }
+
+  const int npy_type = PyArray_TYPE(arr);
+  if (npy_type == NPY_UNICODE || npy_type == NPY_STRING || npy_type == NPY_VOID || npy_type == NPY_OBJECT) {
+    throw std::runtime_error("The array bound to output '" + name + "' must be numeric.");
+  }
+
+  std::vector<int64_t> dims(PyArray_DIMS(arr), PyArray_DIMS(arr) + PyArray_NDIM(arr));
+  OrtValue ml_value;
+  ml_value.Init(new Tensor(NumpyToOnnxRuntimeTensorType(npy_type), TensorShape(dims), PyArray_DATA(arr),
+                           GetAllocator()->Info()),
+                DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+  return ml_value;
+}
+
+// Runs the feeds of a Python iterator one after the other. The next feeds are read and converted while the Run of
+// the current ones executes on a thread of the session, which is then started before the outputs of the current
+// Run are returned, so loading the inputs and handling the outputs overlap with the Runs.
+class PyRunIterator {
+ public:
+  PyRunIterator(InferenceSession* sess, std::vector<std::string> output_names, py::object feeds_iter,
+                py::object run_options)
+      : sess_{sess},
+        output_names_{std::move(output_names)},
+        feeds_iter_{std::move(feeds_iter)},
+        run_options_{std::move(run_options)} {}
+
+  ~PyRunIterator() {
+    // the Run may still use the arrays of its feeds
+    if (pending_ != nullptr) {
+      py::gil_scoped_release release;
+      pending_->result.wait();
+    }
+  }
+
+  std::vector<py::object> Next() {
+    if (pending_ == nullptr) {
+      pending_ = Start(ReadFeeds());
+      if (pending_ == nullptr) {
+        throw py::stop_iteration();
+      }
+    }
+
+    std::unique_ptr<PendingRun> next;
+    try {
+      next = ReadFeeds();
+    } catch (...) {
+      // an error reading the next feeds ends the iteration, once the current Run no longer uses its feeds
+      {
+        py::gil_scoped_release release;
+        pending_->result.wait();
+      }
+      pending_.reset();
+      throw;
+    }
+
+    std::pair<Status, std::vector<OrtValue>> result;
+    {
+      py::gil_scoped_release release;
+      result = pending_->result.get();
+    }
+    pending_ = Start(std::move(next));
+
+    OrtPybindThrowIfError(result.first);
+    return FetchesToPyObjects(result.second);
+  }
+
+ private:
+  struct PendingRun {
+    // keeps the arrays the feeds may point into alive until the Run completes
+    py::dict pyfeeds;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::future<std::pair<Status, std::vector<OrtValue>>> result;
+  };
+
+  // Converts the next feeds of the iterator, nullptr once it is exhausted.
+  std::unique_ptr<PendingRun> ReadFeeds() {
+    if (feeds_iter_.is_none()) {
+      return nullptr;
+    }
+    auto item = py::reinterpret_steal<py::object>(PyIter_Next(feeds_iter_.ptr()));
+    if (!item) {
+      feeds_iter_ = py::none();
+      if (PyErr_Occurred()) {
+        throw py::error_already_set();
+      }
+      return nullptr;
+    }
+
+    auto run = std::make_unique<PendingRun>();
+    run->pyfeeds = item.cast<py::dict>();
+    for (auto& feed : run->pyfeeds) {
+      std::string name = feed.first.cast<std::string>();
+      py::object value = py::reinterpret_borrow<py::object>(feed.second);
+      OrtValue ml_value;
+      CreateFeedMLValue(name, value, &ml_value);
+      run->feed_names.push_back(std::move(name));
+      run->feeds.push_back(ml_value);
+    }
+    return run;
+  }
+
+  std::unique_ptr<PendingRun> Start(std::unique_ptr<PendingRun> run) {
+    if (run == nullptr) {
+      return nullptr;
+    }
+
+    static const RunOptions default_run_options;
+    const RunOptions& options = run_options_.is_none() ? default_run_options : *run_options_.cast<RunOptions*>();
+    auto promise = std::make_shared<std::promise<std::pair<Status, std::vector<OrtValue>>>>();
+    run->result = promise->get_future();
+    sess_->RunAsync(options, run->feed_names, run->feeds, output_names_, {},
+                    [promise](const Status& status, std::vector<OrtValue>& fetches) {
+                      promise->set_value(std::make_pair(status, std::move(fetches)));
+                    });
+    return run;
+  }
+
+  InferenceSession* sess_;
+  const std::vector<std::string> output_names_;
+  py::object feeds_iter_;
+  py::object run_options_;
+  std::unique_ptr<PendingRun> pending_;
+};
+
+static OrtDevice GetDevice(const std::string& device_type, int device_id) {
+  if (device_type == "cpu") {
+    return OrtDevice();
+  }
+  if (device_type == "cuda") {
+    return OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(device_id));
+  }
+  throw std::runtime_error("Unsupported device type '" + device_type + "', expected 'cpu' or 'cuda'.");
+}
+
 void addGlobalMethods(py::module& m) {
   m.def("get_session_initializer", &SessionObjectInitializer::Get, "Return a default session object initializer.");
   m.def(
@@ -537,10 +745,67 @@ void addObjectMethods(py::module& m) {
 Set this option to false if you don't want it. Default is True.)pbdoc")
       .def_readwrite("enable_profiling", &SessionOptions::enable_profiling,
                      R"pbdoc(Enable profiling for this session. Default is false.)pbdoc")
+      .def_readwrite("enable_node_stats", &SessionOptions::enable_node_stats,
+                     R"pbdoc(Collect the count, kernel time and output bytes of every node in lock-free counters, cheap enough to be left on. See InferenceSession.get_node_stats. Default is false.)pbdoc")
       .def_readwrite("optimized_model_filepath", &SessionOptions::optimized_model_filepath,
                      R"pbdoc(File path to serialize optimized model. By default, optimized model is not serialized if optimized_model_filepath is not provided.)pbdoc")
+      .def_readwrite("optimization_report_filepath", &SessionOptions::optimization_report_filepath,
+                     R"pbdoc(File path to write, as JSON, what each graph transformer did to the graph and the op types and execution providers of the final graph. By default, no report is written.)pbdoc")
+      .def_readwrite("enable_shape_subgraph_cache", &SessionOptions::enable_shape_subgraph_cache,
+                     R"pbdoc(Reuse the outputs of the nodes that only depend on the outputs of Shape and Size nodes from an earlier run with the same shapes. Default is true.)pbdoc")
+      .def_readwrite("enable_cost_based_partitioning", &SessionOptions::enable_cost_based_partitioning,
+                     R"pbdoc(Place the nodes an execution provider other than CPU claims on it only where it is estimated to be faster than the CPU, copies included. Default is false.)pbdoc")
+      .def_readwrite("partitioning_cost_filepath", &SessionOptions::partitioning_cost_filepath,
+                     R"pbdoc(File the decisions of the cost based partitioning are loaded from, if it exists, and saved to, so sessions of the same model reuse them. Default is empty for none.)pbdoc")
+      .def_readwrite("warmup_runs", &SessionOptions::warmup_runs,
+                     R"pbdoc(Number of runs executed when the session is created, so the work of the first runs, such as the growth of the arenas or the algorithm search of the kernels, doesn't slow down the first requests. Default is 0.)pbdoc")
+      .def_readwrite("warmup_inputs_path", &SessionOptions::warmup_inputs_path,
+                     R"pbdoc(Directory with the inputs of the warmup runs as TensorProto files input_0.pb, input_1.pb, ... Default is empty, which generates zero-filled inputs, with 1 for the free dimensions.)pbdoc")
       .def_readwrite("enable_mem_pattern", &SessionOptions::enable_mem_pattern,
                      R"pbdoc(Enable the memory pattern optimization. Default is true.)pbdoc")
+      .def_readwrite("mem_pattern_cache_size", &SessionOptions::mem_pattern_cache_size,
+                     R"pbdoc(Maximum number of memory patterns cached per graph. 0 means unbounded. Default is 16.)pbdoc")
+      .def_readwrite("execution_frame_pool_size", &SessionOptions::execution_frame_pool_size,
+                     R"pbdoc(Maximum number of execution frames kept per graph for reuse by later runs. 0 disables the reuse. Default is 4.)pbdoc")
+      .def_readwrite("mem_pattern_dim_buckets", &SessionOptions::mem_pattern_dim_buckets,
+                     R"pbdoc(Ascending bucket boundaries that input dimensions are rounded up to when looking up
+a cached memory pattern. Default is empty, which requires an exact shape match.)pbdoc")
+      .def_readwrite("enable_graph_capture", &SessionOptions::enable_graph_capture,
+                     R"pbdoc(Replay the device work captured from a previous run, such as a CUDA graph, for runs
+with the same input shapes and the same input and output buffers bound with IOBinding. Default is false.)pbdoc")
+      .def_readwrite("enable_mixed_precision", &SessionOptions::enable_mixed_precision,
+                     R"pbdoc(Run the float nodes placed on CUDA in float16 where float16 kernels exist, with Cast nodes
+at the edges of the converted regions. Default is false.)pbdoc")
+      .def_readwrite("mixed_precision_allow_list", &SessionOptions::mixed_precision_allow_list,
+                     R"pbdoc(Op types converted to float16 by enable_mixed_precision. Default is empty, which uses
+the built-in list.)pbdoc")
+      .def_readwrite("mixed_precision_deny_list", &SessionOptions::mixed_precision_deny_list,
+                     R"pbdoc(Op types kept in float even if allowed. Default is empty, which keeps Softmax, the
+reductions and the normalizations in float.)pbdoc")
+      .def_readwrite("enable_calibration", &SessionOptions::enable_calibration,
+                     R"pbdoc(Collect the ranges of the float inputs and node outputs over the runs of a calibration
+dataset. See InferenceSession.get_calibration_ranges. Default is false.)pbdoc")
+      .def_property(
+          "static_quantization_ranges",
+          [](const SessionOptions* options) -> py::dict {
+            py::dict ranges;
+            for (const auto& entry : options->static_quantization_ranges) {
+              ranges[py::str(entry.first)] = py::make_tuple(entry.second.min, entry.second.max);
+            }
+            return ranges;
+          },
+          [](SessionOptions* options, const std::unordered_map<std::string, std::pair<float, float>>& ranges) {
+            options->static_quantization_ranges.clear();
+            for (const auto& entry : ranges) {
+              options->static_quantization_ranges[entry.first] = TensorRange{entry.second.first, entry.second.second};
+            }
+          },
+          R"pbdoc(Dictionary of the (min, max) ranges of the tensors, as returned by
+InferenceSession.get_calibration_ranges. When not empty, the Conv and MatMul nodes on CPU whose input and output have
+a range are quantized to QLinearConv and QLinearMatMul. Default is empty.)pbdoc")
+      .def_readwrite("enable_weight_only_quantization", &SessionOptions::enable_weight_only_quantization,
+                     R"pbdoc(Store the constant float weights of the MatMul, Gemm and Gather nodes on CPU as int8 with
+a scale per channel, dequantized as they are used. Default is false.)pbdoc")
       .def_readwrite("enable_sequential_execution", &SessionOptions::enable_sequential_execution,
                      R"pbdoc(Enables sequential execution, disables parallel execution. Default is true.)pbdoc")
       .def_readwrite("logid", &SessionOptions::session_logid,
@@ -555,6 +820,16 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
                      R"pbdoc(Sets the number of threads used to parallelize the execution within nodes. Default is 0 to let onnxruntime choose.)pbdoc")
       .def_readwrite("inter_op_num_threads", &SessionOptions::inter_op_num_threads,
                      R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
+      .def_readwrite("intra_op_thread_affinity", &SessionOptions::intra_op_thread_affinity,
+                     R"pbdoc(Logical processors the threads used to parallelize the execution within nodes are pinned to. Default is empty to not pin them.)pbdoc")
+      .def_readwrite("intra_op_spin_duration_us", &SessionOptions::intra_op_spin_duration_us,
+                     R"pbdoc(Time, in microseconds, the threads used to parallelize the execution within nodes spin between the nodes of a run waiting for more work before they go back to the pool. Default is 100. Set it to 0 to release them right away.)pbdoc")
+      .def_readwrite("numa_node", &SessionOptions::numa_node,
+                     R"pbdoc(NUMA node to run the session on. Pins the threads used to parallelize the execution within nodes to the processors of the node and allocates the CPU memory on it. Default is -1 for none.)pbdoc")
+      .def_readwrite("use_huge_pages", &SessionOptions::use_huge_pages,
+                     R"pbdoc(Back the large CPU allocations, including the ones holding the initializers, with huge pages where available. See InferenceSession.get_huge_page_bytes. Default is false.)pbdoc")
+      .def_readwrite("use_bf16_matmul", &SessionOptions::use_bf16_matmul,
+                     R"pbdoc(Let the float MatMul on CPU multiply inputs rounded to bfloat16 on processors with bfloat16 dot product instructions. Faster but less precise. Default is false.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
@@ -596,7 +871,16 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
                 break;
             }
           },
-          R"pbdoc(Graph optimization level for this session.)pbdoc");
+          R"pbdoc(Graph optimization level for this session.)pbdoc")
+      .def(
+          "add_initializer",
+          [](SessionOptions* options, const std::string& name, py::object& value) -> void {
+            OrtValue ml_value;
+            CreateFeedMLValue(name, value, &ml_value);
+            options->initializers_to_share[name] = ml_value;
+          },
+          R"pbdoc(Use a copy of the array for the initializer of the given name instead of loading it from the
+model. The sessions created with these options share the copy.)pbdoc");
 
   py::class_<RunOptions>(m, "RunOptions", R"pbdoc(Configuration information for a single Run.)pbdoc")
       .def(py::init())
@@ -609,7 +893,24 @@ Applies to a particular Run() invocation. Default is 0.)pbdoc")
                      "To identify logs generated by a particular Run() invocation.")
       .def_readwrite("terminate", &RunOptions::terminate,
                      R"pbdoc(Set to True to terminate any currently executing calls that are using this
-RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc");
+RunOptions instance. The individual calls will exit gracefully and return an error status.)pbdoc")
+      .def_readwrite("intra_op_num_threads", &RunOptions::intra_op_num_threads,
+                     R"pbdoc(Max number of threads, including the calling one, the kernels of a Run may use
+from the session's intra-op thread pool. Default is 0, all of them.)pbdoc")
+      .def(
+          "set_timeout",
+          [](RunOptions* options, int64_t timeout_us) -> void {
+            ORT_ENFORCE(timeout_us >= 0, "timeout_us must be >= 0");
+            options->deadline = timeout_us == 0
+                                    ? std::chrono::steady_clock::time_point::max()
+                                    : std::chrono::steady_clock::now() + std::chrono::microseconds(timeout_us);
+          },
+          R"pbdoc(Sets the deadline of the Runs using these options to timeout_us microseconds from now. A Run still
+executing at the deadline stops and raises, and a Run started past it raises without running. 0 removes the
+deadline.)pbdoc")
+      .def_readwrite("priority", &RunOptions::priority,
+                     R"pbdoc(Order of the queued Runs using these options, the ones of higher priority are run
+first. Default is 0.)pbdoc");
 
   py::class_<ModelMetadata>(m, "ModelMetadata", R"pbdoc(Pre-defined and custom metadata about the model.
 It is usually used to identify the model used to run the prediction and
@@ -681,6 +982,54 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           },
           "node shape (assuming the node holds a tensor)");
 
+  py::class_<PreparedRun>(m, "PreparedRun", R"pbdoc(The names of the inputs and outputs of Runs of a session, resolved once.)pbdoc")
+      .def_property_readonly("input_names", &PreparedRun::GetInputNames)
+      .def_property_readonly("output_names", &PreparedRun::GetOutputNames);
+
+  py::class_<PyRunIterator>(m, "SessionRunIterator", R"pbdoc(The outputs of Runs of a sequence of feeds, computed ahead of the caller.)pbdoc")
+      .def("__iter__", [](PyRunIterator& it) -> PyRunIterator& { return it; })
+      .def("__next__", &PyRunIterator::Next);
+
+  py::class_<PyIOBinding>(m, "SessionIOBinding", R"pbdoc(The inputs and outputs of the Runs of a session bound to values.)pbdoc")
+      .def(py::init([](InferenceSession* sess) {
+             auto io_binding = std::make_unique<PyIOBinding>();
+             OrtPybindThrowIfError(sess->NewIOBinding(&io_binding->binding));
+             return io_binding;
+           }),
+           py::keep_alive<1, 2>())
+      .def(
+          "bind_input", [](PyIOBinding* io_binding, const std::string& name, py::object& value) -> void {
+            OrtValue ml_value;
+            CreateFeedMLValue(name, value, &ml_value);
+            OrtPybindThrowIfError(io_binding->binding->BindInput(name, ml_value));
+          },
+          R"pbdoc(Bind a copy of the array to an input. It's copied to the device of its consumers once, here.)pbdoc")
+      .def(
+          "bind_output", [](PyIOBinding* io_binding, const std::string& name, const std::string& device_type, int device_id) -> void {
+            OrtPybindThrowIfError(io_binding->binding->BindOutput(name, GetDevice(device_type, device_id)));
+            io_binding->output_arrays.erase(name);
+          },
+          py::arg("name"), py::arg("device_type") = "cpu", py::arg("device_id") = 0,
+          R"pbdoc(Bind an output that the Runs allocate on the device, 'cpu' or 'cuda', where it stays.)pbdoc")
+      .def(
+          "bind_output_array", [](PyIOBinding* io_binding, const std::string& name, py::object& value) -> void {
+            OrtPybindThrowIfError(io_binding->binding->BindOutput(name, WrapArrayAsOutput(name, value)));
+            io_binding->output_arrays[name] = value;
+          },
+          R"pbdoc(Bind a numpy array with the type and shape of an output, into which the Runs write it.)pbdoc")
+      .def("clear_binding_inputs", [](PyIOBinding* io_binding) -> void { io_binding->binding->ClearInputs(); })
+      .def("clear_binding_outputs", [](PyIOBinding* io_binding) -> void {
+        io_binding->binding->ClearOutputs();
+        io_binding->output_arrays.clear();
+      })
+      .def(
+          "copy_outputs_to_cpu", [](const PyIOBinding* io_binding) -> std::vector<py::object> {
+            std::vector<OrtValue> cpu_outputs;
+            OrtPybindThrowIfError(io_binding->binding->CopyOutputsToCpu(cpu_outputs));
+            return FetchesToPyObjects(cpu_outputs);
+          },
+          R"pbdoc(Return copies of the outputs of the last Run as numpy arrays, in the order they were bound.)pbdoc");
+
   py::class_<SessionObjectInitializer>(m, "SessionObjectInitializer");
   py::class_<InferenceSession>(m, "InferenceSession", R"pbdoc(This is the main class used to run a model.)pbdoc")
       .def(py::init<SessionObjectInitializer, SessionObjectInitializer>())
@@ -691,6 +1040,17 @@ including arg name, arg type (contains both type and shape).)pbdoc")
             InitializeSession(sess, provider_types);
           },
           R"pbdoc(Load a model saved in ONNX format.)pbdoc")
+      .def(
+          "load_composed_models", [](InferenceSession* sess, const std::vector<std::string>& paths, std::vector<std::string>& provider_types) {
+            std::vector<std::basic_string<ORTCHAR_T>> model_uris;
+            for (const auto& path : paths) {
+              model_uris.push_back(ToWideString(path));
+            }
+            OrtPybindThrowIfError(sess->LoadComposed(model_uris));
+            InitializeSession(sess, provider_types);
+          },
+          R"pbdoc(Load the models of a pipeline saved in ONNX format composed into a single graph. Each input of a
+model is fed by the output of the same name of the latest earlier model producing one.)pbdoc")
       .def(
           "read_bytes", [](InferenceSession* sess, const py::bytes& serializedModel, std::vector<std::string>& provider_types) {
             std::istringstream buffer(serializedModel);
@@ -702,20 +1062,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
         NameMLValMap feeds;
         for (auto _ : pyfeeds) {
           OrtValue ml_value;
-          CreateGenericMLValue(GetAllocator(), _.first, _.second, &ml_value);
-          if (PyErr_Occurred()) {
-            PyObject *ptype, *pvalue, *ptraceback;
-            PyErr_Fetch(&ptype, &pvalue, &ptraceback);
-
-            PyObject* pStr = PyObject_Str(ptype);
-            std::string sType = py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            pStr = PyObject_Str(pvalue);
-            sType += ": ";
-            sType += py::reinterpret_borrow<py::str>(pStr);
-            Py_XDECREF(pStr);
-            throw std::runtime_error(sType);
-          }
+          CreateFeedMLValue(_.first, _.second, &ml_value);
           feeds.insert(std::make_pair(_.first, ml_value));
         }
 
@@ -732,20 +1079,148 @@ including arg name, arg type (contains both type and shape).)pbdoc")
           }
         }
 
-        std::vector<py::object> rfetch;
-        rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
-          if (_.IsTensor()) {
-            AddTensorAsPyObj(_, rfetch);
-          } else {
-            AddNonTensorAsPyObj(_, rfetch);
-          }
-        }
-        return rfetch;
+        return FetchesToPyObjects(fetches);
       })
+      .def(
+          "prepare_run", [](InferenceSession* sess, const std::vector<std::string>& input_names, const std::vector<std::string>& output_names) {
+            std::unique_ptr<PreparedRun> prepared_run;
+            OrtPybindThrowIfError(sess->NewPreparedRun(input_names, output_names, {}, {}, &prepared_run));
+            return prepared_run;
+          },
+          py::keep_alive<0, 1>(),
+          R"pbdoc(Resolve the names of the inputs and outputs of Runs once, for run_prepared.)pbdoc")
+      .def(
+          "run_prepared", [](InferenceSession* sess, const PreparedRun* prepared_run, py::list pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
+            const auto& input_names = prepared_run->GetInputNames();
+            if (pyfeeds.size() != input_names.size()) {
+              throw std::runtime_error("The prepared run has " + std::to_string(input_names.size()) +
+                                       " inputs, but " + std::to_string(pyfeeds.size()) + " were given.");
+            }
+
+            std::vector<OrtValue> feeds(input_names.size());
+            for (size_t i = 0; i < input_names.size(); ++i) {
+              py::object feed = pyfeeds[i];
+              CreateFeedMLValue(input_names[i], feed, &feeds[i]);
+            }
+
+            std::vector<OrtValue> fetches;
+
+            {
+              // release GIL to allow multiple python threads to invoke Run() in parallel.
+              py::gil_scoped_release release;
+              if (run_options != nullptr) {
+                OrtPybindThrowIfError(sess->Run(*run_options, *prepared_run, feeds, &fetches));
+              } else {
+                OrtPybindThrowIfError(sess->Run(RunOptions(), *prepared_run, feeds, &fetches));
+              }
+            }
+
+            return FetchesToPyObjects(fetches);
+          },
+          R"pbdoc(Run with the inputs of a prepared run, in the order of its input names.)pbdoc")
+      .def(
+          "run_async", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, py::function callback, py::object run_options) -> void {
+            std::vector<std::string> feed_names;
+            std::vector<OrtValue> feeds;
+            for (auto& feed : pyfeeds) {
+              OrtValue ml_value;
+              CreateFeedMLValue(feed.first, feed.second, &ml_value);
+              feed_names.push_back(feed.first);
+              feeds.push_back(ml_value);
+            }
+
+            // keeps the arrays the feeds may point into alive until the Run completes, RunAsync copies the run
+            // options. the Python objects are only released with the GIL held.
+            struct AsyncRunState {
+              std::map<std::string, py::object> pyfeeds;
+              py::function callback;
+            };
+            auto* state = new AsyncRunState{std::move(pyfeeds), std::move(callback)};
+
+            static const RunOptions default_run_options;
+            const RunOptions& options = run_options.is_none() ? default_run_options : *run_options.cast<RunOptions*>();
+            sess->RunAsync(options, std::move(feed_names), std::move(feeds), std::move(output_names), {},
+                           [state](const Status& status, std::vector<OrtValue>& fetches) {
+                             py::gil_scoped_acquire acquire;
+                             std::unique_ptr<AsyncRunState> owned_state{state};
+                             try {
+                               if (status.IsOK()) {
+                                 owned_state->callback(FetchesToPyObjects(fetches), py::none());
+                               } else {
+                                 owned_state->callback(py::none(), status.ErrorMessage());
+                               }
+                             } catch (py::error_already_set& e) {
+                               // there is no caller to raise it to
+                               e.restore();
+                               PyErr_WriteUnraisable(owned_state->callback.ptr());
+                             }
+                           });
+          },
+          R"pbdoc(Queue a Run on the threads of the session, calling callback(outputs, error) when it completes.)pbdoc")
+      .def(
+          "run_iter", [](InferenceSession* sess, std::vector<std::string> output_names, py::object feeds_iter, py::object run_options) {
+            return std::make_unique<PyRunIterator>(sess, std::move(output_names), std::move(feeds_iter), run_options);
+          },
+          py::keep_alive<0, 1>(),
+          R"pbdoc(Return an iterator of the outputs of Runs of the feeds of an iterator, each Run executing on the threads
+of the session while the next feeds are converted.)pbdoc")
+      .def(
+          "run_with_iobinding", [](InferenceSession* sess, PyIOBinding* io_binding, RunOptions* run_options = nullptr) -> void {
+            // release GIL to allow multiple python threads to invoke Run() in parallel.
+            py::gil_scoped_release release;
+            if (run_options != nullptr) {
+              OrtPybindThrowIfError(sess->Run(*run_options, *io_binding->binding));
+            } else {
+              OrtPybindThrowIfError(sess->Run(*io_binding->binding));
+            }
+          },
+          R"pbdoc(Run with the inputs and outputs bound to the binding.)pbdoc")
       .def("end_profiling", [](InferenceSession* sess) -> std::string {
         return sess->EndProfiling();
       })
+      .def(
+          "get_node_stats", [](const InferenceSession* sess) -> py::list {
+            std::vector<NodeStats> node_stats;
+            OrtPybindThrowIfError(sess->GetNodeStats(node_stats));
+
+            py::list result;
+            for (const auto& stats : node_stats) {
+              py::dict entry;
+              entry["node_name"] = stats.node_name;
+              entry["op_type"] = stats.op_type;
+              entry["count"] = stats.count;
+              entry["total_ns"] = stats.total_ns;
+              entry["min_ns"] = stats.min_ns;
+              entry["max_ns"] = stats.max_ns;
+              entry["output_bytes"] = stats.output_bytes;
+              result.append(entry);
+            }
+            return result;
+          },
+          R"pbdoc(Statistics of the nodes that ran since the session was created or the statistics were reset.)pbdoc")
+      .def("reset_node_stats", [](InferenceSession* sess) -> void {
+        OrtPybindThrowIfError(sess->ResetNodeStats());
+      })
+      .def(
+          "get_calibration_ranges", [](const InferenceSession* sess, float percentile) -> py::dict {
+            std::unordered_map<std::string, TensorRange> ranges;
+            OrtPybindThrowIfError(sess->GetCalibrationRanges(percentile, ranges));
+
+            py::dict result;
+            for (const auto& entry : ranges) {
+              result[py::str(entry.first)] = py::make_tuple(entry.second.min, entry.second.max);
+            }
+            return result;
+          },
+          py::arg("percentile") = 100.f,
+          R"pbdoc(The (min, max) ranges of the float tensors collected by the runs since the session was created or
+the calibration was reset.)pbdoc")
+      .def("reset_calibration", [](InferenceSession* sess) -> void {
+        OrtPybindThrowIfError(sess->ResetCalibration());
+      })
+      .def(
+          "get_huge_page_bytes", [](const InferenceSession* sess) -> size_t { return sess->GetHugePageBytes(); },
+          R"pbdoc(Bytes of the memory held by the arenas of the session that is backed by huge pages.)pbdoc")
       .def("get_providers", [](InferenceSession* sess) -> const std::vector<std::string>& {
         return sess->GetRegisteredProviderTypes();
       })
@@ -3,6 +3,7 @@
 # Licensed under the MIT License.
 #--------------------------------------------------------------------------
 
+import concurrent.futures
 import sys
 import os
 
@@ -15,7 +16,9 @@ class InferenceSession:
     """
     def __init__(self, path_or_bytes, sess_options=None):
         """
-        :param path_or_bytes: filename or serialized model in a byte string
+        :param path_or_bytes: filename or serialized model in a byte string, or a list of the filenames of
+            the models of a pipeline composed into a single graph, each input of a model being fed by the
+            output of the same name of the latest earlier model producing one
         :param sess_options: session options
         """
         self._path_or_bytes = path_or_bytes
@@ -34,6 +37,8 @@ class InferenceSession:
             self._sess.load_model(self._path_or_bytes, providers)
         elif isinstance(self._path_or_bytes, bytes):
             self._sess.read_bytes(self._path_or_bytes, providers)
+        elif isinstance(self._path_or_bytes, list):
+            self._sess.load_composed_models(self._path_or_bytes, providers)
         elif isinstance(self._path_or_bytes, tuple):
             # to remove, hidden trick
             self._sess.load_model_no_init(self._path_or_bytes[0], providers)
@@ -105,6 +110,116 @@ class InferenceSession:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run(output_names, input_feed, run_options)
 
+    def run_async(self, output_names, input_feed, run_options=None):
+        """
+        Compute the predictions on the threads of the session without blocking the caller.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: a :class:`concurrent.futures.Future` of the outputs, which asyncio code can await
+            through ``asyncio.wrap_future``
+
+        ::
+
+            outputs = await asyncio.wrap_future(sess.run_async([output_name], {input_name: x}))
+        """
+        num_required_inputs = len(self._inputs_meta)
+        num_inputs = len(input_feed)
+        if num_inputs < num_required_inputs:
+            raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, num_inputs))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+
+        future = concurrent.futures.Future()
+
+        def callback(outputs, error):
+            if error is None:
+                future.set_result(outputs)
+            else:
+                future.set_exception(RuntimeError(error))
+
+        self._sess.run_async(output_names, input_feed, callback, run_options)
+        return future
+
+    def run_iter(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions of a sequence of input feeds, such as the batches of an offline scoring job.
+        The Run of a feed executes on the threads of the session, without the GIL, while the next feed
+        is taken from ``input_feeds`` and converted, and while the caller handles the outputs.
+
+        :param output_names: name of the outputs
+        :param input_feeds: iterable of dictionaries ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: an iterator of the outputs of each input feed, in order
+
+        ::
+
+            for res in sess.run_iter([output_name], ({input_name: x} for x in batches)):
+                ...
+        """
+        num_required_inputs = len(self._inputs_meta)
+
+        def check_feeds():
+            for input_feed in input_feeds:
+                if len(input_feed) < num_required_inputs:
+                    raise ValueError("Model requires {} inputs. Input Feed contains {}".format(num_required_inputs, len(input_feed)))
+                yield input_feed
+
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_iter(output_names, check_feeds(), run_options)
+
+    def prepare_run(self, input_names, output_names=None):
+        """
+        Resolve the names of the inputs and outputs of Runs once, for :meth:`run_prepared`,
+        which then only does the work that depends on the input values.
+
+        :param input_names: name of the inputs, in the order of the values given to :meth:`run_prepared`
+        :param output_names: name of the outputs, all of them if None
+
+        ::
+
+            prepared = sess.prepare_run([input_name], [output_name])
+            sess.run_prepared(prepared, [x])
+        """
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.prepare_run(input_names, output_names)
+
+    def run_prepared(self, prepared_run, input_values, run_options=None):
+        """
+        Compute the predictions for the inputs and outputs of a prepared run.
+
+        :param prepared_run: returned by :meth:`prepare_run`
+        :param input_values: list of the input values, in the order of the input names of the prepared run
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        """
+        return self._sess.run_prepared(prepared_run, input_values, run_options)
+
+    def io_binding(self):
+        """
+        Return a new :class:`onnxruntime.IOBinding` of the inputs and outputs of Runs of this session.
+        """
+        return IOBinding(self)
+
+    def run_with_iobinding(self, iobinding, run_options=None):
+        """
+        Compute the predictions for the inputs and outputs bound to a binding.
+
+        :param iobinding: returned by :meth:`io_binding`
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+
+        ::
+
+            binding = sess.io_binding()
+            binding.bind_input(input_name, x)
+            binding.bind_output(output_name, 'cuda')  # the output stays on the GPU
+            sess.run_with_iobinding(binding)
+            y = binding.copy_outputs_to_cpu()[0]
+        """
+        self._sess.run_with_iobinding(iobinding._iobinding, run_options)
+
     def end_profiling(self):
         """
         End profiling and return results in a file.
@@ -113,3 +228,84 @@ class InferenceSession:
         :meth:`onnxruntime.SessionOptions.enable_profiling`.
         """
         return self._sess.end_profiling()
+
+    def get_node_stats(self):
+        """
+        Return the count, the total, min and max kernel time in nanoseconds and the output bytes of
+        every node that ran, as a list of dictionaries. Requires
+        :meth:`onnxruntime.SessionOptions.enable_node_stats`.
+        """
+        return self._sess.get_node_stats()
+
+    def reset_node_stats(self):
+        """
+        Reset the statistics returned by :meth:`get_node_stats`.
+        """
+        self._sess.reset_node_stats()
+
+    def get_calibration_ranges(self, percentile=100.0):
+        """
+        Return the (min, max) range of every float tensor of the runs, as a dictionary by tensor name
+        to be set as :meth:`onnxruntime.SessionOptions.static_quantization_ranges`. Requires
+        :meth:`onnxruntime.SessionOptions.enable_calibration`.
+
+        :param percentile: With a value below 100, the ranges are clipped to the magnitude covering that
+            percentage of the values.
+        """
+        return self._sess.get_calibration_ranges(percentile)
+
+    def reset_calibration(self):
+        """
+        Reset the ranges returned by :meth:`get_calibration_ranges`.
+        """
+        self._sess.reset_calibration()
+
+
+class IOBinding:
+    """
+    The inputs and outputs of the Runs of a session bound to values, which are reused by every Run.
+    """
+    def __init__(self, session):
+        self._iobinding = C.SessionIOBinding(session._sess)
+
+    def bind_input(self, name, arr_on_cpu):
+        """
+        Bind a copy of the array to an input. It's copied to the device of the consumers of the input
+        once, here, rather than by each Run.
+
+        :param name: input name
+        :param arr_on_cpu: input value as a numpy array
+        """
+        self._iobinding.bind_input(name, arr_on_cpu)
+
+    def bind_output(self, name, device_type='cpu', device_id=0):
+        """
+        Bind an output that the Runs allocate on the device, where it stays until it's copied with
+        :meth:`copy_outputs_to_cpu`.
+
+        :param name: output name
+        :param device_type: 'cpu' or 'cuda'
+        :param device_id: id of the device
+        """
+        self._iobinding.bind_output(name, device_type, device_id)
+
+    def bind_output_array(self, name, arr):
+        """
+        Bind a numpy array with the type and shape of an output, into which the Runs write it in place.
+
+        :param name: output name
+        :param arr: a contiguous, writeable numpy array
+        """
+        self._iobinding.bind_output_array(name, arr)
+
+    def clear_binding_inputs(self):
+        self._iobinding.clear_binding_inputs()
+
+    def clear_binding_outputs(self):
+        self._iobinding.clear_binding_outputs()
+
+    def copy_outputs_to_cpu(self):
+        """
+        Return copies of the outputs of the last Run as numpy arrays, in the order they were bound.
+        """
+        return self._iobinding.copy_outputs_to_cpu()
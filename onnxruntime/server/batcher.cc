@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+// Size of one element, or 0 for types that can't be concatenated with a memcpy.
+static size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static size_t ElementCount(const std::vector<int64_t>& shape) {
+  size_t count = 1;
+  for (auto dim : shape) {
+    count *= static_cast<size_t>(dim);
+  }
+  return count;
+}
+
+static std::vector<Ort::Value> RunSession(Ort::Session& session, const Ort::RunOptions& run_options,
+                                          const std::vector<std::string>& input_names,
+                                          const std::vector<Ort::Value>& input_values,
+                                          const std::vector<std::string>& output_names) {
+  std::vector<const char*> input_ptrs;
+  input_ptrs.reserve(input_names.size());
+  for (const auto& input : input_names) {
+    input_ptrs.push_back(input.data());
+  }
+  std::vector<const char*> output_ptrs;
+  output_ptrs.reserve(output_names.size());
+  for (const auto& output : output_names) {
+    output_ptrs.push_back(output.data());
+  }
+
+  return session.Run(run_options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_ptrs.size(),
+                     output_ptrs.data(), output_ptrs.size());
+}
+
+// The size of the first dimension of the first input, or 1 if it isn't a tensor with one.
+static int64_t RowCount(const std::vector<Ort::Value>& input_values) {
+  if (input_values.empty() || !input_values[0].IsTensor()) {
+    return 1;
+  }
+
+  auto shape = input_values[0].GetTensorTypeAndShapeInfo().GetShape();
+  return shape.empty() || shape[0] <= 0 ? 1 : shape[0];
+}
+
+Batcher::Batcher(Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger,
+                 ModelMetrics* metrics)
+    : session_(session), options_(options), logger_(std::move(logger)), metrics_(metrics) {
+  if (options_.max_batch_size > 1) {
+    worker_ = std::thread(&Batcher::WorkerLoop, this);
+  }
+}
+
+Batcher::~Batcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+std::vector<Ort::Value> Batcher::Run(const Ort::RunOptions& run_options,
+                                     const std::vector<std::string>& input_names,
+                                     const std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& output_names,
+                                     RequestTimings* timings) {
+  auto request = std::make_unique<PendingRequest>();
+  request->run_options = &run_options;
+  request->input_names = &input_names;
+  request->input_values = &input_values;
+  request->output_names = &output_names;
+  request->rows = -1;
+  request->timings = timings;
+
+  // every input must be a fixed size tensor with the same, non-empty, first dimension
+  bool batchable = options_.max_batch_size > 1 && !input_values.empty();
+  for (size_t i = 0; batchable && i < input_values.size(); ++i) {
+    if (!input_values[i].IsTensor()) {
+      batchable = false;
+      break;
+    }
+
+    auto type_and_shape = input_values[i].GetTensorTypeAndShapeInfo();
+    auto shape = type_and_shape.GetShape();
+    auto type = type_and_shape.GetElementType();
+    if (shape.empty() || shape[0] <= 0 || ElementSize(type) == 0 ||
+        (request->rows != -1 && request->rows != shape[0])) {
+      batchable = false;
+      break;
+    }
+
+    request->rows = shape[0];
+    request->input_shapes.push_back(std::move(shape));
+    request->input_types.push_back(type);
+  }
+
+  if (!batchable || request->rows > options_.max_batch_size) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.num_requests;
+      ++stats_.num_batches;
+    }
+    request->rows = RowCount(input_values);
+    return RunSingle(*request);
+  }
+
+  auto result = request->result.get_future();
+  request->enqueue_time = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+
+  return result.get();
+}
+
+BatchingStats Batcher::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+bool Batcher::IsCompatible(const PendingRequest& lhs, const PendingRequest& rhs) const {
+  if (*lhs.input_names != *rhs.input_names || *lhs.output_names != *rhs.output_names ||
+      lhs.input_types != rhs.input_types) {
+    return false;
+  }
+
+  for (size_t i = 0; i < lhs.input_shapes.size(); ++i) {
+    const auto& lhs_shape = lhs.input_shapes[i];
+    const auto& rhs_shape = rhs.input_shapes[i];
+    if (lhs_shape.size() != rhs_shape.size() ||
+        !std::equal(lhs_shape.begin() + 1, lhs_shape.end(), rhs_shape.begin() + 1)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void Batcher::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // wait for enough compatible rows to fill a batch, or for the oldest request to time out
+    const auto deadline = queue_.front()->enqueue_time + options_.batch_timeout;
+    while (!shutdown_) {
+      int64_t rows = 0;
+      for (const auto& request : queue_) {
+        if (IsCompatible(*queue_.front(), *request)) {
+          rows += request->rows;
+        }
+      }
+
+      if (rows >= options_.max_batch_size || cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+        break;
+      }
+    }
+
+    std::vector<std::unique_ptr<PendingRequest>> batch;
+    int64_t batch_rows = 0;
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if ((batch.empty() || IsCompatible(*batch.front(), **it)) &&
+          batch_rows + (*it)->rows <= options_.max_batch_size) {
+        batch_rows += (*it)->rows;
+        batch.push_back(std::move(*it));
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    uint64_t max_queue_time_us = 0;
+    for (const auto& request : batch) {
+      auto queue_time_us = static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::microseconds>(now - request->enqueue_time).count());
+      stats_.total_queue_time_us += queue_time_us;
+      max_queue_time_us = std::max(max_queue_time_us, queue_time_us);
+      if (request->timings != nullptr) {
+        request->timings->Add(RequestPhase::Queue, now - request->enqueue_time);
+      }
+    }
+    stats_.max_queue_time_us = std::max(stats_.max_queue_time_us, max_queue_time_us);
+    stats_.num_requests += batch.size();
+    ++stats_.num_batches;
+
+    lock.unlock();
+    logger_->debug("Running batch of {} requests with {} rows. Max queue time: {}us",
+                   batch.size(), batch_rows, max_queue_time_us);
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+std::vector<Ort::Value> Batcher::RunSingle(const PendingRequest& request) {
+  if (metrics_ != nullptr) {
+    metrics_->ObserveBatchSize(request.rows);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  auto outputs = RunSession(session_, *request.run_options, *request.input_names, *request.input_values,
+                            *request.output_names);
+  if (request.timings != nullptr) {
+    request.timings->Add(RequestPhase::Inference, std::chrono::steady_clock::now() - start);
+  }
+
+  return outputs;
+}
+
+void Batcher::RunBatch(std::vector<std::unique_ptr<PendingRequest>>& batch) {
+  auto run_each = [this, &batch]() {
+    for (auto& request : batch) {
+      try {
+        request->result.set_value(RunSingle(*request));
+      } catch (...) {
+        request->result.set_exception(std::current_exception());
+      }
+    }
+  };
+
+  if (batch.size() == 1) {
+    run_each();
+    return;
+  }
+
+  // the requests before num_answered have their results, the others get the exception being handled
+  size_t num_answered = 0;
+  auto fail_unanswered = [&batch, &num_answered]() {
+    for (; num_answered < batch.size(); ++num_answered) {
+      batch[num_answered]->result.set_exception(std::current_exception());
+    }
+  };
+
+  const auto& first = *batch.front();
+  int64_t total_rows = 0;
+  for (const auto& request : batch) {
+    total_rows += request->rows;
+  }
+
+  try {
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    // concatenate the inputs along the first dimension
+    std::vector<Ort::Value> inputs;
+    inputs.reserve(first.input_shapes.size());
+    for (size_t i = 0; i < first.input_shapes.size(); ++i) {
+      auto shape = first.input_shapes[i];
+      shape[0] = total_rows;
+      auto input = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), first.input_types[i]);
+
+      auto* dst = input.GetTensorMutableData<uint8_t>();
+      const size_t element_size = ElementSize(first.input_types[i]);
+      for (const auto& request : batch) {
+        const size_t bytes = ElementCount(request->input_shapes[i]) * element_size;
+        auto& src = const_cast<Ort::Value&>((*request->input_values)[i]);
+        memcpy(dst, src.GetTensorMutableData<uint8_t>(), bytes);
+        dst += bytes;
+      }
+
+      inputs.push_back(std::move(input));
+    }
+
+    if (metrics_ != nullptr) {
+      metrics_->ObserveBatchSize(total_rows);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto outputs = RunSession(session_, *first.run_options, *first.input_names, inputs, *first.output_names);
+    const auto inference_time = std::chrono::steady_clock::now() - start;
+    for (auto& request : batch) {
+      if (request->timings != nullptr) {
+        request->timings->Add(RequestPhase::Inference, inference_time);
+      }
+    }
+
+    // split the outputs back along the first dimension
+    std::vector<std::vector<Ort::Value>> results(batch.size());
+    for (auto& output : outputs) {
+      if (!output.IsTensor()) {
+        run_each();
+        return;
+      }
+
+      auto type_and_shape = output.GetTensorTypeAndShapeInfo();
+      auto shape = type_and_shape.GetShape();
+      const auto type = type_and_shape.GetElementType();
+      const size_t element_size = ElementSize(type);
+      if (shape.empty() || shape[0] != total_rows || element_size == 0) {
+        // the model doesn't carry the batch dimension through to this output
+        run_each();
+        return;
+      }
+
+      const size_t row_bytes = ElementCount(shape) / static_cast<size_t>(total_rows) * element_size;
+      const auto* src = output.GetTensorMutableData<uint8_t>();
+      for (size_t r = 0; r < batch.size(); ++r) {
+        shape[0] = batch[r]->rows;
+        auto result = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), type);
+        const size_t bytes = row_bytes * static_cast<size_t>(batch[r]->rows);
+        memcpy(result.GetTensorMutableData<uint8_t>(), src, bytes);
+        src += bytes;
+        results[r].push_back(std::move(result));
+      }
+    }
+
+    for (; num_answered < batch.size(); ++num_answered) {
+      batch[num_answered]->result.set_value(std::move(results[num_answered]));
+    }
+  } catch (const Ort::Exception& e) {
+    // e.g. the model has a fixed first dimension. Run the requests separately so each gets its own result.
+    logger_->debug("Batched run failed, running {} requests separately. Error: {}", batch.size(), e.what());
+    run_each();
+  } catch (const std::exception& e) {
+    // e.g. an allocation failed. The callers waiting on the requests get the error instead of a broken promise.
+    logger_->error("Batched run of {} requests failed. Error: {}", batch.size(), e.what());
+    fail_unanswered();
+  } catch (...) {
+    logger_->error("Batched run of {} requests failed with an unknown error", batch.size());
+    fail_unanswered();
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
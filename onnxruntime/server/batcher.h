@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "core/session/onnxruntime_cxx_api.h"
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Maximum number of rows (size of the first dimension summed over requests) run together.
+  // A value of 1 disables batching.
+  int max_batch_size = 1;
+
+  // Maximum time the first request of a batch waits for more requests to arrive.
+  std::chrono::microseconds batch_timeout{1000};
+};
+
+struct BatchingStats {
+  uint64_t num_requests = 0;
+  uint64_t num_batches = 0;
+  uint64_t total_queue_time_us = 0;
+  uint64_t max_queue_time_us = 0;
+};
+
+// Combines concurrent requests for one session into a single Session::Run.
+// Requests are compatible when they use the same inputs and outputs and their input tensors match in type
+// and in every dimension but the first one. They are concatenated along the first dimension and the outputs
+// are split back along the first dimension. Requests that can't be batched, or whose batched outputs don't
+// carry the batch dimension, are run on their own.
+class Batcher {
+ public:
+  // metrics, if not null, must outlive the batcher and gets the size of every run.
+  Batcher(Ort::Session& session, const BatchingOptions& options, std::shared_ptr<spdlog::logger> logger,
+          ModelMetrics* metrics = nullptr);
+  ~Batcher();
+  Batcher(const Batcher&) = delete;
+  Batcher& operator=(const Batcher&) = delete;
+
+  // Blocks until the request has been run. Throws Ort::Exception on failure, like Ort::Session::Run.
+  // The time spent waiting for a batch and running it is added to timings, if it's not null.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& run_options,
+                              const std::vector<std::string>& input_names,
+                              const std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names,
+                              RequestTimings* timings = nullptr);
+
+  BatchingStats GetStats() const;
+
+ private:
+  struct PendingRequest {
+    const Ort::RunOptions* run_options;
+    const std::vector<std::string>* input_names;
+    const std::vector<Ort::Value>* input_values;
+    const std::vector<std::string>* output_names;
+    std::vector<std::vector<int64_t>> input_shapes;
+    std::vector<ONNXTensorElementDataType> input_types;
+    int64_t rows;
+    std::chrono::steady_clock::time_point enqueue_time;
+    RequestTimings* timings;
+    std::promise<std::vector<Ort::Value>> result;
+  };
+
+  bool IsCompatible(const PendingRequest& lhs, const PendingRequest& rhs) const;
+  void WorkerLoop();
+  void RunBatch(std::vector<std::unique_ptr<PendingRequest>>& batch);
+  std::vector<Ort::Value> RunSingle(const PendingRequest& request);
+
+  Ort::Session& session_;
+  const BatchingOptions options_;
+  std::shared_ptr<spdlog::logger> logger_;
+  ModelMetrics* metrics_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<PendingRequest>> queue_;
+  bool shutdown_ = false;
+  BatchingStats stats_;
+  std::thread worker_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -1,13 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cctype>
 #include <memory>
+#include <thread>
+#include <boost/filesystem.hpp>
 #include "environment.h"
 #include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
 namespace server {
 
+namespace fs = boost::filesystem;
+
 static spdlog::level::level_enum Convert(OrtLoggingLevel in) {
   switch (in) {
     case OrtLoggingLevel::ORT_LOGGING_LEVEL_VERBOSE:
@@ -42,46 +48,434 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
   spdlog::initialize_logger(default_logger_);
 }
 
+int ModelOptions::NumThreads() const {
+  const int num_cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  return num_replicas * ((intra_op_num_threads > 0 ? intra_op_num_threads : num_cores) + inter_op_num_threads);
+}
+
+std::vector<Ort::Value> ServerEnvironment::SessionHolder::Run(const Ort::RunOptions& run_options,
+                                                              const std::vector<std::string>& input_names,
+                                                              const std::vector<Ort::Value>& input_values,
+                                                              const std::vector<std::string>& output_names,
+                                                              RequestTimings* timings) const {
+  const size_t num_replicas = replicas.size();
+  const size_t first = next_replica_++ % num_replicas;
+  Replica* replica = replicas[first].get();
+  for (size_t i = 1; i < num_replicas; i++) {
+    Replica* candidate = replicas[(first + i) % num_replicas].get();
+    if (candidate->in_flight.load() < replica->in_flight.load()) {
+      replica = candidate;
+    }
+  }
+
+  struct InFlight {
+    std::atomic<int>& count;
+    explicit InFlight(std::atomic<int>& count) : count(count) { ++count; }
+    ~InFlight() { --count; }
+  } in_flight{replica->in_flight};
+  return replica->batcher->Run(run_options, input_names, input_values, output_names, timings);
+}
+
+size_t ServerEnvironment::SessionHolder::MemoryUsage() const {
+  size_t num_bytes = 0;
+  for (const auto& replica : replicas) {
+    size_t bytes_in_use = 0, max_bytes_in_use = 0;
+    replica->session.GetArenaUsage(bytes_in_use, max_bytes_in_use);
+    num_bytes += model_bytes + max_bytes_in_use;
+  }
+  return num_bytes;
+}
+
+static int64_t SteadyClockNow() {
+  return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+// Snapshots older than their model are stale, the model having been replaced since.
+static bool IsSnapshotCurrent(const std::string& snapshot_path, const std::string& model_path) {
+  boost::system::error_code ec;
+  const auto snapshot_time = fs::last_write_time(snapshot_path, ec);
+  if (ec) {
+    return false;
+  }
+  const auto model_time = fs::last_write_time(model_path, ec);
+  return !ec && snapshot_time >= model_time;
+}
+
 void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
-  auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), Ort::SessionOptions()));
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    if (sessions_.count(std::make_pair(model_name, model_version)) != 0) {
+      throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+    }
+  }
+
+  ServeModel(model_name, model_version, LoadModel(model_path, model_name, model_version));
+}
+
+std::shared_ptr<ServerEnvironment::SessionHolder> ServerEnvironment::LoadModel(const std::string& model_path,
+                                                                               const std::string& model_name,
+                                                                               const std::string& model_version) {
+  ModelOptions model_options;
+  std::string snapshot_path;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = model_options_.find(model_name);
+    model_options = it != model_options_.end() ? it->second : default_model_options_;
+    if (!snapshot_directory_.empty()) {
+      snapshot_path = (fs::path(snapshot_directory_) / (model_name + "_" + model_version + ".onnx")).string();
+    }
+  }
+
+  Ort::SessionOptions options = options_.Clone();
+  options.SetIntraOpNumThreads(model_options.intra_op_num_threads);
+  if (model_options.inter_op_num_threads > 0) {
+    options.DisableSequentialExecution();
+    options.SetInterOpNumThreads(model_options.inter_op_num_threads);
+  }
 
-  if (!result.second) {
-    throw Ort::Exception("Model of that name already loaded.", ORT_INVALID_ARGUMENT);
+  const int num_replicas = std::max(1, model_options.num_replicas);
+  std::shared_ptr<SessionHolder> model;
+  if (!snapshot_path.empty() && IsSnapshotCurrent(snapshot_path, model_path)) {
+    try {
+      model = std::make_shared<SessionHolder>(runtime_environment_, snapshot_path, options, num_replicas);
+    } catch (const Ort::Exception& e) {
+      default_logger_->warn("Failed to load the snapshot {} of version {} of {}, loading {}: {}", snapshot_path,
+                            model_version, model_name, model_path, e.what());
+    }
   }
 
-  auto iterator = result.first;
-  auto output_count = (iterator->second).session.GetOutputCount();
+  if (model == nullptr && !snapshot_path.empty()) {
+    // the first replica saves the snapshot the others load
+    Ort::SessionOptions snapshot_options = options.Clone();
+    snapshot_options.SetOptimizedModelFilePath(snapshot_path.c_str());
+    model = std::make_shared<SessionHolder>(runtime_environment_, model_path, snapshot_options, 1);
+    for (int i = 1; i < num_replicas; i++) {
+      model->replicas.push_back(
+          std::make_unique<Replica>(Ort::Session(runtime_environment_, snapshot_path.c_str(), options)));
+    }
+  } else if (model == nullptr) {
+    model = std::make_shared<SessionHolder>(runtime_environment_, model_path, options, num_replicas);
+  }
+  model->num_threads = model_options.NumThreads();
+  boost::system::error_code ec;
+  const auto model_bytes = fs::file_size(model_path, ec);
+  model->model_bytes = ec ? 0 : static_cast<size_t>(model_bytes);
+  model->last_used = SteadyClockNow();
 
+  const auto& session = model->GetSession();
+  auto output_count = session.GetOutputCount();
   Ort::AllocatorWithDefaultOptions allocator;
   for (size_t i = 0; i < output_count; i++) {
-    auto name = (iterator->second).session.GetOutputName(i, allocator);
-    (iterator->second).output_names.push_back(name);
+    auto name = session.GetOutputName(i, allocator);
+    model->output_names.push_back(name);
     allocator.Free(name);
   }
+
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    CheckThreadBudget(model_name, model_version, *model);
+    auto& metrics = metrics_[std::make_pair(model_name, model_version)];
+    if (metrics == nullptr) {
+      metrics = std::make_shared<ModelMetrics>();
+    }
+    model->metrics = metrics;
+  }
+
+  for (auto& replica : model->replicas) {
+    replica->batcher = std::make_unique<Batcher>(replica->session, batching_options_, default_logger_,
+                                                 model->metrics.get());
+  }
+  return model;
+}
+
+void ServerEnvironment::CheckThreadBudget(const std::string& model_name, const std::string& model_version,
+                                          const SessionHolder& model) const {
+  if (thread_budget_ <= 0) {
+    return;
+  }
+
+  // the model replaces the one served under its name and version, if any
+  int num_threads = model.num_threads;
+  for (const auto& session : sessions_) {
+    if (session.first != std::make_pair(model_name, model_version)) {
+      num_threads += session.second->num_threads;
+    }
+  }
+
+  if (num_threads > thread_budget_) {
+    throw Ort::Exception("Serving version " + model_version + " of " + model_name + " takes the threads of the sessions to " +
+                             std::to_string(num_threads) + ", beyond the budget of " + std::to_string(thread_budget_) + ".",
+                         ORT_INVALID_ARGUMENT);
+  }
+}
+
+void ServerEnvironment::RegisterModel(const std::string& model_path, const std::string& model_name,
+                                      const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  registered_[std::make_pair(model_name, model_version)] = model_path;
+}
+
+std::vector<std::shared_ptr<ServerEnvironment::SessionHolder>> ServerEnvironment::EvictIdleModels(size_t num_bytes,
+                                                                                                    int num_threads) {
+  size_t bytes_in_use = 0;
+  int threads_in_use = 0;
+  for (const auto& session : sessions_) {
+    bytes_in_use += session.second->MemoryUsage();
+    threads_in_use += session.second->num_threads;
+  }
+
+  std::vector<std::shared_ptr<SessionHolder>> evicted;
+  while ((memory_budget_ > 0 && bytes_in_use + num_bytes > memory_budget_) ||
+         (thread_budget_ > 0 && threads_in_use + num_threads > thread_budget_)) {
+    // idle when no request holds on to it
+    auto lru = sessions_.end();
+    for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+      if (registered_.count(it->first) != 0 && it->second.use_count() == 1 &&
+          (lru == sessions_.end() || it->second->last_used < lru->second->last_used)) {
+        lru = it;
+      }
+    }
+    if (lru == sessions_.end()) {
+      break;
+    }
+
+    default_logger_->info("Evicting version {} of {}", lru->first.second, lru->first.first);
+    bytes_in_use -= std::min(bytes_in_use, lru->second->MemoryUsage());
+    threads_in_use -= lru->second->num_threads;
+    evicted.push_back(std::move(lru->second));
+    sessions_.erase(lru);
+  }
+
+  return evicted;
 }
 
-const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+std::shared_ptr<ServerEnvironment::SessionHolder> ServerEnvironment::LoadRegisteredModel(const ModelKey& key,
+                                                                                         const std::string& model_path) {
+  ModelOptions model_options;
+  boost::system::error_code ec;
+  const auto model_bytes = fs::file_size(model_path, ec);
+  std::vector<std::shared_ptr<SessionHolder>> evicted;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = model_options_.find(key.first);
+    model_options = it != model_options_.end() ? it->second : default_model_options_;
+    const int num_replicas = std::max(1, model_options.num_replicas);
+    evicted = EvictIdleModels(ec ? 0 : static_cast<size_t>(model_bytes) * num_replicas, model_options.NumThreads());
   }
+  // released before the model is loaded, unless requests just got hold of them
+  evicted.clear();
 
-  return it->second.output_names;
+  const auto start = std::chrono::steady_clock::now();
+  auto model = LoadModel(model_path, key.first, key.second);
+  ServeModel(key.first, key.second, model);
+  default_logger_->info("Loaded version {} of {} in {}ms", key.second, key.first,
+                        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+  return model;
+}
+
+void ServerEnvironment::ServeModel(const std::string& model_name, const std::string& model_version,
+                                   std::shared_ptr<SessionHolder> model) {
+  std::shared_ptr<SessionHolder> replaced;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    // models loaded concurrently are only counted together once served
+    CheckThreadBudget(model_name, model_version, *model);
+    auto& served = sessions_[std::make_pair(model_name, model_version)];
+    replaced = std::move(served);
+    served = std::move(model);
+  }
+  // released outside of the lock, or by the last request using it
+}
+
+std::vector<std::string> ServerEnvironment::GetModelVersions(const std::string& model_name) const {
+  std::vector<std::string> versions;
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  for (const auto& session : sessions_) {
+    if (session.first.first == model_name) {
+      versions.push_back(session.first.second);
+    }
+  }
+
+  return versions;
+}
+
+void ServerEnvironment::SetBatchingOptions(const BatchingOptions& options) {
+  batching_options_ = options;
+}
+
+void ServerEnvironment::SetWarmupRuns(unsigned warmup_runs) {
+  options_.SetWarmup(warmup_runs);
+}
+
+void ServerEnvironment::SetDefaultModelOptions(const ModelOptions& options) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  default_model_options_ = options;
+}
+
+void ServerEnvironment::SetModelOptions(const std::string& model_name, const ModelOptions& options) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  model_options_[model_name] = options;
+}
+
+void ServerEnvironment::SetThreadBudget(int num_threads) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  thread_budget_ = num_threads;
+}
+
+void ServerEnvironment::SetMemoryBudget(size_t num_bytes) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  memory_budget_ = num_bytes;
+}
+
+void ServerEnvironment::SetSnapshotDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  snapshot_directory_ = directory;
+}
+
+// Orders numeric versions by value, and the others after them by name.
+static bool VersionLess(const std::string& lhs, const std::string& rhs) {
+  auto is_number = [](const std::string& version) {
+    return !version.empty() && std::all_of(version.begin(), version.end(), ::isdigit);
+  };
+  if (is_number(lhs) && is_number(rhs)) {
+    auto lhs_start = lhs.find_first_not_of('0'), rhs_start = rhs.find_first_not_of('0');
+    auto lhs_digits = lhs_start == std::string::npos ? std::string() : lhs.substr(lhs_start);
+    auto rhs_digits = rhs_start == std::string::npos ? std::string() : rhs.substr(rhs_start);
+    return lhs_digits.size() != rhs_digits.size() ? lhs_digits.size() < rhs_digits.size() : lhs_digits < rhs_digits;
+  }
+  if (is_number(lhs) != is_number(rhs)) {
+    return is_number(lhs);
+  }
+  return lhs < rhs;
+}
+
+std::string ServerEnvironment::ResolveVersion(const std::string& model_name, const std::string& model_version) const {
+  if (!model_version.empty()) {
+    return model_version;
+  }
+
+  const std::string* latest = nullptr;
+  auto consider = [&](const ModelKey& key) {
+    if (key.first == model_name && (latest == nullptr || VersionLess(*latest, key.second))) {
+      latest = &key.second;
+    }
+  };
+  for (const auto& session : sessions_) {
+    consider(session.first);
+  }
+  for (const auto& registered : registered_) {
+    consider(registered.first);
+  }
+
+  return latest == nullptr ? std::string() : *latest;
+}
+
+std::shared_ptr<ServerEnvironment::SessionHolder> ServerEnvironment::GetModel(const std::string& model_name,
+                                                                              const std::string& model_version) {
+  std::shared_future<std::shared_ptr<SessionHolder>> loading;
+  std::promise<std::shared_ptr<SessionHolder>> load;
+  bool loads = false;
+  ModelKey key;
+  std::string model_path;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    key = std::make_pair(model_name, ResolveVersion(model_name, model_version));
+    auto it = sessions_.find(key);
+    if (it != sessions_.end()) {
+      it->second->last_used = SteadyClockNow();
+      return it->second;
+    }
+
+    auto registered = registered_.find(key);
+    if (registered == registered_.end()) {
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
+
+    auto pending = loading_.find(key);
+    if (pending != loading_.end()) {
+      loading = pending->second;
+    } else {
+      loading = load.get_future().share();
+      loading_[key] = loading;
+      model_path = registered->second;
+      loads = true;
+    }
+  }
+
+  if (loads) {
+    try {
+      auto model = LoadRegisteredModel(key, model_path);
+      {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        loading_.erase(key);
+      }
+      load.set_value(std::move(model));
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        loading_.erase(key);
+      }
+      load.set_exception(std::current_exception());
+    }
+  }
+
+  // rethrows the error of the load
+  return loading.get();
+}
+
+const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) {
+  return GetModel(model_name, model_version)->output_names;
 }
 
 OrtLoggingLevel ServerEnvironment::GetLogSeverity() const {
   return severity_;
 }
 
-const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) const {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+const Ort::Session& ServerEnvironment::GetSession(const std::string& model_name, const std::string& model_version) {
+  return GetModel(model_name, model_version)->GetSession();
+}
+
+ModelMetrics* ServerEnvironment::GetModelMetrics(const std::string& model_name, const std::string& model_version) {
+  std::lock_guard<std::mutex> lock(sessions_mutex_);
+  auto key = std::make_pair(model_name, ResolveVersion(model_name, model_version));
+  auto it = sessions_.find(key);
+  if (it != sessions_.end()) {
+    return it->second->metrics.get();
+  }
+  if (registered_.count(key) == 0) {
+    return nullptr;
+  }
+
+  // the metrics the model gets once loaded
+  auto& metrics = metrics_[key];
+  if (metrics == nullptr) {
+    metrics = std::make_shared<ModelMetrics>();
+  }
+  return metrics.get();
+}
+
+void ServerEnvironment::WriteMetrics(std::ostream& out) const {
+  std::vector<std::pair<ModelKey, std::shared_ptr<SessionHolder>>> sessions;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    sessions.assign(sessions_.begin(), sessions_.end());
+  }
+
+  std::vector<std::pair<std::string, const ModelMetrics*>> models;
+  for (const auto& session : sessions) {
+    size_t bytes_in_use = 0, max_bytes_in_use = 0;
+    for (const auto& replica : session.second->replicas) {
+      size_t replica_bytes_in_use = 0, replica_max_bytes_in_use = 0;
+      replica->session.GetArenaUsage(replica_bytes_in_use, replica_max_bytes_in_use);
+      bytes_in_use += replica_bytes_in_use;
+      max_bytes_in_use += replica_max_bytes_in_use;
+    }
+    session.second->metrics->SetArenaUsage(bytes_in_use, max_bytes_in_use);
+    models.emplace_back("model=\"" + session.first.first + "\",version=\"" + session.first.second + "\"",
+                        session.second->metrics.get());
   }
 
-  return it->second.session;
+  ModelMetrics::Write(out, models);
 }
 
 std::shared_ptr<spdlog::logger> ServerEnvironment::GetLogger(const std::string& request_id) const {
@@ -95,13 +489,22 @@ std::shared_ptr<spdlog::logger> ServerEnvironment::GetAppLogger() const {
 }
 
 void ServerEnvironment::UnloadModel(const std::string& model_name, const std::string& model_version) {
-  auto identifier = std::make_pair(model_name, model_version);
-  auto it = sessions_.find(identifier);
-  if (it == sessions_.end()) {
-    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
-  }
+  std::shared_ptr<SessionHolder> unloaded;
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    const auto key = std::make_pair(model_name, model_version);
+    const bool registered = registered_.erase(key) != 0;
+    auto it = sessions_.find(key);
+    if (it == sessions_.end()) {
+      if (registered) {
+        return;
+      }
+      throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+    }
 
-  sessions_.erase(it);
+    unloaded = std::move(it->second);
+    sessions_.erase(it);
+  }
 }
 
 }  // namespace server
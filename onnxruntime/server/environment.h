@@ -3,10 +3,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <vector>
 
 #include "core/session/onnxruntime_cxx_api.h"
+#include "batcher.h"
+#include "metrics.h"
 #include <spdlog/spdlog.h>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
@@ -14,22 +20,129 @@
 namespace onnxruntime {
 namespace server {
 
+// The sessions of a model and their threads.
+struct ModelOptions {
+  // Number of sessions of the model, each with its own thread pools and batcher. Requests go to the least loaded one.
+  int num_replicas = 1;
+  // Size of the intra op thread pool of each session, 0 for the default of one thread per core.
+  int intra_op_num_threads = 0;
+  // Size of the inter op thread pool of each session, which runs the independent nodes in parallel.
+  // 0 runs the nodes sequentially.
+  int inter_op_num_threads = 0;
+
+  // The threads of the replicas, counting an intra op thread pool of the default size as one thread per core.
+  int NumThreads() const;
+};
+
 class ServerEnvironment {
  public:
+  // A session of a loaded model.
+  struct Replica {
+    Ort::Session session;
+    std::unique_ptr<Batcher> batcher;
+    // the requests running on the replica
+    std::atomic<int> in_flight{0};
+    explicit Replica(Ort::Session session) : session(std::move(session)) {}
+  };
+
+  // A loaded model. Requests hold on to it while they run, so a model that's replaced or unloaded is only
+  // released once the requests using it are done.
+  struct SessionHolder {
+    std::vector<std::string> output_names;
+    // shared by the successive loads of a model version, and declared before the batchers, which use it
+    std::shared_ptr<ModelMetrics> metrics;
+    // at least one
+    std::vector<std::unique_ptr<Replica>> replicas;
+    // counted against the thread budget while the model is served
+    int num_threads = 0;
+    // size of the model file, an estimate of the memory of the initializers of each replica
+    size_t model_bytes = 0;
+    // steady clock time of the latest request, which orders the eviction of the idle models
+    mutable std::atomic<int64_t> last_used{0};
+    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options, int num_replicas) {
+      for (int i = 0; i < num_replicas; i++) {
+        replicas.push_back(std::make_unique<Replica>(Ort::Session(env, path.c_str(), options)));
+      }
+    };
+    ~SessionHolder() = default;
+    SessionHolder(const SessionHolder&) = delete;
+    SessionHolder(const SessionHolder&&) = delete;
+    SessionHolder& operator=(const SessionHolder&) = delete;
+
+    const Ort::Session& GetSession() const { return replicas.front()->session; }
+
+    // The memory of the initializers of the replicas and of their arenas, at their peak.
+    size_t MemoryUsage() const;
+
+    // Runs the request on the batcher of the replica with the fewest requests running, the ties being broken
+    // round robin. Throws Ort::Exception on failure, see Batcher::Run.
+    std::vector<Ort::Value> Run(const Ort::RunOptions& run_options,
+                                const std::vector<std::string>& input_names,
+                                const std::vector<Ort::Value>& input_values,
+                                const std::vector<std::string>& output_names,
+                                RequestTimings* timings = nullptr) const;
+
+   private:
+    mutable std::atomic<size_t> next_replica_{0};
+  };
+
   explicit ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_init_list sink);
   ~ServerEnvironment() = default;
   ServerEnvironment(const ServerEnvironment&) = delete;
 
   OrtLoggingLevel GetLogSeverity() const;
 
-  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version) const;
+  // An empty model_version is the highest version of model_name being served or registered.
+  // A registered model that isn't loaded is loaded first, the concurrent requests for it waiting for the same load.
+  // Throws Ort::Exception with ORT_NO_MODEL if there's no such model, or the error of the load.
+  std::shared_ptr<SessionHolder> GetModel(const std::string& model_name, const std::string& model_version);
+  // The references returned by these are valid until the model is replaced or unloaded.
+  // The first replica of the model.
+  const Ort::Session& GetSession(const std::string& model_name, const std::string& model_version);
+  // nullptr if the model is neither loaded nor registered, so requests for unknown models aren't counted
+  ModelMetrics* GetModelMetrics(const std::string& model_name, const std::string& model_version);
+  // Writes the metrics of every model in the Prometheus text format.
+  void WriteMetrics(std::ostream& out) const;
+  // Applies to the models initialized afterwards.
+  void SetBatchingOptions(const BatchingOptions& options);
+  // Number of Runs with generated inputs at the end of the initialization of the sessions, see
+  // OrtApi::SetSessionWarmup. Applies to the models initialized afterwards.
+  void SetWarmupRuns(unsigned warmup_runs);
+  // The sessions of the models without options of their own. Applies to the models initialized afterwards.
+  void SetDefaultModelOptions(const ModelOptions& options);
+  // The sessions of the versions of model_name. Applies to the versions initialized afterwards.
+  void SetModelOptions(const std::string& model_name, const ModelOptions& options);
+  // Maximum number of threads of the sessions of the models served together, see ModelOptions::NumThreads.
+  // Loading a model beyond it throws Ort::Exception with ORT_INVALID_ARGUMENT. 0 for no limit.
+  void SetThreadBudget(int num_threads);
+  // Maximum number of bytes of the registered models loaded together, see SessionHolder::MemoryUsage. The idle ones,
+  // least recently used first, are evicted to make room for the one being loaded. 0 for no limit.
+  void SetMemoryBudget(size_t num_bytes);
+  // Directory the models are saved to once optimized, see OrtApi::SetOptimizedModelFilePath. They're loaded from
+  // there afterwards, which skips the graph optimizations and the partitioning. Empty to always load the model.
+  void SetSnapshotDirectory(const std::string& directory);
   void InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
-  const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version) const;
+  // Serves a model without loading it until it's requested, and evicts it when it's idle and room is needed.
+  void RegisterModel(const std::string& model_path, const std::string& model_name, const std::string& model_version);
+  // Loads a model without serving it yet, e.g. to warm it up first.
+  std::shared_ptr<SessionHolder> LoadModel(const std::string& model_path, const std::string& model_name,
+                                           const std::string& model_version);
+  // Serves model as model_version of model_name, replacing the model served under that name and version, if any.
+  // The requests already running keep using the model they started with.
+  void ServeModel(const std::string& model_name, const std::string& model_version,
+                  std::shared_ptr<SessionHolder> model);
+  // The versions of model_name being served.
+  std::vector<std::string> GetModelVersions(const std::string& model_name) const;
+  const std::vector<std::string>& GetModelOutputNames(const std::string& model_name, const std::string& model_version);
   std::shared_ptr<spdlog::logger> GetLogger(const std::string& request_id) const;
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
+  // Stops serving the model, and forgets it if it's registered.
   void UnloadModel(const std::string& model_name, const std::string& model_version);
 
  private:
+  using ModelKey = std::pair<std::string, std::string>;
+  using SessionMap = std::unordered_map<ModelKey, std::shared_ptr<SessionHolder>, boost::hash<ModelKey>>;
+
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
   const std::vector<spdlog::sink_ptr> sink_;
@@ -37,20 +150,35 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  BatchingOptions batching_options_;
+  ModelOptions default_model_options_;
+  std::unordered_map<std::string, ModelOptions> model_options_;
+  int thread_budget_ = 0;
+  size_t memory_budget_ = 0;
+  std::string snapshot_directory_;
 
-  struct SessionHolder {
-    Ort::Session session;
-    std::vector<std::string> output_names;
-    explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
-      session = Ort::Session(env, path.c_str(), options);
-    };
-    ~SessionHolder() = default;
-    SessionHolder(const SessionHolder&) = delete;
-    SessionHolder(const SessionHolder&&) = delete;
-    SessionHolder& operator=(const SessionHolder&) = delete;
-  };
+  // guards sessions_, metrics_, registered_ and loading_, which change while requests are served when models are
+  // reloaded, loaded or evicted
+  mutable std::mutex sessions_mutex_;
+  SessionMap sessions_;
+  // the model path of each registered model
+  std::unordered_map<ModelKey, std::string, boost::hash<ModelKey>> registered_;
+  // the registered models being loaded
+  std::unordered_map<ModelKey, std::shared_future<std::shared_ptr<SessionHolder>>, boost::hash<ModelKey>> loading_;
+  // kept across reloads and unloads so the counters of a model version don't restart
+  std::unordered_map<ModelKey, std::shared_ptr<ModelMetrics>, boost::hash<ModelKey>> metrics_;
 
-  std::unordered_map<std::pair<std::string, std::string>, ServerEnvironment::SessionHolder, boost::hash<std::pair<std::string, std::string>>> sessions_;
+  // model_version, or the highest version of model_name served or registered if it's empty.
+  // sessions_mutex_ must be held.
+  std::string ResolveVersion(const std::string& model_name, const std::string& model_version) const;
+  // Loads the registered model and serves it, once there's room for it.
+  std::shared_ptr<SessionHolder> LoadRegisteredModel(const ModelKey& key, const std::string& model_path);
+  // Removes the idle registered models from sessions_, least recently used first, until num_bytes and num_threads
+  // more fit in the budgets, and returns them to be released outside of the lock. sessions_mutex_ must be held.
+  std::vector<std::shared_ptr<SessionHolder>> EvictIdleModels(size_t num_bytes, int num_threads);
+  // Throws if serving model as model_version of model_name exceeds the thread budget. sessions_mutex_ must be held.
+  void CheckThreadBudget(const std::string& model_name, const std::string& model_version,
+                         const SessionHolder& model) const;
 };
 
 }  // namespace server
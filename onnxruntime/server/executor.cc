@@ -31,6 +31,16 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // raw_data lives as long as the request, so the tensor can use it in place
+  try {
+    if (onnxruntime::server::TensorProtoRawDataToMLValue(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TensorProtoRawDataToMLValue() failed. Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -87,35 +97,37 @@ protobufutil::Status Executor::SetNameMLValueMap(std::vector<std::string>& input
   return protobufutil::Status::OK;
 }
 
-std::vector<Ort::Value> Run(const Ort::Session& session, const Ort::RunOptions& options, const std::vector<std::string>& input_names, const std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
-  size_t input_count = input_names.size();
-  size_t output_count = output_names.size();
-
-  std::vector<const char*> input_ptrs{};
-  input_ptrs.reserve(input_count);
-  for (const auto& input : input_names) {
-    input_ptrs.push_back(input.data());
-  }
-  std::vector<const char*> output_ptrs{};
-  output_ptrs.reserve(output_count);
-  for (const auto& output : output_names) {
-    output_ptrs.push_back(output.data());
+protobufutil::Status Executor::Predict(const std::string& model_name,
+                                       const std::string& model_version,
+                                       const onnxruntime::server::PredictRequest& request,
+                                       /* out */ onnxruntime::server::PredictResponse& response,
+                                       /* out */ RequestTimings* timings) {
+  // held until the request is done, so a reload of the model doesn't release it from under the request
+  std::shared_ptr<ServerEnvironment::SessionHolder> model;
+  try {
+    model = env_->GetModel(model_name, model_version);
+  } catch (const Ort::Exception& e) {
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
 
-  return const_cast<Ort::Session&>(session).Run(options, input_ptrs.data(), const_cast<Ort::Value*>(input_values.data()), input_count, output_ptrs.data(), output_count);
+  return Predict(*model, request, response, timings);
 }
 
-protobufutil::Status Executor::Predict(const std::string& model_name,
-                                       const std::string& model_version,
+protobufutil::Status Executor::Predict(const ServerEnvironment::SessionHolder& model,
                                        const onnxruntime::server::PredictRequest& request,
-                                       /* out */ onnxruntime::server::PredictResponse& response) {
+                                       /* out */ onnxruntime::server::PredictResponse& response,
+                                       /* out */ RequestTimings* timings) {
   auto logger = env_->GetLogger(request_id_);
 
   // Convert PredictRequest to NameMLValMap
+  const auto parse_start = std::chrono::steady_clock::now();
   MemBufferArray buffer_array;
   std::vector<std::string> input_names;
   std::vector<Ort::Value> input_values;
   auto conversion_status = SetNameMLValueMap(input_names, input_values, request, buffer_array);
+  if (timings != nullptr) {
+    timings->Add(RequestPhase::Parse, std::chrono::steady_clock::now() - parse_start);
+  }
   if (conversion_status != protobufutil::Status::OK) {
     return conversion_status;
   }
@@ -133,33 +145,40 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
       output_names.push_back(name);
     }
   } else {
-    output_names = env_->GetModelOutputNames(model_name, model_version);
+    output_names = model.output_names;
   }
 
   std::vector<Ort::Value> outputs;
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    outputs = model.Run(run_options, input_names, input_values, output_names, timings);
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
   }
 
-  // Build the response
+  // counted as serialization on every return from here on
+  struct SerializeTimer {
+    RequestTimings* timings;
+    std::chrono::steady_clock::time_point start;
+    ~SerializeTimer() {
+      if (timings != nullptr) timings->Add(RequestPhase::Serialize, std::chrono::steady_clock::now() - start);
+    }
+  } serialize_timer{timings, std::chrono::steady_clock::now()};
+
+  // Build the response, serializing each output straight into its slot of the response map
+  auto& response_outputs = *response.mutable_outputs();
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    if (response_outputs.count(output_names[i]) != 0) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
+
     try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
+      MLValueToTensorProto(outputs[i], using_raw_data_, logger, response_outputs[output_names[i]]);
     } catch (const Ort::Exception& e) {
       logger = env_->GetLogger(request_id_);
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
-
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
   }
 
   return protobufutil::Status::OK;
@@ -20,10 +20,18 @@ class Executor {
                                                                     using_raw_data_(true) {}
 
   // Prediction method
+  // The time spent converting the inputs and outputs, and in the batcher, is added to timings if it's not null.
   google::protobuf::util::Status Predict(const std::string& model_name,
                                          const std::string& model_version,
                                          const onnxruntime::server::PredictRequest& request,
-                                         /* out */ onnxruntime::server::PredictResponse& response);
+                                         /* out */ onnxruntime::server::PredictResponse& response,
+                                         /* out */ RequestTimings* timings = nullptr);
+
+  // Runs the request on a model that doesn't have to be served yet, e.g. to warm it up.
+  google::protobuf::util::Status Predict(const ServerEnvironment::SessionHolder& model,
+                                         const onnxruntime::server::PredictRequest& request,
+                                         /* out */ onnxruntime::server::PredictResponse& response,
+                                         /* out */ RequestTimings* timings = nullptr);
 
  private:
   ServerEnvironment* env_;
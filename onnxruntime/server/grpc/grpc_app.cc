@@ -1,4 +1,6 @@
 #include "grpc_app.h"
+#include <algorithm>
+#include <chrono>
 #include <grpcpp/health_check_service_interface.h>
 #include <grpcpp/ext/channelz_service_plugin.h>
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
@@ -6,20 +8,240 @@ namespace onnx_grpc = onnxruntime::server::grpc;
 
 namespace onnxruntime {
 namespace server {
-GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port) : prediction_service_implementation_(env) {
+
+namespace {
+
+// Predict: waits for a call, predicts it on a worker and finishes it.
+class UnaryCall final : public GRPCApp::Call {
+ public:
+  // Waits for the next call.
+  static void Create(GRPCApp& app) {
+    auto* call = new UnaryCall(app);
+    if (!app.StartOperation([call]() {
+          call->app_.AsyncService().RequestPredict(&call->context_, &call->request_, &call->responder_,
+                                                   call->app_.Queue(), call->app_.Queue(), call);
+        })) {
+      delete call;
+    }
+  }
+
+  void Proceed(bool ok) override {
+    if (state_ == State::Finishing || !ok) {
+      delete this;
+      return;
+    }
+
+    // wait for the next call while this one is predicted
+    Create(app_);
+    state_ = State::Finishing;
+    app_.Schedule([this]() {
+      auto status = app_.Service().Predict(&context_, &request_, &response_);
+      if (!app_.StartOperation([this, &status]() { responder_.Finish(response_, status, this); })) {
+        delete this;
+      }
+    });
+  }
+
+ private:
+  enum class State { Requested,
+                     Finishing };
+
+  explicit UnaryCall(GRPCApp& app) : app_(app), responder_(&context_) {}
+
+  GRPCApp& app_;
+  State state_ = State::Requested;
+  ::grpc::ServerContext context_;
+  PredictRequest request_;
+  PredictResponse response_;
+  ::grpc::ServerAsyncResponseWriter<PredictResponse> responder_;
+};
+
+// PredictStream: reads the requests one at a time, predicting each on a worker and writing its response before
+// reading the next, so the responses are in the order of the requests.
+class StreamCall final : public GRPCApp::Call {
+ public:
+  // Waits for the next call.
+  static void Create(GRPCApp& app) {
+    auto* call = new StreamCall(app);
+    if (!app.StartOperation([call]() {
+          call->app_.AsyncService().RequestPredictStream(&call->context_, &call->stream_, call->app_.Queue(),
+                                                         call->app_.Queue(), call);
+        })) {
+      delete call;
+    }
+  }
+
+  void Proceed(bool ok) override {
+    switch (state_) {
+      case State::Requested:
+        if (!ok) {
+          delete this;
+          return;
+        }
+        Create(app_);
+        request_id_ = app_.Service().SetRequestContext(&context_);
+        Read();
+        break;
+
+      case State::Reading:
+        if (!ok) {
+          // the client is done writing
+          Finish(::grpc::Status::OK);
+          return;
+        }
+        app_.Schedule([this]() {
+          response_.Clear();
+          auto status = app_.Service().Predict(request_id_, request_, response_);
+          if (!status.ok()) {
+            Finish(status);
+            return;
+          }
+          state_ = State::Writing;
+          if (!app_.StartOperation([this]() { stream_.Write(response_, this); })) {
+            delete this;
+          }
+        });
+        break;
+
+      case State::Writing:
+        if (!ok) {
+          Finish(::grpc::Status(::grpc::StatusCode::CANCELLED, "The stream was closed."));
+          return;
+        }
+        Read();
+        break;
+
+      case State::Finishing:
+        delete this;
+        break;
+    }
+  }
+
+ private:
+  enum class State { Requested,
+                     Reading,
+                     Writing,
+                     Finishing };
+
+  explicit StreamCall(GRPCApp& app) : app_(app), stream_(&context_) {}
+
+  void Read() {
+    state_ = State::Reading;
+    request_.Clear();
+    if (!app_.StartOperation([this]() { stream_.Read(&request_, this); })) {
+      delete this;
+    }
+  }
+
+  void Finish(const ::grpc::Status& status) {
+    state_ = State::Finishing;
+    if (!app_.StartOperation([this, &status]() { stream_.Finish(status, this); })) {
+      delete this;
+    }
+  }
+
+  GRPCApp& app_;
+  State state_ = State::Requested;
+  std::string request_id_;
+  ::grpc::ServerContext context_;
+  PredictRequest request_;
+  PredictResponse response_;
+  ::grpc::ServerAsyncReaderWriter<PredictResponse, PredictRequest> stream_;
+};
+
+}  // namespace
+
+GRPCApp::GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+                 int num_workers) : prediction_service_implementation_(env) {
   ::grpc::EnableDefaultHealthCheckService(true);
   ::grpc::channelz::experimental::InitChannelzService();
   ::grpc::reflection::InitProtoReflectionServerBuilderPlugin();
   ::grpc::ServerBuilder builder;
-  builder.RegisterService(&prediction_service_implementation_);
-  builder.AddListeningPort(host + ":" + std::to_string(port), ::grpc::InsecureServerCredentials());
+  builder.RegisterService(&service_);
+  builder.AddListeningPort(host + ":" + std::to_string(port), ::grpc::InsecureServerCredentials(), &port_);
+  queue_ = builder.AddCompletionQueue();
 
   server_ = builder.BuildAndStart();
   server_->GetHealthCheckService()->SetServingStatus(PredictionService::service_full_name(), true);
+
+  for (int i = 0; i < std::max(num_workers, 1); ++i) {
+    workers_.emplace_back(&GRPCApp::WorkerLoop, this);
+  }
+  UnaryCall::Create(*this);
+  StreamCall::Create(*this);
+  poller_ = std::thread(&GRPCApp::PollLoop, this);
+}
+
+GRPCApp::~GRPCApp() {
+  // fails the calls waiting for a client, and gives the others, the streams in particular, some time to finish
+  server_->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(5));
+
+  {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    workers_shutdown_ = true;
+  }
+  tasks_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    queue_shutdown_ = true;
+    queue_->Shutdown();
+  }
+  poller_.join();
 }
 
 void GRPCApp::Run() {
   server_->Wait();
 }
+
+bool GRPCApp::StartOperation(const std::function<void()>& start_operation) {
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  if (queue_shutdown_) {
+    return false;
+  }
+  start_operation();
+  return true;
+}
+
+void GRPCApp::Schedule(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(tasks_mutex_);
+    if (!workers_shutdown_) {
+      tasks_.push_back(std::move(task));
+      tasks_cv_.notify_one();
+      return;
+    }
+  }
+  // the calls cancelled by the shutdown are finished by the poller once the workers are gone
+  task();
+}
+
+void GRPCApp::PollLoop() {
+  void* tag = nullptr;
+  bool ok = false;
+  while (queue_->Next(&tag, &ok)) {
+    static_cast<Call*>(tag)->Proceed(ok);
+  }
+}
+
+void GRPCApp::WorkerLoop() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(tasks_mutex_);
+      tasks_cv_.wait(lock, [this]() { return workers_shutdown_ || !tasks_.empty(); });
+      // the tasks left are run before stopping, as each finishes a call
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
 }  // namespace server
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
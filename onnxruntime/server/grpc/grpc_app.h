@@ -1,25 +1,73 @@
 #pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <grpcpp/grpcpp.h>
 #include "prediction_service_impl.h"
 #include "environment.h"
 
 namespace onnxruntime {
 namespace server {
+// Serves the PredictionService with the asynchronous GRPC API: a thread polls the completion queue for the calls, and
+// hands their inference to a pool of num_workers threads, so the inference of one call never blocks the others.
 class GRPCApp {
  public:
-  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port);
-  ~GRPCApp() = default;
+  GRPCApp(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env, const std::string& host, const unsigned short port,
+          int num_workers = 1);
+  ~GRPCApp();
   GRPCApp(const GRPCApp& other) = delete;
   GRPCApp(GRPCApp&& other) = delete;
 
-  GRPCApp& operator=(const GRPCApp&) = delete; 
+  GRPCApp& operator=(const GRPCApp&) = delete;
 
   //Block until the server shuts down.
   void Run();
 
+  // The port listened to, picked by the system if port was 0.
+  int Port() const { return port_; }
+
+  // A call in progress, the tag of its operations on the completion queue. It deletes itself once done.
+  class Call {
+   public:
+    virtual ~Call() = default;
+    // ok is the result of the operation that completed
+    virtual void Proceed(bool ok) = 0;
+  };
+
+  grpc::PredictionServiceImpl& Service() { return prediction_service_implementation_; }
+  PredictionService::AsyncService& AsyncService() { return service_; }
+  ::grpc::ServerCompletionQueue* Queue() { return queue_.get(); }
+
+  // Runs start_operation, which starts an operation on the completion queue, unless the queue is shutting down.
+  // Returns false then, and the call should delete itself.
+  bool StartOperation(const std::function<void()>& start_operation);
+
+  // Runs the task on a worker.
+  void Schedule(std::function<void()> task);
+
  private:
+  void PollLoop();
+  void WorkerLoop();
+
   grpc::PredictionServiceImpl prediction_service_implementation_;
+  PredictionService::AsyncService service_;
+  std::unique_ptr<::grpc::ServerCompletionQueue> queue_;
   std::unique_ptr<::grpc::Server> server_;
+  int port_ = 0;
+
+  std::mutex queue_mutex_;
+  bool queue_shutdown_ = false;
+  std::thread poller_;
+
+  std::mutex tasks_mutex_;
+  std::condition_variable tasks_cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool workers_shutdown_ = false;
+  std::vector<std::thread> workers_;
 };
 }  // namespace server
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
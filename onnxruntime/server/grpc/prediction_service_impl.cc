@@ -1,5 +1,6 @@
 #include "prediction_service_impl.h"
 #include "request_id.h"
+#include "metrics.h"
 
 namespace onnxruntime {
 namespace server {
@@ -9,12 +10,20 @@ PredictionServiceImpl::PredictionServiceImpl(const std::shared_ptr<onnxruntime::
 
 ::grpc::Status PredictionServiceImpl::Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response) {
   auto request_id = SetRequestContext(context);
+  return Predict(request_id, *request, *response);
+}
+
+::grpc::Status PredictionServiceImpl::Predict(const std::string& request_id, const ::onnxruntime::server::PredictRequest& request, ::onnxruntime::server::PredictResponse& response) {
   onnxruntime::server::Executor executor(environment_.get(), request_id);
+  // GRPC deserializes the request and serializes the response itself, so only the tensor conversions are timed
+  RequestMetricsScope metrics(environment_->GetModelMetrics("default", ""));
   //TODO: (csteegz) Add modelspec for both paths.
-  auto status = executor.Predict("default", "1", *request, *response);  // Currently only support one model so hard coded.
+  // Currently only support one model so hard coded, at its highest version.
+  auto status = executor.Predict("default", "", request, response, &metrics.timings);
   if (!status.ok()) {
     return ::grpc::Status(::grpc::StatusCode(status.error_code()), status.error_message());
   }
+  metrics.succeeded = true;
   return ::grpc::Status::OK;
 }
 
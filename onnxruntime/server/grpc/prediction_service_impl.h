@@ -7,18 +7,22 @@
 namespace onnxruntime {
 namespace server {
 namespace grpc {
-class PredictionServiceImpl final : public onnxruntime::server::PredictionService::Service {
+// Handles the RPCs of the PredictionService, which GRPCApp serves asynchronously.
+class PredictionServiceImpl final {
  public:
   PredictionServiceImpl(const std::shared_ptr<onnxruntime::server::ServerEnvironment>& env);
   ::grpc::Status Predict(::grpc::ServerContext* context, const ::onnxruntime::server::PredictRequest* request, ::onnxruntime::server::PredictResponse* response);
 
- private:
-  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
+  // Predicts one request of a stream, whose context was set already.
+  ::grpc::Status Predict(const std::string& request_id, const ::onnxruntime::server::PredictRequest& request, ::onnxruntime::server::PredictResponse& response);
 
   //Extract customer request ID and set request ID for response.
   std::string SetRequestContext(::grpc::ServerContext* context);
+
+ private:
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> environment_;
 };
 }  // namespace grpc
 }  // namespace server
 
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
 #include "re2/re2.h"
 
@@ -60,9 +61,16 @@ http::status Routes::ParseUrl(http::verb method,
     return http::status::method_not_allowed;
   }
 
+  // routes like /metrics have fewer capture groups than the model name, version and action, and RE2 doesn't
+  // match when it's given more arguments than the pattern has groups
+  re2::RE2::Arg model_name_arg(&model_name), model_version_arg(&model_version), action_arg(&action);
+  const re2::RE2::Arg* const args[] = {&model_name_arg, &model_version_arg, &action_arg};
+
   bool found_match = false;
   for (const auto& pattern : func_table) {
-    if (re2::RE2::FullMatch(url, pattern.first, &model_name, &model_version, &action)) {
+    re2::RE2 regex(pattern.first);
+    const int num_args = std::min(3, regex.NumberOfCapturingGroups());
+    if (num_args >= 0 && re2::RE2::FullMatchN(url, regex, args, num_args)) {
       func = pattern.second;
 
       found_match = true;
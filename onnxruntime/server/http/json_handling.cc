@@ -9,6 +9,7 @@
 
 #include "predict.pb.h"
 #include "json_handling.h"
+#include "tensor_json.h"
 
 namespace protobufutil = google::protobuf::util;
 
@@ -16,6 +17,11 @@ namespace onnxruntime {
 namespace server {
 
 protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request) {
+  if (ParseRequestJson(json_string, request)) {
+    return protobufutil::Status::OK;
+  }
+  request.Clear();
+
   protobufutil::JsonParseOptions options;
   options.ignore_unknown_fields = true;
 
@@ -24,6 +30,11 @@ protobufutil::Status GetRequestFromJson(const std::string& json_string, /* out *
 }
 
 protobufutil::Status GenerateResponseInJson(const onnxruntime::server::PredictResponse& response, /* out */ std::string& json_string) {
+  if (WriteResponseJson(response, json_string)) {
+    return protobufutil::Status::OK;
+  }
+  json_string.clear();
+
   protobufutil::JsonPrintOptions options;
   options.add_whitespace = false;
   options.always_print_primitive_fields = false;
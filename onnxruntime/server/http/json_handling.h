@@ -15,11 +15,13 @@ namespace http = boost::beast::http;
 
 // Deserialize Json input to PredictRequest.
 // Unknown fields in the json file will be ignored.
+// The common requests are read by the codec of tensor_json.h, the others by the protobuf JSON parser.
 google::protobuf::util::Status GetRequestFromJson(const std::string& json_string, /* out */ onnxruntime::server::PredictRequest& request);
 
 // Serialize PredictResponse to json string
 // 1. Proto3 primitive fields with default values will be omitted in JSON output. Eg. int32 field with value 0 will be omitted
 // 2. Enums will be printed as string, not int, to improve readability
+// The common responses are written by the codec of tensor_json.h, to the same JSON.
 google::protobuf::util::Status GenerateResponseInJson(const onnxruntime::server::PredictResponse& response, /* out */ std::string& json_string);
 
 // Constructs JSON error message from error code object and error message
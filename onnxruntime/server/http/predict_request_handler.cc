@@ -7,6 +7,8 @@
 #include "http_server.h"
 #include "json_handling.h"
 #include "executor.h"
+#include "metrics.h"
+#include "raw_tensors.h"
 #include "util.h"
 
 namespace onnxruntime {
@@ -50,12 +52,16 @@ void Predict(const std::string& name,
     GenerateErrorResponse(logger, http::status::bad_request, "Unknown 'Accept' header field in the request", context);
   }
 
+  RequestMetricsScope metrics(env->GetModelMetrics(name, version));
+
   // Deserialize the payload
+  auto phase_start = std::chrono::steady_clock::now();
   auto body = context.request.body();
   PredictRequest predict_request{};
   http::status error_code;
   std::string error_message;
   bool parse_succeeded = ParseRequestPayload(context, request_type, predict_request, error_code, error_message);
+  metrics.timings.Add(RequestPhase::Parse, std::chrono::steady_clock::now() - phase_start);
   if (!parse_succeeded) {
     GenerateErrorResponse(logger, error_code, error_message, context);
     return;
@@ -64,13 +70,14 @@ void Predict(const std::string& name,
   // Run Prediction
   Executor executor(env.get(), context.request_id);
   PredictResponse predict_response{};
-  auto status = executor.Predict(name, version, predict_request, predict_response);
+  auto status = executor.Predict(name, version, predict_request, predict_response, &metrics.timings);
   if (!status.ok()) {
     GenerateErrorResponse(logger, GetHttpStatusCode((status)), status.error_message(), context);
     return;
   }
 
   // Serialize to proper output format
+  phase_start = std::chrono::steady_clock::now();
   std::string response_body{};
   if (response_type == SupportedContentType::Json) {
     status = GenerateResponseInJson(predict_response, response_body);
@@ -79,6 +86,13 @@ void Predict(const std::string& name,
       return;
     }
     context.response.set(http::field::content_type, "application/json");
+  } else if (response_type == SupportedContentType::RawTensors) {
+    status = GenerateResponseInRawTensors(predict_response, response_body);
+    if (!status.ok()) {
+      GenerateErrorResponse(logger, GetHttpStatusCode(status), status.error_message(), context);
+      return;
+    }
+    context.response.set(http::field::content_type, kRawTensorsMimeType);
   } else {
     response_body = predict_response.SerializeAsString();
     if (context.request.find("Accept") != context.request.end() && context.request["Accept"] != "*/*") {
@@ -95,6 +109,8 @@ void Predict(const std::string& name,
   }
   context.response.body() = response_body;
   context.response.result(http::status::ok);
+  metrics.timings.Add(RequestPhase::Serialize, std::chrono::steady_clock::now() - phase_start);
+  metrics.succeeded = true;
 };
 
 static bool ParseRequestPayload(const HttpContext& context, SupportedContentType request_type, PredictRequest& predictRequest, http::status& error_code, std::string& error_message) {
@@ -110,6 +126,15 @@ static bool ParseRequestPayload(const HttpContext& context, SupportedContentType
       }
       break;
     }
+    case SupportedContentType::RawTensors: {
+      status = GetRequestFromRawTensors(body, predictRequest);
+      if (!status.ok()) {
+        error_code = GetHttpStatusCode(status);
+        error_message = status.error_message();
+        return false;
+      }
+      break;
+    }
     case SupportedContentType::PbByteArray: {
       bool parse_succeeded = predictRequest.ParseFromArray(body.data(), static_cast<int>(body.size()));
       if (!parse_succeeded) {
@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "onnx-ml.pb.h"
+#include "predict.pb.h"
+#include "raw_tensors.h"
+
+namespace protobufutil = google::protobuf::util;
+
+namespace onnxruntime {
+namespace server {
+
+static const char kMagic[4] = {'O', 'R', 'T', 'T'};
+static const uint32_t kVersion = 1;
+
+// The integers are copied as is, the server only runs on little-endian hosts as the raw_data of TensorProto assumes.
+class PayloadReader {
+ public:
+  explicit PayloadReader(const std::string& payload) : data_(payload.data()), remaining_(payload.size()) {}
+
+  template <typename T>
+  bool Read(T& value) {
+    if (remaining_ < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data_, sizeof(T));
+    Skip(sizeof(T));
+    return true;
+  }
+
+  bool ReadBytes(uint64_t length, std::string& bytes) {
+    if (remaining_ < length) {
+      return false;
+    }
+    bytes.assign(data_, static_cast<size_t>(length));
+    Skip(static_cast<size_t>(length));
+    return true;
+  }
+
+  bool ReadString(std::string& value) {
+    uint32_t length = 0;
+    return Read(length) && ReadBytes(length, value);
+  }
+
+  bool AtEnd() const { return remaining_ == 0; }
+
+ private:
+  void Skip(size_t length) {
+    data_ += length;
+    remaining_ -= length;
+  }
+
+  const char* data_;
+  size_t remaining_;
+};
+
+template <typename T>
+static void Append(std::string& payload, T value) {
+  payload.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void AppendString(std::string& payload, const std::string& value) {
+  Append(payload, static_cast<uint32_t>(value.size()));
+  payload.append(value);
+}
+
+// 0 for the types whose elements don't have a fixed size
+static size_t ElementSize(int32_t data_type) {
+  switch (data_type) {
+    case onnx::TensorProto_DataType_BOOL:
+    case onnx::TensorProto_DataType_INT8:
+    case onnx::TensorProto_DataType_UINT8:
+      return 1;
+    case onnx::TensorProto_DataType_INT16:
+    case onnx::TensorProto_DataType_UINT16:
+    case onnx::TensorProto_DataType_FLOAT16:
+    case onnx::TensorProto_DataType_BFLOAT16:
+      return 2;
+    case onnx::TensorProto_DataType_FLOAT:
+    case onnx::TensorProto_DataType_INT32:
+    case onnx::TensorProto_DataType_UINT32:
+      return 4;
+    case onnx::TensorProto_DataType_DOUBLE:
+    case onnx::TensorProto_DataType_INT64:
+    case onnx::TensorProto_DataType_UINT64:
+    case onnx::TensorProto_DataType_COMPLEX64:
+      return 8;
+    case onnx::TensorProto_DataType_COMPLEX128:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+// Appends the typed values as elements of type T, the narrower types being held in wider fields.
+template <typename T, typename Field>
+static void AppendElements(std::string& payload, const Field& values) {
+  for (const auto value : values) {
+    Append(payload, static_cast<T>(value));
+  }
+}
+
+static bool AppendTensorData(std::string& payload, const onnx::TensorProto& tensor) {
+  if (!tensor.raw_data().empty()) {
+    Append(payload, static_cast<uint64_t>(tensor.raw_data().size()));
+    payload.append(tensor.raw_data());
+    return true;
+  }
+
+  const size_t length_offset = payload.size();
+  Append(payload, uint64_t{0});
+  switch (tensor.data_type()) {
+    case onnx::TensorProto_DataType_FLOAT:
+    case onnx::TensorProto_DataType_COMPLEX64:
+      AppendElements<float>(payload, tensor.float_data());
+      break;
+    case onnx::TensorProto_DataType_DOUBLE:
+    case onnx::TensorProto_DataType_COMPLEX128:
+      AppendElements<double>(payload, tensor.double_data());
+      break;
+    case onnx::TensorProto_DataType_INT32:
+      AppendElements<int32_t>(payload, tensor.int32_data());
+      break;
+    case onnx::TensorProto_DataType_INT64:
+      AppendElements<int64_t>(payload, tensor.int64_data());
+      break;
+    case onnx::TensorProto_DataType_UINT32:
+      AppendElements<uint32_t>(payload, tensor.uint64_data());
+      break;
+    case onnx::TensorProto_DataType_UINT64:
+      AppendElements<uint64_t>(payload, tensor.uint64_data());
+      break;
+    case onnx::TensorProto_DataType_BOOL:
+    case onnx::TensorProto_DataType_INT8:
+    case onnx::TensorProto_DataType_UINT8:
+      AppendElements<uint8_t>(payload, tensor.int32_data());
+      break;
+    case onnx::TensorProto_DataType_INT16:
+    case onnx::TensorProto_DataType_UINT16:
+    case onnx::TensorProto_DataType_FLOAT16:
+    case onnx::TensorProto_DataType_BFLOAT16:
+      AppendElements<uint16_t>(payload, tensor.int32_data());
+      break;
+    default:
+      return false;
+  }
+
+  const uint64_t length = payload.size() - length_offset - sizeof(uint64_t);
+  std::memcpy(&payload[length_offset], &length, sizeof(length));
+  return true;
+}
+
+static protobufutil::Status InvalidPayload(const std::string& message) {
+  return protobufutil::Status(protobufutil::error::INVALID_ARGUMENT, "Invalid tensors payload: " + message);
+}
+
+protobufutil::Status GetRequestFromRawTensors(const std::string& payload, /* out */ PredictRequest& request) {
+  PayloadReader reader(payload);
+  char magic[sizeof(kMagic)];
+  uint32_t version = 0;
+  uint32_t num_tensors = 0;
+  if (!reader.Read(magic) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || !reader.Read(version)) {
+    return InvalidPayload("missing header.");
+  }
+  if (version != kVersion) {
+    return InvalidPayload("unsupported version " + std::to_string(version) + ".");
+  }
+  if (!reader.Read(num_tensors)) {
+    return InvalidPayload("missing number of tensors.");
+  }
+
+  auto& inputs = *request.mutable_inputs();
+  for (uint32_t i = 0; i < num_tensors; ++i) {
+    std::string name;
+    int32_t data_type = 0;
+    uint32_t rank = 0;
+    if (!reader.ReadString(name) || !reader.Read(data_type) || !reader.Read(rank)) {
+      return InvalidPayload("truncated tensor " + std::to_string(i) + ".");
+    }
+
+    const size_t element_size = ElementSize(data_type);
+    if (element_size == 0) {
+      return InvalidPayload("unsupported data type " + std::to_string(data_type) + " of " + name + ".");
+    }
+    if (inputs.count(name) != 0) {
+      return InvalidPayload("duplicate tensor " + name + ".");
+    }
+
+    onnx::TensorProto& tensor = inputs[name];
+    tensor.set_data_type(data_type);
+    uint64_t num_elements = 1;
+    for (uint32_t d = 0; d < rank; ++d) {
+      int64_t dim = 0;
+      if (!reader.Read(dim)) {
+        return InvalidPayload("truncated shape of " + name + ".");
+      }
+      if (dim < 0 || (dim != 0 && num_elements > std::numeric_limits<uint64_t>::max() / element_size / dim)) {
+        return InvalidPayload("invalid shape of " + name + ".");
+      }
+      num_elements *= static_cast<uint64_t>(dim);
+      tensor.add_dims(dim);
+    }
+
+    uint64_t length = 0;
+    if (!reader.Read(length) || !reader.ReadBytes(length, *tensor.mutable_raw_data())) {
+      return InvalidPayload("truncated data of " + name + ".");
+    }
+    if (length != num_elements * element_size) {
+      return InvalidPayload("the data of " + name + " is " + std::to_string(length) + " bytes, its shape needs " +
+                            std::to_string(num_elements * element_size) + ".");
+    }
+  }
+
+  uint32_t num_filters = 0;
+  if (!reader.Read(num_filters)) {
+    return InvalidPayload("missing number of output filters.");
+  }
+  for (uint32_t i = 0; i < num_filters; ++i) {
+    if (!reader.ReadString(*request.add_output_filter())) {
+      return InvalidPayload("truncated output filter " + std::to_string(i) + ".");
+    }
+  }
+
+  if (!reader.AtEnd()) {
+    return InvalidPayload("unexpected data after the output filters.");
+  }
+  return protobufutil::Status::OK;
+}
+
+protobufutil::Status GenerateResponseInRawTensors(const PredictResponse& response, /* out */ std::string& payload) {
+  payload.clear();
+  payload.append(kMagic, sizeof(kMagic));
+  Append(payload, kVersion);
+  Append(payload, static_cast<uint32_t>(response.outputs_size()));
+
+  for (const auto& output : response.outputs()) {
+    const onnx::TensorProto& tensor = output.second;
+    AppendString(payload, output.first);
+    Append(payload, static_cast<int32_t>(tensor.data_type()));
+    Append(payload, static_cast<uint32_t>(tensor.dims_size()));
+    for (const auto dim : tensor.dims()) {
+      Append(payload, static_cast<int64_t>(dim));
+    }
+
+    if (!AppendTensorData(payload, tensor)) {
+      return protobufutil::Status(protobufutil::error::INVALID_ARGUMENT,
+                                  "Output " + output.first + " has a data type the tensors payload doesn't support. "
+                                  "Request it as protobuf or JSON instead.");
+    }
+  }
+
+  Append(payload, uint32_t{0});
+  return protobufutil::Status::OK;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// A binary payload of tensors that skips the protobuf and JSON encodings, so the tensor data is copied as is.
+// All the integers are little-endian:
+//   char[4]  magic "ORTT"
+//   uint32   version, 1
+//   uint32   number of tensors, followed by each tensor:
+//     uint32   name length, followed by the name
+//     int32    onnx::TensorProto_DataType of the elements, strings aren't supported
+//     uint32   rank, followed by the int64 dims
+//     uint64   data length, followed by the elements in row-major order, little-endian
+//   uint32   number of output filters, followed by the length and name of each, requests only
+constexpr const char* kRawTensorsMimeType = "application/x-onnxruntime-tensors";
+
+// The tensors are read into raw_data.
+google::protobuf::util::Status GetRequestFromRawTensors(const std::string& payload, /* out */ PredictRequest& request);
+
+// Tensors held in the typed fields of the TensorProto are converted to raw data.
+google::protobuf::util::Status GenerateResponseInRawTensors(const PredictResponse& response, /* out */ std::string& payload);
+
+}  // namespace server
+}  // namespace onnxruntime
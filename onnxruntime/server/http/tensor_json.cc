@@ -0,0 +1,595 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cerrno>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "onnx-ml.pb.h"
+#include "predict.pb.h"
+#include "tensor_json.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+// Reads JSON tokens in place. Every method returns false on anything unexpected.
+class JsonReader {
+ public:
+  explicit JsonReader(const std::string& json) : p_(json.data()), end_(json.data() + json.size()) {}
+
+  // Consumes c, after any whitespace, if it's the next character.
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == c) {
+      ++p_;
+      return true;
+    }
+    return false;
+  }
+
+  bool AtEnd() {
+    SkipWhitespace();
+    return p_ == end_;
+  }
+
+  bool NextIsString() {
+    SkipWhitespace();
+    return p_ != end_ && *p_ == '"';
+  }
+
+  // Strings with characters beyond ASCII are left to protobuf, which validates their UTF-8.
+  bool ReadString(std::string& value) {
+    value.clear();
+    if (!Consume('"')) {
+      return false;
+    }
+    while (p_ != end_) {
+      const unsigned char c = static_cast<unsigned char>(*p_++);
+      if (c == '"') {
+        return true;
+      }
+      if (c < 0x20 || c >= 0x80) {
+        return false;
+      }
+      if (c != '\\') {
+        value.push_back(static_cast<char>(c));
+        continue;
+      }
+      if (p_ == end_) {
+        return false;
+      }
+      switch (*p_++) {
+        case '"':
+          value.push_back('"');
+          break;
+        case '\\':
+          value.push_back('\\');
+          break;
+        case '/':
+          value.push_back('/');
+          break;
+        case 'b':
+          value.push_back('\b');
+          break;
+        case 'f':
+          value.push_back('\f');
+          break;
+        case 'n':
+          value.push_back('\n');
+          break;
+        case 'r':
+          value.push_back('\r');
+          break;
+        case 't':
+          value.push_back('\t');
+          break;
+        case 'u': {
+          uint32_t code_point = 0;
+          if (!ReadHex4(code_point)) {
+            return false;
+          }
+          if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+            return false;
+          }
+          if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+            uint32_t low = 0;
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+              return false;
+            }
+            p_ += 2;
+            if (!ReadHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+              return false;
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+          }
+          AppendUtf8(value, code_point);
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  // Reads a number, or a string holding one as the protobuf JSON mapping allows.
+  bool ReadNumber(std::string& token) {
+    if (NextIsString()) {
+      return ReadString(token) && !token.empty();
+    }
+
+    const char* begin = p_;
+    const char* p = p_;
+    if (p != end_ && *p == '-') ++p;
+    if (p == end_ || !IsDigit(*p)) return false;
+    if (*p == '0') {
+      ++p;
+    } else {
+      while (p != end_ && IsDigit(*p)) ++p;
+    }
+    if (p != end_ && *p == '.') {
+      ++p;
+      if (p == end_ || !IsDigit(*p)) return false;
+      while (p != end_ && IsDigit(*p)) ++p;
+    }
+    if (p != end_ && (*p == 'e' || *p == 'E')) {
+      ++p;
+      if (p != end_ && (*p == '+' || *p == '-')) ++p;
+      if (p == end_ || !IsDigit(*p)) return false;
+      while (p != end_ && IsDigit(*p)) ++p;
+    }
+    token.assign(begin, p);
+    p_ = p;
+    return true;
+  }
+
+ private:
+  static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+  void SkipWhitespace() {
+    while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  bool ReadHex4(uint32_t& value) {
+    if (end_ - p_ < 4) {
+      return false;
+    }
+    for (int i = 0; i < 4; ++i, ++p_) {
+      const char c = *p_;
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        value |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        value |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void AppendUtf8(std::string& value, uint32_t code_point) {
+    if (code_point < 0x80) {
+      value.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+      value.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+      value.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+      value.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+      value.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+      value.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+      value.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+      value.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+      value.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+      value.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+// Integers are only read from integer tokens, the other forms protobuf accepts, like 1e2, are left to it.
+bool IsIntegerToken(const std::string& token, bool allow_sign) {
+  size_t i = (allow_sign && !token.empty() && token[0] == '-') ? 1 : 0;
+  if (i == token.size()) {
+    return false;
+  }
+  for (; i < token.size(); ++i) {
+    if (token[i] < '0' || token[i] > '9') {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseValue(const std::string& token, int64_t& value) {
+  if (!IsIntegerToken(token, true)) {
+    return false;
+  }
+  errno = 0;
+  value = std::strtoll(token.c_str(), nullptr, 10);
+  return errno == 0;
+}
+
+bool ParseValue(const std::string& token, int32_t& value) {
+  int64_t wide = 0;
+  if (!ParseValue(token, wide) || wide < std::numeric_limits<int32_t>::min() ||
+      wide > std::numeric_limits<int32_t>::max()) {
+    return false;
+  }
+  value = static_cast<int32_t>(wide);
+  return true;
+}
+
+bool ParseValue(const std::string& token, uint64_t& value) {
+  if (!IsIntegerToken(token, false)) {
+    return false;
+  }
+  errno = 0;
+  value = std::strtoull(token.c_str(), nullptr, 10);
+  return errno == 0;
+}
+
+bool ParseValue(const std::string& token, double& value) {
+  if (token == "NaN") {
+    value = std::numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+  if (token == "Infinity" || token == "-Infinity") {
+    value = token[0] == '-' ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    return true;
+  }
+
+  // quoted numbers skip the grammar check of ReadNumber, leave anything strtod takes beyond it, like hex, to protobuf
+  if (token.find_first_not_of("0123456789+-.eE") != std::string::npos) {
+    return false;
+  }
+  char* end = nullptr;
+  errno = 0;
+  value = std::strtod(token.c_str(), &end);
+  return errno == 0 && end == token.c_str() + token.size() && std::isfinite(value);
+}
+
+// Parsed as a double and narrowed, like protobuf does, so the values round the same way.
+bool ParseValue(const std::string& token, float& value) {
+  double wide = 0;
+  if (!ParseValue(token, wide) || (std::isfinite(wide) && (wide > FLT_MAX || wide < -FLT_MAX))) {
+    return false;
+  }
+  value = static_cast<float>(wide);
+  return true;
+}
+
+template <typename T, typename Field>
+bool ReadArray(JsonReader& reader, Field& field) {
+  if (!reader.Consume('[')) {
+    return false;
+  }
+  if (reader.Consume(']')) {
+    return true;
+  }
+
+  std::string token;
+  do {
+    T value{};
+    if (!reader.ReadNumber(token) || !ParseValue(token, value)) {
+      return false;
+    }
+    field.Add(value);
+  } while (reader.Consume(','));
+  return reader.Consume(']');
+}
+
+bool ReadTensor(JsonReader& reader, onnx::TensorProto& tensor) {
+  if (!reader.Consume('{')) {
+    return false;
+  }
+  if (reader.Consume('}')) {
+    return true;
+  }
+
+  std::string key;
+  std::string token;
+  do {
+    if (!reader.ReadString(key) || !reader.Consume(':')) {
+      return false;
+    }
+
+    bool read = false;
+    if (key == "dims") {
+      read = ReadArray<int64_t>(reader, *tensor.mutable_dims());
+    } else if (key == "dataType" || key == "data_type") {
+      int32_t data_type = 0;
+      read = reader.ReadNumber(token) && ParseValue(token, data_type);
+      tensor.set_data_type(data_type);
+    } else if (key == "name") {
+      read = reader.ReadString(*tensor.mutable_name());
+    } else if (key == "floatData" || key == "float_data") {
+      read = ReadArray<float>(reader, *tensor.mutable_float_data());
+    } else if (key == "doubleData" || key == "double_data") {
+      read = ReadArray<double>(reader, *tensor.mutable_double_data());
+    } else if (key == "int32Data" || key == "int32_data") {
+      read = ReadArray<int32_t>(reader, *tensor.mutable_int32_data());
+    } else if (key == "int64Data" || key == "int64_data") {
+      read = ReadArray<int64_t>(reader, *tensor.mutable_int64_data());
+    } else if (key == "uint64Data" || key == "uint64_data") {
+      read = ReadArray<uint64_t>(reader, *tensor.mutable_uint64_data());
+    }
+    if (!read) {
+      return false;
+    }
+  } while (reader.Consume(','));
+  return reader.Consume('}');
+}
+
+bool ReadInputs(JsonReader& reader, PredictRequest& request) {
+  if (!reader.Consume('{')) {
+    return false;
+  }
+  if (reader.Consume('}')) {
+    return true;
+  }
+
+  auto& inputs = *request.mutable_inputs();
+  std::string name;
+  do {
+    if (!reader.ReadString(name) || !reader.Consume(':') || inputs.count(name) != 0 ||
+        !ReadTensor(reader, inputs[name])) {
+      return false;
+    }
+  } while (reader.Consume(','));
+  return reader.Consume('}');
+}
+
+bool ReadOutputFilter(JsonReader& reader, PredictRequest& request) {
+  if (!reader.Consume('[')) {
+    return false;
+  }
+  if (reader.Consume(']')) {
+    return true;
+  }
+
+  do {
+    if (!reader.ReadString(*request.add_output_filter())) {
+      return false;
+    }
+  } while (reader.Consume(','));
+  return reader.Consume(']');
+}
+
+// Names with characters that protobuf may escape differently are left to it.
+bool IsPlainString(const std::string& value) {
+  for (const char c : value) {
+    if (c < 0x20 || c >= 0x7f || c == '"' || c == '\\' || c == '<' || c == '>' || c == '&' || c == '\'' ||
+        c == '=') {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WriteString(std::string& json, const std::string& value) {
+  json.push_back('"');
+  json.append(value);
+  json.push_back('"');
+}
+
+void WriteBase64(std::string& json, const std::string& bytes) {
+  static const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const auto* data = reinterpret_cast<const unsigned char*>(bytes.data());
+  const size_t size = bytes.size();
+  json.push_back('"');
+  size_t i = 0;
+  for (; i + 2 < size; i += 3) {
+    const uint32_t triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    json.push_back(kAlphabet[(triple >> 18) & 0x3F]);
+    json.push_back(kAlphabet[(triple >> 12) & 0x3F]);
+    json.push_back(kAlphabet[(triple >> 6) & 0x3F]);
+    json.push_back(kAlphabet[triple & 0x3F]);
+  }
+  if (i < size) {
+    const uint32_t triple = (data[i] << 16) | (i + 1 < size ? data[i + 1] << 8 : 0);
+    json.push_back(kAlphabet[(triple >> 18) & 0x3F]);
+    json.push_back(kAlphabet[(triple >> 12) & 0x3F]);
+    json.push_back(i + 1 < size ? kAlphabet[(triple >> 6) & 0x3F] : '=');
+    json.push_back('=');
+  }
+  json.push_back('"');
+}
+
+void WriteValue(std::string& json, int32_t value) {
+  json.append(std::to_string(value));
+}
+
+// 64 bit integers are quoted in the protobuf JSON mapping
+void WriteValue(std::string& json, int64_t value) {
+  WriteString(json, std::to_string(value));
+}
+
+void WriteValue(std::string& json, uint64_t value) {
+  WriteString(json, std::to_string(value));
+}
+
+template <typename T>
+T Parse(const char* buffer);
+
+template <>
+float Parse<float>(const char* buffer) {
+  return std::strtof(buffer, nullptr);
+}
+
+template <>
+double Parse<double>(const char* buffer) {
+  return std::strtod(buffer, nullptr);
+}
+
+// The shortest of the two precisions of SimpleFtoa and SimpleDtoa that round trips, and the names protobuf gives to
+// the values JSON numbers can't hold.
+template <typename T>
+void WriteFloatingPoint(std::string& json, T value, int digits, int round_trip_digits) {
+  if (std::isnan(value)) {
+    json.append("\"NaN\"");
+    return;
+  }
+  if (std::isinf(value)) {
+    json.append(value > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+    return;
+  }
+
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.*g", digits, static_cast<double>(value));
+  if (Parse<T>(buffer) != value) {
+    std::snprintf(buffer, sizeof(buffer), "%.*g", round_trip_digits, static_cast<double>(value));
+  }
+  json.append(buffer);
+}
+
+void WriteValue(std::string& json, float value) {
+  WriteFloatingPoint(json, value, FLT_DIG, FLT_DIG + 3);
+}
+
+void WriteValue(std::string& json, double value) {
+  WriteFloatingPoint(json, value, DBL_DIG, DBL_DIG + 2);
+}
+
+template <typename T, typename Field>
+void WriteArray(std::string& json, const char* key, const Field& field) {
+  if (field.size() == 0) {
+    return;
+  }
+  json.append(key);
+  json.push_back('[');
+  bool first = true;
+  for (const auto value : field) {
+    if (!first) json.push_back(',');
+    first = false;
+    WriteValue(json, static_cast<T>(value));
+  }
+  json.append("],");
+}
+
+bool WriteTensor(std::string& json, const onnx::TensorProto& tensor) {
+  if (tensor.has_segment() || tensor.has_doc_string() || tensor.external_data_size() != 0 ||
+      (tensor.has_name() && !IsPlainString(tensor.name()))) {
+    return false;
+  }
+
+  // fields in field number order, each followed by a comma dropped at the end
+  json.push_back('{');
+  const size_t start = json.size();
+  WriteArray<int64_t>(json, "\"dims\":", tensor.dims());
+  if (tensor.has_data_type()) {
+    json.append("\"dataType\":");
+    WriteValue(json, static_cast<int32_t>(tensor.data_type()));
+    json.push_back(',');
+  }
+  WriteArray<float>(json, "\"floatData\":", tensor.float_data());
+  WriteArray<int32_t>(json, "\"int32Data\":", tensor.int32_data());
+  if (tensor.string_data_size() != 0) {
+    json.append("\"stringData\":[");
+    for (int i = 0; i < tensor.string_data_size(); ++i) {
+      if (i != 0) json.push_back(',');
+      WriteBase64(json, tensor.string_data(i));
+    }
+    json.append("],");
+  }
+  WriteArray<int64_t>(json, "\"int64Data\":", tensor.int64_data());
+  if (tensor.has_name()) {
+    json.append("\"name\":");
+    WriteString(json, tensor.name());
+    json.push_back(',');
+  }
+  if (tensor.has_raw_data()) {
+    json.append("\"rawData\":");
+    WriteBase64(json, tensor.raw_data());
+    json.push_back(',');
+  }
+  WriteArray<double>(json, "\"doubleData\":", tensor.double_data());
+  WriteArray<uint64_t>(json, "\"uint64Data\":", tensor.uint64_data());
+  if (tensor.has_data_location()) {
+    json.append("\"dataLocation\":");
+    WriteString(json, onnx::TensorProto_DataLocation_Name(tensor.data_location()));
+    json.push_back(',');
+  }
+
+  if (json.size() != start) {
+    json.pop_back();
+  }
+  json.push_back('}');
+  return true;
+}
+
+}  // namespace
+
+bool ParseRequestJson(const std::string& json, /* out */ PredictRequest& request) {
+  JsonReader reader(json);
+  if (!reader.Consume('{')) {
+    return false;
+  }
+
+  if (!reader.Consume('}')) {
+    std::string key;
+    do {
+      if (!reader.ReadString(key) || !reader.Consume(':')) {
+        return false;
+      }
+
+      bool read = false;
+      if (key == "inputs") {
+        read = ReadInputs(reader, request);
+      } else if (key == "outputFilter" || key == "output_filter") {
+        read = ReadOutputFilter(reader, request);
+      }
+      if (!read) {
+        return false;
+      }
+    } while (reader.Consume(','));
+
+    if (!reader.Consume('}')) {
+      return false;
+    }
+  }
+  return reader.AtEnd();
+}
+
+bool WriteResponseJson(const PredictResponse& response, /* out */ std::string& json) {
+  json.clear();
+  if (response.outputs().empty()) {
+    json = "{}";
+    return true;
+  }
+
+  // the map is written in its iteration order, which is also the order of the serialization protobuf converts
+  json.append("{\"outputs\":{");
+  bool first = true;
+  for (const auto& output : response.outputs()) {
+    if (!IsPlainString(output.first)) {
+      return false;
+    }
+    if (!first) json.push_back(',');
+    first = false;
+    WriteString(json, output.first);
+    json.push_back(':');
+    if (!WriteTensor(json, output.second)) {
+      return false;
+    }
+  }
+  json.append("}}");
+  return true;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
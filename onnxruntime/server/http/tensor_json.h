@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "predict.pb.h"
+
+namespace onnxruntime {
+namespace server {
+
+// A JSON codec for the common shape of the predict messages, which reads the numbers of the typed fields straight
+// into the tensors instead of going through the generic protobuf JSON parser.
+// Both return false, leaving the output in an unspecified state, for what they don't handle: other fields, null,
+// invalid JSON, etc. The caller then falls back to the protobuf codec, which also makes the error messages.
+
+// Handles inputs with dims, dataType, name and the float, double, int32, int64 and uint64 fields, and outputFilter.
+bool ParseRequestJson(const std::string& json, /* out */ PredictRequest& request);
+
+// Writes the same JSON as MessageToJsonString without whitespace, for outputs without segment, doc_string,
+// external data or data location.
+bool WriteResponseJson(const PredictResponse& response, /* out */ std::string& json);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include <google/protobuf/stubs/status.h>
 
 #include "context.h"
+#include "raw_tensors.h"
 #include "util.h"
 
 namespace protobufutil = google::protobuf::util;
@@ -60,6 +61,8 @@ SupportedContentType GetRequestContentType(const HttpContext& context) {
       return SupportedContentType::Json;
     } else if (protobuf_mime_types.find(context.request["Content-Type"].to_string()) != protobuf_mime_types.end()) {
       return SupportedContentType::PbByteArray;
+    } else if (context.request["Content-Type"] == kRawTensorsMimeType) {
+      return SupportedContentType::RawTensors;
     }
   }
 
@@ -72,6 +75,8 @@ SupportedContentType GetResponseContentType(const HttpContext& context) {
       return SupportedContentType::Json;
     } else if (context.request["Accept"] == "*/*" || protobuf_mime_types.find(context.request["Accept"].to_string()) != protobuf_mime_types.end()) {
       return SupportedContentType::PbByteArray;
+    } else if (context.request["Accept"] == kRawTensorsMimeType) {
+      return SupportedContentType::RawTensors;
     }
   } else {
     return SupportedContentType::PbByteArray;
@@ -4,6 +4,8 @@
 #include "environment.h"
 #include "http_server.h"
 #include "predict_request_handler.h"
+#include "metrics_request_handler.h"
+#include "model_repository.h"
 #include "server_configuration.h"
 #include "grpc/grpc_app.h"
 #include <spdlog/spdlog.h>
@@ -60,23 +62,71 @@ int main(int argc, char* argv[]) {
 
   const auto env = std::make_shared<server::ServerEnvironment>(config.logging_level, spdlog::sinks_init_list{std::make_shared<spdlog::sinks::stdout_sink_mt>(), std::make_shared<spdlog::sinks::syslog_sink_mt>()});
   auto logger = env->GetAppLogger();
-  logger->info("Model path: {}", config.model_path);
 
-  try {
-    env->InitializeModel(config.model_path, "default", "1");
-    logger->debug("Initialize Model Successfully!");
-  } catch (const Ort::Exception& ex) {
-    logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
-    exit(EXIT_FAILURE);
+  server::BatchingOptions batching_options;
+  batching_options.max_batch_size = config.max_batch_size;
+  batching_options.batch_timeout = std::chrono::microseconds(config.batch_timeout_micros);
+  env->SetBatchingOptions(batching_options);
+  env->SetWarmupRuns(static_cast<unsigned>(config.warmup_runs));
+  server::ModelOptions model_options;
+  model_options.num_replicas = config.num_session_replicas;
+  model_options.intra_op_num_threads = config.IntraOpThreadCount();
+  model_options.inter_op_num_threads = config.num_inter_op_threads;
+  env->SetDefaultModelOptions(model_options);
+  env->SetThreadBudget(config.ModelThreadBudget());
+  if (model_options.num_replicas > 1) {
+    logger->info("Running {} sessions per model with {} intra op and {} inter op threads each", model_options.num_replicas,
+                 model_options.intra_op_num_threads, model_options.inter_op_num_threads);
+  }
+  if (batching_options.max_batch_size > 1) {
+    logger->info("Batching up to {} rows with a timeout of {}us", config.max_batch_size, config.batch_timeout_micros);
+  }
+
+  env->SetMemoryBudget(static_cast<size_t>(config.memory_budget_mb) << 20);
+  if (!config.snapshot_path.empty()) {
+    logger->info("Model snapshots: {}", config.snapshot_path);
+    env->SetSnapshotDirectory(config.snapshot_path);
+  }
+
+  std::unique_ptr<server::ModelRepository> repository;
+  if (!config.models_path.empty()) {
+    const auto num_registered = server::RegisterModels(*env, config.models_path);
+    logger->info("Serving {} model versions from {}, loaded on their first request", num_registered, config.models_path);
+    if (num_registered == 0) {
+      logger->critical("No model found in {}", config.models_path);
+      exit(EXIT_FAILURE);
+    }
+  } else if (!config.repository_path.empty()) {
+    logger->info("Model repository: {}", config.repository_path);
+    server::ModelRepositoryOptions repository_options;
+    repository_options.path = config.repository_path;
+    repository_options.num_versions = config.num_model_versions;
+    repository_options.poll_interval = std::chrono::seconds(config.poll_interval_seconds);
+    repository = std::make_unique<server::ModelRepository>(*env, repository_options);
+    if (repository->Poll() == 0) {
+      logger->critical("No version of the model in the repository could be loaded");
+      exit(EXIT_FAILURE);
+    }
+    repository->Start();
+  } else {
+    logger->info("Model path: {}", config.model_path);
+    try {
+      env->InitializeModel(config.model_path, "default", "1");
+      logger->debug("Initialize Model Successfully!");
+    } catch (const Ort::Exception& ex) {
+      logger->critical("Initialize Model Failed: {} ---- Error: [{}]", ex.GetOrtErrorCode(), ex.what());
+      exit(EXIT_FAILURE);
+    }
   }
 
   //Setup GRPC Server
   auto const grpc_address = config.address;
   auto const grpc_port = config.grpc_port;
 
-  server::GRPCApp grpc_app{env, grpc_address, grpc_port};
+  auto const grpc_workers = config.GrpcWorkerCount();
+  server::GRPCApp grpc_app{env, grpc_address, grpc_port, grpc_workers};
 
-  logger->info("GRPC Listening at: {}:{}", grpc_address, grpc_port);
+  logger->info("GRPC Listening at: {}:{} with {} workers", grpc_address, grpc_port, grpc_workers);
 
   //Setup HTTP Server
   auto const boost_address = boost::asio::ip::make_address(config.address);
@@ -109,6 +159,12 @@ int main(int argc, char* argv[]) {
         server::Predict(name, version, action, context, env);
       });
 
+  app.RegisterGet(
+      R"(/metrics)",
+      [&env](const auto& /*name*/, const auto& /*version*/, const auto& /*action*/, auto& context) -> void {
+        server::Metrics(context, env);
+      });
+
   app.Bind(boost_address, config.http_port)
       .NumThreads(config.num_http_threads)
       .Run();
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <limits>
+
+#include "metrics.h"
+
+namespace onnxruntime {
+namespace server {
+
+static const std::vector<double> kLatencyBuckets{0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05,
+                                                 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+static const std::vector<double> kBatchSizeBuckets{1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024};
+static const char* const kPhaseNames[] = {"parse", "queue", "inference", "serialize"};
+
+static void WriteValue(std::ostream& out, double value) {
+  if (value == std::numeric_limits<double>::infinity()) {
+    out << "+Inf";
+  } else {
+    out << value;
+  }
+}
+
+static std::string JoinLabels(const std::string& labels, const std::string& label) {
+  return labels.empty() ? label : labels + "," + label;
+}
+
+Histogram::Histogram(std::vector<double> upper_bounds)
+    : upper_bounds_(std::move(upper_bounds)), bucket_counts_(upper_bounds_.size() + 1, 0) {
+}
+
+void Histogram::Observe(double value) {
+  const size_t bucket = std::lower_bound(upper_bounds_.begin(), upper_bounds_.end(), value) - upper_bounds_.begin();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++bucket_counts_[bucket];
+  ++count_;
+  sum_ += value;
+}
+
+void Histogram::Write(std::ostream& out, const std::string& name, const std::string& labels) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t cumulative_count = 0;
+  for (size_t i = 0; i < bucket_counts_.size(); ++i) {
+    cumulative_count += bucket_counts_[i];
+    out << name << "_bucket{" << JoinLabels(labels, "le=\"");
+    WriteValue(out, i < upper_bounds_.size() ? upper_bounds_[i] : std::numeric_limits<double>::infinity());
+    out << "\"} " << cumulative_count << "\n";
+  }
+
+  const std::string braced_labels = labels.empty() ? "" : "{" + labels + "}";
+  out << name << "_sum" << braced_labels << " " << sum_ << "\n";
+  out << name << "_count" << braced_labels << " " << count_ << "\n";
+}
+
+ModelMetrics::ModelMetrics() : request_seconds_(kLatencyBuckets), batch_size_(kBatchSizeBuckets) {
+  for (size_t i = 0; i < static_cast<size_t>(RequestPhase::Count); ++i) {
+    phase_seconds_.push_back(std::make_unique<Histogram>(kLatencyBuckets));
+  }
+}
+
+void ModelMetrics::EndRequest(const RequestTimings& timings, std::chrono::steady_clock::duration total,
+                              bool succeeded) {
+  --in_flight_;
+  ++(succeeded ? requests_succeeded_ : requests_failed_);
+  for (size_t i = 0; i < phase_seconds_.size(); ++i) {
+    phase_seconds_[i]->Observe(timings.phases[i].count());
+  }
+  request_seconds_.Observe(std::chrono::duration<double>(total).count());
+}
+
+void ModelMetrics::Write(std::ostream& out,
+                         const std::vector<std::pair<std::string, const ModelMetrics*>>& models) {
+  out << "# HELP onnxruntime_server_requests_total Number of predict requests handled.\n"
+      << "# TYPE onnxruntime_server_requests_total counter\n";
+  for (const auto& model : models) {
+    out << "onnxruntime_server_requests_total{" << JoinLabels(model.first, "status=\"success\"") << "} "
+        << model.second->requests_succeeded_ << "\n";
+    out << "onnxruntime_server_requests_total{" << JoinLabels(model.first, "status=\"failure\"") << "} "
+        << model.second->requests_failed_ << "\n";
+  }
+
+  out << "# HELP onnxruntime_server_requests_in_flight Number of predict requests being handled.\n"
+      << "# TYPE onnxruntime_server_requests_in_flight gauge\n";
+  for (const auto& model : models) {
+    out << "onnxruntime_server_requests_in_flight{" << model.first << "} " << model.second->in_flight_ << "\n";
+  }
+
+  out << "# HELP onnxruntime_server_request_seconds Time to handle a predict request.\n"
+      << "# TYPE onnxruntime_server_request_seconds histogram\n";
+  for (const auto& model : models) {
+    model.second->request_seconds_.Write(out, "onnxruntime_server_request_seconds", model.first);
+  }
+
+  out << "# HELP onnxruntime_server_request_phase_seconds Time a predict request spent in each phase.\n"
+      << "# TYPE onnxruntime_server_request_phase_seconds histogram\n";
+  for (const auto& model : models) {
+    for (size_t i = 0; i < model.second->phase_seconds_.size(); ++i) {
+      model.second->phase_seconds_[i]->Write(out, "onnxruntime_server_request_phase_seconds",
+                                             JoinLabels(model.first, std::string("phase=\"") + kPhaseNames[i] + "\""));
+    }
+  }
+
+  out << "# HELP onnxruntime_server_batch_size Number of rows of each session run.\n"
+      << "# TYPE onnxruntime_server_batch_size histogram\n";
+  for (const auto& model : models) {
+    model.second->batch_size_.Write(out, "onnxruntime_server_batch_size", model.first);
+  }
+
+  out << "# HELP onnxruntime_server_arena_bytes_in_use Bytes in use in the arenas of the session.\n"
+      << "# TYPE onnxruntime_server_arena_bytes_in_use gauge\n";
+  for (const auto& model : models) {
+    out << "onnxruntime_server_arena_bytes_in_use{" << model.first << "} " << model.second->arena_bytes_in_use_
+        << "\n";
+  }
+
+  out << "# HELP onnxruntime_server_arena_max_bytes_in_use Peak bytes in use in the arenas of the session.\n"
+      << "# TYPE onnxruntime_server_arena_max_bytes_in_use gauge\n";
+  for (const auto& model : models) {
+    out << "onnxruntime_server_arena_max_bytes_in_use{" << model.first << "} "
+        << model.second->arena_max_bytes_in_use_ << "\n";
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
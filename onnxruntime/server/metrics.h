@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+namespace server {
+
+// A histogram with cumulative buckets, written in the Prometheus text exposition format.
+class Histogram {
+ public:
+  explicit Histogram(std::vector<double> upper_bounds);
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void Observe(double value);
+
+  // Writes the _bucket, _sum and _count samples of name. labels are the other labels of the samples, if any.
+  void Write(std::ostream& out, const std::string& name, const std::string& labels) const;
+
+ private:
+  const std::vector<double> upper_bounds_;
+  mutable std::mutex mutex_;
+  // the observations in each bucket only, the last one being +Inf
+  std::vector<uint64_t> bucket_counts_;
+  uint64_t count_ = 0;
+  double sum_ = 0;
+};
+
+enum class RequestPhase {
+  Parse,      // deserializing the request and converting its tensors
+  Queue,      // waiting in the batcher
+  Inference,  // the Session::Run the request is part of
+  Serialize,  // converting the outputs and serializing the response
+  Count
+};
+
+// The time a request spent in each phase, filled in as it's handled.
+struct RequestTimings {
+  std::chrono::duration<double> phases[static_cast<size_t>(RequestPhase::Count)]{};
+
+  void Add(RequestPhase phase, std::chrono::steady_clock::duration duration) {
+    phases[static_cast<size_t>(phase)] += duration;
+  }
+};
+
+// The metrics of one model version, shared by the HTTP and GRPC frontends.
+class ModelMetrics {
+ public:
+  ModelMetrics();
+  ModelMetrics(const ModelMetrics&) = delete;
+  ModelMetrics& operator=(const ModelMetrics&) = delete;
+
+  void StartRequest() { ++in_flight_; }
+  void EndRequest(const RequestTimings& timings, std::chrono::steady_clock::duration total, bool succeeded);
+
+  // the number of rows of a Session::Run
+  void ObserveBatchSize(int64_t rows) { batch_size_.Observe(static_cast<double>(rows)); }
+
+  // set before writing the metrics
+  void SetArenaUsage(size_t bytes_in_use, size_t max_bytes_in_use) {
+    arena_bytes_in_use_ = bytes_in_use;
+    arena_max_bytes_in_use_ = max_bytes_in_use;
+  }
+
+  // Writes the metrics of the models, each with its own labels, grouped by metric as Prometheus requires.
+  static void Write(std::ostream& out, const std::vector<std::pair<std::string, const ModelMetrics*>>& models);
+
+ private:
+  std::atomic<uint64_t> requests_succeeded_{0};
+  std::atomic<uint64_t> requests_failed_{0};
+  std::atomic<int64_t> in_flight_{0};
+  std::atomic<size_t> arena_bytes_in_use_{0};
+  std::atomic<size_t> arena_max_bytes_in_use_{0};
+  Histogram request_seconds_;
+  std::vector<std::unique_ptr<Histogram>> phase_seconds_;
+  Histogram batch_size_;
+};
+
+// Tracks one request from its arrival, so it's counted as in flight until it's done.
+class RequestMetricsScope {
+ public:
+  explicit RequestMetricsScope(ModelMetrics* metrics)
+      : metrics_(metrics), start_(std::chrono::steady_clock::now()) {
+    if (metrics_ != nullptr) metrics_->StartRequest();
+  }
+  ~RequestMetricsScope() {
+    if (metrics_ != nullptr) metrics_->EndRequest(timings, std::chrono::steady_clock::now() - start_, succeeded);
+  }
+  RequestMetricsScope(const RequestMetricsScope&) = delete;
+  RequestMetricsScope& operator=(const RequestMetricsScope&) = delete;
+
+  RequestTimings timings;
+  bool succeeded = false;
+
+ private:
+  ModelMetrics* metrics_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
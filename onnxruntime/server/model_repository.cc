@@ -0,0 +1,234 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "executor.h"
+#include "http/json_handling.h"
+#include "model_repository.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace fs = boost::filesystem;
+
+static const char* const kModelFileName = "model.onnx";
+static const char* const kWarmupDirectoryName = "warmup";
+
+// Version directories are named after a number small enough to be ordered as one.
+static bool IsVersion(const std::string& name) {
+  return !name.empty() && name.size() <= 18 && std::all_of(name.begin(), name.end(), ::isdigit);
+}
+
+ModelRepository::ModelRepository(ServerEnvironment& env, ModelRepositoryOptions options)
+    : env_(env), options_(std::move(options)), logger_(env.GetAppLogger()) {
+}
+
+ModelRepository::~ModelRepository() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  if (watcher_.joinable()) {
+    watcher_.join();
+  }
+}
+
+size_t ModelRepository::Poll() {
+  std::lock_guard<std::mutex> lock(poll_mutex_);
+
+  // the directory and the model modification time of each version, by version number
+  std::map<uint64_t, std::pair<std::string, std::time_t>> found;
+  boost::system::error_code ec;
+  for (fs::directory_iterator it(options_.path, ec), end; !ec && it != end; it.increment(ec)) {
+    const auto name = it->path().filename().string();
+    const auto model_file = it->path() / kModelFileName;
+    boost::system::error_code file_ec;
+    if (!IsVersion(name) || !fs::is_regular_file(model_file, file_ec)) {
+      continue;
+    }
+
+    const auto modified = fs::last_write_time(model_file, file_ec);
+    if (!file_ec) {
+      found[std::stoull(name)] = std::make_pair(it->path().string(), modified);
+    }
+  }
+
+  if (ec) {
+    logger_->error("Failed to scan the model repository {}: {}", options_.path, ec.message());
+    return env_.GetModelVersions(options_.model_name).size();
+  }
+
+  // load the highest versions, unless they're loaded already
+  std::set<std::string> wanted;
+  for (auto it = found.rbegin(); it != found.rend() && wanted.size() < static_cast<size_t>(options_.num_versions); ++it) {
+    const auto version = std::to_string(it->first);
+    wanted.insert(version);
+
+    auto loaded = versions_.find(version);
+    if (loaded == versions_.end() || loaded->second != it->second.second) {
+      // remembered even if it fails, so a broken model is only retried once it changes
+      versions_[version] = it->second.second;
+      LoadVersion(version, it->second.first);
+    }
+  }
+
+  for (auto it = versions_.begin(); it != versions_.end();) {
+    it = wanted.count(it->first) == 0 ? versions_.erase(it) : std::next(it);
+  }
+
+  // unload the other versions, once one of the wanted ones is served to take over their requests
+  auto served = env_.GetModelVersions(options_.model_name);
+  const bool any_wanted_served = std::any_of(served.begin(), served.end(),
+                                             [&wanted](const std::string& version) { return wanted.count(version) != 0; });
+  if (!any_wanted_served) {
+    if (!served.empty()) {
+      logger_->warn("None of the latest versions of {} could be loaded. Keeping the versions served.", options_.model_name);
+    }
+    return served.size();
+  }
+
+  size_t num_served = 0;
+  for (const auto& version : served) {
+    if (wanted.count(version) != 0) {
+      ++num_served;
+      continue;
+    }
+
+    logger_->info("Unloading version {} of {}", version, options_.model_name);
+    try {
+      env_.UnloadModel(options_.model_name, version);
+    } catch (const Ort::Exception&) {
+      // unloaded concurrently
+    }
+  }
+
+  return num_served;
+}
+
+void ModelRepository::Start() {
+  if (options_.poll_interval.count() > 0 && !watcher_.joinable()) {
+    watcher_ = std::thread(&ModelRepository::WatchLoop, this);
+  }
+}
+
+void ModelRepository::WatchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!cv_.wait_for(lock, options_.poll_interval, [this]() { return shutdown_; })) {
+    lock.unlock();
+    Poll();
+    lock.lock();
+  }
+}
+
+bool ModelRepository::LoadVersion(const std::string& version, const std::string& directory) {
+  const auto start = std::chrono::steady_clock::now();
+  logger_->info("Loading version {} of {} from {}", version, options_.model_name, directory);
+
+  std::shared_ptr<ServerEnvironment::SessionHolder> model;
+  try {
+    model = env_.LoadModel((fs::path(directory) / kModelFileName).string(), options_.model_name, version);
+  } catch (const Ort::Exception& e) {
+    logger_->error("Failed to load version {} of {}: {}", version, options_.model_name, e.what());
+    return false;
+  }
+
+  if (!WarmUp(*model, version, directory)) {
+    return false;
+  }
+
+  try {
+    env_.ServeModel(options_.model_name, version, std::move(model));
+  } catch (const Ort::Exception& e) {
+    logger_->error("Failed to serve version {} of {}: {}", version, options_.model_name, e.what());
+    return false;
+  }
+  logger_->info("Serving version {} of {}, loaded in {}ms", version, options_.model_name,
+                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+  return true;
+}
+
+bool ModelRepository::WarmUp(const ServerEnvironment::SessionHolder& model, const std::string& version,
+                             const std::string& directory) {
+  const auto warmup_directory = fs::path(directory) / kWarmupDirectoryName;
+  boost::system::error_code ec;
+  if (!fs::is_directory(warmup_directory, ec)) {
+    return true;
+  }
+
+  std::vector<fs::path> files;
+  for (fs::directory_iterator it(warmup_directory, ec), end; !ec && it != end; it.increment(ec)) {
+    const auto extension = it->path().extension().string();
+    if (extension == ".json" || extension == ".pb") {
+      files.push_back(it->path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  Executor executor(&env_, "warmup-" + options_.model_name + "-" + version);
+  for (const auto& file : files) {
+    std::ifstream stream(file.string(), std::ios::binary);
+    std::stringstream content;
+    content << stream.rdbuf();
+
+    PredictRequest request{};
+    bool parsed = false;
+    if (file.extension() == ".json") {
+      parsed = GetRequestFromJson(content.str(), request).ok();
+    } else {
+      parsed = request.ParseFromString(content.str());
+    }
+    if (!stream || !parsed) {
+      logger_->error("Invalid warmup request {} for version {} of {}", file.string(), version, options_.model_name);
+      return false;
+    }
+
+    PredictResponse response{};
+    auto status = executor.Predict(model, request, response);
+    if (!status.ok()) {
+      logger_->error("Warmup request {} failed for version {} of {}: {}", file.string(), version, options_.model_name,
+                     status.error_message());
+      return false;
+    }
+  }
+
+  if (!files.empty()) {
+    logger_->info("Warmed up version {} of {} with {} requests", version, options_.model_name, files.size());
+  }
+  return true;
+}
+
+size_t RegisterModels(ServerEnvironment& env, const std::string& path) {
+  size_t num_registered = 0;
+  boost::system::error_code ec;
+  for (fs::directory_iterator model_it(path, ec), end; !ec && model_it != end; model_it.increment(ec)) {
+    const auto model_name = model_it->path().filename().string();
+    boost::system::error_code version_ec;
+    if (!fs::is_directory(model_it->path(), version_ec)) {
+      continue;
+    }
+
+    for (fs::directory_iterator it(model_it->path(), version_ec); !version_ec && it != end; it.increment(version_ec)) {
+      const auto version = it->path().filename().string();
+      const auto model_file = it->path() / kModelFileName;
+      boost::system::error_code file_ec;
+      if (IsVersion(version) && fs::is_regular_file(model_file, file_ec)) {
+        env.RegisterModel(model_file.string(), model_name, version);
+        ++num_registered;
+      }
+    }
+  }
+
+  return num_registered;
+}
+
+}  // namespace server
+}  // namespace onnxruntime
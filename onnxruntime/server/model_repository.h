@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "environment.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct ModelRepositoryOptions {
+  // Directory with a subdirectory per version of the model, named after the version number, each with a model.onnx.
+  // The PredictRequest files of <version>/warmup, in JSON (*.json) or binary (*.pb) form, are run against the
+  // version before it's served.
+  std::string path;
+  std::string model_name = "default";
+
+  // Number of the highest versions served. The others are unloaded.
+  int num_versions = 1;
+
+  // Time between two scans of the repository. 0 scans it once only.
+  std::chrono::seconds poll_interval{30};
+};
+
+// Serves the versions of a model found in a repository directory, and keeps them up to date with it.
+// New versions, and versions whose model.onnx changes, are loaded and warmed up in the background, and then
+// replace the served versions atomically, so requests never wait for a model to load.
+class ModelRepository {
+ public:
+  ModelRepository(ServerEnvironment& env, ModelRepositoryOptions options);
+  ~ModelRepository();
+  ModelRepository(const ModelRepository&) = delete;
+  ModelRepository& operator=(const ModelRepository&) = delete;
+
+  // Scans the repository once, loading and unloading the versions, and returns the number of versions served.
+  size_t Poll();
+
+  // Starts scanning the repository every poll_interval in the background.
+  void Start();
+
+ private:
+  // Loads, warms up and serves a version. Returns false if any of it failed, in which case the version served before,
+  // if any, stays.
+  bool LoadVersion(const std::string& version, const std::string& directory);
+  bool WarmUp(const ServerEnvironment::SessionHolder& model, const std::string& version, const std::string& directory);
+  void WatchLoop();
+
+  ServerEnvironment& env_;
+  const ModelRepositoryOptions options_;
+  std::shared_ptr<spdlog::logger> logger_;
+
+  // the modification time of the model.onnx of each version that was loaded, or failed to
+  std::map<std::string, std::time_t> versions_;
+  // serializes the scans of the watcher with the ones of the caller
+  std::mutex poll_mutex_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool shutdown_ = false;
+  std::thread watcher_;
+};
+
+// Registers the versions of the models of a directory of <model name>/<version>/model.onnx, to be loaded on their
+// first request, see ServerEnvironment::RegisterModel. Returns the number of versions registered.
+size_t RegisterModels(ServerEnvironment& env, const std::string& path);
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <gsl/pointers>
 #include "core/framework/data_types.h"
@@ -424,6 +425,41 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+
+bool TensorProtoRawDataToMLValue(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info,
+                                 Ort::Value& value) {
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL ||
+      tensor_proto.data_type() == onnx::TensorProto_DataType::TensorProto_DataType_STRING) {
+    return false;
+  }
+
+  size_t size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes);
+  const auto& raw_data = tensor_proto.raw_data();
+  if (raw_data.size() != size_in_bytes) {
+    throw Ort::Exception(MakeString("UnpackTensor: the pre-allocated size does not match the raw data size, expected ",
+                                    size_in_bytes, ", got ", raw_data.size()),
+                         OrtErrorCode::ORT_FAIL);
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  size_t element_count = 1;
+  for (auto dim : tensor_shape_vec) {
+    element_count *= static_cast<size_t>(dim);
+  }
+  const size_t element_size = element_count != 0 ? size_in_bytes / element_count : 1;
+  if (reinterpret_cast<std::uintptr_t>(raw_data.data()) % element_size != 0) {
+    return false;
+  }
+
+  // The tensor is only read by the session, so it's fine to drop the const of the protobuf string.
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(),
+                                   GetTensorElementType(tensor_proto));
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
@@ -27,6 +27,15 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Create a tensor that points directly into the raw_data of a TensorProto, avoiding the copy made by
+ * TensorProtoToMLValue. The TensorProto must outlive the value.
+ * Returns false, leaving value untouched, if there is no raw_data, the host is big endian, the tensor holds strings,
+ * or the raw_data is not suitably aligned for the element type.
+ */
+bool TensorProtoRawDataToMLValue(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info,
+                                 /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
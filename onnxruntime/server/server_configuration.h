@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <thread>
 #include <fstream>
 #include <unordered_map>
 
+#include "boost/filesystem.hpp"
 #include "boost/program_options.hpp"
 #include "core/session/onnxruntime_cxx_api.h"
 
@@ -43,16 +45,44 @@ class ServerConfiguration {
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int max_batch_size = 1;
+  int batch_timeout_micros = 1000;
+  std::string repository_path;
+  std::string models_path;
+  int memory_budget_mb = 0;
+  std::string snapshot_path;
+  int num_model_versions = 1;
+  int poll_interval_seconds = 30;
+  int warmup_runs = 0;
+  int num_intra_op_threads = 0;
+  int num_inter_op_threads = 0;
+  int num_session_replicas = 1;
+  int max_threads = 0;
+  int num_grpc_workers = 0;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
     desc.add_options()("help,h", "Shows a help message and exits");
     desc.add_options()("log_level", po::value(&log_level_str)->default_value(log_level_str), "Logging level. Allowed options (case sensitive): verbose, info, warning, error, fatal");
-    desc.add_options()("model_path", po::value(&model_path)->required(), "Path to ONNX model");
+    desc.add_options()("model_path", po::value(&model_path), "Path to ONNX model");
+    desc.add_options()("repository_path", po::value(&repository_path), "Path to a model repository, served instead of model_path: a directory of <version>/model.onnx, with optional <version>/warmup/*.json or *.pb requests. New and modified versions are loaded without a restart");
+    desc.add_options()("models_path", po::value(&models_path), "Path to a directory of <model name>/<version>/model.onnx, served instead of model_path. Each version is loaded on its first request and evicted when idle to make room for others within memory_budget_mb");
+    desc.add_options()("memory_budget_mb", po::value(&memory_budget_mb)->default_value(memory_budget_mb), "Maximum memory in MB of the models of models_path loaded together, counting their files and the peak of their arenas. 0 for no limit");
+    desc.add_options()("snapshot_path", po::value(&snapshot_path), "Directory the models are saved to once optimized, and loaded from afterwards, which skips the graph optimizations when a model is reloaded");
+    desc.add_options()("num_model_versions", po::value(&num_model_versions)->default_value(num_model_versions), "Number of the highest versions of the model repository served");
+    desc.add_options()("poll_interval_seconds", po::value(&poll_interval_seconds)->default_value(poll_interval_seconds), "Time in seconds between two scans of the model repository. 0 only loads it at startup");
     desc.add_options()("address", po::value(&address)->default_value(address), "The base HTTP address");
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("num_grpc_workers", po::value(&num_grpc_workers)->default_value(num_grpc_workers), "Number of threads running the inference of the GRPC calls. 0 runs as many as the intra op thread pools fill the cores with, times max_batch_size so batches can fill up");
+    desc.add_options()("num_intra_op_threads", po::value(&num_intra_op_threads)->default_value(num_intra_op_threads), "Number of threads of the intra op thread pool of each session. 0 uses one per core");
+    desc.add_options()("num_inter_op_threads", po::value(&num_inter_op_threads)->default_value(num_inter_op_threads), "Number of threads of the inter op thread pool of each session, which runs independent nodes in parallel. 0 runs the nodes sequentially");
+    desc.add_options()("num_session_replicas", po::value(&num_session_replicas)->default_value(num_session_replicas), "Number of sessions of each model, each with its own thread pools. Requests go to the least loaded one");
+    desc.add_options()("max_threads", po::value(&max_threads)->default_value(max_threads), "Maximum number of http threads plus the threads of the sessions. By default num_intra_op_threads then shares the rest with the replicas. 0 for no limit");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum number of rows batched into one run across concurrent requests. 1 disables batching");
+    desc.add_options()("warmup_runs", po::value(&warmup_runs)->default_value(warmup_runs), "Number of runs with generated inputs when a model is loaded, so the first requests don't pay for the arena growth and the kernel algorithm search");
+    desc.add_options()("batch_timeout_micros", po::value(&batch_timeout_micros)->default_value(batch_timeout_micros), "Maximum time in microseconds a request waits for others to be batched with");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -85,6 +115,32 @@ class ServerConfiguration {
     return result;
   }
 
+  // The number of GRPC workers, num_grpc_workers or the one derived from the thread pools.
+  int GrpcWorkerCount() const {
+    if (num_grpc_workers > 0) {
+      return num_grpc_workers;
+    }
+
+    const int num_cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int intra_op_threads = IntraOpThreadCount() > 0 ? IntraOpThreadCount() : num_cores;
+    return std::max(num_session_replicas, num_cores / intra_op_threads) * max_batch_size;
+  }
+
+  // The number of intra op threads of each session, num_intra_op_threads or the share of each replica of the
+  // threads left by max_threads. 0 for one thread per core.
+  int IntraOpThreadCount() const {
+    if (num_intra_op_threads > 0 || max_threads <= 0) {
+      return num_intra_op_threads;
+    }
+
+    return std::max(1, (max_threads - num_http_threads) / num_session_replicas - num_inter_op_threads);
+  }
+
+  // The number of threads left to the sessions of the models by max_threads, 0 for no limit.
+  int ModelThreadBudget() const {
+    return max_threads > 0 ? max_threads - num_http_threads : 0;
+  }
+
  private:
   po::options_description desc{"Allowed options"};
   po::variables_map vm{};
@@ -99,9 +155,58 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
-    } else if (!file_exists(model_path)) {
+    } else if (max_batch_size <= 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than 0");
+      return Result::ExitFailure;
+    } else if (batch_timeout_micros < 0) {
+      PrintHelp(std::cerr, "batch_timeout_micros must not be negative");
+      return Result::ExitFailure;
+    } else if (model_path.empty() + repository_path.empty() + models_path.empty() != 2) {
+      PrintHelp(std::cerr, "Exactly one of model_path, repository_path and models_path is required");
+      return Result::ExitFailure;
+    } else if (!model_path.empty() && !file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
+    } else if (!repository_path.empty() && !boost::filesystem::is_directory(repository_path)) {
+      PrintHelp(std::cerr, "repository_path must be the location of a directory");
+      return Result::ExitFailure;
+    } else if (!models_path.empty() && !boost::filesystem::is_directory(models_path)) {
+      PrintHelp(std::cerr, "models_path must be the location of a directory");
+      return Result::ExitFailure;
+    } else if (memory_budget_mb < 0) {
+      PrintHelp(std::cerr, "memory_budget_mb must not be negative");
+      return Result::ExitFailure;
+    } else if (!snapshot_path.empty() && !boost::filesystem::is_directory(snapshot_path)) {
+      PrintHelp(std::cerr, "snapshot_path must be the location of a directory");
+      return Result::ExitFailure;
+    } else if (num_model_versions <= 0) {
+      PrintHelp(std::cerr, "num_model_versions must be greater than 0");
+      return Result::ExitFailure;
+    } else if (warmup_runs < 0) {
+      PrintHelp(std::cerr, "warmup_runs must not be negative");
+      return Result::ExitFailure;
+    } else if (num_intra_op_threads < 0) {
+      PrintHelp(std::cerr, "num_intra_op_threads must not be negative");
+      return Result::ExitFailure;
+    } else if (num_inter_op_threads < 0) {
+      PrintHelp(std::cerr, "num_inter_op_threads must not be negative");
+      return Result::ExitFailure;
+    } else if (num_session_replicas <= 0) {
+      PrintHelp(std::cerr, "num_session_replicas must be greater than 0");
+      return Result::ExitFailure;
+    } else if (max_threads < 0) {
+      PrintHelp(std::cerr, "max_threads must not be negative");
+      return Result::ExitFailure;
+    } else if (max_threads > 0 && max_threads < num_http_threads +
+                                                     num_session_replicas * (IntraOpThreadCount() + num_inter_op_threads)) {
+      PrintHelp(std::cerr, "num_http_threads and the threads of the session replicas exceed max_threads");
+      return Result::ExitFailure;
+    } else if (num_grpc_workers < 0) {
+      PrintHelp(std::cerr, "num_grpc_workers must not be negative");
+      return Result::ExitFailure;
+    } else if (poll_interval_seconds < 0) {
+      PrintHelp(std::cerr, "poll_interval_seconds must not be negative");
+      return Result::ExitFailure;
     } else {
       return Result::ContinueSuccess;
     }
@@ -92,6 +92,29 @@ TEST(DateTimeTransformer, Future_2025_June_30) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(DateTimeBatchTransformer, MatchesTimePoints) {
+  const std::vector<int64_t> dates{217081624, 217081625, 1751241600, 0};
+
+  OpTester test("DateTimeBatchTransformer", 1, onnxruntime::kMSAutoMLDomain);
+  test.AddInput<int64_t>("X", {2, 2}, dates);
+
+  std::vector<int32_t> expected;
+  for (auto date : dates) {
+    dft::TimePoint tp(SysClock::from_time_t(date));
+    expected.insert(expected.end(), {tp.year, tp.month, tp.day, tp.hour, tp.minute, tp.second, tp.dayOfWeek,
+                                     tp.dayOfYear, tp.quarterOfYear, tp.weekOfMonth});
+  }
+
+  test.AddOutput<int32_t>("Y", {2, 2, 10}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(DateTimeBatchTransformer, DatesBefore1970) {
+  OpTester test("DateTimeBatchTransformer", 1, onnxruntime::kMSAutoMLDomain);
+  test.AddInput<int64_t>("X", {2}, {217081624, -1});
+  test.AddOutput<int32_t>("Y", {2, 10}, std::vector<int32_t>(20));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Dates prior to 1970 are not supported.");
+}
 
 }  // namespace test
 }  // namespace onnxruntime
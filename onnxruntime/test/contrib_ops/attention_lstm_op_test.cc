@@ -63,7 +63,9 @@ static void RunAttnLstmTest(
     // copy the following vectors as we may modify them
     std::vector<std::string> activations = {},
     std::vector<float> activation_alphas = {},
-    std::vector<float> activation_betas = {}) {
+    std::vector<float> activation_betas = {},
+    // add the weights as initializers, which the kernel packs when it's created
+    bool weights_are_initializers = false) {
   const int64_t input_size = x_depth + aw_attn_size;
 
   OpTester test("AttnLSTM", 1, onnxruntime::kMSDomain);
@@ -96,8 +98,8 @@ static void RunAttnLstmTest(
   std::vector<int64_t> R_dims = {num_directions, 4 * hidden_size, hidden_size};
 
   test.AddInput<float>("X", X_dims, X_data);
-  test.AddInput<float>("W", W_dims, W_data);
-  test.AddInput<float>("R", R_dims, R_data);
+  test.AddInput<float>("W", W_dims, W_data, weights_are_initializers);
+  test.AddInput<float>("R", R_dims, R_data, weights_are_initializers);
 
   if (B_data) {
     std::vector<int64_t> B_dims = {num_directions, 8 * hidden_size};
@@ -135,10 +137,10 @@ static void RunAttnLstmTest(
   }
 
   std::vector<int64_t> QW_dims{num_directions, hidden_size, am_attn_size};
-  test.AddInput<float>("QW", QW_dims, QW_data);
+  test.AddInput<float>("QW", QW_dims, QW_data, weights_are_initializers);
 
   std::vector<int64_t> MW_dims{num_directions, memory_depth, am_attn_size};
-  test.AddInput<float>("MW", MW_dims, MW_data);
+  test.AddInput<float>("MW", MW_dims, MW_data, weights_are_initializers);
 
   std::vector<int64_t> attn_v_dims{num_directions, am_attn_size};
   test.AddInput<float>("V", attn_v_dims, attn_v_data);
@@ -155,7 +157,7 @@ static void RunAttnLstmTest(
 
   if (attn_layer_weights) {
     std::vector<int64_t> attn_layer_weight_dims{num_directions, memory_depth + hidden_size, aw_attn_size};
-    test.AddInput<float>("AW", attn_layer_weight_dims, *attn_layer_weights);
+    test.AddInput<float>("AW", attn_layer_weight_dims, *attn_layer_weights, weights_are_initializers);
   } else {
     test.AddMissingOptionalInput<int>();
   }
@@ -528,7 +530,7 @@ TEST(AttnLSTMTest, BidirectionLstmWithBahdanauAMShortenSeqLength) {
       "bidirectional", -9999.f, true, false);
 }
 
-TEST(AttnLSTMTest, BidirectionLstmWithBahdanauAM2BatchShortenSeqLen) {
+static void RunBidirectionLstmWithBahdanauAM2BatchShortenSeqLen(bool weights_are_initializers) {
   const int batch2Size = 2;
   const int inputMaxStep4 = 4;
 
@@ -582,7 +584,15 @@ TEST(AttnLSTMTest, BidirectionLstmWithBahdanauAM2BatchShortenSeqLen) {
       input_only_depth, batch2Size, cell_hidden_size, inputMaxStep4,
       memory_max_step, memory_depth, am_attn_size, aw_attn_size,
       &d_B_data, nullptr, nullptr, nullptr, &s_seq_lengths_2batch,
-      "bidirectional", -9999.f, true, false);
+      "bidirectional", -9999.f, true, false, {}, {}, {}, weights_are_initializers);
+}
+
+TEST(AttnLSTMTest, BidirectionLstmWithBahdanauAM2BatchShortenSeqLen) {
+  RunBidirectionLstmWithBahdanauAM2BatchShortenSeqLen(false);
+}
+
+TEST(AttnLSTMTest, BidirectionLstmWithBahdanauAM2BatchShortenSeqLenPackedWeights) {
+  RunBidirectionLstmWithBahdanauAM2BatchShortenSeqLen(true);
 }
 
 }  // namespace test
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Unfused multi-head attention, as computed by the exported subgraph.
+static std::vector<float> ComputeAttention(const std::vector<float>& input, const std::vector<float>& weights,
+                                           const std::vector<float>& bias, const std::vector<float>& mask,
+                                           int batch_size, int sequence_length, int hidden_size, int num_heads) {
+  const int head_size = hidden_size / num_heads;
+  const int m = batch_size * sequence_length;
+  const int n = 3 * hidden_size;
+
+  std::vector<float> qkv(m * n);
+  for (int r = 0; r < m; ++r) {
+    for (int c = 0; c < n; ++c) {
+      float sum = bias[c];
+      for (int i = 0; i < hidden_size; ++i) {
+        sum += input[r * hidden_size + i] * weights[i * n + c];
+      }
+      qkv[r * n + c] = sum;
+    }
+  }
+
+  std::vector<float> output(m * hidden_size);
+  std::vector<float> scores(sequence_length);
+  for (int b = 0; b < batch_size; ++b) {
+    for (int h = 0; h < num_heads; ++h) {
+      for (int i = 0; i < sequence_length; ++i) {
+        const float* q = &qkv[(b * sequence_length + i) * n + h * head_size];
+        float max_score = -INFINITY;
+        for (int j = 0; j < sequence_length; ++j) {
+          const float* k = &qkv[(b * sequence_length + j) * n + hidden_size + h * head_size];
+          float dot = 0.0f;
+          for (int d = 0; d < head_size; ++d) {
+            dot += q[d] * k[d];
+          }
+          scores[j] = dot / std::sqrt(static_cast<float>(head_size));
+          if (!mask.empty()) {
+            scores[j] += mask[b * sequence_length + j];
+          }
+          max_score = std::max(max_score, scores[j]);
+        }
+
+        float sum = 0.0f;
+        for (int j = 0; j < sequence_length; ++j) {
+          scores[j] = std::exp(scores[j] - max_score);
+          sum += scores[j];
+        }
+
+        for (int d = 0; d < head_size; ++d) {
+          float value = 0.0f;
+          for (int j = 0; j < sequence_length; ++j) {
+            value += scores[j] / sum * qkv[(b * sequence_length + j) * n + 2 * hidden_size + h * head_size + d];
+          }
+          output[(b * sequence_length + i) * hidden_size + h * head_size + d] = value;
+        }
+      }
+    }
+  }
+
+  return output;
+}
+
+static std::vector<float> GenerateValues(size_t count, float scale) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = scale * static_cast<float>(static_cast<int>((i * 7 + 3) % 11) - 5);
+  }
+  return values;
+}
+
+static void RunAttentionTest(int batch_size, int sequence_length, int hidden_size, int num_heads, bool use_mask) {
+  const std::vector<float> input = GenerateValues(batch_size * sequence_length * hidden_size, 0.1f);
+  const std::vector<float> weights = GenerateValues(hidden_size * 3 * hidden_size, 0.05f);
+  const std::vector<float> bias = GenerateValues(3 * hidden_size, 0.02f);
+  std::vector<float> mask;
+  if (use_mask) {
+    // mask out the last token of the first batch
+    mask.resize(batch_size * sequence_length, 0.0f);
+    mask[sequence_length - 1] = -10000.0f;
+  }
+
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input);
+  test.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weights);
+  test.AddInput<float>("bias", {3 * hidden_size}, bias);
+  if (use_mask) {
+    test.AddInput<float>("mask", {batch_size, 1, 1, sequence_length}, mask);
+  }
+  test.AddOutput<float>("output", {batch_size, sequence_length, hidden_size},
+                        ComputeAttention(input, weights, bias, mask, batch_size, sequence_length, hidden_size,
+                                         num_heads));
+  test.Run();
+}
+
+TEST(AttentionTest, SingleHead) {
+  RunAttentionTest(1, 3, 4, 1, false);
+}
+
+TEST(AttentionTest, MultipleHeads) {
+  RunAttentionTest(2, 5, 8, 4, false);
+}
+
+TEST(AttentionTest, MultipleHeadsWithMask) {
+  RunAttentionTest(2, 5, 8, 2, true);
+}
+
+TEST(AttentionTest, InvalidHeads) {
+  OpTester test("Attention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", 3);
+  test.AddInput<float>("input", {1, 2, 4}, GenerateValues(8, 0.1f));
+  test.AddInput<float>("weight", {4, 12}, GenerateValues(48, 0.1f));
+  test.AddInput<float>("bias", {12}, GenerateValues(12, 0.1f));
+  test.AddOutput<float>("output", {1, 2, 4}, std::vector<float>(8));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is not a multiple of num_heads");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "test/providers/provider_test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+static const int64_t kEos = 3;
+
+// The probabilities of the next token given the last one. Greedy search takes 0 -> 1 -> eos with 0.5 * 0.3,
+// while beam search finds 0 -> 2 -> eos with 0.4 * 0.9.
+static std::vector<float> NextTokenLogProbs() {
+  const std::vector<float> probs{0.05f, 0.5f, 0.4f, 0.05f,
+                                 0.7f / 3, 0.7f / 3, 0.7f / 3, 0.3f,
+                                 0.1f / 3, 0.1f / 3, 0.1f / 3, 0.9f,
+                                 0.25f, 0.25f, 0.25f, 0.25f};
+  std::vector<float> log_probs;
+  for (auto p : probs) {
+    log_probs.push_back(std::log(p));
+  }
+  return log_probs;
+}
+
+// logits = Gather(log_probs, input_ids). with_state adds a past state collecting the tokens fed to the decoder.
+static GraphProto CreateDecoder(bool with_state) {
+  Model model("BeamSearch decoder");
+  auto& graph = model.MainGraph();
+
+  TypeProto int64_matrix;
+  int64_matrix.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_matrix.mutable_tensor_type()->mutable_shape()->add_dim();
+  int64_matrix.mutable_tensor_type()->mutable_shape()->add_dim();
+
+  TypeProto float_logits;
+  float_logits.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& input_ids = graph.GetOrCreateNodeArg("input_ids", &int64_matrix);
+  auto& log_probs = graph.GetOrCreateNodeArg("log_probs", nullptr);
+  auto& logits = graph.GetOrCreateNodeArg("logits", &float_logits);
+
+  TensorProto log_probs_proto;
+  log_probs_proto.set_name("log_probs");
+  log_probs_proto.add_dims(4);
+  log_probs_proto.add_dims(4);
+  log_probs_proto.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto value : NextTokenLogProbs()) {
+    log_probs_proto.add_float_data(value);
+  }
+  graph.AddInitializedTensor(log_probs_proto);
+
+  graph.AddNode("gather", "Gather", "logits of the next token", {&log_probs, &input_ids}, {&logits});
+
+  if (with_state) {
+    auto& past = graph.GetOrCreateNodeArg("past", &int64_matrix);
+    auto& present = graph.GetOrCreateNodeArg("present", &int64_matrix);
+    auto& concat = graph.AddNode("concat", "Concat", "present = past + input_ids", {&past, &input_ids}, {&present});
+    concat.AddAttribute("axis", int64_t{1});
+
+    graph.SetInputs({&input_ids, &past});
+    graph.SetOutputs({&logits, &present});
+  } else {
+    graph.SetInputs({&input_ids});
+    graph.SetOutputs({&logits});
+  }
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  return graph.ToGraphProto();
+}
+
+TEST(BeamSearchTest, GreedySearch) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("decoder", CreateDecoder(true));
+  test.AddAttribute<int64_t>("eos_token_id", kEos);
+  test.AddAttribute<int64_t>("pad_token_id", 0);
+
+  test.AddInput<int64_t>("input_ids", {2, 1}, {0, 2});
+  test.AddInput<int64_t>("max_length", {}, {5});
+  test.AddInput<int64_t>("initial_states", {2, 1}, {0, 0});
+
+  // the second sequence ends right away and is padded
+  test.AddOutput<int64_t>("sequences", {2, 3}, {0, 1, kEos,
+                                                2, kEos, 0});
+  test.AddOutput<float>("sequences_scores", {2},
+                        {std::log(0.5f * 0.3f) / 3, std::log(0.9f) / 2});
+  test.Run();
+}
+
+TEST(BeamSearchTest, BeamSearch) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("decoder", CreateDecoder(false));
+  test.AddAttribute<int64_t>("eos_token_id", kEos);
+  test.AddAttribute<int64_t>("num_beams", 2);
+
+  test.AddInput<int64_t>("input_ids", {1, 1}, {0});
+  test.AddInput<int64_t>("max_length", {}, {5});
+
+  test.AddOutput<int64_t>("sequences", {1, 3}, {0, 2, kEos});
+  test.AddOutput<float>("sequences_scores", {1}, {std::log(0.4f * 0.9f) / 3});
+  test.Run();
+}
+
+TEST(BeamSearchTest, MaxLength) {
+  OpTester test("BeamSearch", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("decoder", CreateDecoder(false));
+  test.AddAttribute<int64_t>("eos_token_id", kEos);
+  test.AddAttribute<int64_t>("num_beams", 2);
+
+  // the sequences are cut at max_length before reaching eos
+  test.AddInput<int64_t>("input_ids", {1, 1}, {0});
+  test.AddInput<int64_t>("max_length", {}, {2});
+
+  test.AddOutput<int64_t>("sequences", {1, 2}, {0, 1});
+  test.AddOutput<float>("sequences_scores", {1}, {std::log(0.5f) / 2});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+template <typename T>
+static std::vector<T> RandomMatrix(int64_t rows, int64_t columns, uint32_t seed) {
+  std::default_random_engine generator(seed);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  std::vector<T> data(static_cast<size_t>(rows * columns));
+  for (auto& value : data) {
+    value = static_cast<T>(distribution(generator));
+  }
+  return data;
+}
+
+template <typename T>
+static std::vector<T> ReferenceCDist(const std::vector<T>& a, const std::vector<T>& b, int64_t ma, int64_t mb,
+                                     int64_t n, bool euclidean) {
+  std::vector<T> dest(static_cast<size_t>(ma * mb));
+  for (int64_t i = 0; i < ma; ++i) {
+    for (int64_t j = 0; j < mb; ++j) {
+      double sum = 0;
+      for (int64_t k = 0; k < n; ++k) {
+        const double t = static_cast<double>(a[i * n + k]) - static_cast<double>(b[j * n + k]);
+        sum += t * t;
+      }
+      dest[i * mb + j] = static_cast<T>(euclidean ? std::sqrt(sum) : sum);
+    }
+  }
+  return dest;
+}
+
+template <typename T>
+static void RunCDistTest(int64_t ma, int64_t mb, int64_t n, const std::string& metric) {
+  std::vector<T> a = RandomMatrix<T>(ma, n, 1);
+  std::vector<T> b = RandomMatrix<T>(mb, n, 2);
+
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", metric);
+  test.AddInput<T>("A", {ma, n}, a);
+  test.AddInput<T>("B", {mb, n}, b);
+  test.AddOutput<T>("C", {ma, mb}, ReferenceCDist(a, b, ma, mb, n, metric == "euclidean"));
+  test.Run();
+}
+
+TEST(CDistOpTest, SqeuclideanSmallVectors) {
+  RunCDistTest<float>(3, 4, 3, "sqeuclidean");
+}
+
+TEST(CDistOpTest, SqeuclideanGemm) {
+  RunCDistTest<float>(17, 33, 24, "sqeuclidean");
+}
+
+TEST(CDistOpTest, EuclideanGemm) {
+  RunCDistTest<float>(9, 21, 16, "euclidean");
+  RunCDistTest<double>(9, 21, 16, "euclidean");
+}
+
+TEST(CDistOpTest, EuclideanIdenticalRows) {
+  // the GEMM formulation must not produce a negative distance, or NaN after the square root, for equal vectors
+  std::vector<float> a = RandomMatrix<float>(2, 32, 3);
+
+  OpTester test("CDist", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", std::string("euclidean"));
+  test.AddInput<float>("A", {2, 32}, a);
+  test.AddInput<float>("B", {2, 32}, a);
+  test.AddOutput<float>("C", {2, 2}, ReferenceCDist(a, a, 2, 2, 32, true));
+  test.Run();
+}
+
+template <typename T>
+static void RunCDistTopKTest(int64_t ma, int64_t mb, int64_t n, int64_t k, const std::string& metric) {
+  std::vector<T> a = RandomMatrix<T>(ma, n, 4);
+  std::vector<T> b = RandomMatrix<T>(mb, n, 5);
+  std::vector<T> distances = ReferenceCDist(a, b, ma, mb, n, metric == "euclidean");
+
+  std::vector<T> expected_values;
+  std::vector<int64_t> expected_indices;
+  for (int64_t i = 0; i < ma; ++i) {
+    std::vector<int64_t> order(static_cast<size_t>(mb));
+    std::iota(order.begin(), order.end(), 0);
+    const T* row = distances.data() + i * mb;
+    std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                      [row](int64_t x, int64_t y) { return row[x] < row[y] || (row[x] == row[y] && x < y); });
+    for (int64_t j = 0; j < k; ++j) {
+      expected_values.push_back(row[order[j]]);
+      expected_indices.push_back(order[j]);
+    }
+  }
+
+  OpTester test("CDistTopK", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("metric", metric);
+  test.AddAttribute("k", k);
+  test.AddInput<T>("A", {ma, n}, a);
+  test.AddInput<T>("B", {mb, n}, b);
+  test.AddOutput<T>("Values", {ma, k}, expected_values);
+  test.AddOutput<int64_t>("Indices", {ma, k}, expected_indices);
+  test.Run();
+}
+
+TEST(CDistTopKOpTest, Sqeuclidean) {
+  RunCDistTopKTest<float>(5, 50, 8, 4, "sqeuclidean");
+}
+
+TEST(CDistTopKOpTest, EuclideanMultipleBlocks) {
+  // more rows of A and B than fit in one block of the kernel
+  RunCDistTopKTest<float>(40, 1500, 6, 3, "euclidean");
+  RunCDistTopKTest<double>(40, 1500, 6, 3, "euclidean");
+}
+
+TEST(CDistTopKOpTest, KGreaterThanRows) {
+  OpTester test("CDistTopK", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("k", int64_t(3));
+  test.AddInput<float>("A", {1, 2}, {0.f, 0.f});
+  test.AddInput<float>("B", {2, 2}, {1.f, 1.f, 2.f, 2.f});
+  test.AddOutput<float>("Values", {1, 3}, {0.f, 0.f, 0.f});
+  test.AddOutput<int64_t>("Indices", {1, 3}, {0, 0, 0});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "should not be greater than the number of rows of B");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -100,5 +100,27 @@ TEST(CropAndResizeTest, CropAndResize_1133) {
 
 
 
+TEST(CropAndResizeTest, CropAndResize_MultipleChannelsExtrapolation) {
+  // the second box extends past the right of the image, so its last column is extrapolated
+  const std::vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                                10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f, 17.0f, 18.0f};
+  std::vector<float> expected(X);
+  const std::vector<float> extrapolated = {1.0f, 3.0f, 0.5f, 4.0f, 6.0f, 0.5f, 7.0f, 9.0f, 0.5f,
+                                           10.0f, 12.0f, 0.5f, 13.0f, 15.0f, 0.5f, 16.0f, 18.0f, 0.5f};
+  expected.insert(expected.end(), extrapolated.begin(), extrapolated.end());
+
+  for (const char* mode : {"bilinear", "nearest"}) {
+    OpTester test("CropAndResize", 1, onnxruntime::kMSDomain);
+    test.AddInput<float>("X", {1, 2, 3, 3}, X);
+    test.AddInput<float>("rois", {2, 4}, {0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 2.0f});
+    test.AddInput<int32_t>("batch_indices", {2}, {0, 0});
+    test.AddInput<int32_t>("crop_size", {2}, {3, 3});
+    test.AddAttribute("mode", mode);
+    test.AddAttribute("extrapolation_value", 0.5f);
+    test.AddOutput<float>("output", {2, 2, 3, 3}, expected);
+    test.Run();
+  }
+}
+
 }  // namespace Test
 }  // namespace onnxruntime
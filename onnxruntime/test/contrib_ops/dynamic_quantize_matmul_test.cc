@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// The product computed by DynamicQuantizeLinear -> MatMulInteger -> Cast -> Mul -> Add.
+static std::vector<float> DynamicQuantizeMatMulReference(const std::vector<float>& a, const std::vector<uint8_t>& b,
+                                                         float b_scale, uint8_t b_zero_point,
+                                                         const std::vector<float>& bias,
+                                                         int64_t M, int64_t K, int64_t N) {
+  float a_min = std::min(0.f, *std::min_element(a.begin(), a.end()));
+  float a_max = std::max(0.f, *std::max_element(a.begin(), a.end()));
+  const float a_scale = (a_max - a_min) / 255.f;
+  const float a_zero_point = std::nearbyint(std::max(0.f, std::min(255.f, -a_min / a_scale)));
+
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      int32_t sum = 0;
+      for (int64_t k = 0; k < K; ++k) {
+        const float a_q = std::max(0.f, std::min(255.f, std::nearbyint(a[m * K + k] / a_scale) + a_zero_point));
+        sum += (static_cast<int32_t>(a_q) - static_cast<int32_t>(a_zero_point)) *
+               (static_cast<int32_t>(b[k * N + n]) - b_zero_point);
+      }
+      y[m * N + n] = static_cast<float>(sum) * (a_scale * b_scale) + (bias.empty() ? 0.f : bias[n]);
+    }
+  }
+  return y;
+}
+
+TEST(DynamicQuantizeMatMulTest, Basic) {
+  const std::vector<float> a = {-1.f, 0.5f, 2.f, 3.f, -0.25f, 1.f};
+  const std::vector<uint8_t> b = {10, 200, 128, 0, 255, 64};
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, a);
+  test.AddInput<uint8_t>("B", {3, 2}, b);
+  test.AddInput<float>("b_scale", {}, {0.02f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {128});
+  test.AddOutput<float>("Y", {2, 2}, DynamicQuantizeMatMulReference(a, b, 0.02f, 128, {}, 2, 3, 2));
+  test.Run();
+}
+
+TEST(DynamicQuantizeMatMulTest, BiasWithoutZeroPoint) {
+  // more columns of A than a packed block, with a batch of two matrices
+  constexpr int64_t M = 5;
+  constexpr int64_t K = 150;
+  constexpr int64_t N = 20;
+  std::vector<float> a(2 * M * K);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(i % 13) * 0.25f - 1.f;
+  }
+  std::vector<uint8_t> b(K * N);
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<uint8_t>((i * 7) % 256);
+  }
+  std::vector<float> bias(N);
+  for (size_t i = 0; i < bias.size(); ++i) {
+    bias[i] = static_cast<float>(i) - 10.f;
+  }
+
+  // the matrices of the batch share the scale of the whole A
+  auto expected = DynamicQuantizeMatMulReference(a, b, 0.01f, 0, bias, 2 * M, K, N);
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, M, K}, a);
+  test.AddInput<uint8_t>("B", {K, N}, b);
+  test.AddInput<float>("b_scale", {1}, {0.01f});
+  test.AddMissingOptionalInput<uint8_t>();
+  test.AddInput<float>("bias", {N}, bias);
+  test.AddOutput<float>("Y", {2, M, N}, expected);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
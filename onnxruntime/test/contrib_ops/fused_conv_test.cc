@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// 3x3 input with the values 1 to 9, and two 2x2 filters of ones and minus ones
+static void AddConvInputs(OpTester& test, bool with_bias) {
+  test.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  test.AddInput<float>("X", {1, 1, 3, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f});
+  test.AddInput<float>("W", {2, 1, 2, 2}, {1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f});
+  if (with_bias) {
+    test.AddInput<float>("B", {2}, {1.0f, 2.0f});
+  }
+}
+
+TEST(FusedConvTest, BiasRelu) {
+  OpTester test("FusedConv", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("activation", "Relu");
+  AddConvInputs(test, true);
+  test.AddOutput<float>("Y", {1, 2, 2, 2}, {13.0f, 17.0f, 25.0f, 29.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedConvTest, BiasLeakyRelu) {
+  OpTester test("FusedConv", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("activation", "LeakyRelu");
+  test.AddAttribute("activation_params", std::vector<float>{0.1f});
+  AddConvInputs(test, true);
+  test.AddOutput<float>("Y", {1, 2, 2, 2}, {13.0f, 17.0f, 25.0f, 29.0f, -1.0f, -1.4f, -2.2f, -2.6f});
+  test.Run();
+}
+
+TEST(FusedConvTest, Clip) {
+  OpTester test("FusedConv", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("activation", "Clip");
+  test.AddAttribute("activation_params", std::vector<float>{-20.0f, 20.0f});
+  AddConvInputs(test, false);
+  test.AddOutput<float>("Y", {1, 2, 2, 2}, {12.0f, 16.0f, 20.0f, 20.0f, -12.0f, -16.0f, -20.0f, -20.0f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<float> MakeInput(int64_t size, float offset) {
+  std::vector<float> data(size);
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>(i % 7) - offset;
+  }
+  return data;
+}
+
+TEST(FusedElementwiseTest, BinaryChainWithBroadcast) {
+  // larger than one block, with blocks that end in the middle of a row
+  constexpr int64_t rows = 3;
+  constexpr int64_t cols = 2000;
+  const auto x = MakeInput(rows * cols, 3.0f);
+  const auto bias = MakeInput(cols, 2.0f);
+  const auto y = MakeInput(rows * cols, 1.0f);
+
+  // Y = y - Relu((x + bias) * 0.5)
+  std::vector<float> expected(rows * cols);
+  for (int64_t i = 0; i < rows * cols; ++i) {
+    expected[i] = y[i] - std::max((x[i] + bias[i % cols]) * 0.5f, 0.0f);
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Relu", "Sub"});
+  test.AddAttribute("operand_first", std::vector<int64_t>{0, 0, 1});
+  test.AddInput<float>("X", {rows, cols}, x);
+  test.AddInput<float>("bias", {cols}, bias);
+  test.AddInput<float>("scale", {}, {0.5f});
+  test.AddInput<float>("Y", {rows, cols}, y);
+  test.AddOutput<float>("Z", {rows, cols}, expected);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, UnaryChain) {
+  const std::vector<float> x = {-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+
+  // Y = Sigmoid(Exp(Abs(-x)))
+  std::vector<float> expected;
+  for (float value : x) {
+    expected.push_back(1.0f / (1.0f + std::exp(-std::exp(std::abs(-value)))));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Neg", "Abs", "Exp", "Sigmoid"});
+  test.AddInput<float>("X", {2, 3}, x);
+  test.AddOutput<float>("Y", {2, 3}, expected);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, LongChain) {
+  // longer than what the CUDA kernel evaluates in one launch
+  constexpr int op_pairs = 12;
+  const std::vector<float> x = {-2.0f, -1.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+
+  // Y = Relu(...Relu(Relu(x + 1) - 0.5)...), alternating Add 1 and Sub 0.5
+  std::vector<std::string> ops;
+  std::vector<float> expected(x);
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {2, 3}, x);
+  for (int i = 0; i < op_pairs; ++i) {
+    const bool add = i % 2 == 0;
+    ops.push_back(add ? "Add" : "Sub");
+    ops.push_back("Relu");
+    test.AddInput<float>("B" + std::to_string(i), {}, {add ? 1.0f : 0.5f});
+    for (auto& value : expected) {
+      value = std::max(add ? value + 1.0f : value - 0.5f, 0.0f);
+    }
+  }
+  test.AddAttribute("ops", ops);
+  test.AddOutput<float>("Y", {2, 3}, expected);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, InvalidBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<float>("B", {2, 1}, {1.0f, 2.0f});
+  test.AddOutput<float>("Y", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "can't be broadcast");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedGemmOpTest, RowBiasRelu) {
+  // the (N,) bias and the Relu are both applied by the GEMM epilogue
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Relu");
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {4, 3}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 12.0f, 13.0f,
+                         0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedGemmOpTest, ScaledBiasLeakyRelu) {
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 0.5f);
+  test.AddAttribute("beta", 2.0f);
+  test.AddAttribute("activation", "LeakyRelu");
+  test.AddAttribute("leaky_relu_alpha", 0.1f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4}, std::vector<float>(12, 1.0f));
+  test.AddInput<float>("C", {1, 3}, {1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {7.0f, 9.0f, 11.0f,
+                         -0.3f, -0.1f, 1.0f});
+  test.Run();
+}
+
+TEST(FusedGemmOpTest, ColumnBiasSigmoid) {
+  // the (M, 1) bias is broadcast along the rows
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "Sigmoid");
+
+  test.AddInput<float>("A", {2, 2},
+                       {1.0f, -1.0f,
+                        0.0f, 0.0f});
+  test.AddInput<float>("B", {2, 3},
+                       {1.0f, 2.0f, 0.0f,
+                        1.0f, 0.0f, 0.0f});
+  test.AddInput<float>("C", {2, 1}, {0.0f, 1.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {0.5f, 0.880797f, 0.5f,
+                         0.731059f, 0.731059f, 0.731059f});
+  test.Run();
+}
+
+#ifdef USE_CUDA
+TEST(FusedGemmOpTest, RowBiasFastGelu) {
+  // only fused on CUDA, where the epilogue of the GEMM applies the bias and FastGelu
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)0);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+  test.AddAttribute("activation", "FastGelu");
+
+  test.AddInput<float>("A", {2, 2},
+                       {1.0f, 0.0f,
+                        0.0f, 1.0f});
+  test.AddInput<float>("B", {2, 2},
+                       {1.0f, -1.0f,
+                        0.5f, 2.0f});
+  test.AddInput<float>("C", {2}, {0.0f, 0.5f});
+  test.AddOutput<float>("Y", {2, 2},
+                        {0.841192f, -0.154286f,
+                         0.345714f, 2.484916f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCpuExecutionProvider});
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
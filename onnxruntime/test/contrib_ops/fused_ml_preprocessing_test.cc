@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedMLPreprocessingTest, ImputerScalerNormalizer) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> x = {nan, 2.0f, 3.0f,
+                                4.0f, nan, 6.0f,
+                                1.0f, 1.0f, 1.0f};
+
+  // Imputer replacing NaN with {1, 2, 1}, then Scaler with offset 1 and scales {1, 2, 3}, then L1 Normalizer
+  const std::vector<float> expected = {0.0f, 2.0f / 8.0f, 6.0f / 8.0f,
+                                       3.0f / 20.0f, 2.0f / 20.0f, 15.0f / 20.0f,
+                                       0.0f, 0.0f, 0.0f};
+
+  OpTester test("FusedMLPreprocessing", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Imputer", "Scaler", "Normalizer"});
+  test.AddAttribute("feature_values", std::vector<float>{1.0f, 2.0f, 1.0f,
+                                                         1.0f, 1.0f, 1.0f,
+                                                         1.0f, 2.0f, 3.0f});
+  test.AddAttribute("scalar_values", std::vector<float>{nan});
+  test.AddAttribute("norms", std::vector<std::string>{"L1"});
+  test.AddInput<float>("X", {3, 3}, x);
+  test.AddOutput<float>("Y", {3, 3}, expected);
+  test.Run();
+}
+
+TEST(FusedMLPreprocessingTest, NormalizerBinarizer) {
+  // more rows than a single task
+  constexpr int64_t rows = 1000;
+  constexpr int64_t cols = 5;
+  std::vector<float> x(rows * cols);
+  std::vector<float> expected(rows * cols);
+  for (int64_t row = 0; row < rows; ++row) {
+    float sum = 0.0f;
+    for (int64_t col = 0; col < cols; ++col) {
+      const float value = static_cast<float>((row + col) % 7) - 3.0f;
+      x[row * cols + col] = value;
+      sum += value * value;
+    }
+    // L2 Normalizer then Binarizer with a threshold of 0.25
+    for (int64_t col = 0; col < cols; ++col) {
+      const float value = x[row * cols + col];
+      const float normalized = sum == 0.0f ? value : std::copysign(std::sqrt(value * value / sum), value);
+      expected[row * cols + col] = normalized > 0.25f ? 1.0f : 0.0f;
+    }
+  }
+
+  OpTester test("FusedMLPreprocessing", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Normalizer", "Binarizer"});
+  test.AddAttribute("scalar_values", std::vector<float>{0.25f});
+  test.AddAttribute("norms", std::vector<std::string>{"L2"});
+  test.AddInput<float>("X", {rows, cols}, x);
+  test.AddOutput<float>("Y", {rows, cols}, expected);
+  test.Run();
+}
+
+TEST(FusedMLPreprocessingTest, BinarizerFailsOnNaN) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  OpTester test("FusedMLPreprocessing", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Normalizer", "Binarizer"});
+  test.AddAttribute("scalar_values", std::vector<float>{0.5f});
+  test.AddAttribute("norms", std::vector<std::string>{"MAX"});
+  test.AddInput<float>("X", {2, 2}, {1.0f, 2.0f, 3.0f, nan});
+  test.AddOutput<float>("Y", {2, 2}, {0.0f, 1.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Input data with index: 3 is NaN");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
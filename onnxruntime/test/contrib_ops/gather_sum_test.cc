@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(GatherSumOpTest, GatherSum_2d_indices) {
+  OpTester test("GatherSum", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {4, 2},
+                       {0.0f, 0.5f,
+                        1.0f, 1.5f,
+                        2.0f, 2.5f,
+                        3.0f, 3.5f});
+  test.AddInput<int64_t>("indices", {2, 3},
+                         {0LL, 1LL, 3LL,
+                          2LL, 2LL, 1LL});
+  test.AddOutput<float>("output", {2, 2},
+                        {4.0f, 5.5f,
+                         5.0f, 6.5f});
+  test.Run();
+}
+
+TEST(GatherSumOpTest, GatherSum_1d_indices_3d_data) {
+  OpTester test("GatherSum", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {3, 2, 2},
+                       {0.0f, 1.0f, 2.0f, 3.0f,
+                        10.0f, 11.0f, 12.0f, 13.0f,
+                        20.0f, 21.0f, 22.0f, 23.0f});
+  test.AddInput<int32_t>("indices", {2}, {2, 1});
+  test.AddOutput<float>("output", {2, 2},
+                        {30.0f, 32.0f, 34.0f, 36.0f});
+  test.Run();
+}
+
+TEST(GatherSumOpTest, GatherSum_empty_bags) {
+  OpTester test("GatherSum", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddInput<int64_t>("indices", {2, 0}, {});
+  test.AddOutput<float>("output", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(GatherSumOpTest, GatherSum_invalid_index) {
+  OpTester test("GatherSum", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<int32_t>("indices", {1, 2}, {0, 2});
+  test.AddOutput<float>("output", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+// Enough bags to be split over threads, with bags longer than the prefetch distance.
+TEST(GatherSumOpTest, GatherSum_many_bags) {
+  const int64_t row_count = 50;
+  const int64_t row_size = 5;
+  const int64_t bag_count = 400;
+  const int64_t bag_size = 20;
+  std::vector<float> data(static_cast<size_t>(row_count * row_size));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 17) * 0.25f;
+  }
+  std::vector<int64_t> indices(static_cast<size_t>(bag_count * bag_size));
+  std::vector<float> output(static_cast<size_t>(bag_count * row_size), 0.0f);
+  for (int64_t bag = 0; bag < bag_count; ++bag) {
+    for (int64_t j = 0; j < bag_size; ++j) {
+      const int64_t index = (bag * 7 + j * 13) % row_count;
+      indices[bag * bag_size + j] = index;
+      for (int64_t k = 0; k < row_size; ++k) {
+        output[bag * row_size + k] += data[index * row_size + k];
+      }
+    }
+  }
+
+  OpTester test("GatherSum", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("data", {row_count, row_size}, data);
+  test.AddInput<int64_t>("indices", {bag_count, bag_size}, indices);
+  test.AddOutput<float>("output", {bag_count, row_size}, output);
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
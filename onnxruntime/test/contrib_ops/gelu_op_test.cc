@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static const std::vector<float> kGeluInput = {-3.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 2.0f, 4.0f};
+
+TEST(GeluTest, Basic) {
+  OpTester test("Gelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {2, 4}, kGeluInput);
+  test.AddOutput<float>("Y", {2, 4}, {-0.004050f, -0.158655f, -0.154269f, 0.000000f,
+                                      0.345731f, 0.841345f, 1.954500f, 3.999873f});
+  test.Run();
+}
+
+TEST(GeluTest, MultipleBlocks) {
+  // spans several of the blocks the CPU kernel splits the work into, with a partial last block
+  const int64_t count = 3 * 4096 + 100;
+  std::vector<float> input(count);
+  std::vector<float> output(count);
+  for (int64_t i = 0; i < count; ++i) {
+    input[i] = static_cast<float>(i - count / 2) / 1000.0f;
+    output[i] = 0.5f * input[i] * (1.0f + std::erf(input[i] / std::sqrt(2.0f)));
+  }
+
+  OpTester test("Gelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {count}, input);
+  test.AddOutput<float>("Y", {count}, output);
+  test.Run();
+}
+
+TEST(FastGeluTest, Basic) {
+  OpTester test("FastGelu", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {2, 4}, kGeluInput);
+  test.AddOutput<float>("Y", {2, 4}, {-0.003637f, -0.158808f, -0.154286f, 0.000000f,
+                                      0.345714f, 0.841192f, 1.954598f, 3.999930f});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
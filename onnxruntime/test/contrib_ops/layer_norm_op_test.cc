@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(LayerNormTest, LastAxis) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-05f);
+
+  test.AddInput<float>("X", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.5f, 2.0f, 6.5f});
+  test.AddInput<float>("scale", {4}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("B", {4}, {0.1f, 0.2f, 0.3f, 0.4f});
+  test.AddOutput<float>("Y", {2, 4}, {-1.241635f, -0.694424f, 1.641635f, 5.766542f,
+                                      -0.969044f, -0.869044f, 0.300000f, 6.814266f});
+  test.Run();
+}
+
+TEST(LayerNormTest, MultipleAxes) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", 1);
+  test.AddAttribute<float>("epsilon", 1e-05f);
+
+  // normalizing over {2, 2} is the same as normalizing the flattened row of 4
+  test.AddInput<double>("X", {2, 2, 2}, {1.0, 2.0, 3.0, 4.0, -1.0, 0.5, 2.0, 6.5});
+  test.AddInput<double>("scale", {2, 2}, {1.0, 2.0, 3.0, 4.0});
+  test.AddInput<double>("B", {2, 2}, {0.1, 0.2, 0.3, 0.4});
+  test.AddOutput<double>("Y", {2, 2, 2}, {-1.241635, -0.694424, 1.641635, 5.766542,
+                                          -0.969044, -0.869044, 0.300000, 6.814266});
+  test.Run();
+}
+
+TEST(LayerNormTest, InvalidScaleSize) {
+  OpTester test("LayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("axis", -1);
+  test.AddAttribute<float>("epsilon", 1e-05f);
+
+  test.AddInput<float>("X", {2, 4}, {1.0f, 2.0f, 3.0f, 4.0f, -1.0f, 0.5f, 2.0f, 6.5f});
+  test.AddInput<float>("scale", {2}, {1.0f, 2.0f});
+  test.AddInput<float>("B", {4}, {0.1f, 0.2f, 0.3f, 0.4f});
+  test.AddOutput<float>("Y", {2, 4}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Size of scale and B must match");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -107,5 +107,34 @@ TEST(MurmurHash3OpTest, StringKeyUIntWithSeed42) {
   test.Run();
 }
 
+TEST(MurmurHash3OpTest, MultipleVectors) {
+  // more keys than the lanes of a vector, with a remainder
+  OpTester test("MurmurHash3", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("X", {11}, {3L, 4L, 3L, 4L, 3L, 4L, 3L, 4L, 3L, 4L, 3L});
+  test.AddAttribute<int64_t>("seed", 0LL);
+  test.AddOutput<uint32_t>("Y", {11}, {847579505L, 1889779975L, 847579505L, 1889779975L, 847579505L, 1889779975L,
+                                       847579505L, 1889779975L, 847579505L, 1889779975L, 847579505L});
+  test.Run();
+}
+
+TEST(HashedEmbeddingOpTest, IntKeys) {
+  // the hashes of 3 and 4 are 847579505 and 1889779975, which select rows 2 and 1 of 3
+  OpTester test("HashedEmbedding", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("X", {2, 2}, {3L, 4L, 4L, 3L});
+  test.AddInput<float>("W", {3, 2}, {0.0f, 0.5f, 1.0f, 1.5f, 2.0f, 2.5f});
+  test.AddOutput<float>("Y", {2, 2, 2}, {2.0f, 2.5f, 1.0f, 1.5f, 1.0f, 1.5f, 2.0f, 2.5f});
+  test.Run();
+}
+
+TEST(HashedEmbeddingOpTest, StringKeys) {
+  // the hash of "foo" with seed 42 is 2972666014, which selects row 1 of 3
+  OpTester test("HashedEmbedding", 1, onnxruntime::kMSDomain);
+  test.AddInput<std::string>("X", {1}, {"foo"});
+  test.AddInput<float>("W", {3, 1}, {0.0f, 1.0f, 2.0f});
+  test.AddAttribute<int64_t>("seed", 42LL);
+  test.AddOutput<float>("Y", {1, 1}, {1.0f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
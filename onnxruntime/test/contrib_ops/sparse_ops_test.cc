@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/sparse_tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Runs a single node of the contrib op with a sparse input, built from its COO values and [NNZ, 2] indices.
+template <typename TSparse>
+static void RunWithSparseInput(const std::string& op_type, const NodeAttributes& attributes, int sparse_input,
+                               const std::vector<int64_t>& sparse_shape, std::vector<TSparse> sparse_values,
+                               std::vector<int64_t> sparse_indices, const std::vector<int64_t>& dense_shape,
+                               const std::vector<float>& dense_values, const std::vector<int64_t>& expected_shape,
+                               const std::vector<float>& expected_values,
+                               const std::string& expected_failure = "") {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 10}, {kMSDomain, 1}};
+  Model model("SparseOpsTest", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  auto& graph = model.MainGraph();
+
+  TypeProto sparse_type(*DataTypeImpl::GetSparseTensorType<TSparse>()->GetTypeProto());
+  TypeProto dense_type(*DataTypeImpl::GetTensorType<float>()->GetTypeProto());
+  auto& sparse_arg = graph.GetOrCreateNodeArg("sparse", &sparse_type);
+  auto& dense_arg = graph.GetOrCreateNodeArg("dense", &dense_type);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &dense_type);
+  std::vector<NodeArg*> inputs{&dense_arg, &dense_arg};
+  inputs[sparse_input] = &sparse_arg;
+  graph.AddNode("node", op_type, "", inputs, {&output_arg}, &attributes, kMSDomain);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  std::stringstream model_stream(serialized_model);
+  InferenceSession session(SessionOptions(), &DefaultLoggingManager());
+  ASSERT_TRUE(session.Load(model_stream).IsOK());
+  status = session.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+  auto sparse = std::make_unique<SparseTensor>(DataTypeImpl::GetType<TSparse>(), TensorShape(sparse_shape),
+                                               sparse_values.size(), sparse_values.data(), sparse_indices.data(),
+                                               cpu_info);
+  OrtValue sparse_value;
+  sparse_value.Init(sparse.release(), DataTypeImpl::GetType<SparseTensor>(),
+                    DataTypeImpl::GetType<SparseTensor>()->GetDeleteFunc());
+  OrtValue dense_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dense_shape, dense_values,
+                       &dense_value);
+
+  NameMLValMap feeds{{"sparse", sparse_value}, {"dense", dense_value}};
+  std::vector<OrtValue> fetches;
+  status = session.Run(RunOptions(), feeds, {"Y"}, &fetches);
+  if (!expected_failure.empty()) {
+    ASSERT_FALSE(status.IsOK());
+    EXPECT_NE(status.ErrorMessage().find(expected_failure), std::string::npos) << status.ErrorMessage();
+    return;
+  }
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const auto& output = fetches[0].Get<Tensor>();
+  EXPECT_EQ(output.Shape(), TensorShape(expected_shape));
+  const float* output_data = output.Data<float>();
+  ASSERT_EQ(output.Shape().Size(), static_cast<int64_t>(expected_values.size()));
+  for (size_t i = 0; i < expected_values.size(); ++i) {
+    EXPECT_FLOAT_EQ(output_data[i], expected_values[i]) << i;
+  }
+}
+
+static NodeAttributes MatMulAttributes(float alpha, int64_t trans_a, int64_t trans_b) {
+  NodeAttributes attributes;
+  AttributeProto attr;
+  attr.set_name("alpha");
+  attr.set_type(AttributeProto_AttributeType_FLOAT);
+  attr.set_f(alpha);
+  attributes["alpha"] = attr;
+  attr.Clear();
+  attr.set_name("transA");
+  attr.set_type(AttributeProto_AttributeType_INT);
+  attr.set_i(trans_a);
+  attributes["transA"] = attr;
+  attr.set_name("transB");
+  attr.set_i(trans_b);
+  attributes["transB"] = attr;
+  return attributes;
+}
+
+// A = [[0, 2, 0],
+//      [1, 0, 0],
+//      [0, 0, 0],
+//      [0, 3, 4]], with its values out of row order
+TEST(SparseToDenseMatMulTest, Basic) {
+  const std::vector<float> b{1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+  RunWithSparseInput<float>("SparseToDenseMatMul", MatMulAttributes(1.f, 0, 0), 0, {4, 3}, {4.f, 2.f, 1.f, 3.f},
+                            {3, 2, 0, 1, 1, 0, 3, 1}, {3, 2}, b, {4, 2},
+                            {6.f, 8.f, 1.f, 2.f, 0.f, 0.f, 29.f, 36.f});
+}
+
+TEST(SparseToDenseMatMulTest, TransposedWithAlpha) {
+  // A' is [2, 4] the transpose of the [4, 2] A, and B' is [4, 2] the transpose of B
+  const std::vector<float> b{1.f, 0.f, 2.f, -1.f, 0.f, 1.f, 3.f, 1.f};
+  RunWithSparseInput<float>("SparseToDenseMatMul", MatMulAttributes(2.f, 1, 1), 0, {4, 2}, {1.f, 3.f, 2.f},
+                            {0, 0, 2, 0, 3, 1}, {2, 4}, b, {2, 2}, {14.f, 18.f, -4.f, 4.f});
+}
+
+TEST(SparseToDenseMatMulTest, IndexOutOfBounds) {
+  RunWithSparseInput<float>("SparseToDenseMatMul", MatMulAttributes(1.f, 0, 0), 0, {2, 2}, {1.f}, {2, 0}, {2, 1},
+                            {1.f, 2.f}, {2, 1}, {}, "out of the bounds");
+}
+
+TEST(SparseGatherSumTest, Bags) {
+  // bag 0 = {2, 0}, bag 1 is empty, bag 2 = {1, 1, 2}
+  const std::vector<float> data{1.f, 2.f, 10.f, 20.f, 100.f, 200.f};
+  RunWithSparseInput<int64_t>("SparseGatherSum", NodeAttributes(), 1, {3, 3}, {2, 1, 0, 1, 2},
+                              {0, 0, 2, 0, 0, 1, 2, 1, 2, 2}, {3, 2}, data, {3, 2},
+                              {101.f, 202.f, 0.f, 0.f, 120.f, 240.f});
+}
+
+TEST(SparseGatherSumTest, IdOutOfBounds) {
+  RunWithSparseInput<int64_t>("SparseGatherSum", NodeAttributes(), 1, {1, 2}, {3}, {0, 0}, {3, 1},
+                              {1.f, 2.f, 3.f}, {1, 1}, {}, "out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
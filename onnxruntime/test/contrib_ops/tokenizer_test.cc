@@ -677,6 +677,41 @@ TEST(ContribOpTest, TokenizerWithSeparators_MixCharCommonPrefixC) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }  // namespace test
 
+TEST(ContribOpTest, TokenizerWithSeparators_ManyRowsNC) {
+  // Enough strings to be split into several blocks that may be tokenized on different threads
+  // [N][C] dimensions
+  // Output [N][C][D]
+  std::vector<std::string> separators = {
+      u8";",
+      u8";;;"};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, true, separators, 1);
+
+  const std::vector<std::string> row_input{u8"a;b", u8"a;;;b", u8"b;c;;;d;e", u8"a;;b;;;c"};
+  const std::vector<std::string> row_output{
+      start_mark, u8"a", u8"b", end_mark, padval, padval,
+      start_mark, u8"a", u8"b", end_mark, padval, padval,
+      start_mark, u8"b", u8"c", u8"d", u8"e", end_mark,
+      start_mark, u8"a", u8"b", u8"c", end_mark, padval};
+
+  const int64_t N = 64;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t n = 0; n < N; ++n) {
+    input.insert(input.end(), row_input.cbegin(), row_input.cend());
+    output.insert(output.end(), row_output.cbegin(), row_output.cend());
+  }
+
+  std::vector<int64_t> dims{N, int64_t(row_input.size())};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> output_dims(dims);
+  output_dims.push_back(int64_t(6));
+  test.AddOutput<std::string>("Y", output_dims, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 TEST(ContribOpTest, TokenizerExpression_RegEx) {
   OpTester test("Tokenizer", opset_ver, domain);
   const std::string tokenexp(u8"a.");
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Reference for a batch of matrices, where a batch count of 1 broadcasts against the other operand.
+// a holds a_batch matrices of M x K, or K x M when trans_a. b holds b_batch matrices of K x N, or N x K when trans_b.
+static std::vector<float> ComputeTransposeMatMul(const std::vector<float>& a, const std::vector<float>& b,
+                                                 int64_t a_batch, int64_t b_batch,
+                                                 int64_t M, int64_t N, int64_t K, bool trans_a, bool trans_b) {
+  const int64_t batch = std::max(a_batch, b_batch);
+  std::vector<float> y(batch * M * N);
+  for (int64_t n = 0; n < batch; ++n) {
+    const float* a_mat = a.data() + (a_batch == 1 ? 0 : n) * M * K;
+    const float* b_mat = b.data() + (b_batch == 1 ? 0 : n) * K * N;
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t j = 0; j < N; ++j) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < K; ++k) {
+          sum += (trans_a ? a_mat[k * M + i] : a_mat[i * K + k]) * (trans_b ? b_mat[j * K + k] : b_mat[k * N + j]);
+        }
+        y[(n * M + i) * N + j] = sum;
+      }
+    }
+  }
+  return y;
+}
+
+static std::vector<float> MakeInput(int64_t size) {
+  std::vector<float> data(size);
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  return data;
+}
+
+TEST(TransposeMatMulTest, TransA) {
+  const auto a = MakeInput(3 * 2);
+  const auto b = MakeInput(3 * 4);
+
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("transA", 1);
+  test.AddInput<float>("A", {3, 2}, a);
+  test.AddInput<float>("B", {3, 4}, b);
+  test.AddOutput<float>("Y", {2, 4}, ComputeTransposeMatMul(a, b, 1, 1, 2, 4, 3, true, false));
+  test.Run();
+}
+
+TEST(TransposeMatMulTest, BatchedTransA) {
+  // a transposed left operand can't be flattened into a single GEMM against a 2D right operand
+  const auto a = MakeInput(2 * 3 * 2);
+  const auto b = MakeInput(3 * 4);
+
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("transA", 1);
+  test.AddInput<float>("A", {2, 3, 2}, a);
+  test.AddInput<float>("B", {3, 4}, b);
+  test.AddOutput<float>("Y", {2, 2, 4}, ComputeTransposeMatMul(a, b, 2, 1, 2, 4, 3, true, false));
+  test.Run();
+}
+
+TEST(TransposeMatMulTest, BatchedTransB) {
+  const auto a = MakeInput(2 * 2 * 3);
+  const auto b = MakeInput(4 * 3);
+
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("transB", 1);
+  test.AddInput<float>("A", {2, 2, 3}, a);
+  test.AddInput<float>("B", {4, 3}, b);
+  test.AddOutput<float>("Y", {2, 2, 4}, ComputeTransposeMatMul(a, b, 2, 1, 2, 4, 3, false, true));
+  test.Run();
+}
+
+TEST(TransposeMatMulTest, BatchedTransAB) {
+  const auto a = MakeInput(3 * 5 * 2);
+  const auto b = MakeInput(3 * 4 * 5);
+
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("transA", 1);
+  test.AddAttribute<int64_t>("transB", 1);
+  test.AddInput<float>("A", {3, 5, 2}, a);
+  test.AddInput<float>("B", {3, 4, 5}, b);
+  test.AddOutput<float>("Y", {3, 2, 4}, ComputeTransposeMatMul(a, b, 3, 3, 2, 4, 5, true, true));
+  test.Run();
+}
+
+TEST(TransposeMatMulTest, BatchedAlpha) {
+  const auto a = MakeInput(2 * 2 * 3);
+  const auto b = MakeInput(2 * 3 * 4);
+  auto y = ComputeTransposeMatMul(a, b, 2, 2, 2, 4, 3, false, false);
+  for (auto& value : y) {
+    value *= 0.125f;
+  }
+
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("alpha", 0.125f);
+  test.AddInput<float>("A", {2, 2, 3}, a);
+  test.AddInput<float>("B", {2, 3, 4}, b);
+  test.AddOutput<float>("Y", {2, 2, 4}, y);
+  test.Run();
+}
+
+TEST(TransposeMatMulTest, Transposed1DInput) {
+  OpTester test("TransposeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("transA", 1);
+  test.AddInput<float>("A", {3}, MakeInput(3));
+  test.AddInput<float>("B", {3, 4}, MakeInput(3 * 4));
+  test.AddOutput<float>("Y", {4}, std::vector<float>(4));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "transposed left operand must be at least 2D");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
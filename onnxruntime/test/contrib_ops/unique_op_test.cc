@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <unordered_map>
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -43,5 +45,91 @@ TEST(UniqueOpTest, Unique_AllUniqueElements) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+TEST(UniqueOpTest, Unique_LargeInput) {
+  // large enough for the input to be split into blocks, with elements first seen in different blocks
+  const int64_t size = 5000;
+  std::vector<float> x(size);
+  for (int64_t i = 0; i < size; ++i) {
+    x[i] = static_cast<float>((i * i) % 1009);
+  }
+
+  std::vector<float> uniques;
+  std::vector<int64_t> idx(size);
+  std::vector<int64_t> counts;
+  for (int64_t i = 0; i < size; ++i) {
+    const auto found = std::find(uniques.begin(), uniques.end(), x[i]);
+    idx[i] = found - uniques.begin();
+    if (found == uniques.end()) {
+      uniques.push_back(x[i]);
+      counts.push_back(0);
+    }
+    ++counts[idx[i]];
+  }
+
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("x", {size}, x);
+  test.AddOutput<float>("uniques", {static_cast<int64_t>(uniques.size())}, uniques);
+  test.AddOutput<int64_t>("idx", {size}, idx);
+  test.AddOutput<int64_t>("counts", {static_cast<int64_t>(counts.size())}, counts);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(UniqueOpTest, Unique_SignedZero) {
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("x", {4}, {0.0f, -1.0f, -0.0f, 0.0f});
+  test.AddOutput<float>("uniques", {2}, {0.0f, -1.0f});
+  test.AddOutput<int64_t>("idx", {4}, {0, 1, 0, 0});
+  test.AddOutput<int64_t>("counts", {2}, {3, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(UniqueOpTest, Unique_Int32) {
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<int32_t>("x", {7}, {-3, 5, -3, 7, 5, 5, -1});
+  test.AddOutput<int32_t>("uniques", {4}, {-3, 5, 7, -1});
+  test.AddOutput<int64_t>("idx", {7}, {0, 1, 0, 2, 1, 1, 3});
+  test.AddOutput<int64_t>("counts", {4}, {2, 3, 1, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(UniqueOpTest, Unique_String) {
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<std::string>("x", {5}, {"b", "a", "b", "", "a"});
+  test.AddOutput<std::string>("uniques", {3}, {"b", "a", ""});
+  test.AddOutput<int64_t>("idx", {5}, {0, 1, 0, 2, 1});
+  test.AddOutput<int64_t>("counts", {3}, {2, 2, 1});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(UniqueOpTest, Unique_Int64_LargeInput) {
+  // large enough to be partitioned over the threads, with many unique IDs
+  const int64_t size = 100000;
+  std::vector<int64_t> x(size);
+  for (int64_t i = 0; i < size; ++i) {
+    x[i] = (i * i) % 50021 - 25000;
+  }
+
+  std::vector<int64_t> uniques;
+  std::vector<int64_t> idx(size);
+  std::vector<int64_t> counts;
+  std::unordered_map<int64_t, int64_t> indices;
+  for (int64_t i = 0; i < size; ++i) {
+    const auto inserted = indices.emplace(x[i], static_cast<int64_t>(uniques.size()));
+    if (inserted.second) {
+      uniques.push_back(x[i]);
+      counts.push_back(0);
+    }
+    idx[i] = inserted.first->second;
+    ++counts[idx[i]];
+  }
+
+  OpTester test("Unique", 1, onnxruntime::kMSDomain);
+  test.AddInput<int64_t>("x", {size}, x);
+  test.AddOutput<int64_t>("uniques", {static_cast<int64_t>(uniques.size())}, uniques);
+  test.AddOutput<int64_t>("idx", {size}, idx);
+  test.AddOutput<int64_t>("counts", {static_cast<int64_t>(counts.size())}, counts);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A * (B * b_scale) + bias of an M x K A and a K x N B with a scale per column.
+static std::vector<float> MatMulWeightInt8Reference(const std::vector<float>& a, const std::vector<int8_t>& b,
+                                                    const std::vector<float>& b_scale,
+                                                    const std::vector<float>& bias,
+                                                    int64_t M, int64_t K, int64_t N) {
+  std::vector<float> y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      float sum = bias.empty() ? 0.f : bias[n];
+      for (int64_t k = 0; k < K; ++k) {
+        sum += a[m * K + k] * static_cast<float>(b[k * N + n]) * b_scale[n];
+      }
+      y[m * N + n] = sum;
+    }
+  }
+  return y;
+}
+
+TEST(MatMulWeightInt8Test, Basic) {
+  const std::vector<float> a = {-1.f, 0.5f, 2.f, 3.f, -0.25f, 1.f};
+  const std::vector<int8_t> b = {10, -127, 64, 0, 127, -3};
+  const std::vector<float> b_scale = {0.5f, 0.01f};
+
+  OpTester test("MatMulWeightInt8", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, 3}, a);
+  test.AddInput<int8_t>("B", {3, 2}, b);
+  test.AddInput<float>("b_scale", {2}, b_scale);
+  test.AddOutput<float>("Y", {2, 2}, MatMulWeightInt8Reference(a, b, b_scale, {}, 2, 3, 2));
+  test.Run();
+}
+
+TEST(MatMulWeightInt8Test, BatchWithBias) {
+  // more columns of B than a packed panel and a K split in several slices, with a batch of two matrices
+  constexpr int64_t M = 3;
+  constexpr int64_t K = 300;
+  constexpr int64_t N = 20;
+  std::vector<float> a(2 * M * K);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<float>(i % 13) * 0.25f - 1.f;
+  }
+  std::vector<int8_t> b(K * N);
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<int8_t>(static_cast<int>(i * 7 % 255) - 127);
+  }
+  std::vector<float> b_scale(N);
+  std::vector<float> bias(N);
+  for (int64_t n = 0; n < N; ++n) {
+    b_scale[n] = 0.001f * static_cast<float>(n + 1);
+    bias[n] = static_cast<float>(n) - 10.f;
+  }
+
+  std::vector<float> y = MatMulWeightInt8Reference(std::vector<float>(a.begin(), a.begin() + M * K), b, b_scale,
+                                                   bias, M, K, N);
+  const std::vector<float> y2 = MatMulWeightInt8Reference(std::vector<float>(a.begin() + M * K, a.end()), b,
+                                                          b_scale, bias, M, K, N);
+  y.insert(y.end(), y2.begin(), y2.end());
+
+  OpTester test("MatMulWeightInt8", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {2, M, K}, a);
+  test.AddInput<int8_t>("B", {K, N}, b);
+  test.AddInput<float>("b_scale", {N}, b_scale);
+  test.AddInput<float>("bias", {N}, bias);
+  test.AddOutput<float>("Y", {2, M, N}, y);
+  test.Run();
+}
+
+TEST(GatherWeightInt8Test, DequantizesGatheredRows) {
+  OpTester test("GatherWeightInt8", 1, onnxruntime::kMSDomain);
+  test.AddInput<int8_t>("data", {3, 2}, {1, -2, 3, 4, -127, 127});
+  test.AddInput<float>("scale", {3}, {0.5f, 2.f, 0.01f});
+  test.AddInput<int64_t>("indices", {2, 2}, {2, 0, 1, 1});
+  test.AddOutput<float>("output", {2, 2, 2}, {-1.27f, 1.27f, 0.5f, -1.f, 6.f, 8.f, 6.f, 8.f});
+  test.Run();
+}
+
+TEST(GatherWeightInt8Test, IndicesOutOfBounds) {
+  OpTester test("GatherWeightInt8", 1, onnxruntime::kMSDomain);
+  test.AddInput<int8_t>("data", {2, 2}, {1, 2, 3, 4});
+  test.AddInput<float>("scale", {2}, {1.f, 1.f});
+  test.AddInput<int32_t>("indices", {1}, {2});
+  test.AddOutput<float>("output", {1, 2}, {0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
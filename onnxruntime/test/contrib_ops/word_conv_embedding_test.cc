@@ -1,6 +1,7 @@
 ﻿// Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <codecvt>
 #include <vector>
 #include "gtest/gtest.h"
@@ -127,5 +128,80 @@ TEST(ContribOpTest, WordConvEmbedding_char_embedding_shape_conv_shape_not_match)
   test.Run(OpTester::ExpectResult::kExpectFailure);
 }
 
+// Computes the output of WordConvEmbedding for a sequence of words one window at a time.
+static std::vector<float> ComputeWordConvEmbedding(const std::vector<int>& seq_words, int64_t word_len,
+                                                   const std::vector<float>& W_conv, const std::vector<float>& B_conv,
+                                                   int64_t filter_width, const std::vector<float>& W_char_embedding,
+                                                   int64_t char_embedding_size) {
+  const int64_t seq_len = static_cast<int64_t>(seq_words.size()) / word_len;
+  const int64_t num_filters = static_cast<int64_t>(B_conv.size());
+  std::vector<float> output(seq_len * num_filters, 0.0f);
+  for (int64_t w = 0; w < seq_len; w++) {
+    const int* word = seq_words.data() + w * word_len;
+    int64_t length = 0;
+    for (int64_t c = 0; word[0] > 0 && c < word_len; c++) {
+      length += word[c] > 0 ? 1 : 0;
+    }
+    if (length == 0) {
+      continue;
+    }
+    for (int64_t f = 0; f < num_filters; f++) {
+      float max_value = -1e12f;
+      for (int64_t p = 0; p < std::max(length, filter_width) - filter_width + 1; p++) {
+        float sum = B_conv[f];
+        for (int64_t c = 0; c < filter_width; c++) {
+          for (int64_t e = 0; e < char_embedding_size; e++) {
+            sum += W_char_embedding[word[p + c] * char_embedding_size + e] *
+                   W_conv[(f * filter_width + c) * char_embedding_size + e];
+          }
+        }
+        max_value = std::max(max_value, std::tanh(sum));
+      }
+      output[w * num_filters + f] = max_value;
+    }
+  }
+  return output;
+}
+
+// Many words of different lengths, including empty ones and ones shorter than the filter, with the conv weight as
+// an initializer that the kernel packs ahead of time or as an input.
+TEST(ContribOpTest, WordConvEmbedding_many_words) {
+  const int64_t seq_len = 67;
+  const int64_t word_len = 6;
+  const int64_t num_chars = 11;
+  const int64_t char_embedding_size = 4;
+  const int64_t num_filters = 5;
+  const int64_t filter_width = 3;
+
+  std::vector<int> seq_words(seq_len * word_len, 0);
+  for (int64_t w = 0; w < seq_len; w++) {
+    const int64_t length = w % (word_len + 1);
+    for (int64_t c = 0; c < length; c++) {
+      seq_words[w * word_len + c] = static_cast<int>(1 + (w * 7 + c * 3) % (num_chars - 1));
+    }
+  }
+  std::vector<float> W_char_embedding(num_chars * char_embedding_size);
+  for (size_t i = 0; i < W_char_embedding.size(); i++) {
+    W_char_embedding[i] = static_cast<float>(i % 13) / 13.0f - 0.5f;
+  }
+  std::vector<float> W_conv(num_filters * filter_width * char_embedding_size);
+  for (size_t i = 0; i < W_conv.size(); i++) {
+    W_conv[i] = static_cast<float>(i % 7) / 7.0f - 0.4f;
+  }
+  std::vector<float> B_conv{0.1f, -0.2f, 0.3f, 0.0f, -0.1f};
+
+  const auto output = ComputeWordConvEmbedding(seq_words, word_len, W_conv, B_conv, filter_width, W_char_embedding,
+                                               char_embedding_size);
+  for (bool is_initializer : {false, true}) {
+    OpTester test("WordConvEmbedding", 1, onnxruntime::kMSDomain);
+    test.AddInput<int>("Sequence", {seq_len, word_len}, seq_words);
+    test.AddInput<float>("W", {num_filters, 1, filter_width, char_embedding_size}, W_conv, is_initializer);
+    test.AddInput<float>("B", {num_filters}, B_conv);
+    test.AddInput<float>("C", {num_chars, char_embedding_size}, W_char_embedding);
+    test.AddOutput<float>("Y", {seq_len, num_filters}, output);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
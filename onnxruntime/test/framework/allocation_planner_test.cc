@@ -124,15 +124,19 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool parallel_execution_enabled = false)
+      : shape_map_(shape_map), parallel_execution_enabled_(parallel_execution_enabled) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool IsParallelExecutionEnabled() const override { return parallel_execution_enabled_; }
+
  private:
   ShapeMap* shape_map_;
+  bool parallel_execution_enabled_;
 };
 
 class PlannerTest : public ::testing::Test {
@@ -217,7 +221,8 @@ class PlannerTest : public ::testing::Test {
     }
   }
 
-  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {}) {
+  void CreatePlan(const std::vector<const NodeArg*>& outer_scope_node_args = {},
+                  bool parallel_execution_enabled = false) {
     EXPECT_EQ(graph_.Resolve(), Status::OK());
 
     state_.SetGraph(graph_);
@@ -237,7 +242,7 @@ class PlannerTest : public ::testing::Test {
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
     status = state_.CreateKernels(kernel_registry_manager);
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, parallel_execution_enabled);
     status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph_), outer_scope_node_args, execution_providers,
                                            kernel_registry_manager, state_.GetOrtValueNameIdxMap(), test_context, plan_);
 
@@ -309,6 +314,12 @@ TEST_F(PlannerTest, ChainTest) {
   CheckFreed(1, {});
   CheckFreed(2, {"B"});
   CheckFreed(3, {"X"});
+
+  // Priorities count the nodes remaining on the longest path to a graph output.
+  const auto& plan = GetPlan();
+  for (size_t step = 0; step < plan.execution_plan.size(); ++step) {
+    EXPECT_EQ(plan.NodePriority(plan.execution_plan[step].node_index), plan.execution_plan.size() - step);
+  }
 }
 
 /* InputOutputTest: Test that:
@@ -413,6 +424,95 @@ TEST_F(PlannerTest, InPlaceSizeMismatchTest) {
   CheckFreed(3, {X2});
 }
 
+// ReuseSameSizeTest: Check that a dead buffer is reused for a tensor of another shape with the same known size.
+TEST_F(PlannerTest, ReuseSameSizeTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddNormalNode(X2, X3);  // X3: temporary
+  AddNormalNode(X3, X4);  // X4: temporary, of another shape than X2 with as many elements
+  AddNormalNode(X4, X5);  // X5: output
+
+  // simulate shape-inference results:
+  Shape shape1w{2, 3};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{6};
+  auto shape2 = &shape2w.value;
+  Shape shape3w{3, 2};
+  auto shape3 = &shape3w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape2}, {X4, shape3}, {X5, shape3}});
+
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+
+  // check each ml-value is freed at appropriate step
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {X3});
+  CheckFreed(3, {X2});
+}
+
+// ParallelChainTest: Check that a dead buffer is reused under parallel execution when all of its users precede
+// the node that reuses it.
+TEST_F(PlannerTest, ParallelChainTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5");
+
+  // graph structure:
+  AddNormalNode(X1, X2);  // X1: input; X2: temporary
+  AddNormalNode(X2, X3);  // X3: temporary
+  AddNormalNode(X3, X4);  // X4: temporary
+  AddNormalNode(X4, X5);  // X5: output
+
+  // simulate shape-inference results:
+  Shape shape1{2, 3};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}});
+
+  CreatePlan({}, true);
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kReuse);
+  CheckAllocKind(X5, AllocKind::kAllocateOutput);
+}
+
+// ParallelBranchTest: Check that under parallel execution a buffer is neither updated in place nor reused by a
+// node that can run concurrently with another user of the buffer.
+TEST_F(PlannerTest, ParallelBranchTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6");
+
+  // graph structure:
+  AddNormalNode(X1, X2);   // X1: input; X2: temporary read by two branches
+  AddInplaceNode(X2, X3);  // first branch; X3: temporary
+  AddInplaceNode(X2, X4);  // second branch; X4: output
+  AddNormalNode(X3, X5);   // X5: temporary
+  AddNormalNode(X5, X6);   // X6: output
+
+  // simulate shape-inference results:
+  Shape shape1{2, 3};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}, {X5, shape}, {X6, shape}});
+
+  CreatePlan({}, true);
+
+  // the branches may still read X2 while the other one runs, and X5 may be computed while the second branch reads X2
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocateOutput);
+  CheckAllocKind(X5, AllocKind::kAllocate);
+  CheckAllocKind(X6, AllocKind::kAllocateOutput);
+}
+
 // Test operator<< to output details of an allocation & execution plan.
 TEST_F(PlannerTest, PlanOutputTest) {
   // tensor variables:
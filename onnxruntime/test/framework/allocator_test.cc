@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/framework/allocatormgr.h"
 #include "core/framework/allocator.h"
+#include "core/platform/env.h"
 #include "test_utils.h"
 #include "gtest/gtest.h"
 
@@ -73,5 +76,46 @@ TEST(AllocatorTest, MakeUniquePtrTest) {
   auto void_ptr = IAllocator::MakeUniquePtr<void>(allocator, 16);
   void_ptr = nullptr;
 }
+
+// the NUMA allocator places memory on the node if it can and falls back to the default allocation otherwise,
+// either way the memory is usable and freed by the same allocator
+TEST(AllocatorTest, NumaCPUAllocatorTest) {
+  NumaCPUAllocator allocator(std::make_unique<OrtMemoryInfo>(CPU, OrtAllocatorType::OrtDeviceAllocator), 0);
+  EXPECT_EQ(allocator.NumaNode(), 0);
+
+  const size_t size = 1 << 20;
+  auto* p = static_cast<char*>(allocator.Alloc(size));
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, size);
+  EXPECT_EQ(p[size - 1], 1);
+  allocator.Free(p);
+
+  EXPECT_GE(Env::Default().GetNumaNodeCount(), 1);
+}
+
+// the huge page allocator backs the large allocations with huge pages if the platform has some available, and
+// makes the others with the fallback allocator
+TEST(AllocatorTest, HugePageCPUAllocatorTest) {
+  HugePageCPUAllocator allocator(std::make_unique<CPUAllocator>(), -1);
+  const size_t huge_page_size = Env::Default().GetHugePageSize();
+
+  auto* small = static_cast<char*>(allocator.Alloc(64));
+  ASSERT_NE(small, nullptr);
+  EXPECT_EQ(allocator.HugePageBytes(), 0u);
+
+  const size_t size = std::max<size_t>(huge_page_size, 1 << 20) + 100;
+  auto* p = static_cast<char*>(allocator.Alloc(size));
+  ASSERT_NE(p, nullptr);
+  memset(p, 1, size);
+  EXPECT_EQ(p[size - 1], 1);
+  if (allocator.HugePageBytes() > 0) {
+    // rounded up to whole huge pages
+    EXPECT_EQ(allocator.HugePageBytes(), 2 * huge_page_size);
+  }
+
+  allocator.Free(p);
+  allocator.Free(small);
+  EXPECT_EQ(allocator.HugePageBytes(), 0u);
+}
 }  // namespace test
 }  // namespace onnxruntime
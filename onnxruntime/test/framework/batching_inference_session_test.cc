@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_inference_session.h"
+
+#include <sstream>
+#include <thread>
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Loads Y = X * X, with the dimensions of X and Y symbolic
+static void LoadSquareModel(InferenceSession& session) {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 10}};
+  Model model("BatchingInferenceSessionTest", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("D0");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("D1");
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("square", "Mul", "", {&x, &x}, {&y});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  std::stringstream model_stream(serialized_model);
+  ASSERT_TRUE(session.Load(model_stream).IsOK());
+  status = session.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+// Runs a request per shape from its own thread, and checks that each gets the square of its input back
+static void RunConcurrentRequests(BatchingInferenceSession& batching_session,
+                                  const std::vector<std::vector<int64_t>>& shapes) {
+  RunOptions run_options;
+  std::vector<std::thread> threads;
+  for (size_t r = 0; r < shapes.size(); ++r) {
+    threads.emplace_back([&batching_session, &run_options, &shapes, r]() {
+      const auto& dims = shapes[r];
+      std::vector<float> values(static_cast<size_t>(TensorShape(dims).Size()));
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(r * 10 + i);
+      }
+      OrtValue x;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values, &x);
+
+      std::vector<OrtValue> fetches;
+      auto status = batching_session.Run(run_options, {"X"}, {x}, {"Y"}, &fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      ASSERT_EQ(fetches.size(), 1u);
+
+      const auto& y = fetches[0].Get<Tensor>();
+      ASSERT_EQ(y.Shape(), TensorShape(dims));
+      for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(y.Data<float>()[i], values[i] * values[i]) << "request " << r << " element " << i;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(BatchingInferenceSessionTest, BatchesConcurrentRequests) {
+  InferenceSession session(SessionOptions(), &DefaultLoggingManager());
+  LoadSquareModel(session);
+
+  // the batch is only run early because it's full
+  BatchingSessionOptions options;
+  options.max_batch_size = 4;
+  options.max_latency = std::chrono::seconds(60);
+  BatchingInferenceSession batching_session(session, options);
+
+  RunConcurrentRequests(batching_session, {{1, 3}, {1, 3}, {2, 3}});
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, 3u);
+  EXPECT_EQ(stats.num_runs, 1u);
+}
+
+TEST(BatchingInferenceSessionTest, BatchesAlongInnerAxis) {
+  InferenceSession session(SessionOptions(), &DefaultLoggingManager());
+  LoadSquareModel(session);
+
+  BatchingSessionOptions options;
+  options.batch_axis = 1;
+  options.max_batch_size = 3;
+  options.max_latency = std::chrono::seconds(60);
+  BatchingInferenceSession batching_session(session, options);
+
+  RunConcurrentRequests(batching_session, {{2, 1}, {2, 1}, {2, 1}});
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, 3u);
+  EXPECT_EQ(stats.num_runs, 1u);
+}
+
+TEST(BatchingInferenceSessionTest, RunsIncompatibleRequestsSeparately) {
+  InferenceSession session(SessionOptions(), &DefaultLoggingManager());
+  LoadSquareModel(session);
+
+  BatchingSessionOptions options;
+  options.max_batch_size = 4;
+  options.max_latency = std::chrono::milliseconds(10);
+  BatchingInferenceSession batching_session(session, options);
+
+  // the second dimensions differ, and the last request is larger than a batch
+  RunConcurrentRequests(batching_session, {{1, 2}, {1, 3}, {5, 2}});
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, 3u);
+  EXPECT_EQ(stats.num_runs, 3u);
+}
+
+TEST(BatchingInferenceSessionTest, DropsExpiredRequests) {
+  InferenceSession session(SessionOptions(), &DefaultLoggingManager());
+  LoadSquareModel(session);
+
+  // the request waits for a batch that doesn't come until its deadline
+  BatchingSessionOptions options;
+  options.max_batch_size = 4;
+  options.max_latency = std::chrono::seconds(60);
+  BatchingInferenceSession batching_session(session, options);
+
+  RunOptions run_options;
+  run_options.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1, 2}, {1.f, 2.f}, &x);
+  std::vector<OrtValue> fetches;
+  auto status = batching_session.Run(run_options, {"X"}, {x}, {"Y"}, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("deadline"), std::string::npos) << status.ErrorMessage();
+  EXPECT_TRUE(fetches.empty());
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_requests, 1u);
+  EXPECT_EQ(stats.num_runs, 0u);
+  EXPECT_EQ(stats.num_expired, 1u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
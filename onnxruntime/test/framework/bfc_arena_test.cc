@@ -234,5 +234,110 @@ TEST(BFCArenaTest, TestReserve) {
   a.GetStats(&stats);
   EXPECT_EQ(stats.total_allocated_bytes, 1048576);
 }
+
+TEST(BFCArenaTest, ThreadCacheReusesFreedChunks) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, 1 << 20);
+
+  // 600 bytes rounds up to the 1KB size class.
+  void* first_ptr = a.Alloc(600);
+  ASSERT_NE(first_ptr, nullptr);
+  EXPECT_EQ(a.AllocatedSize(first_ptr), 1024u);
+  a.Free(first_ptr);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+  EXPECT_EQ(stats.num_cache_hits, 0);
+  EXPECT_EQ(stats.bytes_in_cache, 1024);
+
+  // Any request in the same size class is served from the cache.
+  void* second_ptr = a.Alloc(1000);
+  EXPECT_EQ(second_ptr, first_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.bytes_in_cache, 0);
+
+  // Large allocations bypass the cache.
+  void* large_ptr = a.Alloc(1 << 20);
+  a.Free(large_ptr);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+
+  a.Free(second_ptr);
+  a.DrainThreadCache();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_cache, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheDrainsWhenFull) {
+  // Allow at most 4KB to be parked per shard.
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, 4096);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 8; i++) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_cache, 4096);
+  EXPECT_EQ(stats.bytes_in_use, stats.bytes_in_cache);
+}
+
+TEST(BFCArenaTest, ShrinkReleasesUnusedRegions) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30);
+
+  // the first region is 1MB, so the second allocation needs another region
+  void* first_ptr = a.Alloc(1 << 19);
+  void* second_ptr = a.Alloc(1 << 20);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 2);
+  EXPECT_EQ(stats.total_allocated_bytes, 3 << 20);
+  EXPECT_EQ(stats.largest_free_chunk, 1 << 20);
+
+  // both regions are in use
+  EXPECT_EQ(a.Shrink(), 0u);
+
+  a.Free(second_ptr);
+  EXPECT_EQ(a.Shrink(), size_t{2} << 20);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20);
+  EXPECT_EQ(stats.bytes_in_use, 1 << 19);
+  EXPECT_EQ(stats.largest_free_chunk, 1 << 19);
+
+  // the arena keeps working after shrinking
+  void* third_ptr = a.Alloc(1 << 20);
+  ASSERT_NE(third_ptr, nullptr);
+  a.Free(third_ptr);
+  a.Free(first_ptr);
+
+  EXPECT_GT(a.Shrink(), 0u);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.largest_free_chunk, 0);
+}
+
+TEST(BFCArenaTest, ShrinkDrainsThreadCache) {
+  BFCArena a(std::unique_ptr<IDeviceAllocator>(new CPUAllocator()), 1 << 30, 1 << 20);
+
+  void* ptr = a.Alloc(1024);
+  a.Free(ptr);
+
+  // the chunk parked in the thread cache doesn't keep its region alive
+  EXPECT_EQ(a.Shrink(), size_t{1} << 20);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_cache, 0);
+  EXPECT_EQ(stats.num_regions, 0);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,11 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include "core/framework/allocatormgr.h"
+#include "core/framework/tensor.h"
 #include "test/framework/test_utils.h"
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/gpu_data_transfer.h"
 
 namespace onnxruntime {
 namespace test {
@@ -67,5 +70,77 @@ TEST(AllocatorTest, CUDAAllocatorTest) {
   cuda_arena->Free(cuda_addr);
   pinned_allocator->Free(pinned_addr);
 }
+
+TEST(AllocatorTest, CUDAArenasShareDeviceMemoryCache) {
+  int cuda_device_id = 0;
+  DeviceAllocatorRegistrationInfo default_memory_info({OrtMemTypeDefault,
+                                                          [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
+
+  auto first_arena = CreateAllocator(default_memory_info, cuda_device_id);
+  auto second_arena = CreateAllocator(default_memory_info, cuda_device_id);
+  auto& cache = CUDAMemoryCache::Get(cuda_device_id);
+
+  void* first_addr = first_arena->Alloc(1024);
+  EXPECT_TRUE(first_addr);
+  first_arena->Free(first_addr);
+
+  // the region of the first arena goes back to the cache rather than to the driver
+  auto stats = cache.GetStats();
+  EXPECT_GT(dynamic_cast<IArenaAllocator*>(first_arena.get())->Shrink(), 0u);
+  auto shrunk_stats = cache.GetStats();
+  EXPECT_GT(shrunk_stats.bytes_cached, stats.bytes_cached);
+  EXPECT_LT(shrunk_stats.bytes_in_use, stats.bytes_in_use);
+
+  // and the second arena reuses it without cudaMalloc
+  void* second_addr = second_arena->Alloc(1024);
+  EXPECT_TRUE(second_addr);
+  auto reused_stats = cache.GetStats();
+  EXPECT_EQ(reused_stats.num_cuda_mallocs, shrunk_stats.num_cuda_mallocs);
+  EXPECT_EQ(reused_stats.num_cache_hits, shrunk_stats.num_cache_hits + 1);
+  second_arena->Free(second_addr);
+}
+
+TEST(AllocatorTest, CUDAPinnedStagingPoolReusesBuffers) {
+  auto& pool = CUDAPinnedStagingPool::Get(0);
+  void* buffer = pool.Acquire();
+  ASSERT_TRUE(buffer);
+  pool.Release(buffer, cudaStreamPerThread);
+  ASSERT_EQ(cudaStreamSynchronize(cudaStreamPerThread), cudaSuccess);
+
+  // the copies of the released buffer are done, so a buffer is handed out again without allocating another one
+  auto stats = pool.GetStats();
+  void* reused = pool.Acquire();
+  ASSERT_TRUE(reused);
+  EXPECT_EQ(pool.GetStats().num_buffers, stats.num_buffers);
+  pool.Release(reused, cudaStreamPerThread);
+}
+
+TEST(AllocatorTest, GPUDataTransferStagesPageableCopies) {
+  DeviceAllocatorRegistrationInfo default_memory_info({OrtMemTypeDefault,
+                                                          [](int id) { return std::make_unique<CUDAAllocator>(id, CUDA); }, std::numeric_limits<size_t>::max()});
+  auto cuda_arena = CreateAllocator(default_memory_info, 0);
+  const auto& cpu_arena = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+
+  // a few chunks and a partial one
+  const int64_t num_elements = static_cast<int64_t>(CUDAPinnedStagingPool::kBufferSize / sizeof(float)) * 5 / 2 + 3;
+  Tensor cpu_input(DataTypeImpl::GetType<float>(), TensorShape({num_elements}), cpu_arena);
+  Tensor gpu_tensor(DataTypeImpl::GetType<float>(), TensorShape({num_elements}), cuda_arena);
+  Tensor cpu_output(DataTypeImpl::GetType<float>(), TensorShape({num_elements}), cpu_arena);
+  float* input = cpu_input.MutableData<float>();
+  for (int64_t i = 0; i < num_elements; ++i) {
+    input[i] = static_cast<float>(i % 1000);
+  }
+
+  GPUDataTransfer data_transfer;
+  ASSERT_TRUE(data_transfer.CopyTensor(cpu_input, gpu_tensor, 0).IsOK());
+  // the input may be overwritten as soon as the copy returns
+  std::fill(input, input + num_elements, -1.0f);
+  ASSERT_TRUE(data_transfer.CopyTensor(gpu_tensor, cpu_output, 0).IsOK());
+
+  const float* output = cpu_output.Data<float>();
+  for (int64_t i = 0; i < num_elements; ++i) {
+    ASSERT_EQ(output[i], static_cast<float>(i % 1000)) << i;
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
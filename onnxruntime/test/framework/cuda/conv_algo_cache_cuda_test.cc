@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "core/providers/cuda/nn/conv_algo_cache.h"
+
+namespace onnxruntime {
+namespace test {
+
+using cuda::CudnnConvAlgoCache;
+
+static CudnnConvAlgoCache::Key MakeTestKey(CudnnConvAlgoCache::Search search, int64_t batch_size) {
+  return CudnnConvAlgoCache::MakeKey(search, CUDNN_DATA_FLOAT, 0,
+                                     {batch_size, 3, 32, 32}, {8, 3, 3, 3}, {batch_size, 8, 30, 30},
+                                     {0, 0, 0, 0}, {1, 1}, {1, 1}, 1);
+}
+
+TEST(CudnnConvAlgoCacheTest, KeysDifferByConvolution) {
+  EXPECT_EQ(MakeTestKey(CudnnConvAlgoCache::Search::Forward, 1), MakeTestKey(CudnnConvAlgoCache::Search::Forward, 1));
+  EXPECT_NE(MakeTestKey(CudnnConvAlgoCache::Search::Forward, 1), MakeTestKey(CudnnConvAlgoCache::Search::Forward, 2));
+  EXPECT_NE(MakeTestKey(CudnnConvAlgoCache::Search::Forward, 1),
+            MakeTestKey(CudnnConvAlgoCache::Search::BackwardData, 1));
+}
+
+TEST(CudnnConvAlgoCacheTest, SaveAndLoad) {
+  auto& cache = CudnnConvAlgoCache::Instance();
+  cache.Clear();
+
+  const auto forward_key = MakeTestKey(CudnnConvAlgoCache::Search::Forward, 1);
+  const auto backward_key = MakeTestKey(CudnnConvAlgoCache::Search::BackwardData, 4);
+  cache.Insert(forward_key, {1, 1024, CUDNN_DEFAULT_MATH});
+  cache.Insert(backward_key, {3, 0, CUDNN_TENSOR_OP_MATH});
+
+  const std::string path = "cudnn_conv_algo_cache_test.txt";
+  ASSERT_TRUE(cache.Save(path).IsOK());
+  cache.Clear();
+  ASSERT_EQ(cache.Size(), 0u);
+
+  ASSERT_TRUE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 2u);
+
+  CudnnConvAlgoCache::Result result;
+  ASSERT_TRUE(cache.Find(forward_key, result));
+  EXPECT_EQ(result.algo, 1);
+  EXPECT_EQ(result.memory, 1024u);
+  EXPECT_EQ(result.math_type, CUDNN_DEFAULT_MATH);
+  ASSERT_TRUE(cache.Find(backward_key, result));
+  EXPECT_EQ(result.algo, 3);
+  EXPECT_EQ(result.memory, 0u);
+  EXPECT_EQ(result.math_type, CUDNN_TENSOR_OP_MATH);
+
+  // entries of the file don't replace the ones found since
+  cache.Insert(forward_key, {2, 0, CUDNN_DEFAULT_MATH});
+  ASSERT_TRUE(cache.Load(path).IsOK());
+  ASSERT_TRUE(cache.Find(forward_key, result));
+  EXPECT_EQ(result.algo, 2);
+
+  cache.Clear();
+  std::remove(path.c_str());
+}
+
+TEST(CudnnConvAlgoCacheTest, LoadIgnoresMissingAndStaleFiles) {
+  auto& cache = CudnnConvAlgoCache::Instance();
+  cache.Clear();
+
+  EXPECT_TRUE(cache.Load("no_such_cudnn_conv_algo_cache.txt").IsOK());
+
+  const std::string path = "stale_cudnn_conv_algo_cache_test.txt";
+  {
+    std::ofstream file(path);
+    file << "onnxruntime_cudnn_conv_algo_cache " << cudnnGetVersion() + 1 << "\n1 42 1 0 0\n";
+  }
+  EXPECT_TRUE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 0u);
+
+  {
+    std::ofstream file(path);
+    file << "not a cache\n";
+  }
+  EXPECT_FALSE(cache.Load(path).IsOK());
+
+  {
+    std::ofstream file(path);
+    file << "onnxruntime_cudnn_conv_algo_cache " << cudnnGetVersion() << "\n2 42\n";
+  }
+  EXPECT_FALSE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 0u);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
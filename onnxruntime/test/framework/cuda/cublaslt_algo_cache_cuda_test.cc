@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "core/providers/cuda/math/cublaslt_gemm.h"
+
+#ifdef USE_CUBLASLT
+
+namespace onnxruntime {
+namespace test {
+
+using cuda::CublasLtAlgoCache;
+using cuda::CublasLtEpilogue;
+using cuda::CublasLtGemmArgs;
+
+static CublasLtGemmArgs MakeTestArgs(int batch_count, CublasLtEpilogue epilogue) {
+  CublasLtGemmArgs args;
+  args.m = 64;
+  args.n = 32;
+  args.k = 16;
+  args.lda = 64;
+  args.ldb = 16;
+  args.ldc = 64;
+  args.stride_a = 64 * 16;
+  args.stride_c = 64 * 32;
+  args.batch_count = batch_count;
+  args.epilogue = epilogue;
+  return args;
+}
+
+TEST(CublasLtAlgoCacheTest, KeysDifferByGemm) {
+  const auto args = MakeTestArgs(1, CublasLtEpilogue::Default);
+  EXPECT_EQ(CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args), CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args));
+  EXPECT_NE(CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args), CublasLtAlgoCache::MakeKey(CUDA_R_16F, 0, args));
+  EXPECT_NE(CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args),
+            CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, MakeTestArgs(2, CublasLtEpilogue::Default)));
+  EXPECT_NE(CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args),
+            CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, MakeTestArgs(1, CublasLtEpilogue::ReluBias)));
+
+  // the algorithms may depend on the alignment of the pointers
+  auto misaligned = args;
+  misaligned.a = reinterpret_cast<const void*>(static_cast<uintptr_t>(4));
+  EXPECT_NE(CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, args), CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, misaligned));
+}
+
+TEST(CublasLtAlgoCacheTest, SaveAndLoad) {
+  auto& cache = CublasLtAlgoCache::Instance();
+  cache.Clear();
+
+  const auto key = CublasLtAlgoCache::MakeKey(CUDA_R_32F, 0, MakeTestArgs(4, CublasLtEpilogue::Default));
+  const auto unsupported_key = CublasLtAlgoCache::MakeKey(CUDA_R_64F, 0, MakeTestArgs(1, CublasLtEpilogue::GeluBias));
+  cache.Insert(key, {true, {1, 2, 3, 4, 5, 6, 7, 8}, 4096});
+  cache.Insert(unsupported_key, {false, {}, 0});
+
+  const std::string path = "cublaslt_algo_cache_test.txt";
+  ASSERT_TRUE(cache.Save(path).IsOK());
+  cache.Clear();
+  ASSERT_EQ(cache.Size(), 0u);
+
+  ASSERT_TRUE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 2u);
+
+  CublasLtAlgoCache::Result result;
+  ASSERT_TRUE(cache.Find(key, result));
+  EXPECT_TRUE(result.found);
+  EXPECT_EQ(result.algo[0], 1u);
+  EXPECT_EQ(result.algo[7], 8u);
+  EXPECT_EQ(result.workspace_size, 4096u);
+  ASSERT_TRUE(cache.Find(unsupported_key, result));
+  EXPECT_FALSE(result.found);
+
+  cache.Clear();
+  std::remove(path.c_str());
+}
+
+TEST(CublasLtAlgoCacheTest, LoadIgnoresMissingAndStaleFiles) {
+  auto& cache = CublasLtAlgoCache::Instance();
+  cache.Clear();
+
+  EXPECT_TRUE(cache.Load("no_such_cublaslt_algo_cache.txt").IsOK());
+
+  const std::string path = "stale_cublaslt_algo_cache_test.txt";
+  {
+    std::ofstream file(path);
+    file << "onnxruntime_cublaslt_algo_cache " << cublasLtGetVersion() + 1 << "\n1 42 1 0 0 0 0 0 0 0 0 0\n";
+  }
+  EXPECT_TRUE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 0u);
+
+  {
+    std::ofstream file(path);
+    file << "not a cache\n";
+  }
+  EXPECT_FALSE(cache.Load(path).IsOK());
+
+  {
+    std::ofstream file(path);
+    file << "onnxruntime_cublaslt_algo_cache " << cublasLtGetVersion() << "\n1 42 1 0\n";
+  }
+  EXPECT_FALSE(cache.Load(path).IsOK());
+  EXPECT_EQ(cache.Size(), 0u);
+
+  std::remove(path.c_str());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // USE_CUBLASLT
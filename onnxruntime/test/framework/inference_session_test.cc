@@ -7,6 +7,7 @@
 #include <cfloat>
 #include <functional>
 #include <iterator>
+#include <numeric>
 #include <thread>
 #include <fstream>
 
@@ -29,7 +30,9 @@
 #ifdef USE_CUDA
 #include "core/providers/cuda/gpu_data_transfer.h"
 #endif
+#include "core/session/environment.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
@@ -125,9 +128,18 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
                                            logging::LoggingManager* logging_manager) : InferenceSession(session_options, logging_manager) {
   }
 
+  InferenceSessionGetGraphWrapper(const SessionOptions& session_options, const Environment& session_env,
+                                  logging::LoggingManager* logging_manager)
+      : InferenceSession(session_options, session_env, logging_manager) {
+  }
+
   const Graph& GetGraph() {
     return model_->MainGraph();
   }
+
+  const SessionState& GetSessionState() {
+    return session_state_;
+  }
 };
 
 namespace test {
@@ -340,6 +352,24 @@ TEST(InferenceSessionTests, NoTimeout) {
   RunModel(session_object, run_options);
 }
 
+// The CPU provider can't capture graphs, so the Runs are executed normally.
+TEST(InferenceSessionTests, GraphCaptureWithoutProviderSupport) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.GraphCaptureWithoutProviderSupport";
+  so.enable_graph_capture = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+  for (int run = 0; run < 3; ++run) {
+    RunModel(session_object, run_options, true);
+  }
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -426,6 +456,60 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(model_fs_Level3.fail());
 }
 
+TEST(InferenceSessionTests, TestOptimizedModelRestoresNodePlacement) {
+  SessionOptions so;
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  so.session_logid = "InferenceSessionTests.TestOptimizedModelRestoresNodePlacement";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.optimized_model_filepath = ToWideString(test_model + "-NodePlacement");
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // Reload the optimized model without serializing it again.
+  SessionOptions so_opt;
+  so_opt.session_logid = "InferenceSessionTests.TestOptimizedModelRestoresNodePlacement";
+  InferenceSessionGetGraphWrapper session_object_opt{so_opt, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object_opt.Load(so.optimized_model_filepath).IsOK());
+
+  auto metadata = session_object_opt.GetModelMetadata();
+  ASSERT_TRUE(metadata.first.IsOK());
+  auto placement = metadata.second->custom_metadata_map.find("onnxruntime.optimized_node_placement");
+  ASSERT_TRUE(placement != metadata.second->custom_metadata_map.cend());
+  ASSERT_FALSE(placement->second.empty());
+
+  ASSERT_TRUE(session_object_opt.Initialize().IsOK());
+  const auto& graph = session_object_opt.GetGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Identity"] == 0);
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+  }
+}
+
+TEST(InferenceSessionTests, TestOptimizationReport) {
+  SessionOptions so;
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  so.session_logid = "InferenceSessionTests.TestOptimizationReport";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  so.optimization_report_filepath = ToWideString(test_model + "-OptimizationReport.json");
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::ifstream report_file(so.optimization_report_filepath);
+  ASSERT_TRUE(report_file);
+  std::string report((std::istreambuf_iterator<char>(report_file)), std::istreambuf_iterator<char>());
+
+  // the Identity node is removed by the rule of the level 1 rule based transformer
+  EXPECT_NE(report.find("\"name\": \"Level1_RuleBasedTransformer\", \"level\": 1"), string::npos) << report;
+  EXPECT_NE(report.find("\"EliminateIdentity\": 1"), string::npos) << report;
+  EXPECT_NE(report.find("\"name\": \"MemcpyTransformer\""), string::npos) << report;
+  EXPECT_EQ(report.find("\"Identity\""), string::npos) << report;
+  EXPECT_NE(report.find("\"Abs\": {\"CPUExecutionProvider\": 1}"), string::npos) << report;
+  EXPECT_NE(report.find("\"execution_providers\": {\"CPUExecutionProvider\": 2}"), string::npos) << report;
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -550,6 +634,61 @@ TEST(InferenceSessionTests, CheckRunLogger) {
 #endif
 }
 
+TEST(InferenceSessionTests, LoadComposedModels) {
+  SessionOptions so;
+  so.session_logid = "LoadComposedModels";
+
+  // Y = X * W twice, the second model fed by the output of the first one
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  const std::basic_string<ORTCHAR_T> model_uri = ToWideString(MODEL_URI);
+  auto status = session_object.LoadComposed({model_uri, model_uri}, {{}, {{"X", "Y"}}});
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto inputs = session_object.GetModelInputs();
+  ASSERT_TRUE(inputs.first.IsOK());
+  ASSERT_EQ(inputs.second->size(), 1u);
+  EXPECT_EQ((*inputs.second)[0]->Name(), "X");
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<OrtValue> fetches;
+  status = session_object.Run(RunOptions(), feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, {3, 2}, {1.0f, 8.0f, 27.0f, 64.0f, 125.0f, 216.0f});
+
+  // the second model's input has no output to be fed by otherwise, and the outputs of both models collide
+  InferenceSession unmapped_session{so, &DefaultLoggingManager()};
+  EXPECT_FALSE(unmapped_session.LoadComposed({model_uri, model_uri}).IsOK());
+}
+
+TEST(InferenceSessionTests, RunPastDeadlineFails) {
+  SessionOptions so;
+  so.session_logid = "RunPastDeadlineFails";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<OrtValue> fetches;
+
+  RunOptions run_options;
+  run_options.deadline = std::chrono::steady_clock::now();
+  auto status = session_object.Run(run_options, feeds, {"Y"}, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("deadline"), std::string::npos) << status.ErrorMessage();
+
+  // a deadline that isn't reached doesn't change the Run
+  run_options.deadline = std::chrono::steady_clock::now() + std::chrono::hours(1);
+  RunModel(session_object, run_options);
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   SessionOptions so;
 
@@ -571,24 +710,48 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
   ASSERT_TRUE(profile);
   std::string line;
 
-  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
-  int count = 0;
+  std::vector<std::string> lines;
   while (std::getline(profile, line)) {
-    if (count == 0) {
-      ASSERT_TRUE(line.find("[") != string::npos);
-    } else if (count <= 7) {
-      for (auto& s : tags) {
-        ASSERT_TRUE(line.find(s) != string::npos);
-      }
-    } else {
-      ASSERT_TRUE(line.find("]") != string::npos);
-    }
+    lines.push_back(line);
+  }
+  ASSERT_GE(lines.size(), 3u);
+  ASSERT_TRUE(lines.front().find("[") != string::npos);
+  ASSERT_TRUE(lines.back().find("]") != string::npos);
 
-    if (count == 1) {
-      ASSERT_TRUE(line.find("model_loading_uri") != string::npos);
+  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
+  bool has_model_loading = false;
+  for (size_t i = 1; i < lines.size() - 1; ++i) {
+    for (auto& s : tags) {
+      ASSERT_TRUE(lines[i].find(s) != string::npos);
     }
-    count++;
+    has_model_loading = has_model_loading || lines[i].find("model_loading_uri") != string::npos;
   }
+  ASSERT_TRUE(has_model_loading);
+}
+
+TEST(InferenceSessionTests, CheckProfilerRecordsInitializationEvents) {
+  SessionOptions so;
+
+  so.session_logid = "CheckProfilerRecordsInitializationEvents";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_initialization_test");
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string content((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+
+  for (const char* name : {"model_proto_parsing", "graph_construction", "graph_resolve", "model_loading_uri",
+                           "partitioning_CPUExecutionProvider", "CastFloat16Transformer", "MemcpyTransformer",
+                           "memory_plan_creation", "initializer_unpacking", "kernel_creation",
+                           "session_initialization"}) {
+    EXPECT_NE(content.find(std::string("\"") + name + "\""), string::npos) << name;
+  }
+  EXPECT_NE(content.find("\"node_count_before\""), string::npos);
 }
 
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
@@ -630,6 +793,208 @@ TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   }
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerRecordsMemoryEvents) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerRecordsMemoryEvents";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_memory_test");
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string content((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+
+  // the output of the Mul node, allocated by the frame
+  EXPECT_NE(content.find("\"Memory\""), string::npos);
+  EXPECT_NE(content.find("Y_alloc"), string::npos);
+  EXPECT_NE(content.find("\"alloc_kind\" : \"AllocateOutput\""), string::npos);
+#ifndef USE_JEMALLOC
+  EXPECT_NE(content.find("arena_peak"), string::npos);
+#endif
+}
+
+// device profiler whose kernels complete when the profiler waits for them
+class TestEpProfiler : public profiling::EpProfiler {
+ public:
+  size_t Start() override { return next_id_++; }
+
+  void Stop(size_t id, const std::string& event_name, std::unordered_map<std::string, std::string>&& event_args) override {
+    stopped_.emplace_back(profiling::NODE_EVENT, 0, 0, event_name + "_" + std::to_string(id), 0, 1,
+                          std::move(event_args));
+  }
+
+  void Collect(bool wait, TimePoint /*profiling_start_time*/, std::vector<EventRecord>& events) override {
+    ++num_collects_;
+    if (!wait) return;
+    for (auto& event : stopped_) {
+      events.push_back(std::move(event));
+    }
+    stopped_.clear();
+  }
+
+  size_t next_id_ = 0;
+  int num_collects_ = 0;
+  std::vector<EventRecord> stopped_;
+};
+
+TEST(InferenceSessionTests, CheckProfilerCollectsEpEvents) {
+  profiling::Profiler profiler;
+  profiler.Initialize(&DefaultLoggingManager().DefaultLogger());
+  profiler.StartProfiling(std::string("onnxruntime_profile_ep_test.json"));
+
+  auto ep_profiler = std::make_unique<TestEpProfiler>();
+  auto* test_ep_profiler = ep_profiler.get();
+  profiler.AddEpProfiler("TestEP", std::move(ep_profiler));
+  ASSERT_EQ(profiler.GetEpProfiler("TestEP"), test_ep_profiler);
+  ASSERT_EQ(profiler.GetEpProfiler(kCpuExecutionProvider), nullptr);
+
+  auto id = test_ep_profiler->Start();
+  test_ep_profiler->Stop(id, "node", {{"input_shapes", "{3,2}"}});
+
+  // not completed yet
+  profiler.CollectEpEvents();
+  EXPECT_EQ(test_ep_profiler->num_collects_, 1);
+
+  // EndProfiling waits for the device events
+  std::string profile_file = profiler.EndProfiling();
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string content((std::istreambuf_iterator<char>(profile)), std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find("node_0"), string::npos);
+  EXPECT_NE(content.find("input_shapes"), string::npos);
+}
+
+TEST(InferenceSessionTests, CheckNodeStats) {
+  SessionOptions so;
+
+  so.session_logid = "CheckNodeStats";
+  so.enable_node_stats = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::vector<NodeStats> node_stats;
+  ASSERT_TRUE(session_object.GetNodeStats(node_stats).IsOK());
+  EXPECT_TRUE(node_stats.empty());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  ASSERT_TRUE(session_object.GetNodeStats(node_stats).IsOK());
+  ASSERT_EQ(node_stats.size(), 1u);
+  EXPECT_EQ(node_stats[0].op_type, "Mul");
+  EXPECT_EQ(node_stats[0].count, 2u);
+  EXPECT_LE(node_stats[0].min_ns, node_stats[0].max_ns);
+  EXPECT_LE(node_stats[0].max_ns, node_stats[0].total_ns);
+  // the 3x2 float output of every Run
+  EXPECT_EQ(node_stats[0].output_bytes, 2 * 6 * sizeof(float));
+
+  ASSERT_TRUE(session_object.ResetNodeStats().IsOK());
+  ASSERT_TRUE(session_object.GetNodeStats(node_stats).IsOK());
+  EXPECT_TRUE(node_stats.empty());
+
+  // not collected unless enabled
+  InferenceSession session_without_stats(SessionOptions{});
+  ASSERT_TRUE(session_without_stats.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_without_stats.Initialize().IsOK());
+  EXPECT_FALSE(session_without_stats.GetNodeStats(node_stats).IsOK());
+}
+
+TEST(InferenceSessionTests, CheckCalibrationRanges) {
+  SessionOptions so;
+
+  so.session_logid = "CheckCalibrationRanges";
+  so.enable_calibration = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the graph input and the output of the Mul squaring it
+  std::unordered_map<std::string, TensorRange> ranges;
+  ASSERT_TRUE(session_object.GetCalibrationRanges(100.f, ranges).IsOK());
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges["X"].min, 1.f);
+  EXPECT_EQ(ranges["X"].max, 6.f);
+  EXPECT_EQ(ranges["Y"].min, 1.f);
+  EXPECT_EQ(ranges["Y"].max, 36.f);
+  EXPECT_FALSE(session_object.GetCalibrationRanges(0.f, ranges).IsOK());
+
+  ASSERT_TRUE(session_object.ResetCalibration().IsOK());
+  ASSERT_TRUE(session_object.GetCalibrationRanges(100.f, ranges).IsOK());
+  EXPECT_TRUE(ranges.empty());
+
+  // not collected unless enabled
+  InferenceSession session_without_calibration(SessionOptions{});
+  ASSERT_TRUE(session_without_calibration.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_without_calibration.Initialize().IsOK());
+  EXPECT_FALSE(session_without_calibration.GetCalibrationRanges(100.f, ranges).IsOK());
+}
+
+TEST(InferenceSessionTests, WarmUpRunsAtInitialization) {
+  SessionOptions so;
+
+  so.session_logid = "WarmUpRunsAtInitialization";
+  so.warmup_runs = 2;
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_warmup_test");
+  so.enable_node_stats = true;
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the warmup Runs aren't counted in the statistics of the user
+  std::vector<NodeStats> node_stats;
+  ASSERT_TRUE(session_object.GetNodeStats(node_stats).IsOK());
+  EXPECT_TRUE(node_stats.empty());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  std::string line;
+  size_t num_warmup_events = 0, num_model_runs = 0;
+  while (std::getline(profile, line)) {
+    num_warmup_events += line.find("\"name\" :\"warmup\"") != string::npos ? 1 : 0;
+    num_model_runs += line.find("model_run") != string::npos ? 1 : 0;
+  }
+  EXPECT_EQ(num_warmup_events, 1u);
+  EXPECT_EQ(num_model_runs, 3u);
+}
+
+TEST(InferenceSessionTests, WarmUpFailsWithoutInputs) {
+  SessionOptions so;
+
+  so.session_logid = "WarmUpFailsWithoutInputs";
+  so.warmup_runs = 1;
+  so.warmup_inputs_path = ORT_TSTR("testdata/no_such_directory");
+
+  InferenceSession session_object(so);
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  auto status = session_object.Initialize();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("No warmup input"));
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  EXPECT_FALSE(session_object.Run(run_options, NameMLValMap{}, {"Y"}, &fetches).IsOK());
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -654,6 +1019,40 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, SessionsShareEnvironmentThreadPools) {
+  ThreadingOptions threading_options;
+  threading_options.intra_op_num_threads = 2;
+  threading_options.intra_op_thread_options.allow_spinning = false;
+  // the pool may not be able to pin its threads, e.g. in a container limited to other processors,
+  // so this only checks the pool works with the option
+  threading_options.intra_op_thread_options.affinity = {0};
+  // the Environments aren't destroyed as that shuts down protobuf for the rest of the tests
+  std::unique_ptr<Environment> owned_env;
+  ASSERT_TRUE(Environment::Create(owned_env, threading_options).IsOK());
+  const Environment* env = owned_env.release();
+  ASSERT_TRUE(env->HasGlobalThreadPools());
+  ASSERT_NE(env->GetIntraOpThreadPool(), nullptr);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SessionsShareEnvironmentThreadPools";
+  so.use_per_session_threads = false;
+
+  InferenceSessionGetGraphWrapper session_1{so, *env, &DefaultLoggingManager()};
+  InferenceSessionGetGraphWrapper session_2{so, *env, &DefaultLoggingManager()};
+  for (auto* session : {&session_1, &session_2}) {
+    ASSERT_TRUE(session->Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session->Initialize().IsOK());
+    ASSERT_EQ(session->GetSessionState().GetThreadPool(), env->GetIntraOpThreadPool());
+    RunModel(*session, RunOptions{});
+  }
+
+  // an Environment without global thread pools can't be used
+  std::unique_ptr<Environment> owned_env_without_pools;
+  ASSERT_TRUE(Environment::Create(owned_env_without_pools).IsOK());
+  const Environment* env_without_pools = owned_env_without_pools.release();
+  ASSERT_THROW(InferenceSession(so, *env_without_pools, &DefaultLoggingManager()), OnnxRuntimeException);
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -791,6 +1190,471 @@ static void TestBindHelper(const std::string& log_str,
                             allocation_provider);
 }
 
+TEST(InferenceSessionTests, TestPreparedRun) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.TestPreparedRun";
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  std::unique_ptr<PreparedRun> prepared_run;
+  ASSERT_FALSE(session_object.NewPreparedRun({"X"}, {"Z"}, {}, {}, &prepared_run).IsOK());
+  ASSERT_TRUE(session_object.NewPreparedRun({"X"}, {"Y"}, {}, {}, &prepared_run).IsOK());
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // the prepared run is reused with new values, and preallocated fetches
+  for (int i = 0; i < 2; ++i) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &ml_value);
+    std::vector<OrtValue> fetches;
+    if (i == 1) {
+      fetches.resize(1);
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                           &fetches[0]);
+    }
+
+    common::Status st = session_object.Run(run_options, *prepared_run, {ml_value}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // the values are still validated by each Run
+  std::vector<int64_t> values_int = {1, 2, 3, 4, 5, 6};
+  OrtValue int_value;
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_int,
+                         &int_value);
+  std::vector<OrtValue> fetches;
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, {int_value}, &fetches).IsOK());
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, {}, &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, TestSharedInitializers) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  ONNX_NAMESPACE::TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weights.add_dims(3);
+  weights.add_dims(2);
+  for (int i = 0; i < 6; ++i) {
+    weights.add_float_data(1.0f);
+  }
+  graph.AddInitializedTensor(weights);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& weights_arg = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("node_1", "Add", "node 1.", {&input_arg, &weights_arg}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> values_w = {10.0f, 20.0f, 30.0f, 40.0f, 50.0f, 60.0f};
+  std::vector<float> expected_values_y = {11.0f, 22.0f, 33.0f, 44.0f, 55.0f, 66.0f};
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestSharedInitializers";
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_w,
+                       &so.initializers_to_share["W"]);
+  const float* shared_data = so.initializers_to_share["W"].Get<Tensor>().Data<float>();
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x,
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  // both sessions use the shared value instead of the one in the model
+  for (int i = 0; i < 2; ++i) {
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    std::stringstream sstr(serialized_model);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    common::Status st = session_object.Initialize();
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    int idx;
+    ASSERT_TRUE(session_object.GetSessionState().GetOrtValueNameIdxMap().GetIdx("W", idx).IsOK());
+    const auto& initializers = session_object.GetSessionState().GetInitializedTensors();
+    ASSERT_EQ(initializers.at(idx).Get<Tensor>().Data<float>(), shared_data);
+
+    std::vector<OrtValue> fetches;
+    st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, dims_x, expected_values_y);
+  }
+
+  // a value that doesn't match the initializer, or that isn't one, is an error
+  SessionOptions bad_so;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {6}, values_w,
+                       &bad_so.initializers_to_share["W"]);
+  InferenceSession bad_shape_session{bad_so, &DefaultLoggingManager()};
+  std::stringstream bad_shape_sstr(serialized_model);
+  ASSERT_TRUE(bad_shape_session.Load(bad_shape_sstr).IsOK());
+  ASSERT_FALSE(bad_shape_session.Initialize().IsOK());
+
+  bad_so.initializers_to_share.clear();
+  bad_so.initializers_to_share["V"] = so.initializers_to_share["W"];
+  InferenceSession bad_name_session{bad_so, &DefaultLoggingManager()};
+  std::stringstream bad_name_sstr(serialized_model);
+  ASSERT_TRUE(bad_name_session.Load(bad_name_sstr).IsOK());
+  ASSERT_FALSE(bad_name_session.Initialize().IsOK());
+}
+
+// Test that an initializer is released once every kernel using it has pre-packed it, and kept otherwise.
+TEST(InferenceSessionTests, TestPrePackedInitializerIsReleased) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](int64_t rows, int64_t columns) {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(rows);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(columns);
+    return type;
+  };
+  auto add_weights = [&graph](const std::string& name, const std::vector<float>& values) {
+    ONNX_NAMESPACE::TensorProto weights;
+    weights.set_name(name);
+    weights.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weights.add_dims(3);
+    weights.add_dims(2);
+    for (float value : values) {
+      weights.add_float_data(value);
+    }
+    graph.AddInitializedTensor(weights);
+  };
+
+  // W is only used by a MatMul, which packs it, while V is also read by an Identity
+  add_weights("W", {1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f});
+  add_weights("V", {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f});
+
+  auto x_type = make_type(2, 3);
+  auto w_type = make_type(3, 2);
+  auto y_type = make_type(2, 2);
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& w_arg = graph.GetOrCreateNodeArg("W", &w_type);
+  auto& v_arg = graph.GetOrCreateNodeArg("V", &w_type);
+  auto& y_arg = graph.GetOrCreateNodeArg("Y", &y_type);
+  auto& z_arg = graph.GetOrCreateNodeArg("Z", &y_type);
+  auto& v_copy_arg = graph.GetOrCreateNodeArg("V_copy", &w_type);
+  graph.AddNode("node_1", "MatMul", "node 1.", {&x_arg, &w_arg}, {&y_arg});
+  graph.AddNode("node_2", "MatMul", "node 2.", {&x_arg, &v_arg}, {&z_arg});
+  graph.AddNode("node_3", "Identity", "node 3.", {&v_arg}, {&v_copy_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestPrePackedInitializerIsReleased";
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(serialized_model);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  common::Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  const auto& session_state = session_object.GetSessionState();
+  const auto& initializers = session_state.GetInitializedTensors();
+  int w_idx, v_idx;
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("W", w_idx).IsOK());
+  ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("V", v_idx).IsOK());
+  EXPECT_EQ(initializers.count(w_idx), 0u);
+  EXPECT_EQ(initializers.count(v_idx), 1u);
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  std::vector<OrtValue> fetches;
+  st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {2, 2}, {4.0f, 5.0f, 10.0f, 11.0f});
+
+  fetches.clear();
+  st = session_object.Run(RunOptions{}, feeds, {"Z"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+  VerifyOutputs(fetches, {2, 2}, {6.0f, 6.0f, 15.0f, 15.0f});
+}
+
+TEST(InferenceSessionTests, TestShapeSubgraphCache) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto x_type;
+  x_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (const char* dim : {"A", "B", "C"}) {
+    x_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param(dim);
+  }
+
+  auto add_int64s = [&graph](const std::string& name, int64_t value) {
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.set_name(name);
+    tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    tensor.add_dims(1);
+    tensor.add_int64_data(value);
+    graph.AddInitializedTensor(tensor);
+  };
+  add_int64s("zero", 0);
+  add_int64s("minus_one", -1);
+
+  // Y = Reshape(X, Concat(Gather(Shape(X), [0]), [-1])), which flattens all but the first dimension of X
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& shape_arg = graph.GetOrCreateNodeArg("shape", nullptr);
+  auto& zero_arg = graph.GetOrCreateNodeArg("zero", nullptr);
+  auto& minus_one_arg = graph.GetOrCreateNodeArg("minus_one", nullptr);
+  auto& first_dim_arg = graph.GetOrCreateNodeArg("first_dim", nullptr);
+  auto& target_arg = graph.GetOrCreateNodeArg("target", nullptr);
+  auto& y_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("shape", "Shape", "", {&x_arg}, {&shape_arg});
+  graph.AddNode("gather", "Gather", "", {&shape_arg, &zero_arg}, {&first_dim_arg});
+  graph.AddNode("concat", "Concat", "", {&first_dim_arg, &minus_one_arg}, {&target_arg})
+      .AddAttribute("axis", int64_t(0));
+  graph.AddNode("reshape", "Reshape", "", {&x_arg, &target_arg}, {&y_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestShapeSubgraphCache";
+  InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(serialized_model);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  common::Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  const ShapeSubgraphCache* cache = session_object.GetSessionState().GetShapeSubgraphCache();
+  ASSERT_NE(cache, nullptr);
+  EXPECT_EQ(cache->NumRoots(), 1u);
+  // Gather and Concat
+  EXPECT_EQ(cache->NumCachedNodes(), 2u);
+
+  auto run = [&session_object](const std::vector<int64_t>& x_dims, const std::vector<int64_t>& expected_dims) {
+    std::vector<float> values(static_cast<size_t>(x_dims[0] * x_dims[1] * x_dims[2]));
+    std::iota(values.begin(), values.end(), 0.0f);
+    OrtValue ml_value_x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), x_dims, values,
+                         &ml_value_x);
+    NameMLValMap feeds{{"X", ml_value_x}};
+    std::vector<OrtValue> fetches;
+    common::Status status = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, expected_dims, values);
+  };
+
+  run({2, 3, 2}, {2, 6});
+  EXPECT_EQ(cache->NumEntries(), 2u);
+  // other shapes get their own entries
+  run({3, 2, 2}, {3, 4});
+  EXPECT_EQ(cache->NumEntries(), 4u);
+  // and the same shapes reuse them
+  run({2, 3, 2}, {2, 6});
+  run({3, 2, 2}, {3, 4});
+  EXPECT_EQ(cache->NumEntries(), 4u);
+  // a different shape with the same first dimension
+  run({2, 1, 2}, {2, 2});
+  EXPECT_EQ(cache->NumEntries(), 6u);
+}
+
+TEST(InferenceSessionTests, TestStaticMemoryPatterns) {
+  auto create_model = [](bool static_shapes, std::string& serialized_model) {
+    onnxruntime::Model model("graph_1");
+    auto& graph = model.MainGraph();
+
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    auto* dim = float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+    if (static_shapes) {
+      dim->set_dim_value(3);
+    } else {
+      dim->set_dim_param("N");
+    }
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+    // X -> A -> B -> Y, with the intermediate A and B allocated by the session
+    auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+    auto& a_arg = graph.GetOrCreateNodeArg("A", nullptr);
+    auto& b_arg = graph.GetOrCreateNodeArg("B", nullptr);
+    auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+    graph.AddNode("node_1", "Transpose", "node 1.", {&input_arg}, {&a_arg});
+    graph.AddNode("node_2", "Relu", "node 2.", {&a_arg}, {&b_arg});
+    graph.AddNode("node_3", "Add", "node 3.", {&a_arg, &b_arg}, {&output_arg});
+    ASSERT_TRUE(graph.Resolve().IsOK());
+    model.ToProto().SerializeToString(&serialized_model);
+  };
+
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x,
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  for (bool static_shapes : {true, false}) {
+    std::string serialized_model;
+    create_model(static_shapes, serialized_model);
+
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.TestStaticMemoryPatterns";
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    std::stringstream sstr(serialized_model);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    common::Status st = session_object.Initialize();
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    const auto& session_state = session_object.GetSessionState();
+    auto static_patterns = session_state.GetStaticMemoryPatternGroup();
+    if (!static_shapes) {
+      // the patterns are traced by the first Run instead
+      ASSERT_EQ(static_patterns, nullptr);
+      continue;
+    }
+
+    ASSERT_NE(static_patterns, nullptr);
+    ASSERT_EQ(static_patterns->locations.size(), 1u);
+    int a_idx, b_idx;
+    ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("A", a_idx).IsOK());
+    ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("B", b_idx).IsOK());
+    const auto& pattern = static_patterns->patterns[0];
+    const auto* a_block = pattern.GetBlock(a_idx);
+    const auto* b_block = pattern.GetBlock(b_idx);
+    ASSERT_NE(a_block, nullptr);
+    ASSERT_NE(b_block, nullptr);
+    // A and B are alive at the same time, so their blocks don't overlap
+    ASSERT_TRUE(a_block->offset_ + a_block->size_ <= b_block->offset_ ||
+                b_block->offset_ + b_block->size_ <= a_block->offset_);
+    ASSERT_EQ(pattern.PeakSize(), a_block->size_ + b_block->size_);
+
+    std::vector<OrtValue> fetches;
+    st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    VerifyOutputs(fetches, {2, 3}, {2.0f, 6.0f, 10.0f, 4.0f, 8.0f, 12.0f});
+  }
+}
+
+// the execution frames are pooled across Runs, so check Runs with different input shapes don't see each
+// other's values and the outputs of a Run outlive the frame being reused.
+TEST(InferenceSessionTests, TestExecutionFrameReuse) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& a_arg = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& b_arg = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("node_1", "Transpose", "node 1.", {&input_arg}, {&a_arg});
+  graph.AddNode("node_2", "Relu", "node 2.", {&a_arg}, {&b_arg});
+  graph.AddNode("node_3", "Add", "node 3.", {&a_arg, &b_arg}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+
+  // no reuse, a pool of a single frame and the default pool
+  for (size_t pool_size : {size_t{0}, size_t{1}, SessionOptions().execution_frame_pool_size}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.TestExecutionFrameReuse";
+    so.execution_frame_pool_size = pool_size;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    std::stringstream sstr(serialized_model);
+    ASSERT_TRUE(session_object.Load(sstr).IsOK());
+    common::Status st = session_object.Initialize();
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    auto run = [&session_object](const std::vector<int64_t>& dims, const std::vector<float>& values,
+                                 std::vector<OrtValue>& fetches) {
+      OrtValue ml_value_x;
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims, values,
+                           &ml_value_x);
+      NameMLValMap feeds{{"X", ml_value_x}};
+      common::Status st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    };
+
+    // the first Run traces the patterns for its shape, the second one uses them
+    std::vector<OrtValue> fetches_1, fetches_2, fetches_3;
+    run({3, 2}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, fetches_1);
+    run({3, 2}, {-1.0f, -2.0f, -3.0f, -4.0f, -5.0f, -6.0f}, fetches_2);
+    run({2, 2}, {1.0f, 2.0f, 3.0f, 4.0f}, fetches_3);
+
+    VerifyOutputs(fetches_1, {2, 3}, {2.0f, 6.0f, 10.0f, 4.0f, 8.0f, 12.0f});
+    VerifyOutputs(fetches_2, {2, 3}, {-1.0f, -3.0f, -5.0f, -2.0f, -4.0f, -6.0f});
+    VerifyOutputs(fetches_3, {2, 2}, {2.0f, 6.0f, 4.0f, 8.0f});
+  }
+}
+
+// the inputs are small integers, which bfloat16 represents exactly, so the products are exact with or without the
+// bfloat16 kernel.
+TEST(InferenceSessionTests, TestBf16MatMul) {
+  onnxruntime::Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // the constant right operand would otherwise be pre-packed
+  ONNX_NAMESPACE::TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weight.add_dims(3);
+  weight.add_dims(2);
+  for (float value : {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}) {
+    weight.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weight);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  graph.AddNode("node_1", "MatMul", "node 1.", {&input_arg, graph.GetNodeArg("W")}, {&output_arg});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+  std::string serialized_model;
+  model.ToProto().SerializeToString(&serialized_model);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestBf16MatMul";
+  so.use_bf16_matmul = true;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  std::stringstream sstr(serialized_model);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  common::Status st = session_object.Initialize();
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {2, 3},
+                       {1.0f, -2.0f, 3.0f, 4.0f, 5.0f, -6.0f}, &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  std::vector<OrtValue> fetches;
+  st = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+  VerifyOutputs(fetches, {2, 2}, {10.0f, 12.0f, -11.0f, -8.0f});
+}
+
 TEST(InferenceSessionTests, TestBindCpu) {
   TestBindHelper("TestBindCpu",
                  kCpuExecutionProvider,
@@ -907,6 +1771,76 @@ TEST(InferenceSessionTests, TestBindCudaPreallocateOutputOnCpu2) {
                  kCpuExecutionProvider);
 }
 
+TEST(InferenceSessionTests, TestGraphCaptureCuda) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestGraphCaptureCuda";
+  so.enable_graph_capture = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  CUDAExecutionProviderInfo epi;
+  epi.device_id = 0;
+  ASSERT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<CUDAExecutionProvider>(epi)).IsOK());
+
+  std::unique_ptr<Model> p_model;
+  CreateMatMulModel(p_model, kCudaExecutionProvider);
+  std::string s1;
+  p_model->ToProto().SerializeToString(&s1);
+  std::stringstream sstr(s1);
+  ASSERT_TRUE(session_object.Load(sstr).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto cpu_allocator = TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  auto gpu_allocator = TestCudaExecutionProvider()->GetAllocator(0, OrtMemTypeDefault);
+  std::vector<int64_t> dims_A = {3, 4};
+  std::vector<int64_t> dims_B = {4, 3};
+  std::vector<int64_t> dims_Y = {3, 3};
+  OrtValue A, B, Y;
+  AllocateMLValue<float>(gpu_allocator, dims_A, &A);
+  AllocateMLValue<float>(gpu_allocator, dims_B, &B);
+  AllocateMLValue<float>(gpu_allocator, dims_Y, &Y);
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_TRUE(session_object.NewIOBinding(&io_binding).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("A", A).IsOK());
+  ASSERT_TRUE(io_binding->BindInput("B", B).IsOK());
+  ASSERT_TRUE(io_binding->BindOutput("Y", Y).IsOK());
+
+  // the first Run is executed normally, the second one is captured and the later ones replay it,
+  // so new values written to the bound inputs must be picked up by every Run
+  std::vector<float> values_B = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f};
+  for (int run = 0; run < 4; ++run) {
+    std::vector<float> values_A(12);
+    for (size_t i = 0; i < values_A.size(); ++i) {
+      values_A[i] = static_cast<float>(i + run);
+    }
+    OrtValue cpu_A, cpu_B;
+    CreateMLValue<float>(cpu_allocator, dims_A, values_A, &cpu_A);
+    CreateMLValue<float>(cpu_allocator, dims_B, values_B, &cpu_B);
+    ASSERT_TRUE(GPUDataTransfer().CopyTensor(cpu_A.Get<Tensor>(), *A.GetMutable<Tensor>(), 0).IsOK());
+    ASSERT_TRUE(GPUDataTransfer().CopyTensor(cpu_B.Get<Tensor>(), *B.GetMutable<Tensor>(), 0).IsOK());
+
+    RunOptions run_options;
+    Status st = session_object.Run(run_options, *io_binding);
+    ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+
+    std::vector<float> expected_Y(9);
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) {
+        for (int k = 0; k < 4; ++k) {
+          expected_Y[row * 3 + col] += values_A[row * 4 + k] * values_B[k * 3 + col];
+        }
+      }
+    }
+
+    std::unique_ptr<Tensor> cpu_Y = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape(dims_Y),
+                                                              cpu_allocator);
+    ASSERT_TRUE(GPUDataTransfer().CopyTensor(io_binding->GetOutputs()[0].Get<Tensor>(), *cpu_Y, 0).IsOK());
+    OrtValue result;
+    result.Init(cpu_Y.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    VerifyOutputs({result}, dims_Y, expected_Y);
+  }
+}
+
 #endif
 
 TEST(InferenceSessionTests, ModelWithoutOpset) {
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/kernel_registry.h"
+
+#include "core/graph/model.h"
+#include "core/graph/op.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+class NoOpKernel : public OpKernel {
+ public:
+  explicit NoOpKernel(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext*) const override { return Status::OK(); }
+};
+
+KernelCreateInfo MakeCreateInfo(MLDataType type) {
+  return KernelCreateInfo(KernelDefBuilder()
+                              .SetName("KernelRegistryTestOp")
+                              .Provider(kCpuExecutionProvider)
+                              .SinceVersion(1)
+                              .TypeConstraint("T", type)
+                              .Build(),
+                          [](const OpKernelInfo& info) -> OpKernel* { return new NoOpKernel(info); });
+}
+
+Node& AddNode(Graph& graph, const std::string& name, TensorProto_DataType elem_type) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto& input = graph.GetOrCreateNodeArg(name + "_in", &type);
+  auto& output = graph.GetOrCreateNodeArg(name + "_out", &type);
+  return graph.AddNode(name, "KernelRegistryTestOp", name, {&input}, {&output});
+}
+}  // namespace
+
+TEST(KernelRegistryTest, MemoizesLookupsPerSignature) {
+  ONNX_OPERATOR_SCHEMA(KernelRegistryTestOp)
+      .SetDoc("Op of the kernel registry tests.")
+      .Input(0, "X", "input", "T")
+      .Output(0, "Y", "output", "T")
+      .TypeConstraint("T", {"tensor(float)", "tensor(int32)", "tensor(double)"}, "the type of X and Y");
+
+  onnxruntime::Model model("kernel_registry_test");
+  auto& graph = model.MainGraph();
+  const Node& float_node = AddNode(graph, "float_node", TensorProto_DataType_FLOAT);
+  const Node& other_float_node = AddNode(graph, "other_float_node", TensorProto_DataType_FLOAT);
+  const Node& int_node = AddNode(graph, "int_node", TensorProto_DataType_INT32);
+  const Node& double_node = AddNode(graph, "double_node", TensorProto_DataType_DOUBLE);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistry registry;
+  ASSERT_TRUE(registry.Register(MakeCreateInfo(DataTypeImpl::GetTensorType<float>())).IsOK());
+  ASSERT_TRUE(registry.Register(MakeCreateInfo(DataTypeImpl::GetTensorType<int32_t>())).IsOK());
+
+  const KernelCreateInfo* float_kernel = registry.TryFindKernel(float_node, kCpuExecutionProvider);
+  ASSERT_NE(float_kernel, nullptr);
+  EXPECT_EQ(float_kernel->kernel_def->TypeConstraints().at("T").front(), DataTypeImpl::GetTensorType<float>());
+  const KernelCreateInfo* int_kernel = registry.TryFindKernel(int_node, kCpuExecutionProvider);
+  ASSERT_NE(int_kernel, nullptr);
+  EXPECT_EQ(int_kernel->kernel_def->TypeConstraints().at("T").front(), DataTypeImpl::GetTensorType<int32_t>());
+  EXPECT_EQ(registry.NumCachedLookups(), 2u);
+
+  // the nodes of the same signature share the memoized lookup
+  EXPECT_EQ(registry.TryFindKernel(other_float_node, kCpuExecutionProvider), float_kernel);
+  EXPECT_EQ(registry.TryFindKernel(float_node, kCpuExecutionProvider), float_kernel);
+  EXPECT_EQ(registry.NumCachedLookups(), 2u);
+
+  // a provider without kernels for the op isn't a signature
+  EXPECT_EQ(registry.TryFindKernel(float_node, kCudaExecutionProvider), nullptr);
+  EXPECT_EQ(registry.NumCachedLookups(), 2u);
+
+  // a signature without a kernel is memoized too, until a kernel is registered
+  EXPECT_EQ(registry.TryFindKernel(double_node, kCpuExecutionProvider), nullptr);
+  EXPECT_EQ(registry.NumCachedLookups(), 3u);
+  ASSERT_TRUE(registry.Register(MakeCreateInfo(DataTypeImpl::GetTensorType<double>())).IsOK());
+  EXPECT_EQ(registry.NumCachedLookups(), 0u);
+  const KernelCreateInfo* double_kernel = registry.TryFindKernel(double_node, kCpuExecutionProvider);
+  ASSERT_NE(double_kernel, nullptr);
+  EXPECT_EQ(double_kernel->kernel_def->TypeConstraints().at("T").front(), DataTypeImpl::GetTensorType<double>());
+  EXPECT_EQ(registry.TryFindKernel(float_node, kCpuExecutionProvider), float_kernel);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -283,6 +283,110 @@ TEST(TransformerTest, TestCopyNodeInsertionInitializerInSubgraph) {
   EXPECT_TRUE(modified);
 }
 
+TEST(TransformerTest, MemcpyTransformerCoalescesCopies) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg i1_def("I1", &tensor_float_type),
+      i2_def("I2", &tensor_float_type),
+      o1_def("O1", &tensor_float_type),
+      o2_def("O2", &tensor_float_type);
+
+  // both graph inputs are used on CPU and GPU
+  auto& node1 = graph.AddNode("node1", "Add", "cpu operator1", ArgMap{&i1_def, &i2_def}, ArgMap{&o1_def});
+  node1.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  auto& node2 = graph.AddNode("node2", "Add", "gpu operator1", ArgMap{&i1_def, &i2_def}, ArgMap{&o2_def});
+  node2.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                          std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernels(execution_providers);
+
+  MemcpyTransformer transformer({onnxruntime::kCudaExecutionProvider}, test_registry_manager);
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // Expect: one copy of I1 and I2 from cpu to gpu
+  int num_copy_nodes = 0;
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "MemcpyFromHost") {
+      ++num_copy_nodes;
+      ASSERT_EQ(node.InputDefs().size(), 2u);
+      EXPECT_EQ(node.InputDefs()[0], &i1_def);
+      EXPECT_EQ(node.InputDefs()[1], &i2_def);
+      EXPECT_EQ(node.OutputDefs()[0], node2.InputDefs()[0]);
+      EXPECT_EQ(node.OutputDefs()[1], node2.InputDefs()[1]);
+    }
+  }
+  EXPECT_EQ(num_copy_nodes, 1);
+  EXPECT_EQ(node1.InputDefs()[0], &i1_def);
+  EXPECT_EQ(node1.InputDefs()[1], &i2_def);
+}
+
+TEST(TransformerTest, MemcpyTransformerPlacesIntegerNodesOnCpu) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  TypeProto tensor_int64_type;
+  tensor_int64_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  onnxruntime::NodeArg i1_def("I1", &tensor_int64_type),
+      i2_def("I2", &tensor_float_type),
+      o1_def("O1", &tensor_int64_type),
+      o2_def("O2", &tensor_float_type);
+
+  // node1 computes a graph output from a graph input, so running it on GPU costs two copies
+  auto& node1 = graph.AddNode("node1", "Add", "integer operator", ArgMap{&i1_def, &i1_def}, ArgMap{&o1_def});
+  node1.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  // node2 is not an integer computation, and stays on GPU
+  auto& node2 = graph.AddNode("node2", "Add", "gpu operator", ArgMap{&i2_def, &i2_def}, ArgMap{&o2_def});
+  node2.SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  execution_providers.Add(onnxruntime::kCpuExecutionProvider,
+                          std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  test_registry_manager.RegisterKernels(execution_providers);
+
+  MemcpyTransformer transformer({onnxruntime::kCudaExecutionProvider}, test_registry_manager);
+
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  EXPECT_EQ(node1.GetExecutionProviderType(), onnxruntime::kCpuExecutionProvider);
+  EXPECT_EQ(node2.GetExecutionProviderType(), onnxruntime::kCudaExecutionProvider);
+  for (auto& node : graph.Nodes()) {
+    EXPECT_NE(node.OpType(), "MemcpyFromHost");
+    EXPECT_NE(node.OpType(), "MemcpyToHost");
+  }
+}
+
 #endif
 
 }  // namespace test
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_providers.h"
+#include "core/optimizer/mixed_precision_transformer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+#ifdef USE_CUDA
+
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+static bool IsFloat16(const NodeArg& arg) {
+  return arg.TypeAsProto()->tensor_type().elem_type() == TensorProto_DataType_FLOAT16;
+}
+
+// MatMul(I1, W) -> Softmax -> MatMul(., I3) with every node on CUDA
+static void BuildMatMulSoftmaxMatMul(Graph& graph) {
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = tensor_float_type.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(2);
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  weights.add_dims(2);
+  weights.add_dims(2);
+  for (float value : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    weights.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weights);
+
+  auto& i1_def = graph.GetOrCreateNodeArg("I1", &tensor_float_type);
+  auto& w_def = graph.GetOrCreateNodeArg("W", &tensor_float_type);
+  auto& i3_def = graph.GetOrCreateNodeArg("I3", &tensor_float_type);
+  auto& o1_def = graph.GetOrCreateNodeArg("O1", &tensor_float_type);
+  auto& o2_def = graph.GetOrCreateNodeArg("O2", &tensor_float_type);
+  auto& o3_def = graph.GetOrCreateNodeArg("O3", &tensor_float_type);
+
+  graph.AddNode("node1", "MatMul", "gpu operator1", ArgMap{&i1_def, &w_def}, ArgMap{&o1_def})
+      .SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  graph.AddNode("node2", "Softmax", "gpu operator2", ArgMap{&o1_def}, ArgMap{&o2_def})
+      .SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+  graph.AddNode("node3", "MatMul", "gpu operator3", ArgMap{&o2_def, &i3_def}, ArgMap{&o3_def})
+      .SetExecutionProviderType(onnxruntime::kCudaExecutionProvider);
+}
+
+TEST(TransformerTest, MixedPrecisionTransformerKeepsDeniedOpsInFloat) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  onnxruntime::Graph& graph = model->MainGraph();
+  BuildMatMulSoftmaxMatMul(graph);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  ASSERT_TRUE(test_registry_manager.RegisterKernels(execution_providers).IsOK());
+
+  MixedPrecisionTransformer transformer(test_registry_manager);
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // I1, I3 and the output of Softmax are cast to float16, and the outputs of both MatMuls back to float for
+  // Softmax and the graph output. W is converted instead of cast.
+  auto op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Cast"], 5);
+  EXPECT_EQ(op_to_count["MatMul"], 2);
+
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "MatMul") {
+      for (const auto* arg : node.InputDefs()) {
+        EXPECT_TRUE(IsFloat16(*arg)) << node.Name() << " input " << arg->Name();
+      }
+      EXPECT_TRUE(IsFloat16(*node.OutputDefs()[0])) << node.Name();
+    } else if (node.OpType() == "Softmax") {
+      EXPECT_FALSE(IsFloat16(*node.InputDefs()[0]));
+      EXPECT_FALSE(IsFloat16(*node.OutputDefs()[0]));
+    } else {
+      EXPECT_EQ(node.OpType(), "Cast");
+      EXPECT_EQ(node.GetExecutionProviderType(), onnxruntime::kCudaExecutionProvider);
+    }
+  }
+
+  const auto& outputs = graph.GetOutputs();
+  ASSERT_EQ(outputs.size(), 1u);
+  EXPECT_EQ(outputs[0]->Name(), "O3");
+  EXPECT_FALSE(IsFloat16(*outputs[0]));
+
+  const TensorProto* weights = nullptr;
+  EXPECT_FALSE(graph.GetInitializedTensor("W", weights));
+  size_t num_float16_initializers = 0;
+  for (const auto& initializer : graph.GetAllInitializedTensors()) {
+    EXPECT_EQ(initializer.second->data_type(), TensorProto_DataType_FLOAT16);
+    num_float16_initializers++;
+  }
+  EXPECT_EQ(num_float16_initializers, 1u);
+}
+
+TEST(TransformerTest, MixedPrecisionTransformerDenyList) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 7;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  onnxruntime::Graph& graph = model->MainGraph();
+  BuildMatMulSoftmaxMatMul(graph);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  ExecutionProviders execution_providers;
+  execution_providers.Add(onnxruntime::kCudaExecutionProvider,
+                          std::make_unique<CUDAExecutionProvider>(CUDAExecutionProviderInfo()));
+  KernelRegistryManager test_registry_manager;
+  ASSERT_TRUE(test_registry_manager.RegisterKernels(execution_providers).IsOK());
+
+  MixedPrecisionTransformer transformer(test_registry_manager, {}, {"MatMul"});
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_FALSE(modified);
+  EXPECT_EQ(CountOpsInGraph(graph)["Cast"], 0);
+}
+
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
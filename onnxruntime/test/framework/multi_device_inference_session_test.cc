@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/multi_device_inference_session.h"
+
+#include <thread>
+#include "core/framework/tensor.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+static const std::string MULTI_DEVICE_MODEL_URI = "testdata/mul_1.onnx";
+
+// Y = X * [1, 2, 3, 4, 5, 6] on devices that are CPU providers
+static void RunMul(MultiDeviceInferenceSession& session) {
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                       &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+
+  std::vector<OrtValue> fetches;
+  auto status = session.Run(RunOptions(), feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 1u);
+
+  const std::vector<float> expected = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  const auto& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape(dims_mul_x));
+  EXPECT_EQ(std::vector<float>(y.Data<float>(), y.Data<float>() + expected.size()), expected);
+}
+
+TEST(MultiDeviceInferenceSessionTest, RunsOnEveryDevice) {
+  std::vector<int> created_providers;
+  SessionOptions so;
+  so.session_logid = "MultiDeviceInferenceSessionTest.RunsOnEveryDevice";
+  MultiDeviceInferenceSession session(so, {0, 1, 2}, [&created_providers](int device_id) {
+    created_providers.push_back(device_id);
+    return std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  });
+
+  ASSERT_TRUE(session.Load(MULTI_DEVICE_MODEL_URI).IsOK());
+  ASSERT_TRUE(session.Initialize().IsOK());
+  EXPECT_EQ(created_providers, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(session.NumDevices(), 3u);
+  EXPECT_EQ(session.GetDeviceId(2), 2);
+
+  auto inputs = session.GetModelInputs();
+  ASSERT_TRUE(inputs.first.IsOK());
+  ASSERT_EQ(inputs.second->size(), 1u);
+  EXPECT_EQ(inputs.second->at(0)->Name(), "X");
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 6; ++i) {
+    threads.emplace_back([&session]() {
+      for (int j = 0; j < 10; ++j) {
+        RunMul(session);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // every Run stopped counting on its device
+  for (size_t i = 0; i < session.NumDevices(); ++i) {
+    EXPECT_EQ(session.GetCurrentNumRuns(i), 0);
+    EXPECT_EQ(session.GetSession(i).GetCurrentNumRuns(), 0);
+  }
+}
+
+TEST(MultiDeviceInferenceSessionTest, RunBeforeLoadFails) {
+  MultiDeviceInferenceSession session(SessionOptions(), {0}, [](int) {
+    return std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  });
+  std::vector<OrtValue> fetches;
+  EXPECT_FALSE(session.Run(RunOptions(), NameMLValMap(), {"Y"}, &fetches).IsOK());
+  EXPECT_FALSE(session.Load("testdata/does_not_exist.onnx").IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdio>
+
+#include "core/framework/partition_cost_model.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/framework/model_builder_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+// X -> Relu -> Y, with X and Y of x_type
+static std::unique_ptr<Model> BuildRelu(const TypeProto& x_type) {
+  auto model = std::make_unique<Model>("test");
+  Graph& graph = model->MainGraph();
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &x_type);
+  graph.AddNode("relu", "Relu", "", ArgMap{&x}, ArgMap{&y});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+  return model;
+}
+
+// MatMul(A, B) -> Y of size x size matrices
+static std::unique_ptr<Model> BuildMatMul(int size) {
+  auto model = std::make_unique<Model>("test");
+  Graph& graph = model->MainGraph();
+  modelbuilder::Type type({size, size});
+  auto& a = graph.GetOrCreateNodeArg("A", &type.value);
+  auto& b = graph.GetOrCreateNodeArg("B", &type.value);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type.value);
+  graph.AddNode("matmul", "MatMul", "", ArgMap{&a, &b}, ArgMap{&y});
+  EXPECT_TRUE(graph.Resolve().IsOK());
+  return model;
+}
+
+static std::vector<NodeIndex> AllNodes(const GraphViewer& graph) {
+  std::vector<NodeIndex> nodes;
+  for (const auto& node : graph.Nodes()) {
+    nodes.push_back(node.Index());
+  }
+  return nodes;
+}
+
+TEST(PartitionCostModelTest, SmallNodeStaysOnCpu) {
+  modelbuilder::Type type({1, 8});
+  auto model = BuildRelu(type.value);
+  GraphViewer graph(model->MainGraph());
+
+  PartitionCostModel cost_model;
+  EXPECT_EQ(PartitionCostModel::EstimateFlops(*graph.GetNode(0)), 8.0);
+  // copying X in and Y out costs more than the Relu saves
+  EXPECT_FALSE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+}
+
+TEST(PartitionCostModelTest, LargeMatMulIsPlaced) {
+  auto model = BuildMatMul(512);
+  GraphViewer graph(model->MainGraph());
+
+  PartitionCostModel cost_model;
+  EXPECT_EQ(PartitionCostModel::EstimateFlops(*graph.GetNode(0)), 2.0 * 512 * 512 * 512);
+  EXPECT_TRUE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+}
+
+TEST(PartitionCostModelTest, UnknownShapeIsPlaced) {
+  modelbuilder::Type type({"batch", "features"});
+  auto model = BuildRelu(type.value);
+  GraphViewer graph(model->MainGraph());
+
+  PartitionCostModel cost_model;
+  EXPECT_LT(PartitionCostModel::EstimateFlops(*graph.GetNode(0)), 0.0);
+  EXPECT_TRUE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+}
+
+TEST(PartitionCostModelTest, SavedDecisionsAreReused) {
+  const std::basic_string<ORTCHAR_T> path = ORT_TSTR("partition_cost_model_test.txt");
+  auto model = BuildMatMul(512);
+  GraphViewer graph(model->MainGraph());
+
+  {
+    PartitionCostModel cost_model;
+    ASSERT_TRUE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+    ASSERT_TRUE(cost_model.Save(path).IsOK());
+  }
+
+  // costs under which the MatMul would stay on CPU, if it wasn't for the saved decision
+  PartitionCostModel::Costs slow_device;
+  slow_device.device_speedup = 0.5;
+  {
+    PartitionCostModel cost_model(slow_device);
+    EXPECT_FALSE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+  }
+  {
+    PartitionCostModel cost_model(slow_device);
+    ASSERT_TRUE(cost_model.Load(path).IsOK());
+    EXPECT_EQ(cost_model.NumDecisions(), 1u);
+    EXPECT_TRUE(cost_model.ShouldPlace(graph, AllNodes(graph), kCudaExecutionProvider));
+    // a decision for another provider isn't reused
+    EXPECT_FALSE(cost_model.ShouldPlace(graph, AllNodes(graph), kTensorrtExecutionProvider));
+  }
+
+  std::remove(ToMBString(path).c_str());
+}
+
+TEST(PartitionCostModelTest, MissingFileIsNotAnError) {
+  PartitionCostModel cost_model;
+  EXPECT_TRUE(cost_model.Load(ORT_TSTR("partition_cost_model_test_missing.txt")).IsOK());
+  EXPECT_EQ(cost_model.NumDecisions(), 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
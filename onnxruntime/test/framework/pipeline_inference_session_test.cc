@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_inference_session.h"
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+// Y = (X * X + W) * X, with W = [1, 2] and the batch dimension of X symbolic
+static std::string MakeChainModel() {
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 10}};
+  Model model("PipelineInferenceSessionTest", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  TypeProto weight_tensor;
+  weight_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  weight_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  TensorProto weight;
+  weight.set_name("W");
+  weight.set_data_type(TensorProto_DataType_FLOAT);
+  weight.add_dims(2);
+  weight.add_float_data(1.0f);
+  weight.add_float_data(2.0f);
+  graph.AddInitializedTensor(weight);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", &weight_tensor);
+  auto& a = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& b = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("square", "Mul", "", {&x, &x}, {&a});
+  graph.AddNode("add", "Add", "", {&a, &w}, {&b});
+  graph.AddNode("mul", "Mul", "", {&b, &x}, {&y});
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::string serialized_model;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  return serialized_model;
+}
+
+static PipelineInferenceSession::ProviderFactory CPUProviderFactory() {
+  return [](int) { return std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo()); };
+}
+
+static void LoadChainModel(PipelineInferenceSession& session) {
+  const std::string model = MakeChainModel();
+  auto status = session.Load(model.data(), static_cast<int>(model.size()));
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  status = session.Initialize();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+static void RunChain(PipelineInferenceSession& session, int64_t batch_size) {
+  std::vector<int64_t> dims_x = {batch_size, 2};
+  std::vector<float> values_x;
+  for (int64_t i = 0; i < batch_size * 2; ++i) {
+    values_x.push_back(static_cast<float>(i));
+  }
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), dims_x, values_x,
+                       &ml_value);
+  NameMLValMap feeds;
+  feeds.insert(std::make_pair("X", ml_value));
+
+  std::vector<OrtValue> fetches;
+  auto status = session.Run(RunOptions(), feeds, {"Y"}, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(fetches.size(), 1u);
+
+  const auto& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape(dims_x));
+  for (size_t i = 0; i < values_x.size(); ++i) {
+    const float x = values_x[i];
+    EXPECT_EQ(y.Data<float>()[i], (x * x + (i % 2 == 0 ? 1.0f : 2.0f)) * x) << "at " << i;
+  }
+}
+
+TEST(PipelineInferenceSessionTest, SplitsIntoStages) {
+  std::vector<int> created_providers;
+  PipelineInferenceSession session(SessionOptions(), {0, 1, 2}, [&created_providers](int device_id) {
+    created_providers.push_back(device_id);
+    return std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  });
+  LoadChainModel(session);
+  EXPECT_EQ(created_providers, std::vector<int>({0, 1, 2}));
+  ASSERT_EQ(session.NumStages(), 3u);
+
+  // the values of the earlier stages and the feeds go to the stages using them, the initializers aren't passed
+  EXPECT_EQ(session.GetStageInputs(0), std::vector<std::string>({"X"}));
+  EXPECT_EQ(session.GetStageOutputs(0), std::vector<std::string>({"A"}));
+  EXPECT_EQ(session.GetStageInputs(1), std::vector<std::string>({"A"}));
+  EXPECT_EQ(session.GetStageOutputs(1), std::vector<std::string>({"B"}));
+  EXPECT_EQ(session.GetStageInputs(2), std::vector<std::string>({"B", "X"}));
+  EXPECT_EQ(session.GetStageOutputs(2), std::vector<std::string>({"Y"}));
+
+  RunChain(session, 4);
+}
+
+TEST(PipelineInferenceSessionTest, RunsMicroBatches) {
+  PipelineInferenceSession session(SessionOptions(), {0, 1}, CPUProviderFactory(), 3);
+  LoadChainModel(session);
+  ASSERT_EQ(session.NumStages(), 2u);
+
+  // batches that split unevenly, or into fewer micro-batches than asked for
+  for (int64_t batch_size : {7, 3, 2, 1}) {
+    RunChain(session, batch_size);
+  }
+}
+
+TEST(PipelineInferenceSessionTest, TooManyStagesFail) {
+  PipelineInferenceSession session(SessionOptions(), {0, 1, 2, 3}, CPUProviderFactory());
+  const std::string model = MakeChainModel();
+  auto status = session.Load(model.data(), static_cast<int>(model.size()));
+  EXPECT_FALSE(status.IsOK());
+}
+
+TEST(PipelineInferenceSessionTest, RunBeforeLoadFails) {
+  PipelineInferenceSession session(SessionOptions(), {0}, CPUProviderFactory());
+  std::vector<OrtValue> fetches;
+  EXPECT_FALSE(session.Run(RunOptions(), NameMLValMap(), {"Y"}, &fetches).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/calibration_collector.h"
+#include "core/framework/tensor.h"
+#include "core/optimizer/static_quantization_transformer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+static void CollectValues(CalibrationCollector& collector, const std::string& name, std::vector<float> values) {
+  Tensor tensor(DataTypeImpl::GetType<float>(), TensorShape({static_cast<int64_t>(values.size())}), values.data(),
+                OrtMemoryInfo(CPU, OrtDeviceAllocator));
+  collector.Collect(name, tensor);
+}
+
+TEST(CalibrationCollectorTest, Ranges) {
+  CalibrationCollector collector(100);
+  CollectValues(collector, "X", {-1.f, 0.5f, 2.f});
+  CollectValues(collector, "X", {-3.f, 1.f});
+  CollectValues(collector, "Y", {0.f, 0.f});
+
+  auto ranges = collector.GetRanges();
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges["X"].min, -3.f);
+  EXPECT_EQ(ranges["X"].max, 2.f);
+  EXPECT_EQ(ranges["Y"].min, 0.f);
+  EXPECT_EQ(ranges["Y"].max, 0.f);
+
+  collector.Reset();
+  EXPECT_TRUE(collector.GetRanges().empty());
+}
+
+TEST(CalibrationCollectorTest, PercentileClipsOutliers) {
+  CalibrationCollector collector(100);
+  std::vector<float> values(999, 1.f);
+  values.push_back(100.f);
+  CollectValues(collector, "X", values);
+
+  EXPECT_EQ(collector.GetRanges()["X"].max, 100.f);
+
+  // the magnitude covering 99% of the values is the bin of 1, whose width is 1
+  const auto clipped = collector.GetRanges(99.f)["X"];
+  EXPECT_EQ(clipped.min, 1.f);
+  EXPECT_LE(clipped.max, 2.f);
+}
+
+// X -> MatMul(W1) -> Y1 -> MatMul(W2) -> Y2 on CPU
+static void BuildMatMulMatMul(Graph& graph) {
+  TypeProto tensor_float_type;
+  tensor_float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = tensor_float_type.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(2);
+
+  for (const char* name : {"W1", "W2"}) {
+    TensorProto weights;
+    weights.set_name(name);
+    weights.set_data_type(TensorProto_DataType_FLOAT);
+    weights.add_dims(2);
+    weights.add_dims(2);
+    for (float value : {1.0f, -2.0f, 3.0f, 4.0f}) {
+      weights.add_float_data(value);
+    }
+    graph.AddInitializedTensor(weights);
+  }
+
+  auto& x_def = graph.GetOrCreateNodeArg("X", &tensor_float_type);
+  auto& w1_def = graph.GetOrCreateNodeArg("W1", &tensor_float_type);
+  auto& w2_def = graph.GetOrCreateNodeArg("W2", &tensor_float_type);
+  auto& y1_def = graph.GetOrCreateNodeArg("Y1", &tensor_float_type);
+  auto& y2_def = graph.GetOrCreateNodeArg("Y2", &tensor_float_type);
+
+  graph.AddNode("node1", "MatMul", "cpu operator1", ArgMap{&x_def, &w1_def}, ArgMap{&y1_def})
+      .SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  graph.AddNode("node2", "MatMul", "cpu operator2", ArgMap{&y1_def, &w2_def}, ArgMap{&y2_def})
+      .SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+}
+
+static std::shared_ptr<Model> CreateModel() {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  auto model = std::make_shared<onnxruntime::Model>("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                                                    domain_to_version);
+  BuildMatMulMatMul(model->MainGraph());
+  return model;
+}
+
+TEST(TransformerTest, StaticQuantizationTransformerChainsQuantizedNodes) {
+  auto model = CreateModel();
+  auto& graph = model->MainGraph();
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const std::unordered_map<std::string, TensorRange> ranges{{"X", {-1.f, 1.f}}, {"Y1", {-6.f, 6.f}},
+                                                            {"Y2", {-40.f, 40.f}}};
+  StaticQuantizationTransformer transformer(ranges);
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  // X is quantized once, Y1 stays in uint8 between the QLinearMatMuls and only Y2 is dequantized
+  auto op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+  EXPECT_EQ(op_to_count["QLinearMatMul"], 2);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), onnxruntime::kCpuExecutionProvider) << node.Name();
+    if (node.OpType() == "QLinearMatMul") {
+      EXPECT_EQ(node.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_UINT8);
+      EXPECT_EQ(node.InputDefs()[3]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_UINT8);
+    }
+  }
+
+  const auto& outputs = graph.GetOutputs();
+  ASSERT_EQ(outputs.size(), 1u);
+  EXPECT_EQ(outputs[0]->Name(), "Y2");
+  EXPECT_EQ(outputs[0]->TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_FLOAT);
+}
+
+TEST(TransformerTest, StaticQuantizationTransformerKeepsNodesWithoutRanges) {
+  auto model = CreateModel();
+  auto& graph = model->MainGraph();
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // the second MatMul has no range for its output, so it stays in float and Y1 is dequantized for it
+  const std::unordered_map<std::string, TensorRange> ranges{{"X", {-1.f, 1.f}}, {"Y1", {-6.f, 6.f}}};
+  StaticQuantizationTransformer transformer(ranges);
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  auto op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+  EXPECT_EQ(op_to_count["QLinearMatMul"], 1);
+  EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+  EXPECT_EQ(op_to_count["MatMul"], 1);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/weight_only_quantization_transformer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+typedef std::vector<onnxruntime::NodeArg*> ArgMap;
+
+static TypeProto FloatType(std::initializer_list<int64_t> dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (auto dim : dims) {
+    shape->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+static void AddWeights(Graph& graph, const std::string& name, std::initializer_list<int64_t> dims,
+                       std::initializer_list<float> values) {
+  TensorProto weights;
+  weights.set_name(name);
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  for (auto dim : dims) {
+    weights.add_dims(dim);
+  }
+  for (float value : values) {
+    weights.add_float_data(value);
+  }
+  graph.AddInitializedTensor(weights);
+}
+
+// Gather(E, ids) -> X -> MatMul(W) -> Y -> Gemm(W, C, transB) -> Z on CPU, with W used twice
+static void BuildEmbeddingMatMulGemm(Graph& graph) {
+  AddWeights(graph, "E", {3, 2}, {1.f, -2.f, 3.f, 4.f, 0.f, 0.f});
+  AddWeights(graph, "W", {2, 2}, {1.f, -2.f, 3.f, 4.f});
+  AddWeights(graph, "C", {2}, {0.5f, -0.5f});
+
+  TypeProto ids_type;
+  ids_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  ids_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+  const auto embedding_type = FloatType({3, 2});
+  const auto weights_type = FloatType({2, 2});
+  const auto values_type = FloatType({4, 2});
+
+  auto& ids_def = graph.GetOrCreateNodeArg("ids", &ids_type);
+  auto& e_def = graph.GetOrCreateNodeArg("E", &embedding_type);
+  auto& w_def = graph.GetOrCreateNodeArg("W", &weights_type);
+  auto c_type = FloatType({2});
+  auto& c_def = graph.GetOrCreateNodeArg("C", &c_type);
+  auto& x_def = graph.GetOrCreateNodeArg("X", &values_type);
+  auto& y_def = graph.GetOrCreateNodeArg("Y", &values_type);
+  auto& z_def = graph.GetOrCreateNodeArg("Z", &values_type);
+
+  graph.AddNode("gather", "Gather", "", ArgMap{&e_def, &ids_def}, ArgMap{&x_def})
+      .SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  graph.AddNode("matmul", "MatMul", "", ArgMap{&x_def, &w_def}, ArgMap{&y_def})
+      .SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  auto& gemm = graph.AddNode("gemm", "Gemm", "", ArgMap{&y_def, &w_def, &c_def}, ArgMap{&z_def});
+  gemm.SetExecutionProviderType(onnxruntime::kCpuExecutionProvider);
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+  gemm.AddAttribute("beta", 2.f);
+}
+
+TEST(TransformerTest, WeightOnlyQuantizationTransformerQuantizesWeights) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 9;
+  domain_to_version[kMSDomain] = 1;
+  Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  auto& graph = model.MainGraph();
+  BuildEmbeddingMatMulGemm(graph);
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  WeightOnlyQuantizationTransformer transformer;
+  bool modified = false;
+  status = transformer.Apply(graph, modified);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_TRUE(modified);
+
+  auto op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["GatherWeightInt8"], 1);
+  EXPECT_EQ(op_to_count["MatMulWeightInt8"], 2);
+  EXPECT_EQ(op_to_count["Gather"], 0);
+  EXPECT_EQ(op_to_count["MatMul"], 0);
+  EXPECT_EQ(op_to_count["Gemm"], 0);
+
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), onnxruntime::kCpuExecutionProvider) << node.Name();
+    EXPECT_EQ(node.Domain(), kMSDomain) << node.Name();
+    const auto& weights = *node.InputDefs()[node.OpType() == "GatherWeightInt8" ? 0 : 1];
+    EXPECT_EQ(weights.TypeAsProto()->tensor_type().elem_type(), TensorProto_DataType_INT8) << node.Name();
+  }
+
+  // the Gemm with transB has the weights transposed, with a scale per row of W, and beta * C as its bias
+  for (const auto& node : graph.Nodes()) {
+    if (node.InputDefs().size() != 4) {
+      continue;
+    }
+    const TensorProto* scale = nullptr;
+    const TensorProto* bias = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[2]->Name(), scale));
+    ASSERT_TRUE(graph.GetInitializedTensor(node.InputDefs()[3]->Name(), bias));
+    Initializer scale_data(scale);
+    Initializer bias_data(bias);
+    EXPECT_FLOAT_EQ(scale_data.data<float>()[0], 2.f / 127.f);
+    EXPECT_FLOAT_EQ(scale_data.data<float>()[1], 4.f / 127.f);
+    EXPECT_EQ(bias_data.data<float>()[0], 1.f);
+    EXPECT_EQ(bias_data.data<float>()[1], -1.f);
+  }
+
+  // the float weights are no longer used
+  EXPECT_EQ(graph.GetAllInitializedTensors().count("E"), 0u);
+  EXPECT_EQ(graph.GetAllInitializedTensors().count("W"), 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -873,6 +873,192 @@ TEST(TypeInferenceTest, NonConstInitializer) {
   resolve_and_validate(graph2);
 }
 
+// Test that the shapes computed by Shape -> Gather -> Unsqueeze -> Concat are propagated with symbolic dims
+TEST(TypeInferenceTest, SymbolicShapeValues) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(3);
+
+  TensorProto index;
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(0);
+  index.set_name("index");
+  graph.AddInitializedTensor(index);
+
+  TensorProto size;
+  size.set_data_type(TensorProto_DataType_INT64);
+  size.add_dims(1);
+  size.add_int64_data(-1);
+  size.set_name("size");
+  graph.AddInitializedTensor(size);
+
+  auto& X = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", nullptr);
+  auto& gather_out = graph.GetOrCreateNodeArg("gather_out", nullptr);
+  auto& unsqueeze_out = graph.GetOrCreateNodeArg("unsqueeze_out", nullptr);
+  auto& concat_out = graph.GetOrCreateNodeArg("concat_out", nullptr);
+  auto& reshape_out = graph.GetOrCreateNodeArg("reshape_out", nullptr);
+  auto& constant_of_shape_out = graph.GetOrCreateNodeArg("constant_of_shape_out", nullptr);
+
+  graph.AddNode("shape", "Shape", "shape", {&X}, {&shape_out});
+  graph.AddNode("gather", "Gather", "gather", {&shape_out, graph.GetNodeArg("index")}, {&gather_out});
+  graph.AddNode("unsqueeze", "Unsqueeze", "unsqueeze", {&gather_out}, {&unsqueeze_out})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("concat", "Concat", "concat", {&unsqueeze_out, graph.GetNodeArg("size")}, {&concat_out})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("reshape", "Reshape", "reshape", {&X, &concat_out}, {&reshape_out});
+  graph.AddNode("constant_of_shape", "ConstantOfShape", "constant of shape", {&concat_out},
+                {&constant_of_shape_out});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  // the -1 is inferred from the known dims of X
+  const auto* reshape_shape = graph.GetNodeArg("reshape_out")->Shape();
+  ASSERT_TRUE(reshape_shape != nullptr);
+  ASSERT_EQ(reshape_shape->dim_size(), 2);
+  EXPECT_EQ(reshape_shape->dim(0).dim_param(), "batch");
+  EXPECT_EQ(reshape_shape->dim(1).dim_value(), 6);
+
+  // a negative value isn't a valid dim, so only the symbolic dim is known
+  const auto* constant_of_shape_shape = graph.GetNodeArg("constant_of_shape_out")->Shape();
+  ASSERT_TRUE(constant_of_shape_shape != nullptr);
+  ASSERT_EQ(constant_of_shape_shape->dim_size(), 2);
+  EXPECT_EQ(constant_of_shape_shape->dim(0).dim_param(), "batch");
+  EXPECT_FALSE(constant_of_shape_shape->dim(1).has_dim_value());
+}
+
+// Test that the values of tensors of a higher rank, such as an unsqueezed shape, aren't read as shapes
+TEST(TypeInferenceTest, SymbolicShapeValuesOfHigherRank) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(3);
+
+  TensorProto index;
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(0);
+  index.set_name("index");
+  graph.AddInitializedTensor(index);
+
+  auto& X = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", nullptr);
+  auto& unsqueeze_out = graph.GetOrCreateNodeArg("unsqueeze_out", nullptr);
+  auto& gather_out = graph.GetOrCreateNodeArg("gather_out", nullptr);
+  auto& constant_of_shape_out = graph.GetOrCreateNodeArg("constant_of_shape_out", nullptr);
+
+  // the unsqueezed shape is a 1x3 tensor, so the gather takes its only row of 3 values and not its first value
+  graph.AddNode("shape", "Shape", "shape", {&X}, {&shape_out});
+  graph.AddNode("unsqueeze", "Unsqueeze", "unsqueeze", {&shape_out}, {&unsqueeze_out})
+      .AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("gather", "Gather", "gather", {&unsqueeze_out, graph.GetNodeArg("index")}, {&gather_out})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("constant_of_shape", "ConstantOfShape", "constant of shape", {&gather_out},
+                {&constant_of_shape_out});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const auto* constant_of_shape_shape = graph.GetNodeArg("constant_of_shape_out")->Shape();
+  EXPECT_TRUE(constant_of_shape_shape == nullptr || constant_of_shape_shape->dim_size() == 3);
+}
+
+// Test that a Concat of values of a higher rank along an axis other than 0 isn't read as a concatenated shape
+TEST(TypeInferenceTest, SymbolicShapeValuesConcatAxis) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(3);
+
+  TensorProto index;
+  index.set_data_type(TensorProto_DataType_INT64);
+  index.add_int64_data(1);
+  index.set_name("index");
+  graph.AddInitializedTensor(index);
+
+  auto& X = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& shape_out = graph.GetOrCreateNodeArg("shape_out", nullptr);
+  auto& unsqueeze_out = graph.GetOrCreateNodeArg("unsqueeze_out", nullptr);
+  auto& concat_out = graph.GetOrCreateNodeArg("concat_out", nullptr);
+  auto& gather_out = graph.GetOrCreateNodeArg("gather_out", nullptr);
+  auto& constant_of_shape_out = graph.GetOrCreateNodeArg("constant_of_shape_out", nullptr);
+
+  // the concat of the 3x1 tensors is a 3x2 tensor whose second row is (2, 2)
+  graph.AddNode("shape", "Shape", "shape", {&X}, {&shape_out});
+  graph.AddNode("unsqueeze", "Unsqueeze", "unsqueeze", {&shape_out}, {&unsqueeze_out})
+      .AddAttribute("axes", std::vector<int64_t>{1});
+  graph.AddNode("concat", "Concat", "concat", {&unsqueeze_out, &unsqueeze_out}, {&concat_out})
+      .AddAttribute("axis", int64_t{1});
+  graph.AddNode("gather", "Gather", "gather", {&concat_out, graph.GetNodeArg("index")}, {&gather_out})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("constant_of_shape", "ConstantOfShape", "constant of shape", {&gather_out},
+                {&constant_of_shape_out});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  const auto* constant_of_shape_shape = graph.GetNodeArg("constant_of_shape_out")->Shape();
+  EXPECT_TRUE(constant_of_shape_shape == nullptr || constant_of_shape_shape->dim_size() == 2);
+}
+
+// Test that a Resolve after changing a graph infers the changed nodes and the nodes downstream of them
+TEST(TypeInferenceTest, IncrementalResolve) {
+  Model model("graph_1");
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& X = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& A = graph.GetOrCreateNodeArg("A", nullptr);
+  auto& B = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& relu_1 = graph.AddNode("relu_1", "Relu", "relu 1", {&X}, {&A});
+  graph.AddNode("relu_2", "Relu", "relu 2", {&A}, {&B});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+  EXPECT_TRUE(B.Shape() == nullptr);
+
+  // replace the input of the first node with one that has a shape, which has to reach the output of the second
+  auto* shape = float_tensor.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_value(2);
+  shape->add_dim()->set_dim_value(3);
+  auto& X2 = graph.GetOrCreateNodeArg("X2", &float_tensor);
+  relu_1.MutableInputDefs()[0] = &X2;
+  graph.SetInputs({&X2});
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+  ASSERT_TRUE(B.Shape() != nullptr);
+  ASSERT_EQ(B.Shape()->dim_size(), 2);
+  EXPECT_EQ(B.Shape()->dim(1).dim_value(), 3);
+
+  // a new node is inferred, and so is a node whose attributes changed
+  auto& C = graph.GetOrCreateNodeArg("C", nullptr);
+  auto& cast = graph.AddNode("cast", "Cast", "cast", {&B}, {&C});
+  cast.AddAttribute("to", int64_t{TensorProto_DataType_INT32});
+  status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+  CheckTensorEltType(C.TypeAsProto(), TensorProto_DataType_INT32);
+
+  cast.AddAttribute("to", int64_t{TensorProto_DataType_INT64});
+  status = graph.Resolve();
+  EXPECT_FALSE(status.IsOK());
+}
+
 // Test that Graph::Resolve identifies name-duplication across initializer and node-output-arg
 TEST(NameResolutionTest, DuplicateName) {
   Model model("graph_1");
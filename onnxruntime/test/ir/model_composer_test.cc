@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/graph/model_composer.h"
+
+#include <algorithm>
+#include <memory>
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+static void AddValueInfo(ValueInfoProto& value_info, const std::string& name,
+                         TensorProto_DataType elem_type = TensorProto_DataType_FLOAT) {
+  value_info.set_name(name);
+  auto* tensor_type = value_info.mutable_type()->mutable_tensor_type();
+  tensor_type->set_elem_type(elem_type);
+  tensor_type->mutable_shape()->add_dim()->set_dim_value(2);
+}
+
+// output = op_type(inputs...), with the inputs that are not graph_inputs being initializers of 2 floats
+static ModelProto MakeModel(int64_t opset, const std::string& op_type, const std::vector<std::string>& graph_inputs,
+                            const std::vector<std::string>& inputs, const std::string& output,
+                            TensorProto_DataType elem_type = TensorProto_DataType_FLOAT) {
+  ModelProto model;
+  model.set_ir_version(4);
+  auto* opset_import = model.add_opset_import();
+  opset_import->set_domain("");
+  opset_import->set_version(opset);
+
+  GraphProto& graph = *model.mutable_graph();
+  graph.set_name(op_type);
+  for (const auto& name : graph_inputs) {
+    AddValueInfo(*graph.add_input(), name, elem_type);
+  }
+  for (const auto& name : inputs) {
+    if (std::find(graph_inputs.cbegin(), graph_inputs.cend(), name) == graph_inputs.cend()) {
+      auto* initializer = graph.add_initializer();
+      initializer->set_name(name);
+      initializer->set_data_type(elem_type);
+      initializer->add_dims(2);
+      initializer->add_float_data(1.f);
+      initializer->add_float_data(2.f);
+    }
+  }
+  AddValueInfo(*graph.add_output(), output, elem_type);
+
+  auto* node = graph.add_node();
+  node->set_name(op_type);
+  node->set_op_type(op_type);
+  for (const auto& name : inputs) {
+    node->add_input(name);
+  }
+  node->add_output(output);
+  return model;
+}
+
+static void ExpectValidModel(const ModelProto& model_proto) {
+  std::shared_ptr<Model> model;
+  auto status = Model::Load(model_proto, model);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  status = model->MainGraph().Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+}
+
+TEST(ModelComposerTest, ConnectsOutputsToInputsByName) {
+  // T = X + C, then Z = T * C, with a C of each model
+  const ModelProto pre = MakeModel(10, "Add", {"X"}, {"X", "C"}, "T");
+  const ModelProto post = MakeModel(10, "Mul", {"T"}, {"T", "C"}, "Z");
+
+  ModelProto composed;
+  auto status = ComposeModels({{&pre, {}}, {&post, {}}}, composed);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const GraphProto& graph = composed.graph();
+  ASSERT_EQ(graph.input_size(), 1);
+  EXPECT_EQ(graph.input(0).name(), "X");
+  ASSERT_EQ(graph.output_size(), 1);
+  EXPECT_EQ(graph.output(0).name(), "Z");
+  ASSERT_EQ(graph.initializer_size(), 2);
+  EXPECT_EQ(graph.initializer(0).name(), "stage0/C");
+  EXPECT_EQ(graph.initializer(1).name(), "stage1/C");
+
+  ASSERT_EQ(graph.node_size(), 2);
+  EXPECT_EQ(graph.node(0).name(), "stage0/Add");
+  EXPECT_EQ(graph.node(0).output(0), "stage0/T");
+  EXPECT_EQ(graph.node(1).name(), "stage1/Mul");
+  EXPECT_EQ(graph.node(1).input(0), "stage0/T");
+  EXPECT_EQ(graph.node(1).input(1), "stage1/C");
+  ExpectValidModel(composed);
+}
+
+TEST(ModelComposerTest, InputMapConnectsOtherNames) {
+  const ModelProto first = MakeModel(10, "Relu", {"X"}, {"X"}, "Y");
+  const ModelProto second = MakeModel(10, "Relu", {"X"}, {"X"}, "Y");
+
+  // without the map the inputs of both models are the input of the composed model, and their outputs collide
+  ModelProto composed;
+  EXPECT_FALSE(ComposeModels({{&first, {}}, {&second, {}}}, composed).IsOK());
+
+  auto status = ComposeModels({{&first, {}}, {&second, {{"X", "Y"}}}}, composed);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(composed.graph().input_size(), 1);
+  EXPECT_EQ(composed.graph().input(0).name(), "X");
+  ASSERT_EQ(composed.graph().output_size(), 1);
+  EXPECT_EQ(composed.graph().output(0).name(), "Y");
+  EXPECT_EQ(composed.graph().node(1).input(0), "stage0/Y");
+  ExpectValidModel(composed);
+
+  // the map must name an input of the model and an output of an earlier one
+  EXPECT_FALSE(ComposeModels({{&first, {}}, {&second, {{"W", "Y"}}}}, composed).IsOK());
+  EXPECT_FALSE(ComposeModels({{&first, {}}, {&second, {{"X", "W"}}}}, composed).IsOK());
+}
+
+TEST(ModelComposerTest, SharesInputsOfTheSameName) {
+  const ModelProto first = MakeModel(10, "Relu", {"X"}, {"X"}, "Y");
+  const ModelProto second = MakeModel(10, "Neg", {"X"}, {"X"}, "Z");
+
+  ModelProto composed;
+  auto status = ComposeModels({{&first, {}}, {&second, {}}}, composed);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  EXPECT_EQ(composed.graph().input_size(), 1);
+  EXPECT_EQ(composed.graph().output_size(), 2);
+  ExpectValidModel(composed);
+
+  // a shared input must have the same type in both models
+  const ModelProto int_model = MakeModel(10, "Neg", {"X"}, {"X"}, "Z", TensorProto_DataType_INT32);
+  EXPECT_FALSE(ComposeModels({{&first, {}}, {&int_model, {}}}, composed).IsOK());
+}
+
+TEST(ModelComposerTest, MergesOpsetVersions) {
+  // Add hasn't changed between the versions 9 and 10 of the ONNX opset, Slice has
+  const ModelProto add = MakeModel(9, "Add", {"X"}, {"X", "C"}, "T");
+  const ModelProto relu = MakeModel(10, "Relu", {"T"}, {"T"}, "Z");
+
+  ModelProto composed;
+  auto status = ComposeModels({{&add, {}}, {&relu, {}}}, composed);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  ASSERT_EQ(composed.opset_import_size(), 1);
+  EXPECT_EQ(composed.opset_import(0).version(), 10);
+  ExpectValidModel(composed);
+
+  const ModelProto slice = MakeModel(9, "Slice", {"X"}, {"X"}, "T");
+  status = ComposeModels({{&slice, {}}, {&relu, {}}}, composed);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("Slice"), std::string::npos) << status.ErrorMessage();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,405 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    benchmark.cpp
+
+Abstract:
+
+    This module implements micro-benchmarks of the MLAS library kernels.
+
+    The shapes are taken from BERT, ResNet-50 and LSTM models. The last
+    argument of every benchmark is the number of threads the kernel runs on,
+    including the calling thread. GEMM and convolution benchmarks report the
+    GFLOPS counter, pooling benchmarks report the processed bytes.
+
+--*/
+
+#include <benchmark/benchmark.h>
+#include <stdint.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include <mlas.h>
+#include "core/platform/threadpool.h"
+
+//
+// Creates the thread pool for the requested thread count. MLAS runs on the
+// calling thread too, so a single thread runs without a thread pool.
+//
+
+static
+std::unique_ptr<onnxruntime::concurrency::ThreadPool>
+CreateThreadPool(
+    int64_t Threads
+    )
+{
+    if (Threads <= 1) {
+        return nullptr;
+    }
+
+    return std::make_unique<onnxruntime::concurrency::ThreadPool>("mlas_benchmark", static_cast<int>(Threads - 1));
+}
+
+template <typename T>
+static
+std::vector<T>
+RandomBuffer(
+    size_t Elements
+    )
+{
+    std::vector<T> Buffer(Elements);
+    std::default_random_engine Generator(static_cast<unsigned>(Elements));
+    std::uniform_int_distribution<int> Distribution(-8, 8);
+
+    for (auto& Value : Buffer) {
+        Value = static_cast<T>(Distribution(Generator));
+    }
+
+    return Buffer;
+}
+
+static
+void
+SetFlopsCounter(
+    benchmark::State& state,
+    double FlopsPerIteration
+    )
+{
+    state.counters["GFLOPS"] = benchmark::Counter(FlopsPerIteration * state.iterations() / 1e9, benchmark::Counter::kIsRate);
+}
+
+//
+// GEMM shapes: M, N, K and threads.
+//
+// BERT-base with a sequence length of 128: the QKV/output projections, the
+// feed forward layers and the attention scores of one head. LSTM with a
+// hidden size of 256 and an input size of 256: the gates of a batch of 1 and
+// of 64.
+//
+
+static
+void
+GemmShapes(
+    benchmark::internal::Benchmark* b
+    )
+{
+    const std::vector<std::vector<int64_t>> Shapes = {
+        {128, 768, 768},
+        {128, 3072, 768},
+        {128, 768, 3072},
+        {128, 128, 64},
+        {1, 1024, 256},
+        {64, 1024, 256},
+    };
+
+    for (const auto& Shape : Shapes) {
+        for (int64_t Threads : {1, 4}) {
+            b->Args({Shape[0], Shape[1], Shape[2], Threads});
+        }
+    }
+
+    b->ArgNames({"M", "N", "K", "Threads"});
+}
+
+static
+void
+BM_Sgemm(
+    benchmark::State& state
+    )
+{
+    const size_t M = static_cast<size_t>(state.range(0));
+    const size_t N = static_cast<size_t>(state.range(1));
+    const size_t K = static_cast<size_t>(state.range(2));
+    auto ThreadPool = CreateThreadPool(state.range(3));
+
+    auto A = RandomBuffer<float>(M * K);
+    auto B = RandomBuffer<float>(K * N);
+    std::vector<float> C(M * N);
+
+    for (auto _ : state) {
+        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A.data(), K, B.data(), N, 0.0f, C.data(), N, ThreadPool.get());
+    }
+
+    SetFlopsCounter(state, 2.0 * M * N * K);
+}
+
+BENCHMARK(BM_Sgemm)->Apply(GemmShapes)->UseRealTime();
+
+static
+void
+BM_SgemmPacked(
+    benchmark::State& state
+    )
+{
+    const size_t M = static_cast<size_t>(state.range(0));
+    const size_t N = static_cast<size_t>(state.range(1));
+    const size_t K = static_cast<size_t>(state.range(2));
+    auto ThreadPool = CreateThreadPool(state.range(3));
+
+    auto A = RandomBuffer<float>(M * K);
+    auto B = RandomBuffer<float>(K * N);
+    std::vector<float> C(M * N);
+
+    std::vector<uint8_t> PackedB(MlasSgemmPackBSize(N, K));
+    MlasSgemmPackB(CblasNoTrans, N, K, B.data(), N, PackedB.data());
+
+    for (auto _ : state) {
+        MlasSgemmPacked(CblasNoTrans, M, N, K, 1.0f, A.data(), K, PackedB.data(), 0.0f, C.data(), N, nullptr, nullptr, ThreadPool.get());
+    }
+
+    SetFlopsCounter(state, 2.0 * M * N * K);
+}
+
+BENCHMARK(BM_SgemmPacked)->Apply(GemmShapes)->UseRealTime();
+
+template <typename BType>
+static
+void
+BM_QGemm(
+    benchmark::State& state
+    )
+{
+    const size_t M = static_cast<size_t>(state.range(0));
+    const size_t N = static_cast<size_t>(state.range(1));
+    const size_t K = static_cast<size_t>(state.range(2));
+    auto ThreadPool = CreateThreadPool(state.range(3));
+
+    auto A = RandomBuffer<uint8_t>(M * K);
+    auto B = RandomBuffer<BType>(K * N);
+    std::vector<int32_t> C(M * N);
+
+    for (auto _ : state) {
+        MlasGemm(M, N, K, A.data(), K, uint8_t(128), B.data(), N, BType(0), C.data(), N, ThreadPool.get());
+    }
+
+    SetFlopsCounter(state, 2.0 * M * N * K);
+}
+
+#if defined(_M_IX86) || defined(__i386__) || defined(_M_AMD64) || defined(__x86_64__)
+BENCHMARK_TEMPLATE(BM_QGemm, uint8_t)->Apply(GemmShapes)->UseRealTime();
+#endif
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t)->Apply(GemmShapes)->UseRealTime();
+
+//
+// Convolution shapes: input channels, input height/width, filter count,
+// kernel size, stride, padding and threads.
+//
+// ResNet-50 with a batch of 1: the stem, the 3x3 and 1x1 convolutions of the
+// first stage and the 3x3 convolution of the last stage.
+//
+
+static
+void
+ConvShapes(
+    benchmark::internal::Benchmark* b
+    )
+{
+    const std::vector<std::vector<int64_t>> Shapes = {
+        {3, 224, 64, 7, 2, 3},
+        {64, 56, 64, 3, 1, 1},
+        {64, 56, 256, 1, 1, 0},
+        {256, 56, 64, 1, 1, 0},
+        {512, 7, 512, 3, 1, 1},
+    };
+
+    for (const auto& Shape : Shapes) {
+        for (int64_t Threads : {1, 4}) {
+            b->Args({Shape[0], Shape[1], Shape[2], Shape[3], Shape[4], Shape[5], Threads});
+        }
+    }
+
+    b->ArgNames({"C", "HW", "F", "Kernel", "Stride", "Pad", "Threads"});
+}
+
+struct ConvShape {
+    int64_t InputChannels;
+    int64_t InputSize;
+    int64_t FilterCount;
+    int64_t KernelSize;
+    int64_t Stride;
+    int64_t Padding;
+    int64_t OutputSize;
+
+    explicit ConvShape(const benchmark::State& state)
+    {
+        InputChannels = state.range(0);
+        InputSize = state.range(1);
+        FilterCount = state.range(2);
+        KernelSize = state.range(3);
+        Stride = state.range(4);
+        Padding = state.range(5);
+        OutputSize = (InputSize + 2 * Padding - KernelSize) / Stride + 1;
+    }
+
+    double Flops() const
+    {
+        return 2.0 * FilterCount * OutputSize * OutputSize * InputChannels * KernelSize * KernelSize;
+    }
+};
+
+static
+void
+BM_Conv(
+    benchmark::State& state
+    )
+{
+    const ConvShape Shape(state);
+    auto ThreadPool = CreateThreadPool(state.range(6));
+
+    const int64_t InputShape[] = {Shape.InputSize, Shape.InputSize};
+    const int64_t KernelShape[] = {Shape.KernelSize, Shape.KernelSize};
+    const int64_t DilationShape[] = {1, 1};
+    const int64_t Padding[] = {Shape.Padding, Shape.Padding, Shape.Padding, Shape.Padding};
+    const int64_t StrideShape[] = {Shape.Stride, Shape.Stride};
+    const int64_t OutputShape[] = {Shape.OutputSize, Shape.OutputSize};
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+    MlasConvPrepare(&Parameters, 2, 1, 1, static_cast<size_t>(Shape.InputChannels), InputShape, KernelShape,
+                    DilationShape, Padding, StrideShape, OutputShape, static_cast<size_t>(Shape.FilterCount),
+                    &Activation, &WorkingBufferSize, ThreadPool.get());
+
+    auto Input = RandomBuffer<float>(Shape.InputChannels * Shape.InputSize * Shape.InputSize);
+    auto Filter = RandomBuffer<float>(Shape.FilterCount * Shape.InputChannels * Shape.KernelSize * Shape.KernelSize);
+    auto Bias = RandomBuffer<float>(Shape.FilterCount);
+    std::vector<float> WorkingBuffer(WorkingBufferSize);
+    std::vector<float> Output(Shape.FilterCount * Shape.OutputSize * Shape.OutputSize);
+
+    for (auto _ : state) {
+        MlasConv(&Parameters, Input.data(), Filter.data(), Bias.data(), WorkingBuffer.data(), Output.data(), ThreadPool.get());
+    }
+
+    SetFlopsCounter(state, Shape.Flops());
+}
+
+BENCHMARK(BM_Conv)->Apply(ConvShapes)->UseRealTime();
+
+static
+void
+BM_NchwcConv(
+    benchmark::State& state
+    )
+{
+    const ConvShape Shape(state);
+    auto ThreadPool = CreateThreadPool(state.range(6));
+
+    const int64_t BlockSize = static_cast<int64_t>(MlasNchwcGetBlockSize());
+    if (BlockSize <= 1) {
+        state.SkipWithError("the NCHWc kernels aren't supported on this platform");
+        return;
+    }
+
+    //
+    // Inputs with fewer channels than the block size, like the stem, use the
+    // NCHW input layout and the OIHWBo filter layout. The other ones use the
+    // NCHWc input layout and the OIHWBiBo filter layout.
+    //
+
+    const bool NchwcInput = Shape.InputChannels >= BlockSize;
+    const int64_t InputChannels = NchwcInput ? (Shape.InputChannels + BlockSize - 1) / BlockSize * BlockSize : Shape.InputChannels;
+    const int64_t OutputChannels = (Shape.FilterCount + BlockSize - 1) / BlockSize * BlockSize;
+
+    const int64_t InputShape[] = {1, InputChannels, Shape.InputSize, Shape.InputSize};
+    const int64_t FilterShape[] = {Shape.FilterCount, Shape.InputChannels, Shape.KernelSize, Shape.KernelSize};
+    const int64_t KernelShape[] = {Shape.KernelSize, Shape.KernelSize};
+    const int64_t DilationShape[] = {1, 1};
+    const int64_t Padding[] = {Shape.Padding, Shape.Padding, Shape.Padding, Shape.Padding};
+    const int64_t StrideShape[] = {Shape.Stride, Shape.Stride};
+    const int64_t OutputShape[] = {1, OutputChannels, Shape.OutputSize, Shape.OutputSize};
+
+    auto Filter = RandomBuffer<float>(Shape.FilterCount * Shape.InputChannels * Shape.KernelSize * Shape.KernelSize);
+    std::vector<float> ReorderedFilter(OutputChannels * InputChannels * Shape.KernelSize * Shape.KernelSize);
+    if (NchwcInput) {
+        MlasReorderFilterOIHWBiBo(FilterShape, Filter.data(), ReorderedFilter.data());
+    } else {
+        MlasReorderFilterOIHWBo(FilterShape, Filter.data(), ReorderedFilter.data());
+    }
+
+    auto Input = RandomBuffer<float>(InputChannels * Shape.InputSize * Shape.InputSize);
+    auto Bias = RandomBuffer<float>(OutputChannels);
+    std::vector<float> Output(OutputChannels * Shape.OutputSize * Shape.OutputSize);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    for (auto _ : state) {
+        MlasNchwcConv(2, InputShape, KernelShape, DilationShape, Padding, StrideShape, OutputShape, 1, Input.data(),
+                      ReorderedFilter.data(), Bias.data(), Output.data(), &Activation, true, ThreadPool.get());
+    }
+
+    SetFlopsCounter(state, Shape.Flops());
+}
+
+BENCHMARK(BM_NchwcConv)->Apply(ConvShapes)->UseRealTime();
+
+//
+// Pooling shapes: channels, input height/width, kernel size, stride, padding
+// and threads.
+//
+// ResNet-50 with a batch of 1: the max pooling after the stem and the global
+// average pooling before the classifier.
+//
+
+static
+void
+PoolShapes(
+    benchmark::internal::Benchmark* b
+    )
+{
+    const std::vector<std::vector<int64_t>> Shapes = {
+        {64, 112, 3, 2, 1},
+        {2048, 7, 7, 1, 0},
+    };
+
+    for (const auto& Shape : Shapes) {
+        for (int64_t Threads : {1, 4}) {
+            b->Args({Shape[0], Shape[1], Shape[2], Shape[3], Shape[4], Threads});
+        }
+    }
+
+    b->ArgNames({"C", "HW", "Kernel", "Stride", "Pad", "Threads"});
+}
+
+template <MLAS_POOLING_KIND PoolingKind>
+static
+void
+BM_Pool(
+    benchmark::State& state
+    )
+{
+    const int64_t Channels = state.range(0);
+    const int64_t InputSize = state.range(1);
+    const int64_t KernelSize = state.range(2);
+    const int64_t Stride = state.range(3);
+    const int64_t PaddingSize = state.range(4);
+    const int64_t OutputSize = (InputSize + 2 * PaddingSize - KernelSize) / Stride + 1;
+    auto ThreadPool = CreateThreadPool(state.range(5));
+
+    const int64_t InputShape[] = {1, Channels, InputSize, InputSize};
+    const int64_t KernelShape[] = {KernelSize, KernelSize};
+    const int64_t Padding[] = {PaddingSize, PaddingSize, PaddingSize, PaddingSize};
+    const int64_t StrideShape[] = {Stride, Stride};
+    const int64_t OutputShape[] = {1, Channels, OutputSize, OutputSize};
+
+    auto Input = RandomBuffer<float>(Channels * InputSize * InputSize);
+    std::vector<float> Output(Channels * OutputSize * OutputSize);
+
+    for (auto _ : state) {
+        MlasPool(PoolingKind, 2, InputShape, KernelShape, Padding, StrideShape, OutputShape, Input.data(), Output.data(), ThreadPool.get());
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(Input.size() * sizeof(float)));
+}
+
+BENCHMARK_TEMPLATE(BM_Pool, MlasMaximumPooling)->Apply(PoolShapes)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Pool, MlasAveragePoolingExcludePad)->Apply(PoolShapes)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -17,8 +17,11 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
+#include <random>
+#include <vector>
 #include <mlas.h>
 
 #if defined(_WIN32)
@@ -246,6 +249,229 @@ private:
         }
     }
 
+    void
+    TestEpilogue(
+        size_t M,
+        size_t N,
+        size_t K
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        const float* Bias = BufferBias.GetBuffer(N);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        MLAS_ACTIVATION Activation;
+        Activation.ActivationKind = MlasReluActivation;
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, C, N, Bias, &Activation, threadpool);
+        ReferenceSgemm(CblasNoTrans, CblasNoTrans, M, N, K, 1.0f, A, K, B, N, 0.0f, CReference, N);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float* c = CReference + (m * N) + n;
+                *c = std::max(*c + Bias[n], 0.0f);
+            }
+        }
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch epilogue M=%zd, N=%zd, K=%zd!\n", M, N, K);
+                break;
+            }
+        }
+    }
+
+    void
+    TestPacked(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* PackedB = BufferPackedB.GetBuffer(MlasSgemmPackBSize(N, K) / sizeof(float));
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        for (int t = 0; t < 4; t++) {
+
+            CBLAS_TRANSPOSE TransA = (t & 1) ? CblasTrans : CblasNoTrans;
+            CBLAS_TRANSPOSE TransB = (t & 2) ? CblasTrans : CblasNoTrans;
+            size_t lda = (TransA == CblasNoTrans) ? K : M;
+            size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+            std::fill_n(C, M * N, -0.5f);
+            std::fill_n(CReference, M * N, -0.5f);
+
+            MlasSgemmPackB(TransB, N, K, B, ldb, PackedB);
+            MlasSgemmPacked(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, N, nullptr, nullptr, threadpool);
+            ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+            for (size_t f = 0; f < M * N; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch packed TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                    break;
+                }
+            }
+        }
+    }
+
+    static
+    MLAS_FP16
+    ConvertFloatToHalf(
+        float Value
+        )
+    {
+        // N.B. The test values are small integers, so the conversion does not
+        // need to handle rounding, denormals, infinities or NaNs.
+        uint32_t Bits;
+        memcpy(&Bits, &Value, sizeof(Bits));
+
+        MLAS_FP16 Half;
+        Half.val = uint16_t((Bits >> 16) & 0x8000);
+
+        if ((Bits & 0x7FFFFFFF) != 0) {
+            Half.val |= uint16_t(((((Bits >> 23) & 0xFF) - 112) << 10) | ((Bits >> 13) & 0x3FF));
+        }
+
+        return Half;
+    }
+
+    void
+    TestHalfB(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        MLAS_FP16* HalfB = reinterpret_cast<MLAS_FP16*>(BufferHalfB.GetBuffer(N * K));
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        for (size_t f = 0; f < N * K; f++) {
+            HalfB[f] = ConvertFloatToHalf(B[f]);
+        }
+
+        for (int t = 0; t < 4; t++) {
+
+            CBLAS_TRANSPOSE TransA = (t & 1) ? CblasTrans : CblasNoTrans;
+            CBLAS_TRANSPOSE TransB = (t & 2) ? CblasTrans : CblasNoTrans;
+            size_t lda = (TransA == CblasNoTrans) ? K : M;
+            size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+            std::fill_n(C, M * N, -0.5f);
+            std::fill_n(CReference, M * N, -0.5f);
+
+            MlasSgemm(TransA, TransB, M, N, K, alpha, A, lda, HalfB, ldb, beta, C, N, nullptr, nullptr, threadpool);
+            ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+            for (size_t f = 0; f < M * N; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch half B TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                    break;
+                }
+            }
+        }
+    }
+
+    void
+    TestBf16(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        //
+        // The test values are small integers that are exactly representable
+        // as bfloat16, so the results match the single precision reference.
+        //
+
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        for (int t = 0; t < 4; t++) {
+
+            CBLAS_TRANSPOSE TransA = (t & 1) ? CblasTrans : CblasNoTrans;
+            CBLAS_TRANSPOSE TransB = (t & 2) ? CblasTrans : CblasNoTrans;
+            size_t lda = (TransA == CblasNoTrans) ? K : M;
+            size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+            std::fill_n(C, M * N, -0.5f);
+            std::fill_n(CReference, M * N, -0.5f);
+
+            MlasSgemmBf16(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, N, threadpool);
+            ReferenceSgemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, N);
+
+            for (size_t f = 0; f < M * N; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch bf16 TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, M, N, K, alpha, beta);
+                    break;
+                }
+            }
+        }
+    }
+
+    void
+    TestBatch(
+        size_t BatchSize,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M * BatchSize);
+        const float* B = BufferB.GetBuffer(N * K * BatchSize);
+        float* C = BufferC.GetBuffer(N * M * BatchSize);
+        float* CReference = BufferCReference.GetBuffer(N * M * BatchSize);
+
+        std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+
+        for (int t = 0; t < 4; t++) {
+
+            CBLAS_TRANSPOSE TransA = (t & 1) ? CblasTrans : CblasNoTrans;
+            CBLAS_TRANSPOSE TransB = (t & 2) ? CblasTrans : CblasNoTrans;
+            size_t lda = (TransA == CblasNoTrans) ? K : M;
+            size_t ldb = (TransB == CblasNoTrans) ? N : K;
+
+            std::fill_n(C, M * N * BatchSize, -0.5f);
+            std::fill_n(CReference, M * N * BatchSize, -0.5f);
+
+            for (size_t b = 0; b < BatchSize; b++) {
+                Data[b].A = A + M * K * b;
+                Data[b].B = B + N * K * b;
+                Data[b].C = C + M * N * b;
+                ReferenceSgemm(TransA, TransB, M, N, K, alpha, Data[b].A, lda, Data[b].B, ldb, beta, CReference + M * N * b, N);
+            }
+
+            MlasSgemmBatch(TransA, TransB, M, N, K, alpha, lda, ldb, beta, N, Data.data(), BatchSize, threadpool);
+
+            for (size_t f = 0; f < M * N * BatchSize; f++) {
+                if (C[f] != CReference[f]) {
+                    printf("mismatch batch TransA=%d, TransB=%d, BatchSize=%zd, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f!\n", TransA, TransB, BatchSize, M, N, K, alpha, beta);
+                    break;
+                }
+            }
+        }
+    }
+
     void
     ReferenceSgemm(
         CBLAS_TRANSPOSE TransA,
@@ -357,6 +583,9 @@ private:
 
     MatrixGuardBuffer<float> BufferA;
     MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<float> BufferBias;
+    MatrixGuardBuffer<float> BufferPackedB;
+    MatrixGuardBuffer<uint16_t> BufferHalfB;
     MatrixGuardBuffer<float> BufferC;
     MatrixGuardBuffer<float> BufferCReference;
 
@@ -375,6 +604,29 @@ public:
         for (size_t b = 256; b < 320; b += 32) {
             Test(b, b, b, 1.0f, 0.0f);
         }
+        for (size_t b = 1; b < 320; b += 31) {
+            TestEpilogue(1, b, b);
+            TestEpilogue(b, b + 3, b);
+        }
+        for (size_t b = 1; b < 400; b += 37) {
+            TestPacked(b, b + 5, b, 1.0f, 0.0f);
+            TestPacked(b + 3, b, b * 2, 0.5f, 1.0f);
+        }
+        for (size_t b = 1; b < 400; b += 37) {
+            TestHalfB(b, b + 5, b, 1.0f, 0.0f);
+            TestHalfB(1, b + 7, b, 1.0f, 0.0f);
+            TestHalfB(b + 3, b, b * 2, 0.5f, 1.0f);
+        }
+        for (size_t b = 1; b < 400; b += 37) {
+            TestBf16(b, b + 5, b, 1.0f, 0.0f);
+            TestBf16(1, b + 7, b, 1.0f, 0.0f);
+            TestBf16(b + 3, b, b * 2, 0.5f, 1.0f);
+        }
+        for (size_t b = 1; b < 64; b += 9) {
+            TestBatch(b, 7, 9, 11, 1.0f, 0.0f);
+            TestBatch(b, b + 3, b, 16, 0.5f, 1.0f);
+            TestBatch(3, b, b + 17, b * 2, 1.0f, 0.0f);
+        }
     }
 
     void
@@ -504,6 +756,49 @@ private:
         }
     }
 
+    void
+    TestRequantize(
+        size_t M,
+        size_t N,
+        size_t K,
+        uint8_t offa,
+        uint8_t offb
+        )
+    {
+        const uint8_t* A = BufferA.GetBuffer(K * M);
+        const xint8_t* B = BufferB.GetBuffer(N * K);
+        int32_t* C = BufferC.GetBuffer(N * M);
+        int32_t* CReference = BufferCReference.GetBuffer(N * M);
+        int32_t* Bias = BufferBias.GetBuffer(M);
+        uint8_t* Output = BufferOutput.GetBuffer(N * M);
+        uint8_t* OutputReference = BufferOutputReference.GetBuffer(N * M);
+
+        for (size_t m = 0; m < M; m++) {
+            Bias[m] = int32_t(m * 37) - 500;
+        }
+
+        const float Scale = 1.0f / float(K * 64 + 1);
+        const uint8_t ZeroPoint = 112;
+
+        MLAS_QGEMM_REQUANTIZE Requantize;
+        Requantize.Output = Output;
+        Requantize.ldo = N;
+        Requantize.Bias = Bias;
+        Requantize.Scale = Scale;
+        Requantize.ZeroPoint = ZeroPoint;
+
+        MlasGemm(M, N, K, A, K, offa, B, N, xint8_t(offb), C, N, &Requantize, threadpool);
+        ReferenceQgemm(M, N, K, A, K, offa, B, N, xint8_t(offb), CReference, N);
+        MlasRequantizeOutput(CReference, OutputReference, Bias, M, N, Scale, ZeroPoint);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (Output[f] != OutputReference[f]) {
+                printf("requantize mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+                break;
+            }
+        }
+    }
+
     void
     ReferenceQgemm(
         size_t M,
@@ -543,6 +838,9 @@ private:
     MatrixGuardBuffer<xint8_t> BufferB;
     MatrixGuardBuffer<int32_t> BufferC;
     MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<int32_t> BufferBias;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+    MatrixGuardBuffer<uint8_t> BufferOutputReference;
 
 public:
     void
@@ -559,6 +857,11 @@ public:
         for (size_t b = 256; b < 320; b += 32) {
             Test(b, b, b, 85, 173);
         }
+        for (size_t b = 1; b < 96; b += 19) {
+            TestRequantize(b, b + 3, b * 2, 7, 129);
+        }
+        TestRequantize(384, 64, 300, 34, 1);
+        TestRequantize(64, 600, 257, 85, 173);
     }
 
     void
@@ -896,6 +1199,13 @@ public:
             Test(1, 1, 16, i, i, 32, i, 1, 0, 0, 0, 0, 1, 1, 1, 1);
             Test(1, 1, 16, i, i, 32, 1, i, 0, 0, 0, 0, 1, 1, 1, 1);
         }
+        for (unsigned i = 1; i < 128; i += 9) {
+            // Depthwise convolutions.
+            Test(1, 32, 1, i, i + 3, 1, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(2, 32, 1, i, i + 3, 1, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+            Test(1, 32, 1, i, i, 1, 5, 5, 2, 2, 2, 2, 1, 1, 1, 1);
+            Test(1, 32, 1, i, i, 1, 3, 3, 0, 1, 2, 0, 2, 2, 1, 2);
+        }
     }
 
     void
@@ -916,6 +1226,12 @@ public:
             Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
         }
 
+        // Depthwise convolutions with a channel multiplier.
+        for (unsigned i = 1; i < 64; i += 3) {
+            Test(2, 24, 1, i, i + 5, 2, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 17, 1, i, i, 3, 5, 5, 2, 1, 0, 2, 1, 2, 2, 1);
+        }
+
         for (unsigned ic = 0; ic < _countof(cs); ic++) {
             for (unsigned ih = 0; ih < _countof(is); ih++) {
                 for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1138,6 +1454,12 @@ public:
             Test(b, 1, 64, 11, 11, 128, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1);
         }
 
+        // Depthwise convolutions with a channel multiplier.
+        for (unsigned i = 1; i < 64; i += 3) {
+            Test(2, 24, 1, i, i + 5, 2, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+            Test(1, 17, 1, i, i, 3, 5, 5, 2, 1, 0, 2, 1, 2, 2, 1);
+        }
+
         for (unsigned ic = 0; ic < _countof(cis); ic++) {
             for (unsigned ih = 0; ih < _countof(is); ih++) {
                 for (unsigned iw = 0; iw < _countof(is); iw++) {
@@ -1959,6 +2281,263 @@ public:
     }
 };
 
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+    void
+    Test(
+        size_t N,
+        size_t D,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+        std::default_random_engine generator(static_cast<unsigned>(N * D));
+        std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = distribution(generator);
+        }
+
+        Test(Input, Output, OutputReference, N, D, false);
+        Test(Input, Output, OutputReference, N, D, true);
+    }
+
+    void
+    Test(
+        const float* Input,
+        float* Output,
+        float* OutputReference,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
+        ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+
+        constexpr float AbsoluteTolerance = 1e-6f;
+        constexpr float RelativeTolerance = 1e-6f;
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            float diff = std::fabs(Output[nd] - OutputReference[nd]);
+            if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
+                printf("softmax(%d) difference: %u/%u %.8f %.8f\n", int32_t(LogSoftmax), unsigned(N), unsigned(D), Output[nd], OutputReference[nd]);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceSoftmax(
+        const float* Input,
+        float* Output,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        for (size_t n = 0; n < N; n++) {
+
+            float MaximumValue = std::numeric_limits<float>::lowest();
+
+            for (size_t d = 0; d < D; d++) {
+                MaximumValue = (std::max)(MaximumValue, Input[d]);
+            }
+
+            double Sum = 0.0;
+
+            for (size_t d = 0; d < D; d++) {
+                double e = std::exp(double(Input[d]) - double(MaximumValue));
+                Sum += e;
+                Output[d] = float(e);
+            }
+
+            if (LogSoftmax) {
+
+                float Scale = float(std::log(Sum));
+
+                for (size_t d = 0; d < D; d++) {
+                    Output[d] = Input[d] - MaximumValue - Scale;
+                }
+
+            } else {
+
+                float Scale = float(Sum);
+
+                for (size_t d = 0; d < D; d++) {
+                    Output[d] /= Scale;
+                }
+            }
+
+            Input += D;
+            Output += D;
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 128; d++) {
+            Test(1, d, -10.f, 10.f);
+        }
+
+        Test(3, 128, 20.f, 30.f);
+        Test(63, 95, -150.f, 190.f);
+        Test(16, 211, 20.f, 30.f);
+        Test(256, 1024, -2.f, 2.f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+class MlasRequantizeOutputTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<int32_t> BufferInput;
+    MatrixGuardBuffer<int32_t> BufferBias;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+    MatrixGuardBuffer<uint8_t> BufferOutputReference;
+
+    void
+    Test(
+        size_t M,
+        size_t N,
+        float Scale,
+        uint8_t ZeroPoint
+        )
+    {
+        int32_t* Input = BufferInput.GetBuffer(M * N);
+        int32_t* Bias = BufferBias.GetBuffer(M);
+        uint8_t* Output = BufferOutput.GetBuffer(M * N);
+        uint8_t* OutputReference = BufferOutputReference.GetBuffer(M * N);
+
+        std::default_random_engine generator(static_cast<unsigned>(M * N));
+        std::uniform_int_distribution<int32_t> distribution(-5000, 5000);
+
+        for (size_t mn = 0; mn < M * N; mn++) {
+            Input[mn] = distribution(generator);
+        }
+
+        for (size_t m = 0; m < M; m++) {
+            Bias[m] = distribution(generator);
+        }
+
+        MlasRequantizeOutput(Input, Output, Bias, M, N, Scale, ZeroPoint);
+
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                float Value = std::nearbyint(float(Input[m * N + n] + Bias[m]) * Scale) + float(ZeroPoint);
+                OutputReference[m * N + n] = uint8_t((std::min)((std::max)(Value, 0.0f), 255.0f));
+            }
+        }
+
+        for (size_t mn = 0; mn < M * N; mn++) {
+            if (Output[mn] != OutputReference[mn]) {
+                printf("requantize mismatch M=%zd, N=%zd, Scale=%f, ZeroPoint=%d: %d %d\n", M, N, Scale, int(ZeroPoint), int(Output[mn]), int(OutputReference[mn]));
+                break;
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t n = 1; n < 40; n++) {
+            Test(3, n, 0.03125f, 128);
+            Test(2, n, 0.0078125f, 0);
+            Test(5, n, 0.5f, 255);
+        }
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+template <typename ElementType>
+class MlasTransposeTest : public MlasTestBase
+{
+private:
+    MatrixGuardBuffer<ElementType> BufferInput;
+    MatrixGuardBuffer<ElementType> BufferOutput;
+
+    void
+    Test(
+        size_t BatchCount,
+        size_t M,
+        size_t N
+        )
+    {
+        ElementType* Input = BufferInput.GetBuffer(BatchCount * M * N);
+        ElementType* Output = BufferOutput.GetBuffer(BatchCount * M * N);
+
+        for (size_t i = 0; i < BatchCount * M * N; i++) {
+            Input[i] = ElementType(i * 2654435761u);
+        }
+
+        MlasTranspose(Input, Output, BatchCount, M, N, threadpool);
+
+        for (size_t b = 0; b < BatchCount; b++) {
+            for (size_t m = 0; m < M; m++) {
+                for (size_t n = 0; n < N; n++) {
+                    if (Output[(b * N + n) * M + m] != Input[(b * M + m) * N + n]) {
+                        printf("mismatch transpose ElementSize=%zd, BatchCount=%zd, M=%zd, N=%zd!\n", sizeof(ElementType), BatchCount, M, N);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t m = 1; m < 40; m++) {
+            for (size_t n = 1; n < 40; n += 3) {
+                Test(1, m, n);
+                Test(3, m, n);
+            }
+        }
+        Test(1, 3, 224 * 224);
+        Test(2, 56 * 56, 64);
+        Test(16, 128, 64);
+        Test(1, 513, 1027);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
 int
 #if defined(_WIN32)
 __cdecl
@@ -1967,6 +2546,8 @@ main(
     void
     )
 {
+    printf("Kernel selection: %s\n", MlasGetKernelSelection());
+
     for (int i = 0; i != 2; ++i) {
         printf("SGEMM tests.\n");
         std::make_unique<MlasSgemmTest>()->ExecuteShort();
@@ -1995,6 +2576,16 @@ main(
         printf("Activation tests.\n");
         std::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Softmax tests.\n");
+        std::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+        printf("Requantize tests.\n");
+        std::make_unique<MlasRequantizeOutputTest>()->ExecuteShort();
+
+        printf("Transpose tests.\n");
+        std::make_unique<MlasTransposeTest<uint32_t>>()->ExecuteShort();
+        std::make_unique<MlasTransposeTest<uint64_t>>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
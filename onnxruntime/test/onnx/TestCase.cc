@@ -239,6 +239,9 @@ class OnnxModelInfo : public TestModelInfo {
   std::string GetModelVersion() const override { return onnx_commit_tag_; }
 
   const std::string& GetNodeName() const override { return node_name_; }
+  const ONNX_NAMESPACE::ValueInfoProto* GetInputInfoFromModel(size_t i) const override {
+    return &input_value_info_[i];
+  }
   const ONNX_NAMESPACE::ValueInfoProto* GetOutputInfoFromModel(size_t i) const override {
     return &output_value_info_[i];
   }
@@ -49,6 +49,7 @@ class TestModelInfo {
     return test_case_dir;
   }
   virtual const std::string& GetNodeName() const = 0;
+  virtual const ONNX_NAMESPACE::ValueInfoProto* GetInputInfoFromModel(size_t i) const = 0;
   virtual const ONNX_NAMESPACE::ValueInfoProto* GetOutputInfoFromModel(size_t i) const = 0;
   virtual int GetInputCount() const = 0;
   virtual int GetOutputCount() const = 0;
@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of single CPU kernels. Each one builds a model of one node, lets an InferenceSession create the kernel,
+// and then times only OpKernel::Compute, called through an OpKernelContext on the same execution frame, so the cost of
+// the executor and of the output allocations after the first iteration is excluded.
+// The last argument of every benchmark is intra_op_num_threads.
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include <core/graph/onnx_protobuf.h>
+#include <core/graph/model.h>
+#include <core/framework/allocator.h>
+#include <core/framework/execution_frame.h>
+#include <core/framework/op_kernel_context_internal.h>
+#include <core/framework/session_state.h>
+#include <core/session/inference_session.h>
+
+using namespace onnxruntime;
+
+namespace {
+class KernelBenchmarkSession : public InferenceSession {
+ public:
+  explicit KernelBenchmarkSession(const SessionOptions& session_options) : InferenceSession(session_options) {}
+
+  common::Status LoadModel(const ONNX_NAMESPACE::ModelProto& model_proto) { return Load(model_proto); }
+
+  const SessionState& GetSessionState() const { return session_state_; }
+};
+
+OrtValue CreateRandomTensor(const std::vector<int64_t>& dims, std::default_random_engine& rand_engine) {
+  auto tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape(dims),
+                                         std::make_shared<CPUAllocator>());
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  float* data = tensor->MutableData<float>();
+  for (int64_t i = 0; i < tensor->Shape().Size(); ++i) {
+    data[i] = distribution(rand_engine);
+  }
+
+  OrtValue value;
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  value.Init(tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  return value;
+}
+
+// Runs the kernel of op_type on float inputs of input_shapes with intra_op_num_threads of threads.
+// flops is the number of floating point operations of one Compute, to report the GFLOPS counter.
+void RunKernel(benchmark::State& state, int64_t threads, const std::string& op_type,
+               const std::vector<std::vector<int64_t>>& input_shapes,
+               const std::function<void(Node&)>& add_attributes, double flops) {
+  onnxruntime::Model model("kernel_benchmark", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 10}});
+  Graph& graph = model.MainGraph();
+  std::vector<NodeArg*> input_args;
+  for (size_t i = 0; i < input_shapes.size(); ++i) {
+    ONNX_NAMESPACE::TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (int64_t dim : input_shapes[i]) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    input_args.push_back(&graph.GetOrCreateNodeArg("X" + std::to_string(i), &type));
+  }
+  NodeArg& output_arg = graph.GetOrCreateNodeArg("Y", nullptr);
+  Node& node = graph.AddNode("node", op_type, op_type, input_args, {&output_arg});
+  if (add_attributes) add_attributes(node);
+
+  auto status = graph.Resolve();
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  SessionOptions session_options;
+  session_options.intra_op_num_threads = static_cast<int>(threads);
+  session_options.graph_optimization_level = TransformerLevel::Default;
+  session_options.enable_mem_pattern = false;
+  KernelBenchmarkSession session(session_options);
+  status = session.LoadModel(model.ToProto());
+  if (status.IsOK()) status = session.Initialize();
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  const SessionState& session_state = session.GetSessionState();
+  const auto& ort_value_name_idx_map = session_state.GetOrtValueNameIdxMap();
+  std::default_random_engine rand_engine(42);
+  std::vector<int> feed_idxs(input_shapes.size());
+  std::vector<OrtValue> feeds;
+  for (size_t i = 0; i < input_shapes.size(); ++i) {
+    status = ort_value_name_idx_map.GetIdx(input_args[i]->Name(), feed_idxs[i]);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      return;
+    }
+    feeds.push_back(CreateRandomTensor(input_shapes[i], rand_engine));
+  }
+  int fetch_idx;
+  status = ort_value_name_idx_map.GetIdx(output_arg.Name(), fetch_idx);
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  const OpKernel* kernel = session_state.GetKernel(session_state.GetGraphViewer()->GetNodesInTopologicalOrder()[0]);
+  ExecutionFrame frame(feed_idxs, feeds, {fetch_idx}, {}, {}, session_state);
+  const bool terminate_flag = false;
+  for (auto _ : state) {
+    OpKernelContextInternal context(session_state, frame, *kernel, session_state.Logger(), terminate_flag);
+    status = kernel->Compute(&context);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+
+  if (flops > 0) {
+    state.counters["GFLOPS"] = benchmark::Counter(flops * state.iterations() / 1e9, benchmark::Counter::kIsRate);
+  }
+}
+
+void ThreadCounts(benchmark::internal::Benchmark* b, const std::vector<std::vector<int64_t>>& shapes) {
+  for (const auto& shape : shapes) {
+    for (int64_t threads : {1, 4}) {
+      auto args = shape;
+      args.push_back(threads);
+      b->Args(args);
+    }
+  }
+}
+}  // namespace
+
+// BERT-base with a sequence length of 128: the QKV/output projections and the feed forward layers.
+static void BM_MatMul(benchmark::State& state) {
+  const int64_t M = state.range(0), N = state.range(1), K = state.range(2);
+  RunKernel(state, state.range(3), "MatMul", {{M, K}, {K, N}}, nullptr, 2.0 * M * N * K);
+}
+BENCHMARK(BM_MatMul)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      ThreadCounts(b, {{128, 768, 768}, {128, 3072, 768}, {128, 768, 3072}});
+      b->ArgNames({"M", "N", "K", "Threads"});
+    })
+    ->UseRealTime();
+
+// BERT-base: the Softmax of the attention scores of the 12 heads, and the residual Add.
+static void BM_Softmax(benchmark::State& state) {
+  RunKernel(state, state.range(0), "Softmax", {{12 * 128, 128}}, nullptr, 0);
+}
+BENCHMARK(BM_Softmax)->Arg(1)->Arg(4)->ArgName("Threads")->UseRealTime();
+
+static void BM_Add(benchmark::State& state) {
+  RunKernel(state, state.range(0), "Add", {{128, 768}, {128, 768}}, nullptr, 0);
+}
+BENCHMARK(BM_Add)->Arg(1)->Arg(4)->ArgName("Threads")->UseRealTime();
+
+// ResNet-50 with a batch of 1: the stem, the 3x3 and 1x1 convolutions of the first stage and the 3x3 convolution of
+// the last stage.
+static void BM_Conv(benchmark::State& state) {
+  const int64_t C = state.range(0), HW = state.range(1), F = state.range(2), kernel = state.range(3),
+                stride = state.range(4), pad = state.range(5);
+  const int64_t output_size = (HW + 2 * pad - kernel) / stride + 1;
+  RunKernel(state, state.range(6), "Conv", {{1, C, HW, HW}, {F, C, kernel, kernel}, {F}},
+            [=](Node& node) {
+              node.AddAttribute("kernel_shape", std::vector<int64_t>{kernel, kernel});
+              node.AddAttribute("strides", std::vector<int64_t>{stride, stride});
+              node.AddAttribute("pads", std::vector<int64_t>{pad, pad, pad, pad});
+            },
+            2.0 * F * output_size * output_size * C * kernel * kernel);
+}
+BENCHMARK(BM_Conv)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      ThreadCounts(b, {{3, 224, 64, 7, 2, 3}, {64, 56, 64, 3, 1, 1}, {64, 56, 256, 1, 1, 0}, {512, 7, 512, 3, 1, 1}});
+      b->ArgNames({"C", "HW", "F", "Kernel", "Stride", "Pad", "Threads"});
+    })
+    ->UseRealTime();
+
+// ResNet-50: the max pooling after the stem and the global average pooling before the classifier.
+static void BM_MaxPool(benchmark::State& state) {
+  RunKernel(state, state.range(0), "MaxPool", {{1, 64, 112, 112}},
+            [](Node& node) {
+              node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+              node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+              node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+            },
+            0);
+}
+BENCHMARK(BM_MaxPool)->Arg(1)->Arg(4)->ArgName("Threads")->UseRealTime();
+
+static void BM_GlobalAveragePool(benchmark::State& state) {
+  RunKernel(state, state.range(0), "GlobalAveragePool", {{1, 2048, 7, 7}}, nullptr, 0);
+}
+BENCHMARK(BM_GlobalAveragePool)->Arg(1)->Arg(4)->ArgName("Threads")->UseRealTime();
+
+// LSTM with a hidden size and an input size of 256, over 32 steps.
+static void BM_LSTM(benchmark::State& state) {
+  const int64_t batch = state.range(0);
+  const int64_t seq_length = 32, input_size = 256, hidden_size = 256;
+  RunKernel(state, state.range(1), "LSTM",
+            {{seq_length, batch, input_size}, {1, 4 * hidden_size, input_size}, {1, 4 * hidden_size, hidden_size}},
+            [=](Node& node) { node.AddAttribute("hidden_size", hidden_size); },
+            2.0 * seq_length * batch * 4 * hidden_size * (input_size + hidden_size));
+}
+BENCHMARK(BM_LSTM)
+    ->Apply([](benchmark::internal::Benchmark* b) {
+      ThreadCounts(b, {{1}, {64}});
+      b->ArgNames({"Batch", "Threads"});
+    })
+    ->UseRealTime();
@@ -11,6 +11,7 @@
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/unsqueeze_elimination.h"
+#include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
@@ -18,6 +19,19 @@
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/relu_clip_fusion.h"
+#include "core/optimizer/pad_fusion.h"
+#include "core/optimizer/matmul_mul_fusion.h"
+#include "core/optimizer/gemm_add_fusion.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/matmul_scale_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/optimizer/ml_preprocessing_fusion.h"
+#include "core/optimizer/qdq_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_fusion.h"
 #include "core/framework/data_types.h"
 #include "core/framework/ml_value.h"
 #include "core/util/math.h"
@@ -28,6 +42,8 @@
 #include "gtest/gtest.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/common_subexpression_elimination.h"
+#include "core/optimizer/dead_node_elimination.h"
 #include "core/optimizer/shape_to_initializer.h"
 
 using namespace std;
@@ -115,6 +131,38 @@ TEST(GraphTransformationTests, ConstantFolding) {
   ASSERT_TRUE(op_to_count["Unsqueeze"] == 0);
 }
 
+TEST(GraphTransformationTests, ConstantFoldingSizeBudget) {
+  // Expand of a 2 element constant to a 512x2 output
+  string model_uri = MODEL_FOLDER + "constant_folding_size_budget.onnx";
+
+  {
+    std::shared_ptr<Model> model;
+    ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+    Graph& graph = model->MainGraph();
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::make_unique<ConstantFolding>(std::unordered_set<std::string>{}, 1024),
+                                      TransformerLevel::Level1);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_TRUE(op_to_count["Expand"] == 1);
+  }
+
+  {
+    std::shared_ptr<Model> model;
+    ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+    Graph& graph = model->MainGraph();
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(std::make_unique<ConstantFolding>(), TransformerLevel::Level1);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    ASSERT_TRUE(op_to_count["Expand"] == 0);
+  }
+}
+
 TEST(GraphTransformationTests, ConstantFoldingSubgraph) {
   TensorProto value_tensor;
   value_tensor.add_dims(1);
@@ -211,6 +259,71 @@ TEST(GraphTransformationTests, ShapeToInitializer) {
   ASSERT_TRUE(op_to_count["Shape"] == 2);
 }
 
+TEST(GraphTransformationTests, ReshapeFusion) {
+  string model_uri = MODEL_FOLDER + "reshape_fusion.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Reshape"] == 2);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  auto rule_transformer_L1 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformerL1");
+  rule_transformer_L1->Register(std::make_unique<ReshapeFusion>());
+  graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  op_to_count = CountOpsInGraph(graph);
+  // Flatten -> Reshape and Squeeze -> Unsqueeze each become a single Reshape, and the no-op Reshape is removed
+  ASSERT_TRUE(op_to_count["Flatten"] == 0);
+  ASSERT_TRUE(op_to_count["Squeeze"] == 0);
+  ASSERT_TRUE(op_to_count["Unsqueeze"] == 0);
+  ASSERT_TRUE(op_to_count["Reshape"] == 2);
+  ASSERT_TRUE(op_to_count["Relu"] == 1);
+  ASSERT_TRUE(op_to_count["Neg"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Reshape") {
+      const auto& input_name = node.InputDefs()[0]->Name();
+      ASSERT_TRUE(input_name == "X" || input_name == "X2");
+    } else if (node.OpType() == "Neg") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "relu_out");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, CommonSubexpressionElimination) {
+  string model_uri = MODEL_FOLDER + "cse.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_TRUE(Model::Load(model_uri, model).IsOK());
+  Graph& graph = model->MainGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Shape"] == 2);
+  ASSERT_TRUE(op_to_count["Cast"] == 3);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<CommonSubexpressionElimination>(), TransformerLevel::Level1);
+
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1).IsOK());
+
+  op_to_count = CountOpsInGraph(graph);
+  // the duplicated Shape -> Gather -> Unsqueeze chain and the duplicated Cast to double are merged
+  ASSERT_TRUE(op_to_count["Shape"] == 1);
+  ASSERT_TRUE(op_to_count["Gather"] == 1);
+  ASSERT_TRUE(op_to_count["Unsqueeze"] == 1);
+  // the Cast to int32 has a different attribute value
+  ASSERT_TRUE(op_to_count["Cast"] == 2);
+  // non-deterministic nodes are never merged
+  ASSERT_TRUE(op_to_count["RandomUniformLike"] == 2);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Concat" || (node.OpType() == "Add" && node.OutputDefs()[0]->Name() == "cast_out")) {
+      ASSERT_EQ(node.InputDefs()[0], node.InputDefs()[1]);
+    }
+  }
+}
+
 // Check transformations in the case of a subgraph with constant inputs.
 TEST(GraphTransformationTests, SubgraphWithConstantInputs) {
   string model_uri = MODEL_FOLDER + "constant-subgraph.onnx";
@@ -478,6 +591,297 @@ TEST(GraphTransformationTests, Gemm_Relu_three_input) {
   std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
   ASSERT_TRUE(op_to_count["Relu"] == 0);
 }
+
+// FastGelu is only fused into the Gemm nodes of CUDA, whose FusedGemm applies it in the epilogue of the GEMM
+TEST(GraphTransformationTests, GemmFastGeluFusionOnlyOnCuda) {
+  for (const std::string provider : {kCudaExecutionProvider, kCpuExecutionProvider}) {
+    Model model("GemmFastGelu", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+                {{"", 10}, {kMSDomain, 1}}, {});
+    Graph& graph = model.MainGraph();
+
+    auto tensor_type = [](const std::vector<int64_t>& dims) {
+      TypeProto type;
+      type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+      for (auto dim : dims) {
+        type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+      }
+      return type;
+    };
+    const TypeProto x_type = tensor_type({2, 3});
+    const TypeProto w_type = tensor_type({3, 4});
+    const TypeProto b_type = tensor_type({4});
+    const TypeProto y_type = tensor_type({2, 4});
+    auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+    auto& w = graph.GetOrCreateNodeArg("W", &w_type);
+    auto& b = graph.GetOrCreateNodeArg("B", &b_type);
+    auto& gemm_output = graph.GetOrCreateNodeArg("gemm_output", &y_type);
+    auto& y = graph.GetOrCreateNodeArg("Y", &y_type);
+    graph.AddNode("gemm", "Gemm", "Gemm", {&x, &w, &b}, {&gemm_output});
+    graph.AddNode("gelu", "FastGelu", "FastGelu", {&gemm_output}, {&y}, nullptr, kMSDomain);
+    for (auto& node : graph.Nodes()) {
+      node.SetExecutionProviderType(provider);
+    }
+    ASSERT_TRUE(graph.Resolve().IsOK());
+
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    graph_transformation_mgr.Register(
+        std::make_unique<GemmActivationFusion>(
+            std::unordered_set<std::string>{kCpuExecutionProvider, kCudaExecutionProvider}),
+        TransformerLevel::Level2);
+    ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+    std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+    if (provider == kCudaExecutionProvider) {
+      EXPECT_EQ(op_to_count["FusedGemm"], 1);
+      EXPECT_EQ(op_to_count["FastGelu"], 0);
+      for (const auto& node : graph.Nodes()) {
+        EXPECT_EQ(node.GetAttributes().at("activation").s(), "FastGelu");
+      }
+    } else {
+      EXPECT_EQ(op_to_count["Gemm"], 1);
+      EXPECT_EQ(op_to_count["FastGelu"], 1);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, LayerNormFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/layer_norm.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["ReduceMean"] == 0);
+  ASSERT_TRUE(op_to_count["Sub"] == 0);
+  ASSERT_TRUE(op_to_count["Pow"] == 0);
+  ASSERT_TRUE(op_to_count["Sqrt"] == 0);
+  ASSERT_TRUE(op_to_count["Div"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["LayerNormalization"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "LayerNormalization") {
+      ASSERT_EQ(node.GetAttributes().at("axis").i(), 2);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, GeluFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/gelu.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<GeluFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Div"] == 0);
+  ASSERT_TRUE(op_to_count["Erf"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["Gelu"] == 1);
+}
+
+TEST(GraphTransformationTests, FastGeluFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/fast_gelu.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<GeluFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Pow"] == 0);
+  ASSERT_TRUE(op_to_count["Tanh"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["FastGelu"] == 1);
+}
+
+TEST(GraphTransformationTests, AttentionFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/attention.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["MatMul"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["Reshape"] == 0);
+  ASSERT_TRUE(op_to_count["Transpose"] == 0);
+  ASSERT_TRUE(op_to_count["Div"] == 0);
+  ASSERT_TRUE(op_to_count["Softmax"] == 0);
+  ASSERT_TRUE(op_to_count["Attention"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Attention") {
+      ASSERT_EQ(node.GetAttributes().at("num_heads").i(), 2);
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, MatMulTransposeFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/matmul_transpose.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<MatMulTransposeFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Transpose"] == 0);
+  ASSERT_TRUE(op_to_count["MatMul"] == 0);
+  ASSERT_TRUE(op_to_count["TransposeMatMul"] == 1);
+  ASSERT_TRUE(op_to_count["Gemm"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "TransposeMatMul") {
+      ASSERT_EQ(node.GetAttributes().at("transA").i(), 1);
+      ASSERT_EQ(node.GetAttributes().at("transB").i(), 0);
+    } else if (node.OpType() == "Gemm") {
+      ASSERT_EQ(node.GetAttributes().at("transA").i(), 0);
+      ASSERT_EQ(node.GetAttributes().at("transB").i(), 1);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, MatMulScaleFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/matmul_scale.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<MatMulScaleFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["Div"] == 0);
+  ASSERT_TRUE(op_to_count["MatMul"] == 0);
+  ASSERT_TRUE(op_to_count["TransposeMatMul"] == 2);
+  ASSERT_TRUE(op_to_count["Gemm"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "TransposeMatMul") {
+      ASSERT_EQ(node.GetAttributes().at("alpha").f(), 0.5f);
+    } else if (node.OpType() == "Gemm") {
+      ASSERT_EQ(node.GetAttributes().at("alpha").f(), 3.0f);
+      ASSERT_EQ(node.GetAttributes().at("beta").f(), 3.0f);
+    }
+  }
+}
+
+TEST(GraphTransformationTests, ElementwiseFusionTest) {
+  string model_uri = MODEL_FOLDER + "fusion/elementwise_chain.onnx";
+
+  std::shared_ptr<Model> p_model;
+  ASSERT_TRUE(Model::Load(model_uri, p_model).IsOK());
+  Graph& graph = p_model->MainGraph();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["Relu"] == 0);
+  ASSERT_TRUE(op_to_count["Sub"] == 0);
+  ASSERT_TRUE(op_to_count["MatMul"] == 1);
+  ASSERT_TRUE(op_to_count["FusedElementwise"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "FusedElementwise") {
+      const auto& ops = node.GetAttributes().at("ops").strings();
+      ASSERT_EQ(std::vector<std::string>(ops.begin(), ops.end()),
+                (std::vector<std::string>{"Add", "Mul", "Relu", "Sub"}));
+      const auto& operand_first = node.GetAttributes().at("operand_first").ints();
+      ASSERT_EQ(std::vector<int64_t>(operand_first.begin(), operand_first.end()),
+                (std::vector<int64_t>{0, 0, 1}));
+      ASSERT_EQ(node.InputDefs().size(), 4u);
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+    }
+  }
+}
+
+TEST(GraphTransformationTests, MLPreprocessingFusionTest) {
+  Model model("MLPreprocessingFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{"", 10}, {kMLDomain, 1}, {kMSDomain, 1}}, {});
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = float_tensor_type.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("N");
+  shape->add_dim()->set_dim_value(3);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& imputed = graph.GetOrCreateNodeArg("imputed", &float_tensor_type);
+  auto& scaled = graph.GetOrCreateNodeArg("scaled", &float_tensor_type);
+  auto& normalized = graph.GetOrCreateNodeArg("normalized", &float_tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+
+  auto& imputer = graph.AddNode("imputer", "Imputer", "Imputer", {&x}, {&imputed}, nullptr, kMLDomain);
+  imputer.AddAttribute("imputed_value_floats", std::vector<float>{2.0f});
+  imputer.AddAttribute("replaced_value_float", 0.0f);
+  auto& scaler = graph.AddNode("scaler", "Scaler", "Scaler", {&imputed}, {&scaled}, nullptr, kMLDomain);
+  scaler.AddAttribute("offset", std::vector<float>{1.0f, 2.0f, 3.0f});
+  scaler.AddAttribute("scale", std::vector<float>{4.0f, 5.0f, 6.0f});
+  auto& normalizer = graph.AddNode("normalizer", "Normalizer", "Normalizer", {&scaled}, {&normalized}, nullptr,
+                                   kMLDomain);
+  normalizer.AddAttribute("norm", std::string("L2"));
+  graph.AddNode("binarizer", "Binarizer", "Binarizer", {&normalized}, {&y}, nullptr, kMLDomain);
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<MLPreprocessingFusion>(), TransformerLevel::Level2);
+  ASSERT_TRUE(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2).IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Imputer"] == 0);
+  ASSERT_TRUE(op_to_count["Scaler"] == 0);
+  ASSERT_TRUE(op_to_count["Normalizer"] == 0);
+  ASSERT_TRUE(op_to_count["Binarizer"] == 0);
+  ASSERT_TRUE(op_to_count["FusedMLPreprocessing"] == 1);
+
+  for (const Node& node : graph.Nodes()) {
+    const auto& attributes = node.GetAttributes();
+    const auto& ops = attributes.at("ops").strings();
+    ASSERT_EQ(std::vector<std::string>(ops.begin(), ops.end()),
+              (std::vector<std::string>{"Imputer", "Scaler", "Normalizer", "Binarizer"}));
+    // the single imputed value is expanded to the 3 features
+    const auto& feature_values = attributes.at("feature_values").floats();
+    ASSERT_EQ(std::vector<float>(feature_values.begin(), feature_values.end()),
+              (std::vector<float>{2.0f, 2.0f, 2.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+    const auto& scalar_values = attributes.at("scalar_values").floats();
+    ASSERT_EQ(std::vector<float>(scalar_values.begin(), scalar_values.end()), (std::vector<float>{0.0f, 1.0f}));
+    ASSERT_EQ(attributes.at("norms").strings(0), "L2");
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+    ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y");
+  }
+}
 #endif
 
 TEST(GraphTransformationTests, FuseConvBnAddMulFloat16) {
@@ -606,5 +1010,555 @@ TEST(GraphTransformationTests, ReluClipFusion) {
   }
 }
 
+
+template <typename T>
+static NodeArg& AddTestInitializer(Graph& graph, const std::string& name, TensorProto_DataType data_type,
+                                   const std::vector<int64_t>& dims, const std::vector<T>& values) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(data_type);
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  for (auto dim : dims) {
+    tensor.add_dims(dim);
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  tensor.set_raw_data(values.data(), values.size() * sizeof(T));
+  graph.AddInitializedTensor(tensor);
+  return graph.GetOrCreateNodeArg(name, &type);
+}
+
+static TypeProto TestTensorType(TensorProto_DataType data_type, const std::vector<int64_t>& dims) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(data_type);
+  for (auto dim : dims) {
+    type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+  }
+  return type;
+}
+
+// Exp(X) and Relu(Y) meet at Add -> Tanh, which only one of the two chains can take
+TEST(GraphTransformationTests, ElementwiseFusionMeetingChains) {
+  Model model("ElementwiseFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto type = TestTensorType(TensorProto_DataType_FLOAT, {2, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+  auto& exp_output = graph.GetOrCreateNodeArg("exp_output", &type);
+  auto& relu_output = graph.GetOrCreateNodeArg("relu_output", &type);
+  auto& add_output = graph.GetOrCreateNodeArg("add_output", &type);
+  auto& z = graph.GetOrCreateNodeArg("Z", &type);
+  graph.AddNode("exp", "Exp", "", {&x}, {&exp_output});
+  graph.AddNode("relu", "Relu", "", {&y}, {&relu_output});
+  graph.AddNode("add", "Add", "", {&exp_output, &relu_output}, {&add_output});
+  graph.AddNode("tanh", "Tanh", "", {&add_output}, {&z});
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<ElementwiseFusion>(), TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["FusedElementwise"], 1);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Tanh"], 0);
+  ASSERT_EQ(op_to_count["Exp"] + op_to_count["Relu"], 1);
+
+  // every value has a single producer, which is still in the graph
+  std::unordered_set<std::string> produced{"X", "Y"};
+  for (const Node& node : graph.Nodes()) {
+    for (const auto* output : node.OutputDefs()) {
+      ASSERT_TRUE(produced.insert(output->Name()).second) << output->Name();
+    }
+  }
+  for (const Node& node : graph.Nodes()) {
+    for (const auto* input : node.InputDefs()) {
+      ASSERT_EQ(produced.count(input->Name()), 1u) << input->Name();
+    }
+  }
+}
+
+static Status ApplyPadFusion(Graph& graph) {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  auto rule_transformer_L1 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  rule_transformer_L1->Register(std::make_unique<PadFusion>());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1);
+  return graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+}
+
+// X -> Pad -> Conv -> Y, where the zeros padded are added to the pads of the Conv
+TEST(GraphTransformationTests, PadFusionConv) {
+  Model model("PadFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto x_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 1, 4, 4});
+  auto padded_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 1, 6, 7});
+  auto y_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 1, 5, 7});
+  auto& w = AddTestInitializer<float>(graph, "W", TensorProto_DataType_FLOAT, {1, 1, 3, 3},
+                                      std::vector<float>(9, 1.0f));
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& padded = graph.GetOrCreateNodeArg("padded", &padded_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &y_type);
+
+  auto& pad = graph.AddNode("pad", "Pad", "", {&x}, {&padded});
+  pad.AddAttribute("pads", std::vector<int64_t>{0, 0, 1, 2, 0, 0, 1, 1});
+  auto& conv = graph.AddNode("conv", "Conv", "", {&padded, &w}, {&y});
+  conv.AddAttribute("pads", std::vector<int64_t>{1, 1, 0, 1});
+
+  auto status = ApplyPadFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Pad"], 0);
+  ASSERT_EQ(op_to_count["Conv"], 1);
+  for (const Node& node : graph.Nodes()) {
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+    std::vector<int64_t> pads;
+    ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "pads", pads));
+    ASSERT_EQ(pads, std::vector<int64_t>({2, 3, 1, 2}));
+  }
+}
+
+// X -> Pad -> MaxPool and X -> Relu -> Pad -> MaxPool, where only the zeros padded to the output of the Relu can be
+// folded into the MaxPool, as its implicit padding is ignored rather than zeros
+TEST(GraphTransformationTests, PadFusionMaxPool) {
+  Model model("PadFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto x_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 4, 4});
+  auto padded_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 6, 6});
+  auto y_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 3, 3});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& relu_output = graph.GetOrCreateNodeArg("relu_output", &x_type);
+  auto& padded0 = graph.GetOrCreateNodeArg("padded0", &padded_type);
+  auto& padded1 = graph.GetOrCreateNodeArg("padded1", &padded_type);
+  auto& y0 = graph.GetOrCreateNodeArg("Y0", &y_type);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &y_type);
+
+  graph.AddNode("relu", "Relu", "", {&x}, {&relu_output});
+  auto& pad0 = graph.AddNode("pad0", "Pad", "Pad of an input that may be negative", {&x}, {&padded0});
+  auto& pad1 = graph.AddNode("pad1", "Pad", "Pad of the output of a Relu", {&relu_output}, {&padded1});
+  auto& pool0 = graph.AddNode("pool0", "MaxPool", "", {&padded0}, {&y0});
+  auto& pool1 = graph.AddNode("pool1", "MaxPool", "", {&padded1}, {&y1});
+  for (Node* node : {&pad0, &pad1}) {
+    node->AddAttribute("pads", std::vector<int64_t>{0, 0, 1, 1, 0, 0, 1, 1});
+  }
+  for (Node* node : {&pool0, &pool1}) {
+    node->AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+    node->AddAttribute("strides", std::vector<int64_t>{2, 2});
+  }
+
+  auto status = ApplyPadFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Pad"], 1);
+  ASSERT_EQ(op_to_count["MaxPool"], 2);
+  for (const Node& node : graph.Nodes()) {
+    if (node.Name() == "pool1") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "relu_output");
+      std::vector<int64_t> pads;
+      ASSERT_TRUE(graph_utils::GetRepeatedNodeAttributeValues(node, "pads", pads));
+      ASSERT_EQ(pads, std::vector<int64_t>({1, 1, 1, 1}));
+    } else if (node.Name() == "pool0") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "padded0");
+    }
+  }
+}
+
+static Status ApplyMatMulMulAndGemmAddFusion(Graph& graph) {
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  auto rule_transformer_L2 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer2");
+  rule_transformer_L2->Register(std::make_unique<MatMulMulFusion>());
+  rule_transformer_L2->Register(std::make_unique<GemmAddFusion>());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::move(rule_transformer_L2), TransformerLevel::Level2);
+  return graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+}
+
+static std::vector<float> GetInitializerValues(const Graph& graph, const std::string& name) {
+  const TensorProto* tensor_proto = nullptr;
+  EXPECT_TRUE(graph.GetInitializedTensor(name, tensor_proto));
+  Initializer values(tensor_proto);
+  return std::vector<float>(values.data<float>(), values.data<float>() + values.size());
+}
+
+// X0 -> MatMul(W) -> Div(S) -> Y0 and X1 -> MatMul(W) -> Y1, where the columns of W are divided by S for the first
+// MatMul only
+TEST(GraphTransformationTests, MatMulDivFusion) {
+  Model model("MatMulMulFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto x_type = TestTensorType(TensorProto_DataType_FLOAT, {4, 3});
+  auto y_type = TestTensorType(TensorProto_DataType_FLOAT, {4, 2});
+  auto& w = AddTestInitializer<float>(graph, "W", TensorProto_DataType_FLOAT, {3, 2}, {1, 2, 3, 4, 5, 6});
+  auto& s = AddTestInitializer<float>(graph, "S", TensorProto_DataType_FLOAT, {2}, {2, 4});
+  auto& x0 = graph.GetOrCreateNodeArg("X0", &x_type);
+  auto& x1 = graph.GetOrCreateNodeArg("X1", &x_type);
+  auto& matmul_output = graph.GetOrCreateNodeArg("matmul_output", &y_type);
+  auto& y0 = graph.GetOrCreateNodeArg("Y0", &y_type);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &y_type);
+
+  graph.AddNode("matmul0", "MatMul", "", {&x0, &w}, {&matmul_output});
+  graph.AddNode("div", "Div", "", {&matmul_output, &s}, {&y0});
+  graph.AddNode("matmul1", "MatMul", "", {&x1, &w}, {&y1});
+
+  auto status = ApplyMatMulMulAndGemmAddFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Div"], 0);
+  ASSERT_EQ(op_to_count["MatMul"], 2);
+  for (const Node& node : graph.Nodes()) {
+    if (node.Name() == "matmul0") {
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y0");
+      ASSERT_NE(node.InputDefs()[1]->Name(), "W");
+      ASSERT_EQ(GetInitializerValues(graph, node.InputDefs()[1]->Name()),
+                std::vector<float>({0.5f, 0.5f, 1.5f, 1.0f, 2.5f, 1.5f}));
+    } else {
+      ASSERT_EQ(node.InputDefs()[1]->Name(), "W");
+    }
+  }
+  ASSERT_EQ(GetInitializerValues(graph, "W"), std::vector<float>({1, 2, 3, 4, 5, 6}));
+}
+
+// X -> Gemm(B, C) -> Mul(S) -> Add(D) -> Y, where B is transposed, so that its rows are scaled by S, and the scaled
+// C is added the bias
+TEST(GraphTransformationTests, GemmMulAddFusion) {
+  Model model("GemmAddFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto x_type = TestTensorType(TensorProto_DataType_FLOAT, {2, 3});
+  auto y_type = TestTensorType(TensorProto_DataType_FLOAT, {2, 2});
+  auto& b = AddTestInitializer<float>(graph, "B", TensorProto_DataType_FLOAT, {2, 3}, {1, 2, 3, 4, 5, 6});
+  auto& c = AddTestInitializer<float>(graph, "C", TensorProto_DataType_FLOAT, {2}, {1, 2});
+  auto& s = AddTestInitializer<float>(graph, "S", TensorProto_DataType_FLOAT, {2}, {2, 3});
+  auto& d = AddTestInitializer<float>(graph, "D", TensorProto_DataType_FLOAT, {1, 2}, {10, 20});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& gemm_output = graph.GetOrCreateNodeArg("gemm_output", &y_type);
+  auto& mul_output = graph.GetOrCreateNodeArg("mul_output", &y_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &y_type);
+
+  auto& gemm = graph.AddNode("gemm", "Gemm", "", {&x, &b, &c}, {&gemm_output});
+  gemm.AddAttribute("transB", static_cast<int64_t>(1));
+  gemm.AddAttribute("beta", 0.5f);
+  graph.AddNode("mul", "Mul", "", {&s, &gemm_output}, {&mul_output});
+  graph.AddNode("add", "Add", "", {&mul_output, &d}, {&y});
+
+  auto status = ApplyMatMulMulAndGemmAddFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Mul"], 0);
+  ASSERT_EQ(op_to_count["Add"], 0);
+  ASSERT_EQ(op_to_count["Gemm"], 1);
+  for (const Node& node : graph.Nodes()) {
+    ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y");
+    ASSERT_EQ(graph_utils::GetNodeAttribute(node, "beta")->f(), 1.0f);
+    ASSERT_EQ(GetInitializerValues(graph, node.InputDefs()[1]->Name()),
+              std::vector<float>({2, 4, 6, 12, 15, 18}));
+    ASSERT_EQ(GetInitializerValues(graph, node.InputDefs()[2]->Name()), std::vector<float>({11, 23}));
+  }
+}
+
+// X -> MaxPool -> Y0 and X -> Split -> Y1, with a chain of nodes and the indices of the MaxPool that aren't used.
+// The Split keeps its unused output, which isn't optional.
+TEST(GraphTransformationTests, DeadNodeElimination) {
+  Model model("DeadNodeElimination", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto x_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 4, 4});
+  auto indices_type = TestTensorType(TensorProto_DataType_INT64, {1, 2, 2, 2});
+  auto pooled_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 2, 2});
+  auto split_type = TestTensorType(TensorProto_DataType_FLOAT, {1, 1, 4, 4});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& neg_output = graph.GetOrCreateNodeArg("neg_output", &x_type);
+  auto& abs_output = graph.GetOrCreateNodeArg("abs_output", &x_type);
+  auto& y0 = graph.GetOrCreateNodeArg("Y0", &pooled_type);
+  auto& indices = graph.GetOrCreateNodeArg("indices", &indices_type);
+  auto& y1 = graph.GetOrCreateNodeArg("Y1", &split_type);
+  auto& split_output = graph.GetOrCreateNodeArg("split_output", &split_type);
+
+  graph.AddNode("neg", "Neg", "", {&x}, {&neg_output});
+  graph.AddNode("abs", "Abs", "", {&neg_output}, {&abs_output});
+  auto& pool = graph.AddNode("pool", "MaxPool", "", {&x}, {&y0, &indices});
+  pool.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+  pool.AddAttribute("strides", std::vector<int64_t>{2, 2});
+  graph.AddNode("split", "Split", "", {&x}, {&y1, &split_output}).AddAttribute("axis", static_cast<int64_t>(1));
+  graph.SetOutputs({&y0, &y1});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<DeadNodeElimination>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["Neg"], 0);
+  ASSERT_EQ(op_to_count["Abs"], 0);
+  ASSERT_EQ(op_to_count["MaxPool"], 1);
+  ASSERT_EQ(op_to_count["Split"], 1);
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "MaxPool") {
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y0");
+      ASSERT_TRUE(node.OutputDefs().size() < 2 || !node.OutputDefs()[1]->Exists());
+    } else {
+      ASSERT_EQ(node.OutputDefs().size(), 2u);
+      ASSERT_EQ(node.OutputDefs()[1]->Name(), "split_output");
+    }
+  }
+}
+
+// X * If(true) -> Y, where the If is replaced with the nodes of its then branch, which add a constant of the branch
+// to one of the graph
+TEST(GraphTransformationTests, DeadNodeEliminationConstantIf) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto create_subgraph = [&](GraphProto& graph_proto, bool is_then_branch) {
+    Model model("DeadNodeEliminationConstantIf_subgraph");
+    auto& graph = model.MainGraph();
+
+    auto& parent_constant_arg = graph.GetOrCreateNodeArg("parent_constant", &float_tensor_type);
+    graph.AddOuterScopeNodeArg("parent_constant");
+    auto& subgraph_out = graph.GetOrCreateNodeArg("subgraph_out", &float_tensor_type);
+    if (is_then_branch) {
+      auto& local_constant_arg = AddTestInitializer<float>(graph, "local_constant", TensorProto_DataType_FLOAT, {1},
+                                                           {2.0f});
+      auto& add_out = graph.GetOrCreateNodeArg("add_out", &float_tensor_type);
+      graph.AddNode("add", "Add", "", {&parent_constant_arg, &local_constant_arg}, {&add_out});
+      graph.AddNode("identity", "Identity", "", {&add_out}, {&subgraph_out});
+    } else {
+      graph.AddNode("neg", "Neg", "", {&parent_constant_arg}, {&subgraph_out});
+    }
+
+    auto status = graph.Resolve();
+    ASSERT_TRUE(status.IsOK()) << status;
+    graph_proto = graph.ToGraphProto();
+  };
+
+  Model model("DeadNodeEliminationConstantIf_main_graph");
+  auto& graph = model.MainGraph();
+
+  AddTestInitializer<float>(graph, "parent_constant", TensorProto_DataType_FLOAT, {1}, {1.0f});
+  TensorProto if_cond;
+  if_cond.set_name("if_cond");
+  if_cond.set_data_type(TensorProto_DataType_BOOL);
+  if_cond.add_dims(1);
+  if_cond.add_int32_data(1);
+  graph.AddInitializedTensor(if_cond);
+
+  TypeProto if_cond_type;
+  if_cond_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  if_cond_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& if_cond_arg = graph.GetOrCreateNodeArg("if_cond", &if_cond_type);
+  auto& if_output = graph.GetOrCreateNodeArg("if_out", &float_tensor_type);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor_type);
+
+  auto& if_node = graph.AddNode("if", "If", "If node", {&if_cond_arg}, {&if_output});
+  GraphProto then_branch;
+  create_subgraph(then_branch, true);
+  GraphProto else_branch;
+  create_subgraph(else_branch, false);
+  if_node.AddAttribute("then_branch", {then_branch});
+  if_node.AddAttribute("else_branch", {else_branch});
+  graph.AddNode("mul", "Mul", "", {&x, &if_output}, {&y});
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(std::make_unique<DeadNodeElimination>(), TransformerLevel::Level1);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1);
+  ASSERT_TRUE(status.IsOK()) << status;
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["If"], 0);
+  ASSERT_EQ(op_to_count["Neg"], 0);
+  ASSERT_EQ(op_to_count["Add"], 1);
+  ASSERT_EQ(op_to_count["Identity"], 1);
+  for (const Node& node : graph.Nodes()) {
+    if (node.OpType() == "Add") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "parent_constant");
+      ASSERT_TRUE(graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[1]));
+    } else if (node.OpType() == "Identity") {
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "if_out");
+      ASSERT_EQ(node.GetInputEdgesCount(), 1u);
+    }
+  }
+}
+
+static Status ApplyQDQFusion(Graph& graph) {
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      std::make_unique<QDQFusion>(std::unordered_set<std::string>{kCpuExecutionProvider}), TransformerLevel::Level2);
+  return graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+}
+
+// X -> Q -> DQ -> Reshape -> MatMul(DQ(W)) -> Q -> DQ -> Y
+TEST(GraphTransformationTests, QDQFusionMatMulThroughReshape) {
+  Model model("QDQFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto float_3d = TestTensorType(TensorProto_DataType_FLOAT, {1, 2, 2});
+  auto uint8_3d = TestTensorType(TensorProto_DataType_UINT8, {1, 2, 2});
+  auto float_2d = TestTensorType(TensorProto_DataType_FLOAT, {2, 2});
+  auto uint8_2d = TestTensorType(TensorProto_DataType_UINT8, {2, 2});
+
+  auto& scale = AddTestInitializer<float>(graph, "scale", TensorProto_DataType_FLOAT, {}, {0.1f});
+  auto& zero_point = AddTestInitializer<uint8_t>(graph, "zero_point", TensorProto_DataType_UINT8, {}, {128});
+  auto& shape = AddTestInitializer<int64_t>(graph, "shape", TensorProto_DataType_INT64, {2}, {2, 2});
+  auto& w_q = AddTestInitializer<uint8_t>(graph, "W_q", TensorProto_DataType_UINT8, {2, 2}, {1, 2, 3, 4});
+  auto& w_scale = AddTestInitializer<float>(graph, "W_scale", TensorProto_DataType_FLOAT, {}, {0.5f});
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_3d);
+  auto& x_q = graph.GetOrCreateNodeArg("X_q", &uint8_3d);
+  auto& x_dq = graph.GetOrCreateNodeArg("X_dq", &float_3d);
+  auto& reshaped = graph.GetOrCreateNodeArg("reshaped", &float_2d);
+  auto& w = graph.GetOrCreateNodeArg("W", &float_2d);
+  auto& y_float = graph.GetOrCreateNodeArg("Y_float", &float_2d);
+  auto& y_q = graph.GetOrCreateNodeArg("Y_q", &uint8_2d);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_2d);
+
+  graph.AddNode("quantize_x", "QuantizeLinear", "", {&x, &scale, &zero_point}, {&x_q});
+  graph.AddNode("dequantize_x", "DequantizeLinear", "", {&x_q, &scale, &zero_point}, {&x_dq});
+  graph.AddNode("reshape", "Reshape", "", {&x_dq, &shape}, {&reshaped});
+  graph.AddNode("dequantize_w", "DequantizeLinear", "", {&w_q, &w_scale}, {&w});
+  graph.AddNode("matmul", "MatMul", "", {&reshaped, &w}, {&y_float});
+  graph.AddNode("quantize_y", "QuantizeLinear", "", {&y_float, &scale, &zero_point}, {&y_q});
+  graph.AddNode("dequantize_y", "DequantizeLinear", "", {&y_q, &scale, &zero_point}, {&y});
+
+  auto status = ApplyQDQFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  // the Reshape moves the uint8 X, and only the output is dequantized
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["QuantizeLinear"], 1);
+  ASSERT_EQ(op_to_count["DequantizeLinear"], 1);
+  ASSERT_EQ(op_to_count["MatMul"], 0);
+  ASSERT_EQ(op_to_count["QLinearMatMul"], 1);
+  ASSERT_EQ(op_to_count["Reshape"], 1);
+
+  for (const Node& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+    if (node.OpType() == "Reshape") {
+      ASSERT_EQ(node.InputDefs()[0]->Name(), "X_q");
+    } else if (node.OpType() == "QLinearMatMul") {
+      ASSERT_EQ(node.InputDefs()[3]->Name(), "W_q");
+      ASSERT_EQ(node.OutputDefs()[0]->Name(), "Y_q");
+    }
+  }
+}
+
+// X -> Q -> DQ -> Relu -> Y, where the Q -> DQ pair between float nodes is removed
+TEST(GraphTransformationTests, QDQFusionRemovesQuantizeDequantizePair) {
+  Model model("QDQFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 10}}, {});
+  auto& graph = model.MainGraph();
+
+  auto float_type = TestTensorType(TensorProto_DataType_FLOAT, {4});
+  auto uint8_type = TestTensorType(TensorProto_DataType_UINT8, {4});
+
+  auto& scale = AddTestInitializer<float>(graph, "scale", TensorProto_DataType_FLOAT, {}, {0.1f});
+  auto& zero_point = AddTestInitializer<uint8_t>(graph, "zero_point", TensorProto_DataType_UINT8, {}, {128});
+  auto& x = graph.GetOrCreateNodeArg("X", &float_type);
+  auto& x_q = graph.GetOrCreateNodeArg("X_q", &uint8_type);
+  auto& x_dq = graph.GetOrCreateNodeArg("X_dq", &float_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_type);
+
+  graph.AddNode("quantize_x", "QuantizeLinear", "", {&x, &scale, &zero_point}, {&x_q});
+  graph.AddNode("dequantize_x", "DequantizeLinear", "", {&x_q, &scale, &zero_point}, {&x_dq});
+  graph.AddNode("relu", "Relu", "", {&x_dq}, {&y});
+
+  auto status = ApplyQDQFusion(graph);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["QuantizeLinear"], 0);
+  ASSERT_EQ(op_to_count["DequantizeLinear"], 0);
+  ASSERT_EQ(op_to_count["Relu"], 1);
+  for (const Node& node : graph.Nodes()) {
+    ASSERT_EQ(node.InputDefs()[0]->Name(), "X");
+  }
+}
+
+
+#ifndef DISABLE_CONTRIB_OPS
+// DynamicQuantizeLinear(A) -> MatMulInteger(B) -> Cast -> Mul(Mul(A scale, B scale)) -> Add(bias) -> Y
+TEST(GraphTransformationTests, DynamicQuantizeMatMulFusion) {
+  Model model("DynamicQuantizeMatMulFusion", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{"", 11}, {kMSDomain, 1}}, {});
+  auto& graph = model.MainGraph();
+
+  auto float_a = TestTensorType(TensorProto_DataType_FLOAT, {2, 3});
+  auto uint8_a = TestTensorType(TensorProto_DataType_UINT8, {2, 3});
+  auto float_scalar = TestTensorType(TensorProto_DataType_FLOAT, {});
+  auto uint8_scalar = TestTensorType(TensorProto_DataType_UINT8, {});
+  auto int32_y = TestTensorType(TensorProto_DataType_INT32, {2, 2});
+  auto float_y = TestTensorType(TensorProto_DataType_FLOAT, {2, 2});
+
+  auto& b = AddTestInitializer<uint8_t>(graph, "B", TensorProto_DataType_UINT8, {3, 2}, {1, 2, 3, 4, 5, 6});
+  auto& b_scale = AddTestInitializer<float>(graph, "B_scale", TensorProto_DataType_FLOAT, {}, {0.5f});
+  auto& b_zero_point = AddTestInitializer<uint8_t>(graph, "B_zero_point", TensorProto_DataType_UINT8, {}, {3});
+  auto& bias = AddTestInitializer<float>(graph, "bias", TensorProto_DataType_FLOAT, {2}, {1.f, -1.f});
+
+  auto& a = graph.GetOrCreateNodeArg("A", &float_a);
+  auto& a_q = graph.GetOrCreateNodeArg("A_q", &uint8_a);
+  auto& a_scale = graph.GetOrCreateNodeArg("A_scale", &float_scalar);
+  auto& a_zero_point = graph.GetOrCreateNodeArg("A_zero_point", &uint8_scalar);
+  auto& y_int = graph.GetOrCreateNodeArg("Y_int", &int32_y);
+  auto& y_cast = graph.GetOrCreateNodeArg("Y_cast", &float_y);
+  auto& scale = graph.GetOrCreateNodeArg("scale", &float_scalar);
+  auto& y_scaled = graph.GetOrCreateNodeArg("Y_scaled", &float_y);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_y);
+
+  graph.AddNode("quantize", "DynamicQuantizeLinear", "", {&a}, {&a_q, &a_scale, &a_zero_point});
+  graph.AddNode("matmul", "MatMulInteger", "", {&a_q, &b, &a_zero_point, &b_zero_point}, {&y_int});
+  graph.AddNode("cast", "Cast", "", {&y_int}, {&y_cast})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("scale", "Mul", "", {&a_scale, &b_scale}, {&scale});
+  graph.AddNode("mul", "Mul", "", {&y_cast, &scale}, {&y_scaled});
+  graph.AddNode("add", "Add", "", {&y_scaled, &bias}, {&y});
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(
+      std::make_unique<DynamicQuantizeMatMulFusion>(std::unordered_set<std::string>{kCpuExecutionProvider}),
+      TransformerLevel::Level2);
+  status = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(graph.NumberOfNodes(), 1);
+  ASSERT_EQ(op_to_count["DynamicQuantizeMatMul"], 1);
+
+  const Node& fused_node = *graph.Nodes().begin();
+  ASSERT_EQ(fused_node.InputDefs().size(), 5u);
+  ASSERT_EQ(fused_node.InputDefs()[0]->Name(), "A");
+  ASSERT_EQ(fused_node.InputDefs()[2]->Name(), "B_scale");
+  ASSERT_EQ(fused_node.InputDefs()[3]->Name(), "B_zero_point");
+  ASSERT_EQ(fused_node.InputDefs()[4]->Name(), "bias");
+  ASSERT_EQ(fused_node.OutputDefs()[0]->Name(), "Y");
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
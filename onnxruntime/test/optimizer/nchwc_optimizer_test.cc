@@ -79,27 +79,33 @@ struct NchwcTestHelper {
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
-  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape, const std::vector<float>& data) {
     std::string name = graph_.GenerateNodeArgName("constant");
     ONNX_NAMESPACE::TensorProto tensor_proto;
     tensor_proto.set_name(name);
     tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
 
-    int64_t num_elements = 1;
     for (auto& dim : shape) {
       tensor_proto.add_dims(dim);
-      num_elements *= dim;
     }
 
-    auto random_data = FillRandomData(static_cast<size_t>(num_elements));
-    tensor_proto.mutable_float_data()->Resize(static_cast<int>(num_elements), 0.0f);
-    memcpy(tensor_proto.mutable_float_data()->mutable_data(), random_data.data(), random_data.size() * sizeof(float));
+    tensor_proto.mutable_float_data()->Resize(static_cast<int>(data.size()), 0.0f);
+    memcpy(tensor_proto.mutable_float_data()->mutable_data(), data.data(), data.size() * sizeof(float));
 
     graph_.AddInitializedTensor(tensor_proto);
 
     return &graph_.GetOrCreateNodeArg(name, nullptr);
   }
 
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      num_elements *= dim;
+    }
+
+    return MakeInitializer(shape, FillRandomData(static_cast<size_t>(num_elements)));
+  }
+
   Node& AddNode(const std::string& op_type,
                 const std::vector<NodeArg*>& input_args,
                 const std::vector<NodeArg*>& output_args) {
@@ -814,6 +820,143 @@ TEST(NchwcOptimizerTests, ShapeInferencing2) {
   NchwcOptimizerTester(build_test_case, check_nchwc_graph);
 }
 
+TEST(NchwcOptimizerTests, ConvMul) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+    helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+    helper.AddNode("Mul", {conv1_output_arg, conv2_output_arg}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 1);
+  };
+
+  // Verify that an elementwise Mul of same shaped tensors stays in NCHWc format.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
+TEST(NchwcOptimizerTests, SqueezeExcitation) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 64, 14, 14});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* pool_output_arg = helper.MakeIntermediate();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* relu_output_arg = helper.MakeIntermediate();
+    auto* conv3_output_arg = helper.MakeIntermediate();
+    auto* sigmoid_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv1_output_arg, {64, 64, 3, 3});
+    helper.AddNode("GlobalAveragePool", {conv1_output_arg}, {pool_output_arg});
+    helper.AddConvNode(pool_output_arg, conv2_output_arg, {16, 64, 1, 1});
+    helper.AddNode("Relu", {conv2_output_arg}, {relu_output_arg});
+    helper.AddConvNode(relu_output_arg, conv3_output_arg, {64, 16, 1, 1});
+    helper.AddNode("Sigmoid", {conv3_output_arg}, {sigmoid_output_arg});
+    helper.AddNode("Mul", {conv1_output_arg, sigmoid_output_arg}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 3);
+    EXPECT_EQ(op_to_count["nchwc.GlobalAveragePool"], 1);
+    EXPECT_EQ(op_to_count["nchwc.Mul"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+  };
+
+  // Verify that the channel scale of a squeeze-and-excitation block is done
+  // in NCHWc format with the activations fused into the convolutions.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
+TEST(NchwcOptimizerTests, ConvBatchNormalization) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 32, 28, 28});
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto* pool_output_arg = helper.MakeIntermediate();
+    auto* bn_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv_output_arg, {48, 32, 3, 3});
+
+    // Separate the convolution from the BatchNormalization so that the
+    // normalization isn't folded into the convolution by the level 2
+    // transformers.
+    auto& pool_node = helper.AddNode("MaxPool", {conv_output_arg}, {pool_output_arg});
+    pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+
+    auto* scale_arg = helper.MakeInitializer({48});
+    auto* bias_arg = helper.MakeInitializer({48});
+    auto* mean_arg = helper.MakeInitializer({48});
+    auto* var_arg = helper.MakeInitializer({48}, std::vector<float>(48, 4.0f));
+    auto& bn_node = helper.AddNode("BatchNormalization",
+                                   {pool_output_arg, scale_arg, bias_arg, mean_arg, var_arg},
+                                   {bn_output_arg});
+    bn_node.AddAttribute("epsilon", 1e-3f);
+
+    helper.AddNode("Relu", {bn_output_arg}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["nchwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["nchwc.MaxPool"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["BatchNormalization"], 0);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
+TEST(NchwcOptimizerTests, ConvUpsample) {
+  auto test_case = [&](const std::string& op_type, int opset_version, const std::vector<float>& scales) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({1, 16, 12, 20});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {32, 16, 3, 3});
+
+      if (opset_version == 7) {
+        auto& upsample_node = helper.AddNode(op_type, {conv_output_arg}, {output_arg});
+        upsample_node.AddAttribute("scales", scales);
+      } else {
+        auto* scales_arg = helper.MakeInitializer({4}, scales);
+        helper.AddNode(op_type, {conv_output_arg, scales_arg}, {output_arg});
+      }
+    };
+
+    auto check_nchwc_graph = [&](NchwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["nchwc.Conv"], 1);
+      EXPECT_EQ(op_to_count["nchwc.Upsample"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count[op_type], 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, opset_version);
+  };
+
+  test_case("Upsample", 7, {1.0f, 1.0f, 2.0f, 2.0f});
+  test_case("Upsample", 9, {1.0f, 1.0f, 3.0f, 1.0f});
+  test_case("Resize", 10, {1.0f, 1.0f, 2.0f, 4.0f});
+}
+
 TEST(NchwcOptimizerTests, MixedOutputUsage) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto* input_arg = helper.MakeInput({6, 5, 11, 11});
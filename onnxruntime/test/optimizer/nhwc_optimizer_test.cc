@@ -0,0 +1,302 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/inference_session.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
+#include "test/framework/test_utils.h"
+#include "test/compare_ortvalue.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+// InferenceSession wrapper in order to gain access to the loaded graph.
+class NhwcInferenceSession : public InferenceSession {
+ public:
+  explicit NhwcInferenceSession(const SessionOptions& session_options,
+                                logging::LoggingManager* logging_manager) : InferenceSession(session_options, logging_manager) {
+  }
+
+  std::unordered_map<std::string, int> CountOpsInGraph() {
+    std::unordered_map<std::string, int> op_to_count;
+    if (model_.get() != nullptr) {
+      for (auto& node : model_->MainGraph().Nodes()) {
+        std::string key = node.OpType();
+        if (node.Domain() == kMSNhwcDomain) {
+          key = "nhwc." + key;
+        }
+        op_to_count[key] = op_to_count[key] + 1;
+      }
+    }
+    return op_to_count;
+  }
+};
+
+struct NhwcTestHelper {
+  NhwcTestHelper(Graph& graph) : graph_(graph), fill_value_(0) {
+  }
+
+  NodeArg* MakeInput(const std::vector<int64_t>& shape) {
+    ONNX_NAMESPACE::TypeProto type_proto;
+    type_proto.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      type_proto.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+      num_elements *= dim;
+    }
+
+    OrtValue input_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), shape,
+                         FillData(static_cast<size_t>(num_elements)), &input_value);
+    std::string name = graph_.GenerateNodeArgName("input");
+    feeds_.insert(std::make_pair(name, input_value));
+
+    return &graph_.GetOrCreateNodeArg(name, &type_proto);
+  }
+
+  NodeArg* MakeOutput() {
+    std::string name = graph_.GenerateNodeArgName("output");
+    output_names_.push_back(name);
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeIntermediate() {
+    std::string name = graph_.GenerateNodeArgName("node");
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  NodeArg* MakeInitializer(const std::vector<int64_t>& shape) {
+    std::string name = graph_.GenerateNodeArgName("constant");
+    ONNX_NAMESPACE::TensorProto tensor_proto;
+    tensor_proto.set_name(name);
+    tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+    int64_t num_elements = 1;
+    for (auto& dim : shape) {
+      tensor_proto.add_dims(dim);
+      num_elements *= dim;
+    }
+
+    for (auto value : FillData(static_cast<size_t>(num_elements))) {
+      tensor_proto.add_float_data(value);
+    }
+    graph_.AddInitializedTensor(tensor_proto);
+
+    return &graph_.GetOrCreateNodeArg(name, nullptr);
+  }
+
+  Node& AddNode(const std::string& op_type,
+                const std::vector<NodeArg*>& input_args,
+                const std::vector<NodeArg*>& output_args) {
+    return graph_.AddNode(graph_.GenerateNodeName("node"),
+                          op_type,
+                          "description",
+                          input_args,
+                          output_args);
+  }
+
+  // Adds the Transpose from NHWC to NCHW of input_arg, and returns its output.
+  NodeArg* AddTransposeToNchw(NodeArg* input_arg) {
+    auto* output_arg = MakeIntermediate();
+    AddNode("Transpose", {input_arg}, {output_arg}).AddAttribute("perm", std::vector<int64_t>{0, 3, 1, 2});
+    return output_arg;
+  }
+
+  void AddTransposeToNhwc(NodeArg* input_arg, NodeArg* output_arg) {
+    AddNode("Transpose", {input_arg}, {output_arg}).AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  }
+
+  Node& AddConvNode(NodeArg* input_arg, NodeArg* output_arg, const std::vector<int64_t>& weights_shape) {
+    auto* weights_arg = MakeInitializer(weights_shape);
+    auto* biases_arg = MakeInitializer({weights_shape[0]});
+    return AddNode("Conv", {input_arg, weights_arg, biases_arg}, {output_arg});
+  }
+
+  // Small integers keep the sums of products exact, so both layouts compute the same values.
+  std::vector<float> FillData(size_t count) {
+    constexpr int min_fill_value = -5;
+    constexpr int max_fill_value = 5;
+
+    std::vector<float> data(count);
+    for (size_t n = 0; n < count; n++) {
+      data[n] = static_cast<float>(fill_value_);
+      fill_value_++;
+      if (fill_value_ == max_fill_value) {
+        fill_value_ = min_fill_value;
+      }
+    }
+    return data;
+  }
+
+  Graph& graph_;
+  NameMLValMap feeds_;
+  std::vector<std::string> output_names_;
+  int fill_value_;
+};
+
+// Checks that the Level3 graph computes the same outputs as the Level2 one, which keeps the Transposes.
+void NhwcOptimizerTester(const std::function<void(NhwcTestHelper& helper)>& build_test_case,
+                         const std::function<void(NhwcInferenceSession& session)>& check_nhwc_graph) {
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[kOnnxDomain] = 10;
+  Model model("nhwc", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  NhwcTestHelper helper(model.MainGraph());
+  build_test_case(helper);
+  ASSERT_TRUE(model.MainGraph().Resolve().IsOK());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  auto run_model = [&](TransformerLevel level, std::vector<OrtValue>& fetches) {
+    SessionOptions session_options;
+    session_options.graph_optimization_level = level;
+    session_options.session_logid = "NhwcOptimizerTests";
+    NhwcInferenceSession session{session_options, &DefaultLoggingManager()};
+    ASSERT_TRUE(session.Load(model_data.data(), static_cast<int>(model_data.size())).IsOK());
+    auto status = session.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    status = session.Run(RunOptions(), helper.feeds_, helper.output_names_, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    if (level == TransformerLevel::Level3) {
+      check_nhwc_graph(session);
+    }
+  };
+
+  std::vector<OrtValue> level2_fetches;
+  run_model(TransformerLevel::Level2, level2_fetches);
+
+  std::vector<OrtValue> level3_fetches;
+  run_model(TransformerLevel::Level3, level3_fetches);
+
+  ASSERT_EQ(level2_fetches.size(), level3_fetches.size());
+  for (size_t i = 0; i < level2_fetches.size(); i++) {
+    std::pair<COMPARE_RESULT, std::string> ret =
+        CompareOrtValue(level3_fetches[i], level2_fetches[i], 1e-5, 1e-5, false);
+    EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS) << ret.second;
+  }
+}
+
+#ifndef DISABLE_CONTRIB_OPS
+
+TEST(NhwcOptimizerTests, ConvReluMaxPoolConv) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({2, 9, 9, 8});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* nchw_arg = helper.AddTransposeToNchw(input_arg);
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto& conv1_node = helper.AddConvNode(nchw_arg, conv1_output_arg, {16, 8, 3, 3});
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    auto* relu_output_arg = helper.MakeIntermediate();
+    helper.AddNode("Relu", {conv1_output_arg}, {relu_output_arg});
+    auto* pool_output_arg = helper.MakeIntermediate();
+    auto& pool_node = helper.AddNode("MaxPool", {relu_output_arg}, {pool_output_arg});
+    pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{2, 2});
+    pool_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+    pool_node.AddAttribute("ceil_mode", static_cast<int64_t>(1));
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    helper.AddConvNode(pool_output_arg, conv2_output_arg, {12, 16, 1, 1});
+    helper.AddTransposeToNhwc(conv2_output_arg, output_arg);
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 2);
+    EXPECT_EQ(op_to_count["nhwc.MaxPool"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, ConvNonConstantWeights) {
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 7, 6, 4});
+    auto* weights_arg = helper.MakeInput({5, 4, 3, 2});
+    auto* output_arg = helper.MakeOutput();
+
+    auto* nchw_arg = helper.AddTransposeToNchw(input_arg);
+    auto* conv_output_arg = helper.MakeIntermediate();
+    auto& conv_node = helper.AddNode("Conv", {nchw_arg, weights_arg}, {conv_output_arg});
+    conv_node.AddAttribute("strides", std::vector<int64_t>{2, 1});
+    conv_node.AddAttribute("dilations", std::vector<int64_t>{1, 2});
+    helper.AddTransposeToNhwc(conv_output_arg, output_arg);
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 0);
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 1);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+TEST(NhwcOptimizerTests, AveragePoolGlobalPool) {
+  auto test_case = [&](int64_t count_include_pad, const std::string& global_pool_op_type) {
+    auto build_test_case = [&](NhwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput({3, 10, 11, 6});
+      auto* output_arg = helper.MakeOutput();
+
+      auto* nchw_arg = helper.AddTransposeToNchw(input_arg);
+      auto* pool_output_arg = helper.MakeIntermediate();
+      auto& pool_node = helper.AddNode("AveragePool", {nchw_arg}, {pool_output_arg});
+      pool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+      pool_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      pool_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+      pool_node.AddAttribute("count_include_pad", count_include_pad);
+      auto* global_pool_output_arg = helper.MakeIntermediate();
+      helper.AddNode(global_pool_op_type, {pool_output_arg}, {global_pool_output_arg});
+      helper.AddTransposeToNhwc(global_pool_output_arg, output_arg);
+    };
+
+    auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+      auto op_to_count = session.CountOpsInGraph();
+      EXPECT_EQ(op_to_count["Transpose"], 0);
+      EXPECT_EQ(op_to_count["nhwc.AveragePool"], 1);
+      EXPECT_EQ(op_to_count["nhwc." + global_pool_op_type], 1);
+    };
+
+    NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+  };
+
+  test_case(0, "GlobalMaxPool");
+  test_case(1, "GlobalAveragePool");
+}
+
+TEST(NhwcOptimizerTests, UnsupportedChains) {
+  // a grouped convolution, and a Relu output that is also a graph output, keep the layout of their chains
+  auto build_test_case = [&](NhwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput({1, 5, 5, 8});
+
+    auto* grouped_output_arg = helper.MakeOutput();
+    auto* grouped_nchw_arg = helper.AddTransposeToNchw(input_arg);
+    auto* grouped_conv_output_arg = helper.MakeIntermediate();
+    auto& grouped_conv_node = helper.AddConvNode(grouped_nchw_arg, grouped_conv_output_arg, {8, 4, 3, 3});
+    grouped_conv_node.AddAttribute("group", static_cast<int64_t>(2));
+    helper.AddTransposeToNhwc(grouped_conv_output_arg, grouped_output_arg);
+
+    auto* relu_output_arg = helper.MakeOutput();
+    auto* transposed_output_arg = helper.MakeOutput();
+    auto* relu_nchw_arg = helper.AddTransposeToNchw(input_arg);
+    helper.AddNode("Relu", {relu_nchw_arg}, {relu_output_arg});
+    helper.AddTransposeToNhwc(relu_output_arg, transposed_output_arg);
+  };
+
+  auto check_nhwc_graph = [&](NhwcInferenceSession& session) {
+    auto op_to_count = session.CountOpsInGraph();
+    EXPECT_EQ(op_to_count["Transpose"], 4);
+    EXPECT_EQ(op_to_count["nhwc.Conv"], 0);
+  };
+
+  NhwcOptimizerTester(build_test_case, check_nhwc_graph);
+}
+
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
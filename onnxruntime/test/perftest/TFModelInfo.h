@@ -12,6 +12,7 @@ class TFModelInfo : public TestModelInfo {
   const PATH_CHAR_TYPE* GetModelUrl() const override { return model_url_.c_str(); }
 
   const std::string& GetNodeName() const override { return node_name_; }
+  const ONNX_NAMESPACE::ValueInfoProto* GetInputInfoFromModel(size_t) const override { return nullptr; }
   const ONNX_NAMESPACE::ValueInfoProto* GetOutputInfoFromModel(size_t) const override { return nullptr; }
 
   int GetInputCount() const override;
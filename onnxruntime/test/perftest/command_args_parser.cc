@@ -23,6 +23,45 @@
 namespace onnxruntime {
 namespace perftest {
 
+// Parses 'dim_name=values' where values is a comma-separated list of values or 'min:max[:step]' ranges.
+static bool ParseFreeDimValues(const ORTCHAR_T* str, std::pair<std::string, std::vector<int64_t>>& free_dim_values) {
+  std::basic_string<ORTCHAR_T> arg{str};
+  auto pos = arg.find(ORT_TSTR('='));
+  if (pos == 0 || pos == std::basic_string<ORTCHAR_T>::npos) return false;
+  free_dim_values.first = ToMBString(arg.substr(0, pos));
+  free_dim_values.second.clear();
+
+  auto parse_value = [](const ORTCHAR_T*& p, int64_t& value) {
+    PATH_CHAR_TYPE* end = nullptr;
+    value = static_cast<int64_t>(OrtStrToPtrDiff<PATH_CHAR_TYPE>(p, &end));
+    if (end == p || value <= 0) return false;
+    p = end;
+    return true;
+  };
+
+  const ORTCHAR_T* p = arg.c_str() + pos + 1;
+  while (*p != 0) {
+    int64_t first, last, step = 1;
+    if (!parse_value(p, first)) return false;
+    last = first;
+    if (*p == ORT_TSTR(':')) {
+      ++p;
+      if (!parse_value(p, last) || last < first) return false;
+      if (*p == ORT_TSTR(':') && !parse_value(++p, step)) return false;
+    }
+    for (int64_t value = first; value <= last; value += step) {
+      free_dim_values.second.push_back(value);
+    }
+
+    if (*p == ORT_TSTR(',')) {
+      ++p;
+    } else if (*p != 0) {
+      return false;
+    }
+  }
+  return !free_dim_values.second.empty();
+}
+
 /*static*/ void CommandLineParser::ShowUsage() {
   printf(
       "perf_test [options...] model_path result_file\n"
@@ -39,6 +78,15 @@ namespace perftest {
       "\t-r [repeated_times]: Specifies the repeated times if running in 'times' test mode.Default:1000.\n"
       "\t-t [seconds_to_run]: Specifies the seconds to run for 'duration' mode. Default:600.\n"
       "\t-p [profile_file]: Specifies the profile name to enable profiling and dump the profile data to the file.\n"
+      "\t-w [warmup_times]: Specifies the number of warm-up runs excluded from the results. Default:1.\n"
+      "\t-q [qps[,qps...]]: Issues the requests open-loop at the target QPS, with Poisson arrivals, instead of running\n"
+      "\t\t-c runs back to back. The latency includes the time a request waits for one of the -c workers.\n"
+      "\t\tA comma-separated list runs one test per QPS, for the duration (-t) or the repeated times (-r) each.\n"
+      "\t-d [dim_name=values]: Generates random inputs instead of loading the test data, with the free dim of the\n"
+      "\t\tsymbolic name set to each of the values in turn. values is a comma-separated list of values or\n"
+      "\t\t'min:max[:step]' ranges, e.g. -d batch=1,8 -d seq=32:256:32. Repeat -d for each free dim of the inputs,\n"
+      "\t\tevery combination of the values is tested.\n"
+      "\t-j [summary_file]: Writes a JSON summary of the results, like throughput and latency percentiles, to the file.\n"
       "\t-s: Show statistics result, like P75, P90.\n"
       "\t-v: Show verbose information.\n"
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
@@ -51,7 +99,7 @@ namespace perftest {
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:AMPvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:w:j:q:d:AMPvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -111,6 +159,42 @@ namespace perftest {
         }
         test_config.run_config.test_mode = TestMode::kFixDurationMode;
         break;
+      case 'w':
+        test_config.run_config.warmup_times = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        break;
+      case 'q': {
+        test_config.run_config.target_qps.clear();
+        PATH_CHAR_TYPE* p = optarg;
+        while (*p != 0) {
+          PATH_CHAR_TYPE* end = nullptr;
+          long qps = OrtStrtol<PATH_CHAR_TYPE>(p, &end);
+          if (end == p || qps <= 0) {
+            return false;
+          }
+          test_config.run_config.target_qps.push_back(static_cast<size_t>(qps));
+          p = end;
+          if (*p == ',') {
+            ++p;
+          } else if (*p != 0) {
+            return false;
+          }
+        }
+        if (test_config.run_config.target_qps.empty()) {
+          return false;
+        }
+        break;
+      }
+      case 'd': {
+        std::pair<std::string, std::vector<int64_t>> free_dim_values;
+        if (!ParseFreeDimValues(optarg, free_dim_values)) {
+          return false;
+        }
+        test_config.run_config.free_dim_values.push_back(std::move(free_dim_values));
+        break;
+      }
+      case 'j':
+        test_config.run_config.summary_file = optarg;
+        break;
       case 's':
         test_config.run_config.f_dump_statistics = true;
         break;
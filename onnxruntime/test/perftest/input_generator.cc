@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "input_generator.h"
+
+#include <core/session/onnxruntime_cxx_api.h>
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+common::Status GetInputSpec(const ONNX_NAMESPACE::ValueInfoProto& value_info, InputSpec& spec) {
+  const auto& type = value_info.type();
+  if (type.value_case() != ONNX_NAMESPACE::TypeProto::kTensorType || !type.tensor_type().has_shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "input ", value_info.name(),
+                           " isn't a tensor of known rank, its data can't be generated");
+  }
+
+  spec.name = value_info.name();
+  spec.element_type = static_cast<ONNXTensorElementDataType>(type.tensor_type().elem_type());
+  spec.dims.clear();
+  spec.dim_params.clear();
+  for (const auto& dim : type.tensor_type().shape().dim()) {
+    const bool is_fixed = dim.value_case() == ONNX_NAMESPACE::TensorShapeProto_Dimension::kDimValue &&
+                          dim.dim_value() >= 0;
+    spec.dims.push_back(is_fixed ? dim.dim_value() : -1);
+    spec.dim_params.push_back(
+        dim.value_case() == ONNX_NAMESPACE::TensorShapeProto_Dimension::kDimParam ? dim.dim_param() : "");
+  }
+  return Status::OK();
+}
+
+common::Status ResolveInputShape(const InputSpec& spec, const std::unordered_map<std::string, int64_t>& dim_values,
+                                 std::vector<int64_t>& shape) {
+  shape = spec.dims;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] >= 0) continue;
+
+    auto value = dim_values.find(spec.dim_params[i]);
+    if (spec.dim_params[i].empty() || value == dim_values.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "no value is given for the free dim ", i, " (",
+                             spec.dim_params[i].empty() ? "unnamed" : spec.dim_params[i], ") of input ", spec.name);
+    }
+    shape[i] = value->second;
+  }
+  return Status::OK();
+}
+
+template <typename T, typename Distribution>
+static void FillRandom(Ort::Value& tensor, size_t count, Distribution distribution, std::mt19937& rand_engine) {
+  T* data = tensor.GetTensorMutableData<T>();
+  for (size_t i = 0; i < count; ++i) {
+    data[i] = static_cast<T>(distribution(rand_engine));
+  }
+}
+
+common::Status CreateRandomInput(const InputSpec& spec, const std::vector<int64_t>& shape, std::mt19937& rand_engine,
+                                 OrtValue** value) {
+  size_t count = 1;
+  for (int64_t dim : shape) {
+    count *= static_cast<size_t>(dim);
+  }
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), spec.element_type);
+  std::uniform_real_distribution<double> real(0, 1);
+  std::uniform_int_distribution<int> binary(0, 1);
+  switch (spec.element_type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      FillRandom<float>(tensor, count, real, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      FillRandom<double>(tensor, count, real, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+      FillRandom<int8_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      FillRandom<uint8_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+      FillRandom<int16_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+      FillRandom<uint16_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      FillRandom<int32_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      FillRandom<uint32_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      FillRandom<int64_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      FillRandom<uint64_t>(tensor, count, binary, rand_engine);
+      break;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+      FillRandom<bool>(tensor, count, binary, rand_engine);
+      break;
+    default:
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "generating data of type ", spec.element_type,
+                             " for input ", spec.name, " is not supported");
+  }
+
+  *value = tensor.release();
+  return Status::OK();
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <core/common/status.h>
+#include <core/session/onnxruntime_c_api.h>
+
+namespace ONNX_NAMESPACE {
+class ValueInfoProto;
+}
+
+namespace onnxruntime {
+namespace perftest {
+
+// The type and shape of a graph input, to generate inputs of any value of its free dims.
+struct InputSpec {
+  std::string name;
+  ONNXTensorElementDataType element_type{ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED};
+  // -1 for the free dims
+  std::vector<int64_t> dims;
+  // the symbolic names of the dims, empty for the fixed ones and the free ones without a name
+  std::vector<std::string> dim_params;
+};
+
+common::Status GetInputSpec(const ONNX_NAMESPACE::ValueInfoProto& value_info, InputSpec& spec);
+
+// Sets each free dim of spec to the value of its symbolic name in dim_values.
+common::Status ResolveInputShape(const InputSpec& spec, const std::unordered_map<std::string, int64_t>& dim_values,
+                                 std::vector<int64_t>& shape);
+
+// Creates a CPU tensor of the shape filled with random data. Floating point values are uniform in [0, 1).
+// Integers and bools are 0 or 1, so that the inputs are valid as indices and masks whatever the model.
+common::Status CreateRandomInput(const InputSpec& spec, const std::vector<int64_t>& shape, std::mt19937& rand_engine,
+                                 OrtValue** value);
+
+}  // namespace perftest
+}  // namespace onnxruntime
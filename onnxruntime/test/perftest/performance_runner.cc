@@ -7,10 +7,15 @@
 #endif
 
 #include "performance_runner.h"
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
+#include "input_generator.h"
 #include "utils.h"
 #include "ort_test_session.h"
 #ifdef HAVE_TENSORFLOW
@@ -29,40 +34,227 @@ using onnxruntime::Status;
 #pragma GCC diagnostic pop
 #endif
 using DefaultThreadPoolType = Eigen::ThreadPool;
-static std::unique_ptr<DefaultThreadPoolType> default_pool;
-static std::once_flag default_pool_init;
-Eigen::ThreadPoolInterface* GetDefaultThreadPool(const onnxruntime::Env& env) {
-  std::call_once(default_pool_init, [&env] {
-    int core_num = env.GetNumCpuCores();
-    default_pool.reset(new DefaultThreadPoolType(core_num));
-  });
-  return default_pool.get();
-}
 
 namespace onnxruntime {
 namespace perftest {
+
+LatencyStats PerformanceResult::GetLatencyStats() const {
+  LatencyStats stats;
+  if (time_costs.empty()) return stats;
+
+  std::vector<double> sorted_time = time_costs;
+  std::sort(sorted_time.begin(), sorted_time.end());
+  const size_t total = sorted_time.size();
+
+  auto percentile = [&sorted_time, total](double p) {
+    auto rank = static_cast<size_t>(std::ceil(p * total));
+    return sorted_time[std::min(std::max<size_t>(rank, 1), total) - 1];
+  };
+
+  stats.min = sorted_time.front();
+  stats.max = sorted_time.back();
+  stats.mean = total_time_cost / total;
+  double sum_of_squares = 0;
+  for (double t : sorted_time) {
+    sum_of_squares += (t - stats.mean) * (t - stats.mean);
+  }
+  stats.stddev = std::sqrt(sum_of_squares / total);
+  stats.p50 = percentile(0.5);
+  stats.p90 = percentile(0.9);
+  stats.p95 = percentile(0.95);
+  stats.p99 = percentile(0.99);
+  stats.p999 = percentile(0.999);
+  return stats;
+}
+
+static std::string EscapeJsonString(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') escaped.push_back('\\');
+    escaped.push_back(c);
+  }
+  return escaped;
+}
+
+void PerformanceResult::WriteSummaryJson(std::ostream& out, const PerformanceTestConfig& test_config,
+                                         const std::string& indent) const {
+  const LatencyStats stats = GetLatencyStats();
+  const double total_run_time = GetTotalRunTime();
+  auto throughput = [total_run_time](size_t iterations) {
+    return total_run_time > 0 ? iterations / total_run_time : 0.0;
+  };
+
+  // latencies are reported in milliseconds
+  out << std::setprecision(9);
+  out << indent << "{\n"
+      << indent << "  \"model_name\": \"" << EscapeJsonString(model_name) << "\",\n"
+      << indent << "  \"execution_provider\": \""
+      << EscapeJsonString(test_config.machine_config.provider_type_name) << "\",\n"
+      << indent << "  \"concurrent_session_runs\": " << test_config.run_config.concurrent_session_runs << ",\n"
+      << indent << "  \"intra_op_num_threads\": " << test_config.run_config.intra_op_num_threads << ",\n"
+      << indent << "  \"inter_op_num_threads\": " << test_config.run_config.inter_op_num_threads << ",\n"
+      << indent << "  \"input_shapes\": \"" << EscapeJsonString(input_shapes) << "\",\n"
+      << indent << "  \"target_qps\": " << target_qps << ",\n"
+      << indent << "  \"warmup_iterations\": " << warmup_iterations << ",\n"
+      << indent << "  \"iterations\": " << time_costs.size() << ",\n"
+      << indent << "  \"total_time_cost_s\": " << total_time_cost << ",\n"
+      << indent << "  \"total_run_time_s\": " << total_run_time << ",\n"
+      << indent << "  \"throughput_per_s\": " << throughput(time_costs.size()) << ",\n"
+      << indent << "  \"peak_workingset_size\": " << peak_workingset_size << ",\n"
+      << indent << "  \"session_creation_time_s\": " << session_creation_time << ",\n"
+      << indent << "  \"average_cpu_usage\": " << average_CPU_usage << ",\n"
+      << indent << "  \"latency_ms\": {\n"
+      << indent << "    \"min\": " << stats.min * 1000 << ",\n"
+      << indent << "    \"max\": " << stats.max * 1000 << ",\n"
+      << indent << "    \"mean\": " << stats.mean * 1000 << ",\n"
+      << indent << "    \"stddev\": " << stats.stddev * 1000 << ",\n"
+      << indent << "    \"p50\": " << stats.p50 * 1000 << ",\n"
+      << indent << "    \"p90\": " << stats.p90 * 1000 << ",\n"
+      << indent << "    \"p95\": " << stats.p95 * 1000 << ",\n"
+      << indent << "    \"p99\": " << stats.p99 * 1000 << ",\n"
+      << indent << "    \"p999\": " << stats.p999 * 1000 << "\n"
+      << indent << "  },\n"
+      << indent << "  \"workers\": [";
+  for (size_t i = 0; i < worker_iterations.size(); ++i) {
+    out << (i == 0 ? "\n" : ",\n")
+        << indent << "    {\"iterations\": " << worker_iterations[i]
+        << ", \"throughput_per_s\": " << throughput(worker_iterations[i]) << "}";
+  }
+  out << "\n"
+      << indent << "  ]\n"
+      << indent << "}";
+}
+
+void PerformanceRunner::SerializeResult() const {
+  const auto& run_config = performance_test_config_.run_config;
+  const auto& results = sweep_results_.empty() ? std::vector<PerformanceResult>{performance_result_} : sweep_results_;
+  for (const auto& result : results) {
+    result.DumpToFile(performance_test_config_.model_info.result_file_path, run_config.f_dump_statistics);
+  }
+
+  if (run_config.summary_file.empty()) return;
+
+  std::ofstream outfile;
+  outfile.open(run_config.summary_file, std::ofstream::out | std::ofstream::trunc);
+  if (!outfile.good()) {
+    printf("failed to open summary file");
+    return;
+  }
+
+  // a QPS sweep is summarized as an array with one entry per target QPS
+  if (sweep_results_.empty()) {
+    performance_result_.WriteSummaryJson(outfile, performance_test_config_, "");
+  } else {
+    outfile << "[";
+    for (size_t i = 0; i < sweep_results_.size(); ++i) {
+      outfile << (i == 0 ? "\n" : ",\n");
+      sweep_results_[i].WriteSummaryJson(outfile, performance_test_config_, "  ");
+    }
+    outfile << "\n]";
+  }
+  outfile << std::endl;
+  outfile.close();
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
-  // warm up
-  RunOneIteration<true>();
+  const auto& free_dim_values = performance_test_config_.run_config.free_dim_values;
+  if (free_dim_values.empty()) {
+    return WarmUpAndRunTests();
+  }
+
+  // shape sweep: one set of tests per combination of the values of the free dims, the last one varying fastest
+  std::vector<size_t> value_ids(free_dim_values.size(), 0);
+  for (;;) {
+    std::unordered_map<std::string, int64_t> dim_values;
+    std::ostringstream input_shapes;
+    for (size_t i = 0; i < free_dim_values.size(); ++i) {
+      int64_t value = free_dim_values[i].second[value_ids[i]];
+      dim_values[free_dim_values[i].first] = value;
+      input_shapes << (i == 0 ? "" : ",") << free_dim_values[i].first << "=" << value;
+    }
+    ORT_RETURN_IF_ERROR(LoadRandomInputs(dim_values));
+    input_shapes_ = input_shapes.str();
+    ORT_RETURN_IF_ERROR(WarmUpAndRunTests());
+
+    size_t i = value_ids.size();
+    for (; i > 0; --i) {
+      if (++value_ids[i - 1] < free_dim_values[i - 1].second.size()) break;
+      value_ids[i - 1] = 0;
+    }
+    if (i == 0) break;
+  }
+  return Status::OK();
+}
+
+Status PerformanceRunner::WarmUpAndRunTests() {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // warm up. the warm-up iterations aren't included in the results.
+  // in a shape sweep this also keeps the first runs of each shape, which create its memory patterns, out of them.
+  for (size_t i = 0; i < run_config.warmup_times; ++i) {
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  }
+
+  // open-loop load: one test per target QPS of the sweep. 0 runs the closed-loop test.
+  const bool is_sweep = !run_config.target_qps.empty() || !run_config.free_dim_values.empty();
+  const auto target_qps = run_config.target_qps.empty() ? std::vector<size_t>{0} : run_config.target_qps;
+  for (size_t qps : target_qps) {
+    ORT_RETURN_IF_ERROR(RunTest(qps));
+    if (is_sweep) {
+      sweep_results_.push_back(performance_result_);
+    }
+  }
+  return Status::OK();
+}
+
+Status PerformanceRunner::LoadRandomInputs(const std::unordered_map<std::string, int64_t>& dim_values) {
+  session_->ClearTestData();
+  for (size_t i = 0; i < input_specs_.size(); ++i) {
+    std::vector<int64_t> shape;
+    ORT_RETURN_IF_ERROR(ResolveInputShape(input_specs_[i], dim_values, shape));
+    OrtValue* value = nullptr;
+    ORT_RETURN_IF_ERROR(CreateRandomInput(input_specs_[i], shape, rand_engine_, &value));
+    session_->PreLoadTestData(0, i, value);
+  }
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunTest(size_t target_qps) {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // start from a fresh result, so each test of a QPS sweep is reported on its own
+  std::string model_name = std::move(performance_result_.model_name);
+  const double session_creation_time = performance_result_.session_creation_time;
+  performance_result_ = PerformanceResult();
+  performance_result_.model_name = std::move(model_name);
+  performance_result_.session_creation_time = session_creation_time;
+  performance_result_.target_qps = target_qps;
+  performance_result_.input_shapes = input_shapes_;
+  performance_result_.warmup_iterations = run_config.warmup_times;
+  performance_result_.worker_iterations.assign(std::max<size_t>(run_config.concurrent_session_runs, 1), 0);
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start_ = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop(target_qps));
+  } else {
+    switch (run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end_ = std::chrono::high_resolution_clock::now();
 
@@ -71,13 +263,43 @@ Status PerformanceRunner::Run() {
 
   // TODO: end profiling
   // if (!performance_test_config_.run_config.profile_file.empty()) session_object->EndProfiling();
-  std::chrono::duration<double> duration = performance_result_.end_ - performance_result_.start_;
+  const double duration = performance_result_.GetTotalRunTime();
+  const size_t iterations = performance_result_.time_costs.size();
 
+  if (!input_shapes_.empty()) {
+    std::cout << "Input shapes:" << input_shapes_ << std::endl;
+  }
+  if (target_qps > 0) {
+    // in open-loop mode the latency of a request includes the time it waited for a free worker
+    std::cout << "Target QPS:" << target_qps << std::endl;
+  }
   std::cout << "Total time cost:" << performance_result_.total_time_cost << std::endl  // sum of time taken by each request
-            << "Total iterations:" << performance_result_.time_costs.size() << std::endl
-            << "Average time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl
+            << "Total iterations:" << iterations << std::endl
+            << "Average time cost:" << performance_result_.total_time_cost / iterations * 1000 << " ms" << std::endl
             // Time between start and end of run. Less than Total time cost when running requests in parallel.
-            << "Total run time:" << duration.count() << " s" << std::endl;
+            << "Total run time:" << duration << " s" << std::endl
+            << "Throughput:" << iterations / duration << " inferences/s" << std::endl
+            << "Peak working set size:" << performance_result_.peak_workingset_size << " bytes" << std::endl
+            << "Session creation time:" << performance_result_.session_creation_time * 1000 << " ms" << std::endl;
+
+  const auto& worker_iterations = performance_result_.worker_iterations;
+  if (worker_iterations.size() > 1) {
+    for (size_t i = 0; i < worker_iterations.size(); ++i) {
+      std::cout << "Worker " << i << " iterations:" << worker_iterations[i]
+                << ", throughput:" << worker_iterations[i] / duration << " inferences/s" << std::endl;
+    }
+  }
+
+  // warm-up iterations are excluded
+  LatencyStats stats = performance_result_.GetLatencyStats();
+  std::cout << "Min latency:" << stats.min * 1000 << " ms" << std::endl
+            << "Max latency:" << stats.max * 1000 << " ms" << std::endl
+            << "Latency stddev:" << stats.stddev * 1000 << " ms" << std::endl
+            << "P50 latency:" << stats.p50 * 1000 << " ms" << std::endl
+            << "P90 latency:" << stats.p90 * 1000 << " ms" << std::endl
+            << "P95 latency:" << stats.p95 * 1000 << " ms" << std::endl
+            << "P99 latency:" << stats.p99 * 1000 << " ms" << std::endl
+            << "P999 latency:" << stats.p999 * 1000 << " ms" << std::endl;
   return Status::OK();
 }
 
@@ -98,33 +320,77 @@ Status PerformanceRunner::RepeatedTimesTest() {
 }
 
 Status PerformanceRunner::RunParallelDuration() {
-  // Simple method to continually queue parallel work until the timer has run down.
-  // TODO: Make each thread enqueue a new worker.
-  auto tpool = GetDefaultThreadPool(Env::Default());
-  std::atomic<int> counter = {0};
+  const auto& run_config = performance_test_config_.run_config;
+
+  // create a threadpool with one thread per concurrent request, each running requests until the time is up
+  auto tpool = std::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
+  std::atomic<int> counter{0};
   std::mutex m;
   std::condition_variable cv;
 
-  auto start = std::chrono::high_resolution_clock::now();
-  auto end = start;
-  std::chrono::duration<double> duration_seconds;
-  do {
-    // We will queue work as deep as requested, ignoring the size of the threadpool itself
-    int count = counter.load(std::memory_order_seq_cst);
-    while (count < static_cast<int>(performance_test_config_.run_config.concurrent_session_runs)) {
-      count++;
-      counter++;
-      tpool->Schedule([this, &counter, &m, &cv]() {
-        session_->ThreadSafeRun();
-        // Simplified version of Eigen::Barrier
-        std::lock_guard<std::mutex> lg(m);
-        counter--;
-        cv.notify_all();
-      });
-    }
-    end = std::chrono::high_resolution_clock::now();
-    duration_seconds = end - start;
-  } while (duration_seconds.count() < performance_test_config_.run_config.duration_in_seconds);
+  const auto end = std::chrono::high_resolution_clock::now() + std::chrono::seconds(run_config.duration_in_seconds);
+
+  // Fork
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    counter++;
+    tpool->Schedule([this, i, end, &counter, &m, &cv]() {
+      while (std::chrono::high_resolution_clock::now() < end) {
+        auto status = RunOneIteration<false>(i);
+        if (!status.IsOK())
+          std::cerr << status.ErrorMessage();
+      }
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<std::mutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
+
+  //Join
+  std::unique_lock<std::mutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunOpenLoop(size_t target_qps) {
+  const auto& run_config = performance_test_config_.run_config;
+  using Clock = std::chrono::high_resolution_clock;
+
+  // requests arrive as a Poisson process, independently of how fast they complete, and are queued until one of
+  // the workers is free. the latency of a request is measured from its arrival.
+  auto tpool = std::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
+  std::atomic<int> counter{0};
+  std::mutex m;
+  std::condition_variable cv;
+
+  std::default_random_engine rand_engine(std::random_device{}());
+  std::exponential_distribution<double> inter_arrival_seconds(static_cast<double>(target_qps));
+
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(run_config.duration_in_seconds);
+  auto arrival = start;
+  for (size_t requests = 0;; ++requests) {
+    if (run_config.test_mode == TestMode::KFixRepeatedTimesMode && requests == run_config.repeated_times) break;
+
+    arrival += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(inter_arrival_seconds(rand_engine)));
+    if (run_config.test_mode == TestMode::kFixDurationMode && arrival >= end) break;
+
+    std::this_thread::sleep_until(arrival);
+    counter++;
+    tpool->Schedule([this, arrival, &tpool, &counter, &m, &cv]() {
+      session_->Run();
+      std::chrono::duration<double> latency = Clock::now() - arrival;
+      RecordIteration(latency.count(), static_cast<size_t>(tpool->CurrentThreadId()));
+
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<std::mutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
 
   //Join
   std::unique_lock<std::mutex> lock(m);
@@ -148,9 +414,9 @@ Status PerformanceRunner::ForkJoinRepeat() {
 
   for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
     counter++;
-    tpool->Schedule([this, &counter, &requests, &m, &cv, &run_config]() {
+    tpool->Schedule([this, i, &counter, &requests, &m, &cv, &run_config]() {
       while (requests++ < static_cast<int>(run_config.repeated_times)) {
-        auto status = RunOneIteration<false>();
+        auto status = RunOneIteration<false>(i);
         if (!status.IsOK())
           std::cerr << status.ErrorMessage();
       }
@@ -195,7 +461,12 @@ static TestSession* CreateSession(Ort::Env& env, std::random_device& rd,
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
       test_model_info_(CreateModelInfo(test_config)),
-      session_(CreateSession(env, rd, test_config, test_model_info_)) {}
+      rand_engine_(rd()) {
+  auto start = std::chrono::high_resolution_clock::now();
+  session_.reset(CreateSession(env, rd, test_config, test_model_info_));
+  performance_result_.session_creation_time =
+      std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
 
 PerformanceRunner::~PerformanceRunner() = default;
 
@@ -216,6 +487,27 @@ bool PerformanceRunner::Initialize() {
 
   test_case_.reset(CreateOnnxTestCase(narrow_model_name, test_model_info_, 0.0, 0.0));
 
+  // the inputs of a shape sweep are generated from the types and shapes in the model
+  if (!performance_test_config_.run_config.free_dim_values.empty()) {
+    int input_count = test_model_info_->GetInputCount();
+    input_specs_.resize(input_count);
+    for (int i = 0; i != input_count; ++i) {
+      const auto* value_info = test_model_info_->GetInputInfoFromModel(i);
+      if (value_info == nullptr) {
+        std::cout << "the shapes of the inputs of the model are unknown, a shape sweep isn't possible" << std::endl;
+        return false;
+      }
+      st = GetInputSpec(*value_info, input_specs_[i]);
+      if (!st.IsOK()) {
+        std::cout << st.ErrorMessage() << std::endl;
+        return false;
+      }
+    }
+    test_case_.reset(nullptr);
+    test_model_info_ = nullptr;
+    return true;
+  }
+
   // TODO: Place input tensor on cpu memory if mkldnn provider type to avoid CopyTensor logic in CopyInputAcrossDevices
   size_t test_data_count = test_case_->GetDataCount();
   if (test_data_count == 0) {
@@ -5,6 +5,7 @@
 
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <mutex>
@@ -19,6 +20,7 @@
 #include "test_configuration.h"
 #include "heap_buffer.h"
 #include "test_session.h"
+#include "input_generator.h"
 #include "OrtValueList.h"
 
 class ITestCase;
@@ -27,6 +29,19 @@ class TestModelInfo;
 namespace onnxruntime {
 namespace perftest {
 
+// Latency statistics of the measured iterations, in seconds.
+struct LatencyStats {
+  double min{0};
+  double max{0};
+  double mean{0};
+  double stddev{0};
+  double p50{0};
+  double p90{0};
+  double p95{0};
+  double p99{0};
+  double p999{0};
+};
+
 struct PerformanceResult {
   std::chrono::time_point<std::chrono::high_resolution_clock> start_;
   std::chrono::time_point<std::chrono::high_resolution_clock> end_;
@@ -34,7 +49,28 @@ struct PerformanceResult {
   short average_CPU_usage{0};
   double total_time_cost{0};
   std::vector<double> time_costs;
+  // number of measured iterations run by each of the concurrent workers
+  std::vector<size_t> worker_iterations;
+  size_t warmup_iterations{0};
+  // the rate of the open-loop load the result was measured under, 0 for the closed-loop tests
+  size_t target_qps{0};
+  // the values of the free dims of the generated inputs for a shape sweep, like 'batch=1,seq=128'
+  std::string input_shapes;
   std::string model_name;
+  // time to create the session, which loads, optimizes and partitions the model, in seconds
+  double session_creation_time{0};
+
+  // Time between start and end of the measured run, in seconds.
+  double GetTotalRunTime() const {
+    return std::chrono::duration<double>(end_ - start_).count();
+  }
+
+  // Computes the statistics of time_costs. The percentiles use the nearest-rank method.
+  LatencyStats GetLatencyStats() const;
+
+  // Writes a machine-readable summary of the run as a JSON object, which can be diffed across builds.
+  // Every line of the object is prefixed with indent.
+  void WriteSummaryJson(std::ostream& out, const PerformanceTestConfig& test_config, const std::string& indent) const;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const {
     std::ofstream outfile;
@@ -49,30 +85,16 @@ struct PerformanceResult {
     }
 
     if (!time_costs.empty() && f_include_statistics) {
-      std::vector<double> sorted_time = time_costs;
-
-      size_t total = sorted_time.size();
-      size_t n50 = static_cast<size_t>(total * 0.5);
-      size_t n90 = static_cast<size_t>(total * 0.9);
-      size_t n95 = static_cast<size_t>(total * 0.95);
-      size_t n99 = static_cast<size_t>(total * 0.99);
-      size_t n999 = static_cast<size_t>(total * 0.999);
-
-      std::sort(sorted_time.begin(), sorted_time.end());
+      LatencyStats stats = GetLatencyStats();
 
       outfile << std::endl;
-      auto output_stats = [&](std::ostream& ostream) {
-        ostream << "Min Latency is " << sorted_time[0] << "sec" << std::endl;
-        ostream << "Max Latency is " << sorted_time[total - 1] << "sec" << std::endl;
-        ostream << "P50 Latency is " << sorted_time[n50] << "sec" << std::endl;
-        ostream << "P90 Latency is " << sorted_time[n90] << "sec" << std::endl;
-        ostream << "P95 Latency is " << sorted_time[n95] << "sec" << std::endl;
-        ostream << "P99 Latency is " << sorted_time[n99] << "sec" << std::endl;
-        ostream << "P999 Latency is " << sorted_time[n999] << "sec" << std::endl;
-      };
-
-      output_stats(outfile);
-      output_stats(std::cout);
+      outfile << "Min Latency is " << stats.min << "sec" << std::endl;
+      outfile << "Max Latency is " << stats.max << "sec" << std::endl;
+      outfile << "P50 Latency is " << stats.p50 << "sec" << std::endl;
+      outfile << "P90 Latency is " << stats.p90 << "sec" << std::endl;
+      outfile << "P95 Latency is " << stats.p95 << "sec" << std::endl;
+      outfile << "P99 Latency is " << stats.p99 << "sec" << std::endl;
+      outfile << "P999 Latency is " << stats.p999 << "sec" << std::endl;
     }
 
     outfile.close();
@@ -88,30 +110,37 @@ class PerformanceRunner {
 
   inline const PerformanceResult& GetResult() const { return performance_result_; }
 
-  inline void SerializeResult() const {
-    performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
-                                   performance_test_config_.run_config.f_dump_statistics);
-  }
+  void SerializeResult() const;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerformanceRunner);
 
  private:
   bool Initialize();
 
   template <bool isWarmup>
-  Status RunOneIteration() {
+  Status RunOneIteration(size_t worker_id = 0) {
     std::chrono::duration<double> duration_seconds = session_->Run();
     if (!isWarmup) {
-      std::lock_guard<std::mutex> guard(results_mutex_);
-      performance_result_.time_costs.emplace_back(duration_seconds.count());
-      performance_result_.total_time_cost += duration_seconds.count();
-      if (performance_test_config_.run_config.f_verbose) {
-        std::cout << "iteration:" << performance_result_.time_costs.size() << ","
-                  << "time_cost:" << performance_result_.time_costs.back() << std::endl;
-      }
+      RecordIteration(duration_seconds.count(), worker_id);
     }
     return Status::OK();
   }
 
+  void RecordIteration(double time_cost, size_t worker_id) {
+    std::lock_guard<std::mutex> guard(results_mutex_);
+    performance_result_.time_costs.emplace_back(time_cost);
+    performance_result_.total_time_cost += time_cost;
+    performance_result_.worker_iterations[worker_id]++;
+    if (performance_test_config_.run_config.f_verbose) {
+      std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+                << "time_cost:" << performance_result_.time_costs.back() << std::endl;
+    }
+  }
+
+  Status WarmUpAndRunTests();
+  Status LoadRandomInputs(const std::unordered_map<std::string, int64_t>& dim_values);
+  Status RunTest(size_t target_qps);
+  Status RunOpenLoop(size_t target_qps);
+
   Status FixDurationTest();
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
@@ -133,11 +162,17 @@ class PerformanceRunner {
 
  private:
   PerformanceResult performance_result_;
+  // the results of each target QPS of an open-loop sweep, and each shape of a shape sweep
+  std::vector<PerformanceResult> sweep_results_;
   PerformanceTestConfig performance_test_config_;
   TestModelInfo* test_model_info_;
   std::unique_ptr<TestSession> session_;
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
+  // the graph inputs, when the inputs are generated for a shape sweep
+  std::vector<InputSpec> input_specs_;
+  std::string input_shapes_;
+  std::mt19937 rand_engine_;
 
   // TODO: Convert to OrtMutex
   std::mutex results_mutex_;
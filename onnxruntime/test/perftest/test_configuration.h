@@ -5,6 +5,8 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "core/graph/constants.h"
 
@@ -35,10 +37,16 @@ struct MachineConfig {
 
 struct RunConfig {
   std::basic_string<ORTCHAR_T> profile_file;
+  std::basic_string<ORTCHAR_T> summary_file;
   TestMode test_mode{TestMode::kFixDurationMode};
   size_t repeated_times{1000};
+  size_t warmup_times{1};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // when set, requests are issued at these rates with Poisson arrivals, one test per rate
+  std::vector<size_t> target_qps;
+  // when set, random inputs are generated for each combination of these values of the free dims, by symbolic name
+  std::vector<std::pair<std::string, std::vector<int64_t>>> free_dim_values;
   bool f_dump_statistics{false};
   bool f_verbose{false};
   bool enable_memory_pattern{true};
@@ -16,6 +16,8 @@ class TestSession {
   // Please measure the perf at a higher level.
   void ThreadSafeRun() { abort(); }
   virtual void PreLoadTestData(size_t test_data_id, size_t input_id, OrtValue* value) = 0;
+  // Releases the preloaded test data, so that inputs of other shapes can be loaded.
+  virtual void ClearTestData() = 0;
 
   virtual ~TestSession() = default;
 };
@@ -217,6 +217,15 @@ class TensorflowTestSession : public TestSession {
     return end - start;
   }
 
+  void ClearTestData() override {
+    for (auto& tensors : feed_tensors_) {
+      for (TF_Tensor* t : tensors) {
+        if (t != nullptr) TF_DeleteTensor(t);
+      }
+    }
+    feed_tensors_.clear();
+  }
+
   ~TensorflowTestSession() override {
     if (model_deleter.f != nullptr) {
       model_deleter.f(model_deleter.param);
@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/threadpool.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ThreadPoolTest, ParallelForCoversEveryIteration) {
+  concurrency::ThreadPool tp("test", 4);
+  const int32_t total = 1000;
+  std::vector<std::atomic<int>> counts(total);
+  for (auto& c : counts) c = 0;
+
+  tp.ParallelFor(total, [&counts](int32_t i) { counts[i]++; });
+
+  for (int32_t i = 0; i < total; ++i) {
+    ASSERT_EQ(counts[i], 1) << "iteration " << i;
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForBlocksAreContiguousAndBounded) {
+  concurrency::ThreadPool tp("test", 4);
+  const std::ptrdiff_t total = 12345;
+  std::mutex mutex;
+  std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>> blocks;
+
+  tp.ParallelFor(total, 0.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocks.emplace_back(first, last);
+  });
+
+  ASSERT_LE(static_cast<int>(blocks.size()), tp.NumThreads() + 1);
+  std::sort(blocks.begin(), blocks.end());
+  std::ptrdiff_t next = 0;
+  for (const auto& b : blocks) {
+    ASSERT_EQ(b.first, next);
+    ASSERT_LT(b.first, b.second);
+    next = b.second;
+  }
+  ASSERT_EQ(next, total);
+}
+
+TEST(ThreadPoolTest, ParallelForCheapWorkRunsInline) {
+  concurrency::ThreadPool tp("test", 4);
+  EXPECT_EQ(tp.ComputeBlockCount(16, 1.0), 1);
+  EXPECT_EQ(tp.ComputeBlockCount(1 << 20, 1000.0), tp.NumThreads() + 1);
+  EXPECT_EQ(tp.ComputeBlockCount(3, 0.0), 3);
+  EXPECT_EQ(tp.ComputeBlockCount(0, 0.0), 0);
+
+  std::atomic<int> calls{0};
+  tp.ParallelFor(16, 1.0, [&calls](std::ptrdiff_t first, std::ptrdiff_t last) {
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(last, 16);
+    ++calls;
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(ThreadPoolTest, ParallelForRangeIsHalfOpen) {
+  concurrency::ThreadPool tp("test", 2);
+  std::atomic<int64_t> sum{0};
+  tp.ParallelForRange(10, 20, [&sum](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) sum += i;
+  });
+  EXPECT_EQ(sum, 145);
+}
+
+TEST(ThreadPoolTest, ScopedParallelismLimit) {
+  concurrency::ThreadPool tp("test", 4);
+  ASSERT_EQ(tp.NumThreads(), 4);
+  {
+    concurrency::ThreadPool::ScopedParallelismLimit limit(2);
+    EXPECT_EQ(concurrency::ThreadPool::CurrentParallelismLimit(), 2);
+    // the calling thread is one of the two
+    EXPECT_EQ(tp.NumThreads(), 1);
+    EXPECT_EQ(tp.ComputeBlockCount(1 << 20, 0.0), 2);
+    {
+      concurrency::ThreadPool::ScopedParallelismLimit inner_limit(1);
+      EXPECT_EQ(tp.NumThreads(), 0);
+
+      std::atomic<int> calls{0};
+      tp.ParallelFor(1000, 0.0, [&calls](std::ptrdiff_t first, std::ptrdiff_t last) {
+        EXPECT_EQ(first, 0);
+        EXPECT_EQ(last, 1000);
+        ++calls;
+      });
+      EXPECT_EQ(calls, 1);
+    }
+    EXPECT_EQ(tp.NumThreads(), 1);
+
+    // a limit larger than the pool doesn't add threads
+    concurrency::ThreadPool::ScopedParallelismLimit large_limit(100);
+    EXPECT_EQ(tp.NumThreads(), 4);
+  }
+  EXPECT_EQ(concurrency::ThreadPool::CurrentParallelismLimit(), 0);
+  EXPECT_EQ(tp.NumThreads(), 4);
+}
+
+TEST(ThreadPoolTest, ScopedDeadline) {
+  concurrency::ThreadPool tp("test", 4);
+  EXPECT_FALSE(concurrency::ThreadPool::DeadlineExceeded());
+
+  std::atomic<int> blocks{0};
+  auto count_blocks = [&blocks](std::ptrdiff_t, std::ptrdiff_t) { blocks++; };
+  {
+    concurrency::ThreadPool::ScopedDeadline deadline(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    EXPECT_FALSE(concurrency::ThreadPool::DeadlineExceeded());
+    tp.ParallelFor(100, 0.0, count_blocks);
+    EXPECT_EQ(blocks, 5);
+
+    // the blocks of a loop past the deadline are skipped
+    blocks = 0;
+    concurrency::ThreadPool::ScopedDeadline passed_deadline(std::chrono::steady_clock::now());
+    EXPECT_TRUE(concurrency::ThreadPool::DeadlineExceeded());
+    tp.ParallelFor(100, 0.0, count_blocks);
+    EXPECT_EQ(blocks, 0);
+  }
+  EXPECT_FALSE(concurrency::ThreadPool::DeadlineExceeded());
+  EXPECT_EQ(concurrency::ThreadPool::CurrentDeadline(), std::chrono::steady_clock::time_point::max());
+}
+
+TEST(ThreadPoolTest, ParallelSectionRunsConsecutiveLoops) {
+  for (int spin_duration_us : {0, 100}) {
+    concurrency::ThreadOptions thread_options;
+    thread_options.section_spin_duration_us = spin_duration_us;
+    concurrency::ThreadPool tp("test", 4, thread_options);
+
+    concurrency::ThreadPool::ParallelSection section(&tp);
+    // a nested section on the same pool is a no-op
+    concurrency::ThreadPool::ParallelSection nested_section(&tp);
+
+    const std::ptrdiff_t total = 1000;
+    std::vector<std::atomic<int>> counts(total);
+    for (auto& c : counts) c = 0;
+
+    for (int loop = 0; loop < 50; ++loop) {
+      tp.ParallelFor(total, 0.0, [&counts](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) counts[i]++;
+      });
+    }
+
+    for (std::ptrdiff_t i = 0; i < total; ++i) {
+      ASSERT_EQ(counts[i], 50) << "iteration " << i;
+    }
+  }
+}
+
+// Test that a section doesn't hold the threads of the pool between its loops, so a concurrent caller with its own
+// section, such as another Run of a session, gets helpers too
+TEST(ThreadPoolTest, ParallelSectionsOfConcurrentCallersShareThePool) {
+  concurrency::ThreadOptions thread_options;
+  thread_options.section_spin_duration_us = 100;
+  concurrency::ThreadPool tp("test", 4, thread_options);
+
+  // returns whether a thread other than the calling one ran some of the blocks of a loop
+  auto run_loop = [&tp]() {
+    const auto caller = std::this_thread::get_id();
+    std::atomic<bool> helped{false};
+    tp.ParallelFor(std::ptrdiff_t{5}, 0.0, [&](std::ptrdiff_t, std::ptrdiff_t) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      if (std::this_thread::get_id() != caller) helped = true;
+    });
+    return helped.load();
+  };
+
+  std::promise<void> first_loop_done, second_caller_done;
+  bool first_helped = false, first_helped_again = false, second_helped = false;
+
+  std::thread first_caller([&]() {
+    concurrency::ThreadPool::ParallelSection section(&tp);
+    first_helped = run_loop();
+    first_loop_done.set_value();
+    // the section stays open while the other caller runs, like a Run between two parallel operators
+    second_caller_done.get_future().wait();
+    first_helped_again = run_loop();
+  });
+
+  std::thread second_caller([&]() {
+    first_loop_done.get_future().wait();
+    concurrency::ThreadPool::ParallelSection section(&tp);
+    second_helped = run_loop();
+    second_caller_done.set_value();
+  });
+
+  first_caller.join();
+  second_caller.join();
+
+  EXPECT_TRUE(first_helped);
+  EXPECT_TRUE(second_helped);
+  EXPECT_TRUE(first_helped_again);
+}
+
+TEST(ThreadPoolTest, ParallelSectionWithoutThreadPool) {
+  concurrency::ThreadPool::ParallelSection section(nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
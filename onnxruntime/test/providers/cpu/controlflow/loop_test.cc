@@ -713,6 +713,65 @@ TEST(Loop, Opset11WithNoVariadicInputsAndOutputs) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// the loop carried var alternates between two buffers, which must not happen to one still used by a loop output
+TEST(Loop, LoopCarriedVarInLoopOutput) {
+  auto create_subgraph = []() {
+    Model model("Loop carried var in loop output body graph");
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto float_scalar;
+    float_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    float_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& sum_in = graph.GetOrCreateNodeArg("sum_in", &float_scalar);
+    auto& one = graph.GetOrCreateNodeArg("one", &float_scalar);
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& sum_out = graph.GetOrCreateNodeArg("sum_out", &float_scalar);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+
+    TensorProto one_proto;
+    one_proto.set_name("one");
+    one_proto.add_dims(1);
+    one_proto.set_data_type(TensorProto_DataType_FLOAT);
+    one_proto.add_float_data(1.f);
+    graph.AddInitializedTensor(one_proto);
+
+    graph.AddNode("add", "Add", "sum_out = sum_in + 1", {&sum_in, &one}, {&sum_out});
+
+    // sum_in is also the loop output, so the buffer fed to each iteration is kept by it
+    graph.SetInputs({&iter_num_in, &cond_in, &sum_in});
+    graph.SetOutputs({&cond_out, &sum_out, &sum_in});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  test.AddAttribute<GraphProto>("body", create_subgraph());
+  test.AddInput<int64_t>("M", {1}, {5});
+  test.AddInput<bool>("cond", {1}, {true});
+  test.AddInput<float>("sum", {1}, {0.f});
+
+  test.AddOutput<float>("sum_out", {1}, {5.f});
+  test.AddOutput<float>("loop_scan_out", {5, 1}, {0.f, 1.f, 2.f, 3.f, 4.f});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #ifdef USE_CUDA
 // test that when part of the subgraph run on CUDA it executes successfully
 TEST(Loop, MixedExecutionProviders) {
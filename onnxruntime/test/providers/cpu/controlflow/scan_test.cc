@@ -24,6 +24,7 @@ struct RunOptions {
   bool scalar_loop_state_value = false;
   bool add_bad_shape = false;
   bool mixed_execution_providers = false;
+  bool sequential_execution = true;
 };
 
 static void CreateSubgraph(Graph& graph, RunOptions& options, const std::string& failure_message = "");
@@ -310,7 +311,8 @@ static void RunTest_v8(const std::string test_name, int64_t batch_size, int64_t
   test.AddOutput<float>("scan_output_2", output_shape, output_2);
   test.AddOutput<float>("scan_output_3", output_shape, output_3);
 
-  test.Run(expect_result, failure_message, {kTensorrtExecutionProvider});// Disable TensorRT because its parser failed
+  test.Run(expect_result, failure_message, {kTensorrtExecutionProvider},  // Disable TensorRT because its parser failed
+           nullptr, nullptr, options.sequential_execution);
 }
 
 static void RunTest_v9(const std::string test_name, int64_t sequence_len, int64_t input_size,
@@ -405,7 +407,8 @@ static void RunTest_v9(const std::string test_name, int64_t sequence_len, int64_
 
     test.Run(expect_result, failure_message, {kTensorrtExecutionProvider}, nullptr, &execution_providers);
   } else {
-    test.Run(expect_result, failure_message, {kTensorrtExecutionProvider});// Disable TensorRT because its parser failed
+    test.Run(expect_result, failure_message, {kTensorrtExecutionProvider},  // Disable TensorRT because its parser failed
+             nullptr, nullptr, options.sequential_execution);
   }
 }
 
@@ -603,7 +606,7 @@ TEST(Scan8, ShortSequenceTwoInBatchOneLoopStateVar) {
              iteration_count_out, output_0, output_1, output_2, output_3);
 }
 
-TEST(Scan8, MixedSequenceLens) {
+static void MixedSequenceLens(const RunOptions& options) {
   const int64_t batch_size = 3;
   const int64_t max_sequence_len = 2;
   const int64_t input_size = 2;
@@ -647,7 +650,19 @@ TEST(Scan8, MixedSequenceLens) {
   RunTest_v8("MixedSequenceLens", batch_size, max_sequence_len, input_size,
              nullptr, &sequence_lens,
              iteration_count_in, input_0, input_1,
-             iteration_count_out, output_0, output_1, output_2, output_3);
+             iteration_count_out, output_0, output_1, output_2, output_3,
+             options);
+}
+
+TEST(Scan8, MixedSequenceLens) {
+  MixedSequenceLens({});
+}
+
+// the batch entries after the first are run in parallel on the inter-op thread pool
+TEST(Scan8, MixedSequenceLensParallelExecution) {
+  RunOptions options{};
+  options.sequential_execution = false;
+  MixedSequenceLens(options);
 }
 
 TEST(Scan8, MixedSequenceLensReverse) {
@@ -193,5 +193,61 @@ TEST(CumSumTest, _1DTestInt64) {
   test.AddOutput<int64_t>("y", {5}, {1, 3, 6, 10, 15});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+TEST(CumSumTest, _1DTestLarge) {
+  // long enough for the accumulation to be split into blocks
+  const int64_t size = 50000;
+  std::vector<int64_t> x(size);
+  std::vector<int64_t> y(size);
+  std::vector<int64_t> y_reverse_exclusive(size);
+  int64_t sum = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    x[i] = i % 7 - 3;
+    sum += x[i];
+    y[i] = sum;
+  }
+  sum = 0;
+  for (int64_t i = size - 1; i >= 0; --i) {
+    y_reverse_exclusive[i] = sum;
+    sum += x[i];
+  }
+
+  OpTester test("CumSum", 11, onnxruntime::kOnnxDomain);
+  test.AddInput<int64_t>("x", {size}, x);
+  test.AddInput<int32_t>("axis", {1}, {0});
+  test.AddOutput<int64_t>("y", {size}, y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+
+  OpTester reverse_exclusive_test("CumSum", 11, onnxruntime::kOnnxDomain);
+  reverse_exclusive_test.AddAttribute<int64_t>("exclusive", 1);
+  reverse_exclusive_test.AddAttribute<int64_t>("reverse", 1);
+  reverse_exclusive_test.AddInput<int64_t>("x", {size}, x);
+  reverse_exclusive_test.AddInput<int32_t>("axis", {1}, {0});
+  reverse_exclusive_test.AddOutput<int64_t>("y", {size}, y_reverse_exclusive);
+  reverse_exclusive_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+TEST(CumSumTest, _3DTestMiddleAxisReverse) {
+  const int64_t outer = 3, dim = 4, inner = 5;
+  std::vector<int32_t> x(outer * dim * inner);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<int32_t>(i);
+  }
+  std::vector<int32_t> y(x.size());
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t c = 0; c < inner; ++c) {
+      int32_t sum = 0;
+      for (int64_t t = dim - 1; t >= 0; --t) {
+        sum += x[(o * dim + t) * inner + c];
+        y[(o * dim + t) * inner + c] = sum;
+      }
+    }
+  }
+
+  OpTester test("CumSum", 11, onnxruntime::kOnnxDomain);
+  test.AddAttribute<int64_t>("reverse", 1);
+  test.AddInput<int32_t>("x", {outer, dim, inner}, x);
+  test.AddInput<int32_t>("axis", {1}, {1});
+  test.AddOutput<int32_t>("y", {outer, dim, inner}, y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
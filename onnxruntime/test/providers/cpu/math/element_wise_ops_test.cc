@@ -227,6 +227,128 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// Large enough for the output to be split across the thread pool, including in the middle of a span.
+TEST(MathOpTest, Add_Broadcast_Channel_Large) {
+  OpTester test("Add");
+
+  const int64_t N = 3, C = 17, HW = 29 * 31;
+  std::vector<float> A(N * C * HW), B(C), Y(N * C * HW);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(i % 101);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(1000 * (i + 1));
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = A[i] + B[(i / HW) % C];
+
+  test.AddInput<float>("A", {N, C, 29, 31}, A);
+  test.AddInput<float>("B", {C, 1, 1}, B);
+  test.AddOutput<float>("C", {N, C, 29, 31}, Y);
+  test.Run();
+}
+
+TEST(MathOpTest, Mul_Broadcast_LastDim_Large) {
+  OpTester test("Mul");
+
+  const int64_t M = 517, K = 61;
+  std::vector<float> A(M * K), B(K), Y(M * K);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(i % 13);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i % 7) - 3.0f;
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = A[i] * B[i % K];
+
+  test.AddInput<float>("A", {M, K}, A);
+  test.AddInput<float>("B", {K}, B);
+  test.AddOutput<float>("C", {M, K}, Y);
+  test.Run();
+}
+
+TEST(MathOpTest, Sub_Broadcast_Scalar_Large) {
+  OpTester test("Sub");
+
+  std::vector<float> B(40009), Y(B.size());
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i % 251);
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = 5.0f - B[i];
+
+  test.AddInput<float>("A", {}, {5.0f});
+  test.AddInput<float>("B", {static_cast<int64_t>(B.size())}, B);
+  test.AddOutput<float>("C", {static_cast<int64_t>(Y.size())}, Y);
+  test.Run();
+}
+
+// The left input is broadcast, which checks the operands keep their order.
+TEST(MathOpTest, Sub_Broadcast_LeftLastDim_Large) {
+  OpTester test("Sub");
+
+  const int64_t M = 37, K = 64;
+  std::vector<float> A(K), B(M * K), Y(M * K);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(i % 11);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i % 17);
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = A[i % K] - B[i];
+
+  test.AddInput<float>("A", {K}, A);
+  test.AddInput<float>("B", {M, K}, B);
+  test.AddOutput<float>("C", {M, K}, Y);
+  test.Run();
+}
+
+TEST(MathOpTest, Div_Broadcast_LeftChannel) {
+  OpTester test("Div");
+
+  const int64_t N = 2, C = 5, HW = 3 * 7;
+  std::vector<float> A(C), B(N * C * HW), Y(N * C * HW);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(16 * (i + 1));
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(1 << (i % 4));
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = A[(i / HW) % C] / B[i];
+
+  test.AddInput<float>("A", {C, 1, 1}, A);
+  test.AddInput<float>("B", {N, C, 3, 7}, B);
+  test.AddOutput<float>("C", {N, C, 3, 7}, Y);
+  test.Run();
+}
+
+// The size isn't a multiple of the vectors of the elementwise kernels.
+TEST(MathOpTest, Mul_Large_Odd_Size) {
+  OpTester test("Mul");
+
+  std::vector<float> A(4099), B(A.size()), Y(A.size());
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(i % 29);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i % 5) - 2.0f;
+  for (size_t i = 0; i < Y.size(); i++) Y[i] = A[i] * B[i];
+
+  test.AddInput<float>("A", {static_cast<int64_t>(A.size())}, A);
+  test.AddInput<float>("B", {static_cast<int64_t>(B.size())}, B);
+  test.AddOutput<float>("C", {static_cast<int64_t>(Y.size())}, Y);
+  test.Run();
+}
+
+#ifdef USE_CUDA
+// The CPU provider has no fp16 Add and Mul.
+TEST(MathOpTest, Add_Mul_float16) {
+  const int64_t M = 3, K = 16;
+  std::vector<float> A(M * K + 3), B(A.size()), sum(A.size()), bias(K), product(M * K);
+  for (size_t i = 0; i < A.size(); i++) A[i] = static_cast<float>(i % 13);
+  for (size_t i = 0; i < B.size(); i++) B[i] = static_cast<float>(i % 7) - 3.0f;
+  for (size_t i = 0; i < sum.size(); i++) sum[i] = A[i] + B[i];
+  for (size_t i = 0; i < bias.size(); i++) bias[i] = static_cast<float>(i % 5) - 2.0f;
+  for (size_t i = 0; i < product.size(); i++) product[i] = A[i] * bias[i % K];
+
+  auto to_half = [](const std::vector<float>& values) {
+    std::vector<MLFloat16> output;
+    for (float value : values) output.push_back(MLFloat16(math::floatToHalf(value)));
+    return output;
+  };
+
+  OpTester add_test("Add");
+  add_test.AddInput<MLFloat16>("A", {static_cast<int64_t>(A.size())}, to_half(A));
+  add_test.AddInput<MLFloat16>("B", {static_cast<int64_t>(B.size())}, to_half(B));
+  add_test.AddOutput<MLFloat16>("C", {static_cast<int64_t>(sum.size())}, to_half(sum));
+  add_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCpuExecutionProvider});
+
+  OpTester mul_test("Mul");
+  A.resize(M * K);
+  mul_test.AddInput<MLFloat16>("A", {M, K}, to_half(A));
+  mul_test.AddInput<MLFloat16>("B", {K}, to_half(bias));
+  mul_test.AddOutput<MLFloat16>("C", {M, K}, to_half(product));
+  mul_test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kCpuExecutionProvider});
+}
+#endif
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -87,5 +87,36 @@ TEST(MatmulIntegerOpTest, MatMulInteger_Uint8_Int8) {
   RunMatMulIntegerU8S8Test(8, 16, 64);
 }
 
+// A batch of matrices larger than the tiles of the CUDA kernel, with sizes that aren't multiples of them.
+TEST(MatmulIntegerOpTest, MatMulInteger_Batched_Large) {
+  const int64_t batch = 3, M = 70, K = 37, N = 130;
+  const uint8_t a_zero_point = 128, b_zero_point = 3;
+  std::vector<uint8_t> a(batch * M * K), b(batch * K * N);
+  for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<uint8_t>((i * 7) % 251);
+  for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<uint8_t>((i * 13) % 17);
+
+  std::vector<int32_t> y(batch * M * N, 0);
+  for (int64_t n = 0; n < batch; ++n) {
+    for (int64_t i = 0; i < M; ++i) {
+      for (int64_t j = 0; j < N; ++j) {
+        int32_t sum = 0;
+        for (int64_t k = 0; k < K; ++k) {
+          sum += (static_cast<int32_t>(a[(n * M + i) * K + k]) - a_zero_point) *
+                 (static_cast<int32_t>(b[(n * K + k) * N + j]) - b_zero_point);
+        }
+        y[(n * M + i) * N + j] = sum;
+      }
+    }
+  }
+
+  OpTester test("MatMulInteger", 10);
+  test.AddInput<uint8_t>("T1", {batch, M, K}, a);
+  test.AddInput<uint8_t>("T2", {batch, K, N}, b);
+  test.AddInput<uint8_t>("a_zero_point", {}, {a_zero_point});
+  test.AddInput<uint8_t>("b_zero_point", {}, {b_zero_point});
+  test.AddOutput<int32_t>("T3", {batch, M, N}, y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
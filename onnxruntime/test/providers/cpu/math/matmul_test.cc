@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace test {
@@ -105,6 +106,34 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7);
 }
 
+TEST(MathOpTest, MatMulFloatTypeConstantB) {
+  // a constant 2D B is packed once when the kernel is created
+  OpTester test("MatMul", 7);
+  test.AddInput<float>("A", {2, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
+  test.AddInput<float>("B", {3, 4}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, true);
+  test.AddOutput<float>("Y", {2, 2, 4},
+                        {20, 23, 26, 29, 56, 68, 80, 92, 92, 113, 134, 155, 128, 158, 188, 218});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(MathOpTest, MatMulFloat16Type) {
+  // the product is accumulated in float and rounded to half precision once
+  auto to_half = [](const std::vector<float>& values) {
+    std::vector<MLFloat16> result;
+    for (float v : values) {
+      result.push_back(MLFloat16(math::floatToHalf(v)));
+    }
+    return result;
+  };
+
+  OpTester test("MatMul", 7);
+  test.AddInput<MLFloat16>("A", {2, 2, 3}, to_half({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+  test.AddInput<MLFloat16>("B", {3, 4}, to_half({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+  test.AddOutput<MLFloat16>("Y", {2, 2, 4},
+                            to_half({20, 23, 26, 29, 56, 68, 80, 92, 92, 113, 134, 155, 128, 158, 188, 218}));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
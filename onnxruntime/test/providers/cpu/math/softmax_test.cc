@@ -5,6 +5,9 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace onnxruntime {
 namespace test {
 
@@ -178,6 +181,34 @@ TEST(SoftmaxOperator, ThreeDimsNegativeAxis) {
   RunTest(x_vals_3dims, expected_vals, three_dimensions, /*axis*/ -1);
 }
 
+// The rows are computed by the kernels specialized on the row length, up to the longest rows of the warp
+// softmax of the CUDA provider and past them.
+TEST(SoftmaxOperator, RowLengths) {
+  for (int64_t row_size : {1, 5, 32, 33, 200, 1024, 1500}) {
+    const int64_t rows = 7;
+    std::vector<float> x_vals(rows * row_size);
+    for (size_t i = 0; i < x_vals.size(); i++) {
+      x_vals[i] = static_cast<float>(static_cast<int>(i * 7919 % 101) - 50) / 10.0f;
+    }
+
+    std::vector<float> expected_vals(x_vals.size());
+    for (int64_t r = 0; r < rows; r++) {
+      const float* x_row = x_vals.data() + r * row_size;
+      float* y_row = expected_vals.data() + r * row_size;
+      const float max_value = *std::max_element(x_row, x_row + row_size);
+      double sum = 0;
+      for (int64_t i = 0; i < row_size; i++) {
+        sum += std::exp(x_row[i] - max_value);
+      }
+      for (int64_t i = 0; i < row_size; i++) {
+        y_row[i] = static_cast<float>(std::exp(x_row[i] - max_value) / sum);
+      }
+    }
+
+    RunTest(x_vals, expected_vals, {rows, row_size});
+  }
+}
+
 TEST(SoftmaxOperator, InvalidAxis) {
   std::vector<float> x_vals = {-1.0f, 0.0f, 1.0f};
   std::vector<float> expected_vals = {0.0f, 0.0f, 0.0f};
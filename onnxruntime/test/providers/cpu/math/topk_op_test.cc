@@ -4,6 +4,8 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include <algorithm>
+#include <numeric>
 
 namespace onnxruntime {
 namespace test {
@@ -264,5 +266,37 @@ TEST(TopKOperator, Top1ExplicitAxisMultiDInputOpset10) {
   RunTest(10, 1, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, axis);
 }
 
+// Computes the expected outputs for an input of shape {rows, axis_dim, slices} with values that repeat,
+// so that ties have to be broken by the lower index.
+static void RunTopKReferenceTest(int64_t rows, int64_t axis_dim, int64_t slices, int64_t k) {
+  std::vector<float> input_vals(rows * axis_dim * slices);
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<float>((i * 7) % 23);
+  }
+  std::vector<float> expected_vals(rows * k * slices);
+  std::vector<int64_t> expected_indices(rows * k * slices);
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < slices; ++j) {
+      auto value = [&](int64_t l) { return input_vals[(i * axis_dim + l) * slices + j]; };
+      std::vector<int64_t> order(axis_dim);
+      std::iota(order.begin(), order.end(), int64_t{0});
+      std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) { return value(a) > value(b); });
+      for (int64_t l = 0; l < k; ++l) {
+        expected_vals[(i * k + l) * slices + j] = value(order[l]);
+        expected_indices[(i * k + l) * slices + j] = order[l];
+      }
+    }
+  }
+  RunTest(10, k, input_vals, {rows, axis_dim, slices}, expected_vals, expected_indices, {rows, k, slices}, false, 1);
+}
+
+TEST(TopKOperator, SmallKWithTiesOpset10) {
+  RunTopKReferenceTest(64, 97, 3, 5);
+}
+
+TEST(TopKOperator, LargeKWithTiesOpset10) {
+  RunTopKReferenceTest(8, 301, 2, 100);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
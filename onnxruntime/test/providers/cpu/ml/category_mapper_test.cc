@@ -43,5 +43,20 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, IntToStringManyElements) {
+  const int64_t count = 4096;
+  std::vector<int64_t> dims{count};
+
+  std::vector<int64_t> input;
+  std::vector<std::string> output;
+  static const std::vector<std::string> names = {"default", "One", "Two", "Three"};
+  for (int64_t i = 0; i < count; ++i) {
+    input.push_back(i % 5);
+    output.push_back(names[i % 5 < 4 ? i % 5 : 0]);
+  }
+
+  RunTest(dims, input, output);
+}
 }  // namespace test
 }  // namespace onnxruntime
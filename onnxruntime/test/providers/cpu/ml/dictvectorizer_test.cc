@@ -42,5 +42,23 @@ TEST(MLOpTest, DictVectorizerInt64Input) {
   test.Run();
 }
 
+TEST(MLOpTest, DictVectorizerUnsortedVocabulary) {
+  OpTester test("DictVectorizer", 1, onnxruntime::kMLDomain);
+
+  test.AddAttribute("string_vocabulary", std::vector<std::string>{"d", "b", "a", "e", "a"});
+
+  std::map<std::string, float> map;
+  map["a"] = 1.f;
+  map["c"] = 2.f;
+  map["d"] = 3.f;
+  map["f"] = 4.f;
+
+  test.AddInput<std::string, float>("X", map);
+
+  std::vector<int64_t> dims{1, 5};
+  test.AddOutput<float>("Y", dims, {3.f, 0.f, 1.f, 0.f, 1.f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -168,5 +168,60 @@ TEST(LabelEncoder, Int64ToFloatOpset2) {
   test.Run();
 }
 
+// Enough keys to grow the lookup table several times and enough input to be split over threads.
+TEST(LabelEncoder, StringToInt64ManyKeysOpset2) {
+  const int64_t key_count = 1000;
+  const int64_t input_count = 5000;
+
+  std::vector<std::string> keys;
+  std::vector<std::int64_t> values;
+  for (int64_t i = 0; i < key_count; ++i) {
+    keys.push_back("key" + std::to_string(i));
+    values.push_back(i * 3);
+  }
+  // a repeated key takes the last value, as it did with std::unordered_map
+  keys.push_back("key7");
+  values.push_back(-7);
+
+  std::vector<std::string> input;
+  std::vector<std::int64_t> output;
+  for (int64_t i = 0; i < input_count; ++i) {
+    const int64_t key = (i * 7919) % (key_count + 100);
+    input.push_back("key" + std::to_string(key));
+    output.push_back(key == 7 ? -7 : key < key_count ? key * 3 : -1);
+  }
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+  test.AddAttribute("keys_strings", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  test.AddInput<std::string>("X", {input_count}, input);
+  test.AddOutput<std::int64_t>("Y", {input_count}, output);
+
+  test.Run();
+}
+
+TEST(LabelEncoder, FloatToInt64SignedZeroOpset2) {
+  std::vector<std::int64_t> dims{4};
+
+  std::vector<float> input{-0.0f, 0.0f, 1.0f, -1.0f};
+  std::vector<std::int64_t> output{5, 5, 6, -1};
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  const std::vector<float> keys{0.0f, 1.0f};
+  const std::vector<std::int64_t> values{5, 6};
+
+  test.AddAttribute("keys_floats", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  test.AddInput<float>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
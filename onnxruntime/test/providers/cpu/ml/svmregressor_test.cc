@@ -104,5 +104,29 @@ TEST(MLOpTest, SVMRegressorLinear) {
   test.Run();
 }
 
+TEST(MLOpTest, SVMRegressorSVCSigmoidKernel) {
+  OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
+
+  std::vector<float> dual_coefficients = {0.5f, -1.25f, 0.75f, 1.f};
+  std::vector<float> support_vectors = {1.f, 2.f, 0.5f, -1.f, 0.f, 3.f, 2.f, -2.f, 1.f, 0.f, 1.f, -1.f};
+  std::vector<float> rho = {0.25f};
+  std::vector<float> kernel_params = {0.1f, 0.5f, 3.f};  //gamma, coef0, degree
+
+  std::vector<float> X = {1.f, 0.f, 0.4f, 3.f, -1.f, 2.f, -2.f, 0.5f, 1.f, 0.f, 0.f, 0.f, 1.5f, 2.5f, -0.5f};
+  std::vector<float> predictions = {0.83038208f, 0.59837444f, 0.0056068089f, 0.71211716f, 1.2556572f};
+
+  test.AddAttribute("kernel_type", std::string("SIGMOID"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("n_supports", static_cast<int64_t>(4));
+
+  test.AddInput<float>("X", {5, 3}, X);
+  test.AddOutput<float>("Y", {5, 1}, predictions);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,7 +7,7 @@
 namespace onnxruntime {
 namespace test {
 
-void GenTreeAndRunTest(const std::vector<float>& X, const std::vector<float>& base_values, const std::vector<float>& results, const std::string& aggFunction)
+void GenTreeAndRunTest(const std::vector<float>& X, const std::vector<float>& base_values, const std::vector<float>& results, const std::string& aggFunction, int64_t N = 8)
 {
   OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
 
@@ -51,8 +51,8 @@ void GenTreeAndRunTest(const std::vector<float>& X, const std::vector<float>& ba
   } // default function is SUM
 
   //fill input data
-  test.AddInput<float>("X", {8, 3}, X);
-  test.AddOutput<float>("Y", {8, 2}, results);
+  test.AddInput<float>("X", {N, 3}, X);
+  test.AddOutput<float>("Y", {N, 2}, results);
   test.Run();
 }
 
@@ -77,6 +77,21 @@ TEST(MLOpTest, TreeRegressorMultiTargetMax) {
   GenTreeAndRunTest(X, base_values, results, "MAX");
 }
 
+// Enough rows to span several row blocks, which may be evaluated on different threads.
+TEST(MLOpTest, TreeRegressorMultiTargetManyRows) {
+  std::vector<float> X_block = {1.f, 0.0f, 0.4f, 3.0f, 44.0f, -3.f, 12.0f, 12.9f, -312.f, 23.0f, 11.3f, -222.f, 23.0f, 11.3f, -222.f, 23.0f, 3311.3f, -222.f, 23.0f, 11.3f, -222.f, 43.0f, 413.3f, -114.f};
+  std::vector<float> results_block = {5.f, 28.f, 8.f, 19.f, 7.f, 28.f, 7.f, 28.f, 7.f, 28.f, 7.f, 19.f, 7.f, 28.f, 8.f, 19.f};
+  std::vector<float> base_values{5.f, 5.f};
+  const int64_t repeats = 37;
+  std::vector<float> X;
+  std::vector<float> results;
+  for (int64_t i = 0; i < repeats; ++i) {
+    X.insert(X.end(), X_block.begin(), X_block.end());
+    results.insert(results.end(), results_block.begin(), results_block.end());
+  }
+  GenTreeAndRunTest(X, base_values, results, "MIN", 8 * repeats);
+}
+
 TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
 
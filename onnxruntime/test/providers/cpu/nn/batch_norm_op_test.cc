@@ -513,6 +513,19 @@ TEST(BatchNormTest, InvalidVarDim) {
                 "Invalid input var");
 }
 
+TEST(BatchNormTest, ConstantParameters) {
+  // scale, B, mean and var are initializers, so the kernel folds them when it's created
+  OpTester test("BatchNormalization");
+  test.AddAttribute("epsilon", 0.0f);
+  test.AddInput<float>("X", {2, 2, 1, 3}, {1.0f, 3.0f, 5.0f, -1.0f, 0.0f, 1.0f, -1.0f, 1.0f, 2.0f, -0.5f, 0.25f, -2.0f});
+  test.AddInput<float>("scale", {2}, {1.0f, 2.0f}, true);
+  test.AddInput<float>("B", {2}, {0.0f, 1.0f}, true);
+  test.AddInput<float>("mean", {2}, {1.0f, -1.0f}, true);
+  test.AddInput<float>("var", {2}, {4.0f, 0.25f}, true);
+  test.AddOutput<float>("output", {2, 2, 1, 3}, {0.0f, 1.0f, 2.0f, 1.0f, 5.0f, 9.0f, -1.0f, 0.0f, 0.5f, 3.0f, 6.0f, -3.0f});
+  test.Run();
+}
+
 // Only CUDA kernel has float 16 support
 #ifdef USE_CUDA
 TEST(BatchNormTest, BatchNorm2d_fp16) {
@@ -47,5 +47,36 @@ TEST(ConvIntegerTest_with_padding, ConvIntegerTest) {
   test.Run();
 }
 
+// Two groups, a stride and padding, whose output values are the sums of the windows of each group.
+TEST(ConvIntegerTest, ConvIntegerTest_Group_Stride) {
+  OpTester test("ConvInteger", 10);
+  std::vector<int64_t> x_dims{1, 2, 3, 3};
+  test.AddInput<uint8_t>("x", x_dims,
+                         {2, 3, 4,
+                          5, 6, 7,
+                          8, 9, 10,
+                          1, 1, 1,
+                          1, 1, 1,
+                          1, 1, 1});
+  std::vector<int64_t> w_dims{2, 1, 2, 2};
+  test.AddInput<uint8_t>("w", w_dims,
+                         {2, 2,
+                          2, 2,
+                          3, 3,
+                          3, 3});
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+  test.AddInput<uint8_t>("w_zero_point", {}, {1});
+  test.AddAttribute<int64_t>("group", 2);
+  test.AddAttribute<std::vector<int64_t>>("pads", {1, 1, 1, 1});
+  test.AddAttribute<std::vector<int64_t>>("strides", {2, 2});
+  std::vector<int64_t> y_dims{1, 2, 2, 2};
+  test.AddOutput<int32_t>("y", y_dims,
+                          {1, 5,
+                           11, 28,
+                           0, 0,
+                           0, 0});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
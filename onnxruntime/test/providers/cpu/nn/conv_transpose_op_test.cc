@@ -471,6 +471,33 @@ TEST(ConvTransposeTest, ConvTranspose_2D_Dilation_Group_1) {
   TestConvTransposeOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
 }
 
+TEST(ConvTransposeTest, ConvTranspose_2D_Group_Bias) {
+  ConvTransposeOpAttributes attrs = {
+      vector<int64_t>{2, 2},        // kernel_shape
+      {},                           // output_padding
+      {},                           // output_shape
+      vector<int64_t>{0, 0, 0, 0},  // pads
+      vector<int64_t>{1, 1},        // strides
+      vector<int64_t>{1, 1},        // dilations
+      2                             // group
+  };
+
+  // two output channels per group, each with its own bias
+  vector<float> X = {1.0f, 2.0f};
+  vector<int64_t> X_shape = {1, 2, 1, 1};
+  vector<float> W = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f,
+                     1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f};
+  vector<int64_t> W_shape = {2, 2, 2, 2};
+  vector<float> B = {1.0f, 2.0f, 3.0f, 4.0f};
+  vector<int64_t> B_shape = {4};
+  vector<int64_t> Y_shape = {1, 4, 2, 2};
+  auto expected_vals = {2.0f, 3.0f, 4.0f, 5.0f,
+                        7.0f, 8.0f, 9.0f, 10.0f,
+                        5.0f, 5.0f, 5.0f, 5.0f,
+                        4.0f, 6.0f, 4.0f, 6.0f};
+
+  TestConvTransposeOp(attrs, {X, W, B}, {X_shape, W_shape, B_shape}, expected_vals, Y_shape);
+}
 
 }  // namespace test
 }  // namespace onnxruntime
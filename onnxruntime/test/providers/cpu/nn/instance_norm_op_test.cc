@@ -71,6 +71,19 @@ TEST(InstanceNormalizationOpTest, InstanceNormBatch1) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+TEST(InstanceNormalizationOpTest, InstanceNormLargeMean) {
+  // the variance is small compared to the square of the mean, which the single pass statistics must not lose
+  OpTester test("InstanceNormalization");
+  test.AddAttribute("epsilon", 1e-5F);
+
+  vector<int64_t> input_dims = {1, 1, 5};
+  test.AddInput<float>("input", input_dims, {10001.0F, 10002.0F, 10003.0F, 10004.0F, 10005.0F});
+  test.AddInput<float>("scale", {1}, {1.0F});
+  test.AddInput<float>("B", {1}, {0.0F});
+  test.AddOutput<float>("Y", input_dims, {-1.4142101F, -0.70710504F, 0.0F, 0.70710504F, 1.4142101F});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(InstanceNormalizationOpTest, InstanceNorm_2) {
   OpTester test("InstanceNormalization");
   test.AddAttribute("epsilon", 0.3F);
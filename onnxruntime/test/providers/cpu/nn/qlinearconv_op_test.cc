@@ -105,6 +105,28 @@ TEST(ConvTest, QLinearConv2DTest) {
   test.Run();
 }
 
+TEST(ConvTest, QLinearConv2DBiasTest) {
+  OpTester test("QLinearConv", 10);
+
+  // x - x_zero_point is 0 to 8 and w - w_zero_point is the 2x2 identity, so the accumulators are exact
+  test.AddInput<uint8_t>("x", {1, 1, 3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  test.AddInput<float>("x_scale", {}, {0.5f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {1});
+
+  test.AddInput<uint8_t>("w", {1, 1, 2, 2}, {3, 2, 2, 3});
+  test.AddInput<float>("w_scale", {}, {2.0f});
+  test.AddInput<uint8_t>("w_zero_point", {}, {2});
+
+  test.AddInput<float>("y_scale", {}, {2.0f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {10});
+
+  test.AddInput<int32_t>("b", {1}, {2});
+
+  test.AddOutput<uint8_t>("y", {1, 1, 2, 2}, {13, 14, 16, 17});
+
+  test.Run();
+}
+
 TEST(ConvTest, QLinearConv3DTest) {
   OpTester test("QLinearConv", 10);
 
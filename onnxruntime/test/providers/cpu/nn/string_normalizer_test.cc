@@ -201,5 +201,30 @@ TEST(ContribOpTest, StringNormalizerTest) {
   }
 }
 
+
+TEST(ContribOpTest, StringNormalizerManyStringsTest) {
+  // Enough strings to be split into several blocks that may be normalized on different threads
+  // - case-insensitive approach
+  // - filter out monday
+  // - UPPER
+  const std::vector<std::string> days = {std::string("Monday"), std::string("tuesday"),
+                                         std::string("MONDAY"), std::string("wednesday")};
+  const std::vector<std::string> upper_days = {std::string("TUESDAY"), std::string("WEDNESDAY")};
+  const int64_t repeats = 100;
+
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < repeats; ++i) {
+    input.insert(input.end(), days.cbegin(), days.cend());
+    output.insert(output.end(), upper_days.cbegin(), upper_days.cend());
+  }
+
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "UPPER", false, {"monday"}, test_locale);
+  test.AddInput<std::string>("T", {1, static_cast<int64_t>(input.size())}, input);
+  test.AddOutput<std::string>("Y", {1, static_cast<int64_t>(output.size())}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
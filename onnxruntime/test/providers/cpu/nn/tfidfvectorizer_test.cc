@@ -666,5 +666,33 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// Enough rows to be matched on several threads. The weights apply to the n-grams of the pool
+// in their order, wherever ngram_indexes places them in the output.
+TEST(TfIdfVectorizerTest, Int32_TFIDFWeights_ManyRowsUniAndBigrams_Skip5) {
+  OpTester test("TfIdfVectorizer", opset_ver, domain);
+  // s=5, Min=1, Max=2, weights specified, int32, output indexes reversed
+  InitTestAttr(test, "TFIDF", 1, 2, 5,
+               {0, 4},
+               {6, 5, 4, 3, 2, 1, 0},                //7 output indexes
+               {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0},  // weights
+               {2, 3, 5, 4,                          //1-grams
+                5, 6, 7, 8, 6, 7},                   //bi-grams
+               {});
+
+  const int64_t repeats = 50;
+  std::vector<int32_t> input;
+  std::vector<float> output;
+  for (int64_t i = 0; i < repeats; ++i) {
+    input.insert(input.end(), {1, 1, 3, 3, 3, 7,
+                               8, 6, 7, 5, 6, 8});
+    output.insert(output.end(), {0, 0, 0, 0, 0, 6, 0,
+                                 7, 6, 5, 0, 3, 0, 0});
+  }
+  test.AddInput<int32_t>("T", {2 * repeats, 6}, input);
+  test.AddOutput<float>("Y", {2 * repeats, 7}, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
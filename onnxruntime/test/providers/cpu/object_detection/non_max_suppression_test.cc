@@ -288,6 +288,58 @@ TEST(NonMaxSuppressionOpTest, SelectFromIdenticalBoxes) {
   test.Run();
 }
 
+// More boxes than are sorted at once, with several batches and classes that may be processed on different threads.
+// Boxes 2 * i and 2 * i + 1 are identical, so only the higher scoring box of each pair is selected.
+TEST(NonMaxSuppressionOpTest, ManyBoxesAndClasses) {
+  const int64_t num_batches = 2;
+  const int64_t num_classes = 3;
+  const int64_t num_boxes = 200;
+  const int64_t max_output_boxes_per_class = 80;
+
+  std::vector<float> boxes;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      const float x = static_cast<float>(box / 2) * 2.0f;
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+  }
+
+  // the scores of class 0 decrease with the box index, those of class 1 increase and those of class 2
+  // are all below the score threshold
+  std::vector<float> scores;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      scores.push_back(1.0f - static_cast<float>(box) / 1000.0f);
+    }
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      scores.push_back(static_cast<float>(box + 1) / 1000.0f);
+    }
+    for (int64_t box = 0; box < num_boxes; ++box) {
+      scores.push_back(0.0f);
+    }
+  }
+
+  std::vector<int64_t> selected_indices;
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t i = 0; i < max_output_boxes_per_class; ++i) {
+      selected_indices.insert(selected_indices.end(), {batch, 0, 2 * i});
+    }
+    for (int64_t i = 0; i < max_output_boxes_per_class; ++i) {
+      selected_indices.insert(selected_indices.end(), {batch, 1, num_boxes - 1 - 2 * i});
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 10, kOnnxDomain);
+  test.AddInput<float>("boxes", {num_batches, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {num_batches, num_classes, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {max_output_boxes_per_class});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {static_cast<int64_t>(selected_indices.size() / 3), 3},
+                          selected_indices);
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 6, 4},
@@ -135,6 +135,49 @@ TEST(RoiAlignTest, MaxModePositive) {
   test.Run();
 }
 
+TEST(RoiAlignTest, AvgModeManyRoisAndChannels) {
+  // every channel of X is constant, so the average of the samples of any ROI inside the image is that constant
+  const int64_t N = 2;
+  const int64_t C = 7;
+  const int64_t H = 8;
+  const int64_t W = 8;
+  const int64_t num_rois = 12;
+  const int64_t output_height = 3;
+  const int64_t output_width = 2;
+
+  OpTester test("RoiAlign", 10);
+  test.AddAttribute<int64_t>("output_height", output_height);
+  test.AddAttribute<int64_t>("output_width", output_width);
+  test.AddAttribute<int64_t>("sampling_ratio", 0);
+  test.AddAttribute<float>("spatial_scale", 1.0f);
+
+  std::vector<float> X;
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t c = 0; c < C; ++c) {
+      X.insert(X.end(), H * W, static_cast<float>(n * 10 + c));
+    }
+  }
+
+  std::vector<float> rois;
+  std::vector<int64_t> batch_indices;
+  std::vector<float> Y;
+  for (int64_t i = 0; i < num_rois; ++i) {
+    const float start = static_cast<float>(i % 3);
+    const float end = start + 1.5f + static_cast<float>(i % 4);
+    rois.insert(rois.end(), {start, start * 0.5f, end, end});
+    batch_indices.push_back(i % N);
+    for (int64_t c = 0; c < C; ++c) {
+      Y.insert(Y.end(), output_height * output_width, static_cast<float>((i % N) * 10 + c));
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("rois", {num_rois, 4}, rois);
+  test.AddInput<int64_t>("batch_indices", {num_rois}, batch_indices);
+  test.AddOutput<float>("Y", {num_rois, C, output_height, output_width}, Y);
+  test.Run();
+}
+
 TEST(RoiAlignTest, AvgModeNegativeInvalidMode) {
   OpTester test("RoiAlign", 10);
   test.AddAttribute<std::string>("mode", "foobar"); // <-- failure condition
@@ -515,6 +515,58 @@ TEST(ReductionOpTest, ReduceMean_default_axes_keepdims) {
   test.Run();
 }
 
+// Large enough for the reduction to be split across the operator thread pool.
+TEST(ReductionOpTest, ReduceMean_leading_and_trailing_axes_large) {
+  const int64_t rows = 64;
+  const int64_t cols = 1024;
+  std::vector<float> data(rows * cols);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      data[r * cols + c] = static_cast<float>((r * 7 + c * 3) % 11);
+    }
+  }
+
+  std::vector<float> row_means(rows, 0.0f);
+  std::vector<float> col_means(cols, 0.0f);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      row_means[r] += data[r * cols + c] / cols;
+      col_means[c] += data[r * cols + c] / rows;
+    }
+  }
+
+  OpTester trailing("ReduceMean");
+  trailing.AddAttribute("axes", std::vector<int64_t>{-1});
+  trailing.AddAttribute("keepdims", (int64_t)1);
+  trailing.AddInput<float>("data", {rows, cols}, data);
+  trailing.AddOutput<float>("reduced", {rows, 1}, row_means);
+  trailing.Run();
+
+  OpTester leading("ReduceMean");
+  leading.AddAttribute("axes", std::vector<int64_t>{0});
+  leading.AddAttribute("keepdims", (int64_t)0);
+  leading.AddInput<float>("data", {rows, cols}, data);
+  leading.AddOutput<float>("reduced", {cols}, col_means);
+  leading.Run();
+}
+
+TEST(ReductionOpTest, ReduceMax_leading_axes) {
+  OpTester test("ReduceMax");
+  test.AddAttribute("axes", std::vector<int64_t>{0, 1});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {3, 2, 2},
+                       {5.0f, 1.0f,
+                        20.0f, 2.0f,
+
+                        30.0f, 1.0f,
+                        40.0f, 2.0f,
+
+                        55.0f, 1.0f,
+                        60.0f, -2.0f});
+  test.AddOutput<float>("reduced", {1, 1, 2}, {60.0f, 2.0f});
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceMean_do_not_keepdims) {
   OpTester test("ReduceMean");
   test.AddAttribute("axes", std::vector<int64_t>{1});
@@ -1152,6 +1204,35 @@ TEST(ReductionOpTest, ArgMax2D) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider}); //TensorRT: axis must be 0
 }
 
+// Repeating values, so that the first index has to win the ties, over a middle axis and over a long last axis.
+TEST(ReductionOpTest, ArgMax_ties_large) {
+  auto run = [](int64_t outer, int64_t axis_dim, int64_t inner) {
+    std::vector<float> data(outer * axis_dim * inner);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<float>((i * 7) % 13);
+    }
+    std::vector<int64_t> expected(outer * inner, 0);
+    for (int64_t o = 0; o < outer; ++o) {
+      for (int64_t j = 0; j < inner; ++j) {
+        for (int64_t l = 1; l < axis_dim; ++l) {
+          if (data[(o * axis_dim + l) * inner + j] > data[(o * axis_dim + expected[o * inner + j]) * inner + j]) {
+            expected[o * inner + j] = l;
+          }
+        }
+      }
+    }
+
+    OpTester test("ArgMax");
+    test.AddAttribute("axis", (int64_t)1);
+    test.AddAttribute("keepdims", (int64_t)0);
+    test.AddInput<float>("data", {outer, axis_dim, inner}, data);
+    test.AddOutput<int64_t>("reduced", {outer, inner}, expected);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  //TensorRT: axis must be 0
+  };
+  run(4, 37, 70);
+  run(3, 5000, 1);
+}
+
 TEST(ReductionOpTest, ArgMin) {
   OpTester test("ArgMin");
   test.AddAttribute("axis", (int64_t)0);
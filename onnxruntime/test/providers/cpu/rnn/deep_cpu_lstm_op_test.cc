@@ -46,7 +46,8 @@ static void RunLstmTest(const std::vector<float>& X_data,
                         std::vector<string> activations = {},
                         std::vector<float> activation_alphas = {},
                         std::vector<float> activation_betas = {},
-                        bool hasClip = true) {
+                        bool hasClip = true,
+                        bool is_initializer_R = false) {
   OpTester test("LSTM");
 
   int num_directions = (direction == "bidirectional") ? 2 : 1;
@@ -79,7 +80,7 @@ static void RunLstmTest(const std::vector<float>& X_data,
 
   test.AddInput<float>("X", X_dims, X_data);
   test.AddInput<float>("W", W_dims, W_data);
-  test.AddInput<float>("R", R_dims, R_data);
+  test.AddInput<float>("R", R_dims, R_data, is_initializer_R);
 
   if (B_data) {
     std::vector<int64_t> B_dims = {num_directions, 8 * hidden_size};
@@ -178,6 +179,12 @@ void SimpleWeightsNoBiasTwoRows(std::string direction,
     RunLstmTest(X_data, W_data, R_data, Y_data, Y_h_data, Y_c_data,
                 input_size, batch_size, hidden_size, seq_length,
                 nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 999.f, /* output_sequence*/ false);
+
+  // a constant R is packed when the kernel is created
+  RunLstmTest(X_data, W_data, R_data, Y_data, Y_h_data, Y_c_data,
+              input_size, batch_size, hidden_size, seq_length,
+              nullptr, nullptr, nullptr, nullptr, seq_lengths, direction, 9999.f, true, false,
+              {}, {}, {}, true, /* is_initializer_R */ true);
 }
 
 TEST(LSTMTest, ForwardSimpleWeightsNoBiasTwoRows) {
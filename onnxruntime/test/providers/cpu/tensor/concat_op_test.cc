@@ -233,5 +233,61 @@ TEST(ConcatOpTest, Concat3D_3) {
   test.Run();
 }
 
+// Large enough for the copies of each input to be split over several threads.
+TEST(ConcatOpTest, Concat2D_Large) {
+  OpTester test("Concat");
+  test.AddAttribute("axis", int64_t{1});
+
+  const int64_t rows = 300, cols1 = 700, cols2 = 300;
+  std::vector<int32_t> input1(rows * cols1), input2(rows * cols2), output;
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols1; ++c) {
+      input1[r * cols1 + c] = static_cast<int32_t>(r * 10000 + c);
+      output.push_back(input1[r * cols1 + c]);
+    }
+    for (int64_t c = 0; c < cols2; ++c) {
+      input2[r * cols2 + c] = static_cast<int32_t>(-(r * 10000 + c));
+      output.push_back(input2[r * cols2 + c]);
+    }
+  }
+  test.AddInput<int32_t>("input1", {rows, cols1}, input1);
+  test.AddInput<int32_t>("input2", {rows, cols2}, input2);
+  test.AddOutput<int32_t>("concat_result", {rows, cols1 + cols2}, output);
+  test.Run();
+}
+
+// Inputs of different widths, some of them empty, with fewer and more inputs than the CUDA kernel takes in its
+// parameters.
+TEST(ConcatOpTest, Concat2D_ManyInputs) {
+  for (int input_count : {40, 70}) {
+    OpTester test("Concat");
+    test.AddAttribute("axis", int64_t{1});
+
+    const int64_t rows = 3;
+    std::vector<std::vector<float>> inputs(input_count);
+    int64_t output_cols = 0;
+    for (int i = 0; i < input_count; ++i) {
+      const int64_t cols = i % 5;
+      for (int64_t r = 0; r < rows; ++r) {
+        for (int64_t c = 0; c < cols; ++c) {
+          inputs[i].push_back(static_cast<float>(i * 100 + r * 10 + c));
+        }
+      }
+      test.AddInput<float>(("input" + std::to_string(i)).c_str(), {rows, cols}, inputs[i]);
+      output_cols += cols;
+    }
+
+    std::vector<float> output;
+    for (int64_t r = 0; r < rows; ++r) {
+      for (int i = 0; i < input_count; ++i) {
+        const int64_t cols = i % 5;
+        output.insert(output.end(), inputs[i].begin() + r * cols, inputs[i].begin() + (r + 1) * cols);
+      }
+    }
+    test.AddOutput<float>("concat_result", {rows, output_cols}, output);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -274,6 +274,21 @@ TEST(GatherOpTest, Gather_axis1_indices2d_string) {
   test.Run();
 }
 
+TEST(GatherOpTest, Gather_axis0_string_rows) {
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<std::string>("data", {3, 2},
+                             {"0", "1",
+                              "10", "11",
+                              "20", "21"});
+  test.AddInput<int64_t>("indices", {3}, {2LL, 0LL, 2LL});
+  test.AddOutput<std::string>("output", {3, 2},
+                              {"20", "21",
+                               "0", "1",
+                               "20", "21"});
+  test.Run();
+}
+
 TEST(GatherOpTest, Gather_axis1_indices2d_bool) {
   OpTester test("Gather");
   test.AddAttribute<int64_t>("axis", 1LL);
@@ -305,5 +320,40 @@ TEST(GatherOpTest, Gather_perf) {
   test.AddOutput<int32_t>("output", {800, 1, 100}, output);
   test.Run();
 }
+
+// Embedding lookups with enough indices to be split over threads, for each of the fixed row sizes that have
+// their own copy loop and for a row size that doesn't.
+template <typename T>
+static void RunGatherRowsTest(int64_t row_size) {
+  const int64_t row_count = 97;
+  const int64_t index_count = 3000;
+  std::vector<T> data(static_cast<size_t>(row_count * row_size));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<T>(i % 251);
+  }
+  std::vector<int32_t> indices(static_cast<size_t>(index_count));
+  std::vector<T> output;
+  for (int64_t i = 0; i < index_count; ++i) {
+    indices[i] = static_cast<int32_t>((i * 37 + 11) % row_count);
+    output.insert(output.end(), data.begin() + indices[i] * row_size, data.begin() + (indices[i] + 1) * row_size);
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<T>("data", {row_count, row_size}, data);
+  test.AddInput<int32_t>("indices", {index_count}, indices);
+  test.AddOutput<T>("output", {index_count, row_size}, output);
+  test.Run();
+}
+
+TEST(GatherOpTest, Gather_many_indices) {
+  RunGatherRowsTest<uint8_t>(1);
+  RunGatherRowsTest<uint8_t>(2);
+  RunGatherRowsTest<float>(1);
+  RunGatherRowsTest<float>(2);
+  RunGatherRowsTest<float>(4);
+  RunGatherRowsTest<float>(3);
+  RunGatherRowsTest<float>(64);
+}
 }  // namespace test
 }  // namespace onnxruntime
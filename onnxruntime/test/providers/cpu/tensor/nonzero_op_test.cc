@@ -93,5 +93,33 @@ TEST(NonZeroOpTest, EmptyInput) {
   test.Run();
 }
 
+TEST(NonZeroOpTest, LargeInput) {
+  // large enough for the input to be split into blocks
+  OpTester test{kOpName, kOpVersion};
+
+  const int64_t rows = 300;
+  const int64_t columns = 200;
+  std::vector<int32_t> X(rows * columns);
+  std::vector<int64_t> row_indices;
+  std::vector<int64_t> column_indices;
+  for (int64_t i = 0; i < rows; ++i) {
+    for (int64_t j = 0; j < columns; ++j) {
+      const bool non_zero = (i * 31 + j * 17) % 11 == 0;
+      X[i * columns + j] = non_zero ? static_cast<int32_t>(i + j + 1) : 0;
+      if (non_zero) {
+        row_indices.push_back(i);
+        column_indices.push_back(j);
+      }
+    }
+  }
+
+  std::vector<int64_t> Y(row_indices);
+  Y.insert(Y.end(), column_indices.begin(), column_indices.end());
+
+  test.AddInput<int32_t>("X", {rows, columns}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(row_indices.size())}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -163,5 +163,18 @@ TEST(TensorOpTest, Pad_Reflect_2D) {
   test.Run();
 }
 
+TEST(TensorOpTest, Pad_Constant_2D_negative_begin) {
+  OpTester test("Pad");
+
+  test.AddAttribute("pads", std::vector<int64_t>{-1, 1, 0, -1});
+  test.AddAttribute("value", 1234.0f);
+  test.AddInput<float>("data", {2, 3},
+                       {11.0f, 21.0f, 31.0f,
+                        12.0f, 22.0f, 32.0f});
+  test.AddOutput<float>("output", {1, 3},
+                        {1234.0f, 12.0f, 22.0f});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -166,6 +166,28 @@ TEST(ResizeOpTest, ResizeOpNearestUpSampleTest) {
   test.Run();
 }
 
+TEST(ResizeOpTest, ResizeOpNearestUpSampleTest_NHWC) {
+  OpTester test("Resize", 10);
+  std::vector<float> scales{1.0f, 2.0f, 2.0f, 1.0f};
+
+  test.AddAttribute("mode", "nearest");
+
+  const int64_t N = 1, H = 2, W = 2, C = 3;
+  std::vector<float> X = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f,
+                          7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f};
+
+  test.AddInput<float>("X", {N, H, W, C}, X);
+  test.AddInput<float>("scales", {4}, scales);
+
+  std::vector<float> Y = {1.0f, 2.0f, 3.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 4.0f, 5.0f, 6.0f,
+                          1.0f, 2.0f, 3.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 4.0f, 5.0f, 6.0f,
+                          7.0f, 8.0f, 9.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 10.0f, 11.0f, 12.0f,
+                          7.0f, 8.0f, 9.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 10.0f, 11.0f, 12.0f};
+
+  test.AddOutput<float>("Y", {N, (int64_t)(H * scales[1]), (int64_t)(W * scales[2]), C}, Y);
+  test.Run();
+}
+
 TEST(UpsampleOpTest, ResizeOpNearestNoScaleTest) {
   OpTester test("Resize", 10);
   std::vector<float> scales{1.0f, 1.0f, 1.0f, 1.0f};
@@ -528,5 +528,29 @@ TEST(SliceTest, OptionalAxesInputAloneMissing) {
   testv10.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+TEST(SliceTest, Slice2D_WithNegativeSteps_Large) {
+  const int64_t rows = 400, cols = 500;
+  std::vector<float> input(rows * cols);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i);
+  }
+  // every row in reverse, every second column from the last one
+  std::vector<float> output;
+  for (int64_t r = rows - 1; r >= 0; --r) {
+    for (int64_t c = cols - 1; c >= 0; c -= 2) {
+      output.push_back(input[r * cols + c]);
+    }
+  }
+  RunSliceTest<float>({rows, cols},
+                      input,
+                      {-1, -1},
+                      {-rows - 1, -cols - 1},
+                      {0, 1},
+                      {-1, -2},
+                      {rows, cols / 2},
+                      output,
+                      true);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
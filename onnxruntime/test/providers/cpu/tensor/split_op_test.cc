@@ -498,5 +498,34 @@ SplitAxis2()
 SplitMiddleDimension()
 
 */
+// Outputs of different widths, with fewer and more outputs than the CUDA kernel takes in its parameters.
+TEST(SplitOperatorTest, Axis1ManyOutputs) {
+  for (int output_count : {40, 70}) {
+    const int64_t rows = 3;
+    std::vector<int64_t> split_sizes;
+    std::vector<std::vector<float>> output_data(output_count);
+    std::vector<float> input_data;
+    for (int i = 0; i < output_count; ++i) {
+      split_sizes.push_back(1 + i % 4);
+    }
+    for (int64_t r = 0; r < rows; ++r) {
+      for (int i = 0; i < output_count; ++i) {
+        for (int64_t c = 0; c < split_sizes[i]; ++c) {
+          const float value = static_cast<float>(i * 100 + r * 10 + c);
+          input_data.push_back(value);
+          output_data[i].push_back(value);
+        }
+      }
+    }
+
+    std::vector<ShapeAndFloatData> outputs;
+    for (int i = 0; i < output_count; ++i) {
+      outputs.push_back({{rows, split_sizes[i]}, output_data[i]});
+    }
+    const int64_t cols = static_cast<int64_t>(input_data.size()) / rows;
+    RunTest<float>(1, split_sizes, {{rows, cols}, input_data}, outputs);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
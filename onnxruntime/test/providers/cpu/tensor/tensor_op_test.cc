@@ -262,6 +262,45 @@ TEST(TensorOpTest, CastFromFloat16) {
   TestCastOp(input, int64_t_data, shape, TensorProto::INT64);
 }
 
+TEST(TensorOpTest, CastToFloat16Rounding) {
+  // 20 elements so both the vectorized loop and the scalar tail of the conversion are used
+  const std::vector<int64_t> shape{20};
+  std::initializer_list<float> float_data = {
+      1.00048828125f, 1.00146484375f, 65504.0f, 65520.0f, -1e10f, std::numeric_limits<float>::infinity(),
+      5.9604644775390625e-8f, 2.98023223876953125e-8f, -0.0f, 0.1f, 8.9406967163085938e-8f, -65519.0f,
+      0.0f, 1.0f, -2.0f, 0.5f, 1.0009765625f, 1024.0f, 6.103515625e-5f, -3.0517578125e-5f};
+  const std::initializer_list<MLFloat16> float16_output{
+      MLFloat16(uint16_t(0x3C00)), MLFloat16(uint16_t(0x3C02)), MLFloat16(uint16_t(0x7BFF)),
+      MLFloat16(uint16_t(0x7C00)), MLFloat16(uint16_t(0xFC00)), MLFloat16(uint16_t(0x7C00)),
+      MLFloat16(uint16_t(0x0001)), MLFloat16(uint16_t(0x0000)), MLFloat16(uint16_t(0x8000)),
+      MLFloat16(uint16_t(0x2E66)), MLFloat16(uint16_t(0x0002)), MLFloat16(uint16_t(0xFBFF)),
+      MLFloat16(uint16_t(0x0000)), MLFloat16(uint16_t(0x3C00)), MLFloat16(uint16_t(0xC000)),
+      MLFloat16(uint16_t(0x3800)), MLFloat16(uint16_t(0x3C01)), MLFloat16(uint16_t(0x6400)),
+      MLFloat16(uint16_t(0x0400)), MLFloat16(uint16_t(0x8200))};
+  TestCastOp(float_data, float16_output, shape, TensorProto::FLOAT16);
+  TestCastOp(float16_output, std::initializer_list<float>{
+      1.0f, 1.001953125f, 65504.0f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::infinity(), 5.9604644775390625e-8f, 0.0f, -0.0f, 0.0999755859375f,
+      1.1920928955078125e-7f, -65504.0f, 0.0f, 1.0f, -2.0f, 0.5f, 1.0009765625f, 1024.0f, 6.103515625e-5f,
+      -3.0517578125e-5f}, shape, TensorProto::FLOAT);
+}
+
+TEST(TensorOpTest, CastUInt8ToFloat) {
+  const std::vector<int64_t> shape{5, 7};
+  std::vector<uint8_t> uint8_data(35);
+  std::vector<float> float_output(35);
+  for (size_t i = 0; i < uint8_data.size(); ++i) {
+    uint8_data[i] = static_cast<uint8_t>(i * 7 + 3);
+    float_output[i] = static_cast<float>(uint8_data[i]);
+  }
+
+  OpTester test("Cast", 9);
+  test.AddAttribute("to", int64_t(TensorProto::FLOAT));
+  test.AddInput<uint8_t>("input", shape, uint8_data);
+  test.AddOutput<float>("output", shape, float_output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(TensorOpTest, CastFromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   std::initializer_list<std::string> string_data = {"-inf", "+INF", "2.0f", "3.0f", "4.0f", "5.0f", "NaN", "nan"};
@@ -205,5 +205,81 @@ TEST(TransposeOpTest, NHWC2NCHW) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Compare against a reference transpose for shapes large enough to exercise the tiled kernels
+// used for permutations that are batched 2D transposes.
+template <class T>
+void TransposeReferenceTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; i++) {
+    expected_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; i--) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  const int64_t size = input_strides[0] * input_shape[0];
+
+  std::vector<T> input_vals(size);
+  for (int64_t i = 0; i < size; i++) {
+    input_vals[i] = static_cast<T>(i);
+  }
+
+  std::vector<T> expected_vals(size);
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < size; i++) {
+    int64_t offset = 0;
+    for (size_t j = 0; j < rank; j++) {
+      offset += index[j] * input_strides[perm[j]];
+    }
+    expected_vals[i] = input_vals[offset];
+    for (size_t j = rank; j-- > 0;) {
+      if (++index[j] < expected_shape[j]) break;
+      index[j] = 0;
+    }
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", expected_shape, expected_vals);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(TransposeOpTest, BatchedTwoDimFloat) {
+  TransposeReferenceTest<float>({37, 21}, {1, 0});
+  TransposeReferenceTest<float>({2, 5, 3, 9}, {0, 2, 3, 1});
+  TransposeReferenceTest<float>({2, 7, 11, 6}, {0, 3, 1, 2});
+  TransposeReferenceTest<float>({1, 9, 35, 1}, {3, 2, 0, 1});
+}
+
+TEST(TransposeOpTest, BatchedTwoDimWithTrailingItem) {
+  // The trailing axis keeps its position, so pairs of floats are moved as 8 byte items.
+  TransposeReferenceTest<float>({7, 6, 2}, {1, 0, 2});
+  TransposeReferenceTest<float>({3, 5, 9, 2}, {0, 2, 1, 3});
+}
+
+TEST(TransposeOpTest, BatchedTwoDimMultipleTiles) {
+  // NCHW <-> NHWC with N > 1 and matrices spanning several tiles, with partial ones at the edges
+  TransposeReferenceTest<float>({3, 67, 5, 9}, {0, 2, 3, 1});
+  TransposeReferenceTest<float>({2, 7, 9, 70}, {0, 3, 1, 2});
+  TransposeReferenceTest<double>({2, 33, 40}, {0, 2, 1});
+}
+
+TEST(TransposeOpTest, AttentionHeads0213) {
+  // the heads of attention, [batch, sequence, heads, head size] <-> [batch, heads, sequence, head size]
+  TransposeReferenceTest<float>({2, 7, 4, 16}, {0, 2, 1, 3});
+  TransposeReferenceTest<float>({2, 5, 3, 3}, {0, 2, 1, 3});
+  TransposeReferenceTest<double>({1, 6, 2, 8}, {0, 2, 1, 3});
+}
+
+TEST(TransposeOpTest, BatchedTwoDimInt64) {
+  TransposeReferenceTest<int64_t>({13, 17}, {1, 0});
+  TransposeReferenceTest<int64_t>({3, 10, 6}, {0, 2, 1});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -109,5 +109,47 @@ TEST(WhereOpTest, Broadcast) {
   WhereBroadcastTest<std::string>("true", "false");
 }
 
+TEST(WhereOpTest, BroadcastDistinctValues) {
+  // condition, X and Y each broadcast along different axes, and Y has a lower rank
+  OpTester test{kOpName, kOpVersion};
+
+  const std::initializer_list<bool> condition = {true, false, false, true, false, true, true, false};
+  std::vector<float> X(6);
+  std::vector<float> Y(4);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(10 + i);
+  }
+  for (size_t i = 0; i < Y.size(); ++i) {
+    Y[i] = static_cast<float>(-1 - static_cast<int>(i));
+  }
+
+  std::vector<float> result;
+  for (int64_t i = 0; i < 2; ++i) {
+    for (int64_t j = 0; j < 3; ++j) {
+      for (int64_t k = 0; k < 4; ++k) {
+        result.push_back(condition.begin()[i * 4 + k] ? X[i * 3 + j] : Y[k]);
+      }
+    }
+  }
+
+  test.AddInput<bool>("condition", {2, 1, 4}, condition);
+  test.AddInput<float>("X", {2, 3, 1}, X);
+  test.AddInput<float>("Y", {4}, Y);
+  test.AddOutput<float>("output", {2, 3, 4}, result);
+
+  test.Run();
+}
+
+TEST(WhereOpTest, IncompatibleShapes) {
+  OpTester test{kOpName, kOpVersion};
+
+  test.AddInput<bool>("condition", {2}, {true, false});
+  test.AddInput<float>("X", {3}, {1.0f, 2.0f, 3.0f});
+  test.AddInput<float>("Y", {1}, {0.0f});
+  test.AddOutput<float>("output", {3}, {0.0f, 0.0f, 0.0f});
+
+  test.Run(OpTester::ExpectResult::kExpectFailure, "can not be broadcast");
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <thread>
 #include "core/session/inference_session.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/framework/test_utils.h"
@@ -24,7 +25,8 @@ void VerifyOutputs(const std::vector<OrtValue>& fetches, const std::vector<int64
   ASSERT_EQ(expected_values, found);
 }
 
-TEST(TensorrtExecutionProviderTest, FunctionTest) {
+// M = X + Y + Z, the batch dimension is symbolic if symbolic_batch is true
+static void CreateAddModel(const std::string& model_file_name, bool symbolic_batch = false) {
   onnxruntime::Model model("graph_1");
   auto& graph = model.MainGraph();
   std::vector<onnxruntime::NodeArg*> inputs;
@@ -33,7 +35,11 @@ TEST(TensorrtExecutionProviderTest, FunctionTest) {
   // FLOAT tensor.
   ONNX_NAMESPACE::TypeProto float_tensor;
   float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
-  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  if (symbolic_batch) {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  } else {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  }
   float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
   float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
 
@@ -56,11 +62,16 @@ TEST(TensorrtExecutionProviderTest, FunctionTest) {
 
   auto status = graph.Resolve();
   ASSERT_TRUE(status.IsOK());
-  std::string model_file_name = "trt_execution_provider_test_graph.onnx";
   status = onnxruntime::Model::Save(model, model_file_name);
+  ASSERT_TRUE(status.IsOK());
+}
 
-  std::vector<int64_t> dims_mul_x = {1, 3, 2};
-  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+static void RunAddModel(InferenceSession& session_object, const std::string& logid, int64_t batch_size = 1) {
+  std::vector<int64_t> dims_mul_x = {batch_size, 3, 2};
+  std::vector<float> values_mul_x;
+  for (int64_t i = 0; i < batch_size; ++i) {
+    values_mul_x.insert(values_mul_x.end(), {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  }
   OrtValue ml_value_x;
   CreateMLValue<float>(TestTensorrtExecutionProvider()->GetAllocator(0, OrtMemTypeCPU), dims_mul_x, values_mul_x, &ml_value_x);
   OrtValue ml_value_y;
@@ -78,29 +89,114 @@ TEST(TensorrtExecutionProviderTest, FunctionTest) {
   std::vector<OrtValue> fetches;
 
   // prepare expected inputs and outputs
-  std::vector<int64_t> expected_dims_mul_m = {1, 3, 2};
-  std::vector<float> expected_values_mul_m = {3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f};
+  std::vector<int64_t> expected_dims_mul_m = dims_mul_x;
+  std::vector<float> expected_values_mul_m;
+  for (float value : values_mul_x) {
+    expected_values_mul_m.push_back(3.0f * value);
+  }
 
-  SessionOptions so;
-  so.session_logid = "TensorrtExecutionProviderTest.FunctionTest";
   RunOptions run_options;
-  run_options.run_tag = so.session_logid;
+  run_options.run_tag = logid;
+
+  // Now run
+  auto status = session_object.Run(run_options, feeds, output_names, &fetches);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
+}
 
+static void RunAddModel(const std::string& model_file_name, const std::string& logid,
+                        const TensorrtExecutionProviderInfo& epi) {
+  SessionOptions so;
+  so.session_logid = logid;
   InferenceSession session_object{so};
 
-  TensorrtExecutionProviderInfo epi;
-  epi.device_id = 0;
   EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<::onnxruntime::TensorrtExecutionProvider>(epi)).IsOK());
 
-  status = session_object.Load(model_file_name);
+  auto status = session_object.Load(model_file_name);
   ASSERT_TRUE(status.IsOK());
   status = session_object.Initialize();
   ASSERT_TRUE(status.IsOK());
 
-  // Now run
-  status = session_object.Run(run_options, feeds, output_names, &fetches);
-  ASSERT_TRUE(status.IsOK());
-  VerifyOutputs(fetches, expected_dims_mul_m, expected_values_mul_m);
+  RunAddModel(session_object, logid);
+}
+
+TEST(TensorrtExecutionProviderTest, FunctionTest) {
+  std::string model_file_name = "trt_execution_provider_test_graph.onnx";
+  CreateAddModel(model_file_name);
+
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  RunAddModel(model_file_name, "TensorrtExecutionProviderTest.FunctionTest", epi);
+}
+
+TEST(TensorrtExecutionProviderTest, Fp16Test) {
+  std::string model_file_name = "trt_execution_provider_fp16_test_graph.onnx";
+  CreateAddModel(model_file_name);
+
+  // the sums are exact in fp16, which is ignored if the GPU has no fast fp16
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.fp16_enable = true;
+  RunAddModel(model_file_name, "TensorrtExecutionProviderTest.Fp16Test", epi);
+}
+
+TEST(TensorrtExecutionProviderTest, EngineCacheTest) {
+  std::string model_file_name = "trt_execution_provider_engine_cache_test_graph.onnx";
+  CreateAddModel(model_file_name);
+
+  // the first session builds and caches the engine, the second one deserializes it
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  epi.engine_cache_path = ".";
+  RunAddModel(model_file_name, "TensorrtExecutionProviderTest.EngineCacheTest_build", epi);
+  RunAddModel(model_file_name, "TensorrtExecutionProviderTest.EngineCacheTest_load", epi);
+}
+
+TEST(TensorrtExecutionProviderTest, DynamicBatchTest) {
+  std::string model_file_name = "trt_execution_provider_dynamic_batch_test_graph.onnx";
+  CreateAddModel(model_file_name, true);
+
+  SessionOptions so;
+  so.session_logid = "TensorrtExecutionProviderTest.DynamicBatchTest";
+  InferenceSession session_object{so};
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<::onnxruntime::TensorrtExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the engine built for max batch size 1 is replaced by one for max batch size 4, which runs the next batches
+  RunAddModel(session_object, so.session_logid, 1);
+  RunAddModel(session_object, so.session_logid, 3);
+  RunAddModel(session_object, so.session_logid, 2);
+  RunAddModel(session_object, so.session_logid, 4);
+}
+
+TEST(TensorrtExecutionProviderTest, ConcurrentRunTest) {
+  std::string model_file_name = "trt_execution_provider_concurrent_run_test_graph.onnx";
+  CreateAddModel(model_file_name, true);
+
+  SessionOptions so;
+  so.session_logid = "TensorrtExecutionProviderTest.ConcurrentRunTest";
+  InferenceSession session_object{so};
+  TensorrtExecutionProviderInfo epi;
+  epi.device_id = 0;
+  EXPECT_TRUE(session_object.RegisterExecutionProvider(std::make_unique<::onnxruntime::TensorrtExecutionProvider>(epi)).IsOK());
+  ASSERT_TRUE(session_object.Load(model_file_name).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the threads run the engine on their own execution contexts
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&session_object, &so, i]() {
+      for (int j = 0; j < 10; ++j) {
+        RunAddModel(session_object, so.session_logid, 1 + (i + j) % 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
 }
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,7 @@ import os
 import numpy as np
 import onnxruntime as onnxrt
 import threading
+import time
 
 class TestInferenceSession(unittest.TestCase):
 
@@ -80,6 +81,30 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelAsync(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        futures = [sess.run_async(["Y"], {"X": x * i}) for i in range(1, 4)]
+        for i, future in enumerate(futures, 1):
+            res = future.result(timeout=60)
+            np.testing.assert_allclose(np.square(x * i), res[0], rtol=1e-05, atol=1e-08)
+
+        future = sess.run_async(["Y"], {"X": np.zeros((2, 2), dtype=np.float32)})
+        self.assertRaises(RuntimeError, future.result, 60)
+
+    def testRunIter(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        results = list(sess.run_iter(["Y"], ({"X": x * i} for i in range(1, 5))))
+        self.assertEqual(len(results), 4)
+        for i, res in enumerate(results, 1):
+            np.testing.assert_allclose(np.square(x * i), res[0], rtol=1e-05, atol=1e-08)
+
+        self.assertEqual(list(sess.run_iter(["Y"], [])), [])
+        outputs = sess.run_iter(["Y"], [{"X": x}, {"X": np.zeros((2, 2), dtype=np.float32)}])
+        np.testing.assert_allclose(np.square(x), next(outputs)[0], rtol=1e-05, atol=1e-08)
+        self.assertRaises(Exception, next, outputs)
+
     def testRunModelFromBytes(self):
         with open(self.get_name("mul_1.onnx"), "rb") as f:
             content = f.read()
@@ -99,6 +124,58 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunPrepared(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        prepared = sess.prepare_run(["X"], ["Y"])
+        self.assertEqual(prepared.input_names, ["X"])
+        self.assertEqual(prepared.output_names, ["Y"])
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        for _ in range(2):
+            x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+            res = sess.run_prepared(prepared, [x])
+            np.testing.assert_allclose(
+                output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunWithIOBinding(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        binding = sess.io_binding()
+        binding.bind_input("X", x)
+        binding.bind_output("Y")
+        sess.run_with_iobinding(binding)
+        np.testing.assert_allclose(
+            output_expected, binding.copy_outputs_to_cpu()[0], rtol=1e-05, atol=1e-08)
+
+        # the Runs write into the bound array
+        y = np.zeros((3, 2), dtype=np.float32)
+        binding.clear_binding_outputs()
+        binding.bind_output_array("Y", y)
+        for _ in range(2):
+            sess.run_with_iobinding(binding)
+            np.testing.assert_allclose(output_expected, y, rtol=1e-05, atol=1e-08)
+
+    def testRunModelZeroCopy(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+
+        # a non contiguous input is made contiguous before it's wrapped
+        x = np.array([[1.0, 3.0, 5.0], [2.0, 4.0, 6.0]], dtype=np.float32).T
+        self.assertFalse(x.flags['C_CONTIGUOUS'])
+        res = sess.run(["Y"], {"X": x})
+        np.testing.assert_allclose(
+            output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+        # the output owns the buffer of the tensor, and outlives the session
+        self.assertIsNotNone(res[0].base)
+        del sess
+        np.testing.assert_allclose(
+            output_expected, res[0], rtol=1e-05, atol=1e-08)
+
     def testRunModel2(self):
         sess = onnxrt.InferenceSession(self.get_name("matmul_1.onnx"))
         x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
@@ -132,6 +209,32 @@ class TestInferenceSession(unittest.TestCase):
         t1.join()
         t2.join()
 
+    def testRunOptionsIntraOpNumThreads(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ro = onnxrt.RunOptions()
+        self.assertEqual(ro.intra_op_num_threads, 0)
+        ro.intra_op_num_threads = 1
+        res = sess.run([], {sess.get_inputs()[0].name: x}, ro)
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunOptionsTimeout(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        ro = onnxrt.RunOptions()
+        ro.set_timeout(1)
+        time.sleep(0.01)
+        with self.assertRaises(RuntimeError) as context:
+            sess.run([], {sess.get_inputs()[0].name: x}, ro)
+        self.assertTrue('deadline' in str(context.exception))
+
+        # without the deadline the Run completes
+        ro.set_timeout(0)
+        res = sess.run([], {sess.get_inputs()[0].name: x}, ro)
+        output_expected = np.array([[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(output_expected, res[0], rtol=1e-05, atol=1e-08)
+
     def testRunDevice(self):
         device = onnxrt.get_device()
         self.assertTrue('CPU' in device or 'GPU' in device)
@@ -403,6 +506,47 @@ class TestInferenceSession(unittest.TestCase):
                     self.assertTrue(tag in lines[i])
             self.assertTrue(']' in lines[8])
 
+    def testNodeStats(self):
+        so = onnxrt.SessionOptions()
+        so.enable_node_stats = True
+        sess = onnxrt.InferenceSession(
+            self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        sess.run([], {'X': x})
+        sess.run([], {'X': x})
+
+        stats = sess.get_node_stats()
+        self.assertEqual(len(stats), 1)
+        self.assertEqual(stats[0]['op_type'], 'Mul')
+        self.assertEqual(stats[0]['count'], 2)
+        self.assertEqual(stats[0]['output_bytes'], 2 * x.nbytes)
+
+        sess.reset_node_stats()
+        self.assertEqual(sess.get_node_stats(), [])
+
+    def testCalibration(self):
+        so = onnxrt.SessionOptions()
+        so.enable_calibration = True
+        sess = onnxrt.InferenceSession(
+            self.get_name("mul_1.onnx"), sess_options=so)
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        sess.run([], {'X': x})
+
+        ranges = sess.get_calibration_ranges()
+        self.assertEqual(ranges, {'X': (1.0, 6.0), 'Y': (1.0, 36.0)})
+
+        # the ranges are given to the sessions which quantize the model
+        quantized_so = onnxrt.SessionOptions()
+        quantized_so.static_quantization_ranges = ranges
+        self.assertEqual(quantized_so.static_quantization_ranges, ranges)
+        quantized = onnxrt.InferenceSession(
+            self.get_name("mul_1.onnx"), sess_options=quantized_so)
+        res = quantized.run([], {'X': x})
+        np.testing.assert_allclose(res[0], x * x)
+
+        sess.reset_calibration()
+        self.assertEqual(sess.get_calibration_ranges(), {})
+
     def testDictVectorizer(self):
         sess = onnxrt.InferenceSession(
             self.get_name("pipeline_vectorize.onnx"))
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/http/json_handling.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(BatcherTest, ConcurrentRequestsGetTheirOwnOutputs) {
+  const static auto model_file = "testdata/mul_1.onnx";
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+  const static auto expected = R"({"outputs":{"Y":{"dims":["3","2"],"dataType":1,"floatData":[1,4,9,16,25,36]}}})";
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  BatchingOptions options;
+  options.max_batch_size = 8;
+  options.batch_timeout = std::chrono::milliseconds(10);
+  env->SetBatchingOptions(options);
+  env->InitializeModel(model_file, "Batched", "version");
+
+  constexpr int num_requests = 4;
+  std::vector<std::string> bodies(num_requests);
+  std::vector<bool> succeeded(num_requests, false);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_requests; ++i) {
+    threads.emplace_back([env, i, &bodies, &succeeded]() {
+      onnxruntime::server::Executor executor(env, "RequestId" + std::to_string(i));
+      onnxruntime::server::PredictRequest request{};
+      onnxruntime::server::PredictResponse response{};
+      if (!onnxruntime::server::GetRequestFromJson(input_json, request).ok()) {
+        return;
+      }
+
+      succeeded[i] = executor.Predict("Batched", "version", request, response).ok() &&
+                     GenerateResponseInJson(response, bodies[i]).ok();
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < num_requests; ++i) {
+    EXPECT_TRUE(succeeded[i]);
+    EXPECT_EQ(expected, bodies[i]);
+  }
+
+  auto stats = env->GetBatcher("Batched", "version").GetStats();
+  EXPECT_EQ(stats.num_requests, static_cast<uint64_t>(num_requests));
+  EXPECT_LE(stats.num_batches, static_cast<uint64_t>(num_requests));
+
+  env->UnloadModel("Batched", "version");
+  env->SetBatchingOptions(BatchingOptions{});
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -1108,6 +1108,40 @@ void CreateMLValueBool(AllocatorPtr alloc, const std::vector<int64_t>& dims, con
   p_value = Ort::Value{p_mlvalue};
 }
 
+TEST(MLValueToTensorProtoTests, FloatRawDataUsedInPlace) {
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  onnx::TensorProto tp;
+  tp.set_raw_data(values_mul_x.data(), values_mul_x.size() * sizeof(float));
+  for (auto const& dim : dims_mul_x) {
+    tp.add_dims(dim);
+  }
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  Ort::Value ml_value{nullptr};
+  Ort::AllocatorWithDefaultOptions allocator;
+  ASSERT_TRUE(onnxruntime::server::TensorProtoRawDataToMLValue(tp, *allocator.GetInfo(), ml_value));
+
+  // The tensor aliases the raw_data of the proto
+  EXPECT_EQ(static_cast<const void*>(ml_value.GetTensorMutableData<float>()),
+            static_cast<const void*>(tp.raw_data().data()));
+  EXPECT_EQ(ml_value.GetTensorTypeAndShapeInfo().GetShape(), dims_mul_x);
+
+  onnx::TensorProto tp_out;
+  onnxruntime::server::MLValueToTensorProto(ml_value, /* using_raw_data */ true, spdlog::default_logger(), tp_out);
+  EXPECT_EQ(tp_out.raw_data(), tp.raw_data());
+
+  // Tensors without raw_data are deserialized by TensorProtoToMLValue instead
+  onnx::TensorProto tp_float_data;
+  for (auto const& val : values_mul_x) {
+    tp_float_data.add_float_data(val);
+  }
+  tp_float_data.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  Ort::Value unused{nullptr};
+  EXPECT_FALSE(onnxruntime::server::TensorProtoRawDataToMLValue(tp_float_data, *allocator.GetInfo(), unused));
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
\ No newline at end of file
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -52,6 +54,54 @@ TEST_F(ExecutorTest, TestMul_1) {
   EXPECT_EQ(expected, body);
 }
 
+TEST_F(ExecutorTest, TestMul_1Replicas) {
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+  const static auto expected = R"({"outputs":{"Y":{"dims":["3","2"],"dataType":1,"floatData":[1,4,9,16,25,36]}}})";
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  ModelOptions model_options;
+  model_options.num_replicas = 2;
+  model_options.intra_op_num_threads = 1;
+  env->SetModelOptions("Replicated", model_options);
+  env->InitializeModel("testdata/mul_1.onnx", "Replicated", "version");
+  EXPECT_EQ(env->GetModel("Replicated", "version")->replicas.size(), 2u);
+
+  onnxruntime::server::Executor executor(env, "RequestId");
+  onnxruntime::server::PredictRequest request{};
+  auto protostatus = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_TRUE(protostatus.ok());
+
+  for (int i = 0; i < 3; i++) {
+    onnxruntime::server::PredictResponse response{};
+    auto prediction_res = executor.Predict("Replicated", "version", request, response);
+    EXPECT_TRUE(prediction_res.ok());
+
+    std::string body;
+    protostatus = GenerateResponseInJson(response, body);
+    EXPECT_EQ(expected, body);
+  }
+
+  env->UnloadModel("Replicated", "version");
+}
+
+TEST_F(ExecutorTest, ThreadBudget) {
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  ModelOptions model_options;
+  model_options.num_replicas = 2;
+  model_options.intra_op_num_threads = 2;
+  env->SetModelOptions("Budgeted", model_options);
+
+  // "Name" is served with one thread per core already
+  const int num_cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  env->SetThreadBudget(num_cores + 3);
+  EXPECT_THROW(env->InitializeModel("testdata/mul_1.onnx", "Budgeted", "version"), Ort::Exception);
+
+  env->SetThreadBudget(num_cores + 4);
+  env->InitializeModel("testdata/mul_1.onnx", "Budgeted", "version");
+  env->UnloadModel("Budgeted", "version");
+  env->SetThreadBudget(0);
+}
+
 }  // namespace test
 }  // namespace server
 }  // namespace onnxruntime
@@ -0,0 +1,95 @@
+#include <grpcpp/grpcpp.h>
+
+#include "gtest/gtest.h"
+
+#include "prediction_service.grpc.pb.h"
+#include "server/grpc/grpc_app.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace grpc {
+namespace test {
+
+static PredictRequest GetRequest(float scale) {
+  PredictRequest req{};
+  req.add_output_filter("Y");
+  onnx::TensorProto proto{};
+  proto.add_dims(3);
+  proto.add_dims(2);
+  proto.set_data_type(1);
+  for (int i = 1; i <= 6; ++i) {
+    proto.add_float_data(scale * i);
+  }
+  (*req.mutable_inputs())["X"] = proto;
+  return req;
+}
+
+class GRPCAppTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    onnxruntime::server::test::ServerEnv()->InitializeModel("testdata/mul_1.onnx", "default", "1");
+    app_ = std::make_unique<GRPCApp>(GetEnvironment(), "127.0.0.1", 0, 2);
+    auto channel = ::grpc::CreateChannel("127.0.0.1:" + std::to_string(app_->Port()), ::grpc::InsecureChannelCredentials());
+    stub_ = PredictionService::NewStub(channel);
+  }
+  void TearDown() override {
+    stub_.reset();
+    app_.reset();
+    onnxruntime::server::test::ServerEnv()->UnloadModel("default", "1");
+  }
+  std::shared_ptr<onnxruntime::server::ServerEnvironment> GetEnvironment() {
+    return std::shared_ptr<onnxruntime::server::ServerEnvironment>(onnxruntime::server::test::ServerEnv(), [](onnxruntime::server::ServerEnvironment*) {});
+  }
+
+  std::unique_ptr<GRPCApp> app_;
+  std::unique_ptr<PredictionService::Stub> stub_;
+};
+
+TEST_F(GRPCAppTest, Predict) {
+  ASSERT_NE(app_->Port(), 0);
+  ::grpc::ClientContext context;
+  PredictResponse response;
+  auto status = stub_->Predict(&context, GetRequest(1), &response);
+  ASSERT_TRUE(status.ok()) << status.error_message();
+  // mul_1 squares its input
+  EXPECT_EQ(response.outputs().at("Y").float_data(5), 36.f);
+  EXPECT_NE(context.GetServerInitialMetadata().find("x-ms-request-id"), context.GetServerInitialMetadata().end());
+}
+
+TEST_F(GRPCAppTest, PredictStream) {
+  ::grpc::ClientContext context;
+  auto stream = stub_->PredictStream(&context);
+  for (int i = 1; i <= 3; ++i) {
+    ASSERT_TRUE(stream->Write(GetRequest(static_cast<float>(i))));
+  }
+  stream->WritesDone();
+
+  PredictResponse response;
+  for (int i = 1; i <= 3; ++i) {
+    ASSERT_TRUE(stream->Read(&response));
+    EXPECT_EQ(response.outputs().at("Y").float_data(0), static_cast<float>(i * i));
+  }
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_TRUE(stream->Finish().ok());
+}
+
+TEST_F(GRPCAppTest, PredictStreamEndsAtTheFirstFailure) {
+  ::grpc::ClientContext context;
+  auto stream = stub_->PredictStream(&context);
+  auto invalid = GetRequest(1);
+  (*invalid.mutable_inputs())["X"].add_dims(1);
+  ASSERT_TRUE(stream->Write(GetRequest(1)));
+  stream->Write(invalid);
+  stream->WritesDone();
+
+  PredictResponse response;
+  EXPECT_TRUE(stream->Read(&response));
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_EQ(stream->Finish().error_code(), ::grpc::INVALID_ARGUMENT);
+}
+
+}  // namespace test
+}  // namespace grpc
+}  // namespace server
+}  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <fstream>
+#include <limits>
 #include <google/protobuf/stubs/status.h>
 
 #include "gtest/gtest.h"
@@ -49,6 +50,76 @@ TEST(JsonDeserializationTests, InvalidJson) {
   EXPECT_EQ("Expected : between key:value pair.\n{inputs\":{\"Input3\":{\"dims\":\n       ^", status.error_message());
 }
 
+TEST(JsonDeserializationTests, TypedDataMatchesProtobuf) {
+  std::string input_json = R"({"inputs": {"X": {"dims": [2, "3"], "dataType": 1, "name": "X\u00e9\n",
+                                                "floatData": [1, -2.5, 0.1, 1e-3, "NaN", "-Infinity"],
+                                                "int64Data": ["-9223372036854775808", 42],
+                                                "uint64Data": ["18446744073709551615"],
+                                                "doubleData": [0.1, 1E+300]}},
+                                "outputFilter": ["Y", "Z"]})";
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = onnxruntime::server::GetRequestFromJson(input_json, request);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  onnxruntime::server::PredictRequest expected;
+  protobufutil::JsonParseOptions options;
+  status = protobufutil::JsonStringToMessage(input_json, &expected, options);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code());
+
+  EXPECT_EQ(expected.SerializeAsString(), request.SerializeAsString());
+  EXPECT_EQ(request.inputs().at("X").float_data(2), 0.1f);
+  EXPECT_EQ(request.inputs().at("X").name(), "X\xc3\xa9\n");
+}
+
+TEST(JsonDeserializationTests, InvalidNumber) {
+  std::string input_json = R"({"inputs":{"X":{"dims":[1],"dataType":6,"int32Data":[2147483648]}}})";
+  onnxruntime::server::PredictRequest request;
+  protobufutil::Status status = onnxruntime::server::GetRequestFromJson(input_json, request);
+
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+}
+
+TEST(JsonSerializationTests, TypedDataMatchesProtobuf) {
+  onnxruntime::server::PredictResponse response;
+  auto& y = (*response.mutable_outputs())["Y"];
+  y.add_dims(2);
+  y.add_dims(3);
+  y.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  for (float value : {1.f, -2.5f, 0.1f, 1e-10f, 3.14159274f, 16777217.f}) {
+    y.add_float_data(value);
+  }
+  auto& z = (*response.mutable_outputs())["Z"];
+  z.set_data_type(onnx::TensorProto_DataType_DOUBLE);
+  z.set_name("Z");
+  z.set_data_location(onnx::TensorProto_DataLocation_DEFAULT);
+  for (double value : {0.1, 1.0 / 3, 1e300, std::numeric_limits<double>::quiet_NaN(),
+                       -std::numeric_limits<double>::infinity()}) {
+    z.add_double_data(value);
+  }
+  auto& s = (*response.mutable_outputs())["S"];
+  s.add_dims(2);
+  s.set_data_type(onnx::TensorProto_DataType_STRING);
+  s.add_string_data("a");
+  s.add_string_data("abcd");
+  auto& i = (*response.mutable_outputs())["I"];
+  i.add_dims(0);
+  i.set_data_type(onnx::TensorProto_DataType_INT64);
+  i.add_int64_data(-1);
+  i.add_uint64_data(18446744073709551615ull);
+  i.add_int32_data(-7);
+  i.set_raw_data("");
+
+  std::string json_string;
+  protobufutil::Status status = onnxruntime::server::GenerateResponseInJson(response, json_string);
+  EXPECT_EQ(protobufutil::error::OK, status.error_code());
+
+  std::string expected_json_string;
+  protobufutil::JsonPrintOptions options;
+  status = protobufutil::MessageToJsonString(response, &expected_json_string, options);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code());
+  EXPECT_EQ(expected_json_string, json_string);
+}
+
 TEST(JsonSerializationTests, HappyPath) {
   std::string test_data = "testdata/server/response_0.pb";
   std::string expected_json_string = R"({"outputs":{"Plus214_Output_0":{"dims":["1","10"],"dataType":1,"rawData":"4+pzRFWuGsSMdM1F2gEnRFdRZcRZ9NDEURj0xBIzdsJOS0LEA/GzxA=="}}})";
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "server/executor.h"
+#include "server/http/json_handling.h"
+#include "server/metrics.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+TEST(MetricsTest, HistogramBucketsAreCumulative) {
+  Histogram histogram({1, 2});
+  histogram.Observe(0.5);
+  histogram.Observe(1);
+  histogram.Observe(1.5);
+  histogram.Observe(3);
+
+  std::ostringstream out;
+  histogram.Write(out, "latency", "model=\"m\"");
+  EXPECT_EQ(out.str(),
+            "latency_bucket{model=\"m\",le=\"1\"} 2\n"
+            "latency_bucket{model=\"m\",le=\"2\"} 3\n"
+            "latency_bucket{model=\"m\",le=\"+Inf\"} 4\n"
+            "latency_sum{model=\"m\"} 6\n"
+            "latency_count{model=\"m\"} 4\n");
+}
+
+TEST(MetricsTest, PredictIsCounted) {
+  const static auto model_file = "testdata/mul_1.onnx";
+  const static auto input_json = R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}},"outputFilter":["Y"]})";
+
+  onnxruntime::server::ServerEnvironment* env = ServerEnv();
+  env->InitializeModel(model_file, "Metrics", "1");
+  ModelMetrics* metrics = env->GetModelMetrics("Metrics", "1");
+  ASSERT_NE(metrics, nullptr);
+  EXPECT_EQ(env->GetModelMetrics("Metrics", "2"), nullptr);
+
+  onnxruntime::server::PredictRequest request{};
+  ASSERT_TRUE(onnxruntime::server::GetRequestFromJson(input_json, request).ok());
+  {
+    RequestMetricsScope scope(metrics);
+    onnxruntime::server::Executor executor(env, "RequestId");
+    onnxruntime::server::PredictResponse response{};
+    scope.succeeded = executor.Predict("Metrics", "1", request, response, &scope.timings).ok();
+    EXPECT_TRUE(scope.succeeded);
+  }
+
+  std::ostringstream out;
+  env->WriteMetrics(out);
+  const auto text = out.str();
+  const std::string labels = "model=\"Metrics\",version=\"1\"";
+  EXPECT_NE(text.find("# TYPE onnxruntime_server_request_phase_seconds histogram\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_requests_total{" + labels + ",status=\"success\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_requests_total{" + labels + ",status=\"failure\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_requests_in_flight{" + labels + "} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_request_phase_seconds_count{" + labels + ",phase=\"inference\"} 1\n"),
+            std::string::npos);
+  // one run of the 3 rows of X
+  EXPECT_NE(text.find("onnxruntime_server_batch_size_bucket{" + labels + ",le=\"2\"} 0\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_batch_size_bucket{" + labels + ",le=\"4\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_server_arena_max_bytes_in_use{" + labels + "} "), std::string::npos);
+
+  env->UnloadModel("Metrics", "1");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "server/model_repository.h"
+#include "test_server_environment.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace fs = boost::filesystem;
+
+class ModelRepositoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    repository_ = fs::temp_directory_path() / fs::unique_path("model_repository_%%%%%%%%");
+    fs::create_directories(repository_);
+  }
+
+  void TearDown() override {
+    fs::remove_all(repository_);
+  }
+
+  void AddVersion(const std::string& version) {
+    fs::create_directories(repository_ / version);
+    fs::copy_file("testdata/mul_1.onnx", repository_ / version / "model.onnx");
+  }
+
+  void AddWarmupRequest(const std::string& version, const std::string& file_name, const std::string& content) {
+    fs::create_directories(repository_ / version / "warmup");
+    std::ofstream(fs::path(repository_ / version / "warmup" / file_name).string()) << content;
+  }
+
+  ModelRepositoryOptions Options() const {
+    ModelRepositoryOptions options;
+    options.path = repository_.string();
+    options.model_name = "Repository";
+    options.poll_interval = std::chrono::seconds(0);
+    return options;
+  }
+
+  fs::path repository_;
+};
+
+TEST_F(ModelRepositoryTest, ServesTheHighestVersion) {
+  ServerEnvironment* env = ServerEnv();
+  AddVersion("1");
+  {
+    ModelRepository repository(*env, Options());
+    EXPECT_EQ(repository.Poll(), 1u);
+    EXPECT_EQ(env->GetModelVersions("Repository"), std::vector<std::string>{"1"});
+
+    // a request that started on version 1 keeps it after version 2 replaces it
+    auto version_1 = env->GetModel("Repository", "");
+    AddVersion("2");
+    AddWarmupRequest("2", "mul.json", R"({"inputs":{"X":{"dims":[3,2],"dataType":1,"floatData":[1,2,3,4,5,6]}}})");
+    EXPECT_EQ(repository.Poll(), 1u);
+    EXPECT_EQ(env->GetModelVersions("Repository"), std::vector<std::string>{"2"});
+    EXPECT_NE(env->GetModel("Repository", "").get(), version_1.get());
+    EXPECT_EQ(version_1->output_names, std::vector<std::string>{"Y"});
+
+    // a version whose warmup fails isn't served, and doesn't replace the one served
+    AddVersion("3");
+    AddWarmupRequest("3", "bad_input.json", R"({"inputs":{"Z":{"dims":[1],"dataType":1,"floatData":[1]}}})");
+    EXPECT_EQ(repository.Poll(), 1u);
+    EXPECT_EQ(env->GetModelVersions("Repository"), std::vector<std::string>{"2"});
+  }
+
+  env->UnloadModel("Repository", "2");
+}
+
+TEST_F(ModelRepositoryTest, ServesSeveralVersions) {
+  ServerEnvironment* env = ServerEnv();
+  AddVersion("1");
+  AddVersion("2");
+  AddVersion("10");
+  auto options = Options();
+  options.num_versions = 2;
+  ModelRepository repository(*env, options);
+  EXPECT_EQ(repository.Poll(), 2u);
+
+  auto versions = env->GetModelVersions("Repository");
+  std::sort(versions.begin(), versions.end());
+  EXPECT_EQ(versions, (std::vector<std::string>{"10", "2"}));
+  EXPECT_EQ(env->GetModel("Repository", "").get(), env->GetModel("Repository", "10").get());
+
+  env->UnloadModel("Repository", "2");
+  env->UnloadModel("Repository", "10");
+}
+
+TEST_F(ModelRepositoryTest, LoadsRegisteredModelsOnDemand) {
+  ServerEnvironment* env = ServerEnv();
+  fs::create_directories(repository_ / "Lazy" / "1");
+  fs::create_directories(repository_ / "Lazy" / "2");
+  fs::copy_file("testdata/mul_1.onnx", repository_ / "Lazy" / "1" / "model.onnx");
+  fs::copy_file("testdata/mul_1.onnx", repository_ / "Lazy" / "2" / "model.onnx");
+  EXPECT_EQ(RegisterModels(*env, repository_.string()), 2u);
+  EXPECT_TRUE(env->GetModelVersions("Lazy").empty());
+  EXPECT_NE(env->GetModelMetrics("Lazy", "1"), nullptr);
+
+  size_t memory_usage = env->GetModel("Lazy", "1")->MemoryUsage();
+  EXPECT_EQ(env->GetModelVersions("Lazy"), std::vector<std::string>{"1"});
+
+  // version 1 is evicted to make room for version 2, unless a request holds on to it
+  env->SetMemoryBudget(memory_usage + 1);
+  {
+    auto version_1 = env->GetModel("Lazy", "1");
+    env->GetModel("Lazy", "2");
+    EXPECT_EQ(env->GetModelVersions("Lazy").size(), 2u);
+    env->UnloadModel("Lazy", "2");
+    env->RegisterModel((repository_ / "Lazy" / "2" / "model.onnx").string(), "Lazy", "2");
+  }
+  EXPECT_EQ(env->GetModel("Lazy", "").get(), env->GetModel("Lazy", "2").get());
+  EXPECT_EQ(env->GetModelVersions("Lazy"), std::vector<std::string>{"2"});
+
+  env->SetMemoryBudget(0);
+  env->UnloadModel("Lazy", "1");
+  env->UnloadModel("Lazy", "2");
+}
+
+TEST_F(ModelRepositoryTest, ReloadsFromSnapshots) {
+  ServerEnvironment* env = ServerEnv();
+  AddVersion("1");
+  const auto snapshots = repository_ / "snapshots";
+  fs::create_directories(snapshots);
+  env->SetSnapshotDirectory(snapshots.string());
+
+  env->InitializeModel((repository_ / "1" / "model.onnx").string(), "Snapshot", "1");
+  EXPECT_TRUE(fs::is_regular_file(snapshots / "Snapshot_1.onnx"));
+  env->UnloadModel("Snapshot", "1");
+
+  env->InitializeModel((repository_ / "1" / "model.onnx").string(), "Snapshot", "1");
+  EXPECT_EQ(env->GetModel("Snapshot", "1")->output_names, std::vector<std::string>{"Y"});
+  env->UnloadModel("Snapshot", "1");
+  env->SetSnapshotDirectory("");
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
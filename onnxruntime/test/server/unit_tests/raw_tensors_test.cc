@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <cstring>
+
+#include <google/protobuf/stubs/status.h>
+
+#include "gtest/gtest.h"
+
+#include "predict.pb.h"
+#include "server/http/raw_tensors.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace protobufutil = google::protobuf::util;
+
+template <typename T>
+static void Append(std::string& payload, T value) {
+  payload.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void AppendString(std::string& payload, const std::string& value) {
+  Append(payload, static_cast<uint32_t>(value.size()));
+  payload.append(value);
+}
+
+static std::string Header(uint32_t num_tensors) {
+  std::string payload = "ORTT";
+  Append(payload, uint32_t{1});
+  Append(payload, num_tensors);
+  return payload;
+}
+
+TEST(RawTensorsTests, Request) {
+  const float data[] = {1, 2, 3, 4, 5, 6};
+  std::string payload = Header(1);
+  AppendString(payload, "X");
+  Append(payload, static_cast<int32_t>(onnx::TensorProto_DataType_FLOAT));
+  Append(payload, uint32_t{2});
+  Append(payload, int64_t{3});
+  Append(payload, int64_t{2});
+  Append(payload, static_cast<uint64_t>(sizeof(data)));
+  payload.append(reinterpret_cast<const char*>(data), sizeof(data));
+  Append(payload, uint32_t{1});
+  AppendString(payload, "Y");
+
+  PredictRequest request;
+  auto status = GetRequestFromRawTensors(payload, request);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code()) << status.error_message();
+
+  const auto& x = request.inputs().at("X");
+  EXPECT_EQ(x.data_type(), onnx::TensorProto_DataType_FLOAT);
+  ASSERT_EQ(x.dims_size(), 2);
+  EXPECT_EQ(x.dims(0), 3);
+  EXPECT_EQ(x.dims(1), 2);
+  EXPECT_TRUE(x.has_raw_data());
+  EXPECT_EQ(x.raw_data(), std::string(reinterpret_cast<const char*>(data), sizeof(data)));
+  ASSERT_EQ(request.output_filter_size(), 1);
+  EXPECT_EQ(request.output_filter(0), "Y");
+}
+
+TEST(RawTensorsTests, InvalidRequests) {
+  PredictRequest request;
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, GetRequestFromRawTensors("ORT", request).error_code());
+
+  // the data doesn't match the shape
+  std::string payload = Header(1);
+  AppendString(payload, "X");
+  Append(payload, static_cast<int32_t>(onnx::TensorProto_DataType_INT64));
+  Append(payload, uint32_t{1});
+  Append(payload, int64_t{2});
+  Append(payload, uint64_t{8});
+  Append(payload, int64_t{7});
+  Append(payload, uint32_t{0});
+  auto status = GetRequestFromRawTensors(payload, request);
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, status.error_code());
+  EXPECT_EQ("Invalid tensors payload: the data of X is 8 bytes, its shape needs 16.", status.error_message());
+
+  // the data is longer than the payload
+  payload = Header(1);
+  AppendString(payload, "X");
+  Append(payload, static_cast<int32_t>(onnx::TensorProto_DataType_FLOAT));
+  Append(payload, uint32_t{0});
+  Append(payload, uint64_t{1} << 62);
+  request.Clear();
+  status = GetRequestFromRawTensors(payload, request);
+  EXPECT_EQ("Invalid tensors payload: truncated data of X.", status.error_message());
+
+  // strings have no fixed size
+  payload = Header(1);
+  AppendString(payload, "X");
+  Append(payload, static_cast<int32_t>(onnx::TensorProto_DataType_STRING));
+  request.Clear();
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, GetRequestFromRawTensors(payload, request).error_code());
+}
+
+TEST(RawTensorsTests, Response) {
+  PredictResponse response;
+  auto& y = (*response.mutable_outputs())["Y"];
+  y.add_dims(3);
+  y.set_data_type(onnx::TensorProto_DataType_UINT8);
+  y.add_int32_data(1);
+  y.add_int32_data(2);
+  y.add_int32_data(255);
+
+  std::string payload;
+  auto status = GenerateResponseInRawTensors(response, payload);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code()) << status.error_message();
+
+  std::string expected = Header(1);
+  AppendString(expected, "Y");
+  Append(expected, static_cast<int32_t>(onnx::TensorProto_DataType_UINT8));
+  Append(expected, uint32_t{1});
+  Append(expected, int64_t{3});
+  Append(expected, uint64_t{3});
+  expected.append("\x01\x02\xff", 3);
+  Append(expected, uint32_t{0});
+  EXPECT_EQ(expected, payload);
+
+  // the response reads back as a request, with the data as is
+  PredictRequest request;
+  status = GetRequestFromRawTensors(payload, request);
+  ASSERT_EQ(protobufutil::error::OK, status.error_code()) << status.error_message();
+  EXPECT_EQ(request.inputs().at("Y").raw_data(), std::string("\x01\x02\xff", 3));
+}
+
+TEST(RawTensorsTests, StringResponseIsRejected) {
+  PredictResponse response;
+  auto& y = (*response.mutable_outputs())["Y"];
+  y.add_dims(1);
+  y.set_data_type(onnx::TensorProto_DataType_STRING);
+  y.add_string_data("hello");
+
+  std::string payload;
+  EXPECT_EQ(protobufutil::error::INVALID_ARGUMENT, GenerateResponseInRawTensors(response, payload).error_code());
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -45,6 +45,83 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
 }
 
+TEST(ConfigParsingTests, Batching) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("16"),
+      const_cast<char*>("--batch_timeout_micros"), const_cast<char*>("500")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 16);
+  EXPECT_EQ(config.batch_timeout_micros, 500);
+}
+
+TEST(ConfigParsingTests, WarmupRuns) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--warmup_runs"), const_cast<char*>("3")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.warmup_runs, 3);
+}
+
+TEST(ConfigParsingTests, GrpcWorkers) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_intra_op_threads"), const_cast<char*>("1"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("4")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(7, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_intra_op_threads, 1);
+  const int num_cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  EXPECT_EQ(config.GrpcWorkerCount(), num_cores * 4);
+
+  config.num_grpc_workers = 2;
+  EXPECT_EQ(config.GrpcWorkerCount(), 2);
+}
+
+TEST(ConfigParsingTests, SessionReplicas) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_http_threads"), const_cast<char*>("2"),
+      const_cast<char*>("--num_session_replicas"), const_cast<char*>("3"),
+      const_cast<char*>("--num_inter_op_threads"), const_cast<char*>("1"),
+      const_cast<char*>("--max_threads"), const_cast<char*>("14")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(11, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.num_session_replicas, 3);
+  EXPECT_EQ(config.num_inter_op_threads, 1);
+  // (14 - 2) / 3 - 1 intra op threads per replica
+  EXPECT_EQ(config.IntraOpThreadCount(), 3);
+  EXPECT_EQ(config.ModelThreadBudget(), 12);
+}
+
+TEST(ConfigParsingTests, ThreadBudgetExceeded) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--num_http_threads"), const_cast<char*>("4"),
+      const_cast<char*>("--num_session_replicas"), const_cast<char*>("2"),
+      const_cast<char*>("--num_intra_op_threads"), const_cast<char*>("4"),
+      const_cast<char*>("--max_threads"), const_cast<char*>("8")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(11, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
 TEST(ConfigParsingTests, Help) {
   char* test_argv[] = {
       const_cast<char*>("/path/to/binary"),
@@ -40,6 +40,16 @@ TEST(RequestContentTypeTests, ContentTypeRawData) {
   EXPECT_EQ(result, SupportedContentType::PbByteArray);
 }
 
+TEST(RequestContentTypeTests, ContentTypeRawTensors) {
+  HttpContext context;
+  http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
+  request.set(http::field::content_type, "application/x-onnxruntime-tensors");
+  context.request = request;
+
+  auto result = GetRequestContentType(context);
+  EXPECT_EQ(result, SupportedContentType::RawTensors);
+}
+
 TEST(RequestContentTypeTests, ContentTypeUnknown) {
   HttpContext context;
   http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
@@ -97,6 +107,16 @@ TEST(ResponseContentTypeTests, ContentTypeAny) {
   EXPECT_EQ(result, SupportedContentType::PbByteArray);
 }
 
+TEST(ResponseContentTypeTests, ContentTypeRawTensors) {
+  HttpContext context;
+  http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
+  request.set(http::field::accept, "application/x-onnxruntime-tensors");
+  context.request = request;
+
+  auto result = GetResponseContentType(context);
+  EXPECT_EQ(result, SupportedContentType::RawTensors);
+}
+
 TEST(ResponseContentTypeTests, ContentTypeUnknown) {
   HttpContext context;
   http::request<http::string_body, http::basic_fields<std::allocator<char>>> request{};
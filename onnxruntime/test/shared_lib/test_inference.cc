@@ -3,6 +3,7 @@
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "providers.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -221,6 +222,66 @@ TEST_F(CApiTest, custom_op_handler) {
   TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
 }
 
+// Adds the inputs on the thread pool of the session, and lets the output reuse the buffer of the first input
+struct MyParallelCustomKernel {
+  MyParallelCustomKernel(Ort::CustomOpApi ort, const OrtKernelInfo* /*info*/) : ort_(ort) {
+  }
+
+  void Compute(OrtKernelContext* context) {
+    const OrtValue* input_X = ort_.KernelContext_GetInput(context, 0);
+    const OrtValue* input_Y = ort_.KernelContext_GetInput(context, 1);
+    const float* X = ort_.GetTensorData<float>(input_X);
+    const float* Y = ort_.GetTensorData<float>(input_Y);
+
+    OrtTensorDimensions dimensions(ort_, input_X);
+    OrtValue* output = ort_.KernelContext_GetOutput(context, 0, dimensions.data(), dimensions.size());
+    float* out = ort_.GetTensorMutableData<float>(output);
+
+    OrtTensorTypeAndShapeInfo* output_info = ort_.GetTensorTypeAndShape(output);
+    size_t size = ort_.GetTensorShapeElementCount(output_info);
+    ort_.ReleaseTensorTypeAndShapeInfo(output_info);
+
+    ort_.KernelContext_ParallelFor(context, size, 1.0, [X, Y, out](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++) {
+        out[i] = X[i] + Y[i];
+      }
+    });
+  }
+
+ private:
+  Ort::CustomOpApi ort_;
+};
+
+struct MyParallelCustomOp : Ort::CustomOpBase<MyParallelCustomOp, MyParallelCustomKernel> {
+  void* CreateKernel(Ort::CustomOpApi api, const OrtKernelInfo* info) { return new MyParallelCustomKernel(api, info); };
+  const char* GetName() const { return "Foo"; };
+
+  size_t GetInputTypeCount() const { return 2; };
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  size_t GetOutputTypeCount() const { return 1; };
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; };
+
+  int GetMayInplaceInput(size_t /*index*/) const { return 0; }
+};
+
+TEST_F(CApiTest, custom_op_parallel_for_and_inplace) {
+  std::vector<Input> inputs(1);
+  Input& input = inputs[0];
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+  MyParallelCustomOp custom_op;
+  Ort::CustomOpDomain custom_op_domain("");
+  custom_op_domain.Add(&custom_op);
+
+  TestInference<PATH_TYPE>(env_, CUSTOM_OP_MODEL_URI, inputs, "Y", expected_dims_y, expected_values_y, 0, custom_op_domain);
+}
+
 #if defined(ENABLE_LANGUAGE_INTEROP_OPS) && !defined(_WIN32)  // on windows, PYTHONHOME must be set explicitly
 TEST_F(CApiTest, test_pyop) {
   std::cout << "Test model with pyop" << std::endl;
@@ -254,6 +315,69 @@ TEST_F(CApiTest, create_session_without_session_option) {
 }
 #endif
 
+TEST_F(CApiTest, prepared_run) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  const char* input_name = "X";
+  const char* output_name = "Y";
+  Ort::PreparedRun prepared_run = session.CreatePreparedRun(&input_name, 1, &output_name, 1);
+
+  float values_x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  //test it twice
+  for (int i = 0; i != 2; ++i) {
+    Ort::Value input = Ort::Value::CreateTensor<float>(info, values_x, 6, dims_x.data(), dims_x.size());
+    std::vector<Ort::Value> outputs = session.Run(Ort::RunOptions{nullptr}, prepared_run, &input, 1, 1);
+    ASSERT_EQ(outputs.size(), 1);
+
+    auto type_info = outputs[0].GetTensorTypeAndShapeInfo();
+    ASSERT_EQ(type_info.GetShape(), dims_x);
+    float* f = outputs[0].GetTensorMutableData<float>();
+    for (size_t j = 0; j != values_y.size(); ++j) {
+      ASSERT_EQ(values_y[j], f[j]);
+    }
+  }
+}
+
+TEST_F(CApiTest, io_binding) {
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+
+  float values_x[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> dims_x = {3, 2};
+  std::vector<float> values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  float output_buffer[6] = {};
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  Ort::IoBinding binding(session);
+  Ort::Value input = Ort::Value::CreateTensor<float>(info, values_x, 6, dims_x.data(), dims_x.size());
+  binding.BindInput("X", input);
+  Ort::Value output = Ort::Value::CreateTensor<float>(info, output_buffer, 6, dims_x.data(), dims_x.size());
+  binding.BindOutput("Y", output);
+
+  //test it twice, the runs write into the bound buffer
+  for (int i = 0; i != 2; ++i) {
+    std::fill(std::begin(output_buffer), std::end(output_buffer), 0.0f);
+    session.Run(Ort::RunOptions{nullptr}, binding);
+    for (size_t j = 0; j != values_y.size(); ++j) {
+      ASSERT_EQ(values_y[j], output_buffer[j]);
+    }
+  }
+
+  // an output bound to a device is allocated by the run
+  binding.ClearBoundOutputs();
+  binding.BindOutput("Y", info);
+  session.Run(Ort::RunOptions{nullptr}, binding);
+  std::vector<Ort::Value> outputs = binding.GetOutputValues();
+  ASSERT_EQ(outputs.size(), 1);
+  ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), dims_x);
+  float* f = outputs[0].GetTensorMutableData<float>();
+  for (size_t j = 0; j != values_y.size(); ++j) {
+    ASSERT_EQ(values_y[j], f[j]);
+  }
+}
+
 TEST_F(CApiTest, create_tensor) {
   const char* s[] = {"abc", "kmp"};
   int64_t expected_len = 2;
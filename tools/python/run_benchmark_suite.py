@@ -0,0 +1,160 @@
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(os.path.basename(__file__),
+                                     description='Run a suite of models with onnxruntime_perf_test, write the '
+                                                 'results as JSON and compare them against a stored baseline.')
+    parser.add_argument('--perf_test', required=True, help='path of the onnxruntime_perf_test executable')
+    parser.add_argument('--models_dir', required=True,
+                        help='directory the model paths of the suite are relative to. Each model directory holds '
+                             'the test_data_set_* directories of its inputs, as for onnx_test_runner.')
+    parser.add_argument('--suite',
+                        default=os.path.join(os.path.dirname(os.path.abspath(__file__)), 'benchmark_suite.json'),
+                        help='suite definition (default: %(default)s)')
+    parser.add_argument('--execution_providers',
+                        help='comma-separated execution providers to run, out of those listed for each model in '
+                             'the suite (default: all of them)')
+    parser.add_argument('--cpus',
+                        help='comma-separated CPUs the runs are pinned to, e.g. 0,1,2,3 (Linux only). '
+                             'Pin to the cores of one socket for repeatable results.')
+    parser.add_argument('-o', '--output', default='benchmark_results.json',
+                        help='file the results are written to (default: %(default)s)')
+    parser.add_argument('--baseline', help='results of an earlier run to compare against')
+    parser.add_argument('--update_baseline', action='store_true',
+                        help='write the results to the baseline file instead of comparing against it')
+    return parser.parse_args()
+
+
+def pin_to_cpus(cpus):
+    if not cpus:
+        return None
+    if not hasattr(os, 'sched_setaffinity'):
+        raise RuntimeError('Pinning to CPUs is only supported on Linux.')
+    cpu_set = set(int(cpu) for cpu in cpus.split(','))
+    return lambda: os.sched_setaffinity(0, cpu_set)
+
+
+def run_model(args, settings, model, execution_provider):
+    """Run a model with one execution provider, returning the JSON summary of onnxruntime_perf_test."""
+    model_path = os.path.join(args.models_dir, model['path'])
+    with tempfile.TemporaryDirectory() as temp_dir:
+        summary_file = os.path.join(temp_dir, 'summary.json')
+        command = [args.perf_test,
+                   '-e', execution_provider,
+                   '-m', settings.get('test_mode', 'times'),
+                   '-r', str(settings.get('repeated_times', 200)),
+                   '-t', str(settings.get('seconds_to_run', 60)),
+                   '-w', str(settings.get('warmup_times', 10)),
+                   '-x', str(settings.get('intra_op_num_threads', 1)),
+                   '-y', str(settings.get('inter_op_num_threads', 1)),
+                   '-o', str(settings.get('optimization_level', 2)),
+                   '-j', summary_file]
+        for dim, values in sorted(model.get('free_dims', {}).items()):
+            command += ['-d', '{}={}'.format(dim, values)]
+        command += [model_path, os.path.join(temp_dir, 'result.txt')]
+
+        process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                 universal_newlines=True, preexec_fn=pin_to_cpus(args.cpus))
+        if process.returncode != 0 or not os.path.exists(summary_file):
+            raise RuntimeError('{} failed:\n{}'.format(' '.join(command), process.stdout))
+        with open(summary_file) as f:
+            return json.load(f)
+
+
+def get_metric(summary, metric):
+    value = summary
+    for key in metric.split('.'):
+        value = value[key]
+    return value
+
+
+def compare(results, baseline, tolerances):
+    """Return the descriptions of the metrics of results that are worse than those of baseline by more than their
+    tolerance, as a fraction of the baseline. Throughputs are better higher, the other metrics lower."""
+    regressions = []
+    for key, summary in sorted(results.items()):
+        if key not in baseline:
+            print('{}: no baseline'.format(key))
+            continue
+        for metric, tolerance in sorted(tolerances.items()):
+            value = get_metric(summary, metric)
+            base = get_metric(baseline[key], metric)
+            if base <= 0:
+                continue
+            change = (value - base) / base
+            worse = change < -tolerance if metric.startswith('throughput') else change > tolerance
+            print('{}: {} {:.6g} (baseline {:.6g}, {:+.1%}){}'.format(key, metric, value, base, change,
+                                                                      ' REGRESSION' if worse else ''))
+            if worse:
+                regressions.append('{} {}: {:.6g} vs {:.6g}'.format(key, metric, value, base))
+    return regressions
+
+
+def main():
+    args = parse_args()
+    with open(args.suite) as f:
+        suite = json.load(f)
+    settings = suite.get('settings', {})
+    selected_providers = args.execution_providers.split(',') if args.execution_providers else None
+
+    # the results of each model and execution provider, keyed by 'model/provider'
+    results = {}
+    failures = []
+    for model in suite['models']:
+        if not os.path.exists(os.path.join(args.models_dir, model['path'])):
+            print('{}: skipped, {} was not found'.format(model['name'], model['path']))
+            continue
+        for execution_provider in model['execution_providers']:
+            if selected_providers is not None and execution_provider not in selected_providers:
+                continue
+            key = '{}/{}'.format(model['name'], execution_provider)
+            print('{}: running'.format(key))
+            sys.stdout.flush()
+            try:
+                summary = run_model(args, settings, model, execution_provider)
+            except RuntimeError as e:
+                print(e)
+                failures.append(key)
+                continue
+            # a shape sweep has an entry per shape, which is compared on its own
+            if isinstance(summary, list):
+                for entry in summary:
+                    results['{}[{}]'.format(key, entry['input_shapes'])] = entry
+            else:
+                results[key] = summary
+
+    output = {
+        'machine': {'platform': platform.platform(), 'processor': platform.processor(), 'cpus': args.cpus},
+        'settings': settings,
+        'results': results,
+    }
+    with open(args.output, 'w') as f:
+        json.dump(output, f, indent=2, sort_keys=True)
+    print('Results written to {}'.format(args.output))
+
+    regressions = []
+    if args.baseline and args.update_baseline:
+        with open(args.baseline, 'w') as f:
+            json.dump(output, f, indent=2, sort_keys=True)
+        print('Baseline {} updated'.format(args.baseline))
+    elif args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(results, baseline['results'], suite.get('tolerances', {}))
+
+    for key in failures:
+        print('FAILED: {}'.format(key))
+    for regression in regressions:
+        print('REGRESSION: {}'.format(regression))
+    return 1 if failures or regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())